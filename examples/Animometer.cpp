@@ -16,10 +16,16 @@
 
 #include "utils/ComboRenderPipelineDescriptor.h"
 #include "utils/SystemUtils.h"
+#include "utils/Timer.h"
 #include "utils/WGPUHelpers.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <vector>
 
 wgpu::Device device;
@@ -47,8 +53,211 @@ struct alignas(kMinDynamicBufferOffsetAlignment) ShaderData {
 
 static std::vector<ShaderData> shaderData;
 
+// The stress mode adds to the draws the updates of a top-level acceleration container with
+// animated instances and a pass tracing shadow rays against it, all in the command buffer of each
+// frame, and prints the frame time and the CPU time of the submits once it ran |frameCount|
+// frames.
+struct StressOptions {
+    bool enabled = false;
+    uint32_t frameCount = 600;
+    uint32_t instanceCount = 1024;
+    // The shadow rays are traced at the size of the swapchain.
+    uint32_t shadowWidth = 640;
+    uint32_t shadowHeight = 480;
+};
+StressOptions stressOptions;
+
+wgpu::Buffer rtVertexBuffer;
+wgpu::Buffer rtIndexBuffer;
+wgpu::Buffer shadowBuffer;
+wgpu::RayTracingAccelerationContainer geometryContainer;
+wgpu::RayTracingAccelerationContainer instanceContainer;
+wgpu::RayTracingPipeline shadowPipeline;
+wgpu::BindGroup shadowBindGroup;
+
+std::vector<float> instanceTransforms;
+std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> instances;
+
+std::unique_ptr<utils::Timer> timer;
+double lastFrameStart = 0.0;
+std::vector<double> frameTimes;
+std::vector<double> submitTimes;
+
+void UpdateInstanceTransforms(float time) {
+    // The instances spin on a 32 x N grid, so that every update refits the whole container.
+    for (uint32_t i = 0; i < stressOptions.instanceCount; ++i) {
+        const float angle = time + static_cast<float>(i) * 0.1f;
+        const float c = std::cos(angle) * 0.5f;
+        const float s = std::sin(angle) * 0.5f;
+        const float transform[12] = {
+            c,    -s,   0.0f, static_cast<float>(i % 32),
+            s,    c,    0.0f, static_cast<float>(i / 32),
+            0.0f, 0.0f, 0.5f, 1.0f,
+        };
+        memcpy(&instanceTransforms[i * 12], transform, sizeof(transform));
+    }
+}
+
+void initStress() {
+    const float vertices[9] = {0.0f, 0.5f, 0.0f, -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f};
+    const uint32_t indices[3] = {0, 1, 2};
+    rtVertexBuffer = utils::CreateBufferFromData(device, vertices, sizeof(vertices),
+                                                 wgpu::BufferUsage::CopyDst);
+    rtIndexBuffer = utils::CreateBufferFromData(device, indices, sizeof(indices),
+                                                wgpu::BufferUsage::CopyDst);
+
+    wgpu::RayTracingAccelerationGeometryVertexDescriptor vertex;
+    vertex.buffer = rtVertexBuffer;
+    vertex.format = wgpu::VertexFormat::Float3;
+    vertex.stride = 3 * sizeof(float);
+    vertex.count = 3;
+
+    wgpu::RayTracingAccelerationGeometryIndexDescriptor index;
+    index.buffer = rtIndexBuffer;
+    index.format = wgpu::IndexFormat::Uint32;
+    index.count = 3;
+
+    wgpu::RayTracingAccelerationGeometryDescriptor geometry;
+    geometry.flags = wgpu::RayTracingAccelerationGeometryFlag::Opaque;
+    geometry.type = wgpu::RayTracingAccelerationGeometryType::Triangles;
+    geometry.vertex = &vertex;
+    geometry.index = &index;
+
+    wgpu::RayTracingAccelerationContainerDescriptor geometryDescriptor;
+    geometryDescriptor.level = wgpu::RayTracingAccelerationContainerLevel::Bottom;
+    geometryDescriptor.flags = wgpu::RayTracingAccelerationContainerFlag::PreferFastTrace;
+    geometryDescriptor.geometryCount = 1;
+    geometryDescriptor.geometries = &geometry;
+    geometryContainer = device.CreateRayTracingAccelerationContainer(&geometryDescriptor);
+
+    instanceTransforms.resize(stressOptions.instanceCount * 12);
+    instances.resize(stressOptions.instanceCount);
+    UpdateInstanceTransforms(0.0f);
+    for (uint32_t i = 0; i < stressOptions.instanceCount; ++i) {
+        wgpu::RayTracingAccelerationInstanceDescriptor& instance = instances[i];
+        instance = {};
+        instance.flags = wgpu::RayTracingAccelerationInstanceFlag::TriangleCullDisable;
+        instance.instanceId = i;
+        instance.geometryContainer = geometryContainer;
+        instance.transformMatrixSize = 12;
+        instance.transformMatrix = &instanceTransforms[i * 12];
+    }
+
+    wgpu::RayTracingAccelerationContainerDescriptor instanceDescriptor;
+    instanceDescriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+    instanceDescriptor.flags = wgpu::RayTracingAccelerationContainerFlag::AllowUpdate |
+                               wgpu::RayTracingAccelerationContainerFlag::PreferFastBuild;
+    instanceDescriptor.instanceCount = instances.size();
+    instanceDescriptor.instances = instances.data();
+    instanceContainer = device.CreateRayTracingAccelerationContainer(&instanceDescriptor);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.BuildRayTracingAccelerationContainer(geometryContainer);
+        encoder.BuildRayTracingAccelerationContainer(instanceContainer);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    wgpu::BufferDescriptor shadowBufferDesc;
+    shadowBufferDesc.size = stressOptions.shadowWidth * stressOptions.shadowHeight * sizeof(float);
+    shadowBufferDesc.usage = wgpu::BufferUsage::Storage;
+    shadowBuffer = device.CreateBuffer(&shadowBufferDesc);
+
+    wgpu::ShaderModule rayGenModule =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::RayGeneration, R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadNV float shadowed;
+        layout(set = 0, binding = 0) uniform accelerationStructureNV topLevelAS;
+        layout(std430, set = 0, binding = 1) buffer ShadowBuffer {
+            float shadows[];
+        } shadowBuffer;
+        void main() {
+            const vec2 uv = (vec2(gl_LaunchIDNV.xy) + 0.5) / vec2(gl_LaunchSizeNV.xy);
+            const vec3 origin = vec3(uv * vec2(32.0, 32.0), 0.0);
+            shadowed = 1.0;
+            traceNV(topLevelAS,
+                    gl_RayFlagsOpaqueNV | gl_RayFlagsTerminateOnFirstHitNV |
+                        gl_RayFlagsSkipClosestHitShaderNV,
+                    0xFF, 0, 0, 0, origin, 0.01, normalize(vec3(0.3, 0.2, 1.0)), 64.0, 0);
+            shadowBuffer.shadows[gl_LaunchIDNV.y * gl_LaunchSizeNV.x + gl_LaunchIDNV.x] =
+                shadowed;
+        })");
+    wgpu::ShaderModule rayClosestHitModule =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::RayClosestHit, R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV float shadowed;
+        void main() {
+            shadowed = 1.0;
+        })");
+    wgpu::ShaderModule rayMissModule =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::RayMiss, R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV float shadowed;
+        void main() {
+            shadowed = 0.0;
+        })");
+
+    wgpu::RayTracingShaderBindingTableStagesDescriptor stages[3] = {
+        {wgpu::ShaderStage::RayGeneration, rayGenModule},
+        {wgpu::ShaderStage::RayClosestHit, rayClosestHitModule},
+        {wgpu::ShaderStage::RayMiss, rayMissModule},
+    };
+
+    wgpu::RayTracingShaderBindingTableGroupsDescriptor groups[3] = {};
+    groups[0].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+    groups[0].generalIndex = 0;
+    groups[1].type = wgpu::RayTracingShaderBindingTableGroupType::TrianglesHitGroup;
+    groups[1].closestHitIndex = 1;
+    groups[2].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+    groups[2].generalIndex = 2;
+
+    wgpu::RayTracingShaderBindingTableDescriptor sbtDescriptor;
+    sbtDescriptor.stagesCount = 3;
+    sbtDescriptor.stages = stages;
+    sbtDescriptor.groupsCount = 3;
+    sbtDescriptor.groups = groups;
+    wgpu::RayTracingShaderBindingTable sbt =
+        device.CreateRayTracingShaderBindingTable(&sbtDescriptor);
+
+    wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+        device,
+        {{0, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::AccelerationContainer},
+         {1, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::StorageBuffer}});
+
+    wgpu::RayTracingStateDescriptor state;
+    state.shaderBindingTable = sbt;
+    state.maxRecursionDepth = 1;
+
+    wgpu::RayTracingPipelineDescriptor pipelineDescriptor;
+    pipelineDescriptor.layout = utils::MakeBasicPipelineLayout(device, &bgl);
+    pipelineDescriptor.rayTracingState = &state;
+    shadowPipeline = device.CreateRayTracingPipeline(&pipelineDescriptor);
+
+    wgpu::BindGroupBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].accelerationContainer = instanceContainer;
+    bindings[1].binding = 1;
+    bindings[1].buffer = shadowBuffer;
+    bindings[1].size = shadowBufferDesc.size;
+
+    wgpu::BindGroupDescriptor bindGroupDescriptor;
+    bindGroupDescriptor.layout = bgl;
+    bindGroupDescriptor.bindingCount = 2;
+    bindGroupDescriptor.bindings = bindings;
+    shadowBindGroup = device.CreateBindGroup(&bindGroupDescriptor);
+
+    timer.reset(utils::CreateTimer());
+    timer->Start();
+}
+
 void init() {
-    device = CreateCppDawnDevice();
+    // Ray tracing is only supported on Vulkan.
+    device = stressOptions.enabled ? CreateCppDawnDevice(wgpu::BackendType::Vulkan)
+                                   : CreateCppDawnDevice();
 
     queue = device.CreateQueue();
     swapchain = GetSwapChain(device);
@@ -140,6 +349,10 @@ void init() {
 
     bindGroup =
         utils::MakeBindGroup(device, bgl, {{0, ubo, 0, sizeof(ShaderData)}});
+
+    if (stressOptions.enabled) {
+        initStress();
+    }
 }
 
 void frame() {
@@ -154,6 +367,18 @@ void frame() {
 
     utils::ComboRenderPassDescriptor renderPass({backbufferView});
     wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    if (stressOptions.enabled) {
+        UpdateInstanceTransforms(f / 60.0f);
+        instanceContainer.UpdateInstances(0, instances.size(), instances.data());
+        encoder.UpdateRayTracingAccelerationContainer(instanceContainer);
+
+        wgpu::RayTracingPassDescriptor rayTracingPass;
+        wgpu::RayTracingPassEncoder pass = encoder.BeginRayTracingPass(&rayTracingPass);
+        pass.SetPipeline(shadowPipeline);
+        pass.SetBindGroup(0, shadowBindGroup);
+        pass.TraceRays(0, 1, 2, stressOptions.shadowWidth, stressOptions.shadowHeight);
+        pass.EndPass();
+    }
     {
         wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
         pass.SetPipeline(pipeline);
@@ -168,21 +393,116 @@ void frame() {
     }
 
     wgpu::CommandBuffer commands = encoder.Finish();
-    queue.Submit(1, &commands);
+    if (stressOptions.enabled) {
+        double submitStart = timer->GetElapsedTime();
+        queue.Submit(1, &commands);
+        submitTimes.push_back(timer->GetElapsedTime() - submitStart);
+    } else {
+        queue.Submit(1, &commands);
+    }
     swapchain.Present();
     DoFlush();
-    fprintf(stderr, "frame %i\n", f);
+
+    if (stressOptions.enabled) {
+        // The frame time includes the time the swapchain waits on the GPU.
+        double frameStart = timer->GetElapsedTime();
+        frameTimes.push_back(frameStart - lastFrameStart);
+        lastFrameStart = frameStart;
+    } else {
+        fprintf(stderr, "frame %i\n", f);
+    }
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(std::ceil(percentile * values.size()));
+    return values[std::min(std::max(index, size_t(1)), values.size()) - 1];
+}
+
+void printStressResults() {
+    // The first frames include the creation of the backend objects, so they don't count.
+    size_t warmupFrames = std::min(frameTimes.size() / 10, size_t(10));
+    std::vector<double> sustainedFrameTimes(frameTimes.begin() + warmupFrames, frameTimes.end());
+    std::vector<double> sustainedSubmitTimes(submitTimes.begin() + warmupFrames,
+                                             submitTimes.end());
+
+    double totalFrameTime = 0.0;
+    for (double frameTime : sustainedFrameTimes) {
+        totalFrameTime += frameTime;
+    }
+
+    printf("%zu frames of %zu draws, %u animated instances, %ux%u shadow rays\n",
+           sustainedFrameTimes.size(), kNumTriangles, stressOptions.instanceCount,
+           stressOptions.shadowWidth, stressOptions.shadowHeight);
+    printf("frame time: mean %.3f ms, p99 %.3f ms\n",
+           totalFrameTime * 1000.0 / sustainedFrameTimes.size(),
+           Percentile(sustainedFrameTimes, 0.99) * 1000.0);
+    printf("submit CPU time: median %.3f ms, p99 %.3f ms\n",
+           Percentile(sustainedSubmitTimes, 0.5) * 1000.0,
+           Percentile(sustainedSubmitTimes, 0.99) * 1000.0);
+}
+
+bool ParsePositiveInteger(int argc, const char** argv, int* i, uint32_t* value) {
+    const char* option = argv[*i];
+    (*i)++;
+    if (*i < argc) {
+        char* end = nullptr;
+        unsigned long result = strtoul(argv[*i], &end, 10);
+        if (end != argv[*i] && *end == '\0' && result > 0 && result <= UINT32_MAX) {
+            *value = static_cast<uint32_t>(result);
+            return true;
+        }
+    }
+    fprintf(stderr, "%s expects a positive integer\n", option);
+    return false;
+}
+
+// Parses the options of this sample, the others are left to InitSample.
+bool ParseOptions(int argc, const char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string("--stress") == argv[i]) {
+            stressOptions.enabled = true;
+            continue;
+        }
+        if (std::string("--frames") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &stressOptions.frameCount)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--instances") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &stressOptions.instanceCount)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("-h") == argv[i] || std::string("--help") == argv[i]) {
+            printf("Animometer options:\n");
+            printf("  --stress           also update animated instances and trace shadow rays\n");
+            printf("                     each frame, then print the frame and submit times\n");
+            printf("  --frames N         frames to run in stress mode (default 600)\n");
+            printf("  --instances N      animated instances in stress mode (default 1024)\n");
+        }
+    }
+    return true;
 }
 
 int main(int argc, const char* argv[]) {
-    if (!InitSample(argc, argv)) {
+    if (!ParseOptions(argc, argv) || !InitSample(argc, argv)) {
         return 1;
     }
     init();
 
     while (!ShouldQuit()) {
         frame();
-        utils::USleep(16000);
+        if (stressOptions.enabled) {
+            if (frameTimes.size() == stressOptions.frameCount) {
+                printStressResults();
+                break;
+            }
+        } else {
+            utils::USleep(16000);
+        }
     }
 
     // TODO release stuff
@@ -18,11 +18,25 @@
 
 #include "SampleUtils.h"
 #include "utils/SystemUtils.h"
+#include "utils/Timer.h"
 #include "utils/WGPUHelpers.h"
 
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 WGPUDevice device;
 WGPUQueue queue;
 WGPUSwapChain swapchain;
+WGPUFence fence;
+uint64_t fenceValue = 0;
 
 WGPURenderPipeline pipeline;
 WGPUBindGroupLayout bindGroupLayout;
@@ -51,19 +65,196 @@ WGPUBindGroup rtBindGroup;
 WGPUPipelineLayout rtPipelineLayout;
 WGPURayTracingPipeline rtPipeline;
 
-uint32_t width = 640;
-uint32_t height = 480;
+// The swapchain has the size of the window, the pixel buffer is scaled to it.
+constexpr uint32_t kWindowWidth = 640;
+constexpr uint32_t kWindowHeight = 480;
+
+struct Options {
+    // Prints the time each frame spends building, updating and tracing against the acceleration
+    // containers, and animates the instances so that the top-level container changes every
+    // frame.
+    bool benchmark = false;
+    uint32_t frameCount = 100;
+    // Rebuilds the top-level container every frame instead of updating it.
+    bool rebuild = false;
+
+    uint32_t width = 640;
+    uint32_t height = 480;
+    uint32_t instanceCount = 1;
+    // Every geometry is a grid of |gridSize| x |gridSize| quads, or a single triangle when 0.
+    uint32_t gridSize = 0;
+    // Replaces the generated geometry when set.
+    const char* modelPath = nullptr;
+    // The closest hit shader bounces rays until this depth is reached.
+    uint32_t recursionDepth = 1;
+};
+Options options;
+
+uint64_t pixelBufferSize = 0;
+uint32_t triangleCount = 0;
+
+std::vector<std::array<float, 12>> instanceTransforms;
+std::vector<WGPURayTracingAccelerationInstanceDescriptor> instanceDescriptors;
 
-uint64_t pixelBufferSize = width * height * 4 * sizeof(float);
+std::unique_ptr<utils::Timer> timer;
+uint32_t frameIndex = 0;
+double totalBuildTime = 0.0;
+double totalUpdateTime = 0.0;
+double totalTraceTime = 0.0;
 
 struct CameraData {
     glm::mat4 view;
     glm::mat4 projection;
 };
 
+// Loads the positions and the faces of a Wavefront OBJ file, triangulating the polygons as fans.
+// The other attributes and the materials are ignored.
+bool LoadObj(const char* path, std::vector<float>* vertices, std::vector<uint32_t>* indices) {
+    std::ifstream file(path);
+    if (!file) {
+        fprintf(stderr, "Couldn't open %s\n", path);
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+        if (keyword == "v") {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            stream >> x >> y >> z;
+            vertices->insert(vertices->end(), {x, y, z});
+        } else if (keyword == "f") {
+            int64_t vertexCount = static_cast<int64_t>(vertices->size() / 3);
+            std::vector<uint32_t> face;
+            std::string vertex;
+            while (stream >> vertex) {
+                // The position is the first index of "v/vt/vn", negative indices are relative to
+                // the last vertex.
+                int64_t index = strtoll(vertex.c_str(), nullptr, 10);
+                if (index < 0) {
+                    index += vertexCount + 1;
+                }
+                if (index < 1 || index > vertexCount) {
+                    fprintf(stderr, "Invalid face in %s: %s\n", path, line.c_str());
+                    return false;
+                }
+                face.push_back(static_cast<uint32_t>(index - 1));
+            }
+            for (size_t i = 2; i < face.size(); ++i) {
+                indices->insert(indices->end(), {face[0], face[i - 1], face[i]});
+            }
+        }
+    }
+
+    if (indices->empty()) {
+        fprintf(stderr, "%s has no faces\n", path);
+        return false;
+    }
+
+    // Fit the model in the [-1, 1] box the generated geometries are in.
+    glm::vec3 minimum(FLT_MAX);
+    glm::vec3 maximum(-FLT_MAX);
+    for (size_t i = 0; i < vertices->size(); i += 3) {
+        glm::vec3 position = glm::make_vec3(&(*vertices)[i]);
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+    glm::vec3 center = (minimum + maximum) * 0.5f;
+    glm::vec3 extent = maximum - minimum;
+    float scale = 2.0f / std::max(std::max(extent.x, extent.y), std::max(extent.z, FLT_MIN));
+    for (size_t i = 0; i < vertices->size(); i += 3) {
+        for (size_t j = 0; j < 3; ++j) {
+            (*vertices)[i + j] = ((*vertices)[i + j] - center[j]) * scale;
+        }
+    }
+    return true;
+}
+
+// A grid of |gridSize| x |gridSize| quads over [-1, 1] with a bumpy surface, so that the bounced
+// rays can hit it again.
+void CreateGrid(uint32_t gridSize, std::vector<float>* vertices, std::vector<uint32_t>* indices) {
+    for (uint32_t y = 0; y <= gridSize; ++y) {
+        for (uint32_t x = 0; x <= gridSize; ++x) {
+            float px = static_cast<float>(x) / gridSize * 2.0f - 1.0f;
+            float py = static_cast<float>(y) / gridSize * 2.0f - 1.0f;
+            float pz = 0.1f * std::sin(px * 8.0f) * std::cos(py * 8.0f);
+            vertices->insert(vertices->end(), {px, py, pz});
+        }
+    }
+    for (uint32_t y = 0; y < gridSize; ++y) {
+        for (uint32_t x = 0; x < gridSize; ++x) {
+            uint32_t i = y * (gridSize + 1) + x;
+            indices->insert(indices->end(), {i, i + 1, i + gridSize + 1});
+            indices->insert(indices->end(), {i + 1, i + gridSize + 2, i + gridSize + 1});
+        }
+    }
+}
+
+// Lays the instances out in a square grid scaled to fit the view. In benchmark mode they move
+// every frame.
+void UpdateInstanceDescriptors() {
+    uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(options.instanceCount)));
+    float scale = 1.0f / columns;
+
+    instanceTransforms.resize(options.instanceCount);
+    instanceDescriptors.resize(options.instanceCount);
+    for (uint32_t i = 0; i < options.instanceCount; ++i) {
+        float x = (2 * (i % columns) + 1) * scale - 1.0f;
+        float y = (2 * (i / columns) + 1) * scale - 1.0f;
+        float z = options.benchmark ? 0.1f * std::sin(0.1f * frameIndex + i) : 0.0f;
+
+        // clang-format off
+        instanceTransforms[i] = {
+            scale, 0.0f,  0.0f,  x,
+            0.0f,  scale, 0.0f,  y,
+            0.0f,  0.0f,  scale, z
+        };
+        // clang-format on
+
+        WGPURayTracingAccelerationInstanceDescriptor& instanceDescriptor = instanceDescriptors[i];
+        instanceDescriptor.flags = WGPURayTracingAccelerationInstanceFlag_TriangleCullDisable;
+        instanceDescriptor.instanceId = i;
+        instanceDescriptor.instanceOffset = 0x0;
+        instanceDescriptor.mask = 0xFF;
+        instanceDescriptor.geometryContainer = geometryContainer;
+        instanceDescriptor.transformMatrix = instanceTransforms[i].data();
+        instanceDescriptor.transformMatrixSize = 12;
+        instanceDescriptor.transform = nullptr;
+    }
+}
+
+// Submits the commands and waits for the GPU to execute them. Returns the elapsed time in
+// milliseconds.
+double SubmitAndWait(WGPUCommandEncoder encoder) {
+    double start = timer->GetAbsoluteTime();
+
+    WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(encoder, nullptr);
+    wgpuQueueSubmit(queue, 1, &commandBuffer);
+    wgpuQueueSignal(queue, fence, ++fenceValue);
+    while (wgpuFenceGetCompletedValue(fence) < fenceValue) {
+        wgpuDeviceTick(device);
+        DoFlush();
+    }
+
+    wgpuCommandEncoderRelease(encoder);
+    wgpuCommandBufferRelease(commandBuffer);
+    return (timer->GetAbsoluteTime() - start) * 1000.0;
+}
+
 void init() {
     device = CreateCppDawnDevice(wgpu::BackendType::Vulkan).Release();
-    queue = wgpuDeviceCreateQueue(device);
+    queue = wgpuDeviceCreateQueue(device, nullptr);
+
+    {
+        WGPUFenceDescriptor descriptor;
+        descriptor.nextInChain = nullptr;
+        descriptor.label = nullptr;
+        descriptor.initialValue = 0;
+        fence = wgpuQueueCreateFence(queue, &descriptor);
+    }
+    timer.reset(utils::CreateTimer());
 
     {
         WGPUSwapChainDescriptor descriptor;
@@ -73,14 +264,28 @@ void init() {
         swapchain = wgpuDeviceCreateSwapChain(device, nullptr, &descriptor);
     }
     swapChainFormat = static_cast<WGPUTextureFormat>(GetPreferredSwapChainTextureFormat());
-    wgpuSwapChainConfigure(swapchain, swapChainFormat, WGPUTextureUsage_OutputAttachment, width,
-                           height);
+    wgpuSwapChainConfigure(swapchain, swapChainFormat, WGPUTextureUsage_OutputAttachment,
+                           kWindowWidth, kWindowHeight);
+
+    pixelBufferSize = uint64_t(options.width) * options.height * 4 * sizeof(float);
+
+    // The options are passed to the shaders as defines.
+    const std::string rayTracingHeader = "#version 460\n"
+                                         "#extension GL_NV_ray_tracing : require\n"
+                                         "#define MAX_RECURSION_DEPTH " +
+                                         std::to_string(options.recursionDepth) + "\n";
+    const std::string blitHeader = "#version 460\n"
+                                   "#define RESOLUTION vec2(" +
+                                   std::to_string(options.width) + ", " +
+                                   std::to_string(options.height) + ")\n";
 
     const char* rayGen = R"(
-        #version 460
-        #extension GL_NV_ray_tracing : require
+        struct Payload {
+            vec3 color;
+            uint depth;
+        };
 
-        layout(location = 0) rayPayloadNV vec3 hitValue;
+        layout(location = 0) rayPayloadNV Payload payload;
 
         layout(binding = 0, set = 0) uniform accelerationStructureNV topLevelAS;
 
@@ -105,36 +310,59 @@ void init() {
             vec4 target = uCamera.projection * (vec4(uv.x, uv.y, 1, 1));
             vec4 direction = uCamera.view * vec4(normalize(target.xyz), 0);
 
-            hitValue = vec3(0);
+            payload.color = vec3(0);
+            payload.depth = 1;
             traceNV(topLevelAS, gl_RayFlagsOpaqueNV, 0xFF, 0, 0, 0, origin.xyz, 0.01, direction.xyz, 4096.0, 0);
 
             const uint pixelIndex = ipos.y * resolution.x + ipos.x;
-            pixelBuffer.pixels[pixelIndex] = vec4(hitValue, 1);
+            pixelBuffer.pixels[pixelIndex] = vec4(payload.color, 1);
         }
     )";
 
     const char* rayCHit = R"(
-        #version 460
-        #extension GL_NV_ray_tracing : require
+        struct Payload {
+            vec3 color;
+            uint depth;
+        };
 
-        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        layout(location = 0) rayPayloadInNV Payload payload;
+        layout(location = 1) rayPayloadNV Payload bounce;
 
-        hitAttributeNV vec3 attribs;
+        layout(binding = 0, set = 0) uniform accelerationStructureNV topLevelAS;
+
+        hitAttributeNV vec2 attribs;
 
         void main() {
             const vec3 bary = vec3(1.0 - attribs.x - attribs.y, attribs.x, attribs.y);
-            hitValue = bary;
+            payload.color = bary;
+
+            if (payload.depth < MAX_RECURSION_DEPTH) {
+                // Bounce back to the side the ray came from, in a direction that differs for each
+                // pixel and depth so that the secondary rays are incoherent.
+                const vec3 seed = vec3(gl_LaunchIDNV.xy, payload.depth);
+                const vec3 jitter = fract(sin(seed * vec3(12.9898, 78.233, 37.719)) * 43758.5453);
+                const vec3 origin = gl_WorldRayOriginNV + gl_WorldRayDirectionNV * gl_HitTNV;
+                const vec3 direction = normalize(jitter - 0.5 - gl_WorldRayDirectionNV);
+
+                bounce.color = vec3(0);
+                bounce.depth = payload.depth + 1;
+                traceNV(topLevelAS, gl_RayFlagsOpaqueNV, 0xFF, 0, 0, 0, origin, 0.01, direction,
+                        4096.0, 1);
+                payload.color = mix(bary, bounce.color, 0.5);
+            }
         }
     )";
 
     const char* rayMiss = R"(
-        #version 460
-        #extension GL_NV_ray_tracing : require
+        struct Payload {
+            vec3 color;
+            uint depth;
+        };
 
-        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        layout(location = 0) rayPayloadInNV Payload payload;
 
         void main() {
-            hitValue = vec3(0.15);
+            payload.color = vec3(0.15);
         }
     )";
 
@@ -151,8 +379,6 @@ void init() {
     )";
 
     const char* fs = R"(
-        #version 460
-
         layout (location = 0) in vec2 uv;
         layout (location = 0) out vec4 outColor;
 
@@ -160,7 +386,7 @@ void init() {
             vec4 pixels[];
         } pixelBuffer;
 
-        const vec2 resolution = vec2(640, 480);
+        const vec2 resolution = RESOLUTION;
 
         void main() {
             const ivec2 bufferCoord = ivec2(floor(uv * resolution));
@@ -175,51 +401,66 @@ void init() {
     vsModule = utils::CreateShaderModule(wgpu::Device(device), utils::SingleShaderStage::Vertex, vs)
                    .Release();
 
-    fsModule = utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment, fs).Release();
+    fsModule = utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment,
+                                         (blitHeader + fs).c_str())
+                   .Release();
+
+    rayGenModule = utils::CreateShaderModule(device, utils::SingleShaderStage::RayGeneration,
+                                             (rayTracingHeader + rayGen).c_str())
+                       .Release();
 
-    rayGenModule =
-        utils::CreateShaderModule(device, utils::SingleShaderStage::RayGeneration, rayGen)
-            .Release();
+    rayCHitModule = utils::CreateShaderModule(device, utils::SingleShaderStage::RayClosestHit,
+                                              (rayTracingHeader + rayCHit).c_str())
+                        .Release();
 
-    rayCHitModule =
-        utils::CreateShaderModule(device, utils::SingleShaderStage::RayClosestHit, rayCHit)
-            .Release();
+    rayMissModule = utils::CreateShaderModule(device, utils::SingleShaderStage::RayMiss,
+                                              (rayTracingHeader + rayMiss).c_str())
+                        .Release();
 
-    rayMissModule =
-        utils::CreateShaderModule(device, utils::SingleShaderStage::RayMiss, rayMiss).Release();
+    std::vector<float> vertexData;
+    std::vector<uint32_t> indexData;
+    if (options.modelPath != nullptr) {
+        if (!LoadObj(options.modelPath, &vertexData, &indexData)) {
+            exit(1);
+        }
+    } else if (options.gridSize > 0) {
+        CreateGrid(options.gridSize, &vertexData, &indexData);
+    } else {
+        // clang-format off
+        vertexData = {
+             1.0f,  1.0f,  0.0f,
+            -1.0f,  1.0f,  0.0f,
+             0.0f, -1.0f,  0.0f
+        };
+        indexData = {
+            0, 1, 2
+        };
+        // clang-format on
+    }
+    triangleCount = static_cast<uint32_t>(indexData.size() / 3);
 
-    // clang-format off
-    const float vertexData[] = {
-         1.0f,  1.0f,  0.0f,
-        -1.0f,  1.0f,  0.0f,
-         0.0f, -1.0f,  0.0f
-    };
-    // clang-format on
+    uint64_t vertexDataSize = vertexData.size() * sizeof(float);
     {
         WGPUBufferDescriptor descriptor;
         descriptor.label = nullptr;
         descriptor.nextInChain = nullptr;
-        descriptor.size = sizeof(vertexData);
+        descriptor.size = vertexDataSize;
         descriptor.usage = WGPUBufferUsage_CopyDst;
 
         vertexBuffer = wgpuDeviceCreateBuffer(device, &descriptor);
-        wgpuBufferSetSubData(vertexBuffer, 0, sizeof(vertexData), vertexData);
+        wgpuBufferSetSubData(vertexBuffer, 0, vertexDataSize, vertexData.data());
     }
 
-    // clang-format off
-    const uint32_t indexData[] = {
-        0, 1, 2
-    };
-    // clang-format on
+    uint64_t indexDataSize = indexData.size() * sizeof(uint32_t);
     {
         WGPUBufferDescriptor descriptor;
         descriptor.label = nullptr;
         descriptor.nextInChain = nullptr;
-        descriptor.size = sizeof(indexData);
+        descriptor.size = indexDataSize;
         descriptor.usage = WGPUBufferUsage_CopyDst;
 
         indexBuffer = wgpuDeviceCreateBuffer(device, &descriptor);
-        wgpuBufferSetSubData(indexBuffer, 0, sizeof(indexData), indexData);
+        wgpuBufferSetSubData(indexBuffer, 0, indexDataSize, indexData.data());
     }
 
     {
@@ -241,7 +482,7 @@ void init() {
 
         CameraData data = {};
 
-        float aspect = width / height;
+        float aspect = static_cast<float>(options.width) / options.height;
         data.projection = glm::perspective(2.0f * glm::pi<float>() / 5.0f, -aspect, 0.1f, 4096.0f);
         data.projection = glm::inverse(data.projection);
         data.projection[1][1] *= -1.0f;
@@ -259,13 +500,13 @@ void init() {
         vertexDescriptor.buffer = vertexBuffer;
         vertexDescriptor.format = WGPUVertexFormat_Float3;
         vertexDescriptor.stride = 3 * sizeof(float);
-        vertexDescriptor.count = sizeof(vertexData) / sizeof(float);
+        vertexDescriptor.count = static_cast<uint32_t>(vertexData.size() / 3);
 
         WGPURayTracingAccelerationGeometryIndexDescriptor indexDescriptor;
         indexDescriptor.offset = 0;
         indexDescriptor.buffer = indexBuffer;
         indexDescriptor.format = WGPUIndexFormat_Uint32;
-        indexDescriptor.count = sizeof(indexData) / sizeof(uint32_t);
+        indexDescriptor.count = static_cast<uint32_t>(indexData.size());
 
         WGPURayTracingAccelerationGeometryDescriptor geometry;
         geometry.flags = WGPURayTracingAccelerationGeometryFlag_Opaque;
@@ -273,6 +514,7 @@ void init() {
         geometry.vertex = &vertexDescriptor;
         geometry.index = &indexDescriptor;
         geometry.aabb = nullptr;
+        geometry.transform = nullptr;
 
         WGPURayTracingAccelerationContainerDescriptor descriptor;
         descriptor.level = WGPURayTracingAccelerationContainerLevel_Bottom;
@@ -282,37 +524,28 @@ void init() {
         descriptor.instanceCount = 0;
         descriptor.instances = nullptr;
         descriptor.instanceBuffer = nullptr;
+        descriptor.instanceBufferOffset = 0;
+        descriptor.updateRebuildThreshold = 0;
 
         geometryContainer = wgpuDeviceCreateRayTracingAccelerationContainer(device, &descriptor);
     }
 
     {
-        // clang-format off
-        const float transformMatrix[] = {
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f
-		};
-        // clang-format on
-
-        WGPURayTracingAccelerationInstanceDescriptor instanceDescriptor;
-        instanceDescriptor.flags = WGPURayTracingAccelerationInstanceFlag_TriangleCullDisable;
-        instanceDescriptor.instanceId = 0;
-        instanceDescriptor.instanceOffset = 0x0;
-        instanceDescriptor.mask = 0xFF;
-        instanceDescriptor.geometryContainer = geometryContainer;
-        instanceDescriptor.transformMatrix = transformMatrix;
-        instanceDescriptor.transformMatrixSize = 12;
-        instanceDescriptor.transform = nullptr;
+        UpdateInstanceDescriptors();
 
         WGPURayTracingAccelerationContainerDescriptor descriptor;
         descriptor.level = WGPURayTracingAccelerationContainerLevel_Top;
         descriptor.flags = WGPURayTracingAccelerationContainerFlag_PreferFastTrace;
+        if (options.benchmark && !options.rebuild) {
+            descriptor.flags |= WGPURayTracingAccelerationContainerFlag_AllowUpdate;
+        }
         descriptor.geometryCount = 0;
         descriptor.geometries = nullptr;
-        descriptor.instanceCount = 1;
-        descriptor.instances = &instanceDescriptor;
+        descriptor.instanceCount = options.instanceCount;
+        descriptor.instances = instanceDescriptors.data();
         descriptor.instanceBuffer = nullptr;
+        descriptor.instanceBufferOffset = 0;
+        descriptor.updateRebuildThreshold = 0;
 
         instanceContainer = wgpuDeviceCreateRayTracingAccelerationContainer(device, &descriptor);
     }
@@ -323,11 +556,18 @@ void init() {
         wgpuCommandEncoderBuildRayTracingAccelerationContainer(encoder, geometryContainer);
         wgpuCommandEncoderBuildRayTracingAccelerationContainer(encoder, instanceContainer);
 
-        WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(encoder, nullptr);
-        wgpuQueueSubmit(queue, 1, &commandBuffer);
-
-        wgpuCommandEncoderRelease(encoder);
-        wgpuCommandBufferRelease(commandBuffer);
+        if (options.benchmark) {
+            double buildTime = SubmitAndWait(encoder);
+            printf("%u triangles, %u instances, %ux%u, recursion depth %u\n", triangleCount,
+                   options.instanceCount, options.width, options.height, options.recursionDepth);
+            printf("initial build: %.3f ms\n", buildTime);
+        } else {
+            WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(encoder, nullptr);
+            wgpuQueueSubmit(queue, 1, &commandBuffer);
+
+            wgpuCommandEncoderRelease(encoder);
+            wgpuCommandBufferRelease(commandBuffer);
+        }
     }
 
     WGPURayTracingShaderBindingTable sbt;
@@ -357,11 +597,12 @@ void init() {
 
     {
         WGPUBindGroupLayoutBinding bindingDescriptors[3];
-        // acceleration container
+        // acceleration container, the closest hit shader traces the bounced rays
         bindingDescriptors[0] = {};
         bindingDescriptors[0].binding = 0;
         bindingDescriptors[0].type = WGPUBindingType_AccelerationContainer;
-        bindingDescriptors[0].visibility = WGPUShaderStage_RayGeneration;
+        bindingDescriptors[0].visibility =
+            WGPUShaderStage_RayGeneration | WGPUShaderStage_RayClosestHit;
         // pixel buffer
         bindingDescriptors[1] = {};
         bindingDescriptors[1].binding = 1;
@@ -434,7 +675,7 @@ void init() {
 
     {
         WGPURayTracingStateDescriptor rtStateDescriptor;
-        rtStateDescriptor.maxRecursionDepth = 1;
+        rtStateDescriptor.maxRecursionDepth = options.recursionDepth;
         rtStateDescriptor.shaderBindingTable = sbt;
 
         WGPURayTracingPipelineDescriptor descriptor;
@@ -554,6 +795,24 @@ void init() {
 void frame() {
     WGPUTextureView backbufferView = wgpuSwapChainGetCurrentTextureView(swapchain);
 
+    double buildTime = 0.0;
+    double updateTime = 0.0;
+    if (options.benchmark) {
+        frameIndex++;
+        UpdateInstanceDescriptors();
+        wgpuRayTracingAccelerationContainerUpdateInstances(
+            instanceContainer, 0, options.instanceCount, instanceDescriptors.data());
+
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        if (options.rebuild) {
+            wgpuCommandEncoderBuildRayTracingAccelerationContainer(encoder, instanceContainer);
+            buildTime = SubmitAndWait(encoder);
+        } else {
+            wgpuCommandEncoderUpdateRayTracingAccelerationContainer(encoder, instanceContainer);
+            updateTime = SubmitAndWait(encoder);
+        }
+    }
+
     {
         WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
 
@@ -565,14 +824,24 @@ void frame() {
             wgpuCommandEncoderBeginRayTracingPass(encoder, &rayTracingPassInfo);
         wgpuRayTracingPassEncoderSetPipeline(pass, rtPipeline);
         wgpuRayTracingPassEncoderSetBindGroup(pass, 0, rtBindGroup, 0, nullptr);
-        wgpuRayTracingPassEncoderTraceRays(pass, 0, 1, 2, width, height, 1);
+        wgpuRayTracingPassEncoderTraceRays(pass, 0, 1, 2, options.width, options.height, 1, 0);
         wgpuRayTracingPassEncoderEndPass(pass);
         wgpuRayTracingPassEncoderRelease(pass);
 
-        WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(encoder, nullptr);
-        wgpuCommandEncoderRelease(encoder);
-        wgpuQueueSubmit(queue, 1, &commandBuffer);
-        wgpuCommandBufferRelease(commandBuffer);
+        if (options.benchmark) {
+            double traceTime = SubmitAndWait(encoder);
+            printf("frame %u: build %.3f ms, update %.3f ms, trace %.3f ms\n", frameIndex,
+                   buildTime, updateTime, traceTime);
+
+            totalBuildTime += buildTime;
+            totalUpdateTime += updateTime;
+            totalTraceTime += traceTime;
+        } else {
+            WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(encoder, nullptr);
+            wgpuCommandEncoderRelease(encoder);
+            wgpuQueueSubmit(queue, 1, &commandBuffer);
+            wgpuCommandBufferRelease(commandBuffer);
+        }
     }
 
     {
@@ -613,15 +882,111 @@ void frame() {
     DoFlush();
 }
 
+bool ParsePositiveInteger(int argc, const char** argv, int* i, uint32_t* value) {
+    const char* option = argv[*i];
+    (*i)++;
+    if (*i < argc) {
+        char* end = nullptr;
+        unsigned long result = strtoul(argv[*i], &end, 10);
+        if (end != argv[*i] && *end == '\0' && result > 0 && result <= UINT32_MAX) {
+            *value = static_cast<uint32_t>(result);
+            return true;
+        }
+    }
+    fprintf(stderr, "%s expects a positive integer\n", option);
+    return false;
+}
+
+// Parses the options of this sample, the others are left to InitSample.
+bool ParseOptions(int argc, const char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string("--benchmark") == argv[i]) {
+            options.benchmark = true;
+            continue;
+        }
+        if (std::string("--rebuild") == argv[i]) {
+            options.rebuild = true;
+            continue;
+        }
+        if (std::string("--frames") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.frameCount)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--width") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.width)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--height") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.height)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--instances") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.instanceCount)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--grid") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.gridSize)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--recursion") == argv[i]) {
+            if (!ParsePositiveInteger(argc, argv, &i, &options.recursionDepth)) {
+                return false;
+            }
+            continue;
+        }
+        if (std::string("--model") == argv[i]) {
+            i++;
+            if (i < argc) {
+                options.modelPath = argv[i];
+                continue;
+            }
+            fprintf(stderr, "--model expects the path of an OBJ file\n");
+            return false;
+        }
+        if (std::string("-h") == argv[i] || std::string("--help") == argv[i]) {
+            printf("Ray tracing options:\n");
+            printf("  --benchmark        print the build, update and trace time of each frame\n");
+            printf("  --frames N         frames to run in benchmark mode (default 100)\n");
+            printf("  --rebuild          rebuild the top-level container instead of updating\n");
+            printf("  --width N          width of the traced image (default 640)\n");
+            printf("  --height N         height of the traced image (default 480)\n");
+            printf("  --instances N      instances of the geometry (default 1)\n");
+            printf("  --grid N           use a grid of N x N quads instead of a triangle\n");
+            printf("  --model PATH       use the triangles of an OBJ file as the geometry\n");
+            printf("  --recursion N      maximum recursion depth of the rays (default 1)\n");
+        }
+    }
+    return true;
+}
+
 int main(int argc, const char* argv[]) {
-    if (!InitSample(argc, argv)) {
+    if (!ParseOptions(argc, argv) || !InitSample(argc, argv)) {
         return 1;
     }
     init();
 
     while (!ShouldQuit()) {
         frame();
-        utils::USleep(16000);
+        if (options.benchmark) {
+            if (frameIndex == options.frameCount) {
+                printf("average over %u frames: build %.3f ms, update %.3f ms, trace %.3f ms\n",
+                       frameIndex, totalBuildTime / frameIndex, totalUpdateTime / frameIndex,
+                       totalTraceTime / frameIndex);
+                break;
+            }
+        } else {
+            utils::USleep(16000);
+        }
     }
 
     // TODO release stuff
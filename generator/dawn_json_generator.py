@@ -318,6 +318,8 @@ def compute_wire_params(api_params, wire_json):
     commands = []
     return_commands = []
 
+    # Native-only commands aren't sent on the wire either, their client procs are generated stubs.
+    wire_json['special items']['client_side_commands'] += wire_json['special items']['client_unsupported_commands']
     wire_json['special items']['client_handwritten_commands'] += wire_json['special items']['client_side_commands']
 
     # Generate commands from object methods
@@ -328,7 +330,7 @@ def compute_wire_params(api_params, wire_json):
             ret_type = method.return_type.name.canonical_case()
 
             # Only object return values or void are supported. Other methods must be handwritten.
-            if method.return_type.category != 'object' and ret_type != 'void' and command_suffix != 'RayTracingAccelerationContainerGetHandle':
+            if method.return_type.category != 'object' and ret_type != 'void':
                 assert(command_suffix in wire_json['special items']['client_handwritten_commands'])
                 continue
 
@@ -368,8 +370,32 @@ def compute_wire_params(api_params, wire_json):
 
     wire_params.update(wire_json.get('special items', {}))
 
+    # Commands that can also be sent with the compact encoding, see WireCmd.cpp.
+    commands_by_suffix = {c.name.CamelCase(): c for c in wire_params['cmd_records']['command']}
+    wire_params['compact_cmd_records'] = []
+    for command_suffix in wire_params.get('compact_commands', []):
+        command = commands_by_suffix[command_suffix]
+        assert(command.derived_method != None)
+        assert(command_suffix not in wire_params['client_handwritten_commands'])
+        assert(command_suffix not in wire_params['server_custom_pre_handler_commands'])
+        assert(all(is_compact_member(member) for member in command.members))
+        wire_params['compact_cmd_records'].append(command)
+
     return wire_params
 
+# The compact encoding only handles members that are integers on the wire.
+compact_native_types = ['bool', 'int32_t', 'int64_t', 'uint32_t', 'uint64_t']
+def is_compact_member(member):
+    if member.is_return_value or member.skip_serialize:
+        return False
+    if member.annotation == 'value':
+        return (member.type.category in ['object', 'enum', 'bitmask'] or
+                member.type.name.canonical_case() in compact_native_types)
+    if member.annotation == 'const*':
+        return (member.type.name.canonical_case() in compact_native_types and
+                isinstance(member.length, RecordMember))
+    return False
+
 #############################################################
 # Generator
 #############################################################
@@ -515,7 +541,7 @@ class MultiGeneratorFromDawnJSON(Generator):
         return 'Generates code for various target from Dawn.json.'
 
     def add_commandline_arguments(self, parser):
-        allowed_targets = ['dawn_headers', 'dawncpp_headers', 'dawncpp', 'dawn_proc', 'mock_webgpu', 'dawn_wire', "dawn_native_utils"]
+        allowed_targets = ['dawn_headers', 'dawncpp_headers', 'dawncpp', 'dawncpp_native', 'dawn_proc', 'mock_webgpu', 'dawn_wire', "dawn_native_utils"]
 
         parser.add_argument('--dawn-json', required=True, type=str, help ='The DAWN JSON definition to use.')
         parser.add_argument('--wire-json', default=None, type=str, help='The DAWN WIRE JSON definition to use.')
@@ -570,7 +596,10 @@ class MultiGeneratorFromDawnJSON(Generator):
             renders.append(FileRender('dawn_proc.c', 'src/dawn/dawn_proc.c', [base_params, api_params]))
 
         if 'dawncpp' in targets:
-            renders.append(FileRender('webgpu_cpp.cpp', 'src/dawn/webgpu_cpp.cpp', [base_params, api_params]))
+            renders.append(FileRender('webgpu_cpp.cpp', 'src/dawn/webgpu_cpp.cpp', [base_params, api_params, {'direct_native_dispatch': False}]))
+
+        if 'dawncpp_native' in targets:
+            renders.append(FileRender('webgpu_cpp.cpp', 'src/dawn_native/webgpu_cpp_native.cpp', [base_params, api_params, {'direct_native_dispatch': True}]))
 
         if 'emscripten_bits' in targets:
             renders.append(FileRender('webgpu_struct_info.json', 'src/dawn/webgpu_struct_info.json', [base_params, api_params]))
@@ -602,6 +631,7 @@ class MultiGeneratorFromDawnJSON(Generator):
             renders.append(FileRender('dawn_native/wgpu_structs.h', 'src/dawn_native/wgpu_structs_autogen.h', frontend_params))
             renders.append(FileRender('dawn_native/wgpu_structs.cpp', 'src/dawn_native/wgpu_structs_autogen.cpp', frontend_params))
             renders.append(FileRender('dawn_native/ProcTable.cpp', 'src/dawn_native/ProcTable.cpp', frontend_params))
+            renders.append(FileRender('dawn_native/ProcTable.h', 'src/dawn_native/ProcTable_autogen.h', frontend_params))
 
         if 'dawn_wire' in targets:
             additional_params = compute_wire_params(api_params, wire_json)
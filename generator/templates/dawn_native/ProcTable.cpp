@@ -12,6 +12,8 @@
 //* See the License for the specific language governing permissions and
 //* limitations under the License.
 
+#include "dawn_native/ProcTable_autogen.h"
+
 #include "dawn_native/dawn_platform.h"
 #include "dawn_native/DawnNative.h"
 
@@ -35,52 +37,69 @@ namespace dawn_native {
     using RenderPassEncoderBase = RenderPassEncoder;
     using RenderBundleEncoderBase = RenderBundleEncoder;
     using SurfaceBase = Surface;
+    using TransientUniformAllocatorBase = TransientUniformAllocator;
+
+    {% set unlocked_object_types = [
+        "command encoder", "compute pass encoder", "ray tracing pass encoder",
+        "render bundle encoder", "render pass encoder", "instance", "surface"
+    ] %}
+    {% for type in by_category["object"] %}
+        {% for method in c_methods(type) %}
+            {% set suffix = as_MethodSuffix(type.name, method.name) %}
+
+            {{as_cType(method.return_type.name)}} Native{{suffix}}(
+                {{-as_cType(type.name)}} cSelf
+                {%- for arg in method.arguments -%}
+                    , {{as_annotated_cType(arg)}}
+                {%- endfor -%}
+            ) {
+                //* Perform conversion between C types and frontend types
+                auto self = reinterpret_cast<{{as_frontendType(type)}}>(cSelf);
+
+                //* All calls into a device are serialized, except the command recording of
+                //* encoders which can happen on multiple threads, one thread per encoder.
+                //* Releases are guarded when the object gets deleted.
+                {% set type_name = type.name.canonical_case() %}
+                {% if method.name.canonical_case() not in ["reference", "release"] %}
+                    {% if type_name == "device" %}
+                        DeviceLock lock(self->GetMutex());
+                    {% elif type_name not in unlocked_object_types %}
+                        DeviceLock lock(self->GetDevice()->GetMutex());
+                    {% endif %}
+                {% endif %}
+
+                {% for arg in method.arguments %}
+                    {% set varName = as_varName(arg.name) %}
+                    {% if arg.type.category in ["enum", "bitmask"] %}
+                        auto {{varName}}_ = static_cast<{{as_frontendType(arg.type)}}>({{varName}});
+                    {% elif arg.annotation != "value" or arg.type.category == "object" %}
+                        auto {{varName}}_ = reinterpret_cast<{{decorate("", as_frontendType(arg.type), arg)}}>({{varName}});
+                    {% else %}
+                        auto {{varName}}_ = {{as_varName(arg.name)}};
+                    {% endif %}
+                {%- endfor-%}
 
-    namespace {
-
-        {% for type in by_category["object"] %}
-            {% for method in c_methods(type) %}
-                {% set suffix = as_MethodSuffix(type.name, method.name) %}
-
-                {{as_cType(method.return_type.name)}} Native{{suffix}}(
-                    {{-as_cType(type.name)}} cSelf
+                {% if method.return_type.name.canonical_case() != "void" %}
+                    auto result =
+                {%- endif %}
+                self->{{method.name.CamelCase()}}(
                     {%- for arg in method.arguments -%}
-                        , {{as_annotated_cType(arg)}}
+                        {%- if not loop.first %}, {% endif -%}
+                        {{as_varName(arg.name)}}_
                     {%- endfor -%}
-                ) {
-                    //* Perform conversion between C types and frontend types
-                    auto self = reinterpret_cast<{{as_frontendType(type)}}>(cSelf);
-
-                    {% for arg in method.arguments %}
-                        {% set varName = as_varName(arg.name) %}
-                        {% if arg.type.category in ["enum", "bitmask"] %}
-                            auto {{varName}}_ = static_cast<{{as_frontendType(arg.type)}}>({{varName}});
-                        {% elif arg.annotation != "value" or arg.type.category == "object" %}
-                            auto {{varName}}_ = reinterpret_cast<{{decorate("", as_frontendType(arg.type), arg)}}>({{varName}});
-                        {% else %}
-                            auto {{varName}}_ = {{as_varName(arg.name)}};
-                        {% endif %}
-                    {%- endfor-%}
-
-                    {% if method.return_type.name.canonical_case() != "void" %}
-                        auto result =
-                    {%- endif %}
-                    self->{{method.name.CamelCase()}}(
-                        {%- for arg in method.arguments -%}
-                            {%- if not loop.first %}, {% endif -%}
-                            {{as_varName(arg.name)}}_
-                        {%- endfor -%}
-                    );
-                    {% if method.return_type.name.canonical_case() != "void" %}
-                        {% if method.return_type.category == "object" %}
-                            return reinterpret_cast<{{as_cType(method.return_type.name)}}>(result);
-                        {% else %}
-                            return result;
-                        {% endif %}
+                );
+                {% if method.return_type.name.canonical_case() != "void" %}
+                    {% if method.return_type.category == "object" %}
+                        return reinterpret_cast<{{as_cType(method.return_type.name)}}>(result);
+                    {% else %}
+                        return result;
                     {% endif %}
-                }
-            {% endfor %}
+                {% endif %}
+            }
         {% endfor %}
+    {% endfor %}
+
+    namespace {
 
         struct ProcEntry {
             WGPUProc proc;
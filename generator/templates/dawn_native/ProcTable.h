@@ -0,0 +1,40 @@
+//* Copyright 2020 The Dawn Authors
+//*
+//* Licensed under the Apache License, Version 2.0 (the "License");
+//* you may not use this file except in compliance with the License.
+//* You may obtain a copy of the License at
+//*
+//*     http://www.apache.org/licenses/LICENSE-2.0
+//*
+//* Unless required by applicable law or agreed to in writing, software
+//* distributed under the License is distributed on an "AS IS" BASIS,
+//* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//* See the License for the specific language governing permissions and
+//* limitations under the License.
+
+#ifndef BACKEND_PROCTABLE_H_
+#define BACKEND_PROCTABLE_H_
+
+#include "dawn/webgpu.h"
+
+namespace dawn_native {
+
+    // The dawn_native entry points for each function of the C API, that the proc table points to.
+    // They can be called directly to skip the proc table, see webgpu_cpp_native.cpp.
+    {% for type in by_category["object"] %}
+        {% for method in c_methods(type) %}
+            {{as_cType(method.return_type.name)}} Native{{as_MethodSuffix(type.name, method.name)}}(
+                {{-as_cType(type.name)}} cSelf
+                {%- for arg in method.arguments -%}
+                    , {{as_annotated_cType(arg)}}
+                {%- endfor -%}
+            );
+        {% endfor %}
+    {% endfor %}
+
+    WGPUInstance NativeCreateInstance(WGPUInstanceDescriptor const* cDescriptor);
+    WGPUProc NativeGetProcAddress(WGPUDevice device, const char* procName);
+
+} // namespace dawn_native
+
+#endif  // BACKEND_PROCTABLE_H_
@@ -317,6 +317,199 @@
     DAWN_UNUSED_FUNC({{Return}}{{name}}Deserialize);
 {% endmacro %}
 
+//* Outputs the unsigned integer that represents the member `in` in the compact encoding.
+{% macro compact_encode(member, in) -%}
+    {%- if member.type.category == "object" -%}
+        {%- set Optional = "Optional" if member.optional else "" -%}
+        static_cast<uint64_t>(objectIdProvider.Get{{Optional}}Id({{in}}))
+    {%- elif member.type.name.canonical_case() in ["int32_t", "int64_t"] -%}
+        ZigZagEncode({{in}})
+    {%- else -%}
+        static_cast<uint64_t>({{in}})
+    {%- endif -%}
+{%- endmacro %}
+
+//* Outputs the compact encoding of the default value of a value member.
+{% macro compact_default(member) -%}
+    {%- if member.type.category == "native" and member.default_value != None -%}
+        {{compact_encode(member, member.default_value)}}
+    {%- else -%}
+        0
+    {%- endif -%}
+{%- endmacro %}
+
+//* Outputs the deserialization code of one integer of the compact encoding into `out`.
+{% macro compact_deserialize(member, out) -%}
+    {%- if member.type.category in ["enum", "bitmask"] -%}
+        {
+            uint32_t value = 0;
+            DESERIALIZE_TRY(DeserializeCompactUnsigned(buffer, size, &value));
+            {{out}} = static_cast<decltype({{out}})>(value);
+        }
+    {%- elif member.type.name.canonical_case() in ["int32_t", "int64_t"] -%}
+        DESERIALIZE_TRY(DeserializeCompactSigned(buffer, size, &{{out}}));
+    {%- else -%}
+        DESERIALIZE_TRY(DeserializeCompactUnsigned(buffer, size, &{{out}}));
+    {%- endif -%}
+{%- endmacro %}
+
+//* The compact encoding of a command is its WireCmd followed by a varint mask and the varint
+//* values of its members. Each bit of the mask is set when the corresponding member is omitted:
+//* an object that is the same as in the previous command of this type, a value equal to its
+//* default or a null array.
+{% macro write_compact_serialization_helpers(command) %}
+    {% set Name = command.name.CamelCase() %}
+    {% set Cmd = Name + "Cmd" %}
+
+    uint64_t {{Name}}GetCompactMask(const {{Cmd}}& record, const CompactCommandState& state,
+                                    const ObjectIdProvider& objectIdProvider) {
+        uint64_t mask = 0;
+        {% for member in command.members %}
+            {% set memberName = as_varName(member.name) %}
+            {% if member.type.category == "object" %}
+                if ({{compact_encode(member, "record." + memberName)}} == state.{{as_varName(command.name, member.name)}})
+            {% elif member.annotation == "value" %}
+                if ({{compact_encode(member, "record." + memberName)}} == {{compact_default(member)}})
+            {% else %}
+                if (record.{{memberName}} == nullptr)
+            {% endif %}
+            {
+                mask |= uint64_t(1) << {{loop.index0}};
+            }
+        {% endfor %}
+        return mask;
+    }
+
+    size_t {{Name}}GetCompactRequiredSize(const {{Cmd}}& record, const CompactCommandState& state,
+                                          const ObjectIdProvider& objectIdProvider) {
+        uint64_t mask = {{Name}}GetCompactMask(record, state, objectIdProvider);
+        size_t result = sizeof(WireCmd) + GetVarintSize(mask);
+        {% for member in command.members %}
+            {% set memberName = as_varName(member.name) %}
+            if ((mask & (uint64_t(1) << {{loop.index0}})) == 0) {
+                {% if member.annotation == "value" %}
+                    result += GetVarintSize({{compact_encode(member, "record." + memberName)}});
+                {% else %}
+                    for (size_t i = 0; i < {{member_length(member, "record.")}}; ++i) {
+                        result += GetVarintSize({{compact_encode(member, "record." + memberName + "[i]")}});
+                    }
+                {% endif %}
+            }
+        {% endfor %}
+        return result;
+    }
+
+    void {{Name}}SerializeCompact(const {{Cmd}}& record, char* buffer, CompactCommandState* state,
+                                  const ObjectIdProvider& objectIdProvider) {
+        uint64_t mask = {{Name}}GetCompactMask(record, *state, objectIdProvider);
+
+        WireCmd commandId = WireCmd::Compact{{Name}};
+        memcpy(buffer, &commandId, sizeof(commandId));
+        buffer += sizeof(commandId);
+        SerializeVarint(mask, &buffer);
+
+        {% for member in command.members %}
+            {% set memberName = as_varName(member.name) %}
+            if ((mask & (uint64_t(1) << {{loop.index0}})) == 0) {
+                {% if member.annotation == "value" %}
+                    SerializeVarint({{compact_encode(member, "record." + memberName)}}, &buffer);
+                {% else %}
+                    for (size_t i = 0; i < {{member_length(member, "record.")}}; ++i) {
+                        SerializeVarint({{compact_encode(member, "record." + memberName + "[i]")}}, &buffer);
+                    }
+                {% endif %}
+            }
+        {% endfor %}
+
+        {% for member in command.members if member.type.category == "object" %}
+            state->{{as_varName(command.name, member.name)}} =
+                static_cast<ObjectId>({{compact_encode(member, "record." + as_varName(member.name))}});
+        {% endfor %}
+    }
+
+    DeserializeResult {{Name}}DeserializeCompact({{Cmd}}* record, const volatile char** buffer,
+                                                 size_t* size, DeserializeAllocator* allocator,
+                                                 CompactCommandState* state,
+                                                 const ObjectIdResolver& resolver) {
+        DAWN_UNUSED(allocator);
+
+        const volatile WireCmd* commandId = nullptr;
+        DESERIALIZE_TRY(GetPtrFromBuffer(buffer, size, 1, &commandId));
+        ASSERT(*commandId == WireCmd::Compact{{Name}});
+
+        uint64_t mask = 0;
+        DESERIALIZE_TRY(DeserializeVarint(buffer, size, &mask));
+
+        {% for member in command.members %}
+            {% set memberName = as_varName(member.name) %}
+            {
+                bool omitted = (mask & (uint64_t(1) << {{loop.index0}})) != 0;
+                {% if member.type.category == "object" %}
+                    {% set Optional = "Optional" if member.optional else "" %}
+                    {% set stateMember = "state->" + as_varName(command.name, member.name) %}
+                    if (!omitted) {
+                        DESERIALIZE_TRY(DeserializeCompactUnsigned(buffer, size, &{{stateMember}}));
+                    }
+                    {% if member.name.canonical_case() == "self" %}
+                        record->selfId = {{stateMember}};
+                    {% endif %}
+                    DESERIALIZE_TRY(resolver.Get{{Optional}}FromId({{stateMember}}, &record->{{memberName}}));
+                {% elif member.annotation == "value" %}
+                    if (omitted) {
+                        {% if member.type.category == "native" and member.default_value != None %}
+                            record->{{memberName}} = {{member.default_value}};
+                        {% else %}
+                            record->{{memberName}} = {};
+                        {% endif %}
+                    } else {
+                        {{compact_deserialize(member, "record->" + memberName)}}
+                    }
+                {% else %}
+                    record->{{memberName}} = nullptr;
+                    if (!omitted) {
+                        size_t memberLength = {{member_length(member, "record->")}};
+                        //* Each element takes at least one byte, which bounds the allocation.
+                        if (memberLength > *size) {
+                            return DeserializeResult::FatalError;
+                        }
+
+                        {{as_cType(member.type.name)}}* copiedMembers = nullptr;
+                        DESERIALIZE_TRY(GetSpace(allocator, memberLength, &copiedMembers));
+                        for (size_t i = 0; i < memberLength; ++i) {
+                            {{compact_deserialize(member, "copiedMembers[i]")}}
+                        }
+                        record->{{memberName}} = copiedMembers;
+                    }
+                {% endif %}
+            }
+        {% endfor %}
+
+        return DeserializeResult::Success;
+    }
+{% endmacro %}
+
+{% macro write_compact_command_serialization_methods(command) %}
+    {% set Name = command.name.CamelCase() %}
+    {% set Cmd = Name + "Cmd" %}
+
+    size_t {{Cmd}}::GetCompactRequiredSize(const CompactCommandState& state,
+                                           const ObjectIdProvider& objectIdProvider) const {
+        return {{Name}}GetCompactRequiredSize(*this, state, objectIdProvider);
+    }
+
+    void {{Cmd}}::SerializeCompact(char* buffer, CompactCommandState* state,
+                                   const ObjectIdProvider& objectIdProvider) const {
+        {{Name}}SerializeCompact(*this, buffer, state, objectIdProvider);
+    }
+
+    DeserializeResult {{Cmd}}::DeserializeCompact(const volatile char** buffer, size_t* size,
+                                                  DeserializeAllocator* allocator,
+                                                  CompactCommandState* state,
+                                                  const ObjectIdResolver& resolver) {
+        return {{Name}}DeserializeCompact(this, buffer, size, allocator, state, resolver);
+    }
+{% endmacro %}
+
 {% macro write_command_serialization_methods(command, is_return) %}
     {% set Return = "Return" if is_return else "" %}
     {% set Name = Return + command.name.CamelCase() %}
@@ -383,6 +576,32 @@ namespace dawn_wire {
         return *this;
     }
 
+    const char* GetWireCmdName(WireCmd cmd) {
+        switch (cmd) {
+            {% for command in cmd_records["command"] %}
+                case WireCmd::{{command.name.CamelCase()}}:
+                    return "{{command.name.CamelCase()}}";
+            {% endfor %}
+            {% for command in compact_cmd_records %}
+                case WireCmd::Compact{{command.name.CamelCase()}}:
+                    return "Compact{{command.name.CamelCase()}}";
+            {% endfor %}
+            default:
+                return "Unknown";
+        }
+    }
+
+    const char* GetReturnWireCmdName(ReturnWireCmd cmd) {
+        switch (cmd) {
+            {% for command in cmd_records["return command"] %}
+                case ReturnWireCmd::{{command.name.CamelCase()}}:
+                    return "{{command.name.CamelCase()}}";
+            {% endfor %}
+            default:
+                return "Unknown";
+        }
+    }
+
     namespace {
 
         // Consumes from (buffer, size) enough memory to contain T[count] and return it in data.
@@ -424,6 +643,79 @@ namespace dawn_wire {
             return DeserializeResult::Success;
         }
 
+        // Helpers for the compact encoding of commands, which stores integers as LEB128 varints.
+        size_t GetVarintSize(uint64_t value) {
+            size_t varintSize = 1;
+            while (value >= 0x80) {
+                value >>= 7;
+                varintSize++;
+            }
+            return varintSize;
+        }
+
+        void SerializeVarint(uint64_t value, char** buffer) {
+            while (value >= 0x80) {
+                **buffer = static_cast<char>((value & 0x7F) | 0x80);
+                *buffer += 1;
+                value >>= 7;
+            }
+            **buffer = static_cast<char>(value);
+            *buffer += 1;
+        }
+
+        DeserializeResult DeserializeVarint(const volatile char** buffer, size_t* size, uint64_t* out) {
+            uint64_t value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7) {
+                if (*size == 0) {
+                    return DeserializeResult::FatalError;
+                }
+                uint8_t byte = static_cast<uint8_t>(**buffer);
+                *buffer += 1;
+                *size -= 1;
+
+                // The last byte only has one significant bit.
+                if (shift == 63 && byte > 1) {
+                    return DeserializeResult::FatalError;
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    *out = value;
+                    return DeserializeResult::Success;
+                }
+            }
+            return DeserializeResult::FatalError;
+        }
+
+        // Signed integers are zigzag encoded so that small negative values have short varints.
+        DAWN_DECLARE_UNUSED uint64_t ZigZagEncode(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+        DAWN_UNUSED_FUNC(ZigZagEncode);
+
+        template <typename T>
+        DeserializeResult DeserializeCompactUnsigned(const volatile char** buffer, size_t* size, T* out) {
+            uint64_t value = 0;
+            DESERIALIZE_TRY(DeserializeVarint(buffer, size, &value));
+            if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                return DeserializeResult::FatalError;
+            }
+            *out = static_cast<T>(value);
+            return DeserializeResult::Success;
+        }
+
+        template <typename T>
+        DeserializeResult DeserializeCompactSigned(const volatile char** buffer, size_t* size, T* out) {
+            uint64_t value = 0;
+            DESERIALIZE_TRY(DeserializeVarint(buffer, size, &value));
+            int64_t decoded = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            if (decoded < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+                decoded > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+                return DeserializeResult::FatalError;
+            }
+            *out = static_cast<T>(decoded);
+            return DeserializeResult::Success;
+        }
+
         //* Output structure [de]serialization first because it is used by commands.
         {% for type in by_category["structure"] %}
             {% set name = as_cType(type.name) %}
@@ -446,6 +738,11 @@ namespace dawn_wire {
             {{write_record_serialization_helpers(command, name, command.members,
               is_cmd=True, is_return_command=True)}}
         {% endfor %}
+
+        //* Output the compact [de]serialization helpers of the commands that have one.
+        {% for command in compact_cmd_records %}
+            {{write_compact_serialization_helpers(command)}}
+        {% endfor %}
     }  // anonymous namespace
 
     {% for command in cmd_records["command"] %}
@@ -456,6 +753,10 @@ namespace dawn_wire {
         {{ write_command_serialization_methods(command, True) }}
     {% endfor %}
 
+    {% for command in compact_cmd_records %}
+        {{ write_compact_command_serialization_methods(command) }}
+    {% endfor %}
+
         // Implementations of serialization/deserialization of WPGUDeviceProperties.
         size_t SerializedWGPUDevicePropertiesSize(const WGPUDeviceProperties* deviceProperties) {
             return sizeof(WGPUDeviceProperties) +
@@ -81,6 +81,22 @@ namespace dawn_wire {
         {% for command in cmd_records["command"] %}
             {{command.name.CamelCase()}},
         {% endfor %}
+        //* The compact encodings come after the regular ones so they don't change their values.
+        {% for command in compact_cmd_records %}
+            Compact{{command.name.CamelCase()}},
+        {% endfor %}
+    };
+    constexpr uint32_t kWireCmdCount = {{cmd_records["command"]|length + compact_cmd_records|length}};
+    const char* GetWireCmdName(WireCmd cmd);
+
+    //* The compact encoding of a command omits the object IDs that are the same as in the
+    //* previous command of that type. Both sides of the wire keep track of these IDs.
+    struct CompactCommandState {
+        {% for command in compact_cmd_records %}
+            {% for member in command.members if member.type.category == "object" %}
+                ObjectId {{as_varName(command.name, member.name)}} = 0;
+            {% endfor %}
+        {% endfor %}
     };
 
     //* Enum used as a prefix to each command on the return wire format.
@@ -89,6 +105,8 @@ namespace dawn_wire {
             {{command.name.CamelCase()}},
         {% endfor %}
     };
+    constexpr uint32_t kReturnWireCmdCount = {{cmd_records["return command"]|length}};
+    const char* GetReturnWireCmdName(ReturnWireCmd cmd);
 
 {% macro write_command_struct(command, is_return_command) %}
     {% set Return = "Return" if is_return_command else "" %}
@@ -118,6 +136,19 @@ namespace dawn_wire {
             {%- endif -%}
         );
 
+        {% if command in compact_cmd_records %}
+            //* Same as GetRequiredSize, Serialize and Deserialize but for the compact encoding,
+            //* which depends on the previous commands serialized with |state|.
+            size_t GetCompactRequiredSize(const CompactCommandState& state,
+                                          const ObjectIdProvider& objectIdProvider) const;
+            void SerializeCompact(char* serializeBuffer, CompactCommandState* state,
+                                  const ObjectIdProvider& objectIdProvider) const;
+            DeserializeResult DeserializeCompact(const volatile char** buffer, size_t* size,
+                                                 DeserializeAllocator* allocator,
+                                                 CompactCommandState* state,
+                                                 const ObjectIdResolver& resolver);
+        {% endif %}
+
         {% if command.derived_method %}
             //* Command handlers want to know the object ID in addition to the backing object.
             //* Doesn't need to be filled before Serialize, or GetRequiredSize.
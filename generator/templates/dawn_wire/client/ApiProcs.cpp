@@ -46,7 +46,8 @@ namespace dawn_wire { namespace client {
 
                     //* For object creation, store the object ID the client will use for the result.
                     {% if method.return_type.category == "object" %}
-                        auto* allocation = self->device->GetClient()->{{method.return_type.name.CamelCase()}}Allocator().New(self->device);
+                        auto* allocation = device->GetClient()->{{method.return_type.name.CamelCase()}}Allocator().New(
+                            device, device->GetClient()->GetCommandStream());
                         cmd.result = ObjectHandle{allocation->object->id, allocation->serial};
                     {% endif %}
 
@@ -54,14 +55,27 @@ namespace dawn_wire { namespace client {
                         cmd.{{as_varName(arg.name)}} = {{as_varName(arg.name)}};
                     {% endfor %}
 
+                    {% if Suffix in compact_commands %}
+                        Client* client = device->GetClient();
+                        if (client->UseCompactEncoding()) {
+                            size_t requiredSize =
+                                cmd.GetCompactRequiredSize(*client->GetCompactCommandState(), *client);
+                            char* allocatedBuffer = static_cast<char*>(client->GetCmdSpace(requiredSize));
+                            cmd.SerializeCompact(allocatedBuffer, client->GetCompactCommandState(), *client);
+                            return;
+                        }
+                    {% endif %}
+
                     //* Allocate space to send the command and copy the value args over.
                     size_t requiredSize = cmd.GetRequiredSize();
                     char* allocatedBuffer = static_cast<char*>(device->GetClient()->GetCmdSpace(requiredSize));
                     cmd.Serialize(allocatedBuffer, *device->GetClient());
 
-                    {% if Suffix == "RayTracingAccelerationContainerGetHandle" %}
-                        return 0;
+                    //* Queue submissions are the ordering points of the command streams.
+                    {% if Suffix == "QueueSubmit" %}
+                        device->GetClient()->FlushCommandStream();
                     {% endif %}
+
                     {% if method.return_type.category == "object" %}
                         return reinterpret_cast<{{as_cType(method.return_type.name)}}>(allocation->object.get());
                     {% endif %}
@@ -73,9 +87,7 @@ namespace dawn_wire { namespace client {
             //* When an object's refcount reaches 0, notify the server side of it and delete it.
             void Client{{as_MethodSuffix(type.name, Name("release"))}}({{cType}} cObj) {
                 {{Type}}* obj = reinterpret_cast<{{Type}}*>(cObj);
-                obj->refcount --;
-
-                if (obj->refcount > 0) {
+                if (--obj->refcount > 0) {
                     return;
                 }
 
@@ -87,7 +99,8 @@ namespace dawn_wire { namespace client {
                 char* allocatedBuffer = static_cast<char*>(obj->device->GetClient()->GetCmdSpace(requiredSize));
                 cmd.Serialize(allocatedBuffer);
 
-                obj->device->GetClient()->{{type.name.CamelCase()}}Allocator().Free(obj);
+                Client* client = obj->device->GetClient();
+                client->{{type.name.CamelCase()}}Allocator().Free(obj, client->GetCommandStream());
             }
 
             void Client{{as_MethodSuffix(type.name, Name("reference"))}}({{cType}} cObj) {
@@ -97,6 +110,30 @@ namespace dawn_wire { namespace client {
         {% endif %}
     {% endfor %}
 
+    //* The native-only commands aren't sent on the wire. Their client procs generate a validation
+    //* error instead, so that callers can tell that their outputs weren't written.
+    {% for type in by_category["object"] %}
+        {% for method in type.methods %}
+            {% set Suffix = as_MethodSuffix(type.name, method.name) %}
+            {% if Suffix in client_unsupported_commands %}
+                {{as_cType(method.return_type.name)}} Client{{Suffix}}(
+                    {{-as_cType(type.name)}} cSelf
+                    {%- for arg in method.arguments -%}
+                        , {{as_annotated_cType(arg)}}
+                    {%- endfor -%}
+                ) {
+                    auto self = reinterpret_cast<{{as_wireType(type)}}>(cSelf);
+                    ClientDeviceInjectError(reinterpret_cast<WGPUDevice>(self->device),
+                                            WGPUErrorType_Validation,
+                                            "{{as_cMethod(type.name, method.name)}} is native-only and isn't supported by the wire client");
+                    {% if method.return_type.name.canonical_case() != "void" %}
+                        return {};
+                    {% endif %}
+                }
+            {% endif %}
+        {% endfor %}
+    {% endfor %}
+
     namespace {
         WGPUInstance ClientCreateInstance(WGPUInstanceDescriptor const* descriptor) {
             UNREACHABLE();
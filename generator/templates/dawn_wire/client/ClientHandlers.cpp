@@ -54,8 +54,14 @@ namespace dawn_wire { namespace client {
     {% endfor %}
 
     const volatile char* Client::HandleCommands(const volatile char* commands, size_t size) {
+        std::chrono::steady_clock::time_point batchStart;
+        if (mStatistics != nullptr) {
+            batchStart = std::chrono::steady_clock::now();
+        }
+
         while (size >= sizeof(ReturnWireCmd)) {
             ReturnWireCmd cmdId = *reinterpret_cast<const volatile ReturnWireCmd*>(commands);
+            size_t commandStartSize = size;
 
             bool success = false;
             switch (cmdId) {
@@ -73,12 +79,19 @@ namespace dawn_wire { namespace client {
                 return nullptr;
             }
             mAllocator.Reset();
+
+            if (mStatistics != nullptr) {
+                mStatistics->RecordCommand(static_cast<uint32_t>(cmdId), commandStartSize - size);
+            }
         }
 
         if (size != 0) {
             return nullptr;
         }
 
+        if (mStatistics != nullptr) {
+            mStatistics->RecordBatch(std::chrono::steady_clock::now() - batchStart);
+        }
         return commands;
     }
 }}  // namespace dawn_wire::client
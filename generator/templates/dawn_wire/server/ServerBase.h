@@ -41,6 +41,12 @@ namespace dawn_wire { namespace server {
             {% endfor %}
         }
 
+        void SetMaxObjectIdGap(uint32_t maxIdGap) {
+            {% for type in by_category["object"] %}
+                mKnown{{type.name.CamelCase()}}.SetMaxIdGap(maxIdGap);
+            {% endfor %}
+        }
+
         {% for type in by_category["object"] %}
             const KnownObjects<{{as_cType(type.name)}}>& {{type.name.CamelCase()}}Objects() const {
                 return mKnown{{type.name.CamelCase()}};
@@ -89,11 +89,38 @@ namespace dawn_wire { namespace server {
         }
     {% endfor %}
 
+    //* The handlers of the compact encodings, these commands don't have results or pre-handlers.
+    {% for command in compact_cmd_records %}
+        {% set Suffix = command.name.CamelCase() %}
+        bool Server::HandleCompact{{Suffix}}(const volatile char** commands, size_t* size) {
+            {{Suffix}}Cmd cmd;
+            DeserializeResult deserializeResult =
+                cmd.DeserializeCompact(commands, size, &mAllocator, &mCompactCommandState, *this);
+
+            if (deserializeResult == DeserializeResult::FatalError) {
+                return false;
+            }
+
+            return Do{{Suffix}}(
+                {%- for member in command.members -%}
+                    cmd.{{as_varName(member.name)}}
+                    {%- if not loop.last -%}, {% endif %}
+                {%- endfor -%}
+            );
+        }
+    {% endfor %}
+
     const volatile char* Server::HandleCommands(const volatile char* commands, size_t size) {
-        mProcs.deviceTick(DeviceObjects().Get(1)->handle);
+        std::chrono::steady_clock::time_point batchStart;
+        if (mStatistics != nullptr) {
+            batchStart = std::chrono::steady_clock::now();
+        }
+
+        TickDevice();
 
         while (size >= sizeof(WireCmd)) {
             WireCmd cmdId = *reinterpret_cast<const volatile WireCmd*>(commands);
+            size_t commandStartSize = size;
 
             bool success = false;
             switch (cmdId) {
@@ -102,6 +129,11 @@ namespace dawn_wire { namespace server {
                         success = Handle{{command.name.CamelCase()}}(&commands, &size);
                         break;
                 {% endfor %}
+                {% for command in compact_cmd_records %}
+                    case WireCmd::Compact{{command.name.CamelCase()}}:
+                        success = HandleCompact{{command.name.CamelCase()}}(&commands, &size);
+                        break;
+                {% endfor %}
                 default:
                     success = false;
             }
@@ -110,12 +142,19 @@ namespace dawn_wire { namespace server {
                 return nullptr;
             }
             mAllocator.Reset();
+
+            if (mStatistics != nullptr) {
+                mStatistics->RecordCommand(static_cast<uint32_t>(cmdId), commandStartSize - size);
+            }
         }
 
         if (size != 0) {
             return nullptr;
         }
 
+        if (mStatistics != nullptr) {
+            mStatistics->RecordBatch(std::chrono::steady_clock::now() - batchStart);
+        }
         return commands;
     }
 
@@ -107,6 +107,30 @@ void ProcTableAsClass::BufferMapWriteAsync(WGPUBuffer self,
     OnBufferMapWriteAsyncCallback(self, callback, userdata);
 }
 
+void ProcTableAsClass::BufferMapReadRangeAsync(WGPUBuffer self,
+                                               uint64_t offset,
+                                               uint64_t size,
+                                               WGPUBufferMapReadCallback callback,
+                                               void* userdata) {
+    auto object = reinterpret_cast<ProcTableAsClass::Object*>(self);
+    object->mapReadCallback = callback;
+    object->userdata = userdata;
+
+    OnBufferMapReadRangeAsyncCallback(self, offset, size, callback, userdata);
+}
+
+void ProcTableAsClass::BufferMapWriteRangeAsync(WGPUBuffer self,
+                                                uint64_t offset,
+                                                uint64_t size,
+                                                WGPUBufferMapWriteCallback callback,
+                                                void* userdata) {
+    auto object = reinterpret_cast<ProcTableAsClass::Object*>(self);
+    object->mapWriteCallback = callback;
+    object->userdata = userdata;
+
+    OnBufferMapWriteRangeAsyncCallback(self, offset, size, callback, userdata);
+}
+
 void ProcTableAsClass::FenceOnCompletion(WGPUFence self,
                                          uint64_t value,
                                          WGPUFenceOnCompletionCallback callback,
@@ -69,6 +69,16 @@ class ProcTableAsClass {
         void BufferMapWriteAsync(WGPUBuffer self,
                                  WGPUBufferMapWriteCallback callback,
                                  void* userdata);
+        void BufferMapReadRangeAsync(WGPUBuffer self,
+                                     uint64_t offset,
+                                     uint64_t size,
+                                     WGPUBufferMapReadCallback callback,
+                                     void* userdata);
+        void BufferMapWriteRangeAsync(WGPUBuffer self,
+                                      uint64_t offset,
+                                      uint64_t size,
+                                      WGPUBufferMapWriteCallback callback,
+                                      void* userdata);
         void FenceOnCompletion(WGPUFence self,
                                uint64_t value,
                                WGPUFenceOnCompletionCallback callback,
@@ -94,6 +104,16 @@ class ProcTableAsClass {
         virtual void OnBufferMapWriteAsyncCallback(WGPUBuffer buffer,
                                                    WGPUBufferMapWriteCallback callback,
                                                    void* userdata) = 0;
+        virtual void OnBufferMapReadRangeAsyncCallback(WGPUBuffer buffer,
+                                                       uint64_t offset,
+                                                       uint64_t size,
+                                                       WGPUBufferMapReadCallback callback,
+                                                       void* userdata) = 0;
+        virtual void OnBufferMapWriteRangeAsyncCallback(WGPUBuffer buffer,
+                                                        uint64_t offset,
+                                                        uint64_t size,
+                                                        WGPUBufferMapWriteCallback callback,
+                                                        void* userdata) = 0;
         virtual void OnFenceOnCompletionCallback(WGPUFence fence,
                                                  uint64_t value,
                                                  WGPUFenceOnCompletionCallback callback,
@@ -152,6 +172,8 @@ class MockProcTable : public ProcTableAsClass {
         MOCK_METHOD4(OnDeviceCreateBufferMappedAsyncCallback, void(WGPUDevice device, const WGPUBufferDescriptor* descriptor, WGPUBufferCreateMappedCallback callback, void* userdata));
         MOCK_METHOD3(OnBufferMapReadAsyncCallback, void(WGPUBuffer buffer, WGPUBufferMapReadCallback callback, void* userdata));
         MOCK_METHOD3(OnBufferMapWriteAsyncCallback, void(WGPUBuffer buffer, WGPUBufferMapWriteCallback callback, void* userdata));
+        MOCK_METHOD5(OnBufferMapReadRangeAsyncCallback, void(WGPUBuffer buffer, uint64_t offset, uint64_t size, WGPUBufferMapReadCallback callback, void* userdata));
+        MOCK_METHOD5(OnBufferMapWriteRangeAsyncCallback, void(WGPUBuffer buffer, uint64_t offset, uint64_t size, WGPUBufferMapWriteCallback callback, void* userdata));
         MOCK_METHOD4(OnFenceOnCompletionCallback,
                      void(WGPUFence fence,
                           uint64_t value,
@@ -14,6 +14,20 @@
 
 #include "dawn/webgpu_cpp.h"
 
+{% if direct_native_dispatch %}
+    //* Calls go straight to the dawn_native entry points instead of the C API functions and the
+    //* proc table behind them, which allows inlining them with LTO.
+    #include "dawn_native/ProcTable_autogen.h"
+{% endif %}
+
+{% macro as_cCall(type_name, method_name) -%}
+    {%- if direct_native_dispatch -%}
+        dawn_native::Native{{as_MethodSuffix(type_name, method_name)}}
+    {%- else -%}
+        {{as_cMethod(type_name, method_name)}}
+    {%- endif -%}
+{%- endmacro %}
+
 namespace wgpu {
 
     {% for type in by_category["enum"] %}
@@ -92,7 +106,7 @@ namespace wgpu {
         {%- endmacro %}
 
         {% macro render_cpp_to_c_method_call(type, method) -%}
-            {{as_cMethod(type.name, method.name)}}(Get()
+            {{as_cCall(type.name, method.name)}}(Get()
                 {%- for arg in method.arguments -%},{{" "}}
                     {%- if arg.annotation == "value" -%}
                         {%- if arg.type.category == "object" -%}
@@ -123,12 +137,12 @@ namespace wgpu {
         {% endfor %}
         void {{CppType}}::WGPUReference({{CType}} handle) {
             if (handle != nullptr) {
-                {{as_cMethod(type.name, Name("reference"))}}(handle);
+                {{as_cCall(type.name, Name("reference"))}}(handle);
             }
         }
         void {{CppType}}::WGPURelease({{CType}} handle) {
             if (handle != nullptr) {
-                {{as_cMethod(type.name, Name("release"))}}(handle);
+                {{as_cCall(type.name, Name("release"))}}(handle);
             }
         }
 
@@ -137,11 +151,19 @@ namespace wgpu {
     Instance CreateInstance(const InstanceDescriptor* descriptor) {
         const WGPUInstanceDescriptor* cDescriptor =
             reinterpret_cast<const WGPUInstanceDescriptor*>(descriptor);
-        return Instance::Acquire(wgpuCreateInstance(cDescriptor));
+        {% if direct_native_dispatch %}
+            return Instance::Acquire(dawn_native::NativeCreateInstance(cDescriptor));
+        {% else %}
+            return Instance::Acquire(wgpuCreateInstance(cDescriptor));
+        {% endif %}
     }
 
     Proc GetProcAddress(Device const& device, const char* procName) {
-        return reinterpret_cast<Proc>(wgpuGetProcAddress(device.Get(), procName));
+        {% if direct_native_dispatch %}
+            return reinterpret_cast<Proc>(dawn_native::NativeGetProcAddress(device.Get(), procName));
+        {% else %}
+            return reinterpret_cast<Proc>(wgpuGetProcAddress(device.Get(), procName));
+        {% endif %}
     }
 
 }
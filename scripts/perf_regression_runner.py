@@ -0,0 +1,204 @@
+#!/usr/bin/python2
+#
+# Copyright 2020 The Dawn Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs dawn_perf_tests over a matrix of backends and configurations, and compares the results
+# against a baseline. Each configuration is a set of extra arguments of the test binary, for
+# example "--skip-validation" or "--enable-toggles=lazy_clear_resource_on_first_use".
+#
+#   scripts/perf_regression_runner.py --backend Vulkan --backend D3D12 \
+#       --config default= --config skip_validation=--skip-validation \
+#       --toggle use_d3d12_render_pass --output results.json --baseline baseline.json
+#
+# The script exits with 1 when a metric regressed by more than its threshold.
+
+import argparse
+import glob
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+base_path = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+binary_name = 'dawn_perf_tests'
+if sys.platform == 'win32':
+    binary_name += '.exe'
+
+# Metrics for which a larger value is better, the others are times.
+higher_is_better_metrics = set(['bandwidth'])
+
+
+def find_binary():
+    """Returns the most recent binary of a [Rr]elease build."""
+    newest_binary = None
+    newest_mtime = None
+    for path in glob.glob(os.path.join(base_path, 'out', '*elease*')):
+        binary_path = os.path.join(path, binary_name)
+        if os.path.exists(binary_path):
+            binary_mtime = os.path.getmtime(binary_path)
+            if newest_binary is None or binary_mtime > newest_mtime:
+                newest_binary = binary_path
+                newest_mtime = binary_mtime
+    return newest_binary
+
+
+def parse_configs(args):
+    """Returns the list of (name, binary arguments) to run the tests with."""
+    configs = []
+    for config in args.config:
+        name, _, arguments = config.partition('=')
+        configs.append((name, shlex.split(arguments)))
+    for toggle in args.toggle:
+        configs.append((toggle, ['--enable-toggles=' + toggle]))
+    if not configs:
+        configs.append(('default', []))
+    return configs
+
+
+def make_gtest_filter(tests, backends):
+    """Test names are the name of the suite, the test and its parameters, which start with the
+    backend, as in DrawCallPerf.Run/Vulkan__e_skip_validation."""
+    if not backends:
+        return tests
+    filters = []
+    for test in tests.split(':'):
+        suite, _, name = test.partition('.')
+        for backend in backends:
+            filters.append('%s.%s/%s*' % (suite, name or '*', backend))
+    return ':'.join(filters)
+
+
+def run_config(binary, gtest_filter, arguments, extra_arguments):
+    handle, results_file = tempfile.mkstemp(suffix='.json')
+    os.close(handle)
+    try:
+        command = [binary, '--gtest_filter=' + gtest_filter, '--results-file=' + results_file]
+        command += arguments + extra_arguments
+        print('Running: ' + ' '.join(command))
+        if subprocess.call(command) != 0:
+            print('The tests failed.')
+            sys.exit(2)
+        with open(results_file) as f:
+            return json.load(f)
+    finally:
+        os.remove(results_file)
+
+
+def result_key(result):
+    return '%s.%s:%s' % (result['suite'], result['test'], result['metric'])
+
+
+def compare(results, baseline, threshold, metric_thresholds, stddev_factor):
+    """Returns the list of regressions as strings."""
+    regressions = []
+    for config, config_results in sorted(results.items()):
+        baseline_results = dict(
+            (result_key(result), result) for result in baseline.get(config, []))
+        for result in config_results:
+            key = result_key(result)
+            if key not in baseline_results:
+                print('%s %s: no baseline' % (config, key))
+                continue
+
+            base = baseline_results[key]
+            if base['mean'] == 0:
+                continue
+
+            change = (result['mean'] - base['mean']) / base['mean']
+            if result['metric'] in higher_is_better_metrics:
+                change = -change
+            # Changes within the noise of the measurements aren't regressions.
+            noise = stddev_factor * max(result['stddev'], base['stddev']) / base['mean']
+            allowed = metric_thresholds.get(result['metric'], threshold)
+
+            line = '%s %s: %.4g -> %.4g %s (%+.1f%%)' % (config, key, base['mean'],
+                                                         result['mean'], result['units'],
+                                                         change * 100)
+            if change > allowed and change > noise:
+                regressions.append(line)
+                print(line + ' REGRESSION')
+            else:
+                print(line)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--binary', help='The dawn_perf_tests binary, defaults to the most '
+                        'recent one of the out/*elease* directories.')
+    parser.add_argument('--tests', default='*', help='The gtest filter of the tests to run.')
+    parser.add_argument('--backend', action='append', default=[],
+                        help='A backend to run the tests on, as in D3D12, Metal, Null, OpenGL or '
+                        'Vulkan. Defaults to all the backends of the tests.')
+    parser.add_argument('--config', action='append', default=[],
+                        help='A configuration as name=arguments, the arguments are passed to '
+                        'the test binary.')
+    parser.add_argument('--toggle', action='append', default=[],
+                        help='Adds a configuration enabling the toggle, named after it.')
+    parser.add_argument('--override-steps', type=int,
+                        help='The number of steps to run, instead of calibrating each test.')
+    parser.add_argument('--output', help='The file to write the results to.')
+    parser.add_argument('--baseline', help='The results to compare against.')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='The relative change of the metrics that is a regression.')
+    parser.add_argument('--metric-threshold', action='append', default=[],
+                        help='The threshold of a metric as metric=threshold, for example '
+                        'gpu_time=0.1.')
+    parser.add_argument('--stddev-factor', type=float, default=2.0,
+                        help='Changes smaller than this many standard deviations are noise.')
+    args = parser.parse_args()
+
+    binary = args.binary or find_binary()
+    if binary is None or not os.path.exists(binary):
+        print('Cannot find Release %s!' % binary_name)
+        return 1
+
+    metric_thresholds = {}
+    for metric_threshold in args.metric_threshold:
+        metric, _, threshold = metric_threshold.partition('=')
+        metric_thresholds[metric] = float(threshold)
+
+    extra_arguments = []
+    if args.override_steps is not None:
+        extra_arguments.append('--override-steps=%d' % args.override_steps)
+
+    gtest_filter = make_gtest_filter(args.tests, args.backend)
+    results = {}
+    for name, arguments in parse_configs(args):
+        results[name] = run_config(binary, gtest_filter, arguments, extra_arguments)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(results, baseline, args.threshold, metric_thresholds,
+                              args.stddev_factor)
+        if regressions:
+            print('\n%d regression(s):' % len(regressions))
+            for regression in regressions:
+                print('  ' + regression)
+            return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
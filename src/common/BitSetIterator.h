@@ -18,6 +18,7 @@
 #include "common/Assert.h"
 #include "common/Math.h"
 
+#include <array>
 #include <bitset>
 #include <limits>
 
@@ -132,4 +133,81 @@ BitSetIterator<N, uint32_t> IterateBitSet(const std::bitset<N>& bitset) {
     return BitSetIterator<N, uint32_t>(bitset);
 }
 
+// Iterates over the bits of a bitset converted once to an array of 64-bit words. Each step only
+// clears the lowest bit of the current word, instead of copying, masking and shifting the whole
+// bitset like BitSetIterator does, which matters for the masks iterated on every draw.
+template <size_t N, typename T>
+class BitSetWordIterator final {
+  public:
+    static constexpr size_t kWordCount = (N + 63) / 64;
+    using Words = std::array<uint64_t, kWordCount>;
+
+    BitSetWordIterator(const std::bitset<N>& bitset);
+
+    class Iterator final {
+      public:
+        Iterator(const Words* words, size_t wordIndex, uint64_t word)
+            : mWords(words), mWordIndex(wordIndex), mWord(word) {
+        }
+
+        Iterator& operator++() {
+            DAWN_ASSERT(mWord != 0);
+            mWord &= mWord - 1;
+            while (mWord == 0 && ++mWordIndex < kWordCount) {
+                mWord = (*mWords)[mWordIndex];
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return mWordIndex == other.mWordIndex && mWord == other.mWord;
+        }
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+        T operator*() const {
+            return static_cast<T>(mWordIndex * 64 + ScanForward64(mWord));
+        }
+
+      private:
+        const Words* mWords;
+        size_t mWordIndex;
+        uint64_t mWord;
+    };
+
+    // The iterators point to the words of the BitSetWordIterator, which must outlive them.
+    Iterator begin() const {
+        for (size_t i = 0; i < kWordCount; ++i) {
+            if (mWords[i] != 0) {
+                return Iterator(&mWords, i, mWords[i]);
+            }
+        }
+        return end();
+    }
+    Iterator end() const {
+        return Iterator(&mWords, kWordCount, 0);
+    }
+
+  private:
+    Words mWords;
+};
+
+template <size_t N, typename T>
+BitSetWordIterator<N, T>::BitSetWordIterator(const std::bitset<N>& bitset) {
+    if (kWordCount == 1) {
+        mWords[0] = bitset.to_ullong();
+        return;
+    }
+
+    static const std::bitset<N> wordMask(std::numeric_limits<uint64_t>::max());
+    for (size_t i = 0; i < kWordCount; ++i) {
+        mWords[i] = ((bitset >> (i * 64)) & wordMask).to_ullong();
+    }
+}
+
+template <size_t N>
+BitSetWordIterator<N, uint32_t> IterateBitSetWords(const std::bitset<N>& bitset) {
+    return BitSetWordIterator<N, uint32_t>(bitset);
+}
+
 #endif  // COMMON_BITSETITERATOR_H_
@@ -30,8 +30,10 @@ static constexpr uint32_t kMaxVertexAttributes = 16u;
 static constexpr uint32_t kMaxVertexAttributeEnd = 2048u;
 static constexpr uint32_t kMaxVertexBuffers = 16u;
 static constexpr uint32_t kMaxVertexBufferStride = 2048u;
-static constexpr uint32_t kNumStages = 8;
+static constexpr uint32_t kNumStages = 9;
 static constexpr uint32_t kMaxColorAttachments = 4u;
+// The smallest maxComputeWorkGroupCount of the backends, indirect dispatches are clamped to it.
+static constexpr uint32_t kMaxComputeWorkgroupsPerDimension = 65535u;
 static constexpr uint32_t kTextureRowPitchAlignment = 256u;
 // Dynamic buffer offsets require offset to be divisible by 256
 static constexpr uint64_t kMinDynamicBufferOffsetAlignment = 256u;
@@ -42,10 +44,40 @@ static constexpr uint32_t kMaxDynamicStorageBufferCount = 4u;
 // Max numbers of dynamic buffers
 static constexpr uint32_t kMaxDynamicBufferCount =
     kMaxDynamicUniformBufferCount + kMaxDynamicStorageBufferCount;
+// Push constants are lowered to Vulkan push constants, which guarantee 128 bytes, and to D3D12
+// root constants, whose 32 DWORDs fit in the root signature next to the maximum bind groups.
+static constexpr uint32_t kMaxPushConstantSize = 128u;
+static constexpr uint32_t kPushConstantAlignment = 4u;
+// Sparse resources are mapped in tiles of 64KB, the size of the D3D12 tiles and of the Vulkan
+// standard sparse blocks.
+static constexpr uint64_t kSparseTileSize = 65536u;
 // Indirect command sizes
 static constexpr uint64_t kDispatchIndirectSize = 3 * sizeof(uint32_t);
 static constexpr uint64_t kDrawIndirectSize = 4 * sizeof(uint32_t);
 static constexpr uint64_t kDrawIndexedIndirectSize = 5 * sizeof(uint32_t);
+// Conditional rendering reads a 32-bit predicate in Vulkan but a 64-bit one in D3D12, the
+// predicates take 8 bytes with the upper 4 bytes set to zero.
+static constexpr uint64_t kPredicateSize = sizeof(uint64_t);
+static constexpr uint64_t kPredicateOffsetAlignment = sizeof(uint64_t);
+// Instance records are packed like VkAccelerationStructureInstanceNV and
+// D3D12_RAYTRACING_INSTANCE_DESC: a row-major 3x4 float transform, a word with the instance id in
+// its low 24 bits and the mask in its high 8 bits, a word with the instance offset in its low 24
+// bits and the flags in its high 8 bits, then the 64-bit handle of the geometry container.
+static constexpr uint64_t kAccelerationInstanceSize = 64u;
+static constexpr uint64_t kAccelerationInstanceOffsetAlignment = 16u;
+static constexpr uint32_t kAccelerationInstanceTransformOffset = 0u;
+static constexpr uint32_t kAccelerationInstanceIdAndMaskOffset = 48u;
+static constexpr uint32_t kAccelerationInstanceOffsetAndFlagsOffset = 52u;
+static constexpr uint32_t kAccelerationInstanceHandleOffset = 56u;
+// Queries are resolved as 64-bit values.
+static constexpr uint32_t kMaxQueryCount = 8192u;
+static constexpr uint64_t kQueryResolveAlignment = sizeof(uint64_t);
+// Resource tables are lowered to Vulkan update-after-bind descriptor arrays and D3D12 descriptor
+// tables, this fits in the smallest maxPerStageDescriptorUpdateAfterBind* limits of the drivers
+// exposing descriptor indexing.
+static constexpr uint32_t kMaxResourceTableCapacity = 65536u;
+// Returned by TransientUniformAllocator::Allocate when the ring is full.
+static constexpr uint64_t kInvalidTransientUniformOffset = ~uint64_t(0);
 
 // Non spec defined constants.
 static constexpr float kLodMin = 0.0;
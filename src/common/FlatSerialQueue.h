@@ -0,0 +1,252 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_FLATSERIALQUEUE_H_
+#define COMMON_FLATSERIALQUEUE_H_
+
+#include "common/Assert.h"
+#include "common/Serial.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// FlatSerialQueue has the same interface as SerialQueue but stores each value next to its serial
+// in a single ring buffer instead of a vector of values per serial. The buffer only grows, so a
+// queue that is enqueued to and cleared every tick stops allocating once it reaches its working
+// size. T must be default constructible: cleared slots are reset to T() so that they release
+// what they hold right away.
+template <typename T>
+class FlatSerialQueue {
+  private:
+    struct Entry {
+        Serial serial;
+        T value;
+    };
+
+    template <typename Queue, typename Value>
+    class IteratorBase {
+      public:
+        IteratorBase(Queue* queue, size_t index) : mQueue(queue), mIndex(index) {
+        }
+        IteratorBase& operator++() {
+            mIndex++;
+            return *this;
+        }
+
+        bool operator==(const IteratorBase& other) const {
+            return mQueue == other.mQueue && mIndex == other.mIndex;
+        }
+        bool operator!=(const IteratorBase& other) const {
+            return !(*this == other);
+        }
+        Value& operator*() const {
+            return mQueue->At(mIndex).value;
+        }
+
+      private:
+        Queue* mQueue;
+        size_t mIndex;
+    };
+
+    template <typename Iterator>
+    class BeginEndBase {
+      public:
+        BeginEndBase(Iterator begin, Iterator end) : mBegin(begin), mEnd(end) {
+        }
+
+        Iterator begin() const {
+            return mBegin;
+        }
+        Iterator end() const {
+            return mEnd;
+        }
+
+      private:
+        Iterator mBegin;
+        Iterator mEnd;
+    };
+
+  public:
+    using Iterator = IteratorBase<FlatSerialQueue<T>, T>;
+    using ConstIterator = IteratorBase<const FlatSerialQueue<T>, const T>;
+    using BeginEnd = BeginEndBase<Iterator>;
+    using ConstBeginEnd = BeginEndBase<ConstIterator>;
+
+    // The serial must be given in (not strictly) increasing order.
+    void Enqueue(const T& value, Serial serial);
+    void Enqueue(T&& value, Serial serial);
+    void Enqueue(const std::vector<T>& values, Serial serial);
+    void Enqueue(std::vector<T>&& values, Serial serial);
+
+    bool Empty() const;
+
+    // The UpTo variants of Iterate and Clear affect all values associated to a serial
+    // that is smaller OR EQUAL to the given serial. Iterating is done like so:
+    //     for (const T& value : queue.IterateAll()) { stuff(T); }
+    ConstBeginEnd IterateAll() const;
+    ConstBeginEnd IterateUpTo(Serial serial) const;
+    BeginEnd IterateAll();
+    BeginEnd IterateUpTo(Serial serial);
+
+    void Clear();
+    void ClearUpTo(Serial serial);
+
+    Serial FirstSerial() const;
+    Serial LastSerial() const;
+
+  private:
+    // Returns the slot for the value at |index| from the front of the queue.
+    Entry& At(size_t index);
+    const Entry& At(size_t index) const;
+    // Returns the index from the front of the first value with a serial bigger than serial.
+    size_t FindUpTo(Serial serial) const;
+    Entry& EnqueueSlot(Serial serial);
+    void PopFront();
+
+    // The capacity of the ring buffer is always zero or a power of two.
+    std::vector<Entry> mEntries;
+    size_t mFront = 0;
+    size_t mSize = 0;
+};
+
+// FlatSerialQueue
+
+template <typename T>
+void FlatSerialQueue<T>::Enqueue(const T& value, Serial serial) {
+    EnqueueSlot(serial).value = value;
+}
+
+template <typename T>
+void FlatSerialQueue<T>::Enqueue(T&& value, Serial serial) {
+    EnqueueSlot(serial).value = std::move(value);
+}
+
+template <typename T>
+void FlatSerialQueue<T>::Enqueue(const std::vector<T>& values, Serial serial) {
+    DAWN_ASSERT(values.size() > 0);
+    for (const T& value : values) {
+        Enqueue(value, serial);
+    }
+}
+
+template <typename T>
+void FlatSerialQueue<T>::Enqueue(std::vector<T>&& values, Serial serial) {
+    DAWN_ASSERT(values.size() > 0);
+    for (T& value : values) {
+        Enqueue(std::move(value), serial);
+    }
+}
+
+template <typename T>
+bool FlatSerialQueue<T>::Empty() const {
+    return mSize == 0;
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::ConstBeginEnd FlatSerialQueue<T>::IterateAll() const {
+    return {ConstIterator(this, 0), ConstIterator(this, mSize)};
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::ConstBeginEnd FlatSerialQueue<T>::IterateUpTo(Serial serial) const {
+    return {ConstIterator(this, 0), ConstIterator(this, FindUpTo(serial))};
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::BeginEnd FlatSerialQueue<T>::IterateAll() {
+    return {Iterator(this, 0), Iterator(this, mSize)};
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::BeginEnd FlatSerialQueue<T>::IterateUpTo(Serial serial) {
+    return {Iterator(this, 0), Iterator(this, FindUpTo(serial))};
+}
+
+template <typename T>
+void FlatSerialQueue<T>::Clear() {
+    while (!Empty()) {
+        PopFront();
+    }
+    mFront = 0;
+}
+
+template <typename T>
+void FlatSerialQueue<T>::ClearUpTo(Serial serial) {
+    while (!Empty() && At(0).serial <= serial) {
+        PopFront();
+    }
+}
+
+template <typename T>
+Serial FlatSerialQueue<T>::FirstSerial() const {
+    DAWN_ASSERT(!Empty());
+    return At(0).serial;
+}
+
+template <typename T>
+Serial FlatSerialQueue<T>::LastSerial() const {
+    DAWN_ASSERT(!Empty());
+    return At(mSize - 1).serial;
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::Entry& FlatSerialQueue<T>::At(size_t index) {
+    DAWN_ASSERT(index < mSize);
+    return mEntries[(mFront + index) & (mEntries.size() - 1)];
+}
+
+template <typename T>
+const typename FlatSerialQueue<T>::Entry& FlatSerialQueue<T>::At(size_t index) const {
+    DAWN_ASSERT(index < mSize);
+    return mEntries[(mFront + index) & (mEntries.size() - 1)];
+}
+
+template <typename T>
+size_t FlatSerialQueue<T>::FindUpTo(Serial serial) const {
+    size_t index = 0;
+    while (index < mSize && At(index).serial <= serial) {
+        index++;
+    }
+    return index;
+}
+
+template <typename T>
+typename FlatSerialQueue<T>::Entry& FlatSerialQueue<T>::EnqueueSlot(Serial serial) {
+    DAWN_ASSERT(Empty() || LastSerial() <= serial);
+
+    if (mSize == mEntries.size()) {
+        // Move the values to a buffer twice as big, starting at its front.
+        std::vector<Entry> entries(mEntries.empty() ? 4 : mEntries.size() * 2);
+        for (size_t i = 0; i < mSize; ++i) {
+            entries[i] = std::move(At(i));
+        }
+        mEntries = std::move(entries);
+        mFront = 0;
+    }
+
+    mSize++;
+    Entry& entry = At(mSize - 1);
+    entry.serial = serial;
+    return entry;
+}
+
+template <typename T>
+void FlatSerialQueue<T>::PopFront() {
+    At(0).value = T();
+    mFront = (mFront + 1) & (mEntries.size() - 1);
+    mSize--;
+}
+
+#endif  // COMMON_FLATSERIALQUEUE_H_
@@ -0,0 +1,179 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/MagazineAllocator.h"
+
+#include "common/Assert.h"
+#include "common/SlabAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <new>
+
+namespace {
+
+    // The size classes are 16 bytes apart up to 512 bytes, where most of the objects are, then
+    // 128 bytes apart to bound the number of classes.
+    constexpr size_t kSmallClassGranularity = 16;
+    constexpr size_t kSmallClassMaxSize = 512;
+    constexpr size_t kLargeClassGranularity = 128;
+    constexpr size_t kSmallClassCount = kSmallClassMaxSize / kSmallClassGranularity;
+    constexpr size_t kSizeClassCount =
+        kSmallClassCount +
+        (kMaxMagazineAllocationSize - kSmallClassMaxSize) / kLargeClassGranularity;
+
+    constexpr uint32_t kMagazineCapacity = 16;
+
+    // Slabs are about 64KB, with at least a magazine's worth of blocks.
+    constexpr size_t kTargetSlabSize = 64 * 1024;
+
+    size_t GetSizeClass(size_t size) {
+        ASSERT(size > 0 && size <= kMaxMagazineAllocationSize);
+        if (size <= kSmallClassMaxSize) {
+            return (size - 1) / kSmallClassGranularity;
+        }
+        return kSmallClassCount + (size - kSmallClassMaxSize - 1) / kLargeClassGranularity;
+    }
+
+    size_t GetSizeClassSize(size_t sizeClass) {
+        if (sizeClass < kSmallClassCount) {
+            return (sizeClass + 1) * kSmallClassGranularity;
+        }
+        return kSmallClassMaxSize + (sizeClass - kSmallClassCount + 1) * kLargeClassGranularity;
+    }
+
+    class SharedSlabAllocator : public SlabAllocatorImpl {
+      public:
+        SharedSlabAllocator(size_t objectSize)
+            : SlabAllocatorImpl(
+                  static_cast<Index>(std::max(kTargetSlabSize / objectSize,
+                                              static_cast<size_t>(kMagazineCapacity))),
+                  static_cast<uint32_t>(objectSize),
+                  alignof(std::max_align_t)) {
+        }
+
+        void AllocateBlocks(void** blocks, uint32_t count) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (uint32_t i = 0; i < count; ++i) {
+                blocks[i] = Allocate();
+            }
+        }
+
+        void DeallocateBlocks(void* const* blocks, uint32_t count) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (uint32_t i = 0; i < count; ++i) {
+                Deallocate(blocks[i]);
+            }
+        }
+
+      private:
+        std::mutex mMutex;
+    };
+
+    // The shared allocators are never destroyed, so that the magazines of the threads exiting
+    // after the static destructors ran can still be returned to them.
+    SharedSlabAllocator* GetSharedSlabAllocator(size_t sizeClass) {
+        static std::array<SharedSlabAllocator*, kSizeClassCount>* allocators = []() {
+            auto* allocators = new std::array<SharedSlabAllocator*, kSizeClassCount>();
+            for (size_t i = 0; i < kSizeClassCount; ++i) {
+                (*allocators)[i] = new SharedSlabAllocator(GetSizeClassSize(i));
+            }
+            return allocators;
+        }();
+        return (*allocators)[sizeClass];
+    }
+
+    struct Magazine {
+        std::array<void*, kMagazineCapacity> blocks;
+        uint32_t count = 0;
+    };
+
+    // Set once the magazines of the thread are destroyed, the objects deallocated later by the
+    // destructors of other thread locals and statics go to the shared allocators directly.
+    thread_local bool tMagazinesDestroyed = false;
+
+    struct ThreadMagazines {
+        ~ThreadMagazines() {
+            tMagazinesDestroyed = true;
+            for (size_t i = 0; i < kSizeClassCount; ++i) {
+                if (magazines[i].count > 0) {
+                    GetSharedSlabAllocator(i)->DeallocateBlocks(magazines[i].blocks.data(),
+                                                                magazines[i].count);
+                }
+            }
+        }
+
+        std::array<Magazine, kSizeClassCount> magazines;
+    };
+
+    Magazine* GetThreadMagazine(size_t sizeClass) {
+        if (tMagazinesDestroyed) {
+            return nullptr;
+        }
+        thread_local ThreadMagazines threadMagazines;
+        return &threadMagazines.magazines[sizeClass];
+    }
+
+}  // anonymous namespace
+
+void* MagazineAllocate(size_t size) {
+    if (size == 0 || size > kMaxMagazineAllocationSize) {
+        return ::operator new(size);
+    }
+
+    size_t sizeClass = GetSizeClass(size);
+    Magazine* magazine = GetThreadMagazine(sizeClass);
+    if (magazine == nullptr) {
+        void* block;
+        GetSharedSlabAllocator(sizeClass)->AllocateBlocks(&block, 1);
+        return block;
+    }
+    if (magazine->count == 0) {
+        constexpr uint32_t kRefillCount = kMagazineCapacity / 2;
+        GetSharedSlabAllocator(sizeClass)->AllocateBlocks(magazine->blocks.data(), kRefillCount);
+        magazine->count = kRefillCount;
+    }
+
+    return magazine->blocks[--magazine->count];
+}
+
+void MagazineDeallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (size == 0 || size > kMaxMagazineAllocationSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    size_t sizeClass = GetSizeClass(size);
+    Magazine* magazine = GetThreadMagazine(sizeClass);
+    if (magazine == nullptr) {
+        GetSharedSlabAllocator(sizeClass)->DeallocateBlocks(&ptr, 1);
+        return;
+    }
+    if (magazine->count == kMagazineCapacity) {
+        // Return the oldest half, the most recently freed blocks are the most likely to be hot in
+        // the cache.
+        constexpr uint32_t kReturnCount = kMagazineCapacity / 2;
+        GetSharedSlabAllocator(sizeClass)->DeallocateBlocks(magazine->blocks.data(),
+                                                            kReturnCount);
+        std::copy(magazine->blocks.begin() + kReturnCount, magazine->blocks.end(),
+                  magazine->blocks.begin());
+        magazine->count -= kReturnCount;
+    }
+
+    magazine->blocks[magazine->count++] = ptr;
+}
@@ -0,0 +1,52 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_MAGAZINEALLOCATOR_H_
+#define COMMON_MAGAZINEALLOCATOR_H_
+
+#include <cstddef>
+
+// The MagazineAllocator allocates small objects of any size out of SlabAllocators shared by all
+// the threads, one per size class. The shared allocators are protected by a lock, so each thread
+// keeps a "magazine" of free blocks per size class in front of them: allocations pop blocks off the
+// magazine and deallocations push them back on it, without synchronization. The lock is only taken
+// to refill an empty magazine or to return the blocks of a full one, half a magazine at a time so
+// that alternating allocations and deallocations don't keep hitting the shared allocator.
+//
+// Objects may be deallocated on another thread than the one they were allocated on, the block then
+// goes into the magazine of the deallocating thread. The magazines of a thread are returned to the
+// shared allocators when the thread exits.
+//
+// Sizes larger than kMaxMagazineAllocationSize are passed through to the global operator new.
+static constexpr size_t kMaxMagazineAllocationSize = 4096;
+
+void* MagazineAllocate(size_t size);
+void MagazineDeallocate(void* ptr, size_t size);
+
+// Classes deriving from MagazineAllocated are allocated with the MagazineAllocator, which
+// replaces the general purpose heap for the objects created and destroyed at a high rate. Objects
+// deleted through a pointer to a base class must have a virtual destructor, so that the size of
+// their dynamic type is passed to operator delete.
+class MagazineAllocated {
+  public:
+    static void* operator new(size_t size) {
+        return MagazineAllocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size) {
+        MagazineDeallocate(ptr, size);
+    }
+};
+
+#endif  // COMMON_MAGAZINEALLOCATOR_H_
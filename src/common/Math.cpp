@@ -36,6 +36,28 @@ uint32_t ScanForward(uint32_t bits) {
 #endif
 }
 
+uint32_t ScanForward64(uint64_t bits) {
+    ASSERT(bits != 0);
+#if defined(DAWN_COMPILER_MSVC)
+#    if defined(DAWN_PLATFORM_64_BIT)
+    unsigned long firstBitIndex = 0ul;
+    unsigned char ret = _BitScanForward64(&firstBitIndex, bits);
+    ASSERT(ret != 0);
+    return firstBitIndex;
+#    else   // defined(DAWN_PLATFORM_64_BIT)
+    unsigned long firstBitIndex = 0ul;
+    if (_BitScanForward(&firstBitIndex, bits & 0xFFFFFFFF)) {
+        return firstBitIndex;
+    }
+    unsigned char ret = _BitScanForward(&firstBitIndex, bits >> 32);
+    ASSERT(ret != 0);
+    return firstBitIndex + 32;
+#    endif  // defined(DAWN_PLATFORM_64_BIT)
+#else       // defined(DAWN_COMPILER_MSVC)
+    return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif      // defined(DAWN_COMPILER_MSVC)
+}
+
 uint32_t Log2(uint32_t value) {
     ASSERT(value != 0);
 #if defined(DAWN_COMPILER_MSVC)
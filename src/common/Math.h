@@ -26,6 +26,7 @@
 
 // The following are not valid for 0
 uint32_t ScanForward(uint32_t bits);
+uint32_t ScanForward64(uint64_t bits);
 uint32_t Log2(uint32_t value);
 uint32_t Log2(uint64_t value);
 bool IsPowerOfTwo(uint64_t n);
@@ -50,6 +50,8 @@ SlabAllocatorImpl::SentinelSlab::~SentinelSlab() {
     while (slab != nullptr) {
         Slab* next = slab->next;
         ASSERT(slab->blocksInUse == 0);
+        // The slab lives in its own allocation, free it only once the slab is destroyed.
+        std::unique_ptr<char[]> allocation = std::move(slab->allocation);
         slab->~Slab();
         slab = next;
     }
@@ -0,0 +1,89 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/WorkerThreadPool.h"
+
+#include "common/Assert.h"
+
+WorkerThreadPool::WorkerThreadPool(uint32_t threadCount) {
+    mThreads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        mThreads.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ASSERT(mTask == nullptr);
+        mStopping = true;
+    }
+    mTasksAvailable.notify_all();
+
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+}
+
+void WorkerThreadPool::ParallelFor(uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    ASSERT(mTask == nullptr);
+    mTask = &task;
+    mTaskCount = taskCount;
+    mNextTask = 0;
+    mUnfinishedTaskCount = taskCount;
+    mTasksAvailable.notify_all();
+
+    RunTasks(&lock);
+    mTasksFinished.wait(lock, [this]() { return mUnfinishedTaskCount == 0; });
+
+    mTask = nullptr;
+    mTaskCount = 0;
+    mNextTask = 0;
+}
+
+uint32_t WorkerThreadPool::GetThreadCount() const {
+    return static_cast<uint32_t>(mThreads.size());
+}
+
+void WorkerThreadPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mTasksAvailable.wait(lock, [this]() { return mStopping || mNextTask < mTaskCount; });
+        if (mStopping) {
+            return;
+        }
+        RunTasks(&lock);
+    }
+}
+
+void WorkerThreadPool::RunTasks(std::unique_lock<std::mutex>* lock) {
+    while (mNextTask < mTaskCount) {
+        uint32_t index = mNextTask++;
+        const std::function<void(uint32_t)>& task = *mTask;
+
+        lock->unlock();
+        task(index);
+        lock->lock();
+
+        ASSERT(mUnfinishedTaskCount > 0);
+        if (--mUnfinishedTaskCount == 0) {
+            mTasksFinished.notify_all();
+        }
+    }
+}
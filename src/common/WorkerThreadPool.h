@@ -0,0 +1,59 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_WORKERTHREADPOOL_H_
+#define COMMON_WORKERTHREADPOOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads which run the tasks of ParallelFor. The threads are kept alive between
+// calls so that spreading a small amount of work doesn't pay for thread creation every time.
+class WorkerThreadPool {
+  public:
+    explicit WorkerThreadPool(uint32_t threadCount);
+    ~WorkerThreadPool();
+
+    WorkerThreadPool(const WorkerThreadPool&) = delete;
+    WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
+
+    // Calls task(i) for each i in [0, taskCount) and returns once all of them have returned. The
+    // calling thread runs tasks as well, so a pool without threads runs them all serially. Only
+    // one thread at a time may call ParallelFor.
+    void ParallelFor(uint32_t taskCount, const std::function<void(uint32_t)>& task);
+
+    uint32_t GetThreadCount() const;
+
+  private:
+    void WorkerLoop();
+    // Runs tasks until there are none left to start. The lock is released while a task runs.
+    void RunTasks(std::unique_lock<std::mutex>* lock);
+
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mTasksAvailable;
+    std::condition_variable mTasksFinished;
+    const std::function<void(uint32_t)>* mTask = nullptr;
+    uint32_t mTaskCount = 0;
+    uint32_t mNextTask = 0;
+    uint32_t mUnfinishedTaskCount = 0;
+    bool mStopping = false;
+};
+
+#endif  // COMMON_WORKERTHREADPOOL_H_
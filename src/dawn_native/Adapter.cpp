@@ -34,16 +34,26 @@ namespace dawn_native {
         return mPCIInfo;
     }
 
+    const std::vector<uint8_t>& AdapterBase::GetDriverFingerprint() const {
+        return mDriverFingerprint;
+    }
+
     InstanceBase* AdapterBase::GetInstance() const {
         return mInstance;
     }
 
-    ExtensionsSet AdapterBase::GetSupportedExtensions() const {
+    ExtensionsSet AdapterBase::GetSupportedExtensions() {
+        if (mInstance->ConsumedError(InitializeDetails())) {
+            return {};
+        }
         return mSupportedExtensions;
     }
 
     bool AdapterBase::SupportsAllRequestedExtensions(
-        const std::vector<const char*>& requestedExtensions) const {
+        const std::vector<const char*>& requestedExtensions) {
+        if (mInstance->ConsumedError(InitializeDetails())) {
+            return false;
+        }
         for (const char* extensionStr : requestedExtensions) {
             Extension extensionEnum = mInstance->ExtensionNameToEnum(extensionStr);
             if (extensionEnum == Extension::InvalidEnum) {
@@ -56,13 +66,32 @@ namespace dawn_native {
         return true;
     }
 
-    WGPUDeviceProperties AdapterBase::GetAdapterProperties() const {
+    WGPUDeviceProperties AdapterBase::GetAdapterProperties() {
         WGPUDeviceProperties adapterProperties = {};
 
+        if (mInstance->ConsumedError(InitializeDetails())) {
+            return adapterProperties;
+        }
         mSupportedExtensions.InitializeDeviceProperties(&adapterProperties);
         return adapterProperties;
     }
 
+    MaybeError AdapterBase::InitializeDetailsImpl() {
+        return {};
+    }
+
+    MaybeError AdapterBase::InitializeDetails() {
+        // Adapters can be queried and used to create devices from several threads.
+        std::lock_guard<std::mutex> lock(mDetailsMutex);
+        if (mDetailsInitialized) {
+            return {};
+        }
+
+        DAWN_TRY(InitializeDetailsImpl());
+        mDetailsInitialized = true;
+        return {};
+    }
+
     DeviceBase* AdapterBase::CreateDevice(const DeviceDescriptor* descriptor) {
         DeviceBase* result = nullptr;
 
@@ -75,6 +104,8 @@ namespace dawn_native {
 
     MaybeError AdapterBase::CreateDeviceInternal(DeviceBase** result,
                                                  const DeviceDescriptor* descriptor) {
+        DAWN_TRY(InitializeDetails());
+
         if (descriptor != nullptr) {
             if (!SupportsAllRequestedExtensions(descriptor->requiredExtensions)) {
                 return DAWN_VALIDATION_ERROR("One or more requested extensions are not supported");
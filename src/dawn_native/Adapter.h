@@ -21,7 +21,9 @@
 #include "dawn_native/Extensions.h"
 #include "dawn_native/dawn_platform.h"
 
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace dawn_native {
 
@@ -36,26 +38,38 @@ namespace dawn_native {
         wgpu::AdapterType GetAdapterType() const;
         const PCIInfo& GetPCIInfo() const;
         InstanceBase* GetInstance() const;
+        // Identifies the driver of the adapter, so that the persistent caches of other driver
+        // versions aren't reused. Empty when the backend doesn't expose it.
+        const std::vector<uint8_t>& GetDriverFingerprint() const;
 
         DeviceBase* CreateDevice(const DeviceDescriptor* descriptor = nullptr);
 
-        ExtensionsSet GetSupportedExtensions() const;
-        bool SupportsAllRequestedExtensions(
-            const std::vector<const char*>& requestedExtensions) const;
-        WGPUDeviceProperties GetAdapterProperties() const;
+        // These initialize the details of the adapter the first time they are called.
+        ExtensionsSet GetSupportedExtensions();
+        bool SupportsAllRequestedExtensions(const std::vector<const char*>& requestedExtensions);
+        WGPUDeviceProperties GetAdapterProperties();
 
       protected:
         PCIInfo mPCIInfo = {};
+        std::vector<uint8_t> mDriverFingerprint;
         wgpu::AdapterType mAdapterType = wgpu::AdapterType::Unknown;
         ExtensionsSet mSupportedExtensions;
 
       private:
         virtual ResultOrError<DeviceBase*> CreateDeviceImpl(const DeviceDescriptor* descriptor) = 0;
 
+        // Discovery only gathers what is needed to list the adapter (PCI info and adapter type).
+        // The rest, like the supported extensions, is gathered here when the adapter is used.
+        virtual MaybeError InitializeDetailsImpl();
+        MaybeError InitializeDetails();
+
         MaybeError CreateDeviceInternal(DeviceBase** result, const DeviceDescriptor* descriptor);
 
         InstanceBase* mInstance = nullptr;
         wgpu::BackendType mBackend;
+
+        std::mutex mDetailsMutex;
+        bool mDetailsInitialized = false;
     };
 
 }  // namespace dawn_native
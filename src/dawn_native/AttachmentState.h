@@ -39,7 +39,7 @@ namespace dawn_native {
 
         AttachmentStateBlueprint(const AttachmentStateBlueprint& rhs);
 
-        // Functors necessary for the unordered_set<AttachmentState*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<AttachmentStateBlueprint>.
         struct HashFunc {
             size_t operator()(const AttachmentStateBlueprint* attachmentState) const;
         };
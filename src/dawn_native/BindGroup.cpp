@@ -15,6 +15,8 @@
 #include "dawn_native/BindGroup.h"
 
 #include "common/Assert.h"
+#include "common/BitSetIterator.h"
+#include "common/HashUtils.h"
 #include "common/Math.h"
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Buffer.h"
@@ -125,6 +127,12 @@ namespace dawn_native {
             return {};
         }
 
+        bool IsBufferBinding(wgpu::BindingType type) {
+            return type == wgpu::BindingType::UniformBuffer ||
+                   type == wgpu::BindingType::StorageBuffer ||
+                   type == wgpu::BindingType::ReadonlyStorageBuffer;
+        }
+
     }  // anonymous namespace
 
     MaybeError ValidateBindGroupDescriptor(DeviceBase* device,
@@ -135,6 +143,11 @@ namespace dawn_native {
 
         DAWN_TRY(device->ValidateObject(descriptor->layout));
 
+        if (descriptor->layout->IsResourceTableLayout()) {
+            return DAWN_VALIDATION_ERROR(
+                "Resource table layouts are used with CreateResourceTable, not CreateBindGroup");
+        }
+
         const BindGroupLayoutBase::LayoutBindingInfo& layoutInfo =
             descriptor->layout->GetBindingInfo();
 
@@ -209,7 +222,7 @@ namespace dawn_native {
     BindGroupBase::BindGroupBase(DeviceBase* device,
                                  const BindGroupDescriptor* descriptor,
                                  void* bindingDataStart)
-        : ObjectBase(device),
+        : CachedObject(device),
           mLayout(descriptor->layout),
           mBindingData(mLayout->ComputeBindingDataPointers(bindingDataStart)) {
         for (uint32_t i = 0; i < mLayout->GetBindingCount(); ++i) {
@@ -258,7 +271,13 @@ namespace dawn_native {
     }
 
     BindGroupBase::~BindGroupBase() {
-        if (mLayout) {
+        // Uncache while the bindings are still alive, they are needed to find the bind group.
+        if (IsCachedReference()) {
+            GetDevice()->UncacheBindGroup(this);
+        }
+
+        // Resource tables don't have binding data, they store their resources themselves.
+        if (mLayout && !mLayout->IsResourceTableLayout()) {
             ASSERT(!IsError());
             for (uint32_t i = 0; i < mLayout->GetBindingCount(); ++i) {
                 mBindingData.bindings[i].~Ref<ObjectBase>();
@@ -266,8 +285,13 @@ namespace dawn_native {
         }
     }
 
+    BindGroupBase::BindGroupBase(DeviceBase* device, BindGroupLayoutBase* layout)
+        : CachedObject(device), mLayout(layout), mBindingData() {
+        ASSERT(layout->IsResourceTableLayout());
+    }
+
     BindGroupBase::BindGroupBase(DeviceBase* device, ObjectBase::ErrorTag tag)
-        : ObjectBase(device, tag), mBindingData() {
+        : CachedObject(device, tag), mBindingData() {
     }
 
     // static
@@ -275,6 +299,47 @@ namespace dawn_native {
         return new BindGroupBase(device, ObjectBase::kError);
     }
 
+    size_t BindGroupBase::HashFunc::operator()(const BindGroupBase* bindGroup) const {
+        const BindGroupLayoutBase* layout = bindGroup->mLayout.Get();
+        const BindGroupLayoutBase::LayoutBindingInfo& info = layout->GetBindingInfo();
+
+        size_t hash = Hash(layout);
+        for (uint32_t binding : IterateBitSet(info.mask)) {
+            HashCombine(&hash, bindGroup->mBindingData.bindings[binding].Get());
+            if (IsBufferBinding(info.types[binding])) {
+                const BindGroupLayoutBase::BufferBindingData& bufferData =
+                    bindGroup->mBindingData.bufferData[binding];
+                HashCombine(&hash, bufferData.offset, bufferData.size);
+            }
+        }
+        return hash;
+    }
+
+    bool BindGroupBase::EqualityFunc::operator()(const BindGroupBase* a,
+                                                 const BindGroupBase* b) const {
+        if (a->mLayout.Get() != b->mLayout.Get()) {
+            return false;
+        }
+
+        const BindGroupLayoutBase::LayoutBindingInfo& info = a->mLayout->GetBindingInfo();
+        for (uint32_t binding : IterateBitSet(info.mask)) {
+            if (a->mBindingData.bindings[binding].Get() !=
+                b->mBindingData.bindings[binding].Get()) {
+                return false;
+            }
+            if (IsBufferBinding(info.types[binding])) {
+                const BindGroupLayoutBase::BufferBindingData& aData =
+                    a->mBindingData.bufferData[binding];
+                const BindGroupLayoutBase::BufferBindingData& bData =
+                    b->mBindingData.bufferData[binding];
+                if (aData.offset != bData.offset || aData.size != bData.size) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     BindGroupLayoutBase* BindGroupBase::GetLayout() {
         ASSERT(!IsError());
         return mLayout.Get();
@@ -319,4 +384,12 @@ namespace dawn_native {
         return static_cast<TextureViewBase*>(mBindingData.bindings[binding].Get());
     }
 
+    // BindGroupBlueprint
+
+    BindGroupBlueprint::BindGroupBlueprint(DeviceBase* device,
+                                           const BindGroupDescriptor* descriptor)
+        : BindGroupBase(device, descriptor, bindingData) {
+        ASSERT(descriptor->layout->GetBindingDataSize() <= kMaxBindingDataSize);
+    }
+
 }  // namespace dawn_native
@@ -18,9 +18,9 @@
 #include "common/Constants.h"
 #include "common/Math.h"
 #include "dawn_native/BindGroupLayout.h"
+#include "dawn_native/CachedObject.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
-#include "dawn_native/ObjectBase.h"
 
 #include "dawn_native/dawn_platform.h"
 
@@ -39,12 +39,21 @@ namespace dawn_native {
         uint64_t size;
     };
 
-    class BindGroupBase : public ObjectBase {
+    class BindGroupBase : public CachedObject {
       public:
         ~BindGroupBase() override;
 
         static BindGroupBase* MakeError(DeviceBase* device);
 
+        // Functors necessary for the ContentLessObjectCache<BindGroupBase>. Bind groups are
+        // equal when they have the same layout and the same resources bound with the same ranges.
+        struct HashFunc {
+            size_t operator()(const BindGroupBase* bindGroup) const;
+        };
+        struct EqualityFunc {
+            bool operator()(const BindGroupBase* a, const BindGroupBase* b) const;
+        };
+
         BindGroupLayoutBase* GetLayout();
         BufferBinding GetBindingAsBufferBinding(size_t binding);
         SamplerBase* GetBindingAsSampler(size_t binding);
@@ -71,13 +80,36 @@ namespace dawn_native {
             static_assert(std::is_base_of<BindGroupBase, Derived>::value, "");
         }
 
-      private:
+        // Constructs the base of a ResourceTableBase. Resource tables are set like bind groups
+        // but store their resources themselves, so they don't have binding data.
+        BindGroupBase(DeviceBase* device, BindGroupLayoutBase* layout);
+
         BindGroupBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
+      private:
+
         Ref<BindGroupLayoutBase> mLayout;
         BindGroupLayoutBase::BindingDataPointers mBindingData;
     };
 
+    namespace detail {
+        struct BindGroupBlueprintStorage {
+            static constexpr size_t kMaxBindingDataSize =
+                kMaxBindingsPerGroup * (sizeof(BindGroupLayoutBase::BufferBindingData) +
+                                        sizeof(Ref<ObjectBase>));
+
+            alignas(BindGroupLayoutBase::GetBindingDataAlignment()) char
+                bindingData[kMaxBindingDataSize];
+        };
+    }  // namespace detail
+
+    // A frontend-only bind group used to look up the device's cache of bind groups. Its binding
+    // data is stored inline, in a base class so that it is constructed before BindGroupBase.
+    class BindGroupBlueprint : private detail::BindGroupBlueprintStorage, public BindGroupBase {
+      public:
+        BindGroupBlueprint(DeviceBase* device, const BindGroupDescriptor* descriptor);
+    };
+
 }  // namespace dawn_native
 
 #endif  // DAWNNATIVE_BINDGROUP_H_
@@ -18,6 +18,8 @@
 #include "dawn_native/BindGroup.h"
 #include "dawn_native/BindGroupTracker.h"
 
+#include <set>
+
 namespace dawn_native {
 
     // Extends BindGroupTrackerBase to also keep track of resources that need a usage transition.
@@ -40,15 +42,14 @@ namespace dawn_native {
                 const BindGroupLayoutBase* layout = bindGroup->GetLayout();
                 const auto& info = layout->GetBindingInfo();
 
+                constexpr wgpu::ShaderStage kBarrierStages =
+                    wgpu::ShaderStage::Compute | wgpu::ShaderStage::RayGeneration |
+                    wgpu::ShaderStage::RayAnyHit | wgpu::ShaderStage::RayClosestHit |
+                    wgpu::ShaderStage::RayMiss | wgpu::ShaderStage::RayIntersection |
+                    wgpu::ShaderStage::RayCallable;
+
                 for (uint32_t binding : IterateBitSet(info.mask)) {
-                    if (
-                        ((info.visibilities[binding] & wgpu::ShaderStage::Compute) == 0) ||
-                        ((info.visibilities[binding] & wgpu::ShaderStage::RayGeneration) == 0) ||
-                        ((info.visibilities[binding] & wgpu::ShaderStage::RayAnyHit) == 0) ||
-                        ((info.visibilities[binding] & wgpu::ShaderStage::RayClosestHit) == 0) ||
-                        ((info.visibilities[binding] & wgpu::ShaderStage::RayMiss) == 0) ||
-                        ((info.visibilities[binding] & wgpu::ShaderStage::RayIntersection) == 0)
-                        ) {
+                    if ((info.visibilities[binding] & kBarrierStages) == 0) {
                         continue;
                     }
 
@@ -83,11 +84,30 @@ namespace dawn_native {
             Base::OnSetBindGroup(index, bindGroup, dynamicOffsetCount, dynamicOffsets);
         }
 
+        // Called at the start of each pass. When the dispatches of the pass are independent, the
+        // storage buffers only need a barrier before the first dispatch of the pass using them.
+        void OnBeginPass(bool independentDispatches) {
+            mIndependentDispatches = independentDispatches;
+            mBuffersTransitionedInPass.clear();
+        }
+
       protected:
+        // Whether the storage buffer needs a barrier before the next dispatch.
+        bool NeedsStorageBarrier(BufferBase* buffer) {
+            if (!mIndependentDispatches) {
+                return true;
+            }
+            return mBuffersTransitionedInPass.insert(buffer).second;
+        }
+
         std::array<std::bitset<kMaxBindingsPerGroup>, kMaxBindGroups> mBuffersNeedingBarrier = {};
         std::array<std::array<wgpu::BindingType, kMaxBindingsPerGroup>, kMaxBindGroups>
             mBindingTypes = {};
         std::array<std::array<BufferBase*, kMaxBindingsPerGroup>, kMaxBindGroups> mBuffers = {};
+
+      private:
+        bool mIndependentDispatches = false;
+        std::set<BufferBase*> mBuffersTransitionedInPass;
     };
 
 }  // namespace dawn_native
@@ -55,10 +55,16 @@ namespace dawn_native {
                 break;
             case wgpu::BindingType::AccelerationContainer:
                 // TODO: spec says acceleration container is NOT available in any-hit shader?
+                // Non ray tracing stages could only use acceleration containers through inline
+                // ray queries (SPV_KHR_ray_query), which VK_NV_ray_tracing doesn't provide.
                 if ((shaderStageVisibility & wgpu::ShaderStage::Vertex) != 0 ||
                     (shaderStageVisibility & wgpu::ShaderStage::Fragment) != 0 ||
-                    (shaderStageVisibility & wgpu::ShaderStage::Compute) != 0 ||
-                    (shaderStageVisibility & wgpu::ShaderStage::RayIntersection) != 0) {
+                    (shaderStageVisibility & wgpu::ShaderStage::Compute) != 0) {
+                    return DAWN_VALIDATION_ERROR(
+                        "acceleration container bindings are only supported in ray tracing "
+                        "shaders, inline ray queries aren't supported");
+                }
+                if ((shaderStageVisibility & wgpu::ShaderStage::RayIntersection) != 0) {
                     return DAWN_VALIDATION_ERROR(
                         "acceleration container binding is not supported in this shader");
                 }
@@ -68,7 +74,45 @@ namespace dawn_native {
         return {};
     }
 
-    MaybeError ValidateBindGroupLayoutDescriptor(DeviceBase*,
+    namespace {
+
+        MaybeError ValidateResourceTableLayout(const DeviceBase* device,
+                                               const BindGroupLayoutDescriptor* descriptor) {
+            if (!device->IsExtensionEnabled(Extension::ResourceTables)) {
+                return DAWN_VALIDATION_ERROR("The resource tables extension is not enabled");
+            }
+
+            if (descriptor->resourceTableCapacity > kMaxResourceTableCapacity) {
+                return DAWN_VALIDATION_ERROR("Resource table capacity over the max");
+            }
+
+            if (descriptor->bindingCount != 1) {
+                return DAWN_VALIDATION_ERROR("Resource table layouts must have a single binding");
+            }
+
+            // Samplers and writable resources would need their own descriptor heaps and barriers
+            // on D3D12, so tables only hold the read-only resources materials are made of.
+            const BindGroupLayoutBinding& binding = descriptor->bindings[0];
+            if (binding.type != wgpu::BindingType::SampledTexture &&
+                binding.type != wgpu::BindingType::ReadonlyStorageBuffer) {
+                return DAWN_VALIDATION_ERROR(
+                    "Resource tables can only hold sampled textures or readonly storage buffers");
+            }
+
+            if (binding.hasDynamicOffset) {
+                return DAWN_VALIDATION_ERROR("Resource table bindings cannot be dynamic");
+            }
+
+            if (descriptor->pushDescriptors) {
+                return DAWN_VALIDATION_ERROR("Resource table layouts cannot use push descriptors");
+            }
+
+            return {};
+        }
+
+    }  // anonymous namespace
+
+    MaybeError ValidateBindGroupLayoutDescriptor(DeviceBase* device,
                                                  const BindGroupLayoutDescriptor* descriptor) {
         if (descriptor->nextInChain != nullptr) {
             return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
@@ -144,6 +188,15 @@ namespace dawn_native {
                 "The number of dynamic storage buffer exceeds the maximum value");
         }
 
+        if (descriptor->pushDescriptors &&
+            (dynamicUniformBufferCount > 0 || dynamicStorageBufferCount > 0)) {
+            return DAWN_VALIDATION_ERROR("Push descriptor layouts cannot have dynamic buffers");
+        }
+
+        if (descriptor->resourceTableCapacity > 0) {
+            DAWN_TRY(ValidateResourceTableLayout(device, descriptor));
+        }
+
         return {};
     }  // namespace dawn_native
 
@@ -184,7 +237,9 @@ namespace dawn_native {
 
     BindGroupLayoutBase::BindGroupLayoutBase(DeviceBase* device,
                                              const BindGroupLayoutDescriptor* descriptor)
-        : CachedObject(device) {
+        : CachedObject(device),
+          mPushDescriptors(descriptor->pushDescriptors),
+          mResourceTableCapacity(descriptor->resourceTableCapacity) {
         for (uint32_t i = 0; i < descriptor->bindingCount; ++i) {
             auto& binding = descriptor->bindings[i];
 
@@ -261,12 +316,28 @@ namespace dawn_native {
     }
 
     size_t BindGroupLayoutBase::HashFunc::operator()(const BindGroupLayoutBase* bgl) const {
-        return HashBindingInfo(bgl->mBindingInfo);
+        size_t hash = HashBindingInfo(bgl->mBindingInfo);
+        HashCombine(&hash, bgl->mPushDescriptors, bgl->mResourceTableCapacity);
+        return hash;
     }
 
     bool BindGroupLayoutBase::EqualityFunc::operator()(const BindGroupLayoutBase* a,
                                                        const BindGroupLayoutBase* b) const {
-        return a->mBindingInfo == b->mBindingInfo;
+        return a->mPushDescriptors == b->mPushDescriptors &&
+               a->mResourceTableCapacity == b->mResourceTableCapacity &&
+               a->mBindingInfo == b->mBindingInfo;
+    }
+
+    bool BindGroupLayoutBase::UsesPushDescriptors() const {
+        return mPushDescriptors;
+    }
+
+    bool BindGroupLayoutBase::IsResourceTableLayout() const {
+        return mResourceTableCapacity > 0;
+    }
+
+    uint32_t BindGroupLayoutBase::GetResourceTableCapacity() const {
+        return mResourceTableCapacity;
     }
 
     uint32_t BindGroupLayoutBase::GetBindingCount() const {
@@ -54,7 +54,7 @@ namespace dawn_native {
         };
         const LayoutBindingInfo& GetBindingInfo() const;
 
-        // Functors necessary for the unordered_set<BGLBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<BindGroupLayoutBase>.
         struct HashFunc {
             size_t operator()(const BindGroupLayoutBase* bgl) const;
         };
@@ -62,6 +62,16 @@ namespace dawn_native {
             bool operator()(const BindGroupLayoutBase* a, const BindGroupLayoutBase* b) const;
         };
 
+        // Push descriptors are a hint for backends where writing the bindings directly in the
+        // command buffer is cheaper than allocating a descriptor set for each bind group.
+        bool UsesPushDescriptors() const;
+
+        // Resource table layouts have a single binding that is an array of
+        // GetResourceTableCapacity() descriptors. Their resources are set in ResourceTables,
+        // which are updated in place, instead of bind groups.
+        bool IsResourceTableLayout() const;
+        uint32_t GetResourceTableCapacity() const;
+
         uint32_t GetBindingCount() const;
         uint32_t GetDynamicBufferCount() const;
         uint32_t GetDynamicUniformBufferCount() const;
@@ -101,6 +111,8 @@ namespace dawn_native {
         BindGroupLayoutBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         LayoutBindingInfo mBindingInfo;
+        bool mPushDescriptors = false;
+        uint32_t mResourceTableCapacity = 0;
         uint32_t mBindingCount = 0;
         uint32_t mBufferCount = 0;
         uint32_t mDynamicUniformBufferCount = 0;
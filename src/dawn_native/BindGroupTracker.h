@@ -38,21 +38,23 @@ namespace dawn_native {
                             uint32_t* dynamicOffsets) {
             ASSERT(index < kMaxBindGroups);
 
-            if (mBindGroupLayoutsMask[index]) {
-                // It is okay to only dirty bind groups that are used by the current pipeline
-                // layout. If the pipeline layout changes, then the bind groups it uses will
-                // become dirty.
-
-                if (mBindGroups[index] != bindGroup) {
-                    mDirtyBindGroups.set(index);
-                    mDirtyBindGroupsObjectChangedOrIsDynamic.set(index);
-                }
-
-                if (dynamicOffsetCount > 0) {
-                    mDirtyBindGroupsObjectChangedOrIsDynamic.set(index);
-                }
+            // Setting the same bind group with the same dynamic offsets again doesn't need to
+            // apply anything.
+            if (mBindGroups[index] != bindGroup) {
+                mChangedBindGroups.set(index);
+                mChangedBindGroupsOrDynamicOffsets.set(index);
+            } else if (dynamicOffsetCount > 0 &&
+                       !DynamicOffsetsEqual(mDynamicOffsets[index].data(), dynamicOffsetCount,
+                                            dynamicOffsets)) {
+                mChangedBindGroupsOrDynamicOffsets.set(index);
             }
 
+            // It is okay to only dirty bind groups that are used by the current pipeline layout.
+            // If the pipeline layout changes, then the bind groups it uses will become dirty.
+            mDirtyBindGroups |= mChangedBindGroups & mBindGroupLayoutsMask;
+            mDirtyBindGroupsObjectChangedOrIsDynamic |=
+                mChangedBindGroupsOrDynamicOffsets & mBindGroupLayoutsMask;
+
             mBindGroups[index] = bindGroup;
             mDynamicOffsetCounts[index] = dynamicOffsetCount;
             SetDynamicOffsets(mDynamicOffsets[index].data(), dynamicOffsetCount, dynamicOffsets);
@@ -60,32 +62,32 @@ namespace dawn_native {
 
         void OnSetPipeline(PipelineBase* pipeline) {
             mPipelineLayout = pipeline->GetLayout();
-            if (mLastAppliedPipelineLayout == mPipelineLayout) {
-                return;
-            }
 
             // Keep track of the bind group layout mask to avoid marking unused bind groups as
             // dirty. This also allows us to avoid computing the intersection of the dirty bind
             // groups and bind group layout mask in Draw or Dispatch which is very hot code.
             mBindGroupLayoutsMask = mPipelineLayout->GetBindGroupLayoutsMask();
 
-            // Changing the pipeline layout sets bind groups as dirty. If CanInheritBindGroups,
-            // the first |k| matching bind groups may be inherited.
-            if (CanInheritBindGroups && mLastAppliedPipelineLayout != nullptr) {
-                // Dirty bind groups that cannot be inherited.
-                std::bitset<kMaxBindGroups> dirtiedGroups =
-                    ~mPipelineLayout->InheritedGroupsMask(mLastAppliedPipelineLayout);
-
-                mDirtyBindGroups |= dirtiedGroups;
-                mDirtyBindGroupsObjectChangedOrIsDynamic |= dirtiedGroups;
-
-                // Clear any bind groups not in the mask.
-                mDirtyBindGroups &= mBindGroupLayoutsMask;
-                mDirtyBindGroupsObjectChangedOrIsDynamic &= mBindGroupLayoutsMask;
-            } else {
-                mDirtyBindGroups = mBindGroupLayoutsMask;
-                mDirtyBindGroupsObjectChangedOrIsDynamic = mBindGroupLayoutsMask;
+            // The dirty bind groups are computed from the last applied pipeline layout and not
+            // the one of the previous pipeline, so that switching pipelines several times
+            // between two draws only applies what differs from the bound state. Changing the
+            // pipeline layout sets bind groups as dirty. If CanInheritBindGroups, the first |k|
+            // matching bind groups may be inherited.
+            std::bitset<kMaxBindGroups> dirtiedGroups = 0;
+            if (mLastAppliedPipelineLayout != mPipelineLayout) {
+                if (CanInheritBindGroups && mLastAppliedPipelineLayout != nullptr) {
+                    // Dirty bind groups that cannot be inherited.
+                    dirtiedGroups =
+                        ~mPipelineLayout->InheritedGroupsMask(mLastAppliedPipelineLayout);
+                } else {
+                    dirtiedGroups.set();
+                }
             }
+
+            // Clear any bind groups not in the mask.
+            mDirtyBindGroups = (mChangedBindGroups | dirtiedGroups) & mBindGroupLayoutsMask;
+            mDirtyBindGroupsObjectChangedOrIsDynamic =
+                (mChangedBindGroupsOrDynamicOffsets | dirtiedGroups) & mBindGroupLayoutsMask;
         }
 
       protected:
@@ -95,6 +97,8 @@ namespace dawn_native {
             // will be dirtied again by the next pipeline change.
             mDirtyBindGroups.reset();
             mDirtyBindGroupsObjectChangedOrIsDynamic.reset();
+            mChangedBindGroups.reset();
+            mChangedBindGroupsOrDynamicOffsets.reset();
             mLastAppliedPipelineLayout = mPipelineLayout;
         }
 
@@ -113,6 +117,11 @@ namespace dawn_native {
         PipelineLayoutBase* mLastAppliedPipelineLayout = nullptr;
 
       private:
+        // The bind groups, and the bind groups or their dynamic offsets, that were set since the
+        // last time bind groups were applied, including the ones the pipeline layout doesn't use.
+        std::bitset<kMaxBindGroups> mChangedBindGroups = 0;
+        std::bitset<kMaxBindGroups> mChangedBindGroupsOrDynamicOffsets = 0;
+
         // We have two overloads here because offsets in Vulkan are uint32_t but uint64_t
         // in other backends.
         static void SetDynamicOffsets(uint64_t* data,
@@ -128,6 +137,23 @@ namespace dawn_native {
                                       uint32_t* dynamicOffsets) {
             memcpy(data, dynamicOffsets, sizeof(uint32_t) * dynamicOffsetCount);
         }
+
+        static bool DynamicOffsetsEqual(const uint64_t* data,
+                                        uint32_t dynamicOffsetCount,
+                                        const uint32_t* dynamicOffsets) {
+            for (uint32_t i = 0; i < dynamicOffsetCount; ++i) {
+                if (data[i] != static_cast<uint64_t>(dynamicOffsets[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool DynamicOffsetsEqual(const uint32_t* data,
+                                        uint32_t dynamicOffsetCount,
+                                        const uint32_t* dynamicOffsets) {
+            return memcmp(data, dynamicOffsets, sizeof(uint32_t) * dynamicOffsetCount) == 0;
+        }
     };
 
 }  // namespace dawn_native
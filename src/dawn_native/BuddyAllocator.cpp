@@ -19,14 +19,18 @@
 
 namespace dawn_native {
 
-    BuddyAllocator::BuddyAllocator(uint64_t maxSize) : mMaxBlockSize(maxSize) {
+    static constexpr size_t kBlocksPerSlab = 64;
+
+    BuddyAllocator::BuddyAllocator(uint64_t maxSize)
+        : mMaxBlockSize(maxSize), mBlockAllocator(kBlocksPerSlab * sizeof(BuddyBlock)) {
         ASSERT(IsPowerOfTwo(maxSize));
 
         mFreeLists.resize(Log2(mMaxBlockSize) + 1);
+        ASSERT(mFreeLists.size() <= 64);
 
         // Insert the level0 free block.
-        mRoot = new BuddyBlock(maxSize, /*offset*/ 0);
-        mFreeLists[0] = {mRoot};
+        mRoot = NewBlock(maxSize, /*offset*/ 0);
+        InsertFreeBlock(mRoot, 0);
     }
 
     BuddyAllocator::~BuddyAllocator() {
@@ -35,6 +39,10 @@ namespace dawn_native {
         }
     }
 
+    BuddyAllocator::BuddyBlock* BuddyAllocator::NewBlock(uint64_t size, uint64_t offset) {
+        return mBlockAllocator.Allocate(size, offset);
+    }
+
     uint64_t BuddyAllocator::ComputeTotalNumOfFreeBlocksForTesting() const {
         return ComputeNumOfFreeBlocks(mRoot);
     }
@@ -81,15 +89,19 @@ namespace dawn_native {
         //  Allocate(size=8, alignment=4) will be satified by using F1.
         //  Allocate(size=8, alignment=16) will be satisified by using F2.
         //
-        for (size_t currLevel = allocationBlockLevel; currLevel >= 0; currLevel--) {
+        // Only the levels with free blocks are visited, from the allocation level up to the root.
+        uint64_t candidateLevels = mFreeLevelsBitmap;
+        if (allocationBlockLevel < 63) {
+            candidateLevels &= (uint64_t(1) << (allocationBlockLevel + 1)) - 1;
+        }
+        while (candidateLevels != 0) {
+            const uint32_t currLevel = Log2(candidateLevels);
             BuddyBlock* freeBlock = mFreeLists[currLevel].head;
-            if (freeBlock && (freeBlock->mOffset % alignment == 0)) {
+            ASSERT(freeBlock != nullptr);
+            if (freeBlock->mOffset % alignment == 0) {
                 return currLevel;
             }
-
-            if (currLevel == 0) {
-                break;
-            }
+            candidateLevels &= ~(uint64_t(1) << currLevel);
         }
         return kInvalidOffset;  // No free block exists at any level.
     }
@@ -114,6 +126,7 @@ namespace dawn_native {
         }
 
         mFreeLists[level].head = block;
+        mFreeLevelsBitmap |= uint64_t(1) << level;
     }
 
     void BuddyAllocator::RemoveFreeBlock(BuddyBlock* block, size_t level) {
@@ -122,6 +135,11 @@ namespace dawn_native {
         if (mFreeLists[level].head == block) {
             // Block is in HEAD position.
             mFreeLists[level].head = mFreeLists[level].head->free.pNext;
+            if (mFreeLists[level].head == nullptr) {
+                mFreeLevelsBitmap &= ~(uint64_t(1) << level);
+            } else {
+                mFreeLists[level].head->free.pPrev = nullptr;
+            }
         } else {
             // Block is after HEAD position.
             BuddyBlock* pPrev = block->free.pPrev;
@@ -169,9 +187,9 @@ namespace dawn_native {
 
             // Create two free child blocks (the buddies).
             const uint64_t nextLevelSize = currBlock->mSize / 2;
-            BuddyBlock* leftChildBlock = new BuddyBlock(nextLevelSize, currBlock->mOffset);
+            BuddyBlock* leftChildBlock = NewBlock(nextLevelSize, currBlock->mOffset);
             BuddyBlock* rightChildBlock =
-                new BuddyBlock(nextLevelSize, currBlock->mOffset + nextLevelSize);
+                NewBlock(nextLevelSize, currBlock->mOffset + nextLevelSize);
 
             // Remember the parent to merge these back upon de-allocation.
             rightChildBlock->pParent = currBlock;
@@ -198,6 +216,7 @@ namespace dawn_native {
         // Remove curr block from free-list (now allocated).
         RemoveFreeBlock(currBlock, currBlockLevel);
         currBlock->mState = BlockState::Allocated;
+        mAllocatedSize += currBlock->mSize;
 
         return currBlock->mOffset;
     }
@@ -228,6 +247,8 @@ namespace dawn_native {
 
         // Mark curr free so we can merge.
         curr->mState = BlockState::Free;
+        ASSERT(mAllocatedSize >= curr->mSize);
+        mAllocatedSize -= curr->mSize;
 
         // Merge the buddies (LevelN-to-Level0).
         while (currBlockLevel > 0 && curr->pBuddy->mState == BlockState::Free) {
@@ -252,6 +273,10 @@ namespace dawn_native {
         InsertFreeBlock(curr, currBlockLevel);
     }
 
+    uint64_t BuddyAllocator::GetAllocatedSize() const {
+        return mAllocatedSize;
+    }
+
     // Helper which deletes a block in the tree recursively (post-order).
     void BuddyAllocator::DeleteBlock(BuddyBlock* block) {
         ASSERT(block != nullptr);
@@ -261,7 +286,7 @@ namespace dawn_native {
             DeleteBlock(block->split.pLeft->pBuddy);
             DeleteBlock(block->split.pLeft);
         }
-        delete block;
+        mBlockAllocator.Deallocate(block);
     }
 
 }  // namespace dawn_native
\ No newline at end of file
@@ -15,6 +15,8 @@
 #ifndef DAWNNATIVE_BUDDYALLOCATOR_H_
 #define DAWNNATIVE_BUDDYALLOCATOR_H_
 
+#include "common/SlabAllocator.h"
+
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -33,6 +35,10 @@ namespace dawn_native {
     // the size of the block to be used to satisfy the request. The first level (index=0) represents
     // the root whose size is also called the max block size.
     //
+    // A bitmap of the levels with free blocks finds the closest level with a free block with a
+    // bit scan instead of walking the empty levels, and the blocks of the tree are pooled in a
+    // slab allocator so that splitting and merging don't allocate memory once it is warm.
+    //
     class BuddyAllocator {
       public:
         BuddyAllocator(uint64_t maxSize);
@@ -42,6 +48,9 @@ namespace dawn_native {
         uint64_t Allocate(uint64_t allocationSize, uint64_t alignment = 1);
         void Deallocate(uint64_t offset);
 
+        // The sum of the sizes of the allocated blocks.
+        uint64_t GetAllocatedSize() const;
+
         // For testing purposes only.
         uint64_t ComputeTotalNumOfFreeBlocksForTesting() const;
 
@@ -93,6 +102,8 @@ namespace dawn_native {
 
         uint64_t ComputeNumOfFreeBlocks(BuddyBlock* block) const;
 
+        BuddyBlock* NewBlock(uint64_t size, uint64_t offset);
+
         // Keep track the head and tail (for faster insertion/removal).
         struct BlockList {
             BuddyBlock* head = nullptr;  // First free block in level.
@@ -102,10 +113,16 @@ namespace dawn_native {
         BuddyBlock* mRoot = nullptr;  // Used to deallocate non-free blocks.
 
         uint64_t mMaxBlockSize = 0;
+        uint64_t mAllocatedSize = 0;
 
         // List of linked-lists of free blocks where the index is a level that
         // corresponds to a power-of-two sized block.
         std::vector<BlockList> mFreeLists;
+
+        // Bit N is set iff mFreeLists[N] isn't empty. There are at most 64 levels.
+        uint64_t mFreeLevelsBitmap = 0;
+
+        SlabAllocator<BuddyBlock> mBlockAllocator;
     };
 
 }  // namespace dawn_native
@@ -45,6 +45,8 @@ namespace dawn_native {
             return invalidAllocation;
         }
 
+        const uint64_t requestedSize = allocationSize;
+
         // Round allocation size to nearest power-of-two.
         allocationSize = NextPowerOfTwo(allocationSize);
 
@@ -65,12 +67,14 @@ namespace dawn_native {
             std::unique_ptr<ResourceHeapBase> memory;
             DAWN_TRY_ASSIGN(memory, mHeapAllocator->AllocateResourceHeap(mMemoryBlockSize));
             mTrackedSubAllocations[memoryIndex] = {/*refcount*/ 0, std::move(memory)};
+            mHeapCount++;
         }
 
         mTrackedSubAllocations[memoryIndex].refcount++;
 
         AllocationInfo info;
         info.mBlockOffset = blockOffset;
+        info.mRequestedSize = requestedSize;
         info.mMethod = AllocationMethod::kSubAllocated;
 
         // Allocation offset is always local to the memory.
@@ -93,6 +97,7 @@ namespace dawn_native {
         if (mTrackedSubAllocations[memoryIndex].refcount == 0) {
             mHeapAllocator->DeallocateResourceHeap(
                 std::move(mTrackedSubAllocations[memoryIndex].mMemoryAllocation));
+            mHeapCount--;
         }
 
         mBuddyBlockAllocator.Deallocate(info.mBlockOffset);
@@ -102,6 +107,14 @@ namespace dawn_native {
         return mMemoryBlockSize;
     }
 
+    uint64_t BuddyMemoryAllocator::GetAllocatedHeapSize() const {
+        return mHeapCount * mMemoryBlockSize;
+    }
+
+    uint64_t BuddyMemoryAllocator::GetUsedSize() const {
+        return mBuddyBlockAllocator.GetAllocatedSize();
+    }
+
     uint64_t BuddyMemoryAllocator::ComputeTotalNumOfHeapsForTesting() const {
         uint64_t count = 0;
         for (const TrackedSubAllocations& allocation : mTrackedSubAllocations) {
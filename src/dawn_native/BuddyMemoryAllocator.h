@@ -50,6 +50,12 @@ namespace dawn_native {
 
         uint64_t GetMemoryBlockSize() const;
 
+        // The size of the heaps currently allocated, and how much of it is used by
+        // sub-allocations. The difference is lost to fragmentation until more sub-allocations
+        // fill it.
+        uint64_t GetAllocatedHeapSize() const;
+        uint64_t GetUsedSize() const;
+
         // For testing purposes.
         uint64_t ComputeTotalNumOfHeapsForTesting() const;
 
@@ -60,6 +66,7 @@ namespace dawn_native {
 
         BuddyAllocator mBuddyBlockAllocator;
         ResourceHeapAllocator* mHeapAllocator;
+        uint64_t mHeapCount = 0;
 
         struct TrackedSubAllocations {
             size_t refcount = 0;
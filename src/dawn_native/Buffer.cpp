@@ -15,6 +15,7 @@
 #include "dawn_native/Buffer.h"
 
 #include "common/Assert.h"
+#include "common/Constants.h"
 #include "dawn_native/Device.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorData.h"
@@ -85,7 +86,7 @@ namespace dawn_native {
 
     }  // anonymous namespace
 
-    MaybeError ValidateBufferDescriptor(DeviceBase*, const BufferDescriptor* descriptor) {
+    MaybeError ValidateBufferDescriptor(DeviceBase* device, const BufferDescriptor* descriptor) {
         if (descriptor->nextInChain != nullptr) {
             return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
         }
@@ -94,18 +95,50 @@ namespace dawn_native {
 
         wgpu::BufferUsage usage = descriptor->usage;
 
-        const wgpu::BufferUsage kMapWriteAllowedUsages =
-            wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc;
+        const wgpu::BufferUsage kMapWriteAllowedUsages = wgpu::BufferUsage::MapWrite |
+                                                         wgpu::BufferUsage::CopySrc |
+                                                         wgpu::BufferUsage::PersistentMap;
         if (usage & wgpu::BufferUsage::MapWrite && (usage & kMapWriteAllowedUsages) != usage) {
             return DAWN_VALIDATION_ERROR("Only CopySrc is allowed with MapWrite");
         }
 
-        const wgpu::BufferUsage kMapReadAllowedUsages =
-            wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+        const wgpu::BufferUsage kMapReadAllowedUsages = wgpu::BufferUsage::MapRead |
+                                                        wgpu::BufferUsage::CopyDst |
+                                                        wgpu::BufferUsage::PersistentMap;
         if (usage & wgpu::BufferUsage::MapRead && (usage & kMapReadAllowedUsages) != usage) {
             return DAWN_VALIDATION_ERROR("Only CopyDst is allowed with MapRead");
         }
 
+        if (usage & wgpu::BufferUsage::PersistentMap &&
+            (usage & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) == 0) {
+            return DAWN_VALIDATION_ERROR("PersistentMap requires MapRead or MapWrite");
+        }
+
+        if (usage & wgpu::BufferUsage::Sparse) {
+            if (!device->IsExtensionEnabled(Extension::SparseResources)) {
+                return DAWN_VALIDATION_ERROR("The sparse_resources extension is not enabled");
+            }
+
+            constexpr wgpu::BufferUsage kNonSparseUsages =
+                wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite |
+                wgpu::BufferUsage::PersistentMap | wgpu::BufferUsage::Transient;
+            if (usage & kNonSparseUsages) {
+                return DAWN_VALIDATION_ERROR("Sparse buffers can't be mappable or transient");
+            }
+
+            if (descriptor->size % kSparseTileSize != 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "The size of sparse buffers must be a multiple of the tile size");
+            }
+        }
+
+        if (usage & wgpu::BufferUsage::Predicate &&
+            !device->IsExtensionEnabled(Extension::ConditionalRendering)) {
+            return DAWN_VALIDATION_ERROR("The conditional_rendering extension is not enabled");
+        }
+
+        DAWN_TRY(ValidateResidencyPriority(descriptor->residencyPriority));
+
         return {};
     }
 
@@ -115,6 +148,7 @@ namespace dawn_native {
         : ObjectBase(device),
           mSize(descriptor->size),
           mUsage(descriptor->usage),
+          mResidencyPriority(descriptor->residencyPriority),
           mState(BufferState::Unmapped) {
         // Add readonly storage usage if the buffer has a storage usage. The validation rules in
         // ValidatePassResourceUsage will make sure we don't use both at the same
@@ -122,6 +156,14 @@ namespace dawn_native {
         if (mUsage & wgpu::BufferUsage::Storage) {
             mUsage |= kReadOnlyStorage;
         }
+        // Indirect buffers are read as storage buffers by the pass that validates their content.
+        if ((mUsage & wgpu::BufferUsage::Indirect) &&
+            device->IsToggleEnabled(Toggle::ValidateIndirectArgumentsOnGPU)) {
+            mUsage |= kReadOnlyStorage;
+        }
+
+        // The tiles of sparse buffers are accounted for by the memory they are bound to.
+        mTrackedMemory.Track(device, TrackedObjectType::Buffer, IsSparse() ? 0 : mSize);
     }
 
     BufferBase::BufferBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -158,10 +200,30 @@ namespace dawn_native {
         return mUsage;
     }
 
+    bool BufferBase::IsTransient() const {
+        ASSERT(!IsError());
+        return mUsage & wgpu::BufferUsage::Transient;
+    }
+
+    bool BufferBase::IsSparse() const {
+        ASSERT(!IsError());
+        return mUsage & wgpu::BufferUsage::Sparse;
+    }
+
+    wgpu::ResidencyPriority BufferBase::GetResidencyPriority() const {
+        ASSERT(!IsError());
+        return mResidencyPriority;
+    }
+
     MaybeError BufferBase::MapAtCreation(uint8_t** mappedPointer) {
         ASSERT(!IsError());
         ASSERT(mappedPointer != nullptr);
 
+        // The data would be lost since none of the tiles are resident yet.
+        if (IsSparse()) {
+            return DAWN_VALIDATION_ERROR("Sparse buffers can't be mapped at creation");
+        }
+
         mState = BufferState::Mapped;
 
         if (IsMapWritable()) {
@@ -189,6 +251,12 @@ namespace dawn_native {
             case BufferState::Destroyed:
                 return DAWN_VALIDATION_ERROR("Destroyed buffer used in a submit");
             case BufferState::Mapped:
+                // Persistently mapped buffers can be used by the GPU while mapped, the
+                // application synchronizes its accesses to the mapping with fences. This isn't
+                // possible while the content is still in the staging buffer of CreateBufferMapped.
+                if ((mUsage & wgpu::BufferUsage::PersistentMap) && mStagingBuffer == nullptr) {
+                    return {};
+                }
                 return DAWN_VALIDATION_ERROR("Buffer used in a submit while mapped");
             case BufferState::Unmapped:
                 return {};
@@ -209,9 +277,15 @@ namespace dawn_native {
             // for example buffer.Unmap() is called inside the application-provided callback.
             WGPUBufferMapReadCallback callback = mMapReadCallback;
             mMapReadCallback = nullptr;
+            GetDevice()->DidFinishMapAsync();
 
             if (GetDevice()->IsLost()) {
                 callback(WGPUBufferMapAsyncStatus_DeviceLost, nullptr, 0, mMapUserdata);
+            } else if (status == WGPUBufferMapAsyncStatus_Success) {
+                // Backends map the whole buffer, only the requested range is given out.
+                ASSERT(mMapOffset + mMapSize <= dataLength);
+                callback(status, static_cast<const uint8_t*>(pointer) + mMapOffset, mMapSize,
+                         mMapUserdata);
             } else {
                 callback(status, pointer, dataLength, mMapUserdata);
             }
@@ -230,9 +304,15 @@ namespace dawn_native {
             // for example buffer.Unmap() is called inside the application-provided callback.
             WGPUBufferMapWriteCallback callback = mMapWriteCallback;
             mMapWriteCallback = nullptr;
+            GetDevice()->DidFinishMapAsync();
 
             if (GetDevice()->IsLost()) {
                 callback(WGPUBufferMapAsyncStatus_DeviceLost, nullptr, 0, mMapUserdata);
+            } else if (status == WGPUBufferMapAsyncStatus_Success) {
+                // Backends map the whole buffer, only the requested range is given out.
+                ASSERT(mMapOffset + mMapSize <= dataLength);
+                callback(status, static_cast<uint8_t*>(pointer) + mMapOffset, mMapSize,
+                         mMapUserdata);
             } else {
                 callback(status, pointer, dataLength, mMapUserdata);
             }
@@ -251,8 +331,16 @@ namespace dawn_native {
     }
 
     void BufferBase::MapReadAsync(WGPUBufferMapReadCallback callback, void* userdata) {
+        MapReadRangeAsync(0, mSize, callback, userdata);
+    }
+
+    void BufferBase::MapReadRangeAsync(uint64_t offset,
+                                       uint64_t size,
+                                       WGPUBufferMapReadCallback callback,
+                                       void* userdata) {
         WGPUBufferMapAsyncStatus status;
-        if (GetDevice()->ConsumedError(ValidateMap(wgpu::BufferUsage::MapRead, &status))) {
+        if (GetDevice()->ConsumedError(
+                ValidateMap(wgpu::BufferUsage::MapRead, offset, size, &status))) {
             callback(status, nullptr, 0, userdata);
             return;
         }
@@ -263,14 +351,21 @@ namespace dawn_native {
         // TODO(cwallez@chromium.org): what to do on wraparound? Could cause crashes.
         mMapSerial++;
         mMapReadCallback = callback;
+        mMapOffset = offset;
+        mMapSize = size;
         mMapUserdata = userdata;
         mState = BufferState::Mapped;
+        GetDevice()->DidStartMapAsync();
 
         if (GetDevice()->ConsumedError(MapReadAsyncImpl(mMapSerial))) {
             return;
         }
     }
 
+    MaybeError BufferBase::SetSubDataInternal(uint32_t start, uint32_t count, const void* data) {
+        return SetSubDataImpl(start, count, data);
+    }
+
     MaybeError BufferBase::SetSubDataImpl(uint32_t start, uint32_t count, const void* data) {
         DynamicUploader* uploader = GetDevice()->GetDynamicUploader();
 
@@ -288,8 +383,16 @@ namespace dawn_native {
     }
 
     void BufferBase::MapWriteAsync(WGPUBufferMapWriteCallback callback, void* userdata) {
+        MapWriteRangeAsync(0, mSize, callback, userdata);
+    }
+
+    void BufferBase::MapWriteRangeAsync(uint64_t offset,
+                                        uint64_t size,
+                                        WGPUBufferMapWriteCallback callback,
+                                        void* userdata) {
         WGPUBufferMapAsyncStatus status;
-        if (GetDevice()->ConsumedError(ValidateMap(wgpu::BufferUsage::MapWrite, &status))) {
+        if (GetDevice()->ConsumedError(
+                ValidateMap(wgpu::BufferUsage::MapWrite, offset, size, &status))) {
             callback(status, nullptr, 0, userdata);
             return;
         }
@@ -300,8 +403,11 @@ namespace dawn_native {
         // TODO(cwallez@chromium.org): what to do on wraparound? Could cause crashes.
         mMapSerial++;
         mMapWriteCallback = callback;
+        mMapOffset = offset;
+        mMapSize = size;
         mMapUserdata = userdata;
         mState = BufferState::Mapped;
+        GetDevice()->DidStartMapAsync();
 
         if (GetDevice()->ConsumedError(MapWriteAsyncImpl(mMapSerial))) {
             return;
@@ -328,6 +434,23 @@ namespace dawn_native {
         DestroyInternal();
     }
 
+    void BufferBase::SetResidencyPriority(wgpu::ResidencyPriority priority) {
+        if (GetDevice()->ConsumedError(ValidateSetResidencyPriority(priority))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        bool changed = priority != mResidencyPriority;
+        mResidencyPriority = priority;
+        if (changed && mState != BufferState::Destroyed) {
+            GetDevice()->ConsumedError(SetResidencyPriorityImpl());
+        }
+    }
+
+    MaybeError BufferBase::SetResidencyPriorityImpl() {
+        return {};
+    }
+
     MaybeError BufferBase::CopyFromStagingBuffer() {
         ASSERT(mStagingBuffer);
         DAWN_TRY(GetDevice()->CopyFromStagingToBuffer(mStagingBuffer.get(), 0, this, 0, GetSize()));
@@ -364,6 +487,8 @@ namespace dawn_native {
         mMapReadCallback = nullptr;
         mMapWriteCallback = nullptr;
         mMapUserdata = 0;
+        mMapOffset = 0;
+        mMapSize = 0;
     }
 
     MaybeError BufferBase::ValidateSetSubData(uint32_t start, uint32_t count) const {
@@ -406,6 +531,8 @@ namespace dawn_native {
     }
 
     MaybeError BufferBase::ValidateMap(wgpu::BufferUsage requiredUsage,
+                                       uint64_t offset,
+                                       uint64_t size,
                                        WGPUBufferMapAsyncStatus* status) const {
         *status = WGPUBufferMapAsyncStatus_DeviceLost;
         DAWN_TRY(GetDevice()->ValidateIsAlive());
@@ -426,6 +553,11 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR("Buffer needs the correct map usage bit");
         }
 
+        // Note that no overflow can happen because we first check for GetSize() >= size
+        if (size > GetSize() || offset > GetSize() - size) {
+            return DAWN_VALIDATION_ERROR("Buffer map range out of bounds");
+        }
+
         *status = WGPUBufferMapAsyncStatus_Success;
         return {};
     }
@@ -451,12 +583,20 @@ namespace dawn_native {
         }
     }
 
+    MaybeError BufferBase::ValidateSetResidencyPriority(wgpu::ResidencyPriority priority) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(ValidateResidencyPriority(priority));
+        return {};
+    }
+
     MaybeError BufferBase::ValidateDestroy() const {
         DAWN_TRY(GetDevice()->ValidateObject(this));
         return {};
     }
 
     void BufferBase::DestroyInternal() {
+        mTrackedMemory.Untrack();
         if (mState != BufferState::Destroyed) {
             DestroyImpl();
         }
@@ -17,6 +17,7 @@
 
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
+#include "dawn_native/MemoryUsageTracker.h"
 #include "dawn_native/ObjectBase.h"
 
 #include "dawn_native/dawn_platform.h"
@@ -33,10 +34,12 @@ namespace dawn_native {
 
     static constexpr wgpu::BufferUsage kReadOnlyBufferUsages =
         wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Index |
-        wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Uniform | kReadOnlyStorage;
+        wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Uniform | kReadOnlyStorage |
+        wgpu::BufferUsage::Predicate;
 
     static constexpr wgpu::BufferUsage kWritableBufferUsages =
-        wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage;
+        wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage |
+        wgpu::BufferUsage::QueryResolve;
 
     class BufferBase : public ObjectBase {
         enum class BufferState {
@@ -56,16 +59,37 @@ namespace dawn_native {
 
         uint64_t GetSize() const;
         wgpu::BufferUsage GetUsage() const;
+        // Transient buffers are destroyed once the command buffer using them is submitted so
+        // that backends can reuse their memory for other transient resources right away.
+        bool IsTransient() const;
+        // The memory of sparse buffers is bound in tiles with Queue::UpdateBufferTileMappings.
+        // Accesses to the tiles that aren't resident are discarded or read undefined values.
+        bool IsSparse() const;
+        // How much the backends should keep the memory of the buffer resident when the device
+        // memory is oversubscribed.
+        wgpu::ResidencyPriority GetResidencyPriority() const;
 
         MaybeError MapAtCreation(uint8_t** mappedPointer);
 
         MaybeError ValidateCanUseInSubmitNow() const;
 
+        // Writes data which was already validated, used by Queue::WriteBuffer.
+        MaybeError SetSubDataInternal(uint32_t start, uint32_t count, const void* data);
+
         // Dawn API
         void SetSubData(uint32_t start, uint32_t count, const void* data);
         void MapReadAsync(WGPUBufferMapReadCallback callback, void* userdata);
         void MapWriteAsync(WGPUBufferMapWriteCallback callback, void* userdata);
+        void MapReadRangeAsync(uint64_t offset,
+                               uint64_t size,
+                               WGPUBufferMapReadCallback callback,
+                               void* userdata);
+        void MapWriteRangeAsync(uint64_t offset,
+                                uint64_t size,
+                                WGPUBufferMapWriteCallback callback,
+                                void* userdata);
         void Unmap();
+        void SetResidencyPriority(wgpu::ResidencyPriority priority);
         void Destroy();
 
       protected:
@@ -89,23 +113,34 @@ namespace dawn_native {
         virtual MaybeError MapWriteAsyncImpl(uint32_t serial) = 0;
         virtual void UnmapImpl() = 0;
         virtual void DestroyImpl() = 0;
+        // Applies GetResidencyPriority() to the memory of the buffer, which isn't destroyed. The
+        // default implementation only uses the priority at creation.
+        virtual MaybeError SetResidencyPriorityImpl();
 
         virtual bool IsMapWritable() const = 0;
         MaybeError CopyFromStagingBuffer();
 
         MaybeError ValidateSetSubData(uint32_t start, uint32_t count) const;
         MaybeError ValidateMap(wgpu::BufferUsage requiredUsage,
+                               uint64_t offset,
+                               uint64_t size,
                                WGPUBufferMapAsyncStatus* status) const;
         MaybeError ValidateUnmap() const;
+        MaybeError ValidateSetResidencyPriority(wgpu::ResidencyPriority priority) const;
         MaybeError ValidateDestroy() const;
 
         uint64_t mSize = 0;
         wgpu::BufferUsage mUsage = wgpu::BufferUsage::None;
+        wgpu::ResidencyPriority mResidencyPriority = wgpu::ResidencyPriority::Normal;
+        TrackedMemory mTrackedMemory;
 
         WGPUBufferMapReadCallback mMapReadCallback = nullptr;
         WGPUBufferMapWriteCallback mMapWriteCallback = nullptr;
         void* mMapUserdata = 0;
         uint32_t mMapSerial = 0;
+        // The range given to the map callbacks, backends always map the whole buffer.
+        uint64_t mMapOffset = 0;
+        uint64_t mMapSize = 0;
 
         std::unique_ptr<StagingBufferBase> mStagingBuffer;
 
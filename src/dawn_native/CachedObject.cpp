@@ -14,6 +14,8 @@
 
 #include "dawn_native/CachedObject.h"
 
+#include "common/Assert.h"
+
 namespace dawn_native {
 
     bool CachedObject::IsCachedReference() const {
@@ -24,4 +26,17 @@ namespace dawn_native {
         mIsCachedReference = true;
     }
 
+    void CachedObject::ClearIsCachedReference() {
+        mIsCachedReference = false;
+    }
+
+    size_t CachedObject::GetContentHash() const {
+        ASSERT(mIsCachedReference);
+        return mContentHash;
+    }
+
+    void CachedObject::SetContentHash(size_t contentHash) {
+        mContentHash = contentHash;
+    }
+
 }  // namespace dawn_native
@@ -29,11 +29,17 @@ namespace dawn_native {
 
         bool IsCachedReference() const;
 
+        // The hash of the content the object was cached with, only valid for cached references.
+        size_t GetContentHash() const;
+
       private:
         friend class DeviceBase;
         void SetIsCachedReference();
+        void ClearIsCachedReference();
+        void SetContentHash(size_t contentHash);
 
         bool mIsCachedReference = false;
+        size_t mContentHash = 0;
     };
 
 }  // namespace dawn_native
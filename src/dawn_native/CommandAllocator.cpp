@@ -23,6 +23,70 @@
 
 namespace dawn_native {
 
+    // CommandBlockPool
+
+    constexpr size_t CommandBlockPool::kMinBlockSize;
+    constexpr size_t CommandBlockPool::kMaxBlockSize;
+
+    CommandBlockPool::CommandBlockPool() = default;
+
+    CommandBlockPool::~CommandBlockPool() {
+        for (std::vector<uint8_t*>& freeBlocks : mFreeBlocks) {
+            for (uint8_t* block : freeBlocks) {
+                free(block);
+            }
+        }
+    }
+
+    // static
+    size_t CommandBlockPool::GetSizeClass(size_t size) {
+        ASSERT(size <= kMaxBlockSize);
+        return Log2(NextPowerOfTwo(std::max(size, kMinBlockSize))) -
+               Log2(static_cast<uint64_t>(kMinBlockSize));
+    }
+
+    BlockDef CommandBlockPool::AcquireBlock(size_t minimumSize) {
+        if (minimumSize > kMaxBlockSize) {
+            return {minimumSize, static_cast<uint8_t*>(malloc(minimumSize))};
+        }
+
+        // A bigger block than requested works as well, so look in the bigger size classes before
+        // allocating a new block.
+        size_t sizeClass = GetSizeClass(minimumSize);
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = sizeClass; i < kSizeClassCount; ++i) {
+            if (!mFreeBlocks[i].empty()) {
+                uint8_t* block = mFreeBlocks[i].back();
+                mFreeBlocks[i].pop_back();
+                return {kMinBlockSize << i, block};
+            }
+        }
+
+        size_t size = kMinBlockSize << sizeClass;
+        return {size, static_cast<uint8_t*>(malloc(size))};
+    }
+
+    void CommandBlockPool::ReleaseBlocks(CommandBlocks&& blocks) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const BlockDef& block : blocks) {
+            if (block.size > kMaxBlockSize) {
+                free(block.block);
+                continue;
+            }
+
+            ASSERT(IsPowerOfTwo(block.size) && block.size >= kMinBlockSize);
+            std::vector<uint8_t*>& freeBlocks = mFreeBlocks[GetSizeClass(block.size)];
+            if (freeBlocks.size() < kMaxFreeBlocksPerSizeClass) {
+                freeBlocks.push_back(block.block);
+            } else {
+                free(block.block);
+            }
+        }
+        blocks.clear();
+    }
+
+    // CommandIterator
+
     // TODO(cwallez@chromium.org): figure out a way to have more type safety for the iterator
 
     CommandIterator::CommandIterator() {
@@ -33,13 +97,17 @@ namespace dawn_native {
         ASSERT(mDataWasDestroyed);
 
         if (!IsEmpty()) {
-            for (auto& block : mBlocks) {
-                free(block.block);
+            if (mBlockPool != nullptr) {
+                mBlockPool->ReleaseBlocks(std::move(mBlocks));
+            } else {
+                for (auto& block : mBlocks) {
+                    free(block.block);
+                }
             }
         }
     }
 
-    CommandIterator::CommandIterator(CommandIterator&& other) {
+    CommandIterator::CommandIterator(CommandIterator&& other) : mBlockPool(other.mBlockPool) {
         if (!other.IsEmpty()) {
             mBlocks = std::move(other.mBlocks);
             other.Reset();
@@ -55,22 +123,34 @@ namespace dawn_native {
         } else {
             mBlocks.clear();
         }
+        mBlockPool = other.mBlockPool;
         other.DataWasDestroyed();
         Reset();
         return *this;
     }
 
     CommandIterator::CommandIterator(CommandAllocator&& allocator)
-        : mBlocks(allocator.AcquireBlocks()) {
+        : mBlocks(allocator.AcquireBlocks()), mBlockPool(allocator.mBlockPool) {
         Reset();
     }
 
     CommandIterator& CommandIterator::operator=(CommandAllocator&& allocator) {
         mBlocks = allocator.AcquireBlocks();
+        mBlockPool = allocator.mBlockPool;
         Reset();
         return *this;
     }
 
+    CommandIterator::CommandIterator(std::vector<CommandBlocks>&& segments,
+                                     CommandBlockPool* blockPool)
+        : mBlockPool(blockPool) {
+        for (CommandBlocks& segment : segments) {
+            mBlocks.insert(mBlocks.end(), segment.begin(), segment.end());
+        }
+        segments.clear();
+        Reset();
+    }
+
     bool CommandIterator::NextCommandIdInNewBlock(uint32_t* commandId) {
         mCurrentBlock++;
         if (mCurrentBlock >= mBlocks.size()) {
@@ -97,6 +177,17 @@ namespace dawn_native {
         }
     }
 
+    size_t CommandIterator::GetAllocatedSize() const {
+        if (IsEmpty()) {
+            return 0;
+        }
+        size_t size = 0;
+        for (const BlockDef& block : mBlocks) {
+            size += block.size;
+        }
+        return size;
+    }
+
     void CommandIterator::DataWasDestroyed() {
         mDataWasDestroyed = true;
     }
@@ -115,8 +206,11 @@ namespace dawn_native {
     //  - Better block allocation, maybe have Dawn API to say command buffer is going to have size
     //    close to another
 
-    CommandAllocator::CommandAllocator()
-        : mCurrentPtr(reinterpret_cast<uint8_t*>(&mDummyEnum[0])),
+    // CommandAllocator
+
+    CommandAllocator::CommandAllocator(CommandBlockPool* blockPool)
+        : mBlockPool(blockPool),
+          mCurrentPtr(reinterpret_cast<uint8_t*>(&mDummyEnum[0])),
           mEndPtr(reinterpret_cast<uint8_t*>(&mDummyEnum[1])) {
     }
 
@@ -135,6 +229,14 @@ namespace dawn_native {
         return std::move(mBlocks);
     }
 
+    CommandBlocks CommandAllocator::AcquireRecordedBlocks() {
+        CommandBlocks blocks = AcquireBlocks();
+        mBlocks.clear();
+        mCurrentPtr = reinterpret_cast<uint8_t*>(&mDummyEnum[0]);
+        mEndPtr = reinterpret_cast<uint8_t*>(&mDummyEnum[1]);
+        return blocks;
+    }
+
     uint8_t* CommandAllocator::AllocateInNewBlock(uint32_t commandId,
                                                   size_t commandSize,
                                                   size_t commandAlignment) {
@@ -160,17 +262,22 @@ namespace dawn_native {
 
     bool CommandAllocator::GetNewBlock(size_t minimumSize) {
         // Allocate blocks doubling sizes each time, to a maximum of 16k (or at least minimumSize).
-        mLastAllocationSize =
-            std::max(minimumSize, std::min(mLastAllocationSize * 2, size_t(16384)));
+        mLastAllocationSize = std::max(
+            minimumSize, std::min(mLastAllocationSize * 2, CommandBlockPool::kMaxBlockSize));
 
-        uint8_t* block = static_cast<uint8_t*>(malloc(mLastAllocationSize));
-        if (DAWN_UNLIKELY(block == nullptr)) {
+        BlockDef block;
+        if (mBlockPool != nullptr) {
+            block = mBlockPool->AcquireBlock(mLastAllocationSize);
+        } else {
+            block = {mLastAllocationSize, static_cast<uint8_t*>(malloc(mLastAllocationSize))};
+        }
+        if (DAWN_UNLIKELY(block.block == nullptr)) {
             return false;
         }
 
-        mBlocks.push_back({mLastAllocationSize, block});
-        mCurrentPtr = AlignPtr(block, alignof(uint32_t));
-        mEndPtr = block + mLastAllocationSize;
+        mBlocks.push_back(block);
+        mCurrentPtr = AlignPtr(block.block, alignof(uint32_t));
+        mEndPtr = block.block + block.size;
         return true;
     }
 
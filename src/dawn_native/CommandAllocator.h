@@ -18,8 +18,10 @@
 #include "common/Assert.h"
 #include "common/Math.h"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 namespace dawn_native {
@@ -66,6 +68,35 @@ namespace dawn_native {
 
     class CommandAllocator;
 
+    // Keeps the blocks of the CommandIterators that get destroyed so that new CommandAllocators
+    // can reuse them instead of going through malloc and free for every command encoder. Blocks
+    // are sorted in power of two size classes and only a bounded amount is kept per class, blocks
+    // bigger than the largest class are always freed. The pool is thread-safe since encoders of a
+    // device can record commands on different threads.
+    class CommandBlockPool {
+      public:
+        CommandBlockPool();
+        ~CommandBlockPool();
+
+        // Returns a block of at least minimumSize bytes, its block is nullptr if the allocation
+        // failed.
+        BlockDef AcquireBlock(size_t minimumSize);
+        void ReleaseBlocks(CommandBlocks&& blocks);
+
+        static constexpr size_t kMinBlockSize = 512;
+        static constexpr size_t kMaxBlockSize = 16384;
+
+      private:
+        static constexpr size_t kSizeClassCount = 6;
+        static constexpr size_t kMaxFreeBlocksPerSizeClass = 32;
+        static_assert(kMinBlockSize << (kSizeClassCount - 1) == kMaxBlockSize, "");
+
+        static size_t GetSizeClass(size_t size);
+
+        std::mutex mMutex;
+        std::array<std::vector<uint8_t*>, kSizeClassCount> mFreeBlocks;
+    };
+
     // TODO(cwallez@chromium.org): prevent copy for both iterator and allocator
     class CommandIterator {
       public:
@@ -77,6 +108,9 @@ namespace dawn_native {
 
         CommandIterator(CommandAllocator&& allocator);
         CommandIterator& operator=(CommandAllocator&& allocator);
+        // Iterates over the commands of each segment one after the other, the segments come from
+        // CommandAllocator::AcquireRecordedBlocks.
+        CommandIterator(std::vector<CommandBlocks>&& segments, CommandBlockPool* blockPool);
 
         template <typename E>
         bool NextCommandId(E* commandId) {
@@ -94,6 +128,9 @@ namespace dawn_native {
         // Needs to be called if iteration was stopped early.
         void Reset();
 
+        // The size of the blocks holding the commands.
+        size_t GetAllocatedSize() const;
+
         void DataWasDestroyed();
 
       private:
@@ -135,6 +172,7 @@ namespace dawn_native {
         }
 
         CommandBlocks mBlocks;
+        CommandBlockPool* mBlockPool = nullptr;
         uint8_t* mCurrentPtr = nullptr;
         size_t mCurrentBlock = 0;
         // Used to avoid a special case for empty iterators.
@@ -144,7 +182,9 @@ namespace dawn_native {
 
     class CommandAllocator {
       public:
-        CommandAllocator();
+        // Blocks are taken from the pool when there is one, and go back to it when the
+        // CommandIterator the commands were moved to is destroyed.
+        CommandAllocator(CommandBlockPool* blockPool = nullptr);
         ~CommandAllocator();
 
         template <typename T, typename E>
@@ -174,6 +214,10 @@ namespace dawn_native {
             return result;
         }
 
+        // Ends the commands allocated so far and returns their blocks, so that commands can be
+        // inserted before the next ones. The allocator keeps allocating in new blocks after that.
+        CommandBlocks AcquireRecordedBlocks();
+
       private:
         // This is used for some internal computations and can be any power of two as long as code
         // using the CommandAllocator passes the static_asserts.
@@ -236,7 +280,9 @@ namespace dawn_native {
         bool GetNewBlock(size_t minimumSize);
 
         CommandBlocks mBlocks;
-        size_t mLastAllocationSize = 2048;
+        CommandBlockPool* mBlockPool;
+        // Starts small so that encoders with few commands only use a small block.
+        size_t mLastAllocationSize = CommandBlockPool::kMinBlockSize / 2;
 
         // Pointers to the current range of allocation in the block. Guaranteed to allow for at
         // least one uint32_t if not nullptr, so that the special kEndOfBlock command id can always
@@ -17,13 +17,21 @@
 #include "common/BitSetIterator.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
+#include "dawn_native/Device.h"
 #include "dawn_native/Format.h"
 #include "dawn_native/Texture.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <string>
 
 namespace dawn_native {
 
     CommandBufferBase::CommandBufferBase(CommandEncoder* encoder, const CommandBufferDescriptor*)
-        : ObjectBase(encoder->GetDevice()), mResourceUsages(encoder->AcquireResourceUsages()) {
+        : ObjectBase(encoder->GetDevice()),
+          mResourceUsages(encoder->AcquireResourceUsages()),
+          mStatistics(encoder->AcquireStatistics()),
+          mRetainedObjects(encoder->AcquireRetainedObjects()) {
     }
 
     CommandBufferBase::CommandBufferBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -39,6 +47,56 @@ namespace dawn_native {
         return mResourceUsages;
     }
 
+    const CommandBufferStatistics& CommandBufferBase::GetStatistics() const {
+        return mStatistics;
+    }
+
+    void CommandBufferBase::AddLoweringTime(double time) {
+        mStatistics.loweringTime += time;
+    }
+
+    void CommandBufferBase::TraceStatistics() const {
+        if (!mStatistics.gathered) {
+            return;
+        }
+
+        // Formatted as "Draw:12 SetBindGroup:3", without the commands that weren't recorded.
+        std::string commandCounts;
+        for (size_t i = 0; i < mStatistics.commandCounts.size(); ++i) {
+            if (mStatistics.commandCounts[i] == 0) {
+                continue;
+            }
+            if (!commandCounts.empty()) {
+                commandCounts += ' ';
+            }
+            commandCounts += GetCommandName(static_cast<Command>(i));
+            commandCounts += ':';
+            commandCounts += std::to_string(mStatistics.commandCounts[i]);
+        }
+
+        dawn_platform::Platform* platform = GetDevice()->GetPlatform();
+        TRACE_EVENT_INSTANT2(platform, General, "CommandBuffer::Statistics", "commandCounts",
+                             commandCounts, "commandBytes", mStatistics.commandBytes);
+        TRACE_EVENT_INSTANT2(platform, General, "CommandBuffer::CPUTime", "validationTime",
+                             mStatistics.validationTime, "loweringTime", mStatistics.loweringTime);
+    }
+
+    ScopedLoweringTimer::ScopedLoweringTimer(CommandBufferBase* commandBuffer)
+        : mCommandBuffer(commandBuffer) {
+        if (mCommandBuffer->GetStatistics().gathered) {
+            mBeginTime =
+                mCommandBuffer->GetDevice()->GetPlatform()->MonotonicallyIncreasingTime();
+        }
+    }
+
+    ScopedLoweringTimer::~ScopedLoweringTimer() {
+        if (mCommandBuffer->GetStatistics().gathered) {
+            mCommandBuffer->AddLoweringTime(
+                mCommandBuffer->GetDevice()->GetPlatform()->MonotonicallyIncreasingTime() -
+                mBeginTime);
+        }
+    }
+
     bool IsCompleteSubresourceCopiedTo(const TextureBase* texture,
                                        const Extent3D copySize,
                                        const uint32_t mipLevel) {
@@ -17,26 +17,66 @@
 
 #include "dawn_native/dawn_platform.h"
 
+#include "common/MagazineAllocator.h"
+#include "dawn_native/EncodingContext.h"
 #include "dawn_native/Forward.h"
 #include "dawn_native/ObjectBase.h"
 #include "dawn_native/PassResourceUsage.h"
 
+#include <vector>
+
 namespace dawn_native {
 
     struct BeginRenderPassCmd;
 
-    class CommandBufferBase : public ObjectBase {
+    // The CPU cost of a command buffer, traced when it is submitted so that it can be attributed
+    // to the code that recorded it. Only gathered when the General trace category is enabled.
+    struct CommandBufferStatistics {
+        bool gathered = false;
+        // Indexed by Command.
+        std::vector<uint32_t> commandCounts;
+        uint64_t commandBytes = 0;
+        // In seconds. The validation done at Finish, the commands themselves are validated as
+        // they are recorded.
+        double validationTime = 0;
+        // In seconds. Creating the backend command buffer and recording its backend commands.
+        double loweringTime = 0;
+    };
+
+    class CommandBufferBase : public ObjectBase, public MagazineAllocated {
       public:
         CommandBufferBase(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor);
         static CommandBufferBase* MakeError(DeviceBase* device);
 
         const CommandBufferResourceUsage& GetResourceUsages() const;
 
+        const CommandBufferStatistics& GetStatistics() const;
+        void AddLoweringTime(double time);
+        // Emits the statistics as trace events, called when the command buffer is submitted.
+        void TraceStatistics() const;
+
       private:
         CommandBufferBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         CommandBufferResourceUsage mResourceUsages;
+        CommandBufferStatistics mStatistics;
+        // Outlives the commands of the backend command buffers, which are freed in their
+        // destructors.
+        RetainedObjects mRetainedObjects;
+    };
+
+    // Adds the time spent in its scope to the lowering time of the command buffer, when its
+    // statistics are gathered.
+    class ScopedLoweringTimer {
+      public:
+        ScopedLoweringTimer(CommandBufferBase* commandBuffer);
+        ~ScopedLoweringTimer();
+
+      private:
+        CommandBufferBase* mCommandBuffer;
+        double mBeginTime = 0;
     };
+
     bool IsCompleteSubresourceCopiedTo(const TextureBase* texture,
                                        const Extent3D copySize,
                                        const uint32_t mipLevel);
@@ -18,11 +18,14 @@
 #include "common/BitSetIterator.h"
 #include "dawn_native/BindGroup.h"
 #include "dawn_native/ComputePipeline.h"
+#include "dawn_native/Device.h"
 #include "dawn_native/Forward.h"
 #include "dawn_native/PipelineLayout.h"
 #include "dawn_native/RayTracingPipeline.h"
 #include "dawn_native/RenderPipeline.h"
 
+#include <algorithm>
+
 namespace dawn_native {
 
     enum ValidationAspect {
@@ -30,27 +33,44 @@ namespace dawn_native {
         VALIDATION_ASPECT_BIND_GROUPS,
         VALIDATION_ASPECT_VERTEX_BUFFERS,
         VALIDATION_ASPECT_INDEX_BUFFER,
+        VALIDATION_ASPECT_PUSH_CONSTANTS,
 
         VALIDATION_ASPECT_COUNT
     };
     static_assert(VALIDATION_ASPECT_COUNT == CommandBufferStateTracker::kNumAspects, "");
 
     static constexpr CommandBufferStateTracker::ValidationAspects kDispatchAspects =
-        1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS;
+        1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS |
+        1 << VALIDATION_ASPECT_PUSH_CONSTANTS;
 
     static constexpr CommandBufferStateTracker::ValidationAspects kTraceRaysAspects =
-        1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS;
+        1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS |
+        1 << VALIDATION_ASPECT_PUSH_CONSTANTS;
 
     static constexpr CommandBufferStateTracker::ValidationAspects kDrawAspects =
         1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS |
-        1 << VALIDATION_ASPECT_VERTEX_BUFFERS;
+        1 << VALIDATION_ASPECT_VERTEX_BUFFERS | 1 << VALIDATION_ASPECT_PUSH_CONSTANTS;
 
     static constexpr CommandBufferStateTracker::ValidationAspects kDrawIndexedAspects =
         1 << VALIDATION_ASPECT_PIPELINE | 1 << VALIDATION_ASPECT_BIND_GROUPS |
-        1 << VALIDATION_ASPECT_VERTEX_BUFFERS | 1 << VALIDATION_ASPECT_INDEX_BUFFER;
+        1 << VALIDATION_ASPECT_VERTEX_BUFFERS | 1 << VALIDATION_ASPECT_INDEX_BUFFER |
+        1 << VALIDATION_ASPECT_PUSH_CONSTANTS;
 
     static constexpr CommandBufferStateTracker::ValidationAspects kLazyAspects =
-        1 << VALIDATION_ASPECT_BIND_GROUPS | 1 << VALIDATION_ASPECT_VERTEX_BUFFERS;
+        1 << VALIDATION_ASPECT_BIND_GROUPS | 1 << VALIDATION_ASPECT_VERTEX_BUFFERS |
+        1 << VALIDATION_ASPECT_PUSH_CONSTANTS;
+
+    CommandBufferStateTracker::CommandBufferStateTracker(const DeviceBase* device) {
+        if (!device->IsDrawStateValidationEnabled()) {
+            mSkippedAspects.set(VALIDATION_ASPECT_PIPELINE);
+            mSkippedAspects.set(VALIDATION_ASPECT_VERTEX_BUFFERS);
+            mSkippedAspects.set(VALIDATION_ASPECT_INDEX_BUFFER);
+        }
+        if (!device->IsBindGroupCompatibilityValidationEnabled()) {
+            mSkippedAspects.set(VALIDATION_ASPECT_BIND_GROUPS);
+            mSkippedAspects.set(VALIDATION_ASPECT_PUSH_CONSTANTS);
+        }
+    }
 
     MaybeError CommandBufferStateTracker::ValidateCanDispatch() {
         return ValidateOperation(kDispatchAspects);
@@ -70,7 +90,7 @@ namespace dawn_native {
 
     MaybeError CommandBufferStateTracker::ValidateOperation(ValidationAspects requiredAspects) {
         // Fast return-true path if everything is good
-        ValidationAspects missingAspects = requiredAspects & ~mAspects;
+        ValidationAspects missingAspects = requiredAspects & ~mAspects & ~mSkippedAspects;
         if (missingAspects.none()) {
             return {};
         }
@@ -81,9 +101,16 @@ namespace dawn_native {
             return GenerateAspectError(missingAspects);
         }
 
+        // The lazy aspects can't be computed without a pipeline, which is only possible when the
+        // pipeline aspect isn't validated.
+        if (!mAspects[VALIDATION_ASPECT_PIPELINE]) {
+            ASSERT(mSkippedAspects[VALIDATION_ASPECT_PIPELINE]);
+            return {};
+        }
+
         RecomputeLazyAspects(missingAspects);
 
-        missingAspects = requiredAspects & ~mAspects;
+        missingAspects = requiredAspects & ~mAspects & ~mSkippedAspects;
         if (missingAspects.any()) {
             return GenerateAspectError(missingAspects);
         }
@@ -98,7 +125,7 @@ namespace dawn_native {
         if (aspects[VALIDATION_ASPECT_BIND_GROUPS]) {
             bool matches = true;
 
-            for (uint32_t i : IterateBitSet(mLastPipelineLayout->GetBindGroupLayoutsMask())) {
+            for (uint32_t i : IterateBitSetWords(mLastPipelineLayout->GetBindGroupLayoutsMask())) {
                 if (mBindgroups[i] == nullptr ||
                     mLastPipelineLayout->GetBindGroupLayout(i) != mBindgroups[i]->GetLayout()) {
                     matches = false;
@@ -120,6 +147,13 @@ namespace dawn_native {
                 mAspects.set(VALIDATION_ASPECT_VERTEX_BUFFERS);
             }
         }
+
+        if (aspects[VALIDATION_ASPECT_PUSH_CONSTANTS]) {
+            if (mPushConstantsEnd <= mLastPipelineLayout->GetPushConstantSize() &&
+                (mPushConstantStages & ~mLastPipelineLayout->GetPushConstantVisibility()) == 0) {
+                mAspects.set(VALIDATION_ASPECT_PUSH_CONSTANTS);
+            }
+        }
     }
 
     MaybeError CommandBufferStateTracker::GenerateAspectError(ValidationAspects aspects) {
@@ -137,6 +171,10 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR("Missing bind group");
         }
 
+        if (aspects[VALIDATION_ASPECT_PUSH_CONSTANTS]) {
+            return DAWN_VALIDATION_ERROR("Push constants not in the range of the pipeline layout");
+        }
+
         if (aspects[VALIDATION_ASPECT_PIPELINE]) {
             return DAWN_VALIDATION_ERROR("Missing pipeline");
         }
@@ -161,6 +199,14 @@ namespace dawn_native {
         mBindgroups[index] = bindgroup;
     }
 
+    void CommandBufferStateTracker::SetPushConstants(wgpu::ShaderStage stages,
+                                                     uint32_t offset,
+                                                     uint32_t size) {
+        mPushConstantStages |= stages;
+        mPushConstantsEnd = std::max(mPushConstantsEnd, offset + size);
+        mAspects.reset(VALIDATION_ASPECT_PUSH_CONSTANTS);
+    }
+
     void CommandBufferStateTracker::SetIndexBuffer() {
         mAspects.set(VALIDATION_ASPECT_INDEX_BUFFER);
     }
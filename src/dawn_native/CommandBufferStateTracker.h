@@ -19,6 +19,8 @@
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
 
+#include "dawn_native/dawn_platform.h"
+
 #include <array>
 #include <bitset>
 #include <map>
@@ -28,6 +30,10 @@ namespace dawn_native {
 
     class CommandBufferStateTracker {
       public:
+        CommandBufferStateTracker() = default;
+        // Only validates the aspects whose category of validation is enabled on the device.
+        explicit CommandBufferStateTracker(const DeviceBase* device);
+
         // Non-state-modifying validation functions
         MaybeError ValidateCanDispatch();
         MaybeError ValidateCanTraceRays();
@@ -39,10 +45,11 @@ namespace dawn_native {
         void SetRayTracingPipeline(RayTracingPipelineBase* pipeline);
         void SetRenderPipeline(RenderPipelineBase* pipeline);
         void SetBindGroup(uint32_t index, BindGroupBase* bindgroup);
+        void SetPushConstants(wgpu::ShaderStage stages, uint32_t offset, uint32_t size);
         void SetIndexBuffer();
         void SetVertexBuffer(uint32_t slot);
 
-        static constexpr size_t kNumAspects = 4;
+        static constexpr size_t kNumAspects = 5;
         using ValidationAspects = std::bitset<kNumAspects>;
 
       private:
@@ -53,9 +60,13 @@ namespace dawn_native {
         void SetPipelineCommon(PipelineBase* pipeline);
 
         ValidationAspects mAspects;
+        ValidationAspects mSkippedAspects;
 
         std::array<BindGroupBase*, kMaxBindGroups> mBindgroups = {};
         std::bitset<kMaxVertexBuffers> mVertexBufferSlotsUsed;
+        // The union of the stages and the end of the ranges of all the push constants set.
+        wgpu::ShaderStage mPushConstantStages = wgpu::ShaderStage::None;
+        uint32_t mPushConstantsEnd = 0;
 
         PipelineLayoutBase* mLastPipelineLayout = nullptr;
         RenderPipelineBase* mLastRenderPipeline = nullptr;
@@ -24,6 +24,8 @@
 #include "dawn_native/ComputePassEncoder.h"
 #include "dawn_native/Device.h"
 #include "dawn_native/ErrorData.h"
+#include "dawn_native/QuerySet.h"
+#include "dawn_native/Queue.h"
 #include "dawn_native/RenderPassEncoder.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
 #include "dawn_native/RayTracingPassEncoder.h"
@@ -34,42 +36,12 @@
 
 #include <cmath>
 #include <map>
+#include <set>
 
 namespace dawn_native {
 
     namespace {
 
-        MaybeError ValidateCopySizeFitsInTexture(const TextureCopy& textureCopy,
-                                                 const Extent3D& copySize) {
-            const TextureBase* texture = textureCopy.texture.Get();
-            if (textureCopy.mipLevel >= texture->GetNumMipLevels()) {
-                return DAWN_VALIDATION_ERROR("Copy mipLevel out of range");
-            }
-
-            if (textureCopy.arrayLayer >= texture->GetArrayLayers()) {
-                return DAWN_VALIDATION_ERROR("Copy arrayLayer out of range");
-            }
-
-            Extent3D extent = texture->GetMipLevelPhysicalSize(textureCopy.mipLevel);
-
-            // All texture dimensions are in uint32_t so by doing checks in uint64_t we avoid
-            // overflows.
-            if (uint64_t(textureCopy.origin.x) + uint64_t(copySize.width) >
-                    static_cast<uint64_t>(extent.width) ||
-                uint64_t(textureCopy.origin.y) + uint64_t(copySize.height) >
-                    static_cast<uint64_t>(extent.height)) {
-                return DAWN_VALIDATION_ERROR("Copy would touch outside of the texture");
-            }
-
-            // TODO(cwallez@chromium.org): Check the depth bound differently for 2D arrays and 3D
-            // textures
-            if (textureCopy.origin.z != 0 || copySize.depth > 1) {
-                return DAWN_VALIDATION_ERROR("No support for z != 0 and depth > 1 for now");
-            }
-
-            return {};
-        }
-
         MaybeError ValidateCopySizeFitsInBuffer(const Ref<BufferBase>& buffer,
                                                 uint64_t offset,
                                                 uint64_t size) {
@@ -112,29 +84,6 @@ namespace dawn_native {
             return {};
         }
 
-        MaybeError ValidateImageHeight(const Format& format,
-                                       uint32_t imageHeight,
-                                       uint32_t copyHeight) {
-            if (imageHeight < copyHeight) {
-                return DAWN_VALIDATION_ERROR("Image height must not be less than the copy height.");
-            }
-
-            if (imageHeight % format.blockHeight != 0) {
-                return DAWN_VALIDATION_ERROR(
-                    "Image height must be a multiple of compressed texture format block width");
-            }
-
-            return {};
-        }
-
-        MaybeError ValidateTextureSampleCountInCopyCommands(const TextureBase* texture) {
-            if (texture->GetSampleCount() > 1) {
-                return DAWN_VALIDATION_ERROR("The sample count of textures must be 1");
-            }
-
-            return {};
-        }
-
         MaybeError ValidateEntireSubresourceCopied(const TextureCopy& src,
                                                    const TextureCopy& dst,
                                                    const Extent3D& copySize) {
@@ -218,34 +167,6 @@ namespace dawn_native {
             return {};
         }
 
-        MaybeError ValidateImageOrigin(const Format& format, const Origin3D& offset) {
-            if (offset.x % format.blockWidth != 0) {
-                return DAWN_VALIDATION_ERROR(
-                    "Offset.x must be a multiple of compressed texture format block width");
-            }
-
-            if (offset.y % format.blockHeight != 0) {
-                return DAWN_VALIDATION_ERROR(
-                    "Offset.y must be a multiple of compressed texture format block height");
-            }
-
-            return {};
-        }
-
-        MaybeError ValidateImageCopySize(const Format& format, const Extent3D& extent) {
-            if (extent.width % format.blockWidth != 0) {
-                return DAWN_VALIDATION_ERROR(
-                    "Extent.width must be a multiple of compressed texture format block width");
-            }
-
-            if (extent.height % format.blockHeight != 0) {
-                return DAWN_VALIDATION_ERROR(
-                    "Extent.height must be a multiple of compressed texture format block height");
-            }
-
-            return {};
-        }
-
         MaybeError ValidateRayTracingAccelerationContainerCanBuild(
             const RayTracingAccelerationContainerBase* container) {
             if (container->IsBuilt()) {
@@ -257,6 +178,23 @@ namespace dawn_native {
             return {};
         }
 
+        MaybeError ValidateRayTracingAccelerationContainersCanBuild(
+            uint32_t count,
+            const Ref<RayTracingAccelerationContainerBase>* containers) {
+            if (count == 0) {
+                return DAWN_VALIDATION_ERROR("At least one Acceleration Container must be built");
+            }
+            std::set<const RayTracingAccelerationContainerBase*> uniqueContainers;
+            for (uint32_t i = 0; i < count; ++i) {
+                DAWN_TRY(ValidateRayTracingAccelerationContainerCanBuild(containers[i].Get()));
+                if (!uniqueContainers.insert(containers[i].Get()).second) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Acceleration Container is built more than once in the same batch");
+                }
+            }
+            return {};
+        }
+
         MaybeError ValidateRayTracingAccelerationContainerCanUpdate(
             const RayTracingAccelerationContainerBase* container) {
             if (!container->IsBuilt()) {
@@ -272,6 +210,46 @@ namespace dawn_native {
             return {};
         }
 
+        MaybeError ValidateRayTracingAccelerationContainerCanCompact(
+            const RayTracingAccelerationContainerBase* srcContainer,
+            const RayTracingAccelerationContainerBase* dstContainer) {
+            if (srcContainer == dstContainer) {
+                return DAWN_VALIDATION_ERROR(
+                    "Source and Destination Acceleration Container must be different");
+            }
+            if (!srcContainer->IsBuilt()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Source Acceleration Container must be built before compacting");
+            }
+            if (srcContainer->IsDestroyed()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Source Acceleration Container is destroyed and cannot be compacted");
+            }
+            if ((srcContainer->GetFlags() &
+                 wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) == 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "Source Acceleration Container does not support compaction");
+            }
+            if (srcContainer->GetCompactedSize() == 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "Compacted size of the Source Acceleration Container is not available until "
+                    "its build has completed");
+            }
+            if (dstContainer->IsBuilt()) {
+                return DAWN_VALIDATION_ERROR("Destination Acceleration Container is already built");
+            }
+            if (dstContainer->IsDestroyed()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Destination Acceleration Container is destroyed and cannot be used for "
+                    "compacting");
+            }
+            if (srcContainer->GetLevel() != dstContainer->GetLevel()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Source and Destination Acceleration Container must have the same level");
+            }
+            return {};
+        }
+
         MaybeError ValidateRayTracingAccelerationContainerCanCopy(
             const RayTracingAccelerationContainerBase* srcContainer,
             const RayTracingAccelerationContainerBase* dstContainer) {
@@ -304,6 +282,30 @@ namespace dawn_native {
             return {};
         }
 
+        MaybeError ValidateQuerySetResolve(const QuerySetBase* querySet,
+                                           uint32_t firstQuery,
+                                           uint32_t queryCount,
+                                           const BufferBase* destination,
+                                           uint64_t destinationOffset) {
+            if (firstQuery >= querySet->GetQueryCount() ||
+                queryCount > querySet->GetQueryCount() - firstQuery) {
+                return DAWN_VALIDATION_ERROR("Resolved queries out of bounds of the query set");
+            }
+
+            if (destinationOffset % kQueryResolveAlignment != 0) {
+                return DAWN_VALIDATION_ERROR("Resolve destination offset must be a multiple of 8");
+            }
+
+            uint64_t resolveSize = static_cast<uint64_t>(queryCount) *
+                                   querySet->GetResultCountPerQuery() * sizeof(uint64_t);
+            uint64_t bufferSize = destination->GetSize();
+            if (destinationOffset > bufferSize || resolveSize > bufferSize - destinationOffset) {
+                return DAWN_VALIDATION_ERROR("Resolve destination out of bounds of the buffer");
+            }
+
+            return {};
+        }
+
         MaybeError ValidateCanUseAs(const TextureBase* texture, wgpu::TextureUsage usage) {
             ASSERT(wgpu::HasZeroOrOneBits(usage));
             if (!(texture->GetUsage() & usage)) {
@@ -313,6 +315,33 @@ namespace dawn_native {
             return {};
         }
 
+        MaybeError ValidateGenerateMipmaps(const TextureBase* texture,
+                                           uint32_t baseMipLevel,
+                                           uint32_t mipLevelCount) {
+            if (texture->GetDimension() != wgpu::TextureDimension::e2D) {
+                return DAWN_VALIDATION_ERROR("Mipmaps can only be generated for 2D textures");
+            }
+
+            if (texture->GetSampleCount() > 1) {
+                return DAWN_VALIDATION_ERROR("Can't generate mipmaps for multisampled textures");
+            }
+
+            // The levels are filtered from the previous ones.
+            const Format& format = texture->GetFormat();
+            if (!format.IsColor() || format.isCompressed || format.type != Format::Type::Float) {
+                return DAWN_VALIDATION_ERROR("Mipmaps can't be generated for the texture format");
+            }
+
+            if (mipLevelCount == 0 ||
+                uint64_t(baseMipLevel) + mipLevelCount > texture->GetNumMipLevels()) {
+                return DAWN_VALIDATION_ERROR("Mipmap levels out of range");
+            }
+
+            DAWN_TRY(ValidateCanUseAs(texture, wgpu::TextureUsage::CopySrc));
+            DAWN_TRY(ValidateCanUseAs(texture, wgpu::TextureUsage::CopyDst));
+            return {};
+        }
+
         MaybeError ValidateAttachmentArrayLayersAndLevelCount(const TextureViewBase* attachment) {
             // Currently we do not support layered rendering.
             if (attachment->GetLayerCount() > 1) {
@@ -381,6 +410,10 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR("Cannot use multisampled texture as resolve target");
             }
 
+            if (resolveTarget->GetTexture()->IsTransientAttachment()) {
+                return DAWN_VALIDATION_ERROR("Cannot use a transient attachment as resolve target");
+            }
+
             if (resolveTarget->GetLayerCount() > 1) {
                 return DAWN_VALIDATION_ERROR(
                     "The array layer count of the resolve target must be 1");
@@ -432,6 +465,13 @@ namespace dawn_native {
             DAWN_TRY(ValidateLoadOp(colorAttachment.loadOp));
             DAWN_TRY(ValidateStoreOp(colorAttachment.storeOp));
 
+            if (attachment->GetTexture()->IsTransientAttachment() &&
+                (colorAttachment.loadOp != wgpu::LoadOp::Clear ||
+                 colorAttachment.storeOp != wgpu::StoreOp::Clear)) {
+                return DAWN_VALIDATION_ERROR(
+                    "Transient attachments must use the Clear loadOp and storeOp");
+            }
+
             if (colorAttachment.loadOp == wgpu::LoadOp::Clear) {
                 if (std::isnan(colorAttachment.clearColor.r) ||
                     std::isnan(colorAttachment.clearColor.g) ||
@@ -485,6 +525,14 @@ namespace dawn_native {
                     "The depth storeOp and stencil storeOp are not the same");
             }
 
+            if (attachment->GetTexture()->IsTransientAttachment() &&
+                (depthStencilAttachment->depthLoadOp != wgpu::LoadOp::Clear ||
+                 depthStencilAttachment->stencilLoadOp != wgpu::LoadOp::Clear ||
+                 depthStencilAttachment->depthStoreOp != wgpu::StoreOp::Clear)) {
+                return DAWN_VALIDATION_ERROR(
+                    "Transient attachments must use the Clear loadOps and storeOps");
+            }
+
             // *sampleCount == 0 must only happen when there is no color attachment. In that case we
             // do not need to validate the sample count of the depth stencil attachment.
             const uint32_t depthStencilSampleCount = attachment->GetTexture()->GetSampleCount();
@@ -539,38 +587,76 @@ namespace dawn_native {
             return {};
         }
 
+        // Builds and updates read the instance buffer of top-level containers and the geometry
+        // buffers of bottom-level containers, so they have to be valid when submitting too.
+        void TrackAccelerationContainerBuffers(std::set<BufferBase*>* buffers,
+                                               RayTracingAccelerationContainerBase* container) {
+            if (container->GetInstanceBuffer() != nullptr) {
+                buffers->insert(container->GetInstanceBuffer());
+            }
+            for (BufferBase* buffer : container->GetGeometryBuffers()) {
+                buffers->insert(buffer);
+            }
+        }
+
     }  // namespace
 
     CommandEncoder::CommandEncoder(DeviceBase* device, const CommandEncoderDescriptor*)
-        : ObjectBase(device), mEncodingContext(device, this) {
+        : ObjectBase(device),
+          mEncodingContext(device,
+                           this,
+                           device->IsToggleEnabled(Toggle::ValidateIndirectArgumentsOnGPU)) {
     }
 
     CommandBufferResourceUsage CommandEncoder::AcquireResourceUsages() {
         return CommandBufferResourceUsage{mEncodingContext.AcquirePassUsages(),
                                           std::move(mTopLevelBuffers),
                                           std::move(mTopLevelTextures),
-                                          std::move(mTopLevelAccelerationContainers)};
+                                          std::move(mTopLevelAccelerationContainers),
+                                          std::move(mBuiltAccelerationContainers),
+                                          std::move(mTopLevelWrittenQueries),
+                                          mRequiredQueueType};
+    }
+
+    void CommandEncoder::RequireQueueType(wgpu::QueueType queueType) {
+        if (QueueTypeSupports(queueType, mRequiredQueueType)) {
+            mRequiredQueueType = queueType;
+        }
     }
 
     CommandIterator CommandEncoder::AcquireCommands() {
         return mEncodingContext.AcquireCommands();
     }
 
+    RetainedObjects CommandEncoder::AcquireRetainedObjects() {
+        return mEncodingContext.AcquireRetainedObjects();
+    }
+
+    CommandBufferStatistics CommandEncoder::AcquireStatistics() {
+        return std::move(mStatistics);
+    }
+
     // Implementation of the API's command recording methods
 
     ComputePassEncoder* CommandEncoder::BeginComputePass(const ComputePassDescriptor* descriptor) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), General, "CommandEncoder::BeginComputePass");
         DeviceBase* device = GetDevice();
 
+        mEncodingContext.WillBeginPass();
         bool success =
             mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
                 DAWN_TRY(ValidateComputePassDescriptor(device, descriptor));
 
-                allocator->Allocate<BeginComputePassCmd>(Command::BeginComputePass);
+                BeginComputePassCmd* cmd =
+                    allocator->Allocate<BeginComputePassCmd>(Command::BeginComputePass);
+                cmd->independentDispatches =
+                    descriptor != nullptr && descriptor->independentDispatches;
 
                 return {};
             });
 
         if (success) {
+            RequireQueueType(wgpu::QueueType::Compute);
             ComputePassEncoder* passEncoder =
                 new ComputePassEncoder(device, this, &mEncodingContext);
             mEncodingContext.EnterPass(passEncoder);
@@ -582,6 +668,7 @@ namespace dawn_native {
 
     RayTracingPassEncoder* CommandEncoder::BeginRayTracingPass(
         const RayTracingPassDescriptor* descriptor) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), General, "CommandEncoder::BeginRayTracingPass");
         DeviceBase* device = GetDevice();
 
         bool success =
@@ -594,6 +681,7 @@ namespace dawn_native {
             });
 
         if (success) {
+            RequireQueueType(wgpu::QueueType::Compute);
             RayTracingPassEncoder* passEncoder =
                 new RayTracingPassEncoder(device, this, &mEncodingContext);
             mEncodingContext.EnterPass(passEncoder);
@@ -604,9 +692,12 @@ namespace dawn_native {
     }
 
     RenderPassEncoder* CommandEncoder::BeginRenderPass(const RenderPassDescriptor* descriptor) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), General, "CommandEncoder::BeginRenderPass");
         DeviceBase* device = GetDevice();
 
         PassResourceUsageTracker usageTracker;
+        Ref<AttachmentState> attachmentState;
+        mEncodingContext.WillBeginPass();
         bool success =
             mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
                 uint32_t width = 0;
@@ -622,6 +713,7 @@ namespace dawn_native {
                     allocator->Allocate<BeginRenderPassCmd>(Command::BeginRenderPass);
 
                 cmd->attachmentState = device->GetOrCreateAttachmentState(descriptor);
+                attachmentState = cmd->attachmentState;
 
                 for (uint32_t i : IterateBitSet(cmd->attachmentState->GetColorAttachmentsMask())) {
                     TextureViewBase* view = descriptor->colorAttachments[i].attachment;
@@ -634,12 +726,11 @@ namespace dawn_native {
                     cmd->colorAttachments[i].clearColor =
                         descriptor->colorAttachments[i].clearColor;
 
-                    usageTracker.TextureUsedAs(view->GetTexture(),
-                                               wgpu::TextureUsage::OutputAttachment);
+                    usageTracker.TextureViewUsedAs(view, wgpu::TextureUsage::OutputAttachment);
 
                     if (resolveTarget != nullptr) {
-                        usageTracker.TextureUsedAs(resolveTarget->GetTexture(),
-                                                   wgpu::TextureUsage::OutputAttachment);
+                        usageTracker.TextureViewUsedAs(resolveTarget,
+                                                       wgpu::TextureUsage::OutputAttachment);
                     }
                 }
 
@@ -660,8 +751,7 @@ namespace dawn_native {
                     cmd->depthStencilAttachment.stencilStoreOp =
                         descriptor->depthStencilAttachment->stencilStoreOp;
 
-                    usageTracker.TextureUsedAs(view->GetTexture(),
-                                               wgpu::TextureUsage::OutputAttachment);
+                    usageTracker.TextureViewUsedAs(view, wgpu::TextureUsage::OutputAttachment);
                 }
 
                 cmd->width = width;
@@ -671,8 +761,10 @@ namespace dawn_native {
             });
 
         if (success) {
+            RequireQueueType(wgpu::QueueType::Graphics);
             RenderPassEncoder* passEncoder =
-                new RenderPassEncoder(device, this, &mEncodingContext, std::move(usageTracker));
+                new RenderPassEncoder(device, this, &mEncodingContext, std::move(usageTracker),
+                                      std::move(attachmentState));
             mEncodingContext.EnterPass(passEncoder);
             return passEncoder;
         }
@@ -690,8 +782,76 @@ namespace dawn_native {
                     Command::BuildRayTracingAccelerationContainer);
             build->container = container;
 
+            RequireQueueType(wgpu::QueueType::Compute);
+
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateRayTracingAccelerationContainerCanBuild(container));
+
                 mTopLevelAccelerationContainers.insert(container);
+                TrackAccelerationContainerBuffers(&mTopLevelBuffers, container);
+                mBuiltAccelerationContainers.insert(container);
+            }
+
+            return {};
+        });
+    }
+
+    void CommandEncoder::BuildRayTracingAccelerationContainers(
+        uint32_t containerCount,
+        RayTracingAccelerationContainerBase* const* containers) {
+        mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            for (uint32_t i = 0; i < containerCount; ++i) {
+                DAWN_TRY(GetDevice()->ValidateObject((ObjectBase*)containers[i]));
+            }
+
+            BuildRayTracingAccelerationContainersCmd* build =
+                allocator->Allocate<BuildRayTracingAccelerationContainersCmd>(
+                    Command::BuildRayTracingAccelerationContainers);
+            build->count = containerCount;
+
+            Ref<RayTracingAccelerationContainerBase>* data =
+                allocator->AllocateData<Ref<RayTracingAccelerationContainerBase>>(containerCount);
+            for (uint32_t i = 0; i < containerCount; ++i) {
+                data[i] = containers[i];
+            }
+
+            RequireQueueType(wgpu::QueueType::Compute);
+
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateRayTracingAccelerationContainersCanBuild(containerCount, data));
+
+                for (uint32_t i = 0; i < containerCount; ++i) {
+                    mTopLevelAccelerationContainers.insert(containers[i]);
+                    TrackAccelerationContainerBuffers(&mTopLevelBuffers, containers[i]);
+                    mBuiltAccelerationContainers.insert(containers[i]);
+                }
+            }
+
+            return {};
+        });
+    }
+
+    void CommandEncoder::CompactRayTracingAccelerationContainer(
+        RayTracingAccelerationContainerBase* srcContainer,
+        RayTracingAccelerationContainerBase* dstContainer) {
+        mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            DAWN_TRY(GetDevice()->ValidateObject((ObjectBase*)srcContainer));
+            DAWN_TRY(GetDevice()->ValidateObject((ObjectBase*)dstContainer));
+
+            CompactRayTracingAccelerationContainerCmd* compact =
+                allocator->Allocate<CompactRayTracingAccelerationContainerCmd>(
+                    Command::CompactRayTracingAccelerationContainer);
+            compact->srcContainer = srcContainer;
+            compact->dstContainer = dstContainer;
+
+            RequireQueueType(wgpu::QueueType::Compute);
+
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateRayTracingAccelerationContainerCanCompact(srcContainer,
+                                                                           dstContainer));
+
+                mTopLevelAccelerationContainers.insert(srcContainer);
+                mTopLevelAccelerationContainers.insert(dstContainer);
             }
 
             return {};
@@ -711,7 +871,12 @@ namespace dawn_native {
             build->srcContainer = srcContainer;
             build->dstContainer = dstContainer;
 
+            RequireQueueType(wgpu::QueueType::Compute);
+
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(
+                    ValidateRayTracingAccelerationContainerCanCopy(srcContainer, dstContainer));
+
                 mTopLevelAccelerationContainers.insert(srcContainer);
                 mTopLevelAccelerationContainers.insert(dstContainer);
             }
@@ -730,8 +895,13 @@ namespace dawn_native {
                     Command::UpdateRayTracingAccelerationContainer);
             update->container = container;
 
+            RequireQueueType(wgpu::QueueType::Compute);
+
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateRayTracingAccelerationContainerCanUpdate(container));
+
                 mTopLevelAccelerationContainers.insert(container);
+                TrackAccelerationContainerBuffers(&mTopLevelBuffers, container);
             }
 
             return {};
@@ -756,6 +926,16 @@ namespace dawn_native {
             copy->size = size;
 
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(
+                    ValidateCopySizeFitsInBuffer(copy->source, copy->sourceOffset, copy->size));
+                DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->destination, copy->destinationOffset,
+                                                      copy->size));
+                DAWN_TRY(ValidateB2BCopySizeAlignment(copy->size, copy->sourceOffset,
+                                                      copy->destinationOffset));
+
+                DAWN_TRY(ValidateCanUseAs(copy->source.Get(), wgpu::BufferUsage::CopySrc));
+                DAWN_TRY(ValidateCanUseAs(copy->destination.Get(), wgpu::BufferUsage::CopyDst));
+
                 mTopLevelBuffers.insert(source);
                 mTopLevelBuffers.insert(destination);
             }
@@ -792,6 +972,34 @@ namespace dawn_native {
             }
 
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateTextureSampleCountInCopyCommands(copy->destination.texture.Get()));
+
+                DAWN_TRY(ValidateImageHeight(copy->destination.texture->GetFormat(),
+                                             copy->source.imageHeight, copy->copySize.height));
+                DAWN_TRY(ValidateImageOrigin(copy->destination.texture->GetFormat(),
+                                             copy->destination.origin));
+                DAWN_TRY(
+                    ValidateImageCopySize(copy->destination.texture->GetFormat(), copy->copySize));
+
+                uint32_t bufferCopySize = 0;
+                DAWN_TRY(ValidateRowPitch(copy->destination.texture->GetFormat(), copy->copySize,
+                                          copy->source.rowPitch));
+
+                DAWN_TRY(ComputeTextureCopyBufferSize(copy->destination.texture->GetFormat(),
+                                                      copy->copySize, copy->source.rowPitch,
+                                                      copy->source.imageHeight, &bufferCopySize));
+
+                if (GetDevice()->IsCopyBoundsValidationEnabled()) {
+                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->destination, copy->copySize));
+                }
+                DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->source, bufferCopySize));
+                DAWN_TRY(ValidateTexelBufferOffset(copy->source,
+                                                   copy->destination.texture->GetFormat()));
+
+                DAWN_TRY(ValidateCanUseAs(copy->source.buffer.Get(), wgpu::BufferUsage::CopySrc));
+                DAWN_TRY(ValidateCanUseAs(copy->destination.texture.Get(),
+                                          wgpu::TextureUsage::CopyDst));
+
                 mTopLevelBuffers.insert(source->buffer);
                 mTopLevelTextures.insert(destination->texture);
             }
@@ -828,6 +1036,33 @@ namespace dawn_native {
             }
 
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateTextureSampleCountInCopyCommands(copy->source.texture.Get()));
+
+                DAWN_TRY(ValidateImageHeight(copy->source.texture->GetFormat(),
+                                             copy->destination.imageHeight,
+                                             copy->copySize.height));
+                DAWN_TRY(
+                    ValidateImageOrigin(copy->source.texture->GetFormat(), copy->source.origin));
+                DAWN_TRY(ValidateImageCopySize(copy->source.texture->GetFormat(), copy->copySize));
+
+                uint32_t bufferCopySize = 0;
+                DAWN_TRY(ValidateRowPitch(copy->source.texture->GetFormat(), copy->copySize,
+                                          copy->destination.rowPitch));
+                DAWN_TRY(ComputeTextureCopyBufferSize(
+                    copy->source.texture->GetFormat(), copy->copySize, copy->destination.rowPitch,
+                    copy->destination.imageHeight, &bufferCopySize));
+
+                if (GetDevice()->IsCopyBoundsValidationEnabled()) {
+                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->source, copy->copySize));
+                }
+                DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->destination, bufferCopySize));
+                DAWN_TRY(ValidateTexelBufferOffset(copy->destination,
+                                                   copy->source.texture->GetFormat()));
+
+                DAWN_TRY(ValidateCanUseAs(copy->source.texture.Get(), wgpu::TextureUsage::CopySrc));
+                DAWN_TRY(ValidateCanUseAs(copy->destination.buffer.Get(),
+                                          wgpu::BufferUsage::CopyDst));
+
                 mTopLevelTextures.insert(source->texture);
                 mTopLevelBuffers.insert(destination->buffer);
             }
@@ -855,6 +1090,26 @@ namespace dawn_native {
             copy->copySize = *copySize;
 
             if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateTextureToTextureCopyRestrictions(copy->source, copy->destination,
+                                                                  copy->copySize));
+
+                DAWN_TRY(
+                    ValidateImageOrigin(copy->source.texture->GetFormat(), copy->source.origin));
+                DAWN_TRY(ValidateImageCopySize(copy->source.texture->GetFormat(), copy->copySize));
+                DAWN_TRY(ValidateImageOrigin(copy->destination.texture->GetFormat(),
+                                             copy->destination.origin));
+                DAWN_TRY(
+                    ValidateImageCopySize(copy->destination.texture->GetFormat(), copy->copySize));
+
+                if (GetDevice()->IsCopyBoundsValidationEnabled()) {
+                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->source, copy->copySize));
+                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->destination, copy->copySize));
+                }
+
+                DAWN_TRY(ValidateCanUseAs(copy->source.texture.Get(), wgpu::TextureUsage::CopySrc));
+                DAWN_TRY(ValidateCanUseAs(copy->destination.texture.Get(),
+                                          wgpu::TextureUsage::CopyDst));
+
                 mTopLevelTextures.insert(source->texture);
                 mTopLevelTextures.insert(destination->texture);
             }
@@ -862,6 +1117,94 @@ namespace dawn_native {
         });
     }
 
+    void CommandEncoder::GenerateMipmaps(TextureBase* texture,
+                                         uint32_t baseMipLevel,
+                                         uint32_t mipLevelCount) {
+        mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(GetDevice()->ValidateObject(texture));
+                DAWN_TRY(ValidateGenerateMipmaps(texture, baseMipLevel, mipLevelCount));
+                mTopLevelTextures.insert(texture);
+            }
+
+            // Generating the base level alone doesn't do anything.
+            if (mipLevelCount == 1) {
+                return {};
+            }
+
+            GenerateMipmapsCmd* cmd =
+                allocator->Allocate<GenerateMipmapsCmd>(Command::GenerateMipmaps);
+            cmd->texture = texture;
+            cmd->baseMipLevel = baseMipLevel;
+            cmd->mipLevelCount = mipLevelCount;
+            return {};
+        });
+    }
+
+    void CommandEncoder::ResolveQuerySet(QuerySetBase* querySet,
+                                         uint32_t firstQuery,
+                                         uint32_t queryCount,
+                                         BufferBase* destination,
+                                         uint64_t destinationOffset) {
+        mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(GetDevice()->ValidateObject(querySet));
+                DAWN_TRY(GetDevice()->ValidateObject(destination));
+
+                DAWN_TRY(ValidateQuerySetResolve(querySet, firstQuery, queryCount, destination,
+                                                 destinationOffset));
+                DAWN_TRY(ValidateCanUseAs(destination, wgpu::BufferUsage::QueryResolve));
+
+                // Results are waited for when they are resolved, so every query has to be
+                // written before the resolve executes.
+                for (uint32_t i = firstQuery; i < firstQuery + queryCount; ++i) {
+                    if (!querySet->IsQueryAvailable(i) && !IsQueryWrittenByEncoder(querySet, i)) {
+                        return DAWN_VALIDATION_ERROR("Resolving queries which were never written");
+                    }
+                }
+
+                // Keep track of the query set so that its destruction is checked at submit.
+                std::vector<bool>& writtenQueries = mTopLevelWrittenQueries[querySet];
+                if (writtenQueries.empty()) {
+                    writtenQueries.resize(querySet->GetQueryCount(), false);
+                }
+                mTopLevelBuffers.insert(destination);
+            }
+
+            ResolveQuerySetCmd* cmd =
+                allocator->Allocate<ResolveQuerySetCmd>(Command::ResolveQuerySet);
+            cmd->querySet = querySet;
+            cmd->firstQuery = firstQuery;
+            cmd->queryCount = queryCount;
+            cmd->destination = destination;
+            cmd->destinationOffset = destinationOffset;
+
+            return {};
+        });
+    }
+
+    void CommandEncoder::WriteTimestamp(QuerySetBase* querySet, uint32_t queryIndex) {
+        mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(GetDevice()->ValidateObject(querySet));
+                DAWN_TRY(ValidateQueryWrite(querySet, queryIndex, wgpu::QueryType::Timestamp));
+
+                std::vector<bool>& writtenQueries = mTopLevelWrittenQueries[querySet];
+                if (writtenQueries.empty()) {
+                    writtenQueries.resize(querySet->GetQueryCount(), false);
+                }
+                writtenQueries[queryIndex] = true;
+            }
+
+            WriteTimestampCmd* cmd =
+                allocator->Allocate<WriteTimestampCmd>(Command::WriteTimestamp);
+            cmd->querySet = querySet;
+            cmd->queryIndex = queryIndex;
+
+            return {};
+        });
+    }
+
     void CommandEncoder::InsertDebugMarker(const char* groupLabel) {
         mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             InsertDebugMarkerCmd* cmd =
@@ -877,6 +1220,11 @@ namespace dawn_native {
 
     void CommandEncoder::PopDebugGroup() {
         mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateCanPopDebugGroup(mDebugGroupStackSize));
+            }
+            mDebugGroupStackSize--;
+
             allocator->Allocate<PopDebugGroupCmd>(Command::PopDebugGroup);
 
             return {};
@@ -892,211 +1240,91 @@ namespace dawn_native {
             char* label = allocator->AllocateData<char>(cmd->length + 1);
             memcpy(label, groupLabel, cmd->length + 1);
 
+            mDebugGroupStackSize++;
+
             return {};
         });
     }
 
     CommandBufferBase* CommandEncoder::Finish(const CommandBufferDescriptor* descriptor) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), General, "CommandEncoder::Finish");
         DeviceBase* device = GetDevice();
+        // Recording can happen on any thread but creating the command buffer is serialized with
+        // the other calls into the device.
+        DeviceLock lock(device->GetMutex());
+
+        dawn_platform::Platform* platform = device->GetPlatform();
+        const bool gathersStatistics = TRACE_EVENT_CATEGORY_ENABLED(platform, General);
+        const double validationBeginTime =
+            gathersStatistics ? platform->MonotonicallyIncreasingTime() : 0;
+
         // Even if mEncodingContext.Finish() validation fails, calling it will mutate the internal
         // state of the encoding context. The internal state is set to finished, and subsequent
         // calls to encode commands will generate errors.
         if (device->ConsumedError(mEncodingContext.Finish()) ||
             device->ConsumedError(device->ValidateIsAlive()) ||
             (device->IsValidationEnabled() &&
-             device->ConsumedError(ValidateFinish(mEncodingContext.GetIterator(),
-                                                  mEncodingContext.GetPassUsages())))) {
+             device->ConsumedError(ValidateFinish(mEncodingContext.GetPassUsages()))) ||
+            device->ConsumedError(mEncodingContext.EncodeIndirectValidation())) {
             return CommandBufferBase::MakeError(device);
         }
         ASSERT(!IsError());
-        return device->CreateCommandBuffer(this, descriptor);
-    }
-
-    // Implementation of the command buffer validation that can be precomputed before submit
-    MaybeError CommandEncoder::ValidateFinish(CommandIterator* commands,
-                                              const PerPassUsages& perPassUsages) const {
-        TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "CommandEncoder::ValidateFinish");
-        DAWN_TRY(GetDevice()->ValidateObject(this));
 
-        for (const PassResourceUsage& passUsage : perPassUsages) {
-            DAWN_TRY(ValidatePassResourceUsage(passUsage));
+        if (!gathersStatistics) {
+            return device->CreateCommandBuffer(this, descriptor);
         }
 
-        uint64_t debugGroupStackSize = 0;
-
-        commands->Reset();
+        const double loweringBeginTime = platform->MonotonicallyIncreasingTime();
+        mStatistics.gathered = true;
+        mStatistics.validationTime = loweringBeginTime - validationBeginTime;
+        CommandIterator* commands = mEncodingContext.GetIterator();
+        mStatistics.commandBytes = commands->GetAllocatedSize();
+        mStatistics.commandCounts.resize(kCommandTypeCount, 0);
         Command type;
         while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::BeginComputePass: {
-                    commands->NextCommand<BeginComputePassCmd>();
-                    DAWN_TRY(ValidateComputePass(commands));
-                } break;
-
-                case Command::BeginRayTracingPass: {
-                    commands->NextCommand<BeginRayTracingPassCmd>();
-                    DAWN_TRY(ValidateRayTracingPass(commands));
-                } break;
-
-                case Command::BeginRenderPass: {
-                    const BeginRenderPassCmd* cmd = commands->NextCommand<BeginRenderPassCmd>();
-                    DAWN_TRY(ValidateRenderPass(commands, cmd));
-                } break;
-
-                case Command::BuildRayTracingAccelerationContainer: {
-                    const BuildRayTracingAccelerationContainerCmd* build =
-                        commands->NextCommand<BuildRayTracingAccelerationContainerCmd>();
-
-                    DAWN_TRY(
-                        ValidateRayTracingAccelerationContainerCanBuild(build->container.Get()));
-                } break;
-
-                case Command::UpdateRayTracingAccelerationContainer: {
-                    const UpdateRayTracingAccelerationContainerCmd* build =
-                        commands->NextCommand<UpdateRayTracingAccelerationContainerCmd>();
-
-                    DAWN_TRY(
-                        ValidateRayTracingAccelerationContainerCanUpdate(build->container.Get()));
-                } break;
-
-                case Command::CopyRayTracingAccelerationContainer: {
-                    const CopyRayTracingAccelerationContainerCmd* copy =
-                        commands->NextCommand<CopyRayTracingAccelerationContainerCmd>();
-
-                    DAWN_TRY(ValidateRayTracingAccelerationContainerCanCopy(
-                        copy->srcContainer.Get(), copy->dstContainer.Get()));
-                } break;
-
-                case Command::CopyBufferToBuffer: {
-                    const CopyBufferToBufferCmd* copy =
-                        commands->NextCommand<CopyBufferToBufferCmd>();
-
-                    DAWN_TRY(
-                        ValidateCopySizeFitsInBuffer(copy->source, copy->sourceOffset, copy->size));
-                    DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->destination,
-                                                          copy->destinationOffset, copy->size));
-                    DAWN_TRY(ValidateB2BCopySizeAlignment(copy->size, copy->sourceOffset,
-                                                          copy->destinationOffset));
-
-                    DAWN_TRY(ValidateCanUseAs(copy->source.Get(), wgpu::BufferUsage::CopySrc));
-                    DAWN_TRY(ValidateCanUseAs(copy->destination.Get(), wgpu::BufferUsage::CopyDst));
-                } break;
-
-                case Command::CopyBufferToTexture: {
-                    const CopyBufferToTextureCmd* copy =
-                        commands->NextCommand<CopyBufferToTextureCmd>();
-
-                    DAWN_TRY(
-                        ValidateTextureSampleCountInCopyCommands(copy->destination.texture.Get()));
-
-                    DAWN_TRY(ValidateImageHeight(copy->destination.texture->GetFormat(),
-                                                 copy->source.imageHeight, copy->copySize.height));
-                    DAWN_TRY(ValidateImageOrigin(copy->destination.texture->GetFormat(),
-                                                 copy->destination.origin));
-                    DAWN_TRY(ValidateImageCopySize(copy->destination.texture->GetFormat(),
-                                                   copy->copySize));
-
-                    uint32_t bufferCopySize = 0;
-                    DAWN_TRY(ValidateRowPitch(copy->destination.texture->GetFormat(),
-                                              copy->copySize, copy->source.rowPitch));
-
-                    DAWN_TRY(ComputeTextureCopyBufferSize(
-                        copy->destination.texture->GetFormat(), copy->copySize,
-                        copy->source.rowPitch, copy->source.imageHeight, &bufferCopySize));
-
-                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->destination, copy->copySize));
-                    DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->source, bufferCopySize));
-                    DAWN_TRY(ValidateTexelBufferOffset(copy->source,
-                                                       copy->destination.texture->GetFormat()));
-
-                    DAWN_TRY(
-                        ValidateCanUseAs(copy->source.buffer.Get(), wgpu::BufferUsage::CopySrc));
-                    DAWN_TRY(ValidateCanUseAs(copy->destination.texture.Get(),
-                                              wgpu::TextureUsage::CopyDst));
-                } break;
-
-                case Command::CopyTextureToBuffer: {
-                    const CopyTextureToBufferCmd* copy =
-                        commands->NextCommand<CopyTextureToBufferCmd>();
-
-                    DAWN_TRY(ValidateTextureSampleCountInCopyCommands(copy->source.texture.Get()));
-
-                    DAWN_TRY(ValidateImageHeight(copy->source.texture->GetFormat(),
-                                                 copy->destination.imageHeight,
-                                                 copy->copySize.height));
-                    DAWN_TRY(ValidateImageOrigin(copy->source.texture->GetFormat(),
-                                                 copy->source.origin));
-                    DAWN_TRY(
-                        ValidateImageCopySize(copy->source.texture->GetFormat(), copy->copySize));
-
-                    uint32_t bufferCopySize = 0;
-                    DAWN_TRY(ValidateRowPitch(copy->source.texture->GetFormat(), copy->copySize,
-                                              copy->destination.rowPitch));
-                    DAWN_TRY(ComputeTextureCopyBufferSize(
-                        copy->source.texture->GetFormat(), copy->copySize,
-                        copy->destination.rowPitch, copy->destination.imageHeight,
-                        &bufferCopySize));
+            mStatistics.commandCounts[static_cast<size_t>(type)]++;
+            SkipCommand(commands, type);
+        }
 
-                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->source, copy->copySize));
-                    DAWN_TRY(ValidateCopySizeFitsInBuffer(copy->destination, bufferCopySize));
-                    DAWN_TRY(ValidateTexelBufferOffset(copy->destination,
-                                                       copy->source.texture->GetFormat()));
-
-                    DAWN_TRY(
-                        ValidateCanUseAs(copy->source.texture.Get(), wgpu::TextureUsage::CopySrc));
-                    DAWN_TRY(ValidateCanUseAs(copy->destination.buffer.Get(),
-                                              wgpu::BufferUsage::CopyDst));
-                } break;
-
-                case Command::CopyTextureToTexture: {
-                    const CopyTextureToTextureCmd* copy =
-                        commands->NextCommand<CopyTextureToTextureCmd>();
-
-                    DAWN_TRY(ValidateTextureToTextureCopyRestrictions(
-                        copy->source, copy->destination, copy->copySize));
-
-                    DAWN_TRY(ValidateImageOrigin(copy->source.texture->GetFormat(),
-                                                 copy->source.origin));
-                    DAWN_TRY(
-                        ValidateImageCopySize(copy->source.texture->GetFormat(), copy->copySize));
-                    DAWN_TRY(ValidateImageOrigin(copy->destination.texture->GetFormat(),
-                                                 copy->destination.origin));
-                    DAWN_TRY(ValidateImageCopySize(copy->destination.texture->GetFormat(),
-                                                   copy->copySize));
+        CommandBufferBase* commandBuffer = device->CreateCommandBuffer(this, descriptor);
+        commandBuffer->AddLoweringTime(platform->MonotonicallyIncreasingTime() -
+                                       loweringBeginTime);
+        return commandBuffer;
+    }
 
-                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->source, copy->copySize));
-                    DAWN_TRY(ValidateCopySizeFitsInTexture(copy->destination, copy->copySize));
+    // Implementation of the command buffer validation that can be precomputed before submit. The
+    // commands themselves are validated as they are encoded, so only the state accumulated while
+    // encoding is left to check.
+    MaybeError CommandEncoder::ValidateFinish(const PerPassUsages& perPassUsages) const {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "CommandEncoder::ValidateFinish");
+        DAWN_TRY(GetDevice()->ValidateObject(this));
 
-                    DAWN_TRY(
-                        ValidateCanUseAs(copy->source.texture.Get(), wgpu::TextureUsage::CopySrc));
-                    DAWN_TRY(ValidateCanUseAs(copy->destination.texture.Get(),
-                                              wgpu::TextureUsage::CopyDst));
-                } break;
-
-                case Command::InsertDebugMarker: {
-                    const InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                } break;
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(debugGroupStackSize));
-                    debugGroupStackSize--;
-                } break;
-
-                case Command::PushDebugGroup: {
-                    const PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    debugGroupStackSize++;
-                } break;
-                default:
-                    return DAWN_VALIDATION_ERROR("Command disallowed outside of a pass");
+        if (GetDevice()->IsResourceUsageValidationEnabled()) {
+            for (const PassResourceUsage& passUsage : perPassUsages) {
+                DAWN_TRY(ValidatePassResourceUsage(passUsage));
             }
         }
 
-        DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
+        DAWN_TRY(ValidateFinalDebugGroupStackSize(mDebugGroupStackSize));
 
         return {};
     }
 
+    bool CommandEncoder::IsQueryWrittenByEncoder(const QuerySetBase* querySet,
+                                                 uint32_t queryIndex) const {
+        auto it = mTopLevelWrittenQueries.find(const_cast<QuerySetBase*>(querySet));
+        if (it != mTopLevelWrittenQueries.end() && it->second[queryIndex]) {
+            return true;
+        }
+
+        for (const PassResourceUsage& passUsage : mEncodingContext.GetPassUsages()) {
+            for (size_t i = 0; i < passUsage.querySets.size(); ++i) {
+                if (passUsage.querySets[i] == querySet && passUsage.writtenQueries[i][queryIndex]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
 }  // namespace dawn_native
@@ -17,6 +17,8 @@
 
 #include "dawn_native/dawn_platform.h"
 
+#include "common/MagazineAllocator.h"
+#include "dawn_native/CommandBuffer.h"
 #include "dawn_native/EncodingContext.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ObjectBase.h"
@@ -28,12 +30,14 @@ namespace dawn_native {
 
     struct BeginRenderPassCmd;
 
-    class CommandEncoder final : public ObjectBase {
+    class CommandEncoder final : public ObjectBase, public MagazineAllocated {
       public:
         CommandEncoder(DeviceBase* device, const CommandEncoderDescriptor* descriptor);
 
         CommandIterator AcquireCommands();
         CommandBufferResourceUsage AcquireResourceUsages();
+        RetainedObjects AcquireRetainedObjects();
+        CommandBufferStatistics AcquireStatistics();
 
         // Dawn API
         ComputePassEncoder* BeginComputePass(const ComputePassDescriptor* descriptor);
@@ -41,7 +45,13 @@ namespace dawn_native {
         RenderPassEncoder* BeginRenderPass(const RenderPassDescriptor* descriptor);
 
         void BuildRayTracingAccelerationContainer(RayTracingAccelerationContainerBase* container);
+        void BuildRayTracingAccelerationContainers(
+            uint32_t containerCount,
+            RayTracingAccelerationContainerBase* const* containers);
 
+        void CompactRayTracingAccelerationContainer(
+            RayTracingAccelerationContainerBase* srcContainer,
+            RayTracingAccelerationContainerBase* dstContainer);
         void CopyRayTracingAccelerationContainer(RayTracingAccelerationContainerBase* srcContainer,
                                                  RayTracingAccelerationContainerBase* dstContainer);
 
@@ -61,6 +71,14 @@ namespace dawn_native {
         void CopyTextureToTexture(const TextureCopyView* source,
                                   const TextureCopyView* destination,
                                   const Extent3D* copySize);
+        void GenerateMipmaps(TextureBase* texture, uint32_t baseMipLevel, uint32_t mipLevelCount);
+
+        void ResolveQuerySet(QuerySetBase* querySet,
+                             uint32_t firstQuery,
+                             uint32_t queryCount,
+                             BufferBase* destination,
+                             uint64_t destinationOffset);
+        void WriteTimestamp(QuerySetBase* querySet, uint32_t queryIndex);
 
         void InsertDebugMarker(const char* groupLabel);
         void PopDebugGroup();
@@ -69,13 +87,22 @@ namespace dawn_native {
         CommandBufferBase* Finish(const CommandBufferDescriptor* descriptor);
 
       private:
-        MaybeError ValidateFinish(CommandIterator* commands,
-                                  const PerPassUsages& perPassUsages) const;
+        MaybeError ValidateFinish(const PerPassUsages& perPassUsages) const;
+        // Whether the query was written by an earlier command of this encoder, which makes it
+        // valid to resolve before it is available.
+        bool IsQueryWrittenByEncoder(const QuerySetBase* querySet, uint32_t queryIndex) const;
+        // Raises the type of queue the command buffer needs to at least |queueType|.
+        void RequireQueueType(wgpu::QueueType queueType);
 
         EncodingContext mEncodingContext;
+        uint64_t mDebugGroupStackSize = 0;
         std::set<BufferBase*> mTopLevelBuffers;
         std::set<TextureBase*> mTopLevelTextures;
         std::set<RayTracingAccelerationContainerBase*> mTopLevelAccelerationContainers;
+        std::set<const RayTracingAccelerationContainerBase*> mBuiltAccelerationContainers;
+        std::map<QuerySetBase*, std::vector<bool>> mTopLevelWrittenQueries;
+        wgpu::QueueType mRequiredQueueType = wgpu::QueueType::Copy;
+        CommandBufferStatistics mStatistics;
     };
 
 }  // namespace dawn_native
@@ -14,101 +14,15 @@
 
 #include "dawn_native/CommandValidation.h"
 
-#include "common/BitSetIterator.h"
-#include "dawn_native/BindGroup.h"
 #include "dawn_native/Buffer.h"
-#include "dawn_native/CommandBufferStateTracker.h"
 #include "dawn_native/Commands.h"
+#include "dawn_native/Format.h"
 #include "dawn_native/PassResourceUsage.h"
-#include "dawn_native/RenderBundle.h"
-#include "dawn_native/RenderPipeline.h"
+#include "dawn_native/QuerySet.h"
+#include "dawn_native/Texture.h"
 
 namespace dawn_native {
 
-    namespace {
-
-        inline MaybeError ValidateRenderBundleCommand(CommandIterator* commands,
-                                                      Command type,
-                                                      CommandBufferStateTracker* commandBufferState,
-                                                      const AttachmentState* attachmentState,
-                                                      uint64_t* debugGroupStackSize,
-                                                      const char* disallowedMessage) {
-            switch (type) {
-                case Command::Draw: {
-                    commands->NextCommand<DrawCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDraw());
-                } break;
-
-                case Command::DrawIndexed: {
-                    commands->NextCommand<DrawIndexedCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDrawIndexed());
-                } break;
-
-                case Command::DrawIndirect: {
-                    commands->NextCommand<DrawIndirectCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDraw());
-                } break;
-
-                case Command::DrawIndexedIndirect: {
-                    commands->NextCommand<DrawIndexedIndirectCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDrawIndexed());
-                } break;
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                } break;
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(*debugGroupStackSize));
-                    *debugGroupStackSize -= 1;
-                } break;
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    *debugGroupStackSize += 1;
-                } break;
-
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = commands->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipelineBase* pipeline = cmd->pipeline.Get();
-
-                    if (DAWN_UNLIKELY(pipeline->GetAttachmentState() != attachmentState)) {
-                        return DAWN_VALIDATION_ERROR("Pipeline attachment state is not compatible");
-                    }
-                    commandBufferState->SetRenderPipeline(pipeline);
-                } break;
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-
-                    commandBufferState->SetBindGroup(cmd->index, cmd->group.Get());
-                } break;
-
-                case Command::SetIndexBuffer: {
-                    commands->NextCommand<SetIndexBufferCmd>();
-                    commandBufferState->SetIndexBuffer();
-                } break;
-
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = commands->NextCommand<SetVertexBufferCmd>();
-                    commandBufferState->SetVertexBuffer(cmd->slot);
-                } break;
-
-                default:
-                    return DAWN_VALIDATION_ERROR(disallowedMessage);
-            }
-
-            return {};
-        }
-
-    }  // namespace
-
     MaybeError ValidateCanPopDebugGroup(uint64_t debugGroupStackSize) {
         if (debugGroupStackSize == 0) {
             return DAWN_VALIDATION_ERROR("Pop must be balanced by a corresponding Push.");
@@ -123,202 +37,6 @@ namespace dawn_native {
         return {};
     }
 
-    MaybeError ValidateRenderBundle(CommandIterator* commands,
-                                    const AttachmentState* attachmentState) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
-
-        Command type;
-        while (commands->NextCommandId(&type)) {
-            DAWN_TRY(ValidateRenderBundleCommand(commands, type, &commandBufferState,
-                                                 attachmentState, &debugGroupStackSize,
-                                                 "Command disallowed inside a render bundle"));
-        }
-
-        DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-        return {};
-    }
-
-    MaybeError ValidateRenderPass(CommandIterator* commands, const BeginRenderPassCmd* renderPass) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
-
-        Command type;
-        while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    commands->NextCommand<EndRenderPassCmd>();
-                    DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-                    return {};
-                } break;
-
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = commands->NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = commands->NextData<Ref<RenderBundleBase>>(cmd->count);
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        if (DAWN_UNLIKELY(renderPass->attachmentState.Get() !=
-                                          bundles[i]->GetAttachmentState())) {
-                            return DAWN_VALIDATION_ERROR(
-                                "Render bundle is not compatible with render pass");
-                        }
-                    }
-
-                    if (cmd->count > 0) {
-                        // Reset state. It is invalidated after render bundle execution.
-                        commandBufferState = CommandBufferStateTracker{};
-                    }
-
-                } break;
-
-                case Command::SetStencilReference: {
-                    commands->NextCommand<SetStencilReferenceCmd>();
-                } break;
-
-                case Command::SetBlendColor: {
-                    commands->NextCommand<SetBlendColorCmd>();
-                } break;
-
-                case Command::SetViewport: {
-                    commands->NextCommand<SetViewportCmd>();
-                } break;
-
-                case Command::SetScissorRect: {
-                    commands->NextCommand<SetScissorRectCmd>();
-                } break;
-
-                default:
-                    DAWN_TRY(ValidateRenderBundleCommand(
-                        commands, type, &commandBufferState, renderPass->attachmentState.Get(),
-                        &debugGroupStackSize, "Command disallowed inside a render pass"));
-            }
-        }
-
-        UNREACHABLE();
-        return DAWN_VALIDATION_ERROR("Unfinished render pass");
-    }
-
-    MaybeError ValidateComputePass(CommandIterator* commands) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
-
-        Command type;
-        while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndComputePass: {
-                    commands->NextCommand<EndComputePassCmd>();
-                    DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-                    return {};
-                } break;
-
-                case Command::Dispatch: {
-                    commands->NextCommand<DispatchCmd>();
-                    DAWN_TRY(commandBufferState.ValidateCanDispatch());
-                } break;
-
-                case Command::DispatchIndirect: {
-                    commands->NextCommand<DispatchIndirectCmd>();
-                    DAWN_TRY(commandBufferState.ValidateCanDispatch());
-                } break;
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                } break;
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(debugGroupStackSize));
-                    debugGroupStackSize--;
-                } break;
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    debugGroupStackSize++;
-                } break;
-
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = commands->NextCommand<SetComputePipelineCmd>();
-                    ComputePipelineBase* pipeline = cmd->pipeline.Get();
-                    commandBufferState.SetComputePipeline(pipeline);
-                } break;
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    commandBufferState.SetBindGroup(cmd->index, cmd->group.Get());
-                } break;
-
-                default:
-                    return DAWN_VALIDATION_ERROR("Command disallowed inside a compute pass");
-            }
-        }
-
-        UNREACHABLE();
-        return DAWN_VALIDATION_ERROR("Unfinished compute pass");
-    }
-
-    MaybeError ValidateRayTracingPass(CommandIterator* commands) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
-
-        Command type;
-        while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRayTracingPass: {
-                    commands->NextCommand<EndRayTracingPassCmd>();
-                    DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-                    return {};
-                } break;
-
-                case Command::TraceRays: {
-                    commands->NextCommand<TraceRaysCmd>();
-                    DAWN_TRY(commandBufferState.ValidateCanTraceRays());
-                } break;
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                } break;
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(debugGroupStackSize));
-                    debugGroupStackSize--;
-                } break;
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    debugGroupStackSize++;
-                } break;
-
-                case Command::SetRayTracingPipeline: {
-                    SetRayTracingPipelineCmd* cmd =
-                        commands->NextCommand<SetRayTracingPipelineCmd>();
-                    RayTracingPipelineBase* pipeline = cmd->pipeline.Get();
-                    commandBufferState.SetRayTracingPipeline(pipeline);
-                } break;
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    commandBufferState.SetBindGroup(cmd->index, cmd->group.Get());
-                } break;
-
-                default:
-                    return DAWN_VALIDATION_ERROR("Command disallowed inside a ray tracing pass");
-            }
-        }
-
-        UNREACHABLE();
-        return DAWN_VALIDATION_ERROR("Unfinished ray tracing pass");
-    }
-
     // Performs the per-pass usage validation checks
     // This will eventually need to differentiate between render and compute passes.
     // It will be valid to use a buffer both as uniform and storage in the same compute pass.
@@ -361,4 +79,98 @@ namespace dawn_native {
         return {};
     }
 
+    MaybeError ValidateQueryWrite(const QuerySetBase* querySet,
+                                  uint32_t queryIndex,
+                                  wgpu::QueryType queryType) {
+        if (querySet->GetQueryType() != queryType) {
+            return DAWN_VALIDATION_ERROR("Query set has the wrong query type");
+        }
+        if (queryIndex >= querySet->GetQueryCount()) {
+            return DAWN_VALIDATION_ERROR("Query index out of bounds");
+        }
+        return {};
+    }
+
+    MaybeError ValidateCopySizeFitsInTexture(const TextureCopy& textureCopy,
+                                             const Extent3D& copySize) {
+        const TextureBase* texture = textureCopy.texture.Get();
+        if (textureCopy.mipLevel >= texture->GetNumMipLevels()) {
+            return DAWN_VALIDATION_ERROR("Copy mipLevel out of range");
+        }
+
+        if (textureCopy.arrayLayer >= texture->GetArrayLayers()) {
+            return DAWN_VALIDATION_ERROR("Copy arrayLayer out of range");
+        }
+
+        Extent3D extent = texture->GetMipLevelPhysicalSize(textureCopy.mipLevel);
+
+        // All texture dimensions are in uint32_t so by doing checks in uint64_t we avoid
+        // overflows.
+        if (uint64_t(textureCopy.origin.x) + uint64_t(copySize.width) >
+                static_cast<uint64_t>(extent.width) ||
+            uint64_t(textureCopy.origin.y) + uint64_t(copySize.height) >
+                static_cast<uint64_t>(extent.height)) {
+            return DAWN_VALIDATION_ERROR("Copy would touch outside of the texture");
+        }
+
+        // TODO(cwallez@chromium.org): Check the depth bound differently for 2D arrays and 3D
+        // textures
+        if (textureCopy.origin.z != 0 || copySize.depth > 1) {
+            return DAWN_VALIDATION_ERROR("No support for z != 0 and depth > 1 for now");
+        }
+
+        return {};
+    }
+
+    MaybeError ValidateImageHeight(const Format& format,
+                                   uint32_t imageHeight,
+                                   uint32_t copyHeight) {
+        if (imageHeight < copyHeight) {
+            return DAWN_VALIDATION_ERROR("Image height must not be less than the copy height.");
+        }
+
+        if (imageHeight % format.blockHeight != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Image height must be a multiple of compressed texture format block width");
+        }
+
+        return {};
+    }
+
+    MaybeError ValidateTextureSampleCountInCopyCommands(const TextureBase* texture) {
+        if (texture->GetSampleCount() > 1) {
+            return DAWN_VALIDATION_ERROR("The sample count of textures must be 1");
+        }
+
+        return {};
+    }
+
+    MaybeError ValidateImageOrigin(const Format& format, const Origin3D& offset) {
+        if (offset.x % format.blockWidth != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Offset.x must be a multiple of compressed texture format block width");
+        }
+
+        if (offset.y % format.blockHeight != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Offset.y must be a multiple of compressed texture format block height");
+        }
+
+        return {};
+    }
+
+    MaybeError ValidateImageCopySize(const Format& format, const Extent3D& extent) {
+        if (extent.width % format.blockWidth != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Extent.width must be a multiple of compressed texture format block width");
+        }
+
+        if (extent.height % format.blockHeight != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Extent.height must be a multiple of compressed texture format block height");
+        }
+
+        return {};
+    }
+
 }  // namespace dawn_native
@@ -15,28 +15,37 @@
 #ifndef DAWNNATIVE_COMMANDVALIDATION_H_
 #define DAWNNATIVE_COMMANDVALIDATION_H_
 
-#include "dawn_native/CommandAllocator.h"
 #include "dawn_native/Error.h"
 
-#include <vector>
+#include "dawn_native/dawn_platform.h"
 
 namespace dawn_native {
 
-    class AttachmentState;
-    struct BeginRenderPassCmd;
+    class QuerySetBase;
+    class TextureBase;
+    struct Format;
     struct PassResourceUsage;
+    struct TextureCopy;
 
     MaybeError ValidateCanPopDebugGroup(uint64_t debugGroupStackSize);
     MaybeError ValidateFinalDebugGroupStackSize(uint64_t debugGroupStackSize);
 
-    MaybeError ValidateRenderBundle(CommandIterator* commands,
-                                    const AttachmentState* attachmentState);
-    MaybeError ValidateRenderPass(CommandIterator* commands, const BeginRenderPassCmd* renderPass);
-    MaybeError ValidateComputePass(CommandIterator* commands);
-    MaybeError ValidateRayTracingPass(CommandIterator* commands);
-
     MaybeError ValidatePassResourceUsage(const PassResourceUsage& usage);
 
+    // Checks that a query of the given type can be written to querySet at queryIndex.
+    MaybeError ValidateQueryWrite(const QuerySetBase* querySet,
+                                  uint32_t queryIndex,
+                                  wgpu::QueryType queryType);
+
+    // The checks on the texture side of copies, shared by the copy commands and
+    // Queue::WriteTexture.
+    MaybeError ValidateCopySizeFitsInTexture(const TextureCopy& textureCopy,
+                                             const Extent3D& copySize);
+    MaybeError ValidateImageHeight(const Format& format, uint32_t imageHeight, uint32_t copyHeight);
+    MaybeError ValidateTextureSampleCountInCopyCommands(const TextureBase* texture);
+    MaybeError ValidateImageOrigin(const Format& format, const Origin3D& offset);
+    MaybeError ValidateImageCopySize(const Format& format, const Extent3D& extent);
+
 }  // namespace dawn_native
 
 #endif  // DAWNNATIVE_COMMANDVALIDATION_H_
@@ -18,7 +18,9 @@
 #include "dawn_native/Buffer.h"
 #include "dawn_native/CommandAllocator.h"
 #include "dawn_native/ComputePipeline.h"
+#include "dawn_native/QuerySet.h"
 #include "dawn_native/RenderBundle.h"
+#include "dawn_native/RayTracingBundle.h"
 #include "dawn_native/RayTracingPipeline.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
 #include "dawn_native/RenderPipeline.h"
@@ -36,6 +38,20 @@ namespace dawn_native {
                     BeginComputePassCmd* begin = commands->NextCommand<BeginComputePassCmd>();
                     begin->~BeginComputePassCmd();
                 } break;
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* begin =
+                        commands->NextCommand<BeginConditionalRenderingCmd>();
+                    begin->~BeginConditionalRenderingCmd();
+                } break;
+                case Command::BeginOcclusionQuery: {
+                    BeginOcclusionQueryCmd* begin = commands->NextCommand<BeginOcclusionQueryCmd>();
+                    begin->~BeginOcclusionQueryCmd();
+                } break;
+                case Command::BeginPipelineStatisticsQuery: {
+                    BeginPipelineStatisticsQueryCmd* begin =
+                        commands->NextCommand<BeginPipelineStatisticsQueryCmd>();
+                    begin->~BeginPipelineStatisticsQueryCmd();
+                } break;
                 case Command::BeginRayTracingPass: {
                     BeginRayTracingPassCmd* begin = commands->NextCommand<BeginRayTracingPassCmd>();
                     begin->~BeginRayTracingPassCmd();
@@ -49,6 +65,21 @@ namespace dawn_native {
                         commands->NextCommand<BuildRayTracingAccelerationContainerCmd>();
                     build->~BuildRayTracingAccelerationContainerCmd();
                 } break;
+                case Command::BuildRayTracingAccelerationContainers: {
+                    BuildRayTracingAccelerationContainersCmd* build =
+                        commands->NextCommand<BuildRayTracingAccelerationContainersCmd>();
+                    auto containers =
+                        commands->NextData<Ref<RayTracingAccelerationContainerBase>>(build->count);
+                    for (size_t i = 0; i < build->count; ++i) {
+                        (&containers[i])->~Ref<RayTracingAccelerationContainerBase>();
+                    }
+                    build->~BuildRayTracingAccelerationContainersCmd();
+                } break;
+                case Command::CompactRayTracingAccelerationContainer: {
+                    CompactRayTracingAccelerationContainerCmd* compact =
+                        commands->NextCommand<CompactRayTracingAccelerationContainerCmd>();
+                    compact->~CompactRayTracingAccelerationContainerCmd();
+                } break;
                 case Command::CopyRayTracingAccelerationContainer: {
                     CopyRayTracingAccelerationContainerCmd* build =
                         commands->NextCommand<CopyRayTracingAccelerationContainerCmd>();
@@ -104,6 +135,20 @@ namespace dawn_native {
                     EndComputePassCmd* cmd = commands->NextCommand<EndComputePassCmd>();
                     cmd->~EndComputePassCmd();
                 } break;
+                case Command::EndConditionalRendering: {
+                    EndConditionalRenderingCmd* cmd =
+                        commands->NextCommand<EndConditionalRenderingCmd>();
+                    cmd->~EndConditionalRenderingCmd();
+                } break;
+                case Command::EndOcclusionQuery: {
+                    EndOcclusionQueryCmd* cmd = commands->NextCommand<EndOcclusionQueryCmd>();
+                    cmd->~EndOcclusionQueryCmd();
+                } break;
+                case Command::EndPipelineStatisticsQuery: {
+                    EndPipelineStatisticsQueryCmd* cmd =
+                        commands->NextCommand<EndPipelineStatisticsQueryCmd>();
+                    cmd->~EndPipelineStatisticsQueryCmd();
+                } break;
                 case Command::EndRayTracingPass: {
                     EndRayTracingPassCmd* cmd = commands->NextCommand<EndRayTracingPassCmd>();
                     cmd->~EndRayTracingPassCmd();
@@ -120,6 +165,19 @@ namespace dawn_native {
                     }
                     cmd->~ExecuteBundlesCmd();
                 } break;
+                case Command::ExecuteRayTracingBundles: {
+                    ExecuteRayTracingBundlesCmd* cmd =
+                        commands->NextCommand<ExecuteRayTracingBundlesCmd>();
+                    auto bundles = commands->NextData<Ref<RayTracingBundleBase>>(cmd->count);
+                    for (size_t i = 0; i < cmd->count; ++i) {
+                        (&bundles[i])->~Ref<RayTracingBundleBase>();
+                    }
+                    cmd->~ExecuteRayTracingBundlesCmd();
+                } break;
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = commands->NextCommand<GenerateMipmapsCmd>();
+                    cmd->~GenerateMipmapsCmd();
+                } break;
                 case Command::InsertDebugMarker: {
                     InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
                     commands->NextData<char>(cmd->length + 1);
@@ -134,6 +192,10 @@ namespace dawn_native {
                     commands->NextData<char>(cmd->length + 1);
                     cmd->~PushDebugGroupCmd();
                 } break;
+                case Command::ResolveQuerySet: {
+                    ResolveQuerySetCmd* cmd = commands->NextCommand<ResolveQuerySetCmd>();
+                    cmd->~ResolveQuerySetCmd();
+                } break;
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = commands->NextCommand<SetComputePipelineCmd>();
                     cmd->~SetComputePipelineCmd();
@@ -165,11 +227,14 @@ namespace dawn_native {
                 } break;
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    NextDynamicOffsets(commands, cmd);
                     cmd->~SetBindGroupCmd();
                 } break;
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = commands->NextCommand<SetPushConstantsCmd>();
+                    commands->NextData<uint8_t>(cmd->size);
+                    cmd->~SetPushConstantsCmd();
+                } break;
                 case Command::SetIndexBuffer: {
                     SetIndexBufferCmd* cmd = commands->NextCommand<SetIndexBufferCmd>();
                     cmd->~SetIndexBufferCmd();
@@ -182,6 +247,10 @@ namespace dawn_native {
                     TraceRaysCmd* cmd = commands->NextCommand<TraceRaysCmd>();
                     cmd->~TraceRaysCmd();
                 } break;
+                case Command::WriteTimestamp: {
+                    WriteTimestampCmd* cmd = commands->NextCommand<WriteTimestampCmd>();
+                    cmd->~WriteTimestampCmd();
+                } break;
             }
         }
         commands->DataWasDestroyed();
@@ -193,6 +262,18 @@ namespace dawn_native {
                 commands->NextCommand<BeginComputePassCmd>();
                 break;
 
+            case Command::BeginConditionalRendering:
+                commands->NextCommand<BeginConditionalRenderingCmd>();
+                break;
+
+            case Command::BeginOcclusionQuery:
+                commands->NextCommand<BeginOcclusionQueryCmd>();
+                break;
+
+            case Command::BeginPipelineStatisticsQuery:
+                commands->NextCommand<BeginPipelineStatisticsQueryCmd>();
+                break;
+
             case Command::BeginRayTracingPass:
                 commands->NextCommand<BeginRayTracingPassCmd>();
                 break;
@@ -205,6 +286,15 @@ namespace dawn_native {
                 commands->NextCommand<BuildRayTracingAccelerationContainerCmd>();
                 break;
 
+            case Command::BuildRayTracingAccelerationContainers: {
+                auto* cmd = commands->NextCommand<BuildRayTracingAccelerationContainersCmd>();
+                commands->NextData<Ref<RayTracingAccelerationContainerBase>>(cmd->count);
+            } break;
+
+            case Command::CompactRayTracingAccelerationContainer:
+                commands->NextCommand<CompactRayTracingAccelerationContainerCmd>();
+                break;
+
             case Command::CopyRayTracingAccelerationContainer:
                 commands->NextCommand<CopyRayTracingAccelerationContainerCmd>();
                 break;
@@ -257,6 +347,18 @@ namespace dawn_native {
                 commands->NextCommand<EndComputePassCmd>();
                 break;
 
+            case Command::EndConditionalRendering:
+                commands->NextCommand<EndConditionalRenderingCmd>();
+                break;
+
+            case Command::EndOcclusionQuery:
+                commands->NextCommand<EndOcclusionQueryCmd>();
+                break;
+
+            case Command::EndPipelineStatisticsQuery:
+                commands->NextCommand<EndPipelineStatisticsQueryCmd>();
+                break;
+
             case Command::EndRayTracingPass:
                 commands->NextCommand<EndRayTracingPassCmd>();
                 break;
@@ -270,6 +372,15 @@ namespace dawn_native {
                 commands->NextData<Ref<RenderBundleBase>>(cmd->count);
             } break;
 
+            case Command::ExecuteRayTracingBundles: {
+                auto* cmd = commands->NextCommand<ExecuteRayTracingBundlesCmd>();
+                commands->NextData<Ref<RayTracingBundleBase>>(cmd->count);
+            } break;
+
+            case Command::GenerateMipmaps:
+                commands->NextCommand<GenerateMipmapsCmd>();
+                break;
+
             case Command::InsertDebugMarker: {
                 InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
                 commands->NextData<char>(cmd->length + 1);
@@ -284,6 +395,10 @@ namespace dawn_native {
                 commands->NextData<char>(cmd->length + 1);
             } break;
 
+            case Command::ResolveQuerySet:
+                commands->NextCommand<ResolveQuerySetCmd>();
+                break;
+
             case Command::SetComputePipeline:
                 commands->NextCommand<SetComputePipelineCmd>();
                 break;
@@ -314,9 +429,12 @@ namespace dawn_native {
 
             case Command::SetBindGroup: {
                 SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                if (cmd->dynamicOffsetCount > 0) {
-                    commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                }
+                NextDynamicOffsets(commands, cmd);
+            } break;
+
+            case Command::SetPushConstants: {
+                SetPushConstantsCmd* cmd = commands->NextCommand<SetPushConstantsCmd>();
+                commands->NextData<uint8_t>(cmd->size);
             } break;
 
             case Command::SetIndexBuffer:
@@ -330,7 +448,65 @@ namespace dawn_native {
             case Command::TraceRays: {
                 commands->NextCommand<TraceRaysCmd>();
             } break;
+
+            case Command::WriteTimestamp:
+                commands->NextCommand<WriteTimestampCmd>();
+                break;
         }
     }
 
+    const char* GetCommandName(Command type) {
+        static constexpr const char* kCommandNames[] = {
+            "BeginComputePass",
+            "BeginConditionalRendering",
+            "BeginOcclusionQuery",
+            "BeginPipelineStatisticsQuery",
+            "BeginRayTracingPass",
+            "BeginRenderPass",
+            "BuildRayTracingAccelerationContainer",
+            "BuildRayTracingAccelerationContainers",
+            "CompactRayTracingAccelerationContainer",
+            "CopyRayTracingAccelerationContainer",
+            "UpdateRayTracingAccelerationContainer",
+            "CopyBufferToBuffer",
+            "CopyBufferToTexture",
+            "CopyTextureToBuffer",
+            "CopyTextureToTexture",
+            "Dispatch",
+            "DispatchIndirect",
+            "Draw",
+            "DrawIndexed",
+            "DrawIndirect",
+            "DrawIndexedIndirect",
+            "EndComputePass",
+            "EndConditionalRendering",
+            "EndOcclusionQuery",
+            "EndPipelineStatisticsQuery",
+            "EndRayTracingPass",
+            "EndRenderPass",
+            "ExecuteBundles",
+            "ExecuteRayTracingBundles",
+            "GenerateMipmaps",
+            "InsertDebugMarker",
+            "PopDebugGroup",
+            "PushDebugGroup",
+            "ResolveQuerySet",
+            "SetComputePipeline",
+            "SetRayTracingPipeline",
+            "SetRenderPipeline",
+            "SetStencilReference",
+            "SetViewport",
+            "SetScissorRect",
+            "SetBlendColor",
+            "SetBindGroup",
+            "SetPushConstants",
+            "SetIndexBuffer",
+            "SetVertexBuffer",
+            "TraceRays",
+            "WriteTimestamp",
+        };
+        static_assert(sizeof(kCommandNames) / sizeof(kCommandNames[0]) == kCommandTypeCount, "");
+        return kCommandNames[static_cast<size_t>(type)];
+    }
+
 }  // namespace dawn_native
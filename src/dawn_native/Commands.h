@@ -18,6 +18,7 @@
 #include "common/Constants.h"
 
 #include "dawn_native/AttachmentState.h"
+#include "dawn_native/CommandAllocator.h"
 #include "dawn_native/Texture.h"
 
 #include "dawn_native/dawn_platform.h"
@@ -30,12 +31,21 @@ namespace dawn_native {
     // Definition of the commands that are present in the CommandIterator given by the
     // CommandBufferBuilder. There are not defined in CommandBuffer.h to break some header
     // dependencies: Ref<Object> needs Object to be defined.
+    //
+    // The commands recorded many times per pass, like setting pipelines, bind groups and buffers,
+    // hold raw pointers instead of Refs. Their objects are referenced once per command buffer by
+    // EncodingContext::RetainObject.
 
     enum class Command {
         BeginComputePass,
+        BeginConditionalRendering,
+        BeginOcclusionQuery,
+        BeginPipelineStatisticsQuery,
         BeginRayTracingPass,
         BeginRenderPass,
         BuildRayTracingAccelerationContainer,
+        BuildRayTracingAccelerationContainers,
+        CompactRayTracingAccelerationContainer,
         CopyRayTracingAccelerationContainer,
         UpdateRayTracingAccelerationContainer,
         CopyBufferToBuffer,
@@ -49,12 +59,18 @@ namespace dawn_native {
         DrawIndirect,
         DrawIndexedIndirect,
         EndComputePass,
+        EndConditionalRendering,
+        EndOcclusionQuery,
+        EndPipelineStatisticsQuery,
         EndRayTracingPass,
         EndRenderPass,
         ExecuteBundles,
+        ExecuteRayTracingBundles,
+        GenerateMipmaps,
         InsertDebugMarker,
         PopDebugGroup,
         PushDebugGroup,
+        ResolveQuerySet,
         SetComputePipeline,
         SetRayTracingPipeline,
         SetRenderPipeline,
@@ -63,12 +79,37 @@ namespace dawn_native {
         SetScissorRect,
         SetBlendColor,
         SetBindGroup,
+        SetPushConstants,
         SetIndexBuffer,
         SetVertexBuffer,
-        TraceRays
+        TraceRays,
+        WriteTimestamp
+    };
+    static constexpr size_t kCommandTypeCount = static_cast<size_t>(Command::WriteTimestamp) + 1;
+
+    struct BeginComputePassCmd {
+        // The dispatches of the pass don't access the storage buffers written by its other
+        // dispatches, so the backends don't need barriers between them.
+        bool independentDispatches;
+    };
+
+    struct BeginConditionalRenderingCmd {
+        Ref<BufferBase> predicateBuffer;
+        uint64_t predicateOffset;
+        // The commands are skipped when the predicate isn't zero instead of when it is zero.
+        bool inverted;
+    };
+
+    struct BeginOcclusionQueryCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t queryIndex;
+    };
+
+    struct BeginPipelineStatisticsQueryCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t queryIndex;
     };
 
-    struct BeginComputePassCmd {};
     struct BeginRayTracingPassCmd {};
 
     struct RenderPassColorAttachmentInfo {
@@ -103,6 +144,15 @@ namespace dawn_native {
         Ref<RayTracingAccelerationContainerBase> container;
     };
 
+    struct BuildRayTracingAccelerationContainersCmd {
+        uint32_t count;
+    };
+
+    struct CompactRayTracingAccelerationContainerCmd {
+        Ref<RayTracingAccelerationContainerBase> srcContainer;
+        Ref<RayTracingAccelerationContainerBase> dstContainer;
+    };
+
     struct CopyRayTracingAccelerationContainerCmd {
         Ref<RayTracingAccelerationContainerBase> srcContainer;
         Ref<RayTracingAccelerationContainerBase> dstContainer;
@@ -152,6 +202,13 @@ namespace dawn_native {
         Extent3D copySize;  // Texels
     };
 
+    // Generates the levels after baseMipLevel from it, for all the array layers.
+    struct GenerateMipmapsCmd {
+        Ref<TextureBase> texture;
+        uint32_t baseMipLevel;
+        uint32_t mipLevelCount;
+    };
+
     struct DispatchCmd {
         uint32_t x;
         uint32_t y;
@@ -159,7 +216,7 @@ namespace dawn_native {
     };
 
     struct DispatchIndirectCmd {
-        Ref<BufferBase> indirectBuffer;
+        BufferBase* indirectBuffer;
         uint64_t indirectOffset;
     };
 
@@ -179,17 +236,31 @@ namespace dawn_native {
     };
 
     struct DrawIndirectCmd {
-        Ref<BufferBase> indirectBuffer;
+        BufferBase* indirectBuffer;
         uint64_t indirectOffset;
+        // The number of draws packed in the indirect buffer, or the maximum number of draws if
+        // the count is read from countBuffer.
+        uint32_t drawCount;
+        BufferBase* countBuffer;
+        uint64_t countBufferOffset;
     };
 
-    struct DrawIndexedIndirectCmd {
-        Ref<BufferBase> indirectBuffer;
-        uint64_t indirectOffset;
-    };
+    struct DrawIndexedIndirectCmd : DrawIndirectCmd {};
 
     struct EndComputePassCmd {};
 
+    struct EndConditionalRenderingCmd {};
+
+    struct EndOcclusionQueryCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t queryIndex;
+    };
+
+    struct EndPipelineStatisticsQueryCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t queryIndex;
+    };
+
     struct EndRayTracingPassCmd {};
 
     struct EndRenderPassCmd {};
@@ -198,6 +269,10 @@ namespace dawn_native {
         uint32_t count;
     };
 
+    struct ExecuteRayTracingBundlesCmd {
+        uint32_t count;
+    };
+
     struct InsertDebugMarkerCmd {
         uint32_t length;
     };
@@ -208,16 +283,24 @@ namespace dawn_native {
         uint32_t length;
     };
 
+    struct ResolveQuerySetCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t firstQuery;
+        uint32_t queryCount;
+        Ref<BufferBase> destination;
+        uint64_t destinationOffset;
+    };
+
     struct SetComputePipelineCmd {
-        Ref<ComputePipelineBase> pipeline;
+        ComputePipelineBase* pipeline;
     };
 
     struct SetRayTracingPipelineCmd {
-        Ref<RayTracingPipelineBase> pipeline;
+        RayTracingPipelineBase* pipeline;
     };
 
     struct SetRenderPipelineCmd {
-        Ref<RenderPipelineBase> pipeline;
+        RenderPipelineBase* pipeline;
     };
 
     struct SetStencilReferenceCmd {
@@ -236,20 +319,44 @@ namespace dawn_native {
         Color color;
     };
 
+    // Bind groups are often set with one or two dynamic offsets before each draw, so that many
+    // are stored in the command itself, in what would otherwise be padding. When there are more,
+    // the command is followed by |dynamicOffsetCount| uint32_t of data instead.
+    static constexpr uint32_t kMaxInlineDynamicOffsets = 2;
     struct SetBindGroupCmd {
         uint32_t index;
-        Ref<BindGroupBase> group;
         uint32_t dynamicOffsetCount;
+        BindGroupBase* group;
+        uint32_t inlineDynamicOffsets[kMaxInlineDynamicOffsets];
+    };
+
+    // Returns the dynamic offsets of the command, or nullptr if it has none. Must be called
+    // right after getting the command from the iterator.
+    inline uint32_t* NextDynamicOffsets(CommandIterator* commands, SetBindGroupCmd* cmd) {
+        if (cmd->dynamicOffsetCount == 0) {
+            return nullptr;
+        }
+        if (cmd->dynamicOffsetCount <= kMaxInlineDynamicOffsets) {
+            return cmd->inlineDynamicOffsets;
+        }
+        return commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
+    }
+
+    // Followed by |size| bytes of data.
+    struct SetPushConstantsCmd {
+        wgpu::ShaderStage stages;
+        uint32_t offset;
+        uint32_t size;
     };
 
     struct SetIndexBufferCmd {
-        Ref<BufferBase> buffer;
+        BufferBase* buffer;
         uint64_t offset;
     };
 
     struct SetVertexBufferCmd {
         uint32_t slot;
-        Ref<BufferBase> buffer;
+        BufferBase* buffer;
         uint64_t offset;
     };
 
@@ -260,6 +367,12 @@ namespace dawn_native {
         uint32_t width;
         uint32_t height;
         uint32_t depth;
+        uint32_t rayCallableOffset;
+    };
+
+    struct WriteTimestampCmd {
+        Ref<QuerySetBase> querySet;
+        uint32_t queryIndex;
     };
 
     // This needs to be called before the CommandIterator is freed so that the Ref<> present in
@@ -271,6 +384,8 @@ namespace dawn_native {
     // consuming the correct amount of data from the command iterator.
     void SkipCommand(CommandIterator* commands, Command type);
 
+    const char* GetCommandName(Command type);
+
 }  // namespace dawn_native
 
 #endif  // DAWNNATIVE_COMMANDS_H_
@@ -0,0 +1,212 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/CompletionThread.h"
+
+#include "common/Compiler.h"
+#include "common/Platform.h"
+#include "dawn_native/Device.h"
+
+#include <condition_variable>
+#include <mutex>
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+#    include "common/windows_with_undefs.h"
+#elif defined(DAWN_PLATFORM_POSIX)
+#    include <unistd.h>
+#endif
+
+namespace dawn_native {
+
+    namespace {
+
+        // The backend waits are bounded so that StopWaiting doesn't wait for the GPU.
+        constexpr uint64_t kWaitTimeoutNs = 50ull * 1000ull * 1000ull;  // 50ms
+
+    }  // anonymous namespace
+
+    // The state is shared with the thread and the tasks given to the executor, which can outlive
+    // the CompletionThread.
+    struct CompletionThread::State {
+        CompletionThreadDescriptor descriptor;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+        bool tickRequested = false;
+        bool hasWaitSerial = false;
+        Serial waitSerial = 0;
+        // Whether a task was given to the executor and didn't start running yet.
+        bool taskPending = false;
+
+        // Held by the thread while it waits on the backend.
+        std::mutex waitMutex;
+
+        // Guards the device the tasks tick. Recursive because the device can be destroyed by a
+        // callback called from the tick.
+        std::recursive_mutex deviceMutex;
+        DeviceBase* device = nullptr;
+    };
+
+    CompletionThread::CompletionThread(DeviceBase* device,
+                                       const CompletionThreadDescriptor& descriptor)
+        : mState(std::make_shared<State>()) {
+        mState->descriptor = descriptor;
+        mState->device = device;
+        mThread = std::thread(ThreadLoop, mState, device);
+    }
+
+    CompletionThread::~CompletionThread() {
+        StopWaiting();
+        {
+            std::lock_guard<std::recursive_mutex> lock(mState->deviceMutex);
+            mState->device = nullptr;
+        }
+
+        // The device can be destroyed by a task which an executor runs on the completion thread.
+        if (mThread.get_id() == std::this_thread::get_id()) {
+            mThread.detach();
+        } else {
+            mThread.join();
+        }
+    }
+
+    void CompletionThread::RequestTick() {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        mState->tickRequested = true;
+        mState->condition.notify_one();
+    }
+
+    void CompletionThread::DidTick(Serial completedSerial,
+                                   Serial lastSubmittedSerial,
+                                   bool hasPendingCallbacks) {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        mState->hasWaitSerial = false;
+        if (!hasPendingCallbacks) {
+            return;
+        }
+
+        // Callbacks waiting on serials that already completed need another tick, for example
+        // when the device completed a serial without GPU work.
+        if (completedSerial >= lastSubmittedSerial) {
+            mState->tickRequested = true;
+        } else {
+            mState->hasWaitSerial = true;
+            mState->waitSerial = lastSubmittedSerial;
+        }
+        mState->condition.notify_one();
+    }
+
+    void CompletionThread::StopWaiting() {
+        {
+            std::lock_guard<std::mutex> lock(mState->mutex);
+            mState->stopping = true;
+            mState->condition.notify_one();
+        }
+        // The thread checks that it isn't stopping before each wait, with the wait lock held.
+        std::lock_guard<std::mutex> waitLock(mState->waitMutex);
+    }
+
+    // static
+    void CompletionThread::ThreadLoop(std::shared_ptr<State> state, DeviceBase* device) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (true) {
+            state->condition.wait(lock, [&state] {
+                return state->stopping || state->tickRequested || state->hasWaitSerial;
+            });
+            if (state->stopping) {
+                return;
+            }
+
+            if (!state->tickRequested) {
+                Serial serial = state->waitSerial;
+                lock.unlock();
+
+                bool completed = false;
+                {
+                    std::lock_guard<std::mutex> waitLock(state->waitMutex);
+                    bool stopping;
+                    {
+                        std::lock_guard<std::mutex> stoppingLock(state->mutex);
+                        stopping = state->stopping;
+                    }
+                    if (!stopping) {
+                        completed = device->WaitForSerialFromCompletionThread(serial,
+                                                                              kWaitTimeoutNs);
+                    }
+                }
+
+                lock.lock();
+                // Wait again if the device ticked in the meantime and waits for another serial.
+                if (!completed || !state->hasWaitSerial || state->waitSerial != serial) {
+                    continue;
+                }
+            }
+
+            // The next tick tells what to wait for next.
+            state->tickRequested = false;
+            state->hasWaitSerial = false;
+
+            // A task that didn't start yet ticks the device after what we were waiting for.
+            if (state->taskPending) {
+                continue;
+            }
+            state->taskPending = state->descriptor.executor != nullptr;
+
+            lock.unlock();
+            Notify(state);
+            lock.lock();
+        }
+    }
+
+    // static
+    void CompletionThread::Notify(const std::shared_ptr<State>& state) {
+        const CompletionThreadDescriptor& descriptor = state->descriptor;
+        if (descriptor.executor != nullptr) {
+            descriptor.executor(TickDeviceTask, new std::shared_ptr<State>(state),
+                                descriptor.executorUserdata);
+        }
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+        if (descriptor.win32Event != nullptr) {
+            SetEvent(static_cast<HANDLE>(descriptor.win32Event));
+        }
+#elif defined(DAWN_PLATFORM_POSIX)
+        if (descriptor.eventFd >= 0) {
+            uint64_t value = 1;
+            ssize_t written = write(descriptor.eventFd, &value, sizeof(value));
+            DAWN_UNUSED(written);
+        }
+#endif
+    }
+
+    // static
+    void CompletionThread::TickDeviceTask(void* taskData) {
+        std::unique_ptr<std::shared_ptr<State>> statePointer(
+            static_cast<std::shared_ptr<State>*>(taskData));
+        State* state = statePointer->get();
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->taskPending = false;
+        }
+
+        std::lock_guard<std::recursive_mutex> deviceLock(state->deviceMutex);
+        if (state->device != nullptr) {
+            DeviceLock lock(state->device->GetMutex());
+            state->device->Tick();
+        }
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,60 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_COMPLETIONTHREAD_H_
+#define DAWNNATIVE_COMPLETIONTHREAD_H_
+
+#include "common/Serial.h"
+#include "dawn_native/DawnNative.h"
+
+#include <memory>
+#include <thread>
+
+namespace dawn_native {
+
+    class DeviceBase;
+
+    // Waits on the GPU for the callbacks of a device to be ready and notifies the application
+    // that it should tick the device, so that the application doesn't need to poll. The device
+    // reports after each tick its serials and whether callbacks are still pending, the thread is
+    // idle when none are.
+    class CompletionThread {
+      public:
+        CompletionThread(DeviceBase* device, const CompletionThreadDescriptor& descriptor);
+        // Tasks that were given to the executor but didn't run yet don't tick the device anymore
+        // once the completion thread is destroyed.
+        ~CompletionThread();
+
+        // Notifies the application right away, for callbacks which were added since the last
+        // tick and wait for commands that are only submitted by the next tick.
+        void RequestTick();
+        void DidTick(Serial completedSerial, Serial lastSubmittedSerial, bool hasPendingCallbacks);
+
+        // Stops waiting on the backend, after which the backend objects the thread waited on can
+        // be destroyed. Tasks given to the executor still tick the device.
+        void StopWaiting();
+
+      private:
+        struct State;
+        static void ThreadLoop(std::shared_ptr<State> state, DeviceBase* device);
+        static void Notify(const std::shared_ptr<State>& state);
+        static void TickDeviceTask(void* taskData);
+
+        std::shared_ptr<State> mState;
+        std::thread mThread;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_COMPLETIONTHREAD_H_
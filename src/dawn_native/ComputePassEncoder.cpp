@@ -44,6 +44,8 @@ namespace dawn_native {
 
     void ComputePassEncoder::EndPass() {
         if (mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+                DAWN_TRY(ValidateProgrammableEncoderEnd());
+
                 allocator->Allocate<EndComputePassCmd>(Command::EndComputePass);
 
                 return {};
@@ -54,6 +56,10 @@ namespace dawn_native {
 
     void ComputePassEncoder::Dispatch(uint32_t x, uint32_t y, uint32_t z) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(mCommandBufferState.ValidateCanDispatch());
+            }
+
             DispatchCmd* dispatch = allocator->Allocate<DispatchCmd>(Command::Dispatch);
             dispatch->x = x;
             dispatch->y = y;
@@ -72,13 +78,30 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR("Indirect offset out of bounds");
             }
 
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(mCommandBufferState.ValidateCanDispatch());
+            }
+
+            // The arguments are read as words of a storage buffer by the validation pass.
+            const bool validatesArguments = mEncodingContext->ValidatesIndirectArguments();
+            if (validatesArguments && indirectOffset % 4 != 0) {
+                return DAWN_VALIDATION_ERROR("Indirect offset must be a multiple of 4");
+            }
+
             DispatchIndirectCmd* dispatch =
                 allocator->Allocate<DispatchIndirectCmd>(Command::DispatchIndirect);
             dispatch->indirectBuffer = indirectBuffer;
+            mEncodingContext->RetainObject(indirectBuffer);
             dispatch->indirectOffset = indirectOffset;
 
             mUsageTracker.BufferUsedAs(indirectBuffer, wgpu::BufferUsage::Indirect);
 
+            if (validatesArguments) {
+                mEncodingContext->AddIndirectValidation(
+                    {indirectBuffer, indirectOffset, false, 1, kMaxComputeWorkgroupsPerDimension,
+                     &dispatch->indirectBuffer, &dispatch->indirectOffset});
+            }
+
             return {};
         });
     }
@@ -90,6 +113,9 @@ namespace dawn_native {
             SetComputePipelineCmd* cmd =
                 allocator->Allocate<SetComputePipelineCmd>(Command::SetComputePipeline);
             cmd->pipeline = pipeline;
+            mEncodingContext->RetainObject(pipeline);
+
+            mCommandBufferState.SetComputePipeline(pipeline);
 
             return {};
         });
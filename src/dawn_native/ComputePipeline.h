@@ -31,7 +31,7 @@ namespace dawn_native {
 
         static ComputePipelineBase* MakeError(DeviceBase* device);
 
-        // Functors necessary for the unordered_set<ComputePipelineBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<ComputePipelineBase>.
         struct HashFunc {
             size_t operator()(const ComputePipelineBase* pipeline) const;
         };
@@ -0,0 +1,151 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_CONTENTLESSOBJECTCACHE_H_
+#define DAWNNATIVE_CONTENTLESSOBJECTCACHE_H_
+
+#include "common/Assert.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dawn_native {
+
+    // A set of pointers to objects which are compared by their content, used for the device's
+    // caches of deduplicated objects. The content hash of the objects is computed once by the
+    // caller and given with each operation: it is stored next to the pointer so that lookups
+    // compare hashes before the deep equality and that the table grows without hashing the
+    // objects again. The objects keep their own hash to be erased, as their content may already
+    // be partially destroyed at that point.
+    //
+    // The table is a flat array probed linearly, erasing shifts the following entries of the
+    // probe sequence back so that no tombstones accumulate.
+    template <typename Object, typename EqualityFunc = typename Object::EqualityFunc>
+    class ContentLessObjectCache {
+      public:
+        ContentLessObjectCache() = default;
+        ContentLessObjectCache(const ContentLessObjectCache&) = delete;
+        ContentLessObjectCache& operator=(const ContentLessObjectCache&) = delete;
+
+        // Returns the object equal to the blueprint, or nullptr.
+        Object* Find(const Object* blueprint, size_t hash) const {
+            if (mSize == 0) {
+                return nullptr;
+            }
+            for (size_t i = GetHomeIndex(hash); mSlots[i].object != nullptr; i = Next(i)) {
+                if (mSlots[i].hash == hash && EqualityFunc()(mSlots[i].object, blueprint)) {
+                    return mSlots[i].object;
+                }
+            }
+            return nullptr;
+        }
+
+        // The object must not be equal to any object of the cache.
+        void Insert(Object* object, size_t hash) {
+            ASSERT(object != nullptr);
+            ASSERT(Find(object, hash) == nullptr);
+
+            if ((mSize + 1) * kMaxLoadDenominator > mSlots.size() * kMaxLoadNumerator) {
+                Grow();
+            }
+            InsertSlot({hash, object});
+            mSize++;
+        }
+
+        // Erases this exact object, returns whether it was in the cache.
+        bool Erase(const Object* object, size_t hash) {
+            if (mSize == 0) {
+                return false;
+            }
+
+            size_t i = GetHomeIndex(hash);
+            while (mSlots[i].object != object) {
+                if (mSlots[i].object == nullptr) {
+                    return false;
+                }
+                i = Next(i);
+            }
+
+            // Move back the entries which can't be found anymore once slot |i| is freed, that is
+            // the ones whose home index isn't cyclically in (i, j].
+            for (size_t j = Next(i); mSlots[j].object != nullptr; j = Next(j)) {
+                size_t home = GetHomeIndex(mSlots[j].hash);
+                bool reachable = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+                if (!reachable) {
+                    mSlots[i] = mSlots[j];
+                    i = j;
+                }
+            }
+            mSlots[i] = {};
+            mSize--;
+            return true;
+        }
+
+        bool Empty() const {
+            return mSize == 0;
+        }
+
+        size_t Size() const {
+            return mSize;
+        }
+
+      private:
+        struct Slot {
+            size_t hash = 0;
+            Object* object = nullptr;
+        };
+
+        // The table is grown past 3/4 of occupancy to keep the probe sequences short.
+        static constexpr size_t kMaxLoadNumerator = 3;
+        static constexpr size_t kMaxLoadDenominator = 4;
+        static constexpr uint32_t kMinCapacityLog2 = 4;
+
+        // The hashes are combinations of pointers and small integers whose low bits are poorly
+        // distributed, so spread them with a Fibonacci multiplication and keep the high bits.
+        size_t GetHomeIndex(size_t hash) const {
+            return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >>
+                                       (64 - mCapacityLog2));
+        }
+
+        size_t Next(size_t index) const {
+            return (index + 1) & (mSlots.size() - 1);
+        }
+
+        void InsertSlot(const Slot& slot) {
+            size_t i = GetHomeIndex(slot.hash);
+            while (mSlots[i].object != nullptr) {
+                i = Next(i);
+            }
+            mSlots[i] = slot;
+        }
+
+        void Grow() {
+            std::vector<Slot> slots = std::move(mSlots);
+            mCapacityLog2 = slots.empty() ? kMinCapacityLog2 : mCapacityLog2 + 1;
+            mSlots.assign(size_t(1) << mCapacityLog2, Slot{});
+            for (const Slot& slot : slots) {
+                if (slot.object != nullptr) {
+                    InsertSlot(slot);
+                }
+            }
+        }
+
+        std::vector<Slot> mSlots;
+        uint32_t mCapacityLog2 = 0;
+        size_t mSize = 0;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_CONTENTLESSOBJECTCACHE_H_
@@ -128,6 +128,14 @@ namespace dawn_native {
         mImpl->DiscoverDefaultAdapters();
     }
 
+    void Instance::DiscoverDefaultAdapters(const std::vector<WGPUBackendType>& backendTypes) {
+        std::vector<wgpu::BackendType> types;
+        for (WGPUBackendType type : backendTypes) {
+            types.push_back(static_cast<wgpu::BackendType>(type));
+        }
+        mImpl->DiscoverDefaultAdapters(types);
+    }
+
     bool Instance::DiscoverAdapters(const AdapterDiscoveryOptionsBase* options) {
         return mImpl->DiscoverAdapters(options);
     }
@@ -166,6 +174,12 @@ namespace dawn_native {
         return deviceBase->GetLazyClearCountForTesting();
     }
 
+    bool StartCompletionThread(WGPUDevice device, const CompletionThreadDescriptor* descriptor) {
+        dawn_native::DeviceBase* deviceBase = reinterpret_cast<dawn_native::DeviceBase*>(device);
+        DeviceLock lock(deviceBase->GetMutex());
+        return deviceBase->StartCompletionThread(*descriptor);
+    }
+
     bool IsTextureSubresourceInitialized(WGPUTexture texture,
                                          uint32_t baseMipLevel,
                                          uint32_t levelCount,
@@ -187,4 +201,8 @@ namespace dawn_native {
         : type(type) {
     }
 
+    ExternalBufferDescriptor::ExternalBufferDescriptor(ExternalImageDescriptorType type)
+        : type(type) {
+    }
+
 }  // namespace dawn_native
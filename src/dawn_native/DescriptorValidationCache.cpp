@@ -0,0 +1,104 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/DescriptorValidationCache.h"
+
+#include "common/HashUtils.h"
+#include "dawn_native/Buffer.h"
+#include "dawn_native/Texture.h"
+
+namespace dawn_native {
+
+    namespace {
+
+        // Applications creating many distinct shapes don't gain from the cache, it is reset
+        // instead of growing without bound.
+        constexpr size_t kMaxCachedDescriptors = 1024;
+
+        template <typename Set, typename Key>
+        void Insert(Set* set, const Key& key) {
+            if (set->size() >= kMaxCachedDescriptors) {
+                set->clear();
+            }
+            set->insert(key);
+        }
+
+    }  // anonymous namespace
+
+    size_t DescriptorValidationCache::BufferKey::HashFunc::operator()(const BufferKey& key) const {
+        size_t hash = Hash(key.usage);
+        HashCombine(&hash, key.size, key.residencyPriority);
+        return hash;
+    }
+
+    bool DescriptorValidationCache::BufferKey::operator==(const BufferKey& other) const {
+        return usage == other.usage && size == other.size &&
+               residencyPriority == other.residencyPriority;
+    }
+
+    size_t DescriptorValidationCache::TextureKey::HashFunc::operator()(
+        const TextureKey& key) const {
+        size_t hash = Hash(key.usage);
+        HashCombine(&hash, key.dimension, key.size.width, key.size.height, key.size.depth,
+                    key.arrayLayerCount, key.format, key.mipLevelCount, key.sampleCount,
+                    key.residencyPriority);
+        return hash;
+    }
+
+    bool DescriptorValidationCache::TextureKey::operator==(const TextureKey& other) const {
+        return usage == other.usage && dimension == other.dimension &&
+               size.width == other.size.width && size.height == other.size.height &&
+               size.depth == other.size.depth && arrayLayerCount == other.arrayLayerCount &&
+               format == other.format && mipLevelCount == other.mipLevelCount &&
+               sampleCount == other.sampleCount && residencyPriority == other.residencyPriority;
+    }
+
+    MaybeError DescriptorValidationCache::ValidateBufferDescriptor(
+        DeviceBase* device,
+        const BufferDescriptor* descriptor) {
+        if (descriptor == nullptr || descriptor->nextInChain != nullptr) {
+            return dawn_native::ValidateBufferDescriptor(device, descriptor);
+        }
+
+        BufferKey key = {descriptor->usage, descriptor->size, descriptor->residencyPriority};
+        if (mValidBufferDescriptors.count(key) != 0) {
+            return {};
+        }
+
+        DAWN_TRY(dawn_native::ValidateBufferDescriptor(device, descriptor));
+        Insert(&mValidBufferDescriptors, key);
+        return {};
+    }
+
+    MaybeError DescriptorValidationCache::ValidateTextureDescriptor(
+        const DeviceBase* device,
+        const TextureDescriptor* descriptor) {
+        if (descriptor == nullptr || descriptor->nextInChain != nullptr) {
+            return dawn_native::ValidateTextureDescriptor(device, descriptor);
+        }
+
+        TextureKey key = {descriptor->usage, descriptor->dimension,
+                          descriptor->size, descriptor->arrayLayerCount,
+                          descriptor->format, descriptor->mipLevelCount,
+                          descriptor->sampleCount, descriptor->residencyPriority};
+        if (mValidTextureDescriptors.count(key) != 0) {
+            return {};
+        }
+
+        DAWN_TRY(dawn_native::ValidateTextureDescriptor(device, descriptor));
+        Insert(&mValidTextureDescriptors, key);
+        return {};
+    }
+
+}  // namespace dawn_native
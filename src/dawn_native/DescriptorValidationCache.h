@@ -0,0 +1,73 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_DESCRIPTORVALIDATIONCACHE_H_
+#define DAWNNATIVE_DESCRIPTORVALIDATIONCACHE_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+#include "dawn_native/dawn_platform.h"
+
+#include <unordered_set>
+
+namespace dawn_native {
+
+    class DeviceBase;
+
+    // Remembers the buffer and texture descriptors that passed validation so that creating the
+    // same shape again, like the pooled transient resources of a frame graph, skips the
+    // validation. The validation only depends on the descriptor and on the extensions and formats
+    // of the device, which don't change. Labels aren't part of the key and descriptors with
+    // chained structs are always validated.
+    class DescriptorValidationCache {
+      public:
+        MaybeError ValidateBufferDescriptor(DeviceBase* device, const BufferDescriptor* descriptor);
+        MaybeError ValidateTextureDescriptor(const DeviceBase* device,
+                                             const TextureDescriptor* descriptor);
+
+      private:
+        struct BufferKey {
+            wgpu::BufferUsage usage;
+            uint64_t size;
+            wgpu::ResidencyPriority residencyPriority;
+
+            struct HashFunc {
+                size_t operator()(const BufferKey& key) const;
+            };
+            bool operator==(const BufferKey& other) const;
+        };
+
+        struct TextureKey {
+            wgpu::TextureUsage usage;
+            wgpu::TextureDimension dimension;
+            Extent3D size;
+            uint32_t arrayLayerCount;
+            wgpu::TextureFormat format;
+            uint32_t mipLevelCount;
+            uint32_t sampleCount;
+            wgpu::ResidencyPriority residencyPriority;
+
+            struct HashFunc {
+                size_t operator()(const TextureKey& key) const;
+            };
+            bool operator==(const TextureKey& other) const;
+        };
+
+        std::unordered_set<BufferKey, BufferKey::HashFunc> mValidBufferDescriptors;
+        std::unordered_set<TextureKey, TextureKey::HashFunc> mValidTextureDescriptors;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_DESCRIPTORVALIDATIONCACHE_H_
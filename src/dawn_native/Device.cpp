@@ -19,50 +19,69 @@
 #include "dawn_native/BindGroup.h"
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Buffer.h"
+#include "dawn_native/CommandAllocator.h"
 #include "dawn_native/CommandBuffer.h"
 #include "dawn_native/CommandEncoder.h"
+#include "dawn_native/CompletionThread.h"
 #include "dawn_native/ComputePipeline.h"
+#include "dawn_native/ContentLessObjectCache.h"
+#include "dawn_native/DescriptorValidationCache.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/ErrorScope.h"
 #include "dawn_native/ErrorScopeTracker.h"
 #include "dawn_native/Fence.h"
 #include "dawn_native/FenceSignalTracker.h"
+#include "dawn_native/IndirectValidation.h"
 #include "dawn_native/Instance.h"
+#include "dawn_native/PersistentCache.h"
 #include "dawn_native/PipelineLayout.h"
+#include "dawn_native/QuerySet.h"
 #include "dawn_native/Queue.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
+#include "dawn_native/RayTracingBundle.h"
+#include "dawn_native/RayTracingBundleEncoder.h"
 #include "dawn_native/RayTracingPipeline.h"
+#include "dawn_native/RayTracingResidencyManager.h"
 #include "dawn_native/RayTracingShaderBindingTable.h"
+#include "dawn_native/RenderBundle.h"
 #include "dawn_native/RenderBundleEncoder.h"
 #include "dawn_native/RenderPipeline.h"
+#include "dawn_native/ResourceTable.h"
 #include "dawn_native/Sampler.h"
 #include "dawn_native/ShaderModule.h"
+#include "dawn_native/ShaderModuleValidationQueue.h"
 #include "dawn_native/Surface.h"
 #include "dawn_native/SwapChain.h"
 #include "dawn_native/Texture.h"
+#include "dawn_native/TransientUniformAllocator.h"
 #include "dawn_native/ValidationUtils_autogen.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
 
-#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 namespace dawn_native {
 
     // DeviceBase::Caches
 
-    // The caches are unordered_sets of pointers with special hash and compare functions
-    // to compare the value of the objects, instead of the pointers.
-    template <typename Object>
-    using ContentLessObjectCache =
-        std::unordered_set<Object*, typename Object::HashFunc, typename Object::EqualityFunc>;
+    // The caches are sets of pointers compared with the objects' EqualityFunc, to compare the
+    // value of the objects instead of the pointers. They are keyed by the objects' HashFunc.
 
     struct DeviceBase::Caches {
         ContentLessObjectCache<AttachmentStateBlueprint> attachmentStates;
+        ContentLessObjectCache<BindGroupBase> bindGroups;
         ContentLessObjectCache<BindGroupLayoutBase> bindGroupLayouts;
         ContentLessObjectCache<ComputePipelineBase> computePipelines;
         ContentLessObjectCache<PipelineLayoutBase> pipelineLayouts;
+        ContentLessObjectCache<RayTracingPipelineBase> rayTracingPipelines;
+        ContentLessObjectCache<RayTracingShaderBindingTableBase> rayTracingShaderBindingTables;
         ContentLessObjectCache<RenderPipelineBase> renderPipelines;
         ContentLessObjectCache<SamplerBase> samplers;
         ContentLessObjectCache<ShaderModuleBase> shaderModules;
+        ContentLessObjectCache<TextureViewBase> textureViews;
     };
 
     // DeviceBase
@@ -71,9 +90,13 @@ namespace dawn_native {
         : mAdapter(adapter),
           mRootErrorScope(AcquireRef(new ErrorScope())),
           mCurrentErrorScope(mRootErrorScope.Get()) {
+        mCommandBlockPool = std::make_unique<CommandBlockPool>();
         mCaches = std::make_unique<DeviceBase::Caches>();
+        mDescriptorValidationCache = std::make_unique<DescriptorValidationCache>();
         mErrorScopeTracker = std::make_unique<ErrorScopeTracker>(this);
         mFenceSignalTracker = std::make_unique<FenceSignalTracker>(this);
+        mPersistentCache = std::make_unique<PersistentCache>(this);
+        mRayTracingResidencyManager = std::make_unique<RayTracingResidencyManager>();
         mDynamicUploader = std::make_unique<DynamicUploader>(this);
         SetDefaultToggles();
 
@@ -81,31 +104,56 @@ namespace dawn_native {
             ApplyExtensions(descriptor);
         }
 
-        mFormatTable = BuildFormatTable(this);
+        mSupportedFormats = ComputeSupportedFormats(this);
     }
 
     DeviceBase::~DeviceBase() {
         // Devices must explicitly free the uploader
         ASSERT(mDynamicUploader == nullptr);
         ASSERT(mDeferredCreateBufferMappedAsyncResults.empty());
-
-        ASSERT(mCaches->attachmentStates.empty());
-        ASSERT(mCaches->bindGroupLayouts.empty());
-        ASSERT(mCaches->computePipelines.empty());
-        ASSERT(mCaches->pipelineLayouts.empty());
-        ASSERT(mCaches->renderPipelines.empty());
-        ASSERT(mCaches->samplers.empty());
-        ASSERT(mCaches->shaderModules.empty());
+        ASSERT(mDeferredCreateRayTracingAccelerationContainerAsync.empty());
+        ASSERT(mDeferredCreateRayTracingPipelineAsync.empty());
+        ASSERT(mDeferredCreateRenderPipelineAsync.empty());
+        ASSERT(mDeferredCreateShaderModuleAsync.empty());
+
+        ASSERT(mCaches->attachmentStates.Empty());
+        ASSERT(mCaches->bindGroups.Empty());
+        ASSERT(mCaches->bindGroupLayouts.Empty());
+        ASSERT(mCaches->computePipelines.Empty());
+        ASSERT(mCaches->pipelineLayouts.Empty());
+        ASSERT(mCaches->rayTracingPipelines.Empty());
+        ASSERT(mCaches->rayTracingShaderBindingTables.Empty());
+        ASSERT(mCaches->renderPipelines.Empty());
+        ASSERT(mCaches->samplers.Empty());
+        ASSERT(mCaches->shaderModules.Empty());
+        ASSERT(mCaches->textureViews.Empty());
     }
 
     void DeviceBase::BaseDestructor() {
+        // The worker threads request ticks from the completion thread.
+        mShaderModuleValidationQueue = nullptr;
+        // Stopped first since it waits on the backend objects released below.
+        mCompletionThread = nullptr;
+        mIndirectValidationPipeline = nullptr;
+
         if (mLossStatus != LossStatus::Alive) {
             // if device is already lost, we may still have fences and error scopes to clear since
             // the time the device was lost, clear them now before we destruct the device.
             mErrorScopeTracker->Tick(GetCompletedCommandSerial());
             mFenceSignalTracker->Tick(GetCompletedCommandSerial());
+            RejectDeferredCreateRayTracingAccelerationContainerAsync();
+            RejectDeferredCreateRayTracingPipelineAsync();
+            RejectDeferredCreateRenderPipelineAsync();
+            RejectDeferredCreateShaderModuleAsync();
+            RejectRayTracingAccelerationContainerBuildInfoRequests();
             return;
         }
+        // Containers, pipelines and modules that weren't created yet are never handed out.
+        RejectDeferredCreateRayTracingAccelerationContainerAsync();
+        RejectDeferredCreateRayTracingPipelineAsync();
+        RejectDeferredCreateRenderPipelineAsync();
+        RejectDeferredCreateShaderModuleAsync();
+        RejectRayTracingAccelerationContainerBuildInfoRequests();
         // Assert that errors are device loss so that we can continue with destruction
         AssertAndIgnoreDeviceLossError(WaitForIdleForDestruction());
         Destroy();
@@ -113,6 +161,9 @@ namespace dawn_native {
     }
 
     void DeviceBase::HandleError(wgpu::ErrorType type, const char* message) {
+        // Errors of finished encoders can be reported from the threads recording them.
+        DeviceLock lock(mMutex);
+
         if (type == wgpu::ErrorType::DeviceLost) {
             HandleLoss(message);
         }
@@ -190,6 +241,11 @@ namespace dawn_native {
             return;
         }
 
+        // The tasks already given to the executor tick the lost device, which rejects the
+        // pending callbacks.
+        if (mCompletionThread != nullptr) {
+            mCompletionThread->StopWaiting();
+        }
         Destroy();
         mLossStatus = LossStatus::AlreadyLost;
 
@@ -217,183 +273,409 @@ namespace dawn_native {
         return GetAdapter()->GetInstance()->GetPlatform();
     }
 
+    bool DeviceBase::HasPendingCommands() const {
+        return false;
+    }
+
+    bool DeviceBase::StartCompletionThread(const CompletionThreadDescriptor& descriptor) {
+        if (IsLost() || mCompletionThread != nullptr) {
+            return false;
+        }
+        mCompletionThread = std::make_unique<CompletionThread>(this, descriptor);
+        mCompletionThread->DidTick(GetCompletedCommandSerial(), GetLastSubmittedCommandSerial(),
+                                   HasPendingCallbacks());
+        return true;
+    }
+
+    void DeviceBase::RequestCompletionTick() {
+        if (mCompletionThread != nullptr) {
+            mCompletionThread->RequestTick();
+        }
+    }
+
+    bool DeviceBase::WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs) {
+        constexpr uint64_t kPollIntervalNs = 1000ull * 1000ull;  // 1ms
+        std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(timeoutNs, kPollIntervalNs)));
+        return true;
+    }
+
+    void DeviceBase::DidStartMapAsync() {
+        mPendingMapAsyncCount++;
+        RequestCompletionTick();
+    }
+
+    void DeviceBase::DidFinishMapAsync() {
+        ASSERT(mPendingMapAsyncCount > 0);
+        mPendingMapAsyncCount--;
+    }
+
+    bool DeviceBase::HasPendingCallbacks() const {
+        return mPendingMapAsyncCount > 0 || !mErrorScopeTracker->Empty() ||
+               !mFenceSignalTracker->Empty() || !mDeferredCreateBufferMappedAsyncResults.empty() ||
+               !mDeferredCreateRayTracingAccelerationContainerAsync.empty() ||
+               !mRayTracingAccelerationContainerBuildInfoRequests.Empty() ||
+               !mDeferredCreateRayTracingPipelineAsync.empty() ||
+               !mDeferredCreateRenderPipelineAsync.empty() ||
+               !mDeferredCreateShaderModuleAsync.empty();
+    }
+
+    RenderBundleBase* DeviceBase::CreateRenderBundle(RenderBundleEncoder* encoder,
+                                                     const RenderBundleDescriptor* descriptor,
+                                                     AttachmentState* attachmentState,
+                                                     PassResourceUsage resourceUsage) {
+        return new RenderBundleBase(encoder, descriptor, attachmentState,
+                                    std::move(resourceUsage));
+    }
+
+    RayTracingBundleBase* DeviceBase::CreateRayTracingBundle(
+        RayTracingBundleEncoder* encoder,
+        const RayTracingBundleDescriptor* descriptor,
+        PassResourceUsage resourceUsage) {
+        return new RayTracingBundleBase(encoder, descriptor, std::move(resourceUsage));
+    }
+
+    MemoryUsageTracker* DeviceBase::GetMemoryUsageTracker() {
+        return &mMemoryUsageTracker;
+    }
+
     ErrorScopeTracker* DeviceBase::GetErrorScopeTracker() const {
         return mErrorScopeTracker.get();
     }
 
+    std::recursive_mutex& DeviceBase::GetMutex() {
+        return mMutex;
+    }
+
+    CommandBlockPool* DeviceBase::GetCommandBlockPool() const {
+        return mCommandBlockPool.get();
+    }
+
     FenceSignalTracker* DeviceBase::GetFenceSignalTracker() const {
         return mFenceSignalTracker.get();
     }
 
+    RayTracingResidencyManager* DeviceBase::GetRayTracingResidencyManager() const {
+        return mRayTracingResidencyManager.get();
+    }
+
     ResultOrError<const Format*> DeviceBase::GetInternalFormat(wgpu::TextureFormat format) const {
         size_t index = ComputeFormatIndex(format);
-        if (index >= mFormatTable.size()) {
+        if (index >= kKnownFormatCount) {
             return DAWN_VALIDATION_ERROR("Unknown texture format");
         }
 
-        const Format* internalFormat = &mFormatTable[index];
-        if (!internalFormat->isSupported) {
+        if (!mSupportedFormats[index]) {
             return DAWN_VALIDATION_ERROR("Unsupported texture format");
         }
 
-        return internalFormat;
+        return &GetFormatTable()[index];
     }
 
     const Format& DeviceBase::GetValidInternalFormat(wgpu::TextureFormat format) const {
         size_t index = ComputeFormatIndex(format);
-        ASSERT(index < mFormatTable.size());
-        ASSERT(mFormatTable[index].isSupported);
-        return mFormatTable[index];
+        ASSERT(index < kKnownFormatCount);
+        ASSERT(mSupportedFormats[index]);
+        return GetFormatTable()[index];
+    }
+
+    template <typename T, typename Cache, typename Blueprint>
+    T* DeviceBase::FindCachedObject(Cache* cache,
+                                    const Blueprint* blueprint,
+                                    size_t blueprintHash) {
+        T* object = static_cast<T*>(cache->Find(blueprint, blueprintHash));
+        if (object == nullptr) {
+            return nullptr;
+        }
+
+        if (object->TryReference()) {
+            return object;
+        }
+
+        // The last reference to the object was released on another thread, which waits on the
+        // device's mutex to delete it. It is taken out of the cache so that an equal object gets
+        // created and cached instead.
+        object->ClearIsCachedReference();
+        cache->Erase(object, blueprintHash);
+        return nullptr;
+    }
+
+    template <typename Cache, typename T>
+    void DeviceBase::InsertCachedObject(Cache* cache, T* object, size_t contentHash) {
+        object->SetIsCachedReference();
+        object->SetContentHash(contentHash);
+        cache->Insert(object, contentHash);
+    }
+
+    ResultOrError<BindGroupBase*> DeviceBase::GetOrCreateBindGroup(
+        const BindGroupDescriptor* descriptor) {
+        BindGroupBlueprint blueprint(this, descriptor);
+        const size_t blueprintHash = BindGroupBase::HashFunc()(&blueprint);
+
+        if (BindGroupBase* cached = FindCachedObject<BindGroupBase>(
+                &mCaches->bindGroups, &blueprint, blueprintHash)) {
+            return cached;
+        }
+
+        BindGroupBase* backendObj;
+        DAWN_TRY_ASSIGN(backendObj, CreateBindGroupImpl(descriptor));
+        InsertCachedObject(&mCaches->bindGroups, backendObj, blueprintHash);
+        return backendObj;
+    }
+
+    void DeviceBase::UncacheBindGroup(BindGroupBase* obj) {
+        ASSERT(obj->IsCachedReference());
+        bool removed = mCaches->bindGroups.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     ResultOrError<BindGroupLayoutBase*> DeviceBase::GetOrCreateBindGroupLayout(
         const BindGroupLayoutDescriptor* descriptor) {
         BindGroupLayoutBase blueprint(this, descriptor);
+        const size_t blueprintHash = BindGroupLayoutBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->bindGroupLayouts.find(&blueprint);
-        if (iter != mCaches->bindGroupLayouts.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (BindGroupLayoutBase* cached = FindCachedObject<BindGroupLayoutBase>(
+                &mCaches->bindGroupLayouts, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         BindGroupLayoutBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreateBindGroupLayoutImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->bindGroupLayouts.insert(backendObj);
+        InsertCachedObject(&mCaches->bindGroupLayouts, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncacheBindGroupLayout(BindGroupLayoutBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->bindGroupLayouts.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->bindGroupLayouts.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     ResultOrError<ComputePipelineBase*> DeviceBase::GetOrCreateComputePipeline(
         const ComputePipelineDescriptor* descriptor) {
         ComputePipelineBase blueprint(this, descriptor);
+        const size_t blueprintHash = ComputePipelineBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->computePipelines.find(&blueprint);
-        if (iter != mCaches->computePipelines.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (ComputePipelineBase* cached = FindCachedObject<ComputePipelineBase>(
+                &mCaches->computePipelines, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         ComputePipelineBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreateComputePipelineImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->computePipelines.insert(backendObj);
+        InsertCachedObject(&mCaches->computePipelines, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncacheComputePipeline(ComputePipelineBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->computePipelines.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->computePipelines.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
+    }
+
+    ResultOrError<ComputePipelineBase*> DeviceBase::GetOrCreateIndirectValidationPipeline() {
+        if (mIndirectValidationPipeline.Get() == nullptr) {
+            DAWN_TRY_ASSIGN(mIndirectValidationPipeline, CreateIndirectValidationPipeline(this));
+        }
+        return mIndirectValidationPipeline.Get();
+    }
+
+    ResultOrError<Ref<BufferBase>> DeviceBase::CreateInternalBuffer(
+        const BufferDescriptor* descriptor) {
+        BufferBase* buffer;
+        DAWN_TRY_ASSIGN(buffer, CreateBufferImpl(descriptor));
+        return AcquireRef(buffer);
+    }
+
+    void DeviceBase::AddTransientUniformAllocator(TransientUniformAllocator* allocator) {
+        mTransientUniformAllocators.push_back(allocator);
+    }
+
+    void DeviceBase::RemoveTransientUniformAllocator(TransientUniformAllocator* allocator) {
+        auto it = std::find(mTransientUniformAllocators.begin(),
+                            mTransientUniformAllocators.end(), allocator);
+        if (it != mTransientUniformAllocators.end()) {
+            mTransientUniformAllocators.erase(it);
+        }
+    }
+
+    void DeviceBase::FlushTransientUniformAllocators(QueueBase* queue) {
+        for (TransientUniformAllocator* allocator : mTransientUniformAllocators) {
+            allocator->Flush(queue);
+        }
     }
 
     ResultOrError<PipelineLayoutBase*> DeviceBase::GetOrCreatePipelineLayout(
         const PipelineLayoutDescriptor* descriptor) {
         PipelineLayoutBase blueprint(this, descriptor);
+        const size_t blueprintHash = PipelineLayoutBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->pipelineLayouts.find(&blueprint);
-        if (iter != mCaches->pipelineLayouts.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (PipelineLayoutBase* cached = FindCachedObject<PipelineLayoutBase>(
+                &mCaches->pipelineLayouts, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         PipelineLayoutBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreatePipelineLayoutImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->pipelineLayouts.insert(backendObj);
+        InsertCachedObject(&mCaches->pipelineLayouts, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncachePipelineLayout(PipelineLayoutBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->pipelineLayouts.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->pipelineLayouts.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
+    }
+
+    ResultOrError<RayTracingPipelineBase*> DeviceBase::GetOrCreateRayTracingPipeline(
+        const RayTracingPipelineDescriptor* descriptor) {
+        RayTracingPipelineBase blueprint(this, descriptor);
+        const size_t blueprintHash = RayTracingPipelineBase::HashFunc()(&blueprint);
+
+        if (RayTracingPipelineBase* cached = FindCachedObject<RayTracingPipelineBase>(
+                &mCaches->rayTracingPipelines, &blueprint, blueprintHash)) {
+            return cached;
+        }
+
+        RayTracingPipelineBase* backendObj;
+        DAWN_TRY_ASSIGN(backendObj, CreateRayTracingPipelineImpl(descriptor));
+        InsertCachedObject(&mCaches->rayTracingPipelines, backendObj, blueprintHash);
+        return backendObj;
+    }
+
+    void DeviceBase::UncacheRayTracingPipeline(RayTracingPipelineBase* obj) {
+        ASSERT(obj->IsCachedReference());
+        bool removed = mCaches->rayTracingPipelines.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
+    }
+
+    ResultOrError<RayTracingShaderBindingTableBase*>
+    DeviceBase::GetOrCreateRayTracingShaderBindingTable(
+        const RayTracingShaderBindingTableDescriptor* descriptor) {
+        RayTracingShaderBindingTableBlueprint blueprint(this, descriptor);
+        const size_t blueprintHash = RayTracingShaderBindingTableBase::HashFunc()(&blueprint);
+
+        if (RayTracingShaderBindingTableBase* cached =
+                FindCachedObject<RayTracingShaderBindingTableBase>(
+                    &mCaches->rayTracingShaderBindingTables, &blueprint, blueprintHash)) {
+            return cached;
+        }
+
+        RayTracingShaderBindingTableBase* backendObj;
+        DAWN_TRY_ASSIGN(backendObj, CreateRayTracingShaderBindingTableImpl(descriptor));
+        backendObj->TrackMemory();
+        InsertCachedObject(&mCaches->rayTracingShaderBindingTables, backendObj, blueprintHash);
+        return backendObj;
+    }
+
+    void DeviceBase::UncacheRayTracingShaderBindingTable(RayTracingShaderBindingTableBase* obj) {
+        ASSERT(obj->IsCachedReference());
+        bool removed = mCaches->rayTracingShaderBindingTables.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
+        obj->ClearIsCachedReference();
     }
 
     ResultOrError<RenderPipelineBase*> DeviceBase::GetOrCreateRenderPipeline(
         const RenderPipelineDescriptor* descriptor) {
         RenderPipelineBase blueprint(this, descriptor);
+        const size_t blueprintHash = RenderPipelineBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->renderPipelines.find(&blueprint);
-        if (iter != mCaches->renderPipelines.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (RenderPipelineBase* cached = FindCachedObject<RenderPipelineBase>(
+                &mCaches->renderPipelines, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         RenderPipelineBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreateRenderPipelineImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->renderPipelines.insert(backendObj);
+        InsertCachedObject(&mCaches->renderPipelines, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncacheRenderPipeline(RenderPipelineBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->renderPipelines.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->renderPipelines.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     ResultOrError<SamplerBase*> DeviceBase::GetOrCreateSampler(
         const SamplerDescriptor* descriptor) {
         SamplerBase blueprint(this, descriptor);
+        const size_t blueprintHash = SamplerBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->samplers.find(&blueprint);
-        if (iter != mCaches->samplers.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (SamplerBase* cached = FindCachedObject<SamplerBase>(
+                &mCaches->samplers, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         SamplerBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreateSamplerImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->samplers.insert(backendObj);
+        InsertCachedObject(&mCaches->samplers, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncacheSampler(SamplerBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->samplers.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->samplers.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     ResultOrError<ShaderModuleBase*> DeviceBase::GetOrCreateShaderModule(
         const ShaderModuleDescriptor* descriptor) {
         ShaderModuleBase blueprint(this, descriptor);
+        const size_t blueprintHash = ShaderModuleBase::HashFunc()(&blueprint);
 
-        auto iter = mCaches->shaderModules.find(&blueprint);
-        if (iter != mCaches->shaderModules.end()) {
-            (*iter)->Reference();
-            return *iter;
+        if (ShaderModuleBase* cached = FindCachedObject<ShaderModuleBase>(
+                &mCaches->shaderModules, &blueprint, blueprintHash)) {
+            return cached;
         }
 
         ShaderModuleBase* backendObj;
         DAWN_TRY_ASSIGN(backendObj, CreateShaderModuleImpl(descriptor));
-        backendObj->SetIsCachedReference();
-        mCaches->shaderModules.insert(backendObj);
+        InsertCachedObject(&mCaches->shaderModules, backendObj, blueprintHash);
         return backendObj;
     }
 
     void DeviceBase::UncacheShaderModule(ShaderModuleBase* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->shaderModules.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->shaderModules.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
+    }
+
+    ResultOrError<TextureViewBase*> DeviceBase::GetOrCreateTextureView(
+        TextureBase* texture,
+        const TextureViewDescriptor* descriptor) {
+        TextureViewBase blueprint(texture, descriptor);
+        const size_t blueprintHash = TextureViewBase::HashFunc()(&blueprint);
+
+        if (TextureViewBase* cached = FindCachedObject<TextureViewBase>(
+                &mCaches->textureViews, &blueprint, blueprintHash)) {
+            return cached;
+        }
+
+        TextureViewBase* backendObj;
+        DAWN_TRY_ASSIGN(backendObj, CreateTextureViewImpl(texture, descriptor));
+        InsertCachedObject(&mCaches->textureViews, backendObj, blueprintHash);
+        return backendObj;
+    }
+
+    void DeviceBase::UncacheTextureView(TextureViewBase* obj) {
+        ASSERT(obj->IsCachedReference());
+        bool removed = mCaches->textureViews.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     Ref<AttachmentState> DeviceBase::GetOrCreateAttachmentState(
         AttachmentStateBlueprint* blueprint) {
-        auto iter = mCaches->attachmentStates.find(blueprint);
-        if (iter != mCaches->attachmentStates.end()) {
-            return static_cast<AttachmentState*>(*iter);
+        // Called when beginning render passes, which can be recorded on any thread.
+        DeviceLock lock(mMutex);
+
+        const size_t blueprintHash = AttachmentStateBlueprint::HashFunc()(blueprint);
+        if (AttachmentState* cached = FindCachedObject<AttachmentState>(
+                &mCaches->attachmentStates, blueprint, blueprintHash)) {
+            return AcquireRef(cached);
         }
 
         Ref<AttachmentState> attachmentState = AcquireRef(new AttachmentState(this, *blueprint));
-        attachmentState->SetIsCachedReference();
-        mCaches->attachmentStates.insert(attachmentState.Get());
+        InsertCachedObject(&mCaches->attachmentStates, attachmentState.Get(), blueprintHash);
         return attachmentState;
     }
 
@@ -417,8 +699,8 @@ namespace dawn_native {
 
     void DeviceBase::UncacheAttachmentState(AttachmentState* obj) {
         ASSERT(obj->IsCachedReference());
-        size_t removedCount = mCaches->attachmentStates.erase(obj);
-        ASSERT(removedCount == 1);
+        bool removed = mCaches->attachmentStates.Erase(obj, obj->GetContentHash());
+        ASSERT(removed);
     }
 
     // Object creation API methods
@@ -432,6 +714,209 @@ namespace dawn_native {
         return result;
     }
 
+    void DeviceBase::CreateRayTracingAccelerationContainerAsync(
+        const RayTracingAccelerationContainerDescriptor* descriptor,
+        wgpu::RayTracingAccelerationContainerCreateCallback callback,
+        void* userdata) {
+        DeferredCreateRayTracingAccelerationContainerAsync deferred;
+        deferred.callback = callback;
+        deferred.descriptor =
+            std::make_unique<RayTracingAccelerationContainerDescriptorStorage>(descriptor);
+        deferred.userdata = userdata;
+
+        // The container is created in a later Tick and only handed out once it is usable.
+        mDeferredCreateRayTracingAccelerationContainerAsync.push_back(std::move(deferred));
+        RequestCompletionTick();
+    }
+
+    void DeviceBase::GetRayTracingAccelerationContainerHandles(
+        uint32_t containerCount,
+        RayTracingAccelerationContainerBase* const* containers,
+        uint64_t* handles) {
+        if (ConsumedError(
+                GetRayTracingAccelerationContainerHandlesInternal(containerCount, containers,
+                                                                  handles))) {
+            std::fill(handles, handles + containerCount, 0);
+        }
+    }
+
+    void DeviceBase::GetRayTracingAccelerationContainerMemoryInfo(
+        RayTracingAccelerationContainerMemoryInfo* info) const {
+        *info = mRayTracingAccelerationContainerMemoryInfo;
+    }
+
+    void DeviceBase::GetRayTracingAccelerationInstanceLayout(
+        RayTracingAccelerationInstanceLayout* layout) const {
+        layout->size = kAccelerationInstanceSize;
+        layout->offsetAlignment = kAccelerationInstanceOffsetAlignment;
+        layout->transformOffset = kAccelerationInstanceTransformOffset;
+        layout->instanceIdAndMaskOffset = kAccelerationInstanceIdAndMaskOffset;
+        layout->instanceOffsetAndFlagsOffset = kAccelerationInstanceOffsetAndFlagsOffset;
+        layout->geometryContainerHandleOffset = kAccelerationInstanceHandleOffset;
+    }
+
+    void DeviceBase::GetMemoryUsage(MemoryUsage* usage) const {
+        *usage = {};
+        mMemoryUsageTracker.GetUsage(usage);
+
+        // Scratch memory is shared by the containers and isn't part of any of them.
+        usage->accelerationContainerSize = mRayTracingAccelerationContainerMemoryInfo.resultSize +
+                                           mRayTracingAccelerationContainerMemoryInfo.instanceSize;
+
+        if (mDynamicUploader != nullptr) {
+            usage->stagingSize = mDynamicUploader->GetStagingSize();
+        }
+        usage->descriptorPoolCount = GetDescriptorPoolCountImpl();
+
+        for (const MemoryTypeUsage& memoryType : GetMemoryTypeUsagesImpl()) {
+            usage->heapSize += memoryType.heapSize;
+            usage->subAllocationHeapSize += memoryType.subAllocationHeapSize;
+            usage->subAllocatedSize += memoryType.subAllocatedSize;
+            usage->pendingDeletionSize += memoryType.pendingDeletionSize;
+        }
+    }
+
+    uint32_t DeviceBase::GetMemoryTypeUsages(uint32_t usageCount, MemoryTypeUsage* usages) const {
+        std::vector<MemoryTypeUsage> memoryTypes = GetMemoryTypeUsagesImpl();
+        if (usages != nullptr) {
+            std::copy_n(memoryTypes.begin(), std::min<size_t>(usageCount, memoryTypes.size()),
+                        usages);
+        }
+        return static_cast<uint32_t>(memoryTypes.size());
+    }
+
+    void DeviceBase::SetRayTracingAccelerationContainerResidencyBudget(uint64_t budget) {
+        if (ConsumedError(ValidateIsAlive())) {
+            return;
+        }
+        mRayTracingResidencyManager->SetBudget(budget);
+    }
+
+    MaybeError DeviceBase::GetRayTracingAccelerationContainerHandlesInternal(
+        uint32_t containerCount,
+        RayTracingAccelerationContainerBase* const* containers,
+        uint64_t* handles) {
+        DAWN_TRY(ValidateIsAlive());
+        for (uint32_t i = 0; i < containerCount; ++i) {
+            DAWN_TRY(ValidateObject(containers[i]));
+            DAWN_TRY_ASSIGN(handles[i], containers[i]->GetValidatedHandle());
+        }
+        return {};
+    }
+
+    void DeviceBase::TrackRayTracingAccelerationContainerMemory(
+        const RayTracingAccelerationContainerMemoryInfo& previousInfo,
+        const RayTracingAccelerationContainerMemoryInfo& info) {
+        RayTracingAccelerationContainerMemoryInfo& total =
+            mRayTracingAccelerationContainerMemoryInfo;
+        ASSERT(total.resultSize >= previousInfo.resultSize);
+        ASSERT(total.buildScratchSize >= previousInfo.buildScratchSize);
+        ASSERT(total.updateScratchSize >= previousInfo.updateScratchSize);
+        ASSERT(total.instanceSize >= previousInfo.instanceSize);
+        total.resultSize += info.resultSize - previousInfo.resultSize;
+        total.buildScratchSize += info.buildScratchSize - previousInfo.buildScratchSize;
+        total.updateScratchSize += info.updateScratchSize - previousInfo.updateScratchSize;
+        total.instanceSize += info.instanceSize - previousInfo.instanceSize;
+    }
+
+    uint64_t DeviceBase::GetRayTracingAccelerationContainerGeneration() const {
+        return mRayTracingAccelerationContainerGeneration;
+    }
+
+    void DeviceBase::InvalidateRayTracingAccelerationContainerGeneration() {
+        mRayTracingAccelerationContainerGeneration++;
+    }
+
+    void DeviceBase::AddRayTracingAccelerationContainerBuildInfoRequest(
+        RayTracingAccelerationContainerBase* container,
+        Serial buildSerial,
+        wgpu::RayTracingAccelerationContainerGetBuildInfoCallback callback,
+        void* userdata) {
+        RayTracingAccelerationContainerBuildInfoRequest request;
+        request.container = container;
+        request.callback = callback;
+        request.userdata = userdata;
+
+        // the requests are queued in order, one for a container built earlier waits a bit longer
+        SerialQueue<RayTracingAccelerationContainerBuildInfoRequest>& requests =
+            mRayTracingAccelerationContainerBuildInfoRequests;
+        Serial serial =
+            requests.Empty() ? buildSerial : std::max(buildSerial, requests.LastSerial());
+        requests.Enqueue(std::move(request), serial);
+        RequestCompletionTick();
+    }
+
+    void DeviceBase::TickRayTracingAccelerationContainerBuildInfoRequests(Serial completedSerial) {
+        // moved out first since the callbacks can request more build infos
+        std::vector<RayTracingAccelerationContainerBuildInfoRequest> requests;
+        for (RayTracingAccelerationContainerBuildInfoRequest& request :
+             mRayTracingAccelerationContainerBuildInfoRequests.IterateUpTo(completedSerial)) {
+            requests.push_back(std::move(request));
+        }
+        mRayTracingAccelerationContainerBuildInfoRequests.ClearUpTo(completedSerial);
+
+        for (const RayTracingAccelerationContainerBuildInfoRequest& request : requests) {
+            WGPURayTracingAccelerationContainerGetBuildInfoStatus status =
+                WGPURayTracingAccelerationContainerGetBuildInfoStatus_Success;
+            if (request.container->IsDestroyed()) {
+                status = WGPURayTracingAccelerationContainerGetBuildInfoStatus_Unknown;
+            }
+            request.callback(status, request.container->GetBuildInfoInternal(), request.userdata);
+        }
+    }
+
+    void DeviceBase::RejectRayTracingAccelerationContainerBuildInfoRequests() {
+        std::vector<RayTracingAccelerationContainerBuildInfoRequest> requests;
+        for (RayTracingAccelerationContainerBuildInfoRequest& request :
+             mRayTracingAccelerationContainerBuildInfoRequests.IterateAll()) {
+            requests.push_back(std::move(request));
+        }
+        mRayTracingAccelerationContainerBuildInfoRequests.Clear();
+
+        for (const RayTracingAccelerationContainerBuildInfoRequest& request : requests) {
+            request.callback(WGPURayTracingAccelerationContainerGetBuildInfoStatus_DeviceLost, {},
+                             request.userdata);
+        }
+    }
+
+    void DeviceBase::TickDeferredCreateRayTracingAccelerationContainerAsync() {
+        constexpr size_t kMaxCreationsPerTick = 256;
+
+        for (size_t i = 0;
+             i < kMaxCreationsPerTick && !mDeferredCreateRayTracingAccelerationContainerAsync.empty();
+             ++i) {
+            DeferredCreateRayTracingAccelerationContainerAsync deferred =
+                std::move(mDeferredCreateRayTracingAccelerationContainerAsync.front());
+            mDeferredCreateRayTracingAccelerationContainerAsync.pop_front();
+
+            if (IsLost()) {
+                deferred.callback(WGPURayTracingAccelerationContainerCreateStatus_DeviceLost,
+                                  nullptr, deferred.userdata);
+                continue;
+            }
+
+            RayTracingAccelerationContainerBase* result = nullptr;
+            WGPURayTracingAccelerationContainerCreateStatus status =
+                WGPURayTracingAccelerationContainerCreateStatus_Success;
+            if (ConsumedError(CreateRayTracingAccelerationContainerInternal(
+                    &result, deferred.descriptor->GetDescriptor()))) {
+                status = WGPURayTracingAccelerationContainerCreateStatus_Error;
+                result = RayTracingAccelerationContainerBase::MakeError(this);
+            }
+
+            deferred.callback(status, reinterpret_cast<WGPURayTracingAccelerationContainer>(result),
+                              deferred.userdata);
+        }
+    }
+
+    void DeviceBase::RejectDeferredCreateRayTracingAccelerationContainerAsync() {
+        auto deferredCreations = std::move(mDeferredCreateRayTracingAccelerationContainerAsync);
+        for (const auto& deferred : deferredCreations) {
+            deferred.callback(WGPURayTracingAccelerationContainerCreateStatus_DeviceLost, nullptr,
+                              deferred.userdata);
+        }
+    }
+
     RayTracingShaderBindingTableBase* DeviceBase::CreateRayTracingShaderBindingTable(const RayTracingShaderBindingTableDescriptor* descriptor) {
         RayTracingShaderBindingTableBase* result = nullptr;
 
@@ -453,6 +938,116 @@ namespace dawn_native {
         return result;
     }
 
+    void DeviceBase::CreateRayTracingPipelineAsync(const RayTracingPipelineDescriptor* descriptor,
+                                                   wgpu::RayTracingPipelineCreateCallback callback,
+                                                   void* userdata) {
+        DeferredCreateRayTracingPipelineAsync deferred;
+        deferred.callback = callback;
+        deferred.descriptor = std::make_unique<RayTracingPipelineDescriptorStorage>(descriptor);
+        deferred.userdata = userdata;
+
+        mDeferredCreateRayTracingPipelineAsync.push_back(std::move(deferred));
+        RequestCompletionTick();
+    }
+
+    RayTracingBundleEncoder* DeviceBase::CreateRayTracingBundleEncoder(
+        const RayTracingBundleEncoderDescriptor* descriptor) {
+        RayTracingBundleEncoder* result = nullptr;
+
+        if (ConsumedError(CreateRayTracingBundleEncoderInternal(&result, descriptor))) {
+            return RayTracingBundleEncoder::MakeError(this);
+        }
+
+        return result;
+    }
+
+    void DeviceBase::TickDeferredCreateRayTracingPipelineAsync() {
+        constexpr size_t kMaxCreationsPerTick = 16;
+
+        if (mDeferredCreateRayTracingPipelineAsync.empty()) {
+            return;
+        }
+        if (IsLost()) {
+            RejectDeferredCreateRayTracingPipelineAsync();
+            return;
+        }
+
+        // Invalid descriptors are rejected right away, the valid ones are compiled together.
+        std::vector<DeferredCreateRayTracingPipelineAsync> batch;
+        std::vector<const RayTracingPipelineDescriptor*> descriptors;
+        while (batch.size() < kMaxCreationsPerTick &&
+               !mDeferredCreateRayTracingPipelineAsync.empty()) {
+            DeferredCreateRayTracingPipelineAsync deferred =
+                std::move(mDeferredCreateRayTracingPipelineAsync.front());
+            mDeferredCreateRayTracingPipelineAsync.pop_front();
+
+            const RayTracingPipelineDescriptor* descriptor = deferred.descriptor->GetDescriptor();
+            if (IsValidationEnabled() &&
+                ConsumedError(ValidateRayTracingPipelineDescriptor(this, descriptor))) {
+                deferred.callback(WGPURayTracingPipelineCreateStatus_Error,
+                                  reinterpret_cast<WGPURayTracingPipeline>(
+                                      RayTracingPipelineBase::MakeError(this)),
+                                  deferred.userdata);
+                continue;
+            }
+
+            // Pipelines equal to a cached one are given out without being compiled again.
+            RayTracingPipelineBase blueprint(this, descriptor);
+            const size_t blueprintHash = RayTracingPipelineBase::HashFunc()(&blueprint);
+            if (RayTracingPipelineBase* cached = FindCachedObject<RayTracingPipelineBase>(
+                &mCaches->rayTracingPipelines, &blueprint, blueprintHash)) {
+                deferred.callback(WGPURayTracingPipelineCreateStatus_Success,
+                                  reinterpret_cast<WGPURayTracingPipeline>(cached),
+                                  deferred.userdata);
+                continue;
+            }
+
+            descriptors.push_back(descriptor);
+            batch.push_back(std::move(deferred));
+        }
+
+        if (batch.empty()) {
+            return;
+        }
+
+        std::vector<Ref<RayTracingPipelineBase>> pipelines;
+        if (ConsumedError(CreateRayTracingPipelinesImpl(descriptors), &pipelines)) {
+            for (const DeferredCreateRayTracingPipelineAsync& deferred : batch) {
+                deferred.callback(WGPURayTracingPipelineCreateStatus_Error,
+                                  reinterpret_cast<WGPURayTracingPipeline>(
+                                      RayTracingPipelineBase::MakeError(this)),
+                                  deferred.userdata);
+            }
+            return;
+        }
+
+        ASSERT(pipelines.size() == batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // Duplicates within the batch are compiled once per entry, all but the first one
+            // are dropped in favor of the cached pipeline.
+            const size_t hash = RayTracingPipelineBase::HashFunc()(pipelines[i].Get());
+            RayTracingPipelineBase* pipeline = FindCachedObject<RayTracingPipelineBase>(
+                &mCaches->rayTracingPipelines, pipelines[i].Get(), hash);
+            if (pipeline == nullptr) {
+                // The reference of the Ref is handed over to the application.
+                pipeline = pipelines[i].Get();
+                pipeline->Reference();
+                InsertCachedObject(&mCaches->rayTracingPipelines, pipeline, hash);
+            }
+            batch[i].callback(WGPURayTracingPipelineCreateStatus_Success,
+                              reinterpret_cast<WGPURayTracingPipeline>(pipeline),
+                              batch[i].userdata);
+        }
+    }
+
+    void DeviceBase::RejectDeferredCreateRayTracingPipelineAsync() {
+        auto deferredCreations = std::move(mDeferredCreateRayTracingPipelineAsync);
+        for (const auto& deferred : deferredCreations) {
+            deferred.callback(WGPURayTracingPipelineCreateStatus_DeviceLost, nullptr,
+                              deferred.userdata);
+        }
+    }
+
     BindGroupBase* DeviceBase::CreateBindGroup(const BindGroupDescriptor* descriptor) {
         BindGroupBase* result = nullptr;
 
@@ -475,6 +1070,12 @@ namespace dawn_native {
     BufferBase* DeviceBase::CreateBuffer(const BufferDescriptor* descriptor) {
         BufferBase* result = nullptr;
 
+        if (IsValidationEnabled() && descriptor->mappedDataFullyWritten) {
+            ConsumedError(DAWN_VALIDATION_ERROR(
+                "mappedDataFullyWritten requires the buffer to be created mapped"));
+            return BufferBase::MakeError(this);
+        }
+
         if (ConsumedError(CreateBufferInternal(&result, descriptor))) {
             return BufferBase::MakeError(this);
         }
@@ -502,8 +1103,13 @@ namespace dawn_native {
             // Non-zero dataLength and nullptr data is used to indicate there should be
             // mapped data but the allocation failed.
             ASSERT(buffer->IsError());
-        } else {
+        } else if (!descriptor->mappedDataFullyWritten) {
             memset(data, 0, size);
+        } else if (IsToggleEnabled(Toggle::NonzeroClearResourcesOnCreationForTesting)) {
+            // The application writes all of the data before Unmap so it isn't cleared, which
+            // would be the most expensive part of uploading large buffers. Tests fill it with a
+            // nonzero value instead, to catch the data that wasn't written.
+            memset(data, 1, size);
         }
 
         WGPUCreateBufferMappedResult result = {};
@@ -533,6 +1139,7 @@ namespace dawn_native {
 
         // The callback is deferred so it matches the async behavior of WebGPU.
         mDeferredCreateBufferMappedAsyncResults.push_back(deferred_info);
+        RequestCompletionTick();
     }
     CommandEncoder* DeviceBase::CreateCommandEncoder(const CommandEncoderDescriptor* descriptor) {
         return new CommandEncoder(this, descriptor);
@@ -557,15 +1164,33 @@ namespace dawn_native {
 
         return result;
     }
-    QueueBase* DeviceBase::CreateQueue() {
+    QuerySetBase* DeviceBase::CreateQuerySet(const QuerySetDescriptor* descriptor) {
+        QuerySetBase* result = nullptr;
+
+        if (ConsumedError(CreateQuerySetInternal(&result, descriptor))) {
+            return QuerySetBase::MakeError(this);
+        }
+
+        return result;
+    }
+    QueueBase* DeviceBase::CreateQueue(const QueueDescriptor* descriptor) {
         QueueBase* result = nullptr;
 
-        if (ConsumedError(CreateQueueInternal(&result))) {
+        if (ConsumedError(CreateQueueInternal(&result, descriptor))) {
             return QueueBase::MakeError(this);
         }
 
         return result;
     }
+    ResourceTableBase* DeviceBase::CreateResourceTable(const ResourceTableDescriptor* descriptor) {
+        ResourceTableBase* result = nullptr;
+
+        if (ConsumedError(CreateResourceTableInternal(&result, descriptor))) {
+            return ResourceTableBase::MakeError(this);
+        }
+
+        return result;
+    }
     SamplerBase* DeviceBase::CreateSampler(const SamplerDescriptor* descriptor) {
         SamplerBase* result = nullptr;
 
@@ -595,6 +1220,131 @@ namespace dawn_native {
 
         return result;
     }
+
+    void DeviceBase::CreateRenderPipelineAsync(const RenderPipelineDescriptor* descriptor,
+                                               wgpu::RenderPipelineCreateCallback callback,
+                                               void* userdata) {
+        DeferredCreateRenderPipelineAsync deferred;
+        deferred.callback = callback;
+        deferred.descriptor = std::make_unique<RenderPipelineDescriptorStorage>(descriptor);
+        deferred.userdata = userdata;
+
+        mDeferredCreateRenderPipelineAsync.push_back(std::move(deferred));
+        RequestCompletionTick();
+    }
+
+    void DeviceBase::TickDeferredCreateRenderPipelineAsync() {
+        constexpr size_t kMaxCreationsPerTick = 64;
+
+        if (mDeferredCreateRenderPipelineAsync.empty()) {
+            return;
+        }
+        if (IsLost()) {
+            RejectDeferredCreateRenderPipelineAsync();
+            return;
+        }
+
+        // Invalid descriptors are rejected right away, the valid ones are compiled together.
+        std::vector<DeferredCreateRenderPipelineAsync> batch;
+        std::vector<const RenderPipelineDescriptor*> descriptors;
+        // Descriptors without a layout are given the default one of their shaders. A deque keeps
+        // the pointers to its elements valid when it grows.
+        std::deque<RenderPipelineDescriptor> descriptorsWithDefaultLayout;
+        std::vector<Ref<PipelineLayoutBase>> defaultLayouts;
+
+        auto Reject = [this](const DeferredCreateRenderPipelineAsync& deferred) {
+            deferred.callback(
+                WGPURenderPipelineCreateStatus_Error,
+                reinterpret_cast<WGPURenderPipeline>(RenderPipelineBase::MakeError(this)),
+                deferred.userdata);
+        };
+
+        while (batch.size() < kMaxCreationsPerTick &&
+               !mDeferredCreateRenderPipelineAsync.empty()) {
+            DeferredCreateRenderPipelineAsync deferred =
+                std::move(mDeferredCreateRenderPipelineAsync.front());
+            mDeferredCreateRenderPipelineAsync.pop_front();
+
+            const RenderPipelineDescriptor* descriptor = deferred.descriptor->GetDescriptor();
+            if (IsValidationEnabled() &&
+                ConsumedError(ValidateRenderPipelineDescriptor(this, descriptor))) {
+                Reject(deferred);
+                continue;
+            }
+
+            if (descriptor->layout == nullptr) {
+                const ShaderModuleBase* modules[2];
+                modules[0] = descriptor->vertexStage.module;
+                uint32_t count = 1;
+                if (descriptor->fragmentStage != nullptr) {
+                    modules[1] = descriptor->fragmentStage->module;
+                    count = 2;
+                }
+
+                PipelineLayoutBase* layout = nullptr;
+                if (ConsumedError(PipelineLayoutBase::CreateDefault(this, modules, count),
+                                  &layout)) {
+                    Reject(deferred);
+                    continue;
+                }
+                defaultLayouts.push_back(AcquireRef(layout));
+                descriptorsWithDefaultLayout.push_back(*descriptor);
+                descriptorsWithDefaultLayout.back().layout = layout;
+                descriptor = &descriptorsWithDefaultLayout.back();
+            }
+
+            // Pipelines equal to a cached one are given out without being compiled again.
+            RenderPipelineBase blueprint(this, descriptor);
+            const size_t blueprintHash = RenderPipelineBase::HashFunc()(&blueprint);
+            if (RenderPipelineBase* cached = FindCachedObject<RenderPipelineBase>(
+                    &mCaches->renderPipelines, &blueprint, blueprintHash)) {
+                deferred.callback(WGPURenderPipelineCreateStatus_Success,
+                                  reinterpret_cast<WGPURenderPipeline>(cached),
+                                  deferred.userdata);
+                continue;
+            }
+
+            descriptors.push_back(descriptor);
+            batch.push_back(std::move(deferred));
+        }
+
+        if (batch.empty()) {
+            return;
+        }
+
+        std::vector<Ref<RenderPipelineBase>> pipelines;
+        if (ConsumedError(CreateRenderPipelinesImpl(descriptors), &pipelines)) {
+            for (const DeferredCreateRenderPipelineAsync& deferred : batch) {
+                Reject(deferred);
+            }
+            return;
+        }
+
+        ASSERT(pipelines.size() == batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // Duplicates within the batch are compiled once per entry, all but the first one
+            // are dropped in favor of the cached pipeline.
+            const size_t hash = RenderPipelineBase::HashFunc()(pipelines[i].Get());
+            RenderPipelineBase* pipeline = FindCachedObject<RenderPipelineBase>(
+                &mCaches->renderPipelines, pipelines[i].Get(), hash);
+            if (pipeline == nullptr) {
+                // The reference of the Ref is handed over to the application.
+                pipeline = pipelines[i].Get();
+                pipeline->Reference();
+                InsertCachedObject(&mCaches->renderPipelines, pipeline, hash);
+            }
+            batch[i].callback(WGPURenderPipelineCreateStatus_Success,
+                              reinterpret_cast<WGPURenderPipeline>(pipeline), batch[i].userdata);
+        }
+    }
+
+    void DeviceBase::RejectDeferredCreateRenderPipelineAsync() {
+        auto deferredCreations = std::move(mDeferredCreateRenderPipelineAsync);
+        for (const auto& deferred : deferredCreations) {
+            deferred.callback(WGPURenderPipelineCreateStatus_DeviceLost, nullptr,
+                              deferred.userdata);
+        }
+    }
     ShaderModuleBase* DeviceBase::CreateShaderModule(const ShaderModuleDescriptor* descriptor) {
         ShaderModuleBase* result = nullptr;
 
@@ -604,6 +1354,106 @@ namespace dawn_native {
 
         return result;
     }
+
+    void DeviceBase::CreateShaderModuleAsync(const ShaderModuleDescriptor* descriptor,
+                                             wgpu::ShaderModuleCreateCallback callback,
+                                             void* userdata) {
+        DeferredCreateShaderModuleAsync deferred;
+        deferred.callback = callback;
+        deferred.code.assign(descriptor->code, descriptor->code + descriptor->codeSize);
+        deferred.hasChainedStructs = descriptor->nextInChain != nullptr;
+        deferred.userdata = userdata;
+
+        if (IsValidationEnabled() && !deferred.hasChainedStructs &&
+            IsToggleEnabled(Toggle::ValidateShaderModulesOnWorkerThreads)) {
+            if (mShaderModuleValidationQueue == nullptr) {
+                uint32_t threadCount = std::thread::hardware_concurrency() / 2;
+                threadCount = std::min(std::max(threadCount, 1u), 4u);
+                mShaderModuleValidationQueue =
+                    std::make_unique<ShaderModuleValidationQueue>(this, threadCount);
+            }
+            deferred.validation = mShaderModuleValidationQueue->Enqueue(deferred.code);
+        }
+
+        mDeferredCreateShaderModuleAsync.push_back(std::move(deferred));
+        RequestCompletionTick();
+    }
+
+    void DeviceBase::TickDeferredCreateShaderModuleAsync() {
+        constexpr size_t kMaxValidationsPerTick = 16;
+
+        if (mDeferredCreateShaderModuleAsync.empty()) {
+            return;
+        }
+        if (IsLost()) {
+            RejectDeferredCreateShaderModuleAsync();
+            return;
+        }
+
+        auto Reject = [this](const DeferredCreateShaderModuleAsync& deferred) {
+            deferred.callback(
+                WGPUShaderModuleCreateStatus_Error,
+                reinterpret_cast<WGPUShaderModule>(ShaderModuleBase::MakeError(this)),
+                deferred.userdata);
+        };
+
+        // The modules validated on the worker threads are created as soon as their validation
+        // completes, regardless of the ones before them.
+        std::deque<DeferredCreateShaderModuleAsync> stillPending;
+        size_t validationCount = 0;
+        while (!mDeferredCreateShaderModuleAsync.empty()) {
+            DeferredCreateShaderModuleAsync deferred =
+                std::move(mDeferredCreateShaderModuleAsync.front());
+            mDeferredCreateShaderModuleAsync.pop_front();
+
+            ShaderModuleDescriptor descriptor = {};
+            descriptor.codeSize = static_cast<uint32_t>(deferred.code.size());
+            descriptor.code = deferred.code.data();
+
+            MaybeError validation = {};
+            if (deferred.validation != nullptr) {
+                if (!mShaderModuleValidationQueue->IsDone(*deferred.validation)) {
+                    stillPending.push_back(std::move(deferred));
+                    continue;
+                }
+                if (deferred.validation->error != nullptr) {
+                    validation = MaybeError(std::move(deferred.validation->error));
+                }
+            } else if (IsValidationEnabled()) {
+                if (validationCount == kMaxValidationsPerTick) {
+                    stillPending.push_back(std::move(deferred));
+                    continue;
+                }
+                validationCount++;
+
+                if (deferred.hasChainedStructs) {
+                    validation = DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+                } else {
+                    validation = ValidateShaderModuleDescriptor(this, &descriptor);
+                }
+            }
+
+            ShaderModuleBase* shaderModule = nullptr;
+            if (ConsumedError(std::move(validation)) ||
+                ConsumedError(GetOrCreateShaderModule(&descriptor), &shaderModule)) {
+                Reject(deferred);
+                continue;
+            }
+            deferred.callback(WGPUShaderModuleCreateStatus_Success,
+                              reinterpret_cast<WGPUShaderModule>(shaderModule),
+                              deferred.userdata);
+        }
+
+        mDeferredCreateShaderModuleAsync = std::move(stillPending);
+    }
+
+    void DeviceBase::RejectDeferredCreateShaderModuleAsync() {
+        auto deferredCreations = std::move(mDeferredCreateShaderModuleAsync);
+        for (const auto& deferred : deferredCreations) {
+            deferred.callback(WGPUShaderModuleCreateStatus_DeviceLost, nullptr, deferred.userdata);
+        }
+    }
+
     SwapChainBase* DeviceBase::CreateSwapChain(Surface* surface,
                                                const SwapChainDescriptor* descriptor) {
         SwapChainBase* result = nullptr;
@@ -633,6 +1483,16 @@ namespace dawn_native {
 
         return result;
     }
+    TransientUniformAllocator* DeviceBase::CreateTransientUniformAllocator(
+        const TransientUniformAllocatorDescriptor* descriptor) {
+        TransientUniformAllocator* result = nullptr;
+
+        if (ConsumedError(CreateTransientUniformAllocatorInternal(&result, descriptor))) {
+            return TransientUniformAllocator::MakeError(this);
+        }
+
+        return result;
+    }
 
     // Other Device API methods
 
@@ -645,6 +1505,11 @@ namespace dawn_native {
                 deferred.callback(deferred.status, deferred.result, deferred.userdata);
             }
         }
+        // Deferred creations are also resolved when the device is lost, with a device lost status.
+        TickDeferredCreateRayTracingAccelerationContainerAsync();
+        TickDeferredCreateRayTracingPipelineAsync();
+        TickDeferredCreateRenderPipelineAsync();
+        TickDeferredCreateShaderModuleAsync();
         if (ConsumedError(ValidateIsAlive())) {
             return;
         }
@@ -654,6 +1519,13 @@ namespace dawn_native {
 
         mErrorScopeTracker->Tick(GetCompletedCommandSerial());
         mFenceSignalTracker->Tick(GetCompletedCommandSerial());
+        mRayTracingResidencyManager->Tick(GetCompletedCommandSerial());
+        TickRayTracingAccelerationContainerBuildInfoRequests(GetCompletedCommandSerial());
+
+        if (mCompletionThread != nullptr) {
+            mCompletionThread->DidTick(GetCompletedCommandSerial(),
+                                       GetLastSubmittedCommandSerial(), HasPendingCallbacks());
+        }
     }
 
     void DeviceBase::Reference() {
@@ -714,6 +1586,23 @@ namespace dawn_native {
         return !IsToggleEnabled(Toggle::SkipValidation);
     }
 
+    bool DeviceBase::IsDrawStateValidationEnabled() const {
+        return IsValidationEnabled() && !IsToggleEnabled(Toggle::SkipDrawStateValidation);
+    }
+
+    bool DeviceBase::IsResourceUsageValidationEnabled() const {
+        return IsValidationEnabled() && !IsToggleEnabled(Toggle::SkipResourceUsageValidation);
+    }
+
+    bool DeviceBase::IsCopyBoundsValidationEnabled() const {
+        return IsValidationEnabled() && !IsToggleEnabled(Toggle::SkipCopyBoundsValidation);
+    }
+
+    bool DeviceBase::IsBindGroupCompatibilityValidationEnabled() const {
+        return IsValidationEnabled() &&
+               !IsToggleEnabled(Toggle::SkipBindGroupCompatibilityValidation);
+    }
+
     size_t DeviceBase::GetLazyClearCountForTesting() {
         return mLazyClearCountForTesting;
     }
@@ -730,17 +1619,23 @@ namespace dawn_native {
     // Implementation details of object creation
     MaybeError DeviceBase::CreateBindGroupInternal(BindGroupBase** result,
                                                    const BindGroupDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateBindGroup");
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateBindGroupDescriptor(this, descriptor));
         }
-        DAWN_TRY_ASSIGN(*result, CreateBindGroupImpl(descriptor));
+        if (IsToggleEnabled(Toggle::CacheBindGroups)) {
+            DAWN_TRY_ASSIGN(*result, GetOrCreateBindGroup(descriptor));
+        } else {
+            DAWN_TRY_ASSIGN(*result, CreateBindGroupImpl(descriptor));
+        }
         return {};
     }
 
     MaybeError DeviceBase::CreateBindGroupLayoutInternal(
         BindGroupLayoutBase** result,
         const BindGroupLayoutDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateBindGroupLayout");
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateBindGroupLayoutDescriptor(this, descriptor));
@@ -753,7 +1648,7 @@ namespace dawn_native {
                                                 const BufferDescriptor* descriptor) {
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
-            DAWN_TRY(ValidateBufferDescriptor(this, descriptor));
+            DAWN_TRY(mDescriptorValidationCache->ValidateBufferDescriptor(this, descriptor));
         }
         DAWN_TRY_ASSIGN(*result, CreateBufferImpl(descriptor));
         return {};
@@ -762,6 +1657,7 @@ namespace dawn_native {
     MaybeError DeviceBase::CreateComputePipelineInternal(
         ComputePipelineBase** result,
         const ComputePipelineDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateComputePipeline");
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateComputePipelineDescriptor(this, descriptor));
@@ -795,15 +1691,36 @@ namespace dawn_native {
         return {};
     }
 
-    MaybeError DeviceBase::CreateQueueInternal(QueueBase** result) {
+    MaybeError DeviceBase::CreateQuerySetInternal(QuerySetBase** result,
+                                                  const QuerySetDescriptor* descriptor) {
+        DAWN_TRY(ValidateIsAlive());
+        if (IsValidationEnabled()) {
+            DAWN_TRY(ValidateQuerySetDescriptor(this, descriptor));
+        }
+        DAWN_TRY_ASSIGN(*result, CreateQuerySetImpl(descriptor));
+        return {};
+    }
+
+    MaybeError DeviceBase::CreateQueueInternal(QueueBase** result,
+                                               const QueueDescriptor* descriptor) {
         DAWN_TRY(ValidateIsAlive());
-        DAWN_TRY_ASSIGN(*result, CreateQueueImpl());
+
+        QueueDescriptor defaultDescriptor;
+        if (descriptor == nullptr) {
+            descriptor = &defaultDescriptor;
+        }
+
+        if (IsValidationEnabled()) {
+            DAWN_TRY(ValidateQueueDescriptor(descriptor));
+        }
+        DAWN_TRY_ASSIGN(*result, CreateQueueImpl(descriptor));
         return {};
     }
 
     MaybeError DeviceBase::CreateRayTracingAccelerationContainerInternal(
         RayTracingAccelerationContainerBase** result,
         const RayTracingAccelerationContainerDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateRayTracingAccelerationContainer");
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateRayTracingAccelerationContainerDescriptor(this, descriptor));
         }
@@ -814,20 +1731,77 @@ namespace dawn_native {
     MaybeError DeviceBase::CreateRayTracingShaderBindingTableInternal(
         RayTracingShaderBindingTableBase** result,
         const RayTracingShaderBindingTableDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateRayTracingShaderBindingTable");
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateRayTracingShaderBindingTableDescriptor(this, descriptor));
         }
-        DAWN_TRY_ASSIGN(*result, CreateRayTracingShaderBindingTableImpl(descriptor));
+        if (RayTracingShaderBindingTableBase::IsCacheable(descriptor)) {
+            DAWN_TRY_ASSIGN(*result, GetOrCreateRayTracingShaderBindingTable(descriptor));
+        } else {
+            DAWN_TRY_ASSIGN(*result, CreateRayTracingShaderBindingTableImpl(descriptor));
+            (*result)->TrackMemory();
+        }
         return {};
     }
 
     MaybeError DeviceBase::CreateRayTracingPipelineInternal(
         RayTracingPipelineBase** result,
         const RayTracingPipelineDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateRayTracingPipeline");
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateRayTracingPipelineDescriptor(this, descriptor));
         }
-        DAWN_TRY_ASSIGN(*result, CreateRayTracingPipelineImpl(descriptor));
+        DAWN_TRY_ASSIGN(*result, GetOrCreateRayTracingPipeline(descriptor));
+        return {};
+    }
+
+    MaybeError DeviceBase::CopyFromStagingToTexture(StagingBufferBase*,
+                                                    uint64_t,
+                                                    uint32_t,
+                                                    uint32_t,
+                                                    const TextureCopy&,
+                                                    const Extent3D&) {
+        return DAWN_UNIMPLEMENTED_ERROR("Texture writes aren't supported by this backend");
+    }
+
+    std::vector<MemoryTypeUsage> DeviceBase::GetMemoryTypeUsagesImpl() const {
+        return {};
+    }
+
+    uint64_t DeviceBase::GetDescriptorPoolCountImpl() const {
+        return 0;
+    }
+
+    ResultOrError<std::vector<Ref<RayTracingPipelineBase>>>
+    DeviceBase::CreateRayTracingPipelinesImpl(
+        const std::vector<const RayTracingPipelineDescriptor*>& descriptors) {
+        std::vector<Ref<RayTracingPipelineBase>> pipelines;
+        pipelines.reserve(descriptors.size());
+        for (const RayTracingPipelineDescriptor* descriptor : descriptors) {
+            RayTracingPipelineBase* pipeline = nullptr;
+            DAWN_TRY_ASSIGN(pipeline, CreateRayTracingPipelineImpl(descriptor));
+            pipelines.push_back(AcquireRef(pipeline));
+        }
+        return std::move(pipelines);
+    }
+
+    ResultOrError<std::vector<Ref<RenderPipelineBase>>> DeviceBase::CreateRenderPipelinesImpl(
+        const std::vector<const RenderPipelineDescriptor*>& descriptors) {
+        std::vector<Ref<RenderPipelineBase>> pipelines;
+        pipelines.reserve(descriptors.size());
+        for (const RenderPipelineDescriptor* descriptor : descriptors) {
+            RenderPipelineBase* pipeline = nullptr;
+            DAWN_TRY_ASSIGN(pipeline, CreateRenderPipelineImpl(descriptor));
+            pipelines.push_back(AcquireRef(pipeline));
+        }
+        return std::move(pipelines);
+    }
+
+    MaybeError DeviceBase::CreateRayTracingBundleEncoderInternal(
+        RayTracingBundleEncoder** result,
+        const RayTracingBundleEncoderDescriptor* descriptor) {
+        DAWN_TRY(ValidateIsAlive());
+        *result = new RayTracingBundleEncoder(this, descriptor);
         return {};
     }
 
@@ -845,6 +1819,7 @@ namespace dawn_native {
     MaybeError DeviceBase::CreateRenderPipelineInternal(
         RenderPipelineBase** result,
         const RenderPipelineDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateRenderPipeline");
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateRenderPipelineDescriptor(this, descriptor));
@@ -876,6 +1851,17 @@ namespace dawn_native {
         return {};
     }
 
+    MaybeError DeviceBase::CreateResourceTableInternal(
+        ResourceTableBase** result,
+        const ResourceTableDescriptor* descriptor) {
+        DAWN_TRY(ValidateIsAlive());
+        if (IsValidationEnabled()) {
+            DAWN_TRY(ValidateResourceTableDescriptor(this, descriptor));
+        }
+        DAWN_TRY_ASSIGN(*result, CreateResourceTableImpl(descriptor));
+        return {};
+    }
+
     MaybeError DeviceBase::CreateSamplerInternal(SamplerBase** result,
                                                  const SamplerDescriptor* descriptor) {
         DAWN_TRY(ValidateIsAlive());
@@ -888,6 +1874,7 @@ namespace dawn_native {
 
     MaybeError DeviceBase::CreateShaderModuleInternal(ShaderModuleBase** result,
                                                       const ShaderModuleDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateShaderModule");
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateShaderModuleDescriptor(this, descriptor));
@@ -929,7 +1916,7 @@ namespace dawn_native {
                                                  const TextureDescriptor* descriptor) {
         DAWN_TRY(ValidateIsAlive());
         if (IsValidationEnabled()) {
-            DAWN_TRY(ValidateTextureDescriptor(this, descriptor));
+            DAWN_TRY(mDescriptorValidationCache->ValidateTextureDescriptor(this, descriptor));
         }
         DAWN_TRY_ASSIGN(*result, CreateTextureImpl(descriptor));
         return {};
@@ -944,7 +1931,18 @@ namespace dawn_native {
         if (IsValidationEnabled()) {
             DAWN_TRY(ValidateTextureViewDescriptor(texture, &desc));
         }
-        DAWN_TRY_ASSIGN(*result, CreateTextureViewImpl(texture, &desc));
+        DAWN_TRY_ASSIGN(*result, GetOrCreateTextureView(texture, &desc));
+        return {};
+    }
+
+    MaybeError DeviceBase::CreateTransientUniformAllocatorInternal(
+        TransientUniformAllocator** result,
+        const TransientUniformAllocatorDescriptor* descriptor) {
+        DAWN_TRY(ValidateIsAlive());
+        if (IsValidationEnabled()) {
+            DAWN_TRY(ValidateTransientUniformAllocatorDescriptor(descriptor));
+        }
+        DAWN_TRY_ASSIGN(*result, TransientUniformAllocator::Create(this, descriptor));
         return {};
     }
 
@@ -954,6 +1952,10 @@ namespace dawn_native {
         return mDynamicUploader.get();
     }
 
+    PersistentCache* DeviceBase::GetPersistentCache() const {
+        return mPersistentCache.get();
+    }
+
     void DeviceBase::SetToggle(Toggle toggle, bool isEnabled) {
         mTogglesSet.SetToggle(toggle, isEnabled);
     }
@@ -16,27 +16,47 @@
 #define DAWNNATIVE_DEVICE_H_
 
 #include "common/Serial.h"
+#include "common/SerialQueue.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/Extensions.h"
 #include "dawn_native/Format.h"
 #include "dawn_native/Forward.h"
+#include "dawn_native/MemoryUsageTracker.h"
 #include "dawn_native/ObjectBase.h"
 #include "dawn_native/Toggles.h"
 
 #include "dawn_native/DawnNative.h"
 #include "dawn_native/dawn_platform.h"
 
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace dawn_native {
     class AdapterBase;
     class AttachmentState;
     class AttachmentStateBlueprint;
+    class CommandBlockPool;
+    class CompletionThread;
+    class DescriptorValidationCache;
     class ErrorScope;
     class ErrorScopeTracker;
     class FenceSignalTracker;
+    class PersistentCache;
     class DynamicUploader;
+    class RayTracingAccelerationContainerDescriptorStorage;
+    class RayTracingResidencyManager;
+    class RayTracingPipelineDescriptorStorage;
+    class RenderPipelineDescriptorStorage;
+    class ShaderModuleValidationQueue;
+    struct ShaderModuleValidationTask;
     class StagingBufferBase;
+    struct PassResourceUsage;
+    struct TextureCopy;
+
+    // Guards the calls into a device made from multiple threads, see DeviceBase::GetMutex().
+    using DeviceLock = std::lock_guard<std::recursive_mutex>;
 
     class DeviceBase {
       public:
@@ -68,8 +88,18 @@ namespace dawn_native {
         AdapterBase* GetAdapter() const;
         dawn_platform::Platform* GetPlatform() const;
 
+        // All API calls except the command recording of encoders are serialized with this mutex,
+        // so that each thread can record its own encoders in parallel while the creation of
+        // objects, the caches, the error scopes, the uploads and the submits stay single-threaded.
+        // It is recursive because API calls nest, for example when creating an object releases
+        // another one.
+        std::recursive_mutex& GetMutex();
+
+        CommandBlockPool* GetCommandBlockPool() const;
         ErrorScopeTracker* GetErrorScopeTracker() const;
         FenceSignalTracker* GetFenceSignalTracker() const;
+        MemoryUsageTracker* GetMemoryUsageTracker();
+        RayTracingResidencyManager* GetRayTracingResidencyManager() const;
 
         // Returns the Format corresponding to the wgpu::TextureFormat or an error if the format
         // isn't a valid wgpu::TextureFormat or isn't supported by this device.
@@ -84,10 +114,23 @@ namespace dawn_native {
         virtual CommandBufferBase* CreateCommandBuffer(
             CommandEncoder* encoder,
             const CommandBufferDescriptor* descriptor) = 0;
+        // Backends can override this to keep their own version of the bundle's commands, which
+        // is built once instead of re-encoding the commands each time the bundle is executed.
+        virtual RenderBundleBase* CreateRenderBundle(RenderBundleEncoder* encoder,
+                                                     const RenderBundleDescriptor* descriptor,
+                                                     AttachmentState* attachmentState,
+                                                     PassResourceUsage resourceUsage);
+        virtual RayTracingBundleBase* CreateRayTracingBundle(
+            RayTracingBundleEncoder* encoder,
+            const RayTracingBundleDescriptor* descriptor,
+            PassResourceUsage resourceUsage);
 
         virtual Serial GetCompletedCommandSerial() const = 0;
         virtual Serial GetLastSubmittedCommandSerial() const = 0;
         virtual Serial GetPendingCommandSerial() const = 0;
+        // Whether commands were recorded but not submitted yet, they will complete with the
+        // pending serial.
+        virtual bool HasPendingCommands() const;
         virtual MaybeError TickImpl() = 0;
 
         // Many Dawn objects are completely immutable once created which means that if two
@@ -104,6 +147,9 @@ namespace dawn_native {
         // the created object will be, the "blueprint". The blueprint is just a FooBase object
         // instead of a backend Foo object. If the blueprint doesn't match an object in the
         // cache, then the descriptor is used to make a new object.
+        ResultOrError<BindGroupBase*> GetOrCreateBindGroup(const BindGroupDescriptor* descriptor);
+        void UncacheBindGroup(BindGroupBase* obj);
+
         ResultOrError<BindGroupLayoutBase*> GetOrCreateBindGroupLayout(
             const BindGroupLayoutDescriptor* descriptor);
         void UncacheBindGroupLayout(BindGroupLayoutBase* obj);
@@ -116,6 +162,15 @@ namespace dawn_native {
             const PipelineLayoutDescriptor* descriptor);
         void UncachePipelineLayout(PipelineLayoutBase* obj);
 
+        ResultOrError<RayTracingPipelineBase*> GetOrCreateRayTracingPipeline(
+            const RayTracingPipelineDescriptor* descriptor);
+        void UncacheRayTracingPipeline(RayTracingPipelineBase* obj);
+
+        ResultOrError<RayTracingShaderBindingTableBase*> GetOrCreateRayTracingShaderBindingTable(
+            const RayTracingShaderBindingTableDescriptor* descriptor);
+        // Also called when a cached table is destroyed, it then stops being a cached reference.
+        void UncacheRayTracingShaderBindingTable(RayTracingShaderBindingTableBase* obj);
+
         ResultOrError<RenderPipelineBase*> GetOrCreateRenderPipeline(
             const RenderPipelineDescriptor* descriptor);
         void UncacheRenderPipeline(RenderPipelineBase* obj);
@@ -127,6 +182,11 @@ namespace dawn_native {
             const ShaderModuleDescriptor* descriptor);
         void UncacheShaderModule(ShaderModuleBase* obj);
 
+        ResultOrError<TextureViewBase*> GetOrCreateTextureView(
+            TextureBase* texture,
+            const TextureViewDescriptor* descriptor);
+        void UncacheTextureView(TextureViewBase* obj);
+
         Ref<AttachmentState> GetOrCreateAttachmentState(AttachmentStateBlueprint* blueprint);
         Ref<AttachmentState> GetOrCreateAttachmentState(
             const RenderBundleEncoderDescriptor* descriptor);
@@ -134,13 +194,45 @@ namespace dawn_native {
         Ref<AttachmentState> GetOrCreateAttachmentState(const RenderPassDescriptor* descriptor);
         void UncacheAttachmentState(AttachmentState* obj);
 
+        // The pipeline clamping indirect arguments, created the first time it is needed.
+        ResultOrError<ComputePipelineBase*> GetOrCreateIndirectValidationPipeline();
+        // Creates a buffer that is only used by Dawn, skipping the validation of the descriptor.
+        ResultOrError<Ref<BufferBase>> CreateInternalBuffer(const BufferDescriptor* descriptor);
+
+        // The live transient uniform allocators, whose allocations are uploaded before each
+        // submit.
+        void AddTransientUniformAllocator(TransientUniformAllocator* allocator);
+        void RemoveTransientUniformAllocator(TransientUniformAllocator* allocator);
+        void FlushTransientUniformAllocators(QueueBase* queue);
+
         // Dawn API
         RayTracingAccelerationContainerBase* CreateRayTracingAccelerationContainer(
             const RayTracingAccelerationContainerDescriptor* descriptor);
+        void CreateRayTracingAccelerationContainerAsync(
+            const RayTracingAccelerationContainerDescriptor* descriptor,
+            wgpu::RayTracingAccelerationContainerCreateCallback callback,
+            void* userdata);
+        void GetRayTracingAccelerationContainerHandles(
+            uint32_t containerCount,
+            RayTracingAccelerationContainerBase* const* containers,
+            uint64_t* handles);
+        void GetRayTracingAccelerationContainerMemoryInfo(
+            RayTracingAccelerationContainerMemoryInfo* info) const;
+        // The packing of the instance records, for shaders writing instance buffers.
+        void GetRayTracingAccelerationInstanceLayout(
+            RayTracingAccelerationInstanceLayout* layout) const;
+        void GetMemoryUsage(MemoryUsage* usage) const;
+        uint32_t GetMemoryTypeUsages(uint32_t usageCount, MemoryTypeUsage* usages) const;
+        void SetRayTracingAccelerationContainerResidencyBudget(uint64_t budget);
         RayTracingShaderBindingTableBase* CreateRayTracingShaderBindingTable(
             const RayTracingShaderBindingTableDescriptor* descriptor);
         RayTracingPipelineBase* CreateRayTracingPipeline(
             const RayTracingPipelineDescriptor* descriptor);
+        void CreateRayTracingPipelineAsync(const RayTracingPipelineDescriptor* descriptor,
+                                           wgpu::RayTracingPipelineCreateCallback callback,
+                                           void* userdata);
+        RayTracingBundleEncoder* CreateRayTracingBundleEncoder(
+            const RayTracingBundleEncoderDescriptor* descriptor);
         BindGroupBase* CreateBindGroup(const BindGroupDescriptor* descriptor);
         BindGroupLayoutBase* CreateBindGroupLayout(const BindGroupLayoutDescriptor* descriptor);
         BufferBase* CreateBuffer(const BufferDescriptor* descriptor);
@@ -151,21 +243,47 @@ namespace dawn_native {
         CommandEncoder* CreateCommandEncoder(const CommandEncoderDescriptor* descriptor);
         ComputePipelineBase* CreateComputePipeline(const ComputePipelineDescriptor* descriptor);
         PipelineLayoutBase* CreatePipelineLayout(const PipelineLayoutDescriptor* descriptor);
-        QueueBase* CreateQueue();
+        QuerySetBase* CreateQuerySet(const QuerySetDescriptor* descriptor);
+        QueueBase* CreateQueue(const QueueDescriptor* descriptor);
         RenderBundleEncoder* CreateRenderBundleEncoder(
             const RenderBundleEncoderDescriptor* descriptor);
         RenderPipelineBase* CreateRenderPipeline(const RenderPipelineDescriptor* descriptor);
+        void CreateRenderPipelineAsync(const RenderPipelineDescriptor* descriptor,
+                                       wgpu::RenderPipelineCreateCallback callback,
+                                       void* userdata);
+        ResourceTableBase* CreateResourceTable(const ResourceTableDescriptor* descriptor);
         SamplerBase* CreateSampler(const SamplerDescriptor* descriptor);
         ShaderModuleBase* CreateShaderModule(const ShaderModuleDescriptor* descriptor);
+        void CreateShaderModuleAsync(const ShaderModuleDescriptor* descriptor,
+                                     wgpu::ShaderModuleCreateCallback callback,
+                                     void* userdata);
         SwapChainBase* CreateSwapChain(Surface* surface, const SwapChainDescriptor* descriptor);
         TextureBase* CreateTexture(const TextureDescriptor* descriptor);
         TextureViewBase* CreateTextureView(TextureBase* texture,
                                            const TextureViewDescriptor* descriptor);
+        TransientUniformAllocator* CreateTransientUniformAllocator(
+            const TransientUniformAllocatorDescriptor* descriptor);
 
         void InjectError(wgpu::ErrorType type, const char* message);
 
         void Tick();
 
+        // Returns false if the device is lost or already has a completion thread.
+        bool StartCompletionThread(const CompletionThreadDescriptor& descriptor);
+        // Called when a callback was added which needs the device to be ticked, to notify the
+        // application when there is a completion thread.
+        void RequestCompletionTick();
+        // Blocks until |serial| completed or |timeoutNs| elapsed, and returns whether it completed.
+        // Called on the completion thread, concurrently with the rest of the device, so backends
+        // only use objects which can be waited on from any thread. The default implementation
+        // can't wait and returns true after a short delay, which makes the application poll the
+        // device while commands are in flight.
+        virtual bool WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs);
+
+        // Counts the buffers waiting for their map callback.
+        void DidStartMapAsync();
+        void DidFinishMapAsync();
+
         void SetDeviceLostCallback(wgpu::DeviceLostCallback callback, void* userdata);
         void SetUncapturedErrorCallback(wgpu::ErrorCallback callback, void* userdata);
         void PushErrorScope(wgpu::ErrorFilter filter);
@@ -185,16 +303,47 @@ namespace dawn_native {
                                                    BufferBase* destination,
                                                    uint64_t destinationOffset,
                                                    uint64_t size) = 0;
+        // Copies |copySize| texels from the staging buffer, where the rows are |rowPitch| bytes
+        // apart and the images |imageHeight| texels tall, into |destination|. |rowPitch| is a
+        // multiple of kTextureRowPitchAlignment. The default implementation returns an error for
+        // the backends which don't support it.
+        virtual MaybeError CopyFromStagingToTexture(StagingBufferBase* source,
+                                                    uint64_t sourceOffset,
+                                                    uint32_t rowPitch,
+                                                    uint32_t imageHeight,
+                                                    const TextureCopy& destination,
+                                                    const Extent3D& copySize);
 
         DynamicUploader* GetDynamicUploader() const;
+        PersistentCache* GetPersistentCache() const;
 
         std::vector<const char*> GetEnabledExtensions() const;
         std::vector<const char*> GetTogglesUsed() const;
         bool IsExtensionEnabled(Extension extension) const;
         bool IsToggleEnabled(Toggle toggle) const;
         bool IsValidationEnabled() const;
+        // Categories of validation which can be skipped on their own for trusted commands. They
+        // are all skipped when validation is.
+        bool IsDrawStateValidationEnabled() const;
+        bool IsResourceUsageValidationEnabled() const;
+        bool IsCopyBoundsValidationEnabled() const;
+        bool IsBindGroupCompatibilityValidationEnabled() const;
         size_t GetLazyClearCountForTesting();
         void IncrementLazyClearCountForTesting();
+        // Keeps the device-wide sum of the memory used by acceleration containers up to date.
+        void TrackRayTracingAccelerationContainerMemory(
+            const RayTracingAccelerationContainerMemoryInfo& previousInfo,
+            const RayTracingAccelerationContainerMemoryInfo& info);
+        // Bumped whenever a container gets destroyed or evicted, so that top-level containers only
+        // validate their geometry containers again when one of them might have become unusable.
+        uint64_t GetRayTracingAccelerationContainerGeneration() const;
+        void InvalidateRayTracingAccelerationContainerGeneration();
+        // Calls the callback with the build info of the container once |buildSerial| completed.
+        void AddRayTracingAccelerationContainerBuildInfoRequest(
+            RayTracingAccelerationContainerBase* container,
+            Serial buildSerial,
+            wgpu::RayTracingAccelerationContainerGetBuildInfoCallback callback,
+            void* userdata);
         void LoseForTesting();
         bool IsLost() const;
 
@@ -219,6 +368,15 @@ namespace dawn_native {
             const RayTracingShaderBindingTableDescriptor* descriptor) = 0;
         virtual ResultOrError<RayTracingPipelineBase*> CreateRayTracingPipelineImpl(
             const RayTracingPipelineDescriptor* descriptor) = 0;
+        // Creates several pipelines at once, backends which can compile them in a single call
+        // override this. The default implementation creates the pipelines one by one.
+        virtual ResultOrError<std::vector<Ref<RayTracingPipelineBase>>>
+        CreateRayTracingPipelinesImpl(
+            const std::vector<const RayTracingPipelineDescriptor*>& descriptors);
+        // The usage of the memory types the backend allocates resources from, and the amount of
+        // descriptor pools or heaps it allocated. The default implementations report none.
+        virtual std::vector<MemoryTypeUsage> GetMemoryTypeUsagesImpl() const;
+        virtual uint64_t GetDescriptorPoolCountImpl() const;
         virtual ResultOrError<BindGroupBase*> CreateBindGroupImpl(
             const BindGroupDescriptor* descriptor) = 0;
         virtual ResultOrError<BindGroupLayoutBase*> CreateBindGroupLayoutImpl(
@@ -228,9 +386,17 @@ namespace dawn_native {
             const ComputePipelineDescriptor* descriptor) = 0;
         virtual ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) = 0;
-        virtual ResultOrError<QueueBase*> CreateQueueImpl() = 0;
+        virtual ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) = 0;
+        virtual ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) = 0;
         virtual ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) = 0;
+        // Creates several pipelines at once, backends which can compile them in a single call
+        // override this. The default implementation creates the pipelines one by one.
+        virtual ResultOrError<std::vector<Ref<RenderPipelineBase>>> CreateRenderPipelinesImpl(
+            const std::vector<const RenderPipelineDescriptor*>& descriptors);
+        virtual ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) = 0;
         virtual ResultOrError<SamplerBase*> CreateSamplerImpl(
             const SamplerDescriptor* descriptor) = 0;
         virtual ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
@@ -248,6 +414,11 @@ namespace dawn_native {
             TextureBase* texture,
             const TextureViewDescriptor* descriptor) = 0;
 
+        MaybeError GetRayTracingAccelerationContainerHandlesInternal(
+            uint32_t containerCount,
+            RayTracingAccelerationContainerBase* const* containers,
+            uint64_t* handles);
+
         MaybeError CreateRayTracingAccelerationContainerInternal(RayTracingAccelerationContainerBase** result,
                                            const RayTracingAccelerationContainerDescriptor* descriptor);
         MaybeError CreateRayTracingShaderBindingTableInternal(RayTracingShaderBindingTableBase** result,
@@ -263,12 +434,19 @@ namespace dawn_native {
                                                  const ComputePipelineDescriptor* descriptor);
         MaybeError CreatePipelineLayoutInternal(PipelineLayoutBase** result,
                                                 const PipelineLayoutDescriptor* descriptor);
-        MaybeError CreateQueueInternal(QueueBase** result);
+        MaybeError CreateQuerySetInternal(QuerySetBase** result,
+                                          const QuerySetDescriptor* descriptor);
+        MaybeError CreateQueueInternal(QueueBase** result, const QueueDescriptor* descriptor);
+        MaybeError CreateRayTracingBundleEncoderInternal(
+            RayTracingBundleEncoder** result,
+            const RayTracingBundleEncoderDescriptor* descriptor);
         MaybeError CreateRenderBundleEncoderInternal(
             RenderBundleEncoder** result,
             const RenderBundleEncoderDescriptor* descriptor);
         MaybeError CreateRenderPipelineInternal(RenderPipelineBase** result,
                                                 const RenderPipelineDescriptor* descriptor);
+        MaybeError CreateResourceTableInternal(ResourceTableBase** result,
+                                               const ResourceTableDescriptor* descriptor);
         MaybeError CreateSamplerInternal(SamplerBase** result, const SamplerDescriptor* descriptor);
         MaybeError CreateShaderModuleInternal(ShaderModuleBase** result,
                                               const ShaderModuleDescriptor* descriptor);
@@ -279,6 +457,9 @@ namespace dawn_native {
         MaybeError CreateTextureViewInternal(TextureViewBase** result,
                                              TextureBase* texture,
                                              const TextureViewDescriptor* descriptor);
+        MaybeError CreateTransientUniformAllocatorInternal(
+            TransientUniformAllocator** result,
+            const TransientUniformAllocatorDescriptor* descriptor);
 
         void ApplyExtensions(const DeviceDescriptor* deviceDescriptor);
 
@@ -297,19 +478,39 @@ namespace dawn_native {
         virtual MaybeError WaitForIdleForDestruction() = 0;
 
         void HandleLoss(const char* message);
+        // Whether callbacks will be called by a later tick.
+        bool HasPendingCallbacks() const;
         wgpu::DeviceLostCallback mDeviceLostCallback = nullptr;
         void* mDeviceLostUserdata;
 
+        // Declared first so that it outlives the objects released while destroying the device.
+        std::recursive_mutex mMutex;
+        // Declared early so that it outlives the objects it tracks.
+        MemoryUsageTracker mMemoryUsageTracker;
+
         AdapterBase* mAdapter = nullptr;
 
         Ref<ErrorScope> mRootErrorScope;
         Ref<ErrorScope> mCurrentErrorScope;
 
+        // Declared before the objects which can own commands so that it is destroyed after them.
+        std::unique_ptr<CommandBlockPool> mCommandBlockPool;
+
         // The object caches aren't exposed in the header as they would require a lot of
         // additional includes.
         struct Caches;
         std::unique_ptr<Caches> mCaches;
 
+        // Holds references to cached objects, released before the caches are checked to be empty.
+        Ref<ComputePipelineBase> mIndirectValidationPipeline;
+
+        // Returns the cached object equal to the blueprint with an added reference, or nullptr.
+        // |blueprintHash| is the hash of the blueprint's content.
+        template <typename T, typename Cache, typename Blueprint>
+        T* FindCachedObject(Cache* cache, const Blueprint* blueprint, size_t blueprintHash);
+        template <typename Cache, typename T>
+        void InsertCachedObject(Cache* cache, T* object, size_t contentHash);
+
         struct DeferredCreateBufferMappedAsync {
             wgpu::BufferCreateMappedCallback callback;
             WGPUBufferMapAsyncStatus status;
@@ -317,17 +518,91 @@ namespace dawn_native {
             void* userdata;
         };
 
+        struct DeferredCreateRayTracingAccelerationContainerAsync {
+            wgpu::RayTracingAccelerationContainerCreateCallback callback;
+            std::unique_ptr<RayTracingAccelerationContainerDescriptorStorage> descriptor;
+            void* userdata;
+        };
+
+        // Creating acceleration containers is spread over several ticks so that creating a
+        // large amount of them doesn't stall a single frame.
+        void TickDeferredCreateRayTracingAccelerationContainerAsync();
+        void RejectDeferredCreateRayTracingAccelerationContainerAsync();
+
+        struct RayTracingAccelerationContainerBuildInfoRequest {
+            Ref<RayTracingAccelerationContainerBase> container;
+            wgpu::RayTracingAccelerationContainerGetBuildInfoCallback callback;
+            void* userdata;
+        };
+
+        void TickRayTracingAccelerationContainerBuildInfoRequests(Serial completedSerial);
+        void RejectRayTracingAccelerationContainerBuildInfoRequests();
+
+        struct DeferredCreateRayTracingPipelineAsync {
+            wgpu::RayTracingPipelineCreateCallback callback;
+            std::unique_ptr<RayTracingPipelineDescriptorStorage> descriptor;
+            void* userdata;
+        };
+
+        // Pending pipelines are compiled together, a bounded number per tick.
+        void TickDeferredCreateRayTracingPipelineAsync();
+        void RejectDeferredCreateRayTracingPipelineAsync();
+
+        struct DeferredCreateRenderPipelineAsync {
+            wgpu::RenderPipelineCreateCallback callback;
+            std::unique_ptr<RenderPipelineDescriptorStorage> descriptor;
+            void* userdata;
+        };
+
+        void TickDeferredCreateRenderPipelineAsync();
+        void RejectDeferredCreateRenderPipelineAsync();
+
+        struct DeferredCreateShaderModuleAsync {
+            wgpu::ShaderModuleCreateCallback callback;
+            std::vector<uint32_t> code;
+            // Only the code is copied, chained structures are rejected when validating.
+            bool hasChainedStructs;
+            // Only set when the code is validated on the worker threads.
+            std::shared_ptr<ShaderModuleValidationTask> validation;
+            void* userdata;
+        };
+
+        // The modules are created once their validation completes, in any order. Without worker
+        // threads they are validated in the tick, a bounded number per tick.
+        void TickDeferredCreateShaderModuleAsync();
+        void RejectDeferredCreateShaderModuleAsync();
+
+        std::unique_ptr<DescriptorValidationCache> mDescriptorValidationCache;
         std::unique_ptr<ErrorScopeTracker> mErrorScopeTracker;
         std::unique_ptr<FenceSignalTracker> mFenceSignalTracker;
+        std::unique_ptr<PersistentCache> mPersistentCache;
+        std::unique_ptr<RayTracingResidencyManager> mRayTracingResidencyManager;
         std::vector<DeferredCreateBufferMappedAsync> mDeferredCreateBufferMappedAsyncResults;
+        std::deque<DeferredCreateRayTracingAccelerationContainerAsync>
+            mDeferredCreateRayTracingAccelerationContainerAsync;
+        SerialQueue<RayTracingAccelerationContainerBuildInfoRequest>
+            mRayTracingAccelerationContainerBuildInfoRequests;
+        std::deque<DeferredCreateRayTracingPipelineAsync> mDeferredCreateRayTracingPipelineAsync;
+        std::deque<DeferredCreateRenderPipelineAsync> mDeferredCreateRenderPipelineAsync;
+        std::deque<DeferredCreateShaderModuleAsync> mDeferredCreateShaderModuleAsync;
+        // Created with the first module validated on worker threads.
+        std::unique_ptr<ShaderModuleValidationQueue> mShaderModuleValidationQueue;
+        uint32_t mPendingMapAsyncCount = 0;
+
+        std::unique_ptr<CompletionThread> mCompletionThread;
+
+        std::vector<TransientUniformAllocator*> mTransientUniformAllocators;
 
         uint32_t mRefCount = 1;
 
-        FormatTable mFormatTable;
+        FormatSet mSupportedFormats;
 
         TogglesSet mTogglesSet;
         size_t mLazyClearCountForTesting = 0;
 
+        RayTracingAccelerationContainerMemoryInfo mRayTracingAccelerationContainerMemoryInfo;
+        uint64_t mRayTracingAccelerationContainerGeneration = 1;
+
         ExtensionsSet mEnabledExtensions;
     };
 
@@ -15,12 +15,16 @@
 #include "dawn_native/DynamicUploader.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <algorithm>
 
 namespace dawn_native {
 
     DynamicUploader::DynamicUploader(DeviceBase* device) : mDevice(device) {
         mRingBuffers.emplace_back(std::unique_ptr<RingBuffer>(
-            new RingBuffer{nullptr, RingBufferAllocator(kRingBufferSize)}));
+            new RingBuffer{nullptr, RingBufferAllocator(kMinRingBufferSize)}));
     }
 
     void DynamicUploader::ReleaseStagingBuffer(std::unique_ptr<StagingBufferBase> stagingBuffer) {
@@ -28,18 +32,87 @@ namespace dawn_native {
                                         mDevice->GetPendingCommandSerial());
     }
 
-    ResultOrError<UploadHandle> DynamicUploader::Allocate(uint64_t allocationSize, Serial serial) {
-        // Disable further sub-allocation should the request be too large.
-        if (allocationSize > kRingBufferSize) {
-            std::unique_ptr<StagingBufferBase> stagingBuffer;
-            DAWN_TRY_ASSIGN(stagingBuffer, mDevice->CreateStagingBuffer(allocationSize));
+    uint64_t DynamicUploader::GetStagingSize() const {
+        uint64_t size = 0;
+        for (const std::unique_ptr<RingBuffer>& ringBuffer : mRingBuffers) {
+            if (ringBuffer->mStagingBuffer != nullptr) {
+                size += ringBuffer->mStagingBuffer->GetSize();
+            }
+        }
+        for (const std::unique_ptr<StagingBufferBase>& buffer :
+             mReleasedStagingBuffers.IterateAll()) {
+            size += buffer->GetSize();
+        }
+        for (const std::unique_ptr<StagingBufferBase>& buffer :
+             mInflightLargeStagingBuffers.IterateAll()) {
+            size += buffer->GetSize();
+        }
+        for (const std::unique_ptr<StagingBufferBase>& buffer : mFreeLargeStagingBuffers) {
+            size += buffer->GetSize();
+        }
+        return size;
+    }
+
+    uint64_t DynamicUploader::GetRingBufferSize() const {
+        uint64_t size = std::max(kMinRingBufferSize, mPeakUploadSizePerSerial);
+        return std::min(kMaxRingBufferSize, NextPowerOfTwo(size));
+    }
+
+    void DynamicUploader::TrackUploadSize(uint64_t allocationSize, Serial serial) {
+        if (serial != mLastUploadSerial) {
+            // Decay the peak so that the ring buffers created after a burst of uploads shrink
+            // back over time.
+            mPeakUploadSizePerSerial -= mPeakUploadSizePerSerial / 8;
+            mLastUploadSerial = serial;
+            mLastSerialUploadSize = 0;
+        }
+
+        mLastSerialUploadSize += allocationSize;
+        mPeakUploadSizePerSerial = std::max(mPeakUploadSizePerSerial, mLastSerialUploadSize);
+    }
 
-            UploadHandle uploadHandle;
-            uploadHandle.mappedBuffer = static_cast<uint8_t*>(stagingBuffer->GetMappedPointer());
-            uploadHandle.stagingBuffer = stagingBuffer.get();
+    ResultOrError<UploadHandle> DynamicUploader::AllocateLargeStagingBuffer(
+        uint64_t allocationSize,
+        Serial serial) {
+        // Best-fit: reuse the smallest free staging buffer large enough for the request.
+        auto bestFit = mFreeLargeStagingBuffers.end();
+        for (auto it = mFreeLargeStagingBuffers.begin(); it != mFreeLargeStagingBuffers.end();
+             ++it) {
+            if ((*it)->GetSize() >= allocationSize &&
+                (bestFit == mFreeLargeStagingBuffers.end() ||
+                 (*it)->GetSize() < (*bestFit)->GetSize())) {
+                bestFit = it;
+            }
+        }
+
+        std::unique_ptr<StagingBufferBase> stagingBuffer;
+        if (bestFit != mFreeLargeStagingBuffers.end()) {
+            stagingBuffer = std::move(*bestFit);
+            mFreeLargeStagingBuffers.erase(bestFit);
+        } else {
+            // Round the size up so that the buffer can be reused by uploads of similar sizes.
+            uint64_t stagingBufferSize =
+                (allocationSize + kMinRingBufferSize - 1) / kMinRingBufferSize *
+                kMinRingBufferSize;
+            DAWN_TRY_ASSIGN(stagingBuffer, mDevice->CreateStagingBuffer(stagingBufferSize));
+        }
+
+        UploadHandle uploadHandle;
+        uploadHandle.mappedBuffer = static_cast<uint8_t*>(stagingBuffer->GetMappedPointer());
+        uploadHandle.stagingBuffer = stagingBuffer.get();
+
+        mInflightLargeStagingBuffers.Enqueue(std::move(stagingBuffer), serial);
+        return uploadHandle;
+    }
+
+    ResultOrError<UploadHandle> DynamicUploader::Allocate(uint64_t allocationSize, Serial serial) {
+        TRACE_EVENT0(mDevice->GetPlatform(), General, "DynamicUploader::Allocate");
+        TrackUploadSize(allocationSize, serial);
 
-            ReleaseStagingBuffer(std::move(stagingBuffer));
-            return uploadHandle;
+        // Disable further sub-allocation should the request be too large.
+        uint64_t ringBufferSize = GetRingBufferSize();
+        if (allocationSize > ringBufferSize) {
+            return AllocateLargeStagingBuffer(allocationSize, serial);
         }
 
         // Note: Validation ensures size is already aligned.
@@ -62,11 +135,11 @@ namespace dawn_native {
             startOffset = targetRingBuffer->mAllocator.Allocate(allocationSize, serial);
         }
 
-        // Upon failure, append a newly created ring buffer to fulfill the
-        // request.
+        // Upon failure, append a newly created ring buffer, sized for the recent upload volume,
+        // to fulfill the request.
         if (startOffset == RingBufferAllocator::kInvalidOffset) {
             mRingBuffers.emplace_back(std::unique_ptr<RingBuffer>(
-                new RingBuffer{nullptr, RingBufferAllocator(kRingBufferSize)}));
+                new RingBuffer{nullptr, RingBufferAllocator(ringBufferSize)}));
 
             targetRingBuffer = mRingBuffers.back().get();
             startOffset = targetRingBuffer->mAllocator.Allocate(allocationSize, serial);
@@ -100,12 +173,24 @@ namespace dawn_native {
         for (size_t i = 0; i < mRingBuffers.size(); ++i) {
             mRingBuffers[i]->mAllocator.Deallocate(lastCompletedSerial);
 
-            // Never erase the last buffer as to prevent re-creating smaller buffers
-            // again. The last buffer is the largest.
+            // Never erase the last buffer as to prevent re-creating it for the next upload.
             if (mRingBuffers[i]->mAllocator.Empty() && i < mRingBuffers.size() - 1) {
                 mRingBuffers.erase(mRingBuffers.begin() + i);
             }
         }
         mReleasedStagingBuffers.ClearUpTo(lastCompletedSerial);
+
+        // Recycle the large staging buffers, dropping the oldest ones when there are too many.
+        for (std::unique_ptr<StagingBufferBase>& stagingBuffer :
+             mInflightLargeStagingBuffers.IterateUpTo(lastCompletedSerial)) {
+            mFreeLargeStagingBuffers.push_back(std::move(stagingBuffer));
+        }
+        mInflightLargeStagingBuffers.ClearUpTo(lastCompletedSerial);
+
+        if (mFreeLargeStagingBuffers.size() > kMaxFreeLargeStagingBuffers) {
+            size_t excess = mFreeLargeStagingBuffers.size() - kMaxFreeLargeStagingBuffers;
+            mFreeLargeStagingBuffers.erase(mFreeLargeStagingBuffers.begin(),
+                                           mFreeLargeStagingBuffers.begin() + excess);
+        }
     }
-}  // namespace dawn_native
\ No newline at end of file
+}  // namespace dawn_native
@@ -15,12 +15,17 @@
 #ifndef DAWNNATIVE_DYNAMICUPLOADER_H_
 #define DAWNNATIVE_DYNAMICUPLOADER_H_
 
+#include "common/FlatSerialQueue.h"
 #include "dawn_native/Forward.h"
 #include "dawn_native/RingBufferAllocator.h"
 #include "dawn_native/StagingBuffer.h"
 
 // DynamicUploader is the front-end implementation used to manage multiple ring buffers for upload
-// usage.
+// usage. Uploads are recorded in the device's pending commands, so the uploader is only used while
+// holding the device's mutex, see DeviceBase::GetMutex().
+// New ring buffers are sized after the largest volume recently uploaded in a single serial, and
+// uploads which don't fit in a ring buffer use staging buffers recycled once their serial is
+// completed.
 namespace dawn_native {
 
     struct UploadHandle {
@@ -43,16 +48,38 @@ namespace dawn_native {
         ResultOrError<UploadHandle> Allocate(uint64_t allocationSize, Serial serial);
         void Deallocate(Serial lastCompletedSerial);
 
+        // The size of the staging buffers the uploader currently holds on to.
+        uint64_t GetStagingSize() const;
+
       private:
-        static constexpr uint64_t kRingBufferSize = 4 * 1024 * 1024;
+        static constexpr uint64_t kMinRingBufferSize = 4 * 1024 * 1024;
+        static constexpr uint64_t kMaxRingBufferSize = 256 * 1024 * 1024;
+        static constexpr size_t kMaxFreeLargeStagingBuffers = 4;
 
         struct RingBuffer {
             std::unique_ptr<StagingBufferBase> mStagingBuffer;
             RingBufferAllocator mAllocator;
         };
 
+        uint64_t GetRingBufferSize() const;
+        void TrackUploadSize(uint64_t allocationSize, Serial serial);
+        ResultOrError<UploadHandle> AllocateLargeStagingBuffer(uint64_t allocationSize,
+                                                               Serial serial);
+
         std::vector<std::unique_ptr<RingBuffer>> mRingBuffers;
-        SerialQueue<std::unique_ptr<StagingBufferBase>> mReleasedStagingBuffers;
+        FlatSerialQueue<std::unique_ptr<StagingBufferBase>> mReleasedStagingBuffers;
+
+        // Staging buffers of uploads too large for the ring buffers, which are reused once the
+        // uploads they contain have completed.
+        FlatSerialQueue<std::unique_ptr<StagingBufferBase>> mInflightLargeStagingBuffers;
+        std::vector<std::unique_ptr<StagingBufferBase>> mFreeLargeStagingBuffers;
+
+        // The size uploaded in the serial of the last allocation, and a peak of the sizes uploaded
+        // per serial which decays over the following serials.
+        Serial mLastUploadSerial = 0;
+        uint64_t mLastSerialUploadSize = 0;
+        uint64_t mPeakUploadSizePerSerial = 0;
+
         DeviceBase* mDevice;
     };
 }  // namespace dawn_native
@@ -23,8 +23,14 @@
 
 namespace dawn_native {
 
-    EncodingContext::EncodingContext(DeviceBase* device, const ObjectBase* initialEncoder)
-        : mDevice(device), mTopLevelEncoder(initialEncoder), mCurrentEncoder(initialEncoder) {
+    EncodingContext::EncodingContext(DeviceBase* device,
+                                     const ObjectBase* initialEncoder,
+                                     bool validatesIndirectArguments)
+        : mDevice(device),
+          mTopLevelEncoder(initialEncoder),
+          mCurrentEncoder(initialEncoder),
+          mAllocator(device->GetCommandBlockPool()),
+          mValidatesIndirectArguments(validatesIndirectArguments) {
     }
 
     EncodingContext::~EncodingContext() {
@@ -46,9 +52,33 @@ namespace dawn_native {
         return &mIterator;
     }
 
+    void EncodingContext::RetainObject(ObjectBase* object) {
+        ASSERT(!mWereRetainedObjectsAcquired);
+        if (object == mLastRetainedObject) {
+            return;
+        }
+        mLastRetainedObject = object;
+        if (mRetainedObjectSet.insert(object).second) {
+            mRetainedObjects.emplace_back(object);
+        }
+    }
+
+    RetainedObjects EncodingContext::AcquireRetainedObjects() {
+        ASSERT(!mWereRetainedObjectsAcquired);
+        mWereRetainedObjectsAcquired = true;
+        mRetainedObjectSet.clear();
+        return std::move(mRetainedObjects);
+    }
+
     void EncodingContext::MoveToIterator() {
         if (!mWasMovedToIterator) {
-            mIterator = std::move(mAllocator);
+            if (mCommandSegments.empty()) {
+                mIterator = std::move(mAllocator);
+            } else {
+                mCommandSegments.push_back(mAllocator.AcquireRecordedBlocks());
+                mIterator = CommandIterator(std::move(mCommandSegments),
+                                            mDevice->GetCommandBlockPool());
+            }
             mWasMovedToIterator = true;
         }
     }
@@ -66,6 +96,13 @@ namespace dawn_native {
         }
     }
 
+    void EncodingContext::ConsumeError(std::unique_ptr<ErrorData> error) {
+        if (!IsFinished() && mGotError) {
+            return;
+        }
+        HandleError(error->GetType(), error->GetMessage().c_str());
+    }
+
     void EncodingContext::EnterPass(const ObjectBase* passEncoder) {
         // Assert we're at the top level.
         ASSERT(mCurrentEncoder == mTopLevelEncoder);
@@ -95,6 +132,52 @@ namespace dawn_native {
         return std::move(mPassUsages);
     }
 
+    bool EncodingContext::ValidatesIndirectArguments() const {
+        return mValidatesIndirectArguments;
+    }
+
+    void EncodingContext::WillBeginPass() {
+        if (!mValidatesIndirectArguments || IsFinished()) {
+            return;
+        }
+        mCommandSegments.push_back(mAllocator.AcquireRecordedBlocks());
+    }
+
+    void EncodingContext::AddIndirectValidation(IndirectValidationRequest request) {
+        ASSERT(mValidatesIndirectArguments);
+        // The pass being encoded gets its usages at index mPassUsages.size() once it ends, and
+        // its commands start at the segment following those recorded before it.
+        const size_t passIndex = mPassUsages.size();
+        if (mIndirectValidatedPasses.empty() ||
+            mIndirectValidatedPasses.back().passIndex != passIndex) {
+            mIndirectValidatedPasses.push_back({passIndex, mCommandSegments.size(), {}});
+        }
+        mIndirectValidatedPasses.back().requests.push_back(std::move(request));
+    }
+
+    MaybeError EncodingContext::EncodeIndirectValidation() {
+        ASSERT(!mWasMovedToIterator);
+        if (mIndirectValidatedPasses.empty()) {
+            return {};
+        }
+
+        // Inserting from the last pass keeps the indices of the previous ones valid.
+        mCommandSegments.push_back(mAllocator.AcquireRecordedBlocks());
+        for (auto it = mIndirectValidatedPasses.rbegin(); it != mIndirectValidatedPasses.rend();
+             ++it) {
+            PassResourceUsage validationPassUsage;
+            DAWN_TRY(EncodeIndirectValidationPass(mDevice, this, &mAllocator, it->requests,
+                                                  &validationPassUsage,
+                                                  &mPassUsages[it->passIndex]));
+            mCommandSegments.insert(mCommandSegments.begin() + it->segmentIndex,
+                                    mAllocator.AcquireRecordedBlocks());
+            mPassUsages.insert(mPassUsages.begin() + it->passIndex,
+                               std::move(validationPassUsage));
+        }
+        mIndirectValidatedPasses.clear();
+        return {};
+    }
+
     MaybeError EncodingContext::Finish() {
         if (IsFinished()) {
             return DAWN_VALIDATION_ERROR("Command encoding already finished");
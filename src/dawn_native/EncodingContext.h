@@ -18,32 +18,45 @@
 #include "dawn_native/CommandAllocator.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ErrorData.h"
+#include "dawn_native/IndirectValidation.h"
+#include "dawn_native/ObjectBase.h"
 #include "dawn_native/PassResourceUsageTracker.h"
 #include "dawn_native/dawn_platform.h"
 
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace dawn_native {
 
     class DeviceBase;
-    class ObjectBase;
+
+    // The objects referenced by the commands of an encoder that hold raw pointers.
+    using RetainedObjects = std::vector<Ref<ObjectBase>>;
 
     // Base class for allocating/iterating commands.
     // It performs error tracking as well as encoding state for render/compute passes.
     class EncodingContext {
       public:
-        EncodingContext(DeviceBase* device, const ObjectBase* initialEncoder);
+        // The indirect arguments are only validated on the GPU by |validatesIndirectArguments|
+        // contexts, which are those of command encoders with the toggle enabled.
+        EncodingContext(DeviceBase* device,
+                        const ObjectBase* initialEncoder,
+                        bool validatesIndirectArguments = false);
         ~EncodingContext();
 
         CommandIterator AcquireCommands();
         CommandIterator* GetIterator();
 
+        // Keeps |object| alive as long as the commands, references each unique object once.
+        void RetainObject(ObjectBase* object);
+        RetainedObjects AcquireRetainedObjects();
+
         // Functions to handle encoder errors
         void HandleError(wgpu::ErrorType type, const char* message);
-
-        inline void ConsumeError(std::unique_ptr<ErrorData> error) {
-            HandleError(error->GetType(), error->GetMessage().c_str());
-        }
+        // Only the first error of an encoder is reported, the message of the following ones is
+        // never formatted.
+        void ConsumeError(std::unique_ptr<ErrorData> error);
 
         inline bool ConsumedError(MaybeError maybeError) {
             if (DAWN_UNLIKELY(maybeError.IsError())) {
@@ -78,6 +91,15 @@ namespace dawn_native {
         const PerPassUsages& GetPassUsages() const;
         PerPassUsages AcquirePassUsages();
 
+        // Functions to clamp indirect arguments on the GPU, see IndirectValidation.h
+        bool ValidatesIndirectArguments() const;
+        // Called before the command beginning a pass is recorded, so that the pass validating its
+        // indirect arguments can be inserted before it.
+        void WillBeginPass();
+        void AddIndirectValidation(IndirectValidationRequest request);
+        // Inserts the validation passes, called after the usages were validated.
+        MaybeError EncodeIndirectValidation();
+
       private:
         bool IsFinished() const;
         void MoveToIterator();
@@ -102,6 +124,24 @@ namespace dawn_native {
         bool mWasMovedToIterator = false;
         bool mWereCommandsAcquired = false;
 
+        // The commands are split before each pass when indirect arguments are validated, the
+        // commands of the validation passes are inserted in between the segments.
+        struct IndirectValidatedPass {
+            size_t passIndex;
+            size_t segmentIndex;
+            std::vector<IndirectValidationRequest> requests;
+        };
+        bool mValidatesIndirectArguments;
+        std::vector<CommandBlocks> mCommandSegments;
+        std::vector<IndirectValidatedPass> mIndirectValidatedPasses;
+
+        // The same object is often set many times in a row, so the last one is checked before
+        // looking up the set.
+        const ObjectBase* mLastRetainedObject = nullptr;
+        std::unordered_set<const ObjectBase*> mRetainedObjectSet;
+        RetainedObjects mRetainedObjects;
+        bool mWereRetainedObjectsAcquired = false;
+
         bool mGotError = false;
         std::string mErrorMessage;
     };
@@ -40,6 +40,10 @@ namespace dawn_native {
     //
     // but shorthand version for specific error types are preferred:
     //   return DAWN_VALIDATION_ERROR("My error message");
+    //
+    // String literal messages aren't copied. Messages with arguments are formatted printf-style
+    // from copies of the arguments, only once the message is needed:
+    //   return DAWN_FORMAT_VALIDATION_ERROR("Index %u is out of bounds", index);
 #define DAWN_MAKE_ERROR(TYPE, MESSAGE) \
     ::dawn_native::ErrorData::Create(TYPE, MESSAGE, __FILE__, __func__, __LINE__)
 #define DAWN_VALIDATION_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::Validation, MESSAGE)
@@ -47,6 +51,13 @@ namespace dawn_native {
 #define DAWN_UNIMPLEMENTED_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::Unimplemented, MESSAGE)
 #define DAWN_OUT_OF_MEMORY_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::OutOfMemory, MESSAGE)
 
+#define DAWN_MAKE_FORMATTED_ERROR(TYPE, FORMAT, ...)                                      \
+    ::dawn_native::ErrorData::Create(                                                     \
+        TYPE, ::dawn_native::detail::MakeFormattedMessage(FORMAT, __VA_ARGS__), __FILE__, \
+        __func__, __LINE__)
+#define DAWN_FORMAT_VALIDATION_ERROR(FORMAT, ...) \
+    DAWN_MAKE_FORMATTED_ERROR(InternalErrorType::Validation, FORMAT, __VA_ARGS__)
+
 #define DAWN_CONCAT1(x, y) x##y
 #define DAWN_CONCAT2(x, y) DAWN_CONCAT1(x, y)
 #define DAWN_LOCAL_VAR DAWN_CONCAT2(_localVar, __LINE__)
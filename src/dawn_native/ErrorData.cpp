@@ -24,7 +24,28 @@ namespace dawn_native {
                                                  const char* file,
                                                  const char* function,
                                                  int line) {
-        std::unique_ptr<ErrorData> error = std::make_unique<ErrorData>(type, message);
+        std::unique_ptr<ErrorData> error = std::make_unique<ErrorData>(type, std::move(message));
+        error->AppendBacktrace(file, function, line);
+        return error;
+    }
+
+    std::unique_ptr<ErrorData> ErrorData::Create(InternalErrorType type,
+                                                 std::unique_ptr<LazyMessage> message,
+                                                 const char* file,
+                                                 const char* function,
+                                                 int line) {
+        return Create(type, nullptr, std::move(message), file, function, line);
+    }
+
+    // static
+    std::unique_ptr<ErrorData> ErrorData::Create(InternalErrorType type,
+                                                 const char* literalMessage,
+                                                 std::unique_ptr<LazyMessage> lazyMessage,
+                                                 const char* file,
+                                                 const char* function,
+                                                 int line) {
+        std::unique_ptr<ErrorData> error(
+            new ErrorData(type, literalMessage, std::move(lazyMessage)));
         error->AppendBacktrace(file, function, line);
         return error;
     }
@@ -33,6 +54,12 @@ namespace dawn_native {
         : mType(type), mMessage(std::move(message)) {
     }
 
+    ErrorData::ErrorData(InternalErrorType type,
+                         const char* literalMessage,
+                         std::unique_ptr<LazyMessage> lazyMessage)
+        : mType(type), mLiteralMessage(literalMessage), mLazyMessage(std::move(lazyMessage)) {
+    }
+
     void ErrorData::AppendBacktrace(const char* file, const char* function, int line) {
         BacktraceRecord record;
         record.file = file;
@@ -60,6 +87,13 @@ namespace dawn_native {
     }
 
     const std::string& ErrorData::GetMessage() const {
+        if (mLiteralMessage != nullptr) {
+            mMessage = mLiteralMessage;
+            mLiteralMessage = nullptr;
+        } else if (mLazyMessage != nullptr) {
+            mMessage = mLazyMessage->Format();
+            mLazyMessage = nullptr;
+        }
         return mMessage;
     }
 
@@ -15,11 +15,16 @@
 #ifndef DAWNNATIVE_ERRORDATA_H_
 #define DAWNNATIVE_ERRORDATA_H_
 
+#include "common/MagazineAllocator.h"
+
 #include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <memory>
 
 namespace wgpu {
     enum class ErrorType : uint32_t;
@@ -32,13 +37,36 @@ namespace dawn {
 namespace dawn_native {
     enum class InternalErrorType : uint32_t;
 
-    class ErrorData {
+    class ErrorData : public MagazineAllocated {
       public:
+        // The message of an error is only needed when it is reported, errors which are dropped,
+        // for example because an encoder already got an error, never build their message.
+        class LazyMessage {
+          public:
+            virtual ~LazyMessage() = default;
+            virtual std::string Format() const = 0;
+        };
+
+        // String literals are kept as a pointer instead of being copied.
+        template <size_t N>
+        static std::unique_ptr<ErrorData> Create(InternalErrorType type,
+                                                 const char (&message)[N],
+                                                 const char* file,
+                                                 const char* function,
+                                                 int line) {
+            return Create(type, static_cast<const char*>(message), nullptr, file, function, line);
+        }
         static std::unique_ptr<ErrorData> Create(InternalErrorType type,
                                                  std::string message,
                                                  const char* file,
                                                  const char* function,
                                                  int line);
+        static std::unique_ptr<ErrorData> Create(InternalErrorType type,
+                                                 std::unique_ptr<LazyMessage> message,
+                                                 const char* file,
+                                                 const char* function,
+                                                 int line);
+
         ErrorData(InternalErrorType type, std::string message);
 
         struct BacktraceRecord {
@@ -54,11 +82,74 @@ namespace dawn_native {
         const std::vector<BacktraceRecord>& GetBacktrace() const;
 
       private:
+        ErrorData(InternalErrorType type,
+                  const char* literalMessage,
+                  std::unique_ptr<LazyMessage> lazyMessage);
+        static std::unique_ptr<ErrorData> Create(InternalErrorType type,
+                                                 const char* literalMessage,
+                                                 std::unique_ptr<LazyMessage> lazyMessage,
+                                                 const char* file,
+                                                 const char* function,
+                                                 int line);
+
         InternalErrorType mType;
-        std::string mMessage;
+        // At most one of the literal and the lazy message is set, it is turned into mMessage the
+        // first time the message is needed.
+        mutable const char* mLiteralMessage = nullptr;
+        mutable std::unique_ptr<LazyMessage> mLazyMessage;
+        mutable std::string mMessage;
         std::vector<BacktraceRecord> mBacktrace;
     };
 
+    namespace detail {
+
+        // Formats a printf-style message with arguments copied when the error is created.
+        template <typename... Args>
+        class FormattedMessage final : public ErrorData::LazyMessage {
+          public:
+            FormattedMessage(const char* format, Args... args) : mFormat(format), mArgs(args...) {
+                static_assert(
+                    AllScalars<Args...>::value,
+                    "Only scalars and string literals can be formatted lazily, their lifetime "
+                    "would otherwise end before the message is formatted");
+            }
+
+            std::string Format() const override {
+                return FormatImpl(std::index_sequence_for<Args...>());
+            }
+
+          private:
+            template <typename... T>
+            struct AllScalars : std::true_type {};
+            template <typename T, typename... Rest>
+            struct AllScalars<T, Rest...>
+                : std::integral_constant<bool,
+                                         std::is_scalar<T>::value && AllScalars<Rest...>::value> {
+            };
+
+            template <size_t... I>
+            std::string FormatImpl(std::index_sequence<I...>) const {
+                int length = snprintf(nullptr, 0, mFormat, std::get<I>(mArgs)...);
+                if (length <= 0) {
+                    return mFormat;
+                }
+                std::string message(static_cast<size_t>(length), '\0');
+                snprintf(&message[0], message.size() + 1, mFormat, std::get<I>(mArgs)...);
+                return message;
+            }
+
+            const char* mFormat;
+            std::tuple<Args...> mArgs;
+        };
+
+        template <typename... Args>
+        std::unique_ptr<ErrorData::LazyMessage> MakeFormattedMessage(const char* format,
+                                                                     Args... args) {
+            return std::make_unique<FormattedMessage<Args...>>(format, args...);
+        }
+
+    }  // namespace detail
+
 }  // namespace dawn_native
 
 #endif  // DAWNNATIVE_ERRORDATA_H_
@@ -17,6 +17,7 @@
 
 #include "dawn_native/dawn_platform.h"
 
+#include "common/MagazineAllocator.h"
 #include "dawn_native/RefCounted.h"
 
 #include <string>
@@ -35,7 +36,10 @@ namespace dawn_native {
     // To simplify ErrorHandling, there is a sentinel root error scope which has
     // no parent. All uncaptured errors are handled by the root error scope. Its
     // callback is called immediately once it encounters an error.
-    class ErrorScope : public RefCounted {
+    //
+    // Applications push and pop scopes every frame, so they are allocated out of the magazines
+    // of the MagazineAllocator instead of the general purpose heap.
+    class ErrorScope : public RefCounted, public MagazineAllocated {
       public:
         ErrorScope();  // Constructor for the root error scope.
         ErrorScope(wgpu::ErrorFilter errorFilter, ErrorScope* parent);
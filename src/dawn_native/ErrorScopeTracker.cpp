@@ -36,7 +36,23 @@ namespace dawn_native {
     }
 
     void ErrorScopeTracker::TrackUntilLastSubmitComplete(ErrorScope* scope) {
-        mScopesInFlight.Enqueue(scope, mDevice->GetLastSubmittedCommandSerial());
+        Serial serial = mDevice->HasPendingCommands() ? mDevice->GetPendingCommandSerial()
+                                                      : mDevice->GetLastSubmittedCommandSerial();
+        if (serial <= mDevice->GetCompletedCommandSerial()) {
+            return;
+        }
+
+        // The scopes at the last serial are still referenced, so the pointer can't be stale.
+        if (!mScopesInFlight.Empty() && mScopesInFlight.LastSerial() == serial &&
+            mLastTrackedScope == scope) {
+            return;
+        }
+        mScopesInFlight.Enqueue(scope, serial);
+        mLastTrackedScope = scope;
+    }
+
+    bool ErrorScopeTracker::Empty() const {
+        return mScopesInFlight.Empty();
     }
 
     void ErrorScopeTracker::Tick(Serial completedSerial) {
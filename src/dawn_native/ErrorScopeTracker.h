@@ -15,7 +15,7 @@
 #ifndef DAWNNATIVE_ERRORSCOPETRACKER_H_
 #define DAWNNATIVE_ERRORSCOPETRACKER_H_
 
-#include "common/SerialQueue.h"
+#include "common/FlatSerialQueue.h"
 #include "dawn_native/RefCounted.h"
 
 namespace dawn_native {
@@ -28,13 +28,21 @@ namespace dawn_native {
         ErrorScopeTracker(DeviceBase* device);
         ~ErrorScopeTracker();
 
+        // Scopes whose commands already completed aren't tracked, so they resolve as soon as
+        // they are popped instead of at the next Tick.
         void TrackUntilLastSubmitComplete(ErrorScope* scope);
 
         void Tick(Serial completedSerial);
 
+        bool Empty() const;
+
       protected:
         DeviceBase* mDevice;
-        SerialQueue<Ref<ErrorScope>> mScopesInFlight;
+        FlatSerialQueue<Ref<ErrorScope>> mScopesInFlight;
+
+        // The scope tracked last, which isn't tracked again for the submits and signals that
+        // complete at the same serial.
+        ErrorScope* mLastTrackedScope = nullptr;
     };
 
 }  // namespace dawn_native
@@ -34,7 +34,44 @@ namespace dawn_native {
             {{Extension::TextureCompressionBC,
               {"texture_compression_bc", "Support Block Compressed (BC) texture formats",
                "https://bugs.chromium.org/p/dawn/issues/detail?id=42"},
-              &WGPUDeviceProperties::textureCompressionBC}}};
+              &WGPUDeviceProperties::textureCompressionBC},
+             {Extension::TimestampQuery,
+              {"timestamp_query", "Support timestamp query sets written by writeTimestamp", ""},
+              &WGPUDeviceProperties::timestampQuery},
+             {Extension::PipelineStatisticsQuery,
+              {"pipeline_statistics_query",
+               "Support query sets counting the invocations of the pipeline stages", ""},
+              &WGPUDeviceProperties::pipelineStatisticsQuery},
+             {Extension::DrawIndirectCount,
+              {"draw_indirect_count",
+               "Support multi draw indirect commands taking their draw count from a buffer", ""},
+              &WGPUDeviceProperties::drawIndirectCount},
+             {Extension::PushConstants,
+              {"push_constants",
+               "Support setPushConstants and pipeline layouts reserving push constant space", ""},
+              &WGPUDeviceProperties::pushConstants},
+             {Extension::SparseResources,
+              {"sparse_resources",
+               "Support sparse buffers and textures whose tiles are made resident with "
+               "updateBufferTileMappings and updateTextureTileMappings",
+               ""},
+              &WGPUDeviceProperties::sparseResources},
+             {Extension::ConditionalRendering,
+              {"conditional_rendering",
+               "Support skipping the draws and dispatches of a pass depending on a value in a "
+               "predicate buffer",
+               ""},
+              &WGPUDeviceProperties::conditionalRendering},
+             {Extension::RayTracingConditional,
+              {"ray_tracing_conditional",
+               "Support traceRays in the conditional rendering scopes of ray tracing passes", ""},
+              &WGPUDeviceProperties::rayTracingConditional},
+             {Extension::ResourceTables,
+              {"resource_tables",
+               "Support bind group layouts with a single array binding of up to 65536 sampled "
+               "textures or readonly storage buffers, updated in place with resource tables",
+               ""},
+              &WGPUDeviceProperties::resourceTables}}};
 
     }  // anonymous namespace
 
@@ -25,6 +25,14 @@ namespace dawn_native {
 
     enum class Extension {
         TextureCompressionBC,
+        TimestampQuery,
+        PipelineStatisticsQuery,
+        DrawIndirectCount,
+        PushConstants,
+        SparseResources,
+        ConditionalRendering,
+        RayTracingConditional,
+        ResourceTables,
 
         EnumCount,
         InvalidEnum = EnumCount,
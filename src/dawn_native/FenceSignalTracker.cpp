@@ -29,8 +29,14 @@ namespace dawn_native {
     void FenceSignalTracker::UpdateFenceOnComplete(Fence* fence, uint64_t value) {
         // Because we currently only have a single queue, we can simply update
         // the fence completed value once the last submitted serial has passed.
-        mFencesInFlight.Enqueue(FenceInFlight{fence, value},
-                                mDevice->GetLastSubmittedCommandSerial());
+        // Commands the backend didn't submit yet complete with the pending serial.
+        Serial serial = mDevice->HasPendingCommands() ? mDevice->GetPendingCommandSerial()
+                                                      : mDevice->GetLastSubmittedCommandSerial();
+        mFencesInFlight.Enqueue(FenceInFlight{fence, value}, serial);
+    }
+
+    bool FenceSignalTracker::Empty() const {
+        return mFencesInFlight.Empty();
     }
 
     void FenceSignalTracker::Tick(Serial finishedSerial) {
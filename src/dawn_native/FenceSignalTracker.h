@@ -37,6 +37,8 @@ namespace dawn_native {
 
         void Tick(Serial finishedSerial);
 
+        bool Empty() const;
+
       private:
         DeviceBase* mDevice;
         SerialQueue<FenceInFlight> mFencesInFlight;
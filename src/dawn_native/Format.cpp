@@ -16,8 +16,6 @@
 #include "dawn_native/Device.h"
 #include "dawn_native/Extensions.h"
 
-#include <bitset>
-
 namespace dawn_native {
 
     // Format
@@ -88,163 +86,143 @@ namespace dawn_native {
 
     // Implementation details of the format table of the DeviceBase
 
-    // For the enum for formats are packed but this might change when we have a broader extension
-    // mechanism for webgpu.h. Formats start at 1 because 0 is the undefined format.
-    size_t ComputeFormatIndex(wgpu::TextureFormat format) {
-        // This takes advantage of overflows to make the index of TextureFormat::Undefined outside
-        // of the range of the FormatTable.
-        static_assert(static_cast<uint32_t>(wgpu::TextureFormat::Undefined) - 1 > kKnownFormatCount,
-                      "");
-        return static_cast<size_t>(static_cast<uint32_t>(format) - 1);
-    }
-
-    FormatTable BuildFormatTable(const DeviceBase* device) {
-        FormatTable table;
-        std::bitset<kKnownFormatCount> formatsSet;
+    namespace {
 
         using Type = Format::Type;
         using Aspect = Format::Aspect;
 
-        auto AddFormat = [&table, &formatsSet](Format format) {
-            size_t index = ComputeFormatIndex(format.format);
-            ASSERT(index < table.size());
-
-            // This checks that each format is set at most once, the first part of checking that all
-            // formats are set exactly once.
-            ASSERT(!formatsSet[index]);
-
-            table[index] = format;
-            formatsSet.set(index);
-        };
-
-        auto AddColorFormat = [&AddFormat](wgpu::TextureFormat format, bool renderable,
-                                           bool supportsStorageUsage, uint32_t byteSize,
-                                           Type type) {
-            Format internalFormat;
-            internalFormat.format = format;
-            internalFormat.isRenderable = renderable;
-            internalFormat.isCompressed = false;
-            internalFormat.isSupported = true;
-            internalFormat.supportsStorageUsage = supportsStorageUsage;
-            internalFormat.aspect = Aspect::Color;
-            internalFormat.type = type;
-            internalFormat.blockByteSize = byteSize;
-            internalFormat.blockWidth = 1;
-            internalFormat.blockHeight = 1;
-            AddFormat(internalFormat);
-        };
-
-        auto AddDepthStencilFormat = [&AddFormat](wgpu::TextureFormat format, Format::Aspect aspect,
-                                                  uint32_t byteSize) {
-            Format internalFormat;
-            internalFormat.format = format;
-            internalFormat.isRenderable = true;
-            internalFormat.isCompressed = false;
-            internalFormat.isSupported = true;
-            internalFormat.supportsStorageUsage = false;
-            internalFormat.aspect = aspect;
-            internalFormat.type = Type::Other;
-            internalFormat.blockByteSize = byteSize;
-            internalFormat.blockWidth = 1;
-            internalFormat.blockHeight = 1;
-            AddFormat(internalFormat);
-        };
-
-        auto AddCompressedFormat = [&AddFormat](wgpu::TextureFormat format, uint32_t byteSize,
-                                                uint32_t width, uint32_t height, bool isSupported) {
-            Format internalFormat;
-            internalFormat.format = format;
-            internalFormat.isRenderable = false;
-            internalFormat.isCompressed = true;
-            internalFormat.isSupported = isSupported;
-            internalFormat.supportsStorageUsage = false;
-            internalFormat.aspect = Aspect::Color;
-            internalFormat.type = Type::Float;
-            internalFormat.blockByteSize = byteSize;
-            internalFormat.blockWidth = width;
-            internalFormat.blockHeight = height;
-            AddFormat(internalFormat);
-        };
+        constexpr Format ColorFormat(wgpu::TextureFormat format,
+                                     bool renderable,
+                                     bool supportsStorageUsage,
+                                     uint32_t byteSize,
+                                     Type type) {
+            return {format, renderable, false, supportsStorageUsage, Aspect::Color, type, byteSize,
+                    1, 1, Extension::InvalidEnum};
+        }
+
+        constexpr Format DepthStencilFormat(wgpu::TextureFormat format,
+                                            Aspect aspect,
+                                            uint32_t byteSize) {
+            return {format, true, false, false, aspect, Type::Other, byteSize, 1, 1,
+                    Extension::InvalidEnum};
+        }
+
+        constexpr Format CompressedFormat(wgpu::TextureFormat format,
+                                          uint32_t byteSize,
+                                          uint32_t width,
+                                          uint32_t height,
+                                          Extension extension) {
+            return {format, false, true, false, Aspect::Color, Type::Float, byteSize, width, height,
+                    extension};
+        }
+
+        constexpr Format BCFormat(wgpu::TextureFormat format, uint32_t byteSize) {
+            return CompressedFormat(format, byteSize, 4, 4, Extension::TextureCompressionBC);
+        }
 
         // clang-format off
 
-        // 1 byte color formats
-        AddColorFormat(wgpu::TextureFormat::R8Unorm, true, false, 1, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::R8Snorm, false, false, 1, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::R8Uint, true, false, 1, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::R8Sint, true, false, 1, Type::Sint);
-
-        // 2 bytes color formats
-        AddColorFormat(wgpu::TextureFormat::R16Uint, true, false, 2, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::R16Sint, true, false, 2, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::R16Float, true, false, 2, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RG8Unorm, true, false, 2, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RG8Snorm, false, false, 2, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RG8Uint, true, false, 2, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RG8Sint, true, false, 2, Type::Sint);
-
-        // 4 bytes color formats
-        AddColorFormat(wgpu::TextureFormat::R32Uint, true, true, 4, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::R32Sint, true, true, 4, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::R32Float, true, true, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RG16Uint, true, false, 4, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RG16Sint, true, false, 4, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::RG16Float, true, false, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGBA8Unorm, true, true, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGBA8UnormSrgb, true, false, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGBA8Snorm, false, true, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGBA8Uint, true, true, 4, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RGBA8Sint, true, true, 4, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::BGRA8Unorm, true, false, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::BGRA8UnormSrgb, true, false, 4, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGB10A2Unorm, true, false, 4, Type::Float);
-
-        AddColorFormat(wgpu::TextureFormat::RG11B10Float, false, false, 4, Type::Float);
-
-        // 8 bytes color formats
-        AddColorFormat(wgpu::TextureFormat::RG32Uint, true, true, 8, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RG32Sint, true, true, 8, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::RG32Float, true, true, 8, Type::Float);
-        AddColorFormat(wgpu::TextureFormat::RGBA16Uint, true, true, 8, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RGBA16Sint, true, true, 8, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::RGBA16Float, true, true, 8, Type::Float);
-
-        // 16 bytes color formats
-        AddColorFormat(wgpu::TextureFormat::RGBA32Uint, true, true, 16, Type::Uint);
-        AddColorFormat(wgpu::TextureFormat::RGBA32Sint, true, true, 16, Type::Sint);
-        AddColorFormat(wgpu::TextureFormat::RGBA32Float, true, true, 16, Type::Float);
-
-        // Depth stencil formats
-        AddDepthStencilFormat(wgpu::TextureFormat::Depth32Float, Aspect::Depth, 4);
-        AddDepthStencilFormat(wgpu::TextureFormat::Depth24Plus, Aspect::Depth, 4);
-        // TODO(cwallez@chromium.org): It isn't clear if this format should be copyable
-        // because its size isn't well defined, is it 4, 5 or 8?
-        AddDepthStencilFormat(wgpu::TextureFormat::Depth24PlusStencil8, Aspect::DepthStencil, 4);
-
-        // BC compressed formats
-        bool isBCFormatSupported = device->IsExtensionEnabled(Extension::TextureCompressionBC);
-        AddCompressedFormat(wgpu::TextureFormat::BC1RGBAUnorm, 8, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC1RGBAUnormSrgb, 8, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC4RSnorm, 8, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC4RUnorm, 8, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC2RGBAUnorm, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC2RGBAUnormSrgb, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC3RGBAUnorm, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC3RGBAUnormSrgb, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC5RGSnorm, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC5RGUnorm, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC6HRGBSfloat, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC6HRGBUfloat, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC7RGBAUnorm, 16, 4, 4, isBCFormatSupported);
-        AddCompressedFormat(wgpu::TextureFormat::BC7RGBAUnormSrgb, 16, 4, 4, isBCFormatSupported);
+        // The formats are in the order of their index, which is checked below.
+        constexpr FormatTable kFormatTable = {{
+            // 1 byte color formats
+            ColorFormat(wgpu::TextureFormat::R8Unorm, true, false, 1, Type::Float),
+            ColorFormat(wgpu::TextureFormat::R8Snorm, false, false, 1, Type::Float),
+            ColorFormat(wgpu::TextureFormat::R8Uint, true, false, 1, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::R8Sint, true, false, 1, Type::Sint),
+
+            // 2 bytes color formats
+            ColorFormat(wgpu::TextureFormat::R16Uint, true, false, 2, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::R16Sint, true, false, 2, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::R16Float, true, false, 2, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RG8Unorm, true, false, 2, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RG8Snorm, false, false, 2, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RG8Uint, true, false, 2, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RG8Sint, true, false, 2, Type::Sint),
+
+            // 4 bytes color formats
+            ColorFormat(wgpu::TextureFormat::R32Float, true, true, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::R32Uint, true, true, 4, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::R32Sint, true, true, 4, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::RG16Uint, true, false, 4, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RG16Sint, true, false, 4, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::RG16Float, true, false, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGBA8Unorm, true, true, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGBA8UnormSrgb, true, false, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGBA8Snorm, false, true, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGBA8Uint, true, true, 4, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RGBA8Sint, true, true, 4, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::BGRA8Unorm, true, false, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::BGRA8UnormSrgb, true, false, 4, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGB10A2Unorm, true, false, 4, Type::Float),
+
+            ColorFormat(wgpu::TextureFormat::RG11B10Float, false, false, 4, Type::Float),
+
+            // 8 bytes color formats
+            ColorFormat(wgpu::TextureFormat::RG32Float, true, true, 8, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RG32Uint, true, true, 8, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RG32Sint, true, true, 8, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::RGBA16Uint, true, true, 8, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RGBA16Sint, true, true, 8, Type::Sint),
+            ColorFormat(wgpu::TextureFormat::RGBA16Float, true, true, 8, Type::Float),
+
+            // 16 bytes color formats
+            ColorFormat(wgpu::TextureFormat::RGBA32Float, true, true, 16, Type::Float),
+            ColorFormat(wgpu::TextureFormat::RGBA32Uint, true, true, 16, Type::Uint),
+            ColorFormat(wgpu::TextureFormat::RGBA32Sint, true, true, 16, Type::Sint),
+
+            // Depth stencil formats
+            DepthStencilFormat(wgpu::TextureFormat::Depth32Float, Aspect::Depth, 4),
+            DepthStencilFormat(wgpu::TextureFormat::Depth24Plus, Aspect::Depth, 4),
+            // TODO(cwallez@chromium.org): It isn't clear if this format should be copyable
+            // because its size isn't well defined, is it 4, 5 or 8?
+            DepthStencilFormat(wgpu::TextureFormat::Depth24PlusStencil8, Aspect::DepthStencil, 4),
+
+            // BC compressed formats
+            BCFormat(wgpu::TextureFormat::BC1RGBAUnorm, 8),
+            BCFormat(wgpu::TextureFormat::BC1RGBAUnormSrgb, 8),
+            BCFormat(wgpu::TextureFormat::BC2RGBAUnorm, 16),
+            BCFormat(wgpu::TextureFormat::BC2RGBAUnormSrgb, 16),
+            BCFormat(wgpu::TextureFormat::BC3RGBAUnorm, 16),
+            BCFormat(wgpu::TextureFormat::BC3RGBAUnormSrgb, 16),
+            BCFormat(wgpu::TextureFormat::BC4RUnorm, 8),
+            BCFormat(wgpu::TextureFormat::BC4RSnorm, 8),
+            BCFormat(wgpu::TextureFormat::BC5RGUnorm, 16),
+            BCFormat(wgpu::TextureFormat::BC5RGSnorm, 16),
+            BCFormat(wgpu::TextureFormat::BC6HRGBUfloat, 16),
+            BCFormat(wgpu::TextureFormat::BC6HRGBSfloat, 16),
+            BCFormat(wgpu::TextureFormat::BC7RGBAUnorm, 16),
+            BCFormat(wgpu::TextureFormat::BC7RGBAUnormSrgb, 16),
+        }};
 
         // clang-format on
 
-        // This checks that each format is set at least once, the second part of checking that all
-        // formats are checked exactly once.
-        ASSERT(formatsSet.all());
+        // Checks that each format is at its index, and with kKnownFormatCount being the size of
+        // the table, that all formats are set exactly once.
+        constexpr bool AreFormatsAtTheirIndex() {
+            for (size_t i = 0; i < kFormatTable.size(); ++i) {
+                if (ComputeFormatIndex(kFormatTable[i].format) != i) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        static_assert(AreFormatsAtTheirIndex(), "The format table isn't in the order of indices");
+
+    }  // anonymous namespace
 
-        return table;
+    const FormatTable& GetFormatTable() {
+        return kFormatTable;
+    }
+
+    FormatSet ComputeSupportedFormats(const DeviceBase* device) {
+        FormatSet supportedFormats;
+        for (const Format& format : kFormatTable) {
+            if (format.extension == Extension::InvalidEnum ||
+                device->IsExtensionEnabled(format.extension)) {
+                supportedFormats.set(format.GetIndex());
+            }
+        }
+        return supportedFormats;
     }
 
 }  // namespace dawn_native
@@ -18,15 +18,17 @@
 #include "dawn_native/dawn_platform.h"
 
 #include "dawn_native/Error.h"
+#include "dawn_native/Extensions.h"
 
 #include <array>
+#include <bitset>
 
 namespace dawn_native {
 
     class DeviceBase;
 
-    // The number of formats Dawn knows about. Asserts in BuildFormatTable ensure that this is the
-    // exact number of known format.
+    // The number of formats Dawn knows about. A static_assert on the format table ensures that
+    // this is the exact number of known format.
     static constexpr size_t kKnownFormatCount = 52;
 
     // A wgpu::TextureFormat along with all the information about it necessary for validation.
@@ -48,8 +50,6 @@ namespace dawn_native {
         wgpu::TextureFormat format;
         bool isRenderable;
         bool isCompressed;
-        // A format can be known but not supported because it is part of a disabled extension.
-        bool isSupported;
         bool supportsStorageUsage;
         Aspect aspect;
         Type type;
@@ -58,6 +58,10 @@ namespace dawn_native {
         uint32_t blockWidth;
         uint32_t blockHeight;
 
+        // A format can be known but not supported because it is part of a disabled extension.
+        // This is InvalidEnum for the formats that don't need an extension.
+        Extension extension;
+
         static Type TextureComponentTypeToFormatType(wgpu::TextureComponentType componentType);
         static wgpu::TextureComponentType FormatTypeToTextureComponentType(Type type);
 
@@ -75,11 +79,24 @@ namespace dawn_native {
     // Implementation details of the format table in the device.
 
     using FormatTable = std::array<Format, kKnownFormatCount>;
+    // The formats supported by a device, indexed like the FormatTable.
+    using FormatSet = std::bitset<kKnownFormatCount>;
 
     // Returns the index of a format in the FormatTable.
-    size_t ComputeFormatIndex(wgpu::TextureFormat format);
-    // Builds the format table with the extensions enabled on the device.
-    FormatTable BuildFormatTable(const DeviceBase* device);
+    // For the enum for formats are packed but this might change when we have a broader extension
+    // mechanism for webgpu.h. Formats start at 1 because 0 is the undefined format.
+    constexpr size_t ComputeFormatIndex(wgpu::TextureFormat format) {
+        // This takes advantage of overflows to make the index of TextureFormat::Undefined outside
+        // of the range of the FormatTable.
+        static_assert(static_cast<uint32_t>(wgpu::TextureFormat::Undefined) - 1 > kKnownFormatCount,
+                      "");
+        return static_cast<size_t>(static_cast<uint32_t>(format) - 1);
+    }
+
+    // The table of all known formats. It is built at compile time and shared by all devices.
+    const FormatTable& GetFormatTable();
+    // Returns which formats are supported with the extensions enabled on the device.
+    FormatSet ComputeSupportedFormats(const DeviceBase* device);
 
 }  // namespace dawn_native
 
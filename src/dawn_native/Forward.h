@@ -31,8 +31,11 @@ namespace dawn_native {
     class InstanceBase;
     class PipelineBase;
     class PipelineLayoutBase;
+    class QuerySetBase;
     class QueueBase;
     class RayTracingAccelerationContainerBase;
+    class RayTracingBundleBase;
+    class RayTracingBundleEncoder;
     class RayTracingPassEncoder;
     class RayTracingPipelineBase;
     class RayTracingShaderBindingTableBase;
@@ -41,6 +44,7 @@ namespace dawn_native {
     class RenderPassEncoder;
     class RenderPipelineBase;
     class ResourceHeapBase;
+    class ResourceTableBase;
     class SamplerBase;
     class Surface;
     class ShaderModuleBase;
@@ -49,6 +53,7 @@ namespace dawn_native {
     class NewSwapChainBase;
     class TextureBase;
     class TextureViewBase;
+    class TransientUniformAllocator;
 
     class DeviceBase;
 
@@ -0,0 +1,386 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/IndirectValidation.h"
+
+#include "common/Constants.h"
+#include "common/Math.h"
+#include "dawn_native/BindGroup.h"
+#include "dawn_native/BindGroupLayout.h"
+#include "dawn_native/Buffer.h"
+#include "dawn_native/CommandAllocator.h"
+#include "dawn_native/Commands.h"
+#include "dawn_native/ComputePipeline.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/EncodingContext.h"
+#include "dawn_native/PassResourceUsageTracker.h"
+#include "dawn_native/PipelineLayout.h"
+#include "dawn_native/ShaderModule.h"
+
+#include <spirv-tools/libspirv.hpp>
+
+#include <cstring>
+#include <map>
+
+namespace dawn_native {
+
+    namespace {
+
+        constexpr uint32_t kWorkgroupSize = 64;
+
+        // The Request struct of the shader, offsets are in 32bit words.
+        struct RequestParams {
+            uint32_t inputOffset;
+            uint32_t outputOffset;
+            uint32_t limit;
+            uint32_t indexed;
+        };
+        static_assert(sizeof(RequestParams) == 16, "");
+
+        // The requests of a dispatch are preceded by their count, padded to 16 bytes.
+        constexpr uint32_t kParamsHeaderSize = 16;
+
+        // Storage buffers can only be bound at the offsets that are valid for dynamic offsets.
+        constexpr uint32_t kParamsAlignment = kMinDynamicBufferOffsetAlignment;
+
+        // Each invocation reads a request from the params and writes the clamped arguments to the
+        // output. With i the input offset and o the output offset, for dispatches:
+        //     output[o + k] = min(input[i + k], limit) for k in [0, 3)
+        // and for indexed draws, whose arguments are indexCount, instanceCount, firstIndex,
+        // baseVertex and firstInstance:
+        //     output[o] = min(indexCount, limit - min(firstIndex, limit))
+        //     output[o + k] = input[i + k] for k in [1, 5)
+        constexpr char kShaderSource[] = R"(
+                OpCapability Shader
+          %glsl = OpExtInstImport "GLSL.std.450"
+                OpMemoryModel Logical GLSL450
+                OpEntryPoint GLCompute %main "main" %gid
+                OpExecutionMode %main LocalSize 64 1 1
+                OpDecorate %gid BuiltIn GlobalInvocationId
+                OpMemberDecorate %Request 0 Offset 0
+                OpMemberDecorate %Request 1 Offset 4
+                OpMemberDecorate %Request 2 Offset 8
+                OpMemberDecorate %Request 3 Offset 12
+                OpDecorate %RequestArray ArrayStride 16
+                OpMemberDecorate %ParamsBlock 0 NonWritable
+                OpMemberDecorate %ParamsBlock 0 Offset 0
+                OpMemberDecorate %ParamsBlock 1 NonWritable
+                OpMemberDecorate %ParamsBlock 1 Offset 16
+                OpDecorate %ParamsBlock BufferBlock
+                OpDecorate %UintArray ArrayStride 4
+                OpMemberDecorate %InputBlock 0 NonWritable
+                OpMemberDecorate %InputBlock 0 Offset 0
+                OpDecorate %InputBlock BufferBlock
+                OpMemberDecorate %OutputBlock 0 Offset 0
+                OpDecorate %OutputBlock BufferBlock
+                OpDecorate %params DescriptorSet 0
+                OpDecorate %params Binding 0
+                OpDecorate %input DescriptorSet 0
+                OpDecorate %input Binding 1
+                OpDecorate %output DescriptorSet 0
+                OpDecorate %output Binding 2
+          %void = OpTypeVoid
+      %voidFunc = OpTypeFunction %void
+          %bool = OpTypeBool
+          %uint = OpTypeInt 32 0
+        %v3uint = OpTypeVector %uint 3
+        %uint_0 = OpConstant %uint 0
+        %uint_1 = OpConstant %uint 1
+        %uint_2 = OpConstant %uint 2
+        %uint_3 = OpConstant %uint 3
+        %uint_4 = OpConstant %uint 4
+       %Request = OpTypeStruct %uint %uint %uint %uint
+  %RequestArray = OpTypeRuntimeArray %Request
+   %ParamsBlock = OpTypeStruct %uint %RequestArray
+     %UintArray = OpTypeRuntimeArray %uint
+    %InputBlock = OpTypeStruct %UintArray
+   %OutputBlock = OpTypeStruct %UintArray
+ %paramsPointer = OpTypePointer Uniform %ParamsBlock
+  %inputPointer = OpTypePointer Uniform %InputBlock
+ %outputPointer = OpTypePointer Uniform %OutputBlock
+   %uintPointer = OpTypePointer Uniform %uint
+    %gidPointer = OpTypePointer Input %v3uint
+%uintInputPointer = OpTypePointer Input %uint
+        %params = OpVariable %paramsPointer Uniform
+         %input = OpVariable %inputPointer Uniform
+        %output = OpVariable %outputPointer Uniform
+           %gid = OpVariable %gidPointer Input
+
+          %main = OpFunction %void None %voidFunc
+         %entry = OpLabel
+   %indexPointer = OpAccessChain %uintInputPointer %gid %uint_0
+         %index = OpLoad %uint %indexPointer
+  %countPointer = OpAccessChain %uintPointer %params %uint_0
+         %count = OpLoad %uint %countPointer
+       %inRange = OpULessThan %bool %index %count
+                OpSelectionMerge %end None
+                OpBranchConditional %inRange %body %end
+
+          %body = OpLabel
+%inputOffsetPointer = OpAccessChain %uintPointer %params %uint_1 %index %uint_0
+   %inputOffset = OpLoad %uint %inputOffsetPointer
+%outputOffsetPointer = OpAccessChain %uintPointer %params %uint_1 %index %uint_1
+  %outputOffset = OpLoad %uint %outputOffsetPointer
+  %limitPointer = OpAccessChain %uintPointer %params %uint_1 %index %uint_2
+         %limit = OpLoad %uint %limitPointer
+%indexedPointer = OpAccessChain %uintPointer %params %uint_1 %index %uint_3
+       %indexed = OpLoad %uint %indexedPointer
+   %inputIndex1 = OpIAdd %uint %inputOffset %uint_1
+   %inputIndex2 = OpIAdd %uint %inputOffset %uint_2
+ %inputPointer0 = OpAccessChain %uintPointer %input %uint_0 %inputOffset
+ %inputPointer1 = OpAccessChain %uintPointer %input %uint_0 %inputIndex1
+ %inputPointer2 = OpAccessChain %uintPointer %input %uint_0 %inputIndex2
+        %input0 = OpLoad %uint %inputPointer0
+        %input1 = OpLoad %uint %inputPointer1
+        %input2 = OpLoad %uint %inputPointer2
+  %outputIndex1 = OpIAdd %uint %outputOffset %uint_1
+  %outputIndex2 = OpIAdd %uint %outputOffset %uint_2
+%outputPointer0 = OpAccessChain %uintPointer %output %uint_0 %outputOffset
+%outputPointer1 = OpAccessChain %uintPointer %output %uint_0 %outputIndex1
+%outputPointer2 = OpAccessChain %uintPointer %output %uint_0 %outputIndex2
+     %isIndexed = OpINotEqual %bool %indexed %uint_0
+                OpSelectionMerge %bodyEnd None
+                OpBranchConditional %isIndexed %draw %dispatch
+
+      %dispatch = OpLabel
+             %x = OpExtInst %uint %glsl UMin %input0 %limit
+             %y = OpExtInst %uint %glsl UMin %input1 %limit
+             %z = OpExtInst %uint %glsl UMin %input2 %limit
+                OpStore %outputPointer0 %x
+                OpStore %outputPointer1 %y
+                OpStore %outputPointer2 %z
+                OpBranch %bodyEnd
+
+          %draw = OpLabel
+   %inputIndex3 = OpIAdd %uint %inputOffset %uint_3
+   %inputIndex4 = OpIAdd %uint %inputOffset %uint_4
+ %inputPointer3 = OpAccessChain %uintPointer %input %uint_0 %inputIndex3
+ %inputPointer4 = OpAccessChain %uintPointer %input %uint_0 %inputIndex4
+        %input3 = OpLoad %uint %inputPointer3
+        %input4 = OpLoad %uint %inputPointer4
+    %firstIndex = OpExtInst %uint %glsl UMin %input2 %limit
+%availableIndices = OpISub %uint %limit %firstIndex
+    %indexCount = OpExtInst %uint %glsl UMin %input0 %availableIndices
+  %outputIndex3 = OpIAdd %uint %outputOffset %uint_3
+  %outputIndex4 = OpIAdd %uint %outputOffset %uint_4
+%outputPointer3 = OpAccessChain %uintPointer %output %uint_0 %outputIndex3
+%outputPointer4 = OpAccessChain %uintPointer %output %uint_0 %outputIndex4
+                OpStore %outputPointer0 %indexCount
+                OpStore %outputPointer1 %input1
+                OpStore %outputPointer2 %input2
+                OpStore %outputPointer3 %input3
+                OpStore %outputPointer4 %input4
+                OpBranch %bodyEnd
+
+       %bodyEnd = OpLabel
+                OpBranch %end
+
+           %end = OpLabel
+                OpReturn
+                OpFunctionEnd
+)";
+
+        ResultOrError<Ref<BufferBase>> CreateBuffer(DeviceBase* device,
+                                                    wgpu::BufferUsage usage,
+                                                    uint64_t size) {
+            BufferDescriptor descriptor;
+            descriptor.usage = usage;
+            descriptor.size = size;
+            return device->CreateInternalBuffer(&descriptor);
+        }
+
+    }  // anonymous namespace
+
+    ResultOrError<Ref<ComputePipelineBase>> CreateIndirectValidationPipeline(DeviceBase* device) {
+        std::vector<uint32_t> code;
+        spvtools::SpirvTools spirvTools(SPV_ENV_VULKAN_1_1);
+        if (!spirvTools.Assemble(kShaderSource, sizeof(kShaderSource) - 1, &code)) {
+            return DAWN_VALIDATION_ERROR("Failed to assemble the indirect validation shader");
+        }
+
+        ShaderModuleDescriptor moduleDescriptor;
+        moduleDescriptor.codeSize = static_cast<uint32_t>(code.size());
+        moduleDescriptor.code = code.data();
+        ShaderModuleBase* module;
+        DAWN_TRY_ASSIGN(module, device->GetOrCreateShaderModule(&moduleDescriptor));
+        Ref<ShaderModuleBase> moduleRef = AcquireRef(module);
+
+        BindGroupLayoutBinding bindings[3];
+        bindings[0].binding = 0;
+        bindings[0].visibility = wgpu::ShaderStage::Compute;
+        bindings[0].type = wgpu::BindingType::ReadonlyStorageBuffer;
+        bindings[1].binding = 1;
+        bindings[1].visibility = wgpu::ShaderStage::Compute;
+        bindings[1].type = wgpu::BindingType::ReadonlyStorageBuffer;
+        bindings[2].binding = 2;
+        bindings[2].visibility = wgpu::ShaderStage::Compute;
+        bindings[2].type = wgpu::BindingType::StorageBuffer;
+
+        BindGroupLayoutDescriptor bindGroupLayoutDescriptor;
+        bindGroupLayoutDescriptor.bindingCount = 3;
+        bindGroupLayoutDescriptor.bindings = bindings;
+        BindGroupLayoutBase* bindGroupLayout;
+        DAWN_TRY_ASSIGN(bindGroupLayout,
+                        device->GetOrCreateBindGroupLayout(&bindGroupLayoutDescriptor));
+        Ref<BindGroupLayoutBase> bindGroupLayoutRef = AcquireRef(bindGroupLayout);
+
+        PipelineLayoutDescriptor pipelineLayoutDescriptor;
+        pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+        pipelineLayoutDescriptor.bindGroupLayouts = &bindGroupLayout;
+        PipelineLayoutBase* pipelineLayout;
+        DAWN_TRY_ASSIGN(pipelineLayout,
+                        device->GetOrCreatePipelineLayout(&pipelineLayoutDescriptor));
+        Ref<PipelineLayoutBase> pipelineLayoutRef = AcquireRef(pipelineLayout);
+
+        ComputePipelineDescriptor pipelineDescriptor;
+        pipelineDescriptor.layout = pipelineLayout;
+        pipelineDescriptor.computeStage.module = module;
+        pipelineDescriptor.computeStage.entryPoint = "main";
+        ComputePipelineBase* pipeline;
+        DAWN_TRY_ASSIGN(pipeline, device->GetOrCreateComputePipeline(&pipelineDescriptor));
+        return AcquireRef(pipeline);
+    }
+
+    MaybeError EncodeIndirectValidationPass(DeviceBase* device,
+                                            EncodingContext* encodingContext,
+                                            CommandAllocator* allocator,
+                                            const std::vector<IndirectValidationRequest>& requests,
+                                            PassResourceUsage* validationPassUsage,
+                                            PassResourceUsage* validatedPassUsage) {
+        ComputePipelineBase* pipeline;
+        DAWN_TRY_ASSIGN(pipeline, device->GetOrCreateIndirectValidationPipeline());
+
+        // The requests are grouped by input buffer, each input buffer is bound for one dispatch.
+        std::map<BufferBase*, std::vector<RequestParams>> paramsPerInput;
+        std::vector<uint64_t> outputOffsets;
+        outputOffsets.reserve(requests.size());
+        uint64_t outputSize = 0;
+        for (const IndirectValidationRequest& request : requests) {
+            const uint64_t stride =
+                request.indexed ? kDrawIndexedIndirectSize : kDispatchIndirectSize;
+            std::vector<RequestParams>* params = &paramsPerInput[request.inputBuffer.Get()];
+
+            outputOffsets.push_back(outputSize);
+            for (uint32_t i = 0; i < request.count; ++i) {
+                RequestParams requestParams;
+                requestParams.inputOffset =
+                    static_cast<uint32_t>((request.inputOffset + i * stride) / sizeof(uint32_t));
+                requestParams.outputOffset = static_cast<uint32_t>(outputSize / sizeof(uint32_t));
+                requestParams.limit = request.limit;
+                requestParams.indexed = request.indexed ? 1 : 0;
+                params->push_back(requestParams);
+
+                outputSize += stride;
+            }
+        }
+
+        std::vector<uint8_t> paramsData;
+        std::vector<uint32_t> paramsOffsets;
+        for (const auto& it : paramsPerInput) {
+            const uint32_t count = static_cast<uint32_t>(it.second.size());
+            const uint32_t offset =
+                Align(static_cast<uint32_t>(paramsData.size()), kParamsAlignment);
+            paramsOffsets.push_back(offset);
+
+            paramsData.resize(offset + kParamsHeaderSize + count * sizeof(RequestParams), 0);
+            memcpy(&paramsData[offset], &count, sizeof(count));
+            memcpy(&paramsData[offset + kParamsHeaderSize], it.second.data(),
+                   count * sizeof(RequestParams));
+        }
+
+        Ref<BufferBase> params;
+        DAWN_TRY_ASSIGN(params, CreateBuffer(device,
+                                             wgpu::BufferUsage::Storage |
+                                                 wgpu::BufferUsage::CopyDst,
+                                             paramsData.size()));
+        DAWN_TRY(params->SetSubDataInternal(0, static_cast<uint32_t>(paramsData.size()),
+                                            paramsData.data()));
+        Ref<BufferBase> output;
+        DAWN_TRY_ASSIGN(output, CreateBuffer(device,
+                                             wgpu::BufferUsage::Storage |
+                                                 wgpu::BufferUsage::Indirect,
+                                             outputSize));
+        encodingContext->RetainObject(params.Get());
+        encodingContext->RetainObject(output.Get());
+
+        PassResourceUsageTracker usageTracker;
+        usageTracker.BufferUsedAs(params.Get(), kReadOnlyStorage);
+        usageTracker.BufferUsedAs(output.Get(), wgpu::BufferUsage::Storage);
+
+        BeginComputePassCmd* begin =
+            allocator->Allocate<BeginComputePassCmd>(Command::BeginComputePass);
+        // Each invocation writes different arguments.
+        begin->independentDispatches = true;
+
+        SetComputePipelineCmd* setPipeline =
+            allocator->Allocate<SetComputePipelineCmd>(Command::SetComputePipeline);
+        setPipeline->pipeline = pipeline;
+        encodingContext->RetainObject(pipeline);
+
+        size_t groupIndex = 0;
+        for (const auto& it : paramsPerInput) {
+            BufferBase* input = it.first;
+            const uint32_t count = static_cast<uint32_t>(it.second.size());
+
+            BindGroupBinding bindings[3];
+            bindings[0].binding = 0;
+            bindings[0].buffer = params.Get();
+            bindings[0].offset = paramsOffsets[groupIndex++];
+            bindings[0].size = kParamsHeaderSize + count * sizeof(RequestParams);
+            bindings[1].binding = 1;
+            bindings[1].buffer = input;
+            bindings[1].offset = 0;
+            bindings[1].size = input->GetSize();
+            bindings[2].binding = 2;
+            bindings[2].buffer = output.Get();
+            bindings[2].offset = 0;
+            bindings[2].size = outputSize;
+
+            BindGroupDescriptor bindGroupDescriptor;
+            bindGroupDescriptor.layout = pipeline->GetLayout()->GetBindGroupLayout(0);
+            bindGroupDescriptor.bindingCount = 3;
+            bindGroupDescriptor.bindings = bindings;
+            BindGroupBase* bindGroup;
+            DAWN_TRY_ASSIGN(bindGroup, device->GetOrCreateBindGroup(&bindGroupDescriptor));
+            Ref<BindGroupBase> bindGroupRef = AcquireRef(bindGroup);
+            encodingContext->RetainObject(bindGroup);
+
+            SetBindGroupCmd* setBindGroup =
+                allocator->Allocate<SetBindGroupCmd>(Command::SetBindGroup);
+            setBindGroup->index = 0;
+            setBindGroup->group = bindGroup;
+            setBindGroup->dynamicOffsetCount = 0;
+
+            DispatchCmd* dispatch = allocator->Allocate<DispatchCmd>(Command::Dispatch);
+            dispatch->x = (count + kWorkgroupSize - 1) / kWorkgroupSize;
+            dispatch->y = 1;
+            dispatch->z = 1;
+
+            usageTracker.BufferUsedAs(input, kReadOnlyStorage);
+        }
+
+        allocator->Allocate<EndComputePassCmd>(Command::EndComputePass);
+        *validationPassUsage = usageTracker.AcquireResourceUsage();
+
+        validatedPassUsage->buffers.push_back(output.Get());
+        validatedPassUsage->bufferUsages.push_back(wgpu::BufferUsage::Indirect);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            *requests[i].indirectBuffer = output.Get();
+            *requests[i].indirectOffset = outputOffsets[i];
+        }
+
+        return {};
+    }
+
+}  // namespace dawn_native
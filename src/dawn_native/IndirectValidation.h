@@ -0,0 +1,64 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_INDIRECTVALIDATION_H_
+#define DAWNNATIVE_INDIRECTVALIDATION_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+#include "dawn_native/PassResourceUsage.h"
+#include "dawn_native/RefCounted.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dawn_native {
+
+    class CommandAllocator;
+    class EncodingContext;
+
+    // An indirect dispatch or indexed draw whose arguments are clamped on the GPU before the pass
+    // that uses them, see Toggle::ValidateIndirectArgumentsOnGPU. Once the command buffer is
+    // finished, the command reads the clamped arguments from a scratch buffer instead.
+    struct IndirectValidationRequest {
+        Ref<BufferBase> inputBuffer;
+        uint64_t inputOffset;
+        // Whether the arguments are those of indexed draws instead of a dispatch.
+        bool indexed;
+        // The number of draws packed in the input buffer, 1 for dispatches.
+        uint32_t count;
+        // The max size of each dimension of dispatches, or the number of indices in the index
+        // buffer of draws. Indexed draws are clamped to the indices of the index buffer.
+        uint32_t limit;
+        // The fields of the command which are pointed to the clamped arguments.
+        BufferBase** indirectBuffer;
+        uint64_t* indirectOffset;
+    };
+
+    ResultOrError<Ref<ComputePipelineBase>> CreateIndirectValidationPipeline(DeviceBase* device);
+
+    // Encodes in |allocator| a compute pass writing the clamped arguments of |requests| to a new
+    // scratch buffer, then points the commands of the requests to it. The usages of the compute
+    // pass are written to |validationPassUsage| and the scratch buffer is added to the usages of
+    // the pass it is read by, |validatedPassUsage|.
+    MaybeError EncodeIndirectValidationPass(DeviceBase* device,
+                                            EncodingContext* encodingContext,
+                                            CommandAllocator* allocator,
+                                            const std::vector<IndirectValidationRequest>& requests,
+                                            PassResourceUsage* validationPassUsage,
+                                            PassResourceUsage* validatedPassUsage);
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_INDIRECTVALIDATION_H_
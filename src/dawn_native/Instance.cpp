@@ -19,6 +19,9 @@
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/Surface.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace dawn_native {
 
     // Forward definitions of each backend's "Connect" function that creates new BackendConnection.
@@ -49,6 +52,37 @@ namespace dawn_native {
     }
 #endif  // defined(DAWN_ENABLE_BACKEND_VULKAN)
 
+    namespace {
+
+        struct CompiledBackend {
+            wgpu::BackendType type;
+            BackendConnection* (*connect)(InstanceBase* instance);
+        };
+
+        // The backends that have been compiled, in the order in which their default adapters are
+        // returned.
+        std::vector<CompiledBackend> GetCompiledBackends() {
+            std::vector<CompiledBackend> backends;
+#if defined(DAWN_ENABLE_BACKEND_D3D12)
+            backends.push_back({wgpu::BackendType::D3D12, d3d12::Connect});
+#endif  // defined(DAWN_ENABLE_BACKEND_D3D12)
+#if defined(DAWN_ENABLE_BACKEND_METAL)
+            backends.push_back({wgpu::BackendType::Metal, metal::Connect});
+#endif  // defined(DAWN_ENABLE_BACKEND_METAL)
+#if defined(DAWN_ENABLE_BACKEND_VULKAN)
+            backends.push_back({wgpu::BackendType::Vulkan, vulkan::Connect});
+#endif  // defined(DAWN_ENABLE_BACKEND_VULKAN)
+#if defined(DAWN_ENABLE_BACKEND_OPENGL)
+            backends.push_back({wgpu::BackendType::OpenGL, opengl::Connect});
+#endif  // defined(DAWN_ENABLE_BACKEND_OPENGL)
+#if defined(DAWN_ENABLE_BACKEND_NULL)
+            backends.push_back({wgpu::BackendType::Null, null::Connect});
+#endif  // defined(DAWN_ENABLE_BACKEND_NULL)
+            return backends;
+        }
+
+    }  // anonymous namespace
+
     // InstanceBase
 
     // static
@@ -65,25 +99,85 @@ namespace dawn_native {
     }
 
     void InstanceBase::DiscoverDefaultAdapters() {
-        EnsureBackendConnections();
+        std::vector<wgpu::BackendType> backendTypes;
+        for (const CompiledBackend& backend : GetCompiledBackends()) {
+            backendTypes.push_back(backend.type);
+        }
+        DiscoverDefaultAdapters(backendTypes);
+    }
 
-        if (mDiscoveredDefaultAdapters) {
-            return;
+    void InstanceBase::DiscoverDefaultAdapters(const std::vector<wgpu::BackendType>& backendTypes) {
+        struct Discovery {
+            wgpu::BackendType type;
+            BackendConnection* (*connect)(InstanceBase* instance);
+            // Null until the connection is created, unless it was created by DiscoverAdapters.
+            BackendConnection* connection;
+            std::vector<std::unique_ptr<AdapterBase>> adapters;
+        };
+
+        // Discoveries are kept in the order of the compiled backends so that the order of the
+        // adapters doesn't depend on the order of `backendTypes`.
+        std::vector<Discovery> discoveries;
+        for (const CompiledBackend& backend : GetCompiledBackends()) {
+            if (std::find(backendTypes.begin(), backendTypes.end(), backend.type) ==
+                    backendTypes.end() ||
+                mDiscoveredDefaultAdapterTypes.count(backend.type) != 0) {
+                continue;
+            }
+
+            Discovery discovery = {backend.type, backend.connect, nullptr, {}};
+            if (mConnectedBackendTypes.count(backend.type) != 0) {
+                for (std::unique_ptr<BackendConnection>& connection : mBackends) {
+                    if (connection->GetType() == backend.type) {
+                        discovery.connection = connection.get();
+                    }
+                }
+
+                // The connection to the backend was attempted before and failed.
+                if (discovery.connection == nullptr) {
+                    mDiscoveredDefaultAdapterTypes.insert(backend.type);
+                    continue;
+                }
+            }
+            discoveries.push_back(std::move(discovery));
+        }
+
+        // Connecting to a backend and enumerating its adapters can take a long time (loading the
+        // driver, creating the API instance with its layers...) so each backend is discovered on
+        // its own thread. Backend connections don't share any state.
+        auto Discover = [this](Discovery* discovery) {
+            if (discovery->connection == nullptr) {
+                discovery->connection = discovery->connect(this);
+            }
+            if (discovery->connection != nullptr) {
+                discovery->adapters = discovery->connection->DiscoverDefaultAdapters();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < discoveries.size(); ++i) {
+            threads.emplace_back(Discover, &discoveries[i]);
+        }
+        if (!discoveries.empty()) {
+            Discover(&discoveries[0]);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
         }
 
         // Query and merge all default adapters for all backends
-        for (std::unique_ptr<BackendConnection>& backend : mBackends) {
-            std::vector<std::unique_ptr<AdapterBase>> backendAdapters =
-                backend->DiscoverDefaultAdapters();
+        for (Discovery& discovery : discoveries) {
+            if (mConnectedBackendTypes.count(discovery.type) == 0) {
+                RegisterBackendConnection(discovery.connection, discovery.type);
+            }
+            mDiscoveredDefaultAdapterTypes.insert(discovery.type);
 
-            for (std::unique_ptr<AdapterBase>& adapter : backendAdapters) {
-                ASSERT(adapter->GetBackendType() == backend->GetType());
+            for (std::unique_ptr<AdapterBase>& adapter : discovery.adapters) {
+                ASSERT(adapter->GetBackendType() == discovery.type);
                 ASSERT(adapter->GetInstance() == this);
                 mAdapters.push_back(std::move(adapter));
             }
         }
-
-        mDiscoveredDefaultAdapters = true;
     }
 
     // This is just a wrapper around the real logic that uses Error.h error handling.
@@ -116,36 +210,29 @@ namespace dawn_native {
         return mAdapters;
     }
 
-    void InstanceBase::EnsureBackendConnections() {
-        if (mBackendsConnected) {
+    void InstanceBase::EnsureBackendConnection(wgpu::BackendType type) {
+        if (mConnectedBackendTypes.count(type) != 0) {
             return;
         }
 
-        auto Register = [this](BackendConnection* connection, wgpu::BackendType expectedType) {
-            if (connection != nullptr) {
-                ASSERT(connection->GetType() == expectedType);
-                ASSERT(connection->GetInstance() == this);
-                mBackends.push_back(std::unique_ptr<BackendConnection>(connection));
+        for (const CompiledBackend& backend : GetCompiledBackends()) {
+            if (backend.type == type) {
+                RegisterBackendConnection(backend.connect(this), type);
+                return;
             }
-        };
+        }
+    }
 
-#if defined(DAWN_ENABLE_BACKEND_D3D12)
-        Register(d3d12::Connect(this), wgpu::BackendType::D3D12);
-#endif  // defined(DAWN_ENABLE_BACKEND_D3D12)
-#if defined(DAWN_ENABLE_BACKEND_METAL)
-        Register(metal::Connect(this), wgpu::BackendType::Metal);
-#endif  // defined(DAWN_ENABLE_BACKEND_METAL)
-#if defined(DAWN_ENABLE_BACKEND_VULKAN)
-        Register(vulkan::Connect(this), wgpu::BackendType::Vulkan);
-#endif  // defined(DAWN_ENABLE_BACKEND_VULKAN)
-#if defined(DAWN_ENABLE_BACKEND_OPENGL)
-        Register(opengl::Connect(this), wgpu::BackendType::OpenGL);
-#endif  // defined(DAWN_ENABLE_BACKEND_OPENGL)
-#if defined(DAWN_ENABLE_BACKEND_NULL)
-        Register(null::Connect(this), wgpu::BackendType::Null);
-#endif  // defined(DAWN_ENABLE_BACKEND_NULL)
+    void InstanceBase::RegisterBackendConnection(BackendConnection* connection,
+                                                 wgpu::BackendType type) {
+        ASSERT(mConnectedBackendTypes.count(type) == 0);
+        mConnectedBackendTypes.insert(type);
 
-        mBackendsConnected = true;
+        if (connection != nullptr) {
+            ASSERT(connection->GetType() == type);
+            ASSERT(connection->GetInstance() == this);
+            mBackends.push_back(std::unique_ptr<BackendConnection>(connection));
+        }
     }
 
     ResultOrError<BackendConnection*> InstanceBase::FindBackend(wgpu::BackendType type) {
@@ -159,10 +246,11 @@ namespace dawn_native {
     }
 
     MaybeError InstanceBase::DiscoverAdaptersInternal(const AdapterDiscoveryOptionsBase* options) {
-        EnsureBackendConnections();
+        wgpu::BackendType backendType = static_cast<wgpu::BackendType>(options->backendType);
+        EnsureBackendConnection(backendType);
 
         BackendConnection* backend;
-        DAWN_TRY_ASSIGN(backend, FindBackend(static_cast<wgpu::BackendType>(options->backendType)));
+        DAWN_TRY_ASSIGN(backend, FindBackend(backendType));
 
         std::vector<std::unique_ptr<AdapterBase>> newAdapters;
         DAWN_TRY_ASSIGN(newAdapters, backend->DiscoverAdapters(options));
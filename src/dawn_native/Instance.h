@@ -24,6 +24,7 @@
 
 #include <array>
 #include <memory>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -38,6 +39,8 @@ namespace dawn_native {
         static InstanceBase* Create(const InstanceDescriptor* descriptor = nullptr);
 
         void DiscoverDefaultAdapters();
+        // Only connects to and discovers the default adapters of the backends in `backendTypes`.
+        void DiscoverDefaultAdapters(const std::vector<wgpu::BackendType>& backendTypes);
         bool DiscoverAdapters(const AdapterDiscoveryOptionsBase* options);
 
         const std::vector<std::unique_ptr<AdapterBase>>& GetAdapters() const;
@@ -78,16 +81,18 @@ namespace dawn_native {
 
         bool Initialize(const InstanceDescriptor* descriptor);
 
-        // Lazily creates connections to all backends that have been compiled.
-        void EnsureBackendConnections();
+        // Lazily creates the connection to the backend if it has been compiled.
+        void EnsureBackendConnection(wgpu::BackendType type);
+        void RegisterBackendConnection(BackendConnection* connection, wgpu::BackendType type);
 
         // Finds the BackendConnection for `type` or returns an error.
         ResultOrError<BackendConnection*> FindBackend(wgpu::BackendType type);
 
         MaybeError DiscoverAdaptersInternal(const AdapterDiscoveryOptionsBase* options);
 
-        bool mBackendsConnected = false;
-        bool mDiscoveredDefaultAdapters = false;
+        // The backends for which a connection was attempted, even if it failed.
+        std::set<wgpu::BackendType> mConnectedBackendTypes;
+        std::set<wgpu::BackendType> mDiscoveredDefaultAdapterTypes;
 
         bool mEnableBackendValidation = false;
         bool mBeginCaptureOnStartup = false;
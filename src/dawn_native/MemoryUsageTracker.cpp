@@ -0,0 +1,76 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/MemoryUsageTracker.h"
+
+#include "common/Assert.h"
+#include "dawn_native/Device.h"
+
+namespace dawn_native {
+
+    // MemoryUsageTracker
+
+    void MemoryUsageTracker::Track(TrackedObjectType type, uint64_t size) {
+        Counters& counters = mCounters[static_cast<size_t>(type)];
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+        counters.size.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void MemoryUsageTracker::Untrack(TrackedObjectType type, uint64_t size) {
+        Counters& counters = mCounters[static_cast<size_t>(type)];
+        ASSERT(counters.count.load(std::memory_order_relaxed) > 0);
+        counters.count.fetch_sub(1, std::memory_order_relaxed);
+        counters.size.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    void MemoryUsageTracker::GetUsage(MemoryUsage* usage) const {
+        auto Count = [this](TrackedObjectType type) {
+            return mCounters[static_cast<size_t>(type)].count.load(std::memory_order_relaxed);
+        };
+        auto Size = [this](TrackedObjectType type) {
+            return mCounters[static_cast<size_t>(type)].size.load(std::memory_order_relaxed);
+        };
+
+        usage->bufferCount = Count(TrackedObjectType::Buffer);
+        usage->bufferSize = Size(TrackedObjectType::Buffer);
+        usage->textureCount = Count(TrackedObjectType::Texture);
+        usage->textureSize = Size(TrackedObjectType::Texture);
+        usage->accelerationContainerCount = Count(TrackedObjectType::AccelerationContainer);
+        usage->accelerationContainerSize = Size(TrackedObjectType::AccelerationContainer);
+        usage->shaderBindingTableCount = Count(TrackedObjectType::ShaderBindingTable);
+        usage->shaderBindingTableSize = Size(TrackedObjectType::ShaderBindingTable);
+    }
+
+    // TrackedMemory
+
+    TrackedMemory::~TrackedMemory() {
+        Untrack();
+    }
+
+    void TrackedMemory::Track(DeviceBase* device, TrackedObjectType type, uint64_t size) {
+        ASSERT(mTracker == nullptr);
+        mTracker = device->GetMemoryUsageTracker();
+        mType = type;
+        mSize = size;
+        mTracker->Track(type, size);
+    }
+
+    void TrackedMemory::Untrack() {
+        if (mTracker != nullptr) {
+            mTracker->Untrack(mType, mSize);
+            mTracker = nullptr;
+        }
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,72 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_MEMORYUSAGETRACKER_H_
+#define DAWNNATIVE_MEMORYUSAGETRACKER_H_
+
+#include "dawn_native/dawn_platform.h"
+
+#include <array>
+#include <atomic>
+
+namespace dawn_native {
+
+    class DeviceBase;
+
+    enum class TrackedObjectType {
+        Buffer,
+        Texture,
+        AccelerationContainer,
+        ShaderBindingTable,
+
+        EnumCount,
+    };
+
+    // Counts the objects alive on a device and the memory they use, for
+    // DeviceBase::GetMemoryUsage. Objects can be released on any thread, so the counters are
+    // atomic instead of being guarded by the device's mutex.
+    class MemoryUsageTracker {
+      public:
+        void Track(TrackedObjectType type, uint64_t size);
+        void Untrack(TrackedObjectType type, uint64_t size);
+
+        // Sets the counts and sizes of the tracked objects in |usage|.
+        void GetUsage(MemoryUsage* usage) const;
+
+      private:
+        struct Counters {
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> size{0};
+        };
+        std::array<Counters, static_cast<size_t>(TrackedObjectType::EnumCount)> mCounters;
+    };
+
+    // Keeps the memory of an object accounted for from Track until Untrack, or until the object
+    // is destroyed.
+    class TrackedMemory {
+      public:
+        ~TrackedMemory();
+
+        void Track(DeviceBase* device, TrackedObjectType type, uint64_t size);
+        void Untrack();
+
+      private:
+        MemoryUsageTracker* mTracker = nullptr;
+        TrackedObjectType mType = TrackedObjectType::Buffer;
+        uint64_t mSize = 0;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_MEMORYUSAGETRACKER_H_
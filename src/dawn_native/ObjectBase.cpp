@@ -14,16 +14,23 @@
 
 #include "dawn_native/ObjectBase.h"
 
+#include "dawn_native/Device.h"
+
 namespace dawn_native {
 
     static constexpr uint64_t kErrorPayload = 0;
     static constexpr uint64_t kNotErrorPayload = 1;
 
-    ObjectBase::ObjectBase(DeviceBase* device) : RefCounted(kNotErrorPayload), mDevice(device) {
+    static bool UsesSingleThreadedRefCounting(const DeviceBase* device) {
+        return device != nullptr && device->IsToggleEnabled(Toggle::SingleThreadedRefCounting);
+    }
+
+    ObjectBase::ObjectBase(DeviceBase* device)
+        : RefCounted(kNotErrorPayload, UsesSingleThreadedRefCounting(device)), mDevice(device) {
     }
 
     ObjectBase::ObjectBase(DeviceBase* device, ErrorTag)
-        : RefCounted(kErrorPayload), mDevice(device) {
+        : RefCounted(kErrorPayload, UsesSingleThreadedRefCounting(device)), mDevice(device) {
     }
 
     ObjectBase::~ObjectBase() {
@@ -37,4 +44,9 @@ namespace dawn_native {
         return GetRefCountPayload() == kErrorPayload;
     }
 
+    void ObjectBase::DeleteThis() {
+        DeviceLock lock(mDevice->GetMutex());
+        RefCounted::DeleteThis();
+    }
+
 }  // namespace dawn_native
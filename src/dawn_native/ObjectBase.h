@@ -33,6 +33,11 @@ namespace dawn_native {
         DeviceBase* GetDevice() const;
         bool IsError() const;
 
+      protected:
+        // Objects can be released from any thread, their destruction is guarded by the device's
+        // mutex like the other API calls.
+        void DeleteThis() override;
+
       private:
         DeviceBase* mDevice;
     };
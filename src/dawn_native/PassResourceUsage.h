@@ -17,15 +17,26 @@
 
 #include "dawn_native/dawn_platform.h"
 
+#include <map>
 #include <set>
 #include <vector>
 
 namespace dawn_native {
 
     class BufferBase;
+    class QuerySetBase;
+    class ResourceTableBase;
     class TextureBase;
     class RayTracingAccelerationContainerBase;
 
+    // A range of mip levels and array layers of a texture.
+    struct SubresourceRange {
+        uint32_t baseMipLevel;
+        uint32_t levelCount;
+        uint32_t baseArrayLayer;
+        uint32_t layerCount;
+    };
+
     // Which resources are used by pass and how they are used. The command buffer validation
     // pre-computes this information so that backends with explicit barriers don't have to
     // re-compute it.
@@ -35,8 +46,23 @@ namespace dawn_native {
 
         std::vector<TextureBase*> textures;
         std::vector<wgpu::TextureUsage> textureUsages;
+        // For each texture, the smallest range covering all the subresources used by the pass, so
+        // that backends only lazily clear the subresources that are used.
+        std::vector<SubresourceRange> textureRanges;
 
         std::vector<RayTracingAccelerationContainerBase*> accelerationContainers;
+
+        // For each query set, which of its queries are written by the pass.
+        std::vector<QuerySetBase*> querySets;
+        std::vector<std::vector<bool>> writtenQueries;
+
+        // For each resource table, its generation when it was first set in the pass. The submit
+        // checks that the table wasn't modified since.
+        std::vector<ResourceTableBase*> resourceTables;
+        std::vector<uint64_t> resourceTableGenerations;
+
+        // Whether the pass executes render bundles, only set for render passes.
+        bool executesRenderBundles = false;
     };
 
     using PerPassUsages = std::vector<PassResourceUsage>;
@@ -46,6 +72,12 @@ namespace dawn_native {
         std::set<BufferBase*> topLevelBuffers;
         std::set<TextureBase*> topLevelTextures;
         std::set<RayTracingAccelerationContainerBase*> topLevelAccelerationContainers;
+        // The containers built by the command buffer, which may be evicted until the submit.
+        std::set<const RayTracingAccelerationContainerBase*> builtAccelerationContainers;
+        // The query sets used outside of passes, and which of their queries are written there.
+        std::map<QuerySetBase*, std::vector<bool>> topLevelWrittenQueries;
+        // The least capable type of queue that can execute the command buffer.
+        wgpu::QueueType requiredQueueType = wgpu::QueueType::Copy;
     };
 
 }  // namespace dawn_native
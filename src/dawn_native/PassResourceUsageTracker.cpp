@@ -15,8 +15,13 @@
 #include "dawn_native/PassResourceUsageTracker.h"
 
 #include "dawn_native/Buffer.h"
+#include "dawn_native/QuerySet.h"
+#include "dawn_native/RayTracingAccelerationContainer.h"
+#include "dawn_native/ResourceTable.h"
 #include "dawn_native/Texture.h"
 
+#include <algorithm>
+
 namespace dawn_native {
 
     void PassResourceUsageTracker::BufferUsedAs(BufferBase* buffer, wgpu::BufferUsage usage) {
@@ -25,10 +30,63 @@ namespace dawn_native {
         mBufferUsages[buffer] |= usage;
     }
 
-    void PassResourceUsageTracker::TextureUsedAs(TextureBase* texture, wgpu::TextureUsage usage) {
+    void PassResourceUsageTracker::TextureUsedAs(TextureBase* texture,
+                                                 wgpu::TextureUsage usage,
+                                                 const SubresourceRange& range) {
         // std::map's operator[] will create the key and return 0 if the key didn't exist
         // before.
         mTextureUsages[texture] |= usage;
+
+        auto it = mTextureRanges.find(texture);
+        if (it == mTextureRanges.end()) {
+            mTextureRanges.emplace(texture, range);
+            return;
+        }
+
+        // Extend the range to the smallest one covering both ranges.
+        SubresourceRange& merged = it->second;
+        uint32_t endMipLevel = std::max(merged.baseMipLevel + merged.levelCount,
+                                        range.baseMipLevel + range.levelCount);
+        uint32_t endArrayLayer = std::max(merged.baseArrayLayer + merged.layerCount,
+                                          range.baseArrayLayer + range.layerCount);
+        merged.baseMipLevel = std::min(merged.baseMipLevel, range.baseMipLevel);
+        merged.levelCount = endMipLevel - merged.baseMipLevel;
+        merged.baseArrayLayer = std::min(merged.baseArrayLayer, range.baseArrayLayer);
+        merged.layerCount = endArrayLayer - merged.baseArrayLayer;
+    }
+
+    void PassResourceUsageTracker::TextureViewUsedAs(TextureViewBase* view,
+                                                     wgpu::TextureUsage usage) {
+        TextureUsedAs(view->GetTexture(), usage,
+                      {view->GetBaseMipLevel(), view->GetLevelCount(), view->GetBaseArrayLayer(),
+                       view->GetLayerCount()});
+    }
+
+    void PassResourceUsageTracker::AccelerationContainerUsed(
+        RayTracingAccelerationContainerBase* container) {
+        mAccelerationContainers.insert(container);
+    }
+
+    void PassResourceUsageTracker::QueryWritten(QuerySetBase* querySet, uint32_t queryIndex) {
+        std::vector<bool>& writtenQueries = mWrittenQueries[querySet];
+        if (writtenQueries.empty()) {
+            writtenQueries.resize(querySet->GetQueryCount(), false);
+        }
+        writtenQueries[queryIndex] = true;
+    }
+
+    bool PassResourceUsageTracker::IsQueryWritten(QuerySetBase* querySet,
+                                                  uint32_t queryIndex) const {
+        auto it = mWrittenQueries.find(querySet);
+        return it != mWrittenQueries.end() && it->second[queryIndex];
+    }
+
+    void PassResourceUsageTracker::RenderBundlesExecuted() {
+        mExecutesRenderBundles = true;
+    }
+
+    bool PassResourceUsageTracker::ResourceTableUsed(ResourceTableBase* table) {
+        return mResourceTableGenerations.emplace(table, table->GetGeneration()).second;
     }
 
     // Returns the per-pass usage for use by backends for APIs with explicit barriers.
@@ -38,19 +96,50 @@ namespace dawn_native {
         result.bufferUsages.reserve(mBufferUsages.size());
         result.textures.reserve(mTextureUsages.size());
         result.textureUsages.reserve(mTextureUsages.size());
+        result.textureRanges.reserve(mTextureUsages.size());
+        result.accelerationContainers.reserve(mAccelerationContainers.size());
+        result.querySets.reserve(mWrittenQueries.size());
+        result.writtenQueries.reserve(mWrittenQueries.size());
+        result.resourceTables.reserve(mResourceTableGenerations.size());
+        result.resourceTableGenerations.reserve(mResourceTableGenerations.size());
 
         for (auto& it : mBufferUsages) {
             result.buffers.push_back(it.first);
             result.bufferUsages.push_back(it.second);
         }
 
+        // Both maps have the same keys, so they are iterated in the same order.
+        ASSERT(mTextureRanges.size() == mTextureUsages.size());
         for (auto& it : mTextureUsages) {
             result.textures.push_back(it.first);
             result.textureUsages.push_back(it.second);
         }
+        for (auto& it : mTextureRanges) {
+            result.textureRanges.push_back(it.second);
+        }
+
+        result.accelerationContainers.assign(mAccelerationContainers.begin(),
+                                             mAccelerationContainers.end());
+
+        for (auto& it : mWrittenQueries) {
+            result.querySets.push_back(it.first);
+            result.writtenQueries.push_back(std::move(it.second));
+        }
+
+        for (auto& it : mResourceTableGenerations) {
+            result.resourceTables.push_back(it.first);
+            result.resourceTableGenerations.push_back(it.second);
+        }
+
+        result.executesRenderBundles = mExecutesRenderBundles;
 
         mBufferUsages.clear();
         mTextureUsages.clear();
+        mTextureRanges.clear();
+        mAccelerationContainers.clear();
+        mWrittenQueries.clear();
+        mResourceTableGenerations.clear();
+        mExecutesRenderBundles = false;
 
         return result;
     }
@@ -20,11 +20,16 @@
 #include "dawn_native/dawn_platform.h"
 
 #include <map>
+#include <set>
 
 namespace dawn_native {
 
     class BufferBase;
+    class QuerySetBase;
+    class RayTracingAccelerationContainerBase;
+    class ResourceTableBase;
     class TextureBase;
+    class TextureViewBase;
 
     // Helper class to encapsulate the logic of tracking per-resource usage during the
     // validation of command buffer passes. It is used both to know if there are validation
@@ -33,7 +38,17 @@ namespace dawn_native {
     class PassResourceUsageTracker {
       public:
         void BufferUsedAs(BufferBase* buffer, wgpu::BufferUsage usage);
-        void TextureUsedAs(TextureBase* texture, wgpu::TextureUsage usage);
+        void TextureUsedAs(TextureBase* texture,
+                           wgpu::TextureUsage usage,
+                           const SubresourceRange& range);
+        void TextureViewUsedAs(TextureViewBase* view, wgpu::TextureUsage usage);
+        void AccelerationContainerUsed(RayTracingAccelerationContainerBase* container);
+        void QueryWritten(QuerySetBase* querySet, uint32_t queryIndex);
+        bool IsQueryWritten(QuerySetBase* querySet, uint32_t queryIndex) const;
+        void RenderBundlesExecuted();
+        // Returns whether this is the first use of the table in the pass, in which case the
+        // resources of the table need to be tracked.
+        bool ResourceTableUsed(ResourceTableBase* table);
 
         // Returns the per-pass usage for use by backends for APIs with explicit barriers.
         PassResourceUsage AcquireResourceUsage();
@@ -41,6 +56,11 @@ namespace dawn_native {
       private:
         std::map<BufferBase*, wgpu::BufferUsage> mBufferUsages;
         std::map<TextureBase*, wgpu::TextureUsage> mTextureUsages;
+        std::map<TextureBase*, SubresourceRange> mTextureRanges;
+        std::set<RayTracingAccelerationContainerBase*> mAccelerationContainers;
+        std::map<QuerySetBase*, std::vector<bool>> mWrittenQueries;
+        std::map<ResourceTableBase*, uint64_t> mResourceTableGenerations;
+        bool mExecutesRenderBundles = false;
     };
 
 }  // namespace dawn_native
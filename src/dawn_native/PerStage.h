@@ -33,7 +33,8 @@ namespace dawn_native {
         RayAnyHit,
         RayClosestHit,
         RayMiss,
-        RayIntersection
+        RayIntersection,
+        RayCallable
     };
 
     static_assert(static_cast<uint32_t>(SingleShaderStage::Vertex) < kNumStages, "");
@@ -45,6 +46,7 @@ namespace dawn_native {
     static_assert(static_cast<uint32_t>(SingleShaderStage::RayClosestHit) < kNumStages, "");
     static_assert(static_cast<uint32_t>(SingleShaderStage::RayMiss) < kNumStages, "");
     static_assert(static_cast<uint32_t>(SingleShaderStage::RayIntersection) < kNumStages, "");
+    static_assert(static_cast<uint32_t>(SingleShaderStage::RayCallable) < kNumStages, "");
 
     static_assert(static_cast<uint32_t>(wgpu::ShaderStage::Vertex) ==
                       (1 << static_cast<uint32_t>(SingleShaderStage::Vertex)),
@@ -68,6 +70,9 @@ namespace dawn_native {
     static_assert(static_cast<uint32_t>(wgpu::ShaderStage::RayIntersection) ==
                       (1 << static_cast<uint32_t>(SingleShaderStage::RayIntersection)),
                   "");
+    static_assert(static_cast<uint32_t>(wgpu::ShaderStage::RayCallable) ==
+                      (1 << static_cast<uint32_t>(SingleShaderStage::RayCallable)),
+                  "");
 
     BitSetIterator<kNumStages, SingleShaderStage> IterateStages(wgpu::ShaderStage stages);
     wgpu::ShaderStage StageBit(SingleShaderStage stage);
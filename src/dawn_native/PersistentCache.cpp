@@ -0,0 +1,99 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/PersistentCache.h"
+
+#include "common/Assert.h"
+#include "dawn_native/Adapter.h"
+#include "dawn_native/Device.h"
+#include "dawn_platform/DawnPlatform.h"
+
+namespace dawn_native {
+
+    PersistentCacheKeyBuilder::PersistentCacheKeyBuilder(const char* tag, uint32_t version) {
+        Record(std::string(tag));
+        RecordValue(version);
+    }
+
+    PersistentCacheKeyBuilder& PersistentCacheKeyBuilder::Record(const void* data, size_t size) {
+        uint64_t recordSize = size;
+        const uint8_t* sizeBytes = reinterpret_cast<const uint8_t*>(&recordSize);
+        mKey.insert(mKey.end(), sizeBytes, sizeBytes + sizeof(recordSize));
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        mKey.insert(mKey.end(), bytes, bytes + size);
+        return *this;
+    }
+
+    PersistentCacheKeyBuilder& PersistentCacheKeyBuilder::Record(const std::string& str) {
+        return Record(str.data(), str.size());
+    }
+
+    PersistentCacheKey PersistentCacheKeyBuilder::Finish() {
+        return std::move(mKey);
+    }
+
+    PersistentCache::PersistentCache(DeviceBase* device) {
+        dawn_platform::Platform* platform = device->GetPlatform();
+        if (platform == nullptr) {
+            return;
+        }
+
+        // Cached data is only valid for the adapter and driver that produced it.
+        const AdapterBase* adapter = device->GetAdapter();
+        PersistentCacheKey fingerprint = PersistentCacheKeyBuilder("DawnFingerprint", 2)
+                                             .RecordValue(adapter->GetBackendType())
+                                             .RecordValue(adapter->GetPCIInfo().vendorId)
+                                             .RecordValue(adapter->GetPCIInfo().deviceId)
+                                             .Record(adapter->GetPCIInfo().name)
+                                             .Record(adapter->GetDriverFingerprint())
+                                             .Finish();
+        mCache = platform->GetCachingInterface(fingerprint.data(), fingerprint.size());
+    }
+
+    bool PersistentCache::IsEnabled() const {
+        return mCache != nullptr;
+    }
+
+    std::vector<uint8_t> PersistentCache::LoadData(const PersistentCacheKey& key) {
+        std::vector<uint8_t> value;
+        if (mCache == nullptr) {
+            return value;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t size = mCache->LoadData(key.data(), key.size(), nullptr, 0);
+        if (size == 0) {
+            return value;
+        }
+
+        value.resize(size);
+        if (mCache->LoadData(key.data(), key.size(), value.data(), size) != size) {
+            // The entry changed between the two calls, treat it as a miss.
+            value.clear();
+        }
+        return value;
+    }
+
+    void PersistentCache::StoreData(const PersistentCacheKey& key, const void* value, size_t size) {
+        if (mCache == nullptr) {
+            return;
+        }
+
+        ASSERT(value != nullptr && size > 0);
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCache->StoreData(key.data(), key.size(), value, size);
+    }
+
+}  // namespace dawn_native
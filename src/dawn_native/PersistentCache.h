@@ -0,0 +1,85 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_PERSISTENTCACHE_H_
+#define DAWNNATIVE_PERSISTENTCACHE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dawn_platform {
+    class CachingInterface;
+}
+
+namespace dawn_native {
+
+    class DeviceBase;
+
+    using PersistentCacheKey = std::vector<uint8_t>;
+
+    // Builds the keys of the persistent cache out of everything that influences the cached value.
+    // Each record is prefixed with its size so that adjacent records can't alias.
+    class PersistentCacheKeyBuilder {
+      public:
+        // |tag| identifies the kind of data cached and |version| must be bumped whenever its
+        // format or the way it is produced changes.
+        PersistentCacheKeyBuilder(const char* tag, uint32_t version);
+
+        PersistentCacheKeyBuilder& Record(const void* data, size_t size);
+        PersistentCacheKeyBuilder& Record(const std::string& str);
+
+        template <typename T>
+        PersistentCacheKeyBuilder& Record(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable<T>::value, "");
+            return Record(values.data(), values.size() * sizeof(T));
+        }
+
+        template <typename T>
+        PersistentCacheKeyBuilder& RecordValue(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "");
+            return Record(&value, sizeof(T));
+        }
+
+        PersistentCacheKey Finish();
+
+      private:
+        PersistentCacheKey mKey;
+    };
+
+    // Persists data across runs using the CachingInterface provided by the platform. The cache
+    // is disabled (all loads miss and stores are dropped) when the platform doesn't provide one.
+    class PersistentCache {
+      public:
+        PersistentCache(DeviceBase* device);
+
+        bool IsEnabled() const;
+
+        // Returns an empty vector when |key| isn't in the cache.
+        std::vector<uint8_t> LoadData(const PersistentCacheKey& key);
+        void StoreData(const PersistentCacheKey& key, const void* value, size_t size);
+
+      private:
+        dawn_platform::CachingInterface* mCache = nullptr;
+
+        // The CachingInterface may be shared by several devices used on different threads.
+        std::mutex mMutex;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_PERSISTENTCACHE_H_
@@ -19,6 +19,8 @@
 #include "dawn_native/PipelineLayout.h"
 #include "dawn_native/ShaderModule.h"
 
+#include <cstring>
+
 namespace dawn_native {
 
     MaybeError ValidateProgrammableStageDescriptor(const DeviceBase* device,
@@ -27,7 +29,7 @@ namespace dawn_native {
                                                    SingleShaderStage stage) {
         DAWN_TRY(device->ValidateObject(descriptor->module));
 
-        if (descriptor->entryPoint != std::string("main")) {
+        if (strcmp(descriptor->entryPoint, "main") != 0) {
             return DAWN_VALIDATION_ERROR("Entry point must be \"main\"");
         }
         if (descriptor->module->GetExecutionModel() != stage) {
@@ -20,6 +20,7 @@
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Device.h"
 #include "dawn_native/ShaderModule.h"
+#include "dawn_native/ValidationUtils_autogen.h"
 
 namespace dawn_native {
 
@@ -72,8 +73,12 @@ namespace dawn_native {
 
         uint32_t totalDynamicUniformBufferCount = 0;
         uint32_t totalDynamicStorageBufferCount = 0;
+        uint32_t pushDescriptorLayoutCount = 0;
         for (uint32_t i = 0; i < descriptor->bindGroupLayoutCount; ++i) {
             DAWN_TRY(device->ValidateObject(descriptor->bindGroupLayouts[i]));
+            if (descriptor->bindGroupLayouts[i]->UsesPushDescriptors()) {
+                pushDescriptorLayoutCount++;
+            }
             totalDynamicUniformBufferCount +=
                 descriptor->bindGroupLayouts[i]->GetDynamicUniformBufferCount();
             totalDynamicStorageBufferCount +=
@@ -88,6 +93,28 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR("too many dynamic storage buffers in pipeline layout");
         }
 
+        if (pushDescriptorLayoutCount > 1) {
+            return DAWN_VALIDATION_ERROR("too many push descriptor layouts in pipeline layout");
+        }
+
+        DAWN_TRY(ValidateShaderStage(descriptor->pushConstantVisibility));
+        if (descriptor->pushConstantSize > 0) {
+            if (!device->IsExtensionEnabled(Extension::PushConstants)) {
+                return DAWN_VALIDATION_ERROR("The push constants extension is not enabled");
+            }
+            if (descriptor->pushConstantSize > kMaxPushConstantSize) {
+                return DAWN_VALIDATION_ERROR("push constant size over the max");
+            }
+            if (descriptor->pushConstantSize % kPushConstantAlignment != 0) {
+                return DAWN_VALIDATION_ERROR("push constant size must be a multiple of 4");
+            }
+            if (descriptor->pushConstantVisibility == wgpu::ShaderStage::None) {
+                return DAWN_VALIDATION_ERROR("push constants must be visible to a stage");
+            }
+        } else if (descriptor->pushConstantVisibility != wgpu::ShaderStage::None) {
+            return DAWN_VALIDATION_ERROR("push constant visibility without push constants");
+        }
+
         return {};
     }
 
@@ -101,6 +128,8 @@ namespace dawn_native {
             mBindGroupLayouts[group] = descriptor->bindGroupLayouts[group];
             mMask.set(group);
         }
+        mPushConstantSize = descriptor->pushConstantSize;
+        mPushConstantVisibility = descriptor->pushConstantVisibility;
     }
 
     PipelineLayoutBase::PipelineLayoutBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -140,8 +169,18 @@ namespace dawn_native {
         std::array<uint32_t, kMaxBindGroups> bindingCounts = {};
 
         uint32_t bindGroupLayoutCount = 0;
+        uint32_t pushConstantSize = 0;
+        wgpu::ShaderStage pushConstantVisibility = wgpu::ShaderStage::None;
         for (uint32_t moduleIndex = 0; moduleIndex < count; ++moduleIndex) {
             const ShaderModuleBase* module = modules[moduleIndex];
+            if (module->GetPushConstantSize() > 0) {
+                if (!device->IsExtensionEnabled(Extension::PushConstants)) {
+                    return DAWN_VALIDATION_ERROR("The push constants extension is not enabled");
+                }
+                pushConstantSize = std::max(pushConstantSize, module->GetPushConstantSize());
+                pushConstantVisibility |= StageBit(module->GetExecutionModel());
+            }
+
             const ShaderModuleBase::ModuleBindingInfo& info = module->GetBindingInfo();
             for (uint32_t group = 0; group < info.size(); ++group) {
                 for (uint32_t binding = 0; binding < info[group].size(); ++binding) {
@@ -152,6 +191,10 @@ namespace dawn_native {
                     if (bindingInfo.multisampled) {
                         return DAWN_VALIDATION_ERROR("Multisampled textures not supported (yet)");
                     }
+                    if (bindingInfo.arraySize != 1) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Arrays of resources need an explicit resource table layout");
+                    }
                     BindGroupLayoutBinding bindingSlot;
                     bindingSlot.binding = binding;
                     DAWN_TRY(ValidateBindingTypeWithShaderStageVisibility(
@@ -198,6 +241,8 @@ namespace dawn_native {
         PipelineLayoutDescriptor desc = {};
         desc.bindGroupLayouts = bindGroupLayouts.data();
         desc.bindGroupLayoutCount = bindGroupLayoutCount;
+        desc.pushConstantSize = pushConstantSize;
+        desc.pushConstantVisibility = pushConstantVisibility;
         PipelineLayoutBase* pipelineLayout = device->CreatePipelineLayout(&desc);
         ASSERT(!pipelineLayout->IsError());
 
@@ -239,6 +284,16 @@ namespace dawn_native {
         return mMask;
     }
 
+    uint32_t PipelineLayoutBase::GetPushConstantSize() const {
+        ASSERT(!IsError());
+        return mPushConstantSize;
+    }
+
+    wgpu::ShaderStage PipelineLayoutBase::GetPushConstantVisibility() const {
+        ASSERT(!IsError());
+        return mPushConstantVisibility;
+    }
+
     std::bitset<kMaxBindGroups> PipelineLayoutBase::InheritedGroupsMask(
         const PipelineLayoutBase* other) const {
         ASSERT(!IsError());
@@ -248,6 +303,13 @@ namespace dawn_native {
     uint32_t PipelineLayoutBase::GroupsInheritUpTo(const PipelineLayoutBase* other) const {
         ASSERT(!IsError());
 
+        // Vulkan pipeline layouts are only compatible for a set if their push constant ranges
+        // are identical as well.
+        if (mPushConstantSize != other->mPushConstantSize ||
+            mPushConstantVisibility != other->mPushConstantVisibility) {
+            return 0;
+        }
+
         for (uint32_t i = 0; i < kMaxBindGroups; ++i) {
             if (!mMask[i] || mBindGroupLayouts[i].Get() != other->mBindGroupLayouts[i].Get()) {
                 return i;
@@ -258,6 +320,7 @@ namespace dawn_native {
 
     size_t PipelineLayoutBase::HashFunc::operator()(const PipelineLayoutBase* pl) const {
         size_t hash = Hash(pl->mMask);
+        HashCombine(&hash, pl->mPushConstantSize, pl->mPushConstantVisibility);
 
         for (uint32_t group : IterateBitSet(pl->mMask)) {
             HashCombine(&hash, pl->GetBindGroupLayout(group));
@@ -268,7 +331,8 @@ namespace dawn_native {
 
     bool PipelineLayoutBase::EqualityFunc::operator()(const PipelineLayoutBase* a,
                                                       const PipelineLayoutBase* b) const {
-        if (a->mMask != b->mMask) {
+        if (a->mMask != b->mMask || a->mPushConstantSize != b->mPushConstantSize ||
+            a->mPushConstantVisibility != b->mPushConstantVisibility) {
             return false;
         }
 
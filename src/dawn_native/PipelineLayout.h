@@ -45,15 +45,19 @@ namespace dawn_native {
         BindGroupLayoutBase* GetBindGroupLayout(uint32_t group);
         const std::bitset<kMaxBindGroups> GetBindGroupLayoutsMask() const;
 
+        // The push constants are a single range starting at 0, visible to the same stages.
+        uint32_t GetPushConstantSize() const;
+        wgpu::ShaderStage GetPushConstantVisibility() const;
+
         // Utility functions to compute inherited bind groups.
         // Returns the inherited bind groups as a mask.
         std::bitset<kMaxBindGroups> InheritedGroupsMask(const PipelineLayoutBase* other) const;
 
         // Returns the index of the first incompatible bind group in the range
-        // [1, kMaxBindGroups + 1]
+        // [0, kMaxBindGroups]
         uint32_t GroupsInheritUpTo(const PipelineLayoutBase* other) const;
 
-        // Functors necessary for the unordered_set<PipelineLayoutBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<PipelineLayoutBase>.
         struct HashFunc {
             size_t operator()(const PipelineLayoutBase* pl) const;
         };
@@ -66,6 +70,8 @@ namespace dawn_native {
 
         BindGroupLayoutArray mBindGroupLayouts;
         std::bitset<kMaxBindGroups> mMask;
+        uint32_t mPushConstantSize = 0;
+        wgpu::ShaderStage mPushConstantVisibility = wgpu::ShaderStage::None;
     };
 
 }  // namespace dawn_native
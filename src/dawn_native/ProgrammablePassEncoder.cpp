@@ -15,11 +15,15 @@
 #include "dawn_native/ProgrammablePassEncoder.h"
 
 #include "common/BitSetIterator.h"
+#include "common/Constants.h"
 #include "dawn_native/BindGroup.h"
 #include "dawn_native/Buffer.h"
 #include "dawn_native/CommandBuffer.h"
+#include "dawn_native/CommandValidation.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/QuerySet.h"
+#include "dawn_native/ResourceTable.h"
 #include "dawn_native/ValidationUtils_autogen.h"
 
 #include <cstring>
@@ -46,8 +50,8 @@ namespace dawn_native {
                     } break;
 
                     case wgpu::BindingType::SampledTexture: {
-                        TextureBase* texture = group->GetBindingAsTextureView(i)->GetTexture();
-                        usageTracker->TextureUsedAs(texture, wgpu::TextureUsage::Sampled);
+                        TextureViewBase* view = group->GetBindingAsTextureView(i);
+                        usageTracker->TextureViewUsedAs(view, wgpu::TextureUsage::Sampled);
                     } break;
 
                     case wgpu::BindingType::ReadonlyStorageBuffer: {
@@ -58,8 +62,11 @@ namespace dawn_native {
                     case wgpu::BindingType::Sampler:
                         break;
 
-                    case wgpu::BindingType::AccelerationContainer:
-                        break;
+                    case wgpu::BindingType::AccelerationContainer: {
+                        RayTracingAccelerationContainerBase* container =
+                            group->GetBindingAsRayTracingAccelerationContainer(i);
+                        usageTracker->AccelerationContainerUsed(container);
+                    } break;
 
                     case wgpu::BindingType::StorageTexture:
                     case wgpu::BindingType::ReadonlyStorageTexture:
@@ -73,7 +80,7 @@ namespace dawn_native {
 
     ProgrammablePassEncoder::ProgrammablePassEncoder(DeviceBase* device,
                                                      EncodingContext* encodingContext)
-        : ObjectBase(device), mEncodingContext(encodingContext) {
+        : ObjectBase(device), mEncodingContext(encodingContext), mCommandBufferState(device) {
     }
 
     ProgrammablePassEncoder::ProgrammablePassEncoder(DeviceBase* device,
@@ -82,6 +89,30 @@ namespace dawn_native {
         : ObjectBase(device, errorTag), mEncodingContext(encodingContext) {
     }
 
+    MaybeError ProgrammablePassEncoder::ValidateProgrammableEncoderEnd() const {
+        if (!GetDevice()->IsValidationEnabled()) {
+            return {};
+        }
+        if (mActivePipelineStatisticsQuerySet != nullptr) {
+            return DAWN_VALIDATION_ERROR("Pipeline statistics query still active at the pass end");
+        }
+        if (mConditionalRenderingActive) {
+            return DAWN_VALIDATION_ERROR("Conditional rendering still active at the pass end");
+        }
+        return ValidateFinalDebugGroupStackSize(mDebugGroupStackSize);
+    }
+
+    MaybeError ProgrammablePassEncoder::ValidateQueryWriteInPass(QuerySetBase* querySet,
+                                                                 uint32_t queryIndex,
+                                                                 wgpu::QueryType queryType) const {
+        DAWN_TRY(GetDevice()->ValidateObject(querySet));
+        DAWN_TRY(ValidateQueryWrite(querySet, queryIndex, queryType));
+        if (mUsageTracker.IsQueryWritten(querySet, queryIndex)) {
+            return DAWN_VALIDATION_ERROR("Query written more than once in the pass");
+        }
+        return {};
+    }
+
     void ProgrammablePassEncoder::InsertDebugMarker(const char* groupLabel) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             InsertDebugMarkerCmd* cmd =
@@ -97,6 +128,11 @@ namespace dawn_native {
 
     void ProgrammablePassEncoder::PopDebugGroup() {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateCanPopDebugGroup(mDebugGroupStackSize));
+            }
+            mDebugGroupStackSize--;
+
             allocator->Allocate<PopDebugGroupCmd>(Command::PopDebugGroup);
 
             return {};
@@ -112,6 +148,8 @@ namespace dawn_native {
             char* label = allocator->AllocateData<char>(cmd->length + 1);
             memcpy(label, groupLabel, cmd->length + 1);
 
+            mDebugGroupStackSize++;
+
             return {};
         });
     }
@@ -136,7 +174,10 @@ namespace dawn_native {
 
                 for (uint32_t i = 0; i < dynamicOffsetCount; ++i) {
                     if (dynamicOffsets[i] % kMinDynamicBufferOffsetAlignment != 0) {
-                        return DAWN_VALIDATION_ERROR("Dynamic Buffer Offset need to be aligned");
+                        return DAWN_FORMAT_VALIDATION_ERROR(
+                            "Dynamic Buffer Offset %u (%u) need to be aligned to %u", i,
+                            dynamicOffsets[i],
+                            static_cast<uint32_t>(kMinDynamicBufferOffsetAlignment));
                     }
 
                     BufferBinding bufferBinding = group->GetBindingAsBufferBinding(i);
@@ -149,7 +190,8 @@ namespace dawn_native {
 
                     if ((dynamicOffsets[i] > bufferBinding.buffer->GetSize() -
                                                  bufferBinding.offset - bufferBinding.size)) {
-                        return DAWN_VALIDATION_ERROR("dynamic offset out of bounds");
+                        return DAWN_FORMAT_VALIDATION_ERROR(
+                            "dynamic offset %u (%u) out of bounds", i, dynamicOffsets[i]);
                     }
                 }
             }
@@ -157,13 +199,200 @@ namespace dawn_native {
             SetBindGroupCmd* cmd = allocator->Allocate<SetBindGroupCmd>(Command::SetBindGroup);
             cmd->index = groupIndex;
             cmd->group = group;
+            mEncodingContext->RetainObject(group);
             cmd->dynamicOffsetCount = dynamicOffsetCount;
             if (dynamicOffsetCount > 0) {
-                uint32_t* offsets = allocator->AllocateData<uint32_t>(cmd->dynamicOffsetCount);
+                uint32_t* offsets = cmd->inlineDynamicOffsets;
+                if (dynamicOffsetCount > kMaxInlineDynamicOffsets) {
+                    offsets = allocator->AllocateData<uint32_t>(dynamicOffsetCount);
+                }
                 memcpy(offsets, dynamicOffsets, dynamicOffsetCount * sizeof(uint32_t));
             }
 
             TrackBindGroupResourceUsage(&mUsageTracker, group);
+            mCommandBufferState.SetBindGroup(groupIndex, group);
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::SetResourceTable(uint32_t groupIndex, ResourceTableBase* table) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(GetDevice()->ValidateObject(table));
+
+                if (groupIndex >= kMaxBindGroups) {
+                    return DAWN_VALIDATION_ERROR("Setting resource table over the max");
+                }
+            }
+
+            // The table is recorded like a bind group without dynamic offsets, backends tell them
+            // apart with their layout.
+            SetBindGroupCmd* cmd = allocator->Allocate<SetBindGroupCmd>(Command::SetBindGroup);
+            cmd->index = groupIndex;
+            cmd->group = table;
+            mEncodingContext->RetainObject(table);
+            cmd->dynamicOffsetCount = 0;
+
+            if (mUsageTracker.ResourceTableUsed(table)) {
+                table->TrackUsage(&mUsageTracker);
+            }
+            mCommandBufferState.SetBindGroup(groupIndex, table);
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::SetPushConstants(wgpu::ShaderStage stages,
+                                                   uint32_t offset,
+                                                   uint32_t size,
+                                                   const void* data) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                if (!GetDevice()->IsExtensionEnabled(Extension::PushConstants)) {
+                    return DAWN_VALIDATION_ERROR("The push constants extension is not enabled");
+                }
+
+                DAWN_TRY(ValidateShaderStage(stages));
+                if (stages == wgpu::ShaderStage::None) {
+                    return DAWN_VALIDATION_ERROR("Push constants must be set for a stage");
+                }
+
+                if (offset % kPushConstantAlignment != 0 || size % kPushConstantAlignment != 0) {
+                    return DAWN_VALIDATION_ERROR("Push constant offset and size must be aligned");
+                }
+
+                // The range is checked against the pipeline layout when drawing or dispatching,
+                // since the pipeline may be set after the push constants.
+                if (size == 0 || offset > kMaxPushConstantSize ||
+                    size > kMaxPushConstantSize - offset) {
+                    return DAWN_VALIDATION_ERROR("Push constant range over the max");
+                }
+            }
+
+            SetPushConstantsCmd* cmd =
+                allocator->Allocate<SetPushConstantsCmd>(Command::SetPushConstants);
+            cmd->stages = stages;
+            cmd->offset = offset;
+            cmd->size = size;
+            uint8_t* pushData = allocator->AllocateData<uint8_t>(size);
+            memcpy(pushData, data, size);
+
+            mCommandBufferState.SetPushConstants(stages, offset, size);
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::WriteTimestamp(QuerySetBase* querySet, uint32_t queryIndex) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateQueryWriteInPass(querySet, queryIndex, wgpu::QueryType::Timestamp));
+            }
+
+            WriteTimestampCmd* cmd =
+                allocator->Allocate<WriteTimestampCmd>(Command::WriteTimestamp);
+            cmd->querySet = querySet;
+            cmd->queryIndex = queryIndex;
+
+            mUsageTracker.QueryWritten(querySet, queryIndex);
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::BeginPipelineStatisticsQuery(QuerySetBase* querySet,
+                                                               uint32_t queryIndex) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(ValidateQueryWriteInPass(querySet, queryIndex,
+                                                  wgpu::QueryType::PipelineStatistics));
+                if (mActivePipelineStatisticsQuerySet != nullptr) {
+                    return DAWN_VALIDATION_ERROR("A pipeline statistics query is already active");
+                }
+            }
+
+            BeginPipelineStatisticsQueryCmd* cmd =
+                allocator->Allocate<BeginPipelineStatisticsQueryCmd>(
+                    Command::BeginPipelineStatisticsQuery);
+            cmd->querySet = querySet;
+            cmd->queryIndex = queryIndex;
+
+            mUsageTracker.QueryWritten(querySet, queryIndex);
+            mActivePipelineStatisticsQuerySet = querySet;
+            mActivePipelineStatisticsQueryIndex = queryIndex;
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::EndPipelineStatisticsQuery() {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                if (mActivePipelineStatisticsQuerySet == nullptr) {
+                    return DAWN_VALIDATION_ERROR("No pipeline statistics query is active");
+                }
+            }
+
+            EndPipelineStatisticsQueryCmd* cmd =
+                allocator->Allocate<EndPipelineStatisticsQueryCmd>(
+                    Command::EndPipelineStatisticsQuery);
+            cmd->querySet = mActivePipelineStatisticsQuerySet;
+            cmd->queryIndex = mActivePipelineStatisticsQueryIndex;
+
+            mActivePipelineStatisticsQuerySet = nullptr;
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::BeginConditionalRendering(BufferBase* predicateBuffer,
+                                                            uint64_t predicateOffset,
+                                                            bool inverted) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(GetDevice()->ValidateObject(predicateBuffer));
+
+                if (!GetDevice()->IsExtensionEnabled(Extension::ConditionalRendering)) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Conditional rendering requires the conditional_rendering extension");
+                }
+                if (mConditionalRenderingActive) {
+                    return DAWN_VALIDATION_ERROR("Conditional rendering is already active");
+                }
+                if (predicateOffset % kPredicateOffsetAlignment != 0) {
+                    return DAWN_VALIDATION_ERROR("Predicate offset must be a multiple of 8");
+                }
+                if (predicateOffset >= predicateBuffer->GetSize() ||
+                    kPredicateSize > predicateBuffer->GetSize() - predicateOffset) {
+                    return DAWN_VALIDATION_ERROR("Predicate offset out of bounds");
+                }
+            }
+
+            BeginConditionalRenderingCmd* cmd =
+                allocator->Allocate<BeginConditionalRenderingCmd>(
+                    Command::BeginConditionalRendering);
+            cmd->predicateBuffer = predicateBuffer;
+            cmd->predicateOffset = predicateOffset;
+            cmd->inverted = inverted;
+
+            mUsageTracker.BufferUsedAs(predicateBuffer, wgpu::BufferUsage::Predicate);
+            mConditionalRenderingActive = true;
+
+            return {};
+        });
+    }
+
+    void ProgrammablePassEncoder::EndConditionalRendering() {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                if (!mConditionalRenderingActive) {
+                    return DAWN_VALIDATION_ERROR("Conditional rendering is not active");
+                }
+            }
+
+            allocator->Allocate<EndConditionalRenderingCmd>(Command::EndConditionalRendering);
+            mConditionalRenderingActive = false;
 
             return {};
         });
@@ -15,6 +15,8 @@
 #ifndef DAWNNATIVE_PROGRAMMABLEPASSENCODER_H_
 #define DAWNNATIVE_PROGRAMMABLEPASSENCODER_H_
 
+#include "common/MagazineAllocator.h"
+#include "dawn_native/CommandBufferStateTracker.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ObjectBase.h"
@@ -28,7 +30,8 @@ namespace dawn_native {
     class DeviceBase;
 
     // Base class for shared functionality between ComputePassEncoder and RenderPassEncoder.
-    class ProgrammablePassEncoder : public ObjectBase {
+    // Passes are encoded every frame, they are allocated out of the MagazineAllocator.
+    class ProgrammablePassEncoder : public ObjectBase, public MagazineAllocated {
       public:
         ProgrammablePassEncoder(DeviceBase* device, EncodingContext* encodingContext);
 
@@ -40,6 +43,23 @@ namespace dawn_native {
                           BindGroupBase* group,
                           uint32_t dynamicOffsetCount,
                           const uint32_t* dynamicOffsets);
+        void SetResourceTable(uint32_t groupIndex, ResourceTableBase* table);
+        void SetPushConstants(wgpu::ShaderStage stages,
+                              uint32_t offset,
+                              uint32_t size,
+                              const void* data);
+
+        void WriteTimestamp(QuerySetBase* querySet, uint32_t queryIndex);
+        void BeginPipelineStatisticsQuery(QuerySetBase* querySet, uint32_t queryIndex);
+        void EndPipelineStatisticsQuery();
+
+        // The commands until EndConditionalRendering are skipped when the predicate at
+        // |predicateOffset| is zero, or when it isn't if |inverted|. The predicate is written on
+        // the GPU, for example by a culling pass, so that nothing needs to be read back.
+        void BeginConditionalRendering(BufferBase* predicateBuffer,
+                                       uint64_t predicateOffset,
+                                       bool inverted);
+        void EndConditionalRendering();
 
       protected:
         // Construct an "error" programmable pass encoder.
@@ -47,8 +67,29 @@ namespace dawn_native {
                                 EncodingContext* encodingContext,
                                 ErrorTag errorTag);
 
+        // Checks the state that can only be validated once all the commands of the pass have been
+        // encoded.
+        MaybeError ValidateProgrammableEncoderEnd() const;
+
+        // Checks that a query may be written by the pass. A query can only be written once per
+        // pass since backends may reset all the queries of a pass before it begins.
+        MaybeError ValidateQueryWriteInPass(QuerySetBase* querySet,
+                                            uint32_t queryIndex,
+                                            wgpu::QueryType queryType) const;
+
         EncodingContext* mEncodingContext = nullptr;
         PassResourceUsageTracker mUsageTracker;
+
+        // The commands are validated as they are encoded, so that finishing the command buffer
+        // doesn't have to iterate over them again.
+        CommandBufferStateTracker mCommandBufferState;
+        uint64_t mDebugGroupStackSize = 0;
+
+        // The pipeline statistics query between a Begin and End, kept alive by the commands.
+        QuerySetBase* mActivePipelineStatisticsQuerySet = nullptr;
+        uint32_t mActivePipelineStatisticsQueryIndex = 0;
+
+        bool mConditionalRenderingActive = false;
     };
 
 }  // namespace dawn_native
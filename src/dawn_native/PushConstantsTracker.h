@@ -0,0 +1,74 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_PUSHCONSTANTSTRACKER_H_
+#define DAWNNATIVE_PUSHCONSTANTSTRACKER_H_
+
+#include "common/Assert.h"
+#include "common/Constants.h"
+#include "dawn_native/Pipeline.h"
+#include "dawn_native/PipelineLayout.h"
+
+#include <array>
+#include <cstring>
+
+namespace dawn_native {
+
+    // Keeps a copy of the push constants of a pass so they can be lazily applied when we know the
+    // pipeline layout. The push constants can be set before the pipeline and the backends need the
+    // layout to apply them, and may lose them when the layout changes, so the whole range of the
+    // layout is applied again after each change.
+    class PushConstantsTracker {
+      public:
+        void OnSetPushConstants(uint32_t offset, uint32_t size, const void* data) {
+            ASSERT(offset % kPushConstantAlignment == 0 && size % kPushConstantAlignment == 0);
+            ASSERT(offset + size <= kMaxPushConstantSize);
+            memcpy(&mData[offset / kPushConstantAlignment], data, size);
+            mDirty = true;
+        }
+
+        void OnSetPipeline(PipelineBase* pipeline) {
+            if (mPipelineLayout != pipeline->GetLayout()) {
+                mPipelineLayout = pipeline->GetLayout();
+                mDirty = true;
+            }
+        }
+
+        // Forces the push constants to be applied again after the next pipeline is set, for
+        // example when recording continues in a new command buffer that doesn't inherit them.
+        void Invalidate() {
+            mPipelineLayout = nullptr;
+        }
+
+      protected:
+        // Returns whether the push constants of the current layout need to be applied.
+        bool NeedsApply() const {
+            return mDirty && mPipelineLayout != nullptr &&
+                   mPipelineLayout->GetPushConstantSize() > 0;
+        }
+
+        void DidApply() {
+            mDirty = false;
+        }
+
+        PipelineLayoutBase* mPipelineLayout = nullptr;
+        std::array<uint32_t, kMaxPushConstantSize / kPushConstantAlignment> mData = {};
+
+      private:
+        bool mDirty = false;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_PUSHCONSTANTSTRACKER_H_
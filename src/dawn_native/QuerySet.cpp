@@ -0,0 +1,187 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/QuerySet.h"
+
+#include "common/Assert.h"
+#include "common/Constants.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/Extensions.h"
+#include "dawn_native/ValidationUtils_autogen.h"
+
+#include <algorithm>
+
+namespace dawn_native {
+
+    MaybeError ValidateQuerySetDescriptor(DeviceBase* device,
+                                          const QuerySetDescriptor* descriptor) {
+        if (descriptor->nextInChain != nullptr) {
+            return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+        }
+
+        DAWN_TRY(ValidateQueryType(descriptor->type));
+
+        if (descriptor->count == 0) {
+            return DAWN_VALIDATION_ERROR("Query set must have at least one query");
+        }
+        if (descriptor->count > kMaxQueryCount) {
+            return DAWN_VALIDATION_ERROR("Query set has too many queries");
+        }
+
+        switch (descriptor->type) {
+            case wgpu::QueryType::Occlusion:
+                if (descriptor->pipelineStatisticsCount != 0) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Pipeline statistics can only be set for pipeline statistics queries");
+                }
+                break;
+
+            case wgpu::QueryType::PipelineStatistics: {
+                if (!device->IsExtensionEnabled(Extension::PipelineStatisticsQuery)) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Pipeline statistics queries require the pipeline_statistics_query "
+                        "extension");
+                }
+                if (descriptor->pipelineStatisticsCount == 0) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Pipeline statistics queries need at least one pipeline statistic");
+                }
+
+                std::vector<wgpu::PipelineStatisticName> statistics(
+                    descriptor->pipelineStatistics,
+                    descriptor->pipelineStatistics + descriptor->pipelineStatisticsCount);
+                for (wgpu::PipelineStatisticName statistic : statistics) {
+                    DAWN_TRY(ValidatePipelineStatisticName(statistic));
+                }
+                std::sort(statistics.begin(), statistics.end());
+                if (std::adjacent_find(statistics.begin(), statistics.end()) != statistics.end()) {
+                    return DAWN_VALIDATION_ERROR("Duplicate pipeline statistic");
+                }
+                break;
+            }
+
+            case wgpu::QueryType::Timestamp:
+                if (!device->IsExtensionEnabled(Extension::TimestampQuery)) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Timestamp queries require the timestamp_query extension");
+                }
+                if (descriptor->pipelineStatisticsCount != 0) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Pipeline statistics can only be set for pipeline statistics queries");
+                }
+                break;
+
+            default:
+                UNREACHABLE();
+        }
+
+        return {};
+    }
+
+    // QuerySetBase
+
+    QuerySetBase::QuerySetBase(DeviceBase* device, const QuerySetDescriptor* descriptor)
+        : ObjectBase(device),
+          mQueryType(descriptor->type),
+          mQueryCount(descriptor->count),
+          mQueryAvailability(descriptor->count, false) {
+        mPipelineStatistics.assign(
+            descriptor->pipelineStatistics,
+            descriptor->pipelineStatistics + descriptor->pipelineStatisticsCount);
+        std::sort(mPipelineStatistics.begin(), mPipelineStatistics.end());
+    }
+
+    QuerySetBase::QuerySetBase(DeviceBase* device, ObjectBase::ErrorTag tag)
+        : ObjectBase(device, tag) {
+    }
+
+    QuerySetBase::~QuerySetBase() {
+    }
+
+    // static
+    QuerySetBase* QuerySetBase::MakeError(DeviceBase* device) {
+        return new QuerySetBase(device, ObjectBase::kError);
+    }
+
+    wgpu::QueryType QuerySetBase::GetQueryType() const {
+        ASSERT(!IsError());
+        return mQueryType;
+    }
+
+    uint32_t QuerySetBase::GetQueryCount() const {
+        ASSERT(!IsError());
+        return mQueryCount;
+    }
+
+    const std::vector<wgpu::PipelineStatisticName>& QuerySetBase::GetPipelineStatistics() const {
+        ASSERT(!IsError());
+        return mPipelineStatistics;
+    }
+
+    uint32_t QuerySetBase::GetResultCountPerQuery() const {
+        ASSERT(!IsError());
+        if (mQueryType == wgpu::QueryType::PipelineStatistics) {
+            return static_cast<uint32_t>(mPipelineStatistics.size());
+        }
+        return 1;
+    }
+
+    bool QuerySetBase::IsQueryAvailable(uint32_t queryIndex) const {
+        ASSERT(!IsError());
+        ASSERT(queryIndex < mQueryCount);
+        return mQueryAvailability[queryIndex];
+    }
+
+    void QuerySetBase::SetQueriesAvailable(const std::vector<bool>& writtenQueries) {
+        ASSERT(!IsError());
+        ASSERT(writtenQueries.size() == mQueryCount);
+        for (uint32_t i = 0; i < mQueryCount; ++i) {
+            if (writtenQueries[i]) {
+                mQueryAvailability[i] = true;
+            }
+        }
+    }
+
+    MaybeError QuerySetBase::ValidateCanUseInSubmitNow() const {
+        ASSERT(!IsError());
+        if (mIsDestroyed) {
+            return DAWN_VALIDATION_ERROR("Destroyed query set used in a submit");
+        }
+        return {};
+    }
+
+    void QuerySetBase::Destroy() {
+        if (GetDevice()->ConsumedError(ValidateDestroy())) {
+            return;
+        }
+        ASSERT(!IsError());
+        DestroyInternal();
+    }
+
+    void QuerySetBase::DestroyImpl() {
+    }
+
+    void QuerySetBase::DestroyInternal() {
+        if (!mIsDestroyed) {
+            DestroyImpl();
+        }
+        mIsDestroyed = true;
+    }
+
+    MaybeError QuerySetBase::ValidateDestroy() const {
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        return {};
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,75 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_QUERYSET_H_
+#define DAWNNATIVE_QUERYSET_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+#include "dawn_native/ObjectBase.h"
+
+#include "dawn_native/dawn_platform.h"
+
+#include <vector>
+
+namespace dawn_native {
+
+    MaybeError ValidateQuerySetDescriptor(DeviceBase* device, const QuerySetDescriptor* descriptor);
+
+    class QuerySetBase : public ObjectBase {
+      public:
+        QuerySetBase(DeviceBase* device, const QuerySetDescriptor* descriptor);
+        ~QuerySetBase();
+
+        static QuerySetBase* MakeError(DeviceBase* device);
+
+        wgpu::QueryType GetQueryType() const;
+        uint32_t GetQueryCount() const;
+        // Sorted in the order of the PipelineStatisticName values, which is also the order their
+        // results are resolved in.
+        const std::vector<wgpu::PipelineStatisticName>& GetPipelineStatistics() const;
+        // The number of 64-bit values written by ResolveQuerySet for each query.
+        uint32_t GetResultCountPerQuery() const;
+
+        // A query is available once a submitted command buffer has written it. Only available
+        // queries, or queries written earlier in the same command buffer, may be resolved.
+        bool IsQueryAvailable(uint32_t queryIndex) const;
+        void SetQueriesAvailable(const std::vector<bool>& writtenQueries);
+
+        MaybeError ValidateCanUseInSubmitNow() const;
+
+        // Dawn API
+        void Destroy();
+
+      protected:
+        QuerySetBase(DeviceBase* device, ObjectBase::ErrorTag tag);
+
+        void DestroyInternal();
+
+      private:
+        virtual void DestroyImpl();
+
+        MaybeError ValidateDestroy() const;
+
+        wgpu::QueryType mQueryType = wgpu::QueryType::Occlusion;
+        uint32_t mQueryCount = 0;
+        std::vector<wgpu::PipelineStatisticName> mPipelineStatistics;
+        std::vector<bool> mQueryAvailability;
+
+        bool mIsDestroyed = false;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_QUERYSET_H_
@@ -14,23 +14,117 @@
 
 #include "dawn_native/Queue.h"
 
+#include "common/Constants.h"
+#include "common/Math.h"
 #include "dawn_native/Buffer.h"
 #include "dawn_native/CommandBuffer.h"
+#include "dawn_native/CommandValidation.h"
+#include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorScope.h"
 #include "dawn_native/ErrorScopeTracker.h"
 #include "dawn_native/Fence.h"
 #include "dawn_native/FenceSignalTracker.h"
+#include "dawn_native/QuerySet.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
+#include "dawn_native/RayTracingResidencyManager.h"
+#include "dawn_native/ResourceTable.h"
 #include "dawn_native/Texture.h"
+#include "dawn_native/ValidationUtils_autogen.h"
 #include "dawn_platform/DawnPlatform.h"
 #include "dawn_platform/tracing/TraceEvent.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 namespace dawn_native {
 
+    namespace {
+
+        // Queues of a type execute the commands of all the types with a lower capability.
+        uint32_t GetQueueTypeCapability(wgpu::QueueType queueType) {
+            switch (queueType) {
+                case wgpu::QueueType::Copy:
+                    return 0;
+                case wgpu::QueueType::Compute:
+                    return 1;
+                case wgpu::QueueType::Graphics:
+                    return 2;
+                default:
+                    UNREACHABLE();
+                    return 0;
+            }
+        }
+
+        // The size of |imageCount| images of |rowCount| rows, without the padding after the last
+        // row.
+        uint64_t ComputeTextureDataSize(uint32_t imageCount,
+                                        uint32_t rowCount,
+                                        uint32_t bytesPerRow,
+                                        uint64_t rowPitch,
+                                        uint64_t imagePitch) {
+            if (imageCount == 0 || rowCount == 0) {
+                return 0;
+            }
+            return (imageCount - 1) * imagePitch + (rowCount - 1) * rowPitch + bytesPerRow;
+        }
+
+        // Copies the rows of |bytesPerRow| bytes from |src| to |dst|, which each have their own
+        // row and image pitches, so that the data is repacked in the same pass that copies it.
+        // Ranges with the same layout on both sides are copied with a single memcpy.
+        void CopyTextureData(uint8_t* dst,
+                             const uint8_t* src,
+                             uint32_t imageCount,
+                             uint32_t rowCount,
+                             uint32_t bytesPerRow,
+                             uint64_t dstRowPitch,
+                             uint64_t dstImagePitch,
+                             uint64_t srcRowPitch,
+                             uint64_t srcImagePitch) {
+            if (dstRowPitch == srcRowPitch && dstImagePitch == srcImagePitch) {
+                memcpy(dst, src,
+                       ComputeTextureDataSize(imageCount, rowCount, bytesPerRow, dstRowPitch,
+                                              dstImagePitch));
+                return;
+            }
+
+            for (uint32_t image = 0; image < imageCount; ++image) {
+                uint8_t* dstImage = dst + image * dstImagePitch;
+                const uint8_t* srcImage = src + image * srcImagePitch;
+                if (dstRowPitch == srcRowPitch) {
+                    memcpy(dstImage, srcImage,
+                           ComputeTextureDataSize(1, rowCount, bytesPerRow, dstRowPitch, 0));
+                    continue;
+                }
+                for (uint32_t row = 0; row < rowCount; ++row) {
+                    memcpy(dstImage + row * dstRowPitch, srcImage + row * srcRowPitch,
+                           bytesPerRow);
+                }
+            }
+        }
+
+    }  // anonymous namespace
+
+    MaybeError ValidateQueueDescriptor(const QueueDescriptor* descriptor) {
+        if (descriptor->nextInChain != nullptr) {
+            return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+        }
+
+        DAWN_TRY(ValidateQueueType(descriptor->type));
+
+        return {};
+    }
+
+    bool QueueTypeSupports(wgpu::QueueType queueType, wgpu::QueueType requiredType) {
+        return GetQueueTypeCapability(queueType) >= GetQueueTypeCapability(requiredType);
+    }
+
     // QueueBase
 
-    QueueBase::QueueBase(DeviceBase* device) : ObjectBase(device) {
+    QueueBase::QueueBase(DeviceBase* device, const QueueDescriptor* descriptor)
+        : ObjectBase(device), mType(descriptor->type) {
     }
 
     QueueBase::QueueBase(DeviceBase* device, ObjectBase::ErrorTag tag) : ObjectBase(device, tag) {
@@ -41,6 +135,10 @@ namespace dawn_native {
         return new QueueBase(device, ObjectBase::kError);
     }
 
+    wgpu::QueueType QueueBase::GetType() const {
+        return mType;
+    }
+
     MaybeError QueueBase::SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) {
         UNREACHABLE();
         return {};
@@ -60,11 +158,44 @@ namespace dawn_native {
         }
         ASSERT(!IsError());
 
+        // The uniforms the commands were recorded with are uploaded before they execute.
+        device->FlushTransientUniformAllocators(this);
+
+        // the containers used by this submit can't be evicted until it completes
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            device->GetRayTracingResidencyManager()->TrackUsage(commands[i]->GetResourceUsages(),
+                                                               device->GetPendingCommandSerial());
+        }
+
         if (device->ConsumedError(SubmitImpl(commandCount, commands))) {
             return;
         }
+
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            commands[i]->TraceStatistics();
+        }
+
+        // The queries written by the submitted commands can now be resolved by later ones.
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            const CommandBufferResourceUsage& usages = commands[i]->GetResourceUsages();
+            for (const PassResourceUsage& passUsages : usages.perPass) {
+                for (size_t j = 0; j < passUsages.querySets.size(); ++j) {
+                    passUsages.querySets[j]->SetQueriesAvailable(passUsages.writtenQueries[j]);
+                }
+            }
+            for (const auto& it : usages.topLevelWrittenQueries) {
+                it.first->SetQueriesAvailable(it.second);
+            }
+        }
+
+        // The lifetime of transient resources ends with the command buffer using them.
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            DestroyTransientResources(commands[i]->GetResourceUsages());
+        }
+
         device->GetErrorScopeTracker()->TrackUntilLastSubmitComplete(
             device->GetCurrentErrorScope());
+        device->RequestCompletionTick();
     }
 
     void QueueBase::Signal(Fence* fence, uint64_t signalValue) {
@@ -74,10 +205,104 @@ namespace dawn_native {
         }
         ASSERT(!IsError());
 
+        // The fence can't complete before the commands submitted so far reach the GPU.
+        if (device->ConsumedError(FlushImpl())) {
+            return;
+        }
+
         fence->SetSignaledValue(signalValue);
         device->GetFenceSignalTracker()->UpdateFenceOnComplete(fence, signalValue);
         device->GetErrorScopeTracker()->TrackUntilLastSubmitComplete(
             device->GetCurrentErrorScope());
+        device->RequestCompletionTick();
+    }
+
+    void QueueBase::Wait(Fence* fence, uint64_t waitValue) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(ValidateWait(fence, waitValue))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        device->ConsumedError(WaitImpl(fence, waitValue));
+    }
+
+    MaybeError QueueBase::WaitImpl(Fence* fence, uint64_t waitValue) {
+        return {};
+    }
+
+    void QueueBase::UpdateBufferTileMappings(BufferBase* buffer,
+                                             uint64_t offset,
+                                             uint64_t size,
+                                             bool resident) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(ValidateUpdateBufferTileMappings(buffer, offset, size))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        if (size == 0) {
+            return;
+        }
+        device->ConsumedError(UpdateBufferTileMappingsImpl(buffer, offset / kSparseTileSize,
+                                                           size / kSparseTileSize, resident));
+    }
+
+    MaybeError QueueBase::UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                       uint64_t firstTile,
+                                                       uint64_t tileCount,
+                                                       bool resident) {
+        UNREACHABLE();
+        return {};
+    }
+
+    void QueueBase::UpdateTextureTileMappings(TextureBase* texture,
+                                              uint32_t mipLevel,
+                                              uint32_t arrayLayer,
+                                              const Origin3D* origin,
+                                              const Extent3D* size,
+                                              bool resident) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(
+                ValidateUpdateTextureTileMappings(texture, mipLevel, arrayLayer, origin, size))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        if (size->width == 0 || size->height == 0) {
+            return;
+        }
+
+        Extent3D tileExtent = GetSparseTileExtent(texture->GetFormat());
+        Origin3D firstTile = {origin->x / tileExtent.width, origin->y / tileExtent.height, 0};
+        Extent3D tileCount = {size->width / tileExtent.width, size->height / tileExtent.height, 1};
+        device->ConsumedError(UpdateTextureTileMappingsImpl(texture, mipLevel, arrayLayer,
+                                                            firstTile, tileCount, resident));
+    }
+
+    MaybeError QueueBase::UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                        uint32_t mipLevel,
+                                                        uint32_t arrayLayer,
+                                                        const Origin3D& firstTile,
+                                                        const Extent3D& tileCount,
+                                                        bool resident) {
+        UNREACHABLE();
+        return {};
+    }
+
+    void QueueBase::Flush() {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(device->ValidateIsAlive()) ||
+            device->ConsumedError(device->ValidateObject(this))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        device->ConsumedError(FlushImpl());
+    }
+
+    MaybeError QueueBase::FlushImpl() {
+        return {};
     }
 
     Fence* QueueBase::CreateFence(const FenceDescriptor* descriptor) {
@@ -88,6 +313,99 @@ namespace dawn_native {
         return new Fence(this, descriptor);
     }
 
+    void QueueBase::WriteBuffer(BufferBase* buffer,
+                                uint64_t bufferOffset,
+                                const void* data,
+                                uint64_t size) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(ValidateWriteBuffer(buffer, bufferOffset, size))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        if (size == 0) {
+            return;
+        }
+        device->ConsumedError(WriteBufferImpl(buffer, bufferOffset, data, size));
+    }
+
+    MaybeError QueueBase::WriteBufferImpl(BufferBase* buffer,
+                                          uint64_t bufferOffset,
+                                          const void* data,
+                                          uint64_t size) {
+        return buffer->SetSubDataInternal(static_cast<uint32_t>(bufferOffset),
+                                          static_cast<uint32_t>(size), data);
+    }
+
+    void QueueBase::WriteTexture(const TextureCopyView* destination,
+                                 const void* data,
+                                 uint64_t dataSize,
+                                 const TextureDataLayout* dataLayout,
+                                 const Extent3D* writeSize) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(
+                ValidateWriteTexture(destination, dataSize, dataLayout, writeSize))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        if (writeSize->width == 0 || writeSize->height == 0 || writeSize->depth == 0) {
+            return;
+        }
+
+        const Format& format = destination->texture->GetFormat();
+        TextureDataLayout layout = *dataLayout;
+        if (layout.rowPitch == 0) {
+            layout.rowPitch = writeSize->width / format.blockWidth * format.blockByteSize;
+        }
+        if (layout.imageHeight == 0) {
+            layout.imageHeight = writeSize->height;
+        }
+        device->ConsumedError(WriteTextureImpl(*destination, data, layout, *writeSize));
+    }
+
+    MaybeError QueueBase::WriteTextureImpl(const TextureCopyView& destination,
+                                           const void* data,
+                                           const TextureDataLayout& dataLayout,
+                                           const Extent3D& writeSize) {
+        DeviceBase* device = GetDevice();
+        const Format& format = destination.texture->GetFormat();
+        uint32_t bytesPerRow = writeSize.width / format.blockWidth * format.blockByteSize;
+        uint32_t rowCount = writeSize.height / format.blockHeight;
+
+        uint32_t stagingRowPitch = Align(bytesPerRow, kTextureRowPitchAlignment);
+        uint64_t stagingImagePitch = uint64_t(stagingRowPitch) * rowCount;
+        uint64_t stagingSize = ComputeTextureDataSize(writeSize.depth, rowCount, bytesPerRow,
+                                                      stagingRowPitch, stagingImagePitch);
+
+        // Vulkan needs the offset of buffer to image copies to be a multiple of 4 and of the
+        // block size, but the ring buffers don't align their allocations.
+        uint64_t offsetAlignment = std::max(4u, format.blockByteSize);
+        UploadHandle uploadHandle;
+        DAWN_TRY_ASSIGN(uploadHandle, device->GetDynamicUploader()->Allocate(
+                                          stagingSize + offsetAlignment - 1,
+                                          device->GetPendingCommandSerial()));
+        ASSERT(uploadHandle.mappedBuffer != nullptr);
+        uint64_t stagingOffset = (uploadHandle.startOffset + offsetAlignment - 1) /
+                                 offsetAlignment * offsetAlignment;
+
+        uint64_t imagePitch =
+            uint64_t(dataLayout.rowPitch) * (dataLayout.imageHeight / format.blockHeight);
+        CopyTextureData(uploadHandle.mappedBuffer + (stagingOffset - uploadHandle.startOffset),
+                        static_cast<const uint8_t*>(data) + dataLayout.offset, writeSize.depth,
+                        rowCount, bytesPerRow, stagingRowPitch, stagingImagePitch,
+                        dataLayout.rowPitch, imagePitch);
+
+        TextureCopy textureCopy;
+        textureCopy.texture = destination.texture;
+        textureCopy.mipLevel = destination.mipLevel;
+        textureCopy.arrayLayer = destination.arrayLayer;
+        textureCopy.origin = destination.origin;
+        return device->CopyFromStagingToTexture(uploadHandle.stagingBuffer, stagingOffset,
+                                                stagingRowPitch, writeSize.height, textureCopy,
+                                                writeSize);
+    }
+
     MaybeError QueueBase::ValidateSubmit(uint32_t commandCount,
                                          CommandBufferBase* const* commands) {
         TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "Queue::ValidateSubmit");
@@ -98,6 +416,11 @@ namespace dawn_native {
 
             const CommandBufferResourceUsage& usages = commands[i]->GetResourceUsages();
 
+            if (!QueueTypeSupports(mType, usages.requiredQueueType)) {
+                return DAWN_VALIDATION_ERROR(
+                    "Command buffer has commands the type of the queue can't execute");
+            }
+
             for (const PassResourceUsage& passUsages : usages.perPass) {
                 for (const BufferBase* buffer : passUsages.buffers) {
                     DAWN_TRY(buffer->ValidateCanUseInSubmitNow());
@@ -106,7 +429,20 @@ namespace dawn_native {
                     DAWN_TRY(texture->ValidateCanUseInSubmitNow());
                 }
                 for (const RayTracingAccelerationContainerBase* container : passUsages.accelerationContainers) {
-                    DAWN_TRY(container->ValidateCanUseInSubmitNow());
+                    DAWN_TRY(
+                        container->ValidateCanUseInSubmitNow(usages.builtAccelerationContainers));
+                }
+                for (const QuerySetBase* querySet : passUsages.querySets) {
+                    DAWN_TRY(querySet->ValidateCanUseInSubmitNow());
+                }
+                // The resources of the tables were tracked when they were set, and the backends
+                // may have recorded their descriptors, so the tables can't change until submit.
+                for (size_t j = 0; j < passUsages.resourceTables.size(); ++j) {
+                    if (passUsages.resourceTables[j]->GetGeneration() !=
+                        passUsages.resourceTableGenerations[j]) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Resource table modified after being set in the command buffer");
+                    }
                 }
             }
 
@@ -118,13 +454,41 @@ namespace dawn_native {
             }
             for (const RayTracingAccelerationContainerBase* container :
                  usages.topLevelAccelerationContainers) {
-                DAWN_TRY(container->ValidateCanUseInSubmitNow());
+                DAWN_TRY(container->ValidateCanUseInSubmitNow(usages.builtAccelerationContainers));
+            }
+            for (const auto& it : usages.topLevelWrittenQueries) {
+                DAWN_TRY(it.first->ValidateCanUseInSubmitNow());
             }
         }
 
         return {};
     }
 
+    void QueueBase::DestroyTransientResources(const CommandBufferResourceUsage& usages) {
+        for (const PassResourceUsage& passUsages : usages.perPass) {
+            for (BufferBase* buffer : passUsages.buffers) {
+                if (buffer->IsTransient()) {
+                    buffer->Destroy();
+                }
+            }
+            for (TextureBase* texture : passUsages.textures) {
+                if (texture->IsTransient()) {
+                    texture->Destroy();
+                }
+            }
+        }
+        for (BufferBase* buffer : usages.topLevelBuffers) {
+            if (buffer->IsTransient()) {
+                buffer->Destroy();
+            }
+        }
+        for (TextureBase* texture : usages.topLevelTextures) {
+            if (texture->IsTransient()) {
+                texture->Destroy();
+            }
+        }
+    }
+
     MaybeError QueueBase::ValidateSignal(const Fence* fence, uint64_t signalValue) {
         DAWN_TRY(GetDevice()->ValidateIsAlive());
         DAWN_TRY(GetDevice()->ValidateObject(this));
@@ -140,6 +504,162 @@ namespace dawn_native {
         return {};
     }
 
+    MaybeError QueueBase::ValidateWait(const Fence* fence, uint64_t waitValue) {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(GetDevice()->ValidateObject(fence));
+
+        // The fence may be signaled on any queue of the device, but the signal must already be
+        // enqueued so that waits can't deadlock the queues.
+        if (waitValue > fence->GetSignaledValue()) {
+            return DAWN_VALIDATION_ERROR("Wait value greater than fence signaled value");
+        }
+        return {};
+    }
+
+    MaybeError QueueBase::ValidateWriteBuffer(const BufferBase* buffer,
+                                              uint64_t bufferOffset,
+                                              uint64_t size) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(GetDevice()->ValidateObject(buffer));
+
+        if (!(buffer->GetUsage() & wgpu::BufferUsage::CopyDst)) {
+            return DAWN_VALIDATION_ERROR("Buffer needs the CopyDst usage bit");
+        }
+
+        // Same alignment constraints as the buffer to buffer copies the writes turn into.
+        if (bufferOffset % 4 != 0) {
+            return DAWN_VALIDATION_ERROR("Buffer offset must be a multiple of 4 bytes");
+        }
+        if (size % 4 != 0) {
+            return DAWN_VALIDATION_ERROR("Write size must be a multiple of 4 bytes");
+        }
+
+        uint64_t bufferSize = buffer->GetSize();
+        if (size > bufferSize || bufferOffset > bufferSize - size) {
+            return DAWN_VALIDATION_ERROR("Write out of bounds of the buffer");
+        }
+
+        // Writes are implemented with the 32-bit offsets of Buffer::SetSubData.
+        if (bufferOffset + size > std::numeric_limits<uint32_t>::max()) {
+            return DAWN_VALIDATION_ERROR("Writes must end within the first 4GB of the buffer");
+        }
+
+        return buffer->ValidateCanUseInSubmitNow();
+    }
+
+    MaybeError QueueBase::ValidateWriteTexture(const TextureCopyView* destination,
+                                               uint64_t dataSize,
+                                               const TextureDataLayout* dataLayout,
+                                               const Extent3D* writeSize) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(GetDevice()->ValidateObject(destination->texture));
+
+        if (destination->nextInChain != nullptr || dataLayout->nextInChain != nullptr) {
+            return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+        }
+
+        TextureBase* texture = destination->texture;
+        if (!(texture->GetUsage() & wgpu::TextureUsage::CopyDst)) {
+            return DAWN_VALIDATION_ERROR("Texture needs the CopyDst usage bit");
+        }
+
+        const Format& format = texture->GetFormat();
+        DAWN_TRY(ValidateTextureSampleCountInCopyCommands(texture));
+        DAWN_TRY(ValidateImageOrigin(format, destination->origin));
+        DAWN_TRY(ValidateImageCopySize(format, *writeSize));
+
+        TextureCopy textureCopy;
+        textureCopy.texture = texture;
+        textureCopy.mipLevel = destination->mipLevel;
+        textureCopy.arrayLayer = destination->arrayLayer;
+        textureCopy.origin = destination->origin;
+        DAWN_TRY(ValidateCopySizeFitsInTexture(textureCopy, *writeSize));
+
+        // Unlike buffer to texture copies, any row pitch is valid since the rows are repacked
+        // when they are written to the staging memory.
+        uint32_t bytesPerRow = writeSize->width / format.blockWidth * format.blockByteSize;
+        uint32_t rowPitch = dataLayout->rowPitch != 0 ? dataLayout->rowPitch : bytesPerRow;
+        if (rowPitch < bytesPerRow) {
+            return DAWN_VALIDATION_ERROR(
+                "Row pitch must not be less than the number of bytes per row");
+        }
+
+        uint32_t imageHeight =
+            dataLayout->imageHeight != 0 ? dataLayout->imageHeight : writeSize->height;
+        DAWN_TRY(ValidateImageHeight(format, imageHeight, writeSize->height));
+
+        uint64_t requiredSize = ComputeTextureDataSize(
+            writeSize->depth, writeSize->height / format.blockHeight, bytesPerRow, rowPitch,
+            uint64_t(rowPitch) * (imageHeight / format.blockHeight));
+        if (dataLayout->offset > dataSize || requiredSize > dataSize - dataLayout->offset) {
+            return DAWN_VALIDATION_ERROR("Write would read outside of the data");
+        }
+
+        return texture->ValidateCanUseInSubmitNow();
+    }
+
+    MaybeError QueueBase::ValidateUpdateBufferTileMappings(const BufferBase* buffer,
+                                                           uint64_t offset,
+                                                           uint64_t size) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(GetDevice()->ValidateObject(buffer));
+
+        if (!buffer->IsSparse()) {
+            return DAWN_VALIDATION_ERROR("Buffer needs the Sparse usage bit");
+        }
+
+        if (offset % kSparseTileSize != 0 || size % kSparseTileSize != 0) {
+            return DAWN_VALIDATION_ERROR("The range must be a multiple of the sparse tile size");
+        }
+
+        uint64_t bufferSize = buffer->GetSize();
+        if (size > bufferSize || offset > bufferSize - size) {
+            return DAWN_VALIDATION_ERROR("The range is out of bounds of the buffer");
+        }
+
+        return buffer->ValidateCanUseInSubmitNow();
+    }
+
+    MaybeError QueueBase::ValidateUpdateTextureTileMappings(const TextureBase* texture,
+                                                            uint32_t mipLevel,
+                                                            uint32_t arrayLayer,
+                                                            const Origin3D* origin,
+                                                            const Extent3D* size) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(GetDevice()->ValidateObject(texture));
+
+        if (!texture->IsSparse()) {
+            return DAWN_VALIDATION_ERROR("Texture needs the Sparse usage bit");
+        }
+
+        if (mipLevel >= texture->GetNumMipLevels() || arrayLayer >= texture->GetArrayLayers()) {
+            return DAWN_VALIDATION_ERROR("The subresource is out of bounds of the texture");
+        }
+
+        if (origin->z != 0 || size->depth != 1) {
+            return DAWN_VALIDATION_ERROR("The region must be in a single array layer");
+        }
+
+        Extent3D tileExtent = GetSparseTileExtent(texture->GetFormat());
+        if (origin->x % tileExtent.width != 0 || origin->y % tileExtent.height != 0 ||
+            size->width % tileExtent.width != 0 || size->height % tileExtent.height != 0) {
+            return DAWN_VALIDATION_ERROR("The region must be a multiple of the sparse tile size");
+        }
+
+        Extent3D levelSize = texture->GetMipLevelVirtualSize(mipLevel);
+        if (size->width > levelSize.width || origin->x > levelSize.width - size->width ||
+            size->height > levelSize.height || origin->y > levelSize.height - size->height) {
+            return DAWN_VALIDATION_ERROR("The region is out of bounds of the mip level");
+        }
+
+        return texture->ValidateCanUseInSubmitNow();
+    }
+
     MaybeError QueueBase::ValidateCreateFence(const FenceDescriptor* descriptor) {
         DAWN_TRY(GetDevice()->ValidateIsAlive());
         DAWN_TRY(GetDevice()->ValidateObject(this));
@@ -23,25 +23,110 @@
 
 namespace dawn_native {
 
+    struct CommandBufferResourceUsage;
+
+    MaybeError ValidateQueueDescriptor(const QueueDescriptor* descriptor);
+
+    // Whether queues of |queueType| can execute the commands that need a queue of |requiredType|.
+    // Graphics queues execute all the commands, compute queues all of them but render passes and
+    // copy queues only the copies.
+    bool QueueTypeSupports(wgpu::QueueType queueType, wgpu::QueueType requiredType);
+
     class QueueBase : public ObjectBase {
       public:
-        QueueBase(DeviceBase* device);
+        QueueBase(DeviceBase* device, const QueueDescriptor* descriptor);
 
         static QueueBase* MakeError(DeviceBase* device);
 
+        wgpu::QueueType GetType() const;
+
         // Dawn API
         void Submit(uint32_t commandCount, CommandBufferBase* const* commands);
         void Signal(Fence* fence, uint64_t signalValue);
+        void Wait(Fence* fence, uint64_t waitValue);
         Fence* CreateFence(const FenceDescriptor* descriptor);
+        void WriteBuffer(BufferBase* buffer, uint64_t bufferOffset, const void* data, uint64_t size);
+        void WriteTexture(const TextureCopyView* destination,
+                          const void* data,
+                          uint64_t dataSize,
+                          const TextureDataLayout* dataLayout,
+                          const Extent3D* writeSize);
+        void UpdateBufferTileMappings(BufferBase* buffer,
+                                      uint64_t offset,
+                                      uint64_t size,
+                                      bool resident);
+        void UpdateTextureTileMappings(TextureBase* texture,
+                                       uint32_t mipLevel,
+                                       uint32_t arrayLayer,
+                                       const Origin3D* origin,
+                                       const Extent3D* size,
+                                       bool resident);
+        void Flush();
+
+      protected:
+        // The default implementation is the one of Buffer::SetSubData. On backends using the
+        // DynamicUploader, all the writes made between two submits share its ring buffers and
+        // their copies are recorded in the pending commands, which the next submit flushes.
+        virtual MaybeError WriteBufferImpl(BufferBase* buffer,
+                                           uint64_t bufferOffset,
+                                           const void* data,
+                                           uint64_t size);
+        // The default implementation repacks the rows of the data to the row pitch alignment of
+        // buffer to texture copies while it writes them to the DynamicUploader, and records the
+        // copy with DeviceBase::CopyFromStagingToTexture. The defaults of |dataLayout| are
+        // already resolved.
+        virtual MaybeError WriteTextureImpl(const TextureCopyView& destination,
+                                            const void* data,
+                                            const TextureDataLayout& dataLayout,
+                                            const Extent3D& writeSize);
 
       private:
         QueueBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         virtual MaybeError SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands);
+        // Submits the commands which the backend recorded but didn't submit to the GPU yet.
+        virtual MaybeError FlushImpl();
+        // Makes the commands submitted after the wait execute after the fence reaches the value.
+        // The default implementation does nothing because all the queues of a device share the
+        // same hardware queue, which executes the submits in order.
+        virtual MaybeError WaitImpl(Fence* fence, uint64_t waitValue);
+        // Binds memory to the tiles of sparse resources, or releases it, in the queue order: the
+        // commands submitted before see the previous mappings and the ones submitted after the new
+        // ones. The ranges are in tiles and the mappings of the other tiles are kept.
+        virtual MaybeError UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                        uint64_t firstTile,
+                                                        uint64_t tileCount,
+                                                        bool resident);
+        virtual MaybeError UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                         uint32_t mipLevel,
+                                                         uint32_t arrayLayer,
+                                                         const Origin3D& firstTile,
+                                                         const Extent3D& tileCount,
+                                                         bool resident);
 
         MaybeError ValidateSubmit(uint32_t commandCount, CommandBufferBase* const* commands);
+        MaybeError ValidateWriteBuffer(const BufferBase* buffer,
+                                       uint64_t bufferOffset,
+                                       uint64_t size) const;
+        MaybeError ValidateWriteTexture(const TextureCopyView* destination,
+                                        uint64_t dataSize,
+                                        const TextureDataLayout* dataLayout,
+                                        const Extent3D* writeSize) const;
         MaybeError ValidateSignal(const Fence* fence, uint64_t signalValue);
+        MaybeError ValidateWait(const Fence* fence, uint64_t waitValue);
+        MaybeError ValidateUpdateBufferTileMappings(const BufferBase* buffer,
+                                                    uint64_t offset,
+                                                    uint64_t size) const;
+        MaybeError ValidateUpdateTextureTileMappings(const TextureBase* texture,
+                                                     uint32_t mipLevel,
+                                                     uint32_t arrayLayer,
+                                                     const Origin3D* origin,
+                                                     const Extent3D* size) const;
         MaybeError ValidateCreateFence(const FenceDescriptor* descriptor);
+
+        void DestroyTransientResources(const CommandBufferResourceUsage& usages);
+
+        wgpu::QueueType mType = wgpu::QueueType::Graphics;
     };
 
 }  // namespace dawn_native
@@ -17,15 +17,69 @@
 #include "common/Assert.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/RayTracingResidencyManager.h"
+#include "dawn_native/RenderPipeline.h"
+#include "dawn_native/ValidationUtils_autogen.h"
 
 #include "dawn_native/Buffer.h"
 
+#include <algorithm>
+
 namespace dawn_native {
 
     // RayTracingAccelerationContainer
 
     namespace {
 
+        // Geometry data is either staged, or written by shaders before the build. Both get
+        // synchronized with the build by the backends.
+        constexpr wgpu::BufferUsage kAccelerationGeometryBufferUsages =
+            wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage;
+
+        // The vertex formats of VK_NV_ray_tracing and DXR. The four component formats are built
+        // from their first three components.
+        MaybeError ValidateAccelerationGeometryVertexFormat(wgpu::VertexFormat format) {
+            switch (format) {
+                case wgpu::VertexFormat::Float2:
+                case wgpu::VertexFormat::Float3:
+                case wgpu::VertexFormat::Half2:
+                case wgpu::VertexFormat::Half4:
+                case wgpu::VertexFormat::Short2Norm:
+                case wgpu::VertexFormat::Short4Norm:
+                    return {};
+                default:
+                    return DAWN_VALIDATION_ERROR(
+                        "Vertex format not supported for acceleration geometry");
+            }
+        }
+
+        MaybeError ValidateAccelerationGeometryVertex(
+            const RayTracingAccelerationGeometryVertexDescriptor* vertex) {
+            DAWN_TRY(ValidateAccelerationGeometryVertexFormat(vertex->format));
+
+            // The offset and the stride must be aligned to the components of the format.
+            uint64_t componentSize = VertexFormatComponentSize(vertex->format);
+            if (vertex->offset % componentSize != 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "Vertex offset must be a multiple of the component size of the format");
+            }
+            if (vertex->stride % componentSize != 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "Vertex stride must be a multiple of the component size of the format");
+            }
+            uint64_t formatSize = VertexFormatSize(vertex->format);
+            if (vertex->stride < formatSize) {
+                return DAWN_VALIDATION_ERROR("Vertex stride must be at least the format size");
+            }
+
+            uint64_t bufferSize = vertex->buffer->GetSize();
+            uint64_t requiredSize = uint64_t(vertex->stride) * (vertex->count - 1) + formatSize;
+            if (vertex->offset > bufferSize || bufferSize - vertex->offset < requiredSize) {
+                return DAWN_VALIDATION_ERROR("Vertex data is out of bounds");
+            }
+            return {};
+        }
+
         template <typename T, typename E>
         bool VectorReferenceAlreadyExists(std::vector<Ref<T>> const& vec, E* el) {
             for (auto const& element : vec) {
@@ -49,6 +103,33 @@ namespace dawn_native {
             uint64_t GetHandleImpl() override {
                 UNREACHABLE();
             }
+            MaybeError UpdateInstancesImpl(
+                uint32_t firstInstance,
+                uint32_t instanceCount,
+                const RayTracingAccelerationInstanceDescriptor* instances) override {
+                UNREACHABLE();
+                return {};
+            }
+            MaybeError UpdateInstancePropertiesImpl(
+                uint32_t firstInstance,
+                uint32_t instanceCount,
+                const RayTracingAccelerationInstanceProperties* properties) override {
+                UNREACHABLE();
+                return {};
+            }
+            ResultOrError<RayTracingAccelerationContainerBase*> CreateSubsetImpl(
+                const RayTracingAccelerationContainerSubsetDescriptor* descriptor,
+                const std::vector<uint32_t>& instanceIndices) override {
+                UNREACHABLE();
+                return nullptr;
+            }
+            void EvictImpl() override {
+                UNREACHABLE();
+            }
+            MaybeError MakeResidentImpl() override {
+                UNREACHABLE();
+                return {};
+            }
         };
 
     }  // anonymous namespace
@@ -61,6 +142,22 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR(
                 "Invalid Acceleration Container Level. Must be Top or Bottom");
         }
+        if ((descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::BuildOnce) &&
+            (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::AllowUpdate)) {
+            return DAWN_VALIDATION_ERROR(
+                "Acceleration Containers which are built once can't allow updates");
+        }
+        if (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::Evictable) {
+            if (descriptor->level != wgpu::RayTracingAccelerationContainerLevel::Bottom) {
+                return DAWN_VALIDATION_ERROR(
+                    "Only Bottom-Level Acceleration Containers can be evictable");
+            }
+            if (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::BuildOnce) {
+                return DAWN_VALIDATION_ERROR(
+                    "Acceleration Containers which are built once can't be evictable, their "
+                    "build resources are released after the build");
+            }
+        }
         if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Top) {
             if (descriptor->geometryCount > 0) {
                 return DAWN_VALIDATION_ERROR(
@@ -70,12 +167,39 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR(
                     "No data provided for Top-Level Acceleration Container");
             }
-            if (descriptor->instanceCount != 0 && descriptor->instanceBuffer != nullptr) {
+            if (descriptor->instances != nullptr && descriptor->instanceBuffer != nullptr) {
                 return DAWN_VALIDATION_ERROR(
                     "Only instances or instanceBuffer is valid to use in Top-Level Acceleration "
                     "Container");
             }
-            for (unsigned int ii = 0; ii < descriptor->instanceCount; ++ii) {
+            if (descriptor->instances == nullptr && descriptor->instanceBuffer == nullptr) {
+                return DAWN_VALIDATION_ERROR("No instances provided");
+            }
+            if (descriptor->instanceBuffer != nullptr) {
+                DAWN_TRY(device->ValidateObject(descriptor->instanceBuffer));
+                if ((descriptor->instanceBuffer->GetUsage() & wgpu::BufferUsage::RayTracing) ==
+                    0) {
+                    return DAWN_VALIDATION_ERROR("Instance buffer requires the RayTracing usage");
+                }
+                if (descriptor->instanceBufferOffset % kAccelerationInstanceOffsetAlignment != 0) {
+                    return DAWN_VALIDATION_ERROR("Instance buffer offset must be a multiple of 16");
+                }
+                uint64_t bufferSize = descriptor->instanceBuffer->GetSize();
+                if (descriptor->instanceBufferOffset > bufferSize) {
+                    return DAWN_VALIDATION_ERROR("Instance buffer offset is out of bounds");
+                }
+                // an instance count of 0 uses all instances after the offset
+                uint64_t availableInstanceCount =
+                    (bufferSize - descriptor->instanceBufferOffset) / kAccelerationInstanceSize;
+                if (availableInstanceCount == 0) {
+                    return DAWN_VALIDATION_ERROR("Instance buffer holds no instances");
+                }
+                if (descriptor->instanceCount > availableInstanceCount) {
+                    return DAWN_VALIDATION_ERROR("Instance count exceeds the instance buffer");
+                }
+            }
+            for (unsigned int ii = 0;
+                 descriptor->instances != nullptr && ii < descriptor->instanceCount; ++ii) {
                 const RayTracingAccelerationInstanceDescriptor& instance =
                     descriptor->instances[ii];
                 if (instance.geometryContainer == nullptr) {
@@ -110,8 +234,10 @@ namespace dawn_native {
                 }
                 // validate vertex input
                 if (geometry.vertex != nullptr) {
-                    if ((geometry.vertex->buffer->GetUsage() & wgpu::BufferUsage::CopyDst) == 0) {
-                        return DAWN_VALIDATION_ERROR("Vertex data must be staged");
+                    if ((geometry.vertex->buffer->GetUsage() & kAccelerationGeometryBufferUsages) ==
+                        0) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Vertex data must be staged or written by shaders");
                     }
                     if (geometry.vertex->buffer->GetSize() == 0) {
                         return DAWN_VALIDATION_ERROR("Invalid Buffer for Vertex data");
@@ -119,6 +245,7 @@ namespace dawn_native {
                     if (geometry.vertex->count == 0) {
                         return DAWN_VALIDATION_ERROR("Vertex count must not be zero");
                     }
+                    DAWN_TRY(ValidateAccelerationGeometryVertex(geometry.vertex));
                 }
                 // validate index input
                 if (geometry.index != nullptr) {
@@ -128,8 +255,10 @@ namespace dawn_native {
                     if (geometry.index->buffer->GetSize() == 0) {
                         return DAWN_VALIDATION_ERROR("Invalid Buffer for Index data");
                     }
-                    if ((geometry.index->buffer->GetUsage() & wgpu::BufferUsage::CopyDst) == 0) {
-                        return DAWN_VALIDATION_ERROR("Index data must be staged");
+                    if ((geometry.index->buffer->GetUsage() & kAccelerationGeometryBufferUsages) ==
+                        0) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Index data must be staged or written by shaders");
                     }
                     if (geometry.index->count == 0) {
                         return DAWN_VALIDATION_ERROR("Index count must not be zero");
@@ -148,13 +277,38 @@ namespace dawn_native {
                     if (geometry.aabb->buffer->GetSize() == 0) {
                         return DAWN_VALIDATION_ERROR("Invalid Buffer for AABB data");
                     }
-                    if ((geometry.aabb->buffer->GetUsage() & wgpu::BufferUsage::CopyDst) == 0) {
-                        return DAWN_VALIDATION_ERROR("AABB data must be staged");
+                    if ((geometry.aabb->buffer->GetUsage() & kAccelerationGeometryBufferUsages) ==
+                        0) {
+                        return DAWN_VALIDATION_ERROR(
+                            "AABB data must be staged or written by shaders");
                     }
                     if (geometry.aabb->count == 0) {
                         return DAWN_VALIDATION_ERROR("AABB count must not be zero");
                     }
                 }
+                // validate transform input
+                if (geometry.transform != nullptr) {
+                    if (geometry.type != wgpu::RayTracingAccelerationGeometryType::Triangles) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Transform data is only allowed for Triangle geometry");
+                    }
+                    DAWN_TRY(device->ValidateObject(geometry.transform->buffer));
+                    if ((geometry.transform->buffer->GetUsage() &
+                         kAccelerationGeometryBufferUsages) == 0) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Transform data must be staged or written by shaders");
+                    }
+                    if (geometry.transform->offset % kAccelerationGeometryTransformOffsetAlignment !=
+                        0) {
+                        return DAWN_VALIDATION_ERROR("Transform offset must be a multiple of 16");
+                    }
+                    uint64_t bufferSize = geometry.transform->buffer->GetSize();
+                    if (geometry.transform->offset > bufferSize ||
+                        bufferSize - geometry.transform->offset <
+                            kAccelerationGeometryTransformSize) {
+                        return DAWN_VALIDATION_ERROR("Transform data is out of bounds");
+                    }
+                }
                 if (geometry.vertex == nullptr && geometry.index == nullptr &&
                     geometry.aabb == nullptr) {
                     return DAWN_VALIDATION_ERROR("No geometry data provided");
@@ -164,12 +318,95 @@ namespace dawn_native {
         return {};
     }
 
+    // RayTracingAccelerationContainerDescriptorStorage
+
+    RayTracingAccelerationContainerDescriptorStorage::
+        RayTracingAccelerationContainerDescriptorStorage(
+            const RayTracingAccelerationContainerDescriptor* descriptor)
+        : mDescriptor(*descriptor) {
+        // the storage vectors are sized once so that the pointers into them stay valid
+        if (descriptor->geometries != nullptr) {
+            mGeometries.assign(descriptor->geometries,
+                               descriptor->geometries + descriptor->geometryCount);
+            mGeometryStorage.resize(descriptor->geometryCount);
+            for (unsigned int ii = 0; ii < descriptor->geometryCount; ++ii) {
+                RayTracingAccelerationGeometryDescriptor& geometry = mGeometries[ii];
+                GeometryStorage& storage = mGeometryStorage[ii];
+                if (geometry.vertex != nullptr) {
+                    storage.vertex = *geometry.vertex;
+                    geometry.vertex = &storage.vertex;
+                    mReferences.push_back(storage.vertex.buffer);
+                }
+                if (geometry.index != nullptr) {
+                    storage.index = *geometry.index;
+                    geometry.index = &storage.index;
+                    mReferences.push_back(storage.index.buffer);
+                }
+                if (geometry.aabb != nullptr) {
+                    storage.aabb = *geometry.aabb;
+                    geometry.aabb = &storage.aabb;
+                    mReferences.push_back(storage.aabb.buffer);
+                }
+                if (geometry.transform != nullptr) {
+                    storage.transform = *geometry.transform;
+                    geometry.transform = &storage.transform;
+                    mReferences.push_back(storage.transform.buffer);
+                }
+            }
+            mDescriptor.geometries = mGeometries.data();
+        }
+        if (descriptor->instances != nullptr) {
+            mInstances.assign(descriptor->instances,
+                              descriptor->instances + descriptor->instanceCount);
+            mInstanceStorage.resize(descriptor->instanceCount);
+            for (unsigned int ii = 0; ii < descriptor->instanceCount; ++ii) {
+                RayTracingAccelerationInstanceDescriptor& instance = mInstances[ii];
+                InstanceStorage& storage = mInstanceStorage[ii];
+                if (instance.transform != nullptr) {
+                    storage.transform = *instance.transform;
+                    if (storage.transform.translation != nullptr) {
+                        storage.translation = *storage.transform.translation;
+                        storage.transform.translation = &storage.translation;
+                    }
+                    if (storage.transform.rotation != nullptr) {
+                        storage.rotation = *storage.transform.rotation;
+                        storage.transform.rotation = &storage.rotation;
+                    }
+                    if (storage.transform.scale != nullptr) {
+                        storage.scale = *storage.transform.scale;
+                        storage.transform.scale = &storage.scale;
+                    }
+                    instance.transform = &storage.transform;
+                }
+                if (instance.transformMatrix != nullptr) {
+                    storage.transformMatrix.assign(
+                        instance.transformMatrix,
+                        instance.transformMatrix + instance.transformMatrixSize);
+                    instance.transformMatrix = storage.transformMatrix.data();
+                }
+                mReferences.push_back(instance.geometryContainer);
+            }
+            mDescriptor.instances = mInstances.data();
+        }
+        if (descriptor->instanceBuffer != nullptr) {
+            mReferences.push_back(descriptor->instanceBuffer);
+        }
+    }
+
+    const RayTracingAccelerationContainerDescriptor*
+    RayTracingAccelerationContainerDescriptorStorage::GetDescriptor() const {
+        return &mDescriptor;
+    }
+
+    // RayTracingAccelerationContainerBase
+
     RayTracingAccelerationContainerBase::RayTracingAccelerationContainerBase(
         DeviceBase* device,
         const RayTracingAccelerationContainerDescriptor* descriptor)
         : ObjectBase(device) {
         mFlags = descriptor->flags;
         mLevel = descriptor->level;
+        mUpdateRebuildThreshold = descriptor->updateRebuildThreshold;
         if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
             // save unique references to used vertex and index buffers
             for (unsigned int ii = 0; ii < descriptor->geometryCount; ++ii) {
@@ -188,6 +425,18 @@ namespace dawn_native {
                     !VectorReferenceAlreadyExists(mAABBBuffers, geometry.aabb->buffer)) {
                     mAABBBuffers.push_back(geometry.aabb->buffer);
                 }
+                if (geometry.transform != nullptr &&
+                    !VectorReferenceAlreadyExists(mTransformBuffers, geometry.transform->buffer)) {
+                    mTransformBuffers.push_back(geometry.transform->buffer);
+                }
+
+                if (geometry.type == wgpu::RayTracingAccelerationGeometryType::Aabbs) {
+                    mPrimitiveCount += geometry.aabb->count;
+                } else if (geometry.index != nullptr) {
+                    mPrimitiveCount += geometry.index->count / 3;
+                } else {
+                    mPrimitiveCount += geometry.vertex->count / 3;
+                }
             };
         }
         if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Top) {
@@ -195,17 +444,23 @@ namespace dawn_native {
             if (descriptor->instanceBuffer != nullptr) {
                 mInstanceBuffer = descriptor->instanceBuffer;
             }
+            mInstanceCount = descriptor->instanceCount;
+            mPrimitiveCount = descriptor->instanceCount;
+            if (descriptor->instances != nullptr) {
+                mInstanceInfos.resize(mInstanceCount);
+            }
             // save unique references to used geometry containers
-            for (unsigned int ii = 0; ii < descriptor->instanceCount; ++ii) {
+            for (unsigned int ii = 0;
+                 descriptor->instances != nullptr && ii < descriptor->instanceCount; ++ii) {
                 const RayTracingAccelerationInstanceDescriptor& instance =
                     descriptor->instances[ii];
-                RayTracingAccelerationContainerBase* container = instance.geometryContainer;
-
-                if (!VectorReferenceAlreadyExists(mGeometryContainers, container)) {
-                    mGeometryContainers.push_back(container);
-                }
+                SetInstanceInfo(ii, instance.geometryContainer, instance.mask);
             };
         }
+        if (mFlags & wgpu::RayTracingAccelerationContainerFlag::Evictable) {
+            device->GetRayTracingResidencyManager()->Track(this);
+        }
+        mTrackedMemory.Track(device, TrackedObjectType::AccelerationContainer, 0);
     }
 
     RayTracingAccelerationContainerBase::RayTracingAccelerationContainerBase(
@@ -220,21 +475,378 @@ namespace dawn_native {
         return new ErrorRayTracingAccelerationContainer(device);
     }
 
+    void RayTracingAccelerationContainerBase::AddGeometryContainer(
+        RayTracingAccelerationContainerBase* container) {
+        // thousands of instances typically share a few geometry containers
+        if (mGeometryContainerSet.insert(container).second) {
+            mGeometryContainers.push_back(container);
+            mValidatedGeometryContainersGeneration = 0;
+        }
+    }
+
+    void RayTracingAccelerationContainerBase::SetInstanceInfo(
+        uint32_t instanceIndex,
+        RayTracingAccelerationContainerBase* geometryContainer,
+        uint32_t mask) {
+        // geometry containers stay referenced once linked, so the raw pointer stays valid
+        AddGeometryContainer(geometryContainer);
+        mInstanceInfos[instanceIndex].geometryContainer = geometryContainer;
+        mInstanceInfos[instanceIndex].mask = mask;
+    }
+
     void RayTracingAccelerationContainerBase::Destroy() {
         DestroyInternal();
     }
 
     void RayTracingAccelerationContainerBase::DestroyInternal() {
+        if (mFlags & wgpu::RayTracingAccelerationContainerFlag::Evictable) {
+            GetDevice()->GetRayTracingResidencyManager()->Untrack(this);
+        }
+        mTrackedMemory.Untrack();
         if (!IsDestroyed()) {
+            GetDevice()->InvalidateRayTracingAccelerationContainerGeneration();
             DestroyImpl();
+            SetMemoryInfo({});
         }
         SetDestroyState(true);
     }
 
+    void RayTracingAccelerationContainerBase::SetMemoryInfo(
+        const RayTracingAccelerationContainerMemoryInfo& info) {
+        GetDevice()->TrackRayTracingAccelerationContainerMemory(mMemoryInfo, info);
+        mMemoryInfo = info;
+    }
+
     uint64_t RayTracingAccelerationContainerBase::GetHandle() {
         return GetHandleInternal();
     }
 
+    void RayTracingAccelerationContainerBase::GetHandleAsync(
+        wgpu::RayTracingAccelerationContainerGetHandleCallback callback,
+        void* userdata) {
+        WGPURayTracingAccelerationContainerGetHandleStatus status;
+        if (GetDevice()->ConsumedError(ValidateGetHandle(&status))) {
+            callback(status, 0, userdata);
+            return;
+        }
+        ASSERT(!IsError());
+
+        callback(WGPURayTracingAccelerationContainerGetHandleStatus_Success, GetHandleInternal(),
+                 userdata);
+    }
+
+    ResultOrError<uint64_t> RayTracingAccelerationContainerBase::GetValidatedHandle() {
+        WGPURayTracingAccelerationContainerGetHandleStatus status;
+        DAWN_TRY(ValidateGetHandle(&status));
+        ASSERT(!IsError());
+        return GetHandleInternal();
+    }
+
+    void RayTracingAccelerationContainerBase::UpdateInstances(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceDescriptor* instances) {
+        if (GetDevice()->ConsumedError(
+                ValidateUpdateInstances(firstInstance, instanceCount, instances))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        // the bookkeeping is only changed once the backend accepted all the instances, so that a
+        // rejected update leaves the container as it was
+        if (GetDevice()->ConsumedError(
+                UpdateInstancesImpl(firstInstance, instanceCount, instances))) {
+            return;
+        }
+
+        // the new instances might link geometry containers which weren't referenced yet
+        for (unsigned int ii = 0; ii < instanceCount; ++ii) {
+            SetInstanceInfo(firstInstance + ii, instances[ii].geometryContainer,
+                            instances[ii].mask);
+        }
+    }
+
+    void RayTracingAccelerationContainerBase::UpdateInstanceProperties(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceProperties* properties) {
+        if (GetDevice()->ConsumedError(
+                ValidateUpdateInstanceProperties(firstInstance, instanceCount, properties))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        for (unsigned int ii = 0; ii < instanceCount; ++ii) {
+            mInstanceInfos[firstInstance + ii].mask = properties[ii].mask;
+        }
+
+        if (GetDevice()->ConsumedError(
+                UpdateInstancePropertiesImpl(firstInstance, instanceCount, properties))) {
+            return;
+        }
+    }
+
+    RayTracingAccelerationContainerBase* RayTracingAccelerationContainerBase::CreateSubset(
+        const RayTracingAccelerationContainerSubsetDescriptor* descriptor) {
+        RayTracingAccelerationContainerBase* result = nullptr;
+        if (GetDevice()->ConsumedError(CreateSubsetInternal(descriptor), &result)) {
+            return RayTracingAccelerationContainerBase::MakeError(GetDevice());
+        }
+        return result;
+    }
+
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    RayTracingAccelerationContainerBase::CreateSubsetInternal(
+        const RayTracingAccelerationContainerSubsetDescriptor* descriptor) {
+        DAWN_TRY(ValidateCreateSubset(descriptor));
+        ASSERT(!IsError());
+
+        std::vector<uint32_t> instanceIndices;
+        if (descriptor->instanceIndices != nullptr) {
+            instanceIndices.assign(descriptor->instanceIndices,
+                                   descriptor->instanceIndices + descriptor->instanceIndexCount);
+        } else {
+            for (uint32_t ii = 0; ii < mInstanceCount; ++ii) {
+                if ((mInstanceInfos[ii].mask & descriptor->instanceMask) != 0) {
+                    instanceIndices.push_back(ii);
+                }
+            }
+        }
+        if (instanceIndices.empty()) {
+            return DAWN_VALIDATION_ERROR("The subset of the instances is empty");
+        }
+
+        RayTracingAccelerationContainerBase* subset = nullptr;
+        DAWN_TRY_ASSIGN(subset, CreateSubsetImpl(descriptor, instanceIndices));
+        ASSERT(subset->mInstanceCount == instanceIndices.size());
+
+        subset->mInstanceInfos.resize(instanceIndices.size());
+        for (uint32_t ii = 0; ii < instanceIndices.size(); ++ii) {
+            const InstanceInfo& info = mInstanceInfos[instanceIndices[ii]];
+            subset->SetInstanceInfo(ii, info.geometryContainer, info.mask);
+        }
+        return subset;
+    }
+
+    void RayTracingAccelerationContainerBase::GetStatistics(
+        RayTracingAccelerationContainerStatistics* statistics) const {
+        if (GetDevice()->ConsumedError(GetDevice()->ValidateObject(this))) {
+            *statistics = {};
+            return;
+        }
+        *statistics = mStatistics;
+    }
+
+    void RayTracingAccelerationContainerBase::GetMemoryInfo(
+        RayTracingAccelerationContainerMemoryInfo* info) const {
+        if (GetDevice()->ConsumedError(GetDevice()->ValidateObject(this))) {
+            *info = {};
+            return;
+        }
+        *info = mMemoryInfo;
+    }
+
+    bool RayTracingAccelerationContainerBase::IsEvicted() const {
+        if (GetDevice()->ConsumedError(GetDevice()->ValidateObject(this))) {
+            return false;
+        }
+        return mIsEvicted;
+    }
+
+    void RayTracingAccelerationContainerBase::GetBuildInfo(
+        wgpu::RayTracingAccelerationContainerGetBuildInfoCallback callback,
+        void* userdata) {
+        WGPURayTracingAccelerationContainerGetBuildInfoStatus status;
+        if (GetDevice()->ConsumedError(ValidateGetBuildInfo(&status))) {
+            callback(status, {}, userdata);
+            return;
+        }
+        ASSERT(!IsError());
+
+        // the query results of the build are read back by the tick completing its serial
+        GetDevice()->AddRayTracingAccelerationContainerBuildInfoRequest(this, mLastBuildSerial,
+                                                                        callback, userdata);
+    }
+
+    WGPURayTracingAccelerationContainerBuildInfo
+    RayTracingAccelerationContainerBase::GetBuildInfoInternal() const {
+        WGPURayTracingAccelerationContainerBuildInfo info = {};
+        info.resultSize = mMemoryInfo.resultSize;
+        info.compactedSize = mCompactedSize;
+        info.buildTime = mBuildTime;
+        info.primitiveCount = mPrimitiveCount;
+        return info;
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateGetBuildInfo(
+        WGPURayTracingAccelerationContainerGetBuildInfoStatus* status) const {
+        *status = WGPURayTracingAccelerationContainerGetBuildInfoStatus_DeviceLost;
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+
+        *status = WGPURayTracingAccelerationContainerGetBuildInfoStatus_Error;
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (IsDestroyed()) {
+            return DAWN_VALIDATION_ERROR("Acceleration Container must not be destroyed");
+        }
+        if (mStatistics.buildCount == 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Acceleration Container must be built before getting its build info");
+        }
+
+        *status = WGPURayTracingAccelerationContainerGetBuildInfoStatus_Success;
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateGetHandle(
+        WGPURayTracingAccelerationContainerGetHandleStatus* status) const {
+        *status = WGPURayTracingAccelerationContainerGetHandleStatus_DeviceLost;
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+
+        *status = WGPURayTracingAccelerationContainerGetHandleStatus_Error;
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (IsDestroyed()) {
+            return DAWN_VALIDATION_ERROR("Acceleration Container must not be destroyed");
+        }
+        if (IsEvictedInternal()) {
+            return DAWN_VALIDATION_ERROR("Acceleration Container must not be evicted");
+        }
+
+        *status = WGPURayTracingAccelerationContainerGetHandleStatus_Success;
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateCanUpdateInstances(
+        uint32_t firstInstance,
+        uint32_t instanceCount) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (IsDestroyed()) {
+            return DAWN_VALIDATION_ERROR("Cannot update instances of a destroyed container");
+        }
+        if (mLevel != wgpu::RayTracingAccelerationContainerLevel::Top) {
+            return DAWN_VALIDATION_ERROR("Only Top-Level Acceleration Containers have instances");
+        }
+        if (mInstanceBuffer.Get() != nullptr) {
+            return DAWN_VALIDATION_ERROR(
+                "Instances of a container using an external instance buffer must be written "
+                "into that buffer");
+        }
+        if (IsBuilt() && (mFlags & wgpu::RayTracingAccelerationContainerFlag::BuildOnce)) {
+            return DAWN_VALIDATION_ERROR(
+                "Instances of a container which is built once can't be updated after its build");
+        }
+        if (instanceCount > mInstanceCount || firstInstance > mInstanceCount - instanceCount) {
+            return DAWN_VALIDATION_ERROR("Instance range is out of bounds");
+        }
+
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateUpdateInstances(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceDescriptor* instances) const {
+        DAWN_TRY(ValidateCanUpdateInstances(firstInstance, instanceCount));
+
+        for (unsigned int ii = 0; ii < instanceCount; ++ii) {
+            const RayTracingAccelerationInstanceDescriptor& instance = instances[ii];
+            if (instance.geometryContainer == nullptr) {
+                return DAWN_VALIDATION_ERROR(
+                    "Acceleration Container Instance requires a Geometry Container");
+            }
+            DAWN_TRY(GetDevice()->ValidateObject(instance.geometryContainer));
+            // linked geometry container must not be destroyed
+            if (instance.geometryContainer->IsDestroyed()) {
+                return DAWN_VALIDATION_ERROR("Linked Geometry Container must not be destroyed");
+            }
+            // the mask is packed in 8 bits, the id and the offset in 24 bits of the instance
+            // records
+            DAWN_TRY(ValidateRayTracingAccelerationInstanceFlag(instance.flags));
+            if (instance.mask > 0xFF) {
+                return DAWN_VALIDATION_ERROR("Instance Mask out of range");
+            }
+            if (instance.instanceId >= (1u << 24)) {
+                return DAWN_VALIDATION_ERROR("Instance Id out of range");
+            }
+            if (instance.instanceOffset >= (1u << 24)) {
+                return DAWN_VALIDATION_ERROR("Instance Offset out of range");
+            }
+        }
+
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateCreateSubset(
+        const RayTracingAccelerationContainerSubsetDescriptor* descriptor) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (IsDestroyed()) {
+            return DAWN_VALIDATION_ERROR("Cannot create a subset of a destroyed container");
+        }
+        if (mLevel != wgpu::RayTracingAccelerationContainerLevel::Top) {
+            return DAWN_VALIDATION_ERROR("Only Top-Level Acceleration Containers have instances");
+        }
+        if (mInstanceBuffer.Get() != nullptr) {
+            return DAWN_VALIDATION_ERROR(
+                "Subsets can only be created from containers owning their instance buffer");
+        }
+        if (IsBuilt() && (mFlags & wgpu::RayTracingAccelerationContainerFlag::BuildOnce)) {
+            return DAWN_VALIDATION_ERROR(
+                "The instances of a container which is built once are released by its build");
+        }
+
+        DAWN_TRY(ValidateRayTracingAccelerationContainerFlag(descriptor->flags));
+        if ((descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::BuildOnce) &&
+            (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::AllowUpdate)) {
+            return DAWN_VALIDATION_ERROR(
+                "Acceleration Containers which are built once can't allow updates");
+        }
+        if (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::Evictable) {
+            return DAWN_VALIDATION_ERROR(
+                "Only Bottom-Level Acceleration Containers can be evictable");
+        }
+
+        if (descriptor->instanceIndices == nullptr && descriptor->instanceIndexCount != 0) {
+            return DAWN_VALIDATION_ERROR("Instance index count requires instance indices");
+        }
+        for (uint32_t ii = 0;
+             descriptor->instanceIndices != nullptr && ii < descriptor->instanceIndexCount; ++ii) {
+            if (descriptor->instanceIndices[ii] >= mInstanceCount) {
+                return DAWN_VALIDATION_ERROR("Instance index is out of bounds");
+            }
+        }
+
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateUpdateInstanceProperties(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceProperties* properties) const {
+        DAWN_TRY(ValidateCanUpdateInstances(firstInstance, instanceCount));
+
+        // the mask is packed in 8 bits, the id and the offset in 24 bits of the instance records
+        for (unsigned int ii = 0; ii < instanceCount; ++ii) {
+            const RayTracingAccelerationInstanceProperties& instance = properties[ii];
+            DAWN_TRY(ValidateRayTracingAccelerationInstanceFlag(instance.flags));
+            if (instance.mask > 0xFF) {
+                return DAWN_VALIDATION_ERROR("Instance Mask out of range");
+            }
+            if (instance.instanceId >= (1u << 24)) {
+                return DAWN_VALIDATION_ERROR("Instance Id out of range");
+            }
+            if (instance.instanceOffset >= (1u << 24)) {
+                return DAWN_VALIDATION_ERROR("Instance Offset out of range");
+            }
+        }
+
+        return {};
+    }
+
     uint64_t RayTracingAccelerationContainerBase::GetHandleInternal() {
         return GetHandleImpl();
     }
@@ -263,11 +875,124 @@ namespace dawn_native {
         mIsDestroyed = state;
     }
 
-    MaybeError RayTracingAccelerationContainerBase::ValidateCanUseInSubmitNow() const {
+    bool RayTracingAccelerationContainerBase::ShouldRebuildOnUpdate() const {
+        return mUpdateRebuildThreshold != 0 &&
+               mStatistics.updatesSinceBuild >= mUpdateRebuildThreshold;
+    }
+
+    void RayTracingAccelerationContainerBase::TrackBuild() {
+        mStatistics.buildCount++;
+        mStatistics.updatesSinceBuild = 0;
+        mLastBuildSerial = GetDevice()->GetPendingCommandSerial();
+    }
+
+    void RayTracingAccelerationContainerBase::TrackUpdate(bool promotedToRebuild) {
+        mStatistics.updateCount++;
+        if (promotedToRebuild) {
+            mStatistics.promotedUpdateCount++;
+            mStatistics.updatesSinceBuild = 0;
+        } else {
+            mStatistics.updatesSinceBuild++;
+        }
+    }
+
+    BufferBase* RayTracingAccelerationContainerBase::GetInstanceBuffer() const {
+        return mInstanceBuffer.Get();
+    }
+
+    const std::vector<Ref<RayTracingAccelerationContainerBase>>&
+    RayTracingAccelerationContainerBase::GetGeometryContainers() const {
+        return mGeometryContainers;
+    }
+
+    bool RayTracingAccelerationContainerBase::IsEvictedInternal() const {
+        return mIsEvicted;
+    }
+
+    uint64_t RayTracingAccelerationContainerBase::GetResultMemorySize() const {
+        return mMemoryInfo.resultSize;
+    }
+
+    void RayTracingAccelerationContainerBase::Evict() {
+        ASSERT(!IsDestroyed() && !mIsEvicted);
+        GetDevice()->InvalidateRayTracingAccelerationContainerGeneration();
+        EvictImpl();
+        mIsEvicted = true;
+        mIsBuilt = false;
+        mIsUpdated = false;
+        mStatistics.evictionCount++;
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::MakeResident() {
+        if (!mIsEvicted) {
+            return {};
+        }
+        DAWN_TRY(MakeResidentImpl());
+        mIsEvicted = false;
+        return {};
+    }
+
+    std::vector<BufferBase*> RayTracingAccelerationContainerBase::GetGeometryBuffers() const {
+        std::vector<BufferBase*> buffers;
+        for (const std::vector<Ref<BufferBase>>* references :
+             {&mVertexBuffers, &mIndexBuffers, &mAABBBuffers, &mTransformBuffers}) {
+            for (const Ref<BufferBase>& buffer : *references) {
+                if (std::find(buffers.begin(), buffers.end(), buffer.Get()) == buffers.end()) {
+                    buffers.push_back(buffer.Get());
+                }
+            }
+        }
+        return buffers;
+    }
+
+    uint64_t RayTracingAccelerationContainerBase::GetCompactedSize() const {
+        return mCompactedSize;
+    }
+
+    void RayTracingAccelerationContainerBase::SetCompactedSize(uint64_t size) {
+        mCompactedSize = size;
+    }
+
+    void RayTracingAccelerationContainerBase::SetBuildTime(uint64_t nanoseconds) {
+        mBuildTime = nanoseconds;
+    }
+
+    MaybeError RayTracingAccelerationContainerBase::ValidateCanUseInSubmitNow(
+        const std::set<const RayTracingAccelerationContainerBase*>& builtContainers) const {
         ASSERT(!IsError());
         if (IsDestroyed()) {
             return DAWN_VALIDATION_ERROR("Destroyed acceleration container used in a submit");
         }
+        if (mIsEvicted && builtContainers.find(this) == builtContainers.end()) {
+            return DAWN_VALIDATION_ERROR(
+                "Evicted acceleration container must be rebuilt before it is used");
+        }
+
+        // The geometry containers only have to be checked again once a container of the device
+        // got destroyed or evicted since they were last found usable.
+        uint64_t generation = GetDevice()->GetRayTracingAccelerationContainerGeneration();
+        if (mValidatedGeometryContainersGeneration == generation) {
+            return {};
+        }
+        bool allResident = true;
+        for (const Ref<RayTracingAccelerationContainerBase>& container : mGeometryContainers) {
+            if (container->IsDestroyed()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Acceleration container references a destroyed geometry container");
+            }
+            if (container->IsEvictedInternal()) {
+                if (builtContainers.find(container.Get()) == builtContainers.end()) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Acceleration container references an evicted geometry container which "
+                        "must be rebuilt before it is used");
+                }
+                allResident = false;
+            }
+        }
+        // rebuilds of evicted containers only make them usable for the submit doing them
+        if (allResident) {
+            mValidatedGeometryContainersGeneration = generation;
+        }
         return {};
     }
 
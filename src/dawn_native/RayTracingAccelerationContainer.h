@@ -15,21 +15,66 @@
 #ifndef DAWNNATIVE_RAY_TRACING_ACCELERATION_CONTAINER_H_
 #define DAWNNATIVE_RAY_TRACING_ACCELERATION_CONTAINER_H_
 
+#include "common/Constants.h"
+#include "common/Serial.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
+#include "dawn_native/MemoryUsageTracker.h"
 #include "dawn_native/ObjectBase.h"
 
 #include "dawn_native/dawn_platform.h"
 
 #include <vector>
 #include <memory>
+#include <set>
+#include <unordered_set>
 
 namespace dawn_native {
 
+    // Byte size (a 3x4 float matrix) and required offset alignment of a geometry transform.
+    static constexpr uint64_t kAccelerationGeometryTransformSize = 48;
+    static constexpr uint64_t kAccelerationGeometryTransformOffsetAlignment = 16;
+
     MaybeError ValidateRayTracingAccelerationContainerDescriptor(
         DeviceBase* device,
         const RayTracingAccelerationContainerDescriptor* descriptor);
 
+    // Deep copy of a RayTracingAccelerationContainerDescriptor which keeps the referenced objects
+    // alive, used to create a container after the application's descriptor went out of scope.
+    class RayTracingAccelerationContainerDescriptorStorage {
+      public:
+        RayTracingAccelerationContainerDescriptorStorage(
+            const RayTracingAccelerationContainerDescriptor* descriptor);
+        RayTracingAccelerationContainerDescriptorStorage(
+            const RayTracingAccelerationContainerDescriptorStorage&) = delete;
+        RayTracingAccelerationContainerDescriptorStorage& operator=(
+            const RayTracingAccelerationContainerDescriptorStorage&) = delete;
+
+        const RayTracingAccelerationContainerDescriptor* GetDescriptor() const;
+
+      private:
+        struct GeometryStorage {
+            RayTracingAccelerationGeometryVertexDescriptor vertex;
+            RayTracingAccelerationGeometryIndexDescriptor index;
+            RayTracingAccelerationGeometryAabbDescriptor aabb;
+            RayTracingAccelerationGeometryTransformDescriptor transform;
+        };
+        struct InstanceStorage {
+            RayTracingAccelerationInstanceTransformDescriptor transform;
+            Transform3D translation;
+            Transform3D rotation;
+            Transform3D scale;
+            std::vector<float> transformMatrix;
+        };
+
+        RayTracingAccelerationContainerDescriptor mDescriptor;
+        std::vector<RayTracingAccelerationGeometryDescriptor> mGeometries;
+        std::vector<GeometryStorage> mGeometryStorage;
+        std::vector<RayTracingAccelerationInstanceDescriptor> mInstances;
+        std::vector<InstanceStorage> mInstanceStorage;
+        std::vector<Ref<ObjectBase>> mReferences;
+    };
+
     class RayTracingAccelerationContainerBase : public ObjectBase {
 
       public:
@@ -42,6 +87,45 @@ namespace dawn_native {
         void Destroy();
 
         uint64_t GetHandle();
+        // Same as GetHandle() but reports the handle through a callback, which is how the handle
+        // gets to clients of the wire.
+        void GetHandleAsync(wgpu::RayTracingAccelerationContainerGetHandleCallback callback,
+                            void* userdata);
+        // Same as GetHandle() but validated like GetHandleAsync(), used to get the handles of
+        // many containers at once.
+        ResultOrError<uint64_t> GetValidatedHandle();
+
+        // Overwrites a range of the instances of a top-level container which owns its instance
+        // buffer. The new instances are used by the next build or update of the container.
+        void UpdateInstances(uint32_t firstInstance,
+                             uint32_t instanceCount,
+                             const RayTracingAccelerationInstanceDescriptor* instances);
+        // Overwrites the flags, mask, id and shader binding table offset of a range of instances
+        // but keeps their transforms and geometry containers, for example to force instances to
+        // be opaque for some rays. Like UpdateInstances(), this takes effect with the next build
+        // or update of the container.
+        void UpdateInstanceProperties(uint32_t firstInstance,
+                                      uint32_t instanceCount,
+                                      const RayTracingAccelerationInstanceProperties* properties);
+
+        // Creates a top-level container over a subset of the instances of this one, either the
+        // listed instances or the ones whose mask intersects the instance mask. The instance
+        // records are copied on the GPU, so the geometry containers don't have to be looked up
+        // and packed again. The subset has to be built before it is used.
+        RayTracingAccelerationContainerBase* CreateSubset(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor);
+
+        void GetStatistics(RayTracingAccelerationContainerStatistics* statistics) const;
+        void GetMemoryInfo(RayTracingAccelerationContainerMemoryInfo* info) const;
+        bool IsEvicted() const;
+
+        // Reports the sizes, primitive count and GPU time of the last build recorded for the
+        // container once that build completed on the GPU, to choose build flags and budgets per
+        // kind of asset. The compacted size is 0 unless the container allows compaction, and the
+        // build time is 0 unless the TimestampQuery extension is enabled.
+        void GetBuildInfo(wgpu::RayTracingAccelerationContainerGetBuildInfoCallback callback,
+                          void* userdata);
+        WGPURayTracingAccelerationContainerBuildInfo GetBuildInfoInternal() const;
 
         bool IsBuilt() const;
         bool IsUpdated() const;
@@ -50,36 +134,143 @@ namespace dawn_native {
         void SetUpdateState(bool state);
         void SetDestroyState(bool state);
 
-        MaybeError ValidateCanUseInSubmitNow() const;
+        // Bookkeeping of the builds and updates recorded for this container. Once
+        // |updateRebuildThreshold| updates were recorded since the last build, the next update
+        // gets recorded as a full rebuild instead, to recover the quality of the BVH.
+        bool ShouldRebuildOnUpdate() const;
+        void TrackBuild();
+        void TrackUpdate(bool promotedToRebuild);
+
+        // The compacted size is only known once a build of a container that allows compaction
+        // has completed on the GPU, it is 0 until then.
+        uint64_t GetCompactedSize() const;
+        void SetCompactedSize(uint64_t size);
+        // Like the compacted size, the GPU time of a build in nanoseconds is only known once the
+        // build completed.
+        void SetBuildTime(uint64_t nanoseconds);
+
+        // An evicted container, or a top-level container referencing an evicted one, can only be
+        // used in a submit which rebuilds the evicted containers.
+        MaybeError ValidateCanUseInSubmitNow(
+            const std::set<const RayTracingAccelerationContainerBase*>& builtContainers) const;
 
         wgpu::RayTracingAccelerationContainerFlag GetFlags() const;
         wgpu::RayTracingAccelerationContainerLevel GetLevel() const;
 
+        // The external instance buffer of a top-level container, nullptr if the container owns
+        // its instance buffer.
+        BufferBase* GetInstanceBuffer() const;
+
+        // The bottom-level containers referenced by the instances of a top-level container.
+        const std::vector<Ref<RayTracingAccelerationContainerBase>>& GetGeometryContainers()
+            const;
+
+        // Residency of the containers created with the Evictable flag, which is managed by the
+        // device's RayTracingResidencyManager. Evicting a container releases its acceleration
+        // structure and result memory, the next build of the container recreates them.
+        bool IsEvictedInternal() const;
+        uint64_t GetResultMemorySize() const;
+        void Evict();
+        MaybeError MakeResident();
+
+        // The unique vertex, index, AABB and transform buffers the geometries of a bottom-level
+        // container are read from by builds and updates.
+        std::vector<BufferBase*> GetGeometryBuffers() const;
+
       protected:
         RayTracingAccelerationContainerBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         void DestroyInternal();
         uint64_t GetHandleInternal();
+
+        // Called by the backends whenever the memory owned by the container changes.
+        void SetMemoryInfo(const RayTracingAccelerationContainerMemoryInfo& info);
       private:
+        void AddGeometryContainer(RayTracingAccelerationContainerBase* container);
+        void SetInstanceInfo(uint32_t instanceIndex,
+                             RayTracingAccelerationContainerBase* geometryContainer,
+                             uint32_t mask);
+        ResultOrError<RayTracingAccelerationContainerBase*> CreateSubsetInternal(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor);
+
+        MaybeError ValidateGetHandle(
+            WGPURayTracingAccelerationContainerGetHandleStatus* status) const;
+        MaybeError ValidateGetBuildInfo(
+            WGPURayTracingAccelerationContainerGetBuildInfoStatus* status) const;
+        MaybeError ValidateCanUpdateInstances(uint32_t firstInstance,
+                                              uint32_t instanceCount) const;
+        MaybeError ValidateUpdateInstances(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceDescriptor* instances) const;
+        MaybeError ValidateUpdateInstanceProperties(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceProperties* properties) const;
+        MaybeError ValidateCreateSubset(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor) const;
 
         // bottom-level references
         std::vector<Ref<BufferBase>> mVertexBuffers;
         std::vector<Ref<BufferBase>> mIndexBuffers;
         std::vector<Ref<BufferBase>> mAABBBuffers;
+        std::vector<Ref<BufferBase>> mTransformBuffers;
 
         // top-level references
         Ref<BufferBase> mInstanceBuffer;
+        uint32_t mInstanceCount = 0;
         std::vector<Ref<RayTracingAccelerationContainerBase>> mGeometryContainers;
+        std::unordered_set<const RayTracingAccelerationContainerBase*> mGeometryContainerSet;
+        // What subsets need to know about the instances, kept when the container owns its
+        // instance buffer since the packed instances only live on the GPU.
+        struct InstanceInfo {
+            RayTracingAccelerationContainerBase* geometryContainer = nullptr;
+            uint32_t mask = 0;
+        };
+        std::vector<InstanceInfo> mInstanceInfos;
+        // The device's container generation at which the geometry containers were last found
+        // usable in a submit, 0 if they have to be validated again.
+        mutable uint64_t mValidatedGeometryContainersGeneration = 0;
 
         bool mIsBuilt = false;
         bool mIsUpdated = false;
         bool mIsDestroyed = false;
+        bool mIsEvicted = false;
+
+        uint64_t mCompactedSize = 0;
+        uint64_t mBuildTime = 0;
+        // Triangles and AABBs of a bottom-level container, instances of a top-level one.
+        uint64_t mPrimitiveCount = 0;
+        // The serial the last build was recorded with.
+        Serial mLastBuildSerial = 0;
+
+        uint32_t mUpdateRebuildThreshold = 0;
+        RayTracingAccelerationContainerStatistics mStatistics;
+        RayTracingAccelerationContainerMemoryInfo mMemoryInfo;
+        // Only counts the container, its memory is summed from the memory infos by the device.
+        TrackedMemory mTrackedMemory;
 
-        wgpu::RayTracingAccelerationContainerFlag mFlags;
+        wgpu::RayTracingAccelerationContainerFlag mFlags =
+            wgpu::RayTracingAccelerationContainerFlag::None;
         wgpu::RayTracingAccelerationContainerLevel mLevel;
 
         virtual void DestroyImpl() = 0;
         virtual uint64_t GetHandleImpl() = 0;
+        virtual MaybeError UpdateInstancesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceDescriptor* instances) = 0;
+        virtual MaybeError UpdateInstancePropertiesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceProperties* properties) = 0;
+        // Creates a top-level container owning an instance buffer with copies of the given
+        // instances of this container.
+        virtual ResultOrError<RayTracingAccelerationContainerBase*> CreateSubsetImpl(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor,
+            const std::vector<uint32_t>& instanceIndices) = 0;
+        virtual void EvictImpl() = 0;
+        virtual MaybeError MakeResidentImpl() = 0;
     };
 
 }  // namespace dawn_native
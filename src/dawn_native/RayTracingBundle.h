@@ -0,0 +1,56 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RAYTRACINGBUNDLE_H_
+#define DAWNNATIVE_RAYTRACINGBUNDLE_H_
+
+#include "dawn_native/CommandAllocator.h"
+#include "dawn_native/EncodingContext.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/ObjectBase.h"
+#include "dawn_native/PassResourceUsage.h"
+
+#include "dawn_native/dawn_platform.h"
+
+namespace dawn_native {
+
+    struct RayTracingBundleDescriptor;
+    class RayTracingBundleEncoder;
+
+    // The commands of a ray tracing bundle are validated once, as they are encoded. Executing it
+    // in a ray tracing pass only merges its resource usages into the pass's.
+    class RayTracingBundleBase : public ObjectBase {
+      public:
+        RayTracingBundleBase(RayTracingBundleEncoder* encoder,
+                             const RayTracingBundleDescriptor* descriptor,
+                             PassResourceUsage resourceUsage);
+        ~RayTracingBundleBase() override;
+
+        static RayTracingBundleBase* MakeError(DeviceBase* device);
+
+        CommandIterator* GetCommands();
+
+        const PassResourceUsage& GetResourceUsage() const;
+
+      private:
+        RayTracingBundleBase(DeviceBase* device, ErrorTag errorTag);
+
+        CommandIterator mCommands;
+        RetainedObjects mRetainedObjects;
+        PassResourceUsage mResourceUsage;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RAYTRACINGBUNDLE_H_
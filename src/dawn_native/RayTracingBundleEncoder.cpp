@@ -0,0 +1,79 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/RayTracingBundleEncoder.h"
+
+#include "dawn_native/CommandValidation.h"
+#include "dawn_native/Device.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+namespace dawn_native {
+
+    RayTracingBundleEncoder::RayTracingBundleEncoder(DeviceBase* device,
+                                                     const RayTracingBundleEncoderDescriptor*)
+        : RayTracingEncoderBase(device, &mEncodingContext), mEncodingContext(device, this) {
+    }
+
+    RayTracingBundleEncoder::RayTracingBundleEncoder(DeviceBase* device, ErrorTag errorTag)
+        : RayTracingEncoderBase(device, &mEncodingContext, errorTag),
+          mEncodingContext(device, this) {
+    }
+
+    // static
+    RayTracingBundleEncoder* RayTracingBundleEncoder::MakeError(DeviceBase* device) {
+        return new RayTracingBundleEncoder(device, ObjectBase::kError);
+    }
+
+    CommandIterator RayTracingBundleEncoder::AcquireCommands() {
+        return mEncodingContext.AcquireCommands();
+    }
+
+    RetainedObjects RayTracingBundleEncoder::AcquireRetainedObjects() {
+        return mEncodingContext.AcquireRetainedObjects();
+    }
+
+    RayTracingBundleBase* RayTracingBundleEncoder::Finish(
+        const RayTracingBundleDescriptor* descriptor) {
+        PassResourceUsage usages = mUsageTracker.AcquireResourceUsage();
+
+        DeviceBase* device = GetDevice();
+        // Recording can happen on any thread but creating the ray tracing bundle is serialized
+        // with the other calls into the device.
+        DeviceLock lock(device->GetMutex());
+
+        // Even if mEncodingContext.Finish() validation fails, calling it will mutate the internal
+        // state of the encoding context. Subsequent calls to encode commands will generate errors.
+        if (device->ConsumedError(mEncodingContext.Finish()) ||
+            (device->IsValidationEnabled() &&
+             device->ConsumedError(ValidateFinish(usages)))) {
+            return RayTracingBundleBase::MakeError(device);
+        }
+
+        ASSERT(!IsError());
+        return device->CreateRayTracingBundle(this, descriptor, std::move(usages));
+    }
+
+    MaybeError RayTracingBundleEncoder::ValidateFinish(const PassResourceUsage& usages) const {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), Validation,
+                     "RayTracingBundleEncoder::ValidateFinish");
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        if (GetDevice()->IsResourceUsageValidationEnabled()) {
+            DAWN_TRY(ValidatePassResourceUsage(usages));
+        }
+        DAWN_TRY(ValidateProgrammableEncoderEnd());
+        return {};
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,48 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RAYTRACINGBUNDLEENCODER_H_
+#define DAWNNATIVE_RAYTRACINGBUNDLEENCODER_H_
+
+#include "dawn_native/EncodingContext.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/RayTracingBundle.h"
+#include "dawn_native/RayTracingEncoderBase.h"
+
+namespace dawn_native {
+
+    // Prerecords the pipeline, bind groups and traceRays of a ray tracing pass, so that the
+    // same sequence executed every frame is validated once.
+    class RayTracingBundleEncoder final : public RayTracingEncoderBase {
+      public:
+        RayTracingBundleEncoder(DeviceBase* device,
+                                const RayTracingBundleEncoderDescriptor* descriptor);
+
+        static RayTracingBundleEncoder* MakeError(DeviceBase* device);
+
+        RayTracingBundleBase* Finish(const RayTracingBundleDescriptor* descriptor);
+
+        CommandIterator AcquireCommands();
+        RetainedObjects AcquireRetainedObjects();
+
+      private:
+        RayTracingBundleEncoder(DeviceBase* device, ErrorTag errorTag);
+
+        MaybeError ValidateFinish(const PassResourceUsage& usages) const;
+
+        EncodingContext mEncodingContext;
+    };
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RAYTRACINGBUNDLEENCODER_H_
@@ -0,0 +1,91 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/RayTracingEncoderBase.h"
+
+#include "dawn_native/Buffer.h"
+#include "dawn_native/CommandEncoder.h"
+#include "dawn_native/Commands.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/RayTracingPipeline.h"
+
+namespace dawn_native {
+
+    RayTracingEncoderBase::RayTracingEncoderBase(DeviceBase* device,
+                                                 EncodingContext* encodingContext)
+        : ProgrammablePassEncoder(device, encodingContext) {
+    }
+
+    RayTracingEncoderBase::RayTracingEncoderBase(DeviceBase* device,
+                                                 EncodingContext* encodingContext,
+                                                 ErrorTag errorTag)
+        : ProgrammablePassEncoder(device, encodingContext, errorTag) {
+    }
+
+    void RayTracingEncoderBase::TraceRays(uint32_t rayGenerationOffset,
+                                          uint32_t rayHitOffset,
+                                          uint32_t rayMissOffset,
+                                          uint32_t width,
+                                          uint32_t height,
+                                          uint32_t depth,
+                                          uint32_t rayCallableOffset) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(mCommandBufferState.ValidateCanTraceRays());
+                DAWN_TRY(ValidateCanTraceRaysConditionally());
+            }
+
+            TraceRaysCmd* traceRays = allocator->Allocate<TraceRaysCmd>(Command::TraceRays);
+            traceRays->rayGenerationOffset = rayGenerationOffset;
+            traceRays->rayHitOffset = rayHitOffset;
+            traceRays->rayMissOffset = rayMissOffset;
+            traceRays->width = width;
+            traceRays->height = height;
+            traceRays->depth = depth;
+            traceRays->rayCallableOffset = rayCallableOffset;
+            return {};
+        });
+    }
+
+    MaybeError RayTracingEncoderBase::ValidateCanTraceRaysConditionally() const {
+        // VK_EXT_conditional_rendering only predicates draws and dispatches.
+        if (mConditionalRenderingActive &&
+            !GetDevice()->IsExtensionEnabled(Extension::RayTracingConditional)) {
+            return DAWN_VALIDATION_ERROR(
+                "traceRays in a conditional rendering scope requires the ray_tracing_conditional "
+                "extension");
+        }
+        return {};
+    }
+
+    void RayTracingEncoderBase::SetPipeline(RayTracingPipelineBase* pipeline) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            DAWN_TRY(GetDevice()->ValidateObject(pipeline));
+
+            if (pipeline->GetShaderBindingTable()->IsDestroyed()) {
+                return DAWN_VALIDATION_ERROR("Shader binding table is destroyed");
+            }
+
+            SetRayTracingPipelineCmd* setPipeline =
+                allocator->Allocate<SetRayTracingPipelineCmd>(Command::SetRayTracingPipeline);
+            setPipeline->pipeline = pipeline;
+            mEncodingContext->RetainObject(pipeline);
+
+            mCommandBufferState.SetRayTracingPipeline(pipeline);
+
+            return {};
+        });
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,48 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RAYTRACINGENCODERBASE_H_
+#define DAWNNATIVE_RAYTRACINGENCODERBASE_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/ProgrammablePassEncoder.h"
+
+namespace dawn_native {
+
+    // The commands shared by ray tracing passes and ray tracing bundles.
+    class RayTracingEncoderBase : public ProgrammablePassEncoder {
+      public:
+        RayTracingEncoderBase(DeviceBase* device, EncodingContext* encodingContext);
+
+        void TraceRays(uint32_t rayGenerationOffset,
+                       uint32_t rayHitOffset,
+                       uint32_t rayMissOffset,
+                       uint32_t width,
+                       uint32_t height,
+                       uint32_t depth,
+                       uint32_t rayCallableOffset);
+        void SetPipeline(RayTracingPipelineBase* pipeline);
+
+      protected:
+        // Construct an "error" ray tracing encoder base.
+        RayTracingEncoderBase(DeviceBase* device,
+                              EncodingContext* encodingContext,
+                              ErrorTag errorTag);
+
+        MaybeError ValidateCanTraceRaysConditionally() const;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RAYTRACINGENCODERBASE_H_
@@ -14,37 +14,38 @@
 
 #include "dawn_native/RayTracingPassEncoder.h"
 
-#include "dawn_native/Buffer.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
-#include "dawn_native/RayTracingPipeline.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/RayTracingBundle.h"
 
 namespace dawn_native {
 
     RayTracingPassEncoder::RayTracingPassEncoder(DeviceBase* device,
-                                           CommandEncoder* commandEncoder,
-                                           EncodingContext* encodingContext)
-        : ProgrammablePassEncoder(device, encodingContext), mCommandEncoder(commandEncoder) {
+                                                 CommandEncoder* commandEncoder,
+                                                 EncodingContext* encodingContext)
+        : RayTracingEncoderBase(device, encodingContext), mCommandEncoder(commandEncoder) {
     }
 
     RayTracingPassEncoder::RayTracingPassEncoder(DeviceBase* device,
-                                           CommandEncoder* commandEncoder,
-                                           EncodingContext* encodingContext,
-                                           ErrorTag errorTag)
-        : ProgrammablePassEncoder(device, encodingContext, errorTag),
+                                                 CommandEncoder* commandEncoder,
+                                                 EncodingContext* encodingContext,
+                                                 ErrorTag errorTag)
+        : RayTracingEncoderBase(device, encodingContext, errorTag),
           mCommandEncoder(commandEncoder) {
     }
 
     RayTracingPassEncoder* RayTracingPassEncoder::MakeError(DeviceBase* device,
-                                                      CommandEncoder* commandEncoder,
-                                                      EncodingContext* encodingContext) {
+                                                            CommandEncoder* commandEncoder,
+                                                            EncodingContext* encodingContext) {
         return new RayTracingPassEncoder(device, commandEncoder, encodingContext,
                                          ObjectBase::kError);
     }
 
     void RayTracingPassEncoder::EndPass() {
         if (mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+                DAWN_TRY(ValidateProgrammableEncoderEnd());
+
                 allocator->Allocate<EndRayTracingPassCmd>(Command::EndRayTracingPass);
 
                 return {};
@@ -53,35 +54,45 @@ namespace dawn_native {
         }
     }
 
-    void RayTracingPassEncoder::TraceRays(uint32_t rayGenerationOffset,
-                                          uint32_t rayHitOffset,
-                                          uint32_t rayMissOffset,
-                                          uint32_t width,
-                                          uint32_t height,
-                                          uint32_t depth) {
+    void RayTracingPassEncoder::ExecuteBundles(uint32_t count,
+                                               RayTracingBundleBase* const* rayTracingBundles) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            TraceRaysCmd* traceRays = allocator->Allocate<TraceRaysCmd>(Command::TraceRays);
-            traceRays->rayGenerationOffset = rayGenerationOffset;
-            traceRays->rayHitOffset = rayHitOffset;
-            traceRays->rayMissOffset = rayMissOffset;
-            traceRays->width = width;
-            traceRays->height = height;
-            traceRays->depth = depth;
-            return {};
-        });
-    }
+            for (uint32_t i = 0; i < count; ++i) {
+                DAWN_TRY(GetDevice()->ValidateObject(rayTracingBundles[i]));
+            }
+            // The bundles are recorded once, without the predicate of the pass executing them.
+            if (GetDevice()->IsValidationEnabled() && count > 0 && mConditionalRenderingActive) {
+                return DAWN_VALIDATION_ERROR(
+                    "Ray tracing bundles can't be executed in a conditional rendering scope");
+            }
 
-    void RayTracingPassEncoder::SetPipeline(RayTracingPipelineBase* pipeline) {
-        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            DAWN_TRY(GetDevice()->ValidateObject(pipeline));
+            ExecuteRayTracingBundlesCmd* cmd =
+                allocator->Allocate<ExecuteRayTracingBundlesCmd>(Command::ExecuteRayTracingBundles);
+            cmd->count = count;
 
-            if (pipeline->GetShaderBindingTable()->IsDestroyed()) {
-                return DAWN_VALIDATION_ERROR("Shader binding table is destroyed");
+            Ref<RayTracingBundleBase>* bundles =
+                allocator->AllocateData<Ref<RayTracingBundleBase>>(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                bundles[i] = rayTracingBundles[i];
+
+                const PassResourceUsage& usages = bundles[i]->GetResourceUsage();
+                for (uint32_t i = 0; i < usages.buffers.size(); ++i) {
+                    mUsageTracker.BufferUsedAs(usages.buffers[i], usages.bufferUsages[i]);
+                }
+                for (uint32_t i = 0; i < usages.textures.size(); ++i) {
+                    mUsageTracker.TextureUsedAs(usages.textures[i], usages.textureUsages[i],
+                                                usages.textureRanges[i]);
+                }
+                for (RayTracingAccelerationContainerBase* container :
+                     usages.accelerationContainers) {
+                    mUsageTracker.AccelerationContainerUsed(container);
+                }
             }
 
-            SetRayTracingPipelineCmd* setPipeline =
-                allocator->Allocate<SetRayTracingPipelineCmd>(Command::SetRayTracingPipeline);
-            setPipeline->pipeline = pipeline;
+            if (count > 0) {
+                // Reset state. It is invalidated after ray tracing bundle execution.
+                mCommandBufferState = CommandBufferStateTracker(GetDevice());
+            }
 
             return {};
         });
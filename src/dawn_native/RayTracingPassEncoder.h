@@ -16,35 +16,29 @@
 #define DAWNNATIVE_RAY_TRACING_PASSENCODER_H_
 
 #include "dawn_native/Error.h"
-#include "dawn_native/ProgrammablePassEncoder.h"
+#include "dawn_native/RayTracingEncoderBase.h"
 
 namespace dawn_native {
 
-    class RayTracingPassEncoder final : public ProgrammablePassEncoder {
+    class RayTracingPassEncoder final : public RayTracingEncoderBase {
       public:
         RayTracingPassEncoder(DeviceBase* device,
-                           CommandEncoder* commandEncoder,
-                           EncodingContext* encodingContext);
+                              CommandEncoder* commandEncoder,
+                              EncodingContext* encodingContext);
 
         static RayTracingPassEncoder* MakeError(DeviceBase* device,
-                                             CommandEncoder* commandEncoder,
-                                             EncodingContext* encodingContext);
+                                                CommandEncoder* commandEncoder,
+                                                EncodingContext* encodingContext);
 
         void EndPass();
 
-        void TraceRays(uint32_t rayGenerationOffset,
-                       uint32_t rayHitOffset,
-                       uint32_t rayMissOffset,
-                       uint32_t width,
-                       uint32_t height,
-                       uint32_t depth);
-        void SetPipeline(RayTracingPipelineBase* pipeline);
+        void ExecuteBundles(uint32_t count, RayTracingBundleBase* const* rayTracingBundles);
 
       protected:
         RayTracingPassEncoder(DeviceBase* device,
-                           CommandEncoder* commandEncoder,
-                           EncodingContext* encodingContext,
-                           ErrorTag errorTag);
+                              CommandEncoder* commandEncoder,
+                              EncodingContext* encodingContext,
+                              ErrorTag errorTag);
 
       private:
         // For render and compute passes, the encoding context is borrowed from the command encoder.
@@ -38,15 +38,47 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR("Shader Binding Table must not be destroyed");
         }
 
+        if (descriptor->basePipeline != nullptr) {
+            DAWN_TRY(device->ValidateObject(descriptor->basePipeline));
+            if (!descriptor->basePipeline->AllowsDerivatives()) {
+                return DAWN_VALIDATION_ERROR("Base pipeline doesn't allow derivatives");
+            }
+        }
+
         return {};
     }
 
+    // RayTracingPipelineDescriptorStorage
+
+    RayTracingPipelineDescriptorStorage::RayTracingPipelineDescriptorStorage(
+        const RayTracingPipelineDescriptor* descriptor)
+        : mDescriptor(*descriptor),
+          mLayout(descriptor->layout),
+          mBasePipeline(descriptor->basePipeline) {
+        if (descriptor->label != nullptr) {
+            mLabel = descriptor->label;
+            mDescriptor.label = mLabel.c_str();
+        }
+        if (descriptor->rayTracingState != nullptr) {
+            mRayTracingState = *descriptor->rayTracingState;
+            mShaderBindingTable = mRayTracingState.shaderBindingTable;
+            mDescriptor.rayTracingState = &mRayTracingState;
+        }
+    }
+
+    const RayTracingPipelineDescriptor* RayTracingPipelineDescriptorStorage::GetDescriptor()
+        const {
+        return &mDescriptor;
+    }
+
     // RayTracingPipelineBase
 
     RayTracingPipelineBase::RayTracingPipelineBase(DeviceBase* device,
                                                    const RayTracingPipelineDescriptor* descriptor)
         : PipelineBase(device, descriptor->layout),
-        mShaderBindingTable(descriptor->rayTracingState->shaderBindingTable) {
+        mShaderBindingTable(descriptor->rayTracingState->shaderBindingTable),
+        mMaxRecursionDepth(descriptor->rayTracingState->maxRecursionDepth),
+        mAllowDerivatives(descriptor->allowDerivatives) {
     }
 
     RayTracingPipelineBase::RayTracingPipelineBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -54,7 +86,10 @@ namespace dawn_native {
     }
 
     RayTracingPipelineBase::~RayTracingPipelineBase() {
-
+        // Do not uncache the actual cached object if we are a blueprint
+        if (IsCachedReference()) {
+            GetDevice()->UncacheRayTracingPipeline(this);
+        }
     }
 
     // static
@@ -66,4 +101,25 @@ namespace dawn_native {
         return mShaderBindingTable.Get();
     }
 
+    bool RayTracingPipelineBase::AllowsDerivatives() const {
+        ASSERT(!IsError());
+        return mAllowDerivatives;
+    }
+
+    size_t RayTracingPipelineBase::HashFunc::operator()(
+        const RayTracingPipelineBase* pipeline) const {
+        size_t hash = 0;
+        HashCombine(&hash, pipeline->GetLayout(), pipeline->mShaderBindingTable.Get(),
+                    pipeline->mMaxRecursionDepth, pipeline->mAllowDerivatives);
+        return hash;
+    }
+
+    bool RayTracingPipelineBase::EqualityFunc::operator()(const RayTracingPipelineBase* a,
+                                                          const RayTracingPipelineBase* b) const {
+        return a->GetLayout() == b->GetLayout() &&
+               a->mShaderBindingTable.Get() == b->mShaderBindingTable.Get() &&
+               a->mMaxRecursionDepth == b->mMaxRecursionDepth &&
+               a->mAllowDerivatives == b->mAllowDerivatives;
+    }
+
 }  // namespace dawn_native
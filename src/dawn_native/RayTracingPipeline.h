@@ -18,6 +18,8 @@
 #include "dawn_native/Pipeline.h"
 #include "dawn_native/RayTracingShaderBindingTable.h"
 
+#include <string>
+
 namespace dawn_native {
 
     class DeviceBase;
@@ -25,6 +27,26 @@ namespace dawn_native {
     MaybeError ValidateRayTracingPipelineDescriptor(DeviceBase* device,
                                                     const RayTracingPipelineDescriptor* descriptor);
 
+    // Owns a copy of a RayTracingPipelineDescriptor and the objects it references, so that the
+    // pipeline can be created after the call which provided the descriptor has returned.
+    class RayTracingPipelineDescriptorStorage {
+      public:
+        RayTracingPipelineDescriptorStorage(const RayTracingPipelineDescriptor* descriptor);
+        RayTracingPipelineDescriptorStorage(const RayTracingPipelineDescriptorStorage&) = delete;
+        RayTracingPipelineDescriptorStorage& operator=(
+            const RayTracingPipelineDescriptorStorage&) = delete;
+
+        const RayTracingPipelineDescriptor* GetDescriptor() const;
+
+      private:
+        RayTracingPipelineDescriptor mDescriptor;
+        RayTracingStateDescriptor mRayTracingState;
+        std::string mLabel;
+        Ref<PipelineLayoutBase> mLayout;
+        Ref<RayTracingShaderBindingTableBase> mShaderBindingTable;
+        Ref<RayTracingPipelineBase> mBasePipeline;
+    };
+
     class RayTracingPipelineBase : public PipelineBase {
       public:
         RayTracingPipelineBase(DeviceBase* device, const RayTracingPipelineDescriptor* descriptor);
@@ -34,10 +56,26 @@ namespace dawn_native {
 
         RayTracingShaderBindingTableBase* GetShaderBindingTable();
 
+        // Whether the pipeline can be the base pipeline of derivatives, which backends may
+        // compile faster by reusing the base's compiled shaders.
+        bool AllowsDerivatives() const;
+
+        // Functors necessary for the ContentLessObjectCache<RayTracingPipelineBase>.
+        // Pipelines own the records of their table, so they are only equal when created from
+        // the same table object.
+        struct HashFunc {
+            size_t operator()(const RayTracingPipelineBase* pipeline) const;
+        };
+        struct EqualityFunc {
+            bool operator()(const RayTracingPipelineBase* a, const RayTracingPipelineBase* b) const;
+        };
+
       private:
         RayTracingPipelineBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         Ref<RayTracingShaderBindingTableBase> mShaderBindingTable;
+        uint32_t mMaxRecursionDepth = 0;
+        bool mAllowDerivatives = false;
     };
 
 }  // namespace dawn_native
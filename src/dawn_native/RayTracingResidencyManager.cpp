@@ -0,0 +1,109 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/RayTracingResidencyManager.h"
+
+#include "common/Assert.h"
+#include "dawn_native/PassResourceUsage.h"
+#include "dawn_native/RayTracingAccelerationContainer.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace dawn_native {
+
+    void RayTracingResidencyManager::SetBudget(uint64_t budget) {
+        mBudget = budget;
+    }
+
+    void RayTracingResidencyManager::Track(RayTracingAccelerationContainerBase* container) {
+        ASSERT(mLastUsedSerials.find(container) == mLastUsedSerials.end());
+        mLastUsedSerials[container] = 0;
+    }
+
+    void RayTracingResidencyManager::Untrack(RayTracingAccelerationContainerBase* container) {
+        mLastUsedSerials.erase(container);
+    }
+
+    void RayTracingResidencyManager::TrackUsage(const CommandBufferResourceUsage& usages,
+                                                Serial serial) {
+        if (mLastUsedSerials.empty()) {
+            return;
+        }
+        for (const PassResourceUsage& passUsages : usages.perPass) {
+            for (RayTracingAccelerationContainerBase* container :
+                 passUsages.accelerationContainers) {
+                MarkUsed(container, serial);
+            }
+        }
+        for (RayTracingAccelerationContainerBase* container :
+             usages.topLevelAccelerationContainers) {
+            MarkUsed(container, serial);
+        }
+    }
+
+    void RayTracingResidencyManager::MarkUsed(RayTracingAccelerationContainerBase* container,
+                                              Serial serial) {
+        auto it = mLastUsedSerials.find(container);
+        if (it != mLastUsedSerials.end()) {
+            it->second = serial;
+        }
+        for (const Ref<RayTracingAccelerationContainerBase>& geometryContainer :
+             container->GetGeometryContainers()) {
+            it = mLastUsedSerials.find(geometryContainer.Get());
+            if (it != mLastUsedSerials.end()) {
+                it->second = serial;
+            }
+        }
+    }
+
+    void RayTracingResidencyManager::Tick(Serial completedSerial) {
+        if (mBudget == 0) {
+            return;
+        }
+
+        // only containers which the GPU is done with can be evicted
+        uint64_t residentSize = 0;
+        std::vector<std::pair<Serial, RayTracingAccelerationContainerBase*>> candidates;
+        for (const auto& it : mLastUsedSerials) {
+            RayTracingAccelerationContainerBase* container = it.first;
+            if (container->IsEvictedInternal()) {
+                continue;
+            }
+            residentSize += container->GetResultMemorySize();
+            if (it.second <= completedSerial) {
+                candidates.emplace_back(it.second, container);
+            }
+        }
+        if (residentSize <= mBudget) {
+            return;
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const std::pair<Serial, RayTracingAccelerationContainerBase*>& a,
+                            const std::pair<Serial, RayTracingAccelerationContainerBase*>& b) {
+                             return a.first < b.first;
+                         });
+        for (const auto& candidate : candidates) {
+            if (residentSize <= mBudget) {
+                break;
+            }
+            RayTracingAccelerationContainerBase* container = candidate.second;
+            residentSize -= container->GetResultMemorySize();
+            container->Evict();
+        }
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,56 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RAYTRACINGRESIDENCYMANAGER_H_
+#define DAWNNATIVE_RAYTRACINGRESIDENCYMANAGER_H_
+
+#include "common/Serial.h"
+
+#include <cstdint>
+#include <map>
+
+namespace dawn_native {
+
+    class RayTracingAccelerationContainerBase;
+    struct CommandBufferResourceUsage;
+
+    // Keeps the result memory of the evictable bottom-level containers of a device within a
+    // budget. When the budget is exceeded, the least recently used containers which the GPU is
+    // done with get evicted first. An evicted container loses its acceleration structure and has
+    // to be rebuilt before it can be used again.
+    class RayTracingResidencyManager {
+      public:
+        // A budget of 0 disables eviction.
+        void SetBudget(uint64_t budget);
+
+        void Track(RayTracingAccelerationContainerBase* container);
+        void Untrack(RayTracingAccelerationContainerBase* container);
+
+        // Marks the containers used by a command buffer as used by the submit with |serial|.
+        // Bottom-level containers are also used by the builds and traces of the top-level
+        // containers which reference them.
+        void TrackUsage(const CommandBufferResourceUsage& usages, Serial serial);
+
+        void Tick(Serial completedSerial);
+
+      private:
+        void MarkUsed(RayTracingAccelerationContainerBase* container, Serial serial);
+
+        uint64_t mBudget = 0;
+        std::map<RayTracingAccelerationContainerBase*, Serial> mLastUsedSerials;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RAYTRACINGRESIDENCYMANAGER_H_
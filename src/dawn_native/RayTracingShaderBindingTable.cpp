@@ -15,6 +15,7 @@
 #include "dawn_native/RayTracingShaderBindingTable.h"
 
 #include "common/Assert.h"
+#include "common/HashUtils.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
 
@@ -33,6 +34,12 @@ namespace dawn_native {
             void DestroyImpl() override {
                 UNREACHABLE();
             }
+            MaybeError WriteRecordDataImpl(uint32_t groupIndex,
+                                           uint32_t count,
+                                           const void* data) override {
+                UNREACHABLE();
+                return {};
+            }
         };
 
     }  // anonymous namespace
@@ -54,6 +61,7 @@ namespace dawn_native {
                 case wgpu::ShaderStage::RayAnyHit:
                 case wgpu::ShaderStage::RayMiss:
                 case wgpu::ShaderStage::RayIntersection:
+                case wgpu::ShaderStage::RayCallable:
                     break;
                 // invalid
                 case wgpu::ShaderStage::None:
@@ -67,16 +75,32 @@ namespace dawn_native {
     }
 
     RayTracingShaderBindingTableBase::RayTracingShaderBindingTableBase(DeviceBase* device, const RayTracingShaderBindingTableDescriptor* descriptor)
-        : ObjectBase(device) {
-
+        : CachedObject(device),
+          mGroupCount(descriptor->groupsCount),
+          mRecordDataSize(descriptor->recordDataSize) {
+        mStages.reserve(descriptor->stagesCount);
+        for (uint32_t i = 0; i < descriptor->stagesCount; ++i) {
+            mStages.push_back({descriptor->stages[i].stage, descriptor->stages[i].module});
+        }
+        mGroups.assign(descriptor->groups, descriptor->groups + descriptor->groupsCount);
     }
 
     RayTracingShaderBindingTableBase::RayTracingShaderBindingTableBase(DeviceBase* device, ObjectBase::ErrorTag tag)
-        : ObjectBase(device, tag) {
+        : CachedObject(device, tag) {
     }
 
     RayTracingShaderBindingTableBase::~RayTracingShaderBindingTableBase() {
+        // Do not uncache the actual cached object if we are a blueprint
+        if (IsCachedReference()) {
+            GetDevice()->UncacheRayTracingShaderBindingTable(this);
+        }
+    }
 
+    // static
+    bool RayTracingShaderBindingTableBase::IsCacheable(
+        const RayTracingShaderBindingTableDescriptor* descriptor) {
+        // The record data is written after creation, tables holding some can't be shared.
+        return descriptor->recordDataSize == 0;
     }
 
     uint32_t RayTracingShaderBindingTableBase::GetOffsetImpl(wgpu::ShaderStage shaderStage) {
@@ -84,10 +108,62 @@ namespace dawn_native {
     }
 
     void RayTracingShaderBindingTableBase::Destroy() {
+        // Equal tables created afterwards must not be given the destroyed one.
+        if (IsCachedReference()) {
+            GetDevice()->UncacheRayTracingShaderBindingTable(this);
+        }
         DestroyInternal();
     }
 
+    void RayTracingShaderBindingTableBase::WriteRecordData(uint32_t groupIndex,
+                                                           uint32_t count,
+                                                           const void* data) {
+        if (GetDevice()->ConsumedError(ValidateWriteRecordData(groupIndex, count))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        if (count == 0) {
+            return;
+        }
+
+        if (GetDevice()->ConsumedError(WriteRecordDataImpl(groupIndex, count, data))) {
+            return;
+        }
+    }
+
+    MaybeError RayTracingShaderBindingTableBase::ValidateWriteRecordData(uint32_t groupIndex,
+                                                                         uint32_t count) const {
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (IsDestroyed()) {
+            return DAWN_VALIDATION_ERROR("Shader binding table is destroyed");
+        }
+        if (groupIndex >= mGroupCount) {
+            return DAWN_VALIDATION_ERROR("Group index out of range");
+        }
+        if (count > mRecordDataSize) {
+            return DAWN_VALIDATION_ERROR("Record data exceeds the record data size");
+        }
+
+        return {};
+    }
+
+    uint32_t RayTracingShaderBindingTableBase::GetGroupCount() const {
+        return mGroupCount;
+    }
+
+    uint32_t RayTracingShaderBindingTableBase::GetRecordDataSize() const {
+        return mRecordDataSize;
+    }
+
+    void RayTracingShaderBindingTableBase::TrackMemory() {
+        mTrackedMemory.Track(GetDevice(), TrackedObjectType::ShaderBindingTable,
+                             uint64_t(mGroupCount) * mRecordDataSize);
+    }
+
     void RayTracingShaderBindingTableBase::DestroyInternal() {
+        mTrackedMemory.Untrack();
         if (!IsDestroyed()) {
             DestroyImpl();
         }
@@ -108,4 +184,63 @@ namespace dawn_native {
         return new ErrorRayTracingShaderBindingTable(device);
     }
 
+    size_t RayTracingShaderBindingTableBase::HashFunc::operator()(
+        const RayTracingShaderBindingTableBase* table) const {
+        size_t hash = 0;
+        HashCombine(&hash, table->mRecordDataSize, table->mStages.size(), table->mGroups.size());
+        for (const Stage& stage : table->mStages) {
+            HashCombine(&hash, stage.stage, stage.module.Get());
+        }
+        for (const RayTracingShaderBindingTableGroupsDescriptor& group : table->mGroups) {
+            HashCombine(&hash, group.type, group.generalIndex, group.closestHitIndex,
+                        group.anyHitIndex, group.intersectionIndex);
+        }
+        return hash;
+    }
+
+    bool RayTracingShaderBindingTableBase::EqualityFunc::operator()(
+        const RayTracingShaderBindingTableBase* a,
+        const RayTracingShaderBindingTableBase* b) const {
+        if (a->mRecordDataSize != b->mRecordDataSize || a->mStages.size() != b->mStages.size() ||
+            a->mGroups.size() != b->mGroups.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a->mStages.size(); ++i) {
+            if (a->mStages[i].stage != b->mStages[i].stage ||
+                a->mStages[i].module.Get() != b->mStages[i].module.Get()) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < a->mGroups.size(); ++i) {
+            const RayTracingShaderBindingTableGroupsDescriptor& groupA = a->mGroups[i];
+            const RayTracingShaderBindingTableGroupsDescriptor& groupB = b->mGroups[i];
+            if (groupA.type != groupB.type || groupA.generalIndex != groupB.generalIndex ||
+                groupA.closestHitIndex != groupB.closestHitIndex ||
+                groupA.anyHitIndex != groupB.anyHitIndex ||
+                groupA.intersectionIndex != groupB.intersectionIndex) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // RayTracingShaderBindingTableBlueprint
+
+    RayTracingShaderBindingTableBlueprint::RayTracingShaderBindingTableBlueprint(
+        DeviceBase* device,
+        const RayTracingShaderBindingTableDescriptor* descriptor)
+        : RayTracingShaderBindingTableBase(device, descriptor) {
+    }
+
+    void RayTracingShaderBindingTableBlueprint::DestroyImpl() {
+        UNREACHABLE();
+    }
+
+    MaybeError RayTracingShaderBindingTableBlueprint::WriteRecordDataImpl(uint32_t groupIndex,
+                                                                          uint32_t count,
+                                                                          const void* data) {
+        UNREACHABLE();
+        return {};
+    }
+
 }  // namespace dawn_native
@@ -15,31 +15,57 @@
 #ifndef DAWNNATIVE_RAY_TRACING_SHADER_BINDING_TABLE_H_
 #define DAWNNATIVE_RAY_TRACING_SHADER_BINDING_TABLE_H_
 
+#include "dawn_native/CachedObject.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
-#include "dawn_native/ObjectBase.h"
+#include "dawn_native/MemoryUsageTracker.h"
+#include "dawn_native/ShaderModule.h"
 
 #include "dawn_native/dawn_platform.h"
 
 #include <memory>
+#include <vector>
 
 namespace dawn_native {
 
     MaybeError ValidateRayTracingShaderBindingTableDescriptor(DeviceBase* device,
                                            const RayTracingShaderBindingTableDescriptor* descriptor);
 
-    class RayTracingShaderBindingTableBase : public ObjectBase {
+    // Tables without record data are immutable once created and are deduplicated by the
+    // device's cache, so that the pipelines created from equal tables are deduplicated as well.
+    class RayTracingShaderBindingTableBase : public CachedObject {
       public:
         RayTracingShaderBindingTableBase(DeviceBase* device,
                                          const RayTracingShaderBindingTableDescriptor* descriptor);
-        ~RayTracingShaderBindingTableBase();
+        ~RayTracingShaderBindingTableBase() override;
+
+        static bool IsCacheable(const RayTracingShaderBindingTableDescriptor* descriptor);
 
         void Destroy();
+        void WriteRecordData(uint32_t groupIndex, uint32_t count, const void* data);
         bool IsDestroyed() const;
         void SetDestroyState(bool state);
 
+        // Every group occupies one record of the table: the group's handle, followed by
+        // *recordDataSize* bytes of user data which shaders read as their shader record.
+        uint32_t GetGroupCount() const;
+        uint32_t GetRecordDataSize() const;
+
+        // Accounts for the record data of the table in the device's memory usage. Called by the
+        // device once the backend table is created, since blueprints aren't tracked.
+        void TrackMemory();
+
         static RayTracingShaderBindingTableBase* MakeError(DeviceBase* device);
 
+        // Functors necessary for the ContentLessObjectCache<RayTracingShaderBindingTableBase>.
+        struct HashFunc {
+            size_t operator()(const RayTracingShaderBindingTableBase* table) const;
+        };
+        struct EqualityFunc {
+            bool operator()(const RayTracingShaderBindingTableBase* a,
+                            const RayTracingShaderBindingTableBase* b) const;
+        };
+
       protected:
         RayTracingShaderBindingTableBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
@@ -48,9 +74,39 @@ namespace dawn_native {
       private:
         virtual uint32_t GetOffsetImpl(wgpu::ShaderStage stageKind);
 
+        MaybeError ValidateWriteRecordData(uint32_t groupIndex, uint32_t count) const;
+
         bool mIsDestroyed = false;
 
+        uint32_t mGroupCount = 0;
+        uint32_t mRecordDataSize = 0;
+        TrackedMemory mTrackedMemory;
+
+        struct Stage {
+            wgpu::ShaderStage stage;
+            Ref<ShaderModuleBase> module;
+        };
+        std::vector<Stage> mStages;
+        std::vector<RayTracingShaderBindingTableGroupsDescriptor> mGroups;
+
         virtual void DestroyImpl() = 0;
+        virtual MaybeError WriteRecordDataImpl(uint32_t groupIndex,
+                                               uint32_t count,
+                                               const void* data) = 0;
+    };
+
+    // A frontend-only table used to look up the device's cache of shader binding tables.
+    class RayTracingShaderBindingTableBlueprint : public RayTracingShaderBindingTableBase {
+      public:
+        RayTracingShaderBindingTableBlueprint(
+            DeviceBase* device,
+            const RayTracingShaderBindingTableDescriptor* descriptor);
+
+      private:
+        void DestroyImpl() override;
+        MaybeError WriteRecordDataImpl(uint32_t groupIndex,
+                                       uint32_t count,
+                                       const void* data) override;
     };
 
 }  // namespace dawn_native
@@ -0,0 +1,70 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/RecyclingResourceHeapAllocator.h"
+
+#include "common/Assert.h"
+
+namespace dawn_native {
+
+    RecyclingResourceHeapAllocator::RecyclingResourceHeapAllocator(
+        uint64_t heapSize,
+        ResourceHeapAllocator* heapAllocator)
+        : mHeapSize(heapSize), mHeapAllocator(heapAllocator) {
+    }
+
+    RecyclingResourceHeapAllocator::~RecyclingResourceHeapAllocator() {
+        for (RecycledHeap& recycled : mRecycledHeaps) {
+            mHeapAllocator->DeallocateResourceHeap(std::move(recycled.heap));
+        }
+    }
+
+    ResultOrError<std::unique_ptr<ResourceHeapBase>>
+    RecyclingResourceHeapAllocator::AllocateResourceHeap(uint64_t size) {
+        ASSERT(size == mHeapSize);
+
+        // Reuse the most recently recycled heap so that the older ones can age out.
+        if (!mRecycledHeaps.empty()) {
+            std::unique_ptr<ResourceHeapBase> heap = std::move(mRecycledHeaps.back().heap);
+            mRecycledHeaps.pop_back();
+            return std::move(heap);
+        }
+
+        return mHeapAllocator->AllocateResourceHeap(size);
+    }
+
+    void RecyclingResourceHeapAllocator::DeallocateResourceHeap(
+        std::unique_ptr<ResourceHeapBase> heap) {
+        mRecycledHeaps.push_back({std::move(heap), mCompletedSerial});
+    }
+
+    void RecyclingResourceHeapAllocator::Tick(Serial completedSerial) {
+        mCompletedSerial = completedSerial;
+
+        size_t releasedCount = 0;
+        while (releasedCount < mRecycledHeaps.size() &&
+               mRecycledHeaps[releasedCount].completedSerial + kRetainedSerials <=
+                   completedSerial) {
+            mHeapAllocator->DeallocateResourceHeap(
+                std::move(mRecycledHeaps[releasedCount].heap));
+            releasedCount++;
+        }
+        mRecycledHeaps.erase(mRecycledHeaps.begin(), mRecycledHeaps.begin() + releasedCount);
+    }
+
+    size_t RecyclingResourceHeapAllocator::GetRecycledHeapCountForTesting() const {
+        return mRecycledHeaps.size();
+    }
+
+}  // namespace dawn_native
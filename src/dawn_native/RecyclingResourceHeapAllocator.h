@@ -0,0 +1,65 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RECYCLINGRESOURCEHEAPALLOCATOR_H_
+#define DAWNNATIVE_RECYCLINGRESOURCEHEAPALLOCATOR_H_
+
+#include "common/Serial.h"
+#include "dawn_native/ResourceHeapAllocator.h"
+
+#include <memory>
+#include <vector>
+
+namespace dawn_native {
+
+    // RecyclingResourceHeapAllocator keeps the heaps its client gives back and hands them out
+    // again instead of creating new ones. It is used for the heaps of transient resources: they
+    // are destroyed as soon as the command buffer using them is submitted, so their heaps are
+    // often empty between two submits and would otherwise be freed and created again each frame.
+    //
+    // Heaps that stay unused while kRetainedSerials serials complete are released to the backend
+    // allocator. All the heaps must have the same size.
+    class RecyclingResourceHeapAllocator : public ResourceHeapAllocator {
+      public:
+        static constexpr Serial kRetainedSerials = 3;
+
+        RecyclingResourceHeapAllocator(uint64_t heapSize, ResourceHeapAllocator* heapAllocator);
+        ~RecyclingResourceHeapAllocator() override;
+
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size) override;
+        void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> heap) override;
+
+        void Tick(Serial completedSerial);
+
+        // For testing purposes.
+        size_t GetRecycledHeapCountForTesting() const;
+
+      private:
+        struct RecycledHeap {
+            std::unique_ptr<ResourceHeapBase> heap;
+            Serial completedSerial;
+        };
+
+        uint64_t mHeapSize;
+        ResourceHeapAllocator* mHeapAllocator;
+
+        // Ordered by the serial they were recycled at, the most recent last.
+        std::vector<RecycledHeap> mRecycledHeaps;
+        Serial mCompletedSerial = 0;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RECYCLINGRESOURCEHEAPALLOCATOR_H_
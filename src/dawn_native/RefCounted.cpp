@@ -20,11 +20,16 @@
 
 namespace dawn_native {
 
-    static constexpr size_t kPayloadBits = 1;
-    static constexpr uint64_t kPayloadMask = (uint64_t(1) << kPayloadBits) - 1;
+    // The low bits of the refcount hold the payload given by the subclass and whether the object
+    // is single-threaded. Neither change after initialization.
+    static constexpr size_t kPayloadBits = 2;
+    static constexpr uint64_t kPayloadMask = 1;
+    static constexpr uint64_t kSingleThreadedBit = 2;
+    static constexpr uint64_t kFlagsMask = (uint64_t(1) << kPayloadBits) - 1;
     static constexpr uint64_t kRefCountIncrement = (uint64_t(1) << kPayloadBits);
 
-    RefCounted::RefCounted(uint64_t payload) : mRefCount(kRefCountIncrement + payload) {
+    RefCounted::RefCounted(uint64_t payload, bool singleThreaded)
+        : mRefCount(kRefCountIncrement + payload + (singleThreaded ? kSingleThreadedBit : 0)) {
         ASSERT((payload & kPayloadMask) == payload);
     }
 
@@ -35,6 +40,12 @@ namespace dawn_native {
         return mRefCount >> kPayloadBits;
     }
 
+    bool RefCounted::HasOneRef() const {
+        // Acquire the references released by other threads so that their uses of the object
+        // happen before the caller's.
+        return (mRefCount.load(std::memory_order_acquire) >> kPayloadBits) == 1;
+    }
+
     uint64_t RefCounted::GetRefCountPayload() const {
         // We only care about the payload bits of the refcount. These never change after
         // initialization so we can use the relaxed memory order. The order doesn't guarantee
@@ -43,8 +54,21 @@ namespace dawn_native {
         return kPayloadMask & mRefCount.load(std::memory_order_relaxed);
     }
 
+    bool RefCounted::IsSingleThreaded() const {
+        // Like the payload, relaxed loads are enough since the bit never changes.
+        return (kSingleThreadedBit & mRefCount.load(std::memory_order_relaxed)) != 0;
+    }
+
     void RefCounted::Reference() {
-        ASSERT((mRefCount & ~kPayloadMask) != 0);
+        uint64_t refCount = mRefCount.load(std::memory_order_relaxed);
+        ASSERT((refCount & ~kFlagsMask) != 0);
+
+        // Single-threaded objects are never referenced concurrently, so a plain load and store
+        // avoid the locked instruction of the atomic increment.
+        if (refCount & kSingleThreadedBit) {
+            mRefCount.store(refCount + kRefCountIncrement, std::memory_order_relaxed);
+            return;
+        }
 
         // The relaxed ordering guarantees only the atomicity of the update, which is enough here
         // because the reference we are copying from still exists and makes sure other threads
@@ -54,8 +78,36 @@ namespace dawn_native {
         mRefCount.fetch_add(kRefCountIncrement, std::memory_order_relaxed);
     }
 
+    bool RefCounted::TryReference() {
+        uint64_t refCount = mRefCount.load(std::memory_order_relaxed);
+        if (refCount & kSingleThreadedBit) {
+            if ((refCount & ~kFlagsMask) == 0) {
+                return false;
+            }
+            mRefCount.store(refCount + kRefCountIncrement, std::memory_order_relaxed);
+            return true;
+        }
+
+        do {
+            if ((refCount & ~kFlagsMask) == 0) {
+                return false;
+            }
+        } while (!mRefCount.compare_exchange_weak(refCount, refCount + kRefCountIncrement,
+                                                  std::memory_order_relaxed));
+        return true;
+    }
+
     void RefCounted::Release() {
-        ASSERT((mRefCount & ~kPayloadMask) != 0);
+        uint64_t refCount = mRefCount.load(std::memory_order_relaxed);
+        ASSERT((refCount & ~kFlagsMask) != 0);
+
+        if (refCount & kSingleThreadedBit) {
+            mRefCount.store(refCount - kRefCountIncrement, std::memory_order_relaxed);
+            if (refCount < 2 * kRefCountIncrement) {
+                DeleteThis();
+            }
+            return;
+        }
 
         // The release fence here is to make sure all accesses to the object on a thread A
         // happen-before the object is deleted on a thread B. The release memory order ensures that
@@ -75,8 +127,12 @@ namespace dawn_native {
             // memory barrier, when an acquire load on mRefCount (using the `ldar` instruction)
             // should be enough and could end up being faster.
             std::atomic_thread_fence(std::memory_order_acquire);
-            delete this;
+            DeleteThis();
         }
     }
 
+    void RefCounted::DeleteThis() {
+        delete this;
+    }
+
 }  // namespace dawn_native
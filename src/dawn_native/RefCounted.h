@@ -22,17 +22,30 @@ namespace dawn_native {
 
     class RefCounted {
       public:
-        RefCounted(uint64_t payload = 0);
+        // Single-threaded objects can only be referenced and released on one thread at a time,
+        // which lets them update their refcount without atomic read-modify-write operations.
+        RefCounted(uint64_t payload = 0, bool singleThreaded = false);
         virtual ~RefCounted();
 
         uint64_t GetRefCountForTesting() const;
+        // Whether the only reference is the one of the caller, in which case no other object
+        // uses this one.
+        bool HasOneRef() const;
         uint64_t GetRefCountPayload() const;
+        bool IsSingleThreaded() const;
 
         // Dawn API
         void Reference();
         void Release();
 
+        // Adds a reference unless the last one was already released, in which case the object is
+        // about to be deleted and false is returned.
+        bool TryReference();
+
       protected:
+        // Called when the last reference is released, allows subclasses to wrap the deletion.
+        virtual void DeleteThis();
+
         std::atomic_uint64_t mRefCount;
     };
 
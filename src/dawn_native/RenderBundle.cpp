@@ -27,6 +27,7 @@ namespace dawn_native {
                                        PassResourceUsage resourceUsage)
         : ObjectBase(encoder->GetDevice()),
           mCommands(encoder->AcquireCommands()),
+          mRetainedObjects(encoder->AcquireRetainedObjects()),
           mAttachmentState(attachmentState),
           mResourceUsage(std::move(resourceUsage)) {
     }
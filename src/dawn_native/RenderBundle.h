@@ -18,6 +18,7 @@
 #include "common/Constants.h"
 #include "dawn_native/AttachmentState.h"
 #include "dawn_native/CommandAllocator.h"
+#include "dawn_native/EncodingContext.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ObjectBase.h"
 #include "dawn_native/PassResourceUsage.h"
@@ -32,6 +33,9 @@ namespace dawn_native {
     struct RenderBundleDescriptor;
     class RenderBundleEncoder;
 
+    // The commands of a render bundle are validated once, as they are encoded. Executing it in a
+    // render pass only checks that its attachment state matches the pass, and merges its resource
+    // usages into the pass's.
     class RenderBundleBase : public ObjectBase {
       public:
         RenderBundleBase(RenderBundleEncoder* encoder,
@@ -51,6 +55,7 @@ namespace dawn_native {
         RenderBundleBase(DeviceBase* device, ErrorTag errorTag);
 
         CommandIterator mCommands;
+        RetainedObjects mRetainedObjects;
         Ref<AttachmentState> mAttachmentState;
         PassResourceUsage mResourceUsage;
     };
@@ -79,9 +79,10 @@ namespace dawn_native {
 
     RenderBundleEncoder::RenderBundleEncoder(DeviceBase* device,
                                              const RenderBundleEncoderDescriptor* descriptor)
-        : RenderEncoderBase(device, &mEncodingContext),
-          mEncodingContext(device, this),
-          mAttachmentState(device->GetOrCreateAttachmentState(descriptor)) {
+        : RenderEncoderBase(device,
+                            &mEncodingContext,
+                            device->GetOrCreateAttachmentState(descriptor)),
+          mEncodingContext(device, this) {
     }
 
     RenderBundleEncoder::RenderBundleEncoder(DeviceBase* device, ErrorTag errorTag)
@@ -93,36 +94,42 @@ namespace dawn_native {
         return new RenderBundleEncoder(device, ObjectBase::kError);
     }
 
-    const AttachmentState* RenderBundleEncoder::GetAttachmentState() const {
-        return mAttachmentState.Get();
-    }
-
     CommandIterator RenderBundleEncoder::AcquireCommands() {
         return mEncodingContext.AcquireCommands();
     }
 
+    RetainedObjects RenderBundleEncoder::AcquireRetainedObjects() {
+        return mEncodingContext.AcquireRetainedObjects();
+    }
+
     RenderBundleBase* RenderBundleEncoder::Finish(const RenderBundleDescriptor* descriptor) {
         PassResourceUsage usages = mUsageTracker.AcquireResourceUsage();
 
         DeviceBase* device = GetDevice();
+        // Recording can happen on any thread but creating the render bundle is serialized with
+        // the other calls into the device.
+        DeviceLock lock(device->GetMutex());
+
         // Even if mEncodingContext.Finish() validation fails, calling it will mutate the internal
         // state of the encoding context. Subsequent calls to encode commands will generate errors.
         if (device->ConsumedError(mEncodingContext.Finish()) ||
             (device->IsValidationEnabled() &&
-             device->ConsumedError(ValidateFinish(mEncodingContext.GetIterator(), usages)))) {
+             device->ConsumedError(ValidateFinish(usages)))) {
             return RenderBundleBase::MakeError(device);
         }
 
         ASSERT(!IsError());
-        return new RenderBundleBase(this, descriptor, mAttachmentState.Get(), std::move(usages));
+        return device->CreateRenderBundle(this, descriptor, mAttachmentState.Get(),
+                                          std::move(usages));
     }
 
-    MaybeError RenderBundleEncoder::ValidateFinish(CommandIterator* commands,
-                                                   const PassResourceUsage& usages) const {
+    MaybeError RenderBundleEncoder::ValidateFinish(const PassResourceUsage& usages) const {
         TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "RenderBundleEncoder::ValidateFinish");
         DAWN_TRY(GetDevice()->ValidateObject(this));
-        DAWN_TRY(ValidatePassResourceUsage(usages));
-        DAWN_TRY(ValidateRenderBundle(commands, mAttachmentState.Get()));
+        if (GetDevice()->IsResourceUsageValidationEnabled()) {
+            DAWN_TRY(ValidatePassResourceUsage(usages));
+        }
+        DAWN_TRY(ValidateProgrammableEncoderEnd());
         return {};
     }
 
@@ -22,12 +22,17 @@
 #include "dawn_native/RenderPipeline.h"
 
 #include <math.h>
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 namespace dawn_native {
 
-    RenderEncoderBase::RenderEncoderBase(DeviceBase* device, EncodingContext* encodingContext)
+    RenderEncoderBase::RenderEncoderBase(DeviceBase* device,
+                                         EncodingContext* encodingContext,
+                                         Ref<AttachmentState> attachmentState)
         : ProgrammablePassEncoder(device, encodingContext),
+          mAttachmentState(std::move(attachmentState)),
           mDisableBaseVertex(device->IsToggleEnabled(Toggle::DisableBaseVertex)),
           mDisableBaseInstance(device->IsToggleEnabled(Toggle::DisableBaseInstance)) {
     }
@@ -40,6 +45,10 @@ namespace dawn_native {
           mDisableBaseInstance(device->IsToggleEnabled(Toggle::DisableBaseInstance)) {
     }
 
+    const AttachmentState* RenderEncoderBase::GetAttachmentState() const {
+        return mAttachmentState.Get();
+    }
+
     void RenderEncoderBase::Draw(uint32_t vertexCount,
                                  uint32_t instanceCount,
                                  uint32_t firstVertex,
@@ -49,6 +58,10 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR("Non-zero first instance not supported");
             }
 
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(mCommandBufferState.ValidateCanDraw());
+            }
+
             DrawCmd* draw = allocator->Allocate<DrawCmd>(Command::Draw);
             draw->vertexCount = vertexCount;
             draw->instanceCount = instanceCount;
@@ -72,6 +85,10 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR("Non-zero base vertex not supported");
             }
 
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(mCommandBufferState.ValidateCanDrawIndexed());
+            }
+
             DrawIndexedCmd* draw = allocator->Allocate<DrawIndexedCmd>(Command::DrawIndexed);
             draw->indexCount = indexCount;
             draw->instanceCount = instanceCount;
@@ -84,40 +101,107 @@ namespace dawn_native {
     }
 
     void RenderEncoderBase::DrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset) {
-        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            DAWN_TRY(GetDevice()->ValidateObject(indirectBuffer));
-
-            if (indirectOffset >= indirectBuffer->GetSize() ||
-                indirectOffset + kDrawIndirectSize > indirectBuffer->GetSize()) {
-                return DAWN_VALIDATION_ERROR("Indirect offset out of bounds");
-            }
+        EncodeDrawIndirect(false, indirectBuffer, indirectOffset, 1, nullptr, 0);
+    }
 
-            DrawIndirectCmd* cmd = allocator->Allocate<DrawIndirectCmd>(Command::DrawIndirect);
-            cmd->indirectBuffer = indirectBuffer;
-            cmd->indirectOffset = indirectOffset;
+    void RenderEncoderBase::DrawIndexedIndirect(BufferBase* indirectBuffer,
+                                                uint64_t indirectOffset) {
+        EncodeDrawIndirect(true, indirectBuffer, indirectOffset, 1, nullptr, 0);
+    }
 
-            mUsageTracker.BufferUsedAs(indirectBuffer, wgpu::BufferUsage::Indirect);
+    void RenderEncoderBase::MultiDrawIndirect(BufferBase* indirectBuffer,
+                                              uint64_t indirectOffset,
+                                              uint32_t maxDrawCount,
+                                              BufferBase* countBuffer,
+                                              uint64_t countBufferOffset) {
+        EncodeDrawIndirect(false, indirectBuffer, indirectOffset, maxDrawCount, countBuffer,
+                           countBufferOffset);
+    }
 
-            return {};
-        });
+    void RenderEncoderBase::MultiDrawIndexedIndirect(BufferBase* indirectBuffer,
+                                                     uint64_t indirectOffset,
+                                                     uint32_t maxDrawCount,
+                                                     BufferBase* countBuffer,
+                                                     uint64_t countBufferOffset) {
+        EncodeDrawIndirect(true, indirectBuffer, indirectOffset, maxDrawCount, countBuffer,
+                           countBufferOffset);
     }
 
-    void RenderEncoderBase::DrawIndexedIndirect(BufferBase* indirectBuffer,
-                                                uint64_t indirectOffset) {
+    void RenderEncoderBase::EncodeDrawIndirect(bool indexed,
+                                               BufferBase* indirectBuffer,
+                                               uint64_t indirectOffset,
+                                               uint32_t drawCount,
+                                               BufferBase* countBuffer,
+                                               uint64_t countBufferOffset) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             DAWN_TRY(GetDevice()->ValidateObject(indirectBuffer));
 
-            if ((indirectOffset >= indirectBuffer->GetSize() ||
-                 indirectOffset + kDrawIndexedIndirectSize > indirectBuffer->GetSize())) {
+            // The draws are packed in the indirect buffer, drawCount * stride can't overflow.
+            const uint64_t stride = indexed ? kDrawIndexedIndirectSize : kDrawIndirectSize;
+            if (indirectOffset >= indirectBuffer->GetSize() ||
+                drawCount * stride > indirectBuffer->GetSize() - indirectOffset) {
                 return DAWN_VALIDATION_ERROR("Indirect offset out of bounds");
             }
 
-            DrawIndexedIndirectCmd* cmd =
-                allocator->Allocate<DrawIndexedIndirectCmd>(Command::DrawIndexedIndirect);
+            if (countBuffer != nullptr) {
+                DAWN_TRY(GetDevice()->ValidateObject(countBuffer));
+
+                if (!GetDevice()->IsExtensionEnabled(Extension::DrawIndirectCount)) {
+                    return DAWN_VALIDATION_ERROR(
+                        "A count buffer requires the draw_indirect_count extension");
+                }
+                if (countBufferOffset % 4 != 0) {
+                    return DAWN_VALIDATION_ERROR("Count buffer offset must be a multiple of 4");
+                }
+                if (countBufferOffset >= countBuffer->GetSize() ||
+                    sizeof(uint32_t) > countBuffer->GetSize() - countBufferOffset) {
+                    return DAWN_VALIDATION_ERROR("Count buffer offset out of bounds");
+                }
+            }
+
+            if (GetDevice()->IsValidationEnabled()) {
+                if (indexed) {
+                    DAWN_TRY(mCommandBufferState.ValidateCanDrawIndexed());
+                } else {
+                    DAWN_TRY(mCommandBufferState.ValidateCanDraw());
+                }
+            }
+
+            // Only indexed draws are clamped, to the indices of the index buffer. Nothing bounds
+            // the vertices and instances of draws outside of the shaders.
+            const bool validatesArguments = indexed && drawCount > 0 &&
+                                            mEncodingContext->ValidatesIndirectArguments() &&
+                                            mLastPipeline != nullptr && mHasIndexBuffer;
+            if (validatesArguments && indirectOffset % 4 != 0) {
+                return DAWN_VALIDATION_ERROR("Indirect offset must be a multiple of 4");
+            }
+
+            DrawIndirectCmd* cmd =
+                indexed ? allocator->Allocate<DrawIndexedIndirectCmd>(Command::DrawIndexedIndirect)
+                        : allocator->Allocate<DrawIndirectCmd>(Command::DrawIndirect);
             cmd->indirectBuffer = indirectBuffer;
+            mEncodingContext->RetainObject(indirectBuffer);
             cmd->indirectOffset = indirectOffset;
+            cmd->drawCount = drawCount;
+            cmd->countBuffer = countBuffer;
+            cmd->countBufferOffset = countBufferOffset;
 
             mUsageTracker.BufferUsedAs(indirectBuffer, wgpu::BufferUsage::Indirect);
+            if (countBuffer != nullptr) {
+                mEncodingContext->RetainObject(countBuffer);
+                mUsageTracker.BufferUsedAs(countBuffer, wgpu::BufferUsage::Indirect);
+            }
+
+            if (validatesArguments) {
+                const uint64_t indexSize =
+                    IndexFormatSize(mLastPipeline->GetVertexStateDescriptor()->indexFormat);
+                const uint32_t indexCount = static_cast<uint32_t>(std::min(
+                    mIndexBufferSize / indexSize, uint64_t(std::numeric_limits<uint32_t>::max())));
+                mEncodingContext->AddIndirectValidation({indirectBuffer, indirectOffset, true,
+                                                         drawCount, indexCount,
+                                                         &cmd->indirectBuffer,
+                                                         &cmd->indirectOffset});
+            }
 
             return {};
         });
@@ -127,9 +211,18 @@ namespace dawn_native {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             DAWN_TRY(GetDevice()->ValidateObject(pipeline));
 
+            if (GetDevice()->IsValidationEnabled() &&
+                DAWN_UNLIKELY(pipeline->GetAttachmentState() != mAttachmentState.Get())) {
+                return DAWN_VALIDATION_ERROR("Pipeline attachment state is not compatible");
+            }
+
             SetRenderPipelineCmd* cmd =
                 allocator->Allocate<SetRenderPipelineCmd>(Command::SetRenderPipeline);
             cmd->pipeline = pipeline;
+            mEncodingContext->RetainObject(pipeline);
+
+            mCommandBufferState.SetRenderPipeline(pipeline);
+            mLastPipeline = pipeline;
 
             return {};
         });
@@ -142,9 +235,13 @@ namespace dawn_native {
             SetIndexBufferCmd* cmd =
                 allocator->Allocate<SetIndexBufferCmd>(Command::SetIndexBuffer);
             cmd->buffer = buffer;
+            mEncodingContext->RetainObject(buffer);
             cmd->offset = offset;
 
             mUsageTracker.BufferUsedAs(buffer, wgpu::BufferUsage::Index);
+            mCommandBufferState.SetIndexBuffer();
+            mHasIndexBuffer = true;
+            mIndexBufferSize = offset < buffer->GetSize() ? buffer->GetSize() - offset : 0;
 
             return {};
         });
@@ -162,9 +259,11 @@ namespace dawn_native {
                 allocator->Allocate<SetVertexBufferCmd>(Command::SetVertexBuffer);
             cmd->slot = slot;
             cmd->buffer = buffer;
+            mEncodingContext->RetainObject(buffer);
             cmd->offset = offset;
 
             mUsageTracker.BufferUsedAs(buffer, wgpu::BufferUsage::Vertex);
+            mCommandBufferState.SetVertexBuffer(slot);
 
             return {};
         });
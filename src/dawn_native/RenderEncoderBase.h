@@ -15,6 +15,7 @@
 #ifndef DAWNNATIVE_RENDERENCODERBASE_H_
 #define DAWNNATIVE_RENDERENCODERBASE_H_
 
+#include "dawn_native/AttachmentState.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ProgrammablePassEncoder.h"
 
@@ -22,7 +23,11 @@ namespace dawn_native {
 
     class RenderEncoderBase : public ProgrammablePassEncoder {
       public:
-        RenderEncoderBase(DeviceBase* device, EncodingContext* encodingContext);
+        RenderEncoderBase(DeviceBase* device,
+                          EncodingContext* encodingContext,
+                          Ref<AttachmentState> attachmentState);
+
+        const AttachmentState* GetAttachmentState() const;
 
         void Draw(uint32_t vertexCount,
                   uint32_t instanceCount,
@@ -36,6 +41,16 @@ namespace dawn_native {
 
         void DrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
         void DrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
+        void MultiDrawIndirect(BufferBase* indirectBuffer,
+                               uint64_t indirectOffset,
+                               uint32_t maxDrawCount,
+                               BufferBase* countBuffer,
+                               uint64_t countBufferOffset);
+        void MultiDrawIndexedIndirect(BufferBase* indirectBuffer,
+                                      uint64_t indirectOffset,
+                                      uint32_t maxDrawCount,
+                                      BufferBase* countBuffer,
+                                      uint64_t countBufferOffset);
 
         void SetPipeline(RenderPipelineBase* pipeline);
 
@@ -46,9 +61,23 @@ namespace dawn_native {
         // Construct an "error" render encoder base.
         RenderEncoderBase(DeviceBase* device, EncodingContext* encodingContext, ErrorTag errorTag);
 
+        Ref<AttachmentState> mAttachmentState;
+
       private:
+        void EncodeDrawIndirect(bool indexed,
+                                BufferBase* indirectBuffer,
+                                uint64_t indirectOffset,
+                                uint32_t drawCount,
+                                BufferBase* countBuffer,
+                                uint64_t countBufferOffset);
+
         const bool mDisableBaseVertex;
         const bool mDisableBaseInstance;
+
+        // The state indexed indirect draws are clamped to when indirect arguments are validated.
+        const RenderPipelineBase* mLastPipeline = nullptr;
+        bool mHasIndexBuffer = false;
+        uint64_t mIndexBufferSize = 0;
     };
 
 }  // namespace dawn_native
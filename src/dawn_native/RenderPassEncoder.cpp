@@ -19,6 +19,7 @@
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/QuerySet.h"
 #include "dawn_native/RenderBundle.h"
 #include "dawn_native/RenderPipeline.h"
 
@@ -33,8 +34,10 @@ namespace dawn_native {
     RenderPassEncoder::RenderPassEncoder(DeviceBase* device,
                                          CommandEncoder* commandEncoder,
                                          EncodingContext* encodingContext,
-                                         PassResourceUsageTracker usageTracker)
-        : RenderEncoderBase(device, encodingContext), mCommandEncoder(commandEncoder) {
+                                         PassResourceUsageTracker usageTracker,
+                                         Ref<AttachmentState> attachmentState)
+        : RenderEncoderBase(device, encodingContext, std::move(attachmentState)),
+          mCommandEncoder(commandEncoder) {
         mUsageTracker = std::move(usageTracker);
     }
 
@@ -53,6 +56,11 @@ namespace dawn_native {
 
     void RenderPassEncoder::EndPass() {
         if (mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+                DAWN_TRY(ValidateProgrammableEncoderEnd());
+                if (GetDevice()->IsValidationEnabled() && mActiveOcclusionQuerySet != nullptr) {
+                    return DAWN_VALIDATION_ERROR("Occlusion query still active at the pass end");
+                }
+
                 allocator->Allocate<EndRenderPassCmd>(Command::EndRenderPass);
 
                 return {};
@@ -139,6 +147,13 @@ namespace dawn_native {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             for (uint32_t i = 0; i < count; ++i) {
                 DAWN_TRY(GetDevice()->ValidateObject(renderBundles[i]));
+
+                if (GetDevice()->IsValidationEnabled() &&
+                    DAWN_UNLIKELY(renderBundles[i]->GetAttachmentState() !=
+                                  mAttachmentState.Get())) {
+                    return DAWN_VALIDATION_ERROR(
+                        "Render bundle is not compatible with render pass");
+                }
             }
 
             ExecuteBundlesCmd* cmd =
@@ -154,10 +169,59 @@ namespace dawn_native {
                     mUsageTracker.BufferUsedAs(usages.buffers[i], usages.bufferUsages[i]);
                 }
                 for (uint32_t i = 0; i < usages.textures.size(); ++i) {
-                    mUsageTracker.TextureUsedAs(usages.textures[i], usages.textureUsages[i]);
+                    mUsageTracker.TextureUsedAs(usages.textures[i], usages.textureUsages[i],
+                                                usages.textureRanges[i]);
+                }
+            }
+
+            if (count > 0) {
+                // Reset state. It is invalidated after render bundle execution.
+                mCommandBufferState = CommandBufferStateTracker(GetDevice());
+                mUsageTracker.RenderBundlesExecuted();
+            }
+
+            return {};
+        });
+    }
+
+    void RenderPassEncoder::BeginOcclusionQuery(QuerySetBase* querySet, uint32_t queryIndex) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                DAWN_TRY(
+                    ValidateQueryWriteInPass(querySet, queryIndex, wgpu::QueryType::Occlusion));
+                if (mActiveOcclusionQuerySet != nullptr) {
+                    return DAWN_VALIDATION_ERROR("An occlusion query is already active");
                 }
             }
 
+            BeginOcclusionQueryCmd* cmd =
+                allocator->Allocate<BeginOcclusionQueryCmd>(Command::BeginOcclusionQuery);
+            cmd->querySet = querySet;
+            cmd->queryIndex = queryIndex;
+
+            mUsageTracker.QueryWritten(querySet, queryIndex);
+            mActiveOcclusionQuerySet = querySet;
+            mActiveOcclusionQueryIndex = queryIndex;
+
+            return {};
+        });
+    }
+
+    void RenderPassEncoder::EndOcclusionQuery() {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (GetDevice()->IsValidationEnabled()) {
+                if (mActiveOcclusionQuerySet == nullptr) {
+                    return DAWN_VALIDATION_ERROR("No occlusion query is active");
+                }
+            }
+
+            EndOcclusionQueryCmd* cmd =
+                allocator->Allocate<EndOcclusionQueryCmd>(Command::EndOcclusionQuery);
+            cmd->querySet = mActiveOcclusionQuerySet;
+            cmd->queryIndex = mActiveOcclusionQueryIndex;
+
+            mActiveOcclusionQuerySet = nullptr;
+
             return {};
         });
     }
@@ -27,7 +27,8 @@ namespace dawn_native {
         RenderPassEncoder(DeviceBase* device,
                           CommandEncoder* commandEncoder,
                           EncodingContext* encodingContext,
-                          PassResourceUsageTracker usageTracker);
+                          PassResourceUsageTracker usageTracker,
+                          Ref<AttachmentState> attachmentState);
 
         static RenderPassEncoder* MakeError(DeviceBase* device,
                                             CommandEncoder* commandEncoder,
@@ -46,6 +47,9 @@ namespace dawn_native {
         void SetScissorRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
         void ExecuteBundles(uint32_t count, RenderBundleBase* const* renderBundles);
 
+        void BeginOcclusionQuery(QuerySetBase* querySet, uint32_t queryIndex);
+        void EndOcclusionQuery();
+
       protected:
         RenderPassEncoder(DeviceBase* device,
                           CommandEncoder* commandEncoder,
@@ -56,6 +60,10 @@ namespace dawn_native {
         // For render and compute passes, the encoding context is borrowed from the command encoder.
         // Keep a reference to the encoder to make sure the context isn't freed.
         Ref<CommandEncoder> mCommandEncoder;
+
+        // The occlusion query between a Begin and End, kept alive by the commands.
+        QuerySetBase* mActiveOcclusionQuerySet = nullptr;
+        uint32_t mActiveOcclusionQueryIndex = 0;
     };
 
 }  // namespace dawn_native
@@ -376,6 +376,64 @@ namespace dawn_native {
 
     // RenderPipelineBase
 
+    // RenderPipelineDescriptorStorage
+
+    RenderPipelineDescriptorStorage::RenderPipelineDescriptorStorage(
+        const RenderPipelineDescriptor* descriptor)
+        : mDescriptor(*descriptor),
+          mLayout(descriptor->layout),
+          mVertexModule(descriptor->vertexStage.module) {
+        if (descriptor->label != nullptr) {
+            mLabel = descriptor->label;
+            mDescriptor.label = mLabel.c_str();
+        }
+        if (descriptor->vertexStage.entryPoint != nullptr) {
+            mVertexEntryPoint = descriptor->vertexStage.entryPoint;
+            mDescriptor.vertexStage.entryPoint = mVertexEntryPoint.c_str();
+        }
+        if (descriptor->fragmentStage != nullptr) {
+            mFragmentStage = *descriptor->fragmentStage;
+            mFragmentModule = mFragmentStage.module;
+            if (mFragmentStage.entryPoint != nullptr) {
+                mFragmentEntryPoint = mFragmentStage.entryPoint;
+                mFragmentStage.entryPoint = mFragmentEntryPoint.c_str();
+            }
+            mDescriptor.fragmentStage = &mFragmentStage;
+        }
+
+        if (descriptor->vertexState != nullptr) {
+            mVertexState = *descriptor->vertexState;
+            const VertexBufferLayoutDescriptor* vertexBuffers = mVertexState.vertexBuffers;
+            mVertexBuffers.assign(vertexBuffers, vertexBuffers + mVertexState.vertexBufferCount);
+            mAttributes.resize(mVertexBuffers.size());
+            for (size_t i = 0; i < mVertexBuffers.size(); ++i) {
+                const VertexAttributeDescriptor* attributes = mVertexBuffers[i].attributes;
+                mAttributes[i].assign(attributes, attributes + mVertexBuffers[i].attributeCount);
+                mVertexBuffers[i].attributes = mAttributes[i].data();
+            }
+            mVertexState.vertexBuffers = mVertexBuffers.data();
+            mDescriptor.vertexState = &mVertexState;
+        }
+
+        if (descriptor->rasterizationState != nullptr) {
+            mRasterizationState = *descriptor->rasterizationState;
+            mDescriptor.rasterizationState = &mRasterizationState;
+        }
+        if (descriptor->depthStencilState != nullptr) {
+            mDepthStencilState = *descriptor->depthStencilState;
+            mDescriptor.depthStencilState = &mDepthStencilState;
+        }
+        mColorStates.assign(descriptor->colorStates,
+                            descriptor->colorStates + descriptor->colorStateCount);
+        mDescriptor.colorStates = mColorStates.data();
+    }
+
+    const RenderPipelineDescriptor* RenderPipelineDescriptorStorage::GetDescriptor() const {
+        return &mDescriptor;
+    }
+
+    // RenderPipelineBase
+
     RenderPipelineBase::RenderPipelineBase(DeviceBase* device,
                                            const RenderPipelineDescriptor* descriptor)
         : PipelineBase(device,
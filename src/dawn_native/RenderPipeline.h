@@ -22,6 +22,8 @@
 
 #include <array>
 #include <bitset>
+#include <string>
+#include <vector>
 
 namespace dawn_native {
 
@@ -52,6 +54,37 @@ namespace dawn_native {
         wgpu::InputStepMode stepMode;
     };
 
+    // Owns a copy of a RenderPipelineDescriptor and the objects it references, so that the
+    // pipeline can be created after the call which provided the descriptor has returned.
+    class RenderPipelineDescriptorStorage {
+      public:
+        RenderPipelineDescriptorStorage(const RenderPipelineDescriptor* descriptor);
+        RenderPipelineDescriptorStorage(const RenderPipelineDescriptorStorage&) = delete;
+        RenderPipelineDescriptorStorage& operator=(const RenderPipelineDescriptorStorage&) =
+            delete;
+
+        const RenderPipelineDescriptor* GetDescriptor() const;
+
+      private:
+        RenderPipelineDescriptor mDescriptor;
+        std::string mLabel;
+        Ref<PipelineLayoutBase> mLayout;
+
+        Ref<ShaderModuleBase> mVertexModule;
+        std::string mVertexEntryPoint;
+        ProgrammableStageDescriptor mFragmentStage;
+        Ref<ShaderModuleBase> mFragmentModule;
+        std::string mFragmentEntryPoint;
+
+        VertexStateDescriptor mVertexState;
+        std::vector<VertexBufferLayoutDescriptor> mVertexBuffers;
+        std::vector<std::vector<VertexAttributeDescriptor>> mAttributes;
+
+        RasterizationStateDescriptor mRasterizationState;
+        DepthStencilStateDescriptor mDepthStencilState;
+        std::vector<ColorStateDescriptor> mColorStates;
+    };
+
     class RenderPipelineBase : public PipelineBase {
       public:
         RenderPipelineBase(DeviceBase* device, const RenderPipelineDescriptor* descriptor);
@@ -83,7 +116,7 @@ namespace dawn_native {
         std::array<std::bitset<kMaxVertexAttributes>, kMaxVertexBuffers>
             attributesUsingVertexBuffer;
 
-        // Functors necessary for the unordered_set<RenderPipelineBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<RenderPipelineBase>.
         struct HashFunc {
             size_t operator()(const RenderPipelineBase* pipeline) const;
         };
@@ -46,6 +46,10 @@ namespace dawn_native {
         // allocation offset is always local to the memory.
         uint64_t mBlockOffset = 0;
 
+        // The size the allocation was requested with, before the allocator rounded it up. Used
+        // to account for the memory of the allocations waiting to be deleted.
+        uint64_t mRequestedSize = 0;
+
         AllocationMethod mMethod = AllocationMethod::kInvalid;
     };
 
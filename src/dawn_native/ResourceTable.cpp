@@ -0,0 +1,254 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/ResourceTable.h"
+
+#include "common/Assert.h"
+#include "common/BitSetIterator.h"
+#include "common/Math.h"
+#include "dawn_native/Buffer.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/PassResourceUsageTracker.h"
+#include "dawn_native/Texture.h"
+
+namespace dawn_native {
+
+    MaybeError ValidateResourceTableDescriptor(DeviceBase* device,
+                                               const ResourceTableDescriptor* descriptor) {
+        if (descriptor->nextInChain != nullptr) {
+            return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+        }
+
+        DAWN_TRY(device->ValidateObject(descriptor->layout));
+
+        if (!descriptor->layout->IsResourceTableLayout()) {
+            return DAWN_VALIDATION_ERROR("Resource tables need a resource table layout");
+        }
+
+        return {};
+    }
+
+    // ResourceTableBase
+
+    ResourceTableBase::ResourceTableBase(DeviceBase* device,
+                                         const ResourceTableDescriptor* descriptor)
+        : BindGroupBase(device, descriptor->layout),
+          mSlots(descriptor->layout->GetResourceTableCapacity()) {
+        const BindGroupLayoutBase::LayoutBindingInfo& info =
+            descriptor->layout->GetBindingInfo();
+        ASSERT(info.mask.count() == 1);
+        for (uint32_t binding : IterateBitSet(info.mask)) {
+            mBindingType = info.types[binding];
+            mTextureComponentType = info.textureComponentTypes[binding];
+            mTextureDimension = info.textureDimensions[binding];
+        }
+    }
+
+    ResourceTableBase::ResourceTableBase(DeviceBase* device, ObjectBase::ErrorTag tag)
+        : BindGroupBase(device, tag) {
+    }
+
+    ResourceTableBase::~ResourceTableBase() = default;
+
+    // static
+    ResourceTableBase* ResourceTableBase::MakeError(DeviceBase* device) {
+        return new ResourceTableBase(device, ObjectBase::kError);
+    }
+
+    uint32_t ResourceTableBase::GetCapacity() const {
+        ASSERT(!IsError());
+        return static_cast<uint32_t>(mSlots.size());
+    }
+
+    wgpu::BindingType ResourceTableBase::GetBindingType() const {
+        ASSERT(!IsError());
+        return mBindingType;
+    }
+
+    bool ResourceTableBase::IsSlotSet(uint32_t slot) const {
+        ASSERT(!IsError());
+        ASSERT(slot < mSlots.size());
+        return mSlots[slot].resource.Get() != nullptr;
+    }
+
+    TextureViewBase* ResourceTableBase::GetSlotAsTextureView(uint32_t slot) const {
+        ASSERT(IsSlotSet(slot));
+        ASSERT(GetBindingType() == wgpu::BindingType::SampledTexture);
+        return static_cast<TextureViewBase*>(mSlots[slot].resource.Get());
+    }
+
+    BufferBinding ResourceTableBase::GetSlotAsBufferBinding(uint32_t slot) const {
+        ASSERT(IsSlotSet(slot));
+        ASSERT(GetBindingType() == wgpu::BindingType::ReadonlyStorageBuffer);
+        const Slot& data = mSlots[slot];
+        return {static_cast<BufferBase*>(data.resource.Get()), data.offset, data.size};
+    }
+
+    uint64_t ResourceTableBase::GetGeneration() const {
+        ASSERT(!IsError());
+        return mGeneration;
+    }
+
+    void ResourceTableBase::TrackUsage(PassResourceUsageTracker* usageTracker) const {
+        ASSERT(!IsError());
+        if (mSetSlotCount == 0) {
+            return;
+        }
+
+        bool isTextureTable = mBindingType == wgpu::BindingType::SampledTexture;
+        for (const Slot& slot : mSlots) {
+            if (slot.resource.Get() == nullptr) {
+                continue;
+            }
+
+            if (isTextureTable) {
+                usageTracker->TextureViewUsedAs(static_cast<TextureViewBase*>(slot.resource.Get()),
+                                                wgpu::TextureUsage::Sampled);
+            } else {
+                usageTracker->BufferUsedAs(static_cast<BufferBase*>(slot.resource.Get()),
+                                           kReadOnlyStorage);
+            }
+        }
+    }
+
+    void ResourceTableBase::SetTextureView(uint32_t slot, TextureViewBase* view) {
+        if (GetDevice()->ConsumedError(ValidateSetTextureView(slot, view))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        Slot& data = mSlots[slot];
+        if (data.resource.Get() == nullptr) {
+            mSetSlotCount++;
+        }
+        data.resource = view;
+        mGeneration++;
+        DidUpdateSlot(slot);
+    }
+
+    void ResourceTableBase::SetBuffer(uint32_t slot,
+                                      BufferBase* buffer,
+                                      uint64_t offset,
+                                      uint64_t size) {
+        if (GetDevice()->ConsumedError(ValidateSetBuffer(slot, buffer, offset, size))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        Slot& data = mSlots[slot];
+        if (data.resource.Get() == nullptr) {
+            mSetSlotCount++;
+        }
+        data.resource = buffer;
+        data.offset = offset;
+        data.size = (size == wgpu::kWholeSize) ? buffer->GetSize() : size;
+        mGeneration++;
+        DidUpdateSlot(slot);
+    }
+
+    void ResourceTableBase::ClearSlot(uint32_t slot) {
+        if (GetDevice()->ConsumedError(ValidateSlot(slot))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        Slot& data = mSlots[slot];
+        if (data.resource.Get() == nullptr) {
+            return;
+        }
+        data = {};
+        mSetSlotCount--;
+        mGeneration++;
+        DidUpdateSlot(slot);
+    }
+
+    void ResourceTableBase::DidUpdateSlot(uint32_t slot) {
+    }
+
+    MaybeError ResourceTableBase::ValidateSlot(uint32_t slot) const {
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (slot >= mSlots.size()) {
+            return DAWN_VALIDATION_ERROR("Resource table slot out of bounds");
+        }
+
+        return {};
+    }
+
+    MaybeError ResourceTableBase::ValidateSetTextureView(uint32_t slot,
+                                                         const TextureViewBase* view) const {
+        DAWN_TRY(ValidateSlot(slot));
+        DAWN_TRY(GetDevice()->ValidateObject(view));
+
+        if (mBindingType != wgpu::BindingType::SampledTexture) {
+            return DAWN_VALIDATION_ERROR("Texture view set in a table of buffers");
+        }
+
+        const TextureBase* texture = view->GetTexture();
+        if (!(texture->GetUsage() & wgpu::TextureUsage::Sampled)) {
+            return DAWN_VALIDATION_ERROR("texture binding usage mismatch");
+        }
+
+        if (texture->IsMultisampledTexture()) {
+            return DAWN_VALIDATION_ERROR("texture multisampling mismatch");
+        }
+
+        if (!texture->GetFormat().HasComponentType(mTextureComponentType)) {
+            return DAWN_VALIDATION_ERROR("texture component type usage mismatch");
+        }
+
+        if (view->GetDimension() != mTextureDimension) {
+            return DAWN_VALIDATION_ERROR("texture view dimension mismatch");
+        }
+
+        return {};
+    }
+
+    MaybeError ResourceTableBase::ValidateSetBuffer(uint32_t slot,
+                                                    const BufferBase* buffer,
+                                                    uint64_t offset,
+                                                    uint64_t size) const {
+        DAWN_TRY(ValidateSlot(slot));
+        DAWN_TRY(GetDevice()->ValidateObject(buffer));
+
+        if (mBindingType != wgpu::BindingType::ReadonlyStorageBuffer) {
+            return DAWN_VALIDATION_ERROR("Buffer set in a table of texture views");
+        }
+
+        // Same rules as the buffer bindings of bind groups.
+        uint64_t bufferSize = buffer->GetSize();
+        uint64_t bindingSize = (size == wgpu::kWholeSize) ? bufferSize : size;
+        if (bindingSize > bufferSize) {
+            return DAWN_VALIDATION_ERROR("Buffer binding size larger than the buffer");
+        }
+
+        // Note that no overflow can happen because we already checked that
+        // bufferSize >= bindingSize
+        if (offset > bufferSize - bindingSize) {
+            return DAWN_VALIDATION_ERROR("Buffer binding doesn't fit in the buffer");
+        }
+
+        if (!IsAligned(offset, 256)) {
+            return DAWN_VALIDATION_ERROR(
+                "Buffer offset for resource table needs to be 256-byte aligned");
+        }
+
+        if (!(buffer->GetUsage() & wgpu::BufferUsage::Storage)) {
+            return DAWN_VALIDATION_ERROR("buffer binding usage mismatch");
+        }
+
+        return {};
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,96 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_RESOURCETABLE_H_
+#define DAWNNATIVE_RESOURCETABLE_H_
+
+#include "dawn_native/BindGroup.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+
+#include "dawn_native/dawn_platform.h"
+
+#include <vector>
+
+namespace dawn_native {
+
+    class PassResourceUsageTracker;
+
+    MaybeError ValidateResourceTableDescriptor(DeviceBase* device,
+                                               const ResourceTableDescriptor* descriptor);
+
+    // A bind group of a resource table layout whose slots are updated in place, so that large
+    // sets of textures or buffers, like all the materials of a scene, don't need to be created
+    // again when a few of them change. Shaders index the array binding of the layout with the
+    // slots, which can be left empty as long as the shaders don't access them.
+    //
+    // The tables are set in passes like bind groups, and record the resources that are in them
+    // at that time. A table must not be modified between being set in a command buffer and the
+    // submit of the command buffer, so that the contents backends see when they record the
+    // commands match the usages that were validated.
+    class ResourceTableBase : public BindGroupBase {
+      public:
+        ResourceTableBase(DeviceBase* device, const ResourceTableDescriptor* descriptor);
+        ~ResourceTableBase() override;
+
+        static ResourceTableBase* MakeError(DeviceBase* device);
+
+        uint32_t GetCapacity() const;
+        wgpu::BindingType GetBindingType() const;
+        bool IsSlotSet(uint32_t slot) const;
+        TextureViewBase* GetSlotAsTextureView(uint32_t slot) const;
+        BufferBinding GetSlotAsBufferBinding(uint32_t slot) const;
+
+        // Incremented every time a slot is updated.
+        uint64_t GetGeneration() const;
+
+        // Adds the usages of all the resources currently in the table to the pass.
+        void TrackUsage(PassResourceUsageTracker* usageTracker) const;
+
+        // Dawn API
+        void SetTextureView(uint32_t slot, TextureViewBase* view);
+        void SetBuffer(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size);
+        void ClearSlot(uint32_t slot);
+
+      protected:
+        ResourceTableBase(DeviceBase* device, ObjectBase::ErrorTag tag);
+
+      private:
+        // Called after the resource of a slot changed, or was removed.
+        virtual void DidUpdateSlot(uint32_t slot);
+
+        MaybeError ValidateSetTextureView(uint32_t slot, const TextureViewBase* view) const;
+        MaybeError ValidateSetBuffer(uint32_t slot,
+                                     const BufferBase* buffer,
+                                     uint64_t offset,
+                                     uint64_t size) const;
+        MaybeError ValidateSlot(uint32_t slot) const;
+
+        struct Slot {
+            Ref<ObjectBase> resource;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+        std::vector<Slot> mSlots;
+        // The binding of the layout, cached because GetLayout() isn't const.
+        wgpu::BindingType mBindingType = wgpu::BindingType::SampledTexture;
+        wgpu::TextureComponentType mTextureComponentType = wgpu::TextureComponentType::Float;
+        wgpu::TextureViewDimension mTextureDimension = wgpu::TextureViewDimension::Undefined;
+        uint32_t mSetSlotCount = 0;
+        uint64_t mGeneration = 0;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_RESOURCETABLE_H_
@@ -33,7 +33,7 @@ namespace dawn_native {
 
         static SamplerBase* MakeError(DeviceBase* device);
 
-        // Functors necessary for the unordered_set<SamplerBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<SamplerBase>.
         struct HashFunc {
             size_t operator()(const SamplerBase* module) const;
         };
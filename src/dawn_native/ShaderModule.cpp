@@ -17,13 +17,17 @@
 #include "common/HashUtils.h"
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/PersistentCache.h"
 #include "dawn_native/Pipeline.h"
 #include "dawn_native/PipelineLayout.h"
 
 #include <spirv-tools/libspirv.hpp>
 #include <spirv_cross.hpp>
+#include <spirv_parser.hpp>
 
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 
 namespace dawn_native {
 
@@ -134,6 +138,57 @@ namespace dawn_native {
                         "Attempted to convert invalid spvc execution model to SingleShaderStage");
             }
         }
+
+        // Bump kSpirvInfoCacheVersion when the reflection or the layout of CachedSpirvInfo
+        // changes.
+        constexpr uint32_t kSpirvInfoCacheVersion = 3;
+
+        struct CachedSpirvInfo {
+            ShaderModuleBase::ModuleBindingInfo bindingInfo;
+            uint64_t usedVertexAttributes;
+            SingleShaderStage executionModel;
+            ShaderModuleBase::FragmentOutputBaseTypes fragmentOutputFormatBaseTypes;
+            uint32_t pushConstantSize;
+        };
+        static_assert(std::is_trivially_copyable<CachedSpirvInfo>::value, "");
+        static_assert(kMaxVertexAttributes <= 64, "");
+
+        // Returns the size of the push constant block of the module, or 0 if it has none.
+        ResultOrError<uint32_t> ComputePushConstantSize(
+            const spirv_cross::Compiler& compiler,
+            const spirv_cross::SmallVector<spirv_cross::Resource>& pushConstantBuffers) {
+            if (pushConstantBuffers.empty()) {
+                return 0u;
+            }
+            if (pushConstantBuffers.size() > 1) {
+                return DAWN_VALIDATION_ERROR("Only one push constant block is allowed");
+            }
+
+            size_t size = compiler.get_declared_struct_size(
+                compiler.get_type(pushConstantBuffers[0].base_type_id));
+            if (size > kMaxPushConstantSize) {
+                return DAWN_VALIDATION_ERROR("Push constant block over the max size");
+            }
+            return static_cast<uint32_t>(size);
+        }
+
+        // Returns the number of descriptors of the resource variable |id|, 0 when it is a
+        // runtime-sized array.
+        ResultOrError<uint32_t> ComputeBindingArraySize(const spirv_cross::Compiler& compiler,
+                                                        uint32_t id) {
+            const spirv_cross::SPIRType& type = compiler.get_type_from_variable(id);
+            if (type.array.empty()) {
+                return 1u;
+            }
+            if (type.array.size() > 1) {
+                return DAWN_VALIDATION_ERROR("Arrays of arrays of resources aren't supported");
+            }
+            if (!type.array_size_literal[0]) {
+                return DAWN_VALIDATION_ERROR(
+                    "Arrays of resources sized with specialization constants aren't supported");
+            }
+            return type.array[0];
+        }
     }  // anonymous namespace
 
     MaybeError ValidateShaderModuleDescriptor(DeviceBase*,
@@ -207,9 +262,68 @@ namespace dawn_native {
         } else {
             DAWN_TRY(ExtractSpirvInfoWithSpirvCross(compiler));
         }
+        StoreSpirvInfoInCache();
         return {};
     }
 
+    PersistentCacheKey ShaderModuleBase::GetSpirvInfoCacheKey() const {
+        return PersistentCacheKeyBuilder("ShaderModuleSpirvInfo", kSpirvInfoCacheVersion)
+            .RecordValue(GetDevice()->IsToggleEnabled(Toggle::UseSpvc))
+            .Record(mCode)
+            .Finish();
+    }
+
+    bool ShaderModuleBase::LoadSpirvInfoFromCache() {
+        ASSERT(!IsError());
+        PersistentCache* cache = GetDevice()->GetPersistentCache();
+        if (!cache->IsEnabled()) {
+            return false;
+        }
+
+        std::vector<uint8_t> data = cache->LoadData(GetSpirvInfoCacheKey());
+        if (data.size() != sizeof(CachedSpirvInfo)) {
+            return false;
+        }
+
+        CachedSpirvInfo info;
+        memcpy(&info, data.data(), sizeof(info));
+        mBindingInfo = info.bindingInfo;
+        mUsedVertexAttributes = std::bitset<kMaxVertexAttributes>(info.usedVertexAttributes);
+        mExecutionModel = info.executionModel;
+        mFragmentOutputFormatBaseTypes = info.fragmentOutputFormatBaseTypes;
+        mPushConstantSize = info.pushConstantSize;
+        return true;
+    }
+
+    void ShaderModuleBase::StoreSpirvInfoInCache() const {
+        PersistentCache* cache = GetDevice()->GetPersistentCache();
+        if (!cache->IsEnabled()) {
+            return;
+        }
+
+        CachedSpirvInfo info;
+        info.bindingInfo = mBindingInfo;
+        info.usedVertexAttributes = mUsedVertexAttributes.to_ullong();
+        info.executionModel = mExecutionModel;
+        info.fragmentOutputFormatBaseTypes = mFragmentOutputFormatBaseTypes;
+        info.pushConstantSize = mPushConstantSize;
+        cache->StoreData(GetSpirvInfoCacheKey(), &info, sizeof(info));
+    }
+
+    const std::vector<uint32_t>& ShaderModuleBase::GetCode() const {
+        return mCode;
+    }
+
+    const spirv_cross::ParsedIR& ShaderModuleBase::GetParsedIR() {
+        ASSERT(!IsError());
+        if (mParsedIR == nullptr) {
+            spirv_cross::Parser parser(mCode.data(), mCode.size());
+            parser.parse();
+            mParsedIR = std::make_unique<spirv_cross::ParsedIR>(std::move(parser.get_parsed_ir()));
+        }
+        return *mParsedIR;
+    }
+
     MaybeError ShaderModuleBase::ExtractSpirvInfoWithSpvc() {
         shaderc_spvc_execution_model execution_model;
         DAWN_TRY(CheckSpvcSuccess(mSpvcContext.GetExecutionModel(&execution_model),
@@ -222,15 +336,18 @@ namespace dawn_native {
             CheckSpvcSuccess(mSpvcContext.GetPushConstantBufferCount(&push_constant_buffers_count),
                              "Unable to get push constant buffer count for shader."));
 
-        // TODO(rharrison): This should be handled by spirv-val pass in spvc,
-        // but need to confirm.
+        // spvc doesn't reflect the size of the push constant block nor the size of the arrays of
+        // resources, so they are taken from SPIRV-Cross.
+        spirv_cross::Compiler compiler(GetParsedIR());
         if (push_constant_buffers_count > 0) {
-            return DAWN_VALIDATION_ERROR("Push constants aren't supported.");
+            DAWN_TRY_ASSIGN(mPushConstantSize,
+                            ComputePushConstantSize(
+                                compiler, compiler.get_shader_resources().push_constant_buffers));
         }
 
         // Fill in bindingInfo with the SPIRV bindings
         auto ExtractResourcesBinding =
-            [this](std::vector<shaderc_spvc_binding_info> bindings) -> MaybeError {
+            [this, &compiler](std::vector<shaderc_spvc_binding_info> bindings) -> MaybeError {
             for (const auto& binding : bindings) {
                 if (binding.binding >= kMaxBindingsPerGroup || binding.set >= kMaxBindGroups) {
                     return DAWN_VALIDATION_ERROR("Binding over limits in the SPIRV");
@@ -241,6 +358,7 @@ namespace dawn_native {
                 info->used = true;
                 info->id = binding.id;
                 info->base_type_id = binding.base_type_id;
+                DAWN_TRY_ASSIGN(info->arraySize, ComputeBindingArraySize(compiler, binding.id));
                 if (binding.binding_type == shaderc_spvc_binding_type_sampled_texture) {
                     info->multisampled = binding.multisampled;
                     info->textureDimension = ToWGPUTextureViewDimension(binding.texture_dimension);
@@ -361,14 +479,16 @@ namespace dawn_native {
             case spv::ExecutionModelIntersectionNV:
                 mExecutionModel = SingleShaderStage::RayIntersection;
                 break;
+            case spv::ExecutionModelCallableNV:
+                mExecutionModel = SingleShaderStage::RayCallable;
+                break;
             default:
                 UNREACHABLE();
                 return DAWN_VALIDATION_ERROR("Unexpected shader execution model");
         }
 
-        if (resources.push_constant_buffers.size() > 0) {
-            return DAWN_VALIDATION_ERROR("Push constants aren't supported.");
-        }
+        DAWN_TRY_ASSIGN(mPushConstantSize,
+                        ComputePushConstantSize(compiler, resources.push_constant_buffers));
 
         // Fill in bindingInfo with the SPIRV bindings
         auto ExtractResourcesBinding =
@@ -397,6 +517,7 @@ namespace dawn_native {
                 info->used = true;
                 info->id = resource.id;
                 info->base_type_id = resource.base_type_id;
+                DAWN_TRY_ASSIGN(info->arraySize, ComputeBindingArraySize(compiler, resource.id));
                 switch (bindingType) {
                     case wgpu::BindingType::SampledTexture: {
                         spirv_cross::SPIRType::ImageType imageType =
@@ -535,9 +656,20 @@ namespace dawn_native {
         return mExecutionModel;
     }
 
+    uint32_t ShaderModuleBase::GetPushConstantSize() const {
+        ASSERT(!IsError());
+        return mPushConstantSize;
+    }
+
     bool ShaderModuleBase::IsCompatibleWithPipelineLayout(const PipelineLayoutBase* layout) const {
         ASSERT(!IsError());
 
+        if (mPushConstantSize > 0 &&
+            (mPushConstantSize > layout->GetPushConstantSize() ||
+             (layout->GetPushConstantVisibility() & StageBit(mExecutionModel)) == 0)) {
+            return false;
+        }
+
         for (uint32_t group : IterateBitSet(layout->GetBindGroupLayoutsMask())) {
             if (!IsCompatibleWithBindGroupLayout(group, layout->GetBindGroupLayout(group))) {
                 return false;
@@ -586,6 +718,16 @@ namespace dawn_native {
                 return false;
             }
 
+            // Arrays of resources can only be bound with resource tables, which must have a
+            // descriptor for each element of sized arrays.
+            if (layout->IsResourceTableLayout()) {
+                if (moduleInfo.arraySize > layout->GetResourceTableCapacity()) {
+                    return false;
+                }
+            } else if (moduleInfo.arraySize != 1) {
+                return false;
+            }
+
             if (layoutBindingType == wgpu::BindingType::SampledTexture) {
                 Format::Type layoutTextureComponentType =
                     Format::TextureComponentTypeToFormatType(layoutInfo.textureComponentTypes[i]);
@@ -21,6 +21,7 @@
 #include "dawn_native/Format.h"
 #include "dawn_native/Forward.h"
 #include "dawn_native/PerStage.h"
+#include "dawn_native/PersistentCache.h"
 
 #include "dawn_native/dawn_platform.h"
 
@@ -28,10 +29,12 @@
 
 #include <array>
 #include <bitset>
+#include <memory>
 #include <vector>
 
 namespace spirv_cross {
     class Compiler;
+    class ParsedIR;
 }
 
 namespace dawn_native {
@@ -46,7 +49,11 @@ namespace dawn_native {
 
         static ShaderModuleBase* MakeError(DeviceBase* device);
 
+        // Reflects the module and stores the results in the persistent cache. Backends should
+        // try LoadSpirvInfoFromCache first so that they can skip creating the compiler.
         MaybeError ExtractSpirvInfo(const spirv_cross::Compiler& compiler);
+        // Returns true when the reflection results were found in the persistent cache.
+        bool LoadSpirvInfoFromCache();
 
         struct BindingInfo {
             // The SPIRV ID of the resource.
@@ -57,6 +64,8 @@ namespace dawn_native {
             wgpu::TextureViewDimension textureDimension = wgpu::TextureViewDimension::Undefined;
             Format::Type textureComponentType = Format::Type::Float;
             bool multisampled = false;
+            // The number of descriptors of the binding, 0 for runtime-sized arrays.
+            uint32_t arraySize = 1;
             bool used = false;
         };
         using ModuleBindingInfo =
@@ -65,6 +74,8 @@ namespace dawn_native {
         const ModuleBindingInfo& GetBindingInfo() const;
         const std::bitset<kMaxVertexAttributes>& GetUsedVertexAttributes() const;
         SingleShaderStage GetExecutionModel() const;
+        // The size of the push constant block, or 0 if the module doesn't use push constants.
+        uint32_t GetPushConstantSize() const;
 
         // An array to record the basic types (float, int and uint) of the fragment shader outputs
         // or Format::Type::Other means the fragment shader output is unused.
@@ -73,7 +84,7 @@ namespace dawn_native {
 
         bool IsCompatibleWithPipelineLayout(const PipelineLayoutBase* layout) const;
 
-        // Functors necessary for the unordered_set<ShaderModuleBase*>-based cache.
+        // Functors necessary for the ContentLessObjectCache<ShaderModuleBase>.
         struct HashFunc {
             size_t operator()(const ShaderModuleBase* module) const;
         };
@@ -81,6 +92,8 @@ namespace dawn_native {
             bool operator()(const ShaderModuleBase* a, const ShaderModuleBase* b) const;
         };
 
+        const std::vector<uint32_t>& GetCode() const;
+
         shaderc_spvc::Context* GetContext() {
             return &mSpvcContext;
         }
@@ -89,6 +102,11 @@ namespace dawn_native {
         static MaybeError CheckSpvcSuccess(shaderc_spvc_status status, const char* error_msg);
         shaderc_spvc::CompileOptions GetCompileOptions();
 
+        // The SPIR-V is parsed the first time this is called. Backends create all their
+        // SPIRV-Cross compilers, for reflection and for each translation, from copies of this IR
+        // instead of parsing the module again.
+        const spirv_cross::ParsedIR& GetParsedIR();
+
         shaderc_spvc::Context mSpvcContext;
 
       private:
@@ -101,13 +119,18 @@ namespace dawn_native {
         MaybeError ExtractSpirvInfoWithSpvc();
         MaybeError ExtractSpirvInfoWithSpirvCross(const spirv_cross::Compiler& compiler);
 
+        PersistentCacheKey GetSpirvInfoCacheKey() const;
+        void StoreSpirvInfoInCache() const;
+
         // TODO(cwallez@chromium.org): The code is only stored for deduplication. We could maybe
         // store a cryptographic hash of the code instead?
         std::vector<uint32_t> mCode;
+        std::unique_ptr<spirv_cross::ParsedIR> mParsedIR;
 
         ModuleBindingInfo mBindingInfo;
         std::bitset<kMaxVertexAttributes> mUsedVertexAttributes;
         SingleShaderStage mExecutionModel;
+        uint32_t mPushConstantSize = 0;
 
         FragmentOutputBaseTypes mFragmentOutputFormatBaseTypes;
     };
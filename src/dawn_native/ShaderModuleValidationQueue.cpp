@@ -0,0 +1,90 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/ShaderModuleValidationQueue.h"
+
+#include "common/Assert.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/ShaderModule.h"
+
+namespace dawn_native {
+
+    ShaderModuleValidationQueue::ShaderModuleValidationQueue(DeviceBase* device,
+                                                             uint32_t threadCount)
+        : mDevice(device) {
+        ASSERT(threadCount > 0);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            mThreads.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ShaderModuleValidationQueue::~ShaderModuleValidationQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mCondition.notify_all();
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+    std::shared_ptr<ShaderModuleValidationTask> ShaderModuleValidationQueue::Enqueue(
+        std::vector<uint32_t> code) {
+        std::shared_ptr<ShaderModuleValidationTask> task =
+            std::make_shared<ShaderModuleValidationTask>();
+        task->code = std::move(code);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPendingTasks.push_back(task);
+        }
+        mCondition.notify_one();
+        return task;
+    }
+
+    bool ShaderModuleValidationQueue::IsDone(const ShaderModuleValidationTask& task) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return task.done;
+    }
+
+    void ShaderModuleValidationQueue::WorkerLoop() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mCondition.wait(lock, [this] { return mStopping || !mPendingTasks.empty(); });
+            if (mStopping) {
+                return;
+            }
+
+            std::shared_ptr<ShaderModuleValidationTask> task = std::move(mPendingTasks.front());
+            mPendingTasks.pop_front();
+            lock.unlock();
+
+            ShaderModuleDescriptor descriptor = {};
+            descriptor.codeSize = static_cast<uint32_t>(task->code.size());
+            descriptor.code = task->code.data();
+            MaybeError result = ValidateShaderModuleDescriptor(mDevice, &descriptor);
+
+            lock.lock();
+            if (result.IsError()) {
+                task->error = result.AcquireError();
+            }
+            task->done = true;
+
+            lock.unlock();
+            mDevice->RequestCompletionTick();
+            lock.lock();
+        }
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,67 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_SHADERMODULEVALIDATIONQUEUE_H_
+#define DAWNNATIVE_SHADERMODULEVALIDATIONQUEUE_H_
+
+#include "dawn_native/Error.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dawn_native {
+
+    class DeviceBase;
+
+    struct ShaderModuleValidationTask {
+        std::vector<uint32_t> code;
+
+        // Written by the worker thread under the lock of the queue, use IsDone to read them.
+        bool done = false;
+        std::unique_ptr<ErrorData> error;
+    };
+
+    // Validates the SPIR-V of the shader modules created with createShaderModuleAsync on worker
+    // threads, so that the device tick creating the modules only reflects them. The device is
+    // asked for a tick each time a validation completes.
+    class ShaderModuleValidationQueue {
+      public:
+        ShaderModuleValidationQueue(DeviceBase* device, uint32_t threadCount);
+        // The tasks which didn't start are dropped, the destructor waits for the running ones.
+        ~ShaderModuleValidationQueue();
+
+        std::shared_ptr<ShaderModuleValidationTask> Enqueue(std::vector<uint32_t> code);
+        // Once this returned true the worker threads don't access the task anymore.
+        bool IsDone(const ShaderModuleValidationTask& task);
+
+      private:
+        void WorkerLoop();
+
+        DeviceBase* mDevice;
+        std::vector<std::thread> mThreads;
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<std::shared_ptr<ShaderModuleValidationTask>> mPendingTasks;
+        bool mStopping = false;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_SHADERMODULEVALIDATIONQUEUE_H_
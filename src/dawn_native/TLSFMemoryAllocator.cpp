@@ -0,0 +1,377 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/TLSFMemoryAllocator.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+#include "dawn_native/ResourceHeapAllocator.h"
+
+namespace dawn_native {
+
+    namespace {
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+            ASSERT(IsPowerOfTwo(alignment));
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        uint32_t ScanForward64(uint64_t bits) {
+            ASSERT(bits != 0);
+            uint32_t lowBits = static_cast<uint32_t>(bits);
+            if (lowBits != 0) {
+                return ScanForward(lowBits);
+            }
+            return 32 + ScanForward(static_cast<uint32_t>(bits >> 32));
+        }
+
+    }  // anonymous namespace
+
+    constexpr uint64_t TLSFMemoryAllocator::kInvalidHeapIndex;
+    constexpr uint64_t TLSFMemoryAllocator::kInvalidOffset;
+
+    TLSFMemoryAllocator::TLSFMemoryAllocator(uint64_t heapSize,
+                                             uint64_t blockGranularity,
+                                             ResourceHeapAllocator* heapAllocator)
+        : mHeapSize(heapSize), mBlockGranularity(blockGranularity), mHeapAllocator(heapAllocator) {
+        ASSERT(IsPowerOfTwo(mBlockGranularity));
+        ASSERT(mHeapSize % mBlockGranularity == 0);
+
+        for (std::array<uint64_t, kSecondLevelCount>& freeLists : mFreeLists) {
+            freeLists.fill(kInvalidOffset);
+        }
+    }
+
+    TLSFMemoryAllocator::~TLSFMemoryAllocator() = default;
+
+    // static
+    void TLSFMemoryAllocator::GetBin(uint64_t size, uint32_t* firstLevel, uint32_t* secondLevel) {
+        // Sizes smaller than the number of second level bins all go in the first first level bin
+        // with one second level bin per size.
+        if (size < kSecondLevelCount) {
+            *firstLevel = 0;
+            *secondLevel = static_cast<uint32_t>(size);
+            return;
+        }
+
+        uint32_t log2Size = Log2(size);
+        *firstLevel = log2Size - kSecondLevelLog2 + 1;
+        *secondLevel =
+            static_cast<uint32_t>(size >> (log2Size - kSecondLevelLog2)) - kSecondLevelCount;
+    }
+
+    void TLSFMemoryAllocator::InsertFreeBlock(uint64_t offset, uint64_t size) {
+        uint32_t firstLevel;
+        uint32_t secondLevel;
+        GetBin(size, &firstLevel, &secondLevel);
+
+        uint64_t& head = mFreeLists[firstLevel][secondLevel];
+
+        Block& block = mBlocks[offset];
+        block.size = size;
+        block.isFree = true;
+        block.prevFree = kInvalidOffset;
+        block.nextFree = head;
+        if (head != kInvalidOffset) {
+            mBlocks[head].prevFree = offset;
+        }
+        head = offset;
+
+        mFirstLevelBitmap |= uint64_t(1) << firstLevel;
+        mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    }
+
+    void TLSFMemoryAllocator::RemoveFreeBlock(uint64_t offset) {
+        Block& block = mBlocks[offset];
+        ASSERT(block.isFree);
+
+        uint32_t firstLevel;
+        uint32_t secondLevel;
+        GetBin(block.size, &firstLevel, &secondLevel);
+
+        if (block.prevFree != kInvalidOffset) {
+            mBlocks[block.prevFree].nextFree = block.nextFree;
+        } else {
+            ASSERT(mFreeLists[firstLevel][secondLevel] == offset);
+            mFreeLists[firstLevel][secondLevel] = block.nextFree;
+        }
+        if (block.nextFree != kInvalidOffset) {
+            mBlocks[block.nextFree].prevFree = block.prevFree;
+        }
+
+        if (mFreeLists[firstLevel][secondLevel] == kInvalidOffset) {
+            mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (mSecondLevelBitmaps[firstLevel] == 0) {
+                mFirstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+            }
+        }
+
+        block.isFree = false;
+        block.prevFree = kInvalidOffset;
+        block.nextFree = kInvalidOffset;
+    }
+
+    uint64_t TLSFMemoryAllocator::FindFreeBlock(uint64_t size,
+                                                uint64_t alignment,
+                                                uint64_t excludedHeapIndex) const {
+        // Free blocks start at a multiple of the granularity, so aligning them wastes at most
+        // the alignment minus the granularity.
+        uint64_t searchSize = size;
+        if (alignment > mBlockGranularity) {
+            searchSize += alignment - mBlockGranularity;
+        }
+
+        // Round the size up to the next bin so that any free block of the bins searched is large
+        // enough.
+        if (searchSize >= kSecondLevelCount) {
+            searchSize += (uint64_t(1) << (Log2(searchSize) - kSecondLevelLog2)) - 1;
+        }
+
+        uint32_t firstLevel;
+        uint32_t secondLevel;
+        GetBin(searchSize, &firstLevel, &secondLevel);
+        if (firstLevel >= kFirstLevelCount) {
+            return kInvalidOffset;
+        }
+
+        uint32_t secondLevelBitmap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        while (true) {
+            if (secondLevelBitmap == 0) {
+                uint64_t firstLevelBitmap = 0;
+                if (firstLevel + 1 < kFirstLevelCount) {
+                    firstLevelBitmap = mFirstLevelBitmap & (~uint64_t(0) << (firstLevel + 1));
+                }
+                if (firstLevelBitmap == 0) {
+                    return kInvalidOffset;
+                }
+                firstLevel = ScanForward64(firstLevelBitmap);
+                secondLevelBitmap = mSecondLevelBitmaps[firstLevel];
+            }
+
+            secondLevel = ScanForward(secondLevelBitmap);
+            for (uint64_t offset = mFreeLists[firstLevel][secondLevel]; offset != kInvalidOffset;
+                 offset = mBlocks.at(offset).nextFree) {
+                if (excludedHeapIndex == kInvalidHeapIndex ||
+                    offset / mHeapSize != excludedHeapIndex) {
+                    return offset;
+                }
+            }
+            secondLevelBitmap &= ~(1u << secondLevel);
+        }
+    }
+
+    MaybeError TLSFMemoryAllocator::CreateHeap() {
+        std::unique_ptr<ResourceHeapBase> resourceHeap;
+        DAWN_TRY_ASSIGN(resourceHeap, mHeapAllocator->AllocateResourceHeap(mHeapSize));
+
+        uint64_t heapIndex;
+        if (!mReleasedHeapIndices.empty()) {
+            heapIndex = mReleasedHeapIndices.back();
+            mReleasedHeapIndices.pop_back();
+        } else {
+            heapIndex = mHeaps.size();
+            mHeaps.emplace_back();
+        }
+
+        Heap& heap = mHeaps[heapIndex];
+        heap.resourceHeap = std::move(resourceHeap);
+        heap.usedSize = 0;
+        heap.allocationCount = 0;
+
+        InsertFreeBlock(heapIndex * mHeapSize, mHeapSize);
+        return {};
+    }
+
+    ResultOrError<ResourceMemoryAllocation> TLSFMemoryAllocator::Allocate(
+        uint64_t allocationSize,
+        uint64_t alignment,
+        uint64_t excludedHeapIndex) {
+        ResourceMemoryAllocation invalidAllocation = ResourceMemoryAllocation{};
+
+        if (allocationSize == 0) {
+            return invalidAllocation;
+        }
+
+        const uint64_t requestedSize = allocationSize;
+        ASSERT(IsPowerOfTwo(alignment));
+        allocationSize = AlignUp(allocationSize, mBlockGranularity);
+
+        // Allocation cannot exceed the heap size.
+        if (allocationSize > mHeapSize || alignment > mHeapSize) {
+            return invalidAllocation;
+        }
+
+        uint64_t freeOffset = FindFreeBlock(allocationSize, alignment, excludedHeapIndex);
+        if (freeOffset == kInvalidOffset) {
+            // Relocations out of a heap must not grow the allocator.
+            if (excludedHeapIndex != kInvalidHeapIndex) {
+                return invalidAllocation;
+            }
+            DAWN_TRY(CreateHeap());
+            freeOffset = FindFreeBlock(allocationSize, alignment, kInvalidHeapIndex);
+            ASSERT(freeOffset != kInvalidOffset);
+        }
+
+        const uint64_t freeSize = mBlocks[freeOffset].size;
+        RemoveFreeBlock(freeOffset);
+
+        const uint64_t heapIndex = freeOffset / mHeapSize;
+        const uint64_t heapOffset = heapIndex * mHeapSize;
+        const uint64_t memoryOffset = AlignUp(freeOffset - heapOffset, alignment);
+        const uint64_t blockOffset = heapOffset + memoryOffset;
+
+        // Split the alignment padding and the remainder of the free block off the allocation.
+        const uint64_t paddingSize = blockOffset - freeOffset;
+        ASSERT(paddingSize + allocationSize <= freeSize);
+        if (paddingSize > 0) {
+            InsertFreeBlock(freeOffset, paddingSize);
+        }
+        const uint64_t remainderSize = freeSize - paddingSize - allocationSize;
+        if (remainderSize > 0) {
+            InsertFreeBlock(blockOffset + allocationSize, remainderSize);
+        }
+
+        Block& block = mBlocks[blockOffset];
+        block.size = allocationSize;
+        block.isFree = false;
+
+        Heap& heap = mHeaps[heapIndex];
+        heap.usedSize += allocationSize;
+        heap.allocationCount++;
+        mUsedSize += allocationSize;
+
+        AllocationInfo info;
+        info.mBlockOffset = blockOffset;
+        info.mRequestedSize = requestedSize;
+        info.mMethod = AllocationMethod::kSubAllocated;
+
+        return ResourceMemoryAllocation{info, memoryOffset, heap.resourceHeap.get()};
+    }
+
+    void TLSFMemoryAllocator::Deallocate(const ResourceMemoryAllocation& allocation) {
+        const AllocationInfo info = allocation.GetInfo();
+        ASSERT(info.mMethod == AllocationMethod::kSubAllocated);
+
+        auto it = mBlocks.find(info.mBlockOffset);
+        ASSERT(it != mBlocks.end() && !it->second.isFree);
+
+        const uint64_t heapIndex = info.mBlockOffset / mHeapSize;
+        const uint64_t blockSize = it->second.size;
+
+        Heap& heap = mHeaps[heapIndex];
+        ASSERT(heap.allocationCount > 0);
+        heap.usedSize -= blockSize;
+        heap.allocationCount--;
+        mUsedSize -= blockSize;
+
+        // Empty heaps are handed back right away, along with their single free block.
+        if (heap.allocationCount == 0) {
+            const uint64_t heapOffset = heapIndex * mHeapSize;
+            for (auto block = mBlocks.lower_bound(heapOffset);
+                 block != mBlocks.end() && block->first < heapOffset + mHeapSize;) {
+                if (block->second.isFree) {
+                    RemoveFreeBlock(block->first);
+                }
+                block = mBlocks.erase(block);
+            }
+
+            mHeapAllocator->DeallocateResourceHeap(std::move(heap.resourceHeap));
+            mReleasedHeapIndices.push_back(heapIndex);
+            return;
+        }
+
+        // Coalesce the block with its free neighbors in the same heap.
+        uint64_t freeOffset = it->first;
+        uint64_t freeSize = blockSize;
+
+        auto next = std::next(it);
+        if (next != mBlocks.end() && next->first / mHeapSize == heapIndex && next->second.isFree) {
+            freeSize += next->second.size;
+            RemoveFreeBlock(next->first);
+            mBlocks.erase(next);
+        }
+
+        if (it != mBlocks.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first / mHeapSize == heapIndex && prev->second.isFree) {
+                freeOffset = prev->first;
+                freeSize += prev->second.size;
+                RemoveFreeBlock(prev->first);
+                mBlocks.erase(it);
+            }
+        }
+
+        InsertFreeBlock(freeOffset, freeSize);
+    }
+
+    uint64_t TLSFMemoryAllocator::GetHeapSize() const {
+        return mHeapSize;
+    }
+
+    uint64_t TLSFMemoryAllocator::GetHeapIndex(const ResourceMemoryAllocation& allocation) const {
+        ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated);
+        return allocation.GetInfo().mBlockOffset / mHeapSize;
+    }
+
+    uint64_t TLSFMemoryAllocator::GetDefragmentationCandidate() const {
+        uint64_t candidate = kInvalidHeapIndex;
+        uint64_t heapCount = 0;
+        for (uint64_t i = 0; i < mHeaps.size(); ++i) {
+            if (mHeaps[i].resourceHeap == nullptr) {
+                continue;
+            }
+            heapCount++;
+            if (candidate == kInvalidHeapIndex ||
+                mHeaps[i].usedSize < mHeaps[candidate].usedSize) {
+                candidate = i;
+            }
+        }
+
+        if (heapCount < 2) {
+            return kInvalidHeapIndex;
+        }
+
+        // Only consider heaps that are at most half full, denser heaps aren't worth the copies.
+        const uint64_t candidateUsedSize = mHeaps[candidate].usedSize;
+        if (candidateUsedSize > mHeapSize / 2) {
+            return kInvalidHeapIndex;
+        }
+
+        const uint64_t totalFreeSize = heapCount * mHeapSize - mUsedSize;
+        const uint64_t otherFreeSize = totalFreeSize - (mHeapSize - candidateUsedSize);
+        if (candidateUsedSize > otherFreeSize) {
+            return kInvalidHeapIndex;
+        }
+        return candidate;
+    }
+
+    uint64_t TLSFMemoryAllocator::GetUsedSize() const {
+        return mUsedSize;
+    }
+
+    uint64_t TLSFMemoryAllocator::GetAllocatedHeapSize() const {
+        return (mHeaps.size() - mReleasedHeapIndices.size()) * mHeapSize;
+    }
+
+    uint64_t TLSFMemoryAllocator::ComputeTotalNumOfHeapsForTesting() const {
+        uint64_t count = 0;
+        for (const Heap& heap : mHeaps) {
+            if (heap.resourceHeap != nullptr) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+}  // namespace dawn_native
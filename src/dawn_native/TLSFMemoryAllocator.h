@@ -0,0 +1,125 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_TLSFMEMORYALLOCATOR_H_
+#define DAWNNATIVE_TLSFMEMORYALLOCATOR_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/ResourceMemoryAllocation.h"
+
+#include <array>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace dawn_native {
+
+    class ResourceHeapAllocator;
+
+    // TLSFMemoryAllocator sub-allocates blocks of device memory created by ResourceHeapAllocator
+    // clients using a two-level segregated fit allocator. Unlike the buddy allocator, the
+    // allocations are not rounded up to a power of two: each allocation takes exactly its size,
+    // rounded up to the block granularity, and the free ranges around it are coalesced on
+    // deallocation.
+    //
+    // The free blocks are binned in size classes: the first level is the power of two of the
+    // size, the second level linearly subdivides each power of two. Bitmaps of the non-empty
+    // bins find a free block that is large enough in constant time.
+    //
+    // All the heaps have the same size. Heaps are created when no free block is large enough and
+    // handed back to the ResourceHeapAllocator as soon as they are empty. As with
+    // BuddyMemoryAllocator, the block offset of the allocations is global to the allocator while
+    // the allocation offset is local to the heap.
+    class TLSFMemoryAllocator {
+      public:
+        static constexpr uint64_t kInvalidHeapIndex = std::numeric_limits<uint64_t>::max();
+
+        // |blockGranularity| must be a power of two dividing |heapSize|.
+        TLSFMemoryAllocator(uint64_t heapSize,
+                            uint64_t blockGranularity,
+                            ResourceHeapAllocator* heapAllocator);
+        ~TLSFMemoryAllocator();
+
+        // Returns an invalid allocation when |allocationSize| is larger than the heaps. When
+        // |excludedHeapIndex| is given, the allocation is only placed in the other existing heaps
+        // and no new heap is created.
+        ResultOrError<ResourceMemoryAllocation> Allocate(
+            uint64_t allocationSize,
+            uint64_t alignment,
+            uint64_t excludedHeapIndex = kInvalidHeapIndex);
+        void Deallocate(const ResourceMemoryAllocation& allocation);
+
+        uint64_t GetHeapSize() const;
+        uint64_t GetHeapIndex(const ResourceMemoryAllocation& allocation) const;
+
+        // Returns the sparsest heap if its allocations fit in the free space of the other heaps,
+        // so that moving them out would release it, otherwise returns kInvalidHeapIndex.
+        uint64_t GetDefragmentationCandidate() const;
+
+        uint64_t GetUsedSize() const;
+        // The size of the heaps currently allocated, which is larger than the used size when the
+        // heaps are fragmented.
+        uint64_t GetAllocatedHeapSize() const;
+
+        // For testing purposes.
+        uint64_t ComputeTotalNumOfHeapsForTesting() const;
+
+      private:
+        static constexpr uint64_t kInvalidOffset = std::numeric_limits<uint64_t>::max();
+
+        static constexpr uint32_t kSecondLevelLog2 = 4;
+        static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+        static constexpr uint32_t kFirstLevelCount = 64 - kSecondLevelLog2 + 1;
+
+        struct Block {
+            uint64_t size = 0;
+            bool isFree = false;
+            // Links of the free list of the block's bin, only used by free blocks.
+            uint64_t prevFree = kInvalidOffset;
+            uint64_t nextFree = kInvalidOffset;
+        };
+
+        struct Heap {
+            std::unique_ptr<ResourceHeapBase> resourceHeap;
+            uint64_t usedSize = 0;
+            uint64_t allocationCount = 0;
+        };
+
+        static void GetBin(uint64_t size, uint32_t* firstLevel, uint32_t* secondLevel);
+
+        void InsertFreeBlock(uint64_t offset, uint64_t size);
+        void RemoveFreeBlock(uint64_t offset);
+        uint64_t FindFreeBlock(uint64_t size, uint64_t alignment, uint64_t excludedHeapIndex) const;
+        MaybeError CreateHeap();
+
+        uint64_t mHeapSize;
+        uint64_t mBlockGranularity;
+        ResourceHeapAllocator* mHeapAllocator;
+
+        // All the blocks, free or allocated, keyed by their global offset.
+        std::map<uint64_t, Block> mBlocks;
+
+        uint64_t mFirstLevelBitmap = 0;
+        std::array<uint32_t, kFirstLevelCount> mSecondLevelBitmaps = {};
+        std::array<std::array<uint64_t, kSecondLevelCount>, kFirstLevelCount> mFreeLists;
+
+        std::vector<Heap> mHeaps;
+        std::vector<uint64_t> mReleasedHeapIndices;
+        uint64_t mUsedSize = 0;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_TLSFMEMORYALLOCATOR_H_
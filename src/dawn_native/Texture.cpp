@@ -18,6 +18,7 @@
 
 #include "common/Assert.h"
 #include "common/Constants.h"
+#include "common/HashUtils.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
 #include "dawn_native/ValidationUtils_autogen.h"
@@ -194,9 +195,73 @@ namespace dawn_native {
                 return DAWN_VALIDATION_ERROR("Format cannot be used in storage textures");
             }
 
+            if ((descriptor->usage & wgpu::TextureUsage::Transient) &&
+                (descriptor->usage & wgpu::TextureUsage::Present)) {
+                return DAWN_VALIDATION_ERROR("Transient textures cannot be presented");
+            }
+
+            // The contents of transient attachments never leave the tile memory of the render
+            // passes, so they can't be used in any other way.
+            if ((descriptor->usage & wgpu::TextureUsage::TransientAttachment) &&
+                (descriptor->usage & ~(wgpu::TextureUsage::TransientAttachment |
+                                       wgpu::TextureUsage::OutputAttachment)) !=
+                    wgpu::TextureUsage::None) {
+                return DAWN_VALIDATION_ERROR(
+                    "Transient attachments can only have the OutputAttachment usage");
+            }
+            if ((descriptor->usage & wgpu::TextureUsage::TransientAttachment) &&
+                !(descriptor->usage & wgpu::TextureUsage::OutputAttachment)) {
+                return DAWN_VALIDATION_ERROR(
+                    "Transient attachments must have the OutputAttachment usage");
+            }
+
+            return {};
+        }
+
+        MaybeError ValidateSparseTexture(const DeviceBase* device,
+                                         const TextureDescriptor* descriptor,
+                                         const Format* format) {
+            if (!device->IsExtensionEnabled(Extension::SparseResources)) {
+                return DAWN_VALIDATION_ERROR("The sparse_resources extension is not enabled");
+            }
+
+            if (descriptor->usage & (wgpu::TextureUsage::Transient | wgpu::TextureUsage::Present)) {
+                return DAWN_VALIDATION_ERROR("Sparse textures can't be transient or presented");
+            }
+
+            if (descriptor->sampleCount != 1 || format->HasDepthOrStencil()) {
+                return DAWN_VALIDATION_ERROR(
+                    "Sparse textures can't be multisampled or have a depth-stencil format");
+            }
+
+            // Backends would pack the mip levels smaller than a tile in a mip tail which can only
+            // be mapped as a whole, so all the mip levels must be made of whole tiles instead.
+            Extent3D tileExtent = GetSparseTileExtent(*format);
+            uint32_t lastLevel = descriptor->mipLevelCount - 1;
+            if (descriptor->size.width % (tileExtent.width << lastLevel) != 0 ||
+                descriptor->size.height % (tileExtent.height << lastLevel) != 0) {
+                return DAWN_VALIDATION_ERROR(
+                    "All the mip levels of sparse textures must be multiples of the tile size");
+            }
+
             return {};
         }
 
+        // The size of the texels of all the subresources, which the backends pad and align.
+        uint64_t ComputeEstimatedTextureSize(const Format& format,
+                                             const TextureDescriptor* descriptor) {
+            uint64_t size = 0;
+            for (uint32_t level = 0; level < descriptor->mipLevelCount; ++level) {
+                uint32_t width = std::max(descriptor->size.width >> level, 1u);
+                uint32_t height = std::max(descriptor->size.height >> level, 1u);
+                uint64_t blocksPerRow = (width + format.blockWidth - 1) / format.blockWidth;
+                uint64_t rowCount = (height + format.blockHeight - 1) / format.blockHeight;
+                uint64_t blockCount = blocksPerRow * rowCount;
+                size += blockCount * format.blockByteSize * descriptor->size.depth;
+            }
+            return size * descriptor->arrayLayerCount * descriptor->sampleCount;
+        }
+
     }  // anonymous namespace
 
     MaybeError ValidateTextureDescriptor(const DeviceBase* device,
@@ -228,9 +293,26 @@ namespace dawn_native {
 
         DAWN_TRY(ValidateTextureSize(descriptor, format));
 
+        if (descriptor->usage & wgpu::TextureUsage::Sparse) {
+            DAWN_TRY(ValidateSparseTexture(device, descriptor, format));
+        }
+
+        DAWN_TRY(ValidateResidencyPriority(descriptor->residencyPriority));
+
         return {};
     }
 
+    Extent3D GetSparseTileExtent(const Format& format) {
+        // The tiles are as square as possible in blocks, which are the standard tile shapes of
+        // D3D12 and the standard sparse block shapes of Vulkan.
+        ASSERT(IsPowerOfTwo(format.blockByteSize));
+        uint32_t blockCountLog2 =
+            Log2(static_cast<uint32_t>(kSparseTileSize / format.blockByteSize));
+        uint32_t widthInBlocks = 1u << ((blockCountLog2 + 1) / 2);
+        uint32_t heightInBlocks = (1u << blockCountLog2) / widthInBlocks;
+        return {widthInBlocks * format.blockWidth, heightInBlocks * format.blockHeight, 1};
+    }
+
     MaybeError ValidateTextureViewDescriptor(const TextureBase* texture,
                                              const TextureViewDescriptor* descriptor) {
         if (descriptor->nextInChain != nullptr) {
@@ -349,10 +431,22 @@ namespace dawn_native {
           mMipLevelCount(descriptor->mipLevelCount),
           mSampleCount(descriptor->sampleCount),
           mUsage(descriptor->usage),
+          mResidencyPriority(descriptor->residencyPriority),
           mState(state) {
         uint32_t subresourceCount =
             GetSubresourceIndex(descriptor->mipLevelCount, descriptor->arrayLayerCount);
-        mIsSubresourceContentInitializedAtIndex = std::vector<bool>(subresourceCount, false);
+        // The tiles of sparse textures are undefined until they are written after being made
+        // resident, so sparse textures aren't lazily cleared.
+        mIsSubresourceContentInitializedAtIndex =
+            std::vector<bool>(subresourceCount, IsSparse());
+
+        // Wrapped textures don't use memory of the device, and the tiles of sparse textures are
+        // accounted for by the memory they are bound to.
+        if (state == TextureState::OwnedInternal) {
+            mTrackedMemory.Track(
+                device, TrackedObjectType::Texture,
+                IsSparse() ? 0 : ComputeEstimatedTextureSize(mFormat, descriptor));
+        }
     }
 
     static Format kUnusedFormat;
@@ -396,6 +490,25 @@ namespace dawn_native {
         ASSERT(!IsError());
         return mUsage;
     }
+    bool TextureBase::IsTransient() const {
+        ASSERT(!IsError());
+        return mUsage & wgpu::TextureUsage::Transient;
+    }
+
+    bool TextureBase::IsTransientAttachment() const {
+        ASSERT(!IsError());
+        return mUsage & wgpu::TextureUsage::TransientAttachment;
+    }
+
+    bool TextureBase::IsSparse() const {
+        ASSERT(!IsError());
+        return mUsage & wgpu::TextureUsage::Sparse;
+    }
+
+    wgpu::ResidencyPriority TextureBase::GetResidencyPriority() const {
+        ASSERT(!IsError());
+        return mResidencyPriority;
+    }
 
     TextureBase::TextureState TextureBase::GetTextureState() const {
         ASSERT(!IsError());
@@ -497,11 +610,36 @@ namespace dawn_native {
     void TextureBase::DestroyImpl() {
     }
 
+    void TextureBase::SetResidencyPriority(wgpu::ResidencyPriority priority) {
+        if (GetDevice()->ConsumedError(ValidateSetResidencyPriority(priority))) {
+            return;
+        }
+        ASSERT(!IsError());
+
+        bool changed = priority != mResidencyPriority;
+        mResidencyPriority = priority;
+        if (changed && mState == TextureState::OwnedInternal) {
+            GetDevice()->ConsumedError(SetResidencyPriorityImpl());
+        }
+    }
+
+    MaybeError TextureBase::SetResidencyPriorityImpl() {
+        return {};
+    }
+
     void TextureBase::DestroyInternal() {
+        mTrackedMemory.Untrack();
         DestroyImpl();
         mState = TextureState::Destroyed;
     }
 
+    MaybeError TextureBase::ValidateSetResidencyPriority(wgpu::ResidencyPriority priority) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+        DAWN_TRY(ValidateResidencyPriority(priority));
+        return {};
+    }
+
     MaybeError TextureBase::ValidateDestroy() const {
         DAWN_TRY(GetDevice()->ValidateObject(this));
         return {};
@@ -510,7 +648,7 @@ namespace dawn_native {
     // TextureViewBase
 
     TextureViewBase::TextureViewBase(TextureBase* texture, const TextureViewDescriptor* descriptor)
-        : ObjectBase(texture->GetDevice()),
+        : CachedObject(texture->GetDevice()),
           mTexture(texture),
           mFormat(GetDevice()->GetValidInternalFormat(descriptor->format)),
           mDimension(descriptor->dimension),
@@ -521,7 +659,13 @@ namespace dawn_native {
     }
 
     TextureViewBase::TextureViewBase(DeviceBase* device, ObjectBase::ErrorTag tag)
-        : ObjectBase(device, tag), mFormat(kUnusedFormat) {
+        : CachedObject(device, tag), mFormat(kUnusedFormat) {
+    }
+
+    TextureViewBase::~TextureViewBase() {
+        if (IsCachedReference()) {
+            GetDevice()->UncacheTextureView(this);
+        }
     }
 
     // static
@@ -568,4 +712,26 @@ namespace dawn_native {
         ASSERT(!IsError());
         return mArrayLayerCount;
     }
+    size_t TextureViewBase::HashFunc::operator()(const TextureViewBase* view) const {
+        size_t hash = 0;
+
+        HashCombine(&hash, view->mTexture.Get());
+        HashCombine(&hash, view->mFormat.format);
+        HashCombine(&hash, view->mDimension);
+        HashCombine(&hash, view->mBaseMipLevel);
+        HashCombine(&hash, view->mMipLevelCount);
+        HashCombine(&hash, view->mBaseArrayLayer);
+        HashCombine(&hash, view->mArrayLayerCount);
+
+        return hash;
+    }
+
+    bool TextureViewBase::EqualityFunc::operator()(const TextureViewBase* a,
+                                                   const TextureViewBase* b) const {
+        return a->mTexture.Get() == b->mTexture.Get() && a->mFormat.format == b->mFormat.format &&
+               a->mDimension == b->mDimension && a->mBaseMipLevel == b->mBaseMipLevel &&
+               a->mMipLevelCount == b->mMipLevelCount && a->mBaseArrayLayer == b->mBaseArrayLayer &&
+               a->mArrayLayerCount == b->mArrayLayerCount;
+    }
+
 }  // namespace dawn_native
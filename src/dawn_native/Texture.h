@@ -15,8 +15,10 @@
 #ifndef DAWNNATIVE_TEXTURE_H_
 #define DAWNNATIVE_TEXTURE_H_
 
+#include "dawn_native/CachedObject.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/Forward.h"
+#include "dawn_native/MemoryUsageTracker.h"
 #include "dawn_native/ObjectBase.h"
 
 #include "dawn_native/dawn_platform.h"
@@ -34,6 +36,9 @@ namespace dawn_native {
 
     bool IsValidSampleCount(uint32_t sampleCount);
 
+    // The size in texels of the tiles of the sparse textures with the format.
+    Extent3D GetSparseTileExtent(const Format& format);
+
     static constexpr wgpu::TextureUsage kReadOnlyTextureUsages =
         wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::Sampled | wgpu::TextureUsage::Present;
 
@@ -56,6 +61,18 @@ namespace dawn_native {
         uint32_t GetNumMipLevels() const;
         uint32_t GetSampleCount() const;
         wgpu::TextureUsage GetUsage() const;
+        // Transient textures are destroyed once the command buffer using them is submitted so
+        // that backends can reuse their memory for other transient resources right away.
+        bool IsTransient() const;
+        // Transient attachments are only ever cleared and discarded by render passes, so that
+        // backends can keep their contents in tile memory without backing them in device memory.
+        bool IsTransientAttachment() const;
+        // The memory of sparse textures is bound in tiles with Queue::UpdateTextureTileMappings.
+        // Accesses to the tiles that aren't resident are discarded or read undefined values.
+        bool IsSparse() const;
+        // How much the backends should keep the memory of the texture resident when the device
+        // memory is oversubscribed.
+        wgpu::ResidencyPriority GetResidencyPriority() const;
         TextureState GetTextureState() const;
         uint32_t GetSubresourceIndex(uint32_t mipLevel, uint32_t arraySlice) const;
         bool IsSubresourceContentInitialized(uint32_t baseMipLevel,
@@ -82,6 +99,7 @@ namespace dawn_native {
 
         // Dawn API
         TextureViewBase* CreateView(const TextureViewDescriptor* descriptor);
+        void SetResidencyPriority(wgpu::ResidencyPriority priority);
         void Destroy();
 
       protected:
@@ -90,7 +108,11 @@ namespace dawn_native {
       private:
         TextureBase(DeviceBase* device, ObjectBase::ErrorTag tag);
         virtual void DestroyImpl();
+        // Applies GetResidencyPriority() to the memory of the texture, which is owned by Dawn and
+        // isn't destroyed. The default implementation only uses the priority at creation.
+        virtual MaybeError SetResidencyPriorityImpl();
 
+        MaybeError ValidateSetResidencyPriority(wgpu::ResidencyPriority priority) const;
         MaybeError ValidateDestroy() const;
         wgpu::TextureDimension mDimension;
         // TODO(cwallez@chromium.org): This should be deduplicated in the Device
@@ -100,15 +122,20 @@ namespace dawn_native {
         uint32_t mMipLevelCount;
         uint32_t mSampleCount;
         wgpu::TextureUsage mUsage = wgpu::TextureUsage::None;
+        wgpu::ResidencyPriority mResidencyPriority = wgpu::ResidencyPriority::Normal;
         TextureState mState;
+        TrackedMemory mTrackedMemory;
 
         // TODO(natlee@microsoft.com): Use a more optimized data structure to save space
         std::vector<bool> mIsSubresourceContentInitializedAtIndex;
     };
 
-    class TextureViewBase : public ObjectBase {
+    // Views are deduplicated in the device cache, so that creating a view equal to one that is
+    // still alive returns that view instead of a new backend view.
+    class TextureViewBase : public CachedObject {
       public:
         TextureViewBase(TextureBase* texture, const TextureViewDescriptor* descriptor);
+        ~TextureViewBase() override;
 
         static TextureViewBase* MakeError(DeviceBase* device);
 
@@ -122,6 +149,14 @@ namespace dawn_native {
         uint32_t GetBaseArrayLayer() const;
         uint32_t GetLayerCount() const;
 
+        // Functors necessary for the ContentLessObjectCache<TextureViewBase>.
+        struct HashFunc {
+            size_t operator()(const TextureViewBase* view) const;
+        };
+        struct EqualityFunc {
+            bool operator()(const TextureViewBase* a, const TextureViewBase* b) const;
+        };
+
       private:
         TextureViewBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
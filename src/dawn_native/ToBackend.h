@@ -63,6 +63,11 @@ namespace dawn_native {
         using BackendType = typename BackendTraits::PipelineLayoutType;
     };
 
+    template <typename BackendTraits>
+    struct ToBackendTraits<QuerySetBase, BackendTraits> {
+        using BackendType = typename BackendTraits::QuerySetType;
+    };
+
     template <typename BackendTraits>
     struct ToBackendTraits<QueueBase, BackendTraits> {
         using BackendType = typename BackendTraits::QueueType;
@@ -93,6 +98,11 @@ namespace dawn_native {
         using BackendType = typename BackendTraits::ResourceHeapType;
     };
 
+    template <typename BackendTraits>
+    struct ToBackendTraits<ResourceTableBase, BackendTraits> {
+        using BackendType = typename BackendTraits::ResourceTableType;
+    };
+
     template <typename BackendTraits>
     struct ToBackendTraits<SamplerBase, BackendTraits> {
         using BackendType = typename BackendTraits::SamplerType;
@@ -42,7 +42,8 @@ namespace dawn_native {
              {"nonzero_clear_resources_on_creation_for_testing",
               "Clears texture to full 1 bits as soon as they are created, but doesn't update "
               "the tracking state of the texture. This way we can test the logic of clearing "
-              "textures that use recycled memory.",
+              "textures that use recycled memory. Also fills the mapped data of buffers created "
+              "with mappedDataFullyWritten with 1 bits instead of leaving it uninitialized.",
               "https://crbug.com/dawn/145"}},
             {Toggle::AlwaysResolveIntoZeroLevelAndLayer,
              {"always_resolve_into_zero_level_and_layer",
@@ -83,9 +84,46 @@ namespace dawn_native {
               "versions of Windows prior to build 1809, or when this toggle is turned off, Dawn "
               "will emulate a render pass.",
               "https://crbug.com/dawn/36"}},
+            {Toggle::UseDXC,
+             {"use_dxc",
+              "Use DXC instead of FXC to compile the HLSL shaders on D3D12, targeting shader model "
+              "6.0. This is ignored when dxcompiler.dll and dxil.dll can't be loaded.",
+              ""}},
             {Toggle::SkipValidation,
              {"skip_validation", "Skip expensive validation of Dawn commands.",
               "https://crbug.com/dawn/271"}},
+            {Toggle::SkipDrawStateValidation,
+             {"skip_draw_state_validation",
+              "Skip the validation that a pipeline, the vertex buffers and the index buffer are set "
+              "before draws, dispatches and ray traces.",
+              "https://crbug.com/dawn/271"}},
+            {Toggle::SkipResourceUsageValidation,
+             {"skip_resource_usage_validation",
+              "Skip the validation that the resources used in a pass aren't both written and used "
+              "in another way. The usages are still tracked for the backends.",
+              "https://crbug.com/dawn/271"}},
+            {Toggle::SkipCopyBoundsValidation,
+             {"skip_copy_bounds_validation",
+              "Skip the validation that copy regions fit in their textures. Copies are still "
+              "validated to fit in their buffers.",
+              "https://crbug.com/dawn/271"}},
+            {Toggle::SkipBindGroupCompatibilityValidation,
+             {"skip_bind_group_compatibility_validation",
+              "Skip the validation that the bind groups set are compatible with the layout of the "
+              "current pipeline.",
+              "https://crbug.com/dawn/271"}},
+            {Toggle::CacheBindGroups,
+             {"cache_bind_groups",
+              "Return an existing bind group when a bind group with the same layout and bindings "
+              "is created, instead of creating a new backend object. The bind groups are cached "
+              "as long as they are referenced.",
+              ""}},
+            {Toggle::SingleThreadedRefCounting,
+             {"single_threaded_ref_counting",
+              "Declare that the device and its objects are only used from one thread at a time. "
+              "The objects then update their refcounts without atomic operations, which speeds "
+              "up command recording. Disables the recording of render passes on worker threads.",
+              ""}},
             {Toggle::UseSpvc,
              {"use_spvc",
               "Enable use of spvc for shader compilation, instead of accessing spirv_cross "
@@ -96,16 +134,63 @@ namespace dawn_native {
               "Enable usage of spvc's internal parsing and IR generation code, instead of "
               "spirv_cross's.",
               "https://crbug.com/dawn/288"}},
+            {Toggle::ValidateIndirectArgumentsOnGPU,
+             {"validate_indirect_arguments_on_gpu",
+              "Clamp the arguments of indirect dispatches and indexed draws in a compute pass "
+              "inserted before the pass that uses them, so that the content of indirect buffers "
+              "doesn't need to be trusted or read back.",
+              ""}},
+            {Toggle::ValidateShaderModulesOnWorkerThreads,
+             {"validate_shader_modules_on_worker_threads",
+              "Validate the SPIR-V of the shader modules created with createShaderModuleAsync on "
+              "worker threads instead of during the device tick, so that creating many modules "
+              "doesn't stall the thread ticking the device.",
+              ""}},
             {Toggle::VulkanUseD32S8,
              {"vulkan_use_d32s8",
               "Vulkan mandates support of either D32_FLOAT_S8 or D24_UNORM_S8. When available the "
               "backend will use D32S8 (toggle to on) but setting the toggle to off will make it"
               "use the D24S8 format when possible.",
               "https://crbug.com/dawn/286"}},
+            {Toggle::VulkanUseAsyncComputeForAccelerationContainerBuilds,
+             {"vulkan_use_async_compute_for_acceleration_container_builds",
+              "Build bottom-level acceleration containers on a dedicated compute queue when the "
+              "device exposes one, so that the builds overlap with the graphics work submitted "
+              "after them. Falls back to the graphics queue otherwise.",
+              ""}},
+            {Toggle::VulkanRecordRenderPassesInParallel,
+             {"vulkan_record_render_passes_in_parallel",
+              "Record the render passes of the command buffers given to a single submit on worker "
+              "threads, in secondary command buffers executed in submit order. The barriers and "
+              "the other passes are still recorded on the submitting thread.",
+              ""}},
+            {Toggle::VulkanBatchQueueSubmits,
+             {"vulkan_batch_queue_submits",
+              "Record the command buffers of consecutive submits in the same VkCommandBuffer and "
+              "submit it to the VkQueue on the next device tick, fence signal, map request or "
+              "queue flush instead of at each submit.",
+              ""}},
+            {Toggle::VulkanDestroyHandlesOnWorkerThread,
+             {"vulkan_destroy_handles_on_worker_thread",
+              "Destroy the Vulkan handles that are no longer used by the GPU on a dedicated thread "
+              "instead of during the device tick, so that frames releasing many resources don't "
+              "stall on the vkDestroy* calls.",
+              ""}},
+            {Toggle::VulkanResetCommandPoolsOnWorkerThread,
+             {"vulkan_reset_command_pools_on_worker_thread",
+              "Reset the command pools of completed submits on a dedicated thread instead of "
+              "during the device tick, to reduce the CPU overhead of high submit rates.",
+              ""}},
             {Toggle::MetalDisableSamplerCompare,
              {"metal_disable_sampler_compare",
               "Disables the use of sampler compare on Metal. This is unsupported before A9 "
               "processors."}},
+            {Toggle::MetalUseArgumentBuffers,
+             {"metal_use_argument_buffers",
+              "Encode the bind groups that only contain uniform buffers without dynamic offsets, "
+              "samplers and sampled textures in Metal argument buffers, bound with a single call "
+              "per stage. Requires Tier 2 argument buffers and is ignored when using spvc.",
+              ""}},
             {Toggle::DisableBaseVertex,
              {"disable_base_vertex",
               "Disables the use of non-zero base vertex which is unsupported on some platforms."}},
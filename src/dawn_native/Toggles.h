@@ -32,11 +32,26 @@ namespace dawn_native {
         UseTemporaryBufferInCompressedTextureToTextureCopy,
         UseD3D12ResourceHeapTier2,
         UseD3D12RenderPass,
+        UseDXC,
         SkipValidation,
+        SkipDrawStateValidation,
+        SkipResourceUsageValidation,
+        SkipCopyBoundsValidation,
+        SkipBindGroupCompatibilityValidation,
+        CacheBindGroups,
+        SingleThreadedRefCounting,
         UseSpvc,
         UseSpvcParser,
+        ValidateIndirectArgumentsOnGPU,
+        ValidateShaderModulesOnWorkerThreads,
         VulkanUseD32S8,
+        VulkanUseAsyncComputeForAccelerationContainerBuilds,
+        VulkanRecordRenderPassesInParallel,
+        VulkanBatchQueueSubmits,
+        VulkanDestroyHandlesOnWorkerThread,
+        VulkanResetCommandPoolsOnWorkerThread,
         MetalDisableSamplerCompare,
+        MetalUseArgumentBuffers,
         DisableBaseVertex,
         DisableBaseInstance,
 
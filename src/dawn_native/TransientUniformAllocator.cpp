@@ -0,0 +1,152 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/TransientUniformAllocator.h"
+
+#include "common/Assert.h"
+#include "common/Constants.h"
+#include "dawn_native/Buffer.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/Queue.h"
+
+#include <cstring>
+
+namespace dawn_native {
+
+    MaybeError ValidateTransientUniformAllocatorDescriptor(
+        const TransientUniformAllocatorDescriptor* descriptor) {
+        if (descriptor->nextInChain != nullptr) {
+            return DAWN_VALIDATION_ERROR("nextInChain must be nullptr");
+        }
+
+        if (descriptor->size == 0) {
+            return DAWN_VALIDATION_ERROR("Transient uniform allocators can't be empty");
+        }
+
+        // The allocations are aligned for dynamic offsets, a remainder could never be used.
+        if (descriptor->size % kMinDynamicBufferOffsetAlignment != 0) {
+            return DAWN_VALIDATION_ERROR(
+                "Transient uniform allocator size must be a multiple of 256");
+        }
+
+        return {};
+    }
+
+    // static
+    ResultOrError<TransientUniformAllocator*> TransientUniformAllocator::Create(
+        DeviceBase* device,
+        const TransientUniformAllocatorDescriptor* descriptor) {
+        Ref<TransientUniformAllocator> allocator =
+            AcquireRef(new TransientUniformAllocator(device, descriptor->size));
+        DAWN_TRY(allocator->Initialize());
+        return allocator.Detach();
+    }
+
+    TransientUniformAllocator::TransientUniformAllocator(DeviceBase* device, uint64_t size)
+        : ObjectBase(device), mAllocator(size) {
+    }
+
+    TransientUniformAllocator::TransientUniformAllocator(DeviceBase* device,
+                                                         ObjectBase::ErrorTag tag)
+        : ObjectBase(device, tag) {
+    }
+
+    TransientUniformAllocator::~TransientUniformAllocator() {
+        if (!IsError()) {
+            GetDevice()->RemoveTransientUniformAllocator(this);
+        }
+    }
+
+    // static
+    TransientUniformAllocator* TransientUniformAllocator::MakeError(DeviceBase* device) {
+        return new TransientUniformAllocator(device, ObjectBase::kError);
+    }
+
+    MaybeError TransientUniformAllocator::Initialize() {
+        BufferDescriptor descriptor;
+        descriptor.size = mAllocator.GetSize();
+        descriptor.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+        DAWN_TRY_ASSIGN(mBuffer, GetDevice()->CreateInternalBuffer(&descriptor));
+
+        mData.resize(static_cast<size_t>(descriptor.size));
+        GetDevice()->AddTransientUniformAllocator(this);
+        return {};
+    }
+
+    void TransientUniformAllocator::Flush(QueueBase* queue) {
+        ASSERT(!IsError());
+        for (const DirtyRange& range : mDirtyRanges) {
+            queue->WriteBuffer(mBuffer.Get(), range.offset, &mData[range.offset], range.size);
+        }
+        mDirtyRanges.clear();
+    }
+
+    uint64_t TransientUniformAllocator::Allocate(const void* data, uint64_t size) {
+        DeviceBase* device = GetDevice();
+        if (device->ConsumedError(ValidateAllocate(data, size))) {
+            return kInvalidTransientUniformOffset;
+        }
+
+        // The space of the allocations is reused once the commands using them completed.
+        mAllocator.Deallocate(device->GetCompletedCommandSerial());
+
+        uint64_t alignedSize = (size + kMinDynamicBufferOffsetAlignment - 1) &
+                               ~(kMinDynamicBufferOffsetAlignment - 1);
+        uint64_t offset = mAllocator.Allocate(alignedSize, device->GetPendingCommandSerial());
+        if (offset == RingBufferAllocator::kInvalidOffset) {
+            return kInvalidTransientUniformOffset;
+        }
+
+        memcpy(&mData[offset], data, static_cast<size_t>(size));
+
+        // Consecutive allocations are uploaded together, including the padding between them.
+        if (!mDirtyRanges.empty() &&
+            mDirtyRanges.back().offset + mDirtyRanges.back().size == offset) {
+            mDirtyRanges.back().size += alignedSize;
+        } else {
+            mDirtyRanges.push_back({offset, alignedSize});
+        }
+
+        return offset;
+    }
+
+    BufferBase* TransientUniformAllocator::GetBuffer() {
+        if (GetDevice()->ConsumedError(GetDevice()->ValidateObject(this))) {
+            return BufferBase::MakeError(GetDevice());
+        }
+
+        mBuffer->Reference();
+        return mBuffer.Get();
+    }
+
+    MaybeError TransientUniformAllocator::ValidateAllocate(const void* data, uint64_t size) const {
+        DAWN_TRY(GetDevice()->ValidateIsAlive());
+        DAWN_TRY(GetDevice()->ValidateObject(this));
+
+        if (size == 0) {
+            return DAWN_VALIDATION_ERROR("Transient uniform allocations can't be empty");
+        }
+
+        if (size > mAllocator.GetSize()) {
+            return DAWN_VALIDATION_ERROR("Allocation is larger than the transient uniform ring");
+        }
+
+        if (data == nullptr) {
+            return DAWN_VALIDATION_ERROR("data must not be nullptr");
+        }
+
+        return {};
+    }
+
+}  // namespace dawn_native
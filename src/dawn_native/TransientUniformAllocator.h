@@ -0,0 +1,76 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_TRANSIENTUNIFORMALLOCATOR_H_
+#define DAWNNATIVE_TRANSIENTUNIFORMALLOCATOR_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+#include "dawn_native/ObjectBase.h"
+#include "dawn_native/RefCounted.h"
+#include "dawn_native/RingBufferAllocator.h"
+
+#include "dawn_native/dawn_platform.h"
+
+#include <vector>
+
+namespace dawn_native {
+
+    MaybeError ValidateTransientUniformAllocatorDescriptor(
+        const TransientUniformAllocatorDescriptor* descriptor);
+
+    // Sub-allocates the uniforms of draws and dispatches from a ring in a single buffer, which is
+    // bound once with a dynamic offset per draw instead of calling SetSubData for each of them.
+    // The data is kept in a copy on the CPU and uploaded when the queue submits, with one write
+    // per contiguous range of allocations. An allocation can be used by the commands submitted
+    // in the same serial, and its space is reused once they complete.
+    class TransientUniformAllocator final : public ObjectBase {
+      public:
+        static ResultOrError<TransientUniformAllocator*> Create(
+            DeviceBase* device,
+            const TransientUniformAllocatorDescriptor* descriptor);
+        ~TransientUniformAllocator();
+
+        static TransientUniformAllocator* MakeError(DeviceBase* device);
+
+        // Uploads the allocations made since the last flush.
+        void Flush(QueueBase* queue);
+
+        // Dawn API
+        // Returns the offset of the data in the buffer, aligned for dynamic offsets, or
+        // kInvalidTransientUniformOffset when the ring is full.
+        uint64_t Allocate(const void* data, uint64_t size);
+        BufferBase* GetBuffer();
+
+      private:
+        TransientUniformAllocator(DeviceBase* device, uint64_t size);
+        TransientUniformAllocator(DeviceBase* device, ObjectBase::ErrorTag tag);
+
+        MaybeError Initialize();
+        MaybeError ValidateAllocate(const void* data, uint64_t size) const;
+
+        struct DirtyRange {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        Ref<BufferBase> mBuffer;
+        RingBufferAllocator mAllocator;
+        std::vector<uint8_t> mData;
+        std::vector<DirtyRange> mDirtyRanges;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_TRANSIENTUNIFORMALLOCATOR_H_
@@ -74,6 +74,14 @@ namespace dawn_native { namespace d3d12 {
 
         DAWN_TRY_ASSIGN(mDeviceInfo, GatherDeviceInfo(*this));
 
+        const uint32_t driverFingerprint[4] = {
+            static_cast<uint32_t>(mDeviceInfo.driverVersion),
+            static_cast<uint32_t>(mDeviceInfo.driverVersion >> 32), adapterDesc.SubSysId,
+            adapterDesc.Revision};
+        const uint8_t* driverFingerprintBytes = reinterpret_cast<const uint8_t*>(driverFingerprint);
+        mDriverFingerprint.assign(driverFingerprintBytes,
+                                  driverFingerprintBytes + sizeof(driverFingerprint));
+
         if (adapterDesc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
             mAdapterType = wgpu::AdapterType::CPU;
         } else {
@@ -92,6 +100,17 @@ namespace dawn_native { namespace d3d12 {
 
     void Adapter::InitializeSupportedExtensions() {
         mSupportedExtensions.EnableExtension(Extension::TextureCompressionBC);
+        // ExecuteIndirect always supports reading the command count from a buffer.
+        mSupportedExtensions.EnableExtension(Extension::DrawIndirectCount);
+        // Push constants are root constants, which have space reserved in all root signatures.
+        mSupportedExtensions.EnableExtension(Extension::PushConstants);
+        // Predication is supported by all command lists that can draw and dispatch.
+        mSupportedExtensions.EnableExtension(Extension::ConditionalRendering);
+        // Tier 2 raises the number of SRVs in a descriptor table to the size of the heap, and
+        // doesn't require the descriptors that aren't accessed to be initialized.
+        if (mDeviceInfo.resourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_2) {
+            mSupportedExtensions.EnableExtension(Extension::ResourceTables);
+        }
     }
 
     ResultOrError<DeviceBase*> Adapter::CreateDeviceImpl(const DeviceDescriptor* descriptor) {
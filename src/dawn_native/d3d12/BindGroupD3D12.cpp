@@ -25,67 +25,48 @@
 namespace dawn_native { namespace d3d12 {
 
     // static
-    BindGroup* BindGroup::Create(Device* device, const BindGroupDescriptor* descriptor) {
+    ResultOrError<BindGroup*> BindGroup::Create(Device* device,
+                                                const BindGroupDescriptor* descriptor) {
         return ToBackend(descriptor->layout)->AllocateBindGroup(device, descriptor);
     }
 
-    BindGroup::BindGroup(Device* device, const BindGroupDescriptor* descriptor)
-        : BindGroupBase(this, device, descriptor) {
+    BindGroup::BindGroup(Device* device,
+                         const BindGroupDescriptor* descriptor,
+                         const CPUDescriptorHeapAllocation& viewAllocation,
+                         const CPUDescriptorHeapAllocation& samplerAllocation)
+        : BindGroupBase(this, device, descriptor),
+          mCPUViewAllocation(viewAllocation),
+          mCPUSamplerAllocation(samplerAllocation) {
+        const BindGroupLayout::LayoutBindingInfo& layout = GetLayout()->GetBindingInfo();
+
+        uint32_t dynamicBufferIndex = 0;
+        for (uint32_t bindingIndex : IterateBitSet(layout.hasDynamicOffset)) {
+            BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
+
+            DynamicBufferBinding& dynamicBinding = mDynamicBufferBindings[dynamicBufferIndex++];
+            dynamicBinding.bindingIndex = bindingIndex;
+            dynamicBinding.type = layout.types[bindingIndex];
+            dynamicBinding.baseLocation = ToBackend(binding.buffer)->GetVA() + binding.offset;
+        }
     }
 
     BindGroup::~BindGroup() {
-        ToBackend(GetLayout())->DeallocateBindGroup(this);
+        ToBackend(GetLayout())
+            ->DeallocateBindGroup(this, &mCPUViewAllocation, &mCPUSamplerAllocation);
     }
 
-    ResultOrError<bool> BindGroup::Populate(ShaderVisibleDescriptorAllocator* allocator) {
-        Device* device = ToBackend(GetDevice());
-
-        if (allocator->IsAllocationStillValid(mLastUsageSerial, mHeapSerial)) {
-            return true;
-        }
-
-        // Attempt to allocate descriptors for the currently bound shader-visible heaps.
-        // If either failed, return early to re-allocate and switch the heaps.
+    void BindGroup::CreateCPUDescriptors(const StagingDescriptorAllocator* viewAllocator,
+                                         const StagingDescriptorAllocator* samplerAllocator) {
         const BindGroupLayout* bgl = ToBackend(GetLayout());
-        const Serial pendingSerial = device->GetPendingCommandSerial();
-
-        const uint32_t cbvUavSrvDescriptorCount = bgl->GetCbvUavSrvDescriptorCount();
-        DescriptorHeapAllocation cbvSrvUavDescriptorHeapAllocation;
-        if (cbvUavSrvDescriptorCount > 0) {
-            DAWN_TRY_ASSIGN(
-                cbvSrvUavDescriptorHeapAllocation,
-                allocator->AllocateGPUDescriptors(cbvUavSrvDescriptorCount, pendingSerial,
-                                                  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
-            if (cbvSrvUavDescriptorHeapAllocation.IsInvalid()) {
-                return false;
-            }
-
-            mBaseCbvSrvUavDescriptor = cbvSrvUavDescriptorHeapAllocation.GetGPUHandle(0);
-        }
-
-        const uint32_t samplerDescriptorCount = bgl->GetSamplerDescriptorCount();
-        DescriptorHeapAllocation samplerDescriptorHeapAllocation;
-        if (samplerDescriptorCount > 0) {
-            DAWN_TRY_ASSIGN(samplerDescriptorHeapAllocation,
-                            allocator->AllocateGPUDescriptors(samplerDescriptorCount, pendingSerial,
-                                                              D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER));
-            if (samplerDescriptorHeapAllocation.IsInvalid()) {
-                return false;
-            }
-
-            mBaseSamplerDescriptor = samplerDescriptorHeapAllocation.GetGPUHandle(0);
-        }
-
-        // Record both the device and heap serials to determine later if the allocations are still
-        // valid.
-        mLastUsageSerial = pendingSerial;
-        mHeapSerial = allocator->GetShaderVisibleHeapsSerial();
-
         const auto& layout = bgl->GetBindingInfo();
-
         const auto& bindingOffsets = bgl->GetBindingOffsets();
 
-        ID3D12Device* d3d12Device = device->GetD3D12Device().Get();
+        const uint32_t viewSizeIncrement =
+            viewAllocator != nullptr ? viewAllocator->GetSizeIncrement() : 0;
+        const uint32_t samplerSizeIncrement =
+            samplerAllocator != nullptr ? samplerAllocator->GetSizeIncrement() : 0;
+
+        ID3D12Device* d3d12Device = ToBackend(GetDevice())->GetD3D12Device().Get();
 
         for (uint32_t bindingIndex : IterateBitSet(layout.mask)) {
             // It's not necessary to create descriptors in descriptor heap for dynamic
@@ -106,8 +87,8 @@ namespace dawn_native { namespace d3d12 {
                     desc.BufferLocation = ToBackend(binding.buffer)->GetVA() + binding.offset;
 
                     d3d12Device->CreateConstantBufferView(
-                        &desc, cbvSrvUavDescriptorHeapAllocation.GetCPUHandle(
-                                   bindingOffsets[bindingIndex]));
+                        &desc, mCPUViewAllocation.OffsetFrom(viewSizeIncrement,
+                                                            bindingOffsets[bindingIndex]));
                 } break;
                 case wgpu::BindingType::StorageBuffer: {
                     BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
@@ -130,8 +111,8 @@ namespace dawn_native { namespace d3d12 {
 
                     d3d12Device->CreateUnorderedAccessView(
                         ToBackend(binding.buffer)->GetD3D12Resource().Get(), nullptr, &desc,
-                        cbvSrvUavDescriptorHeapAllocation.GetCPUHandle(
-                            bindingOffsets[bindingIndex]));
+                        mCPUViewAllocation.OffsetFrom(viewSizeIncrement,
+                                                      bindingOffsets[bindingIndex]));
                 } break;
                 case wgpu::BindingType::ReadonlyStorageBuffer: {
                     BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
@@ -150,23 +131,24 @@ namespace dawn_native { namespace d3d12 {
                     desc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
                     d3d12Device->CreateShaderResourceView(
                         ToBackend(binding.buffer)->GetD3D12Resource().Get(), &desc,
-                        cbvSrvUavDescriptorHeapAllocation.GetCPUHandle(
-                            bindingOffsets[bindingIndex]));
+                        mCPUViewAllocation.OffsetFrom(viewSizeIncrement,
+                                                      bindingOffsets[bindingIndex]));
                 } break;
                 case wgpu::BindingType::SampledTexture: {
                     auto* view = ToBackend(GetBindingAsTextureView(bindingIndex));
                     auto& srv = view->GetSRVDescriptor();
                     d3d12Device->CreateShaderResourceView(
                         ToBackend(view->GetTexture())->GetD3D12Resource(), &srv,
-                        cbvSrvUavDescriptorHeapAllocation.GetCPUHandle(
-                            bindingOffsets[bindingIndex]));
+                        mCPUViewAllocation.OffsetFrom(viewSizeIncrement,
+                                                      bindingOffsets[bindingIndex]));
                 } break;
                 case wgpu::BindingType::Sampler: {
                     auto* sampler = ToBackend(GetBindingAsSampler(bindingIndex));
                     auto& samplerDesc = sampler->GetSamplerDescriptor();
                     d3d12Device->CreateSampler(
                         &samplerDesc,
-                        samplerDescriptorHeapAllocation.GetCPUHandle(bindingOffsets[bindingIndex]));
+                        mCPUSamplerAllocation.OffsetFrom(samplerSizeIncrement,
+                                                         bindingOffsets[bindingIndex]));
                 } break;
 
                 case wgpu::BindingType::AccelerationContainer:
@@ -184,6 +166,63 @@ namespace dawn_native { namespace d3d12 {
             }
         }
 
+    }
+
+    ResultOrError<bool> BindGroup::Populate(ShaderVisibleDescriptorAllocator* allocator) {
+        Device* device = ToBackend(GetDevice());
+
+        if (allocator->IsAllocationStillValid(mLastUsageSerial, mHeapSerial)) {
+            return true;
+        }
+
+        // Attempt to allocate descriptors for the currently bound shader-visible heaps.
+        // If either failed, return early to re-allocate and switch the heaps.
+        const BindGroupLayout* bgl = ToBackend(GetLayout());
+        const Serial pendingSerial = device->GetPendingCommandSerial();
+        ID3D12Device* d3d12Device = device->GetD3D12Device().Get();
+
+        // The descriptors were created once in the non shader-visible heaps, copy them to the
+        // shader-visible ones instead of creating them again.
+        const uint32_t cbvUavSrvDescriptorCount = bgl->GetCbvUavSrvDescriptorCount();
+        DescriptorHeapAllocation cbvSrvUavDescriptorHeapAllocation;
+        if (cbvUavSrvDescriptorCount > 0) {
+            DAWN_TRY_ASSIGN(
+                cbvSrvUavDescriptorHeapAllocation,
+                allocator->AllocateGPUDescriptors(cbvUavSrvDescriptorCount, pendingSerial,
+                                                  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
+            if (cbvSrvUavDescriptorHeapAllocation.IsInvalid()) {
+                return false;
+            }
+
+            d3d12Device->CopyDescriptorsSimple(
+                cbvUavSrvDescriptorCount, cbvSrvUavDescriptorHeapAllocation.GetCPUHandle(0),
+                mCPUViewAllocation.GetBaseDescriptor(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+            mBaseCbvSrvUavDescriptor = cbvSrvUavDescriptorHeapAllocation.GetGPUHandle(0);
+        }
+
+        const uint32_t samplerDescriptorCount = bgl->GetSamplerDescriptorCount();
+        DescriptorHeapAllocation samplerDescriptorHeapAllocation;
+        if (samplerDescriptorCount > 0) {
+            DAWN_TRY_ASSIGN(samplerDescriptorHeapAllocation,
+                            allocator->AllocateGPUDescriptors(samplerDescriptorCount, pendingSerial,
+                                                              D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER));
+            if (samplerDescriptorHeapAllocation.IsInvalid()) {
+                return false;
+            }
+
+            d3d12Device->CopyDescriptorsSimple(
+                samplerDescriptorCount, samplerDescriptorHeapAllocation.GetCPUHandle(0),
+                mCPUSamplerAllocation.GetBaseDescriptor(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+            mBaseSamplerDescriptor = samplerDescriptorHeapAllocation.GetGPUHandle(0);
+        }
+
+        // Record both the device and heap serials to determine later if the allocations are still
+        // valid.
+        mLastUsageSerial = pendingSerial;
+        mHeapSerial = allocator->GetShaderVisibleHeapsSerial();
+
         return true;
     }
 
@@ -194,4 +233,9 @@ namespace dawn_native { namespace d3d12 {
     D3D12_GPU_DESCRIPTOR_HANDLE BindGroup::GetBaseSamplerDescriptor() const {
         return mBaseSamplerDescriptor;
     }
+
+    const BindGroup::DynamicBufferBinding* BindGroup::GetDynamicBufferBindings() const {
+        return mDynamicBufferBindings.data();
+    }
+
 }}  // namespace dawn_native::d3d12
@@ -18,8 +18,11 @@
 #include "common/PlacementAllocated.h"
 #include "common/Serial.h"
 #include "dawn_native/BindGroup.h"
+#include "dawn_native/d3d12/StagingDescriptorAllocatorD3D12.h"
 #include "dawn_native/d3d12/d3d12_platform.h"
 
+#include <array>
+
 namespace dawn_native { namespace d3d12 {
 
     class Device;
@@ -27,23 +30,48 @@ namespace dawn_native { namespace d3d12 {
 
     class BindGroup : public BindGroupBase, public PlacementAllocated {
       public:
-        static BindGroup* Create(Device* device, const BindGroupDescriptor* descriptor);
+        static ResultOrError<BindGroup*> Create(Device* device,
+                                                const BindGroupDescriptor* descriptor);
 
-        BindGroup(Device* device, const BindGroupDescriptor* descriptor);
+        BindGroup(Device* device,
+                  const BindGroupDescriptor* descriptor,
+                  const CPUDescriptorHeapAllocation& viewAllocation,
+                  const CPUDescriptorHeapAllocation& samplerAllocation);
         ~BindGroup() override;
 
+        // Creates the descriptors of the bindings in the non shader-visible allocations. This is
+        // done once, populating the bind group only copies them to the shader-visible heaps.
+        void CreateCPUDescriptors(const StagingDescriptorAllocator* viewAllocator,
+                                  const StagingDescriptorAllocator* samplerAllocator);
+
         // Returns true if the BindGroup was successfully populated.
         ResultOrError<bool> Populate(ShaderVisibleDescriptorAllocator* allocator);
 
         D3D12_GPU_DESCRIPTOR_HANDLE GetBaseCbvUavSrvDescriptor() const;
         D3D12_GPU_DESCRIPTOR_HANDLE GetBaseSamplerDescriptor() const;
 
+        struct DynamicBufferBinding {
+            uint32_t bindingIndex;
+            wgpu::BindingType type;
+            // The location of the binding before the dynamic offset is added.
+            D3D12_GPU_VIRTUAL_ADDRESS baseLocation;
+        };
+
+        // Returns the dynamic buffer bindings in the order of their dynamic offsets. The buffers
+        // referenced by bind groups are never relocated so the locations are computed once.
+        const DynamicBufferBinding* GetDynamicBufferBindings() const;
+
       private:
         Serial mLastUsageSerial = 0;
         Serial mHeapSerial = 0;
 
         D3D12_GPU_DESCRIPTOR_HANDLE mBaseCbvSrvUavDescriptor = {0};
         D3D12_GPU_DESCRIPTOR_HANDLE mBaseSamplerDescriptor = {0};
+
+        CPUDescriptorHeapAllocation mCPUViewAllocation;
+        CPUDescriptorHeapAllocation mCPUSamplerAllocation;
+
+        std::array<DynamicBufferBinding, kMaxDynamicBufferCount> mDynamicBufferBindings;
     };
 }}  // namespace dawn_native::d3d12
 
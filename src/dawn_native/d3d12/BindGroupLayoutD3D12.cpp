@@ -17,9 +17,17 @@
 #include "common/BitSetIterator.h"
 #include "dawn_native/d3d12/BindGroupD3D12.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
+#include "dawn_native/d3d12/StagingDescriptorAllocatorD3D12.h"
 
 namespace dawn_native { namespace d3d12 {
 
+    namespace {
+
+        // The number of bind groups whose descriptors share a non shader-visible heap.
+        constexpr uint32_t kBindGroupsPerStagingHeap = 256;
+
+    }  // anonymous namespace
+
     BindGroupLayout::BindGroupLayout(Device* device, const BindGroupLayoutDescriptor* descriptor)
         : BindGroupLayoutBase(device, descriptor),
           mDescriptorCounts{},
@@ -43,7 +51,10 @@ namespace dawn_native { namespace d3d12 {
                     break;
                 case wgpu::BindingType::SampledTexture:
                 case wgpu::BindingType::ReadonlyStorageBuffer:
-                    mBindingOffsets[binding] = mDescriptorCounts[SRV]++;
+                    // The binding of a resource table is an array of all its slots.
+                    mBindingOffsets[binding] = mDescriptorCounts[SRV];
+                    mDescriptorCounts[SRV] +=
+                        IsResourceTableLayout() ? GetResourceTableCapacity() : 1;
                     break;
                 case wgpu::BindingType::Sampler:
                     mBindingOffsets[binding] = mDescriptorCounts[Sampler]++;
@@ -151,14 +162,58 @@ namespace dawn_native { namespace d3d12 {
                     // TODO(shaobo.yan@intel.com): Implement dynamic buffer offset.
             }
         }
+
+        // Resource tables own their descriptors, see ResourceTableD3D12.
+        if (GetCbvUavSrvDescriptorCount() > 0 && !IsResourceTableLayout()) {
+            mViewAllocator = std::make_unique<StagingDescriptorAllocator>(
+                device, GetCbvUavSrvDescriptorCount(), kBindGroupsPerStagingHeap,
+                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        }
+        if (GetSamplerDescriptorCount() > 0) {
+            mSamplerAllocator = std::make_unique<StagingDescriptorAllocator>(
+                device, GetSamplerDescriptorCount(), kBindGroupsPerStagingHeap,
+                D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+        }
     }
 
-    BindGroup* BindGroupLayout::AllocateBindGroup(Device* device,
-                                                  const BindGroupDescriptor* descriptor) {
-        return mBindGroupAllocator.Allocate(device, descriptor);
+    BindGroupLayout::~BindGroupLayout() = default;
+
+    ResultOrError<BindGroup*> BindGroupLayout::AllocateBindGroup(
+        Device* device,
+        const BindGroupDescriptor* descriptor) {
+        CPUDescriptorHeapAllocation viewAllocation;
+        if (mViewAllocator != nullptr) {
+            DAWN_TRY_ASSIGN(viewAllocation, mViewAllocator->AllocateCPUDescriptors());
+        }
+
+        CPUDescriptorHeapAllocation samplerAllocation;
+        if (mSamplerAllocator != nullptr) {
+            ResultOrError<CPUDescriptorHeapAllocation> result =
+                mSamplerAllocator->AllocateCPUDescriptors();
+            if (result.IsError()) {
+                if (viewAllocation.IsValid()) {
+                    mViewAllocator->Deallocate(&viewAllocation);
+                }
+                return result.AcquireError();
+            }
+            samplerAllocation = result.AcquireSuccess();
+        }
+
+        BindGroup* bindGroup = mBindGroupAllocator.Allocate(device, descriptor, viewAllocation,
+                                                            samplerAllocation);
+        bindGroup->CreateCPUDescriptors(mViewAllocator.get(), mSamplerAllocator.get());
+        return bindGroup;
     }
 
-    void BindGroupLayout::DeallocateBindGroup(BindGroup* bindGroup) {
+    void BindGroupLayout::DeallocateBindGroup(BindGroup* bindGroup,
+                                              CPUDescriptorHeapAllocation* viewAllocation,
+                                              CPUDescriptorHeapAllocation* samplerAllocation) {
+        if (viewAllocation->IsValid()) {
+            mViewAllocator->Deallocate(viewAllocation);
+        }
+        if (samplerAllocation->IsValid()) {
+            mSamplerAllocator->Deallocate(samplerAllocation);
+        }
         mBindGroupAllocator.Deallocate(bindGroup);
     }
 
@@ -20,17 +20,25 @@
 #include "common/SlabAllocator.h"
 #include "dawn_native/d3d12/d3d12_platform.h"
 
+#include <memory>
+
 namespace dawn_native { namespace d3d12 {
 
     class BindGroup;
+    class CPUDescriptorHeapAllocation;
     class Device;
+    class StagingDescriptorAllocator;
 
     class BindGroupLayout : public BindGroupLayoutBase {
       public:
         BindGroupLayout(Device* device, const BindGroupLayoutDescriptor* descriptor);
+        ~BindGroupLayout() override;
 
-        BindGroup* AllocateBindGroup(Device* device, const BindGroupDescriptor* descriptor);
-        void DeallocateBindGroup(BindGroup* bindGroup);
+        ResultOrError<BindGroup*> AllocateBindGroup(Device* device,
+                                                    const BindGroupDescriptor* descriptor);
+        void DeallocateBindGroup(BindGroup* bindGroup,
+                                 CPUDescriptorHeapAllocation* viewAllocation,
+                                 CPUDescriptorHeapAllocation* samplerAllocation);
 
         enum DescriptorType {
             CBV,
@@ -54,6 +62,11 @@ namespace dawn_native { namespace d3d12 {
         D3D12_DESCRIPTOR_RANGE mRanges[DescriptorType::Count];
 
         SlabAllocator<BindGroup> mBindGroupAllocator;
+
+        // The non shader-visible descriptors of the bind groups, null when there are no
+        // descriptors of that heap type.
+        std::unique_ptr<StagingDescriptorAllocator> mViewAllocator;
+        std::unique_ptr<StagingDescriptorAllocator> mSamplerAllocator;
     };
 
 }}  // namespace dawn_native::d3d12
@@ -21,6 +21,7 @@
 #include "dawn_native/d3d12/D3D12Error.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
 #include "dawn_native/d3d12/HeapD3D12.h"
+#include "dawn_native/d3d12/ResourceAllocatorManagerD3D12.h"
 
 namespace dawn_native { namespace d3d12 {
 
@@ -60,6 +61,9 @@ namespace dawn_native { namespace d3d12 {
             if (usage & wgpu::BufferUsage::Indirect) {
                 resourceState |= D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
             }
+            if (usage & wgpu::BufferUsage::Predicate) {
+                resourceState |= D3D12_RESOURCE_STATE_PREDICATION;
+            }
 
             return resourceState;
         }
@@ -114,9 +118,103 @@ namespace dawn_native { namespace d3d12 {
             mLastUsage = wgpu::BufferUsage::CopySrc;
         }
 
+        if (IsTransient()) {
+            Device* device = ToBackend(GetDevice());
+            DAWN_TRY_ASSIGN(mResourceAllocation, device->AllocateTransientMemory(
+                                                     heapType, resourceDescriptor, bufferUsage));
+            mNeedsAliasingBarrier =
+                mResourceAllocation.GetInfo().mMethod == AllocationMethod::kSubAllocated;
+            return {};
+        }
+
         DAWN_TRY_ASSIGN(
             mResourceAllocation,
-            ToBackend(GetDevice())->AllocateMemory(heapType, resourceDescriptor, bufferUsage));
+            ToBackend(GetDevice())->AllocateMemory(heapType, resourceDescriptor, bufferUsage,
+                                                   GetResidencyPriority()));
+
+        // Buffers in the other heaps are mapped, which pins their memory.
+        if (heapType == D3D12_HEAP_TYPE_DEFAULT &&
+            mResourceAllocation.GetInfo().mMethod == AllocationMethod::kSubAllocated) {
+            ToBackend(GetDevice())->GetResourceAllocatorManager()->AddRelocatableBuffer(this);
+        }
+        return {};
+    }
+
+    // static
+    ResultOrError<BufferBase*> Buffer::CreateFromSharedHandle(Device* device,
+                                                              const BufferDescriptor* descriptor,
+                                                              HANDLE sharedHandle,
+                                                              HANDLE fenceSharedHandle,
+                                                              uint64_t fenceWaitValue) {
+        DAWN_TRY(ValidateBufferDescriptor(device, descriptor));
+        if (descriptor->usage & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite |
+                                 wgpu::BufferUsage::Transient)) {
+            return DAWN_VALIDATION_ERROR("Wrapped buffers can't be mappable or transient");
+        }
+
+        std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>(device, descriptor);
+        DAWN_TRY(buffer->InitializeAsExternalBuffer(sharedHandle, fenceSharedHandle,
+                                                    fenceWaitValue));
+        return buffer.release();
+    }
+
+    MaybeError Buffer::InitializeAsExternalBuffer(HANDLE sharedHandle,
+                                                  HANDLE fenceSharedHandle,
+                                                  uint64_t fenceWaitValue) {
+        Device* device = ToBackend(GetDevice());
+
+        ComPtr<ID3D12Resource> d3d12Resource;
+        DAWN_TRY(CheckHRESULT(device->GetD3D12Device()->OpenSharedHandle(
+                                  sharedHandle, IID_PPV_ARGS(&d3d12Resource)),
+                              "D3D12 opening shared handle"));
+
+        const D3D12_RESOURCE_DESC d3dDescriptor = d3d12Resource->GetDesc();
+        if (d3dDescriptor.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER) {
+            return DAWN_VALIDATION_ERROR("D3D12 shared resource isn't a buffer");
+        }
+        if (d3dDescriptor.Width < GetSize()) {
+            return DAWN_VALIDATION_ERROR("D3D12 buffer is smaller than the descriptor size");
+        }
+        if ((GetUsage() & wgpu::BufferUsage::Storage) &&
+            !(d3dDescriptor.Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)) {
+            return DAWN_VALIDATION_ERROR("D3D12 buffer doesn't allow storage usage");
+        }
+
+        if (fenceSharedHandle != nullptr) {
+            ComPtr<ID3D12Fence> sharedFence;
+            DAWN_TRY(CheckHRESULT(device->GetD3D12Device()->OpenSharedHandle(
+                                      fenceSharedHandle, IID_PPV_ARGS(&sharedFence)),
+                                  "D3D12 opening shared fence handle"));
+            DAWN_TRY(CheckHRESULT(device->GetCommandQueue()->Wait(sharedFence.Get(),
+                                                                   fenceWaitValue),
+                                  "D3D12 waiting on shared fence"));
+            mSharedFence = std::move(sharedFence);
+        }
+
+        AllocationInfo info;
+        info.mMethod = AllocationMethod::kExternal;
+        // The resource heap is set to nullptr because the buffer is owned externally, like for
+        // wrapped textures.
+        mResourceAllocation = {info, 0, std::move(d3d12Resource), nullptr};
+        return {};
+    }
+
+    MaybeError Buffer::SignalAndDestroy(uint64_t fenceSignalValue) {
+        if (mResourceAllocation.GetInfo().mMethod != AllocationMethod::kExternal) {
+            return DAWN_VALIDATION_ERROR("Can't release destroyed / non-external buffer");
+        }
+
+        Device* device = ToBackend(GetDevice());
+        DAWN_TRY(device->ExecutePendingCommandContext());
+        if (mSharedFence != nullptr) {
+            DAWN_TRY(CheckHRESULT(device->GetCommandQueue()->Signal(mSharedFence.Get(),
+                                                                     fenceSignalValue),
+                                  "D3D12 signaling shared fence"));
+            mSharedFence.Reset();
+        }
+
+        // Destroy the buffer so it can't be used again
+        DestroyInternal();
         return {};
     }
 
@@ -134,9 +232,16 @@ namespace dawn_native { namespace d3d12 {
     bool Buffer::TrackUsageAndGetResourceBarrier(CommandRecordingContext* commandContext,
                                                  D3D12_RESOURCE_BARRIER* barrier,
                                                  wgpu::BufferUsage newUsage) {
-        // Track the underlying heap to ensure residency.
-        Heap* heap = ToBackend(mResourceAllocation.GetResourceHeap());
-        commandContext->TrackHeapUsage(heap, GetDevice()->GetPendingCommandSerial());
+        if (mResourceAllocation.GetInfo().mMethod != AllocationMethod::kExternal) {
+            // Track the underlying heap to ensure residency.
+            Heap* heap = ToBackend(mResourceAllocation.GetResourceHeap());
+            commandContext->TrackHeapUsage(heap, GetDevice()->GetPendingCommandSerial());
+        }
+
+        if (mNeedsAliasingBarrier) {
+            commandContext->AddAliasingBarrier(GetD3D12Resource().Get());
+            mNeedsAliasingBarrier = false;
+        }
 
         // Return the resource barrier.
         return TransitionUsageAndGetResourceBarrier(commandContext, barrier, newUsage);
@@ -226,6 +331,32 @@ namespace dawn_native { namespace d3d12 {
         return true;
     }
 
+    const ResourceHeapAllocation& Buffer::GetResourceAllocation() const {
+        return mResourceAllocation;
+    }
+
+    bool Buffer::CanRelocate() const {
+        return HasOneRef();
+    }
+
+    void Buffer::Relocate(CommandRecordingContext* commandContext,
+                          ResourceHeapAllocation allocation) {
+        ASSERT(!mFixedResourceState);
+
+        TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::CopySrc);
+        ComPtr<ID3D12Resource> previousResource = GetD3D12Resource();
+        ToBackend(GetDevice())->DeallocateMemory(mResourceAllocation);
+
+        // The new resource starts in the COMMON state, like a newly created buffer.
+        mResourceAllocation = std::move(allocation);
+        mLastUsage = wgpu::BufferUsage::None;
+        mLastUsedSerial = UINT64_MAX;
+        TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::CopyDst);
+
+        commandContext->GetCommandList()->CopyBufferRegion(GetD3D12Resource().Get(), 0,
+                                                           previousResource.Get(), 0, GetSize());
+    }
+
     D3D12_GPU_VIRTUAL_ADDRESS Buffer::GetVA() const {
         return mResourceAllocation.GetGPUPointer();
     }
@@ -284,9 +415,16 @@ namespace dawn_native { namespace d3d12 {
     }
 
     void Buffer::DestroyImpl() {
+        ToBackend(GetDevice())->GetResourceAllocatorManager()->RemoveRelocatableBuffer(this);
         ToBackend(GetDevice())->DeallocateMemory(mResourceAllocation);
     }
 
+    MaybeError Buffer::SetResidencyPriorityImpl() {
+        return ToBackend(GetDevice())
+            ->GetResourceAllocatorManager()
+            ->SetResidencyPriority(mResourceAllocation, GetResidencyPriority());
+    }
+
     MapRequestTracker::MapRequestTracker(Device* device) : mDevice(device) {
     }
 
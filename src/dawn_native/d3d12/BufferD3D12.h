@@ -31,6 +31,14 @@ namespace dawn_native { namespace d3d12 {
         Buffer(Device* device, const BufferDescriptor* descriptor);
         ~Buffer();
 
+        // Creates a buffer aliasing the D3D12 buffer resource of |sharedHandle|. The commands
+        // submitted next wait on the shared fence, if any.
+        static ResultOrError<BufferBase*> CreateFromSharedHandle(Device* device,
+                                                                 const BufferDescriptor* descriptor,
+                                                                 HANDLE sharedHandle,
+                                                                 HANDLE fenceSharedHandle,
+                                                                 uint64_t fenceWaitValue);
+
         MaybeError Initialize();
 
         ComPtr<ID3D12Resource> GetD3D12Resource() const;
@@ -43,12 +51,30 @@ namespace dawn_native { namespace d3d12 {
         void TrackUsageAndTransitionNow(CommandRecordingContext* commandContext,
                                         wgpu::BufferUsage newUsage);
 
+        const ResourceHeapAllocation& GetResourceAllocation() const;
+
+        // Buffers can only be relocated when nothing but the application references them, since
+        // bind groups and recorded commands use their D3D12 resource.
+        bool CanRelocate() const;
+        // Copies the contents of the buffer to |allocation| in |commandContext| and makes it the
+        // buffer's memory. The previous memory is freed once the copy has completed.
+        void Relocate(CommandRecordingContext* commandContext, ResourceHeapAllocation allocation);
+
+        // Submits the pending commands, signals the shared fence with |fenceSignalValue| after
+        // them and destroys the buffer.
+        MaybeError SignalAndDestroy(uint64_t fenceSignalValue);
+
       private:
+        MaybeError InitializeAsExternalBuffer(HANDLE sharedHandle,
+                                              HANDLE fenceSharedHandle,
+                                              uint64_t fenceWaitValue);
+
         // Dawn API
         MaybeError MapReadAsyncImpl(uint32_t serial) override;
         MaybeError MapWriteAsyncImpl(uint32_t serial) override;
         void UnmapImpl() override;
         void DestroyImpl() override;
+        MaybeError SetResidencyPriorityImpl() override;
 
         bool IsMapWritable() const override;
         virtual MaybeError MapAtCreationImpl(uint8_t** mappedPointer) override;
@@ -58,7 +84,11 @@ namespace dawn_native { namespace d3d12 {
                                                   wgpu::BufferUsage newUsage);
 
         ResourceHeapAllocation mResourceAllocation;
+        // The fence shared with the owner of the resource of wrapped buffers.
+        ComPtr<ID3D12Fence> mSharedFence;
         bool mFixedResourceState = false;
+        // Set for transient buffers placed in memory that other transient resources used.
+        bool mNeedsAliasingBarrier = false;
         wgpu::BufferUsage mLastUsage = wgpu::BufferUsage::None;
         Serial mLastUsedSerial = UINT64_MAX;
         D3D12_RANGE mWrittenMappedRange;
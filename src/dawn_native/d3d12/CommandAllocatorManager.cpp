@@ -18,55 +18,63 @@
 #include "dawn_native/d3d12/DeviceD3D12.h"
 
 #include "common/Assert.h"
-#include "common/BitSetIterator.h"
+#include "dawn_platform/tracing/TraceEvent.h"
 
 namespace dawn_native { namespace d3d12 {
 
-    CommandAllocatorManager::CommandAllocatorManager(Device* device)
-        : device(device), mAllocatorCount(0) {
-        mFreeAllocators.set();
+    CommandAllocatorManager::CommandAllocatorManager(Device* device, uint32_t maxAllocatorCount)
+        : device(device), mMaxAllocatorCount(maxAllocatorCount) {
+        ASSERT(mMaxAllocatorCount >= 2);
     }
 
     ResultOrError<ID3D12CommandAllocator*> CommandAllocatorManager::ReserveCommandAllocator() {
-        // If there are no free allocators, get the oldest serial in flight and wait on it
-        if (mFreeAllocators.none()) {
-            const uint64_t firstSerial = mInFlightCommandAllocators.FirstSerial();
-            DAWN_TRY(device->WaitForSerial(firstSerial));
-            DAWN_TRY(Tick(firstSerial));
-        }
-
-        ASSERT(mFreeAllocators.any());
-
-        // Get the index of the first free allocator from the bitset
-        unsigned int firstFreeIndex = *(IterateBitSet(mFreeAllocators).begin());
+        mStats.reserveCount++;
 
-        if (firstFreeIndex >= mAllocatorCount) {
-            ASSERT(firstFreeIndex == mAllocatorCount);
-            mAllocatorCount++;
-            DAWN_TRY(CheckHRESULT(device->GetD3D12Device()->CreateCommandAllocator(
-                                      D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                      IID_PPV_ARGS(&mCommandAllocators[firstFreeIndex])),
-                                  "D3D12 create command allocator"));
+        if (mFreeAllocators.empty()) {
+            if (mCommandAllocators.size() < mMaxAllocatorCount) {
+                ComPtr<ID3D12CommandAllocator> commandAllocator;
+                DAWN_TRY(CheckHRESULT(device->GetD3D12Device()->CreateCommandAllocator(
+                                          D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                          IID_PPV_ARGS(&commandAllocator)),
+                                      "D3D12 create command allocator"));
+                mFreeAllocators.push_back(static_cast<uint32_t>(mCommandAllocators.size()));
+                mCommandAllocators.push_back(std::move(commandAllocator));
+                mStats.allocatorCount = static_cast<uint32_t>(mCommandAllocators.size());
+            } else {
+                // The pool is at its high-water mark, get the oldest serial in flight and wait
+                // on it
+                TRACE_EVENT0(device->GetPlatform(), GPUWork,
+                             "CommandAllocatorManager::WaitForFreeAllocator");
+                mStats.waitCount++;
+                const uint64_t firstSerial = mInFlightCommandAllocators.FirstSerial();
+                DAWN_TRY(device->WaitForSerial(firstSerial));
+                DAWN_TRY(Tick(firstSerial));
+            }
         }
 
-        // Mark the command allocator as used
-        mFreeAllocators.reset(firstFreeIndex);
+        ASSERT(!mFreeAllocators.empty());
+        uint32_t freeIndex = mFreeAllocators.back();
+        mFreeAllocators.pop_back();
 
         // Enqueue the command allocator. It will be scheduled for reset after the next
         // ExecuteCommandLists
-        mInFlightCommandAllocators.Enqueue({mCommandAllocators[firstFreeIndex], firstFreeIndex},
+        mInFlightCommandAllocators.Enqueue({mCommandAllocators[freeIndex], freeIndex},
                                            device->GetPendingCommandSerial());
-        return mCommandAllocators[firstFreeIndex].Get();
+        return mCommandAllocators[freeIndex].Get();
     }
 
     MaybeError CommandAllocatorManager::Tick(uint64_t lastCompletedSerial) {
         // Reset all command allocators that are no longer in flight
         for (auto it : mInFlightCommandAllocators.IterateUpTo(lastCompletedSerial)) {
             DAWN_TRY(CheckHRESULT(it.commandAllocator->Reset(), "D3D12 reset command allocator"));
-            mFreeAllocators.set(it.index);
+            mFreeAllocators.push_back(it.index);
         }
         mInFlightCommandAllocators.ClearUpTo(lastCompletedSerial);
         return {};
     }
 
+    const CommandAllocatorManager::Stats& CommandAllocatorManager::GetStats() const {
+        return mStats;
+    }
+
 }}  // namespace dawn_native::d3d12
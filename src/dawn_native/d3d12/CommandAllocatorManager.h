@@ -20,7 +20,7 @@
 #include "common/SerialQueue.h"
 #include "dawn_native/Error.h"
 
-#include <bitset>
+#include <vector>
 
 namespace dawn_native { namespace d3d12 {
 
@@ -28,28 +28,45 @@ namespace dawn_native { namespace d3d12 {
 
     class CommandAllocatorManager {
       public:
-        CommandAllocatorManager(Device* device);
+        // The pool grows as needed until it holds |maxAllocatorCount| allocators. Past that,
+        // reserving an allocator waits for the oldest one in flight to be done on the GPU.
+        CommandAllocatorManager(Device* device,
+                                uint32_t maxAllocatorCount = kDefaultMaxCommandAllocators);
 
         // A CommandAllocator that is reserved must be used on the next ExecuteCommandLists
         // otherwise its commands may be reset before execution has completed on the GPU
         ResultOrError<ID3D12CommandAllocator*> ReserveCommandAllocator();
         MaybeError Tick(uint64_t lastCompletedSerial);
 
+        struct Stats {
+            uint64_t reserveCount = 0;
+            // The number of reservations that had to wait on the GPU because the pool was at
+            // its high-water mark.
+            uint64_t waitCount = 0;
+            uint32_t allocatorCount = 0;
+        };
+        const Stats& GetStats() const;
+
+        // This must be at least 2 because the Device and Queue use separate command allocators
+        static constexpr uint32_t kDefaultMaxCommandAllocators = 256;
+
       private:
         Device* device;
 
-        // This must be at least 2 because the Device and Queue use separate command allocators
-        static constexpr unsigned int kMaxCommandAllocators = 32;
-        unsigned int mAllocatorCount;
+        const uint32_t mMaxAllocatorCount;
 
         struct IndexedCommandAllocator {
             ComPtr<ID3D12CommandAllocator> commandAllocator;
-            unsigned int index;
+            uint32_t index;
         };
 
-        ComPtr<ID3D12CommandAllocator> mCommandAllocators[kMaxCommandAllocators];
-        std::bitset<kMaxCommandAllocators> mFreeAllocators;
+        std::vector<ComPtr<ID3D12CommandAllocator>> mCommandAllocators;
+        // Used as a stack so that the most recently reset allocators, which are the most likely
+        // to still be in the caches, are reused first.
+        std::vector<uint32_t> mFreeAllocators;
         SerialQueue<IndexedCommandAllocator> mInFlightCommandAllocators;
+
+        Stats mStats;
     };
 
 }}  // namespace dawn_native::d3d12
@@ -18,6 +18,7 @@
 #include "dawn_native/BindGroupAndStorageBarrierTracker.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
+#include "dawn_native/PushConstantsTracker.h"
 #include "dawn_native/RenderBundle.h"
 #include "dawn_native/d3d12/BindGroupD3D12.h"
 #include "dawn_native/d3d12/BindGroupLayoutD3D12.h"
@@ -26,10 +27,12 @@
 #include "dawn_native/d3d12/ComputePipelineD3D12.h"
 #include "dawn_native/d3d12/DescriptorHeapAllocator.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
+#include "dawn_native/d3d12/MipmapGeneratorD3D12.h"
 #include "dawn_native/d3d12/PipelineLayoutD3D12.h"
 #include "dawn_native/d3d12/PlatformFunctions.h"
 #include "dawn_native/d3d12/RenderPassBuilderD3D12.h"
 #include "dawn_native/d3d12/RenderPipelineD3D12.h"
+#include "dawn_native/d3d12/ResourceTableD3D12.h"
 #include "dawn_native/d3d12/SamplerD3D12.h"
 #include "dawn_native/d3d12/ShaderVisibleDescriptorAllocatorD3D12.h"
 #include "dawn_native/d3d12/TextureCopySplitter.h"
@@ -67,6 +70,76 @@ namespace dawn_native { namespace d3d12 {
             return false;
         }
 
+        // ExecuteIndirect takes the number of draws from the count buffer when there is one,
+        // clamped to drawCount.
+        void RecordSetPredication(ID3D12GraphicsCommandList* commandList,
+                                  const BeginConditionalRenderingCmd* cmd) {
+            // The commands are skipped while the predication op is true, the opposite of the
+            // Vulkan condition.
+            D3D12_PREDICATION_OP op = cmd->inverted ? D3D12_PREDICATION_OP_NOT_EQUAL_ZERO
+                                                    : D3D12_PREDICATION_OP_EQUAL_ZERO;
+            commandList->SetPredication(ToBackend(cmd->predicateBuffer)->GetD3D12Resource().Get(),
+                                        cmd->predicateOffset, op);
+        }
+
+        void ExecuteDrawIndirect(ID3D12GraphicsCommandList* commandList,
+                                 ID3D12CommandSignature* signature,
+                                 const DrawIndirectCmd* draw) {
+            ID3D12Resource* countResource = nullptr;
+            if (draw->countBuffer != nullptr) {
+                countResource = ToBackend(draw->countBuffer)->GetD3D12Resource().Get();
+            }
+            commandList->ExecuteIndirect(signature, draw->drawCount,
+                                         ToBackend(draw->indirectBuffer)->GetD3D12Resource().Get(),
+                                         draw->indirectOffset, countResource,
+                                         draw->countBufferOffset);
+        }
+
+        // Consecutive copies between the same two buffers that continue each other in both the
+        // source and the destination are recorded as a single CopyBufferRegion.
+        class BufferCopyBatch {
+          public:
+            void Append(CommandRecordingContext* commandContext,
+                        const CopyBufferToBufferCmd* copy) {
+                Buffer* source = ToBackend(copy->source.Get());
+                Buffer* destination = ToBackend(copy->destination.Get());
+                if (mSize > 0 && source == mSource && destination == mDestination &&
+                    copy->sourceOffset == mSourceOffset + mSize &&
+                    copy->destinationOffset == mDestinationOffset + mSize) {
+                    mSize += copy->size;
+                    return;
+                }
+
+                Record(commandContext);
+                mSource = source;
+                mDestination = destination;
+                mSourceOffset = copy->sourceOffset;
+                mDestinationOffset = copy->destinationOffset;
+                mSize = copy->size;
+            }
+
+            void Record(CommandRecordingContext* commandContext) {
+                if (mSize == 0) {
+                    return;
+                }
+
+                mSource->TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::CopySrc);
+                mDestination->TrackUsageAndTransitionNow(commandContext,
+                                                         wgpu::BufferUsage::CopyDst);
+                commandContext->GetCommandList()->CopyBufferRegion(
+                    mDestination->GetD3D12Resource().Get(), mDestinationOffset,
+                    mSource->GetD3D12Resource().Get(), mSourceOffset, mSize);
+                mSize = 0;
+            }
+
+          private:
+            Buffer* mSource = nullptr;
+            Buffer* mDestination = nullptr;
+            uint64_t mSourceOffset = 0;
+            uint64_t mDestinationOffset = 0;
+            uint64_t mSize = 0;
+        };
+
     }  // anonymous namespace
 
     class BindGroupStateTracker : public BindGroupAndStorageBarrierTrackerBase<false, uint64_t> {
@@ -78,9 +151,16 @@ namespace dawn_native { namespace d3d12 {
 
         void SetInComputePass(bool inCompute_) {
             mInCompute = inCompute_;
+            // The compute and graphics root arguments are separate.
+            mRootDescriptorLocations.fill(0);
         }
 
         MaybeError Apply(CommandRecordingContext* commandContext) {
+            // The root descriptors set for another root signature don't apply to this one.
+            if (mLastAppliedPipelineLayout != mPipelineLayout) {
+                mRootDescriptorLocations.fill(0);
+            }
+
             // Bindgroups are allocated in shader-visible descriptor heaps which are managed by a
             // ringbuffer. There can be a single shader-visible descriptor heap of each type bound
             // at any given time. This means that when we switch heaps, all other currently bound
@@ -90,9 +170,8 @@ namespace dawn_native { namespace d3d12 {
             // to occur on overflow.
             // TODO(bryan.bernhart@intel.com): Consider further optimization.
             bool didCreateBindGroups = true;
-            for (uint32_t index : IterateBitSet(mDirtyBindGroups)) {
-                DAWN_TRY_ASSIGN(didCreateBindGroups,
-                                ToBackend(mBindGroups[index])->Populate(mAllocator));
+            for (uint32_t index : IterateBitSetWords(mDirtyBindGroups)) {
+                DAWN_TRY_ASSIGN(didCreateBindGroups, PopulateBindGroup(index));
                 if (!didCreateBindGroups) {
                     break;
                 }
@@ -111,28 +190,28 @@ namespace dawn_native { namespace d3d12 {
                 // Must be called before applying the bindgroups.
                 SetID3D12DescriptorHeaps(commandList);
 
-                for (uint32_t index : IterateBitSet(mBindGroupLayoutsMask)) {
-                    DAWN_TRY_ASSIGN(didCreateBindGroups,
-                                    ToBackend(mBindGroups[index])->Populate(mAllocator));
+                for (uint32_t index : IterateBitSetWords(mBindGroupLayoutsMask)) {
+                    DAWN_TRY_ASSIGN(didCreateBindGroups, PopulateBindGroup(index));
                     ASSERT(didCreateBindGroups);
                 }
             }
 
-            for (uint32_t index : IterateBitSet(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
-                BindGroup* group = ToBackend(mBindGroups[index]);
-                ApplyBindGroup(commandList, ToBackend(mPipelineLayout), index, group,
+            for (uint32_t index : IterateBitSetWords(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
+                ApplyBindGroup(commandList, ToBackend(mPipelineLayout), index, mBindGroups[index],
                                mDynamicOffsetCounts[index], mDynamicOffsets[index].data());
             }
 
             if (mInCompute) {
-                for (uint32_t index : IterateBitSet(mBindGroupLayoutsMask)) {
-                    for (uint32_t binding : IterateBitSet(mBuffersNeedingBarrier[index])) {
+                for (uint32_t index : IterateBitSetWords(mBindGroupLayoutsMask)) {
+                    for (uint32_t binding : IterateBitSetWords(mBuffersNeedingBarrier[index])) {
                         wgpu::BindingType bindingType = mBindingTypes[index][binding];
                         switch (bindingType) {
                             case wgpu::BindingType::StorageBuffer:
-                                ToBackend(mBuffers[index][binding])
-                                    ->TrackUsageAndTransitionNow(commandContext,
-                                                                 wgpu::BufferUsage::Storage);
+                                if (NeedsStorageBarrier(mBuffers[index][binding])) {
+                                    ToBackend(mBuffers[index][binding])
+                                        ->TrackUsageAndTransitionNow(commandContext,
+                                                                     wgpu::BufferUsage::Storage);
+                                }
                                 break;
 
                             case wgpu::BindingType::StorageTexture:
@@ -158,6 +237,13 @@ namespace dawn_native { namespace d3d12 {
             return {};
         }
 
+        // The root signature or the descriptor heaps were changed outside of the tracker, so
+        // everything needs to be applied again.
+        void Invalidate() {
+            mLastAppliedPipelineLayout = nullptr;
+            mRootDescriptorLocations.fill(0);
+        }
+
         void SetID3D12DescriptorHeaps(ID3D12GraphicsCommandList* commandList) {
             ASSERT(commandList != nullptr);
             std::array<ID3D12DescriptorHeap*, 2> descriptorHeaps =
@@ -168,72 +254,76 @@ namespace dawn_native { namespace d3d12 {
         }
 
       private:
+        // Resource tables are set like bind groups, but own their descriptors.
+        ResultOrError<bool> PopulateBindGroup(uint32_t index) {
+            BindGroupBase* group = mBindGroups[index];
+            if (group->GetLayout()->IsResourceTableLayout()) {
+                return ToBackend(static_cast<ResourceTableBase*>(group))->Populate(mAllocator);
+            }
+            return ToBackend(group)->Populate(mAllocator);
+        }
+
         void ApplyBindGroup(ID3D12GraphicsCommandList* commandList,
                             const PipelineLayout* pipelineLayout,
                             uint32_t index,
-                            BindGroup* group,
+                            BindGroupBase* group,
                             uint32_t dynamicOffsetCount,
                             const uint64_t* dynamicOffsets) {
-            // Usually, the application won't set the same offsets many times,
-            // so always try to apply dynamic offsets even if the offsets stay the same
-            if (dynamicOffsetCount) {
-                // Update dynamic offsets
-                const BindGroupLayout::LayoutBindingInfo& layout =
-                    group->GetLayout()->GetBindingInfo();
-                uint32_t currentDynamicBufferIndex = 0;
-
-                for (uint32_t bindingIndex : IterateBitSet(layout.hasDynamicOffset)) {
-                    ASSERT(dynamicOffsetCount > 0);
-                    uint32_t parameterIndex =
-                        pipelineLayout->GetDynamicRootParameterIndex(index, bindingIndex);
-                    BufferBinding binding = group->GetBindingAsBufferBinding(bindingIndex);
-
-                    // Calculate buffer locations that root descriptors links to. The location
-                    // is (base buffer location + initial offset + dynamic offset)
-                    uint64_t dynamicOffset = dynamicOffsets[currentDynamicBufferIndex];
-                    uint64_t offset = binding.offset + dynamicOffset;
-                    D3D12_GPU_VIRTUAL_ADDRESS bufferLocation =
-                        ToBackend(binding.buffer)->GetVA() + offset;
-
-                    switch (layout.types[bindingIndex]) {
-                        case wgpu::BindingType::UniformBuffer:
-                            if (mInCompute) {
-                                commandList->SetComputeRootConstantBufferView(parameterIndex,
-                                                                              bufferLocation);
-                            } else {
-                                commandList->SetGraphicsRootConstantBufferView(parameterIndex,
-                                                                               bufferLocation);
-                            }
-                            break;
-                        case wgpu::BindingType::StorageBuffer:
-                            if (mInCompute) {
-                                commandList->SetComputeRootUnorderedAccessView(parameterIndex,
-                                                                               bufferLocation);
-                            } else {
-                                commandList->SetGraphicsRootUnorderedAccessView(parameterIndex,
-                                                                                bufferLocation);
-                            }
-                            break;
-                        case wgpu::BindingType::ReadonlyStorageBuffer:
-                            if (mInCompute) {
-                                commandList->SetComputeRootShaderResourceView(parameterIndex,
-                                                                              bufferLocation);
-                            } else {
-                                commandList->SetGraphicsRootShaderResourceView(parameterIndex,
-                                                                               bufferLocation);
-                            }
-                            break;
-                        case wgpu::BindingType::SampledTexture:
-                        case wgpu::BindingType::Sampler:
-                        case wgpu::BindingType::StorageTexture:
-                        case wgpu::BindingType::ReadonlyStorageTexture:
-                        case wgpu::BindingType::WriteonlyStorageTexture:
-                        case wgpu::BindingType::AccelerationContainer:
-                            UNREACHABLE();
-                            break;
-                    }
-
-                    ++currentDynamicBufferIndex;
+            // Usually, the application won't set the same offsets many times, but the same bind
+            // group is often set again with the same offsets. Skip root descriptors that would
+            // point to the same location as the ones already set.
+            const BindGroup::DynamicBufferBinding* dynamicBindings =
+                dynamicOffsetCount > 0 ? ToBackend(group)->GetDynamicBufferBindings() : nullptr;
+            for (uint32_t i = 0; i < dynamicOffsetCount; ++i) {
+                const BindGroup::DynamicBufferBinding& dynamicBinding = dynamicBindings[i];
+                uint32_t parameterIndex = pipelineLayout->GetDynamicRootParameterIndex(
+                    index, dynamicBinding.bindingIndex);
+
+                // Calculate buffer locations that root descriptors links to. The location
+                // is (base buffer location + initial offset + dynamic offset)
+                D3D12_GPU_VIRTUAL_ADDRESS bufferLocation =
+                    dynamicBinding.baseLocation + dynamicOffsets[i];
+                if (mRootDescriptorLocations[parameterIndex] == bufferLocation) {
+                    continue;
+                }
+                mRootDescriptorLocations[parameterIndex] = bufferLocation;
+
+                switch (dynamicBinding.type) {
+                    case wgpu::BindingType::UniformBuffer:
+                        if (mInCompute) {
+                            commandList->SetComputeRootConstantBufferView(parameterIndex,
+                                                                          bufferLocation);
+                        } else {
+                            commandList->SetGraphicsRootConstantBufferView(parameterIndex,
+                                                                           bufferLocation);
+                        }
+                        break;
+                    case wgpu::BindingType::StorageBuffer:
+                        if (mInCompute) {
+                            commandList->SetComputeRootUnorderedAccessView(parameterIndex,
+                                                                           bufferLocation);
+                        } else {
+                            commandList->SetGraphicsRootUnorderedAccessView(parameterIndex,
+                                                                            bufferLocation);
+                        }
+                        break;
+                    case wgpu::BindingType::ReadonlyStorageBuffer:
+                        if (mInCompute) {
+                            commandList->SetComputeRootShaderResourceView(parameterIndex,
+                                                                          bufferLocation);
+                        } else {
+                            commandList->SetGraphicsRootShaderResourceView(parameterIndex,
+                                                                           bufferLocation);
+                        }
+                        break;
+                    case wgpu::BindingType::SampledTexture:
+                    case wgpu::BindingType::Sampler:
+                    case wgpu::BindingType::StorageTexture:
+                    case wgpu::BindingType::ReadonlyStorageTexture:
+                    case wgpu::BindingType::WriteonlyStorageTexture:
+                    case wgpu::BindingType::AccelerationContainer:
+                        UNREACHABLE();
+                        break;
                 }
             }
 
@@ -250,7 +340,10 @@ namespace dawn_native { namespace d3d12 {
             if (cbvUavSrvCount > 0) {
                 uint32_t parameterIndex = pipelineLayout->GetCbvUavSrvRootParameterIndex(index);
                 const D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor =
-                    group->GetBaseCbvUavSrvDescriptor();
+                    group->GetLayout()->IsResourceTableLayout()
+                        ? ToBackend(static_cast<ResourceTableBase*>(group))
+                              ->GetBaseCbvUavSrvDescriptor()
+                        : ToBackend(group)->GetBaseCbvUavSrvDescriptor();
                 if (mInCompute) {
                     commandList->SetComputeRootDescriptorTable(parameterIndex, baseDescriptor);
                 } else {
@@ -261,7 +354,7 @@ namespace dawn_native { namespace d3d12 {
             if (samplerCount > 0) {
                 uint32_t parameterIndex = pipelineLayout->GetSamplerRootParameterIndex(index);
                 const D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor =
-                    group->GetBaseSamplerDescriptor();
+                    ToBackend(group)->GetBaseSamplerDescriptor();
                 if (mInCompute) {
                     commandList->SetComputeRootDescriptorTable(parameterIndex, baseDescriptor);
                 } else {
@@ -272,6 +365,10 @@ namespace dawn_native { namespace d3d12 {
 
         bool mInCompute = false;
 
+        // The locations of the root descriptors last set on the command list, zero when unknown.
+        std::array<D3D12_GPU_VIRTUAL_ADDRESS, PipelineLayout::kMaxRootParameterCount>
+            mRootDescriptorLocations = {};
+
         ShaderVisibleDescriptorAllocator* mAllocator;
     };
 
@@ -351,7 +448,7 @@ namespace dawn_native { namespace d3d12 {
                 if (mLastAppliedRenderPipeline != renderPipeline) {
                     mLastAppliedRenderPipeline = renderPipeline;
 
-                    for (uint32_t slot : IterateBitSet(vertexBufferSlotsUsed)) {
+                    for (uint32_t slot : IterateBitSetWords(vertexBufferSlotsUsed)) {
                         startSlot = std::min(startSlot, slot);
                         endSlot = std::max(endSlot, slot + 1);
                         mD3D12BufferViews[slot].StrideInBytes =
@@ -415,6 +512,29 @@ namespace dawn_native { namespace d3d12 {
             D3D12_INDEX_BUFFER_VIEW mD3D12BufferView = {};
         };
 
+        class PushConstantsStateTracker : public PushConstantsTracker {
+          public:
+            void Apply(ID3D12GraphicsCommandList* commandList, bool inCompute) {
+                if (!NeedsApply()) {
+                    return;
+                }
+
+                // Setting the root signature doesn't reset the root constants if it is the same
+                // one, and the tracker only dirties them when the layout changes.
+                const PipelineLayout* layout = ToBackend(mPipelineLayout);
+                uint32_t parameterIndex = layout->GetPushConstantsRootParameterIndex();
+                uint32_t valueCount = layout->GetPushConstantSize() / sizeof(uint32_t);
+                if (inCompute) {
+                    commandList->SetComputeRoot32BitConstants(parameterIndex, valueCount,
+                                                              mData.data(), 0);
+                } else {
+                    commandList->SetGraphicsRoot32BitConstants(parameterIndex, valueCount,
+                                                               mData.data(), 0);
+                }
+                DidApply();
+            }
+        };
+
         void ResolveMultisampledRenderPass(CommandRecordingContext* commandContext,
                                            BeginRenderPassCmd* renderPass) {
             ASSERT(renderPass != nullptr);
@@ -494,9 +614,10 @@ namespace dawn_native { namespace d3d12 {
                 // cleared during record render pass if the texture subresource has not been
                 // initialized before the render pass.
                 if (!(usages.textureUsages[i] & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(commandContext, 0,
-                                                                 texture->GetNumMipLevels(), 0,
-                                                                 texture->GetArrayLayers());
+                    const SubresourceRange& range = usages.textureRanges[i];
+                    texture->EnsureSubresourceContentInitialized(
+                        commandContext, range.baseMipLevel, range.levelCount,
+                        range.baseArrayLayer, range.layerCount);
                 }
             }
 
@@ -523,15 +644,23 @@ namespace dawn_native { namespace d3d12 {
         const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
         uint32_t nextPassNumber = 0;
 
+        // The copies batched so far are recorded before any other command.
+        BufferCopyBatch bufferCopies;
+
         Command type;
         while (mCommands.NextCommandId(&type)) {
+            if (type != Command::CopyBufferToBuffer) {
+                bufferCopies.Record(commandContext);
+            }
+
             switch (type) {
                 case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
+                    BeginComputePassCmd* cmd = mCommands.NextCommand<BeginComputePassCmd>();
 
                     PrepareResourcesForSubmission(commandContext,
                                                   passResourceUsages[nextPassNumber]);
                     bindingTracker.SetInComputePass(true);
+                    bindingTracker.OnBeginPass(cmd->independentDispatches);
                     DAWN_TRY(RecordComputePass(commandContext, &bindingTracker));
 
                     nextPassNumber++;
@@ -554,17 +683,7 @@ namespace dawn_native { namespace d3d12 {
 
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    Buffer* srcBuffer = ToBackend(copy->source.Get());
-                    Buffer* dstBuffer = ToBackend(copy->destination.Get());
-
-                    srcBuffer->TrackUsageAndTransitionNow(commandContext,
-                                                          wgpu::BufferUsage::CopySrc);
-                    dstBuffer->TrackUsageAndTransitionNow(commandContext,
-                                                          wgpu::BufferUsage::CopyDst);
-
-                    commandList->CopyBufferRegion(
-                        dstBuffer->GetD3D12Resource().Get(), copy->destinationOffset,
-                        srcBuffer->GetD3D12Resource().Get(), copy->sourceOffset, copy->size);
+                    bufferCopies.Append(commandContext, copy);
                 } break;
 
                 case Command::CopyBufferToTexture: {
@@ -693,9 +812,27 @@ namespace dawn_native { namespace d3d12 {
                     }
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    uint32_t layerCount = texture->GetArrayLayers();
+
+                    // The generated levels are overwritten entirely.
+                    texture->EnsureSubresourceContentInitialized(commandContext, cmd->baseMipLevel,
+                                                                 1, 0, layerCount);
+                    texture->SetIsSubresourceContentInitialized(true, cmd->baseMipLevel + 1,
+                                                                cmd->mipLevelCount - 1, 0,
+                                                                layerCount);
+
+                    DAWN_TRY(device->GetMipmapGenerator()->GenerateMipmaps(
+                        commandContext, texture, cmd->baseMipLevel, cmd->mipLevelCount));
+                    bindingTracker.Invalidate();
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
+        bufferCopies.Record(commandContext);
 
         return {};
     }
@@ -704,6 +841,7 @@ namespace dawn_native { namespace d3d12 {
                                                 BindGroupStateTracker* bindingTracker) {
         PipelineLayout* lastLayout = nullptr;
         ID3D12GraphicsCommandList* commandList = commandContext->GetCommandList();
+        PushConstantsStateTracker pushConstants = {};
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
@@ -712,6 +850,7 @@ namespace dawn_native { namespace d3d12 {
                     DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
+                    pushConstants.Apply(commandList, true);
                     commandList->Dispatch(dispatch->x, dispatch->y, dispatch->z);
                 } break;
 
@@ -719,7 +858,8 @@ namespace dawn_native { namespace d3d12 {
                     DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
-                    Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
+                    pushConstants.Apply(commandList, true);
+                    Buffer* buffer = ToBackend(dispatch->indirectBuffer);
                     ComPtr<ID3D12CommandSignature> signature =
                         ToBackend(GetDevice())->GetDispatchIndirectSignature();
                     commandList->ExecuteIndirect(signature.Get(), 1,
@@ -734,25 +874,29 @@ namespace dawn_native { namespace d3d12 {
 
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                    ComputePipeline* pipeline = ToBackend(cmd->pipeline);
                     PipelineLayout* layout = ToBackend(pipeline->GetLayout());
 
                     commandList->SetComputeRootSignature(layout->GetRootSignature().Get());
                     commandList->SetPipelineState(pipeline->GetPipelineState().Get());
 
                     bindingTracker->OnSetPipeline(pipeline);
+                    pushConstants.OnSetPipeline(pipeline);
 
                     lastLayout = layout;
                 } break;
 
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = mCommands.NextCommand<SetPushConstantsCmd>();
+                    const uint8_t* data = mCommands.NextData<uint8_t>(cmd->size);
+                    pushConstants.OnSetPushConstants(cmd->offset, cmd->size, data);
+                } break;
+
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    BindGroup* group = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    // Resource tables are recorded as bind groups too.
+                    BindGroupBase* group = cmd->group;
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(&mCommands, cmd);
 
                     bindingTracker->OnSetBindGroup(cmd->index, group, cmd->dynamicOffsetCount,
                                                    dynamicOffsets);
@@ -794,6 +938,17 @@ namespace dawn_native { namespace d3d12 {
                     }
                 } break;
 
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* cmd =
+                        mCommands.NextCommand<BeginConditionalRenderingCmd>();
+                    RecordSetPredication(commandList, cmd);
+                } break;
+
+                case Command::EndConditionalRendering: {
+                    mCommands.NextCommand<EndConditionalRenderingCmd>();
+                    commandList->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
@@ -966,6 +1121,7 @@ namespace dawn_native { namespace d3d12 {
         PipelineLayout* lastLayout = nullptr;
         VertexBufferTracker vertexBufferTracker = {};
         IndexBufferTracker indexBufferTracker = {};
+        PushConstantsStateTracker pushConstants = {};
 
         auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) -> MaybeError {
             switch (type) {
@@ -973,6 +1129,7 @@ namespace dawn_native { namespace d3d12 {
                     DrawCmd* draw = iter->NextCommand<DrawCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
+                    pushConstants.Apply(commandList, false);
                     vertexBufferTracker.Apply(commandList, lastPipeline);
                     commandList->DrawInstanced(draw->vertexCount, draw->instanceCount,
                                                draw->firstVertex, draw->firstInstance);
@@ -982,6 +1139,7 @@ namespace dawn_native { namespace d3d12 {
                     DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
+                    pushConstants.Apply(commandList, false);
                     indexBufferTracker.Apply(commandList);
                     vertexBufferTracker.Apply(commandList, lastPipeline);
                     commandList->DrawIndexedInstanced(draw->indexCount, draw->instanceCount,
@@ -993,27 +1151,23 @@ namespace dawn_native { namespace d3d12 {
                     DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
+                    pushConstants.Apply(commandList, false);
                     vertexBufferTracker.Apply(commandList, lastPipeline);
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
                     ComPtr<ID3D12CommandSignature> signature =
                         ToBackend(GetDevice())->GetDrawIndirectSignature();
-                    commandList->ExecuteIndirect(signature.Get(), 1,
-                                                 buffer->GetD3D12Resource().Get(),
-                                                 draw->indirectOffset, nullptr, 0);
+                    ExecuteDrawIndirect(commandList, signature.Get(), draw);
                 } break;
 
                 case Command::DrawIndexedIndirect: {
                     DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
 
                     DAWN_TRY(bindingTracker->Apply(commandContext));
+                    pushConstants.Apply(commandList, false);
                     indexBufferTracker.Apply(commandList);
                     vertexBufferTracker.Apply(commandList, lastPipeline);
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
                     ComPtr<ID3D12CommandSignature> signature =
                         ToBackend(GetDevice())->GetDrawIndexedIndirectSignature();
-                    commandList->ExecuteIndirect(signature.Get(), 1,
-                                                 buffer->GetD3D12Resource().Get(),
-                                                 draw->indirectOffset, nullptr, 0);
+                    ExecuteDrawIndirect(commandList, signature.Get(), draw);
                 } break;
 
                 case Command::InsertDebugMarker: {
@@ -1054,7 +1208,7 @@ namespace dawn_native { namespace d3d12 {
 
                 case Command::SetRenderPipeline: {
                     SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                    RenderPipeline* pipeline = ToBackend(cmd->pipeline);
                     PipelineLayout* layout = ToBackend(pipeline->GetLayout());
 
                     commandList->SetGraphicsRootSignature(layout->GetRootSignature().Get());
@@ -1063,19 +1217,23 @@ namespace dawn_native { namespace d3d12 {
 
                     bindingTracker->OnSetPipeline(pipeline);
                     indexBufferTracker.OnSetPipeline(pipeline);
+                    pushConstants.OnSetPipeline(pipeline);
 
                     lastPipeline = pipeline;
                     lastLayout = layout;
                 } break;
 
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = iter->NextCommand<SetPushConstantsCmd>();
+                    const uint8_t* data = iter->NextData<uint8_t>(cmd->size);
+                    pushConstants.OnSetPushConstants(cmd->offset, cmd->size, data);
+                } break;
+
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    BindGroup* group = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    // Resource tables are recorded as bind groups too.
+                    BindGroupBase* group = cmd->group;
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(iter, cmd);
 
                     bindingTracker->OnSetBindGroup(cmd->index, group, cmd->dynamicOffsetCount,
                                                    dynamicOffsets);
@@ -1084,13 +1242,13 @@ namespace dawn_native { namespace d3d12 {
                 case Command::SetIndexBuffer: {
                     SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
 
-                    indexBufferTracker.OnSetIndexBuffer(ToBackend(cmd->buffer.Get()), cmd->offset);
+                    indexBufferTracker.OnSetIndexBuffer(ToBackend(cmd->buffer), cmd->offset);
                 } break;
 
                 case Command::SetVertexBuffer: {
                     SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
 
-                    vertexBufferTracker.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
+                    vertexBufferTracker.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer),
                                                           cmd->offset);
                 } break;
 
@@ -1162,6 +1320,17 @@ namespace dawn_native { namespace d3d12 {
                     }
                 } break;
 
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* cmd =
+                        mCommands.NextCommand<BeginConditionalRenderingCmd>();
+                    RecordSetPredication(commandList, cmd);
+                } break;
+
+                case Command::EndConditionalRendering: {
+                    mCommands.NextCommand<EndConditionalRenderingCmd>();
+                    commandList->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+                } break;
+
                 default: { DAWN_TRY(EncodeRenderBundleCommand(&mCommands, type)); } break;
             }
         }
@@ -88,6 +88,16 @@ namespace dawn_native { namespace d3d12 {
         }
     }
 
+    void CommandRecordingContext::AddAliasingBarrier(ID3D12Resource* resource) {
+        D3D12_RESOURCE_BARRIER barrier;
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        // A null resource before the barrier means any of the resources that used the memory.
+        barrier.Aliasing.pResourceBefore = nullptr;
+        barrier.Aliasing.pResourceAfter = resource;
+        GetCommandList()->ResourceBarrier(1, &barrier);
+    }
+
     ID3D12GraphicsCommandList* CommandRecordingContext::GetCommandList() const {
         ASSERT(mD3d12CommandList != nullptr);
         ASSERT(IsOpen());
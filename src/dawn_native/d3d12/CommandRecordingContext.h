@@ -39,6 +39,10 @@ namespace dawn_native { namespace d3d12 {
 
         void TrackHeapUsage(Heap* heap, Serial serial);
 
+        // Records a barrier before the first use of a placed resource whose memory may have been
+        // used by other placed resources.
+        void AddAliasingBarrier(ID3D12Resource* resource);
+
       private:
         ComPtr<ID3D12GraphicsCommandList> mD3d12CommandList;
         ComPtr<ID3D12GraphicsCommandList4> mD3d12CommandList4;
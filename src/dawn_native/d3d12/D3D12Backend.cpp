@@ -18,6 +18,7 @@
 #include "dawn_native/D3D12Backend.h"
 
 #include "common/SwapChainUtils.h"
+#include "dawn_native/d3d12/BufferD3D12.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
 #include "dawn_native/d3d12/NativeSwapChainImplD3D12.h"
 #include "dawn_native/d3d12/TextureD3D12.h"
@@ -46,6 +47,17 @@ namespace dawn_native { namespace d3d12 {
         return static_cast<WGPUTextureFormat>(impl->GetPreferredFormat());
     }
 
+    uint64_t DefragmentBufferMemory(WGPUDevice device, uint64_t maxRelocatedSize) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+
+        uint64_t relocatedSize = 0;
+        if (backendDevice->ConsumedError(
+                backendDevice->DefragmentBufferMemory(maxRelocatedSize, &relocatedSize))) {
+            return 0;
+        }
+        return relocatedSize;
+    }
+
     ExternalImageDescriptorDXGISharedHandle::ExternalImageDescriptorDXGISharedHandle()
         : ExternalImageDescriptor(ExternalImageDescriptorType::DXGISharedHandle) {
     }
@@ -58,4 +70,27 @@ namespace dawn_native { namespace d3d12 {
         return reinterpret_cast<WGPUTexture>(texture);
     }
 
+    ExternalBufferDescriptorDXGISharedHandle::ExternalBufferDescriptorDXGISharedHandle()
+        : ExternalBufferDescriptor(ExternalImageDescriptorType::DXGISharedHandle) {
+    }
+
+    WGPUBuffer WrapSharedHandle(WGPUDevice device,
+                                const ExternalBufferDescriptorDXGISharedHandle* descriptor) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        BufferBase* buffer = backendDevice->WrapSharedBufferHandle(
+            descriptor, descriptor->sharedHandle, descriptor->fenceSharedHandle,
+            descriptor->fenceWaitValue);
+        return reinterpret_cast<WGPUBuffer>(buffer);
+    }
+
+    bool ReleaseSharedBuffer(WGPUDevice device, WGPUBuffer buffer, uint64_t fenceSignalValue) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        Buffer* backendBuffer = reinterpret_cast<Buffer*>(buffer);
+        if (backendBuffer == nullptr) {
+            return false;
+        }
+        return !backendDevice->ConsumedError(
+            backendDevice->ReleaseSharedBuffer(backendBuffer, fenceSignalValue));
+    }
+
 }}  // namespace dawn_native::d3d12
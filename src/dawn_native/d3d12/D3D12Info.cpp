@@ -36,17 +36,25 @@ namespace dawn_native { namespace d3d12 {
 
         info.isUMA = arch.UMA;
 
+        LARGE_INTEGER umdVersion;
+        DAWN_TRY(CheckHRESULT(
+            adapter.GetHardwareAdapter()->CheckInterfaceSupport(__uuidof(IDXGIDevice), &umdVersion),
+            "IDXGIAdapter::CheckInterfaceSupport"));
+        info.driverVersion = static_cast<uint64_t>(umdVersion.QuadPart);
+
         D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
         DAWN_TRY(CheckHRESULT(adapter.GetDevice()->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS,
                                                                        &options, sizeof(options)),
                               "ID3D12Device::CheckFeatureSupport"));
 
         info.resourceHeapTier = options.ResourceHeapTier;
+        info.resourceBindingTier = options.ResourceBindingTier;
 
         // Windows builds 1809 and above can use the D3D12 render pass API. If we query
         // CheckFeatureSupport for D3D12_FEATURE_D3D12_OPTIONS5 successfully, then we can use
         // the render pass API.
         info.supportsRenderPass = false;
+        info.supportsRayTracing = false;
         D3D12_FEATURE_DATA_D3D12_OPTIONS5 featureOptions5 = {};
         if (SUCCEEDED(adapter.GetDevice()->CheckFeatureSupport(
                 D3D12_FEATURE_D3D12_OPTIONS5, &featureOptions5, sizeof(featureOptions5)))) {
@@ -57,6 +65,8 @@ namespace dawn_native { namespace d3d12 {
                 !gpu_info::IsIntel(adapter.GetPCIInfo().vendorId)) {
                 info.supportsRenderPass = true;
             }
+            info.supportsRayTracing =
+                featureOptions5.RaytracingTier >= D3D12_RAYTRACING_TIER_1_0;
         }
 
         return info;
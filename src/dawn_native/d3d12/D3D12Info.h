@@ -24,8 +24,12 @@ namespace dawn_native { namespace d3d12 {
 
     struct D3D12DeviceInfo {
         bool isUMA;
+        // The version of the user mode driver.
+        uint64_t driverVersion;
         uint32_t resourceHeapTier;
+        uint32_t resourceBindingTier;
         bool supportsRenderPass;
+        bool supportsRayTracing;
     };
 
     ResultOrError<D3D12DeviceInfo> GatherDeviceInfo(const Adapter& adapter);
@@ -16,6 +16,8 @@
 
 #include "common/Assert.h"
 #include "dawn_native/BackendConnection.h"
+#include "dawn_native/CommandBuffer.h"
+#include "dawn_native/Commands.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/d3d12/AdapterD3D12.h"
@@ -28,17 +30,21 @@
 #include "dawn_native/d3d12/ComputePipelineD3D12.h"
 #include "dawn_native/d3d12/D3D12Error.h"
 #include "dawn_native/d3d12/DescriptorHeapAllocator.h"
+#include "dawn_native/d3d12/MipmapGeneratorD3D12.h"
 #include "dawn_native/d3d12/PipelineLayoutD3D12.h"
 #include "dawn_native/d3d12/PlatformFunctions.h"
 #include "dawn_native/d3d12/QueueD3D12.h"
 #include "dawn_native/d3d12/RenderPipelineD3D12.h"
 #include "dawn_native/d3d12/ResourceAllocatorManagerD3D12.h"
+#include "dawn_native/d3d12/ResourceTableD3D12.h"
 #include "dawn_native/d3d12/SamplerD3D12.h"
 #include "dawn_native/d3d12/ShaderModuleD3D12.h"
 #include "dawn_native/d3d12/ShaderVisibleDescriptorAllocatorD3D12.h"
 #include "dawn_native/d3d12/StagingBufferD3D12.h"
 #include "dawn_native/d3d12/SwapChainD3D12.h"
+#include "dawn_native/d3d12/TextureCopySplitter.h"
 #include "dawn_native/d3d12/TextureD3D12.h"
+#include "dawn_native/d3d12/UtilsD3D12.h"
 
 namespace dawn_native { namespace d3d12 {
 
@@ -69,6 +75,21 @@ namespace dawn_native { namespace d3d12 {
 
         mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
         ASSERT(mFenceEvent != nullptr);
+        mCompletionThreadFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        ASSERT(mCompletionThreadFenceEvent != nullptr);
+
+        // DXC is optional, fall back to FXC when it isn't installed.
+        if (IsToggleEnabled(Toggle::UseDXC) && !GetFunctions()->IsDXCAvailable()) {
+            SetToggle(Toggle::UseDXC, false);
+        }
+        if (IsToggleEnabled(Toggle::UseDXC)) {
+            DAWN_TRY(CheckHRESULT(
+                GetFunctions()->dxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&mDxcLibrary)),
+                "DXC create library"));
+            DAWN_TRY(CheckHRESULT(
+                GetFunctions()->dxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&mDxcCompiler)),
+                "DXC create compiler"));
+        }
 
         // Initialize backend services
         mCommandAllocatorManager = std::make_unique<CommandAllocatorManager>(this);
@@ -79,6 +100,7 @@ namespace dawn_native { namespace d3d12 {
         DAWN_TRY(mShaderVisibleDescriptorAllocator->Initialize());
 
         mMapRequestTracker = std::make_unique<MapRequestTracker>(this);
+        mMipmapGenerator = std::make_unique<MipmapGenerator>(this);
         mResourceAllocatorManager = std::make_unique<ResourceAllocatorManager>(this);
 
         DAWN_TRY(NextSerial());
@@ -146,6 +168,16 @@ namespace dawn_native { namespace d3d12 {
         return ToBackend(GetAdapter())->GetBackend()->GetFunctions();
     }
 
+    IDxcLibrary* Device::GetDxcLibrary() const {
+        ASSERT(mDxcLibrary != nullptr);
+        return mDxcLibrary.Get();
+    }
+
+    IDxcCompiler* Device::GetDxcCompiler() const {
+        ASSERT(mDxcCompiler != nullptr);
+        return mDxcCompiler.Get();
+    }
+
     MapRequestTracker* Device::GetMapRequestTracker() const {
         return mMapRequestTracker.get();
     }
@@ -209,6 +241,20 @@ namespace dawn_native { namespace d3d12 {
         return {};
     }
 
+    bool Device::WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs) {
+        // ID3D12Fence can be used from any thread.
+        if (mFence->GetCompletedValue() >= serial) {
+            return true;
+        }
+        if (FAILED(mFence->SetEventOnCompletion(serial, mCompletionThreadFenceEvent))) {
+            return false;
+        }
+        WaitForSingleObject(mCompletionThreadFenceEvent,
+                            static_cast<DWORD>(timeoutNs / (1000ull * 1000ull)));
+        // The event can also have been set by the completion of a previous wait that timed out.
+        return mFence->GetCompletedValue() >= serial;
+    }
+
     void Device::ReferenceUntilUnused(ComPtr<IUnknown> object) {
         mUsedComObjectRefs.Enqueue(object, GetPendingCommandSerial());
     }
@@ -217,6 +263,28 @@ namespace dawn_native { namespace d3d12 {
         return mPendingCommands.ExecuteCommandList(mCommandQueue.Get());
     }
 
+    const char* Device::GetRayTracingUnsupportedReason() const {
+        // DXR state objects need DXIL libraries (lib_6_3), which the FXC based shader compilation
+        // of this backend can't produce, so ray tracing isn't implemented on D3D12 yet.
+        if (GetDeviceInfo().supportsRayTracing) {
+            return "Ray tracing isn't implemented on the D3D12 backend yet";
+        }
+        return "Ray tracing requires D3D12_RAYTRACING_TIER_1_0";
+    }
+
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    Device::CreateRayTracingAccelerationContainerImpl(
+        const RayTracingAccelerationContainerDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR(GetRayTracingUnsupportedReason());
+    }
+    ResultOrError<RayTracingShaderBindingTableBase*> Device::CreateRayTracingShaderBindingTableImpl(
+        const RayTracingShaderBindingTableDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR(GetRayTracingUnsupportedReason());
+    }
+    ResultOrError<RayTracingPipelineBase*> Device::CreateRayTracingPipelineImpl(
+        const RayTracingPipelineDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR(GetRayTracingUnsupportedReason());
+    }
     ResultOrError<BindGroupBase*> Device::CreateBindGroupImpl(
         const BindGroupDescriptor* descriptor) {
         return BindGroup::Create(this, descriptor);
@@ -242,13 +310,20 @@ namespace dawn_native { namespace d3d12 {
         const PipelineLayoutDescriptor* descriptor) {
         return PipelineLayout::Create(this, descriptor);
     }
-    ResultOrError<QueueBase*> Device::CreateQueueImpl() {
-        return new Queue(this);
+    ResultOrError<QuerySetBase*> Device::CreateQuerySetImpl(const QuerySetDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Query sets aren't implemented on the D3D12 backend yet");
+    }
+    ResultOrError<QueueBase*> Device::CreateQueueImpl(const QueueDescriptor* descriptor) {
+        return new Queue(this, descriptor);
     }
     ResultOrError<RenderPipelineBase*> Device::CreateRenderPipelineImpl(
         const RenderPipelineDescriptor* descriptor) {
         return RenderPipeline::Create(this, descriptor);
     }
+    ResultOrError<ResourceTableBase*> Device::CreateResourceTableImpl(
+        const ResourceTableDescriptor* descriptor) {
+        return ResourceTable::Create(this, descriptor);
+    }
     ResultOrError<SamplerBase*> Device::CreateSamplerImpl(const SamplerDescriptor* descriptor) {
         return new Sampler(this, descriptor);
     }
@@ -302,6 +377,50 @@ namespace dawn_native { namespace d3d12 {
         return {};
     }
 
+    MaybeError Device::CopyFromStagingToTexture(StagingBufferBase* source,
+                                                uint64_t sourceOffset,
+                                                uint32_t rowPitch,
+                                                uint32_t imageHeight,
+                                                const TextureCopy& destination,
+                                                const Extent3D& copySize) {
+        CommandRecordingContext* commandContext;
+        DAWN_TRY_ASSIGN(commandContext, GetPendingCommandContext());
+        Texture* texture = ToBackend(destination.texture.Get());
+        StagingBuffer* stagingBuffer = ToBackend(source);
+
+        if (IsCompleteSubresourceCopiedTo(texture, copySize, destination.mipLevel)) {
+            texture->SetIsSubresourceContentInitialized(true, destination.mipLevel, 1,
+                                                        destination.arrayLayer, 1);
+        } else {
+            texture->EnsureSubresourceContentInitialized(commandContext, destination.mipLevel, 1,
+                                                         destination.arrayLayer, 1);
+        }
+        texture->TrackUsageAndTransitionNow(commandContext, wgpu::TextureUsage::CopyDst);
+        stagingBuffer->TrackUsage(commandContext);
+
+        TextureCopySplit copySplit =
+            ComputeTextureCopySplit(destination.origin, copySize, texture->GetFormat(),
+                                    sourceOffset, rowPitch, imageHeight);
+        D3D12_TEXTURE_COPY_LOCATION textureLocation = ComputeTextureCopyLocationForTexture(
+            texture, destination.mipLevel, destination.arrayLayer);
+
+        for (uint32_t i = 0; i < copySplit.count; ++i) {
+            TextureCopySplit::CopyInfo& info = copySplit.copies[i];
+
+            D3D12_TEXTURE_COPY_LOCATION bufferLocation = ComputeBufferLocationForCopyTextureRegion(
+                texture, stagingBuffer->GetResource(), info.bufferSize, copySplit.offset,
+                rowPitch);
+            D3D12_BOX sourceRegion =
+                ComputeD3D12BoxFromOffsetAndSize(info.bufferOffset, info.copySize);
+
+            commandContext->GetCommandList()->CopyTextureRegion(
+                &textureLocation, info.textureOffset.x, info.textureOffset.y,
+                info.textureOffset.z, &bufferLocation, &sourceRegion);
+        }
+
+        return {};
+    }
+
     void Device::DeallocateMemory(ResourceHeapAllocation& allocation) {
         mResourceAllocatorManager->DeallocateMemory(allocation);
     }
@@ -309,9 +428,38 @@ namespace dawn_native { namespace d3d12 {
     ResultOrError<ResourceHeapAllocation> Device::AllocateMemory(
         D3D12_HEAP_TYPE heapType,
         const D3D12_RESOURCE_DESC& resourceDescriptor,
-        D3D12_RESOURCE_STATES initialUsage) {
+        D3D12_RESOURCE_STATES initialUsage,
+        wgpu::ResidencyPriority priority) {
         return mResourceAllocatorManager->AllocateMemory(heapType, resourceDescriptor,
-                                                         initialUsage);
+                                                         initialUsage, priority);
+    }
+
+    ResultOrError<ResourceHeapAllocation> Device::AllocateTransientMemory(
+        D3D12_HEAP_TYPE heapType,
+        const D3D12_RESOURCE_DESC& resourceDescriptor,
+        D3D12_RESOURCE_STATES initialUsage) {
+        return mResourceAllocatorManager->AllocateTransientMemory(heapType, resourceDescriptor,
+                                                                  initialUsage);
+    }
+
+    ResourceAllocatorManager* Device::GetResourceAllocatorManager() const {
+        return mResourceAllocatorManager.get();
+    }
+
+    std::vector<MemoryTypeUsage> Device::GetMemoryTypeUsagesImpl() const {
+        // The allocator manager is destroyed when the device shuts down.
+        if (mResourceAllocatorManager == nullptr) {
+            return {};
+        }
+        return mResourceAllocatorManager->GetMemoryTypeUsages();
+    }
+
+    MaybeError Device::DefragmentBufferMemory(uint64_t maxRelocatedSize,
+                                              uint64_t* relocatedSize) {
+        CommandRecordingContext* commandContext;
+        DAWN_TRY_ASSIGN(commandContext, GetPendingCommandContext());
+        return mResourceAllocatorManager->Defragment(commandContext, maxRelocatedSize,
+                                                     relocatedSize);
     }
 
     TextureBase* Device::WrapSharedHandle(const ExternalImageDescriptor* descriptor,
@@ -325,6 +473,27 @@ namespace dawn_native { namespace d3d12 {
         return dawnTexture;
     }
 
+    BufferBase* Device::WrapSharedBufferHandle(const ExternalBufferDescriptor* descriptor,
+                                               HANDLE sharedHandle,
+                                               HANDLE fenceSharedHandle,
+                                               uint64_t fenceWaitValue) {
+        const BufferDescriptor* bufferDescriptor =
+            reinterpret_cast<const BufferDescriptor*>(descriptor->cBufferDescriptor);
+
+        BufferBase* dawnBuffer;
+        if (ConsumedError(Buffer::CreateFromSharedHandle(this, bufferDescriptor, sharedHandle,
+                                                         fenceSharedHandle, fenceWaitValue),
+                          &dawnBuffer))
+            return nullptr;
+
+        return dawnBuffer;
+    }
+
+    MaybeError Device::ReleaseSharedBuffer(Buffer* buffer, uint64_t fenceSignalValue) {
+        DAWN_TRY(ValidateObject(buffer));
+        return buffer->SignalAndDestroy(fenceSignalValue);
+    }
+
     // We use IDXGIKeyedMutexes to synchronize access between D3D11 and D3D12. D3D11/12 fences
     // are a viable alternative but are, unfortunately, not available on all versions of Windows
     // 10. Since D3D12 does not directly support keyed mutexes, we need to wrap the D3D12
@@ -434,6 +603,14 @@ namespace dawn_native { namespace d3d12 {
         if (mFenceEvent != nullptr) {
             ::CloseHandle(mFenceEvent);
         }
+        if (mCompletionThreadFenceEvent != nullptr) {
+            ::CloseHandle(mCompletionThreadFenceEvent);
+        }
+
+        // This also releases the heaps kept for transient resources.
+        if (mResourceAllocatorManager != nullptr) {
+            mResourceAllocatorManager->Tick(mCompletedSerial);
+        }
 
         mUsedComObjectRefs.ClearUpTo(mCompletedSerial);
 
@@ -444,4 +621,8 @@ namespace dawn_native { namespace d3d12 {
     ShaderVisibleDescriptorAllocator* Device::GetShaderVisibleDescriptorAllocator() const {
         return mShaderVisibleDescriptorAllocator.get();
     }
+
+    MipmapGenerator* Device::GetMipmapGenerator() const {
+        return mMipmapGenerator.get();
+    }
 }}  // namespace dawn_native::d3d12
@@ -32,6 +32,7 @@ namespace dawn_native { namespace d3d12 {
     class DescriptorHeapAllocator;
     class ShaderVisibleDescriptorAllocator;
     class MapRequestTracker;
+    class MipmapGenerator;
     class PlatformFunctions;
     class ResourceAllocatorManager;
 
@@ -55,6 +56,7 @@ namespace dawn_native { namespace d3d12 {
         Serial GetCompletedCommandSerial() const final override;
         Serial GetLastSubmittedCommandSerial() const final override;
         MaybeError TickImpl() override;
+        bool WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs) override;
 
         ComPtr<ID3D12Device> GetD3D12Device() const;
         ComPtr<ID3D12CommandQueue> GetCommandQueue() const;
@@ -70,6 +72,10 @@ namespace dawn_native { namespace d3d12 {
         const PlatformFunctions* GetFunctions() const;
         ComPtr<IDXGIFactory4> GetFactory() const;
 
+        // Only valid when the UseDXC toggle is enabled.
+        IDxcLibrary* GetDxcLibrary() const;
+        IDxcCompiler* GetDxcCompiler() const;
+
         ResultOrError<CommandRecordingContext*> GetPendingCommandContext();
         Serial GetPendingCommandSerial() const override;
 
@@ -88,15 +94,30 @@ namespace dawn_native { namespace d3d12 {
                                            BufferBase* destination,
                                            uint64_t destinationOffset,
                                            uint64_t size) override;
+        MaybeError CopyFromStagingToTexture(StagingBufferBase* source,
+                                            uint64_t sourceOffset,
+                                            uint32_t rowPitch,
+                                            uint32_t imageHeight,
+                                            const TextureCopy& destination,
+                                            const Extent3D& copySize) override;
 
         ResultOrError<ResourceHeapAllocation> AllocateMemory(
+            D3D12_HEAP_TYPE heapType,
+            const D3D12_RESOURCE_DESC& resourceDescriptor,
+            D3D12_RESOURCE_STATES initialUsage,
+            wgpu::ResidencyPriority priority = wgpu::ResidencyPriority::Normal);
+        ResultOrError<ResourceHeapAllocation> AllocateTransientMemory(
             D3D12_HEAP_TYPE heapType,
             const D3D12_RESOURCE_DESC& resourceDescriptor,
             D3D12_RESOURCE_STATES initialUsage);
 
         void DeallocateMemory(ResourceHeapAllocation& allocation);
 
+        ResourceAllocatorManager* GetResourceAllocatorManager() const;
+        MaybeError DefragmentBufferMemory(uint64_t maxRelocatedSize, uint64_t* relocatedSize);
+
         ShaderVisibleDescriptorAllocator* GetShaderVisibleDescriptorAllocator() const;
+        MipmapGenerator* GetMipmapGenerator() const;
 
         TextureBase* WrapSharedHandle(const ExternalImageDescriptor* descriptor,
                                       HANDLE sharedHandle,
@@ -105,22 +126,26 @@ namespace dawn_native { namespace d3d12 {
             ID3D12Resource* d3d12Resource);
         void ReleaseKeyedMutexForTexture(ComPtr<IDXGIKeyedMutex> dxgiKeyedMutex);
 
+        BufferBase* WrapSharedBufferHandle(const ExternalBufferDescriptor* descriptor,
+                                           HANDLE sharedHandle,
+                                           HANDLE fenceSharedHandle,
+                                           uint64_t fenceWaitValue);
+        MaybeError ReleaseSharedBuffer(Buffer* buffer, uint64_t fenceSignalValue);
+
         void InitTogglesFromDriver();
 
       private:
+        std::vector<MemoryTypeUsage> GetMemoryTypeUsagesImpl() const override;
+
+        const char* GetRayTracingUnsupportedReason() const;
+
         ResultOrError<RayTracingAccelerationContainerBase*>
         CreateRayTracingAccelerationContainerImpl(
-            const RayTracingAccelerationContainerDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingAccelerationContainerDescriptor* descriptor) override;
         ResultOrError<RayTracingShaderBindingTableBase*> CreateRayTracingShaderBindingTableImpl(
-            const RayTracingShaderBindingTableDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingShaderBindingTableDescriptor* descriptor) override;
         ResultOrError<RayTracingPipelineBase*> CreateRayTracingPipelineImpl(
-            const RayTracingPipelineDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingPipelineDescriptor* descriptor) override;
         ResultOrError<BindGroupBase*> CreateBindGroupImpl(
             const BindGroupDescriptor* descriptor) override;
         ResultOrError<BindGroupLayoutBase*> CreateBindGroupLayoutImpl(
@@ -130,9 +155,13 @@ namespace dawn_native { namespace d3d12 {
             const ComputePipelineDescriptor* descriptor) override;
         ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) override;
-        ResultOrError<QueueBase*> CreateQueueImpl() override;
+        ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) override;
         ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) override;
+        ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) override;
         ResultOrError<SamplerBase*> CreateSamplerImpl(const SamplerDescriptor* descriptor) override;
         ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
             const ShaderModuleDescriptor* descriptor) override;
@@ -154,6 +183,8 @@ namespace dawn_native { namespace d3d12 {
         Serial mLastSubmittedSerial = 0;
         ComPtr<ID3D12Fence> mFence;
         HANDLE mFenceEvent = nullptr;
+        // Only used by the completion thread.
+        HANDLE mCompletionThreadFenceEvent = nullptr;
 
         ComPtr<ID3D12Device> mD3d12Device;  // Device is owned by adapter and will not be outlived.
         ComPtr<ID3D12CommandQueue> mCommandQueue;
@@ -166,6 +197,9 @@ namespace dawn_native { namespace d3d12 {
         ComPtr<ID3D12CommandSignature> mDrawIndirectSignature;
         ComPtr<ID3D12CommandSignature> mDrawIndexedIndirectSignature;
 
+        ComPtr<IDxcLibrary> mDxcLibrary;
+        ComPtr<IDxcCompiler> mDxcCompiler;
+
         CommandRecordingContext mPendingCommands;
 
         SerialQueue<ComPtr<IUnknown>> mUsedComObjectRefs;
@@ -173,6 +207,7 @@ namespace dawn_native { namespace d3d12 {
         std::unique_ptr<CommandAllocatorManager> mCommandAllocatorManager;
         std::unique_ptr<DescriptorHeapAllocator> mDescriptorHeapAllocator;
         std::unique_ptr<MapRequestTracker> mMapRequestTracker;
+        std::unique_ptr<MipmapGenerator> mMipmapGenerator;
         std::unique_ptr<ResourceAllocatorManager> mResourceAllocatorManager;
         std::unique_ptr<ShaderVisibleDescriptorAllocator> mShaderVisibleDescriptorAllocator;
     };
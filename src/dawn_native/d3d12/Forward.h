@@ -32,6 +32,7 @@ namespace dawn_native { namespace d3d12 {
     class RayTracingAccelerationContainer;
     class RayTracingShaderBindingTable;
     class RenderPipeline;
+    class ResourceTable;
     class Sampler;
     class ShaderModule;
     class StagingBuffer;
@@ -52,6 +53,7 @@ namespace dawn_native { namespace d3d12 {
         using RayTracingAccelerationContainerType = RayTracingAccelerationContainer;
         using RayTracingShaderBindingTableType = RayTracingShaderBindingTable;
         using RenderPipelineType = RenderPipeline;
+        using ResourceTableType = ResourceTable;
         using ResourceHeapType = Heap;
         using SamplerType = Sampler;
         using ShaderModuleType = ShaderModule;
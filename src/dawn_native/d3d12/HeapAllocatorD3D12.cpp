@@ -21,8 +21,9 @@ namespace dawn_native { namespace d3d12 {
 
     HeapAllocator::HeapAllocator(Device* device,
                                  D3D12_HEAP_TYPE heapType,
-                                 D3D12_HEAP_FLAGS heapFlags)
-        : mDevice(device), mHeapType(heapType), mHeapFlags(heapFlags) {
+                                 D3D12_HEAP_FLAGS heapFlags,
+                                 bool transient)
+        : mDevice(device), mHeapType(heapType), mHeapFlags(heapFlags), mTransient(transient) {
     }
 
     ResultOrError<std::unique_ptr<ResourceHeapBase>> HeapAllocator::AllocateResourceHeap(
@@ -46,7 +47,7 @@ namespace dawn_native { namespace d3d12 {
             mDevice->GetD3D12Device()->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)),
             "ID3D12Device::CreateHeap"));
 
-        return {std::make_unique<Heap>(std::move(heap), size)};
+        return {std::make_unique<Heap>(std::move(heap), size, mTransient)};
     }
 
     void HeapAllocator::DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> heap) {
@@ -25,7 +25,10 @@ namespace dawn_native { namespace d3d12 {
     // Wrapper to allocate a D3D12 heap.
     class HeapAllocator : public ResourceHeapAllocator {
       public:
-        HeapAllocator(Device* device, D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags);
+        HeapAllocator(Device* device,
+                      D3D12_HEAP_TYPE heapType,
+                      D3D12_HEAP_FLAGS heapFlags,
+                      bool transient = false);
         ~HeapAllocator() override = default;
 
         ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
@@ -36,6 +39,7 @@ namespace dawn_native { namespace d3d12 {
         Device* mDevice;
         D3D12_HEAP_TYPE mHeapType;
         D3D12_HEAP_FLAGS mHeapFlags;
+        bool mTransient;
     };
 
 }}  // namespace dawn_native::d3d12
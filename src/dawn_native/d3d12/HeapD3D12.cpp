@@ -15,8 +15,8 @@
 #include "dawn_native/d3d12/HeapD3D12.h"
 
 namespace dawn_native { namespace d3d12 {
-    Heap::Heap(ComPtr<ID3D12Pageable> d3d12Pageable, uint64_t size)
-        : mD3d12Pageable(std::move(d3d12Pageable)), mSize(size) {
+    Heap::Heap(ComPtr<ID3D12Pageable> d3d12Pageable, uint64_t size, bool transient)
+        : mD3d12Pageable(std::move(d3d12Pageable)), mSize(size), mTransient(transient) {
     }
 
     // This function should only be used when mD3D12Pageable was initialized from a ID3D12Pageable
@@ -44,4 +44,8 @@ namespace dawn_native { namespace d3d12 {
     uint64_t Heap::GetSize() const {
         return mSize;
     }
+
+    bool Heap::IsTransient() const {
+        return mTransient;
+    }
 }}  // namespace dawn_native::d3d12
\ No newline at end of file
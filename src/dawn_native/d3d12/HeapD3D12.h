@@ -23,7 +23,7 @@ namespace dawn_native { namespace d3d12 {
 
     class Heap : public ResourceHeapBase {
       public:
-        Heap(ComPtr<ID3D12Pageable> d3d12Pageable, uint64_t size);
+        Heap(ComPtr<ID3D12Pageable> d3d12Pageable, uint64_t size, bool transient = false);
         ~Heap() = default;
 
         ComPtr<ID3D12Heap> GetD3D12Heap() const;
@@ -37,10 +37,15 @@ namespace dawn_native { namespace d3d12 {
 
         uint64_t GetSize() const;
 
+        // Transient heaps are only sub-allocated for transient resources, which can reuse each
+        // other's memory as soon as they are destroyed.
+        bool IsTransient() const;
+
       private:
         ComPtr<ID3D12Pageable> mD3d12Pageable;
         Serial mLastUsage = 0;
         uint64_t mSize = 0;
+        bool mTransient = false;
     };
 }}  // namespace dawn_native::d3d12
 
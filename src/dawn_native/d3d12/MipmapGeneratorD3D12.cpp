@@ -0,0 +1,300 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/d3d12/MipmapGeneratorD3D12.h"
+
+#include "dawn_native/d3d12/CommandRecordingContext.h"
+#include "dawn_native/d3d12/D3D12Error.h"
+#include "dawn_native/d3d12/DescriptorHeapAllocator.h"
+#include "dawn_native/d3d12/DeviceD3D12.h"
+#include "dawn_native/d3d12/PlatformFunctions.h"
+#include "dawn_native/d3d12/ShaderVisibleDescriptorAllocatorD3D12.h"
+#include "dawn_native/d3d12/TextureD3D12.h"
+
+#include <array>
+#include <string>
+
+namespace dawn_native { namespace d3d12 {
+
+    namespace {
+
+        // Draws a triangle covering the render target, sampling the previous level at the
+        // center of each texel of the level drawn.
+        constexpr char kMipmapShaderSource[] = R"(
+            struct VertexOutput {
+                float4 position : SV_Position;
+                float2 uv : TEXCOORD0;
+            };
+
+            VertexOutput VSMain(uint vertexIndex : SV_VertexID) {
+                VertexOutput output;
+                output.uv = float2((vertexIndex << 1) & 2, vertexIndex & 2);
+                output.position = float4(output.uv * float2(2.0, -2.0) + float2(-1.0, 1.0),
+                                         0.0, 1.0);
+                return output;
+            }
+
+            cbuffer Constants : register(b0) {
+                uint arrayLayer;
+            };
+            Texture2DArray<float4> sourceLevel : register(t0);
+            SamplerState linearSampler : register(s0);
+
+            float4 PSMain(VertexOutput input) : SV_Target {
+                return sourceLevel.SampleLevel(linearSampler, float3(input.uv, arrayLayer), 0);
+            }
+        )";
+
+        enum RootParameters : uint32_t {
+            ArrayLayerConstant,
+            SourceLevelTable,
+            RootParameterCount,
+        };
+
+        ResultOrError<std::vector<uint8_t>> CompileShader(const PlatformFunctions* functions,
+                                                          const char* entryPoint,
+                                                          const char* target) {
+            ComPtr<ID3DBlob> compiledShader;
+            ComPtr<ID3DBlob> errors;
+            if (FAILED(functions->d3dCompile(kMipmapShaderSource, sizeof(kMipmapShaderSource) - 1,
+                                             nullptr, nullptr, nullptr, entryPoint, target,
+                                             D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &compiledShader,
+                                             &errors))) {
+                std::string message = "D3D compile of the mipmap shaders failed";
+                if (errors != nullptr) {
+                    message +=
+                        std::string(": ") + static_cast<const char*>(errors->GetBufferPointer());
+                }
+                return DAWN_DEVICE_LOST_ERROR(message);
+            }
+
+            const uint8_t* data = static_cast<const uint8_t*>(compiledShader->GetBufferPointer());
+            return std::vector<uint8_t>(data, data + compiledShader->GetBufferSize());
+        }
+
+    }  // anonymous namespace
+
+    MipmapGenerator::MipmapGenerator(Device* device) : mDevice(device) {
+    }
+
+    MaybeError MipmapGenerator::Initialize() {
+        DAWN_TRY_ASSIGN(mVertexShader, CompileShader(mDevice->GetFunctions(), "VSMain", "vs_5_1"));
+        DAWN_TRY_ASSIGN(mPixelShader, CompileShader(mDevice->GetFunctions(), "PSMain", "ps_5_1"));
+
+        D3D12_DESCRIPTOR_RANGE sourceLevelRange;
+        sourceLevelRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        sourceLevelRange.NumDescriptors = 1;
+        sourceLevelRange.BaseShaderRegister = 0;
+        sourceLevelRange.RegisterSpace = 0;
+        sourceLevelRange.OffsetInDescriptorsFromTableStart = 0;
+
+        D3D12_ROOT_PARAMETER rootParameters[RootParameterCount];
+        rootParameters[ArrayLayerConstant].ParameterType =
+            D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        rootParameters[ArrayLayerConstant].Constants.ShaderRegister = 0;
+        rootParameters[ArrayLayerConstant].Constants.RegisterSpace = 0;
+        rootParameters[ArrayLayerConstant].Constants.Num32BitValues = 1;
+        rootParameters[ArrayLayerConstant].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        rootParameters[SourceLevelTable].ParameterType =
+            D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        rootParameters[SourceLevelTable].DescriptorTable.NumDescriptorRanges = 1;
+        rootParameters[SourceLevelTable].DescriptorTable.pDescriptorRanges = &sourceLevelRange;
+        rootParameters[SourceLevelTable].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        D3D12_STATIC_SAMPLER_DESC samplerDescriptor = {};
+        samplerDescriptor.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDescriptor.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        samplerDescriptor.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        samplerDescriptor.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        samplerDescriptor.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+        samplerDescriptor.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+        samplerDescriptor.MaxLOD = D3D12_FLOAT32_MAX;
+        samplerDescriptor.ShaderRegister = 0;
+        samplerDescriptor.RegisterSpace = 0;
+        samplerDescriptor.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        D3D12_ROOT_SIGNATURE_DESC rootSignatureDescriptor;
+        rootSignatureDescriptor.NumParameters = RootParameterCount;
+        rootSignatureDescriptor.pParameters = rootParameters;
+        rootSignatureDescriptor.NumStaticSamplers = 1;
+        rootSignatureDescriptor.pStaticSamplers = &samplerDescriptor;
+        rootSignatureDescriptor.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+        ComPtr<ID3DBlob> signature;
+        ComPtr<ID3DBlob> error;
+        DAWN_TRY(CheckHRESULT(
+            mDevice->GetFunctions()->d3d12SerializeRootSignature(
+                &rootSignatureDescriptor, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error),
+            "D3D12 serialize root signature"));
+        DAWN_TRY(CheckHRESULT(mDevice->GetD3D12Device()->CreateRootSignature(
+                                  0, signature->GetBufferPointer(), signature->GetBufferSize(),
+                                  IID_PPV_ARGS(&mRootSignature)),
+                              "D3D12 create root signature"));
+        return {};
+    }
+
+    ResultOrError<ID3D12PipelineState*> MipmapGenerator::GetOrCreatePipelineState(
+        DXGI_FORMAT format) {
+        auto it = mPipelineStates.find(format);
+        if (it != mPipelineStates.end()) {
+            return it->second.Get();
+        }
+
+        if (mRootSignature == nullptr) {
+            DAWN_TRY(Initialize());
+        }
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC descriptor = {};
+        descriptor.pRootSignature = mRootSignature.Get();
+        descriptor.VS.pShaderBytecode = mVertexShader.data();
+        descriptor.VS.BytecodeLength = mVertexShader.size();
+        descriptor.PS.pShaderBytecode = mPixelShader.data();
+        descriptor.PS.BytecodeLength = mPixelShader.size();
+
+        descriptor.BlendState.RenderTarget[0].BlendEnable = false;
+        descriptor.BlendState.RenderTarget[0].LogicOpEnable = false;
+        descriptor.BlendState.RenderTarget[0].RenderTargetWriteMask =
+            D3D12_COLOR_WRITE_ENABLE_ALL;
+        descriptor.SampleMask = UINT_MAX;
+
+        descriptor.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+        descriptor.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+        descriptor.RasterizerState.DepthClipEnable = true;
+        descriptor.DepthStencilState.DepthEnable = false;
+        descriptor.DepthStencilState.StencilEnable = false;
+
+        descriptor.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        descriptor.NumRenderTargets = 1;
+        descriptor.RTVFormats[0] = format;
+        descriptor.SampleDesc.Count = 1;
+
+        ComPtr<ID3D12PipelineState> pipelineState;
+        DAWN_TRY(CheckHRESULT(mDevice->GetD3D12Device()->CreateGraphicsPipelineState(
+                                  &descriptor, IID_PPV_ARGS(&pipelineState)),
+                              "D3D12 create mipmap pipeline state"));
+
+        ID3D12PipelineState* result = pipelineState.Get();
+        mPipelineStates.emplace(format, std::move(pipelineState));
+        return result;
+    }
+
+    MaybeError MipmapGenerator::GenerateMipmaps(CommandRecordingContext* commandContext,
+                                                Texture* texture,
+                                                uint32_t baseMipLevel,
+                                                uint32_t mipLevelCount) {
+        ASSERT(mipLevelCount > 1);
+        ID3D12PipelineState* pipelineState;
+        DAWN_TRY_ASSIGN(pipelineState, GetOrCreatePipelineState(texture->GetD3D12Format()));
+
+        ID3D12Device* d3d12Device = mDevice->GetD3D12Device().Get();
+        ID3D12GraphicsCommandList* commandList = commandContext->GetCommandList();
+        uint32_t layerCount = texture->GetArrayLayers();
+        uint32_t sourceLevelCount = mipLevelCount - 1;
+
+        // One shader-visible SRV for each level that is read.
+        ShaderVisibleDescriptorAllocator* allocator =
+            mDevice->GetShaderVisibleDescriptorAllocator();
+        DescriptorHeapAllocation srvAllocation;
+        DAWN_TRY_ASSIGN(srvAllocation, allocator->AllocateGPUDescriptors(
+                                           sourceLevelCount, mDevice->GetPendingCommandSerial(),
+                                           D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
+        if (srvAllocation.IsInvalid()) {
+            DAWN_TRY(allocator->AllocateAndSwitchShaderVisibleHeaps());
+            DAWN_TRY_ASSIGN(srvAllocation, allocator->AllocateGPUDescriptors(
+                                               sourceLevelCount, mDevice->GetPendingCommandSerial(),
+                                               D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
+            if (srvAllocation.IsInvalid()) {
+                return DAWN_OUT_OF_MEMORY_ERROR("Unable to allocate the mipmap descriptors");
+            }
+        }
+        std::array<ID3D12DescriptorHeap*, 2> descriptorHeaps = allocator->GetShaderVisibleHeaps();
+        commandList->SetDescriptorHeaps(2, descriptorHeaps.data());
+
+        DescriptorHeapHandle rtvHeap;
+        DAWN_TRY_ASSIGN(rtvHeap, mDevice->GetDescriptorHeapAllocator()->AllocateCPUHeap(
+                                     D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 1));
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap.GetCPUHandle(0);
+
+        // The whole texture is tracked in the render target state, each level is moved to the
+        // shader resource state while it is read and back at the end.
+        texture->TrackUsageAndTransitionNow(commandContext, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        commandList->SetGraphicsRootSignature(mRootSignature.Get());
+        commandList->SetPipelineState(pipelineState);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        std::vector<D3D12_RESOURCE_BARRIER> barriers(layerCount);
+        auto TransitionLevel = [&](uint32_t level, D3D12_RESOURCE_STATES before,
+                                   D3D12_RESOURCE_STATES after) {
+            for (uint32_t layer = 0; layer < layerCount; ++layer) {
+                D3D12_RESOURCE_BARRIER& barrier = barriers[layer];
+                barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                barrier.Transition.pResource = texture->GetD3D12Resource();
+                barrier.Transition.StateBefore = before;
+                barrier.Transition.StateAfter = after;
+                barrier.Transition.Subresource = texture->GetSubresourceIndex(level, layer);
+            }
+            commandList->ResourceBarrier(layerCount, barriers.data());
+        };
+
+        for (uint32_t i = 0; i < sourceLevelCount; ++i) {
+            uint32_t sourceLevel = baseMipLevel + i;
+            uint32_t level = sourceLevel + 1;
+            TransitionLevel(sourceLevel, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
+            srvDesc.Format = texture->GetD3D12Format();
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+            srvDesc.Texture2DArray.MostDetailedMip = sourceLevel;
+            srvDesc.Texture2DArray.MipLevels = 1;
+            srvDesc.Texture2DArray.FirstArraySlice = 0;
+            srvDesc.Texture2DArray.ArraySize = layerCount;
+            srvDesc.Texture2DArray.PlaneSlice = 0;
+            srvDesc.Texture2DArray.ResourceMinLODClamp = 0;
+            d3d12Device->CreateShaderResourceView(texture->GetD3D12Resource(), &srvDesc,
+                                                  srvAllocation.GetCPUHandle(i));
+            commandList->SetGraphicsRootDescriptorTable(SourceLevelTable,
+                                                        srvAllocation.GetGPUHandle(i));
+
+            Extent3D size = texture->GetMipLevelVirtualSize(level);
+            D3D12_VIEWPORT viewport = {
+                0.f, 0.f, static_cast<float>(size.width), static_cast<float>(size.height),
+                0.f, 1.f};
+            D3D12_RECT scissorRect = {0, 0, static_cast<LONG>(size.width),
+                                      static_cast<LONG>(size.height)};
+            commandList->RSSetViewports(1, &viewport);
+            commandList->RSSetScissorRects(1, &scissorRect);
+
+            for (uint32_t layer = 0; layer < layerCount; ++layer) {
+                D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = texture->GetRTVDescriptor(level, layer, 1);
+                d3d12Device->CreateRenderTargetView(texture->GetD3D12Resource(), &rtvDesc,
+                                                    rtvHandle);
+                commandList->OMSetRenderTargets(1, &rtvHandle, false, nullptr);
+                commandList->SetGraphicsRoot32BitConstant(ArrayLayerConstant, layer, 0);
+                commandList->DrawInstanced(3, 1, 0, 0);
+            }
+        }
+
+        for (uint32_t i = 0; i < sourceLevelCount; ++i) {
+            TransitionLevel(baseMipLevel + i, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                            D3D12_RESOURCE_STATE_RENDER_TARGET);
+        }
+        return {};
+    }
+
+}}  // namespace dawn_native::d3d12
@@ -0,0 +1,59 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_D3D12_MIPMAPGENERATORD3D12_H_
+#define DAWNNATIVE_D3D12_MIPMAPGENERATORD3D12_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/d3d12/d3d12_platform.h"
+
+#include <map>
+#include <vector>
+
+namespace dawn_native { namespace d3d12 {
+
+    class CommandRecordingContext;
+    class Device;
+    class Texture;
+
+    // Generates the mip levels of textures by drawing each level from the previous one with a
+    // linear filter, D3D12 having no blits. The shaders and the root signature are created when
+    // mipmaps are first generated, and a pipeline is cached for each render target format.
+    class MipmapGenerator {
+      public:
+        MipmapGenerator(Device* device);
+
+        // Records the draws in the command list of |commandContext|, which leaves the texture in
+        // the render target state. The root signature and pipeline state of the command list are
+        // changed, and the shader-visible descriptor heaps can be switched.
+        MaybeError GenerateMipmaps(CommandRecordingContext* commandContext,
+                                   Texture* texture,
+                                   uint32_t baseMipLevel,
+                                   uint32_t mipLevelCount);
+
+      private:
+        MaybeError Initialize();
+        ResultOrError<ID3D12PipelineState*> GetOrCreatePipelineState(DXGI_FORMAT format);
+
+        Device* mDevice;
+
+        ComPtr<ID3D12RootSignature> mRootSignature;
+        std::vector<uint8_t> mVertexShader;
+        std::vector<uint8_t> mPixelShader;
+        std::map<DXGI_FORMAT, ComPtr<ID3D12PipelineState>> mPipelineStates;
+    };
+
+}}  // namespace dawn_native::d3d12
+
+#endif  // DAWNNATIVE_D3D12_MIPMAPGENERATORD3D12_H_
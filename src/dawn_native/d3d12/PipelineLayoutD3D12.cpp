@@ -70,7 +70,7 @@ namespace dawn_native { namespace d3d12 {
 
     MaybeError PipelineLayout::Initialize() {
         Device* device = ToBackend(GetDevice());
-        D3D12_ROOT_PARAMETER rootParameters[kMaxBindGroups * 2 + kMaxDynamicBufferCount];
+        D3D12_ROOT_PARAMETER rootParameters[kMaxRootParameterCount];
 
         // A root parameter is one of these types
         union {
@@ -152,6 +152,16 @@ namespace dawn_native { namespace d3d12 {
             }
         }
 
+        if (GetPushConstantSize() > 0) {
+            D3D12_ROOT_PARAMETER* rootParameter = &rootParameters[parameterIndex];
+            rootParameter->ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+            rootParameter->Constants.ShaderRegister = 0;
+            rootParameter->Constants.RegisterSpace = kPushConstantRegisterSpace;
+            rootParameter->Constants.Num32BitValues = GetPushConstantSize() / sizeof(uint32_t);
+            rootParameter->ShaderVisibility = ShaderVisibilityType(GetPushConstantVisibility());
+            mPushConstantsRootParameterIndex = parameterIndex++;
+        }
+
         D3D12_ROOT_SIGNATURE_DESC rootSignatureDescriptor;
         rootSignatureDescriptor.NumParameters = parameterIndex;
         rootSignatureDescriptor.pParameters = rootParameters;
@@ -193,4 +203,9 @@ namespace dawn_native { namespace d3d12 {
         ASSERT(GetBindGroupLayout(group)->GetBindingInfo().hasDynamicOffset[binding]);
         return mDynamicRootParameterIndices[group][binding];
     }
+
+    uint32_t PipelineLayout::GetPushConstantsRootParameterIndex() const {
+        ASSERT(GetPushConstantSize() > 0);
+        return mPushConstantsRootParameterIndex;
+    }
 }}  // namespace dawn_native::d3d12
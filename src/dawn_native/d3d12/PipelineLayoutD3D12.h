@@ -25,6 +25,14 @@ namespace dawn_native { namespace d3d12 {
 
     class PipelineLayout : public PipelineLayoutBase {
       public:
+        // A descriptor table per bind group for views and samplers, a root descriptor per
+        // dynamic buffer and the root constants of the push constants.
+        static constexpr uint32_t kMaxRootParameterCount =
+            kMaxBindGroups * 2 + kMaxDynamicBufferCount + 1;
+
+        // The push constants are in register b0 of the space after the bind groups' spaces.
+        static constexpr uint32_t kPushConstantRegisterSpace = kMaxBindGroups;
+
         static ResultOrError<PipelineLayout*> Create(Device* device,
                                                      const PipelineLayoutDescriptor* descriptor);
 
@@ -34,6 +42,9 @@ namespace dawn_native { namespace d3d12 {
         // Returns the index of the root parameter reserved for a dynamic buffer binding
         uint32_t GetDynamicRootParameterIndex(uint32_t group, uint32_t binding) const;
 
+        // Returns the index of the root constants parameter, only if the layout has push constants
+        uint32_t GetPushConstantsRootParameterIndex() const;
+
         ComPtr<ID3D12RootSignature> GetRootSignature() const;
 
       private:
@@ -43,6 +54,7 @@ namespace dawn_native { namespace d3d12 {
         std::array<uint32_t, kMaxBindGroups> mSamplerRootParameterInfo;
         std::array<std::array<uint32_t, kMaxBindingsPerGroup>, kMaxBindGroups>
             mDynamicRootParameterIndices;
+        uint32_t mPushConstantsRootParameterIndex = 0;
         ComPtr<ID3D12RootSignature> mRootSignature;
     };
 
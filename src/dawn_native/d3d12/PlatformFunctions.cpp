@@ -29,6 +29,7 @@ namespace dawn_native { namespace d3d12 {
         DAWN_TRY(LoadD3DCompiler());
         DAWN_TRY(LoadD3D11());
         LoadPIXRuntime();
+        LoadDXCompiler();
         return {};
     }
 
@@ -82,6 +83,21 @@ namespace dawn_native { namespace d3d12 {
         return {};
     }
 
+    bool PlatformFunctions::IsDXCAvailable() const {
+        return mDXILLib.Valid() && mDXCompilerLib.Valid();
+    }
+
+    void PlatformFunctions::LoadDXCompiler() {
+        // DXC is optional. dxil.dll isn't used directly but DXC needs it to sign the shaders,
+        // without it D3D12 rejects the compiled shaders.
+        if (!mDXILLib.Open("dxil.dll") || !mDXCompilerLib.Open("dxcompiler.dll") ||
+            !mDXCompilerLib.GetProc(&dxcCreateInstance, "DxcCreateInstance")) {
+            mDXILLib.Close();
+            mDXCompilerLib.Close();
+            dxcCreateInstance = nullptr;
+        }
+    }
+
     bool PlatformFunctions::IsPIXEventRuntimeLoaded() const {
         return mPIXEventRuntimeLib.Valid();
     }
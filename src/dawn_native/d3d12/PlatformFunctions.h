@@ -36,6 +36,7 @@ namespace dawn_native { namespace d3d12 {
 
         MaybeError LoadFunctions();
         bool IsPIXEventRuntimeLoaded() const;
+        bool IsDXCAvailable() const;
 
         // Functions from d3d12.dll
         PFN_D3D12_CREATE_DEVICE d3d12CreateDevice = nullptr;
@@ -61,6 +62,9 @@ namespace dawn_native { namespace d3d12 {
         // Functions from d3d3compiler.dll
         pD3DCompile d3dCompile = nullptr;
 
+        // Functions from dxcompiler.dll
+        DxcCreateInstanceProc dxcCreateInstance = nullptr;
+
         // Functions from WinPixEventRuntime.dll
         using PFN_PIX_END_EVENT_ON_COMMAND_LIST =
             HRESULT(WINAPI*)(ID3D12GraphicsCommandList* commandList);
@@ -86,12 +90,15 @@ namespace dawn_native { namespace d3d12 {
         MaybeError LoadDXGI();
         MaybeError LoadD3DCompiler();
         void LoadPIXRuntime();
+        void LoadDXCompiler();
 
         DynamicLib mD3D12Lib;
         DynamicLib mD3D11Lib;
         DynamicLib mDXGILib;
         DynamicLib mD3DCompilerLib;
         DynamicLib mPIXEventRuntimeLib;
+        DynamicLib mDXILLib;
+        DynamicLib mDXCompilerLib;
     };
 
 }}  // namespace dawn_native::d3d12
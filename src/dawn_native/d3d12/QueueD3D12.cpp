@@ -22,7 +22,8 @@
 
 namespace dawn_native { namespace d3d12 {
 
-    Queue::Queue(Device* device) : QueueBase(device) {
+    Queue::Queue(Device* device, const QueueDescriptor* descriptor)
+        : QueueBase(device, descriptor) {
     }
 
     MaybeError Queue::SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) {
@@ -36,6 +37,7 @@ namespace dawn_native { namespace d3d12 {
         TRACE_EVENT_BEGIN0(GetDevice()->GetPlatform(), Recording,
                            "CommandBufferD3D12::RecordCommands");
         for (uint32_t i = 0; i < commandCount; ++i) {
+            ScopedLoweringTimer timer(commands[i]);
             DAWN_TRY(ToBackend(commands[i])->RecordCommands(commandContext));
         }
         TRACE_EVENT_END0(GetDevice()->GetPlatform(), Recording,
@@ -0,0 +1,77 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/d3d12/RayTracingBufferAllocatorD3D12.h"
+
+#include "dawn_native/d3d12/ResourceAllocatorManagerD3D12.h"
+
+namespace dawn_native { namespace d3d12 {
+
+    RayTracingBuffer::RayTracingBuffer(ResourceHeapAllocation allocation,
+                                       D3D12_RESOURCE_STATES state)
+        : mAllocation(std::move(allocation)), mState(state) {
+    }
+
+    ResourceHeapAllocation& RayTracingBuffer::GetAllocation() {
+        return mAllocation;
+    }
+
+    ID3D12Resource* RayTracingBuffer::GetD3D12Resource() const {
+        return mAllocation.GetD3D12Resource().Get();
+    }
+
+    D3D12_GPU_VIRTUAL_ADDRESS RayTracingBuffer::GetGPUPointer() const {
+        return mAllocation.GetGPUPointer();
+    }
+
+    D3D12_RESOURCE_STATES RayTracingBuffer::GetState() const {
+        return mState;
+    }
+
+    RayTracingBufferAllocator::RayTracingBufferAllocator(ResourceAllocatorManager* allocatorManager,
+                                                         D3D12_RESOURCE_STATES state)
+        : mAllocatorManager(allocatorManager), mState(state) {
+    }
+
+    ResultOrError<std::unique_ptr<ResourceHeapBase>>
+    RayTracingBufferAllocator::AllocateResourceHeap(uint64_t size) {
+        D3D12_RESOURCE_DESC resourceDescriptor;
+        resourceDescriptor.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        resourceDescriptor.Alignment = 0;
+        resourceDescriptor.Width = size;
+        resourceDescriptor.Height = 1;
+        resourceDescriptor.DepthOrArraySize = 1;
+        resourceDescriptor.MipLevels = 1;
+        resourceDescriptor.Format = DXGI_FORMAT_UNKNOWN;
+        resourceDescriptor.SampleDesc.Count = 1;
+        resourceDescriptor.SampleDesc.Quality = 0;
+        resourceDescriptor.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        // Both acceleration structures and the scratch memory of their builds are written as
+        // unordered access.
+        resourceDescriptor.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+        ResourceHeapAllocation allocation;
+        DAWN_TRY_ASSIGN(allocation, mAllocatorManager->AllocateMemory(
+                                        D3D12_HEAP_TYPE_DEFAULT, resourceDescriptor, mState));
+        return {std::make_unique<RayTracingBuffer>(std::move(allocation), mState)};
+    }
+
+    void RayTracingBufferAllocator::DeallocateResourceHeap(
+        std::unique_ptr<ResourceHeapBase> allocation) {
+        // The ResourceAllocatorManager keeps the buffer alive until the GPU is done with it.
+        mAllocatorManager->DeallocateMemory(
+            static_cast<RayTracingBuffer*>(allocation.get())->GetAllocation());
+    }
+
+}}  // namespace dawn_native::d3d12
@@ -0,0 +1,63 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_D3D12_RAYTRACINGBUFFERALLOCATORD3D12_H_
+#define DAWNNATIVE_D3D12_RAYTRACINGBUFFERALLOCATORD3D12_H_
+
+#include "dawn_native/ResourceHeap.h"
+#include "dawn_native/ResourceHeapAllocator.h"
+#include "dawn_native/d3d12/ResourceHeapAllocationD3D12.h"
+#include "dawn_native/d3d12/d3d12_platform.h"
+
+namespace dawn_native { namespace d3d12 {
+
+    class ResourceAllocatorManager;
+
+    // A buffer that stays in the same state for its whole lifetime, which acceleration
+    // structures or their scratch memory are sub-allocated in.
+    class RayTracingBuffer : public ResourceHeapBase {
+      public:
+        RayTracingBuffer(ResourceHeapAllocation allocation, D3D12_RESOURCE_STATES state);
+        ~RayTracingBuffer() override = default;
+
+        ResourceHeapAllocation& GetAllocation();
+        ID3D12Resource* GetD3D12Resource() const;
+        D3D12_GPU_VIRTUAL_ADDRESS GetGPUPointer() const;
+        D3D12_RESOURCE_STATES GetState() const;
+
+      private:
+        ResourceHeapAllocation mAllocation;
+        D3D12_RESOURCE_STATES mState;
+    };
+
+    // Creates unordered access buffers in the default heap, placed in the resource heaps of the
+    // ResourceAllocatorManager, for the sub-allocators of ray tracing memory.
+    class RayTracingBufferAllocator : public ResourceHeapAllocator {
+      public:
+        RayTracingBufferAllocator(ResourceAllocatorManager* allocatorManager,
+                                  D3D12_RESOURCE_STATES state);
+        ~RayTracingBufferAllocator() override = default;
+
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size) override;
+        void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override;
+
+      private:
+        ResourceAllocatorManager* mAllocatorManager;
+        D3D12_RESOURCE_STATES mState;
+    };
+
+}}  // namespace dawn_native::d3d12
+
+#endif  // DAWNNATIVE_D3D12_RAYTRACINGBUFFERALLOCATORD3D12_H_
@@ -310,47 +310,35 @@ namespace dawn_native { namespace d3d12 {
 
         D3D12_GRAPHICS_PIPELINE_STATE_DESC descriptorD3D12 = {};
 
-        PerStage<ComPtr<ID3DBlob>> compiledShader;
-        ComPtr<ID3DBlob> errors;
+        PerStage<ShaderModule::CompiledShader> compiledShader;
 
         wgpu::ShaderStage renderStages = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment;
         for (auto stage : IterateStages(renderStages)) {
             ShaderModule* module = nullptr;
             const char* entryPoint = nullptr;
-            const char* compileTarget = nullptr;
             D3D12_SHADER_BYTECODE* shader = nullptr;
             switch (stage) {
                 case SingleShaderStage::Vertex:
                     module = ToBackend(descriptor->vertexStage.module);
                     entryPoint = descriptor->vertexStage.entryPoint;
                     shader = &descriptorD3D12.VS;
-                    compileTarget = "vs_5_1";
                     break;
                 case SingleShaderStage::Fragment:
                     module = ToBackend(descriptor->fragmentStage->module);
                     entryPoint = descriptor->fragmentStage->entryPoint;
                     shader = &descriptorD3D12.PS;
-                    compileTarget = "ps_5_1";
                     break;
                 default:
                     UNREACHABLE();
                     break;
             }
 
-            std::string hlslSource;
-            DAWN_TRY_ASSIGN(hlslSource, module->GetHLSLSource(ToBackend(GetLayout())));
-
-            const PlatformFunctions* functions = device->GetFunctions();
-            if (FAILED(functions->d3dCompile(hlslSource.c_str(), hlslSource.length(), nullptr,
-                                             nullptr, nullptr, entryPoint, compileTarget,
-                                             compileFlags, 0, &compiledShader[stage], &errors))) {
-                printf("%s\n", reinterpret_cast<char*>(errors->GetBufferPointer()));
-                ASSERT(false);
-            }
+            DAWN_TRY_ASSIGN(compiledShader[stage], module->Compile(entryPoint, stage,
+                                                                   ToBackend(GetLayout()),
+                                                                   compileFlags));
 
             if (shader != nullptr) {
-                shader->pShaderBytecode = compiledShader[stage]->GetBufferPointer();
-                shader->BytecodeLength = compiledShader[stage]->GetBufferSize();
+                *shader = compiledShader[stage].GetD3D12ShaderBytecode();
             }
         }
 
@@ -14,11 +14,14 @@
 
 #include "dawn_native/d3d12/ResourceAllocatorManagerD3D12.h"
 
+#include "dawn_native/d3d12/BufferD3D12.h"
 #include "dawn_native/d3d12/D3D12Error.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
 #include "dawn_native/d3d12/HeapAllocatorD3D12.h"
 #include "dawn_native/d3d12/HeapD3D12.h"
 
+#include <algorithm>
+
 namespace dawn_native { namespace d3d12 {
     namespace {
         D3D12_HEAP_TYPE GetD3D12HeapType(ResourceHeapKind resourceHeapKind) {
@@ -130,6 +133,27 @@ namespace dawn_native { namespace d3d12 {
             }
         }
 
+        D3D12_RESIDENCY_PRIORITY D3D12ResidencyPriority(wgpu::ResidencyPriority priority) {
+            switch (priority) {
+                case wgpu::ResidencyPriority::Minimum:
+                    return D3D12_RESIDENCY_PRIORITY_MINIMUM;
+                case wgpu::ResidencyPriority::Low:
+                    return D3D12_RESIDENCY_PRIORITY_LOW;
+                case wgpu::ResidencyPriority::Normal:
+                    return D3D12_RESIDENCY_PRIORITY_NORMAL;
+                case wgpu::ResidencyPriority::High:
+                    return D3D12_RESIDENCY_PRIORITY_HIGH;
+                case wgpu::ResidencyPriority::Maximum:
+                    return D3D12_RESIDENCY_PRIORITY_MAXIMUM;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        uint64_t AlignSize(uint64_t size, uint64_t alignment) {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
     }  // namespace
 
     ResourceAllocatorManager::ResourceAllocatorManager(Device* device) : mDevice(device) {
@@ -137,19 +161,56 @@ namespace dawn_native { namespace d3d12 {
                                 ? mDevice->GetDeviceInfo().resourceHeapTier
                                 : 1;
 
+        // ID3D12Device1 is only available starting with the Windows 10 Fall Creators Update.
+        if (FAILED(mDevice->GetD3D12Device().As(&mD3d12Device1))) {
+            mD3d12Device1 = nullptr;
+        }
+
         for (uint32_t i = 0; i < ResourceHeapKind::EnumCount; i++) {
             const ResourceHeapKind resourceHeapKind = static_cast<ResourceHeapKind>(i);
             mHeapAllocators[i] = std::make_unique<HeapAllocator>(
                 mDevice, GetD3D12HeapType(resourceHeapKind), GetD3D12HeapFlags(resourceHeapKind));
-            mSubAllocatedResourceAllocators[i] = std::make_unique<BuddyMemoryAllocator>(
-                kMaxHeapSize, kMinHeapSize, mHeapAllocators[i].get());
+            // Placed resources are aligned to at least 4KB, so the heaps don't need finer blocks.
+            mSubAllocatedResourceAllocators[i] = std::make_unique<TLSFMemoryAllocator>(
+                kPlacedResourceHeapSize, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT,
+                mHeapAllocators[i].get());
+
+            mTransientHeapAllocators[i] = std::make_unique<HeapAllocator>(
+                mDevice, GetD3D12HeapType(resourceHeapKind), GetD3D12HeapFlags(resourceHeapKind),
+                true);
+            mRecyclingHeapAllocators[i] = std::make_unique<RecyclingResourceHeapAllocator>(
+                kTransientResourceHeapSize, mTransientHeapAllocators[i].get());
+            mTransientResourceAllocators[i] = std::make_unique<TLSFMemoryAllocator>(
+                kTransientResourceHeapSize, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT,
+                mRecyclingHeapAllocators[i].get());
+        }
+
+        mRayTracingBufferAllocators[AccelerationStructure] =
+            std::make_unique<RayTracingBufferAllocator>(
+                this, D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE);
+        mRayTracingBufferAllocators[AccelerationStructureScratch] =
+            std::make_unique<RayTracingBufferAllocator>(this,
+                                                        D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        for (uint32_t i = 0; i < RayTracingMemoryKindCount; i++) {
+            mRayTracingMemoryAllocators[i] = std::make_unique<TLSFMemoryAllocator>(
+                kRayTracingBufferSize, D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT,
+                mRayTracingBufferAllocators[i].get());
         }
     }
 
     ResultOrError<ResourceHeapAllocation> ResourceAllocatorManager::AllocateMemory(
         D3D12_HEAP_TYPE heapType,
         const D3D12_RESOURCE_DESC& resourceDescriptor,
-        D3D12_RESOURCE_STATES initialUsage) {
+        D3D12_RESOURCE_STATES initialUsage,
+        wgpu::ResidencyPriority priority) {
+        if (priority != wgpu::ResidencyPriority::Normal) {
+            ResourceHeapAllocation directAllocation;
+            DAWN_TRY_ASSIGN(directAllocation,
+                            CreateCommittedResource(heapType, resourceDescriptor, initialUsage));
+            DAWN_TRY(SetResidencyPriority(directAllocation, priority));
+            return directAllocation;
+        }
+
         // TODO(bryan.bernhart@intel.com): Conditionally disable sub-allocation.
         // For very large resources, there is no benefit to suballocate.
         // For very small resources, it is inefficent to suballocate given the min. heap
@@ -170,14 +231,112 @@ namespace dawn_native { namespace d3d12 {
         return directAllocation;
     }
 
+    ResultOrError<ResourceHeapAllocation> ResourceAllocatorManager::AllocateTransientMemory(
+        D3D12_HEAP_TYPE heapType,
+        const D3D12_RESOURCE_DESC& resourceDescriptor,
+        D3D12_RESOURCE_STATES initialUsage) {
+        ResourceHeapAllocation transientAllocation;
+        DAWN_TRY_ASSIGN(transientAllocation,
+                        CreatePlacedResource(heapType, resourceDescriptor, initialUsage,
+                                             TLSFMemoryAllocator::kInvalidHeapIndex, true));
+        if (transientAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
+            return transientAllocation;
+        }
+
+        // Resources larger than the transient heaps don't alias others.
+        return AllocateMemory(heapType, resourceDescriptor, initialUsage);
+    }
+
+    ResultOrError<ResourceMemoryAllocation>
+    ResourceAllocatorManager::AllocateAccelerationStructureMemory(uint64_t size) {
+        return AllocateRayTracingMemory(AccelerationStructure, size);
+    }
+
+    ResultOrError<ResourceMemoryAllocation>
+    ResourceAllocatorManager::AllocateAccelerationStructureScratchMemory(uint64_t size) {
+        return AllocateRayTracingMemory(AccelerationStructureScratch, size);
+    }
+
+    ResultOrError<ResourceMemoryAllocation> ResourceAllocatorManager::AllocateRayTracingMemory(
+        RayTracingMemoryKind kind,
+        uint64_t size) {
+        const uint64_t alignedSize = AlignSize(
+            std::max(size, uint64_t(1)), D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT);
+
+        ResourceMemoryAllocation subAllocation;
+        DAWN_TRY_ASSIGN(subAllocation,
+                        mRayTracingMemoryAllocators[kind]->Allocate(
+                            alignedSize, D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT));
+        if (subAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
+            return subAllocation;
+        }
+
+        // Larger than the shared buffers, the memory gets a buffer of its own.
+        std::unique_ptr<ResourceHeapBase> buffer;
+        DAWN_TRY_ASSIGN(buffer,
+                        mRayTracingBufferAllocators[kind]->AllocateResourceHeap(
+                            AlignSize(alignedSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)));
+
+        AllocationInfo info;
+        info.mMethod = AllocationMethod::kDirect;
+        info.mRequestedSize = size;
+        return ResourceMemoryAllocation{info, 0, buffer.release()};
+    }
+
+    void ResourceAllocatorManager::DeallocateRayTracingMemory(
+        ResourceMemoryAllocation& allocation) {
+        if (allocation.GetInfo().mMethod == AllocationMethod::kInvalid) {
+            return;
+        }
+
+        mRayTracingAllocationsToDelete.Enqueue(allocation, mDevice->GetPendingCommandSerial());
+        allocation.Invalidate();
+    }
+
+    void ResourceAllocatorManager::FreeRayTracingMemory(
+        const ResourceMemoryAllocation& allocation) {
+        // The state of the buffer tells which of the allocators the memory comes from.
+        const RayTracingMemoryKind kind =
+            static_cast<RayTracingBuffer*>(allocation.GetResourceHeap())->GetState() ==
+                    D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE
+                ? AccelerationStructure
+                : AccelerationStructureScratch;
+
+        if (allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated) {
+            mRayTracingMemoryAllocators[kind]->Deallocate(allocation);
+        } else {
+            ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kDirect);
+            mRayTracingBufferAllocators[kind]->DeallocateResourceHeap(
+                std::unique_ptr<ResourceHeapBase>(allocation.GetResourceHeap()));
+        }
+    }
+
     void ResourceAllocatorManager::Tick(Serial completedSerial) {
+        // Done first so that the buffers released by the ray tracing allocators are deleted
+        // below when the device is destroyed and the completed serial is the maximum.
+        for (const ResourceMemoryAllocation& allocation :
+             mRayTracingAllocationsToDelete.IterateUpTo(completedSerial)) {
+            FreeRayTracingMemory(allocation);
+        }
+        mRayTracingAllocationsToDelete.ClearUpTo(completedSerial);
+
         for (ResourceHeapAllocation& allocation :
              mAllocationsToDelete.IterateUpTo(completedSerial)) {
+            size_t resourceHeapKindIndex = GetResourceHeapKindIndex(allocation);
+            ASSERT(mPendingDeletionSizes[resourceHeapKindIndex] >=
+                   allocation.GetInfo().mRequestedSize);
+            mPendingDeletionSizes[resourceHeapKindIndex] -= allocation.GetInfo().mRequestedSize;
+
             if (allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated) {
                 FreeMemory(allocation);
             }
         }
         mAllocationsToDelete.ClearUpTo(completedSerial);
+
+        for (const std::unique_ptr<RecyclingResourceHeapAllocator>& allocator :
+             mRecyclingHeapAllocators) {
+            allocator->Tick(completedSerial);
+        }
     }
 
     void ResourceAllocatorManager::DeallocateMemory(ResourceHeapAllocation& allocation) {
@@ -185,6 +344,24 @@ namespace dawn_native { namespace d3d12 {
             return;
         }
 
+        // The memory of transient resources is reused right away since the next transient
+        // resources start with an aliasing barrier, only the placed resource is kept alive until
+        // the GPU is done with it.
+        if (allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated &&
+            ToBackend(allocation.GetResourceHeap())->IsTransient()) {
+            mDevice->ReferenceUntilUnused(allocation.GetD3D12Resource());
+            FreeMemory(allocation);
+            allocation.Invalidate();
+            return;
+        }
+
+        size_t resourceHeapKindIndex = GetResourceHeapKindIndex(allocation);
+        mPendingDeletionSizes[resourceHeapKindIndex] += allocation.GetInfo().mRequestedSize;
+        if (allocation.GetInfo().mMethod == AllocationMethod::kDirect) {
+            ASSERT(mCommittedResourceSizes[resourceHeapKindIndex] >=
+                   allocation.GetInfo().mRequestedSize);
+            mCommittedResourceSizes[resourceHeapKindIndex] -= allocation.GetInfo().mRequestedSize;
+        }
         mAllocationsToDelete.Enqueue(allocation, mDevice->GetPendingCommandSerial());
 
         // Directly allocated ResourceHeapAllocations are created with a heap object that must be
@@ -201,25 +378,68 @@ namespace dawn_native { namespace d3d12 {
         ASSERT(allocation.GetD3D12Resource().Get() == nullptr);
     }
 
-    void ResourceAllocatorManager::FreeMemory(ResourceHeapAllocation& allocation) {
-        ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated);
+    MaybeError ResourceAllocatorManager::SetResidencyPriority(
+        const ResourceHeapAllocation& allocation,
+        wgpu::ResidencyPriority priority) {
+        if (mD3d12Device1 == nullptr || allocation.GetInfo().mMethod != AllocationMethod::kDirect) {
+            return {};
+        }
+
+        ComPtr<ID3D12Pageable> pageable =
+            ToBackend(allocation.GetResourceHeap())->GetD3D12Pageable();
+        D3D12_RESIDENCY_PRIORITY d3d12Priority = D3D12ResidencyPriority(priority);
+        return CheckHRESULT(
+            mD3d12Device1->SetResidencyPriority(1, pageable.GetAddressOf(), &d3d12Priority),
+            "ID3D12Device1::SetResidencyPriority");
+    }
+
+    std::vector<MemoryTypeUsage> ResourceAllocatorManager::GetMemoryTypeUsages() const {
+        std::vector<MemoryTypeUsage> usages(ResourceHeapKind::EnumCount);
+        for (uint32_t i = 0; i < ResourceHeapKind::EnumCount; i++) {
+            const TLSFMemoryAllocator* allocators[] = {mSubAllocatedResourceAllocators[i].get(),
+                                                       mTransientResourceAllocators[i].get()};
+
+            usages[i].memoryType = i;
+            usages[i].heapSize = mCommittedResourceSizes[i];
+            usages[i].pendingDeletionSize = mPendingDeletionSizes[i];
+            for (const TLSFMemoryAllocator* allocator : allocators) {
+                usages[i].heapSize += allocator->GetAllocatedHeapSize();
+                usages[i].subAllocationHeapSize += allocator->GetAllocatedHeapSize();
+                usages[i].subAllocatedSize += allocator->GetUsedSize();
+            }
+        }
+        return usages;
+    }
 
+    size_t ResourceAllocatorManager::GetResourceHeapKindIndex(
+        const ResourceHeapAllocation& allocation) const {
         D3D12_HEAP_PROPERTIES heapProp;
         allocation.GetD3D12Resource()->GetHeapProperties(&heapProp, nullptr);
 
         const D3D12_RESOURCE_DESC resourceDescriptor = allocation.GetD3D12Resource()->GetDesc();
 
-        const size_t resourceHeapKindIndex =
-            GetResourceHeapKind(resourceDescriptor.Dimension, heapProp.Type,
-                                resourceDescriptor.Flags, mResourceHeapTier);
+        return GetResourceHeapKind(resourceDescriptor.Dimension, heapProp.Type,
+                                   resourceDescriptor.Flags, mResourceHeapTier);
+    }
+
+    void ResourceAllocatorManager::FreeMemory(ResourceHeapAllocation& allocation) {
+        ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated);
+
+        const size_t resourceHeapKindIndex = GetResourceHeapKindIndex(allocation);
 
-        mSubAllocatedResourceAllocators[resourceHeapKindIndex]->Deallocate(allocation);
+        if (ToBackend(allocation.GetResourceHeap())->IsTransient()) {
+            mTransientResourceAllocators[resourceHeapKindIndex]->Deallocate(allocation);
+        } else {
+            mSubAllocatedResourceAllocators[resourceHeapKindIndex]->Deallocate(allocation);
+        }
     }
 
     ResultOrError<ResourceHeapAllocation> ResourceAllocatorManager::CreatePlacedResource(
         D3D12_HEAP_TYPE heapType,
         const D3D12_RESOURCE_DESC& requestedResourceDescriptor,
-        D3D12_RESOURCE_STATES initialUsage) {
+        D3D12_RESOURCE_STATES initialUsage,
+        uint64_t excludedHeapIndex,
+        bool transient) {
         const ResourceHeapKind resourceHeapKind =
             GetResourceHeapKind(requestedResourceDescriptor.Dimension, heapType,
                                 requestedResourceDescriptor.Flags, mResourceHeapTier);
@@ -243,12 +463,14 @@ namespace dawn_native { namespace d3d12 {
             return DAWN_OUT_OF_MEMORY_ERROR("Resource allocation size was invalid.");
         }
 
-        BuddyMemoryAllocator* allocator =
-            mSubAllocatedResourceAllocators[static_cast<size_t>(resourceHeapKind)].get();
+        const size_t resourceHeapKindIndex = static_cast<size_t>(resourceHeapKind);
+        TLSFMemoryAllocator* allocator =
+            transient ? mTransientResourceAllocators[resourceHeapKindIndex].get()
+                      : mSubAllocatedResourceAllocators[resourceHeapKindIndex].get();
 
         ResourceMemoryAllocation allocation;
-        DAWN_TRY_ASSIGN(allocation,
-                        allocator->Allocate(resourceInfo.SizeInBytes, resourceInfo.Alignment));
+        DAWN_TRY_ASSIGN(allocation, allocator->Allocate(resourceInfo.SizeInBytes,
+                                                        resourceInfo.Alignment, excludedHeapIndex));
         if (allocation.GetInfo().mMethod == AllocationMethod::kInvalid) {
             return ResourceHeapAllocation{};  // invalid
         }
@@ -260,7 +482,7 @@ namespace dawn_native { namespace d3d12 {
         // upon Tick or after the last command list using the resource has completed
         // on the GPU. This means the same physical memory is not reused
         // within the same command-list and does not require additional synchronization (aliasing
-        // barrier).
+        // barrier). Transient resources are the exception and need an aliasing barrier.
         // https://docs.microsoft.com/en-us/windows/win32/api/d3d12/nf-d3d12-id3d12device-createplacedresource
         ComPtr<ID3D12Resource> placedResource;
         DAWN_TRY(CheckOutOfMemoryHRESULT(
@@ -273,6 +495,63 @@ namespace dawn_native { namespace d3d12 {
                                       std::move(placedResource), heap};
     }
 
+    void ResourceAllocatorManager::AddRelocatableBuffer(Buffer* buffer) {
+        mRelocatableBuffers.insert(buffer);
+    }
+
+    void ResourceAllocatorManager::RemoveRelocatableBuffer(Buffer* buffer) {
+        mRelocatableBuffers.erase(buffer);
+    }
+
+    MaybeError ResourceAllocatorManager::Defragment(CommandRecordingContext* commandContext,
+                                                    uint64_t maxRelocatedSize,
+                                                    uint64_t* relocatedSize) {
+        *relocatedSize = 0;
+
+        // Relocatable buffers all live in the default heaps of the same kind.
+        const ResourceHeapKind resourceHeapKind =
+            GetResourceHeapKind(D3D12_RESOURCE_DIMENSION_BUFFER, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_NONE, mResourceHeapTier);
+        TLSFMemoryAllocator* allocator =
+            mSubAllocatedResourceAllocators[static_cast<size_t>(resourceHeapKind)].get();
+
+        const uint64_t heapIndex = allocator->GetDefragmentationCandidate();
+        if (heapIndex == TLSFMemoryAllocator::kInvalidHeapIndex) {
+            return {};
+        }
+
+        std::vector<Buffer*> candidates;
+        for (Buffer* buffer : mRelocatableBuffers) {
+            const ResourceHeapAllocation& allocation = buffer->GetResourceAllocation();
+            if (allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated &&
+                allocator->GetHeapIndex(allocation) == heapIndex && buffer->CanRelocate()) {
+                candidates.push_back(buffer);
+            }
+        }
+
+        for (Buffer* buffer : candidates) {
+            ComPtr<ID3D12Resource> resource = buffer->GetD3D12Resource();
+            const D3D12_RESOURCE_DESC resourceDescriptor = resource->GetDesc();
+            if (*relocatedSize + resourceDescriptor.Width > maxRelocatedSize) {
+                break;
+            }
+
+            ResourceHeapAllocation newAllocation;
+            DAWN_TRY_ASSIGN(newAllocation,
+                            CreatePlacedResource(D3D12_HEAP_TYPE_DEFAULT, resourceDescriptor,
+                                                 D3D12_RESOURCE_STATE_COMMON, heapIndex));
+            // The other heaps are too fragmented to take the buffer.
+            if (newAllocation.GetInfo().mMethod == AllocationMethod::kInvalid) {
+                break;
+            }
+
+            buffer->Relocate(commandContext, std::move(newAllocation));
+            *relocatedSize += resourceDescriptor.Width;
+        }
+
+        return {};
+    }
+
     ResultOrError<ResourceHeapAllocation> ResourceAllocatorManager::CreateCommittedResource(
         D3D12_HEAP_TYPE heapType,
         const D3D12_RESOURCE_DESC& resourceDescriptor,
@@ -314,6 +593,11 @@ namespace dawn_native { namespace d3d12 {
 
         AllocationInfo info;
         info.mMethod = AllocationMethod::kDirect;
+        info.mRequestedSize = resourceInfo.SizeInBytes;
+
+        const ResourceHeapKind resourceHeapKind = GetResourceHeapKind(
+            resourceDescriptor.Dimension, heapType, resourceDescriptor.Flags, mResourceHeapTier);
+        mCommittedResourceSizes[static_cast<size_t>(resourceHeapKind)] += info.mRequestedSize;
 
         return ResourceHeapAllocation{info,
                                       /*offset*/ 0, std::move(committedResource), heap};
@@ -16,14 +16,21 @@
 #define DAWNNATIVE_D3D12_RESOURCEALLOCATORMANAGERD3D12_H_
 
 #include "common/SerialQueue.h"
-#include "dawn_native/BuddyMemoryAllocator.h"
+#include "dawn_native/dawn_platform.h"
+#include "dawn_native/RecyclingResourceHeapAllocator.h"
+#include "dawn_native/TLSFMemoryAllocator.h"
 #include "dawn_native/d3d12/HeapAllocatorD3D12.h"
+#include "dawn_native/d3d12/RayTracingBufferAllocatorD3D12.h"
 #include "dawn_native/d3d12/ResourceHeapAllocationD3D12.h"
 
 #include <array>
+#include <unordered_set>
+#include <vector>
 
 namespace dawn_native { namespace d3d12 {
 
+    class Buffer;
+    class CommandRecordingContext;
     class Device;
 
     // Resource heap types + flags combinations are named after the D3D constants.
@@ -58,39 +65,123 @@ namespace dawn_native { namespace d3d12 {
       public:
         ResourceAllocatorManager(Device* device);
 
+        // Resources with a priority other than normal get a committed resource so that their
+        // priority doesn't apply to the other resources placed in the same heap.
         ResultOrError<ResourceHeapAllocation> AllocateMemory(
+            D3D12_HEAP_TYPE heapType,
+            const D3D12_RESOURCE_DESC& resourceDescriptor,
+            D3D12_RESOURCE_STATES initialUsage,
+            wgpu::ResidencyPriority priority = wgpu::ResidencyPriority::Normal);
+
+        // Transient resources are placed in heaps of their own and their memory is reused by
+        // the next transient resources as soon as they are deallocated. The resources must be
+        // given an aliasing barrier before their first use.
+        ResultOrError<ResourceHeapAllocation> AllocateTransientMemory(
             D3D12_HEAP_TYPE heapType,
             const D3D12_RESOURCE_DESC& resourceDescriptor,
             D3D12_RESOURCE_STATES initialUsage);
 
         void DeallocateMemory(ResourceHeapAllocation& allocation);
 
+        // Acceleration structures are sub-allocated with their 256 byte alignment in buffers that
+        // stay in the D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE state, instead of
+        // each getting a resource of its own rounded up to 64KB. The resource heap of the
+        // allocations is a RayTracingBuffer which they are at the offset of.
+        ResultOrError<ResourceMemoryAllocation> AllocateAccelerationStructureMemory(
+            uint64_t size);
+        // Scratch memory of the acceleration structure builds, sub-allocated the same way in
+        // buffers that stay in the D3D12_RESOURCE_STATE_UNORDERED_ACCESS state.
+        ResultOrError<ResourceMemoryAllocation> AllocateAccelerationStructureScratchMemory(
+            uint64_t size);
+        // The memory is reused once the pending serial completed.
+        void DeallocateRayTracingMemory(ResourceMemoryAllocation& allocation);
+
+        // Sets the priority with which the OS keeps the memory of the allocation resident when
+        // the video memory is oversubscribed. Only committed resources have a priority of their
+        // own, placed resources keep the normal priority of their heap.
+        MaybeError SetResidencyPriority(const ResourceHeapAllocation& allocation,
+                                        wgpu::ResidencyPriority priority);
+
         void Tick(Serial lastCompletedSerial);
 
+        // One usage per resource heap kind, the memory type being the ResourceHeapKind.
+        std::vector<MemoryTypeUsage> GetMemoryTypeUsages() const;
+
+        // Buffers in the default heap register themselves so that they can be moved by
+        // Defragment.
+        void AddRelocatableBuffer(Buffer* buffer);
+        void RemoveRelocatableBuffer(Buffer* buffer);
+
+        // Moves the buffers out of the sparsest placed resource heap with copies recorded in
+        // |commandContext| so that the heap gets released once the copies completed. Buffers
+        // that bind groups or unsubmitted commands reference aren't moved since they use the
+        // D3D12 resource. At most |maxRelocatedSize| bytes are moved.
+        MaybeError Defragment(CommandRecordingContext* commandContext,
+                              uint64_t maxRelocatedSize,
+                              uint64_t* relocatedSize);
+
       private:
         void FreeMemory(ResourceHeapAllocation& allocation);
+        size_t GetResourceHeapKindIndex(const ResourceHeapAllocation& allocation) const;
 
         ResultOrError<ResourceHeapAllocation> CreatePlacedResource(
             D3D12_HEAP_TYPE heapType,
             const D3D12_RESOURCE_DESC& requestedResourceDescriptor,
-            D3D12_RESOURCE_STATES initialUsage);
+            D3D12_RESOURCE_STATES initialUsage,
+            uint64_t excludedHeapIndex = TLSFMemoryAllocator::kInvalidHeapIndex,
+            bool transient = false);
 
         ResultOrError<ResourceHeapAllocation> CreateCommittedResource(
             D3D12_HEAP_TYPE heapType,
             const D3D12_RESOURCE_DESC& resourceDescriptor,
             D3D12_RESOURCE_STATES initialUsage);
 
+        enum RayTracingMemoryKind {
+            AccelerationStructure,
+            AccelerationStructureScratch,
+
+            RayTracingMemoryKindCount,
+        };
+        ResultOrError<ResourceMemoryAllocation> AllocateRayTracingMemory(
+            RayTracingMemoryKind kind,
+            uint64_t size);
+        void FreeRayTracingMemory(const ResourceMemoryAllocation& allocation);
+
         Device* mDevice;
         uint32_t mResourceHeapTier;
 
+        // Null when the runtime doesn't support residency priorities.
+        ComPtr<ID3D12Device1> mD3d12Device1;
+
         static constexpr uint64_t kMaxHeapSize = 32ll * 1024ll * 1024ll * 1024ll;  // 32GB
-        static constexpr uint64_t kMinHeapSize = 4ll * 1024ll * 1024ll;            // 4MB
+        static constexpr uint64_t kPlacedResourceHeapSize = 4ll * 1024ll * 1024ll;  // 4MB
+        static constexpr uint64_t kTransientResourceHeapSize = 128ll * 1024ll * 1024ll;  // 128MB
 
-        std::array<std::unique_ptr<BuddyMemoryAllocator>, ResourceHeapKind::EnumCount>
+        std::array<std::unique_ptr<TLSFMemoryAllocator>, ResourceHeapKind::EnumCount>
             mSubAllocatedResourceAllocators;
         std::array<std::unique_ptr<HeapAllocator>, ResourceHeapKind::EnumCount> mHeapAllocators;
 
+        std::array<std::unique_ptr<HeapAllocator>, ResourceHeapKind::EnumCount>
+            mTransientHeapAllocators;
+        std::array<std::unique_ptr<RecyclingResourceHeapAllocator>, ResourceHeapKind::EnumCount>
+            mRecyclingHeapAllocators;
+        std::array<std::unique_ptr<TLSFMemoryAllocator>, ResourceHeapKind::EnumCount>
+            mTransientResourceAllocators;
+
         SerialQueue<ResourceHeapAllocation> mAllocationsToDelete;
+
+        std::array<uint64_t, ResourceHeapKind::EnumCount> mCommittedResourceSizes = {};
+        // The size of the allocations in mAllocationsToDelete.
+        std::array<uint64_t, ResourceHeapKind::EnumCount> mPendingDeletionSizes = {};
+
+        std::unordered_set<Buffer*> mRelocatableBuffers;
+
+        static constexpr uint64_t kRayTracingBufferSize = 4ll * 1024ll * 1024ll;  // 4MB
+        std::array<std::unique_ptr<RayTracingBufferAllocator>, RayTracingMemoryKindCount>
+            mRayTracingBufferAllocators;
+        std::array<std::unique_ptr<TLSFMemoryAllocator>, RayTracingMemoryKindCount>
+            mRayTracingMemoryAllocators;
+        SerialQueue<ResourceMemoryAllocation> mRayTracingAllocationsToDelete;
     };
 
 }}  // namespace dawn_native::d3d12
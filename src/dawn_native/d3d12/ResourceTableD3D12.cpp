@@ -0,0 +1,119 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/d3d12/ResourceTableD3D12.h"
+
+#include "dawn_native/d3d12/BufferD3D12.h"
+#include "dawn_native/d3d12/DeviceD3D12.h"
+#include "dawn_native/d3d12/ShaderVisibleDescriptorAllocatorD3D12.h"
+#include "dawn_native/d3d12/TextureD3D12.h"
+
+namespace dawn_native { namespace d3d12 {
+
+    // static
+    ResultOrError<ResourceTable*> ResourceTable::Create(Device* device,
+                                                        const ResourceTableDescriptor* descriptor) {
+        std::unique_ptr<ResourceTable> table = std::make_unique<ResourceTable>(device, descriptor);
+        DAWN_TRY(table->Initialize());
+        return table.release();
+    }
+
+    MaybeError ResourceTable::Initialize() {
+        // The empty slots are left uninitialized, which resource binding tier 2 allows for SRVs
+        // that aren't accessed.
+        mViewAllocator = std::make_unique<StagingDescriptorAllocator>(
+            ToBackend(GetDevice()), GetCapacity(), 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        DAWN_TRY_ASSIGN(mCPUViewAllocation, mViewAllocator->AllocateCPUDescriptors());
+        return {};
+    }
+
+    ResourceTable::~ResourceTable() {
+        if (mCPUViewAllocation.IsValid()) {
+            mViewAllocator->Deallocate(&mCPUViewAllocation);
+        }
+    }
+
+    void ResourceTable::DidUpdateSlot(uint32_t slot) {
+        mIsDirty = true;
+        if (!IsSlotSet(slot)) {
+            return;
+        }
+
+        ID3D12Device* d3d12Device = ToBackend(GetDevice())->GetD3D12Device().Get();
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptor =
+            mCPUViewAllocation.OffsetFrom(mViewAllocator->GetSizeIncrement(), slot);
+
+        switch (GetBindingType()) {
+            case wgpu::BindingType::SampledTexture: {
+                TextureView* view = ToBackend(GetSlotAsTextureView(slot));
+                const D3D12_SHADER_RESOURCE_VIEW_DESC& srv = view->GetSRVDescriptor();
+                d3d12Device->CreateShaderResourceView(
+                    ToBackend(view->GetTexture())->GetD3D12Resource(), &srv, descriptor);
+            } break;
+
+            case wgpu::BindingType::ReadonlyStorageBuffer: {
+                BufferBinding binding = GetSlotAsBufferBinding(slot);
+
+                // Same raw view as the readonly storage buffers of bind groups.
+                D3D12_SHADER_RESOURCE_VIEW_DESC desc;
+                desc.Format = DXGI_FORMAT_R32_TYPELESS;
+                desc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+                desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+                desc.Buffer.FirstElement = binding.offset / 4;
+                desc.Buffer.NumElements = binding.size / 4;
+                desc.Buffer.StructureByteStride = 0;
+                desc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
+                d3d12Device->CreateShaderResourceView(
+                    ToBackend(binding.buffer)->GetD3D12Resource().Get(), &desc, descriptor);
+            } break;
+
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    ResultOrError<bool> ResourceTable::Populate(ShaderVisibleDescriptorAllocator* allocator) {
+        // The copy in the shader-visible heap may be read by commands in flight, so updates are
+        // copied to a new allocation instead.
+        if (!mIsDirty && allocator->IsAllocationStillValid(mLastUsageSerial, mHeapSerial)) {
+            return true;
+        }
+
+        Device* device = ToBackend(GetDevice());
+        const Serial pendingSerial = device->GetPendingCommandSerial();
+
+        DescriptorHeapAllocation allocation;
+        DAWN_TRY_ASSIGN(allocation,
+                        allocator->AllocateGPUDescriptors(GetCapacity(), pendingSerial,
+                                                          D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
+        if (allocation.IsInvalid()) {
+            return false;
+        }
+
+        device->GetD3D12Device()->CopyDescriptorsSimple(
+            GetCapacity(), allocation.GetCPUHandle(0), mCPUViewAllocation.GetBaseDescriptor(),
+            D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        mBaseCbvSrvUavDescriptor = allocation.GetGPUHandle(0);
+
+        mIsDirty = false;
+        mLastUsageSerial = pendingSerial;
+        mHeapSerial = allocator->GetShaderVisibleHeapsSerial();
+        return true;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE ResourceTable::GetBaseCbvUavSrvDescriptor() const {
+        return mBaseCbvSrvUavDescriptor;
+    }
+
+}}  // namespace dawn_native::d3d12
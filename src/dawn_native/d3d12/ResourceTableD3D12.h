@@ -0,0 +1,63 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_D3D12_RESOURCETABLED3D12_H_
+#define DAWNNATIVE_D3D12_RESOURCETABLED3D12_H_
+
+#include "dawn_native/ResourceTable.h"
+
+#include "common/Serial.h"
+#include "dawn_native/d3d12/StagingDescriptorAllocatorD3D12.h"
+#include "dawn_native/d3d12/d3d12_platform.h"
+
+#include <memory>
+
+namespace dawn_native { namespace d3d12 {
+
+    class Device;
+    class ShaderVisibleDescriptorAllocator;
+
+    // The descriptors of the slots are created in a non shader-visible block when the slots are
+    // updated, and the whole block is copied to the shader-visible heap the first time the table
+    // is populated after an update. The copies used by commands in flight are never written.
+    class ResourceTable final : public ResourceTableBase {
+      public:
+        static ResultOrError<ResourceTable*> Create(Device* device,
+                                                    const ResourceTableDescriptor* descriptor);
+        ~ResourceTable() override;
+
+        // Returns true if the table was successfully populated, like BindGroup::Populate.
+        ResultOrError<bool> Populate(ShaderVisibleDescriptorAllocator* allocator);
+
+        D3D12_GPU_DESCRIPTOR_HANDLE GetBaseCbvUavSrvDescriptor() const;
+
+      private:
+        using ResourceTableBase::ResourceTableBase;
+
+        MaybeError Initialize();
+        void DidUpdateSlot(uint32_t slot) override;
+
+        std::unique_ptr<StagingDescriptorAllocator> mViewAllocator;
+        CPUDescriptorHeapAllocation mCPUViewAllocation;
+
+        // Whether the slots changed since the last copy to the shader-visible heap.
+        bool mIsDirty = true;
+        Serial mLastUsageSerial = 0;
+        Serial mHeapSerial = 0;
+        D3D12_GPU_DESCRIPTOR_HANDLE mBaseCbvSrvUavDescriptor = {0};
+    };
+
+}}  // namespace dawn_native::d3d12
+
+#endif  // DAWNNATIVE_D3D12_RESOURCETABLED3D12_H_
@@ -16,14 +16,26 @@
 
 #include "common/Assert.h"
 #include "common/BitSetIterator.h"
+#include "dawn_native/PersistentCache.h"
 #include "dawn_native/d3d12/BindGroupLayoutD3D12.h"
+#include "dawn_native/d3d12/D3D12Error.h"
 #include "dawn_native/d3d12/DeviceD3D12.h"
 #include "dawn_native/d3d12/PipelineLayoutD3D12.h"
+#include "dawn_native/d3d12/PlatformFunctions.h"
 
 #include <spirv_hlsl.hpp>
 
+#include <cstring>
+
 namespace dawn_native { namespace d3d12 {
 
+    namespace {
+
+        // Bump kBytecodeCacheVersion when the HLSL generation or compilation changes.
+        constexpr uint32_t kBytecodeCacheVersion = 3;
+
+    }  // anonymous namespace
+
     // static
     ResultOrError<ShaderModule*> ShaderModule::Create(Device* device,
                                                       const ShaderModuleDescriptor* descriptor) {
@@ -39,7 +51,6 @@ namespace dawn_native { namespace d3d12 {
     }
 
     MaybeError ShaderModule::Initialize(const ShaderModuleDescriptor* descriptor) {
-        mSpirv.assign(descriptor->code, descriptor->code + descriptor->codeSize);
         if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
             shaderc_spvc::CompileOptions options = GetCompileOptions();
 
@@ -56,12 +67,15 @@ namespace dawn_native { namespace d3d12 {
                 mSpvcContext.InitializeForHlsl(descriptor->code, descriptor->codeSize, options),
                 "Unable to initialize instance of spvc"));
 
-            spirv_cross::Compiler* compiler;
-            DAWN_TRY(CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
-                                      "Unable to get cross compiler"));
-            DAWN_TRY(ExtractSpirvInfo(*compiler));
-        } else {
-            spirv_cross::CompilerHLSL compiler(descriptor->code, descriptor->codeSize);
+            if (!LoadSpirvInfoFromCache()) {
+                spirv_cross::Compiler* compiler;
+                DAWN_TRY(
+                    CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
+                                     "Unable to get cross compiler"));
+                DAWN_TRY(ExtractSpirvInfo(*compiler));
+            }
+        } else if (!LoadSpirvInfoFromCache()) {
+            spirv_cross::Compiler compiler(GetParsedIR());
             DAWN_TRY(ExtractSpirvInfo(compiler));
         }
         return {};
@@ -85,7 +99,7 @@ namespace dawn_native { namespace d3d12 {
             options_hlsl.point_coord_compat = true;
             options_hlsl.point_size_compat = true;
 
-            compiler_impl = std::make_unique<spirv_cross::CompilerHLSL>(mSpirv);
+            compiler_impl = std::make_unique<spirv_cross::CompilerHLSL>(GetParsedIR());
             compiler = compiler_impl.get();
             compiler->set_common_options(options_glsl);
             compiler->set_hlsl_options(options_hlsl);
@@ -113,6 +127,19 @@ namespace dawn_native { namespace d3d12 {
                 }
             }
         }
+
+        // The push constant block is read from the root constants of the layout.
+        if (GetPushConstantSize() > 0) {
+            if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
+                // spvc was initialized for HLSL so its compiler is a CompilerHLSL.
+                DAWN_TRY(
+                    CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
+                                     "Unable to get cross compiler"));
+            }
+            compiler->set_root_constant_layouts(
+                {{0, GetPushConstantSize(), 0, PipelineLayout::kPushConstantRegisterSpace}});
+        }
+
         if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
             shaderc_spvc::CompilationResult result;
             DAWN_TRY(CheckSpvcSuccess(mSpvcContext.CompileShader(&result),
@@ -126,4 +153,178 @@ namespace dawn_native { namespace d3d12 {
         }
     }
 
+    D3D12_SHADER_BYTECODE ShaderModule::CompiledShader::GetD3D12ShaderBytecode() const {
+        ASSERT(bytecode != nullptr);
+        D3D12_SHADER_BYTECODE shaderBytecode;
+        shaderBytecode.pShaderBytecode = bytecode->data();
+        shaderBytecode.BytecodeLength = bytecode->size();
+        return shaderBytecode;
+    }
+
+    ResultOrError<ShaderModule::CompiledShader> ShaderModule::Compile(const char* entryPoint,
+                                                                      SingleShaderStage stage,
+                                                                      PipelineLayout* layout,
+                                                                      uint32_t compileFlags) {
+        Device* device = ToBackend(GetDevice());
+        const bool useDXC = device->IsToggleEnabled(Toggle::UseDXC);
+
+        // The generated HLSL depends on the module and on the register of each of the bindings
+        // it uses.
+        PersistentCacheKeyBuilder keyBuilder("D3D12ShaderBytecode", kBytecodeCacheVersion);
+        keyBuilder.RecordValue(device->IsToggleEnabled(Toggle::UseSpvc))
+            .RecordValue(useDXC)
+            .Record(std::string(entryPoint))
+            .RecordValue(stage)
+            .RecordValue(compileFlags);
+        const ModuleBindingInfo& moduleBindingInfo = GetBindingInfo();
+        for (uint32_t group : IterateBitSet(layout->GetBindGroupLayoutsMask())) {
+            const auto& bindingOffsets =
+                ToBackend(layout->GetBindGroupLayout(group))->GetBindingOffsets();
+            for (uint32_t binding = 0; binding < moduleBindingInfo[group].size(); ++binding) {
+                if (moduleBindingInfo[group][binding].used) {
+                    keyBuilder.RecordValue(group).RecordValue(binding).RecordValue(
+                        bindingOffsets[binding]);
+                }
+            }
+        }
+        PersistentCacheKey compilationKey = keyBuilder.Finish();
+
+        // Pipelines using compatible layouts share the compilations of the module.
+        auto it = mCompiledShaders.find(compilationKey);
+        if (it != mCompiledShaders.end()) {
+            return CompiledShader(it->second);
+        }
+
+        // The persistent cache is shared by all modules so its key also contains the SPIR-V.
+        PersistentCacheKey persistentKey =
+            PersistentCacheKeyBuilder("D3D12ShaderModuleBytecode", kBytecodeCacheVersion)
+                .Record(GetCode())
+                .Record(compilationKey)
+                .Finish();
+        PersistentCache* cache = device->GetPersistentCache();
+
+        std::vector<uint8_t> bytecode = cache->LoadData(persistentKey);
+        if (bytecode.empty()) {
+            std::string hlslSource;
+            DAWN_TRY_ASSIGN(hlslSource, GetHLSLSource(layout));
+
+            if (useDXC) {
+                DAWN_TRY_ASSIGN(bytecode,
+                                CompileWithDXC(hlslSource, entryPoint, stage, compileFlags));
+            } else {
+                DAWN_TRY_ASSIGN(bytecode,
+                                CompileWithFXC(hlslSource, entryPoint, stage, compileFlags));
+            }
+            cache->StoreData(persistentKey, bytecode.data(), bytecode.size());
+        }
+
+        CompiledShader compiledShader;
+        compiledShader.bytecode = std::make_shared<const std::vector<uint8_t>>(std::move(bytecode));
+        mCompiledShaders.emplace(std::move(compilationKey), compiledShader);
+        return std::move(compiledShader);
+    }
+
+    ResultOrError<std::vector<uint8_t>> ShaderModule::CompileWithFXC(const std::string& hlslSource,
+                                                                     const char* entryPoint,
+                                                                     SingleShaderStage stage,
+                                                                     uint32_t compileFlags) {
+        const char* target = nullptr;
+        switch (stage) {
+            case SingleShaderStage::Vertex:
+                target = "vs_5_1";
+                break;
+            case SingleShaderStage::Fragment:
+                target = "ps_5_1";
+                break;
+            case SingleShaderStage::Compute:
+                target = "cs_5_1";
+                break;
+            default:
+                UNREACHABLE();
+        }
+
+        ComPtr<ID3DBlob> compiledShader;
+        ComPtr<ID3DBlob> errors;
+        const PlatformFunctions* functions = ToBackend(GetDevice())->GetFunctions();
+        if (FAILED(functions->d3dCompile(hlslSource.c_str(), hlslSource.length(), nullptr, nullptr,
+                                         nullptr, entryPoint, target, compileFlags, 0,
+                                         &compiledShader, &errors))) {
+            std::string message = "D3D compile failed";
+            if (errors != nullptr) {
+                message += std::string(": ") + static_cast<const char*>(errors->GetBufferPointer());
+            }
+            return DAWN_VALIDATION_ERROR(message);
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(compiledShader->GetBufferPointer());
+        return std::vector<uint8_t>(data, data + compiledShader->GetBufferSize());
+    }
+
+    ResultOrError<std::vector<uint8_t>> ShaderModule::CompileWithDXC(const std::string& hlslSource,
+                                                                     const char* entryPoint,
+                                                                     SingleShaderStage stage,
+                                                                     uint32_t compileFlags) {
+        const wchar_t* target = nullptr;
+        switch (stage) {
+            case SingleShaderStage::Vertex:
+                target = L"vs_6_0";
+                break;
+            case SingleShaderStage::Fragment:
+                target = L"ps_6_0";
+                break;
+            case SingleShaderStage::Compute:
+                target = L"cs_6_0";
+                break;
+            default:
+                UNREACHABLE();
+        }
+
+        // DXC takes command-line arguments instead of the D3DCOMPILE flags.
+        std::vector<const wchar_t*> arguments;
+        if (compileFlags & D3DCOMPILE_DEBUG) {
+            arguments.push_back(DXC_ARG_DEBUG);
+        }
+        if (compileFlags & D3DCOMPILE_SKIP_OPTIMIZATION) {
+            arguments.push_back(DXC_ARG_SKIP_OPTIMIZATIONS);
+        }
+        if (compileFlags & D3DCOMPILE_PACK_MATRIX_ROW_MAJOR) {
+            arguments.push_back(DXC_ARG_PACK_MATRIX_ROW_MAJOR);
+        }
+
+        // Entry points are ASCII identifiers.
+        std::wstring entryPointW(entryPoint, entryPoint + strlen(entryPoint));
+
+        Device* device = ToBackend(GetDevice());
+        ComPtr<IDxcBlobEncoding> sourceBlob;
+        DAWN_TRY(CheckHRESULT(device->GetDxcLibrary()->CreateBlobWithEncodingOnHeapCopy(
+                                  hlslSource.c_str(), static_cast<UINT32>(hlslSource.length()),
+                                  CP_UTF8, &sourceBlob),
+                              "DXC create blob"));
+
+        ComPtr<IDxcOperationResult> result;
+        DAWN_TRY(CheckHRESULT(device->GetDxcCompiler()->Compile(
+                                  sourceBlob.Get(), nullptr, entryPointW.c_str(), target,
+                                  arguments.data(), static_cast<UINT32>(arguments.size()),
+                                  nullptr, 0, nullptr, &result),
+                              "DXC compile"));
+
+        HRESULT status;
+        DAWN_TRY(CheckHRESULT(result->GetStatus(&status), "DXC get status"));
+        if (FAILED(status)) {
+            std::string message = "DXC compile failed";
+            ComPtr<IDxcBlobEncoding> errors;
+            if (SUCCEEDED(result->GetErrorBuffer(&errors)) && errors != nullptr) {
+                message += ": " + std::string(static_cast<const char*>(errors->GetBufferPointer()),
+                                              errors->GetBufferSize());
+            }
+            return DAWN_VALIDATION_ERROR(message);
+        }
+
+        ComPtr<IDxcBlob> compiledShader;
+        DAWN_TRY(CheckHRESULT(result->GetResult(&compiledShader), "DXC get result"));
+
+        const uint8_t* data = static_cast<const uint8_t*>(compiledShader->GetBufferPointer());
+        return std::vector<uint8_t>(data, data + compiledShader->GetBufferSize());
+    }
+
 }}  // namespace dawn_native::d3d12
@@ -17,6 +17,11 @@
 
 #include "dawn_native/ShaderModule.h"
 
+#include "dawn_native/d3d12/d3d12_platform.h"
+
+#include <map>
+#include <memory>
+
 namespace dawn_native { namespace d3d12 {
 
     class Device;
@@ -29,11 +34,33 @@ namespace dawn_native { namespace d3d12 {
 
         ResultOrError<std::string> GetHLSLSource(PipelineLayout* layout);
 
+        // Compiled shaders are cached in memory per module and in the persistent cache so that
+        // pipelines with compatible layouts don't translate and compile the module again.
+        struct CompiledShader {
+            std::shared_ptr<const std::vector<uint8_t>> bytecode;
+
+            D3D12_SHADER_BYTECODE GetD3D12ShaderBytecode() const;
+        };
+        ResultOrError<CompiledShader> Compile(const char* entryPoint,
+                                              SingleShaderStage stage,
+                                              PipelineLayout* layout,
+                                              uint32_t compileFlags);
+
       private:
         ShaderModule(Device* device, const ShaderModuleDescriptor* descriptor);
         MaybeError Initialize(const ShaderModuleDescriptor* descriptor);
 
-        std::vector<uint32_t> mSpirv;
+        ResultOrError<std::vector<uint8_t>> CompileWithFXC(const std::string& hlslSource,
+                                                           const char* entryPoint,
+                                                           SingleShaderStage stage,
+                                                           uint32_t compileFlags);
+        ResultOrError<std::vector<uint8_t>> CompileWithDXC(const std::string& hlslSource,
+                                                           const char* entryPoint,
+                                                           SingleShaderStage stage,
+                                                           uint32_t compileFlags);
+
+        // Keyed by everything but the SPIR-V that the compilation depends on.
+        std::map<PersistentCacheKey, CompiledShader> mCompiledShaders;
     };
 
 }}  // namespace dawn_native::d3d12
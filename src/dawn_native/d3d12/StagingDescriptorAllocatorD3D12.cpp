@@ -0,0 +1,154 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/d3d12/StagingDescriptorAllocatorD3D12.h"
+
+#include "common/Assert.h"
+#include "dawn_native/d3d12/D3D12Error.h"
+#include "dawn_native/d3d12/DeviceD3D12.h"
+
+#include <algorithm>
+
+namespace dawn_native { namespace d3d12 {
+
+    CPUDescriptorHeapAllocation::CPUDescriptorHeapAllocation(
+        D3D12_CPU_DESCRIPTOR_HANDLE baseDescriptor,
+        uint32_t heapIndex)
+        : mBaseDescriptor(baseDescriptor), mHeapIndex(heapIndex) {
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE CPUDescriptorHeapAllocation::GetBaseDescriptor() const {
+        ASSERT(IsValid());
+        return mBaseDescriptor;
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE CPUDescriptorHeapAllocation::OffsetFrom(
+        uint32_t sizeIncrementInBytes,
+        uint32_t offsetInDescriptorCount) const {
+        ASSERT(IsValid());
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = mBaseDescriptor;
+        cpuHandle.ptr += sizeIncrementInBytes * offsetInDescriptorCount;
+        return cpuHandle;
+    }
+
+    uint32_t CPUDescriptorHeapAllocation::GetHeapIndex() const {
+        ASSERT(IsValid());
+        return mHeapIndex;
+    }
+
+    bool CPUDescriptorHeapAllocation::IsValid() const {
+        return mBaseDescriptor.ptr != 0;
+    }
+
+    void CPUDescriptorHeapAllocation::Invalidate() {
+        mBaseDescriptor = {0};
+        mHeapIndex = UINT32_MAX;
+    }
+
+    StagingDescriptorAllocator::StagingDescriptorAllocator(Device* device,
+                                                           uint32_t descriptorCount,
+                                                           uint32_t blocksPerHeap,
+                                                           D3D12_DESCRIPTOR_HEAP_TYPE heapType)
+        : mDevice(device),
+          mSizeIncrement(device->GetD3D12Device()->GetDescriptorHandleIncrementSize(heapType)),
+          mBlockSizeInDescriptors(descriptorCount),
+          mBlocksPerHeap(blocksPerHeap),
+          mHeapType(heapType) {
+        ASSERT(descriptorCount > 0);
+        ASSERT(blocksPerHeap > 0);
+    }
+
+    MaybeError StagingDescriptorAllocator::AllocateCPUHeap() {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDescriptor;
+        heapDescriptor.Type = mHeapType;
+        heapDescriptor.NumDescriptors = mBlockSizeInDescriptors * mBlocksPerHeap;
+        heapDescriptor.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        heapDescriptor.NodeMask = 0;
+
+        ComPtr<ID3D12DescriptorHeap> heap;
+        DAWN_TRY(CheckOutOfMemoryHRESULT(
+            mDevice->GetD3D12Device()->CreateDescriptorHeap(&heapDescriptor, IID_PPV_ARGS(&heap)),
+            "ID3D12Device::CreateDescriptorHeap"));
+
+        NonShaderVisibleHeap newHeap;
+        newHeap.heap = std::move(heap);
+        // Hand out the blocks in increasing order.
+        newHeap.freeBlockIndices.resize(mBlocksPerHeap);
+        for (uint32_t i = 0; i < mBlocksPerHeap; ++i) {
+            newHeap.freeBlockIndices[i] = mBlocksPerHeap - 1 - i;
+        }
+
+        mAvailableHeaps.push_back(static_cast<uint32_t>(mPool.size()));
+        mPool.push_back(std::move(newHeap));
+        return {};
+    }
+
+    ResultOrError<CPUDescriptorHeapAllocation>
+    StagingDescriptorAllocator::AllocateCPUDescriptors() {
+        if (mAvailableHeaps.empty()) {
+            DAWN_TRY(AllocateCPUHeap());
+        }
+
+        const uint32_t heapIndex = mAvailableHeaps.back();
+        NonShaderVisibleHeap& heap = mPool[heapIndex];
+        ASSERT(!heap.freeBlockIndices.empty());
+
+        const uint32_t blockIndex = heap.freeBlockIndices.back();
+        heap.freeBlockIndices.pop_back();
+        if (heap.freeBlockIndices.empty()) {
+            mAvailableHeaps.pop_back();
+        }
+
+        D3D12_CPU_DESCRIPTOR_HANDLE baseCPUDescriptor =
+            heap.heap->GetCPUDescriptorHandleForHeapStart();
+        baseCPUDescriptor.ptr +=
+            static_cast<size_t>(mSizeIncrement) * mBlockSizeInDescriptors * blockIndex;
+
+        return CPUDescriptorHeapAllocation{baseCPUDescriptor, heapIndex};
+    }
+
+    void StagingDescriptorAllocator::Deallocate(CPUDescriptorHeapAllocation* allocation) {
+        ASSERT(allocation->IsValid());
+
+        const uint32_t heapIndex = allocation->GetHeapIndex();
+        ASSERT(heapIndex < mPool.size());
+        NonShaderVisibleHeap& heap = mPool[heapIndex];
+
+        const size_t blockSizeInBytes =
+            static_cast<size_t>(mSizeIncrement) * mBlockSizeInDescriptors;
+        const size_t offsetInBytes = allocation->GetBaseDescriptor().ptr -
+                                     heap.heap->GetCPUDescriptorHandleForHeapStart().ptr;
+        ASSERT(offsetInBytes % blockSizeInBytes == 0);
+        const uint32_t blockIndex = static_cast<uint32_t>(offsetInBytes / blockSizeInBytes);
+        ASSERT(blockIndex < mBlocksPerHeap);
+
+        if (heap.freeBlockIndices.empty()) {
+            mAvailableHeaps.push_back(heapIndex);
+        }
+        ASSERT(std::find(heap.freeBlockIndices.begin(), heap.freeBlockIndices.end(), blockIndex) ==
+               heap.freeBlockIndices.end());
+        heap.freeBlockIndices.push_back(blockIndex);
+
+        allocation->Invalidate();
+    }
+
+    uint32_t StagingDescriptorAllocator::GetSizeIncrement() const {
+        return mSizeIncrement;
+    }
+
+    D3D12_DESCRIPTOR_HEAP_TYPE StagingDescriptorAllocator::GetHeapType() const {
+        return mHeapType;
+    }
+
+}}  // namespace dawn_native::d3d12
@@ -0,0 +1,90 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_D3D12_STAGINGDESCRIPTORALLOCATORD3D12_H_
+#define DAWNNATIVE_D3D12_STAGINGDESCRIPTORALLOCATORD3D12_H_
+
+#include "dawn_native/Error.h"
+#include "dawn_native/d3d12/d3d12_platform.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dawn_native { namespace d3d12 {
+
+    class Device;
+
+    // A block of descriptors in a non shader-visible heap.
+    class CPUDescriptorHeapAllocation {
+      public:
+        CPUDescriptorHeapAllocation() = default;
+        CPUDescriptorHeapAllocation(D3D12_CPU_DESCRIPTOR_HANDLE baseDescriptor,
+                                    uint32_t heapIndex);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE GetBaseDescriptor() const;
+        D3D12_CPU_DESCRIPTOR_HANDLE OffsetFrom(uint32_t sizeIncrementInBytes,
+                                               uint32_t offsetInDescriptorCount) const;
+        uint32_t GetHeapIndex() const;
+
+        bool IsValid() const;
+        void Invalidate();
+
+      private:
+        D3D12_CPU_DESCRIPTOR_HANDLE mBaseDescriptor = {0};
+        uint32_t mHeapIndex = UINT32_MAX;
+    };
+
+    // Allocates fixed-size blocks of descriptors in non shader-visible heaps. Each bind group
+    // layout uses one per heap type with blocks the size of its descriptor tables: bind groups
+    // create their descriptors once in their block and copy them to the shader-visible heaps with
+    // CopyDescriptorsSimple every time they are populated.
+    //
+    // The descriptors are only read on the CPU when they are copied so blocks can be deallocated
+    // right away, without waiting for the GPU.
+    class StagingDescriptorAllocator {
+      public:
+        StagingDescriptorAllocator(Device* device,
+                                   uint32_t descriptorCount,
+                                   uint32_t blocksPerHeap,
+                                   D3D12_DESCRIPTOR_HEAP_TYPE heapType);
+
+        ResultOrError<CPUDescriptorHeapAllocation> AllocateCPUDescriptors();
+        void Deallocate(CPUDescriptorHeapAllocation* allocation);
+
+        uint32_t GetSizeIncrement() const;
+        D3D12_DESCRIPTOR_HEAP_TYPE GetHeapType() const;
+
+      private:
+        struct NonShaderVisibleHeap {
+            ComPtr<ID3D12DescriptorHeap> heap;
+            std::vector<uint32_t> freeBlockIndices;
+        };
+
+        MaybeError AllocateCPUHeap();
+
+        Device* mDevice;
+
+        uint32_t mSizeIncrement;
+        uint32_t mBlockSizeInDescriptors;
+        uint32_t mBlocksPerHeap;
+        D3D12_DESCRIPTOR_HEAP_TYPE mHeapType;
+
+        std::vector<NonShaderVisibleHeap> mPool;
+        // The indices of the heaps of mPool that have free blocks.
+        std::vector<uint32_t> mAvailableHeaps;
+    };
+
+}}  // namespace dawn_native::d3d12
+
+#endif  // DAWNNATIVE_D3D12_STAGINGDESCRIPTORALLOCATORD3D12_H_
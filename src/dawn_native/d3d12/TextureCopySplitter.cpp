@@ -15,6 +15,7 @@
 #include "dawn_native/d3d12/TextureCopySplitter.h"
 
 #include "common/Assert.h"
+#include "common/Constants.h"
 #include "dawn_native/Format.h"
 #include "dawn_native/d3d12/d3d12_platform.h"
 
@@ -113,6 +114,48 @@ namespace dawn_native { namespace d3d12 {
             return copy;
         }
 
+        // The region's rows straddle the row pitch when the footprint is placed at alignedOffset.
+        // Placing it further back in the buffer shifts the start of the copy in the footprint's
+        // rows when the row pitch isn't a multiple of the placement alignment, which can make the
+        // rows fit and avoid splitting, for example when uploading many tiles to a
+        // 256-byte-aligned row pitch. This is only done for 2D copies because the footprint
+        // of the copy isn't laid out like the slices of the buffer.
+        if (copySize.depth == 1) {
+            uint32_t alignedDelta = static_cast<uint32_t>(offset - alignedOffset);
+            uint64_t placementOffset = alignedOffset;
+            uint32_t delta = alignedDelta;
+            // Offsets in the row pitch repeat after at most rowPitch / kTextureRowPitchAlignment
+            // placements since the row pitch is aligned to kTextureRowPitchAlignment.
+            for (uint32_t i = 1; i < rowPitch / kTextureRowPitchAlignment &&
+                                 placementOffset >= D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+                 ++i) {
+                placementOffset -= D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+                delta += D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+
+                uint32_t byteOffsetX = delta % rowPitch;
+                if (copyBytesPerRowPitch + byteOffsetX > rowPitch) {
+                    continue;
+                }
+
+                copy.offset = placementOffset;
+                copy.count = 1;
+
+                copy.copies[0].textureOffset = origin;
+
+                copy.copies[0].copySize = copySize;
+
+                copy.copies[0].bufferOffset.x =
+                    byteOffsetX / format.blockByteSize * format.blockWidth;
+                copy.copies[0].bufferOffset.y = delta / rowPitch * format.blockHeight;
+                copy.copies[0].bufferOffset.z = 0;
+                copy.copies[0].bufferSize.width = copySize.width + copy.copies[0].bufferOffset.x;
+                copy.copies[0].bufferSize.height = copySize.height + copy.copies[0].bufferOffset.y;
+                copy.copies[0].bufferSize.depth = 1;
+
+                return copy;
+            }
+        }
+
         // The region's rows straddle the row pitch. Split the copy into two copies
         //  |<--------------- row pitch --------------->|
         //
@@ -352,10 +352,21 @@ namespace dawn_native { namespace d3d12 {
         resourceDescriptor.Flags =
             D3D12ResourceFlags(GetUsage(), GetFormat(), IsMultisampledTexture());
 
-        DAWN_TRY_ASSIGN(mResourceAllocation,
-                        ToBackend(GetDevice())
-                            ->AllocateMemory(D3D12_HEAP_TYPE_DEFAULT, resourceDescriptor,
-                                             D3D12_RESOURCE_STATE_COMMON));
+        if (IsTransient()) {
+            DAWN_TRY_ASSIGN(mResourceAllocation,
+                            ToBackend(GetDevice())
+                                ->AllocateTransientMemory(D3D12_HEAP_TYPE_DEFAULT,
+                                                          resourceDescriptor,
+                                                          D3D12_RESOURCE_STATE_COMMON));
+            mNeedsAliasingBarrier =
+                mResourceAllocation.GetInfo().mMethod == AllocationMethod::kSubAllocated;
+        } else {
+            DAWN_TRY_ASSIGN(mResourceAllocation,
+                            ToBackend(GetDevice())
+                                ->AllocateMemory(D3D12_HEAP_TYPE_DEFAULT, resourceDescriptor,
+                                                 D3D12_RESOURCE_STATE_COMMON,
+                                                 GetResidencyPriority()));
+        }
 
         Device* device = ToBackend(GetDevice());
 
@@ -399,6 +410,12 @@ namespace dawn_native { namespace d3d12 {
         }
     }
 
+    MaybeError Texture::SetResidencyPriorityImpl() {
+        return ToBackend(GetDevice())
+            ->GetResourceAllocatorManager()
+            ->SetResidencyPriority(mResourceAllocation, GetResidencyPriority());
+    }
+
     DXGI_FORMAT Texture::GetD3D12Format() const {
         return D3D12TextureFormat(GetFormat().format);
     }
@@ -438,6 +455,11 @@ namespace dawn_native { namespace d3d12 {
             commandContext->TrackHeapUsage(heap, GetDevice()->GetPendingCommandSerial());
         }
 
+        if (mNeedsAliasingBarrier) {
+            commandContext->AddAliasingBarrier(GetD3D12Resource());
+            mNeedsAliasingBarrier = false;
+        }
+
         // Return the resource barrier.
         return TransitionUsageAndGetResourceBarrier(commandContext, barrier, newState);
     }
@@ -655,16 +677,25 @@ namespace dawn_native { namespace d3d12 {
             uint32_t bufferSize = static_cast<uint32_t>(bufferSize64);
             DynamicUploader* uploader = device->GetDynamicUploader();
             UploadHandle uploadHandle;
+            // The ring buffer doesn't align its allocations, so over-allocate to be able to place
+            // the clear data at an aligned offset, which needs a single copy region.
             DAWN_TRY_ASSIGN(uploadHandle,
-                            uploader->Allocate(bufferSize, device->GetPendingCommandSerial()));
-            memset(uploadHandle.mappedBuffer, clearColor, bufferSize);
+                            uploader->Allocate(
+                                bufferSize + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1,
+                                device->GetPendingCommandSerial()));
+            uint64_t alignedOffset =
+                (uploadHandle.startOffset + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) &
+                ~static_cast<uint64_t>(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+            memset(uploadHandle.mappedBuffer + (alignedOffset - uploadHandle.startOffset),
+                   clearColor, bufferSize);
 
             TrackUsageAndTransitionNow(commandContext, D3D12_RESOURCE_STATE_COPY_DEST);
 
             // compute d3d12 texture copy locations for texture and buffer
             Extent3D copySize = {GetSize().width, GetSize().height, 1};
             TextureCopySplit copySplit = ComputeTextureCopySplit(
-                {0, 0, 0}, copySize, GetFormat(), uploadHandle.startOffset, rowPitch, 0);
+                {0, 0, 0}, copySize, GetFormat(), alignedOffset, rowPitch, 0);
+            ASSERT(copySplit.count == 1);
 
             for (uint32_t level = baseMipLevel; level < baseMipLevel + levelCount; ++level) {
                 for (uint32_t layer = baseArrayLayer; layer < baseArrayLayer + layerCount;
@@ -77,6 +77,7 @@ namespace dawn_native { namespace d3d12 {
 
         // Dawn API
         void DestroyImpl() override;
+        MaybeError SetResidencyPriorityImpl() override;
         MaybeError ClearTexture(CommandRecordingContext* commandContext,
                                 uint32_t baseMipLevel,
                                 uint32_t levelCount,
@@ -98,6 +99,8 @@ namespace dawn_native { namespace d3d12 {
 
         Serial mLastUsedSerial = UINT64_MAX;
         bool mValidToDecay = false;
+        // Set for transient textures placed in memory that other transient resources used.
+        bool mNeedsAliasingBarrier = false;
 
         Serial mAcquireMutexKey = 0;
         ComPtr<IDXGIKeyedMutex> mDxgiKeyedMutex;
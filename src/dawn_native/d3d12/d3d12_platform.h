@@ -18,6 +18,7 @@
 #include <d3d11_2.h>
 #include <d3d11on12.h>
 #include <d3d12.h>
+#include <dxcapi.h>
 #include <dxgi1_4.h>
 #include <wrl.h>
 
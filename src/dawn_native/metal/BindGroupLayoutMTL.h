@@ -18,6 +18,8 @@
 #include "common/SlabAllocator.h"
 #include "dawn_native/BindGroupLayout.h"
 
+#import <Metal/Metal.h>
+
 namespace dawn_native { namespace metal {
 
     class BindGroup;
@@ -26,12 +28,18 @@ namespace dawn_native { namespace metal {
     class BindGroupLayout : public BindGroupLayoutBase {
       public:
         BindGroupLayout(DeviceBase* device, const BindGroupLayoutDescriptor* descriptor);
+        ~BindGroupLayout() override;
 
         BindGroup* AllocateBindGroup(Device* device, const BindGroupDescriptor* descriptor);
         void DeallocateBindGroup(BindGroup* bindGroup);
 
+        // Returns the encoder of the argument buffers of the bind groups, or nil when the bind
+        // groups are bound resource by resource. The binding numbers are the argument IDs.
+        id<MTLArgumentEncoder> GetArgumentEncoder() const API_AVAILABLE(macos(10.13), ios(11.0));
+
       private:
         SlabAllocator<BindGroup> mBindGroupAllocator;
+        id mArgumentEncoder = nil;
     };
 
 }}  // namespace dawn_native::metal
@@ -14,7 +14,10 @@
 
 #include "dawn_native/metal/BindGroupLayoutMTL.h"
 
+#include "common/BitSetIterator.h"
 #include "dawn_native/metal/BindGroupMTL.h"
+#include "dawn_native/metal/DeviceMTL.h"
+#include "dawn_native/metal/TextureMTL.h"
 
 namespace dawn_native { namespace metal {
 
@@ -22,6 +25,63 @@ namespace dawn_native { namespace metal {
                                      const BindGroupLayoutDescriptor* descriptor)
         : BindGroupLayoutBase(device, descriptor),
           mBindGroupAllocator(MakeFrontendBindGroupAllocator<BindGroup>(4096)) {
+        if (!ToBackend(device)->UseArgumentBuffers()) {
+            return;
+        }
+
+        // Bindings with dynamic offsets would need the argument buffer to be encoded again for
+        // each offset, and storage resources need more tracking, so only bind groups of uniform
+        // buffers, samplers and sampled textures use argument buffers.
+        const LayoutBindingInfo& info = GetBindingInfo();
+        if (info.mask.none() || info.hasDynamicOffset.any()) {
+            return;
+        }
+        for (uint32_t binding : IterateBitSet(info.mask)) {
+            switch (info.types[binding]) {
+                case wgpu::BindingType::UniformBuffer:
+                case wgpu::BindingType::Sampler:
+                case wgpu::BindingType::SampledTexture:
+                    break;
+                default:
+                    return;
+            }
+        }
+
+        if (@available(macOS 10.13, iOS 11.0, *)) {
+            NSMutableArray<MTLArgumentDescriptor*>* arguments = [NSMutableArray new];
+            for (uint32_t binding : IterateBitSet(info.mask)) {
+                MTLArgumentDescriptor* argument = [MTLArgumentDescriptor argumentDescriptor];
+                argument.index = binding;
+                argument.access = MTLArgumentAccessReadOnly;
+
+                switch (info.types[binding]) {
+                    case wgpu::BindingType::UniformBuffer:
+                        argument.dataType = MTLDataTypePointer;
+                        break;
+                    case wgpu::BindingType::Sampler:
+                        argument.dataType = MTLDataTypeSampler;
+                        break;
+                    case wgpu::BindingType::SampledTexture:
+                        argument.dataType = MTLDataTypeTexture;
+                        argument.textureType = MetalTextureViewType(
+                            info.textureDimensions[binding], info.multisampled[binding] ? 4 : 1);
+                        break;
+                    default:
+                        UNREACHABLE();
+                        break;
+                }
+
+                [arguments addObject:argument];
+            }
+
+            mArgumentEncoder =
+                [ToBackend(device)->GetMTLDevice() newArgumentEncoderWithArguments:arguments];
+            [arguments release];
+        }
+    }
+
+    BindGroupLayout::~BindGroupLayout() {
+        [mArgumentEncoder release];
     }
 
     BindGroup* BindGroupLayout::AllocateBindGroup(Device* device,
@@ -33,4 +93,8 @@ namespace dawn_native { namespace metal {
         mBindGroupAllocator.Deallocate(bindGroup);
     }
 
+    id<MTLArgumentEncoder> BindGroupLayout::GetArgumentEncoder() const {
+        return mArgumentEncoder;
+    }
+
 }}  // namespace dawn_native::metal
@@ -18,6 +18,10 @@
 #include "common/PlacementAllocated.h"
 #include "dawn_native/BindGroup.h"
 
+#import <Metal/Metal.h>
+
+#include <vector>
+
 namespace dawn_native { namespace metal {
 
     class BindGroupLayout;
@@ -29,6 +33,23 @@ namespace dawn_native { namespace metal {
         ~BindGroup() override;
 
         static BindGroup* Create(Device* device, const BindGroupDescriptor* descriptor);
+
+        // Returns the argument buffer the bind group is encoded in, or nil if its layout doesn't
+        // use argument buffers.
+        id<MTLBuffer> GetArgumentBuffer() const;
+
+        // Makes the resources referenced by the argument buffer resident for the encoder's pass.
+        void UseResources(id<MTLRenderCommandEncoder> encoder) const
+            API_AVAILABLE(macos(10.13), ios(11.0));
+        void UseResources(id<MTLComputeCommandEncoder> encoder) const
+            API_AVAILABLE(macos(10.13), ios(11.0));
+
+      private:
+        void EncodeArgumentBuffer(Device* device) API_AVAILABLE(macos(10.13), ios(11.0));
+
+        id<MTLBuffer> mArgumentBuffer = nil;
+        std::vector<id<MTLResource>> mReadBuffers;
+        std::vector<id<MTLResource>> mSampledTextures;
     };
 
 }}  // namespace dawn_native::metal
@@ -14,18 +14,87 @@
 
 #include "dawn_native/metal/BindGroupMTL.h"
 
+#include "common/BitSetIterator.h"
 #include "dawn_native/metal/BindGroupLayoutMTL.h"
+#include "dawn_native/metal/BufferMTL.h"
 #include "dawn_native/metal/DeviceMTL.h"
+#include "dawn_native/metal/SamplerMTL.h"
+#include "dawn_native/metal/TextureMTL.h"
+
 namespace dawn_native { namespace metal {
 
     BindGroup::BindGroup(Device* device, const BindGroupDescriptor* descriptor)
         : BindGroupBase(this, device, descriptor) {
+        if (@available(macOS 10.13, iOS 11.0, *)) {
+            if (ToBackend(GetLayout())->GetArgumentEncoder() != nil) {
+                EncodeArgumentBuffer(device);
+            }
+        }
     }
 
     BindGroup::~BindGroup() {
+        [mArgumentBuffer release];
         ToBackend(GetLayout())->DeallocateBindGroup(this);
     }
 
+    void BindGroup::EncodeArgumentBuffer(Device* device) {
+        id<MTLArgumentEncoder> encoder = ToBackend(GetLayout())->GetArgumentEncoder();
+
+        // The argument buffer is written once by the CPU, so it doesn't need to be managed.
+        mArgumentBuffer = [device->GetMTLDevice() newBufferWithLength:[encoder encodedLength]
+                                                              options:MTLResourceStorageModeShared];
+        [encoder setArgumentBuffer:mArgumentBuffer offset:0];
+
+        const auto& layout = GetLayout()->GetBindingInfo();
+        for (uint32_t bindingIndex : IterateBitSet(layout.mask)) {
+            switch (layout.types[bindingIndex]) {
+                case wgpu::BindingType::UniformBuffer: {
+                    const BufferBinding& binding = GetBindingAsBufferBinding(bindingIndex);
+                    id<MTLBuffer> buffer = ToBackend(binding.buffer)->GetMTLBuffer();
+                    [encoder setBuffer:buffer offset:binding.offset atIndex:bindingIndex];
+                    mReadBuffers.push_back(buffer);
+                } break;
+
+                case wgpu::BindingType::Sampler: {
+                    Sampler* sampler = ToBackend(GetBindingAsSampler(bindingIndex));
+                    [encoder setSamplerState:sampler->GetMTLSamplerState() atIndex:bindingIndex];
+                } break;
+
+                case wgpu::BindingType::SampledTexture: {
+                    TextureView* view = ToBackend(GetBindingAsTextureView(bindingIndex));
+                    [encoder setTexture:view->GetMTLTexture() atIndex:bindingIndex];
+                    mSampledTextures.push_back(view->GetMTLTexture());
+                } break;
+
+                default:
+                    UNREACHABLE();
+                    break;
+            }
+        }
+    }
+
+    id<MTLBuffer> BindGroup::GetArgumentBuffer() const {
+        return mArgumentBuffer;
+    }
+
+    void BindGroup::UseResources(id<MTLRenderCommandEncoder> encoder) const {
+        [encoder useResources:mReadBuffers.data()
+                        count:mReadBuffers.size()
+                        usage:MTLResourceUsageRead];
+        [encoder useResources:mSampledTextures.data()
+                        count:mSampledTextures.size()
+                        usage:MTLResourceUsageRead | MTLResourceUsageSample];
+    }
+
+    void BindGroup::UseResources(id<MTLComputeCommandEncoder> encoder) const {
+        [encoder useResources:mReadBuffers.data()
+                        count:mReadBuffers.size()
+                        usage:MTLResourceUsageRead];
+        [encoder useResources:mSampledTextures.data()
+                        count:mSampledTextures.size()
+                        usage:MTLResourceUsageRead | MTLResourceUsageSample];
+    }
+
     // static
     BindGroup* BindGroup::Create(Device* device, const BindGroupDescriptor* descriptor) {
         return ToBackend(descriptor->layout)->AllocateBindGroup(device, descriptor);
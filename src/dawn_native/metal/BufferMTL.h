@@ -31,6 +31,9 @@ namespace dawn_native { namespace metal {
 
         id<MTLBuffer> GetMTLBuffer() const;
 
+        // Records that the buffer is used by the pending command buffer.
+        void TrackUsage();
+
         void OnMapCommandSerialFinished(uint32_t mapSerial, bool isWrite);
 
       private:
@@ -42,8 +45,10 @@ namespace dawn_native { namespace metal {
 
         bool IsMapWritable() const override;
         MaybeError MapAtCreationImpl(uint8_t** mappedPointer) override;
+        MaybeError SetSubDataImpl(uint32_t start, uint32_t count, const void* data) override;
 
         id<MTLBuffer> mMtlBuffer = nil;
+        Serial mLastUsageSerial = 0;
     };
 
     class MapRequestTracker {
@@ -17,6 +17,8 @@
 #include "common/Math.h"
 #include "dawn_native/metal/DeviceMTL.h"
 
+#include <cstring>
+
 namespace dawn_native { namespace metal {
     // The size of uniform buffer and storage buffer need to be aligned to 16 bytes which is the
     // largest alignment of supported data types
@@ -27,6 +29,10 @@ namespace dawn_native { namespace metal {
         MTLResourceOptions storageMode;
         if (GetUsage() & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) {
             storageMode = MTLResourceStorageModeShared;
+        } else if (device->HasUnifiedMemory() && (GetUsage() & wgpu::BufferUsage::CopyDst)) {
+            // With unified memory, shared buffers are as fast as private ones for the GPU and
+            // they can be written without going through a staging buffer.
+            storageMode = MTLResourceStorageModeShared;
         } else {
             storageMode = MTLResourceStorageModePrivate;
         }
@@ -59,9 +65,12 @@ namespace dawn_native { namespace metal {
         }
     }
 
+    void Buffer::TrackUsage() {
+        mLastUsageSerial = ToBackend(GetDevice())->GetPendingCommandSerial();
+    }
+
     bool Buffer::IsMapWritable() const {
-        // TODO(enga): Handle CPU-visible memory on UMA
-        return (GetUsage() & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) != 0;
+        return [mMtlBuffer storageMode] == MTLStorageModeShared;
     }
 
     MaybeError Buffer::MapAtCreationImpl(uint8_t** mappedPointer) {
@@ -69,6 +78,19 @@ namespace dawn_native { namespace metal {
         return {};
     }
 
+    MaybeError Buffer::SetSubDataImpl(uint32_t start, uint32_t count, const void* data) {
+        // Shared buffers that the GPU is done with are written directly. The pending command
+        // buffer isn't submitted yet so the buffers it uses go through the staging buffer, which
+        // keeps the writes ordered with the commands.
+        if ([mMtlBuffer storageMode] == MTLStorageModeShared &&
+            mLastUsageSerial <= GetDevice()->GetCompletedCommandSerial()) {
+            memcpy(reinterpret_cast<uint8_t*>([mMtlBuffer contents]) + start, data, count);
+            return {};
+        }
+
+        return BufferBase::SetSubDataImpl(start, count, data);
+    }
+
     MaybeError Buffer::MapReadAsyncImpl(uint32_t serial) {
         MapRequestTracker* tracker = ToBackend(GetDevice())->GetMapTracker();
         tracker->Track(this, serial, false);
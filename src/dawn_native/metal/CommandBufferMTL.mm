@@ -14,6 +14,7 @@
 
 #include "dawn_native/metal/CommandBufferMTL.h"
 
+#include "common/Constants.h"
 #include "dawn_native/BindGroupTracker.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
@@ -90,7 +91,21 @@ namespace dawn_native { namespace metal {
                         break;
 
                     case wgpu::StoreOp::Clear:
-                        descriptor.colorAttachments[i].storeAction = MTLStoreActionDontCare;
+                        // The multisampled attachment is discarded but still resolved, like
+                        // transient attachments always are.
+                        if (hasResolveTarget) {
+                            descriptor.colorAttachments[i].resolveTexture =
+                                ToBackend(attachmentInfo.resolveTarget->GetTexture())
+                                    ->GetMTLTexture();
+                            descriptor.colorAttachments[i].resolveLevel =
+                                attachmentInfo.resolveTarget->GetBaseMipLevel();
+                            descriptor.colorAttachments[i].resolveSlice =
+                                attachmentInfo.resolveTarget->GetBaseArrayLayer();
+                            descriptor.colorAttachments[i].storeAction =
+                                MTLStoreActionMultisampleResolve;
+                        } else {
+                            descriptor.colorAttachments[i].storeAction = MTLStoreActionDontCare;
+                        }
                         break;
 
                     default:
@@ -471,9 +486,26 @@ namespace dawn_native { namespace metal {
                 : BindGroupTrackerBase(), mLengthTracker(lengthTracker) {
             }
 
+            void OnSetPipeline(RenderPipeline* pipeline) {
+                BindGroupTrackerBase::OnSetPipeline(pipeline);
+                SetArgumentBufferGroups(
+                    SingleShaderStage::Vertex,
+                    pipeline->GetArgumentBufferGroups(SingleShaderStage::Vertex));
+                SetArgumentBufferGroups(
+                    SingleShaderStage::Fragment,
+                    pipeline->GetArgumentBufferGroups(SingleShaderStage::Fragment));
+            }
+
+            void OnSetPipeline(ComputePipeline* pipeline) {
+                BindGroupTrackerBase::OnSetPipeline(pipeline);
+                SetArgumentBufferGroups(SingleShaderStage::Compute,
+                                        pipeline->GetArgumentBufferGroups());
+            }
+
             template <typename Encoder>
             void Apply(Encoder encoder) {
-                for (uint32_t index : IterateBitSet(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
+                for (uint32_t index :
+                     IterateBitSetWords(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
                     ApplyBindGroup(encoder, index, ToBackend(mBindGroups[index]),
                                    mDynamicOffsetCounts[index], mDynamicOffsets[index].data(),
                                    ToBackend(mPipelineLayout));
@@ -482,6 +514,74 @@ namespace dawn_native { namespace metal {
             }
 
           private:
+            // Bind groups are inherited by pipelines with compatible layouts, but they must be
+            // applied again when the shaders of the new pipeline switch between reading them from
+            // an argument buffer and reading the bindings individually.
+            void SetArgumentBufferGroups(SingleShaderStage stage,
+                                         std::bitset<kMaxBindGroups> groups) {
+                std::bitset<kMaxBindGroups> changedGroups =
+                    (mArgumentBufferGroups[stage] ^ groups) & mBindGroupLayoutsMask;
+                mDirtyBindGroups |= changedGroups;
+                mDirtyBindGroupsObjectChangedOrIsDynamic |= changedGroups;
+                mArgumentBufferGroups[stage] = groups;
+            }
+
+            // Binds the argument buffer of the group in the stages that read it and returns the
+            // stages that still need the bindings to be set individually.
+            wgpu::ShaderStage ApplyArgumentBuffer(id<MTLRenderCommandEncoder> render,
+                                                  id<MTLComputeCommandEncoder> compute,
+                                                  uint32_t index,
+                                                  BindGroup* group,
+                                                  PipelineLayout* pipelineLayout) {
+                bool vertexArgumentBuffer =
+                    render != nil && mArgumentBufferGroups[SingleShaderStage::Vertex][index];
+                bool fragmentArgumentBuffer =
+                    render != nil && mArgumentBufferGroups[SingleShaderStage::Fragment][index];
+                bool computeArgumentBuffer =
+                    compute != nil && mArgumentBufferGroups[SingleShaderStage::Compute][index];
+
+                wgpu::ShaderStage discreteStages = wgpu::ShaderStage::Vertex |
+                                                   wgpu::ShaderStage::Fragment |
+                                                   wgpu::ShaderStage::Compute;
+                if (!vertexArgumentBuffer && !fragmentArgumentBuffer && !computeArgumentBuffer) {
+                    return discreteStages;
+                }
+
+                id<MTLBuffer> argumentBuffer = group->GetArgumentBuffer();
+                ASSERT(argumentBuffer != nil);
+
+                if (@available(macOS 10.13, iOS 11.0, *)) {
+                    if (render != nil) {
+                        group->UseResources(render);
+                    } else {
+                        group->UseResources(compute);
+                    }
+                }
+
+                if (vertexArgumentBuffer) {
+                    [render setVertexBuffer:argumentBuffer
+                                     offset:0
+                                    atIndex:pipelineLayout->GetArgumentBufferIndex(
+                                                SingleShaderStage::Vertex, index)];
+                    discreteStages &= ~wgpu::ShaderStage::Vertex;
+                }
+                if (fragmentArgumentBuffer) {
+                    [render setFragmentBuffer:argumentBuffer
+                                       offset:0
+                                      atIndex:pipelineLayout->GetArgumentBufferIndex(
+                                                  SingleShaderStage::Fragment, index)];
+                    discreteStages &= ~wgpu::ShaderStage::Fragment;
+                }
+                if (computeArgumentBuffer) {
+                    [compute setBuffer:argumentBuffer
+                                offset:0
+                               atIndex:pipelineLayout->GetArgumentBufferIndex(
+                                           SingleShaderStage::Compute, index)];
+                    discreteStages &= ~wgpu::ShaderStage::Compute;
+                }
+                return discreteStages;
+            }
+
             // Handles a call to SetBindGroup, directing the commands to the correct encoder.
             // There is a single function that takes both encoders to factor code. Other approaches
             // like templates wouldn't work because the name of methods are different between the
@@ -493,14 +593,20 @@ namespace dawn_native { namespace metal {
                                     uint32_t dynamicOffsetCount,
                                     uint64_t* dynamicOffsets,
                                     PipelineLayout* pipelineLayout) {
+                wgpu::ShaderStage discreteStages =
+                    ApplyArgumentBuffer(render, compute, index, group, pipelineLayout);
+                if (discreteStages == wgpu::ShaderStage::None) {
+                    return;
+                }
+
                 const auto& layout = group->GetLayout()->GetBindingInfo();
                 uint32_t currentDynamicBufferIndex = 0;
 
                 // TODO(kainino@chromium.org): Maintain buffers and offsets arrays in BindGroup
                 // so that we only have to do one setVertexBuffers and one setFragmentBuffers
                 // call here.
-                for (uint32_t bindingIndex : IterateBitSet(layout.mask)) {
-                    auto stage = layout.visibilities[bindingIndex];
+                for (uint32_t bindingIndex : IterateBitSetWords(layout.mask)) {
+                    auto stage = layout.visibilities[bindingIndex] & discreteStages;
                     bool hasVertStage = stage & wgpu::ShaderStage::Vertex && render != nil;
                     bool hasFragStage = stage & wgpu::ShaderStage::Fragment && render != nil;
                     bool hasComputeStage = stage & wgpu::ShaderStage::Compute && compute != nil;
@@ -622,6 +728,7 @@ namespace dawn_native { namespace metal {
             }
 
             StorageBufferLengthTracker* mLengthTracker;
+            PerStage<std::bitset<kMaxBindGroups>> mArgumentBufferGroups;
         };
 
         // Keeps track of the dirty vertex buffer values so they can be lazily applied when we know
@@ -648,7 +755,7 @@ namespace dawn_native { namespace metal {
                 std::bitset<kMaxVertexBuffers> vertexBuffersToApply =
                     mDirtyVertexBuffers & pipeline->GetVertexBufferSlotsUsed();
 
-                for (uint32_t dawnIndex : IterateBitSet(vertexBuffersToApply)) {
+                for (uint32_t dawnIndex : IterateBitSetWords(vertexBuffersToApply)) {
                     uint32_t metalIndex = pipeline->GetMtlVertexBufferIndex(dawnIndex);
 
                     [encoder setVertexBuffers:&mVertexBuffers[dawnIndex]
@@ -680,6 +787,16 @@ namespace dawn_native { namespace metal {
         const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
         size_t nextPassNumber = 0;
 
+        // Shared buffers are written directly by SetSubData when the GPU no longer uses them.
+        for (BufferBase* buffer : GetResourceUsages().topLevelBuffers) {
+            ToBackend(buffer)->TrackUsage();
+        }
+        for (const PassResourceUsage& passUsages : passResourceUsages) {
+            for (BufferBase* buffer : passUsages.buffers) {
+                ToBackend(buffer)->TrackUsage();
+            }
+        }
+
         auto LazyClearForPass = [](const PassResourceUsage& usages) {
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
@@ -687,8 +804,11 @@ namespace dawn_native { namespace metal {
                 // cleared in CreateMTLRenderPassDescriptor by setting the loadop to clear when the
                 // texture subresource has not been initialized before the render pass.
                 if (!(usages.textureUsages[i] & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(0, texture->GetNumMipLevels(), 0,
-                                                                 texture->GetArrayLayers());
+                    const SubresourceRange& range = usages.textureRanges[i];
+                    texture->EnsureSubresourceContentInitialized(range.baseMipLevel,
+                                                                 range.levelCount,
+                                                                 range.baseArrayLayer,
+                                                                 range.layerCount);
                 }
             }
         };
@@ -811,6 +931,40 @@ namespace dawn_native { namespace metal {
                         destinationOrigin:MakeMTLOrigin(copy->destination.origin)];
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    uint32_t layerCount = texture->GetArrayLayers();
+
+                    // The generated levels are overwritten entirely.
+                    texture->EnsureSubresourceContentInitialized(cmd->baseMipLevel, 1, 0,
+                                                                 layerCount);
+                    texture->SetIsSubresourceContentInitialized(true, cmd->baseMipLevel + 1,
+                                                                cmd->mipLevelCount - 1, 0,
+                                                                layerCount);
+
+                    // Metal generates all the levels after the first one of the texture, so
+                    // other ranges of levels use a view.
+                    id<MTLTexture> mtlTexture = texture->GetMTLTexture();
+                    bool needsView = cmd->baseMipLevel != 0 ||
+                                     cmd->mipLevelCount != texture->GetNumMipLevels();
+                    if (needsView) {
+                        mtlTexture = [mtlTexture
+                            newTextureViewWithPixelFormat:mtlTexture.pixelFormat
+                                              textureType:mtlTexture.textureType
+                                                   levels:NSMakeRange(cmd->baseMipLevel,
+                                                                      cmd->mipLevelCount)
+                                                   slices:NSMakeRange(0, layerCount)];
+                    }
+
+                    [commandContext->EnsureBlit() generateMipmapsForTexture:mtlTexture];
+
+                    // The command buffer retains the view until it completes.
+                    if (needsView) {
+                        [mtlTexture release];
+                    }
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
@@ -850,7 +1004,7 @@ namespace dawn_native { namespace metal {
                     bindGroups.Apply(encoder);
                     storageBufferLengths.Apply(encoder, lastPipeline);
 
-                    Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
+                    Buffer* buffer = ToBackend(dispatch->indirectBuffer);
                     id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
                     [encoder dispatchThreadgroupsWithIndirectBuffer:indirectBuffer
                                                indirectBufferOffset:dispatch->indirectOffset
@@ -860,7 +1014,7 @@ namespace dawn_native { namespace metal {
 
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
+                    lastPipeline = ToBackend(cmd->pipeline);
 
                     bindGroups.OnSetPipeline(lastPipeline);
 
@@ -869,12 +1023,9 @@ namespace dawn_native { namespace metal {
 
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(&mCommands, cmd);
 
-                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
+                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group),
                                               cmd->dynamicOffsetCount, dynamicOffsets);
                 } break;
 
@@ -1082,11 +1233,15 @@ namespace dawn_native { namespace metal {
                     bindGroups.Apply(encoder);
                     storageBufferLengths.Apply(encoder, lastPipeline);
 
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                    // Metal has no multi draw indirect, the draws are encoded one by one.
+                    ASSERT(draw->countBuffer == nullptr);
+                    Buffer* buffer = ToBackend(draw->indirectBuffer);
                     id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
-                    [encoder drawPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                              indirectBuffer:indirectBuffer
-                        indirectBufferOffset:draw->indirectOffset];
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        [encoder drawPrimitives:lastPipeline->GetMTLPrimitiveTopology()
+                                  indirectBuffer:indirectBuffer
+                            indirectBufferOffset:draw->indirectOffset + i * kDrawIndirectSize];
+                    }
                 } break;
 
                 case Command::DrawIndexedIndirect: {
@@ -1096,14 +1251,19 @@ namespace dawn_native { namespace metal {
                     bindGroups.Apply(encoder);
                     storageBufferLengths.Apply(encoder, lastPipeline);
 
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                    ASSERT(draw->countBuffer == nullptr);
+                    Buffer* buffer = ToBackend(draw->indirectBuffer);
                     id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
-                    [encoder drawIndexedPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                         indexType:lastPipeline->GetMTLIndexType()
-                                       indexBuffer:indexBuffer
-                                 indexBufferOffset:indexBufferBaseOffset
-                                    indirectBuffer:indirectBuffer
-                              indirectBufferOffset:draw->indirectOffset];
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        uint64_t indirectBufferOffset =
+                            draw->indirectOffset + i * kDrawIndexedIndirectSize;
+                        [encoder drawIndexedPrimitives:lastPipeline->GetMTLPrimitiveTopology()
+                                             indexType:lastPipeline->GetMTLIndexType()
+                                           indexBuffer:indexBuffer
+                                     indexBufferOffset:indexBufferBaseOffset
+                                        indirectBuffer:indirectBuffer
+                                  indirectBufferOffset:indirectBufferOffset];
+                    }
                 } break;
 
                 case Command::InsertDebugMarker: {
@@ -1132,7 +1292,7 @@ namespace dawn_native { namespace metal {
 
                 case Command::SetRenderPipeline: {
                     SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* newPipeline = ToBackend(cmd->pipeline).Get();
+                    RenderPipeline* newPipeline = ToBackend(cmd->pipeline);
 
                     vertexBuffers.OnSetPipeline(lastPipeline, newPipeline);
                     bindGroups.OnSetPipeline(newPipeline);
@@ -1147,18 +1307,15 @@ namespace dawn_native { namespace metal {
 
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(iter, cmd);
 
-                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
+                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group),
                                               cmd->dynamicOffsetCount, dynamicOffsets);
                 } break;
 
                 case Command::SetIndexBuffer: {
                     SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-                    auto b = ToBackend(cmd->buffer.Get());
+                    auto b = ToBackend(cmd->buffer);
                     indexBuffer = b->GetMTLBuffer();
                     indexBufferBaseOffset = cmd->offset;
                 } break;
@@ -1166,7 +1323,7 @@ namespace dawn_native { namespace metal {
                 case Command::SetVertexBuffer: {
                     SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
 
-                    vertexBuffers.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
+                    vertexBuffers.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer),
                                                     cmd->offset);
                 } break;
 
@@ -19,6 +19,8 @@
 
 #import <Metal/Metal.h>
 
+#include <bitset>
+
 namespace dawn_native { namespace metal {
 
     class Device;
@@ -33,6 +35,9 @@ namespace dawn_native { namespace metal {
         MTLSize GetLocalWorkGroupSize() const;
         bool RequiresStorageBufferLength() const;
 
+        // The bind groups that the compute stage reads from argument buffers.
+        std::bitset<kMaxBindGroups> GetArgumentBufferGroups() const;
+
       private:
         using ComputePipelineBase::ComputePipelineBase;
         MaybeError Initialize(const ComputePipelineDescriptor* descriptor);
@@ -40,6 +45,7 @@ namespace dawn_native { namespace metal {
         id<MTLComputePipelineState> mMtlComputePipelineState = nil;
         MTLSize mLocalWorkgroupSize;
         bool mRequiresStorageBufferLength;
+        std::bitset<kMaxBindGroups> mArgumentBufferGroups;
     };
 
 }}  // namespace dawn_native::metal
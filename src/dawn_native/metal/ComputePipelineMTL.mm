@@ -49,6 +49,7 @@ namespace dawn_native { namespace metal {
         // Copy over the local workgroup size as it is passed to dispatch explicitly in Metal
         mLocalWorkgroupSize = computeData.localWorkgroupSize;
         mRequiresStorageBufferLength = computeData.needsStorageBufferLength;
+        mArgumentBufferGroups = computeData.argumentBufferGroups;
         return {};
     }
 
@@ -68,4 +69,8 @@ namespace dawn_native { namespace metal {
         return mRequiresStorageBufferLength;
     }
 
+    std::bitset<kMaxBindGroups> ComputePipeline::GetArgumentBufferGroups() const {
+        return mArgumentBufferGroups;
+    }
+
 }}  // namespace dawn_native::metal
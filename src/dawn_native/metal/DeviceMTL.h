@@ -55,6 +55,13 @@ namespace dawn_native { namespace metal {
 
         MapRequestTracker* GetMapTracker() const;
 
+        // Whether the compatible bind groups are encoded in argument buffers.
+        bool UseArgumentBuffers() const;
+
+        // Whether the GPU and CPU share the same memory, in which case MTLStorageModeShared
+        // resources don't have a performance penalty on the GPU.
+        bool HasUnifiedMemory() const;
+
         TextureBase* CreateTextureWrappingIOSurface(const ExternalImageDescriptor* descriptor,
                                                     IOSurfaceRef ioSurface,
                                                     uint32_t plane);
@@ -69,17 +76,11 @@ namespace dawn_native { namespace metal {
 
       private:
         ResultOrError<RayTracingAccelerationContainerBase*> CreateRayTracingAccelerationContainerImpl(
-            const RayTracingAccelerationContainerDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingAccelerationContainerDescriptor* descriptor) override;
         ResultOrError<RayTracingShaderBindingTableBase*> CreateRayTracingShaderBindingTableImpl(
-            const RayTracingShaderBindingTableDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingShaderBindingTableDescriptor* descriptor) override;
         ResultOrError<RayTracingPipelineBase*> CreateRayTracingPipelineImpl(
-            const RayTracingPipelineDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingPipelineDescriptor* descriptor) override;
         ResultOrError<BindGroupBase*> CreateBindGroupImpl(
             const BindGroupDescriptor* descriptor) override;
         ResultOrError<BindGroupLayoutBase*> CreateBindGroupLayoutImpl(
@@ -89,9 +90,13 @@ namespace dawn_native { namespace metal {
             const ComputePipelineDescriptor* descriptor) override;
         ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) override;
-        ResultOrError<QueueBase*> CreateQueueImpl() override;
+        ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) override;
         ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) override;
+        ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) override;
         ResultOrError<SamplerBase*> CreateSamplerImpl(const SamplerDescriptor* descriptor) override;
         ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
             const ShaderModuleDescriptor* descriptor) override;
@@ -113,6 +118,7 @@ namespace dawn_native { namespace metal {
         id<MTLDevice> mMtlDevice = nil;
         id<MTLCommandQueue> mCommandQueue = nil;
         std::unique_ptr<MapRequestTracker> mMapTracker;
+        bool mHasUnifiedMemory = false;
 
         Serial mLastSubmittedSerial = 0;
         CommandRecordingContext mCommandContext;
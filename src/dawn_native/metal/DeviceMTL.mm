@@ -48,6 +48,14 @@ namespace dawn_native { namespace metal {
         [mMtlDevice retain];
         mCommandQueue = [mMtlDevice newCommandQueue];
 
+#if defined(DAWN_PLATFORM_IOS)
+        mHasUnifiedMemory = true;
+#else
+        if (@available(macOS 10.15, *)) {
+            mHasUnifiedMemory = [mMtlDevice hasUnifiedMemory];
+        }
+#endif
+
         InitTogglesFromDriver();
         if (descriptor != nil) {
             ApplyToggleOverrides(descriptor);
@@ -88,9 +96,44 @@ namespace dawn_native { namespace metal {
             SetToggle(Toggle::DisableBaseInstance, !haveBaseVertexBaseInstance);
         }
 
+        {
+            bool haveTier2ArgumentBuffers = false;
+            if (@available(macOS 10.13, iOS 11.0, *)) {
+                haveTier2ArgumentBuffers =
+                    [mMtlDevice argumentBuffersSupport] == MTLArgumentBuffersTier2;
+            }
+            SetToggle(Toggle::MetalUseArgumentBuffers, haveTier2ArgumentBuffers);
+        }
+
         // TODO(jiawei.shao@intel.com): tighten this workaround when the driver bug is fixed.
         SetToggle(Toggle::AlwaysResolveIntoZeroLevelAndLayer, true);
     }
+
+    bool Device::HasUnifiedMemory() const {
+        return mHasUnifiedMemory;
+    }
+
+    bool Device::UseArgumentBuffers() const {
+        // The argument buffers are only implemented in the SPIRV-Cross path of the shader
+        // translation.
+        return IsToggleEnabled(Toggle::MetalUseArgumentBuffers) &&
+               !IsToggleEnabled(Toggle::UseSpvc);
+    }
+    // Ray tracing shaders are SPIR-V using SPV_NV_ray_tracing, which SPIRV-Cross can't translate
+    // to MSL, so ray tracing isn't implemented on Metal yet.
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    Device::CreateRayTracingAccelerationContainerImpl(
+        const RayTracingAccelerationContainerDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Ray tracing isn't implemented on the Metal backend yet");
+    }
+    ResultOrError<RayTracingShaderBindingTableBase*> Device::CreateRayTracingShaderBindingTableImpl(
+        const RayTracingShaderBindingTableDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Ray tracing isn't implemented on the Metal backend yet");
+    }
+    ResultOrError<RayTracingPipelineBase*> Device::CreateRayTracingPipelineImpl(
+        const RayTracingPipelineDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Ray tracing isn't implemented on the Metal backend yet");
+    }
     ResultOrError<BindGroupBase*> Device::CreateBindGroupImpl(
         const BindGroupDescriptor* descriptor) {
         return BindGroup::Create(this, descriptor);
@@ -114,13 +157,20 @@ namespace dawn_native { namespace metal {
         const PipelineLayoutDescriptor* descriptor) {
         return new PipelineLayout(this, descriptor);
     }
-    ResultOrError<QueueBase*> Device::CreateQueueImpl() {
-        return new Queue(this);
+    ResultOrError<QuerySetBase*> Device::CreateQuerySetImpl(const QuerySetDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Query sets aren't implemented on the Metal backend yet");
+    }
+    ResultOrError<QueueBase*> Device::CreateQueueImpl(const QueueDescriptor* descriptor) {
+        return new Queue(this, descriptor);
     }
     ResultOrError<RenderPipelineBase*> Device::CreateRenderPipelineImpl(
         const RenderPipelineDescriptor* descriptor) {
         return RenderPipeline::Create(this, descriptor);
     }
+    ResultOrError<ResourceTableBase*> Device::CreateResourceTableImpl(
+        const ResourceTableDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Resource tables aren't implemented on the Metal backend yet");
+    }
     ResultOrError<SamplerBase*> Device::CreateSamplerImpl(const SamplerDescriptor* descriptor) {
         return Sampler::Create(this, descriptor);
     }
@@ -260,10 +310,11 @@ namespace dawn_native { namespace metal {
                                                uint64_t destinationOffset,
                                                uint64_t size) {
         id<MTLBuffer> uploadBuffer = ToBackend(source)->GetBufferHandle();
-        id<MTLBuffer> buffer = ToBackend(destination)->GetMTLBuffer();
+        Buffer* buffer = ToBackend(destination);
+        buffer->TrackUsage();
         [GetPendingCommandContext()->EnsureBlit() copyFromBuffer:uploadBuffer
                                                     sourceOffset:sourceOffset
-                                                        toBuffer:buffer
+                                                        toBuffer:buffer->GetMTLBuffer()
                                                destinationOffset:destinationOffset
                                                             size:size];
         return {};
@@ -19,6 +19,8 @@
 
 #include "dawn_native/PerStage.h"
 
+#include <bitset>
+
 #import <Metal/Metal.h>
 
 namespace spirv_cross {
@@ -47,9 +49,17 @@ namespace dawn_native { namespace metal {
         // The number of Metal vertex stage buffers used for the whole pipeline layout.
         uint32_t GetBufferBindingCount(SingleShaderStage stage);
 
+        // The bind groups that may be bound with an argument buffer in |stage|: their layout
+        // uses argument buffers and all their bindings are visible to the stage. The shaders
+        // still fall back to the binding indices above for the groups they don't fully use.
+        std::bitset<kMaxBindGroups> GetArgumentBufferGroups(SingleShaderStage stage) const;
+        uint32_t GetArgumentBufferIndex(SingleShaderStage stage, uint32_t group) const;
+
       private:
         PerStage<BindingIndexInfo> mIndexInfo;
         PerStage<uint32_t> mBufferBindingCount;
+        PerStage<std::bitset<kMaxBindGroups>> mArgumentBufferGroups;
+        PerStage<std::array<uint32_t, kMaxBindGroups>> mArgumentBufferIndices;
     };
 
 }}  // namespace dawn_native::metal
@@ -15,7 +15,7 @@
 #include "dawn_native/metal/PipelineLayoutMTL.h"
 
 #include "common/BitSetIterator.h"
-#include "dawn_native/BindGroupLayout.h"
+#include "dawn_native/metal/BindGroupLayoutMTL.h"
 #include "dawn_native/metal/DeviceMTL.h"
 
 namespace dawn_native { namespace metal {
@@ -63,6 +63,32 @@ namespace dawn_native { namespace metal {
                 }
             }
 
+            // The argument buffers are placed after the buffers bound individually.
+            if (@available(macOS 10.13, iOS 11.0, *)) {
+                for (uint32_t group : IterateBitSet(GetBindGroupLayoutsMask())) {
+                    const BindGroupLayout* bgl = ToBackend(GetBindGroupLayout(group));
+                    if (bgl->GetArgumentEncoder() == nil) {
+                        continue;
+                    }
+
+                    const auto& groupInfo = bgl->GetBindingInfo();
+                    bool allBindingsVisible = true;
+                    for (uint32_t binding : IterateBitSet(groupInfo.mask)) {
+                        if (!(groupInfo.visibilities[binding] & StageBit(stage))) {
+                            allBindingsVisible = false;
+                            break;
+                        }
+                    }
+                    if (!allBindingsVisible) {
+                        continue;
+                    }
+
+                    mArgumentBufferGroups[stage].set(group);
+                    mArgumentBufferIndices[stage][group] = bufferIndex;
+                    bufferIndex++;
+                }
+            }
+
             mBufferBindingCount[stage] = bufferIndex;
         }
     }
@@ -76,4 +102,15 @@ namespace dawn_native { namespace metal {
         return mBufferBindingCount[stage];
     }
 
+    std::bitset<kMaxBindGroups> PipelineLayout::GetArgumentBufferGroups(
+        SingleShaderStage stage) const {
+        return mArgumentBufferGroups[stage];
+    }
+
+    uint32_t PipelineLayout::GetArgumentBufferIndex(SingleShaderStage stage,
+                                                    uint32_t group) const {
+        ASSERT(mArgumentBufferGroups[stage][group]);
+        return mArgumentBufferIndices[stage][group];
+    }
+
 }}  // namespace dawn_native::metal
@@ -24,7 +24,7 @@ namespace dawn_native { namespace metal {
 
     class Queue : public QueueBase {
       public:
-        Queue(Device* device);
+        Queue(Device* device, const QueueDescriptor* descriptor);
 
       private:
         MaybeError SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) override;
@@ -17,6 +17,8 @@
 
 #include "dawn_native/RenderPipeline.h"
 
+#include "dawn_native/PerStage.h"
+
 #import <Metal/Metal.h>
 
 namespace dawn_native { namespace metal {
@@ -44,6 +46,9 @@ namespace dawn_native { namespace metal {
 
         wgpu::ShaderStage GetStagesRequiringStorageBufferLength() const;
 
+        // The bind groups that |stage| reads from argument buffers.
+        std::bitset<kMaxBindGroups> GetArgumentBufferGroups(SingleShaderStage stage) const;
+
       private:
         using RenderPipelineBase::RenderPipelineBase;
         MaybeError Initialize(const RenderPipelineDescriptor* descriptor);
@@ -59,6 +64,7 @@ namespace dawn_native { namespace metal {
         std::array<uint32_t, kMaxVertexBuffers> mMtlVertexBufferIndices;
 
         wgpu::ShaderStage mStagesRequiringStorageBufferLength = wgpu::ShaderStage::None;
+        PerStage<std::bitset<kMaxBindGroups>> mArgumentBufferGroups;
     };
 
 }}  // namespace dawn_native::metal
@@ -342,6 +342,7 @@ namespace dawn_native { namespace metal {
         if (vertexData.needsStorageBufferLength) {
             mStagesRequiringStorageBufferLength |= wgpu::ShaderStage::Vertex;
         }
+        mArgumentBufferGroups[SingleShaderStage::Vertex] = vertexData.argumentBufferGroups;
 
         ShaderModule* fragmentModule = ToBackend(descriptor->fragmentStage->module);
         const char* fragmentEntryPoint = descriptor->fragmentStage->entryPoint;
@@ -353,6 +354,7 @@ namespace dawn_native { namespace metal {
         if (fragmentData.needsStorageBufferLength) {
             mStagesRequiringStorageBufferLength |= wgpu::ShaderStage::Fragment;
         }
+        mArgumentBufferGroups[SingleShaderStage::Fragment] = fragmentData.argumentBufferGroups;
 
         if (HasDepthStencilAttachment()) {
             // TODO(kainino@chromium.org): Handle depth-only and stencil-only formats.
@@ -440,6 +442,11 @@ namespace dawn_native { namespace metal {
         return mStagesRequiringStorageBufferLength;
     }
 
+    std::bitset<kMaxBindGroups> RenderPipeline::GetArgumentBufferGroups(
+        SingleShaderStage stage) const {
+        return mArgumentBufferGroups[stage];
+    }
+
     MTLVertexDescriptor* RenderPipeline::MakeVertexDesc() {
         MTLVertexDescriptor* mtlVertexDescriptor = [MTLVertexDescriptor new];
 
@@ -81,6 +81,12 @@ namespace dawn_native { namespace metal {
             mtlDesc.compareFunction = ToMetalCompareFunction(descriptor->compare);
         }
 
+        if (device->UseArgumentBuffers()) {
+            if (@available(macOS 10.13, iOS 11.0, *)) {
+                mtlDesc.supportArgumentBuffers = YES;
+            }
+        }
+
         mMtlSamplerState = [device->GetMTLDevice() newSamplerStateWithDescriptor:mtlDesc];
 
         [mtlDesc release];
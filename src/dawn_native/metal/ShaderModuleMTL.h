@@ -20,6 +20,10 @@
 #import <Metal/Metal.h>
 
 #include "dawn_native/Error.h"
+#include "dawn_native/PersistentCache.h"
+
+#include <bitset>
+#include <map>
 
 namespace spirv_cross {
     class CompilerMSL;
@@ -34,11 +38,14 @@ namespace dawn_native { namespace metal {
       public:
         static ResultOrError<ShaderModule*> Create(Device* device,
                                                    const ShaderModuleDescriptor* descriptor);
+        ~ShaderModule() override;
 
         struct MetalFunctionData {
             id<MTLFunction> function;
             MTLSize localWorkgroupSize;
             bool needsStorageBufferLength;
+            // The bind groups the function reads from an argument buffer.
+            std::bitset<kMaxBindGroups> argumentBufferGroups;
             ~MetalFunctionData() {
                 [function release];
             }
@@ -52,12 +59,32 @@ namespace dawn_native { namespace metal {
         ShaderModule(Device* device, const ShaderModuleDescriptor* descriptor);
         MaybeError Initialize(const ShaderModuleDescriptor* descriptor);
 
+        // The library compiled from the MSL of an entry point and the reflection done when
+        // generating the MSL.
+        struct CompiledLibrary {
+            id<MTLLibrary> library;
+            MTLSize localWorkgroupSize;
+            bool needsStorageBufferLength;
+            std::bitset<kMaxBindGroups> argumentBufferGroups;
+        };
+        ResultOrError<CompiledLibrary> CompileLibrary(const PersistentCacheKey& key,
+                                                      const char* functionName,
+                                                      SingleShaderStage functionStage,
+                                                      const PipelineLayout* layout);
+
+        // Generates the MSL source and reflects the workgroup size, the need for the buffer
+        // lengths and the bind groups using argument buffers in |out|.
+        MaybeError TranslateToMSL(const char* functionName,
+                                  SingleShaderStage functionStage,
+                                  const PipelineLayout* layout,
+                                  std::string* mslSource,
+                                  MetalFunctionData* out);
+
         shaderc_spvc::CompileOptions GetMSLCompileOptions();
 
-        // Calling compile on CompilerMSL somehow changes internal state that makes subsequent
-        // compiles return invalid MSL. We keep the spirv around and recreate the compiler everytime
-        // we need to use it.
-        std::vector<uint32_t> mSpirv;
+        // Pipelines using the same entry point with compatible layouts share the same library,
+        // keyed by the same key as the persistent cache of the MSL source.
+        std::map<PersistentCacheKey, CompiledLibrary> mCompiledLibraries;
     };
 
 }}  // namespace dawn_native::metal
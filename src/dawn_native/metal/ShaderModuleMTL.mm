@@ -15,11 +15,13 @@
 #include "dawn_native/metal/ShaderModuleMTL.h"
 
 #include "dawn_native/BindGroupLayout.h"
+#include "dawn_native/PersistentCache.h"
 #include "dawn_native/metal/DeviceMTL.h"
 #include "dawn_native/metal/PipelineLayoutMTL.h"
 
 #include <spirv_msl.hpp>
 
+#include <cstring>
 #include <sstream>
 
 namespace dawn_native { namespace metal {
@@ -52,6 +54,18 @@ namespace dawn_native { namespace metal {
                     return shaderc_spvc_execution_model_invalid;
             }
         }
+
+        // Bump kMSLCacheVersion when the MSL generation or the layout of the cached data
+        // changes.
+        constexpr uint32_t kMSLCacheVersion = 2;
+
+        // The cached MSL source is prefixed with the results of the reflection done at the same
+        // time.
+        struct CachedMSLHeader {
+            uint32_t localWorkgroupSize[3];
+            uint32_t needsStorageBufferLength;
+            uint32_t argumentBufferGroups;
+        };
     }  // namespace
 
     // static
@@ -68,8 +82,19 @@ namespace dawn_native { namespace metal {
         : ShaderModuleBase(device, descriptor) {
     }
 
+    ShaderModule::~ShaderModule() {
+        for (auto& it : mCompiledLibraries) {
+            [it.second.library release];
+        }
+    }
+
     MaybeError ShaderModule::Initialize(const ShaderModuleDescriptor* descriptor) {
-        mSpirv.assign(descriptor->code, descriptor->code + descriptor->codeSize);
+        // GetFunction creates a new compiler for each translation so one is only needed here to
+        // do the reflection.
+        if (LoadSpirvInfoFromCache()) {
+            return {};
+        }
+
         if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
             shaderc_spvc::CompileOptions options = GetMSLCompileOptions();
 
@@ -82,7 +107,7 @@ namespace dawn_native { namespace metal {
                                       "Unable to get cross compiler"));
             DAWN_TRY(ExtractSpirvInfo(*compiler));
         } else {
-            spirv_cross::CompilerMSL compiler(mSpirv);
+            spirv_cross::Compiler compiler(GetParsedIR());
             DAWN_TRY(ExtractSpirvInfo(compiler));
         }
         return {};
@@ -94,13 +119,135 @@ namespace dawn_native { namespace metal {
                                          ShaderModule::MetalFunctionData* out) {
         ASSERT(!IsError());
         ASSERT(out);
+
+        // The translation only depends on the module, the entry point and the MSL indices that
+        // the layout gives to the bindings and the argument buffers.
+        PersistentCacheKeyBuilder keyBuilder("MetalShaderSource", kMSLCacheVersion);
+        keyBuilder.RecordValue(GetDevice()->IsToggleEnabled(Toggle::UseSpvc))
+            .Record(GetCode())
+            .Record(std::string(functionName))
+            .RecordValue(functionStage);
+        for (uint32_t group : IterateBitSet(layout->GetBindGroupLayoutsMask())) {
+            const auto& bgInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+            for (uint32_t binding : IterateBitSet(bgInfo.mask)) {
+                for (auto stage : IterateStages(bgInfo.visibilities[binding])) {
+                    keyBuilder.RecordValue(group).RecordValue(binding).RecordValue(stage);
+                    keyBuilder.RecordValue(layout->GetBindingIndexInfo(stage)[group][binding]);
+                }
+            }
+        }
+        for (uint32_t group : IterateBitSet(layout->GetArgumentBufferGroups(functionStage))) {
+            keyBuilder.RecordValue(group).RecordValue(
+                layout->GetArgumentBufferIndex(functionStage, group));
+        }
+        PersistentCacheKey key = keyBuilder.Finish();
+
+        auto it = mCompiledLibraries.find(key);
+        if (it == mCompiledLibraries.end()) {
+            CompiledLibrary compiledLibrary;
+            DAWN_TRY_ASSIGN(compiledLibrary,
+                            CompileLibrary(key, functionName, functionStage, layout));
+            it = mCompiledLibraries.emplace(std::move(key), compiledLibrary).first;
+        }
+        const CompiledLibrary& compiledLibrary = it->second;
+
+        out->localWorkgroupSize = compiledLibrary.localWorkgroupSize;
+        out->needsStorageBufferLength = compiledLibrary.needsStorageBufferLength;
+        out->argumentBufferGroups = compiledLibrary.argumentBufferGroups;
+
+        // TODO(kainino@chromium.org): make this somehow more robust; it needs to behave like
+        // clean_func_name:
+        // https://github.com/KhronosGroup/SPIRV-Cross/blob/4e915e8c483e319d0dd7a1fa22318bef28f8cca3/spirv_msl.cpp#L1213
+        if (strcmp(functionName, "main") == 0) {
+            functionName = "main0";
+        }
+
+        NSString* name = [NSString stringWithFormat:@"%s", functionName];
+        out->function = [compiledLibrary.library newFunctionWithName:name];
+
+        return {};
+    }
+
+    ResultOrError<ShaderModule::CompiledLibrary> ShaderModule::CompileLibrary(
+        const PersistentCacheKey& key,
+        const char* functionName,
+        SingleShaderStage functionStage,
+        const PipelineLayout* layout) {
+        // The MSL translation is reused from the persistent cache when possible, but the library
+        // still has to be compiled from it.
+        MetalFunctionData reflection;
+        reflection.function = nil;
+
+        PersistentCache* cache = GetDevice()->GetPersistentCache();
+        std::string mslSource;
+        std::vector<uint8_t> cachedData = cache->LoadData(key);
+        if (cachedData.size() >= sizeof(CachedMSLHeader)) {
+            CachedMSLHeader header;
+            memcpy(&header, cachedData.data(), sizeof(header));
+            reflection.localWorkgroupSize = MTLSizeMake(header.localWorkgroupSize[0],
+                                                        header.localWorkgroupSize[1],
+                                                        header.localWorkgroupSize[2]);
+            reflection.needsStorageBufferLength = header.needsStorageBufferLength != 0;
+            reflection.argumentBufferGroups = header.argumentBufferGroups;
+            mslSource.assign(reinterpret_cast<const char*>(cachedData.data()) + sizeof(header),
+                             cachedData.size() - sizeof(header));
+        } else {
+            DAWN_TRY(TranslateToMSL(functionName, functionStage, layout, &mslSource, &reflection));
+
+            CachedMSLHeader header = {};
+            header.localWorkgroupSize[0] =
+                static_cast<uint32_t>(reflection.localWorkgroupSize.width);
+            header.localWorkgroupSize[1] =
+                static_cast<uint32_t>(reflection.localWorkgroupSize.height);
+            header.localWorkgroupSize[2] =
+                static_cast<uint32_t>(reflection.localWorkgroupSize.depth);
+            header.needsStorageBufferLength = reflection.needsStorageBufferLength ? 1 : 0;
+            header.argumentBufferGroups =
+                static_cast<uint32_t>(reflection.argumentBufferGroups.to_ulong());
+
+            std::vector<uint8_t> data(sizeof(header) + mslSource.size());
+            memcpy(data.data(), &header, sizeof(header));
+            memcpy(data.data() + sizeof(header), mslSource.data(), mslSource.size());
+            cache->StoreData(key, data.data(), data.size());
+        }
+
+        NSString* mslSourceString = [NSString stringWithFormat:@"%s", mslSource.c_str()];
+        auto mtlDevice = ToBackend(GetDevice())->GetMTLDevice();
+        NSError* error = nil;
+        id<MTLLibrary> library = [mtlDevice newLibraryWithSource:mslSourceString
+                                                         options:nil
+                                                           error:&error];
+        if (error != nil) {
+            // TODO(cwallez@chromium.org): Switch that NSLog to use dawn::InfoLog or even be
+            // folded in the DAWN_VALIDATION_ERROR
+            NSLog(@"MTLDevice newLibraryWithSource => %@", error);
+            if (error.code != MTLLibraryErrorCompileWarning) {
+                [library release];
+                return DAWN_VALIDATION_ERROR("Unable to create library object");
+            }
+        }
+
+        CompiledLibrary compiledLibrary;
+        compiledLibrary.library = library;
+        compiledLibrary.localWorkgroupSize = reflection.localWorkgroupSize;
+        compiledLibrary.needsStorageBufferLength = reflection.needsStorageBufferLength;
+        compiledLibrary.argumentBufferGroups = reflection.argumentBufferGroups;
+        return compiledLibrary;
+    }
+
+    MaybeError ShaderModule::TranslateToMSL(const char* functionName,
+                                            SingleShaderStage functionStage,
+                                            const PipelineLayout* layout,
+                                            std::string* mslSource,
+                                            ShaderModule::MetalFunctionData* out) {
         std::unique_ptr<spirv_cross::CompilerMSL> compiler_impl;
         spirv_cross::CompilerMSL* compiler;
         if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
             // Initializing the compiler is needed every call, because this method uses reflection
             // to mutate the compiler's IR.
             DAWN_TRY(CheckSpvcSuccess(
-                mSpvcContext.InitializeForMsl(mSpirv.data(), mSpirv.size(), GetMSLCompileOptions()),
+                mSpvcContext.InitializeForMsl(GetCode().data(), GetCode().size(),
+                                              GetMSLCompileOptions()),
                 "Unable to initialize instance of spvc"));
             DAWN_TRY(CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
                                       "Unable to get cross compiler"));
@@ -120,11 +267,82 @@ namespace dawn_native { namespace metal {
             // the shader storage buffer lengths.
             options_msl.buffer_size_buffer_index = kBufferLengthBufferSlot;
 
-            compiler_impl = std::make_unique<spirv_cross::CompilerMSL>(mSpirv);
+            // Calling compile on CompilerMSL changes its internal state in a way that makes
+            // subsequent compiles return invalid MSL, so each translation uses a new compiler.
+            compiler_impl = std::make_unique<spirv_cross::CompilerMSL>(GetParsedIR());
             compiler = compiler_impl.get();
             compiler->set_msl_options(options_msl);
         }
 
+        // Bind groups are read from an argument buffer when the layout allows it and the entry
+        // point uses all their bindings, so that the argument buffer structure generated by
+        // SPIRV-Cross matches the one of the bind group layout's argument encoder.
+        out->argumentBufferGroups.reset();
+        if (!GetDevice()->IsToggleEnabled(Toggle::UseSpvc) &&
+            layout->GetArgumentBufferGroups(functionStage).any()) {
+            std::array<std::bitset<kMaxBindingsPerGroup>, kMaxBindGroups> activeBindings;
+            spirv_cross::ShaderResources resources =
+                compiler->get_shader_resources(compiler->get_active_interface_variables());
+            auto RecordActiveBindings = [&](const auto& resourceList) {
+                for (const spirv_cross::Resource& resource : resourceList) {
+                    uint32_t group =
+                        compiler->get_decoration(resource.id, spv::DecorationDescriptorSet);
+                    uint32_t binding =
+                        compiler->get_decoration(resource.id, spv::DecorationBinding);
+                    if (group < kMaxBindGroups && binding < kMaxBindingsPerGroup) {
+                        activeBindings[group].set(binding);
+                    }
+                }
+            };
+            RecordActiveBindings(resources.uniform_buffers);
+            RecordActiveBindings(resources.storage_buffers);
+            RecordActiveBindings(resources.storage_images);
+            RecordActiveBindings(resources.sampled_images);
+            RecordActiveBindings(resources.separate_images);
+            RecordActiveBindings(resources.separate_samplers);
+
+            for (uint32_t group : IterateBitSet(layout->GetArgumentBufferGroups(functionStage))) {
+                const auto& bgInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+                if (activeBindings[group] == bgInfo.mask) {
+                    out->argumentBufferGroups.set(group);
+                }
+            }
+        }
+
+        if (out->argumentBufferGroups.any()) {
+            spirv_cross::CompilerMSL::Options options_msl = compiler->get_msl_options();
+            options_msl.set_msl_version(2, 0);
+            options_msl.argument_buffers = true;
+            compiler->set_msl_options(options_msl);
+
+            for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
+                if (!out->argumentBufferGroups[group]) {
+                    compiler->add_discrete_descriptor_set(group);
+                    continue;
+                }
+
+                // The argument IDs are the binding numbers.
+                const auto& bgInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+                for (uint32_t binding : IterateBitSet(bgInfo.mask)) {
+                    spirv_cross::MSLResourceBinding mslBinding;
+                    mslBinding.stage = SpirvExecutionModelForStage(functionStage);
+                    mslBinding.desc_set = group;
+                    mslBinding.binding = binding;
+                    mslBinding.msl_buffer = mslBinding.msl_texture = mslBinding.msl_sampler =
+                        binding;
+                    compiler->add_msl_resource_binding(mslBinding);
+                }
+
+                spirv_cross::MSLResourceBinding argumentBufferBinding;
+                argumentBufferBinding.stage = SpirvExecutionModelForStage(functionStage);
+                argumentBufferBinding.desc_set = group;
+                argumentBufferBinding.binding = spirv_cross::kArgumentBufferBinding;
+                argumentBufferBinding.msl_buffer =
+                    layout->GetArgumentBufferIndex(functionStage, group);
+                compiler->add_msl_resource_binding(argumentBufferBinding);
+            }
+        }
+
         // By default SPIRV-Cross will give MSL resources indices in increasing order.
         // To make the MSL indices match the indices chosen in the PipelineLayout, we build
         // a table of MSLResourceBinding to give to SPIRV-Cross.
@@ -134,6 +352,10 @@ namespace dawn_native { namespace metal {
             const auto& bgInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
             for (uint32_t binding : IterateBitSet(bgInfo.mask)) {
                 for (auto stage : IterateStages(bgInfo.visibilities[binding])) {
+                    if (stage == functionStage && out->argumentBufferGroups[group]) {
+                        continue;
+                    }
+
                     uint32_t index = layout->GetBindingIndexInfo(stage)[group][binding];
                     if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
                         shaderc_spvc_msl_resource_binding mslBinding;
@@ -176,43 +398,15 @@ namespace dawn_native { namespace metal {
         {
             // SPIRV-Cross also supports re-ordering attributes but it seems to do the correct thing
             // by default.
-            NSString* mslSource;
             if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
                 shaderc_spvc::CompilationResult result;
                 DAWN_TRY(CheckSpvcSuccess(mSpvcContext.CompileShader(&result),
                                           "Unable to compile MSL shader"));
-                std::string result_str;
-                DAWN_TRY(CheckSpvcSuccess(result.GetStringOutput(&result_str),
+                DAWN_TRY(CheckSpvcSuccess(result.GetStringOutput(mslSource),
                                           "Unable to get MSL shader text"));
-                mslSource = [NSString stringWithFormat:@"%s", result_str.c_str()];
             } else {
-                std::string msl = compiler->compile();
-                mslSource = [NSString stringWithFormat:@"%s", msl.c_str()];
-            }
-            auto mtlDevice = ToBackend(GetDevice())->GetMTLDevice();
-            NSError* error = nil;
-            id<MTLLibrary> library = [mtlDevice newLibraryWithSource:mslSource
-                                                             options:nil
-                                                               error:&error];
-            if (error != nil) {
-                // TODO(cwallez@chromium.org): Switch that NSLog to use dawn::InfoLog or even be
-                // folded in the DAWN_VALIDATION_ERROR
-                NSLog(@"MTLDevice newLibraryWithSource => %@", error);
-                if (error.code != MTLLibraryErrorCompileWarning) {
-                    return DAWN_VALIDATION_ERROR("Unable to create library object");
-                }
+                *mslSource = compiler->compile();
             }
-
-            // TODO(kainino@chromium.org): make this somehow more robust; it needs to behave like
-            // clean_func_name:
-            // https://github.com/KhronosGroup/SPIRV-Cross/blob/4e915e8c483e319d0dd7a1fa22318bef28f8cca3/spirv_msl.cpp#L1213
-            if (strcmp(functionName, "main") == 0) {
-                functionName = "main0";
-            }
-
-            NSString* name = [NSString stringWithFormat:@"%s", functionName];
-            out->function = [library newFunctionWithName:name];
-            [library release];
         }
 
         if (GetDevice()->IsToggleEnabled(Toggle::UseSpvc)) {
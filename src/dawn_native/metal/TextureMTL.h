@@ -26,6 +26,8 @@ namespace dawn_native { namespace metal {
     class Device;
 
     MTLPixelFormat MetalPixelFormat(wgpu::TextureFormat format);
+    MTLTextureType MetalTextureViewType(wgpu::TextureViewDimension dimension,
+                                        unsigned int sampleCount);
     MaybeError ValidateIOSurfaceCanBeWrapped(const DeviceBase* device,
                                              const TextureDescriptor* descriptor,
                                              IOSurfaceRef ioSurface,
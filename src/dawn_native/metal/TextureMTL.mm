@@ -68,23 +68,6 @@ namespace dawn_native { namespace metal {
             }
         }
 
-        MTLTextureType MetalTextureViewType(wgpu::TextureViewDimension dimension,
-                                            unsigned int sampleCount) {
-            switch (dimension) {
-                case wgpu::TextureViewDimension::e2D:
-                    return (sampleCount > 1) ? MTLTextureType2DMultisample : MTLTextureType2D;
-                case wgpu::TextureViewDimension::e2DArray:
-                    return MTLTextureType2DArray;
-                case wgpu::TextureViewDimension::Cube:
-                    return MTLTextureTypeCube;
-                case wgpu::TextureViewDimension::CubeArray:
-                    return MTLTextureTypeCubeArray;
-                default:
-                    UNREACHABLE();
-                    return MTLTextureType2D;
-            }
-        }
-
         bool RequiresCreatingNewTextureView(const TextureBase* texture,
                                             const TextureViewDescriptor* textureViewDescriptor) {
             if (texture->GetFormat().format != textureViewDescriptor->format) {
@@ -134,6 +117,23 @@ namespace dawn_native { namespace metal {
 #endif
     }
 
+    MTLTextureType MetalTextureViewType(wgpu::TextureViewDimension dimension,
+                                        unsigned int sampleCount) {
+        switch (dimension) {
+            case wgpu::TextureViewDimension::e2D:
+                return (sampleCount > 1) ? MTLTextureType2DMultisample : MTLTextureType2D;
+            case wgpu::TextureViewDimension::e2DArray:
+                return MTLTextureType2DArray;
+            case wgpu::TextureViewDimension::Cube:
+                return MTLTextureTypeCube;
+            case wgpu::TextureViewDimension::CubeArray:
+                return MTLTextureTypeCubeArray;
+            default:
+                UNREACHABLE();
+                return MTLTextureType2D;
+        }
+    }
+
     MTLPixelFormat MetalPixelFormat(wgpu::TextureFormat format) {
         switch (format) {
             case wgpu::TextureFormat::R8Unorm:
@@ -302,6 +302,10 @@ namespace dawn_native { namespace metal {
         mtlDesc.textureType = MetalTextureType(descriptor->dimension, descriptor->arrayLayerCount,
                                                descriptor->sampleCount);
         mtlDesc.usage = MetalTextureUsage(descriptor->usage);
+        // Generating mipmaps renders to the levels of the texture.
+        if (descriptor->mipLevelCount > 1 && (descriptor->usage & wgpu::TextureUsage::CopyDst)) {
+            mtlDesc.usage |= MTLTextureUsageRenderTarget;
+        }
         mtlDesc.pixelFormat = MetalPixelFormat(descriptor->format);
 
         mtlDesc.width = descriptor->size.width;
@@ -320,10 +324,20 @@ namespace dawn_native { namespace metal {
     Texture::Texture(Device* device, const TextureDescriptor* descriptor)
         : TextureBase(device, descriptor, TextureState::OwnedInternal) {
         MTLTextureDescriptor* mtlDesc = CreateMetalTextureDescriptor(descriptor);
+        // Transient attachments are only ever in the tile memory of the render passes on the GPUs
+        // that have some.
+        if (IsTransientAttachment()) {
+            if (@available(macOS 11.0, iOS 13.0, *)) {
+                if ([device->GetMTLDevice() supportsFamily:MTLGPUFamilyApple1]) {
+                    mtlDesc.storageMode = MTLStorageModeMemoryless;
+                }
+            }
+        }
         mMtlTexture = [device->GetMTLDevice() newTextureWithDescriptor:mtlDesc];
         [mtlDesc release];
 
-        if (device->IsToggleEnabled(Toggle::NonzeroClearResourcesOnCreationForTesting)) {
+        if (device->IsToggleEnabled(Toggle::NonzeroClearResourcesOnCreationForTesting) &&
+            !IsTransientAttachment()) {
             device->ConsumedError(ClearTexture(0, GetNumMipLevels(), 0, GetArrayLayers(),
                                                TextureBase::ClearValue::NonZero));
         }
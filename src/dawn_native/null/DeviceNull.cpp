@@ -117,13 +117,33 @@ namespace dawn_native { namespace null {
         const PipelineLayoutDescriptor* descriptor) {
         return new PipelineLayout(this, descriptor);
     }
-    ResultOrError<QueueBase*> Device::CreateQueueImpl() {
-        return new Queue(this);
+    ResultOrError<QuerySetBase*> Device::CreateQuerySetImpl(const QuerySetDescriptor* descriptor) {
+        return new QuerySet(this, descriptor);
+    }
+    ResultOrError<QueueBase*> Device::CreateQueueImpl(const QueueDescriptor* descriptor) {
+        return new Queue(this, descriptor);
+    }
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    Device::CreateRayTracingAccelerationContainerImpl(
+        const RayTracingAccelerationContainerDescriptor* descriptor) {
+        return new RayTracingAccelerationContainer(this, descriptor);
+    }
+    ResultOrError<RayTracingShaderBindingTableBase*> Device::CreateRayTracingShaderBindingTableImpl(
+        const RayTracingShaderBindingTableDescriptor* descriptor) {
+        return new RayTracingShaderBindingTable(this, descriptor);
+    }
+    ResultOrError<RayTracingPipelineBase*> Device::CreateRayTracingPipelineImpl(
+        const RayTracingPipelineDescriptor* descriptor) {
+        return new RayTracingPipeline(this, descriptor);
     }
     ResultOrError<RenderPipelineBase*> Device::CreateRenderPipelineImpl(
         const RenderPipelineDescriptor* descriptor) {
         return new RenderPipeline(this, descriptor);
     }
+    ResultOrError<ResourceTableBase*> Device::CreateResourceTableImpl(
+        const ResourceTableDescriptor* descriptor) {
+        return new ResourceTable(this, descriptor);
+    }
     ResultOrError<SamplerBase*> Device::CreateSamplerImpl(const SamplerDescriptor* descriptor) {
         return new Sampler(this, descriptor);
     }
@@ -141,13 +161,15 @@ namespace dawn_native { namespace null {
                 return DAWN_VALIDATION_ERROR("Unable to initialize instance of spvc");
             }
 
-            spirv_cross::Compiler* compiler;
-            status = context->GetCompiler(reinterpret_cast<void**>(&compiler));
-            if (status != shaderc_spvc_status_success) {
-                return DAWN_VALIDATION_ERROR("Unable to get cross compiler");
+            if (!module->LoadSpirvInfoFromCache()) {
+                spirv_cross::Compiler* compiler;
+                status = context->GetCompiler(reinterpret_cast<void**>(&compiler));
+                if (status != shaderc_spvc_status_success) {
+                    return DAWN_VALIDATION_ERROR("Unable to get cross compiler");
+                }
+                DAWN_TRY(module->ExtractSpirvInfo(*compiler));
             }
-            DAWN_TRY(module->ExtractSpirvInfo(*compiler));
-        } else {
+        } else if (!module->LoadSpirvInfoFromCache()) {
             spirv_cross::Compiler compiler(descriptor->code, descriptor->codeSize);
             DAWN_TRY(module->ExtractSpirvInfo(compiler));
         }
@@ -208,6 +230,16 @@ namespace dawn_native { namespace null {
         return {};
     }
 
+    MaybeError Device::CopyFromStagingToTexture(StagingBufferBase*,
+                                                uint64_t,
+                                                uint32_t,
+                                                uint32_t,
+                                                const TextureCopy&,
+                                                const Extent3D&) {
+        // Null textures don't have contents.
+        return {};
+    }
+
     MaybeError Device::IncrementMemoryUsage(size_t bytes) {
         static_assert(kMaxMemoryUsage <= std::numeric_limits<size_t>::max() / 2, "");
         if (bytes > kMaxMemoryUsage || mMemoryUsage + bytes > kMaxMemoryUsage) {
@@ -366,19 +398,162 @@ namespace dawn_native { namespace null {
         FreeCommands(&mCommands);
     }
 
+    MaybeError CommandBuffer::TrackAccelerationContainerCommands() {
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            switch (type) {
+                case Command::BuildRayTracingAccelerationContainer: {
+                    BuildRayTracingAccelerationContainerCmd* build =
+                        mCommands.NextCommand<BuildRayTracingAccelerationContainerCmd>();
+                    DAWN_TRY(build->container->MakeResident());
+                    build->container->SetBuildState(true);
+                    build->container->TrackBuild();
+                } break;
+
+                case Command::BuildRayTracingAccelerationContainers: {
+                    BuildRayTracingAccelerationContainersCmd* build =
+                        mCommands.NextCommand<BuildRayTracingAccelerationContainersCmd>();
+                    Ref<RayTracingAccelerationContainerBase>* containers =
+                        mCommands.NextData<Ref<RayTracingAccelerationContainerBase>>(build->count);
+                    for (uint32_t i = 0; i < build->count; ++i) {
+                        DAWN_TRY(containers[i]->MakeResident());
+                        containers[i]->SetBuildState(true);
+                        containers[i]->TrackBuild();
+                    }
+                } break;
+
+                case Command::CompactRayTracingAccelerationContainer: {
+                    CompactRayTracingAccelerationContainerCmd* compact =
+                        mCommands.NextCommand<CompactRayTracingAccelerationContainerCmd>();
+                    compact->dstContainer->SetBuildState(true);
+                } break;
+
+                case Command::UpdateRayTracingAccelerationContainer: {
+                    UpdateRayTracingAccelerationContainerCmd* update =
+                        mCommands.NextCommand<UpdateRayTracingAccelerationContainerCmd>();
+                    RayTracingAccelerationContainerBase* container = update->container.Get();
+                    bool rebuild = container->ShouldRebuildOnUpdate();
+                    if (container->IsBuilt() && !container->IsUpdated()) {
+                        container->SetUpdateState(true);
+                    }
+                    container->TrackUpdate(rebuild);
+                } break;
+
+                default:
+                    SkipCommand(&mCommands, type);
+                    break;
+            }
+        }
+        return {};
+    }
+
     // Queue
 
-    Queue::Queue(Device* device) : QueueBase(device) {
+    Queue::Queue(Device* device, const QueueDescriptor* descriptor)
+        : QueueBase(device, descriptor) {
     }
 
     Queue::~Queue() {
     }
 
-    MaybeError Queue::SubmitImpl(uint32_t, CommandBufferBase* const*) {
+    MaybeError Queue::SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) {
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            DAWN_TRY(ToBackend(commands[i])->TrackAccelerationContainerCommands());
+        }
         ToBackend(GetDevice())->SubmitPendingOperations();
         return {};
     }
 
+    MaybeError Queue::UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                   uint64_t firstTile,
+                                                   uint64_t tileCount,
+                                                   bool resident) {
+        return {};
+    }
+
+    MaybeError Queue::UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                    uint32_t mipLevel,
+                                                    uint32_t arrayLayer,
+                                                    const Origin3D& firstTile,
+                                                    const Extent3D& tileCount,
+                                                    bool resident) {
+        return {};
+    }
+
+    // RayTracingAccelerationContainer
+
+    RayTracingAccelerationContainer::RayTracingAccelerationContainer(
+        Device* device,
+        const RayTracingAccelerationContainerDescriptor* descriptor)
+        : RayTracingAccelerationContainerBase(device, descriptor) {
+    }
+
+    RayTracingAccelerationContainer::~RayTracingAccelerationContainer() {
+        DestroyInternal();
+    }
+
+    void RayTracingAccelerationContainer::DestroyImpl() {
+    }
+
+    uint64_t RayTracingAccelerationContainer::GetHandleImpl() {
+        return reinterpret_cast<uint64_t>(this);
+    }
+
+    MaybeError RayTracingAccelerationContainer::UpdateInstancesImpl(
+        uint32_t,
+        uint32_t,
+        const RayTracingAccelerationInstanceDescriptor*) {
+        return {};
+    }
+
+    MaybeError RayTracingAccelerationContainer::UpdateInstancePropertiesImpl(
+        uint32_t,
+        uint32_t,
+        const RayTracingAccelerationInstanceProperties*) {
+        return {};
+    }
+
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    RayTracingAccelerationContainer::CreateSubsetImpl(
+        const RayTracingAccelerationContainerSubsetDescriptor* subsetDescriptor,
+        const std::vector<uint32_t>& instanceIndices) {
+        RayTracingAccelerationContainerDescriptor descriptor;
+        descriptor.flags = subsetDescriptor->flags;
+        descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+        descriptor.instanceCount = static_cast<uint32_t>(instanceIndices.size());
+        descriptor.instances = nullptr;
+        descriptor.updateRebuildThreshold = subsetDescriptor->updateRebuildThreshold;
+        return new RayTracingAccelerationContainer(ToBackend(GetDevice()), &descriptor);
+    }
+
+    void RayTracingAccelerationContainer::EvictImpl() {
+    }
+
+    MaybeError RayTracingAccelerationContainer::MakeResidentImpl() {
+        return {};
+    }
+
+    // RayTracingShaderBindingTable
+
+    RayTracingShaderBindingTable::RayTracingShaderBindingTable(
+        Device* device,
+        const RayTracingShaderBindingTableDescriptor* descriptor)
+        : RayTracingShaderBindingTableBase(device, descriptor) {
+    }
+
+    RayTracingShaderBindingTable::~RayTracingShaderBindingTable() {
+        DestroyInternal();
+    }
+
+    void RayTracingShaderBindingTable::DestroyImpl() {
+    }
+
+    MaybeError RayTracingShaderBindingTable::WriteRecordDataImpl(uint32_t,
+                                                                 uint32_t,
+                                                                 const void*) {
+        return {};
+    }
+
     // SwapChain
 
     SwapChain::SwapChain(Device* device,
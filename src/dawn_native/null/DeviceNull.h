@@ -24,11 +24,13 @@
 #include "dawn_native/ComputePipeline.h"
 #include "dawn_native/Device.h"
 #include "dawn_native/PipelineLayout.h"
+#include "dawn_native/QuerySet.h"
 #include "dawn_native/Queue.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
 #include "dawn_native/RayTracingPipeline.h"
 #include "dawn_native/RayTracingShaderBindingTable.h"
 #include "dawn_native/RenderPipeline.h"
+#include "dawn_native/ResourceTable.h"
 #include "dawn_native/RingBufferAllocator.h"
 #include "dawn_native/Sampler.h"
 #include "dawn_native/ShaderModule.h"
@@ -49,11 +51,13 @@ namespace dawn_native { namespace null {
     using ComputePipeline = ComputePipelineBase;
     class Device;
     using PipelineLayout = PipelineLayoutBase;
+    using QuerySet = QuerySetBase;
     class Queue;
-    using RayTracingAccelerationContainer = RayTracingAccelerationContainerBase;
+    class RayTracingAccelerationContainer;
     using RayTracingPipeline = RayTracingPipelineBase;
-    using RayTracingShaderBindingTable = RayTracingShaderBindingTableBase;
+    class RayTracingShaderBindingTable;
     using RenderPipeline = RenderPipelineBase;
+    using ResourceTable = ResourceTableBase;
     using Sampler = SamplerBase;
     using ShaderModule = ShaderModuleBase;
     class SwapChain;
@@ -69,9 +73,13 @@ namespace dawn_native { namespace null {
         using ComputePipelineType = ComputePipeline;
         using DeviceType = Device;
         using PipelineLayoutType = PipelineLayout;
+        using QuerySetType = QuerySet;
         using QueueType = Queue;
+        using RayTracingAccelerationContainerType = RayTracingAccelerationContainer;
         using RayTracingPipelineType = RayTracingPipeline;
+        using RayTracingShaderBindingTableType = RayTracingShaderBindingTable;
         using RenderPipelineType = RenderPipeline;
+        using ResourceTableType = ResourceTable;
         using SamplerType = Sampler;
         using ShaderModuleType = ShaderModule;
         using SwapChainType = SwapChain;
@@ -111,6 +119,12 @@ namespace dawn_native { namespace null {
                                            BufferBase* destination,
                                            uint64_t destinationOffset,
                                            uint64_t size) override;
+        MaybeError CopyFromStagingToTexture(StagingBufferBase* source,
+                                            uint64_t sourceOffset,
+                                            uint32_t rowPitch,
+                                            uint32_t imageHeight,
+                                            const TextureCopy& destination,
+                                            const Extent3D& copySize) override;
 
         MaybeError IncrementMemoryUsage(size_t bytes);
         void DecrementMemoryUsage(size_t bytes);
@@ -118,17 +132,11 @@ namespace dawn_native { namespace null {
       private:
         ResultOrError<RayTracingAccelerationContainerBase*>
         CreateRayTracingAccelerationContainerImpl(
-            const RayTracingAccelerationContainerDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingAccelerationContainerDescriptor* descriptor) override;
         ResultOrError<RayTracingShaderBindingTableBase*> CreateRayTracingShaderBindingTableImpl(
-            const RayTracingShaderBindingTableDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingShaderBindingTableDescriptor* descriptor) override;
         ResultOrError<RayTracingPipelineBase*> CreateRayTracingPipelineImpl(
-            const RayTracingPipelineDescriptor* descriptor) override {
-            UNREACHABLE();
-        }
+            const RayTracingPipelineDescriptor* descriptor) override;
         ResultOrError<BindGroupBase*> CreateBindGroupImpl(
             const BindGroupDescriptor* descriptor) override;
         ResultOrError<BindGroupLayoutBase*> CreateBindGroupLayoutImpl(
@@ -138,9 +146,13 @@ namespace dawn_native { namespace null {
             const ComputePipelineDescriptor* descriptor) override;
         ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) override;
-        ResultOrError<QueueBase*> CreateQueueImpl() override;
+        ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) override;
         ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) override;
+        ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) override;
         ResultOrError<SamplerBase*> CreateSamplerImpl(const SamplerDescriptor* descriptor) override;
         ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
             const ShaderModuleDescriptor* descriptor) override;
@@ -227,17 +239,72 @@ namespace dawn_native { namespace null {
         CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor);
         ~CommandBuffer();
 
+        // Nothing is executed, but the acceleration containers are marked as built and updated
+        // like the other backends do when they record the commands, so that workloads using ray
+        // tracing run the same frontend code as on hardware.
+        MaybeError TrackAccelerationContainerCommands();
+
       private:
         CommandIterator mCommands;
     };
 
     class Queue : public QueueBase {
       public:
-        Queue(Device* device);
+        Queue(Device* device, const QueueDescriptor* descriptor);
         ~Queue();
 
       private:
         MaybeError SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) override;
+        MaybeError UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                uint64_t firstTile,
+                                                uint64_t tileCount,
+                                                bool resident) override;
+        MaybeError UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                 uint32_t mipLevel,
+                                                 uint32_t arrayLayer,
+                                                 const Origin3D& firstTile,
+                                                 const Extent3D& tileCount,
+                                                 bool resident) override;
+    };
+
+    // Acceleration containers without any acceleration structure. Their handles are unique but
+    // meaningless, and their compacted size is never known, so they can't be compacted.
+    class RayTracingAccelerationContainer : public RayTracingAccelerationContainerBase {
+      public:
+        RayTracingAccelerationContainer(
+            Device* device,
+            const RayTracingAccelerationContainerDescriptor* descriptor);
+        ~RayTracingAccelerationContainer() override;
+
+      private:
+        void DestroyImpl() override;
+        uint64_t GetHandleImpl() override;
+        MaybeError UpdateInstancesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceDescriptor* instances) override;
+        MaybeError UpdateInstancePropertiesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceProperties* properties) override;
+        ResultOrError<RayTracingAccelerationContainerBase*> CreateSubsetImpl(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor,
+            const std::vector<uint32_t>& instanceIndices) override;
+        void EvictImpl() override;
+        MaybeError MakeResidentImpl() override;
+    };
+
+    class RayTracingShaderBindingTable : public RayTracingShaderBindingTableBase {
+      public:
+        RayTracingShaderBindingTable(Device* device,
+                                     const RayTracingShaderBindingTableDescriptor* descriptor);
+        ~RayTracingShaderBindingTable() override;
+
+      private:
+        void DestroyImpl() override;
+        MaybeError WriteRecordDataImpl(uint32_t groupIndex,
+                                       uint32_t count,
+                                       const void* data) override;
     };
 
     class SwapChain : public NewSwapChainBase {
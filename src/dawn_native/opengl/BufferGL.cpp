@@ -21,7 +21,7 @@ namespace dawn_native { namespace opengl {
     // Buffer
 
     Buffer::Buffer(Device* device, const BufferDescriptor* descriptor)
-        : BufferBase(device, descriptor) {
+        : BufferBase(device, descriptor), mId(device->AllocateBufferId()) {
         device->gl.GenBuffers(1, &mBuffer);
         device->gl.BindBuffer(GL_ARRAY_BUFFER, mBuffer);
         device->gl.BufferData(GL_ARRAY_BUFFER, GetSize(), nullptr, GL_STATIC_DRAW);
@@ -35,6 +35,10 @@ namespace dawn_native { namespace opengl {
         return mBuffer;
     }
 
+    uint64_t Buffer::GetId() const {
+        return mId;
+    }
+
     bool Buffer::IsMapWritable() const {
         // TODO(enga): All buffers in GL can be mapped. Investigate if mapping them will cause the
         // driver to migrate it to shared memory.
@@ -51,6 +55,12 @@ namespace dawn_native { namespace opengl {
     }
 
     MaybeError Buffer::SetSubDataImpl(uint32_t start, uint32_t count, const void* data) {
+        // With persistently mapped staging buffers, the data is written straight into the upload
+        // ring and copied on the GPU timeline instead of being copied by the driver.
+        if (ToBackend(GetDevice())->SupportsPersistentMapping()) {
+            return BufferBase::SetSubDataImpl(start, count, data);
+        }
+
         const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
 
         gl.BindBuffer(GL_ARRAY_BUFFER, mBuffer);
@@ -29,6 +29,7 @@ namespace dawn_native { namespace opengl {
         ~Buffer();
 
         GLuint GetHandle() const;
+        uint64_t GetId() const;
 
       private:
         // Dawn API
@@ -42,6 +43,7 @@ namespace dawn_native { namespace opengl {
         MaybeError MapAtCreationImpl(uint8_t** mappedPointer) override;
 
         GLuint mBuffer = 0;
+        uint64_t mId;
     };
 
 }}  // namespace dawn_native::opengl
@@ -14,6 +14,7 @@
 
 #include "dawn_native/opengl/CommandBufferGL.h"
 
+#include "common/Constants.h"
 #include "dawn_native/BindGroup.h"
 #include "dawn_native/BindGroupTracker.h"
 #include "dawn_native/CommandEncoder.h"
@@ -49,169 +50,50 @@ namespace dawn_native { namespace opengl {
             }
         }
 
-        GLenum VertexFormatType(wgpu::VertexFormat format) {
-            switch (format) {
-                case wgpu::VertexFormat::UChar2:
-                case wgpu::VertexFormat::UChar4:
-                case wgpu::VertexFormat::UChar2Norm:
-                case wgpu::VertexFormat::UChar4Norm:
-                    return GL_UNSIGNED_BYTE;
-                case wgpu::VertexFormat::Char2:
-                case wgpu::VertexFormat::Char4:
-                case wgpu::VertexFormat::Char2Norm:
-                case wgpu::VertexFormat::Char4Norm:
-                    return GL_BYTE;
-                case wgpu::VertexFormat::UShort2:
-                case wgpu::VertexFormat::UShort4:
-                case wgpu::VertexFormat::UShort2Norm:
-                case wgpu::VertexFormat::UShort4Norm:
-                    return GL_UNSIGNED_SHORT;
-                case wgpu::VertexFormat::Short2:
-                case wgpu::VertexFormat::Short4:
-                case wgpu::VertexFormat::Short2Norm:
-                case wgpu::VertexFormat::Short4Norm:
-                    return GL_SHORT;
-                case wgpu::VertexFormat::Half2:
-                case wgpu::VertexFormat::Half4:
-                    return GL_HALF_FLOAT;
-                case wgpu::VertexFormat::Float:
-                case wgpu::VertexFormat::Float2:
-                case wgpu::VertexFormat::Float3:
-                case wgpu::VertexFormat::Float4:
-                    return GL_FLOAT;
-                case wgpu::VertexFormat::UInt:
-                case wgpu::VertexFormat::UInt2:
-                case wgpu::VertexFormat::UInt3:
-                case wgpu::VertexFormat::UInt4:
-                    return GL_UNSIGNED_INT;
-                case wgpu::VertexFormat::Int:
-                case wgpu::VertexFormat::Int2:
-                case wgpu::VertexFormat::Int3:
-                case wgpu::VertexFormat::Int4:
-                    return GL_INT;
-                default:
-                    UNREACHABLE();
-            }
-        }
-
-        GLboolean VertexFormatIsNormalized(wgpu::VertexFormat format) {
-            switch (format) {
-                case wgpu::VertexFormat::UChar2Norm:
-                case wgpu::VertexFormat::UChar4Norm:
-                case wgpu::VertexFormat::Char2Norm:
-                case wgpu::VertexFormat::Char4Norm:
-                case wgpu::VertexFormat::UShort2Norm:
-                case wgpu::VertexFormat::UShort4Norm:
-                case wgpu::VertexFormat::Short2Norm:
-                case wgpu::VertexFormat::Short4Norm:
-                    return GL_TRUE;
-                default:
-                    return GL_FALSE;
-            }
-        }
-
-        bool VertexFormatIsInt(wgpu::VertexFormat format) {
-            switch (format) {
-                case wgpu::VertexFormat::UChar2:
-                case wgpu::VertexFormat::UChar4:
-                case wgpu::VertexFormat::Char2:
-                case wgpu::VertexFormat::Char4:
-                case wgpu::VertexFormat::UShort2:
-                case wgpu::VertexFormat::UShort4:
-                case wgpu::VertexFormat::Short2:
-                case wgpu::VertexFormat::Short4:
-                case wgpu::VertexFormat::UInt:
-                case wgpu::VertexFormat::UInt2:
-                case wgpu::VertexFormat::UInt3:
-                case wgpu::VertexFormat::UInt4:
-                case wgpu::VertexFormat::Int:
-                case wgpu::VertexFormat::Int2:
-                case wgpu::VertexFormat::Int3:
-                case wgpu::VertexFormat::Int4:
-                    return true;
-                default:
-                    return false;
-            }
-        }
-
         // Vertex buffers and index buffers are implemented as part of an OpenGL VAO that
         // corresponds to a VertexState. On the contrary in Dawn they are part of the global state.
-        // This means that we have to re-apply these buffers on a VertexState change.
+        // This means that we have to bind a VAO of the pipeline with the current buffers on a
+        // VertexState or buffer change.
         class VertexStateBufferBindingTracker {
           public:
             void OnSetIndexBuffer(BufferBase* buffer) {
-                mIndexBufferDirty = true;
+                mDirty = true;
                 mIndexBuffer = ToBackend(buffer);
             }
 
             void OnSetVertexBuffer(uint32_t slot, BufferBase* buffer, uint64_t offset) {
+                mDirty = true;
                 mVertexBuffers[slot] = ToBackend(buffer);
                 mVertexBufferOffsets[slot] = offset;
-
-                // Use 64 bit masks and make sure there are no shift UB
-                static_assert(kMaxVertexBuffers <= 8 * sizeof(unsigned long long) - 1, "");
-                mDirtyVertexBuffers |= 1ull << slot;
             }
 
-            void OnSetPipeline(RenderPipelineBase* pipeline) {
+            void OnSetPipeline(RenderPipeline* pipeline) {
                 if (mLastPipeline == pipeline) {
                     return;
                 }
 
-                mIndexBufferDirty = true;
-                mDirtyVertexBuffers |= pipeline->GetVertexBufferSlotsUsed();
-
+                mDirty = true;
                 mLastPipeline = pipeline;
             }
 
-            void Apply(const OpenGLFunctions& gl) {
-                if (mIndexBufferDirty && mIndexBuffer != nullptr) {
-                    gl.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer->GetHandle());
-                    mIndexBufferDirty = false;
-                }
-
-                for (uint32_t slot : IterateBitSet(mDirtyVertexBuffers &
-                                                   mLastPipeline->GetVertexBufferSlotsUsed())) {
-                    for (uint32_t location :
-                         IterateBitSet(mLastPipeline->GetAttributesUsingVertexBuffer(slot))) {
-                        const VertexAttributeInfo& attribute =
-                            mLastPipeline->GetAttribute(location);
-
-                        GLuint buffer = mVertexBuffers[slot]->GetHandle();
-                        uint64_t offset = mVertexBufferOffsets[slot];
-
-                        const VertexBufferInfo& vertexBuffer = mLastPipeline->GetVertexBuffer(slot);
-                        uint32_t components = VertexFormatNumComponents(attribute.format);
-                        GLenum formatType = VertexFormatType(attribute.format);
-
-                        GLboolean normalized = VertexFormatIsNormalized(attribute.format);
-                        gl.BindBuffer(GL_ARRAY_BUFFER, buffer);
-                        if (VertexFormatIsInt(attribute.format)) {
-                            gl.VertexAttribIPointer(
-                                location, components, formatType, vertexBuffer.arrayStride,
-                                reinterpret_cast<void*>(
-                                    static_cast<intptr_t>(offset + attribute.offset)));
-                        } else {
-                            gl.VertexAttribPointer(location, components, formatType, normalized,
-                                                   vertexBuffer.arrayStride,
-                                                   reinterpret_cast<void*>(static_cast<intptr_t>(
-                                                       offset + attribute.offset)));
-                        }
-                    }
+            void Apply(PersistentPipelineState* persistentPipelineState) {
+                if (!mDirty) {
+                    return;
                 }
 
-                mDirtyVertexBuffers.reset();
+                mLastPipeline->ApplyVertexBuffers(*persistentPipelineState, mIndexBuffer,
+                                                  mVertexBuffers, mVertexBufferOffsets);
+                mDirty = false;
             }
 
           private:
-            bool mIndexBufferDirty = false;
+            bool mDirty = false;
             Buffer* mIndexBuffer = nullptr;
 
-            std::bitset<kMaxVertexBuffers> mDirtyVertexBuffers;
-            std::array<Buffer*, kMaxVertexBuffers> mVertexBuffers;
-            std::array<uint64_t, kMaxVertexBuffers> mVertexBufferOffsets;
+            std::array<Buffer*, kMaxVertexBuffers> mVertexBuffers = {};
+            std::array<uint64_t, kMaxVertexBuffers> mVertexBufferOffsets = {};
 
-            RenderPipelineBase* mLastPipeline = nullptr;
+            RenderPipeline* mLastPipeline = nullptr;
         };
 
         class BindGroupTracker : public BindGroupTrackerBase<false, uint64_t> {
@@ -226,16 +108,19 @@ namespace dawn_native { namespace opengl {
                 mPipeline = pipeline;
             }
 
-            void Apply(const OpenGLFunctions& gl) {
-                for (uint32_t index : IterateBitSet(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
-                    ApplyBindGroup(gl, index, mBindGroups[index], mDynamicOffsetCounts[index],
-                                   mDynamicOffsets[index].data());
+            void Apply(const OpenGLFunctions& gl,
+                       PersistentPipelineState* persistentPipelineState) {
+                for (uint32_t index :
+                     IterateBitSetWords(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
+                    ApplyBindGroup(gl, persistentPipelineState, index, mBindGroups[index],
+                                   mDynamicOffsetCounts[index], mDynamicOffsets[index].data());
                 }
                 DidApply();
             }
 
           private:
             void ApplyBindGroup(const OpenGLFunctions& gl,
+                                PersistentPipelineState* persistentPipelineState,
                                 uint32_t index,
                                 BindGroupBase* group,
                                 uint32_t dynamicOffsetCount,
@@ -244,7 +129,7 @@ namespace dawn_native { namespace opengl {
                 const auto& layout = group->GetLayout()->GetBindingInfo();
                 uint32_t currentDynamicIndex = 0;
 
-                for (uint32_t bindingIndex : IterateBitSet(layout.mask)) {
+                for (uint32_t bindingIndex : IterateBitSetWords(layout.mask)) {
                     switch (layout.types[bindingIndex]) {
                         case wgpu::BindingType::UniformBuffer: {
                             BufferBinding binding = group->GetBindingAsBufferBinding(bindingIndex);
@@ -270,9 +155,11 @@ namespace dawn_native { namespace opengl {
                                 // Only use filtering for certain texture units, because int and
                                 // uint texture are only complete without filtering
                                 if (unit.shouldUseFiltering) {
-                                    gl.BindSampler(unit.unit, sampler->GetFilteringHandle());
+                                    persistentPipelineState->BindSampler(
+                                        gl, unit.unit, sampler->GetFilteringHandle());
                                 } else {
-                                    gl.BindSampler(unit.unit, sampler->GetNonFilteringHandle());
+                                    persistentPipelineState->BindSampler(
+                                        gl, unit.unit, sampler->GetNonFilteringHandle());
                                 }
                             }
                         } break;
@@ -285,8 +172,7 @@ namespace dawn_native { namespace opengl {
                             GLuint viewIndex = indices[bindingIndex];
 
                             for (auto unit : mPipeline->GetTextureUnitsForTextureView(viewIndex)) {
-                                gl.ActiveTexture(GL_TEXTURE0 + unit);
-                                gl.BindTexture(target, handle);
+                                persistentPipelineState->BindTexture(gl, unit, target, handle);
                             }
                         } break;
 
@@ -417,8 +303,11 @@ namespace dawn_native { namespace opengl {
                 // cleared in BeginRenderPass by setting the loadop to clear when the
                 // texture subresource has not been initialized before the render pass.
                 if (!(usages.textureUsages[i] & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(0, texture->GetNumMipLevels(), 0,
-                                                                 texture->GetArrayLayers());
+                    const SubresourceRange& range = usages.textureRanges[i];
+                    texture->EnsureSubresourceContentInitialized(range.baseMipLevel,
+                                                                 range.levelCount,
+                                                                 range.baseArrayLayer,
+                                                                 range.layerCount);
                 }
             }
         };
@@ -625,6 +514,30 @@ namespace dawn_native { namespace opengl {
                                         copySize.width, copySize.height, 1);
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    uint32_t layerCount = texture->GetArrayLayers();
+
+                    // The generated levels are overwritten entirely.
+                    texture->EnsureSubresourceContentInitialized(cmd->baseMipLevel, 1, 0,
+                                                                 layerCount);
+                    texture->SetIsSubresourceContentInitialized(true, cmd->baseMipLevel + 1,
+                                                                cmd->mipLevelCount - 1, 0,
+                                                                layerCount);
+
+                    // glGenerateMipmap works on the range of levels of the texture, which is
+                    // restored to all the levels afterwards.
+                    GLenum target = texture->GetGLTarget();
+                    gl.BindTexture(target, texture->GetHandle());
+                    gl.TexParameteri(target, GL_TEXTURE_BASE_LEVEL, cmd->baseMipLevel);
+                    gl.TexParameteri(target, GL_TEXTURE_MAX_LEVEL,
+                                     cmd->baseMipLevel + cmd->mipLevelCount - 1);
+                    gl.GenerateMipmap(target);
+                    gl.TexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+                    gl.TexParameteri(target, GL_TEXTURE_MAX_LEVEL, texture->GetNumMipLevels() - 1);
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
@@ -634,6 +547,7 @@ namespace dawn_native { namespace opengl {
         const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
         ComputePipeline* lastPipeline = nullptr;
         BindGroupTracker bindGroupTracker = {};
+        PersistentPipelineState persistentPipelineState;
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
@@ -645,7 +559,7 @@ namespace dawn_native { namespace opengl {
 
                 case Command::Dispatch: {
                     DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
-                    bindGroupTracker.Apply(gl);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
                     gl.DispatchCompute(dispatch->x, dispatch->y, dispatch->z);
                     // TODO(cwallez@chromium.org): add barriers to the API
@@ -654,10 +568,10 @@ namespace dawn_native { namespace opengl {
 
                 case Command::DispatchIndirect: {
                     DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
-                    bindGroupTracker.Apply(gl);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
                     uint64_t indirectBufferOffset = dispatch->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(dispatch->indirectBuffer.Get());
+                    Buffer* indirectBuffer = ToBackend(dispatch->indirectBuffer);
 
                     gl.BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBuffer->GetHandle());
                     gl.DispatchComputeIndirect(static_cast<GLintptr>(indirectBufferOffset));
@@ -667,19 +581,16 @@ namespace dawn_native { namespace opengl {
 
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
-                    lastPipeline->ApplyNow();
+                    lastPipeline = ToBackend(cmd->pipeline);
+                    lastPipeline->ApplyNow(persistentPipelineState);
 
                     bindGroupTracker.OnSetPipeline(lastPipeline);
                 } break;
 
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group.Get(),
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(&mCommands, cmd);
+                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group,
                                                     cmd->dynamicOffsetCount, dynamicOffsets);
                 } break;
 
@@ -794,7 +705,7 @@ namespace dawn_native { namespace opengl {
                 // when that's fixed will lose precision on integer formats when converting to
                 // float.
                 if (attachmentInfo->loadOp == wgpu::LoadOp::Clear) {
-                    gl.ColorMaski(i, true, true, true, true);
+                    persistentPipelineState.SetColorMask(gl, i, true, true, true, true);
                     gl.ClearBufferfv(GL_COLOR, i, &attachmentInfo->clearColor.r);
                 }
 
@@ -814,10 +725,11 @@ namespace dawn_native { namespace opengl {
                                       (attachmentInfo->stencilLoadOp == wgpu::LoadOp::Clear);
 
                 if (doDepthClear) {
-                    gl.DepthMask(GL_TRUE);
+                    persistentPipelineState.SetDepthWriteEnabled(gl, true);
                 }
                 if (doStencilClear) {
-                    gl.StencilMask(GetStencilMaskFromStencilFormat(attachmentFormat.format));
+                    persistentPipelineState.SetStencilWriteMask(
+                        gl, GetStencilMaskFromStencilFormat(attachmentFormat.format));
                 }
 
                 if (doDepthClear && doStencilClear) {
@@ -842,8 +754,8 @@ namespace dawn_native { namespace opengl {
             switch (type) {
                 case Command::Draw: {
                     DrawCmd* draw = iter->NextCommand<DrawCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
+                    vertexStateBufferBindingTracker.Apply(&persistentPipelineState);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
                     if (draw->firstInstance > 0) {
                         gl.DrawArraysInstancedBaseInstance(
@@ -859,8 +771,8 @@ namespace dawn_native { namespace opengl {
 
                 case Command::DrawIndexed: {
                     DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
+                    vertexStateBufferBindingTracker.Apply(&persistentPipelineState);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
                     wgpu::IndexFormat indexFormat =
                         lastPipeline->GetVertexStateDescriptor()->indexFormat;
@@ -896,34 +808,43 @@ namespace dawn_native { namespace opengl {
 
                 case Command::DrawIndirect: {
                     DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
+                    vertexStateBufferBindingTracker.Apply(&persistentPipelineState);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
-                    uint64_t indirectBufferOffset = draw->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
+                    // Multi draw indirect isn't in OpenGL ES 3.1, the draws are made one by one.
+                    ASSERT(draw->countBuffer == nullptr);
+                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer);
 
                     gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
-                    gl.DrawArraysIndirect(
-                        lastPipeline->GetGLPrimitiveTopology(),
-                        reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        uint64_t indirectBufferOffset =
+                            draw->indirectOffset + i * kDrawIndirectSize;
+                        gl.DrawArraysIndirect(
+                            lastPipeline->GetGLPrimitiveTopology(),
+                            reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                    }
                 } break;
 
                 case Command::DrawIndexedIndirect: {
                     DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
+                    vertexStateBufferBindingTracker.Apply(&persistentPipelineState);
+                    bindGroupTracker.Apply(gl, &persistentPipelineState);
 
                     wgpu::IndexFormat indexFormat =
                         lastPipeline->GetVertexStateDescriptor()->indexFormat;
                     GLenum formatType = IndexFormatType(indexFormat);
 
-                    uint64_t indirectBufferOffset = draw->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
+                    ASSERT(draw->countBuffer == nullptr);
+                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer);
 
                     gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
-                    gl.DrawElementsIndirect(
-                        lastPipeline->GetGLPrimitiveTopology(), formatType,
-                        reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        uint64_t indirectBufferOffset =
+                            draw->indirectOffset + i * kDrawIndexedIndirectSize;
+                        gl.DrawElementsIndirect(
+                            lastPipeline->GetGLPrimitiveTopology(), formatType,
+                            reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                    }
                 } break;
 
                 case Command::InsertDebugMarker:
@@ -936,7 +857,7 @@ namespace dawn_native { namespace opengl {
 
                 case Command::SetRenderPipeline: {
                     SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
+                    lastPipeline = ToBackend(cmd->pipeline);
                     lastPipeline->ApplyNow(persistentPipelineState);
 
                     vertexStateBufferBindingTracker.OnSetPipeline(lastPipeline);
@@ -945,23 +866,20 @@ namespace dawn_native { namespace opengl {
 
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group.Get(),
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(iter, cmd);
+                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group,
                                                     cmd->dynamicOffsetCount, dynamicOffsets);
                 } break;
 
                 case Command::SetIndexBuffer: {
                     SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
                     indexBufferBaseOffset = cmd->offset;
-                    vertexStateBufferBindingTracker.OnSetIndexBuffer(cmd->buffer.Get());
+                    vertexStateBufferBindingTracker.OnSetIndexBuffer(cmd->buffer);
                 } break;
 
                 case Command::SetVertexBuffer: {
                     SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-                    vertexStateBufferBindingTracker.OnSetVertexBuffer(cmd->slot, cmd->buffer.Get(),
+                    vertexStateBufferBindingTracker.OnSetVertexBuffer(cmd->slot, cmd->buffer,
                                                                       cmd->offset);
                 } break;
 
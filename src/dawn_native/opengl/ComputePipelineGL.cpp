@@ -26,8 +26,8 @@ namespace dawn_native { namespace opengl {
         PipelineGL::Initialize(device->gl, ToBackend(descriptor->layout), modules);
     }
 
-    void ComputePipeline::ApplyNow() {
-        PipelineGL::ApplyNow(ToBackend(GetDevice())->gl);
+    void ComputePipeline::ApplyNow(PersistentPipelineState& persistentPipelineState) {
+        PipelineGL::ApplyNow(ToBackend(GetDevice())->gl, persistentPipelineState);
     }
 
 }}  // namespace dawn_native::opengl
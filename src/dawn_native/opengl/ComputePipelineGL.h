@@ -29,7 +29,7 @@ namespace dawn_native { namespace opengl {
       public:
         ComputePipeline(Device* device, const ComputePipelineDescriptor* descriptor);
 
-        void ApplyNow();
+        void ApplyNow(PersistentPipelineState& persistentPipelineState);
     };
 
 }}  // namespace dawn_native::opengl
@@ -28,6 +28,7 @@
 #include "dawn_native/opengl/RenderPipelineGL.h"
 #include "dawn_native/opengl/SamplerGL.h"
 #include "dawn_native/opengl/ShaderModuleGL.h"
+#include "dawn_native/opengl/StagingBufferGL.h"
 #include "dawn_native/opengl/SwapChainGL.h"
 #include "dawn_native/opengl/TextureGL.h"
 
@@ -73,7 +74,7 @@ namespace dawn_native { namespace opengl {
     }
 
     const GLFormat& Device::GetGLFormat(const Format& format) {
-        ASSERT(format.isSupported);
+        ASSERT(&GetValidInternalFormat(format.format) == &format);
         ASSERT(format.GetIndex() < mFormatTable.size());
 
         const GLFormat& result = mFormatTable[format.GetIndex()];
@@ -90,6 +91,10 @@ namespace dawn_native { namespace opengl {
         return new BindGroupLayout(this, descriptor);
     }
     ResultOrError<BufferBase*> Device::CreateBufferImpl(const BufferDescriptor* descriptor) {
+        // Buffers are mapped with glMapBuffer, the GL can't use them while they are mapped.
+        if (descriptor->usage & wgpu::BufferUsage::PersistentMap) {
+            return DAWN_VALIDATION_ERROR("PersistentMap isn't supported on OpenGL");
+        }
         return new Buffer(this, descriptor);
     }
     CommandBufferBase* Device::CreateCommandBuffer(CommandEncoder* encoder,
@@ -104,13 +109,21 @@ namespace dawn_native { namespace opengl {
         const PipelineLayoutDescriptor* descriptor) {
         return new PipelineLayout(this, descriptor);
     }
-    ResultOrError<QueueBase*> Device::CreateQueueImpl() {
-        return new Queue(this);
+    ResultOrError<QuerySetBase*> Device::CreateQuerySetImpl(const QuerySetDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR("Query sets aren't implemented on the OpenGL backend yet");
+    }
+    ResultOrError<QueueBase*> Device::CreateQueueImpl(const QueueDescriptor* descriptor) {
+        return new Queue(this, descriptor);
     }
     ResultOrError<RenderPipelineBase*> Device::CreateRenderPipelineImpl(
         const RenderPipelineDescriptor* descriptor) {
         return new RenderPipeline(this, descriptor);
     }
+    ResultOrError<ResourceTableBase*> Device::CreateResourceTableImpl(
+        const ResourceTableDescriptor* descriptor) {
+        return DAWN_VALIDATION_ERROR(
+            "Resource tables aren't implemented on the OpenGL backend yet");
+    }
     ResultOrError<SamplerBase*> Device::CreateSamplerImpl(const SamplerDescriptor* descriptor) {
         return new Sampler(this, descriptor);
     }
@@ -181,8 +194,23 @@ namespace dawn_native { namespace opengl {
         }
     }
 
+    bool Device::SupportsPersistentMapping() const {
+        return gl.IsAtLeastGL(4, 4);
+    }
+
+    uint64_t Device::AllocateBufferId() {
+        return mNextBufferId++;
+    }
+
     ResultOrError<std::unique_ptr<StagingBufferBase>> Device::CreateStagingBuffer(size_t size) {
-        return DAWN_UNIMPLEMENTED_ERROR("Device unable to create staging buffer.");
+        if (!SupportsPersistentMapping()) {
+            return DAWN_UNIMPLEMENTED_ERROR("Device unable to create staging buffer.");
+        }
+
+        std::unique_ptr<StagingBufferBase> stagingBuffer =
+            std::make_unique<StagingBuffer>(size, this);
+        DAWN_TRY(stagingBuffer->Initialize());
+        return std::move(stagingBuffer);
     }
 
     MaybeError Device::CopyFromStagingToBuffer(StagingBufferBase* source,
@@ -190,7 +218,11 @@ namespace dawn_native { namespace opengl {
                                                BufferBase* destination,
                                                uint64_t destinationOffset,
                                                uint64_t size) {
-        return DAWN_UNIMPLEMENTED_ERROR("Device unable to copy from staging buffer.");
+        gl.BindBuffer(GL_COPY_READ_BUFFER, ToBackend(source)->GetHandle());
+        gl.BindBuffer(GL_COPY_WRITE_BUFFER, ToBackend(destination)->GetHandle());
+        gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset,
+                             destinationOffset, size);
+        return {};
     }
 
     void Device::Destroy() {
@@ -46,6 +46,14 @@ namespace dawn_native { namespace opengl {
 
         void SubmitFenceSync();
 
+        // Whether staging buffers can be persistently mapped, which requires the immutable buffer
+        // storage of OpenGL 4.4.
+        bool SupportsPersistentMapping() const;
+
+        // Returns an identifier that no other buffer of the device uses, unlike the GL names
+        // that are reused after buffers are deleted.
+        uint64_t AllocateBufferId();
+
         // Dawn API
         CommandBufferBase* CreateCommandBuffer(CommandEncoder* encoder,
                                                const CommandBufferDescriptor* descriptor) override;
@@ -85,9 +93,13 @@ namespace dawn_native { namespace opengl {
             const ComputePipelineDescriptor* descriptor) override;
         ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) override;
-        ResultOrError<QueueBase*> CreateQueueImpl() override;
+        ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) override;
         ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) override;
+        ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) override;
         ResultOrError<SamplerBase*> CreateSamplerImpl(const SamplerDescriptor* descriptor) override;
         ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
             const ShaderModuleDescriptor* descriptor) override;
@@ -110,6 +122,7 @@ namespace dawn_native { namespace opengl {
         Serial mCompletedSerial = 0;
         Serial mLastSubmittedSerial = 0;
         std::queue<std::pair<GLsync, Serial>> mFencesInFlight;
+        uint64_t mNextBufferId = 1;
 
         GLFormatTable mFormatTable;
     };
@@ -14,12 +14,146 @@
 
 #include "dawn_native/opengl/PersistentPipelineStateGL.h"
 
+#include "common/Assert.h"
 #include "dawn_native/opengl/OpenGLFunctions.h"
 
 namespace dawn_native { namespace opengl {
 
     void PersistentPipelineState::SetDefaultState(const OpenGLFunctions& gl) {
+        mProgram = 0;
+        mVertexArray = 0;
+
+        mCullEnabled = false;
+        mFrontFace = GL_CCW;
+        mCullFace = GL_BACK;
+        gl.Disable(GL_CULL_FACE);
+        gl.FrontFace(mFrontFace);
+        gl.CullFace(mCullFace);
+
+        mDepthTestEnabled = false;
+        mDepthWriteEnabled = true;
+        mDepthCompareFunction = GL_LESS;
+        gl.Disable(GL_DEPTH_TEST);
+        gl.DepthMask(GL_TRUE);
+        gl.DepthFunc(mDepthCompareFunction);
+
+        mStencilTestEnabled = false;
+        gl.Disable(GL_STENCIL_TEST);
         CallGLStencilFunc(gl);
+        mStencilBackOperations = {};
+        mStencilFrontOperations = {};
+        gl.StencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        mStencilWriteMask = 0xffffffff;
+        gl.StencilMask(mStencilWriteMask);
+
+        for (uint32_t attachment = 0; attachment < kMaxColorAttachments; ++attachment) {
+            mBlendStates[attachment] = {};
+            gl.Disablei(GL_BLEND, attachment);
+            CallGLBlendState(gl, attachment);
+
+            mColorMasks[attachment] = {true, true, true, true};
+            CallGLColorMask(gl, attachment);
+        }
+
+        mActiveTextureUnit = GL_NONE;
+        mSamplers.clear();
+        mTextures.clear();
+    }
+
+    void PersistentPipelineState::SetProgram(const OpenGLFunctions& gl, GLuint program) {
+        ASSERT(program != 0);
+        if (mProgram == program) {
+            return;
+        }
+
+        mProgram = program;
+        gl.UseProgram(program);
+    }
+
+    void PersistentPipelineState::SetVertexArray(const OpenGLFunctions& gl, GLuint vertexArray) {
+        ASSERT(vertexArray != 0);
+        if (mVertexArray == vertexArray) {
+            return;
+        }
+
+        mVertexArray = vertexArray;
+        gl.BindVertexArray(vertexArray);
+    }
+
+    void PersistentPipelineState::SetCullState(const OpenGLFunctions& gl,
+                                               bool cullEnabled,
+                                               GLenum frontFace,
+                                               GLenum cullFace) {
+        if (mCullEnabled != cullEnabled) {
+            mCullEnabled = cullEnabled;
+            if (cullEnabled) {
+                gl.Enable(GL_CULL_FACE);
+            } else {
+                gl.Disable(GL_CULL_FACE);
+            }
+        }
+
+        // The faces don't matter when culling is disabled.
+        if (!cullEnabled) {
+            return;
+        }
+
+        if (mFrontFace != frontFace) {
+            mFrontFace = frontFace;
+            gl.FrontFace(frontFace);
+        }
+        if (mCullFace != cullFace) {
+            mCullFace = cullFace;
+            gl.CullFace(cullFace);
+        }
+    }
+
+    void PersistentPipelineState::SetDepthTestEnabled(const OpenGLFunctions& gl,
+                                                      bool depthTestEnabled) {
+        if (mDepthTestEnabled == depthTestEnabled) {
+            return;
+        }
+
+        mDepthTestEnabled = depthTestEnabled;
+        if (depthTestEnabled) {
+            gl.Enable(GL_DEPTH_TEST);
+        } else {
+            gl.Disable(GL_DEPTH_TEST);
+        }
+    }
+
+    void PersistentPipelineState::SetDepthWriteEnabled(const OpenGLFunctions& gl,
+                                                       bool depthWriteEnabled) {
+        if (mDepthWriteEnabled == depthWriteEnabled) {
+            return;
+        }
+
+        mDepthWriteEnabled = depthWriteEnabled;
+        gl.DepthMask(depthWriteEnabled ? GL_TRUE : GL_FALSE);
+    }
+
+    void PersistentPipelineState::SetDepthFunc(const OpenGLFunctions& gl,
+                                               GLenum depthCompareFunction) {
+        if (mDepthCompareFunction == depthCompareFunction) {
+            return;
+        }
+
+        mDepthCompareFunction = depthCompareFunction;
+        gl.DepthFunc(depthCompareFunction);
+    }
+
+    void PersistentPipelineState::SetStencilTestEnabled(const OpenGLFunctions& gl,
+                                                        bool stencilTestEnabled) {
+        if (mStencilTestEnabled == stencilTestEnabled) {
+            return;
+        }
+
+        mStencilTestEnabled = stencilTestEnabled;
+        if (stencilTestEnabled) {
+            gl.Enable(GL_STENCIL_TEST);
+        } else {
+            gl.Disable(GL_STENCIL_TEST);
+        }
     }
 
     void PersistentPipelineState::SetStencilFuncsAndMask(const OpenGLFunctions& gl,
@@ -48,6 +182,115 @@ namespace dawn_native { namespace opengl {
         CallGLStencilFunc(gl);
     }
 
+    void PersistentPipelineState::SetStencilOperations(const OpenGLFunctions& gl,
+                                                       GLenum face,
+                                                       GLenum failOperation,
+                                                       GLenum depthFailOperation,
+                                                       GLenum passOperation) {
+        ASSERT(face == GL_BACK || face == GL_FRONT);
+        StencilOperations* operations =
+            face == GL_BACK ? &mStencilBackOperations : &mStencilFrontOperations;
+        if (operations->failOperation == failOperation &&
+            operations->depthFailOperation == depthFailOperation &&
+            operations->passOperation == passOperation) {
+            return;
+        }
+
+        operations->failOperation = failOperation;
+        operations->depthFailOperation = depthFailOperation;
+        operations->passOperation = passOperation;
+        gl.StencilOpSeparate(face, failOperation, depthFailOperation, passOperation);
+    }
+
+    void PersistentPipelineState::SetStencilWriteMask(const OpenGLFunctions& gl,
+                                                      uint32_t stencilWriteMask) {
+        if (mStencilWriteMask == stencilWriteMask) {
+            return;
+        }
+
+        mStencilWriteMask = stencilWriteMask;
+        gl.StencilMask(stencilWriteMask);
+    }
+
+    void PersistentPipelineState::SetBlendState(const OpenGLFunctions& gl,
+                                                uint32_t attachment,
+                                                const BlendState& blendState) {
+        ASSERT(attachment < kMaxColorAttachments);
+        BlendState* current = &mBlendStates[attachment];
+
+        if (current->enabled != blendState.enabled) {
+            current->enabled = blendState.enabled;
+            if (blendState.enabled) {
+                gl.Enablei(GL_BLEND, attachment);
+            } else {
+                gl.Disablei(GL_BLEND, attachment);
+            }
+        }
+
+        if (!blendState.enabled) {
+            return;
+        }
+
+        if (current->colorOperation != blendState.colorOperation ||
+            current->alphaOperation != blendState.alphaOperation ||
+            current->colorSrcFactor != blendState.colorSrcFactor ||
+            current->colorDstFactor != blendState.colorDstFactor ||
+            current->alphaSrcFactor != blendState.alphaSrcFactor ||
+            current->alphaDstFactor != blendState.alphaDstFactor) {
+            *current = blendState;
+            CallGLBlendState(gl, attachment);
+        }
+    }
+
+    void PersistentPipelineState::SetColorMask(const OpenGLFunctions& gl,
+                                               uint32_t attachment,
+                                               bool red,
+                                               bool green,
+                                               bool blue,
+                                               bool alpha) {
+        ASSERT(attachment < kMaxColorAttachments);
+        std::array<bool, 4> colorMask = {red, green, blue, alpha};
+        if (mColorMasks[attachment] == colorMask) {
+            return;
+        }
+
+        mColorMasks[attachment] = colorMask;
+        CallGLColorMask(gl, attachment);
+    }
+
+    void PersistentPipelineState::BindSampler(const OpenGLFunctions& gl,
+                                              GLuint unit,
+                                              GLuint sampler) {
+        ASSERT(sampler != 0);
+        if (unit >= mSamplers.size()) {
+            mSamplers.resize(unit + 1, 0);
+        } else if (mSamplers[unit] == sampler) {
+            return;
+        }
+
+        mSamplers[unit] = sampler;
+        gl.BindSampler(unit, sampler);
+    }
+
+    void PersistentPipelineState::BindTexture(const OpenGLFunctions& gl,
+                                              GLuint unit,
+                                              GLenum target,
+                                              GLuint texture) {
+        ASSERT(target != GL_NONE);
+        if (unit >= mTextures.size()) {
+            mTextures.resize(unit + 1);
+        } else if (mTextures[unit].target == target && mTextures[unit].texture == texture) {
+            return;
+        }
+
+        if (mActiveTextureUnit != GL_TEXTURE0 + unit) {
+            mActiveTextureUnit = GL_TEXTURE0 + unit;
+            gl.ActiveTexture(mActiveTextureUnit);
+        }
+        mTextures[unit] = {target, texture};
+        gl.BindTexture(target, texture);
+    }
+
     void PersistentPipelineState::CallGLStencilFunc(const OpenGLFunctions& gl) {
         gl.StencilFuncSeparate(GL_BACK, mStencilBackCompareFunction, mStencilReference,
                                mStencilReadMask);
@@ -55,4 +298,18 @@ namespace dawn_native { namespace opengl {
                                mStencilReadMask);
     }
 
+    void PersistentPipelineState::CallGLBlendState(const OpenGLFunctions& gl,
+                                                   uint32_t attachment) {
+        const BlendState& blendState = mBlendStates[attachment];
+        gl.BlendEquationSeparatei(attachment, blendState.colorOperation,
+                                  blendState.alphaOperation);
+        gl.BlendFuncSeparatei(attachment, blendState.colorSrcFactor, blendState.colorDstFactor,
+                              blendState.alphaSrcFactor, blendState.alphaDstFactor);
+    }
+
+    void PersistentPipelineState::CallGLColorMask(const OpenGLFunctions& gl, uint32_t attachment) {
+        const std::array<bool, 4>& colorMask = mColorMasks[attachment];
+        gl.ColorMaski(attachment, colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+    }
+
 }}  // namespace dawn_native::opengl
@@ -15,29 +15,116 @@
 #ifndef DAWNNATIVE_OPENGL_PERSISTENTPIPELINESTATEGL_H_
 #define DAWNNATIVE_OPENGL_PERSISTENTPIPELINESTATEGL_H_
 
+#include "common/Constants.h"
 #include "dawn_native/dawn_platform.h"
 #include "dawn_native/opengl/opengl_platform.h"
 
+#include <array>
+#include <vector>
+
 namespace dawn_native { namespace opengl {
 
     struct OpenGLFunctions;
 
+    // Shadows the OpenGL state set while executing a pass so that the calls that wouldn't change
+    // it are skipped. All the changes to the shadowed state during the pass must go through this
+    // object. The program, vertex array, texture and sampler bindings start out unknown, while
+    // the fixed-function state is only known after SetDefaultState puts it in its default values.
     class PersistentPipelineState {
       public:
         void SetDefaultState(const OpenGLFunctions& gl);
+
+        void SetProgram(const OpenGLFunctions& gl, GLuint program);
+        void SetVertexArray(const OpenGLFunctions& gl, GLuint vertexArray);
+
+        void SetCullState(const OpenGLFunctions& gl,
+                          bool cullEnabled,
+                          GLenum frontFace,
+                          GLenum cullFace);
+
+        void SetDepthTestEnabled(const OpenGLFunctions& gl, bool depthTestEnabled);
+        void SetDepthWriteEnabled(const OpenGLFunctions& gl, bool depthWriteEnabled);
+        void SetDepthFunc(const OpenGLFunctions& gl, GLenum depthCompareFunction);
+
+        void SetStencilTestEnabled(const OpenGLFunctions& gl, bool stencilTestEnabled);
         void SetStencilFuncsAndMask(const OpenGLFunctions& gl,
                                     GLenum stencilBackCompareFunction,
                                     GLenum stencilFrontCompareFunction,
                                     uint32_t stencilReadMask);
         void SetStencilReference(const OpenGLFunctions& gl, uint32_t stencilReference);
+        void SetStencilOperations(const OpenGLFunctions& gl,
+                                  GLenum face,
+                                  GLenum failOperation,
+                                  GLenum depthFailOperation,
+                                  GLenum passOperation);
+        void SetStencilWriteMask(const OpenGLFunctions& gl, uint32_t stencilWriteMask);
+
+        // The blend equations and functions are only set when blending is enabled.
+        struct BlendState {
+            bool enabled = false;
+            GLenum colorOperation = GL_FUNC_ADD;
+            GLenum alphaOperation = GL_FUNC_ADD;
+            GLenum colorSrcFactor = GL_ONE;
+            GLenum colorDstFactor = GL_ZERO;
+            GLenum alphaSrcFactor = GL_ONE;
+            GLenum alphaDstFactor = GL_ZERO;
+        };
+        void SetBlendState(const OpenGLFunctions& gl,
+                           uint32_t attachment,
+                           const BlendState& blendState);
+        void SetColorMask(const OpenGLFunctions& gl,
+                          uint32_t attachment,
+                          bool red,
+                          bool green,
+                          bool blue,
+                          bool alpha);
+
+        void BindSampler(const OpenGLFunctions& gl, GLuint unit, GLuint sampler);
+        void BindTexture(const OpenGLFunctions& gl, GLuint unit, GLenum target, GLuint texture);
 
       private:
         void CallGLStencilFunc(const OpenGLFunctions& gl);
+        void CallGLBlendState(const OpenGLFunctions& gl, uint32_t attachment);
+        void CallGLColorMask(const OpenGLFunctions& gl, uint32_t attachment);
+
+        // Program and vertex array 0 are never used by the passes and mean "unknown".
+        GLuint mProgram = 0;
+        GLuint mVertexArray = 0;
+
+        bool mCullEnabled = false;
+        GLenum mFrontFace = GL_CCW;
+        GLenum mCullFace = GL_BACK;
 
+        bool mDepthTestEnabled = false;
+        bool mDepthWriteEnabled = true;
+        GLenum mDepthCompareFunction = GL_LESS;
+
+        bool mStencilTestEnabled = false;
         GLenum mStencilBackCompareFunction = GL_ALWAYS;
         GLenum mStencilFrontCompareFunction = GL_ALWAYS;
         GLuint mStencilReadMask = 0xffffffff;
         GLuint mStencilReference = 0;
+        struct StencilOperations {
+            GLenum failOperation = GL_KEEP;
+            GLenum depthFailOperation = GL_KEEP;
+            GLenum passOperation = GL_KEEP;
+        };
+        StencilOperations mStencilBackOperations;
+        StencilOperations mStencilFrontOperations;
+        GLuint mStencilWriteMask = 0xffffffff;
+
+        std::array<BlendState, kMaxColorAttachments> mBlendStates;
+        std::array<std::array<bool, 4>, kMaxColorAttachments> mColorMasks;
+
+        // The texture units are only known once they have been bound in the pass. Sampler 0 and
+        // the GL_NONE target are never bound by the passes and mean "unknown".
+        struct TextureBinding {
+            GLenum target = GL_NONE;
+            GLuint texture = 0;
+        };
+        GLenum mActiveTextureUnit = GL_NONE;
+        std::vector<GLuint> mSamplers;
+        std::vector<TextureBinding> mTextures;
     };
 
 }}  // namespace dawn_native::opengl
@@ -19,6 +19,7 @@
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/opengl/Forward.h"
 #include "dawn_native/opengl/OpenGLFunctions.h"
+#include "dawn_native/opengl/PersistentPipelineStateGL.h"
 #include "dawn_native/opengl/PipelineLayoutGL.h"
 #include "dawn_native/opengl/ShaderModuleGL.h"
 
@@ -208,8 +209,9 @@ namespace dawn_native { namespace opengl {
         return mProgram;
     }
 
-    void PipelineGL::ApplyNow(const OpenGLFunctions& gl) {
-        gl.UseProgram(mProgram);
+    void PipelineGL::ApplyNow(const OpenGLFunctions& gl,
+                              PersistentPipelineState& persistentPipelineState) {
+        persistentPipelineState.SetProgram(gl, mProgram);
     }
 
 }}  // namespace dawn_native::opengl
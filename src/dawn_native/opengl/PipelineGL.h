@@ -49,7 +49,7 @@ namespace dawn_native { namespace opengl {
         const std::vector<GLuint>& GetTextureUnitsForTextureView(GLuint index) const;
         GLuint GetProgramHandle() const;
 
-        void ApplyNow(const OpenGLFunctions& gl);
+        void ApplyNow(const OpenGLFunctions& gl, PersistentPipelineState& persistentPipelineState);
 
       private:
         GLuint mProgram;
@@ -14,6 +14,7 @@
 
 #include "dawn_native/opengl/RenderPipelineGL.h"
 
+#include "dawn_native/opengl/BufferGL.h"
 #include "dawn_native/opengl/DeviceGL.h"
 #include "dawn_native/opengl/Forward.h"
 #include "dawn_native/opengl/PersistentPipelineStateGL.h"
@@ -40,21 +41,101 @@ namespace dawn_native { namespace opengl {
             }
         }
 
+        GLenum VertexFormatType(wgpu::VertexFormat format) {
+            switch (format) {
+                case wgpu::VertexFormat::UChar2:
+                case wgpu::VertexFormat::UChar4:
+                case wgpu::VertexFormat::UChar2Norm:
+                case wgpu::VertexFormat::UChar4Norm:
+                    return GL_UNSIGNED_BYTE;
+                case wgpu::VertexFormat::Char2:
+                case wgpu::VertexFormat::Char4:
+                case wgpu::VertexFormat::Char2Norm:
+                case wgpu::VertexFormat::Char4Norm:
+                    return GL_BYTE;
+                case wgpu::VertexFormat::UShort2:
+                case wgpu::VertexFormat::UShort4:
+                case wgpu::VertexFormat::UShort2Norm:
+                case wgpu::VertexFormat::UShort4Norm:
+                    return GL_UNSIGNED_SHORT;
+                case wgpu::VertexFormat::Short2:
+                case wgpu::VertexFormat::Short4:
+                case wgpu::VertexFormat::Short2Norm:
+                case wgpu::VertexFormat::Short4Norm:
+                    return GL_SHORT;
+                case wgpu::VertexFormat::Half2:
+                case wgpu::VertexFormat::Half4:
+                    return GL_HALF_FLOAT;
+                case wgpu::VertexFormat::Float:
+                case wgpu::VertexFormat::Float2:
+                case wgpu::VertexFormat::Float3:
+                case wgpu::VertexFormat::Float4:
+                    return GL_FLOAT;
+                case wgpu::VertexFormat::UInt:
+                case wgpu::VertexFormat::UInt2:
+                case wgpu::VertexFormat::UInt3:
+                case wgpu::VertexFormat::UInt4:
+                    return GL_UNSIGNED_INT;
+                case wgpu::VertexFormat::Int:
+                case wgpu::VertexFormat::Int2:
+                case wgpu::VertexFormat::Int3:
+                case wgpu::VertexFormat::Int4:
+                    return GL_INT;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        GLboolean VertexFormatIsNormalized(wgpu::VertexFormat format) {
+            switch (format) {
+                case wgpu::VertexFormat::UChar2Norm:
+                case wgpu::VertexFormat::UChar4Norm:
+                case wgpu::VertexFormat::Char2Norm:
+                case wgpu::VertexFormat::Char4Norm:
+                case wgpu::VertexFormat::UShort2Norm:
+                case wgpu::VertexFormat::UShort4Norm:
+                case wgpu::VertexFormat::Short2Norm:
+                case wgpu::VertexFormat::Short4Norm:
+                    return GL_TRUE;
+                default:
+                    return GL_FALSE;
+            }
+        }
+
+        bool VertexFormatIsInt(wgpu::VertexFormat format) {
+            switch (format) {
+                case wgpu::VertexFormat::UChar2:
+                case wgpu::VertexFormat::UChar4:
+                case wgpu::VertexFormat::Char2:
+                case wgpu::VertexFormat::Char4:
+                case wgpu::VertexFormat::UShort2:
+                case wgpu::VertexFormat::UShort4:
+                case wgpu::VertexFormat::Short2:
+                case wgpu::VertexFormat::Short4:
+                case wgpu::VertexFormat::UInt:
+                case wgpu::VertexFormat::UInt2:
+                case wgpu::VertexFormat::UInt3:
+                case wgpu::VertexFormat::UInt4:
+                case wgpu::VertexFormat::Int:
+                case wgpu::VertexFormat::Int2:
+                case wgpu::VertexFormat::Int3:
+                case wgpu::VertexFormat::Int4:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
         void ApplyFrontFaceAndCulling(const OpenGLFunctions& gl,
                                       wgpu::FrontFace face,
-                                      wgpu::CullMode mode) {
-            if (mode == wgpu::CullMode::None) {
-                gl.Disable(GL_CULL_FACE);
-            } else {
-                gl.Enable(GL_CULL_FACE);
-                // Note that we invert winding direction in OpenGL. Because Y axis is up in OpenGL,
-                // which is different from WebGPU and other backends (Y axis is down).
-                GLenum direction = (face == wgpu::FrontFace::CCW) ? GL_CW : GL_CCW;
-                gl.FrontFace(direction);
-
-                GLenum cullMode = (mode == wgpu::CullMode::Front) ? GL_FRONT : GL_BACK;
-                gl.CullFace(cullMode);
-            }
+                                      wgpu::CullMode mode,
+                                      PersistentPipelineState* persistentPipelineState) {
+            // Note that we invert winding direction in OpenGL. Because Y axis is up in OpenGL,
+            // which is different from WebGPU and other backends (Y axis is down).
+            GLenum direction = (face == wgpu::FrontFace::CCW) ? GL_CW : GL_CCW;
+            GLenum cullMode = (mode == wgpu::CullMode::Front) ? GL_FRONT : GL_BACK;
+            persistentPipelineState->SetCullState(gl, mode != wgpu::CullMode::None, direction,
+                                                  cullMode);
         }
 
         GLenum GLBlendFactor(wgpu::BlendFactor factor, bool alpha) {
@@ -109,23 +190,24 @@ namespace dawn_native { namespace opengl {
 
         void ApplyColorState(const OpenGLFunctions& gl,
                              uint32_t attachment,
-                             const ColorStateDescriptor* descriptor) {
-            if (BlendEnabled(descriptor)) {
-                gl.Enablei(GL_BLEND, attachment);
-                gl.BlendEquationSeparatei(attachment, GLBlendMode(descriptor->colorBlend.operation),
-                                          GLBlendMode(descriptor->alphaBlend.operation));
-                gl.BlendFuncSeparatei(attachment,
-                                      GLBlendFactor(descriptor->colorBlend.srcFactor, false),
-                                      GLBlendFactor(descriptor->colorBlend.dstFactor, false),
-                                      GLBlendFactor(descriptor->alphaBlend.srcFactor, true),
-                                      GLBlendFactor(descriptor->alphaBlend.dstFactor, true));
-            } else {
-                gl.Disablei(GL_BLEND, attachment);
+                             const ColorStateDescriptor* descriptor,
+                             PersistentPipelineState* persistentPipelineState) {
+            PersistentPipelineState::BlendState blendState;
+            blendState.enabled = BlendEnabled(descriptor);
+            if (blendState.enabled) {
+                blendState.colorOperation = GLBlendMode(descriptor->colorBlend.operation);
+                blendState.alphaOperation = GLBlendMode(descriptor->alphaBlend.operation);
+                blendState.colorSrcFactor = GLBlendFactor(descriptor->colorBlend.srcFactor, false);
+                blendState.colorDstFactor = GLBlendFactor(descriptor->colorBlend.dstFactor, false);
+                blendState.alphaSrcFactor = GLBlendFactor(descriptor->alphaBlend.srcFactor, true);
+                blendState.alphaDstFactor = GLBlendFactor(descriptor->alphaBlend.dstFactor, true);
             }
-            gl.ColorMaski(attachment, descriptor->writeMask & wgpu::ColorWriteMask::Red,
-                          descriptor->writeMask & wgpu::ColorWriteMask::Green,
-                          descriptor->writeMask & wgpu::ColorWriteMask::Blue,
-                          descriptor->writeMask & wgpu::ColorWriteMask::Alpha);
+            persistentPipelineState->SetBlendState(gl, attachment, blendState);
+            persistentPipelineState->SetColorMask(
+                gl, attachment, descriptor->writeMask & wgpu::ColorWriteMask::Red,
+                descriptor->writeMask & wgpu::ColorWriteMask::Green,
+                descriptor->writeMask & wgpu::ColorWriteMask::Blue,
+                descriptor->writeMask & wgpu::ColorWriteMask::Alpha);
         }
 
         GLuint OpenGLStencilOperation(wgpu::StencilOperation stencilOperation) {
@@ -155,59 +237,54 @@ namespace dawn_native { namespace opengl {
                                     const DepthStencilStateDescriptor* descriptor,
                                     PersistentPipelineState* persistentPipelineState) {
             // Depth writes only occur if depth is enabled
-            if (descriptor->depthCompare == wgpu::CompareFunction::Always &&
-                !descriptor->depthWriteEnabled) {
-                gl.Disable(GL_DEPTH_TEST);
-            } else {
-                gl.Enable(GL_DEPTH_TEST);
-            }
-
-            if (descriptor->depthWriteEnabled) {
-                gl.DepthMask(GL_TRUE);
-            } else {
-                gl.DepthMask(GL_FALSE);
-            }
-
-            gl.DepthFunc(ToOpenGLCompareFunction(descriptor->depthCompare));
+            persistentPipelineState->SetDepthTestEnabled(
+                gl, descriptor->depthCompare != wgpu::CompareFunction::Always ||
+                        descriptor->depthWriteEnabled);
+            persistentPipelineState->SetDepthWriteEnabled(gl, descriptor->depthWriteEnabled);
+            persistentPipelineState->SetDepthFunc(
+                gl, ToOpenGLCompareFunction(descriptor->depthCompare));
 
-            if (StencilTestEnabled(descriptor)) {
-                gl.Enable(GL_STENCIL_TEST);
-            } else {
-                gl.Disable(GL_STENCIL_TEST);
-            }
+            persistentPipelineState->SetStencilTestEnabled(gl, StencilTestEnabled(descriptor));
 
             GLenum backCompareFunction = ToOpenGLCompareFunction(descriptor->stencilBack.compare);
             GLenum frontCompareFunction = ToOpenGLCompareFunction(descriptor->stencilFront.compare);
             persistentPipelineState->SetStencilFuncsAndMask(
                 gl, backCompareFunction, frontCompareFunction, descriptor->stencilReadMask);
 
-            gl.StencilOpSeparate(GL_BACK, OpenGLStencilOperation(descriptor->stencilBack.failOp),
-                                 OpenGLStencilOperation(descriptor->stencilBack.depthFailOp),
-                                 OpenGLStencilOperation(descriptor->stencilBack.passOp));
-            gl.StencilOpSeparate(GL_FRONT, OpenGLStencilOperation(descriptor->stencilFront.failOp),
-                                 OpenGLStencilOperation(descriptor->stencilFront.depthFailOp),
-                                 OpenGLStencilOperation(descriptor->stencilFront.passOp));
+            persistentPipelineState->SetStencilOperations(
+                gl, GL_BACK, OpenGLStencilOperation(descriptor->stencilBack.failOp),
+                OpenGLStencilOperation(descriptor->stencilBack.depthFailOp),
+                OpenGLStencilOperation(descriptor->stencilBack.passOp));
+            persistentPipelineState->SetStencilOperations(
+                gl, GL_FRONT, OpenGLStencilOperation(descriptor->stencilFront.failOp),
+                OpenGLStencilOperation(descriptor->stencilFront.depthFailOp),
+                OpenGLStencilOperation(descriptor->stencilFront.passOp));
 
-            gl.StencilMask(descriptor->stencilWriteMask);
+            persistentPipelineState->SetStencilWriteMask(gl, descriptor->stencilWriteMask);
         }
 
     }  // anonymous namespace
 
     RenderPipeline::RenderPipeline(Device* device, const RenderPipelineDescriptor* descriptor)
         : RenderPipelineBase(device, descriptor),
-          mVertexArrayObject(0),
           mGlPrimitiveTopology(GLPrimitiveTopology(GetPrimitiveTopology())) {
         PerStage<const ShaderModule*> modules(nullptr);
         modules[SingleShaderStage::Vertex] = ToBackend(descriptor->vertexStage.module);
         modules[SingleShaderStage::Fragment] = ToBackend(descriptor->fragmentStage->module);
 
         PipelineGL::Initialize(device->gl, ToBackend(GetLayout()), modules);
-        CreateVAOForVertexState(descriptor->vertexState);
+
+        for (uint32_t location : IterateBitSet(GetAttributeLocationsUsed())) {
+            const auto& attribute = GetAttribute(location);
+            attributesUsingVertexBuffer[attribute.vertexBufferSlot][location] = true;
+        }
     }
 
     RenderPipeline::~RenderPipeline() {
         const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
-        gl.DeleteVertexArrays(1, &mVertexArrayObject);
+        for (auto& it : mVertexArrayObjects) {
+            gl.DeleteVertexArrays(1, &it.second.vertexArrayObject);
+        }
         gl.BindVertexArray(0);
     }
 
@@ -215,17 +292,21 @@ namespace dawn_native { namespace opengl {
         return mGlPrimitiveTopology;
     }
 
-    void RenderPipeline::CreateVAOForVertexState(const VertexStateDescriptor* vertexState) {
-        const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
-
-        gl.GenVertexArrays(1, &mVertexArrayObject);
-        gl.BindVertexArray(mVertexArrayObject);
+    bool RenderPipeline::VertexArrayKey::operator<(const VertexArrayKey& other) const {
+        if (indexBufferId != other.indexBufferId) {
+            return indexBufferId < other.indexBufferId;
+        }
+        if (vertexBufferIds != other.vertexBufferIds) {
+            return vertexBufferIds < other.vertexBufferIds;
+        }
+        return vertexBufferOffsets < other.vertexBufferOffsets;
+    }
 
+    void RenderPipeline::InitializeVertexArrayObject(const OpenGLFunctions& gl) {
         for (uint32_t location : IterateBitSet(GetAttributeLocationsUsed())) {
             const auto& attribute = GetAttribute(location);
             gl.EnableVertexAttribArray(location);
 
-            attributesUsingVertexBuffer[attribute.vertexBufferSlot][location] = true;
             const VertexBufferInfo& vertexBuffer = GetVertexBuffer(attribute.vertexBufferSlot);
 
             if (vertexBuffer.arrayStride == 0) {
@@ -246,19 +327,101 @@ namespace dawn_native { namespace opengl {
         }
     }
 
-    void RenderPipeline::ApplyNow(PersistentPipelineState& persistentPipelineState) {
+    void RenderPipeline::SetVertexArrayBuffers(
+        const OpenGLFunctions& gl,
+        Buffer* indexBuffer,
+        const std::array<Buffer*, kMaxVertexBuffers>& vertexBuffers,
+        const std::array<uint64_t, kMaxVertexBuffers>& offsets) {
+        if (indexBuffer != nullptr) {
+            gl.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->GetHandle());
+        }
+
+        for (uint32_t slot : IterateBitSet(GetVertexBufferSlotsUsed())) {
+            const VertexBufferInfo& vertexBuffer = GetVertexBuffer(slot);
+            gl.BindBuffer(GL_ARRAY_BUFFER, vertexBuffers[slot]->GetHandle());
+
+            for (uint32_t location : IterateBitSet(GetAttributesUsingVertexBuffer(slot))) {
+                const VertexAttributeInfo& attribute = GetAttribute(location);
+
+                uint32_t components = VertexFormatNumComponents(attribute.format);
+                GLenum formatType = VertexFormatType(attribute.format);
+                uint64_t offset = offsets[slot] + attribute.offset;
+                void* pointer = reinterpret_cast<void*>(static_cast<intptr_t>(offset));
+
+                if (VertexFormatIsInt(attribute.format)) {
+                    gl.VertexAttribIPointer(location, components, formatType,
+                                            vertexBuffer.arrayStride, pointer);
+                } else {
+                    GLboolean normalized = VertexFormatIsNormalized(attribute.format);
+                    gl.VertexAttribPointer(location, components, formatType, normalized,
+                                           vertexBuffer.arrayStride, pointer);
+                }
+            }
+        }
+    }
+
+    void RenderPipeline::ApplyVertexBuffers(
+        PersistentPipelineState& persistentPipelineState,
+        Buffer* indexBuffer,
+        const std::array<Buffer*, kMaxVertexBuffers>& vertexBuffers,
+        const std::array<uint64_t, kMaxVertexBuffers>& vertexBufferOffsets) {
         const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
-        PipelineGL::ApplyNow(gl);
 
-        ASSERT(mVertexArrayObject);
-        gl.BindVertexArray(mVertexArrayObject);
+        // Only the buffers used by the pipeline are part of the key.
+        VertexArrayKey key;
+        if (indexBuffer != nullptr) {
+            key.indexBufferId = indexBuffer->GetId();
+        }
+        for (uint32_t slot : IterateBitSet(GetVertexBufferSlotsUsed())) {
+            ASSERT(vertexBuffers[slot] != nullptr);
+            key.vertexBufferIds[slot] = vertexBuffers[slot]->GetId();
+            key.vertexBufferOffsets[slot] = vertexBufferOffsets[slot];
+        }
+
+        mVertexArrayUseCount++;
+
+        auto it = mVertexArrayObjects.find(key);
+        if (it != mVertexArrayObjects.end()) {
+            it->second.lastUsed = mVertexArrayUseCount;
+            persistentPipelineState.SetVertexArray(gl, it->second.vertexArrayObject);
+            return;
+        }
+
+        GLuint vertexArrayObject = 0;
+        if (mVertexArrayObjects.size() < kMaxCachedVertexArrayObjects) {
+            gl.GenVertexArrays(1, &vertexArrayObject);
+            persistentPipelineState.SetVertexArray(gl, vertexArrayObject);
+            InitializeVertexArrayObject(gl);
+        } else {
+            // The attributes of the least recently used VAO are already enabled, only its buffers
+            // need to be respecified.
+            auto leastRecentlyUsed = mVertexArrayObjects.begin();
+            for (auto candidate = mVertexArrayObjects.begin();
+                 candidate != mVertexArrayObjects.end(); ++candidate) {
+                if (candidate->second.lastUsed < leastRecentlyUsed->second.lastUsed) {
+                    leastRecentlyUsed = candidate;
+                }
+            }
+            vertexArrayObject = leastRecentlyUsed->second.vertexArrayObject;
+            mVertexArrayObjects.erase(leastRecentlyUsed);
+            persistentPipelineState.SetVertexArray(gl, vertexArrayObject);
+        }
+
+        SetVertexArrayBuffers(gl, indexBuffer, vertexBuffers, vertexBufferOffsets);
+        mVertexArrayObjects[key] = {vertexArrayObject, mVertexArrayUseCount};
+    }
+
+    void RenderPipeline::ApplyNow(PersistentPipelineState& persistentPipelineState) {
+        const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
+        PipelineGL::ApplyNow(gl, persistentPipelineState);
 
-        ApplyFrontFaceAndCulling(gl, GetFrontFace(), GetCullMode());
+        ApplyFrontFaceAndCulling(gl, GetFrontFace(), GetCullMode(), &persistentPipelineState);
 
         ApplyDepthStencilState(gl, GetDepthStencilStateDescriptor(), &persistentPipelineState);
 
         for (uint32_t attachmentSlot : IterateBitSet(GetColorAttachmentsMask())) {
-            ApplyColorState(gl, attachmentSlot, GetColorStateDescriptor(attachmentSlot));
+            ApplyColorState(gl, attachmentSlot, GetColorStateDescriptor(attachmentSlot),
+                            &persistentPipelineState);
         }
     }
 
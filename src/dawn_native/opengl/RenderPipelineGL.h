@@ -20,10 +20,13 @@
 #include "dawn_native/opengl/PipelineGL.h"
 #include "dawn_native/opengl/opengl_platform.h"
 
+#include <array>
+#include <map>
 #include <vector>
 
 namespace dawn_native { namespace opengl {
 
+    class Buffer;
     class Device;
     class PersistentPipelineState;
 
@@ -36,11 +39,41 @@ namespace dawn_native { namespace opengl {
 
         void ApplyNow(PersistentPipelineState& persistentPipelineState);
 
+        // The vertex and index buffers are part of the VAO state in OpenGL. Binds a VAO of the
+        // pipeline that has these buffers and offsets, reusing or respecifying the least recently
+        // used one when there is no such VAO.
+        void ApplyVertexBuffers(PersistentPipelineState& persistentPipelineState,
+                                Buffer* indexBuffer,
+                                const std::array<Buffer*, kMaxVertexBuffers>& vertexBuffers,
+                                const std::array<uint64_t, kMaxVertexBuffers>& vertexBufferOffsets);
+
       private:
-        void CreateVAOForVertexState(const VertexStateDescriptor* vertexState);
+        static constexpr size_t kMaxCachedVertexArrayObjects = 16;
+
+        // The buffers are identified by their ID and not by their GL name because the names are
+        // reused after the buffers are deleted.
+        struct VertexArrayKey {
+            uint64_t indexBufferId = 0;
+            std::array<uint64_t, kMaxVertexBuffers> vertexBufferIds = {};
+            std::array<uint64_t, kMaxVertexBuffers> vertexBufferOffsets = {};
+
+            bool operator<(const VertexArrayKey& other) const;
+        };
+
+        struct CachedVertexArray {
+            GLuint vertexArrayObject;
+            uint64_t lastUsed;
+        };
+
+        void InitializeVertexArrayObject(const OpenGLFunctions& gl);
+        void SetVertexArrayBuffers(const OpenGLFunctions& gl,
+                                   Buffer* indexBuffer,
+                                   const std::array<Buffer*, kMaxVertexBuffers>& vertexBuffers,
+                                   const std::array<uint64_t, kMaxVertexBuffers>& offsets);
 
         // TODO(yunchao.he@intel.com): vao need to be deduplicated between pipelines.
-        GLuint mVertexArrayObject;
+        std::map<VertexArrayKey, CachedVertexArray> mVertexArrayObjects;
+        uint64_t mVertexArrayUseCount = 0;
         GLenum mGlPrimitiveTopology;
     };
 
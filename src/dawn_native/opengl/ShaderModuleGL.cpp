@@ -121,7 +121,9 @@ namespace dawn_native { namespace opengl {
         compiler->set_common_options(options);
         }
 
-        DAWN_TRY(ExtractSpirvInfo(*compiler));
+        if (!LoadSpirvInfoFromCache()) {
+            DAWN_TRY(ExtractSpirvInfo(*compiler));
+        }
 
         const auto& bindingInfo = GetBindingInfo();
 
@@ -0,0 +1,61 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/opengl/StagingBufferGL.h"
+
+#include "dawn_native/opengl/DeviceGL.h"
+
+namespace dawn_native { namespace opengl {
+
+    StagingBuffer::StagingBuffer(size_t size, Device* device)
+        : StagingBufferBase(size), mDevice(device) {
+    }
+
+    StagingBuffer::~StagingBuffer() {
+        if (mBuffer == 0) {
+            return;
+        }
+
+        const OpenGLFunctions& gl = mDevice->gl;
+        gl.BindBuffer(GL_COPY_READ_BUFFER, mBuffer);
+        gl.UnmapBuffer(GL_COPY_READ_BUFFER);
+        gl.DeleteBuffers(1, &mBuffer);
+        mBuffer = 0;
+    }
+
+    MaybeError StagingBuffer::Initialize() {
+        ASSERT(mDevice->SupportsPersistentMapping());
+        const OpenGLFunctions& gl = mDevice->gl;
+
+        // The buffer stays mapped for its whole lifetime. The mapping is coherent so the writes
+        // are visible to the copies recorded after them without flushing explicitly.
+        constexpr GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                                         GL_MAP_COHERENT_BIT;
+
+        gl.GenBuffers(1, &mBuffer);
+        gl.BindBuffer(GL_COPY_READ_BUFFER, mBuffer);
+        gl.BufferStorage(GL_COPY_READ_BUFFER, GetSize(), nullptr, kMapFlags);
+        mMappedPointer = gl.MapBufferRange(GL_COPY_READ_BUFFER, 0, GetSize(), kMapFlags);
+        if (mMappedPointer == nullptr) {
+            return DAWN_DEVICE_LOST_ERROR("Unable to map staging buffer.");
+        }
+
+        return {};
+    }
+
+    GLuint StagingBuffer::GetHandle() const {
+        return mBuffer;
+    }
+
+}}  // namespace dawn_native::opengl
@@ -14,6 +14,7 @@
 
 #include "dawn_native/vulkan/AdapterVk.h"
 
+#include "common/Constants.h"
 #include "dawn_native/vulkan/BackendVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 
@@ -38,19 +39,26 @@ namespace dawn_native { namespace vulkan {
     }
 
     MaybeError Adapter::Initialize() {
-        DAWN_TRY_ASSIGN(mDeviceInfo, GatherDeviceInfo(*this));
+        DAWN_TRY_ASSIGN(mDeviceInfo, GatherDeviceDiscoveryInfo(*this));
         if (!mDeviceInfo.maintenance1) {
             return DAWN_DEVICE_LOST_ERROR(
                 "Dawn requires Vulkan 1.1 or Vulkan 1.0 with KHR_Maintenance1 in order to support "
                 "viewport flipY");
         }
 
-        InitializeSupportedExtensions();
-
         mPCIInfo.deviceId = mDeviceInfo.properties.deviceID;
         mPCIInfo.vendorId = mDeviceInfo.properties.vendorID;
         mPCIInfo.name = mDeviceInfo.properties.deviceName;
 
+        // The pipeline cache UUID changes whenever the driver can't use the pipeline caches of
+        // another version anymore.
+        const uint8_t* uuid = mDeviceInfo.properties.pipelineCacheUUID;
+        const uint8_t* driverVersion =
+            reinterpret_cast<const uint8_t*>(&mDeviceInfo.properties.driverVersion);
+        mDriverFingerprint.assign(uuid, uuid + VK_UUID_SIZE);
+        mDriverFingerprint.insert(mDriverFingerprint.end(), driverVersion,
+                                  driverVersion + sizeof(uint32_t));
+
         switch (mDeviceInfo.properties.deviceType) {
             case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
                 mAdapterType = wgpu::AdapterType::IntegratedGPU;
@@ -69,10 +77,62 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Adapter::InitializeDetailsImpl() {
+        DAWN_TRY_ASSIGN(mDeviceInfo, GatherDeviceInfo(*this));
+        InitializeSupportedExtensions();
+        return {};
+    }
+
     void Adapter::InitializeSupportedExtensions() {
         if (mDeviceInfo.features.textureCompressionBC == VK_TRUE) {
             mSupportedExtensions.EnableExtension(Extension::TextureCompressionBC);
         }
+
+        // Timestamps are written on the universal queue, which needs to support them in all
+        // stages.
+        if (mDeviceInfo.properties.limits.timestampComputeAndGraphics == VK_TRUE) {
+            mSupportedExtensions.EnableExtension(Extension::TimestampQuery);
+        }
+
+        if (mDeviceInfo.features.pipelineStatisticsQuery == VK_TRUE) {
+            mSupportedExtensions.EnableExtension(Extension::PipelineStatisticsQuery);
+        }
+
+        // The count buffer gives the number of draws in a single command, which can't be split.
+        if (mDeviceInfo.drawIndirectCount && mDeviceInfo.features.multiDrawIndirect == VK_TRUE) {
+            mSupportedExtensions.EnableExtension(Extension::DrawIndirectCount);
+        }
+
+        // The conditionalRendering feature is required with the extension.
+        if (mDeviceInfo.conditionalRendering) {
+            mSupportedExtensions.EnableExtension(Extension::ConditionalRendering);
+        }
+
+        if (SupportsResourceTables(*this)) {
+            mSupportedExtensions.EnableExtension(Extension::ResourceTables);
+        }
+
+        // The limit is at least 128 in Vulkan, so this is only a sanity check.
+        if (mDeviceInfo.properties.limits.maxPushConstantsSize >= kMaxPushConstantSize) {
+            mSupportedExtensions.EnableExtension(Extension::PushConstants);
+        }
+
+        // The binds are enqueued on the universal queue, which is the first queue family with
+        // graphics and compute, and the standard block shapes are the tile extents of Dawn.
+        const VkPhysicalDeviceFeatures& features = mDeviceInfo.features;
+        if (features.sparseBinding == VK_TRUE && features.sparseResidencyBuffer == VK_TRUE &&
+            features.sparseResidencyImage2D == VK_TRUE &&
+            mDeviceInfo.properties.sparseProperties.residencyStandard2DBlockShape == VK_TRUE) {
+            constexpr uint32_t kUniversalFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+            for (const VkQueueFamilyProperties& family : mDeviceInfo.queueFamilies) {
+                if ((family.queueFlags & kUniversalFlags) == kUniversalFlags) {
+                    if (family.queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) {
+                        mSupportedExtensions.EnableExtension(Extension::SparseResources);
+                    }
+                    break;
+                }
+            }
+        }
     }
 
     ResultOrError<DeviceBase*> Adapter::CreateDeviceImpl(const DeviceDescriptor* descriptor) {
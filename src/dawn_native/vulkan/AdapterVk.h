@@ -29,6 +29,8 @@ namespace dawn_native { namespace vulkan {
         Adapter(Backend* backend, VkPhysicalDevice physicalDevice);
         virtual ~Adapter() = default;
 
+        // Only the properties are valid until the details of the adapter are initialized, which
+        // is always the case once a device is created.
         const VulkanDeviceInfo& GetDeviceInfo() const;
         VkPhysicalDevice GetPhysicalDevice() const;
         Backend* GetBackend() const;
@@ -37,6 +39,7 @@ namespace dawn_native { namespace vulkan {
 
       private:
         ResultOrError<DeviceBase*> CreateDeviceImpl(const DeviceDescriptor* descriptor) override;
+        MaybeError InitializeDetailsImpl() override;
         void InitializeSupportedExtensions();
 
         VkPhysicalDevice mPhysicalDevice;
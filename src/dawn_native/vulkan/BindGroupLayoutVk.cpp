@@ -22,10 +22,19 @@
 #include "dawn_native/vulkan/VulkanError.h"
 #include "dawn_native/vulkan/UtilsVulkan.h"
 
+#include <algorithm>
 #include <map>
 
 namespace dawn_native { namespace vulkan {
 
+    namespace {
+
+        // Bounds the size of the pools so that layouts with few bind groups don't reserve too
+        // much descriptor memory.
+        constexpr uint32_t kMaxDescriptorsPerPool = 512;
+
+    }  // anonymous namespace
+
     VkDescriptorType VulkanDescriptorType(wgpu::BindingType type, bool isDynamic) {
         switch (type) {
             case wgpu::BindingType::UniformBuffer:
@@ -73,25 +82,65 @@ namespace dawn_native { namespace vulkan {
             binding->binding = bindingIndex;
             binding->descriptorType =
                 VulkanDescriptorType(info.types[bindingIndex], info.hasDynamicOffset[bindingIndex]);
-            binding->descriptorCount = 1;
+            binding->descriptorCount = IsResourceTableLayout() ? GetResourceTableCapacity() : 1;
             binding->stageFlags = ToVulkanShaderStageFlags(info.visibilities[bindingIndex]);
             binding->pImmutableSamplers = nullptr;
 
             numBindings++;
         }
 
+        Device* device = ToBackend(GetDevice());
+        mIsPushDescriptorSetLayout =
+            UsesPushDescriptors() && device->GetDeviceInfo().pushDescriptor;
+
         VkDescriptorSetLayoutCreateInfo createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         createInfo.pNext = nullptr;
         createInfo.flags = 0;
+        if (mIsPushDescriptorSetLayout) {
+            createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
         createInfo.bindingCount = numBindings;
         createInfo.pBindings = bindings.data();
 
-        Device* device = ToBackend(GetDevice());
+        // The slots of resource tables are written while their descriptor sets are bound, and
+        // the empty slots are never written.
+        VkDescriptorBindingFlagsEXT tableBindingFlags =
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlags;
+        if (IsResourceTableLayout()) {
+            ASSERT(numBindings == 1);
+            bindingFlags.sType =
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+            bindingFlags.pNext = nullptr;
+            bindingFlags.bindingCount = 1;
+            bindingFlags.pBindingFlags = &tableBindingFlags;
+
+            createInfo.pNext = &bindingFlags;
+            createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        }
+
         DAWN_TRY(CheckVkSuccess(device->fn.CreateDescriptorSetLayout(
                                     device->GetVkDevice(), &createInfo, nullptr, &*mHandle),
                                 "CreateDescriptorSetLayout"));
 
+        // Resource tables allocate their own descriptor sets, see ResourceTableVk.
+        if (IsResourceTableLayout()) {
+            return {};
+        }
+
+        // Push descriptor set layouts don't allocate descriptor sets so they don't need an update
+        // template nor pool sizes.
+        if (mIsPushDescriptorSetLayout) {
+            return {};
+        }
+
+        if (device->GetDeviceInfo().descriptorUpdateTemplate) {
+            DAWN_TRY(CreateUpdateTemplate());
+        }
+
         // Compute the size of descriptor pools used for this layout.
         std::map<VkDescriptorType, uint32_t> descriptorCountPerType;
 
@@ -103,14 +152,66 @@ namespace dawn_native { namespace vulkan {
             descriptorCountPerType[vulkanType]++;
         }
 
+        mSetsPerPool = kMaxDescriptorsPerPool;
+        for (const auto& it : descriptorCountPerType) {
+            mSetsPerPool = std::min(mSetsPerPool, kMaxDescriptorsPerPool / it.second);
+        }
+        ASSERT(mSetsPerPool > 0);
+
         mPoolSizes.reserve(descriptorCountPerType.size());
         for (const auto& it : descriptorCountPerType) {
-            mPoolSizes.push_back(VkDescriptorPoolSize{it.first, it.second});
+            mPoolSizes.push_back(VkDescriptorPoolSize{it.first, it.second * mSetsPerPool});
         }
 
         return {};
     }
 
+    MaybeError BindGroupLayout::CreateUpdateTemplate() {
+        const LayoutBindingInfo& info = GetBindingInfo();
+
+        // One entry per binding, reading the DescriptorUpdateData packed at the same position.
+        uint32_t numEntries = 0;
+        std::array<VkDescriptorUpdateTemplateEntry, kMaxBindingsPerGroup> entries;
+        for (uint32_t bindingIndex : IterateBitSet(info.mask)) {
+            if (info.types[bindingIndex] == wgpu::BindingType::AccelerationContainer) {
+                continue;
+            }
+
+            VkDescriptorUpdateTemplateEntry* entry = &entries[numEntries];
+            entry->dstBinding = bindingIndex;
+            entry->dstArrayElement = 0;
+            entry->descriptorCount = 1;
+            entry->descriptorType =
+                VulkanDescriptorType(info.types[bindingIndex], info.hasDynamicOffset[bindingIndex]);
+            entry->offset = numEntries * sizeof(DescriptorUpdateData);
+            entry->stride = sizeof(DescriptorUpdateData);
+
+            numEntries++;
+        }
+
+        if (numEntries == 0) {
+            return {};
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.descriptorUpdateEntryCount = numEntries;
+        createInfo.pDescriptorUpdateEntries = entries.data();
+        createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        createInfo.descriptorSetLayout = mHandle;
+        // The pipeline fields are only used by push descriptor templates.
+        createInfo.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        createInfo.pipelineLayout = VK_NULL_HANDLE;
+        createInfo.set = 0;
+
+        Device* device = ToBackend(GetDevice());
+        return CheckVkSuccess(device->fn.CreateDescriptorUpdateTemplateKHR(
+                                  device->GetVkDevice(), &createInfo, nullptr, &*mUpdateTemplate),
+                              "CreateDescriptorUpdateTemplate");
+    }
+
     BindGroupLayout::BindGroupLayout(DeviceBase* device,
                                      const BindGroupLayoutDescriptor* descriptor)
         : BindGroupLayoutBase(device, descriptor),
@@ -120,29 +221,47 @@ namespace dawn_native { namespace vulkan {
     BindGroupLayout::~BindGroupLayout() {
         Device* device = ToBackend(GetDevice());
 
-        // DescriptorSetLayout aren't used by execution on the GPU and can be deleted at any time,
-        // so we destroy mHandle immediately instead of using the FencedDeleter
+        // DescriptorSetLayout and DescriptorUpdateTemplates aren't used by execution on the GPU and
+        // can be deleted at any time, so we destroy them immediately instead of using the
+        // FencedDeleter
         if (mHandle != VK_NULL_HANDLE) {
             device->fn.DestroyDescriptorSetLayout(device->GetVkDevice(), mHandle, nullptr);
             mHandle = VK_NULL_HANDLE;
         }
+        if (mUpdateTemplate != VK_NULL_HANDLE) {
+            device->fn.DestroyDescriptorUpdateTemplateKHR(device->GetVkDevice(), mUpdateTemplate,
+                                                          nullptr);
+            mUpdateTemplate = VK_NULL_HANDLE;
+        }
 
         FencedDeleter* deleter = device->GetFencedDeleter();
-        for (const SingleDescriptorSetAllocation& allocation : mAllocations) {
-            deleter->DeleteWhenUnused(allocation.pool);
+        for (VkDescriptorPool pool : mPools) {
+            deleter->DeleteWhenUnused(pool);
         }
-        mAllocations.clear();
+        device->DidDestroyDescriptorPools(mPools.size());
+        mPools.clear();
+        mSets.clear();
     }
 
     VkDescriptorSetLayout BindGroupLayout::GetHandle() const {
         return mHandle;
     }
 
+    VkDescriptorUpdateTemplate BindGroupLayout::GetUpdateTemplate() const {
+        return mUpdateTemplate;
+    }
+
+    bool BindGroupLayout::IsPushDescriptorSetLayout() const {
+        return mIsPushDescriptorSetLayout;
+    }
+
     ResultOrError<BindGroup*> BindGroupLayout::AllocateBindGroup(
         Device* device,
         const BindGroupDescriptor* descriptor) {
         DescriptorSetAllocation descriptorSetAllocation;
-        DAWN_TRY_ASSIGN(descriptorSetAllocation, AllocateOneDescriptorSet());
+        if (!mIsPushDescriptorSetLayout) {
+            DAWN_TRY_ASSIGN(descriptorSetAllocation, AllocateOneDescriptorSet());
+        }
         return mBindGroupAllocator.Allocate(device, descriptor, descriptorSetAllocation);
     }
 
@@ -151,23 +270,24 @@ namespace dawn_native { namespace vulkan {
     }
 
     ResultOrError<DescriptorSetAllocation> BindGroupLayout::AllocateOneDescriptorSet() {
-        Device* device = ToBackend(GetDevice());
-
-        // Reuse a previous allocation if available.
-        if (!mAvailableAllocations.empty()) {
-            size_t index = mAvailableAllocations.back();
-            mAvailableAllocations.pop_back();
-            return {{index, mAllocations[index].set}};
+        // Create a new pool of descriptor sets when all the previous ones are in use.
+        if (mAvailableAllocations.empty()) {
+            DAWN_TRY(AllocateDescriptorPool());
         }
 
-        // Create a pool to hold our descriptor set.
-        // TODO(cwallez@chromium.org): This horribly inefficient, have more than one descriptor
-        // set per pool.
+        size_t index = mAvailableAllocations.back();
+        mAvailableAllocations.pop_back();
+        return {{index, mSets[index]}};
+    }
+
+    MaybeError BindGroupLayout::AllocateDescriptorPool() {
+        Device* device = ToBackend(GetDevice());
+
         VkDescriptorPoolCreateInfo createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         createInfo.pNext = nullptr;
         createInfo.flags = 0;
-        createInfo.maxSets = 1;
+        createInfo.maxSets = mSetsPerPool;
         createInfo.poolSizeCount = static_cast<uint32_t>(mPoolSizes.size());
         createInfo.pPoolSizes = mPoolSizes.data();
 
@@ -176,28 +296,38 @@ namespace dawn_native { namespace vulkan {
                                                                 nullptr, &*descriptorPool),
                                 "CreateDescriptorPool"));
 
-        // Allocate our single set.
+        // Allocate all the sets of the pool at once.
+        std::vector<VkDescriptorSetLayout> layouts(mSetsPerPool, mHandle);
+
         VkDescriptorSetAllocateInfo allocateInfo;
         allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocateInfo.pNext = nullptr;
         allocateInfo.descriptorPool = descriptorPool;
-        allocateInfo.descriptorSetCount = 1;
-        allocateInfo.pSetLayouts = &*mHandle;
+        allocateInfo.descriptorSetCount = mSetsPerPool;
+        allocateInfo.pSetLayouts = AsVkArray(layouts.data());
 
-        VkDescriptorSet descriptorSet;
+        size_t firstIndex = mSets.size();
+        mSets.resize(firstIndex + mSetsPerPool);
         MaybeError result =
             CheckVkSuccess(device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo,
-                                                             &*descriptorSet),
+                                                             AsVkArray(&mSets[firstIndex])),
                            "AllocateDescriptorSets");
 
         if (result.IsError()) {
             // On an error we can destroy the pool immediately because no command references it.
             device->fn.DestroyDescriptorPool(device->GetVkDevice(), descriptorPool, nullptr);
+            mSets.resize(firstIndex);
             return result.AcquireError();
         }
 
-        mAllocations.push_back({descriptorPool, descriptorSet});
-        return {{mAllocations.size() - 1, descriptorSet}};
+        mPools.push_back(descriptorPool);
+        device->DidCreateDescriptorPool();
+
+        // Push the sets in reverse so that they are handed out in the order they were allocated.
+        for (size_t i = mSets.size(); i > firstIndex; --i) {
+            mAvailableAllocations.push_back(i - 1);
+        }
+        return {};
     }
 
     void BindGroupLayout::DeallocateDescriptorSet(
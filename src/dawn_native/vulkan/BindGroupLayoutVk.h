@@ -29,6 +29,14 @@ namespace dawn_native { namespace vulkan {
 
     VkDescriptorType VulkanDescriptorType(wgpu::BindingType type, bool isDynamic);
 
+    // The data for one binding of the packed array given to vkUpdateDescriptorSetWithTemplate.
+    // Bindings are packed in the order of their binding index, skipping acceleration containers
+    // that are always written with vkUpdateDescriptorSets.
+    union DescriptorUpdateData {
+        VkDescriptorBufferInfo buffer;
+        VkDescriptorImageInfo image;
+    };
+
     // Contains a descriptor set along with data necessary to track its allocation.
     struct DescriptorSetAllocation {
         size_t index = 0;
@@ -43,10 +51,11 @@ namespace dawn_native { namespace vulkan {
     // VkDescriptorSets for its bindgroups, the layout also acts as an allocator for the descriptor
     // sets.
     //
-    // The allocations is done with one pool per descriptor set, which is inefficient, but at least
-    // the pools are reused when no longer used. Minimizing the number of descriptor pool allocation
-    // is important because creating them can incur GPU memory allocation which is usually an
-    // expensive syscall.
+    // The allocations are done from pools which each hold up to kMaxDescriptorsPerPool descriptors
+    // and all their descriptor sets are allocated when the pool is created. Sets are never freed
+    // back to their pool, instead they are reused once the DescriptorSetService says they are no
+    // longer used. Minimizing the number of descriptor pool allocation is important because
+    // creating them can incur GPU memory allocation which is usually an expensive syscall.
     class BindGroupLayout : public BindGroupLayoutBase {
       public:
         static ResultOrError<BindGroupLayout*> Create(Device* device,
@@ -57,6 +66,14 @@ namespace dawn_native { namespace vulkan {
 
         VkDescriptorSetLayout GetHandle() const;
 
+        // Returns VK_NULL_HANDLE when descriptor update templates aren't supported or when the
+        // layout has no binding they can write.
+        VkDescriptorUpdateTemplate GetUpdateTemplate() const;
+
+        // Bind groups of push descriptor set layouts don't have a VkDescriptorSet, their
+        // descriptors are pushed in the command buffer instead when they are set.
+        bool IsPushDescriptorSetLayout() const;
+
         ResultOrError<BindGroup*> AllocateBindGroup(Device* device,
                                                     const BindGroupDescriptor* descriptor);
         void DeallocateBindGroup(BindGroup* bindGroup);
@@ -70,17 +87,22 @@ namespace dawn_native { namespace vulkan {
       private:
         MaybeError Initialize();
 
+        MaybeError AllocateDescriptorPool();
+        MaybeError CreateUpdateTemplate();
+
+        // The sizes of a pool of mSetsPerPool descriptor sets.
         std::vector<VkDescriptorPoolSize> mPoolSizes;
+        uint32_t mSetsPerPool = 0;
 
-        struct SingleDescriptorSetAllocation {
-            VkDescriptorPool pool = VK_NULL_HANDLE;
-            // Descriptor sets are freed when the pool is destroyed.
-            VkDescriptorSet set = VK_NULL_HANDLE;
-        };
-        std::vector<SingleDescriptorSetAllocation> mAllocations;
+        // Descriptor sets are freed when their pool is destroyed. The index of an allocation is
+        // the index of its set in mSets.
+        std::vector<VkDescriptorPool> mPools;
+        std::vector<VkDescriptorSet> mSets;
         std::vector<size_t> mAvailableAllocations;
 
         VkDescriptorSetLayout mHandle = VK_NULL_HANDLE;
+        VkDescriptorUpdateTemplate mUpdateTemplate = VK_NULL_HANDLE;
+        bool mIsPushDescriptorSetLayout = false;
 
         SlabAllocator<BindGroup> mBindGroupAllocator;
     };
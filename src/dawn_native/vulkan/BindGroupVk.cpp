@@ -32,23 +32,69 @@ namespace dawn_native { namespace vulkan {
         return ToBackend(descriptor->layout)->AllocateBindGroup(device, descriptor);
     }
 
+    // The data of all the bindings of a bind group, gathered on the stack. The update data is
+    // either written all at once by the update template of the layout, or chained in one write per
+    // binding. The acceleration containers always use a write.
+    struct DescriptorWrites {
+        uint32_t numUpdates = 0;
+        std::array<DescriptorUpdateData, kMaxBindingsPerGroup> updateData;
+        uint32_t numWrites = 0;
+        std::array<VkWriteDescriptorSet, kMaxBindingsPerGroup> writes;
+        std::array<VkWriteDescriptorSetAccelerationStructureNV, kMaxBindingsPerGroup>
+            accelerationInfo;
+    };
+
     BindGroup::BindGroup(Device* device,
                          const BindGroupDescriptor* descriptor,
                          DescriptorSetAllocation descriptorSetAllocation)
         : BindGroupBase(this, device, descriptor),
           mDescriptorSetAllocation(descriptorSetAllocation) {
-        // Now do a write of a single descriptor set with all possible chained data allocated on the
-        // stack.
-        uint32_t numWrites = 0;
-        std::array<VkWriteDescriptorSet, kMaxBindingsPerGroup> writes;
-        std::array<VkDescriptorBufferInfo, kMaxBindingsPerGroup> writeBufferInfo;
-        std::array<VkDescriptorImageInfo, kMaxBindingsPerGroup> writeImageInfo;
-        std::array<VkWriteDescriptorSetAccelerationStructureNV, kMaxBindingsPerGroup>
-            writeAccelerationInfo;
+        // The descriptors of push descriptor set layouts are written each time they are set.
+        if (ToBackend(GetLayout())->IsPushDescriptorSetLayout()) {
+            return;
+        }
+
+        VkDescriptorUpdateTemplate updateTemplate = ToBackend(GetLayout())->GetUpdateTemplate();
 
+        DescriptorWrites writes;
+        GatherDescriptorWrites(updateTemplate != VK_NULL_HANDLE, &writes);
+
+        if (updateTemplate != VK_NULL_HANDLE) {
+            device->fn.UpdateDescriptorSetWithTemplateKHR(device->GetVkDevice(), GetHandle(),
+                                                          updateTemplate, writes.updateData.data());
+        }
+        if (writes.numWrites > 0) {
+            device->fn.UpdateDescriptorSets(device->GetVkDevice(), writes.numWrites,
+                                            writes.writes.data(), 0, nullptr);
+        }
+    }
+
+    void BindGroup::PushDescriptorSet(Device* device,
+                                      VkCommandBuffer commands,
+                                      VkPipelineBindPoint bindPoint,
+                                      VkPipelineLayout pipelineLayout,
+                                      uint32_t setIndex) {
+        ASSERT(ToBackend(GetLayout())->IsPushDescriptorSetLayout());
+
+        DescriptorWrites writes;
+        GatherDescriptorWrites(false, &writes);
+
+        device->fn.CmdPushDescriptorSetKHR(commands, bindPoint, pipelineLayout, setIndex,
+                                           writes.numWrites, writes.writes.data());
+    }
+
+    void BindGroup::GatherDescriptorWrites(bool withUpdateTemplate, DescriptorWrites* writes) {
         const auto& layoutInfo = GetLayout()->GetBindingInfo();
         for (uint32_t bindingIndex : IterateBitSet(layoutInfo.mask)) {
-            auto& write = writes[numWrites];
+            bool isAccelerationContainer =
+                layoutInfo.types[bindingIndex] == wgpu::BindingType::AccelerationContainer;
+            if (withUpdateTemplate && !isAccelerationContainer) {
+                WriteDescriptorUpdateData(bindingIndex, &writes->updateData[writes->numUpdates]);
+                writes->numUpdates++;
+                continue;
+            }
+
+            auto& write = writes->writes[writes->numWrites];
             write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             write.pNext = nullptr;
             write.dstSet = GetHandle();
@@ -58,64 +104,67 @@ namespace dawn_native { namespace vulkan {
             write.descriptorType = VulkanDescriptorType(layoutInfo.types[bindingIndex],
                                                         layoutInfo.hasDynamicOffset[bindingIndex]);
 
-            switch (layoutInfo.types[bindingIndex]) {
-                case wgpu::BindingType::UniformBuffer:
-                case wgpu::BindingType::StorageBuffer:
-                case wgpu::BindingType::ReadonlyStorageBuffer: {
-                    BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
-
-                    writeBufferInfo[numWrites].buffer = ToBackend(binding.buffer)->GetHandle();
-                    writeBufferInfo[numWrites].offset = binding.offset;
-                    writeBufferInfo[numWrites].range = binding.size;
-                    write.pBufferInfo = &writeBufferInfo[numWrites];
-                } break;
-
-                case wgpu::BindingType::Sampler: {
-                    Sampler* sampler = ToBackend(GetBindingAsSampler(bindingIndex));
-                    writeImageInfo[numWrites].sampler = sampler->GetHandle();
-                    write.pImageInfo = &writeImageInfo[numWrites];
-                } break;
-
-                case wgpu::BindingType::AccelerationContainer: {
-                    RayTracingAccelerationContainer* container =
-                        ToBackend(GetBindingAsRayTracingAccelerationContainer(bindingIndex));
-                    VkAccelerationStructureNV instance = container->GetAccelerationStructure();
-
-                    writeAccelerationInfo[numWrites].pNext = nullptr;
-                    writeAccelerationInfo[numWrites].sType =
-                        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_NV;
-                    writeAccelerationInfo[numWrites].accelerationStructureCount = 1;
-                    writeAccelerationInfo[numWrites].pAccelerationStructures = &*instance;
-
-                    write.pNext = &writeAccelerationInfo[numWrites];
-                } break;
-
-                case wgpu::BindingType::SampledTexture: {
-                    TextureView* view = ToBackend(GetBindingAsTextureView(bindingIndex));
-
-                    writeImageInfo[numWrites].imageView = view->GetHandle();
-                    // TODO(cwallez@chromium.org): This isn't true in general: if the image has
-                    // two read-only usages one of which is Sampled. Works for now though :)
-                    writeImageInfo[numWrites].imageLayout =
-                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-                    write.pImageInfo = &writeImageInfo[numWrites];
-                } break;
-
-                default:
-                    UNREACHABLE();
+            if (isAccelerationContainer) {
+                RayTracingAccelerationContainer* container =
+                    ToBackend(GetBindingAsRayTracingAccelerationContainer(bindingIndex));
+                VkAccelerationStructureNV instance = container->GetAccelerationStructure();
+
+                auto& accelerationInfo = writes->accelerationInfo[writes->numWrites];
+                accelerationInfo.pNext = nullptr;
+                accelerationInfo.sType =
+                    VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_NV;
+                accelerationInfo.accelerationStructureCount = 1;
+                accelerationInfo.pAccelerationStructures = &*instance;
+
+                write.pNext = &accelerationInfo;
+            } else {
+                DescriptorUpdateData* data = &writes->updateData[writes->numUpdates];
+                WriteDescriptorUpdateData(bindingIndex, data);
+                writes->numUpdates++;
+
+                write.pBufferInfo = &data->buffer;
+                write.pImageInfo = &data->image;
             }
 
-            numWrites++;
+            writes->numWrites++;
         }
+    }
 
-        // TODO(cwallez@chromium.org): Batch these updates
-        device->fn.UpdateDescriptorSets(device->GetVkDevice(), numWrites, writes.data(), 0,
-                                        nullptr);
+    void BindGroup::WriteDescriptorUpdateData(uint32_t bindingIndex, DescriptorUpdateData* data) {
+        switch (GetLayout()->GetBindingInfo().types[bindingIndex]) {
+            case wgpu::BindingType::UniformBuffer:
+            case wgpu::BindingType::StorageBuffer:
+            case wgpu::BindingType::ReadonlyStorageBuffer: {
+                BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
+
+                data->buffer.buffer = ToBackend(binding.buffer)->GetHandle();
+                data->buffer.offset = binding.offset;
+                data->buffer.range = binding.size;
+            } break;
+
+            case wgpu::BindingType::Sampler: {
+                Sampler* sampler = ToBackend(GetBindingAsSampler(bindingIndex));
+                data->image.sampler = sampler->GetHandle();
+            } break;
+
+            case wgpu::BindingType::SampledTexture: {
+                TextureView* view = ToBackend(GetBindingAsTextureView(bindingIndex));
+
+                data->image.imageView = view->GetHandle();
+                // TODO(cwallez@chromium.org): This isn't true in general: if the image has
+                // two read-only usages one of which is Sampled. Works for now though :)
+                data->image.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            } break;
+
+            default:
+                UNREACHABLE();
+        }
     }
 
     BindGroup::~BindGroup() {
-        ToBackend(GetLayout())->DeallocateDescriptorSet(&mDescriptorSetAllocation);
+        if (!ToBackend(GetLayout())->IsPushDescriptorSetLayout()) {
+            ToBackend(GetLayout())->DeallocateDescriptorSet(&mDescriptorSetAllocation);
+        }
         ToBackend(GetLayout())->DeallocateBindGroup(this);
     }
 
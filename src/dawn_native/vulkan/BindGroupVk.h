@@ -24,6 +24,7 @@
 namespace dawn_native { namespace vulkan {
 
     class Device;
+    struct DescriptorWrites;
 
     class BindGroup : public BindGroupBase, public PlacementAllocated {
       public:
@@ -37,7 +38,18 @@ namespace dawn_native { namespace vulkan {
 
         VkDescriptorSet GetHandle() const;
 
+        // Records the descriptors of a bind group of a push descriptor set layout at setIndex.
+        void PushDescriptorSet(Device* device,
+                               VkCommandBuffer commands,
+                               VkPipelineBindPoint bindPoint,
+                               VkPipelineLayout pipelineLayout,
+                               uint32_t setIndex);
+
       private:
+        void GatherDescriptorWrites(bool withUpdateTemplate, DescriptorWrites* writes);
+        // Fills the buffer or image info used to write the descriptor of the binding.
+        void WriteDescriptorUpdateData(uint32_t bindingIndex, DescriptorUpdateData* data);
+
         // The descriptor set in this allocation outlives the BindGroup because it is owned by
         // the BindGroupLayout which is referenced by the BindGroup.
         DescriptorSetAllocation mDescriptorSetAllocation;
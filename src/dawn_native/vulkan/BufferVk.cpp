@@ -14,10 +14,12 @@
 
 #include "dawn_native/vulkan/BufferVk.h"
 
+#include "common/Constants.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
 #include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
+#include "dawn_native/vulkan/SparseTileMemory.h"
 #include "dawn_native/vulkan/VulkanError.h"
 
 #include <cstring>
@@ -32,7 +34,7 @@ namespace dawn_native { namespace vulkan {
             if (usage & wgpu::BufferUsage::CopySrc) {
                 flags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
             }
-            if (usage & wgpu::BufferUsage::CopyDst) {
+            if (usage & (wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::QueryResolve)) {
                 flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
             }
             if (usage & wgpu::BufferUsage::Index) {
@@ -44,7 +46,7 @@ namespace dawn_native { namespace vulkan {
             if (usage & wgpu::BufferUsage::Uniform) {
                 flags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
             }
-            if (usage & wgpu::BufferUsage::Storage) {
+            if (usage & (wgpu::BufferUsage::Storage | kReadOnlyStorage)) {
                 flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
             }
             if (usage & wgpu::BufferUsage::Indirect) {
@@ -53,17 +55,22 @@ namespace dawn_native { namespace vulkan {
             if (usage & wgpu::BufferUsage::RayTracing) {
                 flags |= VK_BUFFER_USAGE_RAY_TRACING_BIT_NV;
             }
+            if (usage & wgpu::BufferUsage::Predicate) {
+                flags |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+            }
 
             return flags;
         }
 
-        VkPipelineStageFlags VulkanPipelineStage(wgpu::BufferUsage usage) {
+        VkPipelineStageFlags VulkanPipelineStage(wgpu::BufferUsage usage,
+                                                 VkPipelineStageFlags shaderStages) {
             VkPipelineStageFlags flags = 0;
 
             if (usage & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) {
                 flags |= VK_PIPELINE_STAGE_HOST_BIT;
             }
-            if (usage & (wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst)) {
+            if (usage & (wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst |
+                         wgpu::BufferUsage::QueryResolve)) {
                 flags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
             }
             if (usage & (wgpu::BufferUsage::Index | wgpu::BufferUsage::Vertex)) {
@@ -71,14 +78,17 @@ namespace dawn_native { namespace vulkan {
             }
             if (usage &
                 (wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Storage | kReadOnlyStorage)) {
-                flags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
-                         VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV;
+                flags |= shaderStages;
             }
             if (usage & wgpu::BufferUsage::Indirect) {
                 flags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
             }
+            if (usage & wgpu::BufferUsage::RayTracing) {
+                flags |= VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV;
+            }
+            if (usage & wgpu::BufferUsage::Predicate) {
+                flags |= VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT;
+            }
 
             return flags;
         }
@@ -95,7 +105,7 @@ namespace dawn_native { namespace vulkan {
             if (usage & wgpu::BufferUsage::CopySrc) {
                 flags |= VK_ACCESS_TRANSFER_READ_BIT;
             }
-            if (usage & wgpu::BufferUsage::CopyDst) {
+            if (usage & (wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::QueryResolve)) {
                 flags |= VK_ACCESS_TRANSFER_WRITE_BIT;
             }
             if (usage & wgpu::BufferUsage::Index) {
@@ -110,15 +120,38 @@ namespace dawn_native { namespace vulkan {
             if (usage & wgpu::BufferUsage::Storage) {
                 flags |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
             }
+            if (usage & kReadOnlyStorage) {
+                flags |= VK_ACCESS_SHADER_READ_BIT;
+            }
             if (usage & wgpu::BufferUsage::Indirect) {
                 flags |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
             }
+            if (usage & wgpu::BufferUsage::RayTracing) {
+                flags |= VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV | VK_ACCESS_SHADER_READ_BIT;
+            }
+            if (usage & wgpu::BufferUsage::Predicate) {
+                flags |= VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+            }
 
             return flags;
         }
 
     }  // namespace
 
+    MaybeError ValidateVulkanBufferCanBeWrapped(const DeviceBase*,
+                                                const BufferDescriptor* descriptor) {
+        // The external memory isn't necessarily host visible.
+        if (descriptor->usage & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) {
+            return DAWN_VALIDATION_ERROR("Wrapped buffers can't be mappable");
+        }
+
+        if (descriptor->usage & wgpu::BufferUsage::Transient) {
+            return DAWN_VALIDATION_ERROR("Wrapped buffers can't be transient");
+        }
+
+        return {};
+    }
+
     // static
     ResultOrError<Buffer*> Buffer::Create(Device* device, const BufferDescriptor* descriptor) {
         std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>(device, descriptor);
@@ -126,6 +159,17 @@ namespace dawn_native { namespace vulkan {
         return buffer.release();
     }
 
+    // static
+    ResultOrError<Buffer*> Buffer::CreateFromExternal(
+        Device* device,
+        const BufferDescriptor* descriptor,
+        const ExternalBufferDescriptor* externalDescriptor,
+        external_memory::Service* externalMemoryService) {
+        std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>(device, descriptor);
+        DAWN_TRY(buffer->InitializeFromExternal(externalDescriptor, externalMemoryService));
+        return buffer.release();
+    }
+
     MaybeError Buffer::Initialize() {
         // Avoid passing ludicrously large sizes to drivers because it causes issues: drivers add
         // some constants to the size passed and align it, but for values close to the maximum
@@ -148,18 +192,44 @@ namespace dawn_native { namespace vulkan {
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         createInfo.queueFamilyIndexCount = 0;
         createInfo.pQueueFamilyIndices = 0;
+        if (IsSparse()) {
+            createInfo.flags |=
+                VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+        }
 
         Device* device = ToBackend(GetDevice());
         DAWN_TRY(CheckVkSuccess(
             device->fn.CreateBuffer(device->GetVkDevice(), &createInfo, nullptr, &*mHandle),
             "vkCreateBuffer"));
 
-        VkMemoryRequirements requirements;
-        device->fn.GetBufferMemoryRequirements(device->GetVkDevice(), mHandle, &requirements);
+        DedicatedAllocation dedicated;
+        VkMemoryRequirements requirements =
+            device->GetBufferMemoryRequirements(mHandle, &dedicated);
+
+        // The memory of sparse buffers is bound tile by tile with UpdateTileMappings.
+        if (IsSparse()) {
+            if (kSparseTileSize % requirements.alignment != 0) {
+                return DAWN_OUT_OF_MEMORY_ERROR(
+                    "The sparse block size of the buffer is larger than the tile size");
+            }
+            mSparseTiles = std::make_unique<SparseTileMemory>(device, requirements.memoryTypeBits,
+                                                              requirements.alignment);
+            return {};
+        }
 
         bool requestMappable =
             (GetUsage() & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) != 0;
-        DAWN_TRY_ASSIGN(mMemoryAllocation, device->AllocateMemory(requirements, requestMappable));
+        // Buffers written with Queue::WriteBuffer can then be written directly when they are in
+        // host visible memory.
+        bool preferHostVisible = (GetUsage() & wgpu::BufferUsage::CopyDst) != 0;
+        if (IsTransient()) {
+            DAWN_TRY_ASSIGN(mMemoryAllocation, device->AllocateTransientMemory(requirements));
+        } else {
+            DAWN_TRY_ASSIGN(mMemoryAllocation,
+                            device->AllocateMemory(requirements, requestMappable,
+                                                   preferHostVisible, GetResidencyPriority(),
+                                                   &dedicated));
+        }
 
         DAWN_TRY(CheckVkSuccess(
             device->fn.BindBufferMemory(device->GetVkDevice(), mHandle,
@@ -170,6 +240,112 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Buffer::InitializeFromExternal(const ExternalBufferDescriptor* descriptor,
+                                              external_memory::Service* externalMemoryService) {
+        if (GetSize() & (uint64_t(3) << uint64_t(62))) {
+            return DAWN_OUT_OF_MEMORY_ERROR("Buffer size is HUGE and could cause overflows");
+        }
+
+        VkBufferUsageFlags usage = VulkanBufferUsage(GetUsage() | wgpu::BufferUsage::CopyDst);
+        if (!externalMemoryService->SupportsImportBufferMemory(usage)) {
+            return DAWN_VALIDATION_ERROR("Importing buffer memory is not supported");
+        }
+
+        VkBufferCreateInfo baseCreateInfo;
+        baseCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        baseCreateInfo.pNext = nullptr;
+        baseCreateInfo.flags = 0;
+        baseCreateInfo.size = GetSize();
+        baseCreateInfo.usage = usage;
+        baseCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        baseCreateInfo.queueFamilyIndexCount = 0;
+        baseCreateInfo.pQueueFamilyIndices = 0;
+
+        DAWN_TRY_ASSIGN(mHandle, externalMemoryService->CreateBuffer(descriptor, baseCreateInfo));
+        return {};
+    }
+
+    MaybeError Buffer::BindExternalMemory(VkSemaphore signalSemaphore,
+                                          VkDeviceMemory externalMemoryAllocation,
+                                          std::vector<VkSemaphore> waitSemaphores) {
+        Device* device = ToBackend(GetDevice());
+        DAWN_TRY(CheckVkSuccess(device->fn.BindBufferMemory(device->GetVkDevice(), mHandle,
+                                                            externalMemoryAllocation, 0),
+                                "BindBufferMemory (external)"));
+
+        // Success, acquire all the external objects.
+        mExternalAllocation = externalMemoryAllocation;
+        mSignalSemaphore = signalSemaphore;
+
+        // Transfer the buffer from the external queue family to the graphics queue family for
+        // all its usages, after the wait semaphores. CopyDst is always included, like in the
+        // buffer usage flags.
+        wgpu::BufferUsage usage = GetUsage() | wgpu::BufferUsage::CopyDst;
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+        recordingContext->waitSemaphores.insert(recordingContext->waitSemaphores.end(),
+                                                waitSemaphores.begin(), waitSemaphores.end());
+
+        VkBufferMemoryBarrier barrier;
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VulkanAccessFlags(usage);
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_EXTERNAL_KHR;
+        barrier.dstQueueFamilyIndex = device->GetGraphicsQueueFamily();
+        barrier.buffer = mHandle;
+        barrier.offset = 0;
+        barrier.size = GetSize();
+
+        device->fn.CmdPipelineBarrier(recordingContext->commandBuffer,
+                                      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                      VulkanPipelineStage(usage, kAllShaderStages), 0, 0, nullptr,
+                                      1, &barrier, 0, nullptr);
+
+        mLastUsage = usage;
+        mLastShaderStages = kAllShaderStages;
+        mLastUsageSerial = device->GetPendingCommandSerial();
+        return {};
+    }
+
+    MaybeError Buffer::SignalAndDestroy(VkSemaphore* outSignalSemaphore) {
+        if (mExternalAllocation == VK_NULL_HANDLE) {
+            return DAWN_VALIDATION_ERROR(
+                "Can't export signal semaphore from destroyed / non-external buffer");
+        }
+
+        // Release the buffer to the external queue family after its last usage.
+        Device* device = ToBackend(GetDevice());
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+
+        VkBufferMemoryBarrier barrier;
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = VulkanAccessFlags(mLastUsage);
+        barrier.dstAccessMask = 0;
+        barrier.srcQueueFamilyIndex = device->GetGraphicsQueueFamily();
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_EXTERNAL_KHR;
+        barrier.buffer = mHandle;
+        barrier.offset = 0;
+        barrier.size = GetSize();
+
+        device->fn.CmdPipelineBarrier(recordingContext->commandBuffer,
+                                      VulkanPipelineStage(mLastUsage, mLastShaderStages),
+                                      VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1,
+                                      &barrier, 0, nullptr);
+
+        // Queue submit to signal we are done with the buffer
+        recordingContext->signalSemaphores.push_back(mSignalSemaphore);
+        DAWN_TRY(device->SubmitPendingCommands());
+
+        // Write out the signal semaphore
+        *outSignalSemaphore = mSignalSemaphore;
+        mSignalSemaphore = VK_NULL_HANDLE;
+
+        // Destroy the buffer so it can't be used again
+        DestroyInternal();
+        return {};
+    }
+
     Buffer::~Buffer() {
         DestroyInternal();
     }
@@ -192,39 +368,80 @@ namespace dawn_native { namespace vulkan {
 
     void Buffer::TransitionUsageNow(CommandRecordingContext* recordingContext,
                                     wgpu::BufferUsage usage) {
+        VkBufferMemoryBarrier barrier;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+
+        if (TransitionUsageAndGetResourceBarrier(usage, kAllShaderStages, &barrier, &srcStages,
+                                                 &dstStages)) {
+            ASSERT(srcStages != 0 && dstStages != 0);
+            ToBackend(GetDevice())
+                ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
+                                        nullptr, 1, &barrier, 0, nullptr);
+        }
+    }
+
+    bool Buffer::TransitionUsageAndGetResourceBarrier(wgpu::BufferUsage usage,
+                                                      VkPipelineStageFlags shaderStages,
+                                                      VkBufferMemoryBarrier* barrier,
+                                                      VkPipelineStageFlags* srcStages,
+                                                      VkPipelineStageFlags* dstStages) {
+        mLastUsageSerial = GetDevice()->GetPendingCommandSerial();
+
         bool lastIncludesTarget = (mLastUsage & usage) == usage;
         bool lastReadOnly = (mLastUsage & kReadOnlyBufferUsages) == mLastUsage;
 
-        // We can skip transitions to already current read-only usages.
+        // We can skip transitions to already current read-only usages, the next write waits for
+        // the reads of all their stages.
         if (lastIncludesTarget && lastReadOnly) {
-            return;
+            mLastShaderStages |= shaderStages;
+            return false;
         }
 
-        // Special-case for the initial transition: Vulkan doesn't allow access flags to be 0.
+        // Special-case for the initial transition: Vulkan doesn't allow access flags to be 0. The
+        // memory of transient buffers may have been used by other transient resources until they
+        // were destroyed, so their first barrier waits for all the previous commands of the queue
+        // and their writes instead.
+        bool isTransientMemoryDependency = false;
         if (mLastUsage == wgpu::BufferUsage::None) {
-            mLastUsage = usage;
-            return;
+            if (!IsTransient()) {
+                mLastUsage = usage;
+                mLastShaderStages = shaderStages;
+                return false;
+            }
+            isTransientMemoryDependency = true;
         }
 
-        VkPipelineStageFlags srcStages = VulkanPipelineStage(mLastUsage);
-        VkPipelineStageFlags dstStages = VulkanPipelineStage(usage);
+        *srcStages |= isTransientMemoryDependency
+                          ? VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+                          : VulkanPipelineStage(mLastUsage, mLastShaderStages);
+        *dstStages |= VulkanPipelineStage(usage, shaderStages);
+
+        barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier->pNext = nullptr;
+        barrier->srcAccessMask = isTransientMemoryDependency ? VK_ACCESS_MEMORY_WRITE_BIT
+                                                             : VulkanAccessFlags(mLastUsage);
+        barrier->dstAccessMask = VulkanAccessFlags(usage);
+        barrier->srcQueueFamilyIndex = 0;
+        barrier->dstQueueFamilyIndex = 0;
+        barrier->buffer = mHandle;
+        barrier->offset = 0;
+        barrier->size = GetSize();
 
-        VkBufferMemoryBarrier barrier;
-        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-        barrier.pNext = nullptr;
-        barrier.srcAccessMask = VulkanAccessFlags(mLastUsage);
-        barrier.dstAccessMask = VulkanAccessFlags(usage);
-        barrier.srcQueueFamilyIndex = 0;
-        barrier.dstQueueFamilyIndex = 0;
-        barrier.buffer = mHandle;
-        barrier.offset = 0;
-        barrier.size = GetSize();
+        mLastUsage = usage;
+        mLastShaderStages = shaderStages;
+        return true;
+    }
 
-        ToBackend(GetDevice())
-            ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
-                                    nullptr, 1, &barrier, 0, nullptr);
+    bool Buffer::IsHostWritableNow() const {
+        return mMemoryAllocation.GetMappedPointer() != nullptr &&
+               mLastUsageSerial <= GetDevice()->GetCompletedCommandSerial();
+    }
 
-        mLastUsage = usage;
+    void Buffer::WriteFromHost(uint64_t offset, const void* data, uint64_t size) {
+        ASSERT(IsHostWritableNow());
+        ASSERT(offset + size <= GetSize());
+        memcpy(mMemoryAllocation.GetMappedPointer() + offset, data, size);
     }
 
     bool Buffer::IsMapWritable() const {
@@ -248,6 +465,11 @@ namespace dawn_native { namespace vulkan {
 
         MapRequestTracker* tracker = device->GetMapRequestTracker();
         tracker->Track(this, serial, memory, false);
+
+        // Batched submits are flushed so that the request doesn't wait for the next tick.
+        if (device->IsToggleEnabled(Toggle::VulkanBatchQueueSubmits)) {
+            DAWN_TRY(device->SubmitPendingCommands());
+        }
         return {};
     }
 
@@ -262,6 +484,11 @@ namespace dawn_native { namespace vulkan {
 
         MapRequestTracker* tracker = device->GetMapRequestTracker();
         tracker->Track(this, serial, memory, true);
+
+        // Batched submits are flushed so that the request doesn't wait for the next tick.
+        if (device->IsToggleEnabled(Toggle::VulkanBatchQueueSubmits)) {
+            DAWN_TRY(device->SubmitPendingCommands());
+        }
         return {};
     }
 
@@ -269,13 +496,77 @@ namespace dawn_native { namespace vulkan {
         // No need to do anything, we keep CPU-visible memory mapped at all time.
     }
 
+    MaybeError Buffer::UpdateTileMappings(uint64_t firstTile, uint64_t tileCount, bool resident) {
+        ASSERT(mSparseTiles != nullptr);
+
+        std::vector<VkSparseMemoryBind> binds;
+        for (uint64_t tile = firstTile; tile < firstTile + tileCount; ++tile) {
+            if (mSparseTiles->IsResident(tile) == resident) {
+                continue;
+            }
+
+            VkSparseMemoryBind bind;
+            bind.resourceOffset = tile * kSparseTileSize;
+            bind.size = kSparseTileSize;
+            bind.memory = VK_NULL_HANDLE;
+            bind.memoryOffset = 0;
+            bind.flags = 0;
+
+            if (resident) {
+                ResultOrError<ResourceMemoryAllocation> allocation = mSparseTiles->Allocate(tile);
+                if (allocation.IsError()) {
+                    mSparseTiles->Rollback();
+                    return allocation.AcquireError();
+                }
+                ResourceMemoryAllocation tileMemory = allocation.AcquireSuccess();
+                bind.memory = ToBackend(tileMemory.GetResourceHeap())->GetMemory();
+                bind.memoryOffset = tileMemory.GetOffset();
+            } else {
+                mSparseTiles->Release(tile);
+            }
+            binds.push_back(bind);
+        }
+
+        if (binds.empty()) {
+            return {};
+        }
+
+        VkSparseBufferMemoryBindInfo bufferBind;
+        bufferBind.buffer = mHandle;
+        bufferBind.bindCount = static_cast<uint32_t>(binds.size());
+        bufferBind.pBinds = binds.data();
+
+        VkBindSparseInfo bindInfo = {};
+        bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+        bindInfo.bufferBindCount = 1;
+        bindInfo.pBufferBinds = &bufferBind;
+
+        MaybeError result = ToBackend(GetDevice())->BindSparse(&bindInfo);
+        if (result.IsError()) {
+            mSparseTiles->Rollback();
+            return result;
+        }
+        mSparseTiles->Commit();
+        return {};
+    }
+
     void Buffer::DestroyImpl() {
         ToBackend(GetDevice())->DeallocateMemory(&mMemoryAllocation);
+        if (mSparseTiles != nullptr) {
+            mSparseTiles->ReleaseAll();
+        }
 
         if (mHandle != VK_NULL_HANDLE) {
             ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
+
+        if (mExternalAllocation != VK_NULL_HANDLE) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mExternalAllocation);
+            mExternalAllocation = VK_NULL_HANDLE;
+        }
+        // If a signal semaphore exists it should be requested before we delete the buffer
+        ASSERT(mSignalSemaphore == VK_NULL_HANDLE);
     }
 
     // MapRequestTracker
@@ -20,15 +20,38 @@
 #include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 #include "dawn_native/ResourceMemoryAllocation.h"
+#include "dawn_native/vulkan/external_memory/MemoryService.h"
+
+#include <memory>
+#include <vector>
 
 namespace dawn_native { namespace vulkan {
 
     struct CommandRecordingContext;
     class Device;
+    class SparseTileMemory;
+
+    // The stages shaders can access bound buffers and textures from. The barriers of a pass only
+    // wait on and block the shader stages of the kind of pass, the other barriers use all of them.
+    static constexpr VkPipelineStageFlags kAllShaderStages =
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV;
+
+    MaybeError ValidateVulkanBufferCanBeWrapped(const DeviceBase* device,
+                                                const BufferDescriptor* descriptor);
 
     class Buffer : public BufferBase {
       public:
         static ResultOrError<Buffer*> Create(Device* device, const BufferDescriptor* descriptor);
+
+        // Creates a buffer aliasing external memory. The memory must be bound with
+        // Buffer::BindExternalMemory.
+        static ResultOrError<Buffer*> CreateFromExternal(
+            Device* device,
+            const BufferDescriptor* descriptor,
+            const ExternalBufferDescriptor* externalDescriptor,
+            external_memory::Service* externalMemoryService);
+
         ~Buffer();
 
         void OnMapReadCommandSerialFinished(uint32_t mapSerial, const void* data);
@@ -39,12 +62,38 @@ namespace dawn_native { namespace vulkan {
 
         // Transitions the buffer to be used as `usage`, recording any necessary barrier in
         // `commands`.
-        // TODO(cwallez@chromium.org): coalesce barriers and do them early when possible.
         void TransitionUsageNow(CommandRecordingContext* recordingContext, wgpu::BufferUsage usage);
+        // Same as TransitionUsageNow, but returns the barrier instead of recording it so that it
+        // can be batched with others. The stages are or'ed into `srcStages` and `dstStages`.
+        // Shader usages are only for the `shaderStages`.
+        bool TransitionUsageAndGetResourceBarrier(wgpu::BufferUsage usage,
+                                                  VkPipelineStageFlags shaderStages,
+                                                  VkBufferMemoryBarrier* barrier,
+                                                  VkPipelineStageFlags* srcStages,
+                                                  VkPipelineStageFlags* dstStages);
+
+        // Buffers in host visible memory can be written from the CPU without a staging copy
+        // while no recorded commands that haven't completed use them.
+        bool IsHostWritableNow() const;
+        void WriteFromHost(uint64_t offset, const void* data, uint64_t size);
+
+        // Binds the imported memory and acquires the buffer from the external queue family in
+        // the pending commands, whose submit waits on |waitSemaphores|.
+        MaybeError BindExternalMemory(VkSemaphore signalSemaphore,
+                                      VkDeviceMemory externalMemoryAllocation,
+                                      std::vector<VkSemaphore> waitSemaphores);
+        // Releases the buffer to the external queue family, submits the pending commands with a
+        // signal of the semaphore and destroys the buffer.
+        MaybeError SignalAndDestroy(VkSemaphore* outSignalSemaphore);
+
+        // Binds or releases the memory of the 64KB tiles of sparse buffers.
+        MaybeError UpdateTileMappings(uint64_t firstTile, uint64_t tileCount, bool resident);
 
       private:
         using BufferBase::BufferBase;
         MaybeError Initialize();
+        MaybeError InitializeFromExternal(const ExternalBufferDescriptor* descriptor,
+                                          external_memory::Service* externalMemoryService);
 
         // Dawn API
         MaybeError MapReadAsyncImpl(uint32_t serial) override;
@@ -58,7 +107,18 @@ namespace dawn_native { namespace vulkan {
         VkBuffer mHandle = VK_NULL_HANDLE;
         ResourceMemoryAllocation mMemoryAllocation;
 
+        // External buffers own their imported memory instead of an allocation.
+        VkDeviceMemory mExternalAllocation = VK_NULL_HANDLE;
+        VkSemaphore mSignalSemaphore = VK_NULL_HANDLE;
+
+        // Sparse buffers only have the memory of their resident tiles.
+        std::unique_ptr<SparseTileMemory> mSparseTiles;
+
         wgpu::BufferUsage mLastUsage = wgpu::BufferUsage::None;
+        // The shader stages the shader usages of the last usage can be from. Read-only usages
+        // that didn't need a barrier add their stages.
+        VkPipelineStageFlags mLastShaderStages = kAllShaderStages;
+        Serial mLastUsageSerial = 0;
     };
 
     class MapRequestTracker {
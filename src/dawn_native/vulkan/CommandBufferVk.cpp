@@ -14,31 +14,112 @@
 
 #include "dawn_native/vulkan/CommandBufferVk.h"
 
+#include "common/Constants.h"
 #include "dawn_native/BindGroupAndStorageBarrierTracker.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
+#include "dawn_native/PushConstantsTracker.h"
+#include "dawn_native/RayTracingBundle.h"
 #include "dawn_native/RenderBundle.h"
+#include "dawn_native/vulkan/AdapterVk.h"
 #include "dawn_native/vulkan/BindGroupVk.h"
 #include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/CommandRecordingContext.h"
 #include "dawn_native/vulkan/ComputePipelineVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/FramebufferCache.h"
 #include "dawn_native/vulkan/PipelineLayoutVk.h"
+#include "dawn_native/vulkan/QuerySetVk.h"
 #include "dawn_native/vulkan/RayTracingAccelerationContainerVk.h"
+#include "dawn_native/vulkan/RayTracingBundleVk.h"
 #include "dawn_native/vulkan/RayTracingPipelineVk.h"
 #include "dawn_native/vulkan/RayTracingShaderBindingTableVk.h"
+#include "dawn_native/vulkan/RenderBundleVk.h"
 #include "dawn_native/vulkan/RenderPassCache.h"
 #include "dawn_native/vulkan/RenderPipelineVk.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
+#include "dawn_native/vulkan/ResourceTableVk.h"
+#include "dawn_native/vulkan/ScratchMemoryPool.h"
 #include "dawn_native/vulkan/TextureVk.h"
 #include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <algorithm>
+#include <set>
 
 namespace dawn_native { namespace vulkan {
 
     namespace {
 
+        // Collects the barriers needed by a pass, a dispatch or a copy so that they are all
+        // recorded with a single vkCmdPipelineBarrier.
+        constexpr VkPipelineStageFlags kRenderShaderStages =
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        class BarrierBatch {
+          public:
+            // The shader usages of the batch are only for |shaderStages|, for example the ray
+            // tracing stage for the resources of a ray tracing pass.
+            BarrierBatch(VkPipelineStageFlags shaderStages = kAllShaderStages)
+                : mShaderStages(shaderStages) {
+            }
+
+            void TransitionBuffer(Buffer* buffer, wgpu::BufferUsage usage) {
+                VkBufferMemoryBarrier barrier;
+                if (buffer->TransitionUsageAndGetResourceBarrier(usage, mShaderStages, &barrier,
+                                                                 &mSrcStages, &mDstStages)) {
+                    mBufferBarriers.push_back(barrier);
+                }
+            }
+
+            void TransitionTexture(CommandRecordingContext* recordingContext,
+                                   Texture* texture,
+                                   wgpu::TextureUsage usage,
+                                   uint32_t baseMipLevel,
+                                   uint32_t levelCount,
+                                   uint32_t baseArrayLayer,
+                                   uint32_t layerCount) {
+                texture->TransitionUsageForPass(recordingContext, usage, baseMipLevel, levelCount,
+                                                baseArrayLayer, layerCount, mShaderStages,
+                                                &mImageBarriers, &mSrcStages, &mDstStages);
+            }
+
+            void TransitionTexture(CommandRecordingContext* recordingContext,
+                                   Texture* texture,
+                                   wgpu::TextureUsage usage) {
+                TransitionTexture(recordingContext, texture, usage, 0, texture->GetNumMipLevels(),
+                                  0, texture->GetArrayLayers());
+            }
+
+            void Record(Device* device, VkCommandBuffer commands) {
+                if (mBufferBarriers.empty() && mImageBarriers.empty()) {
+                    return;
+                }
+
+                ASSERT(mSrcStages != 0 && mDstStages != 0);
+                device->fn.CmdPipelineBarrier(commands, mSrcStages, mDstStages, 0, 0, nullptr,
+                                              static_cast<uint32_t>(mBufferBarriers.size()),
+                                              mBufferBarriers.data(),
+                                              static_cast<uint32_t>(mImageBarriers.size()),
+                                              mImageBarriers.data());
+
+                mBufferBarriers.clear();
+                mImageBarriers.clear();
+                mSrcStages = 0;
+                mDstStages = 0;
+            }
+
+          private:
+            VkPipelineStageFlags mShaderStages;
+            std::vector<VkBufferMemoryBarrier> mBufferBarriers;
+            std::vector<VkImageMemoryBarrier> mImageBarriers;
+            VkPipelineStageFlags mSrcStages = 0;
+            VkPipelineStageFlags mDstStages = 0;
+        };
+
         VkIndexType VulkanIndexType(wgpu::IndexFormat format) {
             switch (format) {
                 case wgpu::IndexFormat::Uint16:
@@ -95,6 +176,170 @@ namespace dawn_native { namespace vulkan {
             return region;
         }
 
+        // Consecutive copies between the same two buffers are recorded as a single
+        // vkCmdCopyBuffer, after a single barrier. The regions of a copy aren't ordered, so a copy
+        // is only added to the batch if it writes after the destination ranges of the previous
+        // ones, which also ensures that they don't overlap.
+        class BufferCopyBatch {
+          public:
+            void Append(Device* device,
+                        CommandRecordingContext* recordingContext,
+                        const CopyBufferToBufferCmd* copy) {
+                Buffer* source = ToBackend(copy->source.Get());
+                Buffer* destination = ToBackend(copy->destination.Get());
+                if (source != mSource || destination != mDestination ||
+                    copy->destinationOffset < mDestinationEnd) {
+                    Record(device, recordingContext);
+                }
+
+                if (mRegions.empty()) {
+                    mSource = source;
+                    mDestination = destination;
+                    mBarriers.TransitionBuffer(source, wgpu::BufferUsage::CopySrc);
+                    mBarriers.TransitionBuffer(destination, wgpu::BufferUsage::CopyDst);
+                }
+
+                VkBufferCopy region;
+                region.srcOffset = copy->sourceOffset;
+                region.dstOffset = copy->destinationOffset;
+                region.size = copy->size;
+                mRegions.push_back(region);
+                mDestinationEnd = copy->destinationOffset + copy->size;
+            }
+
+            void Record(Device* device, CommandRecordingContext* recordingContext) {
+                if (mRegions.empty()) {
+                    return;
+                }
+
+                VkCommandBuffer commands = recordingContext->commandBuffer;
+                mBarriers.Record(device, commands);
+                device->fn.CmdCopyBuffer(commands, mSource->GetHandle(), mDestination->GetHandle(),
+                                         static_cast<uint32_t>(mRegions.size()), mRegions.data());
+
+                mRegions.clear();
+                mSource = nullptr;
+                mDestination = nullptr;
+                mDestinationEnd = 0;
+            }
+
+          private:
+            BarrierBatch mBarriers;
+            std::vector<VkBufferCopy> mRegions;
+            Buffer* mSource = nullptr;
+            Buffer* mDestination = nullptr;
+            uint64_t mDestinationEnd = 0;
+        };
+
+        // Consecutive copies from the same buffer to the same texture are recorded as a single
+        // vkCmdCopyBufferToImage, after a single barrier, as long as their texture regions don't
+        // overlap. The batch is recorded before the lazy clear of a subresource, since the clear
+        // must be recorded before the barriers of the batch.
+        class BufferToTextureCopyBatch {
+          public:
+            void Append(Device* device,
+                        CommandRecordingContext* recordingContext,
+                        const CopyBufferToTextureCmd* copy) {
+                Buffer* source = ToBackend(copy->source.buffer.Get());
+                Texture* destination = ToBackend(copy->destination.texture.Get());
+                VkBufferImageCopy region =
+                    ComputeBufferImageCopyRegion(copy->source, copy->destination, copy->copySize);
+                const VkImageSubresourceLayers& subresource = region.imageSubresource;
+
+                bool overwritesSubresource = IsCompleteSubresourceCopiedTo(
+                    destination, copy->copySize, subresource.mipLevel);
+                bool needsClear =
+                    !overwritesSubresource &&
+                    !destination->IsSubresourceContentInitialized(subresource.mipLevel, 1,
+                                                                  subresource.baseArrayLayer, 1);
+
+                bool subresourceInBatch = false;
+                bool canAppend = source == mSource && destination == mDestination &&
+                                 !needsClear && mRegions.size() < kMaxRegionCount;
+                for (size_t i = 0; canAppend && i < mRegions.size(); ++i) {
+                    if (!IsSameSubresource(mRegions[i], region)) {
+                        continue;
+                    }
+                    subresourceInBatch = true;
+                    canAppend = !Overlaps(mRegions[i], region);
+                }
+                if (!canAppend) {
+                    Record(device, recordingContext);
+                    subresourceInBatch = false;
+                }
+
+                if (overwritesSubresource) {
+                    // Since texture has been overwritten, it has been "initialized"
+                    destination->SetIsSubresourceContentInitialized(
+                        true, subresource.mipLevel, 1, subresource.baseArrayLayer, 1);
+                } else {
+                    destination->EnsureSubresourceContentInitialized(
+                        recordingContext, subresource.mipLevel, 1, subresource.baseArrayLayer, 1);
+                }
+
+                if (mRegions.empty()) {
+                    mSource = source;
+                    mDestination = destination;
+                    mBarriers.TransitionBuffer(source, wgpu::BufferUsage::CopySrc);
+                }
+                if (!subresourceInBatch) {
+                    mBarriers.TransitionTexture(recordingContext, destination,
+                                                wgpu::TextureUsage::CopyDst, subresource.mipLevel,
+                                                1, subresource.baseArrayLayer, 1);
+                }
+                mRegions.push_back(region);
+            }
+
+            void Record(Device* device, CommandRecordingContext* recordingContext) {
+                if (mRegions.empty()) {
+                    return;
+                }
+
+                VkCommandBuffer commands = recordingContext->commandBuffer;
+                mBarriers.Record(device, commands);
+
+                // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
+                // copy command.
+                device->fn.CmdCopyBufferToImage(commands, mSource->GetHandle(),
+                                                mDestination->GetHandle(),
+                                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                static_cast<uint32_t>(mRegions.size()),
+                                                mRegions.data());
+
+                mRegions.clear();
+                mSource = nullptr;
+                mDestination = nullptr;
+            }
+
+          private:
+            // Bounds the cost of checking the regions for overlaps.
+            static constexpr size_t kMaxRegionCount = 256;
+
+            static bool IsSameSubresource(const VkBufferImageCopy& a, const VkBufferImageCopy& b) {
+                return a.imageSubresource.mipLevel == b.imageSubresource.mipLevel &&
+                       a.imageSubresource.baseArrayLayer == b.imageSubresource.baseArrayLayer;
+            }
+
+            static bool Overlaps(const VkBufferImageCopy& a, const VkBufferImageCopy& b) {
+                auto RangesOverlap = [](int32_t aBegin, uint32_t aSize, int32_t bBegin,
+                                        uint32_t bSize) {
+                    return aBegin < bBegin + static_cast<int32_t>(bSize) &&
+                           bBegin < aBegin + static_cast<int32_t>(aSize);
+                };
+                return RangesOverlap(a.imageOffset.x, a.imageExtent.width, b.imageOffset.x,
+                                     b.imageExtent.width) &&
+                       RangesOverlap(a.imageOffset.y, a.imageExtent.height, b.imageOffset.y,
+                                     b.imageExtent.height) &&
+                       RangesOverlap(a.imageOffset.z, a.imageExtent.depth, b.imageOffset.z,
+                                     b.imageExtent.depth);
+            }
+
+            BarrierBatch mBarriers;
+            std::vector<VkBufferImageCopy> mRegions;
+            Buffer* mSource = nullptr;
+            Texture* mDestination = nullptr;
+        };
+
         void ApplyDescriptorSets(Device* device,
                                  VkCommandBuffer commands,
                                  VkPipelineBindPoint bindPoint,
@@ -104,8 +349,22 @@ namespace dawn_native { namespace vulkan {
                                  const std::array<uint32_t, kMaxBindGroups>& dynamicOffsetCounts,
                                  const std::array<std::array<uint32_t, kMaxBindingsPerGroup>,
                                                   kMaxBindGroups>& dynamicOffsets) {
-            for (uint32_t dirtyIndex : IterateBitSet(bindGroupsToApply)) {
-                VkDescriptorSet set = ToBackend(bindGroups[dirtyIndex])->GetHandle();
+            for (uint32_t dirtyIndex : IterateBitSetWords(bindGroupsToApply)) {
+                VkDescriptorSet set = VK_NULL_HANDLE;
+                if (bindGroups[dirtyIndex]->GetLayout()->IsResourceTableLayout()) {
+                    // The descriptors were written by PrepareForSubmit.
+                    set = ToBackend(static_cast<ResourceTableBase*>(bindGroups[dirtyIndex]))
+                              ->GetHandle();
+                } else {
+                    BindGroup* bindGroup = ToBackend(bindGroups[dirtyIndex]);
+                    if (ToBackend(bindGroup->GetLayout())->IsPushDescriptorSetLayout()) {
+                        bindGroup->PushDescriptorSet(device, commands, bindPoint, pipelineLayout,
+                                                     dirtyIndex);
+                        continue;
+                    }
+                    set = bindGroup->GetHandle();
+                }
+
                 const uint32_t* dynamicOffset = dynamicOffsetCounts[dirtyIndex] > 0
                                                     ? dynamicOffsets[dirtyIndex].data()
                                                     : nullptr;
@@ -119,10 +378,10 @@ namespace dawn_native { namespace vulkan {
           public:
             RenderDescriptorSetTracker() = default;
 
-            void Apply(Device* device,
-                       CommandRecordingContext* recordingContext,
-                       VkPipelineBindPoint bindPoint) {
-                ApplyDescriptorSets(device, recordingContext->commandBuffer, bindPoint,
+            // Takes the VkCommandBuffer directly because render passes can be recorded in
+            // secondary command buffers.
+            void Apply(Device* device, VkCommandBuffer commands, VkPipelineBindPoint bindPoint) {
+                ApplyDescriptorSets(device, commands, bindPoint,
                                     ToBackend(mPipelineLayout)->GetHandle(),
                                     mDirtyBindGroupsObjectChangedOrIsDynamic, mBindGroups,
                                     mDynamicOffsetCounts, mDynamicOffsets);
@@ -130,6 +389,32 @@ namespace dawn_native { namespace vulkan {
             }
         };
 
+        // The pipeline and buffers bound in the command buffer recording the render commands, so
+        // that binding the same ones again can be skipped.
+        struct RenderCommandBindings {
+            RenderPipeline* pipeline = nullptr;
+            std::array<VkBuffer, kMaxVertexBuffers> vertexBuffers = {};
+            std::array<VkDeviceSize, kMaxVertexBuffers> vertexBufferOffsets = {};
+            VkBuffer indexBuffer = VK_NULL_HANDLE;
+            VkDeviceSize indexBufferOffset = 0;
+            VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+        };
+
+        class VulkanPushConstantsTracker : public PushConstantsTracker {
+          public:
+            void Apply(Device* device, VkCommandBuffer commands) {
+                if (!NeedsApply()) {
+                    return;
+                }
+
+                device->fn.CmdPushConstants(
+                    commands, ToBackend(mPipelineLayout)->GetHandle(),
+                    ToVulkanShaderStageFlags(mPipelineLayout->GetPushConstantVisibility()), 0,
+                    mPipelineLayout->GetPushConstantSize(), mData.data());
+                DidApply();
+            }
+        };
+
         class ComputeDescriptorSetTracker
             : public BindGroupAndStorageBarrierTrackerBase<true, uint32_t> {
           public:
@@ -143,13 +428,15 @@ namespace dawn_native { namespace vulkan {
                                     mDirtyBindGroupsObjectChangedOrIsDynamic, mBindGroups,
                                     mDynamicOffsetCounts, mDynamicOffsets);
 
-                for (uint32_t index : IterateBitSet(mBindGroupLayoutsMask)) {
-                    for (uint32_t binding : IterateBitSet(mBuffersNeedingBarrier[index])) {
+                BarrierBatch barriers(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                for (uint32_t index : IterateBitSetWords(mBindGroupLayoutsMask)) {
+                    for (uint32_t binding : IterateBitSetWords(mBuffersNeedingBarrier[index])) {
                         switch (mBindingTypes[index][binding]) {
                             case wgpu::BindingType::StorageBuffer:
-                                ToBackend(mBuffers[index][binding])
-                                    ->TransitionUsageNow(recordingContext,
-                                                         wgpu::BufferUsage::Storage);
+                                if (NeedsStorageBarrier(mBuffers[index][binding])) {
+                                    barriers.TransitionBuffer(ToBackend(mBuffers[index][binding]),
+                                                              wgpu::BufferUsage::Storage);
+                                }
                                 break;
 
                             case wgpu::BindingType::StorageTexture:
@@ -169,6 +456,7 @@ namespace dawn_native { namespace vulkan {
                         }
                     }
                 }
+                barriers.Record(device, recordingContext->commandBuffer);
                 DidApply();
             }
         };
@@ -178,21 +466,20 @@ namespace dawn_native { namespace vulkan {
           public:
             RayTracingDescriptorSetTracker() = default;
 
-            void Apply(Device* device,
-                       CommandRecordingContext* recordingContext,
-                       VkPipelineBindPoint bindPoint) {
-                ApplyDescriptorSets(device, recordingContext->commandBuffer, bindPoint,
+            // The commands can be the secondary command buffer of a ray tracing bundle.
+            void Apply(Device* device, VkCommandBuffer commands, VkPipelineBindPoint bindPoint) {
+                ApplyDescriptorSets(device, commands, bindPoint,
                                     ToBackend(mPipelineLayout)->GetHandle(),
                                     mDirtyBindGroupsObjectChangedOrIsDynamic, mBindGroups,
                                     mDynamicOffsetCounts, mDynamicOffsets);
 
-                for (uint32_t index : IterateBitSet(mBindGroupLayoutsMask)) {
-                    for (uint32_t binding : IterateBitSet(mBuffersNeedingBarrier[index])) {
+                BarrierBatch barriers(VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV);
+                for (uint32_t index : IterateBitSetWords(mBindGroupLayoutsMask)) {
+                    for (uint32_t binding : IterateBitSetWords(mBuffersNeedingBarrier[index])) {
                         switch (mBindingTypes[index][binding]) {
                             case wgpu::BindingType::StorageBuffer:
-                                ToBackend(mBuffers[index][binding])
-                                    ->TransitionUsageNow(recordingContext,
-                                                         wgpu::BufferUsage::Storage);
+                                barriers.TransitionBuffer(ToBackend(mBuffers[index][binding]),
+                                                          wgpu::BufferUsage::Storage);
                                 break;
 
                             case wgpu::BindingType::StorageTexture:
@@ -212,77 +499,395 @@ namespace dawn_native { namespace vulkan {
                         }
                     }
                 }
+                barriers.Record(device, commands);
                 DidApply();
             }
         };
 
-        MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
-                                         Device* device,
-                                         BeginRenderPassCmd* renderPass) {
+        // Writes the timestamps around the build of a container, when the device measures the GPU
+        // time of the builds for their build info.
+        void RecordBuildTimestamp(Device* device,
+                                  VkCommandBuffer commands,
+                                  RayTracingAccelerationContainer* container,
+                                  bool afterBuild) {
+            VkQueryPool queryPool = container->GetBuildTimeQueryPool();
+            if (queryPool == VK_NULL_HANDLE) {
+                return;
+            }
+
+            if (!afterBuild) {
+                device->fn.CmdResetQueryPool(commands, queryPool, 0, 2);
+                device->fn.CmdWriteTimestamp(commands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                             queryPool, 0);
+                return;
+            }
+
+            device->fn.CmdWriteTimestamp(
+                commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV, queryPool, 1);
+            // containers which allow compaction are tracked with their compacted size query
+            if ((container->GetFlags() &
+                 wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) == 0) {
+                device->GetBuildQueryTracker()->Track(container);
+            }
+        }
+
+        void RecordBuildAccelerationContainer(Device* device,
+                                              VkCommandBuffer commands,
+                                              RayTracingAccelerationContainer* container,
+                                              VkBuffer scratchBuffer,
+                                              uint64_t scratchOffset) {
+            VkAccelerationStructureInfoNV asInfo{};
+            asInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
+            asInfo.pNext = nullptr;
+            asInfo.flags = ToVulkanBuildAccelerationContainerFlags(container->GetFlags());
+
+            VkBuffer instanceBuffer = VK_NULL_HANDLE;
+            if (container->GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
+                std::vector<VkGeometryNV>& geometries = container->GetGeometries();
+                asInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_NV;
+                asInfo.instanceCount = 0;
+                asInfo.geometryCount = geometries.size();
+                asInfo.pGeometries = geometries.data();
+            } else {
+                asInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_NV;
+                asInfo.instanceCount = container->GetInstanceCount();
+                asInfo.geometryCount = 0;
+                asInfo.pGeometries = nullptr;
+                instanceBuffer = container->GetInstanceMemory().buffer;
+            }
+
+            RecordBuildTimestamp(device, commands, container, false);
+            device->fn.CmdBuildAccelerationStructureNV(
+                commands, &asInfo, instanceBuffer, container->GetInstanceBufferOffset(), false,
+                container->GetAccelerationStructure(), VK_NULL_HANDLE, scratchBuffer,
+                scratchOffset);
+            RecordBuildTimestamp(device, commands, container, true);
+            container->SetBuildState(true);
+            container->TrackBuild();
+            container->ReleaseBuildOnceResources();
+        }
+
+        // Queries the compacted size of a container which allows compaction. The build of the
+        // container must have been recorded before, followed by a barrier on the build stage.
+        void RecordCompactedSizeQuery(Device* device,
+                                      VkCommandBuffer commands,
+                                      RayTracingAccelerationContainer* container) {
+            if ((container->GetFlags() &
+                 wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) == 0) {
+                return;
+            }
+
+            VkQueryPool queryPool = container->GetCompactedSizeQueryPool();
+            VkAccelerationStructureNV accelerationStructure =
+                container->GetAccelerationStructure();
+
+            device->fn.CmdResetQueryPool(commands, queryPool, 0, 1);
+            device->fn.CmdWriteAccelerationStructuresPropertiesNV(
+                commands, 1, &accelerationStructure,
+                VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_NV, queryPool, 0);
+
+            device->GetBuildQueryTracker()->Track(container);
+        }
+
+        // Builds a set of containers that don't depend on each other back to back, taking their
+        // scratch memory from one shared allocation, and synchronizes them with a single barrier
+        // for the builds that follow. Ray tracing passes synchronize with the builds themselves.
+        MaybeError RecordBuildAccelerationContainerBatch(
+            Device* device,
+            CommandRecordingContext* recordingContext,
+            const std::vector<RayTracingAccelerationContainer*>& containers) {
+            if (containers.empty()) {
+                return {};
+            }
+
             VkCommandBuffer commands = recordingContext->commandBuffer;
 
-            // Query a VkRenderPass from the cache
-            VkRenderPass renderPassVK = VK_NULL_HANDLE;
-            {
-                RenderPassCacheQuery query;
+            // transition all instance buffers up front so that the builds stay back to back
+            for (RayTracingAccelerationContainer* container : containers) {
+                DAWN_TRY(container->MakeResident());
+                container->TransitionInstanceBufferNow(recordingContext);
+            }
 
-                for (uint32_t i :
-                     IterateBitSet(renderPass->attachmentState->GetColorAttachmentsMask())) {
-                    const auto& attachmentInfo = renderPass->colorAttachments[i];
+            auto AlignScratchSize = [](uint64_t size) -> uint64_t {
+                constexpr uint64_t kAlignment = ScratchMemoryPool::kScratchMemoryAlignment;
+                return (size + kAlignment - 1) & ~(kAlignment - 1);
+            };
 
-                    bool hasResolveTarget = attachmentInfo.resolveTarget.Get() != nullptr;
-                    wgpu::LoadOp loadOp = attachmentInfo.loadOp;
+            uint64_t scratchSize = 0;
+            for (RayTracingAccelerationContainer* container : containers) {
+                scratchSize += AlignScratchSize(container->GetBuildScratchSize());
+            }
 
-                    query.SetColor(i, attachmentInfo.view->GetFormat().format, loadOp,
-                                   hasResolveTarget);
-                }
+            ScratchMemoryAllocation scratchMemory;
+            DAWN_TRY_ASSIGN(scratchMemory, device->GetScratchMemoryPool()->Allocate(scratchSize));
+
+            bool allBuildOnce = true;
+            uint64_t scratchOffset = scratchMemory.offset;
+            for (RayTracingAccelerationContainer* container : containers) {
+                // the scratch size is reset by the release of the build-once resources
+                uint64_t containerScratchSize = AlignScratchSize(container->GetBuildScratchSize());
+                allBuildOnce = allBuildOnce &&
+                               (container->GetFlags() &
+                                wgpu::RayTracingAccelerationContainerFlag::BuildOnce);
+                RecordBuildAccelerationContainer(device, commands, container, scratchMemory.buffer,
+                                                 scratchOffset);
+                scratchOffset += containerScratchSize;
+            }
+            if (allBuildOnce) {
+                device->GetScratchMemoryPool()->ReleaseWhenIdle();
+            }
 
-                if (renderPass->attachmentState->HasDepthStencilAttachment()) {
-                    const auto& attachmentInfo = renderPass->depthStencilAttachment;
+            VkMemoryBarrier barrier;
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.pNext = nullptr;
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV |
+                                    VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV |
+                                    VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
+
+            device->fn.CmdPipelineBarrier(commands,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+            for (RayTracingAccelerationContainer* container : containers) {
+                RecordCompactedSizeQuery(device, commands, container);
+            }
+
+            return {};
+        }
 
-                    query.SetDepthStencil(attachmentInfo.view->GetTexture()->GetFormat().format,
-                                          attachmentInfo.depthLoadOp, attachmentInfo.stencilLoadOp);
+        // Collects the buffers the geometries of bottom-level containers are read from.
+        std::vector<VkBuffer> GetGeometryBuffers(
+            const std::vector<RayTracingAccelerationContainer*>& containers) {
+            std::vector<VkBuffer> buffers;
+            auto AddBuffer = [&buffers](VkBuffer buffer) {
+                if (buffer != VK_NULL_HANDLE &&
+                    std::find(buffers.begin(), buffers.end(), buffer) == buffers.end()) {
+                    buffers.push_back(buffer);
+                }
+            };
+            for (RayTracingAccelerationContainer* container : containers) {
+                for (const VkGeometryNV& geometry : container->GetGeometries()) {
+                    AddBuffer(geometry.geometry.triangles.vertexData);
+                    AddBuffer(geometry.geometry.triangles.indexData);
+                    AddBuffer(geometry.geometry.triangles.transformData);
+                    AddBuffer(geometry.geometry.aabbs.aabbData);
                 }
+            }
+            return buffers;
+        }
+
+        // Records one half of a queue family ownership transfer of whole buffers. The release is
+        // recorded on the source queue, the acquire with the same families on the destination.
+        void RecordBufferOwnershipTransfer(Device* device,
+                                           VkCommandBuffer commands,
+                                           const std::vector<VkBuffer>& buffers,
+                                           uint32_t srcQueueFamily,
+                                           uint32_t dstQueueFamily,
+                                           VkPipelineStageFlags srcStages,
+                                           VkPipelineStageFlags dstStages) {
+            if (buffers.empty()) {
+                return;
+            }
 
-                query.SetSampleCount(renderPass->attachmentState->GetSampleCount());
+            std::vector<VkBufferMemoryBarrier> barriers(buffers.size());
+            for (size_t i = 0; i < buffers.size(); ++i) {
+                VkBufferMemoryBarrier& barrier = barriers[i];
+                barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                barrier.pNext = nullptr;
+                barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+                barrier.srcQueueFamilyIndex = srcQueueFamily;
+                barrier.dstQueueFamilyIndex = dstQueueFamily;
+                barrier.buffer = buffers[i];
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+            }
+
+            device->fn.CmdPipelineBarrier(commands, srcStages, dstStages, 0, 0, nullptr,
+                                          static_cast<uint32_t>(barriers.size()), barriers.data(),
+                                          0, nullptr);
+        }
 
-                DAWN_TRY_ASSIGN(renderPassVK, device->GetRenderPassCache()->GetRenderPass(query));
+        // Builds bottom-level containers on the async compute queue. The graphics commands
+        // recorded so far get submitted first, and the ones recorded afterwards go to a new
+        // command buffer of the recording context which waits on the builds.
+        MaybeError RecordAsyncBuildAccelerationContainerBatch(
+            Device* device,
+            CommandRecordingContext* recordingContext,
+            const std::vector<RayTracingAccelerationContainer*>& containers) {
+            if (containers.empty()) {
+                return {};
             }
 
-            // Create a framebuffer that will be used once for the render pass and gather the clear
-            // values for the attachments at the same time.
+            const uint32_t graphicsQueueFamily = device->GetGraphicsQueueFamily();
+            const uint32_t computeQueueFamily = device->GetAsyncComputeQueueFamily();
+            std::vector<VkBuffer> geometryBuffers = GetGeometryBuffers(containers);
+
+            // the compute queue may not support the stages of the last usages, so the geometry
+            // buffers get transitioned before they are released to it
+            for (RayTracingAccelerationContainer* container : containers) {
+                container->TransitionGeometryBuffersNow(recordingContext);
+            }
+
+            RecordBufferOwnershipTransfer(device, recordingContext->commandBuffer, geometryBuffers,
+                                          graphicsQueueFamily, computeQueueFamily,
+                                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            CommandRecordingContext* computeContext = nullptr;
+            DAWN_TRY_ASSIGN(computeContext, device->BeginAsyncComputeCommands());
+
+            RecordBufferOwnershipTransfer(device, computeContext->commandBuffer, geometryBuffers,
+                                          graphicsQueueFamily, computeQueueFamily,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV);
+            DAWN_TRY(RecordBuildAccelerationContainerBatch(device, computeContext, containers));
+            RecordBufferOwnershipTransfer(device, computeContext->commandBuffer, geometryBuffers,
+                                          computeQueueFamily, graphicsQueueFamily,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+            DAWN_TRY(device->SubmitAsyncComputeCommands());
+
+            // The graphics queue waits on the builds at the acceleration structure build stage,
+            // so the acquire has to start from it.
+            RecordBufferOwnershipTransfer(device, recordingContext->commandBuffer, geometryBuffers,
+                                          computeQueueFamily, graphicsQueueFamily,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+            return {};
+        }
+
+        // Queries a VkRenderPass matching the attachments and load ops of the render pass from
+        // the cache.
+        ResultOrError<VkRenderPass> GetRenderPassForCmd(Device* device,
+                                                        BeginRenderPassCmd* renderPass) {
+            RenderPassCacheQuery query;
+
+            for (uint32_t i :
+                 IterateBitSet(renderPass->attachmentState->GetColorAttachmentsMask())) {
+                const auto& attachmentInfo = renderPass->colorAttachments[i];
+
+                bool hasResolveTarget = attachmentInfo.resolveTarget.Get() != nullptr;
+                wgpu::LoadOp loadOp = attachmentInfo.loadOp;
+
+                query.SetColor(i, attachmentInfo.view->GetFormat().format, loadOp,
+                               hasResolveTarget, attachmentInfo.storeOp);
+            }
+
+            if (renderPass->attachmentState->HasDepthStencilAttachment()) {
+                const auto& attachmentInfo = renderPass->depthStencilAttachment;
+
+                // The frontend makes the depth and stencil store ops match.
+                query.SetDepthStencil(attachmentInfo.view->GetTexture()->GetFormat().format,
+                                      attachmentInfo.depthLoadOp, attachmentInfo.stencilLoadOp,
+                                      attachmentInfo.depthStoreOp);
+            }
+
+            query.SetAttachmentState(renderPass->attachmentState.Get());
+
+            return device->GetRenderPassCache()->GetRenderPass(query);
+        }
+
+        // Queries have to be reset before they are written. Outside of render passes each query
+        // is reset right before it is written.
+        void RecordResetQuery(Device* device,
+                              VkCommandBuffer commands,
+                              QuerySet* querySet,
+                              uint32_t queryIndex) {
+            device->fn.CmdResetQueryPool(commands, querySet->GetHandle(), queryIndex, 1);
+        }
+
+        // vkCmdResetQueryPool can't be recorded in render passes, so all the queries written by a
+        // render pass are reset before it begins, coalescing consecutive queries in a single
+        // reset. The frontend ensures each query is only written once by the pass.
+        void RecordResetRenderPassQueries(Device* device,
+                                          VkCommandBuffer commands,
+                                          const PassResourceUsage& usages) {
+            for (size_t i = 0; i < usages.querySets.size(); ++i) {
+                VkQueryPool pool = ToBackend(usages.querySets[i])->GetHandle();
+                const std::vector<bool>& writtenQueries = usages.writtenQueries[i];
+
+                uint32_t queryCount = static_cast<uint32_t>(writtenQueries.size());
+                uint32_t firstQuery = 0;
+                while (firstQuery < queryCount) {
+                    if (!writtenQueries[firstQuery]) {
+                        firstQuery++;
+                        continue;
+                    }
+                    uint32_t endQuery = firstQuery + 1;
+                    while (endQuery < queryCount && writtenQueries[endQuery]) {
+                        endQuery++;
+                    }
+                    device->fn.CmdResetQueryPool(commands, pool, firstQuery,
+                                                 endQuery - firstQuery);
+                    firstQuery = endQuery;
+                }
+            }
+        }
+
+        void RecordWriteTimestamp(Device* device,
+                                  VkCommandBuffer commands,
+                                  WriteTimestampCmd* cmd) {
+            device->fn.CmdWriteTimestamp(commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                         ToBackend(cmd->querySet)->GetHandle(), cmd->queryIndex);
+        }
+
+        void RecordBeginConditionalRendering(Device* device,
+                                             VkCommandBuffer commands,
+                                             BeginConditionalRenderingCmd* cmd) {
+            VkConditionalRenderingBeginInfoEXT beginInfo;
+            beginInfo.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+            beginInfo.pNext = nullptr;
+            beginInfo.buffer = ToBackend(cmd->predicateBuffer)->GetHandle();
+            beginInfo.offset = cmd->predicateOffset;
+            beginInfo.flags = cmd->inverted ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : 0;
+            device->fn.CmdBeginConditionalRenderingEXT(commands, &beginInfo);
+        }
+
+        MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
+                                         Device* device,
+                                         BeginRenderPassCmd* renderPass,
+                                         VkSubpassContents contents) {
+            VkCommandBuffer commands = recordingContext->commandBuffer;
+
+            VkRenderPass renderPassVK = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(renderPassVK, GetRenderPassForCmd(device, renderPass));
+
+            // Gather the attachments to get the framebuffer from the cache and the clear values
+            // for the attachments at the same time.
             std::array<VkClearValue, kMaxColorAttachments + 1> clearValues;
-            VkFramebuffer framebuffer = VK_NULL_HANDLE;
-            uint32_t attachmentCount = 0;
+            FramebufferCacheQuery query;
+            query.renderPass = renderPassVK;
+            query.width = renderPass->width;
+            query.height = renderPass->height;
             {
-                // Fill in the attachment info that will be chained in the framebuffer create info.
-                std::array<VkImageView, kMaxColorAttachments * 2 + 1> attachments;
-
                 for (uint32_t i :
                      IterateBitSet(renderPass->attachmentState->GetColorAttachmentsMask())) {
                     auto& attachmentInfo = renderPass->colorAttachments[i];
                     TextureView* view = ToBackend(attachmentInfo.view.Get());
 
-                    attachments[attachmentCount] = view->GetHandle();
+                    VkClearValue& clearValue = clearValues[query.attachmentCount];
+                    clearValue.color.float32[0] = attachmentInfo.clearColor.r;
+                    clearValue.color.float32[1] = attachmentInfo.clearColor.g;
+                    clearValue.color.float32[2] = attachmentInfo.clearColor.b;
+                    clearValue.color.float32[3] = attachmentInfo.clearColor.a;
 
-                    clearValues[attachmentCount].color.float32[0] = attachmentInfo.clearColor.r;
-                    clearValues[attachmentCount].color.float32[1] = attachmentInfo.clearColor.g;
-                    clearValues[attachmentCount].color.float32[2] = attachmentInfo.clearColor.b;
-                    clearValues[attachmentCount].color.float32[3] = attachmentInfo.clearColor.a;
-
-                    attachmentCount++;
+                    query.AddAttachment(view->GetHandle());
                 }
 
                 if (renderPass->attachmentState->HasDepthStencilAttachment()) {
                     auto& attachmentInfo = renderPass->depthStencilAttachment;
                     TextureView* view = ToBackend(attachmentInfo.view.Get());
 
-                    attachments[attachmentCount] = view->GetHandle();
-
-                    clearValues[attachmentCount].depthStencil.depth = attachmentInfo.clearDepth;
-                    clearValues[attachmentCount].depthStencil.stencil = attachmentInfo.clearStencil;
+                    VkClearValue& clearValue = clearValues[query.attachmentCount];
+                    clearValue.depthStencil.depth = attachmentInfo.clearDepth;
+                    clearValue.depthStencil.stencil = attachmentInfo.clearStencil;
 
-                    attachmentCount++;
+                    query.AddAttachment(view->GetHandle());
                 }
 
                 for (uint32_t i :
@@ -291,34 +896,14 @@ namespace dawn_native { namespace vulkan {
                         TextureView* view =
                             ToBackend(renderPass->colorAttachments[i].resolveTarget.Get());
 
-                        attachments[attachmentCount] = view->GetHandle();
-
-                        attachmentCount++;
+                        query.AddAttachment(view->GetHandle());
                     }
                 }
-
-                // Chain attachments and create the framebuffer
-                VkFramebufferCreateInfo createInfo;
-                createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-                createInfo.pNext = nullptr;
-                createInfo.flags = 0;
-                createInfo.renderPass = renderPassVK;
-                createInfo.attachmentCount = attachmentCount;
-                createInfo.pAttachments = AsVkArray(attachments.data());
-                createInfo.width = renderPass->width;
-                createInfo.height = renderPass->height;
-                createInfo.layers = 1;
-
-                DAWN_TRY(
-                    CheckVkSuccess(device->fn.CreateFramebuffer(device->GetVkDevice(), &createInfo,
-                                                                nullptr, &*framebuffer),
-                                   "CreateFramebuffer"));
-
-                // We don't reuse VkFramebuffers so mark the framebuffer for deletion as soon as the
-                // commands currently being recorded are finished.
-                device->GetFencedDeleter()->DeleteWhenUnused(framebuffer);
             }
 
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(framebuffer, device->GetFramebufferCache()->GetFramebuffer(query));
+
             VkRenderPassBeginInfo beginInfo;
             beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
             beginInfo.pNext = nullptr;
@@ -328,13 +913,290 @@ namespace dawn_native { namespace vulkan {
             beginInfo.renderArea.offset.y = 0;
             beginInfo.renderArea.extent.width = renderPass->width;
             beginInfo.renderArea.extent.height = renderPass->height;
-            beginInfo.clearValueCount = attachmentCount;
+            beginInfo.clearValueCount = query.attachmentCount;
             beginInfo.pClearValues = clearValues.data();
 
-            device->fn.CmdBeginRenderPass(commands, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            device->fn.CmdBeginRenderPass(commands, &beginInfo, contents);
 
             return {};
         }
+
+        // The viewport and scissor default to cover all of the attachments.
+        RenderPassDynamicState GetDefaultDynamicState(const BeginRenderPassCmd* renderPass) {
+            RenderPassDynamicState state;
+            state.viewport.x = 0.0f;
+            state.viewport.y = static_cast<float>(renderPass->height);
+            state.viewport.width = static_cast<float>(renderPass->width);
+            state.viewport.height = -static_cast<float>(renderPass->height);
+            state.viewport.minDepth = 0.0f;
+            state.viewport.maxDepth = 1.0f;
+
+            state.scissor.offset.x = 0;
+            state.scissor.offset.y = 0;
+            state.scissor.extent.width = renderPass->width;
+            state.scissor.extent.height = renderPass->height;
+
+            state.blendConstants = {0.0f, 0.0f, 0.0f, 0.0f};
+            state.stencilReference = 0;
+            return state;
+        }
+
+        void RecordDynamicState(Device* device,
+                                VkCommandBuffer commands,
+                                const RenderPassDynamicState& state) {
+            device->fn.CmdSetLineWidth(commands, 1.0f);
+            device->fn.CmdSetDepthBounds(commands, 0.0f, 1.0f);
+
+            device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
+                                              state.stencilReference);
+            device->fn.CmdSetBlendConstants(commands, state.blendConstants.data());
+            device->fn.CmdSetViewport(commands, 0, 1, &state.viewport);
+            device->fn.CmdSetScissor(commands, 0, 1, &state.scissor);
+        }
+
+        // Render bundles are executed as secondary command buffers, unless the pass has active
+        // occlusion or pipeline statistics queries that the secondaries would need to inherit.
+        bool ShouldExecuteBundlesAsSecondaries(const PassResourceUsage& usages) {
+            if (!usages.executesRenderBundles) {
+                return false;
+            }
+            for (QuerySetBase* querySet : usages.querySets) {
+                if (querySet->GetQueryType() != wgpu::QueryType::Timestamp) {
+                    return false;
+                }
+            }
+            // Executing them in a conditional rendering scope would need the
+            // inheritedConditionalRendering feature.
+            for (wgpu::BufferUsage usage : usages.bufferUsages) {
+                if (usage & wgpu::BufferUsage::Predicate) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Whether the render pass |next|, which directly follows |previous| in the command buffer,
+        // can be recorded in the same render pass instance so that tilers keep the attachments in
+        // tile memory in between. |next| needs to load the same attachments that |previous|
+        // stores, and the passes can't depend on each other through other resources because the
+        // barriers and query resets of |next| are recorded before the instance begins.
+        bool CanMergeRenderPasses(const BeginRenderPassCmd* previous,
+                                  const PassResourceUsage& previousUsages,
+                                  const BeginRenderPassCmd* next,
+                                  const PassResourceUsage& nextUsages) {
+            if (ShouldExecuteBundlesAsSecondaries(previousUsages) ||
+                ShouldExecuteBundlesAsSecondaries(nextUsages)) {
+                return false;
+            }
+            if (previous->attachmentState.Get() != next->attachmentState.Get() ||
+                previous->width != next->width || previous->height != next->height) {
+                return false;
+            }
+
+            for (uint32_t i : IterateBitSet(next->attachmentState->GetColorAttachmentsMask())) {
+                const RenderPassColorAttachmentInfo& previousInfo = previous->colorAttachments[i];
+                const RenderPassColorAttachmentInfo& nextInfo = next->colorAttachments[i];
+                if (previousInfo.view.Get() != nextInfo.view.Get() ||
+                    previousInfo.resolveTarget.Get() != nextInfo.resolveTarget.Get() ||
+                    previousInfo.storeOp != wgpu::StoreOp::Store ||
+                    nextInfo.loadOp != wgpu::LoadOp::Load ||
+                    nextInfo.storeOp != wgpu::StoreOp::Store) {
+                    return false;
+                }
+            }
+
+            if (next->attachmentState->HasDepthStencilAttachment()) {
+                const RenderPassDepthStencilAttachmentInfo& previousInfo =
+                    previous->depthStencilAttachment;
+                const RenderPassDepthStencilAttachmentInfo& nextInfo =
+                    next->depthStencilAttachment;
+                if (previousInfo.view.Get() != nextInfo.view.Get() ||
+                    previousInfo.depthStoreOp != wgpu::StoreOp::Store ||
+                    previousInfo.stencilStoreOp != wgpu::StoreOp::Store ||
+                    nextInfo.depthLoadOp != wgpu::LoadOp::Load ||
+                    nextInfo.stencilLoadOp != wgpu::LoadOp::Load ||
+                    nextInfo.depthStoreOp != wgpu::StoreOp::Store ||
+                    nextInfo.stencilStoreOp != wgpu::StoreOp::Store) {
+                    return false;
+                }
+            }
+
+            // Storage writes would need a barrier in between the passes, and the resources used
+            // by both passes need the same usage so that their state is the same for both.
+            for (size_t i = 0; i < nextUsages.buffers.size(); ++i) {
+                if (nextUsages.bufferUsages[i] & wgpu::BufferUsage::Storage) {
+                    return false;
+                }
+                for (size_t j = 0; j < previousUsages.buffers.size(); ++j) {
+                    if (previousUsages.buffers[j] == nextUsages.buffers[i] &&
+                        previousUsages.bufferUsages[j] != nextUsages.bufferUsages[i]) {
+                        return false;
+                    }
+                }
+            }
+            for (wgpu::BufferUsage usage : previousUsages.bufferUsages) {
+                if (usage & wgpu::BufferUsage::Storage) {
+                    return false;
+                }
+            }
+
+            for (size_t i = 0; i < nextUsages.textures.size(); ++i) {
+                if (nextUsages.textureUsages[i] & wgpu::TextureUsage::Storage) {
+                    return false;
+                }
+                for (size_t j = 0; j < previousUsages.textures.size(); ++j) {
+                    if (previousUsages.textures[j] == nextUsages.textures[i] &&
+                        previousUsages.textureUsages[j] != nextUsages.textureUsages[i]) {
+                        return false;
+                    }
+                }
+            }
+            for (wgpu::TextureUsage usage : previousUsages.textureUsages) {
+                if (usage & wgpu::TextureUsage::Storage) {
+                    return false;
+                }
+            }
+
+            // The queries of both passes are reset before the instance begins.
+            for (QuerySetBase* querySet : nextUsages.querySets) {
+                if (std::find(previousUsages.querySets.begin(), previousUsages.querySets.end(),
+                              querySet) != previousUsages.querySets.end()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Only transitions the subresources of the texture that are attachments of the render
+        // pass, so that rendering to a level or a layer doesn't transition the other ones.
+        void TransitionAttachmentsUsage(CommandRecordingContext* recordingContext,
+                                        const BeginRenderPassCmd* renderPass,
+                                        Texture* texture,
+                                        BarrierBatch* barriers) {
+            auto TransitionView = [&](TextureViewBase* view) {
+                if (view != nullptr && view->GetTexture() == texture) {
+                    barriers->TransitionTexture(
+                        recordingContext, texture, wgpu::TextureUsage::OutputAttachment,
+                        view->GetBaseMipLevel(), view->GetLevelCount(), view->GetBaseArrayLayer(),
+                        view->GetLayerCount());
+                }
+            };
+
+            for (uint32_t i :
+                 IterateBitSet(renderPass->attachmentState->GetColorAttachmentsMask())) {
+                TransitionView(renderPass->colorAttachments[i].view.Get());
+                TransitionView(renderPass->colorAttachments[i].resolveTarget.Get());
+            }
+            if (renderPass->attachmentState->HasDepthStencilAttachment()) {
+                TransitionView(renderPass->depthStencilAttachment.view.Get());
+            }
+        }
+
+        // Records the draws packed in the indirect buffer of a command. Without the
+        // multiDrawIndirect feature, the draws are recorded one by one.
+        void RecordDrawIndirect(Device* device,
+                                VkCommandBuffer commands,
+                                const DrawIndirectCmd* draw,
+                                bool indexed) {
+            VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+            VkDeviceSize offset = static_cast<VkDeviceSize>(draw->indirectOffset);
+            const uint32_t stride = static_cast<uint32_t>(indexed ? kDrawIndexedIndirectSize
+                                                                  : kDrawIndirectSize);
+
+            if (draw->countBuffer != nullptr) {
+                VkBuffer countBuffer = ToBackend(draw->countBuffer)->GetHandle();
+                VkDeviceSize countOffset = static_cast<VkDeviceSize>(draw->countBufferOffset);
+                if (indexed) {
+                    device->fn.CmdDrawIndexedIndirectCountKHR(commands, indirectBuffer, offset,
+                                                              countBuffer, countOffset,
+                                                              draw->drawCount, stride);
+                } else {
+                    device->fn.CmdDrawIndirectCountKHR(commands, indirectBuffer, offset,
+                                                       countBuffer, countOffset, draw->drawCount,
+                                                       stride);
+                }
+                return;
+            }
+
+            uint32_t drawsPerCommand =
+                device->GetDeviceInfo().features.multiDrawIndirect == VK_TRUE ? draw->drawCount
+                                                                               : 1;
+            for (uint32_t i = 0; i < draw->drawCount; i += drawsPerCommand) {
+                VkDeviceSize drawOffset = offset + static_cast<VkDeviceSize>(i) * stride;
+                if (indexed) {
+                    device->fn.CmdDrawIndexedIndirect(commands, indirectBuffer, drawOffset,
+                                                      drawsPerCommand, stride);
+                } else {
+                    device->fn.CmdDrawIndirect(commands, indirectBuffer, drawOffset,
+                                               drawsPerCommand, stride);
+                }
+            }
+        }
+
+        // Blits each level from the previous one, with a barrier between the levels.
+        MaybeError RecordGenerateMipmaps(Device* device,
+                                         CommandRecordingContext* recordingContext,
+                                         const GenerateMipmapsCmd* cmd) {
+            Texture* texture = ToBackend(cmd->texture.Get());
+            uint32_t layerCount = texture->GetArrayLayers();
+
+            VkFormatProperties properties;
+            device->fn.GetPhysicalDeviceFormatProperties(
+                ToBackend(device->GetAdapter())->GetPhysicalDevice(),
+                VulkanImageFormat(device, texture->GetFormat().format), &properties);
+            constexpr VkFormatFeatureFlags kBlitFeatures =
+                VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+            if ((properties.optimalTilingFeatures & kBlitFeatures) != kBlitFeatures) {
+                return DAWN_UNIMPLEMENTED_ERROR("Generating mipmaps for a format without blits");
+            }
+            VkFilter filter = (properties.optimalTilingFeatures &
+                               VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                                  ? VK_FILTER_LINEAR
+                                  : VK_FILTER_NEAREST;
+
+            // The generated levels are overwritten entirely.
+            texture->EnsureSubresourceContentInitialized(recordingContext, cmd->baseMipLevel, 1,
+                                                         0, layerCount);
+            texture->SetIsSubresourceContentInitialized(true, cmd->baseMipLevel + 1,
+                                                        cmd->mipLevelCount - 1, 0, layerCount);
+
+            VkCommandBuffer commands = recordingContext->commandBuffer;
+            for (uint32_t level = cmd->baseMipLevel + 1;
+                 level < cmd->baseMipLevel + cmd->mipLevelCount; ++level) {
+                BarrierBatch barriers;
+                barriers.TransitionTexture(recordingContext, texture, wgpu::TextureUsage::CopySrc,
+                                           level - 1, 1, 0, layerCount);
+                barriers.TransitionTexture(recordingContext, texture, wgpu::TextureUsage::CopyDst,
+                                           level, 1, 0, layerCount);
+                barriers.Record(device, commands);
+
+                Extent3D srcSize = texture->GetMipLevelVirtualSize(level - 1);
+                Extent3D dstSize = texture->GetMipLevelVirtualSize(level);
+
+                VkImageBlit region;
+                region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.srcSubresource.mipLevel = level - 1;
+                region.srcSubresource.baseArrayLayer = 0;
+                region.srcSubresource.layerCount = layerCount;
+                region.srcOffsets[0] = {0, 0, 0};
+                region.srcOffsets[1] = {static_cast<int32_t>(srcSize.width),
+                                        static_cast<int32_t>(srcSize.height), 1};
+                region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.dstSubresource.mipLevel = level;
+                region.dstSubresource.baseArrayLayer = 0;
+                region.dstSubresource.layerCount = layerCount;
+                region.dstOffsets[0] = {0, 0, 0};
+                region.dstOffsets[1] = {static_cast<int32_t>(dstSize.width),
+                                        static_cast<int32_t>(dstSize.height), 1};
+
+                // The Dawn CopySrc usage is always mapped to GENERAL
+                device->fn.CmdBlitImage(commands, texture->GetHandle(), VK_IMAGE_LAYOUT_GENERAL,
+                                        texture->GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                        1, &region, filter);
+            }
+            return {};
+        }
     }  // anonymous namespace
 
     // static
@@ -345,6 +1207,7 @@ namespace dawn_native { namespace vulkan {
 
     CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
         : CommandBufferBase(encoder, descriptor), mCommands(encoder->AcquireCommands()) {
+        FindMergedRenderPasses();
     }
 
     CommandBuffer::~CommandBuffer() {
@@ -404,16 +1267,97 @@ namespace dawn_native { namespace vulkan {
         recordingContext->tempBuffers.emplace_back(tempBuffer);
     }
 
-    MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingContext) {
+    MaybeError CommandBuffer::RecordRenderPassesInSecondaries(
+        SecondaryCommandPool* pool,
+        std::vector<VkCommandBuffer>* renderPassCommands) {
+        Device* device = ToBackend(GetDevice());
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (type != Command::BeginRenderPass) {
+                SkipCommand(&mCommands, type);
+                continue;
+            }
+
+            BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
+
+            // The load ops are only known once the attachments are lazily cleared in submit
+            // order, but they don't matter for the render pass compatibility of the secondary.
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(renderPass, GetRenderPassForCmd(device, cmd));
+
+            VkCommandBuffer commands = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(commands, device->BeginSecondaryCommandBuffer(pool, renderPass));
+
+            DAWN_TRY(RecordRenderPassContents(commands, cmd));
+
+            DAWN_TRY(CheckVkSuccess(device->fn.EndCommandBuffer(commands), "vkEndCommandBuffer"));
+            renderPassCommands->push_back(commands);
+        }
+
+        return {};
+    }
+
+    void CommandBuffer::FindMergedRenderPasses() {
+        const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
+        size_t nextPassNumber = 0;
+
+        // Only set while the previous command is the end of a render pass.
+        const BeginRenderPassCmd* previousRenderPass = nullptr;
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (type == Command::BeginRenderPass) {
+                const BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
+                mMergesWithPreviousRenderPass.push_back(
+                    previousRenderPass != nullptr &&
+                    CanMergeRenderPasses(previousRenderPass, passResourceUsages[nextPassNumber - 1],
+                                         cmd, passResourceUsages[nextPassNumber]));
+                SkipRenderPassContents();
+
+                previousRenderPass = cmd;
+                nextPassNumber++;
+                continue;
+            }
+
+            if (type == Command::BeginComputePass || type == Command::BeginRayTracingPass) {
+                nextPassNumber++;
+            }
+            SkipCommand(&mCommands, type);
+            previousRenderPass = nullptr;
+        }
+    }
+
+    void CommandBuffer::SkipRenderPassContents() {
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            SkipCommand(&mCommands, type);
+            if (type == Command::EndRenderPass) {
+                return;
+            }
+        }
+
+        // EndRenderPass should have been encountered
+        UNREACHABLE();
+    }
+
+    MaybeError CommandBuffer::RecordCommands(
+        CommandRecordingContext* recordingContext,
+        const std::vector<VkCommandBuffer>* renderPassCommands) {
         Device* device = ToBackend(GetDevice());
         VkCommandBuffer commands = recordingContext->commandBuffer;
 
-        // Records the necessary barriers for the resource usage pre-computed by the frontend
-        auto TransitionForPass = [](CommandRecordingContext* recordingContext,
-                                    const PassResourceUsage& usages) {
+        // Records the necessary barriers for the resource usage pre-computed by the frontend, all
+        // in a single vkCmdPipelineBarrier.
+        // The shader usages of the pass are only waited for and blocked at |shaderStages|, so
+        // that for example the writes of a ray tracing pass don't wait for compute work.
+        auto TransitionForPass = [device](CommandRecordingContext* recordingContext,
+                                          const PassResourceUsage& usages,
+                                          const BeginRenderPassCmd* renderPass,
+                                          VkPipelineStageFlags shaderStages) {
+            BarrierBatch barriers(shaderStages);
             for (size_t i = 0; i < usages.buffers.size(); ++i) {
-                Buffer* buffer = ToBackend(usages.buffers[i]);
-                buffer->TransitionUsageNow(recordingContext, usages.bufferUsages[i]);
+                barriers.TransitionBuffer(ToBackend(usages.buffers[i]), usages.bufferUsages[i]);
             }
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
@@ -421,21 +1365,81 @@ namespace dawn_native { namespace vulkan {
                 // cleared in RecordBeginRenderPass by setting the loadop to clear when the
                 // texture subresource has not been initialized before the render pass.
                 if (!(usages.textureUsages[i] & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(recordingContext, 0,
-                                                                 texture->GetNumMipLevels(), 0,
-                                                                 texture->GetArrayLayers());
+                    const SubresourceRange& range = usages.textureRanges[i];
+                    texture->EnsureSubresourceContentInitialized(
+                        recordingContext, range.baseMipLevel, range.levelCount,
+                        range.baseArrayLayer, range.layerCount);
+                }
+                if (renderPass != nullptr &&
+                    usages.textureUsages[i] == wgpu::TextureUsage::OutputAttachment) {
+                    TransitionAttachmentsUsage(recordingContext, renderPass, texture, &barriers);
+                } else {
+                    barriers.TransitionTexture(recordingContext, texture, usages.textureUsages[i]);
+                }
+            }
+            barriers.Record(device, recordingContext->commandBuffer);
+        };
+
+        // The containers written by builds, updates and copies since the last barrier to the ray
+        // tracing stages. The barrier is only recorded before the ray tracing passes that trace
+        // against one of them, so that passes using other containers can overlap with the builds.
+        std::set<const RayTracingAccelerationContainerBase*> containersWrittenSinceBarrier;
+        auto SynchronizeAccelerationContainersForPass = [&](const PassResourceUsage& usages) {
+            auto IsWritten = [&](const RayTracingAccelerationContainerBase* container) {
+                return containersWrittenSinceBarrier.find(container) !=
+                       containersWrittenSinceBarrier.end();
+            };
+
+            bool needsBarrier = false;
+            for (const RayTracingAccelerationContainerBase* container :
+                 usages.accelerationContainers) {
+                // tracing against a top-level container traverses its geometry containers
+                needsBarrier = needsBarrier || IsWritten(container);
+                for (const Ref<RayTracingAccelerationContainerBase>& geometryContainer :
+                     container->GetGeometryContainers()) {
+                    needsBarrier = needsBarrier || IsWritten(geometryContainer.Get());
                 }
-                texture->TransitionUsageNow(recordingContext, usages.textureUsages[i]);
             }
+            if (!needsBarrier) {
+                return;
+            }
+
+            VkMemoryBarrier barrier;
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.pNext = nullptr;
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
+
+            // the memory barrier covers all the containers written so far
+            device->fn.CmdPipelineBarrier(recordingContext->commandBuffer,
+                                          VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                                          VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV, 0, 1,
+                                          &barrier, 0, nullptr, 0, nullptr);
+            containersWrittenSinceBarrier.clear();
         };
+
         const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
         size_t nextPassNumber = 0;
+        size_t nextRenderPassNumber = 0;
+        // The number of passes left to record in the render pass instance that is still open.
+        size_t remainingMergedRenderPasses = 0;
 
         bool hasBottomLevelContainerBuild = false;
         bool hasBottomLevelContainerUpdate = false;
 
+        // The copies batched so far are recorded before any other command.
+        BufferCopyBatch bufferCopies;
+        BufferToTextureCopyBatch bufferToTextureCopies;
+
         Command type;
         while (mCommands.NextCommandId(&type)) {
+            if (type != Command::CopyBufferToBuffer) {
+                bufferCopies.Record(device, recordingContext);
+            }
+            if (type != Command::CopyBufferToTexture) {
+                bufferToTextureCopies.Record(device, recordingContext);
+            }
+
             switch (type) {
 
                 case Command::BuildRayTracingAccelerationContainer: {
@@ -443,6 +1447,27 @@ namespace dawn_native { namespace vulkan {
                         mCommands.NextCommand<BuildRayTracingAccelerationContainerCmd>();
                     RayTracingAccelerationContainer* container = ToBackend(build->container.Get());
 
+                    // the build recreates the acceleration structure of an evicted container
+                    DAWN_TRY(container->MakeResident());
+
+                    if (device->HasAsyncComputeQueue() &&
+                        container->GetLevel() ==
+                            wgpu::RayTracingAccelerationContainerLevel::Bottom) {
+                        DAWN_TRY(RecordAsyncBuildAccelerationContainerBatch(device, recordingContext,
+                                                                            {container}));
+                        commands = recordingContext->commandBuffer;
+                        containersWrittenSinceBarrier.insert(container);
+                        break;
+                    }
+
+                    ScratchMemoryAllocation scratchMemory;
+                    DAWN_TRY_ASSIGN(scratchMemory, device->GetScratchMemoryPool()->Allocate(
+                                                       container->GetBuildScratchSize()));
+                    if (container->GetFlags() &
+                        wgpu::RayTracingAccelerationContainerFlag::BuildOnce) {
+                        device->GetScratchMemoryPool()->ReleaseWhenIdle();
+                    }
+
                     VkMemoryBarrier barrier;
                     barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
                     barrier.pNext = nullptr;
@@ -454,6 +1479,7 @@ namespace dawn_native { namespace vulkan {
                     // bottom-level AS
                     if (container->GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
                         std::vector<VkGeometryNV>& geometries = container->GetGeometries();
+                        container->TransitionGeometryBuffersNow(recordingContext);
 
                         VkAccelerationStructureInfoNV asInfo{};
                         asInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
@@ -464,12 +1490,16 @@ namespace dawn_native { namespace vulkan {
                         asInfo.geometryCount = geometries.size();
                         asInfo.pGeometries = geometries.data();
 
+                        RecordBuildTimestamp(device, commands, container, false);
                         device->fn.CmdBuildAccelerationStructureNV(
                             commands, &asInfo, VK_NULL_HANDLE, 0, false,
                             container->GetAccelerationStructure(), VK_NULL_HANDLE,
-                            container->GetScratchMemory().build.buffer,
-                            0);
+                            scratchMemory.buffer, scratchMemory.offset);
+                        RecordBuildTimestamp(device, commands, container, true);
                         container->SetBuildState(true);
+                        container->TrackBuild();
+                        container->ReleaseBuildOnceResources();
+                        containersWrittenSinceBarrier.insert(container);
 
                         hasBottomLevelContainerBuild = true;
                     }
@@ -494,22 +1524,109 @@ namespace dawn_native { namespace vulkan {
                                 &barrier, 0, 0, 0, 0);
                         }
 
+                        container->TransitionInstanceBufferNow(recordingContext);
+
+                        RecordBuildTimestamp(device, commands, container, false);
                         device->fn.CmdBuildAccelerationStructureNV(
-                            commands, &asInfo, container->GetInstanceMemory().buffer, 0, false,
+                            commands, &asInfo, container->GetInstanceMemory().buffer,
+                            container->GetInstanceBufferOffset(), false,
                             container->GetAccelerationStructure(), VK_NULL_HANDLE,
-                            container->GetScratchMemory().build.buffer,
-                            0);
+                            scratchMemory.buffer, scratchMemory.offset);
+                        RecordBuildTimestamp(device, commands, container, true);
 
-                        // probably not needed
+                        // later updates and copies may read the container, the ray tracing
+                        // passes tracing against it synchronize with the build themselves
                         device->fn.CmdPipelineBarrier(
                             commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
-                            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV |
-                                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV,
-                            0, 1, &barrier, 0, 0, 0, 0);
+                            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV, 0, 1, &barrier,
+                            0, 0, 0, 0);
 
                         container->SetBuildState(true);
+                        container->TrackBuild();
+                        container->ReleaseBuildOnceResources();
+                        containersWrittenSinceBarrier.insert(container);
+                    }
+
+                    if (container->GetFlags() &
+                        wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) {
+                        device->fn.CmdPipelineBarrier(
+                            commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV, 0, 1, &barrier,
+                            0, 0, 0, 0);
+                        RecordCompactedSizeQuery(device, commands, container);
+                    }
+
+                } break;
+
+                case Command::BuildRayTracingAccelerationContainers: {
+                    BuildRayTracingAccelerationContainersCmd* build =
+                        mCommands.NextCommand<BuildRayTracingAccelerationContainersCmd>();
+                    Ref<RayTracingAccelerationContainerBase>* containers =
+                        mCommands.NextData<Ref<RayTracingAccelerationContainerBase>>(build->count);
+
+                    // Bottom-level containers are independent of each other and get built first,
+                    // so that top-level containers in the same batch can reference them.
+                    std::vector<RayTracingAccelerationContainer*> bottomLevelContainers;
+                    std::vector<RayTracingAccelerationContainer*> topLevelContainers;
+                    for (uint32_t i = 0; i < build->count; ++i) {
+                        RayTracingAccelerationContainer* container = ToBackend(containers[i].Get());
+                        if (container->GetLevel() ==
+                            wgpu::RayTracingAccelerationContainerLevel::Bottom) {
+                            bottomLevelContainers.push_back(container);
+                        } else {
+                            topLevelContainers.push_back(container);
+                        }
                     }
 
+                    if (device->HasAsyncComputeQueue()) {
+                        DAWN_TRY(RecordAsyncBuildAccelerationContainerBatch(
+                            device, recordingContext, bottomLevelContainers));
+                        commands = recordingContext->commandBuffer;
+                    } else {
+                        for (RayTracingAccelerationContainer* container : bottomLevelContainers) {
+                            container->TransitionGeometryBuffersNow(recordingContext);
+                        }
+                        DAWN_TRY(RecordBuildAccelerationContainerBatch(device, recordingContext,
+                                                                       bottomLevelContainers));
+                    }
+                    DAWN_TRY(RecordBuildAccelerationContainerBatch(device, recordingContext,
+                                                                   topLevelContainers));
+                    containersWrittenSinceBarrier.insert(bottomLevelContainers.begin(),
+                                                         bottomLevelContainers.end());
+                    containersWrittenSinceBarrier.insert(topLevelContainers.begin(),
+                                                         topLevelContainers.end());
+                } break;
+
+                case Command::CompactRayTracingAccelerationContainer: {
+                    CompactRayTracingAccelerationContainerCmd* compact =
+                        mCommands.NextCommand<CompactRayTracingAccelerationContainerCmd>();
+                    RayTracingAccelerationContainer* srcContainer =
+                        ToBackend(compact->srcContainer.Get());
+                    RayTracingAccelerationContainer* dstContainer =
+                        ToBackend(compact->dstContainer.Get());
+
+                    DAWN_TRY(dstContainer->RecreateAsCompacted(srcContainer->GetCompactedSize()));
+
+                    device->fn.CmdCopyAccelerationStructureNV(
+                        commands, dstContainer->GetAccelerationStructure(),
+                        srcContainer->GetAccelerationStructure(),
+                        VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_NV);
+
+                    VkMemoryBarrier barrier;
+                    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                    barrier.pNext = nullptr;
+                    barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV |
+                                            VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
+                    barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV |
+                                            VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
+
+                    device->fn.CmdPipelineBarrier(
+                        commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
+                        VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV, 0, 1, &barrier, 0,
+                        nullptr, 0, nullptr);
+
+                    dstContainer->SetBuildState(true);
+                    containersWrittenSinceBarrier.insert(dstContainer);
                 } break;
 
                 case Command::CopyRayTracingAccelerationContainer: {
@@ -524,7 +1641,7 @@ namespace dawn_native { namespace vulkan {
                         commands, dstContainer->GetAccelerationStructure(),
                         srcContainer->GetAccelerationStructure(),
                         VK_COPY_ACCELERATION_STRUCTURE_MODE_CLONE_NV);
-
+                    containersWrittenSinceBarrier.insert(dstContainer);
                 } break;
 
                 case Command::UpdateRayTracingAccelerationContainer: {
@@ -532,6 +1649,19 @@ namespace dawn_native { namespace vulkan {
                         mCommands.NextCommand<UpdateRayTracingAccelerationContainerCmd>();
                     RayTracingAccelerationContainer* container = ToBackend(build->container.Get());
 
+                    // a refit is promoted to a full rebuild once the container's threshold of
+                    // consecutive updates is reached
+                    bool rebuild = container->ShouldRebuildOnUpdate();
+                    VkBool32 refit = rebuild ? VK_FALSE : VK_TRUE;
+                    VkAccelerationStructureNV srcAccelerationStructure =
+                        rebuild ? VK_NULL_HANDLE : container->GetAccelerationStructure();
+
+                    ScratchMemoryAllocation scratchMemory;
+                    DAWN_TRY_ASSIGN(scratchMemory,
+                                    device->GetScratchMemoryPool()->Allocate(
+                                        rebuild ? container->GetBuildScratchSize()
+                                                : container->GetUpdateScratchSize()));
+
                     VkMemoryBarrier barrier;
                     barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
                     barrier.pNext = nullptr;
@@ -540,15 +1670,14 @@ namespace dawn_native { namespace vulkan {
                     barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_NV |
                                             VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_NV;
 
-                    // we can destroy the scratch build memory after the first update
                     if (container->IsBuilt() && !container->IsUpdated()) {
-                        container->DestroyScratchBuildMemory();
                         container->SetUpdateState(true);
                     }
 
                     // bottom-level AS
                     if (container->GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
                         std::vector<VkGeometryNV>& geometries = container->GetGeometries();
+                        container->TransitionGeometryBuffersNow(recordingContext);
 
                         VkAccelerationStructureInfoNV asInfo{};
                         asInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
@@ -560,11 +1689,9 @@ namespace dawn_native { namespace vulkan {
                         asInfo.pGeometries = geometries.data();
 
                         device->fn.CmdBuildAccelerationStructureNV(
-                            commands, &asInfo, VK_NULL_HANDLE, 0, true,
-                            container->GetAccelerationStructure(),
-                            container->GetAccelerationStructure(),
-                            container->GetScratchMemory().update.buffer,
-                            0);
+                            commands, &asInfo, VK_NULL_HANDLE, 0, refit,
+                            container->GetAccelerationStructure(), srcAccelerationStructure,
+                            scratchMemory.buffer, scratchMemory.offset);
 
                         hasBottomLevelContainerUpdate = true;
                     }
@@ -589,74 +1716,35 @@ namespace dawn_native { namespace vulkan {
                                 &barrier, 0, 0, 0, 0);
                         }
 
+                        container->TransitionInstanceBufferNow(recordingContext);
+
                         device->fn.CmdBuildAccelerationStructureNV(
-                            commands, &asInfo, container->GetInstanceMemory().buffer, 0, true,
-                            container->GetAccelerationStructure(),
-                            container->GetAccelerationStructure(),
-                            container->GetScratchMemory().update.buffer,
-                            0);
+                            commands, &asInfo, container->GetInstanceMemory().buffer,
+                            container->GetInstanceBufferOffset(), refit,
+                            container->GetAccelerationStructure(), srcAccelerationStructure,
+                            scratchMemory.buffer, scratchMemory.offset);
 
-                        // probably not needed
+                        // later updates and copies may read the container, the ray tracing
+                        // passes tracing against it synchronize with the update themselves
                         device->fn.CmdPipelineBarrier(
                             commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV,
-                            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV |
-                                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV,
-                            0, 1, &barrier, 0, 0, 0, 0);
-
+                            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV, 0, 1, &barrier,
+                            0, 0, 0, 0);
                     }
 
+                    container->TrackUpdate(rebuild);
+                    containersWrittenSinceBarrier.insert(container);
+
                 } break;
 
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    Buffer* srcBuffer = ToBackend(copy->source.Get());
-                    Buffer* dstBuffer = ToBackend(copy->destination.Get());
-
-                    srcBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
-                    dstBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
-
-                    VkBufferCopy region;
-                    region.srcOffset = copy->sourceOffset;
-                    region.dstOffset = copy->destinationOffset;
-                    region.size = copy->size;
-
-                    VkBuffer srcHandle = srcBuffer->GetHandle();
-                    VkBuffer dstHandle = dstBuffer->GetHandle();
-                    device->fn.CmdCopyBuffer(commands, srcHandle, dstHandle, 1, &region);
+                    bufferCopies.Append(device, recordingContext, copy);
                 } break;
 
                 case Command::CopyBufferToTexture: {
                     CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-
-                    VkBufferImageCopy region =
-                        ComputeBufferImageCopyRegion(src, dst, copy->copySize);
-                    VkImageSubresourceLayers subresource = region.imageSubresource;
-
-                    if (IsCompleteSubresourceCopiedTo(dst.texture.Get(), copy->copySize,
-                                                      subresource.mipLevel)) {
-                        // Since texture has been overwritten, it has been "initialized"
-                        dst.texture->SetIsSubresourceContentInitialized(
-                            true, subresource.mipLevel, 1, subresource.baseArrayLayer, 1);
-                    } else {
-                        ToBackend(dst.texture)
-                            ->EnsureSubresourceContentInitialized(recordingContext,
-                                                                  subresource.mipLevel, 1,
-                                                                  subresource.baseArrayLayer, 1);
-                    }
-                    ToBackend(src.buffer)
-                        ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
-                    ToBackend(dst.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst);
-                    VkBuffer srcBuffer = ToBackend(src.buffer)->GetHandle();
-                    VkImage dstImage = ToBackend(dst.texture)->GetHandle();
-
-                    // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
-                    // copy command.
-                    device->fn.CmdCopyBufferToImage(commands, srcBuffer, dstImage,
-                                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                                                    &region);
+                    bufferToTextureCopies.Append(device, recordingContext, copy);
                 } break;
 
                 case Command::CopyTextureToBuffer: {
@@ -673,10 +1761,13 @@ namespace dawn_native { namespace vulkan {
                                                               subresource.mipLevel, 1,
                                                               subresource.baseArrayLayer, 1);
 
-                    ToBackend(src.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc);
-                    ToBackend(dst.buffer)
-                        ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+                    BarrierBatch barriers;
+                    barriers.TransitionTexture(recordingContext, ToBackend(src.texture.Get()),
+                                               wgpu::TextureUsage::CopySrc, subresource.mipLevel,
+                                               1, subresource.baseArrayLayer, 1);
+                    barriers.TransitionBuffer(ToBackend(dst.buffer.Get()),
+                                              wgpu::BufferUsage::CopyDst);
+                    barriers.Record(device, commands);
 
                     VkImage srcImage = ToBackend(src.texture)->GetHandle();
                     VkBuffer dstBuffer = ToBackend(dst.buffer)->GetHandle();
@@ -705,10 +1796,14 @@ namespace dawn_native { namespace vulkan {
                                                                   dst.arrayLayer, 1);
                     }
 
-                    ToBackend(src.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc);
-                    ToBackend(dst.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst);
+                    BarrierBatch barriers;
+                    barriers.TransitionTexture(recordingContext, ToBackend(src.texture.Get()),
+                                               wgpu::TextureUsage::CopySrc, src.mipLevel, 1,
+                                               src.arrayLayer, 1);
+                    barriers.TransitionTexture(recordingContext, ToBackend(dst.texture.Get()),
+                                               wgpu::TextureUsage::CopyDst, dst.mipLevel, 1,
+                                               dst.arrayLayer, 1);
+                    barriers.Record(device, commands);
 
                     // In some situations we cannot do texture-to-texture copies with vkCmdCopyImage
                     // because as Vulkan SPEC always validates image copies with the virtual size of
@@ -747,19 +1842,72 @@ namespace dawn_native { namespace vulkan {
                 case Command::BeginRenderPass: {
                     BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
 
-                    TransitionForPass(recordingContext, passResourceUsages[nextPassNumber]);
+                    if (remainingMergedRenderPasses > 0) {
+                        LazyClearRenderPassAttachments(cmd);
+                        DAWN_TRY(RecordRenderPassContents(commands, cmd));
+
+                        remainingMergedRenderPasses--;
+                        if (remainingMergedRenderPasses == 0) {
+                            device->fn.CmdEndRenderPass(commands);
+                        }
+
+                        nextPassNumber++;
+                        nextRenderPassNumber++;
+                        break;
+                    }
+
+                    // The secondaries are recorded for the render pass of each pass, so the
+                    // passes are only merged when recorded inline.
+                    size_t mergedPassCount = 1;
+                    if (renderPassCommands == nullptr) {
+                        while (nextRenderPassNumber + mergedPassCount <
+                                   mMergesWithPreviousRenderPass.size() &&
+                               mMergesWithPreviousRenderPass[nextRenderPassNumber +
+                                                             mergedPassCount]) {
+                            mergedPassCount++;
+                        }
+                    }
+
+                    // No barrier can be recorded inside the render pass instance, so the ones of
+                    // the merged passes are recorded before it begins.
+                    for (size_t i = 0; i < mergedPassCount; ++i) {
+                        TransitionForPass(recordingContext, passResourceUsages[nextPassNumber + i],
+                                          cmd, kRenderShaderStages);
+                        RecordResetRenderPassQueries(device, commands,
+                                                     passResourceUsages[nextPassNumber + i]);
+                    }
 
                     LazyClearRenderPassAttachments(cmd);
-                    DAWN_TRY(RecordRenderPass(recordingContext, cmd));
+                    if (mergedPassCount > 1) {
+                        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, cmd,
+                                                       VK_SUBPASS_CONTENTS_INLINE));
+                        DAWN_TRY(RecordRenderPassContents(commands, cmd));
+                        remainingMergedRenderPasses = mergedPassCount - 1;
+                    } else if (renderPassCommands != nullptr) {
+                        ASSERT(nextRenderPassNumber < renderPassCommands->size());
+                        DAWN_TRY(RecordBeginRenderPass(
+                            recordingContext, device, cmd,
+                            VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS));
+                        device->fn.CmdExecuteCommands(
+                            commands, 1, &(*renderPassCommands)[nextRenderPassNumber]);
+                        device->fn.CmdEndRenderPass(commands);
+
+                        SkipRenderPassContents();
+                    } else {
+                        DAWN_TRY(RecordRenderPass(recordingContext, cmd,
+                                                  passResourceUsages[nextPassNumber]));
+                    }
 
                     nextPassNumber++;
+                    nextRenderPassNumber++;
                 } break;
 
                 case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
+                    BeginComputePassCmd* cmd = mCommands.NextCommand<BeginComputePassCmd>();
 
-                    TransitionForPass(recordingContext, passResourceUsages[nextPassNumber]);
-                    RecordComputePass(recordingContext);
+                    TransitionForPass(recordingContext, passResourceUsages[nextPassNumber],
+                                      nullptr, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+                    RecordComputePass(recordingContext, cmd);
 
                     nextPassNumber++;
                 } break;
@@ -767,24 +1915,62 @@ namespace dawn_native { namespace vulkan {
                 case Command::BeginRayTracingPass: {
                     mCommands.NextCommand<BeginRayTracingPassCmd>();
 
-                    TransitionForPass(recordingContext, passResourceUsages[nextPassNumber]);
-                    RecordRayTracingPass(recordingContext);
+                    TransitionForPass(recordingContext, passResourceUsages[nextPassNumber],
+                                      nullptr, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV);
+                    SynchronizeAccelerationContainersForPass(passResourceUsages[nextPassNumber]);
+                    DAWN_TRY(RecordRayTracingPass(recordingContext));
 
                     nextPassNumber++;
                 } break;
 
+                case Command::WriteTimestamp: {
+                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+
+                    RecordResetQuery(device, commands, ToBackend(cmd->querySet.Get()),
+                                     cmd->queryIndex);
+                    RecordWriteTimestamp(device, commands, cmd);
+                } break;
+
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    DAWN_TRY(RecordGenerateMipmaps(device, recordingContext, cmd));
+                } break;
+
+                case Command::ResolveQuerySet: {
+                    ResolveQuerySetCmd* cmd = mCommands.NextCommand<ResolveQuerySetCmd>();
+                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
+                    Buffer* destination = ToBackend(cmd->destination.Get());
+
+                    destination->TransitionUsageNow(recordingContext,
+                                                    wgpu::BufferUsage::QueryResolve);
+
+                    // The frontend ensures all the queries are written before the resolve, so
+                    // waiting on them doesn't hang.
+                    VkDeviceSize stride = querySet->GetResultCountPerQuery() * sizeof(uint64_t);
+                    device->fn.CmdCopyQueryPoolResults(
+                        commands, querySet->GetHandle(), cmd->firstQuery, cmd->queryCount,
+                        destination->GetHandle(), cmd->destinationOffset, stride,
+                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
+        bufferCopies.Record(device, recordingContext);
+        bufferToTextureCopies.Record(device, recordingContext);
 
         return {};
     }
 
-    void CommandBuffer::RecordComputePass(CommandRecordingContext* recordingContext) {
+    void CommandBuffer::RecordComputePass(CommandRecordingContext* recordingContext,
+                                          const BeginComputePassCmd* computePass) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), Recording, "CommandBufferVk::RecordComputePass");
         Device* device = ToBackend(GetDevice());
         VkCommandBuffer commands = recordingContext->commandBuffer;
 
         ComputeDescriptorSetTracker descriptorSets = {};
+        descriptorSets.OnBeginPass(computePass->independentDispatches);
+        VulkanPushConstantsTracker pushConstants = {};
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
@@ -798,6 +1984,7 @@ namespace dawn_native { namespace vulkan {
                     DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
 
                     descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                    pushConstants.Apply(device, commands);
                     device->fn.CmdDispatch(commands, dispatch->x, dispatch->y, dispatch->z);
                 } break;
 
@@ -806,6 +1993,7 @@ namespace dawn_native { namespace vulkan {
                     VkBuffer indirectBuffer = ToBackend(dispatch->indirectBuffer)->GetHandle();
 
                     descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                    pushConstants.Apply(device, commands);
                     device->fn.CmdDispatchIndirect(
                         commands, indirectBuffer,
                         static_cast<VkDeviceSize>(dispatch->indirectOffset));
@@ -814,11 +2002,8 @@ namespace dawn_native { namespace vulkan {
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
 
-                    BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    BindGroup* bindGroup = ToBackend(cmd->group);
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(&mCommands, cmd);
 
                     descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
                                                   dynamicOffsets);
@@ -826,11 +2011,18 @@ namespace dawn_native { namespace vulkan {
 
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                    ComputePipeline* pipeline = ToBackend(cmd->pipeline);
 
                     device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE,
                                                pipeline->GetHandle());
                     descriptorSets.OnSetPipeline(pipeline);
+                    pushConstants.OnSetPipeline(pipeline);
+                } break;
+
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = mCommands.NextCommand<SetPushConstantsCmd>();
+                    const uint8_t* data = mCommands.NextData<uint8_t>(cmd->size);
+                    pushConstants.OnSetPushConstants(cmd->offset, cmd->size, data);
                 } break;
 
                 case Command::InsertDebugMarker: {
@@ -880,6 +2072,41 @@ namespace dawn_native { namespace vulkan {
                     }
                 } break;
 
+                case Command::WriteTimestamp: {
+                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+
+                    RecordResetQuery(device, commands, ToBackend(cmd->querySet.Get()),
+                                     cmd->queryIndex);
+                    RecordWriteTimestamp(device, commands, cmd);
+                } break;
+
+                case Command::BeginPipelineStatisticsQuery: {
+                    BeginPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<BeginPipelineStatisticsQueryCmd>();
+                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
+
+                    RecordResetQuery(device, commands, querySet, cmd->queryIndex);
+                    device->fn.CmdBeginQuery(commands, querySet->GetHandle(), cmd->queryIndex, 0);
+                } break;
+
+                case Command::EndPipelineStatisticsQuery: {
+                    EndPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<EndPipelineStatisticsQueryCmd>();
+                    device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                           cmd->queryIndex);
+                } break;
+
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* cmd =
+                        mCommands.NextCommand<BeginConditionalRenderingCmd>();
+                    RecordBeginConditionalRendering(device, commands, cmd);
+                } break;
+
+                case Command::EndConditionalRendering: {
+                    mCommands.NextCommand<EndConditionalRenderingCmd>();
+                    device->fn.CmdEndConditionalRenderingEXT(commands);
+                } break;
+
                 default: { UNREACHABLE(); } break;
             }
         }
@@ -888,72 +2115,70 @@ namespace dawn_native { namespace vulkan {
         UNREACHABLE();
     }
 
-    void CommandBuffer::RecordRayTracingPass(CommandRecordingContext* recordingContext) {
+    MaybeError CommandBuffer::RecordRayTracingPass(CommandRecordingContext* recordingContext) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), Recording, "CommandBufferVk::RecordRayTracingPass");
         Device* device = ToBackend(GetDevice());
         VkCommandBuffer commands = recordingContext->commandBuffer;
 
         RayTracingDescriptorSetTracker descriptorSets = {};
+        VulkanPushConstantsTracker pushConstants = {};
 
         RayTracingPipeline* usedPipeline = nullptr;
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
+        // The commands that ray tracing bundles can contain, recorded in |commands| which is the
+        // secondary command buffer of the bundle while it is recorded.
+        auto EncodeRayTracingBundleCommand = [&](CommandIterator* iter, Command type) {
             switch (type) {
-                case Command::EndRayTracingPass: {
-                    mCommands.NextCommand<EndRayTracingPassCmd>();
-                    return;
-                } break;
-
                 case Command::TraceRays: {
-                    TraceRaysCmd* traceRays = mCommands.NextCommand<TraceRaysCmd>();
+                    TraceRaysCmd* traceRays = iter->NextCommand<TraceRaysCmd>();
 
                     ASSERT(usedPipeline != nullptr);
 
                     RayTracingShaderBindingTable* sbt =
                         ToBackend(usedPipeline->GetShaderBindingTable());
 
-                    VkBuffer sbtBuffer = sbt->GetGroupBufferHandle();
+                    VkBuffer sbtBuffer = usedPipeline->GetRecordBufferHandle();
 
-                    uint32_t groupHandleSize = sbt->GetShaderGroupHandleSize();
+                    // records hold the group handle followed by the record data, hit groups
+                    // are selected by the instance offset and the shader's sbtRecordStride
+                    uint32_t recordStride = sbt->GetRecordStride();
 
-                    uint32_t rayGenOffset = traceRays->rayGenerationOffset;
-                    uint32_t rayHitOffset = traceRays->rayHitOffset;
-                    uint32_t rayMissOffset = traceRays->rayMissOffset;
+                    uint64_t rayGenOffset = sbt->GetRecordOffset(traceRays->rayGenerationOffset);
+                    uint64_t rayHitOffset = sbt->GetRecordOffset(traceRays->rayHitOffset);
+                    uint64_t rayMissOffset = sbt->GetRecordOffset(traceRays->rayMissOffset);
+                    uint64_t rayCallableOffset =
+                        sbt->GetRecordOffset(traceRays->rayCallableOffset);
 
-                    descriptorSets.Apply(device, recordingContext,
-                                         VK_PIPELINE_BIND_POINT_RAY_TRACING_NV);
+                    descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_RAY_TRACING_NV);
+                    pushConstants.Apply(device, commands);
 
                     device->fn.CmdTraceRaysNV(
                         commands,
                         // ray-gen
-                        sbtBuffer, rayGenOffset * groupHandleSize,
+                        sbtBuffer, rayGenOffset,
                         // ray-miss
-                        sbtBuffer, rayMissOffset * groupHandleSize, groupHandleSize,
+                        sbtBuffer, rayMissOffset, recordStride,
                         // ray-hit
-                        sbtBuffer, rayHitOffset * groupHandleSize, groupHandleSize,
+                        sbtBuffer, rayHitOffset, recordStride,
                         // callable
-                        VK_NULL_HANDLE, 0, 0,
+                        sbtBuffer, rayCallableOffset, recordStride,
                         // dimensions
                         traceRays->width, traceRays->height, traceRays->depth);
                 } break;
 
                 case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
+                    SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
 
-                    BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    BindGroup* bindGroup = ToBackend(cmd->group);
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(iter, cmd);
 
                     descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
                                                   dynamicOffsets);
                 } break;
 
                 case Command::SetRayTracingPipeline: {
-                    SetRayTracingPipelineCmd* cmd =
-                        mCommands.NextCommand<SetRayTracingPipelineCmd>();
-                    RayTracingPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                    SetRayTracingPipelineCmd* cmd = iter->NextCommand<SetRayTracingPipelineCmd>();
+                    RayTracingPipeline* pipeline = ToBackend(cmd->pipeline);
 
                     device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_RAY_TRACING_NV,
                                                pipeline->GetHandle());
@@ -961,12 +2186,19 @@ namespace dawn_native { namespace vulkan {
                     usedPipeline = pipeline;
 
                     descriptorSets.OnSetPipeline(pipeline);
+                    pushConstants.OnSetPipeline(pipeline);
+                } break;
+
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = iter->NextCommand<SetPushConstantsCmd>();
+                    const uint8_t* data = iter->NextData<uint8_t>(cmd->size);
+                    pushConstants.OnSetPushConstants(cmd->offset, cmd->size, data);
                 } break;
 
                 case Command::InsertDebugMarker: {
                     if (device->GetDeviceInfo().debugMarker) {
-                        InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
+                        InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
+                        const char* label = iter->NextData<char>(cmd->length + 1);
                         VkDebugMarkerMarkerInfoEXT markerInfo;
                         markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
                         markerInfo.pNext = nullptr;
@@ -978,23 +2210,23 @@ namespace dawn_native { namespace vulkan {
                         markerInfo.color[3] = 1.0;
                         device->fn.CmdDebugMarkerInsertEXT(commands, &markerInfo);
                     } else {
-                        SkipCommand(&mCommands, Command::InsertDebugMarker);
+                        SkipCommand(iter, Command::InsertDebugMarker);
                     }
                 } break;
 
                 case Command::PopDebugGroup: {
                     if (device->GetDeviceInfo().debugMarker) {
-                        mCommands.NextCommand<PopDebugGroupCmd>();
+                        iter->NextCommand<PopDebugGroupCmd>();
                         device->fn.CmdDebugMarkerEndEXT(commands);
                     } else {
-                        SkipCommand(&mCommands, Command::PopDebugGroup);
+                        SkipCommand(iter, Command::PopDebugGroup);
                     }
                 } break;
 
                 case Command::PushDebugGroup: {
                     if (device->GetDeviceInfo().debugMarker) {
-                        PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
+                        PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
+                        const char* label = iter->NextData<char>(cmd->length + 1);
                         VkDebugMarkerMarkerInfoEXT markerInfo;
                         markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
                         markerInfo.pNext = nullptr;
@@ -1006,67 +2238,201 @@ namespace dawn_native { namespace vulkan {
                         markerInfo.color[3] = 1.0;
                         device->fn.CmdDebugMarkerBeginEXT(commands, &markerInfo);
                     } else {
-                        SkipCommand(&mCommands, Command::PushDebugGroup);
+                        SkipCommand(iter, Command::PushDebugGroup);
                     }
                 } break;
 
-                default: { UNREACHABLE(); } break;
+                default:
+                    UNREACHABLE();
+                    break;
+            }
+        };
+
+        // Records a ray tracing bundle once in its secondary command buffer, starting from the
+        // default state so that the recording doesn't depend on the pass executing it first. The
+        // storage buffer barriers recorded in the bundle only depend on its own commands, since
+        // the resources are transitioned to the usage of the pass before it begins.
+        auto RecordRayTracingBundle = [&](RayTracingBundle* bundle) -> MaybeError {
+            VkCommandBuffer passCommands = commands;
+            VulkanPushConstantsTracker passPushConstants = pushConstants;
+            DAWN_TRY_ASSIGN(commands, bundle->BeginRecording());
+            descriptorSets = {};
+            pushConstants = {};
+            usedPipeline = nullptr;
+
+            CommandIterator* iter = bundle->GetCommands();
+            iter->Reset();
+            Command type;
+            while (iter->NextCommandId(&type)) {
+                EncodeRayTracingBundleCommand(iter, type);
+            }
+
+            VkCommandBuffer bundleCommands = commands;
+            commands = passCommands;
+            pushConstants = passPushConstants;
+            return CheckVkSuccess(device->fn.EndCommandBuffer(bundleCommands),
+                                  "vkEndCommandBuffer");
+        };
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            switch (type) {
+                case Command::EndRayTracingPass: {
+                    mCommands.NextCommand<EndRayTracingPassCmd>();
+                    return {};
+                } break;
+
+                case Command::ExecuteRayTracingBundles: {
+                    ExecuteRayTracingBundlesCmd* cmd =
+                        mCommands.NextCommand<ExecuteRayTracingBundlesCmd>();
+                    auto bundles = mCommands.NextData<Ref<RayTracingBundleBase>>(cmd->count);
+
+                    // The iterator and the recording of a bundle are shared by all the passes
+                    // executing it, which can be recorded on several threads at once.
+                    std::lock_guard<std::mutex> lock(*device->GetRenderBundleReplayMutex());
+                    for (uint32_t i = 0; i < cmd->count; ++i) {
+                        RayTracingBundle* bundle = static_cast<RayTracingBundle*>(bundles[i].Get());
+                        if (bundle->GetRecording() == VK_NULL_HANDLE) {
+                            DAWN_TRY(RecordRayTracingBundle(bundle));
+                        }
+                        VkCommandBuffer bundleCommands = bundle->GetRecording();
+                        device->fn.CmdExecuteCommands(commands, 1, &bundleCommands);
+                    }
+
+                    // The state bound in the pass is undefined after executing secondary command
+                    // buffers, and the pass sets it again.
+                    descriptorSets = {};
+                    pushConstants.Invalidate();
+                    usedPipeline = nullptr;
+                } break;
+
+                case Command::WriteTimestamp: {
+                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+
+                    RecordResetQuery(device, commands, ToBackend(cmd->querySet.Get()),
+                                     cmd->queryIndex);
+                    RecordWriteTimestamp(device, commands, cmd);
+                } break;
+
+                case Command::BeginPipelineStatisticsQuery: {
+                    BeginPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<BeginPipelineStatisticsQueryCmd>();
+                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
+
+                    RecordResetQuery(device, commands, querySet, cmd->queryIndex);
+                    device->fn.CmdBeginQuery(commands, querySet->GetHandle(), cmd->queryIndex, 0);
+                } break;
+
+                case Command::EndPipelineStatisticsQuery: {
+                    EndPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<EndPipelineStatisticsQueryCmd>();
+                    device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                           cmd->queryIndex);
+                } break;
+
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* cmd =
+                        mCommands.NextCommand<BeginConditionalRenderingCmd>();
+                    RecordBeginConditionalRendering(device, commands, cmd);
+                } break;
+
+                case Command::EndConditionalRendering: {
+                    mCommands.NextCommand<EndConditionalRenderingCmd>();
+                    device->fn.CmdEndConditionalRenderingEXT(commands);
+                } break;
+
+                default: { EncodeRayTracingBundleCommand(&mCommands, type); } break;
             }
         }
 
-        // EndComputePass should have been called
+        // EndRayTracingPass should have been called
         UNREACHABLE();
     }
 
     MaybeError CommandBuffer::RecordRenderPass(CommandRecordingContext* recordingContext,
-                                               BeginRenderPassCmd* renderPassCmd) {
+                                               BeginRenderPassCmd* renderPassCmd,
+                                               const PassResourceUsage& usages) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), Recording, "CommandBufferVk::RecordRenderPass");
         Device* device = ToBackend(GetDevice());
         VkCommandBuffer commands = recordingContext->commandBuffer;
 
-        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd));
+        if (!ShouldExecuteBundlesAsSecondaries(usages)) {
+            DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd,
+                                           VK_SUBPASS_CONTENTS_INLINE));
+            DAWN_TRY(RecordRenderPassContents(commands, renderPassCmd));
+            device->fn.CmdEndRenderPass(commands);
+            return {};
+        }
 
-        // Set the default value for the dynamic state
-        {
-            device->fn.CmdSetLineWidth(commands, 1.0f);
-            device->fn.CmdSetDepthBounds(commands, 0.0f, 1.0f);
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(renderPass, GetRenderPassForCmd(device, renderPassCmd));
+        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd,
+                                       VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS));
 
-            device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK, 0);
+        // The pool is released at the pending serial, so it isn't reset before the commands
+        // executing its command buffers have completed.
+        SecondaryCommandPool pool;
+        DAWN_TRY_ASSIGN(pool, device->AcquireSecondaryCommandPool());
+        MaybeError result = RecordRenderPassContents(commands, renderPassCmd, &pool, renderPass);
+        device->ReleaseSecondaryCommandPool(std::move(pool));
+        DAWN_TRY(std::move(result));
 
-            float blendConstants[4] = {
-                0.0f,
-                0.0f,
-                0.0f,
-                0.0f,
-            };
-            device->fn.CmdSetBlendConstants(commands, blendConstants);
-
-            // The viewport and scissor default to cover all of the attachments
-            VkViewport viewport;
-            viewport.x = 0.0f;
-            viewport.y = static_cast<float>(renderPassCmd->height);
-            viewport.width = static_cast<float>(renderPassCmd->width);
-            viewport.height = -static_cast<float>(renderPassCmd->height);
-            viewport.minDepth = 0.0f;
-            viewport.maxDepth = 1.0f;
-            device->fn.CmdSetViewport(commands, 0, 1, &viewport);
-
-            VkRect2D scissorRect;
-            scissorRect.offset.x = 0;
-            scissorRect.offset.y = 0;
-            scissorRect.extent.width = renderPassCmd->width;
-            scissorRect.extent.height = renderPassCmd->height;
-            device->fn.CmdSetScissor(commands, 0, 1, &scissorRect);
-        }
+        device->fn.CmdEndRenderPass(commands);
+        return {};
+    }
+
+    MaybeError CommandBuffer::RecordRenderPassContents(VkCommandBuffer primaryCommands,
+                                                       BeginRenderPassCmd* renderPassCmd,
+                                                       SecondaryCommandPool* secondaryPool,
+                                                       VkRenderPass renderPass) {
+        Device* device = ToBackend(GetDevice());
+
+        RenderPassDynamicState dynamicState = GetDefaultDynamicState(renderPassCmd);
 
         RenderDescriptorSetTracker descriptorSets = {};
-        RenderPipeline* lastPipeline = nullptr;
+        RenderCommandBindings bindings = {};
+        VulkanPushConstantsTracker pushConstants = {};
+
+        // When the render bundles are executed as secondary command buffers, the other commands
+        // of the pass have to be recorded in secondary command buffers as well because a subpass
+        // can't mix both. A new one is begun after each ExecuteBundles, so commands is only set
+        // while recording them.
+        VkCommandBuffer commands = VK_NULL_HANDLE;
+        if (secondaryPool == nullptr) {
+            commands = primaryCommands;
+            RecordDynamicState(device, commands, dynamicState);
+        }
+
+        // The secondary command buffers don't inherit any state, which is fine since they only
+        // begin at the start of the pass or after render bundles, which invalidate it.
+        auto BeginSecondaryCommands = [&]() -> MaybeError {
+            if (commands == VK_NULL_HANDLE) {
+                DAWN_TRY_ASSIGN(commands,
+                                device->BeginSecondaryCommandBuffer(secondaryPool, renderPass));
+                descriptorSets = {};
+                bindings = {};
+                pushConstants.Invalidate();
+                RecordDynamicState(device, commands, dynamicState);
+            }
+            return {};
+        };
+        auto EndSecondaryCommands = [&]() -> MaybeError {
+            if (secondaryPool != nullptr && commands != VK_NULL_HANDLE) {
+                DAWN_TRY(
+                    CheckVkSuccess(device->fn.EndCommandBuffer(commands), "vkEndCommandBuffer"));
+                device->fn.CmdExecuteCommands(primaryCommands, 1, &commands);
+                commands = VK_NULL_HANDLE;
+            }
+            return {};
+        };
 
         auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) {
             switch (type) {
                 case Command::Draw: {
                     DrawCmd* draw = iter->NextCommand<DrawCmd>();
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Apply(device, commands);
                     device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
                                        draw->firstVertex, draw->firstInstance);
                 } break;
@@ -1074,7 +2440,8 @@ namespace dawn_native { namespace vulkan {
                 case Command::DrawIndexed: {
                     DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Apply(device, commands);
                     device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
                                               draw->firstIndex, draw->baseVertex,
                                               draw->firstInstance);
@@ -1082,22 +2449,18 @@ namespace dawn_native { namespace vulkan {
 
                 case Command::DrawIndirect: {
                     DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    device->fn.CmdDrawIndirect(commands, indirectBuffer,
-                                               static_cast<VkDeviceSize>(draw->indirectOffset), 1,
-                                               0);
+                    descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Apply(device, commands);
+                    RecordDrawIndirect(device, commands, draw, false);
                 } break;
 
                 case Command::DrawIndexedIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+                    DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    device->fn.CmdDrawIndexedIndirect(
-                        commands, indirectBuffer, static_cast<VkDeviceSize>(draw->indirectOffset),
-                        1, 0);
+                    descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Apply(device, commands);
+                    RecordDrawIndirect(device, commands, draw, true);
                 } break;
 
                 case Command::InsertDebugMarker: {
@@ -1149,11 +2512,8 @@ namespace dawn_native { namespace vulkan {
 
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+                    BindGroup* bindGroup = ToBackend(cmd->group);
+                    uint32_t* dynamicOffsets = NextDynamicOffsets(iter, cmd);
 
                     descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
                                                   dynamicOffsets);
@@ -1163,32 +2523,57 @@ namespace dawn_native { namespace vulkan {
                     SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
                     VkBuffer indexBuffer = ToBackend(cmd->buffer)->GetHandle();
 
+                    VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
+
                     // TODO(cwallez@chromium.org): get the index type from the last render pipeline
                     // and rebind if needed on pipeline change
-                    ASSERT(lastPipeline != nullptr);
+                    ASSERT(bindings.pipeline != nullptr);
                     VkIndexType indexType =
-                        VulkanIndexType(lastPipeline->GetVertexStateDescriptor()->indexFormat);
-                    device->fn.CmdBindIndexBuffer(
-                        commands, indexBuffer, static_cast<VkDeviceSize>(cmd->offset), indexType);
+                        VulkanIndexType(bindings.pipeline->GetVertexStateDescriptor()->indexFormat);
+                    if (bindings.indexBuffer == indexBuffer &&
+                        bindings.indexBufferOffset == offset && bindings.indexType == indexType) {
+                        break;
+                    }
+
+                    device->fn.CmdBindIndexBuffer(commands, indexBuffer, offset, indexType);
+                    bindings.indexBuffer = indexBuffer;
+                    bindings.indexBufferOffset = offset;
+                    bindings.indexType = indexType;
                 } break;
 
                 case Command::SetRenderPipeline: {
                     SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                    RenderPipeline* pipeline = ToBackend(cmd->pipeline);
+                    if (bindings.pipeline == pipeline) {
+                        break;
+                    }
 
                     device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                pipeline->GetHandle());
-                    lastPipeline = pipeline;
+                    bindings.pipeline = pipeline;
 
                     descriptorSets.OnSetPipeline(pipeline);
+                    pushConstants.OnSetPipeline(pipeline);
+                } break;
+
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = iter->NextCommand<SetPushConstantsCmd>();
+                    const uint8_t* data = iter->NextData<uint8_t>(cmd->size);
+                    pushConstants.OnSetPushConstants(cmd->offset, cmd->size, data);
                 } break;
 
                 case Command::SetVertexBuffer: {
                     SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
                     VkBuffer buffer = ToBackend(cmd->buffer)->GetHandle();
                     VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
+                    if (bindings.vertexBuffers[cmd->slot] == buffer &&
+                        bindings.vertexBufferOffsets[cmd->slot] == offset) {
+                        break;
+                    }
 
                     device->fn.CmdBindVertexBuffers(commands, cmd->slot, 1, &*buffer, &offset);
+                    bindings.vertexBuffers[cmd->slot] = buffer;
+                    bindings.vertexBufferOffsets[cmd->slot] = offset;
                 } break;
 
                 default:
@@ -1197,28 +2582,67 @@ namespace dawn_native { namespace vulkan {
             }
         };
 
+        // Records a render bundle in a new secondary command buffer, starting from the default
+        // state like the secondary command buffers of the pass.
+        auto RecordRenderBundle = [&](RenderBundle* bundle) -> ResultOrError<VkCommandBuffer> {
+            VkCommandBuffer bundleCommands = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(bundleCommands, bundle->BeginRecording(renderPass, dynamicState));
+            if (bundleCommands == VK_NULL_HANDLE) {
+                return VkCommandBuffer(VK_NULL_HANDLE);
+            }
+
+            ASSERT(commands == VK_NULL_HANDLE);
+            commands = bundleCommands;
+            descriptorSets = {};
+            bindings = {};
+            pushConstants.Invalidate();
+            RecordDynamicState(device, commands, dynamicState);
+
+            CommandIterator* iter = bundle->GetCommands();
+            iter->Reset();
+            Command type;
+            while (iter->NextCommandId(&type)) {
+                EncodeRenderBundleCommand(iter, type);
+            }
+
+            commands = VK_NULL_HANDLE;
+            DAWN_TRY(CheckVkSuccess(device->fn.EndCommandBuffer(bundleCommands),
+                                    "vkEndCommandBuffer"));
+            return bundleCommands;
+        };
+
         Command type;
         while (mCommands.NextCommandId(&type)) {
+            if (type != Command::EndRenderPass && type != Command::ExecuteBundles) {
+                DAWN_TRY(BeginSecondaryCommands());
+            }
+
             switch (type) {
                 case Command::EndRenderPass: {
                     mCommands.NextCommand<EndRenderPassCmd>();
-                    device->fn.CmdEndRenderPass(commands);
+                    DAWN_TRY(EndSecondaryCommands());
                     return {};
                 } break;
 
                 case Command::SetBlendColor: {
                     SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    float blendConstants[4] = {
-                        cmd->color.r,
-                        cmd->color.g,
-                        cmd->color.b,
-                        cmd->color.a,
-                    };
-                    device->fn.CmdSetBlendConstants(commands, blendConstants);
+                    std::array<float, 4> blendConstants = {cmd->color.r, cmd->color.g,
+                                                           cmd->color.b, cmd->color.a};
+                    if (dynamicState.blendConstants == blendConstants) {
+                        break;
+                    }
+
+                    dynamicState.blendConstants = blendConstants;
+                    device->fn.CmdSetBlendConstants(commands, dynamicState.blendConstants.data());
                 } break;
 
                 case Command::SetStencilReference: {
                     SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
+                    if (dynamicState.stencilReference == cmd->reference) {
+                        break;
+                    }
+
+                    dynamicState.stencilReference = cmd->reference;
                     device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
                                                       cmd->reference);
                 } break;
@@ -1232,7 +2656,11 @@ namespace dawn_native { namespace vulkan {
                     viewport.height = -cmd->height;
                     viewport.minDepth = cmd->minDepth;
                     viewport.maxDepth = cmd->maxDepth;
+                    if (IsSameViewport(dynamicState.viewport, viewport)) {
+                        break;
+                    }
 
+                    dynamicState.viewport = viewport;
                     device->fn.CmdSetViewport(commands, 0, 1, &viewport);
                 } break;
 
@@ -1243,7 +2671,11 @@ namespace dawn_native { namespace vulkan {
                     rect.offset.y = cmd->y;
                     rect.extent.width = cmd->width;
                     rect.extent.height = cmd->height;
+                    if (IsSameScissor(dynamicState.scissor, rect)) {
+                        break;
+                    }
 
+                    dynamicState.scissor = rect;
                     device->fn.CmdSetScissor(commands, 0, 1, &rect);
                 } break;
 
@@ -1251,7 +2683,29 @@ namespace dawn_native { namespace vulkan {
                     ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
                     auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
 
+                    // The iterator and the recordings of a bundle are shared by all the render
+                    // passes executing it, which can be recorded on several threads at once.
+                    std::lock_guard<std::mutex> lock(*device->GetRenderBundleReplayMutex());
                     for (uint32_t i = 0; i < cmd->count; ++i) {
+                        VkCommandBuffer bundleCommands = VK_NULL_HANDLE;
+                        if (secondaryPool != nullptr) {
+                            RenderBundle* bundle = static_cast<RenderBundle*>(bundles[i].Get());
+                            bundleCommands = bundle->GetRecording(renderPass, dynamicState);
+                            if (bundleCommands == VK_NULL_HANDLE) {
+                                DAWN_TRY(EndSecondaryCommands());
+                                DAWN_TRY_ASSIGN(bundleCommands, RecordRenderBundle(bundle));
+                            }
+                        }
+
+                        if (bundleCommands != VK_NULL_HANDLE) {
+                            DAWN_TRY(EndSecondaryCommands());
+                            device->fn.CmdExecuteCommands(primaryCommands, 1, &bundleCommands);
+                            continue;
+                        }
+
+                        // The bundle has too many recordings already, or bundles are encoded in
+                        // the render pass.
+                        DAWN_TRY(BeginSecondaryCommands());
                         CommandIterator* iter = bundles[i]->GetCommands();
                         iter->Reset();
                         while (iter->NextCommandId(&type)) {
@@ -1260,6 +2714,49 @@ namespace dawn_native { namespace vulkan {
                     }
                 } break;
 
+                // The queries written by the render pass are reset before it begins.
+                case Command::WriteTimestamp: {
+                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+                    RecordWriteTimestamp(device, commands, cmd);
+                } break;
+
+                case Command::BeginOcclusionQuery: {
+                    BeginOcclusionQueryCmd* cmd = mCommands.NextCommand<BeginOcclusionQueryCmd>();
+                    device->fn.CmdBeginQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                             cmd->queryIndex, 0);
+                } break;
+
+                case Command::EndOcclusionQuery: {
+                    EndOcclusionQueryCmd* cmd = mCommands.NextCommand<EndOcclusionQueryCmd>();
+                    device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                           cmd->queryIndex);
+                } break;
+
+                case Command::BeginPipelineStatisticsQuery: {
+                    BeginPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<BeginPipelineStatisticsQueryCmd>();
+                    device->fn.CmdBeginQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                             cmd->queryIndex, 0);
+                } break;
+
+                case Command::EndPipelineStatisticsQuery: {
+                    EndPipelineStatisticsQueryCmd* cmd =
+                        mCommands.NextCommand<EndPipelineStatisticsQueryCmd>();
+                    device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet)->GetHandle(),
+                                           cmd->queryIndex);
+                } break;
+
+                case Command::BeginConditionalRendering: {
+                    BeginConditionalRenderingCmd* cmd =
+                        mCommands.NextCommand<BeginConditionalRenderingCmd>();
+                    RecordBeginConditionalRendering(device, commands, cmd);
+                } break;
+
+                case Command::EndConditionalRendering: {
+                    mCommands.NextCommand<EndConditionalRenderingCmd>();
+                    device->fn.CmdEndConditionalRenderingEXT(commands);
+                } break;
+
                 default: { EncodeRenderBundleCommand(&mCommands, type); } break;
             }
         }
@@ -21,8 +21,12 @@
 
 #include "common/vulkan_platform.h"
 
+#include <vector>
+
 namespace dawn_native {
+    struct BeginComputePassCmd;
     struct BeginRenderPassCmd;
+    struct PassResourceUsage;
     struct TextureCopy;
 }  // namespace dawn_native
 
@@ -30,6 +34,7 @@ namespace dawn_native { namespace vulkan {
 
     struct CommandRecordingContext;
     class Device;
+    struct SecondaryCommandPool;
 
     class CommandBuffer : public CommandBufferBase {
       public:
@@ -37,21 +42,48 @@ namespace dawn_native { namespace vulkan {
                                      const CommandBufferDescriptor* descriptor);
         ~CommandBuffer();
 
-        MaybeError RecordCommands(CommandRecordingContext* recordingContext);
+        // When renderPassCommands is set, it holds the secondary command buffers recorded by
+        // RecordRenderPassesInSecondaries, which are executed in place of the render passes.
+        MaybeError RecordCommands(CommandRecordingContext* recordingContext,
+                                  const std::vector<VkCommandBuffer>* renderPassCommands = nullptr);
+
+        // Records the contents of each render pass in a secondary command buffer allocated from
+        // pool. It only reads the commands so command buffers can be recorded on several threads
+        // at once, as long as each one has its own pool. The barriers and lazy clears are still
+        // recorded by RecordCommands, in submit order.
+        MaybeError RecordRenderPassesInSecondaries(
+            SecondaryCommandPool* pool,
+            std::vector<VkCommandBuffer>* renderPassCommands);
 
       private:
         CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor);
 
-        void RecordComputePass(CommandRecordingContext* recordingContext);
-        void RecordRayTracingPass(CommandRecordingContext* recordingContext);
+        void RecordComputePass(CommandRecordingContext* recordingContext,
+                               const BeginComputePassCmd* computePass);
+        MaybeError RecordRayTracingPass(CommandRecordingContext* recordingContext);
         MaybeError RecordRenderPass(CommandRecordingContext* recordingContext,
-                                    BeginRenderPassCmd* renderPass);
+                                    BeginRenderPassCmd* renderPass,
+                                    const PassResourceUsage& usages);
+        // When secondaryPool is set, the render pass was begun with secondary command buffer
+        // contents and its commands are recorded in command buffers of that pool, while the
+        // render bundles are executed from their recordings for renderPass.
+        MaybeError RecordRenderPassContents(VkCommandBuffer commands,
+                                            BeginRenderPassCmd* renderPassCmd,
+                                            SecondaryCommandPool* secondaryPool = nullptr,
+                                            VkRenderPass renderPass = VK_NULL_HANDLE);
+        // Finds the render passes that are recorded in the same render pass instance as the
+        // render pass before them.
+        void FindMergedRenderPasses();
+        void SkipRenderPassContents();
         void RecordCopyImageWithTemporaryBuffer(CommandRecordingContext* recordingContext,
                                                 const TextureCopy& srcCopy,
                                                 const TextureCopy& dstCopy,
                                                 const Extent3D& copySize);
 
         CommandIterator mCommands;
+        // For each render pass, whether it continues the render pass instance of the previous one
+        // when recorded inline.
+        std::vector<bool> mMergesWithPreviousRenderPass;
     };
 
 }}  // namespace dawn_native::vulkan
@@ -0,0 +1,131 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/CommandPoolRecycler.h"
+
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+namespace dawn_native { namespace vulkan {
+
+    CommandPoolRecycler::CommandPoolRecycler(Device* device) : mDevice(device) {
+        if (mDevice->IsToggleEnabled(Toggle::VulkanResetCommandPoolsOnWorkerThread)) {
+            mWorkerThread = std::thread([this]() { WorkerLoop(); });
+        }
+    }
+
+    CommandPoolRecycler::~CommandPoolRecycler() {
+        ASSERT(!mWorkerThread.joinable());
+        ASSERT(mAvailableCommands.empty());
+    }
+
+    void CommandPoolRecycler::Recycle(std::vector<CommandPoolAndBuffer>* commands) {
+        if (commands->empty()) {
+            return;
+        }
+
+        if (!mWorkerThread.joinable()) {
+            ResetPools(*commands, &mAvailableCommands);
+            commands->clear();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mWorkerMutex);
+            mCommandsToReset.insert(mCommandsToReset.end(), commands->begin(), commands->end());
+        }
+        mWorkerCondition.notify_one();
+        commands->clear();
+    }
+
+    bool CommandPoolRecycler::AcquireCommands(CommandPoolAndBuffer* commands) {
+        // Take the pools the worker finished resetting in one go, so that the lock is only
+        // needed when the available ones ran out.
+        if (mAvailableCommands.empty() && mWorkerThread.joinable()) {
+            std::lock_guard<std::mutex> lock(mWorkerMutex);
+            std::swap(mAvailableCommands, mResetCommands);
+        }
+
+        if (mAvailableCommands.empty()) {
+            return false;
+        }
+        *commands = mAvailableCommands.back();
+        mAvailableCommands.pop_back();
+        return true;
+    }
+
+    void CommandPoolRecycler::DestroyAll() {
+        if (mWorkerThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mWorkerMutex);
+                mWorkerStopping = true;
+            }
+            mWorkerCondition.notify_one();
+            mWorkerThread.join();
+
+            // The worker finishes the resets that were pending before it stops.
+            ASSERT(mCommandsToReset.empty());
+            mAvailableCommands.insert(mAvailableCommands.end(), mResetCommands.begin(),
+                                      mResetCommands.end());
+            mResetCommands.clear();
+        }
+
+        for (const CommandPoolAndBuffer& commands : mAvailableCommands) {
+            mDevice->fn.DestroyCommandPool(mDevice->GetVkDevice(), commands.pool, nullptr);
+        }
+        mAvailableCommands.clear();
+    }
+
+    void CommandPoolRecycler::ResetPools(const std::vector<CommandPoolAndBuffer>& commands,
+                                         std::vector<CommandPoolAndBuffer>* resetCommands) {
+        VkDevice vkDevice = mDevice->GetVkDevice();
+        for (const CommandPoolAndBuffer& command : commands) {
+            VkResult result =
+                VkResult::WrapUnsafe(mDevice->fn.ResetCommandPool(vkDevice, command.pool, 0));
+            if (result == VK_SUCCESS) {
+                resetCommands->push_back(command);
+            } else {
+                // A new pool gets created in place of this one when none are available.
+                mDevice->fn.DestroyCommandPool(vkDevice, command.pool, nullptr);
+            }
+        }
+    }
+
+    void CommandPoolRecycler::WorkerLoop() {
+        std::vector<CommandPoolAndBuffer> commands;
+        std::vector<CommandPoolAndBuffer> resetCommands;
+        std::unique_lock<std::mutex> lock(mWorkerMutex);
+        while (true) {
+            mWorkerCondition.wait(
+                lock, [this]() { return mWorkerStopping || !mCommandsToReset.empty(); });
+            if (mCommandsToReset.empty()) {
+                ASSERT(mWorkerStopping);
+                return;
+            }
+
+            // Reset the pools without holding the lock so that the device's thread doesn't wait
+            // for them.
+            std::swap(commands, mCommandsToReset);
+            lock.unlock();
+            ResetPools(commands, &resetCommands);
+            commands.clear();
+            lock.lock();
+
+            mResetCommands.insert(mResetCommands.end(), resetCommands.begin(),
+                                  resetCommands.end());
+            resetCommands.clear();
+        }
+    }
+
+}}  // namespace dawn_native::vulkan
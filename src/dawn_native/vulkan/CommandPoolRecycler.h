@@ -0,0 +1,71 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_COMMANDPOOLRECYCLER_H_
+#define DAWNNATIVE_VULKAN_COMMANDPOOLRECYCLER_H_
+
+#include "common/vulkan_platform.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    struct CommandPoolAndBuffer {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    };
+
+    // Resets the command pools of the completed submits so that recording the next ones doesn't
+    // have to. The pools are reset together when they are recycled during the device tick, or on
+    // a dedicated thread when the vulkan_reset_command_pools_on_worker_thread toggle is enabled.
+    class CommandPoolRecycler {
+      public:
+        CommandPoolRecycler(Device* device);
+        ~CommandPoolRecycler();
+
+        // Takes the completed commands, which are handed out by AcquireCommands once reset.
+        void Recycle(std::vector<CommandPoolAndBuffer>* commands);
+        // Returns false if there are no reset commands available.
+        bool AcquireCommands(CommandPoolAndBuffer* commands);
+        // Waits for the pending resets and destroys all the pools.
+        void DestroyAll();
+
+      private:
+        // Resets the pools and appends the ones that were successfully reset to resetCommands.
+        // Pools that fail to reset are destroyed.
+        void ResetPools(const std::vector<CommandPoolAndBuffer>& commands,
+                        std::vector<CommandPoolAndBuffer>* resetCommands);
+        void WorkerLoop();
+
+        Device* mDevice = nullptr;
+        // Only accessed by the device's thread.
+        std::vector<CommandPoolAndBuffer> mAvailableCommands;
+
+        // Only used when the pools are reset on the worker thread.
+        std::thread mWorkerThread;
+        std::mutex mWorkerMutex;
+        std::condition_variable mWorkerCondition;
+        std::vector<CommandPoolAndBuffer> mCommandsToReset;
+        std::vector<CommandPoolAndBuffer> mResetCommands;
+        bool mWorkerStopping = false;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_COMMANDPOOLRECYCLER_H_
@@ -30,6 +30,22 @@ namespace dawn_native { namespace vulkan {
         std::vector<VkSemaphore> waitSemaphores = {};
         std::vector<VkSemaphore> signalSemaphores = {};
 
+        // External timeline semaphores with the values waited on or signaled by the submit. They
+        // live as long as the device, so the submit doesn't delete them.
+        std::vector<VkSemaphore> waitTimelineSemaphores = {};
+        std::vector<uint64_t> waitTimelineValues = {};
+        std::vector<VkSemaphore> signalTimelineSemaphores = {};
+        std::vector<uint64_t> signalTimelineValues = {};
+
+        // Semaphores ordering the graphics queue with the async compute queue. They are deleted
+        // by the async compute submission using them, not by the graphics submission.
+        std::vector<VkSemaphore> asyncComputeWaitSemaphores = {};
+        std::vector<VkSemaphore> asyncComputeSignalSemaphores = {};
+
+        // Semaphores waited on by the sparse binds enqueued after the submission, which delete
+        // them once the bind has executed.
+        std::vector<VkSemaphore> sparseBindSignalSemaphores = {};
+
         // The internal buffers used in the workaround of texture-to-texture copies with compressed
         // formats.
         std::vector<Ref<Buffer>> tempBuffers;
@@ -39,6 +55,14 @@ namespace dawn_native { namespace vulkan {
         bool used = false;
     };
 
+    // A command pool of secondary command buffers which is only used by one thread at a time. The
+    // command buffers are reused once the pool has been reset.
+    struct SecondaryCommandPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers;
+        size_t usedCount = 0;
+    };
+
 }}  // namespace dawn_native::vulkan
 
 #endif  // DAWNNATIVE_VULKAN_COMMANDRECORDINGCONTEXT_H_
@@ -15,7 +15,7 @@
 #ifndef DAWNNATIVE_VULKAN_DESCRIPTORSETSERVICE_H_
 #define DAWNNATIVE_VULKAN_DESCRIPTORSETSERVICE_H_
 
-#include "common/SerialQueue.h"
+#include "common/FlatSerialQueue.h"
 
 #include "dawn_native/vulkan/BindGroupLayoutVk.h"
 
@@ -45,7 +45,7 @@ namespace dawn_native { namespace vulkan {
             Ref<BindGroupLayout> layout;
             size_t index;
         };
-        SerialQueue<Deallocation> mDeallocations;
+        FlatSerialQueue<Deallocation> mDeallocations;
     };
 
 }}  // namespace dawn_native::vulkan
@@ -16,6 +16,7 @@
 
 #include "common/Platform.h"
 #include "dawn_native/BackendConnection.h"
+#include "dawn_native/CommandBuffer.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/Error.h"
@@ -30,21 +31,31 @@
 #include "dawn_native/vulkan/ComputePipelineVk.h"
 #include "dawn_native/vulkan/DescriptorSetService.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/FramebufferCache.h"
 #include "dawn_native/vulkan/PipelineLayoutVk.h"
+#include "dawn_native/vulkan/QueryPoolAllocator.h"
+#include "dawn_native/vulkan/QuerySetVk.h"
 #include "dawn_native/vulkan/QueueVk.h"
 #include "dawn_native/vulkan/RayTracingAccelerationContainerVk.h"
+#include "dawn_native/vulkan/RayTracingBundleVk.h"
 #include "dawn_native/vulkan/RayTracingPipelineVk.h"
 #include "dawn_native/vulkan/RayTracingShaderBindingTableVk.h"
+#include "dawn_native/vulkan/RenderBundleVk.h"
 #include "dawn_native/vulkan/RenderPassCache.h"
 #include "dawn_native/vulkan/RenderPipelineVk.h"
 #include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
+#include "dawn_native/vulkan/ResourceTableVk.h"
 #include "dawn_native/vulkan/SamplerVk.h"
+#include "dawn_native/vulkan/ScratchMemoryPool.h"
 #include "dawn_native/vulkan/ShaderModuleVk.h"
 #include "dawn_native/vulkan/StagingBufferVk.h"
 #include "dawn_native/vulkan/SwapChainVk.h"
 #include "dawn_native/vulkan/TextureVk.h"
+#include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
 
+#include <algorithm>
+
 namespace dawn_native { namespace vulkan {
 
     Device::Device(Adapter* adapter, const DeviceDescriptor* descriptor)
@@ -74,11 +85,21 @@ namespace dawn_native { namespace vulkan {
         DAWN_TRY(functions->LoadDeviceProcs(mVkDevice, mDeviceInfo));
 
         GatherQueueFromDevice();
+        if (mDeviceInfo.timelineSemaphore) {
+            DAWN_TRY(CreateTimelineSemaphore());
+        }
+        DAWN_TRY(CreatePipelineCache());
+        mBuildQueryTracker = std::make_unique<BuildQueryTracker>(this);
         mDescriptorSetService = std::make_unique<DescriptorSetService>(this);
+        mCommandPoolRecycler = std::make_unique<CommandPoolRecycler>(this);
+        mAsyncComputeCommandPoolRecycler = std::make_unique<CommandPoolRecycler>(this);
         mDeleter = std::make_unique<FencedDeleter>(this);
+        mFramebufferCache = std::make_unique<FramebufferCache>(this);
         mMapRequestTracker = std::make_unique<MapRequestTracker>(this);
+        mQueryPoolAllocator = std::make_unique<QueryPoolAllocator>(this);
         mRenderPassCache = std::make_unique<RenderPassCache>(this);
         mResourceMemoryAllocator = std::make_unique<ResourceMemoryAllocator>(this);
+        mScratchMemoryPool = std::make_unique<ScratchMemoryPool>(this);
 
         mExternalMemoryService = std::make_unique<external_memory::Service>(this);
         mExternalSemaphoreService = std::make_unique<external_semaphore::Service>(this);
@@ -110,6 +131,10 @@ namespace dawn_native { namespace vulkan {
         // The Deleter may be null if initialization failed.
         if (mDeleter != nullptr) {
             mCompletedSerial = std::numeric_limits<Serial>::max();
+            // This also releases the heaps kept for transient resources.
+            if (mResourceMemoryAllocator != nullptr) {
+                mResourceMemoryAllocator->Tick(mCompletedSerial);
+            }
             mDeleter->Tick(mCompletedSerial);
             mDeleter = nullptr;
         }
@@ -123,18 +148,39 @@ namespace dawn_native { namespace vulkan {
         }
     }
 
+    MaybeError Device::ValidateRayTracingSupport() const {
+        if (mDeviceInfo.rayTracingNV) {
+            return {};
+        }
+        // The Vulkan headers used by Dawn predate VK_KHR_ray_tracing, only the NV extension can
+        // be driven for now.
+        if (ToBackend(GetAdapter())->GetDeviceInfo().rayTracingKHR) {
+            return DAWN_VALIDATION_ERROR(
+                "Ray tracing requires VK_NV_ray_tracing, VK_KHR_ray_tracing isn't supported yet");
+        }
+        return DAWN_VALIDATION_ERROR("Ray tracing requires VK_NV_ray_tracing");
+    }
+
     ResultOrError<RayTracingAccelerationContainerBase*> Device::CreateRayTracingAccelerationContainerImpl(
         const RayTracingAccelerationContainerDescriptor* descriptor) {
+        DAWN_TRY(ValidateRayTracingSupport());
         return RayTracingAccelerationContainer::Create(this, descriptor);
     }
     ResultOrError<RayTracingShaderBindingTableBase*> Device::CreateRayTracingShaderBindingTableImpl(
         const RayTracingShaderBindingTableDescriptor* descriptor) {
+        DAWN_TRY(ValidateRayTracingSupport());
         return RayTracingShaderBindingTable::Create(this, descriptor);
     }
     ResultOrError<RayTracingPipelineBase*> Device::CreateRayTracingPipelineImpl(
         const RayTracingPipelineDescriptor* descriptor) {
+        DAWN_TRY(ValidateRayTracingSupport());
         return RayTracingPipeline::Create(this, descriptor);
     }
+    ResultOrError<std::vector<Ref<RayTracingPipelineBase>>> Device::CreateRayTracingPipelinesImpl(
+        const std::vector<const RayTracingPipelineDescriptor*>& descriptors) {
+        DAWN_TRY(ValidateRayTracingSupport());
+        return RayTracingPipeline::CreateBatch(this, descriptors);
+    }
     ResultOrError<BindGroupBase*> Device::CreateBindGroupImpl(
         const BindGroupDescriptor* descriptor) {
         return BindGroup::Create(this, descriptor);
@@ -150,6 +196,18 @@ namespace dawn_native { namespace vulkan {
                                                    const CommandBufferDescriptor* descriptor) {
         return CommandBuffer::Create(encoder, descriptor);
     }
+    RenderBundleBase* Device::CreateRenderBundle(RenderBundleEncoder* encoder,
+                                                 const RenderBundleDescriptor* descriptor,
+                                                 AttachmentState* attachmentState,
+                                                 PassResourceUsage resourceUsage) {
+        return new RenderBundle(encoder, descriptor, attachmentState, std::move(resourceUsage));
+    }
+    RayTracingBundleBase* Device::CreateRayTracingBundle(
+        RayTracingBundleEncoder* encoder,
+        const RayTracingBundleDescriptor* descriptor,
+        PassResourceUsage resourceUsage) {
+        return new RayTracingBundle(encoder, descriptor, std::move(resourceUsage));
+    }
     ResultOrError<ComputePipelineBase*> Device::CreateComputePipelineImpl(
         const ComputePipelineDescriptor* descriptor) {
         return ComputePipeline::Create(this, descriptor);
@@ -158,13 +216,24 @@ namespace dawn_native { namespace vulkan {
         const PipelineLayoutDescriptor* descriptor) {
         return PipelineLayout::Create(this, descriptor);
     }
-    ResultOrError<QueueBase*> Device::CreateQueueImpl() {
-        return Queue::Create(this);
+    ResultOrError<QuerySetBase*> Device::CreateQuerySetImpl(const QuerySetDescriptor* descriptor) {
+        return QuerySet::Create(this, descriptor);
+    }
+    ResultOrError<QueueBase*> Device::CreateQueueImpl(const QueueDescriptor* descriptor) {
+        return Queue::Create(this, descriptor);
     }
     ResultOrError<RenderPipelineBase*> Device::CreateRenderPipelineImpl(
         const RenderPipelineDescriptor* descriptor) {
         return RenderPipeline::Create(this, descriptor);
     }
+    ResultOrError<std::vector<Ref<RenderPipelineBase>>> Device::CreateRenderPipelinesImpl(
+        const std::vector<const RenderPipelineDescriptor*>& descriptors) {
+        return RenderPipeline::CreateBatch(this, descriptors);
+    }
+    ResultOrError<ResourceTableBase*> Device::CreateResourceTableImpl(
+        const ResourceTableDescriptor* descriptor) {
+        return ResourceTable::Create(this, descriptor);
+    }
     ResultOrError<SamplerBase*> Device::CreateSamplerImpl(const SamplerDescriptor* descriptor) {
         return Sampler::Create(this, descriptor);
     }
@@ -203,20 +272,34 @@ namespace dawn_native { namespace vulkan {
         return mLastSubmittedSerial + 1;
     }
 
+    bool Device::HasPendingCommands() const {
+        return mRecordingContext.used;
+    }
+
     MaybeError Device::TickImpl() {
-        CheckPassedFences();
-        RecycleCompletedCommands();
+        CheckPassedSerials();
 
-        mDescriptorSetService->Tick(mCompletedSerial);
-        mMapRequestTracker->Tick(mCompletedSerial);
+        // Everything below only releases what was used by the commands up to the completed
+        // serial, so there is nothing to do when no new serial completed since the last tick.
+        if (mCompletedSerial != mLastTickedSerial) {
+            mLastTickedSerial = mCompletedSerial;
 
-        // Uploader should tick before the resource allocator
-        // as it enqueues resources to be released.
-        mDynamicUploader->Deallocate(mCompletedSerial);
+            RecycleCompletedCommands();
 
-        mResourceMemoryAllocator->Tick(mCompletedSerial);
+            mDescriptorSetService->Tick(mCompletedSerial);
+            mMapRequestTracker->Tick(mCompletedSerial);
+            mQueryPoolAllocator->Tick(mCompletedSerial);
+            mScratchMemoryPool->Tick(mCompletedSerial);
+            mBuildQueryTracker->Tick(mCompletedSerial);
 
-        mDeleter->Tick(mCompletedSerial);
+            // Uploader should tick before the resource allocator
+            // as it enqueues resources to be released.
+            mDynamicUploader->Deallocate(mCompletedSerial);
+
+            mResourceMemoryAllocator->Tick(mCompletedSerial);
+
+            mDeleter->Tick(mCompletedSerial);
+        }
 
         if (mRecordingContext.used) {
             DAWN_TRY(SubmitPendingCommands());
@@ -249,10 +332,27 @@ namespace dawn_native { namespace vulkan {
         return mQueue;
     }
 
+    bool Device::HasAsyncComputeQueue() const {
+        return mAsyncComputeQueue != VK_NULL_HANDLE;
+    }
+
+    uint32_t Device::GetAsyncComputeQueueFamily() const {
+        ASSERT(HasAsyncComputeQueue());
+        return mAsyncComputeQueueFamily;
+    }
+
+    BuildQueryTracker* Device::GetBuildQueryTracker() const {
+        return mBuildQueryTracker.get();
+    }
+
     MapRequestTracker* Device::GetMapRequestTracker() const {
         return mMapRequestTracker.get();
     }
 
+    QueryPoolAllocator* Device::GetQueryPoolAllocator() const {
+        return mQueryPoolAllocator.get();
+    }
+
     DescriptorSetService* Device::GetDescriptorSetService() const {
         return mDescriptorSetService.get();
     }
@@ -261,10 +361,73 @@ namespace dawn_native { namespace vulkan {
         return mDeleter.get();
     }
 
+    FramebufferCache* Device::GetFramebufferCache() const {
+        return mFramebufferCache.get();
+    }
+
     RenderPassCache* Device::GetRenderPassCache() const {
         return mRenderPassCache.get();
     }
 
+    ScratchMemoryPool* Device::GetScratchMemoryPool() const {
+        return mScratchMemoryPool.get();
+    }
+
+    VkPipelineCache Device::GetPipelineCache() const {
+        return mPipelineCache;
+    }
+
+    MaybeError Device::CreatePipelineCache() {
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+
+        return CheckVkSuccess(
+            fn.CreatePipelineCache(mVkDevice, &createInfo, nullptr, &*mPipelineCache),
+            "vkCreatePipelineCache");
+    }
+
+    ResultOrError<std::vector<uint8_t>> Device::GetPipelineCacheData() const {
+        size_t size = 0;
+        DAWN_TRY(CheckVkSuccess(fn.GetPipelineCacheData(mVkDevice, mPipelineCache, &size, nullptr),
+                                "vkGetPipelineCacheData"));
+
+        std::vector<uint8_t> data(size);
+        if (size > 0) {
+            DAWN_TRY(CheckVkSuccess(
+                fn.GetPipelineCacheData(mVkDevice, mPipelineCache, &size, data.data()),
+                "vkGetPipelineCacheData"));
+            data.resize(size);
+        }
+        return std::move(data);
+    }
+
+    MaybeError Device::LoadPipelineCacheData(const void* data, size_t size) {
+        // The data is merged into the device's cache through a temporary one so that it can be
+        // loaded at any point. Drivers ignore data produced by an incompatible device or driver.
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = size;
+        createInfo.pInitialData = data;
+
+        VkPipelineCache loadedCache = VK_NULL_HANDLE;
+        DAWN_TRY(CheckVkSuccess(
+            fn.CreatePipelineCache(mVkDevice, &createInfo, nullptr, &*loadedCache),
+            "vkCreatePipelineCache"));
+
+        MaybeError result = CheckVkSuccess(
+            fn.MergePipelineCaches(mVkDevice, mPipelineCache, 1, &*loadedCache),
+            "vkMergePipelineCaches");
+        fn.DestroyPipelineCache(mVkDevice, loadedCache, nullptr);
+
+        return result;
+    }
+
     CommandRecordingContext* Device::GetPendingRecordingContext() {
         ASSERT(mRecordingContext.commandBuffer != VK_NULL_HANDLE);
         mRecordingContext.used = true;
@@ -279,24 +442,88 @@ namespace dawn_native { namespace vulkan {
         DAWN_TRY(CheckVkSuccess(fn.EndCommandBuffer(mRecordingContext.commandBuffer),
                                 "vkEndCommandBuffer"));
 
-        std::vector<VkPipelineStageFlags> dstStageMasks(mRecordingContext.waitSemaphores.size(),
-                                                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        // The arrays given to vkQueueSubmit are kept between submits so that they don't get
+        // allocated each time.
+        std::vector<VkSemaphore>& waitSemaphores = mSubmitWaitSemaphores;
+        std::vector<VkPipelineStageFlags>& dstStageMasks = mSubmitWaitStageMasks;
+        std::vector<VkSemaphore>& signalSemaphores = mSubmitSignalSemaphores;
+        std::vector<uint64_t>& signalValues = mSubmitSignalValues;
+
+        std::vector<uint64_t>& waitValues = mSubmitWaitValues;
+
+        waitSemaphores.assign(mRecordingContext.waitSemaphores.begin(),
+                              mRecordingContext.waitSemaphores.end());
+        dstStageMasks.assign(waitSemaphores.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        // Only the work depending on the acceleration containers built by the async compute
+        // queue waits on it, so that the rest of the submit can overlap with the builds.
+        for (VkSemaphore semaphore : mRecordingContext.asyncComputeWaitSemaphores) {
+            waitSemaphores.push_back(semaphore);
+            dstStageMasks.push_back(VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV |
+                                    VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV);
+        }
+
+        signalSemaphores.assign(mRecordingContext.signalSemaphores.begin(),
+                                mRecordingContext.signalSemaphores.end());
+        signalSemaphores.insert(signalSemaphores.end(),
+                                mRecordingContext.asyncComputeSignalSemaphores.begin(),
+                                mRecordingContext.asyncComputeSignalSemaphores.end());
+        signalSemaphores.insert(signalSemaphores.end(),
+                                mRecordingContext.sparseBindSignalSemaphores.begin(),
+                                mRecordingContext.sparseBindSignalSemaphores.end());
+
+        // Values have to be given for all the semaphores but they are ignored for binary
+        // semaphores. External timeline semaphores are only supported along with the device's
+        // own timeline semaphore.
+        ASSERT(mTimelineSemaphore != VK_NULL_HANDLE ||
+               (mRecordingContext.waitTimelineSemaphores.empty() &&
+                mRecordingContext.signalTimelineSemaphores.empty()));
+        waitValues.assign(waitSemaphores.size(), 0);
+        waitSemaphores.insert(waitSemaphores.end(),
+                              mRecordingContext.waitTimelineSemaphores.begin(),
+                              mRecordingContext.waitTimelineSemaphores.end());
+        waitValues.insert(waitValues.end(), mRecordingContext.waitTimelineValues.begin(),
+                          mRecordingContext.waitTimelineValues.end());
+        dstStageMasks.resize(waitSemaphores.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        signalValues.assign(signalSemaphores.size(), 0);
+        signalSemaphores.insert(signalSemaphores.end(),
+                                mRecordingContext.signalTimelineSemaphores.begin(),
+                                mRecordingContext.signalTimelineSemaphores.end());
+        signalValues.insert(signalValues.end(), mRecordingContext.signalTimelineValues.begin(),
+                            mRecordingContext.signalTimelineValues.end());
+
+        // The timeline semaphore gets signaled with the serial of the submit.
+        Serial submitSerial = mLastSubmittedSerial + 1;
+        VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo;
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            signalSemaphores.push_back(mTimelineSemaphore);
+            signalValues.push_back(submitSerial);
+
+            timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+            timelineSubmitInfo.pNext = nullptr;
+            timelineSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+            timelineSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+            timelineSubmitInfo.signalSemaphoreValueCount =
+                static_cast<uint32_t>(signalValues.size());
+            timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+        }
 
         VkSubmitInfo submitInfo;
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.pNext = nullptr;
-        submitInfo.waitSemaphoreCount =
-            static_cast<uint32_t>(mRecordingContext.waitSemaphores.size());
-        submitInfo.pWaitSemaphores = AsVkArray(mRecordingContext.waitSemaphores.data());
+        submitInfo.pNext = mTimelineSemaphore != VK_NULL_HANDLE ? &timelineSubmitInfo : nullptr;
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = AsVkArray(waitSemaphores.data());
         submitInfo.pWaitDstStageMask = dstStageMasks.data();
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &mRecordingContext.commandBuffer;
-        submitInfo.signalSemaphoreCount =
-            static_cast<uint32_t>(mRecordingContext.signalSemaphores.size());
-        submitInfo.pSignalSemaphores = AsVkArray(mRecordingContext.signalSemaphores.data());
+        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+        submitInfo.pSignalSemaphores = AsVkArray(signalSemaphores.data());
 
+        // Without timeline semaphores, each submit gets a fence to poll for its completion.
         VkFence fence = VK_NULL_HANDLE;
-        DAWN_TRY_ASSIGN(fence, GetUnusedFence());
+        if (mTimelineSemaphore == VK_NULL_HANDLE) {
+            DAWN_TRY_ASSIGN(fence, GetUnusedFence());
+        }
         DAWN_TRY(CheckVkSuccess(fn.QueueSubmit(mQueue, 1, &submitInfo, fence), "vkQueueSubmit"));
 
         // Enqueue the semaphores before incrementing the serial, so that they can be deleted as
@@ -308,8 +535,12 @@ namespace dawn_native { namespace vulkan {
             mDeleter->DeleteWhenUnused(semaphore);
         }
 
-        mLastSubmittedSerial++;
-        mFencesInFlight.emplace(fence, mLastSubmittedSerial);
+        mLastSubmittedSerial = submitSerial;
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            mLastTimelineSignalValue = submitSerial;
+        } else {
+            mFencesInFlight.emplace(fence, submitSerial);
+        }
 
         CommandPoolAndBuffer submittedCommands = {mRecordingContext.commandPool,
                                                   mRecordingContext.commandBuffer};
@@ -320,6 +551,111 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    ResultOrError<CommandRecordingContext*> Device::BeginAsyncComputeCommands() {
+        ASSERT(HasAsyncComputeQueue());
+        ASSERT(mAsyncComputeRecordingContext.commandBuffer == VK_NULL_HANDLE);
+
+        // The graphics commands recorded so far get submitted right away, so that the async
+        // compute commands can wait on them.
+        VkSemaphore graphicsSemaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(graphicsSemaphore, CreateQueueSemaphore());
+        mRecordingContext.asyncComputeSignalSemaphores.push_back(graphicsSemaphore);
+        mRecordingContext.used = true;
+        DAWN_TRY(SubmitPendingCommands());
+
+        DAWN_TRY(PrepareRecordingContext(&mAsyncComputeRecordingContext, mAsyncComputeQueueFamily,
+                                         mAsyncComputeCommandPoolRecycler.get()));
+        mAsyncComputeRecordingContext.waitSemaphores.push_back(graphicsSemaphore);
+        mAsyncComputeRecordingContext.used = true;
+        return &mAsyncComputeRecordingContext;
+    }
+
+    MaybeError Device::SubmitAsyncComputeCommands() {
+        ASSERT(mAsyncComputeRecordingContext.used);
+
+        DAWN_TRY(CheckVkSuccess(fn.EndCommandBuffer(mAsyncComputeRecordingContext.commandBuffer),
+                                "vkEndCommandBuffer"));
+
+        VkSemaphore computeSemaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(computeSemaphore, CreateQueueSemaphore());
+
+        std::vector<VkSemaphore>& waitSemaphores = mAsyncComputeRecordingContext.waitSemaphores;
+        std::vector<VkPipelineStageFlags>& dstStageMasks = mSubmitWaitStageMasks;
+        dstStageMasks.assign(waitSemaphores.size(),
+                             VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_NV);
+
+        VkSubmitInfo submitInfo;
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = nullptr;
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = AsVkArray(waitSemaphores.data());
+        submitInfo.pWaitDstStageMask = dstStageMasks.data();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &mAsyncComputeRecordingContext.commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &*computeSemaphore;
+
+        DAWN_TRY(CheckVkSuccess(fn.QueueSubmit(mAsyncComputeQueue, 1, &submitInfo, VK_NULL_HANDLE),
+                                "vkQueueSubmit"));
+
+        // The next graphics submit waits on the async compute one, so both are finished once the
+        // pending serial is.
+        mRecordingContext.asyncComputeWaitSemaphores.push_back(computeSemaphore);
+        mRecordingContext.used = true;
+
+        for (VkSemaphore semaphore : waitSemaphores) {
+            mDeleter->DeleteWhenUnused(semaphore);
+        }
+        mDeleter->DeleteWhenUnused(computeSemaphore);
+
+        CommandPoolAndBuffer submittedCommands = {mAsyncComputeRecordingContext.commandPool,
+                                                  mAsyncComputeRecordingContext.commandBuffer};
+        mAsyncComputeCommandsInFlight.Enqueue(submittedCommands, GetPendingCommandSerial());
+        mAsyncComputeRecordingContext = CommandRecordingContext();
+
+        return {};
+    }
+
+    MaybeError Device::BindSparse(VkBindSparseInfo* bindInfo) {
+        // The commands recorded so far get submitted right away so that the bind can wait on
+        // them.
+        VkSemaphore commandsSemaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(commandsSemaphore, CreateQueueSemaphore());
+        mRecordingContext.sparseBindSignalSemaphores.push_back(commandsSemaphore);
+        mRecordingContext.used = true;
+        DAWN_TRY(SubmitPendingCommands());
+
+        VkSemaphore bindSemaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(bindSemaphore, CreateQueueSemaphore());
+
+        bindInfo->waitSemaphoreCount = 1;
+        bindInfo->pWaitSemaphores = &*commandsSemaphore;
+        bindInfo->signalSemaphoreCount = 1;
+        bindInfo->pSignalSemaphores = &*bindSemaphore;
+        DAWN_TRY(CheckVkSuccess(fn.QueueBindSparse(mQueue, 1, bindInfo, VK_NULL_HANDLE),
+                                "vkQueueBindSparse"));
+
+        // The next submit waits on the bind and deletes its semaphore, so both semaphores are
+        // unused once the pending serial completes.
+        mRecordingContext.waitSemaphores.push_back(bindSemaphore);
+        mRecordingContext.used = true;
+        mDeleter->DeleteWhenUnused(commandsSemaphore);
+
+        return {};
+    }
+
+    ResultOrError<VkSemaphore> Device::CreateQueueSemaphore() {
+        VkSemaphoreCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        DAWN_TRY(CheckVkSuccess(fn.CreateSemaphore(mVkDevice, &createInfo, nullptr, &*semaphore),
+                                "vkCreateSemaphore"));
+        return semaphore;
+    }
+
     ResultOrError<VulkanDeviceKnobs> Device::CreateDevice(VkPhysicalDevice physicalDevice) {
         VulkanDeviceKnobs usedKnobs = {};
 
@@ -380,6 +716,97 @@ namespace dawn_native { namespace vulkan {
             extensionsToRequest.push_back(kExtensionNameKhrGetMemoryRequirements2);
             usedKnobs.memoryRequirements2 = true;
         }
+        // The dedicated requirements are queried with vkGet*MemoryRequirements2.
+        if (mDeviceInfo.dedicatedAllocation && mDeviceInfo.memoryRequirements2) {
+            extensionsToRequest.push_back(kExtensionNameKhrDedicatedAllocation);
+            usedKnobs.dedicatedAllocation = true;
+        }
+        if (mDeviceInfo.descriptorUpdateTemplate) {
+            extensionsToRequest.push_back(kExtensionNameKhrDescriptorUpdateTemplate);
+            usedKnobs.descriptorUpdateTemplate = true;
+        }
+        if (mDeviceInfo.pushDescriptor) {
+            extensionsToRequest.push_back(kExtensionNameKhrPushDescriptor);
+            usedKnobs.pushDescriptor = true;
+        }
+        if (IsExtensionEnabled(Extension::DrawIndirectCount)) {
+            ASSERT(mDeviceInfo.drawIndirectCount);
+            extensionsToRequest.push_back(kExtensionNameKhrDrawIndirectCount);
+            usedKnobs.drawIndirectCount = true;
+        }
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures = {};
+        conditionalRenderingFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+        if (IsExtensionEnabled(Extension::ConditionalRendering)) {
+            ASSERT(mDeviceInfo.conditionalRendering);
+            extensionsToRequest.push_back(kExtensionNameExtConditionalRendering);
+            usedKnobs.conditionalRendering = true;
+            conditionalRenderingFeatures.conditionalRendering = VK_TRUE;
+        }
+        // The resource tables are descriptor sets updated after they are bound.
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+        descriptorIndexingFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        if (IsExtensionEnabled(Extension::ResourceTables)) {
+            ASSERT(mDeviceInfo.descriptorIndexing && mDeviceInfo.maintenance3);
+            if (mDeviceInfo.properties.apiVersion < VK_MAKE_VERSION(1, 1, 0)) {
+                extensionsToRequest.push_back(kExtensionNameKhrMaintenance3);
+            }
+            extensionsToRequest.push_back(kExtensionNameExtDescriptorIndexing);
+            usedKnobs.maintenance3 = true;
+            usedKnobs.descriptorIndexing = true;
+            descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            descriptorIndexingFeatures.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        }
+        // Only used to report the presentation timings of swapchains.
+        if (mDeviceInfo.displayTiming && mDeviceInfo.swapchain) {
+            extensionsToRequest.push_back(kExtensionNameGoogleDisplayTiming);
+            usedKnobs.displayTiming = true;
+        }
+        // The budget is queried with vkGetPhysicalDeviceMemoryProperties2.
+        if (mDeviceInfo.memoryBudget && fn.GetPhysicalDeviceMemoryProperties2 != nullptr) {
+            extensionsToRequest.push_back(kExtensionNameExtMemoryBudget);
+            usedKnobs.memoryBudget = true;
+        }
+
+        // The timeline semaphore replaces the fences used to poll for the completion of submits,
+        // but only if the feature is supported too.
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures = {};
+        timelineSemaphoreFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+        if (mDeviceInfo.timelineSemaphore && fn.GetPhysicalDeviceFeatures2 != nullptr) {
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &timelineSemaphoreFeatures;
+            fn.GetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+            if (timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE) {
+                extensionsToRequest.push_back(kExtensionNameKhrTimelineSemaphore);
+                usedKnobs.timelineSemaphore = true;
+            }
+        }
+
+        // The memory priority lets the driver page out the memory of the resources with the
+        // lowest residency priority first when the heaps are oversubscribed.
+        VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeatures = {};
+        memoryPriorityFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+        if (mDeviceInfo.memoryPriority && fn.GetPhysicalDeviceFeatures2 != nullptr) {
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &memoryPriorityFeatures;
+            fn.GetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+            if (memoryPriorityFeatures.memoryPriority == VK_TRUE) {
+                extensionsToRequest.push_back(kExtensionNameExtMemoryPriority);
+                usedKnobs.memoryPriority = true;
+            }
+        }
 
         // Always require independentBlend because it is a core Dawn feature
         usedKnobs.features.independentBlend = VK_TRUE;
@@ -387,6 +814,8 @@ namespace dawn_native { namespace vulkan {
         usedKnobs.features.imageCubeArray = VK_TRUE;
         // Always require fragmentStoresAndAtomics because it is required by end2end tests.
         usedKnobs.features.fragmentStoresAndAtomics = VK_TRUE;
+        // Multi draw indirect commands are split into single draws without multiDrawIndirect.
+        usedKnobs.features.multiDrawIndirect = mDeviceInfo.features.multiDrawIndirect;
 
         if (IsExtensionEnabled(Extension::TextureCompressionBC)) {
             ASSERT(ToBackend(GetAdapter())->GetDeviceInfo().features.textureCompressionBC ==
@@ -394,6 +823,18 @@ namespace dawn_native { namespace vulkan {
             usedKnobs.features.textureCompressionBC = VK_TRUE;
         }
 
+        if (IsExtensionEnabled(Extension::PipelineStatisticsQuery)) {
+            ASSERT(ToBackend(GetAdapter())->GetDeviceInfo().features.pipelineStatisticsQuery ==
+                   VK_TRUE);
+            usedKnobs.features.pipelineStatisticsQuery = VK_TRUE;
+        }
+
+        if (IsExtensionEnabled(Extension::SparseResources)) {
+            usedKnobs.features.sparseBinding = VK_TRUE;
+            usedKnobs.features.sparseResidencyBuffer = VK_TRUE;
+            usedKnobs.features.sparseResidencyImage2D = VK_TRUE;
+        }
+
         // Find a universal queue family
         {
             // Note that GRAPHICS and COMPUTE imply TRANSFER so we don't need to check for it.
@@ -413,6 +854,18 @@ namespace dawn_native { namespace vulkan {
             mQueueFamily = static_cast<uint32_t>(universalQueueFamily);
         }
 
+        // Find a compute queue family without graphics support for the async compute queue
+        if (IsToggleEnabled(Toggle::VulkanUseAsyncComputeForAccelerationContainerBuilds)) {
+            for (unsigned int i = 0; i < mDeviceInfo.queueFamilies.size(); ++i) {
+                VkQueueFlags flags = mDeviceInfo.queueFamilies[i].queueFlags;
+                if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+                    mAsyncComputeQueueFamily = i;
+                    mUseAsyncComputeQueue = true;
+                    break;
+                }
+            }
+        }
+
         // Choose to create a single universal queue
         {
             VkDeviceQueueCreateInfo queueCreateInfo;
@@ -426,9 +879,41 @@ namespace dawn_native { namespace vulkan {
             queuesToRequest.push_back(queueCreateInfo);
         }
 
+        // And a single async compute queue
+        if (mUseAsyncComputeQueue) {
+            VkDeviceQueueCreateInfo queueCreateInfo;
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.pNext = nullptr;
+            queueCreateInfo.flags = 0;
+            queueCreateInfo.queueFamilyIndex = mAsyncComputeQueueFamily;
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &zero;
+
+            queuesToRequest.push_back(queueCreateInfo);
+        }
+
+        // Chain the feature structs of the extensions that are used.
+        void* featuresChain = nullptr;
+        if (usedKnobs.memoryPriority) {
+            memoryPriorityFeatures.pNext = featuresChain;
+            featuresChain = &memoryPriorityFeatures;
+        }
+        if (usedKnobs.timelineSemaphore) {
+            timelineSemaphoreFeatures.pNext = featuresChain;
+            featuresChain = &timelineSemaphoreFeatures;
+        }
+        if (usedKnobs.conditionalRendering) {
+            conditionalRenderingFeatures.pNext = featuresChain;
+            featuresChain = &conditionalRenderingFeatures;
+        }
+        if (usedKnobs.descriptorIndexing) {
+            descriptorIndexingFeatures.pNext = featuresChain;
+            featuresChain = &descriptorIndexingFeatures;
+        }
+
         VkDeviceCreateInfo createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        createInfo.pNext = nullptr;
+        createInfo.pNext = featuresChain;
         createInfo.flags = 0;
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queuesToRequest.size());
         createInfo.pQueueCreateInfos = queuesToRequest.data();
@@ -448,6 +933,9 @@ namespace dawn_native { namespace vulkan {
 
     void Device::GatherQueueFromDevice() {
         fn.GetDeviceQueue(mVkDevice, mQueueFamily, 0, &mQueue);
+        if (mUseAsyncComputeQueue) {
+            fn.GetDeviceQueue(mVkDevice, mAsyncComputeQueueFamily, 0, &mAsyncComputeQueue);
+        }
     }
 
     void Device::InitTogglesFromDriver() {
@@ -497,8 +985,6 @@ namespace dawn_native { namespace vulkan {
     ResultOrError<VkFence> Device::GetUnusedFence() {
         if (!mUnusedFences.empty()) {
             VkFence fence = mUnusedFences.back();
-            DAWN_TRY(CheckVkSuccess(fn.ResetFences(mVkDevice, 1, &*fence), "vkResetFences"));
-
             mUnusedFences.pop_back();
             return fence;
         }
@@ -515,7 +1001,43 @@ namespace dawn_native { namespace vulkan {
         return fence;
     }
 
-    void Device::CheckPassedFences() {
+    MaybeError Device::CreateTimelineSemaphore() {
+        VkSemaphoreTypeCreateInfoKHR typeCreateInfo;
+        typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeCreateInfo.pNext = nullptr;
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeCreateInfo.initialValue = mCompletedSerial;
+
+        VkSemaphoreCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        createInfo.pNext = &typeCreateInfo;
+        createInfo.flags = 0;
+
+        return CheckVkSuccess(
+            fn.CreateSemaphore(mVkDevice, &createInfo, nullptr, &*mTimelineSemaphore),
+            "vkCreateSemaphore");
+    }
+
+    void Device::CheckPassedSerials() {
+        // A single query of the timeline semaphore tells which serials completed.
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            uint64_t completedValue = 0;
+            VkResult result = VkResult::WrapUnsafe(INJECT_ERROR_OR_RUN(
+                fn.GetSemaphoreCounterValueKHR(mVkDevice, mTimelineSemaphore, &completedValue),
+                VK_ERROR_DEVICE_LOST));
+            // TODO: Handle DeviceLost error.
+            ASSERT(result == VK_SUCCESS);
+
+            // The completed serial is ahead of the semaphore when it was incremented while there
+            // was no GPU work in flight.
+            if (completedValue > mCompletedSerial) {
+                mCompletedSerial = completedValue;
+            }
+            return;
+        }
+
+        // The fences already in the unused list were reset when their submit completed.
+        size_t resetFenceCount = mUnusedFences.size();
         while (!mFencesInFlight.empty()) {
             VkFence fence = mFencesInFlight.front().first;
             Serial fenceSerial = mFencesInFlight.front().second;
@@ -528,7 +1050,7 @@ namespace dawn_native { namespace vulkan {
             // Fence are added in order, so we can stop searching as soon
             // as we see one that's not ready.
             if (result == VK_NOT_READY) {
-                return;
+                break;
             }
 
             mUnusedFences.push_back(fence);
@@ -537,43 +1059,111 @@ namespace dawn_native { namespace vulkan {
             ASSERT(fenceSerial > mCompletedSerial);
             mCompletedSerial = fenceSerial;
         }
+
+        // Reset all the completed fences with a single call instead of one per submit.
+        if (mUnusedFences.size() > resetFenceCount) {
+            VkResult result = VkResult::WrapUnsafe(INJECT_ERROR_OR_RUN(
+                fn.ResetFences(mVkDevice,
+                               static_cast<uint32_t>(mUnusedFences.size() - resetFenceCount),
+                               AsVkArray(mUnusedFences.data() + resetFenceCount)),
+                VK_ERROR_DEVICE_LOST));
+            // TODO: Handle DeviceLost error.
+            ASSERT(result == VK_SUCCESS);
+        }
+    }
+
+    bool Device::WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs) {
+        // The fences are owned by the thread using the device, only the timeline semaphore can be
+        // waited on from another thread.
+        if (mTimelineSemaphore == VK_NULL_HANDLE) {
+            return DeviceBase::WaitForSerialFromCompletionThread(serial, timeoutNs);
+        }
+
+        uint64_t value = serial;
+        VkSemaphoreWaitInfoKHR waitInfo;
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+        waitInfo.pNext = nullptr;
+        waitInfo.flags = 0;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &*mTimelineSemaphore;
+        waitInfo.pValues = &value;
+
+        // Device loss is reported by the next tick.
+        VkResult result =
+            VkResult::WrapUnsafe(fn.WaitSemaphoresKHR(mVkDevice, &waitInfo, timeoutNs));
+        return result != VK_TIMEOUT;
+    }
+
+    MaybeError Device::WaitForSerial(Serial serial) {
+        ASSERT(serial <= mLastSubmittedSerial);
+        CheckPassedSerials();
+
+        if (serial > mCompletedSerial && mTimelineSemaphore != VK_NULL_HANDLE) {
+            uint64_t value = serial;
+            VkSemaphoreWaitInfoKHR waitInfo;
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            waitInfo.pNext = nullptr;
+            waitInfo.flags = 0;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &*mTimelineSemaphore;
+            waitInfo.pValues = &value;
+
+            DAWN_TRY(CheckVkSuccess(fn.WaitSemaphoresKHR(mVkDevice, &waitInfo, UINT64_MAX),
+                                    "vkWaitSemaphoresKHR"));
+            CheckPassedSerials();
+        }
+
+        // Fences are in serial order, so waiting on the oldest ones until the serial is passed
+        // waits on the fence of the serial last.
+        while (serial > mCompletedSerial) {
+            ASSERT(!mFencesInFlight.empty());
+            VkFence fence = mFencesInFlight.front().first;
+            DAWN_TRY(CheckVkSuccess(fn.WaitForFences(mVkDevice, 1, &*fence, true, UINT64_MAX),
+                                    "vkWaitForFences"));
+            CheckPassedSerials();
+        }
+
+        return {};
     }
 
     MaybeError Device::PrepareRecordingContext() {
-        ASSERT(!mRecordingContext.used);
-        ASSERT(mRecordingContext.commandBuffer == VK_NULL_HANDLE);
-        ASSERT(mRecordingContext.commandPool == VK_NULL_HANDLE);
-
-        // First try to recycle unused command pools.
-        if (!mUnusedCommands.empty()) {
-            CommandPoolAndBuffer commands = mUnusedCommands.back();
-            mUnusedCommands.pop_back();
-            DAWN_TRY(CheckVkSuccess(fn.ResetCommandPool(mVkDevice, commands.pool, 0),
-                                    "vkResetCommandPool"));
+        return PrepareRecordingContext(&mRecordingContext, mQueueFamily,
+                                       mCommandPoolRecycler.get());
+    }
 
-            mRecordingContext.commandBuffer = commands.commandBuffer;
-            mRecordingContext.commandPool = commands.pool;
+    MaybeError Device::PrepareRecordingContext(CommandRecordingContext* recordingContext,
+                                               uint32_t queueFamily,
+                                               CommandPoolRecycler* recycler) {
+        ASSERT(!recordingContext->used);
+        ASSERT(recordingContext->commandBuffer == VK_NULL_HANDLE);
+        ASSERT(recordingContext->commandPool == VK_NULL_HANDLE);
+
+        // First try to recycle unused command pools, they were already reset by the recycler.
+        CommandPoolAndBuffer commands;
+        if (recycler->AcquireCommands(&commands)) {
+            recordingContext->commandBuffer = commands.commandBuffer;
+            recordingContext->commandPool = commands.pool;
         } else {
             // Create a new command pool for our commands and allocate the command buffer.
             VkCommandPoolCreateInfo createInfo;
             createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
             createInfo.pNext = nullptr;
             createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-            createInfo.queueFamilyIndex = mQueueFamily;
+            createInfo.queueFamilyIndex = queueFamily;
 
             DAWN_TRY(CheckVkSuccess(fn.CreateCommandPool(mVkDevice, &createInfo, nullptr,
-                                                         &*mRecordingContext.commandPool),
+                                                         &*recordingContext->commandPool),
                                     "vkCreateCommandPool"));
 
             VkCommandBufferAllocateInfo allocateInfo;
             allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
             allocateInfo.pNext = nullptr;
-            allocateInfo.commandPool = mRecordingContext.commandPool;
+            allocateInfo.commandPool = recordingContext->commandPool;
             allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
             allocateInfo.commandBufferCount = 1;
 
             DAWN_TRY(CheckVkSuccess(fn.AllocateCommandBuffers(mVkDevice, &allocateInfo,
-                                                              &mRecordingContext.commandBuffer),
+                                                              &recordingContext->commandBuffer),
                                     "vkAllocateCommandBuffers"));
         }
 
@@ -584,15 +1174,136 @@ namespace dawn_native { namespace vulkan {
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         beginInfo.pInheritanceInfo = nullptr;
 
-        return CheckVkSuccess(fn.BeginCommandBuffer(mRecordingContext.commandBuffer, &beginInfo),
+        return CheckVkSuccess(fn.BeginCommandBuffer(recordingContext->commandBuffer, &beginInfo),
                               "vkBeginCommandBuffer");
     }
 
     void Device::RecycleCompletedCommands() {
+        ASSERT(mCompletedCommands.empty());
         for (auto& commands : mCommandsInFlight.IterateUpTo(mCompletedSerial)) {
-            mUnusedCommands.push_back(commands);
+            mCompletedCommands.push_back(commands);
         }
         mCommandsInFlight.ClearUpTo(mCompletedSerial);
+        mCommandPoolRecycler->Recycle(&mCompletedCommands);
+
+        for (auto& commands : mAsyncComputeCommandsInFlight.IterateUpTo(mCompletedSerial)) {
+            mCompletedCommands.push_back(commands);
+        }
+        mAsyncComputeCommandsInFlight.ClearUpTo(mCompletedSerial);
+        mAsyncComputeCommandPoolRecycler->Recycle(&mCompletedCommands);
+
+        for (auto& pool : mSecondaryCommandPoolsInFlight.IterateUpTo(mCompletedSerial)) {
+            mUnusedSecondaryCommandPools.push_back(std::move(pool));
+        }
+        mSecondaryCommandPoolsInFlight.ClearUpTo(mCompletedSerial);
+    }
+
+    WorkerThreadPool* Device::GetRecordingThreadPool() {
+        if (mRecordingThreadPool == nullptr) {
+            // The submitting thread records too, so it doesn't need a worker of its own.
+            uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+            uint32_t workerCount = hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0;
+            mRecordingThreadPool = std::make_unique<WorkerThreadPool>(workerCount);
+        }
+        return mRecordingThreadPool.get();
+    }
+
+    ResultOrError<SecondaryCommandPool> Device::AcquireSecondaryCommandPool() {
+        if (!mUnusedSecondaryCommandPools.empty()) {
+            SecondaryCommandPool pool = std::move(mUnusedSecondaryCommandPools.back());
+            mUnusedSecondaryCommandPools.pop_back();
+            DAWN_TRY(CheckVkSuccess(fn.ResetCommandPool(mVkDevice, pool.pool, 0),
+                                    "vkResetCommandPool"));
+
+            pool.usedCount = 0;
+            return std::move(pool);
+        }
+
+        VkCommandPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        createInfo.queueFamilyIndex = mQueueFamily;
+
+        SecondaryCommandPool pool;
+        DAWN_TRY(CheckVkSuccess(fn.CreateCommandPool(mVkDevice, &createInfo, nullptr, &*pool.pool),
+                                "vkCreateCommandPool"));
+        return std::move(pool);
+    }
+
+    ResultOrError<VkCommandBuffer> Device::BeginSecondaryCommandBuffer(SecondaryCommandPool* pool,
+                                                                       VkRenderPass renderPass) {
+        if (pool->usedCount == pool->commandBuffers.size()) {
+            VkCommandBufferAllocateInfo allocateInfo;
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.pNext = nullptr;
+            allocateInfo.commandPool = pool->pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocateInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commands = VK_NULL_HANDLE;
+            DAWN_TRY(CheckVkSuccess(fn.AllocateCommandBuffers(mVkDevice, &allocateInfo, &commands),
+                                    "vkAllocateCommandBuffers"));
+            pool->commandBuffers.push_back(commands);
+        }
+        VkCommandBuffer commands = pool->commandBuffers[pool->usedCount++];
+
+        DAWN_TRY(BeginSecondaryInRenderPass(commands, renderPass,
+                                            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+        return commands;
+    }
+
+    MaybeError Device::BeginSecondaryInRenderPass(VkCommandBuffer commands,
+                                                  VkRenderPass renderPass,
+                                                  VkCommandBufferUsageFlags flags) {
+        // The framebuffer isn't known yet, it is created when the render pass begins in the
+        // primary command buffer.
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = nullptr;
+        inheritanceInfo.renderPass = renderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+        inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+        inheritanceInfo.queryFlags = 0;
+        inheritanceInfo.pipelineStatistics = 0;
+
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        return CheckVkSuccess(fn.BeginCommandBuffer(commands, &beginInfo), "vkBeginCommandBuffer");
+    }
+
+    MaybeError Device::BeginSecondaryOutsideRenderPass(VkCommandBuffer commands,
+                                                       VkCommandBufferUsageFlags flags) {
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = nullptr;
+        inheritanceInfo.renderPass = VK_NULL_HANDLE;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+        inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+        inheritanceInfo.queryFlags = 0;
+        inheritanceInfo.pipelineStatistics = 0;
+
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = flags;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        return CheckVkSuccess(fn.BeginCommandBuffer(commands, &beginInfo), "vkBeginCommandBuffer");
+    }
+
+    void Device::ReleaseSecondaryCommandPool(SecondaryCommandPool pool) {
+        mSecondaryCommandPoolsInFlight.Enqueue(std::move(pool), GetPendingCommandSerial());
+    }
+
+    std::mutex* Device::GetRenderBundleReplayMutex() {
+        return &mRenderBundleReplayMutex;
     }
 
     ResultOrError<std::unique_ptr<StagingBufferBase>> Device::CreateStagingBuffer(size_t size) {
@@ -632,10 +1343,43 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Device::CopyFromStagingToTexture(StagingBufferBase* source,
+                                                uint64_t sourceOffset,
+                                                uint32_t rowPitch,
+                                                uint32_t imageHeight,
+                                                const TextureCopy& destination,
+                                                const Extent3D& copySize) {
+        CommandRecordingContext* recordingContext = GetPendingRecordingContext();
+        Texture* texture = ToBackend(destination.texture.Get());
+
+        if (IsCompleteSubresourceCopiedTo(texture, copySize, destination.mipLevel)) {
+            texture->SetIsSubresourceContentInitialized(true, destination.mipLevel, 1,
+                                                        destination.arrayLayer, 1);
+        } else {
+            texture->EnsureSubresourceContentInitialized(recordingContext, destination.mipLevel,
+                                                         1, destination.arrayLayer, 1);
+        }
+        texture->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst,
+                                    destination.mipLevel, 1, destination.arrayLayer, 1);
+
+        BufferCopy bufferCopy;
+        bufferCopy.offset = sourceOffset;
+        bufferCopy.rowPitch = rowPitch;
+        bufferCopy.imageHeight = imageHeight;
+        VkBufferImageCopy region = ComputeBufferImageCopyRegion(bufferCopy, destination, copySize);
+
+        this->fn.CmdCopyBufferToImage(recordingContext->commandBuffer,
+                                      ToBackend(source)->GetBufferHandle(), texture->GetHandle(),
+                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        return {};
+    }
+
     MaybeError Device::ImportExternalImage(const ExternalImageDescriptor* descriptor,
                                            ExternalMemoryHandle memoryHandle,
                                            VkImage image,
                                            const std::vector<ExternalSemaphoreHandle>& waitHandles,
+                                           bool useTimelineSemaphore,
                                            VkSemaphore* outSignalSemaphore,
                                            VkDeviceMemory* outAllocation,
                                            std::vector<VkSemaphore>* outWaitSemaphores) {
@@ -655,9 +1399,12 @@ namespace dawn_native { namespace vulkan {
             return DAWN_VALIDATION_ERROR("External memory usage not supported");
         }
 
-        // Create an external semaphore to signal when the texture is done being used
-        DAWN_TRY_ASSIGN(*outSignalSemaphore,
-                        mExternalSemaphoreService->CreateExportableSemaphore());
+        // Create an external semaphore to signal when the texture is done being used, unless
+        // the texture is released by signaling a timeline semaphore.
+        if (!useTimelineSemaphore) {
+            DAWN_TRY_ASSIGN(*outSignalSemaphore,
+                            mExternalSemaphoreService->CreateExportableSemaphore());
+        }
 
         // Import the external image's memory
         external_memory::MemoryImportParams importParams;
@@ -690,10 +1437,159 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Device::SignalExternalTextureTimeline(Texture* texture, uint64_t value) {
+        DAWN_TRY(ValidateObject(texture));
+        return texture->SignalTimelineAndDestroy(value);
+    }
+
+    MaybeError Device::ImportExternalBuffer(const ExternalBufferDescriptor* descriptor,
+                                            ExternalMemoryHandle memoryHandle,
+                                            VkBuffer buffer,
+                                            const std::vector<ExternalSemaphoreHandle>& waitHandles,
+                                            VkSemaphore* outSignalSemaphore,
+                                            VkDeviceMemory* outAllocation,
+                                            std::vector<VkSemaphore>* outWaitSemaphores) {
+        if (!mExternalSemaphoreService->Supported()) {
+            return DAWN_VALIDATION_ERROR("External semaphore usage not supported");
+        }
+
+        // Create an external semaphore to signal when the buffer is done being used
+        DAWN_TRY_ASSIGN(*outSignalSemaphore,
+                        mExternalSemaphoreService->CreateExportableSemaphore());
+
+        // Import the external buffer's memory
+        external_memory::MemoryImportParams importParams;
+        DAWN_TRY_ASSIGN(importParams,
+                        mExternalMemoryService->GetBufferMemoryImportParams(descriptor, buffer));
+        DAWN_TRY_ASSIGN(*outAllocation, mExternalMemoryService->ImportBufferMemory(
+                                            memoryHandle, importParams, buffer));
+
+        // Import semaphores we have to wait on before using the buffer
+        for (const ExternalSemaphoreHandle& handle : waitHandles) {
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            DAWN_TRY_ASSIGN(semaphore, mExternalSemaphoreService->ImportSemaphore(handle));
+            outWaitSemaphores->push_back(semaphore);
+        }
+
+        return {};
+    }
+
+    BufferBase* Device::CreateBufferWrappingVulkanBuffer(
+        const ExternalBufferDescriptor* descriptor,
+        ExternalMemoryHandle memoryHandle,
+        const std::vector<ExternalSemaphoreHandle>& waitHandles) {
+        const BufferDescriptor* bufferDescriptor =
+            reinterpret_cast<const BufferDescriptor*>(descriptor->cBufferDescriptor);
+
+        // Initial validation
+        if (ConsumedError(ValidateBufferDescriptor(this, bufferDescriptor))) {
+            return nullptr;
+        }
+        if (ConsumedError(ValidateVulkanBufferCanBeWrapped(this, bufferDescriptor))) {
+            return nullptr;
+        }
+
+        VkSemaphore signalSemaphore = VK_NULL_HANDLE;
+        VkDeviceMemory allocation = VK_NULL_HANDLE;
+        std::vector<VkSemaphore> waitSemaphores;
+        waitSemaphores.reserve(waitHandles.size());
+
+        // Cleanup in case of a failure, the buffer creation doesn't acquire the external objects
+        // if a failure happens.
+        Buffer* result = nullptr;
+        if (ConsumedError(Buffer::CreateFromExternal(this, bufferDescriptor, descriptor,
+                                                     mExternalMemoryService.get()),
+                          &result) ||
+            ConsumedError(ImportExternalBuffer(descriptor, memoryHandle, result->GetHandle(),
+                                               waitHandles, &signalSemaphore, &allocation,
+                                               &waitSemaphores)) ||
+            ConsumedError(
+                result->BindExternalMemory(signalSemaphore, allocation, waitSemaphores))) {
+            // Delete the Buffer if it was created
+            if (result != nullptr) {
+                delete result;
+            }
+
+            // Clear the signal semaphore
+            fn.DestroySemaphore(GetVkDevice(), signalSemaphore, nullptr);
+
+            // Clear buffer memory
+            fn.FreeMemory(GetVkDevice(), allocation, nullptr);
+
+            // Clear any wait semaphores we were able to import
+            for (VkSemaphore semaphore : waitSemaphores) {
+                fn.DestroySemaphore(GetVkDevice(), semaphore, nullptr);
+            }
+            return nullptr;
+        }
+
+        return result;
+    }
+
+    MaybeError Device::SignalAndExportExternalBuffer(Buffer* buffer,
+                                                     ExternalSemaphoreHandle* outHandle) {
+        DAWN_TRY(ValidateObject(buffer));
+
+        VkSemaphore outSignalSemaphore;
+        DAWN_TRY(buffer->SignalAndDestroy(&outSignalSemaphore));
+
+        // This has to happen right after SignalAndDestroy, since the semaphore will be
+        // deleted when the fenced deleter runs after the queue submission
+        DAWN_TRY_ASSIGN(*outHandle, mExternalSemaphoreService->ExportSemaphore(outSignalSemaphore));
+
+        return {};
+    }
+
+    bool Device::SupportsExternalTimelineSemaphores() const {
+        return mExternalSemaphoreService->SupportsTimeline();
+    }
+
+    MaybeError Device::ValidateExternalTimelineSemaphore(VkSemaphore semaphore) const {
+        if (std::find(mExternalTimelineSemaphores.begin(), mExternalTimelineSemaphores.end(),
+                      semaphore) == mExternalTimelineSemaphores.end()) {
+            return DAWN_VALIDATION_ERROR("Unknown external timeline semaphore");
+        }
+        return {};
+    }
+
+    ResultOrError<VkSemaphore> Device::ImportExternalTimelineSemaphore(
+        ExternalSemaphoreHandle handle) {
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(semaphore, mExternalSemaphoreService->ImportTimelineSemaphore(handle));
+        mExternalTimelineSemaphores.push_back(semaphore);
+        return semaphore;
+    }
+
+    ResultOrError<VkSemaphore> Device::CreateExportableTimelineSemaphore(uint64_t initialValue) {
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        DAWN_TRY_ASSIGN(semaphore,
+                        mExternalSemaphoreService->CreateExportableTimelineSemaphore(initialValue));
+        mExternalTimelineSemaphores.push_back(semaphore);
+        return semaphore;
+    }
+
+    ResultOrError<ExternalSemaphoreHandle> Device::ExportExternalTimelineSemaphore(
+        VkSemaphore semaphore) {
+        DAWN_TRY(ValidateExternalTimelineSemaphore(semaphore));
+        return mExternalSemaphoreService->ExportSemaphore(semaphore);
+    }
+
+    MaybeError Device::ReleaseExternalTimelineSemaphore(VkSemaphore semaphore) {
+        DAWN_TRY(ValidateExternalTimelineSemaphore(semaphore));
+
+        // Pending submits can still wait on or signal the semaphore.
+        mExternalTimelineSemaphores.erase(std::find(mExternalTimelineSemaphores.begin(),
+                                                    mExternalTimelineSemaphores.end(), semaphore));
+        mDeleter->DeleteWhenUnused(semaphore);
+        return {};
+    }
+
     TextureBase* Device::CreateTextureWrappingVulkanImage(
         const ExternalImageDescriptor* descriptor,
         ExternalMemoryHandle memoryHandle,
-        const std::vector<ExternalSemaphoreHandle>& waitHandles) {
+        const std::vector<ExternalSemaphoreHandle>& waitHandles,
+        VkSemaphore timelineSemaphore,
+        uint64_t waitTimelineValue) {
         const TextureDescriptor* textureDescriptor =
             reinterpret_cast<const TextureDescriptor*>(descriptor->cTextureDescriptor);
 
@@ -704,6 +1600,10 @@ namespace dawn_native { namespace vulkan {
         if (ConsumedError(ValidateVulkanImageCanBeWrapped(this, textureDescriptor))) {
             return nullptr;
         }
+        if (timelineSemaphore != VK_NULL_HANDLE &&
+            ConsumedError(ValidateExternalTimelineSemaphore(timelineSemaphore))) {
+            return nullptr;
+        }
 
         VkSemaphore signalSemaphore = VK_NULL_HANDLE;
         VkDeviceMemory allocation = VK_NULL_HANDLE;
@@ -718,10 +1618,11 @@ namespace dawn_native { namespace vulkan {
                                                       mExternalMemoryService.get()),
                           &result) ||
             ConsumedError(ImportExternalImage(descriptor, memoryHandle, result->GetHandle(),
-                                              waitHandles, &signalSemaphore, &allocation,
-                                              &waitSemaphores)) ||
+                                              waitHandles, timelineSemaphore != VK_NULL_HANDLE,
+                                              &signalSemaphore, &allocation, &waitSemaphores)) ||
             ConsumedError(result->BindExternalMemory(descriptor, signalSemaphore, allocation,
-                                                     waitSemaphores))) {
+                                                     waitSemaphores, timelineSemaphore,
+                                                     waitTimelineValue))) {
             // Delete the Texture if it was created
             if (result != nullptr) {
                 delete result;
@@ -745,8 +1646,34 @@ namespace dawn_native { namespace vulkan {
 
     ResultOrError<ResourceMemoryAllocation> Device::AllocateMemory(
         VkMemoryRequirements requirements,
-        bool mappable) {
-        return mResourceMemoryAllocator->Allocate(requirements, mappable);
+        bool mappable,
+        bool preferHostVisibleDeviceLocal,
+        wgpu::ResidencyPriority priority,
+        const DedicatedAllocation* dedicated) {
+        return mResourceMemoryAllocator->Allocate(
+            requirements, mappable, preferHostVisibleDeviceLocal, priority,
+            dedicated != nullptr ? *dedicated : DedicatedAllocation{});
+    }
+
+    VkMemoryRequirements Device::GetBufferMemoryRequirements(
+        VkBuffer buffer,
+        DedicatedAllocation* dedicated) const {
+        return mResourceMemoryAllocator->GetBufferMemoryRequirements(buffer, dedicated);
+    }
+
+    VkMemoryRequirements Device::GetImageMemoryRequirements(VkImage image,
+                                                            DedicatedAllocation* dedicated) const {
+        return mResourceMemoryAllocator->GetImageMemoryRequirements(image, dedicated);
+    }
+
+    ResultOrError<ResourceMemoryAllocation> Device::AllocateTransientMemory(
+        VkMemoryRequirements requirements) {
+        return mResourceMemoryAllocator->AllocateTransient(requirements);
+    }
+
+    ResultOrError<ResourceMemoryAllocation> Device::AllocateLazilyAllocatedMemory(
+        VkMemoryRequirements requirements) {
+        return mResourceMemoryAllocator->AllocateLazilyAllocated(requirements);
     }
 
     void Device::DeallocateMemory(ResourceMemoryAllocation* allocation) {
@@ -757,18 +1684,69 @@ namespace dawn_native { namespace vulkan {
         return mResourceMemoryAllocator->FindBestTypeIndex(requirements, mappable);
     }
 
+    std::vector<HeapBudget> Device::GetMemoryHeapBudgets() const {
+        return mResourceMemoryAllocator->GetHeapBudgets();
+    }
+
     ResourceMemoryAllocator* Device::GetResourceMemoryAllocatorForTesting() const {
         return mResourceMemoryAllocator.get();
     }
 
+    void Device::DidCreateDescriptorPool() {
+        mDescriptorPoolCount++;
+    }
+
+    void Device::DidDestroyDescriptorPools(uint64_t count) {
+        ASSERT(mDescriptorPoolCount >= count);
+        mDescriptorPoolCount -= count;
+    }
+
+    std::vector<MemoryTypeUsage> Device::GetMemoryTypeUsagesImpl() const {
+        // The allocator is destroyed when the device shuts down.
+        if (mResourceMemoryAllocator == nullptr) {
+            return {};
+        }
+        return mResourceMemoryAllocator->GetMemoryTypeUsages();
+    }
+
+    uint64_t Device::GetDescriptorPoolCountImpl() const {
+        return mDescriptorPoolCount;
+    }
+
     MaybeError Device::WaitForIdleForDestruction() {
+        if (mAsyncComputeQueue != VK_NULL_HANDLE) {
+            VkResult waitIdleResult = VkResult::WrapUnsafe(fn.QueueWaitIdle(mAsyncComputeQueue));
+            DAWN_UNUSED(waitIdleResult);
+        }
+
         VkResult waitIdleResult = VkResult::WrapUnsafe(fn.QueueWaitIdle(mQueue));
         // Ignore the result of QueueWaitIdle: it can return OOM which we can't really do anything
         // about, Device lost, which means workloads running on the GPU are no longer accessible
         // (so they are as good as waited on) or success.
         DAWN_UNUSED(waitIdleResult);
 
-        CheckPassedFences();
+        CheckPassedSerials();
+
+        // Make sure all submits are complete by explicitly waiting on the last signal value.
+        if (mTimelineSemaphore != VK_NULL_HANDLE && mLastTimelineSignalValue > mCompletedSerial) {
+            VkSemaphoreWaitInfoKHR waitInfo;
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            waitInfo.pNext = nullptr;
+            waitInfo.flags = 0;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &*mTimelineSemaphore;
+            waitInfo.pValues = &mLastTimelineSignalValue;
+
+            VkResult result = VkResult::WrapUnsafe(VK_TIMEOUT);
+            do {
+                result = VkResult::WrapUnsafe(INJECT_ERROR_OR_RUN(
+                    fn.WaitSemaphoresKHR(mVkDevice, &waitInfo, UINT64_MAX), VK_ERROR_DEVICE_LOST));
+            } while (result == VK_TIMEOUT);
+
+            // TODO: Handle errors
+            ASSERT(result == VK_SUCCESS);
+            mCompletedSerial = mLastTimelineSignalValue;
+        }
 
         // Make sure all fences are complete by explicitly waiting on them all
         while (!mFencesInFlight.empty()) {
@@ -809,10 +1787,19 @@ namespace dawn_native { namespace vulkan {
         AssertAndIgnoreDeviceLossError(TickImpl());
 
         ASSERT(mCommandsInFlight.Empty());
-        for (const CommandPoolAndBuffer& commands : mUnusedCommands) {
-            fn.DestroyCommandPool(mVkDevice, commands.pool, nullptr);
+        mCommandPoolRecycler->DestroyAll();
+        mCommandPoolRecycler = nullptr;
+
+        ASSERT(mAsyncComputeCommandsInFlight.Empty());
+        mAsyncComputeCommandPoolRecycler->DestroyAll();
+        mAsyncComputeCommandPoolRecycler = nullptr;
+
+        mRecordingThreadPool = nullptr;
+        ASSERT(mSecondaryCommandPoolsInFlight.Empty());
+        for (const SecondaryCommandPool& pool : mUnusedSecondaryCommandPools) {
+            fn.DestroyCommandPool(mVkDevice, pool.pool, nullptr);
         }
-        mUnusedCommands.clear();
+        mUnusedSecondaryCommandPools.clear();
 
         // TODO(jiajie.hu@intel.com): In rare cases, a DAWN_TRY() failure may leave semaphores
         // untagged for deletion. But for most of the time when everything goes well, these
@@ -825,8 +1812,21 @@ namespace dawn_native { namespace vulkan {
         }
         mUnusedFences.clear();
 
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            fn.DestroySemaphore(mVkDevice, mTimelineSemaphore, nullptr);
+            mTimelineSemaphore = VK_NULL_HANDLE;
+        }
+
+        for (VkSemaphore semaphore : mExternalTimelineSemaphores) {
+            fn.DestroySemaphore(mVkDevice, semaphore, nullptr);
+        }
+        mExternalTimelineSemaphores.clear();
+
         // Free services explicitly so that they can free Vulkan objects before vkDestroyDevice
         mDynamicUploader = nullptr;
+        mScratchMemoryPool = nullptr;
+        mBuildQueryTracker = nullptr;
+        mQueryPoolAllocator = nullptr;
 
         // Releasing the uploader enqueues buffers to be released.
         // Call Tick() again to clear them before releasing the deleter.
@@ -834,9 +1834,19 @@ namespace dawn_native { namespace vulkan {
 
         mMapRequestTracker = nullptr;
 
+        // The VkFramebuffers in the cache can be destroyed immediately too, and must be destroyed
+        // before the VkRenderPasses they were created with.
+        mFramebufferCache = nullptr;
+
         // The VkRenderPasses in the cache can be destroyed immediately since all commands referring
         // to them are guaranteed to be finished executing.
         mRenderPassCache = nullptr;
+
+        // Pipelines don't reference the cache they were created with.
+        if (mPipelineCache != VK_NULL_HANDLE) {
+            fn.DestroyPipelineCache(mVkDevice, mPipelineCache, nullptr);
+            mPipelineCache = VK_NULL_HANDLE;
+        }
     }
 
 }}  // namespace dawn_native::vulkan
@@ -19,7 +19,9 @@
 
 #include "common/Serial.h"
 #include "common/SerialQueue.h"
+#include "common/WorkerThreadPool.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/vulkan/CommandPoolRecycler.h"
 #include "dawn_native/vulkan/CommandRecordingContext.h"
 #include "dawn_native/vulkan/Forward.h"
 #include "dawn_native/vulkan/VulkanFunctions.h"
@@ -28,18 +30,27 @@
 #include "dawn_native/vulkan/external_memory/MemoryService.h"
 #include "dawn_native/vulkan/external_semaphore/SemaphoreService.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 namespace dawn_native { namespace vulkan {
 
     class Adapter;
     class BufferUploader;
+    class BuildQueryTracker;
+    struct DedicatedAllocation;
     class DescriptorSetService;
     class FencedDeleter;
+    class FramebufferCache;
+    struct HeapBudget;
     class MapRequestTracker;
+    class QueryPoolAllocator;
     class RenderPassCache;
     class ResourceMemoryAllocator;
+    class ScratchMemoryPool;
 
     class Device : public DeviceBase {
       public:
@@ -58,32 +69,112 @@ namespace dawn_native { namespace vulkan {
         VkQueue GetQueue() const;
 
         BufferUploader* GetBufferUploader() const;
+        BuildQueryTracker* GetBuildQueryTracker() const;
         DescriptorSetService* GetDescriptorSetService() const;
         FencedDeleter* GetFencedDeleter() const;
+        FramebufferCache* GetFramebufferCache() const;
         MapRequestTracker* GetMapRequestTracker() const;
+        QueryPoolAllocator* GetQueryPoolAllocator() const;
         RenderPassCache* GetRenderPassCache() const;
+        ScratchMemoryPool* GetScratchMemoryPool() const;
+
+        // The VkPipelineCache shared by the creation of all the pipelines of the device.
+        VkPipelineCache GetPipelineCache() const;
+        ResultOrError<std::vector<uint8_t>> GetPipelineCacheData() const;
+        MaybeError LoadPipelineCacheData(const void* data, size_t size);
 
         CommandRecordingContext* GetPendingRecordingContext();
         Serial GetPendingCommandSerial() const override;
         MaybeError SubmitPendingCommands();
+        // Blocks until the commands submitted up to serial are complete. The device-owned
+        // services are only told about it at the next tick.
+        MaybeError WaitForSerial(Serial serial);
+
+        // The async compute queue only exists when the
+        // vulkan_use_async_compute_for_acceleration_container_builds toggle is enabled and the
+        // device has a compute queue family separate from the graphics one.
+        bool HasAsyncComputeQueue() const;
+        uint32_t GetAsyncComputeQueueFamily() const;
+        // Submits the pending graphics commands and starts recording commands for the async
+        // compute queue, which wait on the graphics commands submitted so far.
+        ResultOrError<CommandRecordingContext*> BeginAsyncComputeCommands();
+        // Submits the async compute commands. The graphics commands recorded afterwards wait on
+        // them before building acceleration containers or tracing rays.
+        MaybeError SubmitAsyncComputeCommands();
+
+        // Enqueues the sparse memory binds after the commands recorded so far, which get
+        // submitted, and before the next ones. The semaphores of |bindInfo| are set here.
+        MaybeError BindSparse(VkBindSparseInfo* bindInfo);
+
+        // Used when the vulkan_record_render_passes_in_parallel toggle is enabled, and to pack the
+        // instances of large top-level acceleration containers. A secondary command pool is
+        // acquired and released on the submitting thread, but in between the command buffers of
+        // the pool can be recorded on any one thread.
+        WorkerThreadPool* GetRecordingThreadPool();
+        ResultOrError<SecondaryCommandPool> AcquireSecondaryCommandPool();
+        ResultOrError<VkCommandBuffer> BeginSecondaryCommandBuffer(SecondaryCommandPool* pool,
+                                                                   VkRenderPass renderPass);
+        // Begins a secondary command buffer continuing the first subpass of the render passes
+        // compatible with renderPass.
+        MaybeError BeginSecondaryInRenderPass(VkCommandBuffer commands,
+                                              VkRenderPass renderPass,
+                                              VkCommandBufferUsageFlags flags);
+        // Begins a secondary command buffer executed outside of render passes.
+        MaybeError BeginSecondaryOutsideRenderPass(VkCommandBuffer commands,
+                                                   VkCommandBufferUsageFlags flags);
+        // The pool is reset once the pending commands, which execute its command buffers, have
+        // completed.
+        void ReleaseSecondaryCommandPool(SecondaryCommandPool pool);
+        // Guards the replay of render and ray tracing bundles, whose command iterator is shared.
+        std::mutex* GetRenderBundleReplayMutex();
 
         // Dawn Native API
 
         TextureBase* CreateTextureWrappingVulkanImage(
             const ExternalImageDescriptor* descriptor,
             ExternalMemoryHandle memoryHandle,
-            const std::vector<ExternalSemaphoreHandle>& waitHandles);
+            const std::vector<ExternalSemaphoreHandle>& waitHandles,
+            VkSemaphore timelineSemaphore,
+            uint64_t waitTimelineValue);
 
         MaybeError SignalAndExportExternalTexture(Texture* texture,
                                                   ExternalSemaphoreHandle* outHandle);
+        MaybeError SignalExternalTextureTimeline(Texture* texture, uint64_t value);
+
+        BufferBase* CreateBufferWrappingVulkanBuffer(
+            const ExternalBufferDescriptor* descriptor,
+            ExternalMemoryHandle memoryHandle,
+            const std::vector<ExternalSemaphoreHandle>& waitHandles);
+
+        MaybeError SignalAndExportExternalBuffer(Buffer* buffer,
+                                                 ExternalSemaphoreHandle* outHandle);
+
+        // External timeline semaphores are owned by the device until they are released, and can
+        // be used by any number of wrapped textures in the meantime.
+        bool SupportsExternalTimelineSemaphores() const;
+        ResultOrError<VkSemaphore> ImportExternalTimelineSemaphore(
+            ExternalSemaphoreHandle handle);
+        ResultOrError<VkSemaphore> CreateExportableTimelineSemaphore(uint64_t initialValue);
+        ResultOrError<ExternalSemaphoreHandle> ExportExternalTimelineSemaphore(
+            VkSemaphore semaphore);
+        MaybeError ReleaseExternalTimelineSemaphore(VkSemaphore semaphore);
 
         // Dawn API
         CommandBufferBase* CreateCommandBuffer(CommandEncoder* encoder,
                                                const CommandBufferDescriptor* descriptor) override;
+        RenderBundleBase* CreateRenderBundle(RenderBundleEncoder* encoder,
+                                             const RenderBundleDescriptor* descriptor,
+                                             AttachmentState* attachmentState,
+                                             PassResourceUsage resourceUsage) override;
+        RayTracingBundleBase* CreateRayTracingBundle(RayTracingBundleEncoder* encoder,
+                                                     const RayTracingBundleDescriptor* descriptor,
+                                                     PassResourceUsage resourceUsage) override;
 
         Serial GetCompletedCommandSerial() const final override;
         Serial GetLastSubmittedCommandSerial() const final override;
+        bool HasPendingCommands() const override;
         MaybeError TickImpl() override;
+        bool WaitForSerialFromCompletionThread(Serial serial, uint64_t timeoutNs) override;
 
         ResultOrError<std::unique_ptr<StagingBufferBase>> CreateStagingBuffer(size_t size) override;
         MaybeError CopyFromStagingToBuffer(StagingBufferBase* source,
@@ -91,22 +182,56 @@ namespace dawn_native { namespace vulkan {
                                            BufferBase* destination,
                                            uint64_t destinationOffset,
                                            uint64_t size) override;
-
-        ResultOrError<ResourceMemoryAllocation> AllocateMemory(VkMemoryRequirements requirements,
-                                                               bool mappable);
+        MaybeError CopyFromStagingToTexture(StagingBufferBase* source,
+                                            uint64_t sourceOffset,
+                                            uint32_t rowPitch,
+                                            uint32_t imageHeight,
+                                            const TextureCopy& destination,
+                                            const Extent3D& copySize) override;
+
+        ResultOrError<ResourceMemoryAllocation> AllocateMemory(
+            VkMemoryRequirements requirements,
+            bool mappable,
+            bool preferHostVisibleDeviceLocal = false,
+            wgpu::ResidencyPriority priority = wgpu::ResidencyPriority::Normal,
+            const DedicatedAllocation* dedicated = nullptr);
+        ResultOrError<ResourceMemoryAllocation> AllocateTransientMemory(
+            VkMemoryRequirements requirements);
+        ResultOrError<ResourceMemoryAllocation> AllocateLazilyAllocatedMemory(
+            VkMemoryRequirements requirements);
         void DeallocateMemory(ResourceMemoryAllocation* allocation);
 
+        // Also tell whether the resource should get a dedicated allocation, see
+        // ResourceMemoryAllocator.
+        VkMemoryRequirements GetBufferMemoryRequirements(VkBuffer buffer,
+                                                         DedicatedAllocation* dedicated) const;
+        VkMemoryRequirements GetImageMemoryRequirements(VkImage image,
+                                                        DedicatedAllocation* dedicated) const;
+
         int FindBestMemoryTypeIndex(VkMemoryRequirements requirements, bool mappable);
+        // The usage and budget of each memory heap, in the order of VulkanDeviceInfo::memoryHeaps.
+        std::vector<HeapBudget> GetMemoryHeapBudgets() const;
 
         ResourceMemoryAllocator* GetResourceMemoryAllocatorForTesting() const;
 
+        // Bind group layouts can be destroyed outside of the device lock.
+        void DidCreateDescriptorPool();
+        void DidDestroyDescriptorPools(uint64_t count);
+
       private:
+        std::vector<MemoryTypeUsage> GetMemoryTypeUsagesImpl() const override;
+        uint64_t GetDescriptorPoolCountImpl() const override;
+
+        MaybeError ValidateRayTracingSupport() const;
+
         ResultOrError<RayTracingAccelerationContainerBase*> CreateRayTracingAccelerationContainerImpl(
             const RayTracingAccelerationContainerDescriptor* descriptor) override;
         ResultOrError<RayTracingShaderBindingTableBase*> CreateRayTracingShaderBindingTableImpl(
             const RayTracingShaderBindingTableDescriptor* descriptor) override;
         ResultOrError<RayTracingPipelineBase*> CreateRayTracingPipelineImpl(
             const RayTracingPipelineDescriptor* descriptor) override;
+        ResultOrError<std::vector<Ref<RayTracingPipelineBase>>> CreateRayTracingPipelinesImpl(
+            const std::vector<const RayTracingPipelineDescriptor*>& descriptors) override;
         ResultOrError<BindGroupBase*> CreateBindGroupImpl(
             const BindGroupDescriptor* descriptor) override;
         ResultOrError<BindGroupLayoutBase*> CreateBindGroupLayoutImpl(
@@ -116,9 +241,15 @@ namespace dawn_native { namespace vulkan {
             const ComputePipelineDescriptor* descriptor) override;
         ResultOrError<PipelineLayoutBase*> CreatePipelineLayoutImpl(
             const PipelineLayoutDescriptor* descriptor) override;
-        ResultOrError<QueueBase*> CreateQueueImpl() override;
+        ResultOrError<QuerySetBase*> CreateQuerySetImpl(
+            const QuerySetDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateQueueImpl(const QueueDescriptor* descriptor) override;
         ResultOrError<RenderPipelineBase*> CreateRenderPipelineImpl(
             const RenderPipelineDescriptor* descriptor) override;
+        ResultOrError<std::vector<Ref<RenderPipelineBase>>> CreateRenderPipelinesImpl(
+            const std::vector<const RenderPipelineDescriptor*>& descriptors) override;
+        ResultOrError<ResourceTableBase*> CreateResourceTableImpl(
+            const ResourceTableDescriptor* descriptor) override;
         ResultOrError<SamplerBase*> CreateSamplerImpl(const SamplerDescriptor* descriptor) override;
         ResultOrError<ShaderModuleBase*> CreateShaderModuleImpl(
             const ShaderModuleDescriptor* descriptor) override;
@@ -150,49 +281,98 @@ namespace dawn_native { namespace vulkan {
         VkDevice mVkDevice = VK_NULL_HANDLE;
         uint32_t mQueueFamily = 0;
         VkQueue mQueue = VK_NULL_HANDLE;
+        bool mUseAsyncComputeQueue = false;
+        uint32_t mAsyncComputeQueueFamily = 0;
+        VkQueue mAsyncComputeQueue = VK_NULL_HANDLE;
 
+        std::unique_ptr<BuildQueryTracker> mBuildQueryTracker;
         std::unique_ptr<DescriptorSetService> mDescriptorSetService;
         std::unique_ptr<FencedDeleter> mDeleter;
+        std::unique_ptr<FramebufferCache> mFramebufferCache;
         std::unique_ptr<MapRequestTracker> mMapRequestTracker;
+        std::unique_ptr<QueryPoolAllocator> mQueryPoolAllocator;
         std::unique_ptr<ResourceMemoryAllocator> mResourceMemoryAllocator;
         std::unique_ptr<RenderPassCache> mRenderPassCache;
+        std::unique_ptr<ScratchMemoryPool> mScratchMemoryPool;
+        std::atomic<uint64_t> mDescriptorPoolCount{0};
+
+        VkPipelineCache mPipelineCache = VK_NULL_HANDLE;
+        MaybeError CreatePipelineCache();
 
         std::unique_ptr<external_memory::Service> mExternalMemoryService;
         std::unique_ptr<external_semaphore::Service> mExternalSemaphoreService;
+        std::vector<VkSemaphore> mExternalTimelineSemaphores;
+        MaybeError ValidateExternalTimelineSemaphore(VkSemaphore semaphore) const;
 
+        MaybeError CreateTimelineSemaphore();
         ResultOrError<VkFence> GetUnusedFence();
-        void CheckPassedFences();
+        void CheckPassedSerials();
 
         // We track which operations are in flight on the GPU with an increasing serial.
         // This works only because we have a single queue. Each submit to a queue is associated
         // to a serial and a fence, such that when the fence is "ready" we know the operations
-        // have finished.
+        // have finished. Submits to the async compute queue don't get a serial of their own, the
+        // graphics submit following them waits on them and its serial is used instead.
+        // When VK_KHR_timeline_semaphore is available, a single timeline semaphore signaled with
+        // the serial of each submit is used instead of the fences.
+        VkSemaphore mTimelineSemaphore = VK_NULL_HANDLE;
+        uint64_t mLastTimelineSignalValue = 0;
         std::queue<std::pair<VkFence, Serial>> mFencesInFlight;
-        // Fences in the unused list aren't reset yet.
+        // Fences in the unused list are already reset, they are reset together when their
+        // submits complete.
         std::vector<VkFence> mUnusedFences;
         Serial mCompletedSerial = 0;
         Serial mLastSubmittedSerial = 0;
+        // The completed serial the device-owned services were last ticked with.
+        Serial mLastTickedSerial = 0;
 
         MaybeError PrepareRecordingContext();
+        MaybeError PrepareRecordingContext(CommandRecordingContext* recordingContext,
+                                           uint32_t queueFamily,
+                                           CommandPoolRecycler* recycler);
         void RecycleCompletedCommands();
+        ResultOrError<VkSemaphore> CreateQueueSemaphore();
 
-        struct CommandPoolAndBuffer {
-            VkCommandPool pool = VK_NULL_HANDLE;
-            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-        };
         SerialQueue<CommandPoolAndBuffer> mCommandsInFlight;
-        // Command pools in the unused list haven't been reset yet.
-        std::vector<CommandPoolAndBuffer> mUnusedCommands;
+        std::unique_ptr<CommandPoolRecycler> mCommandPoolRecycler;
+        // Scratch storage reused by each recycling of the completed commands.
+        std::vector<CommandPoolAndBuffer> mCompletedCommands;
         // There is always a valid recording context stored in mRecordingContext
         CommandRecordingContext mRecordingContext;
+        // Scratch storage for the arrays of each vkQueueSubmit.
+        std::vector<VkSemaphore> mSubmitWaitSemaphores;
+        std::vector<VkPipelineStageFlags> mSubmitWaitStageMasks;
+        std::vector<uint64_t> mSubmitWaitValues;
+        std::vector<VkSemaphore> mSubmitSignalSemaphores;
+        std::vector<uint64_t> mSubmitSignalValues;
+
+        // The async compute recording context only holds a command buffer between
+        // BeginAsyncComputeCommands and SubmitAsyncComputeCommands.
+        SerialQueue<CommandPoolAndBuffer> mAsyncComputeCommandsInFlight;
+        std::unique_ptr<CommandPoolRecycler> mAsyncComputeCommandPoolRecycler;
+        CommandRecordingContext mAsyncComputeRecordingContext;
+
+        std::unique_ptr<WorkerThreadPool> mRecordingThreadPool;
+        SerialQueue<SecondaryCommandPool> mSecondaryCommandPoolsInFlight;
+        // Secondary command pools in the unused list haven't been reset yet.
+        std::vector<SecondaryCommandPool> mUnusedSecondaryCommandPools;
+        std::mutex mRenderBundleReplayMutex;
 
         MaybeError ImportExternalImage(const ExternalImageDescriptor* descriptor,
                                        ExternalMemoryHandle memoryHandle,
                                        VkImage image,
                                        const std::vector<ExternalSemaphoreHandle>& waitHandles,
+                                       bool useTimelineSemaphore,
                                        VkSemaphore* outSignalSemaphore,
                                        VkDeviceMemory* outAllocation,
                                        std::vector<VkSemaphore>* outWaitSemaphores);
+        MaybeError ImportExternalBuffer(const ExternalBufferDescriptor* descriptor,
+                                        ExternalMemoryHandle memoryHandle,
+                                        VkBuffer buffer,
+                                        const std::vector<ExternalSemaphoreHandle>& waitHandles,
+                                        VkSemaphore* outSignalSemaphore,
+                                        VkDeviceMemory* outAllocation,
+                                        std::vector<VkSemaphore>* outWaitSemaphores);
     };
 
 }}  // namespace dawn_native::vulkan
@@ -14,170 +14,232 @@
 
 #include "dawn_native/vulkan/FencedDeleter.h"
 
+#include "common/Math.h"
 #include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <algorithm>
 
 namespace dawn_native { namespace vulkan {
 
     FencedDeleter::FencedDeleter(Device* device) : mDevice(device) {
+        if (mDevice->IsToggleEnabled(Toggle::VulkanDestroyHandlesOnWorkerThread)) {
+            mWorkerThread = std::thread([this]() { WorkerLoop(); });
+        }
     }
 
     FencedDeleter::~FencedDeleter() {
-        ASSERT(mBuffersToDelete.Empty());
-        ASSERT(mAccelerationStructuresToDelete.Empty());
-        ASSERT(mDescriptorPoolsToDelete.Empty());
-        ASSERT(mFramebuffersToDelete.Empty());
-        ASSERT(mImagesToDelete.Empty());
-        ASSERT(mImageViewsToDelete.Empty());
-        ASSERT(mMemoriesToDelete.Empty());
-        ASSERT(mPipelinesToDelete.Empty());
-        ASSERT(mPipelineLayoutsToDelete.Empty());
-        ASSERT(mRenderPassesToDelete.Empty());
-        ASSERT(mSamplersToDelete.Empty());
-        ASSERT(mSemaphoresToDelete.Empty());
-        ASSERT(mShaderModulesToDelete.Empty());
-        ASSERT(mSurfacesToDelete.Empty());
-        ASSERT(mSwapChainsToDelete.Empty());
+        if (mWorkerThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mWorkerMutex);
+                mWorkerStopping = true;
+            }
+            mWorkerCondition.notify_one();
+            mWorkerThread.join();
+            ASSERT(mWorkerDeletions.empty());
+        }
+        ASSERT(mDeletions.Empty());
+    }
+
+    template <typename T>
+    void FencedDeleter::Enqueue(HandleType type, T handle) {
+        mDeletions.Enqueue({type, BitCast<uint64_t>(handle)}, mDevice->GetPendingCommandSerial());
     }
 
     void FencedDeleter::DeleteWhenUnused(VkBuffer buffer) {
-        mBuffersToDelete.Enqueue(buffer, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Buffer, buffer);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkAccelerationStructureNV as) {
-        mAccelerationStructuresToDelete.Enqueue(as, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::AccelerationStructure, as);
+    }
+
+    void FencedDeleter::DeleteWhenUnused(VkCommandPool pool) {
+        Enqueue(HandleType::CommandPool, pool);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkDescriptorPool pool) {
-        mDescriptorPoolsToDelete.Enqueue(pool, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::DescriptorPool, pool);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkDeviceMemory memory) {
-        mMemoriesToDelete.Enqueue(memory, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Memory, memory);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkFramebuffer framebuffer) {
-        mFramebuffersToDelete.Enqueue(framebuffer, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Framebuffer, framebuffer);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkImage image) {
-        mImagesToDelete.Enqueue(image, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Image, image);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkImageView view) {
-        mImageViewsToDelete.Enqueue(view, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::ImageView, view);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkPipeline pipeline) {
-        mPipelinesToDelete.Enqueue(pipeline, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Pipeline, pipeline);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkPipelineLayout layout) {
-        mPipelineLayoutsToDelete.Enqueue(layout, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::PipelineLayout, layout);
+    }
+
+    void FencedDeleter::DeleteWhenUnused(VkQueryPool pool) {
+        Enqueue(HandleType::QueryPool, pool);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkRenderPass renderPass) {
-        mRenderPassesToDelete.Enqueue(renderPass, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::RenderPass, renderPass);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkSampler sampler) {
-        mSamplersToDelete.Enqueue(sampler, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Sampler, sampler);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkSemaphore semaphore) {
-        mSemaphoresToDelete.Enqueue(semaphore, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Semaphore, semaphore);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkShaderModule module) {
-        mShaderModulesToDelete.Enqueue(module, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::ShaderModule, module);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkSurfaceKHR surface) {
-        mSurfacesToDelete.Enqueue(surface, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::Surface, surface);
     }
 
     void FencedDeleter::DeleteWhenUnused(VkSwapchainKHR swapChain) {
-        mSwapChainsToDelete.Enqueue(swapChain, mDevice->GetPendingCommandSerial());
+        Enqueue(HandleType::SwapChain, swapChain);
     }
 
     void FencedDeleter::Tick(Serial completedSerial) {
-        VkDevice vkDevice = mDevice->GetVkDevice();
-        VkInstance instance = mDevice->GetVkInstance();
-
-        // Buffers and images must be deleted before memories because it is invalid to free memory
-        // that still have resources bound to it.
-        for (VkBuffer buffer : mBuffersToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyBuffer(vkDevice, buffer, nullptr);
-        }
-        mBuffersToDelete.ClearUpTo(completedSerial);
-        for (VkAccelerationStructureNV as :
-             mAccelerationStructuresToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyAccelerationStructureNV(vkDevice, as, nullptr);
-        }
-        mAccelerationStructuresToDelete.ClearUpTo(completedSerial);
-        for (VkImage image : mImagesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyImage(vkDevice, image, nullptr);
-        }
-        mImagesToDelete.ClearUpTo(completedSerial);
-
-        for (VkDeviceMemory memory : mMemoriesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.FreeMemory(vkDevice, memory, nullptr);
-        }
-        mMemoriesToDelete.ClearUpTo(completedSerial);
-
-        for (VkPipelineLayout layout : mPipelineLayoutsToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyPipelineLayout(vkDevice, layout, nullptr);
-        }
-        mPipelineLayoutsToDelete.ClearUpTo(completedSerial);
-
-        for (VkRenderPass renderPass : mRenderPassesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyRenderPass(vkDevice, renderPass, nullptr);
-        }
-        mRenderPassesToDelete.ClearUpTo(completedSerial);
+        TRACE_EVENT0(mDevice->GetPlatform(), General, "FencedDeleter::Tick");
 
-        for (VkFramebuffer framebuffer : mFramebuffersToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyFramebuffer(vkDevice, framebuffer, nullptr);
+        for (const Deletion& deletion : mDeletions.IterateUpTo(completedSerial)) {
+            mCompletedDeletions.push_back(deletion);
         }
-        mFramebuffersToDelete.ClearUpTo(completedSerial);
+        mDeletions.ClearUpTo(completedSerial);
 
-        for (VkImageView view : mImageViewsToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyImageView(vkDevice, view, nullptr);
+        if (mCompletedDeletions.empty()) {
+            return;
         }
-        mImageViewsToDelete.ClearUpTo(completedSerial);
 
-        for (VkShaderModule module : mShaderModulesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyShaderModule(vkDevice, module, nullptr);
+        if (!mWorkerThread.joinable()) {
+            DestroyHandles(&mCompletedDeletions);
+            mCompletedDeletions.clear();
+            return;
         }
-        mShaderModulesToDelete.ClearUpTo(completedSerial);
 
-        for (VkPipeline pipeline : mPipelinesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyPipeline(vkDevice, pipeline, nullptr);
+        {
+            std::lock_guard<std::mutex> lock(mWorkerMutex);
+            mWorkerDeletions.insert(mWorkerDeletions.end(), mCompletedDeletions.begin(),
+                                    mCompletedDeletions.end());
         }
-        mPipelinesToDelete.ClearUpTo(completedSerial);
-
-        // Vulkan swapchains must be destroyed before their corresponding VkSurface
-        for (VkSwapchainKHR swapChain : mSwapChainsToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroySwapchainKHR(vkDevice, swapChain, nullptr);
-        }
-        mSwapChainsToDelete.ClearUpTo(completedSerial);
-        for (VkSurfaceKHR surface : mSurfacesToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroySurfaceKHR(instance, surface, nullptr);
+        mWorkerCondition.notify_one();
+        mCompletedDeletions.clear();
+    }
+
+    void FencedDeleter::WorkerLoop() {
+        std::vector<Deletion> deletions;
+        std::unique_lock<std::mutex> lock(mWorkerMutex);
+        while (true) {
+            mWorkerCondition.wait(
+                lock, [this]() { return mWorkerStopping || !mWorkerDeletions.empty(); });
+            if (mWorkerDeletions.empty()) {
+                ASSERT(mWorkerStopping);
+                return;
+            }
+
+            // Destroy the handles without holding the lock so that Tick doesn't wait for them.
+            std::swap(deletions, mWorkerDeletions);
+            lock.unlock();
+            DestroyHandles(&deletions);
+            deletions.clear();
+            lock.lock();
         }
-        mSurfacesToDelete.ClearUpTo(completedSerial);
+    }
 
-        for (VkSemaphore semaphore : mSemaphoresToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroySemaphore(vkDevice, semaphore, nullptr);
-        }
-        mSemaphoresToDelete.ClearUpTo(completedSerial);
+    void FencedDeleter::DestroyHandles(std::vector<Deletion>* deletions) {
+        std::stable_sort(deletions->begin(), deletions->end(),
+                         [](const Deletion& a, const Deletion& b) { return a.type < b.type; });
 
-        for (VkDescriptorPool pool : mDescriptorPoolsToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroyDescriptorPool(vkDevice, pool, nullptr);
-        }
-        mDescriptorPoolsToDelete.ClearUpTo(completedSerial);
+        VkDevice vkDevice = mDevice->GetVkDevice();
+        VkInstance instance = mDevice->GetVkInstance();
 
-        for (VkSampler sampler : mSamplersToDelete.IterateUpTo(completedSerial)) {
-            mDevice->fn.DestroySampler(vkDevice, sampler, nullptr);
+        for (const Deletion& deletion : *deletions) {
+            switch (deletion.type) {
+                case HandleType::Buffer:
+                    mDevice->fn.DestroyBuffer(vkDevice, BitCast<VkBuffer>(deletion.handle),
+                                              nullptr);
+                    break;
+                case HandleType::AccelerationStructure:
+                    mDevice->fn.DestroyAccelerationStructureNV(
+                        vkDevice, BitCast<VkAccelerationStructureNV>(deletion.handle), nullptr);
+                    break;
+                case HandleType::Image:
+                    mDevice->fn.DestroyImage(vkDevice, BitCast<VkImage>(deletion.handle), nullptr);
+                    break;
+                case HandleType::Memory:
+                    mDevice->fn.FreeMemory(vkDevice, BitCast<VkDeviceMemory>(deletion.handle),
+                                           nullptr);
+                    break;
+                case HandleType::PipelineLayout:
+                    mDevice->fn.DestroyPipelineLayout(
+                        vkDevice, BitCast<VkPipelineLayout>(deletion.handle), nullptr);
+                    break;
+                case HandleType::RenderPass:
+                    mDevice->fn.DestroyRenderPass(vkDevice, BitCast<VkRenderPass>(deletion.handle),
+                                                  nullptr);
+                    break;
+                case HandleType::Framebuffer:
+                    mDevice->fn.DestroyFramebuffer(
+                        vkDevice, BitCast<VkFramebuffer>(deletion.handle), nullptr);
+                    break;
+                case HandleType::ImageView:
+                    mDevice->fn.DestroyImageView(vkDevice, BitCast<VkImageView>(deletion.handle),
+                                                 nullptr);
+                    break;
+                case HandleType::ShaderModule:
+                    mDevice->fn.DestroyShaderModule(
+                        vkDevice, BitCast<VkShaderModule>(deletion.handle), nullptr);
+                    break;
+                case HandleType::Pipeline:
+                    mDevice->fn.DestroyPipeline(vkDevice, BitCast<VkPipeline>(deletion.handle),
+                                                nullptr);
+                    break;
+                case HandleType::QueryPool:
+                    mDevice->fn.DestroyQueryPool(vkDevice, BitCast<VkQueryPool>(deletion.handle),
+                                                 nullptr);
+                    break;
+                case HandleType::SwapChain:
+                    mDevice->fn.DestroySwapchainKHR(
+                        vkDevice, BitCast<VkSwapchainKHR>(deletion.handle), nullptr);
+                    break;
+                case HandleType::Surface:
+                    mDevice->fn.DestroySurfaceKHR(instance, BitCast<VkSurfaceKHR>(deletion.handle),
+                                                  nullptr);
+                    break;
+                case HandleType::Semaphore:
+                    mDevice->fn.DestroySemaphore(vkDevice, BitCast<VkSemaphore>(deletion.handle),
+                                                 nullptr);
+                    break;
+                case HandleType::DescriptorPool:
+                    mDevice->fn.DestroyDescriptorPool(
+                        vkDevice, BitCast<VkDescriptorPool>(deletion.handle), nullptr);
+                    break;
+                case HandleType::Sampler:
+                    mDevice->fn.DestroySampler(vkDevice, BitCast<VkSampler>(deletion.handle),
+                                               nullptr);
+                    break;
+                case HandleType::CommandPool:
+                    mDevice->fn.DestroyCommandPool(
+                        vkDevice, BitCast<VkCommandPool>(deletion.handle), nullptr);
+                    break;
+            }
         }
-        mSamplersToDelete.ClearUpTo(completedSerial);
     }
 
 }}  // namespace dawn_native::vulkan
@@ -15,13 +15,22 @@
 #ifndef DAWNNATIVE_VULKAN_FENCEDDELETER_H_
 #define DAWNNATIVE_VULKAN_FENCEDDELETER_H_
 
-#include "common/SerialQueue.h"
+#include "common/FlatSerialQueue.h"
 #include "common/vulkan_platform.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace dawn_native { namespace vulkan {
 
     class Device;
 
+    // Destroys Vulkan handles once the GPU no longer uses them. The handles of all types are kept
+    // in a single serial-ordered queue, so that Tick visits each completed handle once. When the
+    // vulkan_destroy_handles_on_worker_thread toggle is enabled, the vkDestroy* calls happen on a
+    // dedicated thread instead of in Tick.
     class FencedDeleter {
       public:
         FencedDeleter(Device* device);
@@ -29,6 +38,7 @@ namespace dawn_native { namespace vulkan {
 
         void DeleteWhenUnused(VkBuffer buffer);
         void DeleteWhenUnused(VkAccelerationStructureNV as);
+        void DeleteWhenUnused(VkCommandPool pool);
         void DeleteWhenUnused(VkDescriptorPool pool);
         void DeleteWhenUnused(VkDeviceMemory memory);
         void DeleteWhenUnused(VkFramebuffer framebuffer);
@@ -37,6 +47,7 @@ namespace dawn_native { namespace vulkan {
         void DeleteWhenUnused(VkPipelineLayout layout);
         void DeleteWhenUnused(VkRenderPass renderPass);
         void DeleteWhenUnused(VkPipeline pipeline);
+        void DeleteWhenUnused(VkQueryPool pool);
         void DeleteWhenUnused(VkSampler sampler);
         void DeleteWhenUnused(VkSemaphore semaphore);
         void DeleteWhenUnused(VkShaderModule module);
@@ -46,22 +57,52 @@ namespace dawn_native { namespace vulkan {
         void Tick(Serial completedSerial);
 
       private:
+        // The handles are destroyed in the order of their types.
+        enum class HandleType : uint8_t {
+            // Buffers and images must be deleted before memories because it is invalid to free
+            // memory that still have resources bound to it.
+            Buffer,
+            AccelerationStructure,
+            Image,
+            Memory,
+            PipelineLayout,
+            RenderPass,
+            Framebuffer,
+            ImageView,
+            ShaderModule,
+            Pipeline,
+            QueryPool,
+            // Vulkan swapchains must be destroyed before their corresponding VkSurface.
+            SwapChain,
+            Surface,
+            Semaphore,
+            DescriptorPool,
+            Sampler,
+            CommandPool,
+        };
+
+        struct Deletion {
+            HandleType type;
+            uint64_t handle;
+        };
+
+        template <typename T>
+        void Enqueue(HandleType type, T handle);
+        // Sorts the deletions in destruction order and destroys them.
+        void DestroyHandles(std::vector<Deletion>* deletions);
+        void WorkerLoop();
+
         Device* mDevice = nullptr;
-        SerialQueue<VkBuffer> mBuffersToDelete;
-        SerialQueue<VkAccelerationStructureNV> mAccelerationStructuresToDelete;
-        SerialQueue<VkDescriptorPool> mDescriptorPoolsToDelete;
-        SerialQueue<VkDeviceMemory> mMemoriesToDelete;
-        SerialQueue<VkFramebuffer> mFramebuffersToDelete;
-        SerialQueue<VkImage> mImagesToDelete;
-        SerialQueue<VkImageView> mImageViewsToDelete;
-        SerialQueue<VkPipeline> mPipelinesToDelete;
-        SerialQueue<VkPipelineLayout> mPipelineLayoutsToDelete;
-        SerialQueue<VkRenderPass> mRenderPassesToDelete;
-        SerialQueue<VkSampler> mSamplersToDelete;
-        SerialQueue<VkSemaphore> mSemaphoresToDelete;
-        SerialQueue<VkShaderModule> mShaderModulesToDelete;
-        SerialQueue<VkSurfaceKHR> mSurfacesToDelete;
-        SerialQueue<VkSwapchainKHR> mSwapChainsToDelete;
+        FlatSerialQueue<Deletion> mDeletions;
+        // Reused between ticks to gather the completed deletions.
+        std::vector<Deletion> mCompletedDeletions;
+
+        // Only used when handles are destroyed on the worker thread.
+        std::thread mWorkerThread;
+        std::mutex mWorkerMutex;
+        std::condition_variable mWorkerCondition;
+        std::vector<Deletion> mWorkerDeletions;
+        bool mWorkerStopping = false;
     };
 
 }}  // namespace dawn_native::vulkan
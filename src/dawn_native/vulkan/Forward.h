@@ -28,12 +28,14 @@ namespace dawn_native { namespace vulkan {
     class ComputePipeline;
     class Device;
     class PipelineLayout;
+    class QuerySet;
     class Queue;
     class RayTracingAccelerationContainer;
     class RayTracingPipeline;
     class RayTracingShaderBindingTable;
     class RenderPipeline;
     class ResourceHeap;
+    class ResourceTable;
     class Sampler;
     class ShaderModule;
     class StagingBuffer;
@@ -50,12 +52,14 @@ namespace dawn_native { namespace vulkan {
         using ComputePipelineType = ComputePipeline;
         using DeviceType = Device;
         using PipelineLayoutType = PipelineLayout;
+        using QuerySetType = QuerySet;
         using QueueType = Queue;
         using RayTracingAccelerationContainerType = RayTracingAccelerationContainer;
         using RayTracingPipelineType = RayTracingPipeline;
         using RayTracingShaderBindingTableType = RayTracingShaderBindingTable;
         using RenderPipelineType = RenderPipeline;
         using ResourceHeapType = ResourceHeap;
+        using ResourceTableType = ResourceTable;
         using SamplerType = Sampler;
         using ShaderModuleType = ShaderModule;
         using StagingBufferType = StagingBuffer;
@@ -0,0 +1,137 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/FramebufferCache.h"
+
+#include "common/HashUtils.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+#include <algorithm>
+
+namespace dawn_native { namespace vulkan {
+
+    // FramebufferCacheQuery
+
+    void FramebufferCacheQuery::AddAttachment(VkImageView view) {
+        ASSERT(attachmentCount < attachments.size());
+        attachments[attachmentCount] = view;
+        attachmentCount++;
+    }
+
+    // FramebufferCache
+
+    FramebufferCache::FramebufferCache(Device* device) : mDevice(device) {
+    }
+
+    FramebufferCache::~FramebufferCache() {
+        for (auto it : mCache) {
+            mDevice->fn.DestroyFramebuffer(mDevice->GetVkDevice(), it.second, nullptr);
+        }
+        mCache.clear();
+    }
+
+    ResultOrError<VkFramebuffer> FramebufferCache::GetFramebuffer(
+        const FramebufferCacheQuery& query) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mCache.find(query);
+        if (it != mCache.end()) {
+            return VkFramebuffer(it->second);
+        }
+
+        VkFramebuffer framebuffer;
+        DAWN_TRY_ASSIGN(framebuffer, CreateFramebufferForQuery(query));
+        mCache.emplace(query, framebuffer);
+        for (uint32_t i = 0; i < query.attachmentCount; ++i) {
+            mViewReferenceCounts[query.attachments[i].GetHandle()]++;
+        }
+        return framebuffer;
+    }
+
+    void FramebufferCache::InvalidateView(VkImageView view) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mViewReferenceCounts.erase(view.GetHandle()) == 0) {
+            return;
+        }
+
+        for (auto it = mCache.begin(); it != mCache.end();) {
+            const FramebufferCacheQuery& query = it->first;
+            auto begin = query.attachments.begin();
+            auto end = begin + query.attachmentCount;
+            if (std::find(begin, end, view) == end) {
+                ++it;
+                continue;
+            }
+
+            // Release the references the framebuffer holds on its other attachments.
+            for (auto attachment = begin; attachment != end; ++attachment) {
+                auto count = mViewReferenceCounts.find(attachment->GetHandle());
+                if (count != mViewReferenceCounts.end() && --count->second == 0) {
+                    mViewReferenceCounts.erase(count);
+                }
+            }
+
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(it->second);
+            it = mCache.erase(it);
+        }
+    }
+
+    ResultOrError<VkFramebuffer> FramebufferCache::CreateFramebufferForQuery(
+        const FramebufferCacheQuery& query) const {
+        VkFramebufferCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.renderPass = query.renderPass;
+        createInfo.attachmentCount = query.attachmentCount;
+        createInfo.pAttachments = AsVkArray(query.attachments.data());
+        createInfo.width = query.width;
+        createInfo.height = query.height;
+        createInfo.layers = 1;
+
+        VkFramebuffer framebuffer;
+        DAWN_TRY(CheckVkSuccess(mDevice->fn.CreateFramebuffer(mDevice->GetVkDevice(), &createInfo,
+                                                              nullptr, &*framebuffer),
+                                "CreateFramebuffer"));
+        return framebuffer;
+    }
+
+    size_t FramebufferCache::CacheFuncs::operator()(const FramebufferCacheQuery& query) const {
+        size_t hash = Hash(query.renderPass.GetHandle());
+
+        HashCombine(&hash, query.attachmentCount, query.width, query.height);
+        for (uint32_t i = 0; i < query.attachmentCount; ++i) {
+            HashCombine(&hash, query.attachments[i].GetHandle());
+        }
+
+        return hash;
+    }
+
+    bool FramebufferCache::CacheFuncs::operator()(const FramebufferCacheQuery& a,
+                                                  const FramebufferCacheQuery& b) const {
+        if (a.renderPass != b.renderPass || a.attachmentCount != b.attachmentCount ||
+            a.width != b.width || a.height != b.height) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < a.attachmentCount; ++i) {
+            if (a.attachments[i] != b.attachments[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}}  // namespace dawn_native::vulkan
@@ -0,0 +1,81 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_FRAMEBUFFERCACHE_H_
+#define DAWNNATIVE_VULKAN_FRAMEBUFFERCACHE_H_
+
+#include "common/Constants.h"
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // This is a key to query the FramebufferCache. Only the first attachmentCount attachments
+    // need to be provided, in the "color-depthstencil-resolve" order of the RenderPassCache.
+    struct FramebufferCacheQuery {
+        void AddAttachment(VkImageView view);
+
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        uint32_t attachmentCount = 0;
+        std::array<VkImageView, kMaxColorAttachments * 2 + 1> attachments;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Caches VkFramebuffers so that render passes using the same attachments don't create and
+    // delete a new framebuffer every time. Framebuffers are removed from the cache when one of the
+    // VkImageViews they reference is destroyed.
+    class FramebufferCache {
+      public:
+        FramebufferCache(Device* device);
+        ~FramebufferCache();
+
+        // Can be called from several threads at once when render passes are recorded in parallel.
+        ResultOrError<VkFramebuffer> GetFramebuffer(const FramebufferCacheQuery& query);
+
+        // Must be called before the view is deleted. The framebuffers referencing the view are
+        // deleted once the commands currently being recorded are finished.
+        void InvalidateView(VkImageView view);
+
+      private:
+        ResultOrError<VkFramebuffer> CreateFramebufferForQuery(
+            const FramebufferCacheQuery& query) const;
+
+        // Implements the functors necessary for to use FramebufferCacheQueries as unordered_map
+        // keys.
+        struct CacheFuncs {
+            size_t operator()(const FramebufferCacheQuery& query) const;
+            bool operator()(const FramebufferCacheQuery& a, const FramebufferCacheQuery& b) const;
+        };
+        using Cache =
+            std::unordered_map<FramebufferCacheQuery, VkFramebuffer, CacheFuncs, CacheFuncs>;
+
+        Device* mDevice = nullptr;
+        std::mutex mMutex;
+        Cache mCache;
+
+        // The number of cached framebuffers referencing each view, so that destroying a view that
+        // isn't an attachment of any of them doesn't need to look at the whole cache.
+        std::unordered_map<::VkImageView, uint32_t> mViewReferenceCounts;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_FRAMEBUFFERCACHE_H_
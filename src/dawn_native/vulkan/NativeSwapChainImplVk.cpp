@@ -18,54 +18,73 @@
 #include "dawn_native/vulkan/FencedDeleter.h"
 #include "dawn_native/vulkan/TextureVk.h"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 
 namespace dawn_native { namespace vulkan {
 
     namespace {
 
-        bool chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes,
-                                   bool turnOffVsync,
-                                   VkPresentModeKHR* presentMode) {
-            if (turnOffVsync) {
-                for (const auto& availablePresentMode : availablePresentModes) {
-                    if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-                        *presentMode = availablePresentMode;
-                        return true;
-                    }
+        uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                .count();
+        }
+
+        VkPresentModeKHR ChooseSwapPresentMode(
+            const std::vector<VkPresentModeKHR>& availablePresentModes,
+            VkPresentModeKHR requestedPresentMode) {
+            std::vector<VkPresentModeKHR> candidates = {requestedPresentMode};
+            switch (requestedPresentMode) {
+                case VK_PRESENT_MODE_MAILBOX_KHR:
+                    candidates.push_back(VK_PRESENT_MODE_IMMEDIATE_KHR);
+                    break;
+                case VK_PRESENT_MODE_IMMEDIATE_KHR:
+                    candidates.push_back(VK_PRESENT_MODE_MAILBOX_KHR);
+                    break;
+                default:
+                    break;
+            }
+
+            for (VkPresentModeKHR candidate : candidates) {
+                if (std::find(availablePresentModes.begin(), availablePresentModes.end(),
+                              candidate) != availablePresentModes.end()) {
+                    return candidate;
                 }
-                return false;
             }
 
-            *presentMode = VK_PRESENT_MODE_FIFO_KHR;
-            return true;
+            // FIFO is the only present mode that all surfaces support.
+            return VK_PRESENT_MODE_FIFO_KHR;
         }
 
-        bool ChooseSurfaceConfig(const VulkanSurfaceInfo& info,
+        void ChooseSurfaceConfig(const VulkanSurfaceInfo& info,
                                  NativeSwapChainImpl::ChosenConfig* config,
-                                 bool turnOffVsync) {
-            VkPresentModeKHR presentMode;
-            if (!chooseSwapPresentMode(info.presentModes, turnOffVsync, &presentMode)) {
-                return false;
-            }
+                                 VkPresentModeKHR requestedPresentMode) {
+            VkPresentModeKHR presentMode =
+                ChooseSwapPresentMode(info.presentModes, requestedPresentMode);
             // TODO(cwallez@chromium.org): For now this is hardcoded to what works with one NVIDIA
             // driver. Need to generalize
             config->nativeFormat = VK_FORMAT_B8G8R8A8_UNORM;
             config->colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
             config->format = wgpu::TextureFormat::BGRA8Unorm;
-            config->minImageCount = 3;
+            config->minImageCount = std::max(3u, info.capabilities.minImageCount);
+            if (info.capabilities.maxImageCount != 0) {
+                config->minImageCount =
+                    std::min(config->minImageCount, info.capabilities.maxImageCount);
+            }
             // TODO(cwallez@chromium.org): This is upside down compared to what we want, at least
             // on Linux
             config->preTransform = info.capabilities.currentTransform;
             config->presentMode = presentMode;
             config->compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-
-            return true;
         }
     }  // anonymous namespace
 
-    NativeSwapChainImpl::NativeSwapChainImpl(Device* device, VkSurfaceKHR surface)
-        : mSurface(surface), mDevice(device) {
+    NativeSwapChainImpl::NativeSwapChainImpl(Device* device,
+                                             VkSurfaceKHR surface,
+                                             const NativeSwapChainOptions& options)
+        : mSurface(surface), mOptions(options), mDevice(device) {
         // Call this immediately, so that BackendBinding::GetPreferredSwapChainTextureFormat
         // will return a correct result before a SwapChain is created.
         UpdateSurfaceConfig();
@@ -88,9 +107,53 @@ namespace dawn_native { namespace vulkan {
             ASSERT(false);
         }
 
-        if (!ChooseSurfaceConfig(mInfo, &mConfig, mDevice->IsToggleEnabled(Toggle::TurnOffVsync))) {
-            ASSERT(false);
+        VkPresentModeKHR presentMode = mDevice->IsToggleEnabled(Toggle::TurnOffVsync)
+                                           ? VK_PRESENT_MODE_IMMEDIATE_KHR
+                                           : mOptions.presentMode;
+        ChooseSurfaceConfig(mInfo, &mConfig, presentMode);
+        mFrameTimings.presentMode = mConfig.presentMode;
+    }
+
+    MaybeError NativeSwapChainImpl::WaitForFramesInFlight() {
+        if (mOptions.maxFramesInFlight == 0) {
+            return {};
+        }
+
+        Serial completedSerial = mDevice->GetCompletedCommandSerial();
+        while (!mFramesInFlight.empty() && mFramesInFlight.front() <= completedSerial) {
+            mFramesInFlight.pop();
+        }
+        while (mFramesInFlight.size() >= mOptions.maxFramesInFlight) {
+            DAWN_TRY(mDevice->WaitForSerial(mFramesInFlight.front()));
+            mFramesInFlight.pop();
+        }
+        return {};
+    }
+
+    void NativeSwapChainImpl::UpdateDisplayTimings() {
+        VkDevice vkDevice = mDevice->GetVkDevice();
+
+        // Only the timings of the most recent frame the presentation engine reported on are kept.
+        uint32_t count = 0;
+        if (mDevice->fn.GetPastPresentationTimingGOOGLE(vkDevice, mSwapChain, &count, nullptr) !=
+                VK_SUCCESS ||
+            count == 0) {
+            return;
         }
+        mPastPresentationTimings.resize(count);
+        VkResult result = VkResult::WrapUnsafe(mDevice->fn.GetPastPresentationTimingGOOGLE(
+            vkDevice, mSwapChain, &count, mPastPresentationTimings.data()));
+        if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || count == 0) {
+            return;
+        }
+
+        const VkPastPresentationTimingGOOGLE& timing = mPastPresentationTimings[count - 1];
+        mFrameTimings.hasDisplayTiming = true;
+        mFrameTimings.presentId = timing.presentID;
+        mFrameTimings.desiredPresentTime = timing.desiredPresentTime;
+        mFrameTimings.actualPresentTime = timing.actualPresentTime;
+        mFrameTimings.earliestPresentTime = timing.earliestPresentTime;
+        mFrameTimings.presentMargin = timing.presentMargin;
     }
 
     void NativeSwapChainImpl::Init(DawnWSIContextVulkan* /*context*/) {
@@ -184,6 +247,14 @@ namespace dawn_native { namespace vulkan {
             mDevice->GetFencedDeleter()->DeleteWhenUnused(oldSwapchain);
         }
 
+        if (mDevice->GetDeviceInfo().displayTiming) {
+            VkRefreshCycleDurationGOOGLE refreshCycle;
+            if (mDevice->fn.GetRefreshCycleDurationGOOGLE(mDevice->GetVkDevice(), mSwapChain,
+                                                          &refreshCycle) == VK_SUCCESS) {
+                mFrameTimings.refreshDuration = refreshCycle.refreshDuration;
+            }
+        }
+
         return DAWN_SWAP_CHAIN_NO_ERROR;
     }
 
@@ -202,11 +273,20 @@ namespace dawn_native { namespace vulkan {
             }
         }
 
+        std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+        if (mDevice->ConsumedError(WaitForFramesInFlight())) {
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(semaphore);
+            return "Failed to wait for the frames in flight";
+        }
+        mFrameTimings.framesInFlightWaitTime = NanosecondsSince(waitStart);
+
+        std::chrono::steady_clock::time_point acquireStart = std::chrono::steady_clock::now();
         if (mDevice->fn.AcquireNextImageKHR(mDevice->GetVkDevice(), mSwapChain,
                                             std::numeric_limits<uint64_t>::max(), semaphore,
                                             VkFence{}, &mLastImageIndex) != VK_SUCCESS) {
             ASSERT(false);
         }
+        mFrameTimings.acquireTime = NanosecondsSince(acquireStart);
 
         nextTexture->texture.u64 =
 #if defined(DAWN_PLATFORM_64_BIT)
@@ -235,10 +315,35 @@ namespace dawn_native { namespace vulkan {
         presentInfo.pImageIndices = &mLastImageIndex;
         presentInfo.pResults = nullptr;
 
+        // The presentation engine reports the timings of the frame with this ID later on.
+        bool displayTiming = mDevice->GetDeviceInfo().displayTiming;
+        VkPresentTimeGOOGLE presentTime;
+        VkPresentTimesInfoGOOGLE presentTimesInfo;
+        if (displayTiming) {
+            presentTime.presentID = ++mLastPresentId;
+            presentTime.desiredPresentTime = 0;
+
+            presentTimesInfo.sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE;
+            presentTimesInfo.pNext = nullptr;
+            presentTimesInfo.swapchainCount = 1;
+            presentTimesInfo.pTimes = &presentTime;
+            presentInfo.pNext = &presentTimesInfo;
+        }
+
+        std::chrono::steady_clock::time_point presentStart = std::chrono::steady_clock::now();
         VkQueue queue = mDevice->GetQueue();
         if (mDevice->fn.QueuePresentKHR(queue, &presentInfo) != VK_SUCCESS) {
             ASSERT(false);
         }
+        mFrameTimings.presentTime = NanosecondsSince(presentStart);
+
+        // The commands of the frame were submitted right before presenting.
+        if (mOptions.maxFramesInFlight != 0) {
+            mFramesInFlight.push(mDevice->GetLastSubmittedCommandSerial());
+        }
+        if (displayTiming) {
+            UpdateDisplayTimings();
+        }
 
         return DAWN_SWAP_CHAIN_NO_ERROR;
     }
@@ -247,4 +352,8 @@ namespace dawn_native { namespace vulkan {
         return mConfig.format;
     }
 
+    NativeSwapChainFrameTimings NativeSwapChainImpl::GetFrameTimings() const {
+        return mFrameTimings;
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -17,9 +17,14 @@
 
 #include "dawn_native/vulkan/VulkanInfo.h"
 
+#include "common/Serial.h"
 #include "dawn/dawn_wsi.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/VulkanBackend.h"
 #include "dawn_native/dawn_platform.h"
 
+#include <queue>
+
 namespace dawn_native { namespace vulkan {
 
     class Device;
@@ -28,7 +33,9 @@ namespace dawn_native { namespace vulkan {
       public:
         using WSIContext = DawnWSIContextVulkan;
 
-        NativeSwapChainImpl(Device* device, VkSurfaceKHR surface);
+        NativeSwapChainImpl(Device* device,
+                            VkSurfaceKHR surface,
+                            const NativeSwapChainOptions& options);
         ~NativeSwapChainImpl();
 
         void Init(DawnWSIContextVulkan* context);
@@ -40,6 +47,7 @@ namespace dawn_native { namespace vulkan {
         DawnSwapChainError Present();
 
         wgpu::TextureFormat GetPreferredFormat() const;
+        NativeSwapChainFrameTimings GetFrameTimings() const;
 
         struct ChosenConfig {
             VkFormat nativeFormat;
@@ -53,6 +61,9 @@ namespace dawn_native { namespace vulkan {
 
       private:
         void UpdateSurfaceConfig();
+        // Waits for the oldest presented frames until fewer than maxFramesInFlight are left.
+        MaybeError WaitForFramesInFlight();
+        void UpdateDisplayTimings();
 
         VkSurfaceKHR mSurface = VK_NULL_HANDLE;
         VkSwapchainKHR mSwapChain = VK_NULL_HANDLE;
@@ -62,6 +73,13 @@ namespace dawn_native { namespace vulkan {
         VulkanSurfaceInfo mInfo;
 
         ChosenConfig mConfig;
+        NativeSwapChainOptions mOptions;
+
+        // The serials of the commands of the presented frames the GPU may still be working on.
+        std::queue<Serial> mFramesInFlight;
+        NativeSwapChainFrameTimings mFrameTimings;
+        uint32_t mLastPresentId = 0;
+        std::vector<VkPastPresentationTimingGOOGLE> mPastPresentationTimings;
 
         Device* mDevice = nullptr;
     };
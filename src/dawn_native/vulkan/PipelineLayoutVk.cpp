@@ -18,6 +18,7 @@
 #include "dawn_native/vulkan/BindGroupLayoutVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
 
 namespace dawn_native { namespace vulkan {
@@ -52,6 +53,16 @@ namespace dawn_native { namespace vulkan {
         createInfo.pushConstantRangeCount = 0;
         createInfo.pPushConstantRanges = nullptr;
 
+        // The push constants are a single range, so vkCmdPushConstants always uses its stages.
+        VkPushConstantRange pushConstantRange;
+        if (GetPushConstantSize() > 0) {
+            pushConstantRange.stageFlags = ToVulkanShaderStageFlags(GetPushConstantVisibility());
+            pushConstantRange.offset = 0;
+            pushConstantRange.size = GetPushConstantSize();
+            createInfo.pushConstantRangeCount = 1;
+            createInfo.pPushConstantRanges = &pushConstantRange;
+        }
+
         Device* device = ToBackend(GetDevice());
         return CheckVkSuccess(
             device->fn.CreatePipelineLayout(device->GetVkDevice(), &createInfo, nullptr, &*mHandle),
@@ -0,0 +1,108 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/QueryPoolAllocator.h"
+
+#include "common/Math.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+#include <algorithm>
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        constexpr uint32_t kMinQueryPoolCapacity = 16;
+        constexpr size_t kMaxUnusedQueryPools = 16;
+
+    }  // anonymous namespace
+
+    QueryPoolAllocator::QueryPoolAllocator(Device* device) : mDevice(device) {
+    }
+
+    QueryPoolAllocator::~QueryPoolAllocator() {
+        // The device is idle when it gets destroyed, so the pools in flight can be destroyed too.
+        for (const QueryPoolAllocation& allocation : mPoolsInFlight.IterateAll()) {
+            DestroyPool(allocation);
+        }
+        mPoolsInFlight.Clear();
+
+        for (const QueryPoolAllocation& allocation : mUnusedPools) {
+            DestroyPool(allocation);
+        }
+        mUnusedPools.clear();
+    }
+
+    ResultOrError<QueryPoolAllocation> QueryPoolAllocator::Acquire(
+        VkQueryType type,
+        VkQueryPipelineStatisticFlags pipelineStatistics,
+        uint32_t queryCount) {
+        uint32_t capacity = static_cast<uint32_t>(
+            std::max(NextPowerOfTwo(queryCount), uint64_t(kMinQueryPoolCapacity)));
+
+        for (auto it = mUnusedPools.begin(); it != mUnusedPools.end(); ++it) {
+            if (it->type == type && it->pipelineStatistics == pipelineStatistics &&
+                it->capacity == capacity) {
+                QueryPoolAllocation allocation = *it;
+                mUnusedPools.erase(it);
+                return allocation;
+            }
+        }
+
+        VkQueryPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.queryType = type;
+        createInfo.queryCount = capacity;
+        createInfo.pipelineStatistics = pipelineStatistics;
+
+        QueryPoolAllocation allocation;
+        allocation.type = type;
+        allocation.pipelineStatistics = pipelineStatistics;
+        allocation.capacity = capacity;
+        DAWN_TRY(CheckVkSuccess(mDevice->fn.CreateQueryPool(mDevice->GetVkDevice(), &createInfo,
+                                                            nullptr, &*allocation.pool),
+                                "vkCreateQueryPool"));
+        return allocation;
+    }
+
+    void QueryPoolAllocator::Release(QueryPoolAllocation allocation) {
+        ASSERT(allocation.pool != VK_NULL_HANDLE);
+        mPoolsInFlight.Enqueue(allocation, mDevice->GetPendingCommandSerial());
+    }
+
+    void QueryPoolAllocator::Tick(Serial completedSerial) {
+        for (const QueryPoolAllocation& allocation :
+             mPoolsInFlight.IterateUpTo(completedSerial)) {
+            mUnusedPools.push_back(allocation);
+        }
+        mPoolsInFlight.ClearUpTo(completedSerial);
+
+        // Keep the most recently released pools, which are the likeliest to be reused.
+        if (mUnusedPools.size() > kMaxUnusedQueryPools) {
+            size_t excess = mUnusedPools.size() - kMaxUnusedQueryPools;
+            for (size_t i = 0; i < excess; ++i) {
+                DestroyPool(mUnusedPools[i]);
+            }
+            mUnusedPools.erase(mUnusedPools.begin(), mUnusedPools.begin() + excess);
+        }
+    }
+
+    void QueryPoolAllocator::DestroyPool(const QueryPoolAllocation& allocation) {
+        mDevice->fn.DestroyQueryPool(mDevice->GetVkDevice(), allocation.pool, nullptr);
+    }
+
+}}  // namespace dawn_native::vulkan
@@ -0,0 +1,63 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_QUERYPOOLALLOCATOR_H_
+#define DAWNNATIVE_VULKAN_QUERYPOOLALLOCATOR_H_
+
+#include "common/SerialQueue.h"
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    struct QueryPoolAllocation {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        VkQueryType type = VK_QUERY_TYPE_OCCLUSION;
+        VkQueryPipelineStatisticFlags pipelineStatistics = 0;
+        uint32_t capacity = 0;
+    };
+
+    // Recycles the VkQueryPools of destroyed query sets. Pools are created with power of two
+    // capacities so that query sets of similar sizes can share them, and are only handed out
+    // again once the commands which used them have completed.
+    class QueryPoolAllocator {
+      public:
+        QueryPoolAllocator(Device* device);
+        ~QueryPoolAllocator();
+
+        // Returns a pool of the given type with room for at least |queryCount| queries.
+        ResultOrError<QueryPoolAllocation> Acquire(
+            VkQueryType type,
+            VkQueryPipelineStatisticFlags pipelineStatistics,
+            uint32_t queryCount);
+        // The pool may still be used by the pending commands, it is reused after they complete.
+        void Release(QueryPoolAllocation allocation);
+        void Tick(Serial completedSerial);
+
+      private:
+        void DestroyPool(const QueryPoolAllocation& allocation);
+
+        Device* mDevice;
+
+        SerialQueue<QueryPoolAllocation> mPoolsInFlight;
+        std::vector<QueryPoolAllocation> mUnusedPools;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_QUERYPOOLALLOCATOR_H_
@@ -0,0 +1,97 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/QuerySetVk.h"
+
+#include "dawn_native/vulkan/DeviceVk.h"
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+        VkQueryType VulkanQueryType(wgpu::QueryType type) {
+            switch (type) {
+                case wgpu::QueryType::Occlusion:
+                    return VK_QUERY_TYPE_OCCLUSION;
+                case wgpu::QueryType::PipelineStatistics:
+                    return VK_QUERY_TYPE_PIPELINE_STATISTICS;
+                case wgpu::QueryType::Timestamp:
+                    return VK_QUERY_TYPE_TIMESTAMP;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        // Vulkan writes the statistics in the order of their bits, which is also the order of
+        // the PipelineStatisticName values.
+        VkQueryPipelineStatisticFlags VulkanPipelineStatistics(
+            const std::vector<wgpu::PipelineStatisticName>& statistics) {
+            VkQueryPipelineStatisticFlags flags = 0;
+            for (wgpu::PipelineStatisticName statistic : statistics) {
+                switch (statistic) {
+                    case wgpu::PipelineStatisticName::VertexShaderInvocations:
+                        flags |= VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT;
+                        break;
+                    case wgpu::PipelineStatisticName::ClipperInvocations:
+                        flags |= VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT;
+                        break;
+                    case wgpu::PipelineStatisticName::ClipperPrimitivesOut:
+                        flags |= VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT;
+                        break;
+                    case wgpu::PipelineStatisticName::FragmentShaderInvocations:
+                        flags |= VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+                        break;
+                    case wgpu::PipelineStatisticName::ComputeShaderInvocations:
+                        flags |= VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+                        break;
+                    default:
+                        UNREACHABLE();
+                }
+            }
+            return flags;
+        }
+    }  // anonymous namespace
+
+    // static
+    ResultOrError<QuerySet*> QuerySet::Create(Device* device,
+                                              const QuerySetDescriptor* descriptor) {
+        std::unique_ptr<QuerySet> querySet = std::make_unique<QuerySet>(device, descriptor);
+        DAWN_TRY(querySet->Initialize());
+        return querySet.release();
+    }
+
+    MaybeError QuerySet::Initialize() {
+        Device* device = ToBackend(GetDevice());
+        DAWN_TRY_ASSIGN(mPool, device->GetQueryPoolAllocator()->Acquire(
+                                   VulkanQueryType(GetQueryType()),
+                                   VulkanPipelineStatistics(GetPipelineStatistics()),
+                                   GetQueryCount()));
+        return {};
+    }
+
+    QuerySet::~QuerySet() {
+        DestroyInternal();
+    }
+
+    VkQueryPool QuerySet::GetHandle() const {
+        return mPool.pool;
+    }
+
+    void QuerySet::DestroyImpl() {
+        if (mPool.pool != VK_NULL_HANDLE) {
+            ToBackend(GetDevice())->GetQueryPoolAllocator()->Release(mPool);
+            mPool = {};
+        }
+    }
+
+}}  // namespace dawn_native::vulkan
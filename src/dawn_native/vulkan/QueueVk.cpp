@@ -14,36 +14,203 @@
 
 #include "dawn_native/vulkan/QueueVk.h"
 
+#include "dawn_native/ErrorData.h"
+#include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/CommandBufferVk.h"
 #include "dawn_native/vulkan/CommandRecordingContext.h"
 #include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/ResourceTableVk.h"
+#include "dawn_native/vulkan/TextureVk.h"
 #include "dawn_platform/DawnPlatform.h"
 #include "dawn_platform/tracing/TraceEvent.h"
 
+#include <unordered_set>
+#include <vector>
+
 namespace dawn_native { namespace vulkan {
 
     // static
-    Queue* Queue::Create(Device* device) {
-        return new Queue(device);
+    Queue* Queue::Create(Device* device, const QueueDescriptor* descriptor) {
+        return new Queue(device, descriptor);
     }
 
     Queue::~Queue() {
     }
 
+    MaybeError Queue::WriteBufferImpl(BufferBase* buffer,
+                                      uint64_t bufferOffset,
+                                      const void* data,
+                                      uint64_t size) {
+        Buffer* vkBuffer = ToBackend(buffer);
+        if (vkBuffer->IsHostWritableNow()) {
+            vkBuffer->WriteFromHost(bufferOffset, data, size);
+            return {};
+        }
+        return QueueBase::WriteBufferImpl(buffer, bufferOffset, data, size);
+    }
+
+    MaybeError Queue::UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                   uint64_t firstTile,
+                                                   uint64_t tileCount,
+                                                   bool resident) {
+        return ToBackend(buffer)->UpdateTileMappings(firstTile, tileCount, resident);
+    }
+
+    MaybeError Queue::UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                    uint32_t mipLevel,
+                                                    uint32_t arrayLayer,
+                                                    const Origin3D& firstTile,
+                                                    const Extent3D& tileCount,
+                                                    bool resident) {
+        return ToBackend(texture)->UpdateTileMappings(mipLevel, arrayLayer, firstTile, tileCount,
+                                                      resident);
+    }
+
     MaybeError Queue::SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) {
         Device* device = ToBackend(GetDevice());
 
-        device->Tick();
+        // Ticking the device would submit the commands batched so far.
+        const bool batchSubmits = device->IsToggleEnabled(Toggle::VulkanBatchQueueSubmits);
+        if (!batchSubmits) {
+            device->Tick();
+        }
+
+        // The resource tables are written before recording, which can happen on worker threads.
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            for (const PassResourceUsage& passUsages : commands[i]->GetResourceUsages().perPass) {
+                for (ResourceTableBase* table : passUsages.resourceTables) {
+                    DAWN_TRY(ToBackend(table)->PrepareForSubmit());
+                }
+            }
+        }
 
         TRACE_EVENT_BEGIN0(GetDevice()->GetPlatform(), Recording,
                            "CommandBufferVk::RecordCommands");
         CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
-        for (uint32_t i = 0; i < commandCount; ++i) {
-            DAWN_TRY(ToBackend(commands[i])->RecordCommands(recordingContext));
+        // The worker threads would reference objects concurrently with the submitting thread.
+        if (device->IsToggleEnabled(Toggle::VulkanRecordRenderPassesInParallel) &&
+            !device->IsToggleEnabled(Toggle::SingleThreadedRefCounting) &&
+            CanRecordRenderPassesInParallel(commandCount, commands)) {
+            DAWN_TRY(RecordCommandsWithParallelRenderPasses(recordingContext, commandCount,
+                                                            commands));
+        } else {
+            for (uint32_t i = 0; i < commandCount; ++i) {
+                ScopedLoweringTimer timer(commands[i]);
+                DAWN_TRY(ToBackend(commands[i])->RecordCommands(recordingContext));
+            }
         }
         TRACE_EVENT_END0(GetDevice()->GetPlatform(), Recording, "CommandBufferVk::RecordCommands");
 
-        DAWN_TRY(device->SubmitPendingCommands());
+        TransitionPersistentlyMappedBuffers(recordingContext, commandCount, commands);
+
+        // With batched submits, the commands are submitted by the next device tick, fence
+        // signal, map request or queue flush, with the pending serial they were recorded with.
+        if (!batchSubmits) {
+            DAWN_TRY(device->SubmitPendingCommands());
+        }
+
+        return {};
+    }
+
+    MaybeError Queue::FlushImpl() {
+        return ToBackend(GetDevice())->SubmitPendingCommands();
+    }
+
+    void Queue::TransitionPersistentlyMappedBuffers(CommandRecordingContext* recordingContext,
+                                                    uint32_t commandCount,
+                                                    CommandBufferBase* const* commands) {
+        // Persistently mapped buffers aren't transitioned by MapReadAsync while the GPU uses
+        // them, so the GPU writes are made visible to the host at the end of each submit instead.
+        // Host writes don't need a barrier since vkQueueSubmit makes them visible to the GPU.
+        std::unordered_set<Buffer*> buffers;
+        auto AddIfPersistentlyMappedForRead = [&](BufferBase* buffer) {
+            constexpr wgpu::BufferUsage kPersistentMapRead =
+                wgpu::BufferUsage::PersistentMap | wgpu::BufferUsage::MapRead;
+            if ((buffer->GetUsage() & kPersistentMapRead) == kPersistentMapRead) {
+                buffers.insert(ToBackend(buffer));
+            }
+        };
+
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            const CommandBufferResourceUsage& usages = commands[i]->GetResourceUsages();
+            for (const PassResourceUsage& pass : usages.perPass) {
+                for (BufferBase* buffer : pass.buffers) {
+                    AddIfPersistentlyMappedForRead(buffer);
+                }
+            }
+            for (BufferBase* buffer : usages.topLevelBuffers) {
+                AddIfPersistentlyMappedForRead(buffer);
+            }
+        }
+
+        for (Buffer* buffer : buffers) {
+            buffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::MapRead);
+        }
+    }
+
+    bool Queue::CanRecordRenderPassesInParallel(uint32_t commandCount,
+                                                CommandBufferBase* const* commands) const {
+        // A single command buffer has nothing to be recorded in parallel with.
+        if (commandCount < 2) {
+            return false;
+        }
+
+        // The commands of a command buffer are iterated by a single thread at a time, so a command
+        // buffer submitted more than once is recorded serially instead.
+        std::unordered_set<CommandBufferBase*> uniqueCommands(commands, commands + commandCount);
+        return uniqueCommands.size() == commandCount;
+    }
+
+    MaybeError Queue::RecordCommandsWithParallelRenderPasses(
+        CommandRecordingContext* recordingContext,
+        uint32_t commandCount,
+        CommandBufferBase* const* commands) {
+        Device* device = ToBackend(GetDevice());
+
+        // The pools are only reset once the pending commands have completed, even if nothing
+        // gets submitted because of an error.
+        std::vector<SecondaryCommandPool> pools;
+        pools.reserve(commandCount);
+        auto ReleasePools = [&]() {
+            for (SecondaryCommandPool& pool : pools) {
+                device->ReleaseSecondaryCommandPool(std::move(pool));
+            }
+        };
+
+        // Each command buffer gets its own pool so that the workers never share one.
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            ResultOrError<SecondaryCommandPool> pool = device->AcquireSecondaryCommandPool();
+            if (pool.IsError()) {
+                ReleasePools();
+                return pool.AcquireError();
+            }
+            pools.push_back(pool.AcquireSuccess());
+        }
+
+        std::vector<std::vector<VkCommandBuffer>> renderPassCommands(commandCount);
+        std::vector<std::unique_ptr<ErrorData>> errors(commandCount);
+        device->GetRecordingThreadPool()->ParallelFor(commandCount, [&](uint32_t i) {
+            MaybeError result = ToBackend(commands[i])
+                                    ->RecordRenderPassesInSecondaries(&pools[i],
+                                                                      &renderPassCommands[i]);
+            if (result.IsError()) {
+                errors[i] = result.AcquireError();
+            }
+        });
+
+        ReleasePools();
+        for (std::unique_ptr<ErrorData>& error : errors) {
+            if (error != nullptr) {
+                return std::move(error);
+            }
+        }
+
+        // The barriers, lazy clears and the passes other than render passes depend on the state
+        // left by the previous command buffers, so they are recorded in submit order.
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            DAWN_TRY(ToBackend(commands[i])
+                         ->RecordCommands(recordingContext, &renderPassCommands[i]));
+        }
 
         return {};
     }
@@ -20,17 +20,48 @@
 namespace dawn_native { namespace vulkan {
 
     class CommandBuffer;
+    struct CommandRecordingContext;
     class Device;
 
     class Queue : public QueueBase {
       public:
-        static Queue* Create(Device* device);
+        static Queue* Create(Device* device, const QueueDescriptor* descriptor);
         ~Queue();
 
       private:
         using QueueBase::QueueBase;
 
         MaybeError SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) override;
+        MaybeError FlushImpl() override;
+        // Writes directly to buffers in host visible memory which the GPU isn't using.
+        MaybeError WriteBufferImpl(BufferBase* buffer,
+                                   uint64_t bufferOffset,
+                                   const void* data,
+                                   uint64_t size) override;
+        MaybeError UpdateBufferTileMappingsImpl(BufferBase* buffer,
+                                                uint64_t firstTile,
+                                                uint64_t tileCount,
+                                                bool resident) override;
+        MaybeError UpdateTextureTileMappingsImpl(TextureBase* texture,
+                                                 uint32_t mipLevel,
+                                                 uint32_t arrayLayer,
+                                                 const Origin3D& firstTile,
+                                                 const Extent3D& tileCount,
+                                                 bool resident) override;
+
+        // Makes the GPU writes to the persistently mapped MapRead buffers visible to the host.
+        void TransitionPersistentlyMappedBuffers(CommandRecordingContext* recordingContext,
+                                                 uint32_t commandCount,
+                                                 CommandBufferBase* const* commands);
+
+        // Used with the vulkan_record_render_passes_in_parallel toggle: the render passes of all
+        // the command buffers are recorded in secondary command buffers on worker threads first.
+        bool CanRecordRenderPassesInParallel(uint32_t commandCount,
+                                             CommandBufferBase* const* commands) const;
+        MaybeError RecordCommandsWithParallelRenderPasses(
+            CommandRecordingContext* recordingContext,
+            uint32_t commandCount,
+            CommandBufferBase* const* commands);
     };
 
 }}  // namespace dawn_native::vulkan
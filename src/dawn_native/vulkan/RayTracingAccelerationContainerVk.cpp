@@ -15,11 +15,20 @@
 #include "dawn_native/vulkan/RayTracingAccelerationContainerVk.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
 
+#include "common/Math.h"
+#include "dawn_native/DynamicUploader.h"
+#include "dawn_native/ErrorData.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/StagingBufferVk.h"
 #include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
 namespace dawn_native { namespace vulkan {
 
     namespace {
@@ -148,6 +157,85 @@ namespace dawn_native { namespace vulkan {
             out[15] = 0.0f;
         }
 
+        MaybeError ToVulkanAccelerationInstance(
+            const RayTracingAccelerationInstanceDescriptor& instance,
+            VkAccelerationInstance* instanceData) {
+            RayTracingAccelerationContainer* geometryContainer =
+                ToBackend(instance.geometryContainer);
+            *instanceData = {};
+            // process transform object
+            if (instance.transform != nullptr) {
+                float transform[16] = {};
+                Fill4x3TransformMatrix(transform, instance.transform->translation,
+                                       instance.transform->rotation, instance.transform->scale);
+                memcpy(&instanceData->transform, transform, sizeof(instanceData->transform));
+            }
+            // process transform matrix
+            else if (instance.transformMatrix != nullptr) {
+                memcpy(&instanceData->transform, instance.transformMatrix,
+                       sizeof(instanceData->transform));
+            }
+            // validate ranges
+            if (instance.mask >= (2 << 7)) {
+                return DAWN_VALIDATION_ERROR("Instance Mask out of range");
+            }
+            if (instance.instanceId >= (2 << 23)) {
+                return DAWN_VALIDATION_ERROR("Instance Id out of range");
+            }
+            instanceData->instanceId = instance.instanceId;
+            instanceData->mask = instance.mask;
+            instanceData->instanceOffset = instance.instanceOffset;
+            instanceData->flags = ToVulkanAccelerationContainerInstanceFlags(instance.flags);
+            instanceData->accelerationStructureHandle = geometryContainer->GetHandle();
+            if (instanceData->accelerationStructureHandle == 0) {
+                return DAWN_VALIDATION_ERROR("Invalid Acceleration Container Handle");
+            }
+            return {};
+        }
+
+        // Large top-level containers are packed in chunks of this many instances on the worker
+        // threads, smaller ones on the calling thread.
+        constexpr uint32_t kInstancesPerPackingTask = 4096;
+
+        MaybeError PackAccelerationInstances(
+            Device* device,
+            const RayTracingAccelerationInstanceDescriptor* instances,
+            uint32_t instanceCount,
+            VkAccelerationInstance* instanceData) {
+            if (instanceCount <= kInstancesPerPackingTask) {
+                for (uint32_t ii = 0; ii < instanceCount; ++ii) {
+                    DAWN_TRY(ToVulkanAccelerationInstance(instances[ii], &instanceData[ii]));
+                }
+                return {};
+            }
+
+            // The instances only read the cached handles of their geometry containers, so the
+            // chunks are independent. The first error of each chunk is kept to report the one of
+            // the lowest instance, like the serial loop.
+            uint32_t taskCount =
+                (instanceCount + kInstancesPerPackingTask - 1) / kInstancesPerPackingTask;
+            std::vector<std::unique_ptr<ErrorData>> errors(taskCount);
+            device->GetRecordingThreadPool()->ParallelFor(taskCount, [&](uint32_t task) {
+                uint32_t first = task * kInstancesPerPackingTask;
+                uint32_t last = std::min(first + kInstancesPerPackingTask, instanceCount);
+                for (uint32_t ii = first; ii < last; ++ii) {
+                    MaybeError result =
+                        ToVulkanAccelerationInstance(instances[ii], &instanceData[ii]);
+                    if (result.IsError()) {
+                        errors[task] = result.AcquireError();
+                        return;
+                    }
+                }
+            });
+
+            for (std::unique_ptr<ErrorData>& error : errors) {
+                if (error != nullptr) {
+                    return std::move(error);
+                }
+            }
+            return {};
+        }
+
     }  // anonymous namespace
 
     // validate geometry instance flag bits to match with wgpu
@@ -169,6 +257,18 @@ namespace dawn_native { namespace vulkan {
                       VK_GEOMETRY_INSTANCE_FORCE_NO_OPAQUE_BIT_NV,
                   "");
 
+    static_assert(sizeof(VkAccelerationInstance) == kAccelerationInstanceSize, "");
+    static_assert(offsetof(VkAccelerationInstance, transform) ==
+                      kAccelerationInstanceTransformOffset,
+                  "");
+    static_assert(sizeof(VkAccelerationInstance::transform) ==
+                      kAccelerationInstanceIdAndMaskOffset - kAccelerationInstanceTransformOffset,
+                  "");
+    static_assert(offsetof(VkAccelerationInstance, accelerationStructureHandle) ==
+                      kAccelerationInstanceHandleOffset,
+                  "");
+    static_assert(sizeof(VkAccelerationInstanceProperties) == 2 * sizeof(uint32_t), "");
+
     // static
     ResultOrError<RayTracingAccelerationContainer*> RayTracingAccelerationContainer::Create(
         Device* device,
@@ -181,17 +281,8 @@ namespace dawn_native { namespace vulkan {
 
     void RayTracingAccelerationContainer::DestroyImpl() {
         Device* device = ToBackend(GetDevice());
-        DestroyScratchBuildMemory();
-        if (mScratchMemory.result.buffer != VK_NULL_HANDLE) {
-            Buffer* buffer = mScratchMemory.result.allocation.Get();
-            buffer->Destroy();
-            mScratchMemory.result.buffer = VK_NULL_HANDLE;
-        }
-        if (mScratchMemory.update.buffer != VK_NULL_HANDLE) {
-            Buffer* buffer = mScratchMemory.update.allocation.Get();
-            buffer->Destroy();
-            mScratchMemory.update.buffer = VK_NULL_HANDLE;
-        }
+        // The sub-allocation is only reclaimed once the pending serial is completed.
+        device->DeallocateMemory(&mResultMemoryAllocation);
         if (mInstanceMemory.buffer != VK_NULL_HANDLE) {
             Buffer* buffer = mInstanceMemory.allocation.Get();
             if (buffer != nullptr) {
@@ -204,12 +295,179 @@ namespace dawn_native { namespace vulkan {
             device->GetFencedDeleter()->DeleteWhenUnused(mAccelerationStructure);
             mAccelerationStructure = VK_NULL_HANDLE;
         }
+        if (mCompactedSizeQueryPool != VK_NULL_HANDLE) {
+            device->GetFencedDeleter()->DeleteWhenUnused(mCompactedSizeQueryPool);
+            mCompactedSizeQueryPool = VK_NULL_HANDLE;
+        }
+        if (mBuildTimeQueryPool != VK_NULL_HANDLE) {
+            device->GetFencedDeleter()->DeleteWhenUnused(mBuildTimeQueryPool);
+            mBuildTimeQueryPool = VK_NULL_HANDLE;
+        }
     }
 
     uint64_t RayTracingAccelerationContainer::GetHandleImpl() {
         return mHandle;
     }
 
+    MaybeError RayTracingAccelerationContainer::UpdateInstancesImpl(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceDescriptor* instances) {
+        if (instanceCount == 0) {
+            return {};
+        }
+
+        // stage the instances in the ring buffer and copy them over on the GPU timeline, so that
+        // builds recorded before keep reading the previous instances. The copy is only recorded
+        // once all the instances were packed, so a rejected instance changes nothing.
+        return UploadInstances(firstInstance, instanceCount, instances);
+    }
+
+    MaybeError RayTracingAccelerationContainer::UpdateInstancePropertiesImpl(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceProperties* properties) {
+        if (instanceCount == 0) {
+            return {};
+        }
+
+        Device* device = ToBackend(GetDevice());
+        constexpr uint64_t kPropertiesOffset = sizeof(VkAccelerationInstance::transform);
+        constexpr size_t kAlignment = alignof(VkAccelerationInstanceProperties);
+        uint64_t size = instanceCount * sizeof(VkAccelerationInstanceProperties);
+
+        DynamicUploader* uploader = device->GetDynamicUploader();
+        UploadHandle uploadHandle;
+        DAWN_TRY_ASSIGN(uploadHandle, uploader->Allocate(size + kAlignment - 1,
+                                                         device->GetPendingCommandSerial()));
+        ASSERT(uploadHandle.mappedBuffer != nullptr);
+
+        uint8_t* mappedBuffer = static_cast<uint8_t*>(uploadHandle.mappedBuffer);
+        VkAccelerationInstanceProperties* propertiesData =
+            reinterpret_cast<VkAccelerationInstanceProperties*>(
+                AlignPtr(mappedBuffer, kAlignment));
+        uint64_t sourceOffset =
+            uploadHandle.startOffset + (reinterpret_cast<uint8_t*>(propertiesData) - mappedBuffer);
+
+        // the properties are packed back to back in staging memory, and copied into the middle
+        // of each instance record with one region per instance
+        std::vector<VkBufferCopy> copies(instanceCount);
+        for (uint32_t ii = 0; ii < instanceCount; ++ii) {
+            propertiesData[ii].instanceId = properties[ii].instanceId;
+            propertiesData[ii].mask = properties[ii].mask;
+            propertiesData[ii].instanceOffset = properties[ii].instanceOffset;
+            propertiesData[ii].flags =
+                ToVulkanAccelerationContainerInstanceFlags(properties[ii].flags);
+
+            copies[ii].srcOffset = sourceOffset + ii * sizeof(VkAccelerationInstanceProperties);
+            copies[ii].dstOffset =
+                (firstInstance + ii) * sizeof(VkAccelerationInstance) + kPropertiesOffset;
+            copies[ii].size = sizeof(VkAccelerationInstanceProperties);
+        }
+
+        // the next build or update transitions the instance buffer out of the copy usage
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+        Buffer* instanceBuffer = mInstanceMemory.allocation.Get();
+        instanceBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+        device->fn.CmdCopyBuffer(recordingContext->commandBuffer,
+                                 ToBackend(uploadHandle.stagingBuffer)->GetBufferHandle(),
+                                 instanceBuffer->GetHandle(), instanceCount, copies.data());
+        return {};
+    }
+
+    ResultOrError<RayTracingAccelerationContainerBase*>
+    RayTracingAccelerationContainer::CreateSubsetImpl(
+        const RayTracingAccelerationContainerSubsetDescriptor* subsetDescriptor,
+        const std::vector<uint32_t>& instanceIndices) {
+        Device* device = ToBackend(GetDevice());
+
+        RayTracingAccelerationContainerDescriptor descriptor;
+        descriptor.flags = subsetDescriptor->flags;
+        descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+        descriptor.instanceCount = static_cast<uint32_t>(instanceIndices.size());
+        descriptor.instances = nullptr;
+        descriptor.updateRebuildThreshold = subsetDescriptor->updateRebuildThreshold;
+
+        std::unique_ptr<RayTracingAccelerationContainer> subset =
+            std::make_unique<RayTracingAccelerationContainer>(device, &descriptor);
+        DAWN_TRY(subset->Initialize(&descriptor));
+
+        // copy the packed instances on the GPU timeline, after the uploads of the instances
+        // recorded before, with one region per run of consecutive instances
+        std::vector<VkBufferCopy> copies;
+        for (uint32_t ii = 0; ii < instanceIndices.size(); ++ii) {
+            uint64_t srcOffset = instanceIndices[ii] * sizeof(VkAccelerationInstance);
+            if (!copies.empty() && copies.back().srcOffset + copies.back().size == srcOffset) {
+                copies.back().size += sizeof(VkAccelerationInstance);
+                continue;
+            }
+            VkBufferCopy copy;
+            copy.srcOffset = srcOffset;
+            copy.dstOffset = ii * sizeof(VkAccelerationInstance);
+            copy.size = sizeof(VkAccelerationInstance);
+            copies.push_back(copy);
+        }
+
+        // the next build or update of the subset transitions its instance buffer out of the
+        // copy usage
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+        Buffer* srcBuffer = mInstanceMemory.allocation.Get();
+        Buffer* dstBuffer = subset->mInstanceMemory.allocation.Get();
+        srcBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
+        dstBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+        device->fn.CmdCopyBuffer(recordingContext->commandBuffer, srcBuffer->GetHandle(),
+                                 dstBuffer->GetHandle(), static_cast<uint32_t>(copies.size()),
+                                 copies.data());
+
+        return subset.release();
+    }
+
+    MaybeError RayTracingAccelerationContainer::UploadInstances(
+        uint32_t firstInstance,
+        uint32_t instanceCount,
+        const RayTracingAccelerationInstanceDescriptor* instances) {
+        Device* device = ToBackend(GetDevice());
+        ASSERT(instanceCount > 0);
+        uint64_t offset = firstInstance * sizeof(VkAccelerationInstance);
+        uint64_t size = instanceCount * sizeof(VkAccelerationInstance);
+
+        // the ring buffer doesn't align its allocations, so over-allocate to be able to pack the
+        // instances in place
+        constexpr size_t kAlignment = alignof(VkAccelerationInstance);
+        DynamicUploader* uploader = device->GetDynamicUploader();
+        UploadHandle uploadHandle;
+        DAWN_TRY_ASSIGN(uploadHandle, uploader->Allocate(size + kAlignment - 1,
+                                                         device->GetPendingCommandSerial()));
+        ASSERT(uploadHandle.mappedBuffer != nullptr);
+
+        uint8_t* mappedBuffer = static_cast<uint8_t*>(uploadHandle.mappedBuffer);
+        uint8_t* instanceData = AlignPtr(mappedBuffer, kAlignment);
+        DAWN_TRY(PackAccelerationInstances(
+            device, instances, instanceCount,
+            reinterpret_cast<VkAccelerationInstance*>(instanceData)));
+
+        // the next build or update transitions the instance buffer out of the copy usage
+        return device->CopyFromStagingToBuffer(
+            uploadHandle.stagingBuffer, uploadHandle.startOffset + (instanceData - mappedBuffer),
+            mInstanceMemory.allocation.Get(), offset, size);
+    }
+
+    void RayTracingAccelerationContainer::TransitionInstanceBufferNow(
+        CommandRecordingContext* recordingContext) {
+        Buffer* buffer = GetInstanceBuffer() != nullptr ? ToBackend(GetInstanceBuffer())
+                                                        : mInstanceMemory.allocation.Get();
+        if (buffer != nullptr) {
+            buffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::RayTracing);
+        }
+    }
+
+    void RayTracingAccelerationContainer::TransitionGeometryBuffersNow(
+        CommandRecordingContext* recordingContext) {
+        for (BufferBase* buffer : GetGeometryBuffers()) {
+            ToBackend(buffer)->TransitionUsageNow(recordingContext, wgpu::BufferUsage::RayTracing);
+        }
+    }
+
     MaybeError RayTracingAccelerationContainer::Initialize(
         const RayTracingAccelerationContainerDescriptor* descriptor) {
         Device* device = ToBackend(GetDevice());
@@ -278,99 +536,88 @@ namespace dawn_native { namespace vulkan {
                     geometryInfo.geometry.aabbs.stride = 0;
                     geometryInfo.geometry.aabbs.offset = 0;
                 }
-                // no transform data support (yet?)
-                geometryInfo.geometry.triangles.transformData = nullptr;
-                geometryInfo.geometry.triangles.transformOffset = 0;
+                // transform buffer, a 3x4 row-major matrix applied to the vertices
+                if (geometry.transform != nullptr && geometry.transform->buffer != nullptr) {
+                    Buffer* transformBuffer = ToBackend(geometry.transform->buffer);
+                    geometryInfo.geometry.triangles.transformData = transformBuffer->GetHandle();
+                    geometryInfo.geometry.triangles.transformOffset = geometry.transform->offset;
+                } else {
+                    geometryInfo.geometry.triangles.transformData = VK_NULL_HANDLE;
+                    geometryInfo.geometry.triangles.transformOffset = 0;
+                }
                 mGeometries.push_back(geometryInfo);
             };
         }
 
-        // acceleration container holds instances
-        if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Top) {
-            // only use instances array when no instance buffer was provided
-            if (descriptor->instanceBuffer == nullptr) {
-                // create data for instance buffer
-                for (unsigned int ii = 0; ii < descriptor->instanceCount; ++ii) {
-                    const RayTracingAccelerationInstanceDescriptor& instance =
-                        descriptor->instances[ii];
-                    RayTracingAccelerationContainer* geometryContainer =
-                        ToBackend(instance.geometryContainer);
-                    VkAccelerationInstance instanceData{};
-                    // process transform object
-                    if (instance.transform != nullptr) {
-                        float transform[16] = {};
-                        Fill4x3TransformMatrix(transform, instance.transform->translation,
-                                               instance.transform->rotation,
-                                               instance.transform->scale);
-                        memcpy(&instanceData.transform, transform, sizeof(instanceData.transform));
-                    }
-                    // process transform matrix
-                    else if (instance.transformMatrix != nullptr) {
-                        memcpy(&instanceData.transform, instance.transformMatrix,
-                               sizeof(instanceData.transform));
-                    }
-                    // validate ranges
-                    if (instance.mask >= (2 << 7)) {
-                        return DAWN_VALIDATION_ERROR("Instance Mask out of range");
-                    }
-                    if (instance.instanceId >= (2 << 23)) {
-                        return DAWN_VALIDATION_ERROR("Instance Id out of range");
-                    }
-                    instanceData.instanceId = instance.instanceId;
-                    instanceData.mask = instance.mask;
-                    instanceData.instanceOffset = instance.instanceOffset;
-                    instanceData.flags = ToVulkanAccelerationContainerInstanceFlags(instance.flags);
-                    instanceData.accelerationStructureHandle = geometryContainer->GetHandle();
-                    if (instanceData.accelerationStructureHandle == 0) {
-                        return DAWN_VALIDATION_ERROR("Invalid Acceleration Container Handle");
-                    }
-                    mInstances.push_back(instanceData);
-                };
-            }
-        }
-
         // container requires instance buffer
         if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Top) {
             // only create internal instance buffer when no external one was provided
             if (descriptor->instanceBuffer == nullptr) {
                 uint64_t bufferSize = descriptor->instanceCount * sizeof(VkAccelerationInstance);
 
-                BufferDescriptor descriptor = {nullptr, nullptr, wgpu::BufferUsage::CopyDst,
-                                               bufferSize};
-                Buffer* buffer = ToBackend(device->CreateBuffer(&descriptor));
+                // the instances are copied out of the buffer to create subsets
+                BufferDescriptor bufferDescriptor = {nullptr, nullptr,
+                                                     wgpu::BufferUsage::CopySrc |
+                                                         wgpu::BufferUsage::CopyDst |
+                                                         wgpu::BufferUsage::RayTracing,
+                                                     bufferSize};
+                Buffer* buffer = ToBackend(device->CreateBuffer(&bufferDescriptor));
                 mInstanceMemory.allocation = AcquireRef(buffer);
                 mInstanceMemory.buffer = buffer->GetHandle();
                 mInstanceMemory.offset = buffer->GetMemoryResource().GetOffset();
                 mInstanceMemory.memory =
                     ToBackend(buffer->GetMemoryResource().GetResourceHeap())->GetMemory();
 
-                // copy instance data into instance buffer
-                buffer->SetSubData(0, bufferSize, mInstances.data());
-                mInstanceCount = mInstances.size();
+                // pack the instances straight into the staging memory of the instance buffer,
+                // the instances of subsets are copied from their source container instead
+                mInstanceCount = descriptor->instanceCount;
+                if (mInstanceCount > 0 && descriptor->instances != nullptr) {
+                    DAWN_TRY(UploadInstances(0, mInstanceCount, descriptor->instances));
+                }
             }
-            // external instance buffer
+            // external instance buffer, which might get written on the GPU
             else {
                 Buffer* buffer = ToBackend(descriptor->instanceBuffer);
                 mInstanceMemory.buffer = buffer->GetHandle();
                 mInstanceMemory.offset = buffer->GetMemoryResource().GetOffset();
                 mInstanceMemory.memory =
                     ToBackend(buffer->GetMemoryResource().GetResourceHeap())->GetMemory();
-                mInstanceCount = buffer->GetSize() / sizeof(VkAccelerationInstance);
+                mInstanceBufferOffset = descriptor->instanceBufferOffset;
+                if (descriptor->instanceCount != 0) {
+                    mInstanceCount = descriptor->instanceCount;
+                } else {
+                    mInstanceCount = (buffer->GetSize() - mInstanceBufferOffset) /
+                                     sizeof(VkAccelerationInstance);
+                }
             }
         }
 
         // create the acceleration container
         {
-            MaybeError result = CreateAccelerationStructure(descriptor);
+            MaybeError result = CreateAccelerationStructure();
             if (result.IsError())
                 return result.AcquireError();
         }
 
-        // reserve scratch memory
-        {
-            MaybeError result = ReserveScratchMemory(descriptor);
-            if (result.IsError())
-                return result.AcquireError();
+        // only remember the scratch sizes, the memory itself is taken from the device's pool
+        mBuildScratchSize = GetMemoryRequirementSize(
+            VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_BUILD_SCRATCH_NV);
+        if (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::AllowUpdate) {
+            mUpdateScratchSize = GetMemoryRequirementSize(
+                VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_UPDATE_SCRATCH_NV);
+        }
+
+        // reserve result memory
+        DAWN_TRY(ReserveResultMemory());
+
+        // query pool to read back the compacted size after building
+        if (descriptor->flags & wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) {
+            DAWN_TRY(CreateQueryPool(VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_NV, 1,
+                                     &mCompactedSizeQueryPool));
+        }
+        // and the GPU time of the builds, for their build info
+        if (GetDevice()->IsExtensionEnabled(Extension::TimestampQuery)) {
+            DAWN_TRY(CreateQueryPool(VK_QUERY_TYPE_TIMESTAMP, 2, &mBuildTimeQueryPool));
         }
 
         // take handle
@@ -382,6 +629,8 @@ namespace dawn_native { namespace vulkan {
             mHandle = handle;
         }
 
+        UpdateMemoryInfo();
+
         return {};
     }
 
@@ -389,104 +638,144 @@ namespace dawn_native { namespace vulkan {
         DestroyInternal();
     }
 
-    void RayTracingAccelerationContainer::DestroyScratchBuildMemory() {
-        // delete scratch build memory
-        if (mScratchMemory.build.buffer != VK_NULL_HANDLE) {
-            Buffer* buffer = mScratchMemory.build.allocation.Get();
-            buffer->Destroy();
-            mScratchMemory.build.buffer = VK_NULL_HANDLE;
+    MaybeError RayTracingAccelerationContainer::ReserveResultMemory() {
+        Device* device = ToBackend(GetDevice());
+
+        // Result memory is sub-allocated like the memory of any other resource, so that small
+        // containers share device memory blocks instead of each owning a whole buffer.
+        VkMemoryRequirements requirements =
+            GetMemoryRequirements(VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_OBJECT_NV)
+                .memoryRequirements;
+
+        DAWN_TRY_ASSIGN(mResultMemoryAllocation, device->AllocateMemory(requirements, false));
+        mResultMemorySize = requirements.size;
+
+        VkBindAccelerationStructureMemoryInfoNV memoryBindInfo{};
+        memoryBindInfo.sType = VK_STRUCTURE_TYPE_BIND_ACCELERATION_STRUCTURE_MEMORY_INFO_NV;
+        memoryBindInfo.accelerationStructure = GetAccelerationStructure();
+        memoryBindInfo.memory =
+            ToBackend(mResultMemoryAllocation.GetResourceHeap())->GetMemory();
+        memoryBindInfo.memoryOffset = mResultMemoryAllocation.GetOffset();
+        memoryBindInfo.deviceIndexCount = 0;
+        memoryBindInfo.pDeviceIndices = nullptr;
+
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.BindAccelerationStructureMemoryNV(device->GetVkDevice(), 1, &memoryBindInfo),
+            "vkBindAccelerationStructureMemoryNV"));
+
+        return {};
+    }
+
+    void RayTracingAccelerationContainer::ReleaseResultMemory() {
+        Device* device = ToBackend(GetDevice());
+
+        device->DeallocateMemory(&mResultMemoryAllocation);
+        mResultMemorySize = 0;
+        if (mAccelerationStructure != VK_NULL_HANDLE) {
+            device->GetFencedDeleter()->DeleteWhenUnused(mAccelerationStructure);
+            mAccelerationStructure = VK_NULL_HANDLE;
         }
     }
 
-    MaybeError RayTracingAccelerationContainer::ReserveScratchMemory(
-        const RayTracingAccelerationContainerDescriptor* descriptor) {
+    MaybeError RayTracingAccelerationContainer::CreateQueryPool(VkQueryType type,
+                                                                uint32_t count,
+                                                                VkQueryPool* queryPool) {
         Device* device = ToBackend(GetDevice());
 
-        // create scratch memory for this container
-        uint64_t resultSize =
-            GetMemoryRequirementSize(VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_OBJECT_NV);
-        uint64_t buildSize = GetMemoryRequirementSize(
-            VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_BUILD_SCRATCH_NV);
-        uint64_t updateSize = GetMemoryRequirementSize(
-            VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_UPDATE_SCRATCH_NV);
+        VkQueryPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.queryType = type;
+        createInfo.queryCount = count;
+        createInfo.pipelineStatistics = 0;
 
-        VkMemoryRequirements2 resultRequirements =
-            GetMemoryRequirements(VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_OBJECT_NV);
-        resultRequirements.memoryRequirements.size = resultSize;
+        return CheckVkSuccess(device->fn.CreateQueryPool(device->GetVkDevice(), &createInfo,
+                                                         nullptr, &**queryPool),
+                              "vkCreateQueryPool");
+    }
 
-        VkMemoryRequirements2 buildRequirements = GetMemoryRequirements(
-            VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_BUILD_SCRATCH_NV);
-        buildRequirements.memoryRequirements.size = buildSize;
+    MaybeError RayTracingAccelerationContainer::RecreateAsCompacted(uint64_t compactedSize) {
+        Device* device = ToBackend(GetDevice());
 
-        VkMemoryRequirements2 updateRequirements = GetMemoryRequirements(
-            VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_UPDATE_SCRATCH_NV);
-        updateRequirements.memoryRequirements.size = updateSize;
+        // the previous objects might still be referenced by commands in flight
+        ReleaseResultMemory();
 
-        VkBufferCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.usage = VK_BUFFER_USAGE_RAY_TRACING_BIT_NV;
-        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount = 0;
-        createInfo.pQueueFamilyIndices = 0;
+        // the geometry and instance counts must be 0 when a compacted size is given
+        VkAccelerationStructureCreateInfoNV accelerationStructureCI{};
+        accelerationStructureCI.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_NV;
+        accelerationStructureCI.compactedSize = compactedSize;
+        accelerationStructureCI.info = {};
+        accelerationStructureCI.info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
+        accelerationStructureCI.info.flags = ToVulkanBuildAccelerationContainerFlags(GetFlags());
+        accelerationStructureCI.info.type =
+            GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Top
+                ? VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_NV
+                : VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_NV;
+        accelerationStructureCI.info.instanceCount = 0;
+        accelerationStructureCI.info.geometryCount = 0;
+        accelerationStructureCI.info.pGeometries = nullptr;
 
-        // allocate scratch result memory
-        {
-            BufferDescriptor descriptor = {nullptr, nullptr, wgpu::BufferUsage::CopyDst,
-                                           resultSize};
-            Buffer* buffer = ToBackend(device->CreateBuffer(&descriptor));
-            mScratchMemory.result.allocation = AcquireRef(buffer);
-            mScratchMemory.result.buffer = buffer->GetHandle();
-            mScratchMemory.result.offset = buffer->GetMemoryResource().GetOffset();
-            mScratchMemory.result.memory =
-                ToBackend(buffer->GetMemoryResource().GetResourceHeap())->GetMemory();
-        }
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateAccelerationStructureNV(
+                device->GetVkDevice(), &accelerationStructureCI, nullptr, &*mAccelerationStructure),
+            "vkCreateAccelerationStructureNV"));
 
-        // allocate scratch build memory
-        {
-            BufferDescriptor descriptor = {nullptr, nullptr, wgpu::BufferUsage::CopyDst, buildSize};
-            Buffer* buffer = ToBackend(device->CreateBuffer(&descriptor));
-            mScratchMemory.build.allocation = AcquireRef(buffer);
-            mScratchMemory.build.buffer = buffer->GetHandle();
-            mScratchMemory.build.offset = buffer->GetMemoryResource().GetOffset();
-            mScratchMemory.build.memory =
-                ToBackend(buffer->GetMemoryResource().GetResourceHeap())->GetMemory();
-        }
+        DAWN_TRY(ReserveResultMemory());
+        DAWN_TRY(FetchHandle(&mHandle));
 
-        // allocate scratch update memory
-        if (updateSize > 0) {
-            BufferDescriptor descriptor = {nullptr, nullptr, wgpu::BufferUsage::CopyDst,
-                                           updateSize};
-            Buffer* buffer = ToBackend(device->CreateBuffer(&descriptor));
-            mScratchMemory.update.allocation = AcquireRef(buffer);
-            mScratchMemory.update.buffer = buffer->GetHandle();
-            mScratchMemory.update.offset = buffer->GetMemoryResource().GetOffset();
-            mScratchMemory.update.memory =
-                ToBackend(buffer->GetMemoryResource().GetResourceHeap())->GetMemory();
-        }
+        UpdateMemoryInfo();
 
-        // bind scratch result memory
-        VkBindAccelerationStructureMemoryInfoNV memoryBindInfo{};
-        memoryBindInfo.sType = VK_STRUCTURE_TYPE_BIND_ACCELERATION_STRUCTURE_MEMORY_INFO_NV;
-        memoryBindInfo.accelerationStructure = GetAccelerationStructure();
-        memoryBindInfo.memory = mScratchMemory.result.memory;
-        memoryBindInfo.memoryOffset = mScratchMemory.result.offset;
-        memoryBindInfo.deviceIndexCount = 0;
-        memoryBindInfo.pDeviceIndices = nullptr;
+        return {};
+    }
 
-        // make sure the memory got allocated properly
-        if (memoryBindInfo.memory == VK_NULL_HANDLE) {
-            return DAWN_VALIDATION_ERROR("Failed to allocate Scratch Memory");
-        }
+    void RayTracingAccelerationContainer::EvictImpl() {
+        // the containers which are evicted aren't used by commands in flight anymore, the
+        // geometries and scratch sizes are kept to recreate the same acceleration structure
+        ReleaseResultMemory();
+        mHandle = 0;
 
-        DAWN_TRY(CheckVkSuccess(
-            device->fn.BindAccelerationStructureMemoryNV(device->GetVkDevice(), 1, &memoryBindInfo),
-            "vkBindAccelerationStructureMemoryNV"));
+        UpdateMemoryInfo();
+    }
+
+    MaybeError RayTracingAccelerationContainer::MakeResidentImpl() {
+        ASSERT(mAccelerationStructure == VK_NULL_HANDLE);
+
+        DAWN_TRY(CreateAccelerationStructure());
+        DAWN_TRY(ReserveResultMemory());
+        DAWN_TRY(FetchHandle(&mHandle));
+
+        UpdateMemoryInfo();
 
         return {};
     }
 
+    void RayTracingAccelerationContainer::ReleaseBuildOnceResources() {
+        if ((GetFlags() & wgpu::RayTracingAccelerationContainerFlag::BuildOnce) == 0) {
+            return;
+        }
+        // an external instance buffer is owned by the application and stays untouched
+        if (mInstanceMemory.allocation.Get() != nullptr) {
+            mInstanceMemory.allocation->Destroy();
+            mInstanceMemory = {};
+        }
+        mBuildScratchSize = 0;
+
+        UpdateMemoryInfo();
+    }
+
+    void RayTracingAccelerationContainer::UpdateMemoryInfo() {
+        RayTracingAccelerationContainerMemoryInfo info;
+        info.resultSize = mResultMemorySize;
+        info.buildScratchSize = mBuildScratchSize;
+        info.updateScratchSize = mUpdateScratchSize;
+        // an external instance buffer is owned by the application
+        if (mInstanceMemory.allocation.Get() != nullptr) {
+            info.instanceSize = mInstanceMemory.allocation->GetSize();
+        }
+        SetMemoryInfo(info);
+    }
+
     VkMemoryRequirements2 RayTracingAccelerationContainer::GetMemoryRequirements(
         VkAccelerationStructureMemoryRequirementsTypeNV type) const {
         Device* device = ToBackend(GetDevice());
@@ -511,8 +800,7 @@ namespace dawn_native { namespace vulkan {
         return GetMemoryRequirements(type).memoryRequirements.size;
     }
 
-    MaybeError RayTracingAccelerationContainer::CreateAccelerationStructure(
-        const RayTracingAccelerationContainerDescriptor* descriptor) {
+    MaybeError RayTracingAccelerationContainer::CreateAccelerationStructure() {
         Device* device = ToBackend(GetDevice());
 
         VkAccelerationStructureCreateInfoNV accelerationStructureCI{};
@@ -521,17 +809,16 @@ namespace dawn_native { namespace vulkan {
 
         accelerationStructureCI.info = {};
         accelerationStructureCI.info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
-        accelerationStructureCI.info.flags =
-            ToVulkanBuildAccelerationContainerFlags(descriptor->flags);
-        if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Top) {
+        accelerationStructureCI.info.flags = ToVulkanBuildAccelerationContainerFlags(GetFlags());
+        if (GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Top) {
             accelerationStructureCI.info.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_NV;
             accelerationStructureCI.info.instanceCount = mInstanceCount;
             accelerationStructureCI.info.geometryCount = 0;
             accelerationStructureCI.info.pGeometries = nullptr;
-        } else if (descriptor->level == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
+        } else if (GetLevel() == wgpu::RayTracingAccelerationContainerLevel::Bottom) {
             accelerationStructureCI.info.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_NV;
             accelerationStructureCI.info.instanceCount = 0;
-            accelerationStructureCI.info.geometryCount = descriptor->geometryCount;
+            accelerationStructureCI.info.geometryCount = mGeometries.size();
             accelerationStructureCI.info.pGeometries = mGeometries.data();
         } else {
             return DAWN_VALIDATION_ERROR("Invalid Acceleration Container Level");
@@ -551,6 +838,10 @@ namespace dawn_native { namespace vulkan {
         return mInstanceMemory;
     }
 
+    uint64_t RayTracingAccelerationContainer::GetInstanceBufferOffset() const {
+        return mInstanceBufferOffset;
+    }
+
     MaybeError RayTracingAccelerationContainer::FetchHandle(uint64_t* handle) {
         Device* device = ToBackend(GetDevice());
         MaybeError result = CheckVkSuccess(
@@ -578,8 +869,63 @@ namespace dawn_native { namespace vulkan {
         return mInstanceCount;
     }
 
-    ScratchMemoryPool& RayTracingAccelerationContainer::GetScratchMemory() {
-        return mScratchMemory;
+    uint64_t RayTracingAccelerationContainer::GetBuildScratchSize() const {
+        return mBuildScratchSize;
+    }
+
+    uint64_t RayTracingAccelerationContainer::GetUpdateScratchSize() const {
+        return mUpdateScratchSize;
+    }
+
+    VkQueryPool RayTracingAccelerationContainer::GetCompactedSizeQueryPool() const {
+        return mCompactedSizeQueryPool;
+    }
+
+    VkQueryPool RayTracingAccelerationContainer::GetBuildTimeQueryPool() const {
+        return mBuildTimeQueryPool;
+    }
+
+    BuildQueryTracker::BuildQueryTracker(Device* device) : mDevice(device) {
+    }
+
+    BuildQueryTracker::~BuildQueryTracker() {
+        ASSERT(mInflightQueries.Empty());
+    }
+
+    void BuildQueryTracker::Track(RayTracingAccelerationContainer* container) {
+        mInflightQueries.Enqueue(Ref<RayTracingAccelerationContainer>(container),
+                                 mDevice->GetPendingCommandSerial());
+    }
+
+    void BuildQueryTracker::Tick(Serial finishedSerial) {
+        for (Ref<RayTracingAccelerationContainer>& container :
+             mInflightQueries.IterateUpTo(finishedSerial)) {
+            // the build has completed, so the results are available without waiting
+            VkQueryPool queryPool = container->GetCompactedSizeQueryPool();
+            if (queryPool != VK_NULL_HANDLE) {
+                uint64_t compactedSize = 0;
+                VkResult result = VkResult::WrapUnsafe(mDevice->fn.GetQueryPoolResults(
+                    mDevice->GetVkDevice(), queryPool, 0, 1, sizeof(compactedSize),
+                    &compactedSize, sizeof(compactedSize), VK_QUERY_RESULT_64_BIT));
+                if (result == VK_SUCCESS) {
+                    container->SetCompactedSize(compactedSize);
+                }
+            }
+
+            queryPool = container->GetBuildTimeQueryPool();
+            if (queryPool != VK_NULL_HANDLE) {
+                uint64_t timestamps[2] = {};
+                VkResult result = VkResult::WrapUnsafe(mDevice->fn.GetQueryPoolResults(
+                    mDevice->GetVkDevice(), queryPool, 0, 2, sizeof(timestamps), timestamps,
+                    sizeof(uint64_t), VK_QUERY_RESULT_64_BIT));
+                if (result == VK_SUCCESS && timestamps[1] >= timestamps[0]) {
+                    float period = mDevice->GetDeviceInfo().properties.limits.timestampPeriod;
+                    container->SetBuildTime(
+                        static_cast<uint64_t>((timestamps[1] - timestamps[0]) * period));
+                }
+            }
+        }
+        mInflightQueries.ClearUpTo(finishedSerial);
     }
 
 }}  // namespace dawn_native::vulkan
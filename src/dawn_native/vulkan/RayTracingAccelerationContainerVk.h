@@ -15,14 +15,17 @@
 #ifndef DAWNNATIVE_VULKAN_RAY_TRACING_ACCELERATION_CONTAINER_H_
 #define DAWNNATIVE_VULKAN_RAY_TRACING_ACCELERATION_CONTAINER_H_
 
+#include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 #include "dawn_native/RayTracingAccelerationContainer.h"
+#include "dawn_native/ResourceMemoryAllocation.h"
 #include "dawn_native/vulkan/BufferVk.h"
 
 #include <vector>
 
 namespace dawn_native { namespace vulkan {
 
+    struct CommandRecordingContext;
     class Device;
 
     struct VkAccelerationInstance {
@@ -34,10 +37,13 @@ namespace dawn_native { namespace vulkan {
         uint64_t accelerationStructureHandle;
     };
 
-    struct ScratchMemoryPool {
-        MemoryEntry result;
-        MemoryEntry update;
-        MemoryEntry build;
+    // The words of a VkAccelerationInstance between its transform and its acceleration structure
+    // handle, which can be overwritten without knowing the rest of the instance.
+    struct VkAccelerationInstanceProperties {
+        uint32_t instanceId : 24;
+        uint32_t mask : 8;
+        uint32_t instanceOffset : 24;
+        uint32_t flags : 8;
     };
 
     class RayTracingAccelerationContainer : public RayTracingAccelerationContainerBase {
@@ -59,33 +65,86 @@ namespace dawn_native { namespace vulkan {
         std::vector<VkGeometryNV>& GetGeometries();
 
         MemoryEntry& GetInstanceMemory();
+        uint64_t GetInstanceBufferOffset() const;
+
+        // Makes writes to the instance buffer visible to the acceleration structure build.
+        void TransitionInstanceBufferNow(CommandRecordingContext* recordingContext);
+
+        // Makes writes to the geometry buffers, by copies or shaders, visible to the acceleration
+        // structure build. Only recorded on the graphics queue which owns these buffers.
+        void TransitionGeometryBuffersNow(CommandRecordingContext* recordingContext);
 
-        ScratchMemoryPool& GetScratchMemory();
-        void DestroyScratchBuildMemory();
+        // Scratch memory isn't owned by the container, it is sub-allocated from the device's
+        // ScratchMemoryPool when a build or an update gets recorded.
+        uint64_t GetBuildScratchSize() const;
+        uint64_t GetUpdateScratchSize() const;
+
+        // Releases the memory which is only needed to build a container created with the
+        // BuildOnce flag, once its build has been recorded. The release is fenced on the
+        // pending serial so the build can still read it.
+        void ReleaseBuildOnceResources();
+
+        // Only valid for containers created with the AllowCompaction flag.
+        VkQueryPool GetCompactedSizeQueryPool() const;
+        // Two timestamps around the build, only valid when the TimestampQuery extension is
+        // enabled.
+        VkQueryPool GetBuildTimeQueryPool() const;
+
+        // Replaces the acceleration structure and its result memory with ones that are just big
+        // enough to be the destination of a compacting copy.
+        MaybeError RecreateAsCompacted(uint64_t compactedSize);
 
       private:
         using RayTracingAccelerationContainerBase::RayTracingAccelerationContainerBase;
 
         void DestroyImpl() override;
         uint64_t GetHandleImpl() override;
+        MaybeError UpdateInstancesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceDescriptor* instances) override;
+        MaybeError UpdateInstancePropertiesImpl(
+            uint32_t firstInstance,
+            uint32_t instanceCount,
+            const RayTracingAccelerationInstanceProperties* properties) override;
+        ResultOrError<RayTracingAccelerationContainerBase*> CreateSubsetImpl(
+            const RayTracingAccelerationContainerSubsetDescriptor* descriptor,
+            const std::vector<uint32_t>& instanceIndices) override;
+        void EvictImpl() override;
+        MaybeError MakeResidentImpl() override;
 
         std::vector<VkGeometryNV> mGeometries;
-        std::vector<VkAccelerationInstance> mInstances;
 
         // AS related
         VkAccelerationStructureNV mAccelerationStructure = VK_NULL_HANDLE;
 
-        // scratch memory
-        ScratchMemoryPool mScratchMemory;
+        // result memory
+        ResourceMemoryAllocation mResultMemoryAllocation;
+        uint64_t mResultMemorySize = 0;
+
+        // scratch memory requirements
+        uint64_t mBuildScratchSize = 0;
+        uint64_t mUpdateScratchSize = 0;
+
+        // compaction
+        VkQueryPool mCompactedSizeQueryPool = VK_NULL_HANDLE;
+        VkQueryPool mBuildTimeQueryPool = VK_NULL_HANDLE;
 
         // instance buffer
         MemoryEntry mInstanceMemory;
         uint32_t mInstanceCount;
-
-        MaybeError CreateAccelerationStructure(
-            const RayTracingAccelerationContainerDescriptor* descriptor);
-        MaybeError ReserveScratchMemory(
-            const RayTracingAccelerationContainerDescriptor* descriptor);
+        uint64_t mInstanceBufferOffset = 0;
+
+        // Packs the instances straight into staging memory and copies them to the instance
+        // buffer.
+        MaybeError UploadInstances(uint32_t firstInstance,
+                                   uint32_t instanceCount,
+                                   const RayTracingAccelerationInstanceDescriptor* instances);
+        MaybeError CreateAccelerationStructure();
+        MaybeError ReserveResultMemory();
+        void ReleaseResultMemory();
+        MaybeError CreateQueryPool(VkQueryType type, uint32_t count, VkQueryPool* queryPool);
+        void UpdateMemoryInfo();
 
         uint64_t mHandle;
         MaybeError FetchHandle(uint64_t* handle);
@@ -93,6 +152,22 @@ namespace dawn_native { namespace vulkan {
         MaybeError Initialize(const RayTracingAccelerationContainerDescriptor* descriptor);
     };
 
+    // Reads back the compacted sizes and build timestamps queried with the builds of containers,
+    // once the serial the builds were submitted with has completed.
+    class BuildQueryTracker {
+      public:
+        BuildQueryTracker(Device* device);
+        ~BuildQueryTracker();
+
+        void Track(RayTracingAccelerationContainer* container);
+        void Tick(Serial finishedSerial);
+
+      private:
+        Device* mDevice;
+
+        SerialQueue<Ref<RayTracingAccelerationContainer>> mInflightQueries;
+    };
+
 }}  // namespace dawn_native::vulkan
 
 #endif  // DAWNNATIVE_VULKAN_RAY_TRACING_ACCELERATION_CONTAINER_H_
@@ -0,0 +1,79 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/RayTracingBundleVk.h"
+
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+namespace dawn_native { namespace vulkan {
+
+    RayTracingBundle::RayTracingBundle(RayTracingBundleEncoder* encoder,
+                                       const RayTracingBundleDescriptor* descriptor,
+                                       PassResourceUsage resourceUsage)
+        : RayTracingBundleBase(encoder, descriptor, std::move(resourceUsage)) {
+    }
+
+    RayTracingBundle::~RayTracingBundle() {
+        // Destroying the pool frees the recording, which may still be executed by pending
+        // command buffers.
+        if (mPool != VK_NULL_HANDLE) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mPool);
+            mPool = VK_NULL_HANDLE;
+        }
+    }
+
+    VkCommandBuffer RayTracingBundle::GetRecording() const {
+        return mRecording;
+    }
+
+    ResultOrError<VkCommandBuffer> RayTracingBundle::BeginRecording() {
+        ASSERT(mRecording == VK_NULL_HANDLE);
+
+        Device* device = ToBackend(GetDevice());
+        VkDevice vkDevice = device->GetVkDevice();
+
+        VkCommandPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.queueFamilyIndex = device->GetGraphicsQueueFamily();
+
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateCommandPool(vkDevice, &createInfo, nullptr, &*mPool),
+            "vkCreateCommandPool"));
+
+        VkCommandBufferAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.commandPool = mPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commands = VK_NULL_HANDLE;
+        DAWN_TRY(
+            CheckVkSuccess(device->fn.AllocateCommandBuffers(vkDevice, &allocateInfo, &commands),
+                           "vkAllocateCommandBuffers"));
+
+        // The same recording can be executed by several pending command buffers, or several
+        // times by the same one.
+        DAWN_TRY(device->BeginSecondaryOutsideRenderPass(
+            commands, VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT));
+
+        mRecording = commands;
+        return commands;
+    }
+
+}}  // namespace dawn_native::vulkan
@@ -0,0 +1,51 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_RAYTRACINGBUNDLEVK_H_
+#define DAWNNATIVE_VULKAN_RAYTRACINGBUNDLEVK_H_
+
+#include "dawn_native/RayTracingBundle.h"
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+
+namespace dawn_native { namespace vulkan {
+
+    // Ray tracing bundles are recorded in a secondary command buffer the first time they are
+    // executed, and the command buffer is executed directly the next times. Unlike render
+    // bundles they don't depend on the state of the pass, so a single recording is enough. The
+    // recorded command buffer lives as long as the bundle.
+    class RayTracingBundle : public RayTracingBundleBase {
+      public:
+        RayTracingBundle(RayTracingBundleEncoder* encoder,
+                         const RayTracingBundleDescriptor* descriptor,
+                         PassResourceUsage resourceUsage);
+        ~RayTracingBundle() override;
+
+        // Both must be called with the device's render bundle replay mutex held, because the
+        // ray tracing passes executing the bundle can be recorded on several threads.
+        // Returns VK_NULL_HANDLE if the bundle wasn't recorded yet.
+        VkCommandBuffer GetRecording() const;
+        // Returns a begun secondary command buffer in which to record the bundle, which must be
+        // ended before it is executed.
+        ResultOrError<VkCommandBuffer> BeginRecording();
+
+      private:
+        VkCommandPool mPool = VK_NULL_HANDLE;
+        VkCommandBuffer mRecording = VK_NULL_HANDLE;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_RAYTRACINGBUNDLEVK_H_
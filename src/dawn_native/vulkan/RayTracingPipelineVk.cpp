@@ -19,6 +19,7 @@
 #include "dawn_native/vulkan/PipelineLayoutVk.h"
 #include "dawn_native/vulkan/ShaderModuleVk.h"
 #include "dawn_native/vulkan/RayTracingShaderBindingTableVk.h"
+#include "dawn_native/vulkan/StagingBufferVk.h"
 #include "dawn_native/vulkan/VulkanError.h"
 #include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
@@ -35,55 +36,234 @@ namespace dawn_native { namespace vulkan {
         return pipeline.release();
     }
 
+    // static
+    ResultOrError<std::vector<Ref<RayTracingPipelineBase>>> RayTracingPipeline::CreateBatch(
+        Device* device,
+        const std::vector<const RayTracingPipelineDescriptor*>& descriptors) {
+        std::vector<Ref<RayTracingPipelineBase>> pipelines;
+        std::vector<ShaderGroupStorage> shaderGroups(descriptors.size());
+        std::vector<VkRayTracingPipelineCreateInfoNV> createInfos(descriptors.size());
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            pipelines.push_back(AcquireRef(new RayTracingPipeline(device, descriptors[i])));
+            GetCreateInfo(descriptors[i], &shaderGroups[i], &createInfos[i]);
+        }
+
+        // all the pipelines are compiled by a single call, which lets the driver parallelize it
+        std::vector<VkPipeline> handles(descriptors.size());
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateRayTracingPipelinesNV(device->GetVkDevice(),
+                                                  device->GetPipelineCache(), createInfos.size(),
+                                                  createInfos.data(), nullptr,
+                                                  AsVkArray(handles.data())),
+            "vkCreateRayTracingPipelinesNV"));
+
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            RayTracingPipeline* pipeline = ToBackend(pipelines[i].Get());
+            pipeline->mHandle = handles[i];
+        }
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            RayTracingPipeline* pipeline = ToBackend(pipelines[i].Get());
+            DAWN_TRY(pipeline->InitializeRecords(descriptors[i]));
+        }
+
+        return std::move(pipelines);
+    }
+
+    // static
+    void RayTracingPipeline::GetCreateInfo(const RayTracingPipelineDescriptor* descriptor,
+                                           ShaderGroupStorage* shaderGroups,
+                                           VkRayTracingPipelineCreateInfoNV* createInfo) {
+        RayTracingShaderBindingTable* shaderBindingTable =
+            ToBackend(descriptor->rayTracingState->shaderBindingTable);
+
+        shaderGroups->stages = shaderBindingTable->GetStages();
+        shaderGroups->groups = shaderBindingTable->GetGroups();
+
+        *createInfo = {};
+        createInfo->sType = VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_NV;
+        createInfo->pNext = nullptr;
+        createInfo->flags = 0;
+        if (descriptor->allowDerivatives) {
+            createInfo->flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+        }
+        createInfo->pStages = shaderGroups->stages.data();
+        createInfo->stageCount = shaderGroups->stages.size();
+        createInfo->pGroups = shaderGroups->groups.data();
+        createInfo->groupCount = shaderGroups->groups.size();
+        createInfo->maxRecursionDepth = descriptor->rayTracingState->maxRecursionDepth;
+        createInfo->layout = ToBackend(descriptor->layout)->GetHandle();
+        createInfo->basePipelineHandle = VK_NULL_HANDLE;
+        createInfo->basePipelineIndex = 0;
+
+        // the driver may reuse the compiled shaders of the base pipeline, derivatives only
+        // recompile what differs from it
+        if (descriptor->basePipeline != nullptr) {
+            createInfo->flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+            createInfo->basePipelineHandle = ToBackend(descriptor->basePipeline)->GetHandle();
+            createInfo->basePipelineIndex = -1;
+        }
+    }
+
     MaybeError RayTracingPipeline::Initialize(const RayTracingPipelineDescriptor* descriptor) {
         Device* device = ToBackend(GetDevice());
 
+        ShaderGroupStorage shaderGroups;
+        VkRayTracingPipelineCreateInfoNV createInfo;
+        GetCreateInfo(descriptor, &shaderGroups, &createInfo);
+
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateRayTracingPipelinesNV(device->GetVkDevice(),
+                                                  device->GetPipelineCache(), 1, &createInfo,
+                                                  nullptr, &*mHandle),
+            "vkCreateRayTracingPipelinesNV"));
+
+        return InitializeRecords(descriptor);
+    }
+
+    MaybeError RayTracingPipeline::InitializeRecords(
+        const RayTracingPipelineDescriptor* descriptor) {
+        Device* device = ToBackend(GetDevice());
+
         RayTracingShaderBindingTable* shaderBindingTable =
             ToBackend(descriptor->rayTracingState->shaderBindingTable);
 
-        std::vector<VkPipelineShaderStageCreateInfo> stages = shaderBindingTable->GetStages();
-        std::vector<VkRayTracingShaderGroupCreateInfoNV> groups = shaderBindingTable->GetGroups();
-
-        {
-            VkRayTracingPipelineCreateInfoNV createInfo{};
-            createInfo.sType = VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_NV;
-            createInfo.pNext = nullptr;
-            createInfo.flags = 0;
-            createInfo.pStages = stages.data();
-            createInfo.stageCount = stages.size();
-            createInfo.pGroups = groups.data();
-            createInfo.groupCount = groups.size();
-            createInfo.maxRecursionDepth = descriptor->rayTracingState->maxRecursionDepth;
-            createInfo.layout = ToBackend(descriptor->layout)->GetHandle();
-            createInfo.basePipelineHandle = VK_NULL_HANDLE;
-            createInfo.basePipelineIndex = 0;
-
-            MaybeError result = CheckVkSuccess(
-                device->fn.CreateRayTracingPipelinesNV(device->GetVkDevice(), VK_NULL_HANDLE, 1,
-                                                       &createInfo, nullptr, &*mHandle),
-                "vkCreateRayTracingPipelinesNV");
-            if (result.IsError())
-                return result.AcquireError();
-        }
-        
-        {
-            uint64_t bufferSize = groups.size() * shaderBindingTable->GetShaderGroupHandleSize();
-
-            MaybeError result =
-                CheckVkSuccess(device->fn.GetRayTracingShaderGroupHandlesNV(
-                                   device->GetVkDevice(), mHandle, 0, groups.size(), bufferSize,
-                                   shaderBindingTable->GetGroupBufferResource().GetMappedPointer()),
-                               "vkGetRayTracingShaderGroupHandlesNV");
-            if (result.IsError())
-                return result.AcquireError();
+        uint32_t groupCount = shaderBindingTable->GetGroups().size();
+        uint32_t handleSize = shaderBindingTable->GetShaderGroupHandleSize();
+        uint32_t recordDataSize = shaderBindingTable->GetRecordDataSize();
+
+        std::vector<uint8_t> handles(groupCount * handleSize);
+        DAWN_TRY(CheckVkSuccess(device->fn.GetRayTracingShaderGroupHandlesNV(
+                                    device->GetVkDevice(), mHandle, 0, groupCount,
+                                    handles.size(), handles.data()),
+                                "vkGetRayTracingShaderGroupHandlesNV"));
+
+        // every pipeline gets its own records, so that pipelines created from the same table
+        // don't overwrite each other's group handles
+        uint64_t bufferSize = groupCount * shaderBindingTable->GetRecordStride();
+
+        VkBufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.size = bufferSize;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_RAY_TRACING_BIT_NV;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.queueFamilyIndexCount = 0;
+        createInfo.pQueueFamilyIndices = 0;
+
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateBuffer(device->GetVkDevice(), &createInfo, nullptr, &*mRecordBuffer),
+            "vkCreateBuffer"));
+
+        VkMemoryRequirements requirements;
+        device->fn.GetBufferMemoryRequirements(device->GetVkDevice(), mRecordBuffer,
+                                               &requirements);
+
+        // the records are read for every ray hit and miss, keep them in device local memory
+        // and upload them with transfers
+        DAWN_TRY_ASSIGN(mRecordBufferResource, device->AllocateMemory(requirements, false));
+
+        DAWN_TRY(CheckVkSuccess(device->fn.BindBufferMemory(
+                                    device->GetVkDevice(), mRecordBuffer,
+                                    ToBackend(mRecordBufferResource.GetResourceHeap())->GetMemory(),
+                                    mRecordBufferResource.GetOffset()),
+                                "vkBindBufferMemory"));
+
+        // the handles are returned tightly packed, lay them out as records together with the
+        // record data written to the table so far
+        std::vector<uint8_t> records(bufferSize, 0);
+        for (uint32_t ii = 0; ii < groupCount; ++ii) {
+            uint8_t* record = &records[shaderBindingTable->GetRecordOffset(ii)];
+            memcpy(record, &handles[ii * handleSize], handleSize);
+            memcpy(record + handleSize, shaderBindingTable->GetRecordData(ii), recordDataSize);
         }
 
+        VkBufferCopy copy;
+        copy.srcOffset = 0;
+        copy.dstOffset = 0;
+        copy.size = bufferSize;
+
+        DAWN_TRY(CopyToRecordBuffer(records.data(), records.size(), copy));
+
+        shaderBindingTable->AddPipeline(this);
+
+        return {};
+    }
+
+    MaybeError RayTracingPipeline::UploadRecordData(uint32_t groupIndex, uint32_t count) {
+        RayTracingShaderBindingTable* shaderBindingTable =
+            ToBackend(GetShaderBindingTable());
+
+        VkBufferCopy copy;
+        copy.srcOffset = 0;
+        copy.dstOffset = shaderBindingTable->GetRecordOffset(groupIndex) +
+                         shaderBindingTable->GetShaderGroupHandleSize();
+        copy.size = count;
+
+        return CopyToRecordBuffer(shaderBindingTable->GetRecordData(groupIndex), count, copy);
+    }
+
+    MaybeError RayTracingPipeline::CopyToRecordBuffer(const void* data,
+                                                      uint64_t size,
+                                                      const VkBufferCopy& copy) {
+        Device* device = ToBackend(GetDevice());
+
+        // stage the data and copy it over on the GPU timeline, so that rays traced before keep
+        // reading the previous records
+        DynamicUploader* uploader = device->GetDynamicUploader();
+        UploadHandle uploadHandle;
+        DAWN_TRY_ASSIGN(uploadHandle, uploader->Allocate(size, device->GetPendingCommandSerial()));
+        ASSERT(uploadHandle.mappedBuffer != nullptr);
+
+        memcpy(uploadHandle.mappedBuffer, data, size);
+
+        VkBufferCopy stagedCopy = copy;
+        stagedCopy.srcOffset += uploadHandle.startOffset;
+
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+
+        // wait for the rays traced before to be done reading the records
+        device->fn.CmdPipelineBarrier(recordingContext->commandBuffer,
+                                      VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                                      0, nullptr);
+
+        device->fn.CmdCopyBuffer(recordingContext->commandBuffer,
+                                 ToBackend(uploadHandle.stagingBuffer)->GetBufferHandle(),
+                                 mRecordBuffer, 1, &stagedCopy);
+
+        // make the copy visible to the ray tracing shaders reading the shader records
+        VkBufferMemoryBarrier barrier;
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = mRecordBuffer;
+        barrier.offset = stagedCopy.dstOffset;
+        barrier.size = stagedCopy.size;
+
+        device->fn.CmdPipelineBarrier(recordingContext->commandBuffer,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                      VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV, 0, 0, nullptr,
+                                      1, &barrier, 0, nullptr);
+
         return {};
     }
 
     RayTracingPipeline::~RayTracingPipeline() {
+        Device* device = ToBackend(GetDevice());
+
+        ToBackend(GetShaderBindingTable())->RemovePipeline(this);
+
+        if (mRecordBuffer != VK_NULL_HANDLE) {
+            device->DeallocateMemory(&mRecordBufferResource);
+            device->GetFencedDeleter()->DeleteWhenUnused(mRecordBuffer);
+            mRecordBuffer = VK_NULL_HANDLE;
+        }
         if (mHandle != VK_NULL_HANDLE) {
-            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mHandle);
+            device->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
     }
@@ -92,4 +272,8 @@ namespace dawn_native { namespace vulkan {
         return mHandle;
     }
 
+    VkBuffer RayTracingPipeline::GetRecordBufferHandle() const {
+        return mRecordBuffer;
+    }
+
 }}  // namespace dawn_native::vulkan
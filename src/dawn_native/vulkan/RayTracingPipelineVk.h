@@ -24,6 +24,8 @@
 
 #include "dawn_native/vulkan/BufferVk.h"
 
+#include <vector>
+
 namespace dawn_native { namespace vulkan {
 
     class Device;
@@ -33,15 +35,42 @@ namespace dawn_native { namespace vulkan {
         static ResultOrError<RayTracingPipeline*> Create(
             Device* device,
             const RayTracingPipelineDescriptor* descriptor);
+        // Compiles all the pipelines with a single call to vkCreateRayTracingPipelinesNV.
+        static ResultOrError<std::vector<Ref<RayTracingPipelineBase>>> CreateBatch(
+            Device* device,
+            const std::vector<const RayTracingPipelineDescriptor*>& descriptors);
         ~RayTracingPipeline();
 
         VkPipeline GetHandle() const;
 
+        // The shader binding table records of the pipeline, its group handles followed by the
+        // record data of the table.
+        VkBuffer GetRecordBufferHandle() const;
+
+        // Uploads record data written to the shader binding table to the pipeline's records.
+        MaybeError UploadRecordData(uint32_t groupIndex, uint32_t count);
+
       private:
         using RayTracingPipelineBase::RayTracingPipelineBase;
         MaybeError Initialize(const RayTracingPipelineDescriptor* descriptor);
 
+        // Keeps the arrays pointed to by a VkRayTracingPipelineCreateInfoNV alive.
+        struct ShaderGroupStorage {
+            std::vector<VkPipelineShaderStageCreateInfo> stages;
+            std::vector<VkRayTracingShaderGroupCreateInfoNV> groups;
+        };
+        static void GetCreateInfo(const RayTracingPipelineDescriptor* descriptor,
+                                  ShaderGroupStorage* shaderGroups,
+                                  VkRayTracingPipelineCreateInfoNV* createInfo);
+        MaybeError InitializeRecords(const RayTracingPipelineDescriptor* descriptor);
+        MaybeError CopyToRecordBuffer(const void* data,
+                                      uint64_t size,
+                                      const VkBufferCopy& copy);
+
         VkPipeline mHandle = VK_NULL_HANDLE;
+
+        VkBuffer mRecordBuffer = VK_NULL_HANDLE;
+        ResourceMemoryAllocation mRecordBufferResource;
     };
 
 }}  // namespace dawn_native::vulkan
@@ -13,8 +13,8 @@
 // limitations under the License.
 
 #include "dawn_native/vulkan/RayTracingShaderBindingTableVk.h"
-#include "dawn_native/vulkan/FencedDeleter.h"
-#include "dawn_native/vulkan/ResourceHeapVk.h"
+#include "common/Math.h"
+#include "dawn_native/vulkan/RayTracingPipelineVk.h"
 #include "dawn_native/vulkan/ShaderModuleVk.h"
 
 #include "dawn_native/vulkan/AdapterVk.h"
@@ -39,12 +39,7 @@ namespace dawn_native { namespace vulkan {
     }
 
     void RayTracingShaderBindingTable::DestroyImpl() {
-        Device* device = ToBackend(GetDevice());
-        if (mGroupBuffer != VK_NULL_HANDLE) {
-            device->DeallocateMemory(&mGroupBufferResource);
-            device->GetFencedDeleter()->DeleteWhenUnused(mGroupBuffer);
-            mGroupBuffer = VK_NULL_HANDLE;
-        }
+        // the records are owned by the pipelines created from the table
     }
 
     MaybeError RayTracingShaderBindingTable::Initialize(
@@ -83,14 +78,11 @@ namespace dawn_native { namespace vulkan {
             groupInfo.intersectionShader = group.intersectionIndex;
 
             if (group.generalIndex != -1) {
-                // generalIndex can be ray gen and miss
-                MaybeError rayGenErr =
-                    ValidateGroupStageIndex(group.generalIndex, VK_SHADER_STAGE_RAYGEN_BIT_NV);
-                MaybeError rayMissErr =
-                    ValidateGroupStageIndex(group.generalIndex, VK_SHADER_STAGE_MISS_BIT_NV);
-                if (rayGenErr.IsError() && rayMissErr.IsError()) {
-                    return rayGenErr;
-                }
+                // generalIndex can be ray gen, miss and callable
+                DAWN_TRY(ValidateGroupStageIndex(group.generalIndex,
+                                                 VK_SHADER_STAGE_RAYGEN_BIT_NV |
+                                                     VK_SHADER_STAGE_MISS_BIT_NV |
+                                                     VK_SHADER_STAGE_CALLABLE_BIT_NV));
                 groupInfo.generalShader = group.generalIndex;
             } else {
                 groupInfo.generalShader = VK_SHADER_UNUSED_NV;
@@ -120,36 +112,35 @@ namespace dawn_native { namespace vulkan {
             mGroups.push_back(groupInfo);
         };
 
-        uint64_t bufferSize = mGroups.size() * GetShaderGroupHandleSize();
-
-        VkBufferCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.size = bufferSize;
-        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount = 0;
-        createInfo.pQueueFamilyIndices = 0;
+        if (GetRecordStride() > mRayTracingProperties.maxShaderGroupStride) {
+            return DAWN_VALIDATION_ERROR("Record data size exceeds the maximum group stride");
+        }
 
-        DAWN_TRY(CheckVkSuccess(
-            device->fn.CreateBuffer(device->GetVkDevice(), &createInfo, nullptr, &*mGroupBuffer),
-            "vkCreateBuffer"));
+        mRecordData.resize(mGroups.size() * GetRecordDataSize(), 0);
 
-        VkMemoryRequirements requirements;
-        device->fn.GetBufferMemoryRequirements(device->GetVkDevice(), mGroupBuffer, &requirements);
+        return {};
+    }
 
-        DAWN_TRY_ASSIGN(mGroupBufferResource, device->AllocateMemory(requirements, true));
+    MaybeError RayTracingShaderBindingTable::WriteRecordDataImpl(uint32_t groupIndex,
+                                                                 uint32_t count,
+                                                                 const void* data) {
+        memcpy(mRecordData.data() + groupIndex * GetRecordDataSize(), data, count);
 
-        DAWN_TRY(CheckVkSuccess(device->fn.BindBufferMemory(
-                                    device->GetVkDevice(), mGroupBuffer,
-                                    ToBackend(mGroupBufferResource.GetResourceHeap())->GetMemory(),
-                                    mGroupBufferResource.GetOffset()),
-                                "vkBindBufferMemory"));
+        for (RayTracingPipeline* pipeline : mPipelines) {
+            DAWN_TRY(pipeline->UploadRecordData(groupIndex, count));
+        }
 
         return {};
     }
 
+    void RayTracingShaderBindingTable::AddPipeline(RayTracingPipeline* pipeline) {
+        mPipelines.insert(pipeline);
+    }
+
+    void RayTracingShaderBindingTable::RemovePipeline(RayTracingPipeline* pipeline) {
+        mPipelines.erase(pipeline);
+    }
+
     RayTracingShaderBindingTable::~RayTracingShaderBindingTable() {
         DestroyInternal();
     }
@@ -162,26 +153,31 @@ namespace dawn_native { namespace vulkan {
         return mStages;
     }
 
-    VkBuffer RayTracingShaderBindingTable::GetGroupBufferHandle() const {
-        return mGroupBuffer;
-    }
-
-    ResourceMemoryAllocation RayTracingShaderBindingTable::GetGroupBufferResource() const {
-        return mGroupBufferResource;
+    const uint8_t* RayTracingShaderBindingTable::GetRecordData(uint32_t groupIndex) const {
+        return mRecordData.data() + groupIndex * GetRecordDataSize();
     }
 
     uint32_t RayTracingShaderBindingTable::GetShaderGroupHandleSize() const {
         return mRayTracingProperties.shaderGroupHandleSize;
     }
 
+    uint32_t RayTracingShaderBindingTable::GetRecordStride() const {
+        uint32_t handleSize = GetShaderGroupHandleSize();
+        return Align(handleSize + GetRecordDataSize(), handleSize);
+    }
+
+    uint64_t RayTracingShaderBindingTable::GetRecordOffset(uint32_t groupIndex) const {
+        return static_cast<uint64_t>(groupIndex) * GetRecordStride();
+    }
+
     MaybeError RayTracingShaderBindingTable::ValidateGroupStageIndex(
         int32_t index,
-        VkShaderStageFlagBits validStage) const {
+        VkShaderStageFlags validStages) const {
         if (index < 0 || index >= (int32_t)mStages.size()) {
             return DAWN_VALIDATION_ERROR("Group index out of range");
         }
         VkShaderStageFlagBits stage = mStages[index].stage;
-        if (stage != validStage) {
+        if ((stage & validStages) == 0) {
             std::string msg = "Invalid stage for group index '" + std::to_string(index) + "'";
             return DAWN_VALIDATION_ERROR(msg);
         }
@@ -17,13 +17,14 @@
 
 #include "common/vulkan_platform.h"
 #include "dawn_native/RayTracingShaderBindingTable.h"
-#include "dawn_native/ResourceMemoryAllocation.h"
 
+#include <set>
 #include <vector>
 
 namespace dawn_native { namespace vulkan {
 
     class Device;
+    class RayTracingPipeline;
 
     class RayTracingShaderBindingTable : public RayTracingShaderBindingTableBase {
       public:
@@ -33,26 +34,39 @@ namespace dawn_native { namespace vulkan {
         std::vector<VkPipelineShaderStageCreateInfo>& GetStages();
         std::vector<VkRayTracingShaderGroupCreateInfoNV>& GetGroups();
 
-        VkBuffer GetGroupBufferHandle() const;
-        ResourceMemoryAllocation GetGroupBufferResource() const;
+        // The record data last written for a group, uploaded to the records of every pipeline
+        // created from the table.
+        const uint8_t* GetRecordData(uint32_t groupIndex) const;
+
+        // Pipelines own the records holding their group handles, they register themselves so
+        // that record data writes reach all of them.
+        void AddPipeline(RayTracingPipeline* pipeline);
+        void RemovePipeline(RayTracingPipeline* pipeline);
 
         uint32_t GetShaderGroupHandleSize() const;
 
+        // The distance between two records of a pipeline, the group handle plus the
+        // record data rounded up to the handle alignment.
+        uint32_t GetRecordStride() const;
+        uint64_t GetRecordOffset(uint32_t groupIndex) const;
+
       private:
         using RayTracingShaderBindingTableBase::RayTracingShaderBindingTableBase;
 
         void DestroyImpl() override;
+        MaybeError WriteRecordDataImpl(uint32_t groupIndex,
+                                       uint32_t count,
+                                       const void* data) override;
 
         std::vector<VkPipelineShaderStageCreateInfo> mStages;
         std::vector<VkRayTracingShaderGroupCreateInfoNV> mGroups;
 
         VkPhysicalDeviceRayTracingPropertiesNV mRayTracingProperties;
 
-        // group handle buffer
-        VkBuffer mGroupBuffer = VK_NULL_HANDLE;
-        ResourceMemoryAllocation mGroupBufferResource;
+        std::vector<uint8_t> mRecordData;
+        std::set<RayTracingPipeline*> mPipelines;
 
-        MaybeError ValidateGroupStageIndex(int32_t index, VkShaderStageFlagBits validStage) const;
+        MaybeError ValidateGroupStageIndex(int32_t index, VkShaderStageFlags validStages) const;
 
         MaybeError Initialize(const RayTracingShaderBindingTableDescriptor* descriptor);
     };
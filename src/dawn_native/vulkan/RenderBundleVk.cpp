@@ -0,0 +1,108 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/RenderBundleVk.h"
+
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+namespace dawn_native { namespace vulkan {
+
+    bool RenderPassDynamicState::operator==(const RenderPassDynamicState& other) const {
+        return IsSameViewport(viewport, other.viewport) && IsSameScissor(scissor, other.scissor) &&
+               blendConstants == other.blendConstants &&
+               stencilReference == other.stencilReference;
+    }
+
+    bool IsSameViewport(const VkViewport& a, const VkViewport& b) {
+        return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height &&
+               a.minDepth == b.minDepth && a.maxDepth == b.maxDepth;
+    }
+
+    bool IsSameScissor(const VkRect2D& a, const VkRect2D& b) {
+        return a.offset.x == b.offset.x && a.offset.y == b.offset.y &&
+               a.extent.width == b.extent.width && a.extent.height == b.extent.height;
+    }
+
+    RenderBundle::RenderBundle(RenderBundleEncoder* encoder,
+                               const RenderBundleDescriptor* descriptor,
+                               AttachmentState* attachmentState,
+                               PassResourceUsage resourceUsage)
+        : RenderBundleBase(encoder, descriptor, attachmentState, std::move(resourceUsage)) {
+    }
+
+    RenderBundle::~RenderBundle() {
+        // Destroying the pool frees the recordings, which may still be executed by pending
+        // command buffers.
+        if (mPool != VK_NULL_HANDLE) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mPool);
+            mPool = VK_NULL_HANDLE;
+        }
+    }
+
+    VkCommandBuffer RenderBundle::GetRecording(VkRenderPass renderPass,
+                                               const RenderPassDynamicState& dynamicState) const {
+        for (const Recording& recording : mRecordings) {
+            if (recording.renderPass == renderPass && recording.dynamicState == dynamicState) {
+                return recording.commands;
+            }
+        }
+        return VK_NULL_HANDLE;
+    }
+
+    ResultOrError<VkCommandBuffer> RenderBundle::BeginRecording(
+        VkRenderPass renderPass,
+        const RenderPassDynamicState& dynamicState) {
+        if (mRecordings.size() == kMaxRecordings) {
+            return VkCommandBuffer(VK_NULL_HANDLE);
+        }
+
+        Device* device = ToBackend(GetDevice());
+        VkDevice vkDevice = device->GetVkDevice();
+
+        if (mPool == VK_NULL_HANDLE) {
+            VkCommandPoolCreateInfo createInfo;
+            createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            createInfo.pNext = nullptr;
+            createInfo.flags = 0;
+            createInfo.queueFamilyIndex = device->GetGraphicsQueueFamily();
+
+            DAWN_TRY(CheckVkSuccess(
+                device->fn.CreateCommandPool(vkDevice, &createInfo, nullptr, &*mPool),
+                "vkCreateCommandPool"));
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.commandPool = mPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commands = VK_NULL_HANDLE;
+        DAWN_TRY(
+            CheckVkSuccess(device->fn.AllocateCommandBuffers(vkDevice, &allocateInfo, &commands),
+                           "vkAllocateCommandBuffers"));
+
+        // The same recording can be executed by several pending command buffers, or several
+        // times by the same one.
+        DAWN_TRY(device->BeginSecondaryInRenderPass(
+            commands, renderPass, VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT));
+
+        mRecordings.push_back({renderPass, dynamicState, commands});
+        return commands;
+    }
+
+}}  // namespace dawn_native::vulkan
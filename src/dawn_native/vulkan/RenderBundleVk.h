@@ -0,0 +1,81 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_RENDERBUNDLEVK_H_
+#define DAWNNATIVE_VULKAN_RENDERBUNDLEVK_H_
+
+#include "dawn_native/RenderBundle.h"
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+
+#include <array>
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // The dynamic state of a render pass. Secondary command buffers don't inherit it from the
+    // render pass executing them, so it is set again at the start of each of them.
+    struct RenderPassDynamicState {
+        VkViewport viewport;
+        VkRect2D scissor;
+        std::array<float, 4> blendConstants;
+        uint32_t stencilReference;
+
+        bool operator==(const RenderPassDynamicState& other) const;
+    };
+
+    bool IsSameViewport(const VkViewport& a, const VkViewport& b);
+    bool IsSameScissor(const VkRect2D& a, const VkRect2D& b);
+
+    // Render bundles are recorded in secondary command buffers the first time they are executed
+    // with a render pass and dynamic state, and the command buffer is executed directly the next
+    // times. The recorded command buffers live as long as the bundle.
+    class RenderBundle : public RenderBundleBase {
+      public:
+        // Past this number of recordings, the bundle is encoded in the render pass directly.
+        static constexpr size_t kMaxRecordings = 4;
+
+        RenderBundle(RenderBundleEncoder* encoder,
+                     const RenderBundleDescriptor* descriptor,
+                     AttachmentState* attachmentState,
+                     PassResourceUsage resourceUsage);
+        ~RenderBundle() override;
+
+        // Both must be called with the device's render bundle replay mutex held, because the
+        // render passes executing the bundle can be recorded on several threads.
+        // Returns VK_NULL_HANDLE if the bundle wasn't recorded for this render pass and state.
+        VkCommandBuffer GetRecording(VkRenderPass renderPass,
+                                     const RenderPassDynamicState& dynamicState) const;
+        // Returns a begun secondary command buffer in which to record the bundle, or
+        // VK_NULL_HANDLE if the bundle already has kMaxRecordings recordings.
+        ResultOrError<VkCommandBuffer> BeginRecording(VkRenderPass renderPass,
+                                                      const RenderPassDynamicState& dynamicState);
+
+      private:
+        struct Recording {
+            VkRenderPass renderPass;
+            RenderPassDynamicState dynamicState;
+            VkCommandBuffer commands;
+        };
+
+        VkCommandPool mPool = VK_NULL_HANDLE;
+        std::vector<Recording> mRecordings;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_RENDERBUNDLEVK_H_
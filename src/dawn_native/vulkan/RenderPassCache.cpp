@@ -16,6 +16,8 @@
 
 #include "common/BitSetIterator.h"
 #include "common/HashUtils.h"
+#include "common/Math.h"
+#include "dawn_native/AttachmentState.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/TextureVk.h"
 #include "dawn_native/vulkan/VulkanError.h"
@@ -33,6 +35,22 @@ namespace dawn_native { namespace vulkan {
                     UNREACHABLE();
             }
         }
+
+        // With StoreOp::Clear the attachment is lazily cleared before its next use, so tilers
+        // don't need to write it back to memory.
+        VkAttachmentStoreOp VulkanAttachmentStoreOp(wgpu::StoreOp op) {
+            switch (op) {
+                case wgpu::StoreOp::Store:
+                    return VK_ATTACHMENT_STORE_OP_STORE;
+                case wgpu::StoreOp::Clear:
+                    return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                default:
+                    UNREACHABLE();
+            }
+        }
+        // Large enough for the render passes of most applications, at half occupancy.
+        constexpr size_t kInitialTableCapacity = 64;
+
     }  // anonymous namespace
 
     // RenderPassCacheQuery
@@ -40,50 +58,136 @@ namespace dawn_native { namespace vulkan {
     void RenderPassCacheQuery::SetColor(uint32_t index,
                                         wgpu::TextureFormat format,
                                         wgpu::LoadOp loadOp,
-                                        bool hasResolveTarget) {
+                                        bool hasResolveTarget,
+                                        wgpu::StoreOp storeOp) {
         colorMask.set(index);
         colorFormats[index] = format;
         colorLoadOp[index] = loadOp;
+        colorStoreOp[index] = storeOp;
         resolveTargetMask[index] = hasResolveTarget;
+        HashCombine(&hash, index, loadOp, storeOp, hasResolveTarget);
     }
 
     void RenderPassCacheQuery::SetDepthStencil(wgpu::TextureFormat format,
                                                wgpu::LoadOp depthLoadOp,
-                                               wgpu::LoadOp stencilLoadOp) {
+                                               wgpu::LoadOp stencilLoadOp,
+                                               wgpu::StoreOp storeOp) {
         hasDepthStencil = true;
         depthStencilFormat = format;
         this->depthLoadOp = depthLoadOp;
         this->stencilLoadOp = stencilLoadOp;
+        depthStencilStoreOp = storeOp;
+        HashCombine(&hash, depthLoadOp, stencilLoadOp, storeOp);
     }
 
-    void RenderPassCacheQuery::SetSampleCount(uint32_t sampleCount) {
-        this->sampleCount = sampleCount;
+    void RenderPassCacheQuery::SetAttachmentState(const AttachmentState* attachmentState) {
+        sampleCount = attachmentState->GetSampleCount();
+        HashCombine(&hash, attachmentState->GetContentHash());
     }
 
     // RenderPassCache
 
+    RenderPassCache::Table::Table(size_t capacity)
+        : mask(capacity - 1), slots(std::make_unique<Slot[]>(capacity)) {
+        ASSERT(IsPowerOfTwo(capacity));
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].hash.store(0, std::memory_order_relaxed);
+        }
+    }
+
     RenderPassCache::RenderPassCache(Device* device) : mDevice(device) {
+        mTables.push_back(std::make_unique<Table>(kInitialTableCapacity));
+        mTable.store(mTables.back().get(), std::memory_order_release);
     }
 
     RenderPassCache::~RenderPassCache() {
-        for (auto it : mCache) {
-            mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), it.second, nullptr);
+        const Table* table = mTable.load(std::memory_order_acquire);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            if (table->slots[i].hash.load(std::memory_order_relaxed) != 0) {
+                mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), table->slots[i].renderPass,
+                                              nullptr);
+            }
         }
-        mCache.clear();
+        mTables.clear();
     }
 
     ResultOrError<VkRenderPass> RenderPassCache::GetRenderPass(const RenderPassCacheQuery& query) {
-        auto it = mCache.find(query);
-        if (it != mCache.end()) {
-            return VkRenderPass(it->second);
+        size_t hash = GetSlotHash(query);
+        if (const Slot* slot = Find(mTable.load(std::memory_order_acquire), query, hash)) {
+            return VkRenderPass(slot->renderPass);
+        }
+
+        // Another thread can have added the render pass since the lookup.
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (const Slot* slot = Find(mTable.load(std::memory_order_relaxed), query, hash)) {
+            return VkRenderPass(slot->renderPass);
         }
 
         VkRenderPass renderPass;
         DAWN_TRY_ASSIGN(renderPass, CreateRenderPassForQuery(query));
-        mCache.emplace(query, renderPass);
+        Insert(query, hash, renderPass);
         return renderPass;
     }
 
+    // static
+    size_t RenderPassCache::GetSlotHash(const RenderPassCacheQuery& query) {
+        return query.hash == 0 ? 1 : query.hash;
+    }
+
+    // static
+    const RenderPassCache::Slot* RenderPassCache::Find(const Table* table,
+                                                       const RenderPassCacheQuery& query,
+                                                       size_t hash) {
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            const Slot& slot = table->slots[i];
+            size_t slotHash = slot.hash.load(std::memory_order_acquire);
+            if (slotHash == 0) {
+                return nullptr;
+            }
+            if (slotHash == hash && QueriesAreEqual(slot.query, query)) {
+                return &slot;
+            }
+        }
+    }
+
+    void RenderPassCache::Insert(const RenderPassCacheQuery& query,
+                                 size_t hash,
+                                 VkRenderPass renderPass) {
+        auto InsertInTable = [](Table* table, const RenderPassCacheQuery& query, size_t hash,
+                                VkRenderPass renderPass) {
+            size_t i = hash & table->mask;
+            while (table->slots[i].hash.load(std::memory_order_relaxed) != 0) {
+                i = (i + 1) & table->mask;
+            }
+            table->slots[i].query = query;
+            table->slots[i].renderPass = renderPass;
+            table->slots[i].hash.store(hash, std::memory_order_release);
+            table->count++;
+        };
+
+        Table* table = mTable.load(std::memory_order_relaxed);
+
+        // Keep the table at most half full so that the probe sequences stay short, the new table
+        // is only published once it contains all the render passes.
+        if ((table->count + 1) * 2 > table->mask + 1) {
+            std::unique_ptr<Table> grownTable = std::make_unique<Table>((table->mask + 1) * 2);
+            for (size_t i = 0; i <= table->mask; ++i) {
+                const Slot& slot = table->slots[i];
+                size_t slotHash = slot.hash.load(std::memory_order_relaxed);
+                if (slotHash != 0) {
+                    InsertInTable(grownTable.get(), slot.query, slotHash, slot.renderPass);
+                }
+            }
+            InsertInTable(grownTable.get(), query, hash, renderPass);
+
+            mTables.push_back(std::move(grownTable));
+            mTable.store(mTables.back().get(), std::memory_order_release);
+            return;
+        }
+
+        InsertInTable(table, query, hash, renderPass);
+    }
+
     ResultOrError<VkRenderPass> RenderPassCache::CreateRenderPassForQuery(
         const RenderPassCacheQuery& query) const {
         // The Vulkan subpasses want to know the layout of the attachments with VkAttachmentRef.
@@ -111,7 +215,7 @@ namespace dawn_native { namespace vulkan {
             attachmentDesc.format = VulkanImageFormat(mDevice, query.colorFormats[i]);
             attachmentDesc.samples = vkSampleCount;
             attachmentDesc.loadOp = VulkanAttachmentLoadOp(query.colorLoadOp[i]);
-            attachmentDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachmentDesc.storeOp = VulkanAttachmentStoreOp(query.colorStoreOp[i]);
             attachmentDesc.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             attachmentDesc.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
@@ -132,9 +236,9 @@ namespace dawn_native { namespace vulkan {
             attachmentDesc.format = VulkanImageFormat(mDevice, query.depthStencilFormat);
             attachmentDesc.samples = vkSampleCount;
             attachmentDesc.loadOp = VulkanAttachmentLoadOp(query.depthLoadOp);
-            attachmentDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachmentDesc.storeOp = VulkanAttachmentStoreOp(query.depthStencilStoreOp);
             attachmentDesc.stencilLoadOp = VulkanAttachmentLoadOp(query.stencilLoadOp);
-            attachmentDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachmentDesc.stencilStoreOp = VulkanAttachmentStoreOp(query.depthStencilStoreOp);
             attachmentDesc.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             attachmentDesc.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
@@ -197,29 +301,9 @@ namespace dawn_native { namespace vulkan {
         return renderPass;
     }
 
-    // RenderPassCache
-
-    size_t RenderPassCache::CacheFuncs::operator()(const RenderPassCacheQuery& query) const {
-        size_t hash = Hash(query.colorMask);
-
-        HashCombine(&hash, Hash(query.resolveTargetMask));
-
-        for (uint32_t i : IterateBitSet(query.colorMask)) {
-            HashCombine(&hash, query.colorFormats[i], query.colorLoadOp[i]);
-        }
-
-        HashCombine(&hash, query.hasDepthStencil);
-        if (query.hasDepthStencil) {
-            HashCombine(&hash, query.depthStencilFormat, query.depthLoadOp, query.stencilLoadOp);
-        }
-
-        HashCombine(&hash, query.sampleCount);
-
-        return hash;
-    }
-
-    bool RenderPassCache::CacheFuncs::operator()(const RenderPassCacheQuery& a,
-                                                 const RenderPassCacheQuery& b) const {
+    // static
+    bool RenderPassCache::QueriesAreEqual(const RenderPassCacheQuery& a,
+                                          const RenderPassCacheQuery& b) {
         if (a.colorMask != b.colorMask) {
             return false;
         }
@@ -234,7 +318,8 @@ namespace dawn_native { namespace vulkan {
 
         for (uint32_t i : IterateBitSet(a.colorMask)) {
             if ((a.colorFormats[i] != b.colorFormats[i]) ||
-                (a.colorLoadOp[i] != b.colorLoadOp[i])) {
+                (a.colorLoadOp[i] != b.colorLoadOp[i]) ||
+                (a.colorStoreOp[i] != b.colorStoreOp[i])) {
                 return false;
             }
         }
@@ -245,7 +330,8 @@ namespace dawn_native { namespace vulkan {
 
         if (a.hasDepthStencil) {
             if ((a.depthStencilFormat != b.depthStencilFormat) ||
-                (a.depthLoadOp != b.depthLoadOp) || (a.stencilLoadOp != b.stencilLoadOp)) {
+                (a.depthLoadOp != b.depthLoadOp) || (a.stencilLoadOp != b.stencilLoadOp) ||
+                (a.depthStencilStoreOp != b.depthStencilStoreOp)) {
                 return false;
             }
         }
@@ -21,8 +21,15 @@
 #include "dawn_native/dawn_platform.h"
 
 #include <array>
+#include <atomic>
 #include <bitset>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dawn_native {
+    class AttachmentState;
+}  // namespace dawn_native
 
 namespace dawn_native { namespace vulkan {
 
@@ -34,26 +41,36 @@ namespace dawn_native { namespace vulkan {
     struct RenderPassCacheQuery {
         // Use these helpers to build the query, they make sure all relevant data is initialized and
         // masks set.
+        // The store ops don't matter for the render pass compatibility with pipelines.
         void SetColor(uint32_t index,
                       wgpu::TextureFormat format,
                       wgpu::LoadOp loadOp,
-                      bool hasResolveTarget);
+                      bool hasResolveTarget,
+                      wgpu::StoreOp storeOp = wgpu::StoreOp::Store);
         void SetDepthStencil(wgpu::TextureFormat format,
                              wgpu::LoadOp depthLoadOp,
-                             wgpu::LoadOp stencilLoadOp);
-        void SetSampleCount(uint32_t sampleCount);
+                             wgpu::LoadOp stencilLoadOp,
+                             wgpu::StoreOp storeOp = wgpu::StoreOp::Store);
+        // Sets the sample count and hashes the formats with the content hash of the attachment
+        // state the query was built from. Called last, after the attachments are set.
+        void SetAttachmentState(const AttachmentState* attachmentState);
 
         std::bitset<kMaxColorAttachments> colorMask;
         std::bitset<kMaxColorAttachments> resolveTargetMask;
         std::array<wgpu::TextureFormat, kMaxColorAttachments> colorFormats;
         std::array<wgpu::LoadOp, kMaxColorAttachments> colorLoadOp;
+        std::array<wgpu::StoreOp, kMaxColorAttachments> colorStoreOp;
 
         bool hasDepthStencil = false;
         wgpu::TextureFormat depthStencilFormat;
         wgpu::LoadOp depthLoadOp;
         wgpu::LoadOp stencilLoadOp;
+        wgpu::StoreOp depthStencilStoreOp;
 
         uint32_t sampleCount;
+
+        // Computed while the query is built, so that looking it up doesn't hash all of it.
+        size_t hash = 0;
     };
 
     // Caches VkRenderPasses so that we don't create duplicate ones for every RenderPipeline or
@@ -66,6 +83,7 @@ namespace dawn_native { namespace vulkan {
         RenderPassCache(Device* device);
         ~RenderPassCache();
 
+        // Can be called from several threads at once when render passes are recorded in parallel.
         ResultOrError<VkRenderPass> GetRenderPass(const RenderPassCacheQuery& query);
 
       private:
@@ -73,17 +91,38 @@ namespace dawn_native { namespace vulkan {
         ResultOrError<VkRenderPass> CreateRenderPassForQuery(
             const RenderPassCacheQuery& query) const;
 
-        // Implements the functors necessary for to use RenderPassCacheQueries as unordered_map
-        // keys.
-        struct CacheFuncs {
-            size_t operator()(const RenderPassCacheQuery& query) const;
-            bool operator()(const RenderPassCacheQuery& a, const RenderPassCacheQuery& b) const;
+        static bool QueriesAreEqual(const RenderPassCacheQuery& a, const RenderPassCacheQuery& b);
+
+        // An open addressing hash table that is read without the lock. Slots are only written
+        // once, with the lock held, and are published by storing their hash last. A table that
+        // grows is replaced by a larger one and kept until the cache is destroyed, since threads
+        // may still be reading it.
+        struct Slot {
+            std::atomic<size_t> hash;
+            RenderPassCacheQuery query;
+            VkRenderPass renderPass;
         };
-        using Cache =
-            std::unordered_map<RenderPassCacheQuery, VkRenderPass, CacheFuncs, CacheFuncs>;
+        struct Table {
+            Table(size_t capacity);
+
+            size_t mask;
+            size_t count = 0;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        // The hash of empty slots is 0 so the hashes of queries are never 0.
+        static size_t GetSlotHash(const RenderPassCacheQuery& query);
+        static const Slot* Find(const Table* table,
+                                const RenderPassCacheQuery& query,
+                                size_t hash);
+        // Must be called with the lock held.
+        void Insert(const RenderPassCacheQuery& query, size_t hash, VkRenderPass renderPass);
 
         Device* mDevice = nullptr;
-        Cache mCache;
+        std::mutex mMutex;
+        std::atomic<Table*> mTable;
+        // All the tables, the last one is mTable.
+        std::vector<std::unique_ptr<Table>> mTables;
     };
 
 }}  // namespace dawn_native::vulkan
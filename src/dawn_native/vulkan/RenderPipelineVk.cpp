@@ -321,6 +321,14 @@ namespace dawn_native { namespace vulkan {
             return depthStencilState;
         }
 
+        // Tag all state as dynamic but stencil masks.
+        constexpr VkDynamicState kDynamicStates[] = {
+            VK_DYNAMIC_STATE_VIEWPORT,          VK_DYNAMIC_STATE_SCISSOR,
+            VK_DYNAMIC_STATE_LINE_WIDTH,        VK_DYNAMIC_STATE_DEPTH_BIAS,
+            VK_DYNAMIC_STATE_BLEND_CONSTANTS,   VK_DYNAMIC_STATE_DEPTH_BOUNDS,
+            VK_DYNAMIC_STATE_STENCIL_REFERENCE,
+        };
+
     }  // anonymous namespace
 
     // static
@@ -333,10 +341,52 @@ namespace dawn_native { namespace vulkan {
         return pipeline.release();
     }
 
+    // static
+    ResultOrError<std::vector<Ref<RenderPipelineBase>>> RenderPipeline::CreateBatch(
+        Device* device,
+        const std::vector<const RenderPipelineDescriptor*>& descriptors) {
+        std::vector<Ref<RenderPipelineBase>> pipelines;
+        std::vector<CreateInfoStorage> storages(descriptors.size());
+        std::vector<VkGraphicsPipelineCreateInfo> createInfos(descriptors.size());
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            pipelines.push_back(AcquireRef(new RenderPipeline(device, descriptors[i])));
+            DAWN_TRY(ToBackend(pipelines[i].Get())
+                         ->ComputeCreateInfo(descriptors[i], &storages[i], &createInfos[i]));
+        }
+
+        // All the pipelines are compiled by a single call, which lets the driver parallelize it.
+        std::vector<VkPipeline> handles(descriptors.size());
+        DAWN_TRY(CheckVkSuccess(
+            device->fn.CreateGraphicsPipelines(device->GetVkDevice(), device->GetPipelineCache(),
+                                               createInfos.size(), createInfos.data(), nullptr,
+                                               AsVkArray(handles.data())),
+            "CreateGraphicsPipelines"));
+
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            ToBackend(pipelines[i].Get())->mHandle = handles[i];
+        }
+        return std::move(pipelines);
+    }
+
     MaybeError RenderPipeline::Initialize(const RenderPipelineDescriptor* descriptor) {
         Device* device = ToBackend(GetDevice());
 
-        VkPipelineShaderStageCreateInfo shaderStages[2];
+        CreateInfoStorage storage;
+        VkGraphicsPipelineCreateInfo createInfo;
+        DAWN_TRY(ComputeCreateInfo(descriptor, &storage, &createInfo));
+
+        return CheckVkSuccess(
+            device->fn.CreateGraphicsPipelines(device->GetVkDevice(), device->GetPipelineCache(), 1,
+                                               &createInfo, nullptr, &*mHandle),
+            "CreateGraphicsPipeline");
+    }
+
+    MaybeError RenderPipeline::ComputeCreateInfo(const RenderPipelineDescriptor* descriptor,
+                                                 CreateInfoStorage* storage,
+                                                 VkGraphicsPipelineCreateInfo* createInfo) {
+        Device* device = ToBackend(GetDevice());
+
+        VkPipelineShaderStageCreateInfo* shaderStages = storage->shaderStages.data();
         {
             shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
             shaderStages[0].pNext = nullptr;
@@ -355,11 +405,10 @@ namespace dawn_native { namespace vulkan {
             shaderStages[1].pName = descriptor->fragmentStage->entryPoint;
         }
 
-        PipelineVertexInputStateCreateInfoTemporaryAllocations tempAllocations;
-        VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo =
-            ComputeVertexInputDesc(&tempAllocations);
+        VkPipelineVertexInputStateCreateInfo& vertexInputCreateInfo = storage->vertexInput;
+        vertexInputCreateInfo = ComputeVertexInputDesc(&storage->vertexInputAllocations);
 
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+        VkPipelineInputAssemblyStateCreateInfo& inputAssembly = storage->inputAssembly;
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         inputAssembly.pNext = nullptr;
         inputAssembly.flags = 0;
@@ -368,19 +417,19 @@ namespace dawn_native { namespace vulkan {
 
         // A dummy viewport/scissor info. The validation layers force use to provide at least one
         // scissor and one viewport here, even if we choose to make them dynamic.
-        VkViewport viewportDesc;
+        VkViewport& viewportDesc = storage->viewportDesc;
         viewportDesc.x = 0.0f;
         viewportDesc.y = 0.0f;
         viewportDesc.width = 1.0f;
         viewportDesc.height = 1.0f;
         viewportDesc.minDepth = 0.0f;
         viewportDesc.maxDepth = 1.0f;
-        VkRect2D scissorRect;
+        VkRect2D& scissorRect = storage->scissorRect;
         scissorRect.offset.x = 0;
         scissorRect.offset.y = 0;
         scissorRect.extent.width = 1;
         scissorRect.extent.height = 1;
-        VkPipelineViewportStateCreateInfo viewport;
+        VkPipelineViewportStateCreateInfo& viewport = storage->viewport;
         viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewport.pNext = nullptr;
         viewport.flags = 0;
@@ -389,7 +438,7 @@ namespace dawn_native { namespace vulkan {
         viewport.scissorCount = 1;
         viewport.pScissors = &scissorRect;
 
-        VkPipelineRasterizationStateCreateInfo rasterization;
+        VkPipelineRasterizationStateCreateInfo& rasterization = storage->rasterization;
         rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
         rasterization.pNext = nullptr;
         rasterization.flags = 0;
@@ -404,7 +453,7 @@ namespace dawn_native { namespace vulkan {
         rasterization.depthBiasSlopeFactor = 0.0f;
         rasterization.lineWidth = 1.0f;
 
-        VkPipelineMultisampleStateCreateInfo multisample;
+        VkPipelineMultisampleStateCreateInfo& multisample = storage->multisample;
         multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisample.pNext = nullptr;
         multisample.flags = 0;
@@ -415,12 +464,13 @@ namespace dawn_native { namespace vulkan {
         multisample.alphaToCoverageEnable = VK_FALSE;
         multisample.alphaToOneEnable = VK_FALSE;
 
-        VkPipelineDepthStencilStateCreateInfo depthStencilState =
-            ComputeDepthStencilDesc(GetDepthStencilStateDescriptor());
+        VkPipelineDepthStencilStateCreateInfo& depthStencilState = storage->depthStencil;
+        depthStencilState = ComputeDepthStencilDesc(GetDepthStencilStateDescriptor());
 
         // Initialize the "blend state info" that will be chained in the "create info" from the data
         // pre-computed in the ColorState
-        std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments> colorBlendAttachments;
+        std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments>&
+            colorBlendAttachments = storage->colorBlendAttachments;
         const ShaderModuleBase::FragmentOutputBaseTypes& fragmentOutputBaseTypes =
             descriptor->fragmentStage->module->GetFragmentOutputBaseTypes();
         for (uint32_t i : IterateBitSet(GetColorAttachmentsMask())) {
@@ -429,7 +479,7 @@ namespace dawn_native { namespace vulkan {
             colorBlendAttachments[i] =
                 ComputeColorDesc(colorStateDescriptor, isDeclaredInFragmentShader);
         }
-        VkPipelineColorBlendStateCreateInfo colorBlend;
+        VkPipelineColorBlendStateCreateInfo& colorBlend = storage->colorBlend;
         colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlend.pNext = nullptr;
         colorBlend.flags = 0;
@@ -445,19 +495,12 @@ namespace dawn_native { namespace vulkan {
         colorBlend.blendConstants[2] = 0.0f;
         colorBlend.blendConstants[3] = 0.0f;
 
-        // Tag all state as dynamic but stencil masks.
-        VkDynamicState dynamicStates[] = {
-            VK_DYNAMIC_STATE_VIEWPORT,          VK_DYNAMIC_STATE_SCISSOR,
-            VK_DYNAMIC_STATE_LINE_WIDTH,        VK_DYNAMIC_STATE_DEPTH_BIAS,
-            VK_DYNAMIC_STATE_BLEND_CONSTANTS,   VK_DYNAMIC_STATE_DEPTH_BOUNDS,
-            VK_DYNAMIC_STATE_STENCIL_REFERENCE,
-        };
-        VkPipelineDynamicStateCreateInfo dynamic;
+        VkPipelineDynamicStateCreateInfo& dynamic = storage->dynamic;
         dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
         dynamic.pNext = nullptr;
         dynamic.flags = 0;
-        dynamic.dynamicStateCount = sizeof(dynamicStates) / sizeof(dynamicStates[0]);
-        dynamic.pDynamicStates = dynamicStates;
+        dynamic.dynamicStateCount = sizeof(kDynamicStates) / sizeof(kDynamicStates[0]);
+        dynamic.pDynamicStates = kDynamicStates;
 
         // Get a VkRenderPass that matches the attachment formats for this pipeline, load ops don't
         // matter so set them all to LoadOp::Load
@@ -474,38 +517,34 @@ namespace dawn_native { namespace vulkan {
                                       wgpu::LoadOp::Load);
             }
 
-            query.SetSampleCount(GetSampleCount());
+            query.SetAttachmentState(GetAttachmentState());
 
             DAWN_TRY_ASSIGN(renderPass, device->GetRenderPassCache()->GetRenderPass(query));
         }
 
-        // The create info chains in a bunch of things created on the stack here or inside state
+        // The create info chains in a bunch of things created in the storage or inside state
         // objects.
-        VkGraphicsPipelineCreateInfo createInfo;
-        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.stageCount = 2;
-        createInfo.pStages = shaderStages;
-        createInfo.pVertexInputState = &vertexInputCreateInfo;
-        createInfo.pInputAssemblyState = &inputAssembly;
-        createInfo.pTessellationState = nullptr;
-        createInfo.pViewportState = &viewport;
-        createInfo.pRasterizationState = &rasterization;
-        createInfo.pMultisampleState = &multisample;
-        createInfo.pDepthStencilState = &depthStencilState;
-        createInfo.pColorBlendState = &colorBlend;
-        createInfo.pDynamicState = &dynamic;
-        createInfo.layout = ToBackend(GetLayout())->GetHandle();
-        createInfo.renderPass = renderPass;
-        createInfo.subpass = 0;
-        createInfo.basePipelineHandle = VkPipeline{};
-        createInfo.basePipelineIndex = -1;
-
-        return CheckVkSuccess(
-            device->fn.CreateGraphicsPipelines(device->GetVkDevice(), VkPipelineCache{}, 1,
-                                               &createInfo, nullptr, &*mHandle),
-            "CreateGraphicsPipeline");
+        createInfo->sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo->pNext = nullptr;
+        createInfo->flags = 0;
+        createInfo->stageCount = 2;
+        createInfo->pStages = shaderStages;
+        createInfo->pVertexInputState = &vertexInputCreateInfo;
+        createInfo->pInputAssemblyState = &inputAssembly;
+        createInfo->pTessellationState = nullptr;
+        createInfo->pViewportState = &viewport;
+        createInfo->pRasterizationState = &rasterization;
+        createInfo->pMultisampleState = &multisample;
+        createInfo->pDepthStencilState = &depthStencilState;
+        createInfo->pColorBlendState = &colorBlend;
+        createInfo->pDynamicState = &dynamic;
+        createInfo->layout = ToBackend(GetLayout())->GetHandle();
+        createInfo->renderPass = renderPass;
+        createInfo->subpass = 0;
+        createInfo->basePipelineHandle = VkPipeline{};
+        createInfo->basePipelineIndex = -1;
+
+        return {};
     }
 
     VkPipelineVertexInputStateCreateInfo RenderPipeline::ComputeVertexInputDesc(
@@ -20,6 +20,8 @@
 #include "common/vulkan_platform.h"
 #include "dawn_native/Error.h"
 
+#include <vector>
+
 namespace dawn_native { namespace vulkan {
 
     class Device;
@@ -28,6 +30,10 @@ namespace dawn_native { namespace vulkan {
       public:
         static ResultOrError<RenderPipeline*> Create(Device* device,
                                                      const RenderPipelineDescriptor* descriptor);
+        // Creates the pipelines of all the descriptors with a single vkCreateGraphicsPipelines.
+        static ResultOrError<std::vector<Ref<RenderPipelineBase>>> CreateBatch(
+            Device* device,
+            const std::vector<const RenderPipelineDescriptor*>& descriptors);
         ~RenderPipeline();
 
         VkPipeline GetHandle() const;
@@ -43,6 +49,27 @@ namespace dawn_native { namespace vulkan {
         VkPipelineVertexInputStateCreateInfo ComputeVertexInputDesc(
             PipelineVertexInputStateCreateInfoTemporaryAllocations* temporaryAllocations);
 
+        // The state structures chained in a VkGraphicsPipelineCreateInfo, which must outlive it.
+        struct CreateInfoStorage {
+            std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages;
+            PipelineVertexInputStateCreateInfoTemporaryAllocations vertexInputAllocations;
+            VkPipelineVertexInputStateCreateInfo vertexInput;
+            VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+            VkViewport viewportDesc;
+            VkRect2D scissorRect;
+            VkPipelineViewportStateCreateInfo viewport;
+            VkPipelineRasterizationStateCreateInfo rasterization;
+            VkPipelineMultisampleStateCreateInfo multisample;
+            VkPipelineDepthStencilStateCreateInfo depthStencil;
+            std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments>
+                colorBlendAttachments;
+            VkPipelineColorBlendStateCreateInfo colorBlend;
+            VkPipelineDynamicStateCreateInfo dynamic;
+        };
+        MaybeError ComputeCreateInfo(const RenderPipelineDescriptor* descriptor,
+                                     CreateInfoStorage* storage,
+                                     VkGraphicsPipelineCreateInfo* createInfo);
+
         VkPipeline mHandle = VK_NULL_HANDLE;
     };
 
@@ -16,8 +16,16 @@
 
 namespace dawn_native { namespace vulkan {
 
-    ResourceHeap::ResourceHeap(VkDeviceMemory memory, size_t memoryType)
-        : mMemory(memory), mMemoryType(memoryType) {
+    ResourceHeap::ResourceHeap(VkDeviceMemory memory,
+                               size_t memoryType,
+                               uint64_t size,
+                               uint8_t* mappedPointer,
+                               bool transient)
+        : mMemory(memory),
+          mMemoryType(memoryType),
+          mSize(size),
+          mMappedPointer(mappedPointer),
+          mTransient(transient) {
     }
 
     VkDeviceMemory ResourceHeap::GetMemory() const {
@@ -28,4 +36,16 @@ namespace dawn_native { namespace vulkan {
         return mMemoryType;
     }
 
+    uint64_t ResourceHeap::GetSize() const {
+        return mSize;
+    }
+
+    uint8_t* ResourceHeap::GetMappedPointer() const {
+        return mMappedPointer;
+    }
+
+    bool ResourceHeap::IsTransient() const {
+        return mTransient;
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -23,15 +23,31 @@ namespace dawn_native { namespace vulkan {
     // Wrapper for physical memory used with or without a resource object.
     class ResourceHeap : public ResourceHeapBase {
       public:
-        ResourceHeap(VkDeviceMemory memory, size_t memoryType);
+        ResourceHeap(VkDeviceMemory memory,
+                     size_t memoryType,
+                     uint64_t size,
+                     uint8_t* mappedPointer = nullptr,
+                     bool transient = false);
         ~ResourceHeap() = default;
 
         VkDeviceMemory GetMemory() const;
         size_t GetMemoryType() const;
+        uint64_t GetSize() const;
+
+        // Heaps of mappable memory are mapped for their whole lifetime. The mapping is released
+        // when the memory is freed.
+        uint8_t* GetMappedPointer() const;
+
+        // Transient heaps are only sub-allocated for transient resources, which can reuse each
+        // other's memory as soon as they are destroyed.
+        bool IsTransient() const;
 
       private:
         VkDeviceMemory mMemory = VK_NULL_HANDLE;
         size_t mMemoryType = 0;
+        uint64_t mSize = 0;
+        uint8_t* mMappedPointer = nullptr;
+        bool mTransient = false;
     };
 
 }}  // namespace dawn_native::vulkan
@@ -14,57 +14,150 @@
 
 #include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
 
+#include "common/Math.h"
 #include "dawn_native/BuddyMemoryAllocator.h"
+#include "dawn_native/RecyclingResourceHeapAllocator.h"
 #include "dawn_native/ResourceHeapAllocator.h"
+#include "dawn_native/vulkan/AdapterVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
 #include "dawn_native/vulkan/VulkanError.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <algorithm>
 
 namespace dawn_native { namespace vulkan {
 
     namespace {
 
-        // TODO(cwallez@chromium.org): This is a hardcoded heurstic to choose when to
-        // suballocate but it should ideally depend on the size of the memory heaps and other
-        // factors.
         constexpr uint64_t kMaxBuddySystemSize = 32ull * 1024ull * 1024ull * 1024ull;  // 32GB
-        constexpr uint64_t kMaxSizeForSubAllocation = 4ull * 1024ull * 1024ull;        // 4MB
+
+        // The buddy heaps are a fraction of the size of the memory heap, so that large heaps use
+        // fewer VkDeviceMemory and small heaps, like the host visible part of VRAM, don't waste
+        // memory in half empty buddy heaps.
+        constexpr uint64_t kMinBuddyHeapsSize = 1ull * 1024ull * 1024ull;   // 1MB
+        constexpr uint64_t kMaxBuddyHeapsSize = 64ull * 1024ull * 1024ull;  // 64MB
+        constexpr uint64_t kMemoryHeapSizeToBuddyHeapsSizeRatio = 128;
+
+        // Resources the driver would prefer to have dedicated memory for only get it when they
+        // are large enough, so that small attachments don't use up the allocation count.
+        constexpr uint64_t kMinSizeForPreferredDedicatedAllocation = 1ull * 1024ull * 1024ull;
+
+        uint64_t ComputeBuddyHeapsSize(uint64_t memoryHeapSize) {
+            uint64_t size = memoryHeapSize / kMemoryHeapSizeToBuddyHeapsSizeRatio;
+            size = std::min(std::max(size, kMinBuddyHeapsSize), kMaxBuddyHeapsSize);
+            // The buddy system needs its heaps to be a power of two.
+            return uint64_t(1) << Log2(size);
+        }
 
         // Have each bucket of the buddy system allocate at least some resource of the maximum
         // size
-        constexpr uint64_t kBuddyHeapsSize = 2 * kMaxSizeForSubAllocation;
+        uint64_t ComputeMaxSizeForSubAllocation(uint64_t buddyHeapsSize) {
+            return buddyHeapsSize / 2;
+        }
+
+        // Transient resources are typically large attachments so they are sub-allocated in
+        // larger heaps, in which they can alias each other.
+        constexpr uint64_t kTransientHeapsSize = 128ull * 1024ull * 1024ull;  // 128MB
+
+        float VulkanMemoryPriority(wgpu::ResidencyPriority priority) {
+            switch (priority) {
+                case wgpu::ResidencyPriority::Minimum:
+                    return 0.0f;
+                case wgpu::ResidencyPriority::Low:
+                    return 0.25f;
+                case wgpu::ResidencyPriority::Normal:
+                    return 0.5f;
+                case wgpu::ResidencyPriority::High:
+                    return 0.75f;
+                case wgpu::ResidencyPriority::Maximum:
+                    return 1.0f;
+                default:
+                    UNREACHABLE();
+            }
+        }
 
     }  // anonymous namespace
 
     // SingleTypeAllocator is a combination of a BuddyMemoryAllocator and its client and can
-    // service suballocation requests, but for a single Vulkan memory type.
+    // service suballocation requests, but for a single Vulkan memory type. When the allocator
+    // serves mappable resources, each of its heaps is mapped once when it is allocated and the
+    // sub-allocations point in that mapping. When the allocator serves transient resources, the
+    // heaps which become empty are recycled for the next transient resources.
 
     class ResourceMemoryAllocator::SingleTypeAllocator : public ResourceHeapAllocator {
       public:
-        SingleTypeAllocator(Device* device, size_t memoryTypeIndex)
+        SingleTypeAllocator(Device* device,
+                            ResourceMemoryAllocator* allocator,
+                            size_t memoryTypeIndex,
+                            uint64_t buddyHeapsSize,
+                            bool mapHeaps,
+                            bool transient = false)
             : mDevice(device),
+              mAllocator(allocator),
               mMemoryTypeIndex(memoryTypeIndex),
-              mBuddySystem(kMaxBuddySystemSize, kBuddyHeapsSize, this) {
+              mMapHeaps(mapHeaps),
+              mTransient(transient),
+              mRecyclingHeapAllocator(
+                  transient ? std::make_unique<RecyclingResourceHeapAllocator>(kTransientHeapsSize,
+                                                                               this)
+                            : nullptr),
+              mBuddySystem(kMaxBuddySystemSize,
+                           transient ? kTransientHeapsSize : buddyHeapsSize,
+                           transient ? static_cast<ResourceHeapAllocator*>(
+                                           mRecyclingHeapAllocator.get())
+                                     : this) {
+            ASSERT(!(mapHeaps && transient));
         }
         ~SingleTypeAllocator() override = default;
 
         ResultOrError<ResourceMemoryAllocation> AllocateMemory(
             const VkMemoryRequirements& requirements) {
-            return mBuddySystem.Allocate(requirements.size, requirements.alignment);
+            ResourceMemoryAllocation allocation;
+            DAWN_TRY_ASSIGN(allocation,
+                            mBuddySystem.Allocate(requirements.size, requirements.alignment));
+            if (!mMapHeaps || allocation.GetInfo().mMethod == AllocationMethod::kInvalid) {
+                return allocation;
+            }
+
+            ResourceHeap* heap = ToBackend(allocation.GetResourceHeap());
+            return ResourceMemoryAllocation(allocation.GetInfo(), allocation.GetOffset(), heap,
+                                            heap->GetMappedPointer() + allocation.GetOffset());
         }
 
         void DeallocateMemory(const ResourceMemoryAllocation& allocation) {
             mBuddySystem.Deallocate(allocation);
         }
 
+        uint64_t GetAllocatedHeapSize() const {
+            return mBuddySystem.GetAllocatedHeapSize();
+        }
+        uint64_t GetUsedSize() const {
+            return mBuddySystem.GetUsedSize();
+        }
+
+        void Tick(Serial completedSerial) {
+            if (mRecyclingHeapAllocator != nullptr) {
+                mRecyclingHeapAllocator->Tick(completedSerial);
+            }
+        }
+
         // Implementation of the MemoryAllocator interface to be a client of BuddyMemoryAllocator
 
         ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
             uint64_t size) override {
+            return AllocateResourceHeap(size, nullptr);
+        }
+
+        // |allocateInfoChain| is chained to the VkMemoryAllocateInfo of the heap.
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size,
+            const void* allocateInfoChain) {
             VkMemoryAllocateInfo allocateInfo;
             allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            allocateInfo.pNext = nullptr;
+            allocateInfo.pNext = allocateInfoChain;
             allocateInfo.allocationSize = size;
             allocateInfo.memoryTypeIndex = mMemoryTypeIndex;
 
@@ -77,16 +170,39 @@ namespace dawn_native { namespace vulkan {
                 "vkAllocateMemory"));
 
             ASSERT(allocatedMemory != VK_NULL_HANDLE);
-            return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex)};
+
+            void* mappedPointer = nullptr;
+            if (mMapHeaps) {
+                MaybeError mapResult = CheckVkSuccess(
+                    mDevice->fn.MapMemory(mDevice->GetVkDevice(), allocatedMemory, 0, size, 0,
+                                          &mappedPointer),
+                    "vkMapMemory");
+                if (mapResult.IsError()) {
+                    mDevice->fn.FreeMemory(mDevice->GetVkDevice(), allocatedMemory, nullptr);
+                    return {mapResult.AcquireError()};
+                }
+            }
+
+            mAllocator->DidAllocateHeap(mMemoryTypeIndex, size);
+            return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex, size,
+                                                   static_cast<uint8_t*>(mappedPointer),
+                                                   mTransient)};
         }
 
         void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
-            mDevice->GetFencedDeleter()->DeleteWhenUnused(ToBackend(allocation.get())->GetMemory());
+            ResourceHeap* heap = ToBackend(allocation.get());
+            mAllocator->DidDeallocateHeap(mMemoryTypeIndex, heap->GetSize());
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(heap->GetMemory());
         }
 
       private:
         Device* mDevice;
+        ResourceMemoryAllocator* mAllocator;
         size_t mMemoryTypeIndex;
+        bool mMapHeaps;
+        bool mTransient;
+        // Declared before the buddy system, which gives its heaps back when it is destroyed.
+        std::unique_ptr<RecyclingResourceHeapAllocator> mRecyclingHeapAllocator;
         BuddyMemoryAllocator mBuddySystem;
     };
 
@@ -95,55 +211,259 @@ namespace dawn_native { namespace vulkan {
     ResourceMemoryAllocator::ResourceMemoryAllocator(Device* device) : mDevice(device) {
         const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
         mAllocatorsPerType.reserve(info.memoryTypes.size());
+        mMappableAllocatorsPerType.resize(info.memoryTypes.size());
+        mTransientAllocatorsPerType.reserve(info.memoryTypes.size());
+        mBuddyHeapsSizesPerType.reserve(info.memoryTypes.size());
 
         for (size_t i = 0; i < info.memoryTypes.size(); i++) {
-            mAllocatorsPerType.emplace_back(std::make_unique<SingleTypeAllocator>(mDevice, i));
+            uint64_t buddyHeapsSize =
+                ComputeBuddyHeapsSize(info.memoryHeaps[info.memoryTypes[i].heapIndex].size);
+            mBuddyHeapsSizesPerType.push_back(buddyHeapsSize);
+
+            mAllocatorsPerType.emplace_back(
+                std::make_unique<SingleTypeAllocator>(mDevice, this, i, buddyHeapsSize, false));
+            mTransientAllocatorsPerType.emplace_back(std::make_unique<SingleTypeAllocator>(
+                mDevice, this, i, buddyHeapsSize, false, true));
+
+            // Mappable resources are only allocated in host visible and coherent memory.
+            constexpr VkMemoryPropertyFlags kMappableFlags =
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            if ((info.memoryTypes[i].propertyFlags & kMappableFlags) == kMappableFlags) {
+                mMappableAllocatorsPerType[i] =
+                    std::make_unique<SingleTypeAllocator>(mDevice, this, i, buddyHeapsSize, true);
+            }
         }
+
+        mHeapBudgets.resize(info.memoryHeaps.size());
+        mAllocatedSizesAtUpdate.resize(info.memoryHeaps.size(), 0);
+        mAllocatedSizes.resize(info.memoryHeaps.size(), 0);
+        mAllocatedSizesPerType.resize(info.memoryTypes.size(), 0);
+        mPendingDeletionSizesPerType.resize(info.memoryTypes.size(), 0);
+        UpdateHeapBudgets();
     }
 
-    ResourceMemoryAllocator::~ResourceMemoryAllocator() = default;
+    ResourceMemoryAllocator::~ResourceMemoryAllocator() {
+        // The allocators give their heaps back when they are destroyed, which updates the
+        // allocated sizes that are declared after them.
+        mTransientAllocatorsPerType.clear();
+        mMappableAllocatorsPerType.clear();
+        mAllocatorsPerType.clear();
+    }
 
     ResultOrError<ResourceMemoryAllocation> ResourceMemoryAllocator::Allocate(
         const VkMemoryRequirements& requirements,
-        bool mappable) {
+        bool mappable,
+        bool preferHostVisibleDeviceLocal,
+        wgpu::ResidencyPriority priority,
+        const DedicatedAllocation& dedicated) {
+        TRACE_EVENT0(mDevice->GetPlatform(), General, "ResourceMemoryAllocator::Allocate");
+        VkDeviceSize size = requirements.size;
+
+        // The priority applies to a whole VkDeviceMemory, so prioritized resources don't share
+        // theirs with other resources.
+        bool usePriority = priority != wgpu::ResidencyPriority::Normal &&
+                           mDevice->GetDeviceInfo().memoryPriority;
+        bool useDedicated = dedicated.buffer != VK_NULL_HANDLE || dedicated.image != VK_NULL_HANDLE;
+        bool canSubAllocate = !usePriority && !useDedicated;
+        auto FitsInSubAllocation = [&](int memoryType) {
+            return canSubAllocate && requirements.size < ComputeMaxSizeForSubAllocation(
+                                                             mBuddyHeapsSizesPerType[memoryType]);
+        };
+
+        // Small resources which are often written by the CPU go in memory that is both device
+        // local and host visible when there is some to spare (UMA, resizable BAR), mapped so that
+        // they can be written without a staging copy.
+        int memoryType = -1;
+        if (preferHostVisibleDeviceLocal && canSubAllocate) {
+            memoryType = FindHostVisibleDeviceLocalTypeIndex(requirements);
+            if (memoryType >= 0 && FitsInSubAllocation(memoryType) &&
+                FitsInHeapBudget(memoryType, mBuddyHeapsSizesPerType[memoryType])) {
+                mappable = true;
+            } else {
+                memoryType = -1;
+            }
+        }
+
         // The Vulkan spec guarantees at least on memory type is valid.
-        int memoryType = FindBestTypeIndex(requirements, mappable);
+        if (memoryType < 0) {
+            memoryType = FindBestTypeIndex(requirements, mappable);
+        }
         ASSERT(memoryType >= 0);
 
-        VkDeviceSize size = requirements.size;
+        // Going over the budget of a heap makes the driver page memory out, which is much worse
+        // than using slower memory. Assume a sub-allocation needs a new buddy heap since we
+        // don't know whether an existing one has room for it.
+        bool subAllocate = FitsInSubAllocation(memoryType);
+        uint64_t heapSize = subAllocate ? mBuddyHeapsSizesPerType[memoryType] : size;
+        if (!FitsInHeapBudget(memoryType, heapSize)) {
+            memoryType = FindFallbackTypeIndex(requirements, mappable, heapSize);
+            if (memoryType < 0) {
+                return DAWN_OUT_OF_MEMORY_ERROR(
+                    "Allocation would exceed the memory budget of all the compatible heaps");
+            }
+            subAllocate = subAllocate && FitsInSubAllocation(memoryType);
+        }
+
+        SingleTypeAllocator* allocator = GetAllocator(memoryType, mappable);
 
-        // Sub-allocate non-mappable resources because at the moment the mapped pointer
-        // is part of the resource and not the heap, which doesn't match the Vulkan model.
-        // TODO(cwallez@chromium.org): allow sub-allocating mappable resources, maybe.
-        if (requirements.size < kMaxSizeForSubAllocation && !mappable) {
+        if (subAllocate) {
             ResourceMemoryAllocation subAllocation;
-            DAWN_TRY_ASSIGN(subAllocation,
-                            mAllocatorsPerType[memoryType]->AllocateMemory(requirements));
+            DAWN_TRY_ASSIGN(subAllocation, allocator->AllocateMemory(requirements));
             if (subAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
                 return subAllocation;
             }
         }
 
+        const void* allocateInfoChain = nullptr;
+
+        VkMemoryPriorityAllocateInfoEXT priorityInfo;
+        if (usePriority) {
+            priorityInfo.sType = VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT;
+            priorityInfo.pNext = allocateInfoChain;
+            priorityInfo.priority = VulkanMemoryPriority(priority);
+            allocateInfoChain = &priorityInfo;
+        }
+
+        VkMemoryDedicatedAllocateInfoKHR dedicatedInfo;
+        if (useDedicated) {
+            dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR;
+            dedicatedInfo.pNext = allocateInfoChain;
+            dedicatedInfo.image = dedicated.image;
+            dedicatedInfo.buffer = dedicated.buffer;
+            allocateInfoChain = &dedicatedInfo;
+        }
+
         // If sub-allocation failed, allocate memory just for it.
         std::unique_ptr<ResourceHeapBase> resourceHeap;
-        DAWN_TRY_ASSIGN(resourceHeap, mAllocatorsPerType[memoryType]->AllocateResourceHeap(size));
+        DAWN_TRY_ASSIGN(resourceHeap, allocator->AllocateResourceHeap(size, allocateInfoChain));
 
-        void* mappedPointer = nullptr;
-        if (mappable) {
-            DAWN_TRY(
-                CheckVkSuccess(mDevice->fn.MapMemory(mDevice->GetVkDevice(),
-                                                     ToBackend(resourceHeap.get())->GetMemory(), 0,
-                                                     size, 0, &mappedPointer),
-                               "vkMapMemory"));
+        uint8_t* mappedPointer = ToBackend(resourceHeap.get())->GetMappedPointer();
+        AllocationInfo info;
+        info.mMethod = AllocationMethod::kDirect;
+        info.mRequestedSize = size;
+        return ResourceMemoryAllocation(info, /*offset*/ 0, resourceHeap.release(), mappedPointer);
+    }
+
+    VkMemoryRequirements ResourceMemoryAllocator::GetBufferMemoryRequirements(
+        VkBuffer buffer,
+        DedicatedAllocation* dedicated) const {
+        if (!mDevice->GetDeviceInfo().dedicatedAllocation) {
+            VkMemoryRequirements requirements;
+            mDevice->fn.GetBufferMemoryRequirements(mDevice->GetVkDevice(), buffer, &requirements);
+            return requirements;
+        }
+
+        VkBufferMemoryRequirementsInfo2KHR requirementsInfo;
+        requirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2_KHR;
+        requirementsInfo.pNext = nullptr;
+        requirementsInfo.buffer = buffer;
+
+        VkMemoryDedicatedRequirementsKHR dedicatedRequirements = {};
+        dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS_KHR;
+
+        VkMemoryRequirements2KHR requirements = {};
+        requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR;
+        requirements.pNext = &dedicatedRequirements;
+
+        mDevice->fn.GetBufferMemoryRequirements2KHR(mDevice->GetVkDevice(), &requirementsInfo,
+                                                    &requirements);
+        if (UseDedicatedAllocation(dedicatedRequirements, requirements.memoryRequirements)) {
+            dedicated->buffer = buffer;
         }
+        return requirements.memoryRequirements;
+    }
+
+    VkMemoryRequirements ResourceMemoryAllocator::GetImageMemoryRequirements(
+        VkImage image,
+        DedicatedAllocation* dedicated) const {
+        if (!mDevice->GetDeviceInfo().dedicatedAllocation) {
+            VkMemoryRequirements requirements;
+            mDevice->fn.GetImageMemoryRequirements(mDevice->GetVkDevice(), image, &requirements);
+            return requirements;
+        }
+
+        VkImageMemoryRequirementsInfo2KHR requirementsInfo;
+        requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2_KHR;
+        requirementsInfo.pNext = nullptr;
+        requirementsInfo.image = image;
+
+        VkMemoryDedicatedRequirementsKHR dedicatedRequirements = {};
+        dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS_KHR;
+
+        VkMemoryRequirements2KHR requirements = {};
+        requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR;
+        requirements.pNext = &dedicatedRequirements;
+
+        mDevice->fn.GetImageMemoryRequirements2KHR(mDevice->GetVkDevice(), &requirementsInfo,
+                                                   &requirements);
+        if (UseDedicatedAllocation(dedicatedRequirements, requirements.memoryRequirements)) {
+            dedicated->image = image;
+        }
+        return requirements.memoryRequirements;
+    }
+
+    // static
+    bool ResourceMemoryAllocator::UseDedicatedAllocation(
+        const VkMemoryDedicatedRequirementsKHR& dedicatedRequirements,
+        const VkMemoryRequirements& requirements) {
+        return dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE ||
+               (dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE &&
+                requirements.size >= kMinSizeForPreferredDedicatedAllocation);
+    }
+
+    ResultOrError<ResourceMemoryAllocation> ResourceMemoryAllocator::AllocateTransient(
+        const VkMemoryRequirements& requirements) {
+        TRACE_EVENT0(mDevice->GetPlatform(), General,
+                     "ResourceMemoryAllocator::AllocateTransient");
+
+        // Resources larger than the transient heaps get memory of their own, which can't be
+        // reused before the GPU is done with it.
+        if (requirements.size > kTransientHeapsSize) {
+            return Allocate(requirements, false);
+        }
+
+        int memoryType = FindBestTypeIndex(requirements, false);
+        ASSERT(memoryType >= 0);
+        if (!FitsInHeapBudget(memoryType, kTransientHeapsSize)) {
+            memoryType = FindFallbackTypeIndex(requirements, false, kTransientHeapsSize);
+            if (memoryType < 0) {
+                return Allocate(requirements, false);
+            }
+        }
+
+        ResourceMemoryAllocation subAllocation;
+        DAWN_TRY_ASSIGN(subAllocation,
+                        mTransientAllocatorsPerType[memoryType]->AllocateMemory(requirements));
+        if (subAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
+            return subAllocation;
+        }
+        return Allocate(requirements, false);
+    }
+
+    ResultOrError<ResourceMemoryAllocation> ResourceMemoryAllocator::AllocateLazilyAllocated(
+        const VkMemoryRequirements& requirements) {
+        TRACE_EVENT0(mDevice->GetPlatform(), General,
+                     "ResourceMemoryAllocator::AllocateLazilyAllocated");
+
+        int memoryType = FindLazilyAllocatedTypeIndex(requirements);
+        if (memoryType < 0) {
+            return Allocate(requirements, false);
+        }
+
+        // Sub-allocating would commit the memory of the whole heap as soon as one of its
+        // attachments doesn't fit in tile memory.
+        std::unique_ptr<ResourceHeapBase> resourceHeap;
+        DAWN_TRY_ASSIGN(resourceHeap, mAllocatorsPerType[memoryType]->AllocateResourceHeap(
+                                          requirements.size, nullptr));
 
         AllocationInfo info;
         info.mMethod = AllocationMethod::kDirect;
-        return ResourceMemoryAllocation(info, /*offset*/ 0, resourceHeap.release(),
-                                        static_cast<uint8_t*>(mappedPointer));
+        info.mRequestedSize = requirements.size;
+        return ResourceMemoryAllocation(info, /*offset*/ 0, resourceHeap.release());
     }
 
     void ResourceMemoryAllocator::Deallocate(ResourceMemoryAllocation* allocation) {
+        TRACE_EVENT0(mDevice->GetPlatform(), General, "ResourceMemoryAllocator::Deallocate");
         switch (allocation->GetInfo().mMethod) {
             // Some memory allocation can never be initialized, for example when wrapping
             // swapchain VkImages with a Texture.
@@ -152,18 +472,28 @@ namespace dawn_native { namespace vulkan {
 
             // For direct allocation we can put the memory for deletion immediately and the fence
             // deleter will make sure the resources are freed before the memory.
-            case AllocationMethod::kDirect:
-                mDevice->GetFencedDeleter()->DeleteWhenUnused(
-                    ToBackend(allocation->GetResourceHeap())->GetMemory());
-                break;
+            case AllocationMethod::kDirect: {
+                ResourceHeap* heap = ToBackend(allocation->GetResourceHeap());
+                DidDeallocateHeap(heap->GetMemoryType(), heap->GetSize());
+                mDevice->GetFencedDeleter()->DeleteWhenUnused(heap->GetMemory());
+            } break;
 
             // Suballocations aren't freed immediately, otherwise another resource allocation could
-            // happen just after that aliases the old one and would require a barrier.
-            // TODO(cwallez@chromium.org): Maybe we can produce the correct barriers to reduce the
-            // latency to reclaim memory.
-            case AllocationMethod::kSubAllocated:
-                mSubAllocationsToDelete.Enqueue(*allocation, mDevice->GetPendingCommandSerial());
-                break;
+            // happen just after that aliases the old one and would require a barrier. Transient
+            // heaps only contain transient resources, which all start with that barrier so their
+            // memory is reused right away.
+            case AllocationMethod::kSubAllocated: {
+                ResourceHeap* heap = ToBackend(allocation->GetResourceHeap());
+                if (heap->IsTransient()) {
+                    mTransientAllocatorsPerType[heap->GetMemoryType()]->DeallocateMemory(
+                        *allocation);
+                } else {
+                    mPendingDeletionSizesPerType[heap->GetMemoryType()] +=
+                        allocation->GetInfo().mRequestedSize;
+                    mSubAllocationsToDelete.Enqueue(*allocation,
+                                                    mDevice->GetPendingCommandSerial());
+                }
+            } break;
 
             default:
                 UNREACHABLE();
@@ -179,12 +509,32 @@ namespace dawn_native { namespace vulkan {
         for (const ResourceMemoryAllocation& allocation :
              mSubAllocationsToDelete.IterateUpTo(completedSerial)) {
             ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated);
-            size_t memoryType = ToBackend(allocation.GetResourceHeap())->GetMemoryType();
-
-            mAllocatorsPerType[memoryType]->DeallocateMemory(allocation);
+            ResourceHeap* heap = ToBackend(allocation.GetResourceHeap());
+            bool mappable = heap->GetMappedPointer() != nullptr;
+
+            ASSERT(mPendingDeletionSizesPerType[heap->GetMemoryType()] >=
+                   allocation.GetInfo().mRequestedSize);
+            mPendingDeletionSizesPerType[heap->GetMemoryType()] -=
+                allocation.GetInfo().mRequestedSize;
+            GetAllocator(heap->GetMemoryType(), mappable)->DeallocateMemory(allocation);
         }
 
         mSubAllocationsToDelete.ClearUpTo(completedSerial);
+
+        // The fenced deleter frees the heaps once the GPU is done with the serial they were
+        // deallocated in, which is also when they stop being pending here.
+        for (const PendingHeapDeletion& deletion :
+             mPendingHeapDeletions.IterateUpTo(completedSerial)) {
+            ASSERT(mPendingDeletionSizesPerType[deletion.memoryType] >= deletion.size);
+            mPendingDeletionSizesPerType[deletion.memoryType] -= deletion.size;
+        }
+        mPendingHeapDeletions.ClearUpTo(completedSerial);
+
+        for (const std::unique_ptr<SingleTypeAllocator>& allocator : mTransientAllocatorsPerType) {
+            allocator->Tick(completedSerial);
+        }
+
+        UpdateHeapBudgets();
     }
 
     int ResourceMemoryAllocator::FindBestTypeIndex(VkMemoryRequirements requirements,
@@ -241,4 +591,175 @@ namespace dawn_native { namespace vulkan {
         return bestType;
     }
 
+    ResourceMemoryAllocator::SingleTypeAllocator* ResourceMemoryAllocator::GetAllocator(
+        size_t memoryType,
+        bool mappable) const {
+        if (mappable) {
+            ASSERT(mMappableAllocatorsPerType[memoryType] != nullptr);
+            return mMappableAllocatorsPerType[memoryType].get();
+        }
+        return mAllocatorsPerType[memoryType].get();
+    }
+
+    int ResourceMemoryAllocator::FindHostVisibleDeviceLocalTypeIndex(
+        VkMemoryRequirements requirements) const {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+
+        constexpr VkMemoryPropertyFlags kRequiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        for (size_t i = 0; i < info.memoryTypes.size(); ++i) {
+            if ((requirements.memoryTypeBits & (1 << i)) != 0 &&
+                (info.memoryTypes[i].propertyFlags & kRequiredFlags) == kRequiredFlags) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    int ResourceMemoryAllocator::FindLazilyAllocatedTypeIndex(
+        VkMemoryRequirements requirements) const {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+
+        for (size_t i = 0; i < info.memoryTypes.size(); ++i) {
+            if ((requirements.memoryTypeBits & (1 << i)) != 0 &&
+                (info.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) !=
+                    0) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    int ResourceMemoryAllocator::FindFallbackTypeIndex(VkMemoryRequirements requirements,
+                                                       bool mappable,
+                                                       uint64_t size) {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+
+        // Fall back to the host visible memory type with the most budget left, in a heap which
+        // has room for the allocation.
+        int bestType = -1;
+        uint64_t bestTypeBudgetLeft = 0;
+        for (size_t i = 0; i < info.memoryTypes.size(); ++i) {
+            if ((requirements.memoryTypeBits & (1 << i)) == 0) {
+                continue;
+            }
+
+            VkMemoryPropertyFlags flags = info.memoryTypes[i].propertyFlags;
+            if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+                continue;
+            }
+            if (mappable && (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0) {
+                continue;
+            }
+
+            if (!FitsInHeapBudget(static_cast<int>(i), size)) {
+                continue;
+            }
+
+            HeapBudget heapBudget = GetHeapBudget(info.memoryTypes[i].heapIndex);
+            uint64_t budgetLeft = heapBudget.budget - heapBudget.usage;
+            if (bestType == -1 || budgetLeft > bestTypeBudgetLeft) {
+                bestType = static_cast<int>(i);
+                bestTypeBudgetLeft = budgetLeft;
+            }
+        }
+
+        return bestType;
+    }
+
+    std::vector<HeapBudget> ResourceMemoryAllocator::GetHeapBudgets() const {
+        std::vector<HeapBudget> budgets(mHeapBudgets.size());
+        for (uint32_t i = 0; i < budgets.size(); ++i) {
+            budgets[i] = GetHeapBudget(i);
+        }
+        return budgets;
+    }
+
+    std::vector<MemoryTypeUsage> ResourceMemoryAllocator::GetMemoryTypeUsages() const {
+        std::vector<MemoryTypeUsage> usages(mAllocatedSizesPerType.size());
+        for (uint32_t i = 0; i < usages.size(); ++i) {
+            usages[i].memoryType = i;
+            usages[i].heapSize = mAllocatedSizesPerType[i];
+            usages[i].pendingDeletionSize = mPendingDeletionSizesPerType[i];
+
+            for (const SingleTypeAllocator* allocator :
+                 {mAllocatorsPerType[i].get(), mMappableAllocatorsPerType[i].get(),
+                  mTransientAllocatorsPerType[i].get()}) {
+                if (allocator != nullptr) {
+                    usages[i].subAllocationHeapSize += allocator->GetAllocatedHeapSize();
+                    usages[i].subAllocatedSize += allocator->GetUsedSize();
+                }
+            }
+        }
+        return usages;
+    }
+
+    HeapBudget ResourceMemoryAllocator::GetHeapBudget(uint32_t heapIndex) const {
+        // Memory freed since the update is only released by the fenced deleter later, so the
+        // estimated usage can't go below what it was at the update.
+        HeapBudget heapBudget = mHeapBudgets[heapIndex];
+        if (mAllocatedSizes[heapIndex] > mAllocatedSizesAtUpdate[heapIndex]) {
+            heapBudget.usage += mAllocatedSizes[heapIndex] - mAllocatedSizesAtUpdate[heapIndex];
+        }
+        return heapBudget;
+    }
+
+    bool ResourceMemoryAllocator::FitsInHeapBudget(int memoryType, uint64_t size) const {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+        HeapBudget heapBudget = GetHeapBudget(info.memoryTypes[memoryType].heapIndex);
+        return heapBudget.usage <= heapBudget.budget &&
+               size <= heapBudget.budget - heapBudget.usage;
+    }
+
+    void ResourceMemoryAllocator::UpdateHeapBudgets() {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+
+        if (!info.memoryBudget) {
+            for (size_t i = 0; i < info.memoryHeaps.size(); ++i) {
+                mHeapBudgets[i].usage = mAllocatedSizes[i];
+                mHeapBudgets[i].budget = info.memoryHeaps[i].size;
+            }
+            mAllocatedSizesAtUpdate = mAllocatedSizes;
+            return;
+        }
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {};
+        memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        memoryProperties2.pNext = &budgetProperties;
+
+        mDevice->fn.GetPhysicalDeviceMemoryProperties2(
+            ToBackend(mDevice->GetAdapter())->GetPhysicalDevice(), &memoryProperties2);
+
+        for (size_t i = 0; i < info.memoryHeaps.size(); ++i) {
+            mHeapBudgets[i].usage = budgetProperties.heapUsage[i];
+            // Some drivers report no budget for heaps they don't track.
+            mHeapBudgets[i].budget = budgetProperties.heapBudget[i] != 0
+                                         ? budgetProperties.heapBudget[i]
+                                         : info.memoryHeaps[i].size;
+        }
+        mAllocatedSizesAtUpdate = mAllocatedSizes;
+    }
+
+    void ResourceMemoryAllocator::DidAllocateHeap(size_t memoryType, uint64_t size) {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+        mAllocatedSizes[info.memoryTypes[memoryType].heapIndex] += size;
+        mAllocatedSizesPerType[memoryType] += size;
+    }
+
+    void ResourceMemoryAllocator::DidDeallocateHeap(size_t memoryType, uint64_t size) {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+        uint32_t heapIndex = info.memoryTypes[memoryType].heapIndex;
+        ASSERT(mAllocatedSizes[heapIndex] >= size);
+        mAllocatedSizes[heapIndex] -= size;
+
+        ASSERT(mAllocatedSizesPerType[memoryType] >= size);
+        mAllocatedSizesPerType[memoryType] -= size;
+        mPendingDeletionSizesPerType[memoryType] += size;
+        mPendingHeapDeletions.Enqueue({memoryType, size}, mDevice->GetPendingCommandSerial());
+    }
+
 }}  // namespace dawn_native::vulkan
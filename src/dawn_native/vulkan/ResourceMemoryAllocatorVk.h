@@ -18,6 +18,7 @@
 #include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 #include "dawn_native/Error.h"
+#include "dawn_native/dawn_platform.h"
 #include "dawn_native/ResourceMemoryAllocation.h"
 
 #include <memory>
@@ -27,24 +28,106 @@ namespace dawn_native { namespace vulkan {
 
     class Device;
 
+    // The memory used by the process in a memory heap, and the amount it can use before the
+    // driver starts paging memory out.
+    struct HeapBudget {
+        uint64_t usage = 0;
+        uint64_t budget = 0;
+    };
+
+    // The buffer or image to allocate memory of its own for, with VK_KHR_dedicated_allocation.
+    struct DedicatedAllocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImage image = VK_NULL_HANDLE;
+    };
+
     class ResourceMemoryAllocator {
       public:
         ResourceMemoryAllocator(Device* device);
         ~ResourceMemoryAllocator();
 
-        ResultOrError<ResourceMemoryAllocation> Allocate(const VkMemoryRequirements& requirements,
-                                                         bool mappable);
+        // With `preferHostVisibleDeviceLocal`, small allocations are made mappable if there is
+        // memory which is both device local and host visible. With VK_EXT_memory_priority,
+        // allocations with a priority other than normal get memory of their own with that
+        // priority, which can't be changed afterwards. The same goes for dedicated allocations.
+        ResultOrError<ResourceMemoryAllocation> Allocate(
+            const VkMemoryRequirements& requirements,
+            bool mappable,
+            bool preferHostVisibleDeviceLocal = false,
+            wgpu::ResidencyPriority priority = wgpu::ResidencyPriority::Normal,
+            const DedicatedAllocation& dedicated = {});
+        // Transient allocations are sub-allocated in heaps of their own and are reused by the
+        // next transient allocations as soon as they are deallocated. The resources using them
+        // must wait on all the previous commands of the queue in their first barrier.
+        ResultOrError<ResourceMemoryAllocation> AllocateTransient(
+            const VkMemoryRequirements& requirements);
+        // Transient attachments get lazily allocated memory of their own when there is some, so
+        // that tilers only back it with memory if the attachments don't fit in tile memory.
+        ResultOrError<ResourceMemoryAllocation> AllocateLazilyAllocated(
+            const VkMemoryRequirements& requirements);
         void Deallocate(ResourceMemoryAllocation* allocation);
 
+        // Returns the memory requirements of the buffer or image. With
+        // VK_KHR_dedicated_allocation, |dedicated| is set to it when the driver requires memory of
+        // its own for it, or prefers it and the resource is large.
+        VkMemoryRequirements GetBufferMemoryRequirements(VkBuffer buffer,
+                                                         DedicatedAllocation* dedicated) const;
+        VkMemoryRequirements GetImageMemoryRequirements(VkImage image,
+                                                        DedicatedAllocation* dedicated) const;
+
         void Tick(Serial completedSerial);
 
         int FindBestTypeIndex(VkMemoryRequirements requirements, bool mappable);
 
+        // With VK_EXT_memory_budget, the budgets are queried on each Tick and the usages include
+        // the memory allocated by the device since then. Otherwise the budget of a heap is its
+        // size and its usage only counts the memory allocated by the device.
+        std::vector<HeapBudget> GetHeapBudgets() const;
+
+        // The memory allocated in each memory type, the part of it that is sub-allocated and
+        // the memory freed by the device which the GPU might still use.
+        std::vector<MemoryTypeUsage> GetMemoryTypeUsages() const;
+
       private:
+        class SingleTypeAllocator;
+        SingleTypeAllocator* GetAllocator(size_t memoryType, bool mappable) const;
+
+        static bool UseDedicatedAllocation(
+            const VkMemoryDedicatedRequirementsKHR& dedicatedRequirements,
+            const VkMemoryRequirements& requirements);
+
+        HeapBudget GetHeapBudget(uint32_t heapIndex) const;
+        bool FitsInHeapBudget(int memoryType, uint64_t size) const;
+        int FindHostVisibleDeviceLocalTypeIndex(VkMemoryRequirements requirements) const;
+        int FindLazilyAllocatedTypeIndex(VkMemoryRequirements requirements) const;
+        int FindFallbackTypeIndex(VkMemoryRequirements requirements, bool mappable, uint64_t size);
+        void UpdateHeapBudgets();
+
+        void DidAllocateHeap(size_t memoryType, uint64_t size);
+        void DidDeallocateHeap(size_t memoryType, uint64_t size);
+
         Device* mDevice;
 
-        class SingleTypeAllocator;
         std::vector<std::unique_ptr<SingleTypeAllocator>> mAllocatorsPerType;
+        // Only set for the host visible and coherent memory types.
+        std::vector<std::unique_ptr<SingleTypeAllocator>> mMappableAllocatorsPerType;
+        std::vector<std::unique_ptr<SingleTypeAllocator>> mTransientAllocatorsPerType;
+        // Depends on the size of the memory heap of the type.
+        std::vector<uint64_t> mBuddyHeapsSizesPerType;
+
+        // The budgets as of the last update, with the memory allocated by the device in each heap
+        // at that time and now.
+        std::vector<HeapBudget> mHeapBudgets;
+        std::vector<uint64_t> mAllocatedSizesAtUpdate;
+        std::vector<uint64_t> mAllocatedSizes;
+
+        std::vector<uint64_t> mAllocatedSizesPerType;
+        std::vector<uint64_t> mPendingDeletionSizesPerType;
+        struct PendingHeapDeletion {
+            size_t memoryType;
+            uint64_t size;
+        };
+        SerialQueue<PendingHeapDeletion> mPendingHeapDeletions;
 
         SerialQueue<ResourceMemoryAllocation> mSubAllocationsToDelete;
     };
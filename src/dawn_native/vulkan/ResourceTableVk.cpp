@@ -0,0 +1,218 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/ResourceTableVk.h"
+
+#include "common/BitSetIterator.h"
+#include "dawn_native/vulkan/BindGroupLayoutVk.h"
+#include "dawn_native/vulkan/BufferVk.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/TextureVk.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+namespace dawn_native { namespace vulkan {
+
+    // static
+    ResultOrError<ResourceTable*> ResourceTable::Create(Device* device,
+                                                        const ResourceTableDescriptor* descriptor) {
+        std::unique_ptr<ResourceTable> table = std::make_unique<ResourceTable>(device, descriptor);
+        DAWN_TRY(table->Initialize());
+        return table.release();
+    }
+
+    MaybeError ResourceTable::Initialize() {
+        mIsSlotDirty.resize(GetCapacity(), false);
+        DAWN_TRY_ASSIGN(mCurrent, CreateVersion());
+        return {};
+    }
+
+    ResourceTable::~ResourceTable() {
+        Device* device = ToBackend(GetDevice());
+        FencedDeleter* deleter = device->GetFencedDeleter();
+
+        uint64_t poolCount = 0;
+        auto DeleteVersion = [&](const Version& version) {
+            if (version.pool != VK_NULL_HANDLE) {
+                deleter->DeleteWhenUnused(version.pool);
+                poolCount++;
+            }
+        };
+
+        DeleteVersion(mCurrent);
+        for (const Version& version : mVersionsInFlight.IterateAll()) {
+            DeleteVersion(version);
+        }
+        for (const Version& version : mAvailableVersions) {
+            DeleteVersion(version);
+        }
+        device->DidDestroyDescriptorPools(poolCount);
+    }
+
+    MaybeError ResourceTable::PrepareForSubmit() {
+        Device* device = ToBackend(GetDevice());
+
+        if (!mDirtySlots.empty()) {
+            if (mLastUsageSerial > device->GetCompletedCommandSerial()) {
+                // The commands in flight can index any slot of the set, so the updates go to
+                // another version of it that gets all the slots.
+                Version version;
+                DAWN_TRY_ASSIGN(version, AcquireVersion());
+                mVersionsInFlight.Enqueue(mCurrent, mLastUsageSerial);
+                mCurrent = version;
+
+                std::vector<uint32_t> setSlots;
+                for (uint32_t slot = 0; slot < GetCapacity(); ++slot) {
+                    if (IsSlotSet(slot)) {
+                        setSlots.push_back(slot);
+                    }
+                }
+                WriteSlots(mCurrent.set, setSlots);
+            } else {
+                WriteSlots(mCurrent.set, mDirtySlots);
+            }
+
+            for (uint32_t slot : mDirtySlots) {
+                mIsSlotDirty[slot] = false;
+            }
+            mDirtySlots.clear();
+        }
+
+        mLastUsageSerial = device->GetPendingCommandSerial();
+        return {};
+    }
+
+    VkDescriptorSet ResourceTable::GetHandle() const {
+        return mCurrent.set;
+    }
+
+    void ResourceTable::DidUpdateSlot(uint32_t slot) {
+        if (!mIsSlotDirty[slot]) {
+            mIsSlotDirty[slot] = true;
+            mDirtySlots.push_back(slot);
+        }
+    }
+
+    ResultOrError<ResourceTable::Version> ResourceTable::AcquireVersion() {
+        Serial completedSerial = ToBackend(GetDevice())->GetCompletedCommandSerial();
+        for (const Version& version : mVersionsInFlight.IterateUpTo(completedSerial)) {
+            mAvailableVersions.push_back(version);
+        }
+        mVersionsInFlight.ClearUpTo(completedSerial);
+
+        if (mAvailableVersions.empty()) {
+            return CreateVersion();
+        }
+
+        Version version = mAvailableVersions.back();
+        mAvailableVersions.pop_back();
+        return version;
+    }
+
+    ResultOrError<ResourceTable::Version> ResourceTable::CreateVersion() {
+        Device* device = ToBackend(GetDevice());
+
+        VkDescriptorPoolSize poolSize;
+        poolSize.type = VulkanDescriptorType(GetBindingType(), false);
+        poolSize.descriptorCount = GetCapacity();
+
+        VkDescriptorPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        createInfo.maxSets = 1;
+        createInfo.poolSizeCount = 1;
+        createInfo.pPoolSizes = &poolSize;
+
+        Version version;
+        DAWN_TRY(CheckVkSuccess(device->fn.CreateDescriptorPool(device->GetVkDevice(), &createInfo,
+                                                                nullptr, &*version.pool),
+                                "CreateDescriptorPool"));
+
+        VkDescriptorSetLayout layout = ToBackend(GetLayout())->GetHandle();
+
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorPool = version.pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &*layout;
+
+        MaybeError result = CheckVkSuccess(
+            device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo, &*version.set),
+            "AllocateDescriptorSets");
+        if (result.IsError()) {
+            // On an error we can destroy the pool immediately because no command references it.
+            device->fn.DestroyDescriptorPool(device->GetVkDevice(), version.pool, nullptr);
+            return result.AcquireError();
+        }
+
+        device->DidCreateDescriptorPool();
+        return version;
+    }
+
+    void ResourceTable::WriteSlots(VkDescriptorSet set, const std::vector<uint32_t>& slots) {
+        Device* device = ToBackend(GetDevice());
+        bool isTextureTable = GetBindingType() == wgpu::BindingType::SampledTexture;
+        VkDescriptorType descriptorType = VulkanDescriptorType(GetBindingType(), false);
+
+        uint32_t binding = 0;
+        for (uint32_t bindingIndex : IterateBitSet(GetLayout()->GetBindingInfo().mask)) {
+            binding = bindingIndex;
+        }
+
+        // The writes point into the update data, which is never reallocated.
+        std::vector<DescriptorUpdateData> updateData(slots.size());
+        std::vector<VkWriteDescriptorSet> writes;
+        writes.reserve(slots.size());
+        for (uint32_t slot : slots) {
+            // Empty slots are left as they are, the layout binding is partially bound.
+            if (!IsSlotSet(slot)) {
+                continue;
+            }
+
+            DescriptorUpdateData* data = &updateData[writes.size()];
+            if (isTextureTable) {
+                data->image.sampler = VK_NULL_HANDLE;
+                data->image.imageView = ToBackend(GetSlotAsTextureView(slot))->GetHandle();
+                data->image.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            } else {
+                BufferBinding bufferBinding = GetSlotAsBufferBinding(slot);
+                data->buffer.buffer = ToBackend(bufferBinding.buffer)->GetHandle();
+                data->buffer.offset = bufferBinding.offset;
+                data->buffer.range = bufferBinding.size;
+            }
+
+            VkWriteDescriptorSet write;
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.pNext = nullptr;
+            write.dstSet = set;
+            write.dstBinding = binding;
+            write.dstArrayElement = slot;
+            write.descriptorCount = 1;
+            write.descriptorType = descriptorType;
+            write.pImageInfo = &data->image;
+            write.pBufferInfo = &data->buffer;
+            write.pTexelBufferView = nullptr;
+            writes.push_back(write);
+        }
+
+        if (!writes.empty()) {
+            device->fn.UpdateDescriptorSets(device->GetVkDevice(),
+                                            static_cast<uint32_t>(writes.size()), writes.data(), 0,
+                                            nullptr);
+        }
+    }
+
+}}  // namespace dawn_native::vulkan
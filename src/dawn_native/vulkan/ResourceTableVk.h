@@ -0,0 +1,70 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_RESOURCETABLEVK_H_
+#define DAWNNATIVE_VULKAN_RESOURCETABLEVK_H_
+
+#include "dawn_native/ResourceTable.h"
+
+#include "common/SerialQueue.h"
+#include "common/vulkan_platform.h"
+
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // The table is an update-after-bind descriptor set in its own pool. The sets used by
+    // commands that are still executing are never written: when the table is updated while its
+    // set is in flight, the next submit uses another version of the set with all the slots
+    // written, and the old version is reused once its commands completed.
+    class ResourceTable final : public ResourceTableBase {
+      public:
+        static ResultOrError<ResourceTable*> Create(Device* device,
+                                                    const ResourceTableDescriptor* descriptor);
+        ~ResourceTable() override;
+
+        // Writes the updated slots before the table is used by the commands submitted at the
+        // pending serial. Called at submit, before any command buffer is recorded.
+        MaybeError PrepareForSubmit();
+        VkDescriptorSet GetHandle() const;
+
+      private:
+        using ResourceTableBase::ResourceTableBase;
+
+        struct Version {
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+        };
+
+        MaybeError Initialize();
+        void DidUpdateSlot(uint32_t slot) override;
+
+        ResultOrError<Version> AcquireVersion();
+        ResultOrError<Version> CreateVersion();
+        void WriteSlots(VkDescriptorSet set, const std::vector<uint32_t>& slots);
+
+        Version mCurrent;
+        Serial mLastUsageSerial = 0;
+        SerialQueue<Version> mVersionsInFlight;
+        std::vector<Version> mAvailableVersions;
+
+        std::vector<uint32_t> mDirtySlots;
+        std::vector<bool> mIsSlotDirty;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_RESOURCETABLEVK_H_
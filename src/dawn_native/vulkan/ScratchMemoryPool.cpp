@@ -0,0 +1,108 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/ScratchMemoryPool.h"
+
+#include "common/Math.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+
+#include <algorithm>
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        constexpr uint64_t kInitialScratchMemorySize = 4 * 1024 * 1024;
+
+    }  // anonymous namespace
+
+    ScratchMemoryPool::ScratchMemoryPool(Device* device) : mDevice(device) {
+    }
+
+    ScratchMemoryPool::~ScratchMemoryPool() {
+        if (mBuffer.Get() != nullptr) {
+            mBuffer->Destroy();
+            mBuffer = nullptr;
+        }
+    }
+
+    ResultOrError<ScratchMemoryAllocation> ScratchMemoryPool::Allocate(uint64_t size) {
+        // Round every sub-allocation up so that all offsets handed out by the ring buffer stay
+        // aligned for vkCmdBuildAccelerationStructureNV.
+        uint64_t allocationSize = std::max(size, uint64_t(1));
+        allocationSize = (allocationSize + kScratchMemoryAlignment - 1) &
+                         ~(kScratchMemoryAlignment - 1);
+
+        Serial pendingSerial = mDevice->GetPendingCommandSerial();
+        mReleaseWhenIdle = false;
+
+        uint64_t startOffset = RingBufferAllocator::kInvalidOffset;
+        if (mBuffer.Get() != nullptr) {
+            startOffset = mAllocator.Allocate(allocationSize, pendingSerial);
+        }
+
+        // Upon failure, replace the arena with a larger one. Commands that were already recorded
+        // keep referencing the previous buffer, which is only released once the pending serial
+        // has completed.
+        if (startOffset == RingBufferAllocator::kInvalidOffset) {
+            DAWN_TRY(Grow(allocationSize));
+            startOffset = mAllocator.Allocate(allocationSize, pendingSerial);
+        }
+
+        ASSERT(startOffset != RingBufferAllocator::kInvalidOffset);
+
+        ScratchMemoryAllocation allocation;
+        allocation.buffer = mBuffer->GetHandle();
+        allocation.offset = startOffset;
+        return allocation;
+    }
+
+    void ScratchMemoryPool::Tick(Serial completedSerial) {
+        mAllocator.Deallocate(completedSerial);
+
+        if (mReleaseWhenIdle && mAllocator.Empty() && mBuffer.Get() != nullptr) {
+            mBuffer->Destroy();
+            mBuffer = nullptr;
+            mAllocator = RingBufferAllocator();
+            mReleaseWhenIdle = false;
+        }
+    }
+
+    void ScratchMemoryPool::ReleaseWhenIdle() {
+        mReleaseWhenIdle = true;
+    }
+
+    MaybeError ScratchMemoryPool::Grow(uint64_t minimumSize) {
+        uint64_t newSize = std::max(kInitialScratchMemorySize, NextPowerOfTwo(minimumSize));
+        newSize = std::max(newSize, mAllocator.GetSize() * 2);
+
+        BufferDescriptor descriptor = {};
+        descriptor.usage = wgpu::BufferUsage::RayTracing;
+        descriptor.size = newSize;
+
+        Buffer* buffer = nullptr;
+        DAWN_TRY_ASSIGN(buffer, Buffer::Create(mDevice, &descriptor));
+
+        // The FencedDeleter keeps the previous arena alive until the GPU is done with it.
+        if (mBuffer.Get() != nullptr) {
+            mBuffer->Destroy();
+        }
+
+        mBuffer = AcquireRef(buffer);
+        mAllocator = RingBufferAllocator(newSize);
+
+        return {};
+    }
+
+}}  // namespace dawn_native::vulkan
@@ -0,0 +1,65 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_SCRATCHMEMORYPOOL_H_
+#define DAWNNATIVE_VULKAN_SCRATCHMEMORYPOOL_H_
+
+#include "common/Serial.h"
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/RingBufferAllocator.h"
+#include "dawn_native/vulkan/BufferVk.h"
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    struct ScratchMemoryAllocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        uint64_t offset = 0;
+    };
+
+    // A device-level arena used as scratch memory for acceleration container builds and updates.
+    // Sub-allocations are made at record time and are reclaimed once the serial they were recorded
+    // for has completed, so the amount of scratch memory scales with the number of builds in
+    // flight rather than with the number of acceleration containers that exist.
+    class ScratchMemoryPool {
+      public:
+        ScratchMemoryPool(Device* device);
+        ~ScratchMemoryPool();
+
+        // Returns a range of at least |size| bytes that is valid for the pending serial.
+        ResultOrError<ScratchMemoryAllocation> Allocate(uint64_t size);
+        void Tick(Serial completedSerial);
+
+        // Releases the arena once all of its sub-allocations are reclaimed, unless it gets
+        // allocated from again before that. Used after builds that aren't expected to be
+        // followed by other builds, like the ones of containers created with BuildOnce.
+        void ReleaseWhenIdle();
+
+        static constexpr uint64_t kScratchMemoryAlignment = 256;
+
+      private:
+        MaybeError Grow(uint64_t minimumSize);
+
+        Device* mDevice;
+
+        Ref<Buffer> mBuffer;
+        RingBufferAllocator mAllocator;
+        bool mReleaseWhenIdle = false;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_SCRATCHMEMORYPOOL_H_
@@ -46,11 +46,14 @@ namespace dawn_native { namespace vulkan {
                 mSpvcContext.InitializeForVulkan(descriptor->code, descriptor->codeSize, options),
                 "Unable to initialize instance of spvc"));
 
-            spirv_cross::Compiler* compiler;
-            DAWN_TRY(CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
-                                      "Unable to get cross compiler"));
-            DAWN_TRY(ExtractSpirvInfo(*compiler));
-        } else {
+            if (!LoadSpirvInfoFromCache()) {
+                spirv_cross::Compiler* compiler;
+                DAWN_TRY(
+                    CheckSpvcSuccess(mSpvcContext.GetCompiler(reinterpret_cast<void**>(&compiler)),
+                                     "Unable to get cross compiler"));
+                DAWN_TRY(ExtractSpirvInfo(*compiler));
+            }
+        } else if (!LoadSpirvInfoFromCache()) {
             spirv_cross::Compiler compiler(descriptor->code, descriptor->codeSize);
             DAWN_TRY(ExtractSpirvInfo(compiler));
         }
@@ -0,0 +1,84 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/SparseTileMemory.h"
+
+#include "common/Assert.h"
+#include "common/Constants.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+
+namespace dawn_native { namespace vulkan {
+
+    SparseTileMemory::SparseTileMemory(Device* device, uint32_t memoryTypeBits, uint64_t alignment)
+        : mDevice(device) {
+        ASSERT(kSparseTileSize % alignment == 0);
+        mTileRequirements.size = kSparseTileSize;
+        mTileRequirements.alignment = alignment;
+        mTileRequirements.memoryTypeBits = memoryTypeBits;
+    }
+
+    SparseTileMemory::~SparseTileMemory() {
+        ASSERT(mTiles.empty());
+        ASSERT(mPendingAllocations.empty() && mPendingReleases.empty());
+    }
+
+    bool SparseTileMemory::IsResident(uint64_t key) const {
+        return mTiles.find(key) != mTiles.end();
+    }
+
+    ResultOrError<ResourceMemoryAllocation> SparseTileMemory::Allocate(uint64_t key) {
+        ASSERT(!IsResident(key));
+        ResourceMemoryAllocation allocation;
+        DAWN_TRY_ASSIGN(allocation, mDevice->AllocateMemory(mTileRequirements, false));
+        mPendingAllocations.emplace_back(key, allocation);
+        return allocation;
+    }
+
+    void SparseTileMemory::Release(uint64_t key) {
+        ASSERT(IsResident(key));
+        mPendingReleases.push_back(key);
+    }
+
+    void SparseTileMemory::Commit() {
+        // The bind was enqueued after the commands submitted so far, which are the last ones
+        // that can use the released memory.
+        for (uint64_t key : mPendingReleases) {
+            auto it = mTiles.find(key);
+            mDevice->DeallocateMemory(&it->second);
+            mTiles.erase(it);
+        }
+        for (auto& it : mPendingAllocations) {
+            mTiles.insert(it);
+        }
+        mPendingReleases.clear();
+        mPendingAllocations.clear();
+    }
+
+    void SparseTileMemory::Rollback() {
+        for (auto& it : mPendingAllocations) {
+            mDevice->DeallocateMemory(&it.second);
+        }
+        mPendingReleases.clear();
+        mPendingAllocations.clear();
+    }
+
+    void SparseTileMemory::ReleaseAll() {
+        Rollback();
+        for (auto& it : mTiles) {
+            mDevice->DeallocateMemory(&it.second);
+        }
+        mTiles.clear();
+    }
+
+}}  // namespace dawn_native::vulkan
@@ -0,0 +1,66 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_SPARSETILEMEMORY_H_
+#define DAWNNATIVE_VULKAN_SPARSETILEMEMORY_H_
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/ResourceMemoryAllocation.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // The memory bound to the resident tiles of a sparse buffer or image, identified by keys the
+    // resource computes from the position of the tiles. Each tile is sub-allocated on its own by
+    // the resource memory allocator, so that tiles can be released independently.
+    //
+    // Changes are staged until the bind using them has been enqueued: Commit() then releases the
+    // memory of the tiles that aren't resident anymore once the commands submitted so far have
+    // completed, and Rollback() undoes the changes when the bind couldn't be enqueued.
+    class SparseTileMemory {
+      public:
+        SparseTileMemory(Device* device, uint32_t memoryTypeBits, uint64_t alignment);
+        ~SparseTileMemory();
+
+        bool IsResident(uint64_t key) const;
+
+        // The tile must not be resident. Returns the memory to bind to the tile.
+        ResultOrError<ResourceMemoryAllocation> Allocate(uint64_t key);
+        // The tile must be resident.
+        void Release(uint64_t key);
+
+        void Commit();
+        void Rollback();
+
+        // Used when the resource is destroyed.
+        void ReleaseAll();
+
+      private:
+        Device* mDevice;
+        VkMemoryRequirements mTileRequirements;
+
+        std::map<uint64_t, ResourceMemoryAllocation> mTiles;
+        std::vector<std::pair<uint64_t, ResourceMemoryAllocation>> mPendingAllocations;
+        std::vector<uint64_t> mPendingReleases;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_SPARSETILEMEMORY_H_
@@ -15,6 +15,7 @@
 #include "dawn_native/vulkan/TextureVk.h"
 
 #include "common/Assert.h"
+#include "common/Constants.h"
 #include "common/Math.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/Error.h"
@@ -24,7 +25,10 @@
 #include "dawn_native/vulkan/CommandRecordingContext.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/FramebufferCache.h"
 #include "dawn_native/vulkan/ResourceHeapVk.h"
+#include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
+#include "dawn_native/vulkan/SparseTileMemory.h"
 #include "dawn_native/vulkan/StagingBufferVk.h"
 #include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
@@ -138,7 +142,9 @@ namespace dawn_native { namespace vulkan {
         }
 
         // Computes which Vulkan pipeline stage can access a texture in the given Dawn usage
-        VkPipelineStageFlags VulkanPipelineStage(wgpu::TextureUsage usage, const Format& format) {
+        VkPipelineStageFlags VulkanPipelineStage(wgpu::TextureUsage usage,
+                                                 const Format& format,
+                                                 VkPipelineStageFlags shaderStages) {
             VkPipelineStageFlags flags = 0;
 
             if (usage == wgpu::TextureUsage::None) {
@@ -150,10 +156,7 @@ namespace dawn_native { namespace vulkan {
                 flags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
             }
             if (usage & (wgpu::TextureUsage::Sampled | wgpu::TextureUsage::Storage)) {
-                flags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
-                         VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_NV;
+                flags |= shaderStages;
             }
             if (usage & wgpu::TextureUsage::OutputAttachment) {
                 if (format.HasDepthOrStencil()) {
@@ -201,6 +204,48 @@ namespace dawn_native { namespace vulkan {
             return {extent.width, extent.height, extent.depth};
         }
 
+        // Read-only usages don't need a barrier when the usage doesn't change.
+        bool CanSkipBarrier(wgpu::TextureUsage lastUsage, wgpu::TextureUsage usage) {
+            bool lastReadOnly = (lastUsage & kReadOnlyTextureUsages) == lastUsage;
+            return lastReadOnly && lastUsage == usage;
+        }
+
+        VkImageMemoryBarrier BuildMemoryBarrier(const Format& format,
+                                                VkImage image,
+                                                wgpu::TextureUsage lastUsage,
+                                                wgpu::TextureUsage usage,
+                                                uint32_t baseMipLevel,
+                                                uint32_t levelCount,
+                                                uint32_t baseArrayLayer,
+                                                uint32_t layerCount) {
+            VkImageMemoryBarrier barrier;
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.pNext = nullptr;
+            barrier.srcAccessMask = VulkanAccessFlags(lastUsage, format);
+            barrier.dstAccessMask = VulkanAccessFlags(usage, format);
+            barrier.oldLayout = VulkanImageLayout(lastUsage, format);
+            barrier.newLayout = VulkanImageLayout(usage, format);
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = VulkanAspectMask(format);
+            barrier.subresourceRange.baseMipLevel = baseMipLevel;
+            barrier.subresourceRange.levelCount = levelCount;
+            barrier.subresourceRange.baseArrayLayer = baseArrayLayer;
+            barrier.subresourceRange.layerCount = layerCount;
+
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            return barrier;
+        }
+
+        // The memory of transient textures may have been used by other transient resources until
+        // they were destroyed, so the first barrier of a transient texture waits for all the
+        // previous commands of the queue and their writes.
+        void AddTransientMemoryDependency(VkImageMemoryBarrier* barrier,
+                                          VkPipelineStageFlags* srcStages) {
+            barrier->srcAccessMask |= VK_ACCESS_MEMORY_WRITE_BIT;
+            *srcStages |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        }
+
     }  // namespace
 
     // Converts Dawn texture format to Vulkan formats.
@@ -354,6 +399,9 @@ namespace dawn_native { namespace vulkan {
                 flags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
             }
         }
+        if (usage & wgpu::TextureUsage::TransientAttachment) {
+            flags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        }
 
         return flags;
     }
@@ -457,18 +505,38 @@ namespace dawn_native { namespace vulkan {
 
         // We always set VK_IMAGE_USAGE_TRANSFER_DST_BIT unconditionally beause the Vulkan images
         // that are used in vkCmdClearColorImage() must have been created with this flag, which is
-        // also required for the implementation of robust resource initialization.
-        createInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        // also required for the implementation of robust resource initialization. Transient
+        // attachments can't have it, but they are always cleared by their render passes instead.
+        if (!IsTransientAttachment()) {
+            createInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+
+        if (IsSparse()) {
+            createInfo.flags |=
+                VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+        }
 
         DAWN_TRY(CheckVkSuccess(
             device->fn.CreateImage(device->GetVkDevice(), &createInfo, nullptr, &*mHandle),
             "CreateImage"));
 
         // Create the image memory and associate it with the container
-        VkMemoryRequirements requirements;
-        device->fn.GetImageMemoryRequirements(device->GetVkDevice(), mHandle, &requirements);
+        DedicatedAllocation dedicated;
+        VkMemoryRequirements requirements = device->GetImageMemoryRequirements(mHandle, &dedicated);
+
+        if (IsSparse()) {
+            return InitializeSparseTiles(requirements);
+        }
 
-        DAWN_TRY_ASSIGN(mMemoryAllocation, device->AllocateMemory(requirements, false));
+        if (IsTransientAttachment()) {
+            DAWN_TRY_ASSIGN(mMemoryAllocation, device->AllocateLazilyAllocatedMemory(requirements));
+        } else if (IsTransient()) {
+            DAWN_TRY_ASSIGN(mMemoryAllocation, device->AllocateTransientMemory(requirements));
+        } else {
+            DAWN_TRY_ASSIGN(mMemoryAllocation,
+                            device->AllocateMemory(requirements, false, false,
+                                                   GetResidencyPriority(), &dedicated));
+        }
 
         DAWN_TRY(CheckVkSuccess(
             device->fn.BindImageMemory(device->GetVkDevice(), mHandle,
@@ -476,7 +544,8 @@ namespace dawn_native { namespace vulkan {
                                        mMemoryAllocation.GetOffset()),
             "BindImageMemory"));
 
-        if (device->IsToggleEnabled(Toggle::NonzeroClearResourcesOnCreationForTesting)) {
+        if (device->IsToggleEnabled(Toggle::NonzeroClearResourcesOnCreationForTesting) &&
+            !IsTransientAttachment()) {
             DAWN_TRY(ClearTexture(ToBackend(GetDevice())->GetPendingRecordingContext(), 0,
                                   GetNumMipLevels(), 0, GetArrayLayers(),
                                   TextureBase::ClearValue::NonZero));
@@ -485,6 +554,98 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Texture::InitializeSparseTiles(const VkMemoryRequirements& requirements) {
+        Device* device = ToBackend(GetDevice());
+
+        // Sparse textures only have a color aspect. The tiles must have the block shape of Dawn,
+        // and the frontend makes sure that the mip levels are made of whole tiles.
+        uint32_t sparseRequirementCount = 1;
+        VkSparseImageMemoryRequirements sparseRequirements;
+        device->fn.GetImageSparseMemoryRequirements(device->GetVkDevice(), mHandle,
+                                                    &sparseRequirementCount, &sparseRequirements);
+
+        Extent3D tileExtent = GetSparseTileExtent(GetFormat());
+        const VkExtent3D& granularity = sparseRequirements.formatProperties.imageGranularity;
+        if (sparseRequirementCount != 1 || granularity.width != tileExtent.width ||
+            granularity.height != tileExtent.height ||
+            sparseRequirements.imageMipTailFirstLod < GetNumMipLevels() ||
+            kSparseTileSize % requirements.alignment != 0) {
+            return DAWN_VALIDATION_ERROR("The format doesn't support sparse textures");
+        }
+
+        mSparseTiles = std::make_unique<SparseTileMemory>(device, requirements.memoryTypeBits,
+                                                          requirements.alignment);
+        return {};
+    }
+
+    MaybeError Texture::UpdateTileMappings(uint32_t mipLevel,
+                                           uint32_t arrayLayer,
+                                           const Origin3D& firstTile,
+                                           const Extent3D& tileCount,
+                                           bool resident) {
+        ASSERT(mSparseTiles != nullptr);
+        Extent3D tileExtent = GetSparseTileExtent(GetFormat());
+
+        std::vector<VkSparseImageMemoryBind> binds;
+        for (uint32_t y = firstTile.y; y < firstTile.y + tileCount.height; ++y) {
+            for (uint32_t x = firstTile.x; x < firstTile.x + tileCount.width; ++x) {
+                uint64_t key = (uint64_t(arrayLayer) << 40) | (uint64_t(mipLevel) << 32) |
+                               (uint64_t(y) << 16) | x;
+                if (mSparseTiles->IsResident(key) == resident) {
+                    continue;
+                }
+
+                VkSparseImageMemoryBind bind;
+                bind.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                bind.subresource.mipLevel = mipLevel;
+                bind.subresource.arrayLayer = arrayLayer;
+                bind.offset = {static_cast<int32_t>(x * tileExtent.width),
+                               static_cast<int32_t>(y * tileExtent.height), 0};
+                bind.extent = {tileExtent.width, tileExtent.height, 1};
+                bind.memory = VK_NULL_HANDLE;
+                bind.memoryOffset = 0;
+                bind.flags = 0;
+
+                if (resident) {
+                    ResultOrError<ResourceMemoryAllocation> allocation =
+                        mSparseTiles->Allocate(key);
+                    if (allocation.IsError()) {
+                        mSparseTiles->Rollback();
+                        return allocation.AcquireError();
+                    }
+                    ResourceMemoryAllocation tileMemory = allocation.AcquireSuccess();
+                    bind.memory = ToBackend(tileMemory.GetResourceHeap())->GetMemory();
+                    bind.memoryOffset = tileMemory.GetOffset();
+                } else {
+                    mSparseTiles->Release(key);
+                }
+                binds.push_back(bind);
+            }
+        }
+
+        if (binds.empty()) {
+            return {};
+        }
+
+        VkSparseImageMemoryBindInfo imageBind;
+        imageBind.image = mHandle;
+        imageBind.bindCount = static_cast<uint32_t>(binds.size());
+        imageBind.pBinds = binds.data();
+
+        VkBindSparseInfo bindInfo = {};
+        bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+        bindInfo.imageBindCount = 1;
+        bindInfo.pImageBinds = &imageBind;
+
+        MaybeError result = ToBackend(GetDevice())->BindSparse(&bindInfo);
+        if (result.IsError()) {
+            mSparseTiles->Rollback();
+            return result;
+        }
+        mSparseTiles->Commit();
+        return {};
+    }
+
     // With this constructor, the lifetime of the resource is externally managed.
     Texture::Texture(Device* device, const TextureDescriptor* descriptor, VkImage nativeImage)
         : TextureBase(device, descriptor, TextureState::OwnedExternal), mHandle(nativeImage) {
@@ -526,7 +687,9 @@ namespace dawn_native { namespace vulkan {
     MaybeError Texture::BindExternalMemory(const ExternalImageDescriptor* descriptor,
                                            VkSemaphore signalSemaphore,
                                            VkDeviceMemory externalMemoryAllocation,
-                                           std::vector<VkSemaphore> waitSemaphores) {
+                                           std::vector<VkSemaphore> waitSemaphores,
+                                           VkSemaphore timelineSemaphore,
+                                           uint64_t waitTimelineValue) {
         Device* device = ToBackend(GetDevice());
         DAWN_TRY(CheckVkSuccess(
             device->fn.BindImageMemory(device->GetVkDevice(), mHandle, externalMemoryAllocation, 0),
@@ -541,12 +704,13 @@ namespace dawn_native { namespace vulkan {
         mExternalAllocation = externalMemoryAllocation;
         mSignalSemaphore = signalSemaphore;
         mWaitRequirements = std::move(waitSemaphores);
+        mTimelineSemaphore = timelineSemaphore;
+        mWaitTimelineValue = waitTimelineValue;
+        mWaitsForTimeline = timelineSemaphore != VK_NULL_HANDLE;
         return {};
     }
 
-    MaybeError Texture::SignalAndDestroy(VkSemaphore* outSignalSemaphore) {
-        Device* device = ToBackend(GetDevice());
-
+    MaybeError Texture::ReleaseToExternal() {
         if (mExternalState == ExternalState::Released) {
             return DAWN_VALIDATION_ERROR("Can't export signal semaphore from signaled texture");
         }
@@ -556,11 +720,22 @@ namespace dawn_native { namespace vulkan {
                 "Can't export signal semaphore from destroyed / non-external texture");
         }
 
-        ASSERT(mSignalSemaphore != VK_NULL_HANDLE);
-
         // Release the texture
         mExternalState = ExternalState::PendingRelease;
-        TransitionUsageNow(device->GetPendingRecordingContext(), wgpu::TextureUsage::None);
+        TransitionUsageNow(ToBackend(GetDevice())->GetPendingRecordingContext(),
+                           wgpu::TextureUsage::None);
+        return {};
+    }
+
+    MaybeError Texture::SignalAndDestroy(VkSemaphore* outSignalSemaphore) {
+        Device* device = ToBackend(GetDevice());
+
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            return DAWN_VALIDATION_ERROR(
+                "Textures wrapped with a timeline semaphore must be released with it");
+        }
+
+        DAWN_TRY(ReleaseToExternal());
 
         // Queue submit to signal we are done with the texture
         device->GetPendingRecordingContext()->signalSemaphores.push_back(mSignalSemaphore);
@@ -575,6 +750,30 @@ namespace dawn_native { namespace vulkan {
         return {};
     }
 
+    MaybeError Texture::SignalTimelineAndDestroy(uint64_t value) {
+        Device* device = ToBackend(GetDevice());
+
+        if (mExternalAllocation != VK_NULL_HANDLE && mTimelineSemaphore == VK_NULL_HANDLE) {
+            return DAWN_VALIDATION_ERROR("Texture wasn't wrapped with a timeline semaphore");
+        }
+        if (value <= mWaitTimelineValue) {
+            return DAWN_VALIDATION_ERROR("Timeline semaphore values must increase");
+        }
+
+        DAWN_TRY(ReleaseToExternal());
+
+        // Queue submit to signal we are done with the texture
+        CommandRecordingContext* recordingContext = device->GetPendingRecordingContext();
+        recordingContext->signalTimelineSemaphores.push_back(mTimelineSemaphore);
+        recordingContext->signalTimelineValues.push_back(value);
+        DAWN_TRY(device->SubmitPendingCommands());
+        mTimelineSemaphore = VK_NULL_HANDLE;
+
+        // Destroy the texture so it can't be used again
+        DestroyInternal();
+        return {};
+    }
+
     Texture::~Texture() {
         DestroyInternal();
     }
@@ -586,6 +785,9 @@ namespace dawn_native { namespace vulkan {
             // For textures created from a VkImage, the allocation if kInvalid so the Device knows
             // to skip the deallocation of the (absence of) VkDeviceMemory.
             device->DeallocateMemory(&mMemoryAllocation);
+            if (mSparseTiles != nullptr) {
+                mSparseTiles->ReleaseAll();
+            }
 
             if (mHandle != VK_NULL_HANDLE) {
                 device->GetFencedDeleter()->DeleteWhenUnused(mHandle);
@@ -612,35 +814,159 @@ namespace dawn_native { namespace vulkan {
 
     void Texture::TransitionUsageNow(CommandRecordingContext* recordingContext,
                                      wgpu::TextureUsage usage) {
+        TransitionUsageNow(recordingContext, usage, 0, GetNumMipLevels(), 0, GetArrayLayers());
+    }
+
+    void Texture::TransitionUsageNow(CommandRecordingContext* recordingContext,
+                                     wgpu::TextureUsage usage,
+                                     uint32_t baseMipLevel,
+                                     uint32_t levelCount,
+                                     uint32_t baseArrayLayer,
+                                     uint32_t layerCount) {
+        std::vector<VkImageMemoryBarrier> barriers;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+
+        TransitionUsageForPass(recordingContext, usage, baseMipLevel, levelCount, baseArrayLayer,
+                               layerCount, kAllShaderStages, &barriers, &srcStages, &dstStages);
+
+        if (!barriers.empty()) {
+            ASSERT(srcStages != 0 && dstStages != 0);
+            ToBackend(GetDevice())
+                ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
+                                        nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()),
+                                        barriers.data());
+        }
+    }
+
+    void Texture::TransitionUsageForPass(CommandRecordingContext* recordingContext,
+                                         wgpu::TextureUsage usage,
+                                         uint32_t baseMipLevel,
+                                         uint32_t levelCount,
+                                         uint32_t baseArrayLayer,
+                                         uint32_t layerCount,
+                                         VkPipelineStageFlags shaderStages,
+                                         std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                         VkPipelineStageFlags* srcStages,
+                                         VkPipelineStageFlags* dstStages) {
+        // This assumes it is a 2D texture
+        ASSERT(GetDimension() == wgpu::TextureDimension::e2D);
+
+        // Queue family ownership transfers always apply to the whole texture, so all its
+        // subresources are first brought to the same usage. These barriers have to be recorded
+        // now because barriers batched together aren't ordered with each other.
+        if (mExternalState != mLastExternalState) {
+            if (!mSameLastUsagesAcrossSubresources) {
+                std::vector<VkImageMemoryBarrier> unifyingBarriers;
+                VkPipelineStageFlags unifyingSrcStages = 0;
+                VkPipelineStageFlags unifyingDstStages = 0;
+                TransitionSubresourcesUsage(usage, 0, GetNumMipLevels(), 0, GetArrayLayers(),
+                                            shaderStages, &unifyingBarriers, &unifyingSrcStages,
+                                            &unifyingDstStages);
+                if (!unifyingBarriers.empty()) {
+                    ToBackend(GetDevice())
+                        ->fn.CmdPipelineBarrier(
+                            recordingContext->commandBuffer, unifyingSrcStages, unifyingDstStages,
+                            0, 0, nullptr, 0, nullptr,
+                            static_cast<uint32_t>(unifyingBarriers.size()),
+                            unifyingBarriers.data());
+                }
+            }
+            TransitionFullUsage(recordingContext, usage, shaderStages, imageBarriers, srcStages,
+                                dstStages);
+            return;
+        }
+
+        bool isFullRange = baseMipLevel == 0 && levelCount == GetNumMipLevels() &&
+                           baseArrayLayer == 0 && layerCount == GetArrayLayers();
+        if (mSameLastUsagesAcrossSubresources && isFullRange) {
+            TransitionFullUsage(recordingContext, usage, shaderStages, imageBarriers, srcStages,
+                                dstStages);
+            return;
+        }
+
+        TransitionSubresourcesUsage(usage, baseMipLevel, levelCount, baseArrayLayer, layerCount,
+                                    shaderStages, imageBarriers, srcStages, dstStages);
+    }
+
+    void Texture::TransitionSubresourcesUsage(wgpu::TextureUsage usage,
+                                              uint32_t baseMipLevel,
+                                              uint32_t levelCount,
+                                              uint32_t baseArrayLayer,
+                                              uint32_t layerCount,
+                                              VkPipelineStageFlags shaderStages,
+                                              std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                              VkPipelineStageFlags* srcStages,
+                                              VkPipelineStageFlags* dstStages) {
+        if (mSameLastUsagesAcrossSubresources) {
+            // Start tracking the usage of each subresource.
+            mSubresourceLastUsages.assign(GetNumMipLevels() * GetArrayLayers(), mLastUsage);
+            mSameLastUsagesAcrossSubresources = false;
+        }
+
+        const Format& format = GetFormat();
+
+        // Coalesce the barriers of the consecutive layers of a level which have the same usage.
+        for (uint32_t level = baseMipLevel; level < baseMipLevel + levelCount; ++level) {
+            uint32_t layer = baseArrayLayer;
+            while (layer < baseArrayLayer + layerCount) {
+                wgpu::TextureUsage lastUsage =
+                    mSubresourceLastUsages[GetSubresourceIndex(level, layer)];
+
+                uint32_t endLayer = layer + 1;
+                while (endLayer < baseArrayLayer + layerCount &&
+                       mSubresourceLastUsages[GetSubresourceIndex(level, endLayer)] == lastUsage) {
+                    mSubresourceLastUsages[GetSubresourceIndex(level, endLayer)] = usage;
+                    endLayer++;
+                }
+                mSubresourceLastUsages[GetSubresourceIndex(level, layer)] = usage;
+
+                if (!CanSkipBarrier(lastUsage, usage)) {
+                    imageBarriers->push_back(BuildMemoryBarrier(format, mHandle, lastUsage, usage,
+                                                                level, 1, layer, endLayer - layer));
+                    *srcStages |= VulkanPipelineStage(lastUsage, format, mLastShaderStages);
+                    *dstStages |= VulkanPipelineStage(usage, format, shaderStages);
+                    if (lastUsage == wgpu::TextureUsage::None && IsTransient()) {
+                        AddTransientMemoryDependency(&imageBarriers->back(), srcStages);
+                    }
+                }
+                layer = endLayer;
+            }
+        }
+        // the other subresources can still have been used from the previous stages
+        mLastShaderStages |= shaderStages;
+
+        // Go back to tracking the whole texture when all of it has been transitioned.
+        if (baseMipLevel == 0 && levelCount == GetNumMipLevels() && baseArrayLayer == 0 &&
+            layerCount == GetArrayLayers()) {
+            mSameLastUsagesAcrossSubresources = true;
+            mLastUsage = usage;
+        }
+    }
+
+    void Texture::TransitionFullUsage(CommandRecordingContext* recordingContext,
+                                      wgpu::TextureUsage usage,
+                                      VkPipelineStageFlags shaderStages,
+                                      std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                      VkPipelineStageFlags* srcStages,
+                                      VkPipelineStageFlags* dstStages) {
         // Avoid encoding barriers when it isn't needed.
-        bool lastReadOnly = (mLastUsage & kReadOnlyTextureUsages) == mLastUsage;
-        if (lastReadOnly && mLastUsage == usage && mLastExternalState == mExternalState) {
+        if (CanSkipBarrier(mLastUsage, usage) && mLastExternalState == mExternalState) {
+            mLastShaderStages |= shaderStages;
             return;
         }
 
         const Format& format = GetFormat();
 
-        VkPipelineStageFlags srcStages = VulkanPipelineStage(mLastUsage, format);
-        VkPipelineStageFlags dstStages = VulkanPipelineStage(usage, format);
-
-        VkImageMemoryBarrier barrier;
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.pNext = nullptr;
-        barrier.srcAccessMask = VulkanAccessFlags(mLastUsage, format);
-        barrier.dstAccessMask = VulkanAccessFlags(usage, format);
-        barrier.oldLayout = VulkanImageLayout(mLastUsage, format);
-        barrier.newLayout = VulkanImageLayout(usage, format);
-        barrier.image = mHandle;
-        // This transitions the whole resource but assumes it is a 2D texture
-        ASSERT(GetDimension() == wgpu::TextureDimension::e2D);
-        barrier.subresourceRange.aspectMask = VulkanAspectMask(format);
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = GetNumMipLevels();
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = GetArrayLayers();
+        *srcStages |= VulkanPipelineStage(mLastUsage, format, mLastShaderStages);
+        *dstStages |= VulkanPipelineStage(usage, format, shaderStages);
 
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        VkImageMemoryBarrier barrier =
+            BuildMemoryBarrier(format, mHandle, mLastUsage, usage, 0, GetNumMipLevels(), 0,
+                               GetArrayLayers());
+        if (mLastUsage == wgpu::TextureUsage::None && IsTransient()) {
+            AddTransientMemoryDependency(&barrier, srcStages);
+        }
 
         if (mExternalState == ExternalState::PendingAcquire) {
             // Transfer texture from external queue to graphics queue
@@ -662,12 +988,16 @@ namespace dawn_native { namespace vulkan {
         recordingContext->waitSemaphores.insert(recordingContext->waitSemaphores.end(),
                                                 mWaitRequirements.begin(), mWaitRequirements.end());
         mWaitRequirements.clear();
+        if (mWaitsForTimeline) {
+            recordingContext->waitTimelineSemaphores.push_back(mTimelineSemaphore);
+            recordingContext->waitTimelineValues.push_back(mWaitTimelineValue);
+            mWaitsForTimeline = false;
+        }
 
-        ToBackend(GetDevice())
-            ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
-                                    nullptr, 0, nullptr, 1, &barrier);
+        imageBarriers->push_back(barrier);
 
         mLastUsage = usage;
+        mLastShaderStages = shaderStages;
         mLastExternalState = mExternalState;
     }
 
@@ -687,7 +1017,8 @@ namespace dawn_native { namespace vulkan {
         uint8_t clearColor = (clearValue == TextureBase::ClearValue::Zero) ? 0 : 1;
         float fClearColor = (clearValue == TextureBase::ClearValue::Zero) ? 0.f : 1.f;
 
-        TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst);
+        TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst, baseMipLevel, levelCount,
+                           baseArrayLayer, layerCount);
         if (GetFormat().isRenderable) {
             if (GetFormat().HasDepthOrStencil()) {
                 VkClearDepthStencilValue clearDepthStencilValue[1];
@@ -815,6 +1146,10 @@ namespace dawn_native { namespace vulkan {
         Device* device = ToBackend(GetTexture()->GetDevice());
 
         if (mHandle != VK_NULL_HANDLE) {
+            // The framebuffer cache is gone once the device has been shut down.
+            if (FramebufferCache* framebufferCache = device->GetFramebufferCache()) {
+                framebufferCache->InvalidateView(mHandle);
+            }
             device->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
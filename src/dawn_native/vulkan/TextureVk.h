@@ -19,13 +19,17 @@
 
 #include "common/vulkan_platform.h"
 #include "dawn_native/ResourceMemoryAllocation.h"
+#include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/ExternalHandle.h"
 #include "dawn_native/vulkan/external_memory/MemoryService.h"
 
+#include <memory>
+
 namespace dawn_native { namespace vulkan {
 
     struct CommandRecordingContext;
     class Device;
+    class SparseTileMemory;
 
     VkFormat VulkanImageFormat(const Device* device, wgpu::TextureFormat format);
     VkImageUsageFlags VulkanImageUsage(wgpu::TextureUsage usage, const Format& format);
@@ -59,9 +63,28 @@ namespace dawn_native { namespace vulkan {
 
         // Transitions the texture to be used as `usage`, recording any necessary barrier in
         // `commands`.
-        // TODO(cwallez@chromium.org): coalesce barriers and do them early when possible.
         void TransitionUsageNow(CommandRecordingContext* recordingContext,
                                 wgpu::TextureUsage usage);
+        // Only transitions the subresources in the range, the others keep their usage.
+        void TransitionUsageNow(CommandRecordingContext* recordingContext,
+                                wgpu::TextureUsage usage,
+                                uint32_t baseMipLevel,
+                                uint32_t levelCount,
+                                uint32_t baseArrayLayer,
+                                uint32_t layerCount);
+        // Same as TransitionUsageNow, but appends the barriers to `imageBarriers` instead of
+        // recording them so that all the barriers of a pass are recorded together. The stages are
+        // or'ed into `srcStages` and `dstStages`. Shader usages are only for the `shaderStages`.
+        void TransitionUsageForPass(CommandRecordingContext* recordingContext,
+                                    wgpu::TextureUsage usage,
+                                    uint32_t baseMipLevel,
+                                    uint32_t levelCount,
+                                    uint32_t baseArrayLayer,
+                                    uint32_t layerCount,
+                                    VkPipelineStageFlags shaderStages,
+                                    std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                    VkPipelineStageFlags* srcStages,
+                                    VkPipelineStageFlags* dstStages);
         void EnsureSubresourceContentInitialized(CommandRecordingContext* recordingContext,
                                                  uint32_t baseMipLevel,
                                                  uint32_t levelCount,
@@ -69,21 +92,53 @@ namespace dawn_native { namespace vulkan {
                                                  uint32_t layerCount);
 
         MaybeError SignalAndDestroy(VkSemaphore* outSignalSemaphore);
+        // Same as SignalAndDestroy for textures wrapped with a timeline semaphore, which is
+        // signaled with |value|.
+        MaybeError SignalTimelineAndDestroy(uint64_t value);
         // Binds externally allocated memory to the VkImage and on success, takes ownership of
-        // semaphores.
+        // semaphores. With a |timelineSemaphore|, owned by the device, there is no
+        // |signalSemaphore|: the first use of the texture waits for the timeline semaphore to
+        // reach |waitTimelineValue| and the texture is released by signaling it.
         MaybeError BindExternalMemory(const ExternalImageDescriptor* descriptor,
                                       VkSemaphore signalSemaphore,
                                       VkDeviceMemory externalMemoryAllocation,
-                                      std::vector<VkSemaphore> waitSemaphores);
+                                      std::vector<VkSemaphore> waitSemaphores,
+                                      VkSemaphore timelineSemaphore,
+                                      uint64_t waitTimelineValue);
+
+        // Binds or releases the memory of a region of tiles of a subresource of sparse textures.
+        MaybeError UpdateTileMappings(uint32_t mipLevel,
+                                      uint32_t arrayLayer,
+                                      const Origin3D& firstTile,
+                                      const Extent3D& tileCount,
+                                      bool resident);
 
       private:
         using TextureBase::TextureBase;
         MaybeError InitializeAsInternalTexture();
+        MaybeError InitializeSparseTiles(const VkMemoryRequirements& requirements);
 
         MaybeError InitializeFromExternal(const ExternalImageDescriptor* descriptor,
                                           external_memory::Service* externalMemoryService);
+        // Transitions the texture to the external queue family in the pending commands.
+        MaybeError ReleaseToExternal();
 
         void DestroyImpl() override;
+        void TransitionFullUsage(CommandRecordingContext* recordingContext,
+                                 wgpu::TextureUsage usage,
+                                 VkPipelineStageFlags shaderStages,
+                                 std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                 VkPipelineStageFlags* srcStages,
+                                 VkPipelineStageFlags* dstStages);
+        void TransitionSubresourcesUsage(wgpu::TextureUsage usage,
+                                         uint32_t baseMipLevel,
+                                         uint32_t levelCount,
+                                         uint32_t baseArrayLayer,
+                                         uint32_t layerCount,
+                                         VkPipelineStageFlags shaderStages,
+                                         std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                         VkPipelineStageFlags* srcStages,
+                                         VkPipelineStageFlags* dstStages);
         MaybeError ClearTexture(CommandRecordingContext* recordingContext,
                                 uint32_t baseMipLevel,
                                 uint32_t levelCount,
@@ -95,6 +150,9 @@ namespace dawn_native { namespace vulkan {
         ResourceMemoryAllocation mMemoryAllocation;
         VkDeviceMemory mExternalAllocation = VK_NULL_HANDLE;
 
+        // Sparse textures only have the memory of their resident tiles.
+        std::unique_ptr<SparseTileMemory> mSparseTiles;
+
         enum class ExternalState {
             InternalOnly,
             PendingAcquire,
@@ -107,10 +165,23 @@ namespace dawn_native { namespace vulkan {
 
         VkSemaphore mSignalSemaphore = VK_NULL_HANDLE;
         std::vector<VkSemaphore> mWaitRequirements;
+        VkSemaphore mTimelineSemaphore = VK_NULL_HANDLE;
+        uint64_t mWaitTimelineValue = 0;
+        bool mWaitsForTimeline = false;
 
         // A usage of none will make sure the texture is transitioned before its first use as
         // required by the Vulkan spec.
         wgpu::TextureUsage mLastUsage = wgpu::TextureUsage::None;
+
+        // The usages of all the subresources are tracked with mLastUsage while they are the same.
+        // Once only part of the texture is transitioned, they are tracked per subresource, indexed
+        // by GetSubresourceIndex, until the whole texture is transitioned again.
+        bool mSameLastUsagesAcrossSubresources = true;
+        std::vector<wgpu::TextureUsage> mSubresourceLastUsages;
+        // The shader stages the shader usages of the last usages can be from, for all the
+        // subresources. Only replaced when the whole texture is transitioned, the transitions of
+        // subresources and the read-only usages that didn't need a barrier add their stages.
+        VkPipelineStageFlags mLastShaderStages = kAllShaderStages;
     };
 
     class TextureView : public TextureViewBase {
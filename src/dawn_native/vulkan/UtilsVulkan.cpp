@@ -74,6 +74,9 @@ namespace dawn_native { namespace vulkan {
         if (stages & wgpu::ShaderStage::RayIntersection) {
             flags |= VK_SHADER_STAGE_INTERSECTION_BIT_NV;
         }
+        if (stages & wgpu::ShaderStage::RayCallable) {
+            flags |= VK_SHADER_STAGE_CALLABLE_BIT_NV;
+        }
 
         return flags;
     }
@@ -108,6 +111,16 @@ namespace dawn_native { namespace vulkan {
                 return VK_FORMAT_R32G32_SFLOAT;
             case wgpu::VertexFormat::Float3:
                 return VK_FORMAT_R32G32B32_SFLOAT;
+            case wgpu::VertexFormat::Half2:
+                return VK_FORMAT_R16G16_SFLOAT;
+            // The builds only read the positions, so the fourth components are skipped by the
+            // stride.
+            case wgpu::VertexFormat::Half4:
+                return VK_FORMAT_R16G16B16_SFLOAT;
+            case wgpu::VertexFormat::Short2Norm:
+                return VK_FORMAT_R16G16_SNORM;
+            case wgpu::VertexFormat::Short4Norm:
+                return VK_FORMAT_R16G16B16_SNORM;
             default:
                 UNREACHABLE();
         }
@@ -154,6 +167,9 @@ namespace dawn_native { namespace vulkan {
         if (buildFlags & wgpu::RayTracingAccelerationContainerFlag::LowMemory) {
             flags |= VK_BUILD_ACCELERATION_STRUCTURE_LOW_MEMORY_BIT_NV;
         }
+        if (buildFlags & wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) {
+            flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_NV;
+        }
         return static_cast<VkBuildAccelerationStructureFlagBitsNV>(flags);
     }
 
@@ -22,8 +22,10 @@
 #include "dawn_native/VulkanBackend.h"
 
 #include "common/SwapChainUtils.h"
+#include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/NativeSwapChainImplVk.h"
+#include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
 #include "dawn_native/vulkan/TextureVk.h"
 
 namespace dawn_native { namespace vulkan {
@@ -43,11 +45,19 @@ namespace dawn_native { namespace vulkan {
     // header as seen in this file uses the wrapped type.
     DAWN_NATIVE_EXPORT DawnSwapChainImplementation
     CreateNativeSwapChainImpl(WGPUDevice device, ::VkSurfaceKHR surfaceNative) {
+        return CreateNativeSwapChainImpl(device, surfaceNative, NativeSwapChainOptions());
+    }
+
+    DAWN_NATIVE_EXPORT DawnSwapChainImplementation
+    CreateNativeSwapChainImpl(WGPUDevice device,
+                              ::VkSurfaceKHR surfaceNative,
+                              const NativeSwapChainOptions& options) {
         Device* backendDevice = reinterpret_cast<Device*>(device);
         VkSurfaceKHR surface = VkSurfaceKHR::CreateFromHandle(surfaceNative);
 
         DawnSwapChainImplementation impl;
-        impl = CreateSwapChainImplementation(new NativeSwapChainImpl(backendDevice, surface));
+        impl = CreateSwapChainImplementation(
+            new NativeSwapChainImpl(backendDevice, surface, options));
         impl.textureUsage = WGPUTextureUsage_Present;
 
         return impl;
@@ -59,6 +69,46 @@ namespace dawn_native { namespace vulkan {
         return static_cast<WGPUTextureFormat>(impl->GetPreferredFormat());
     }
 
+    NativeSwapChainFrameTimings GetNativeSwapChainFrameTimings(
+        const DawnSwapChainImplementation* swapChain) {
+        NativeSwapChainImpl* impl = reinterpret_cast<NativeSwapChainImpl*>(swapChain->userData);
+        return impl->GetFrameTimings();
+    }
+
+    std::vector<uint8_t> GetPipelineCacheData(WGPUDevice cDevice) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+
+        std::vector<uint8_t> data;
+        if (device->ConsumedError(device->GetPipelineCacheData(), &data)) {
+            return {};
+        }
+        return data;
+    }
+
+    bool LoadPipelineCacheData(WGPUDevice cDevice, const void* data, size_t size) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        return !device->ConsumedError(device->LoadPipelineCacheData(data, size));
+    }
+
+    std::vector<MemoryHeapBudget> GetMemoryHeapBudgets(WGPUDevice cDevice) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        const std::vector<VkMemoryHeap>& heaps = device->GetDeviceInfo().memoryHeaps;
+        std::vector<HeapBudget> budgets = device->GetMemoryHeapBudgets();
+
+        std::vector<MemoryHeapBudget> result(budgets.size());
+        for (size_t i = 0; i < budgets.size(); ++i) {
+            result[i].usage = budgets[i].usage;
+            result[i].budget = budgets[i].budget;
+            result[i].isDeviceLocal = (heaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+        return result;
+    }
+
+    float GetTimestampPeriod(WGPUDevice cDevice) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        return device->GetDeviceInfo().properties.limits.timestampPeriod;
+    }
+
 #ifdef DAWN_PLATFORM_LINUX
     ExternalImageDescriptorFD::ExternalImageDescriptorFD(ExternalImageDescriptorType type)
         : ExternalImageDescriptor(type) {
@@ -72,6 +122,18 @@ namespace dawn_native { namespace vulkan {
         : ExternalImageDescriptorFD(ExternalImageDescriptorType::DmaBuf) {
     }
 
+    ExternalBufferDescriptorFD::ExternalBufferDescriptorFD(ExternalImageDescriptorType type)
+        : ExternalBufferDescriptor(type) {
+    }
+
+    ExternalBufferDescriptorOpaqueFD::ExternalBufferDescriptorOpaqueFD()
+        : ExternalBufferDescriptorFD(ExternalImageDescriptorType::OpaqueFD) {
+    }
+
+    ExternalBufferDescriptorDmaBuf::ExternalBufferDescriptorDmaBuf()
+        : ExternalBufferDescriptorFD(ExternalImageDescriptorType::DmaBuf) {
+    }
+
     int ExportSignalSemaphoreOpaqueFD(WGPUDevice cDevice, WGPUTexture cTexture) {
         Device* device = reinterpret_cast<Device*>(cDevice);
         Texture* texture = reinterpret_cast<Texture*>(cTexture);
@@ -88,6 +150,61 @@ namespace dawn_native { namespace vulkan {
         return outHandle;
     }
 
+    bool SupportsTimelineSemaphoreOpaqueFD(WGPUDevice cDevice) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        return device->SupportsExternalTimelineSemaphores();
+    }
+
+    ::VkSemaphore ImportTimelineSemaphoreOpaqueFD(WGPUDevice cDevice, int fd) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        if (device->ConsumedError(device->ImportExternalTimelineSemaphore(fd), &semaphore)) {
+            return VK_NULL_HANDLE;
+        }
+        return semaphore.GetHandle();
+    }
+
+    ::VkSemaphore CreateExportableTimelineSemaphore(WGPUDevice cDevice, uint64_t initialValue) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        if (device->ConsumedError(device->CreateExportableTimelineSemaphore(initialValue),
+                                  &semaphore)) {
+            return VK_NULL_HANDLE;
+        }
+        return semaphore.GetHandle();
+    }
+
+    int ExportTimelineSemaphoreOpaqueFD(WGPUDevice cDevice, ::VkSemaphore semaphore) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+
+        ExternalSemaphoreHandle outHandle;
+        if (device->ConsumedError(device->ExportExternalTimelineSemaphore(
+                                      VkSemaphore::CreateFromHandle(semaphore)),
+                                  &outHandle)) {
+            return -1;
+        }
+        return outHandle;
+    }
+
+    void ReleaseTimelineSemaphore(WGPUDevice cDevice, ::VkSemaphore semaphore) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        device->ConsumedError(
+            device->ReleaseExternalTimelineSemaphore(VkSemaphore::CreateFromHandle(semaphore)));
+    }
+
+    bool SignalTimelineSemaphore(WGPUDevice cDevice, WGPUTexture cTexture, uint64_t value) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        Texture* texture = reinterpret_cast<Texture*>(cTexture);
+
+        if (!texture) {
+            return false;
+        }
+
+        return !device->ConsumedError(device->SignalExternalTextureTimeline(texture, value));
+    }
+
     WGPUTexture WrapVulkanImage(WGPUDevice cDevice, const ExternalImageDescriptor* descriptor) {
         Device* device = reinterpret_cast<Device*>(cDevice);
 
@@ -97,13 +214,48 @@ namespace dawn_native { namespace vulkan {
                 const ExternalImageDescriptorFD* fdDescriptor =
                     static_cast<const ExternalImageDescriptorFD*>(descriptor);
                 TextureBase* texture = device->CreateTextureWrappingVulkanImage(
-                    descriptor, fdDescriptor->memoryFD, fdDescriptor->waitFDs);
+                    descriptor, fdDescriptor->memoryFD, fdDescriptor->waitFDs,
+                    VkSemaphore::CreateFromHandle(fdDescriptor->timelineSemaphore),
+                    fdDescriptor->waitTimelineValue);
                 return reinterpret_cast<WGPUTexture>(texture);
             }
             default:
                 return nullptr;
         }
     }
+
+    int ExportBufferSignalSemaphoreOpaqueFD(WGPUDevice cDevice, WGPUBuffer cBuffer) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+        Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+
+        if (!buffer) {
+            return -1;
+        }
+
+        ExternalSemaphoreHandle outHandle;
+        if (device->ConsumedError(device->SignalAndExportExternalBuffer(buffer, &outHandle))) {
+            return -1;
+        }
+
+        return outHandle;
+    }
+
+    WGPUBuffer WrapVulkanBuffer(WGPUDevice cDevice, const ExternalBufferDescriptor* descriptor) {
+        Device* device = reinterpret_cast<Device*>(cDevice);
+
+        switch (descriptor->type) {
+            case ExternalImageDescriptorType::OpaqueFD:
+            case ExternalImageDescriptorType::DmaBuf: {
+                const ExternalBufferDescriptorFD* fdDescriptor =
+                    static_cast<const ExternalBufferDescriptorFD*>(descriptor);
+                BufferBase* buffer = device->CreateBufferWrappingVulkanBuffer(
+                    descriptor, fdDescriptor->memoryFD, fdDescriptor->waitFDs);
+                return reinterpret_cast<WGPUBuffer>(buffer);
+            }
+            default:
+                return nullptr;
+        }
+    }
 #endif
 
 }}  // namespace dawn_native::vulkan
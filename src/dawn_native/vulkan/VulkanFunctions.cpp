@@ -286,6 +286,36 @@ namespace dawn_native { namespace vulkan {
         }
 #endif
 
+        if (deviceInfo.timelineSemaphore) {
+            GET_DEVICE_PROC(GetSemaphoreCounterValueKHR);
+            GET_DEVICE_PROC(WaitSemaphoresKHR);
+        }
+
+        if (deviceInfo.descriptorUpdateTemplate) {
+            GET_DEVICE_PROC(CreateDescriptorUpdateTemplateKHR);
+            GET_DEVICE_PROC(DestroyDescriptorUpdateTemplateKHR);
+            GET_DEVICE_PROC(UpdateDescriptorSetWithTemplateKHR);
+        }
+
+        if (deviceInfo.pushDescriptor) {
+            GET_DEVICE_PROC(CmdPushDescriptorSetKHR);
+        }
+
+        if (deviceInfo.drawIndirectCount) {
+            GET_DEVICE_PROC(CmdDrawIndirectCountKHR);
+            GET_DEVICE_PROC(CmdDrawIndexedIndirectCountKHR);
+        }
+
+        if (deviceInfo.conditionalRendering) {
+            GET_DEVICE_PROC(CmdBeginConditionalRenderingEXT);
+            GET_DEVICE_PROC(CmdEndConditionalRenderingEXT);
+        }
+
+        if (deviceInfo.displayTiming) {
+            GET_DEVICE_PROC(GetRefreshCycleDurationGOOGLE);
+            GET_DEVICE_PROC(GetPastPresentationTimingGOOGLE);
+        }
+
         if (deviceInfo.swapchain) {
             GET_DEVICE_PROC(CreateSwapchainKHR);
             GET_DEVICE_PROC(DestroySwapchainKHR);
@@ -305,10 +335,12 @@ namespace dawn_native { namespace vulkan {
             GET_DEVICE_PROC(BindAccelerationStructureMemoryNV);
             GET_DEVICE_PROC(GetRayTracingShaderGroupHandlesNV);
             GET_DEVICE_PROC(GetAccelerationStructureMemoryRequirementsNV);
+            GET_DEVICE_PROC(CmdWriteAccelerationStructuresPropertiesNV);
         }
 
         if (deviceInfo.memoryRequirements2) {
-          
+            GET_DEVICE_PROC(GetBufferMemoryRequirements2KHR);
+            GET_DEVICE_PROC(GetImageMemoryRequirements2KHR);
         }
 
         return {};
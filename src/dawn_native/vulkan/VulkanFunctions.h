@@ -255,6 +255,34 @@ namespace dawn_native { namespace vulkan {
         PFN_vkGetMemoryFdKHR GetMemoryFdKHR = nullptr;
         PFN_vkGetMemoryFdPropertiesKHR GetMemoryFdPropertiesKHR = nullptr;
 
+        // VK_KHR_timeline_semaphore
+        PFN_vkGetSemaphoreCounterValueKHR GetSemaphoreCounterValueKHR = nullptr;
+        PFN_vkWaitSemaphoresKHR WaitSemaphoresKHR = nullptr;
+
+        // VK_KHR_descriptor_update_template
+        PFN_vkCreateDescriptorUpdateTemplateKHR CreateDescriptorUpdateTemplateKHR = nullptr;
+        PFN_vkDestroyDescriptorUpdateTemplateKHR DestroyDescriptorUpdateTemplateKHR = nullptr;
+        PFN_vkUpdateDescriptorSetWithTemplateKHR UpdateDescriptorSetWithTemplateKHR = nullptr;
+
+        // VK_KHR_get_memory_requirements2
+        PFN_vkGetBufferMemoryRequirements2KHR GetBufferMemoryRequirements2KHR = nullptr;
+        PFN_vkGetImageMemoryRequirements2KHR GetImageMemoryRequirements2KHR = nullptr;
+
+        // VK_KHR_push_descriptor
+        PFN_vkCmdPushDescriptorSetKHR CmdPushDescriptorSetKHR = nullptr;
+
+        // VK_KHR_draw_indirect_count
+        PFN_vkCmdDrawIndirectCountKHR CmdDrawIndirectCountKHR = nullptr;
+        PFN_vkCmdDrawIndexedIndirectCountKHR CmdDrawIndexedIndirectCountKHR = nullptr;
+
+        // VK_EXT_conditional_rendering
+        PFN_vkCmdBeginConditionalRenderingEXT CmdBeginConditionalRenderingEXT = nullptr;
+        PFN_vkCmdEndConditionalRenderingEXT CmdEndConditionalRenderingEXT = nullptr;
+
+        // VK_GOOGLE_display_timing
+        PFN_vkGetRefreshCycleDurationGOOGLE GetRefreshCycleDurationGOOGLE = nullptr;
+        PFN_vkGetPastPresentationTimingGOOGLE GetPastPresentationTimingGOOGLE = nullptr;
+
         // VK_KHR_external_semaphore_fd
         PFN_vkImportSemaphoreFdKHR ImportSemaphoreFdKHR = nullptr;
         PFN_vkGetSemaphoreFdKHR GetSemaphoreFdKHR = nullptr;
@@ -281,6 +309,7 @@ namespace dawn_native { namespace vulkan {
         PFN_vkBindAccelerationStructureMemoryNV BindAccelerationStructureMemoryNV = nullptr;
         PFN_vkGetRayTracingShaderGroupHandlesNV GetRayTracingShaderGroupHandlesNV = nullptr;
         PFN_vkGetAccelerationStructureMemoryRequirementsNV GetAccelerationStructureMemoryRequirementsNV = nullptr;
+        PFN_vkCmdWriteAccelerationStructuresPropertiesNV CmdWriteAccelerationStructuresPropertiesNV = nullptr;
 
     };
 
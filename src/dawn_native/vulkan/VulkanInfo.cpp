@@ -14,6 +14,7 @@
 
 #include "dawn_native/vulkan/VulkanInfo.h"
 
+#include "common/Constants.h"
 #include "common/Log.h"
 #include "dawn_native/vulkan/AdapterVk.h"
 #include "dawn_native/vulkan/BackendVk.h"
@@ -32,6 +33,22 @@ namespace dawn_native { namespace vulkan {
             return strncmp(extension.extensionName, name, VK_MAX_EXTENSION_NAME_SIZE) == 0;
         }
 
+        MaybeError EnumerateDeviceExtensions(VkPhysicalDevice physicalDevice,
+                                             const VulkanFunctions& vkFunctions,
+                                             std::vector<VkExtensionProperties>* extensions) {
+            uint32_t count = 0;
+            VkResult result = VkResult::WrapUnsafe(vkFunctions.EnumerateDeviceExtensionProperties(
+                physicalDevice, nullptr, &count, nullptr));
+            if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+                return DAWN_DEVICE_LOST_ERROR("vkEnumerateDeviceExtensionProperties");
+            }
+
+            extensions->resize(count);
+            return CheckVkSuccess(vkFunctions.EnumerateDeviceExtensionProperties(
+                                      physicalDevice, nullptr, &count, extensions->data()),
+                                  "vkEnumerateDeviceExtensionProperties");
+        }
+
         bool EnumerateInstanceExtensions(const char* layerName,
                                          const dawn_native::vulkan::VulkanFunctions& vkFunctions,
                                          std::vector<VkExtensionProperties>* extensions) {
@@ -81,7 +98,19 @@ namespace dawn_native { namespace vulkan {
     const char kExtensionNameFuchsiaImagePipeSurface[] = "VK_FUCHSIA_imagepipe_surface";
     const char kExtensionNameKhrMaintenance1[] = "VK_KHR_maintenance1";
     const char kExtensionNameNvRayTracing[] = "VK_NV_ray_tracing";
+    const char kExtensionNameKhrRayTracing[] = "VK_KHR_ray_tracing";
     const char kExtensionNameKhrGetMemoryRequirements2[] = "VK_KHR_get_memory_requirements2";
+    const char kExtensionNameKhrDedicatedAllocation[] = "VK_KHR_dedicated_allocation";
+    const char kExtensionNameExtMemoryBudget[] = "VK_EXT_memory_budget";
+    const char kExtensionNameExtMemoryPriority[] = "VK_EXT_memory_priority";
+    const char kExtensionNameKhrTimelineSemaphore[] = "VK_KHR_timeline_semaphore";
+    const char kExtensionNameKhrDescriptorUpdateTemplate[] = "VK_KHR_descriptor_update_template";
+    const char kExtensionNameKhrPushDescriptor[] = "VK_KHR_push_descriptor";
+    const char kExtensionNameKhrDrawIndirectCount[] = "VK_KHR_draw_indirect_count";
+    const char kExtensionNameExtConditionalRendering[] = "VK_EXT_conditional_rendering";
+    const char kExtensionNameKhrMaintenance3[] = "VK_KHR_maintenance3";
+    const char kExtensionNameExtDescriptorIndexing[] = "VK_EXT_descriptor_indexing";
+    const char kExtensionNameGoogleDisplayTiming[] = "VK_GOOGLE_display_timing";
 
     ResultOrError<VulkanGlobalInfo> GatherGlobalInfo(const Backend& backend) {
         VulkanGlobalInfo info = {};
@@ -224,6 +253,30 @@ namespace dawn_native { namespace vulkan {
         return physicalDevices;
     }
 
+    ResultOrError<VulkanDeviceInfo> GatherDeviceDiscoveryInfo(const Adapter& adapter) {
+        VulkanDeviceInfo info = {};
+        VkPhysicalDevice physicalDevice = adapter.GetPhysicalDevice();
+        const VulkanFunctions& vkFunctions = adapter.GetBackend()->GetFunctions();
+
+        vkFunctions.GetPhysicalDeviceProperties(physicalDevice, &info.properties);
+
+        // Maintenance1 was promoted to Vulkan 1.1, only look for the extension on Vulkan 1.0.
+        if (info.properties.apiVersion >= VK_MAKE_VERSION(1, 1, 0)) {
+            info.maintenance1 = true;
+        } else {
+            std::vector<VkExtensionProperties> extensions;
+            DAWN_TRY(EnumerateDeviceExtensions(physicalDevice, vkFunctions, &extensions));
+
+            for (const auto& extension : extensions) {
+                if (IsExtensionName(extension, kExtensionNameKhrMaintenance1)) {
+                    info.maintenance1 = true;
+                }
+            }
+        }
+
+        return info;
+    }
+
     ResultOrError<VulkanDeviceInfo> GatherDeviceInfo(const Adapter& adapter) {
         VulkanDeviceInfo info = {};
         VkPhysicalDevice physicalDevice = adapter.GetPhysicalDevice();
@@ -271,17 +324,7 @@ namespace dawn_native { namespace vulkan {
 
         // Gather the info about the device extensions
         {
-            uint32_t count = 0;
-            VkResult result = VkResult::WrapUnsafe(vkFunctions.EnumerateDeviceExtensionProperties(
-                physicalDevice, nullptr, &count, nullptr));
-            if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
-                return DAWN_DEVICE_LOST_ERROR("vkEnumerateDeviceExtensionProperties");
-            }
-
-            info.extensions.resize(count);
-            DAWN_TRY(CheckVkSuccess(vkFunctions.EnumerateDeviceExtensionProperties(
-                                        physicalDevice, nullptr, &count, info.extensions.data()),
-                                    "vkEnumerateDeviceExtensionProperties"));
+            DAWN_TRY(EnumerateDeviceExtensions(physicalDevice, vkFunctions, &info.extensions));
 
             for (const auto& extension : info.extensions) {
                 if (IsExtensionName(extension, kExtensionNameExtDebugMarker)) {
@@ -320,15 +363,52 @@ namespace dawn_native { namespace vulkan {
                 if (IsExtensionName(extension, kExtensionNameNvRayTracing)) {
                     info.rayTracingNV = true;
                 }
+                if (IsExtensionName(extension, kExtensionNameKhrRayTracing)) {
+                    info.rayTracingKHR = true;
+                }
                 if (IsExtensionName(extension, kExtensionNameKhrGetMemoryRequirements2)) {
                     info.memoryRequirements2 = true;
                 }
+                if (IsExtensionName(extension, kExtensionNameKhrDedicatedAllocation)) {
+                    info.dedicatedAllocation = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameExtMemoryBudget)) {
+                    info.memoryBudget = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameExtMemoryPriority)) {
+                    info.memoryPriority = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameKhrTimelineSemaphore)) {
+                    info.timelineSemaphore = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameKhrDescriptorUpdateTemplate)) {
+                    info.descriptorUpdateTemplate = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameKhrPushDescriptor)) {
+                    info.pushDescriptor = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameKhrDrawIndirectCount)) {
+                    info.drawIndirectCount = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameExtConditionalRendering)) {
+                    info.conditionalRendering = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameKhrMaintenance3)) {
+                    info.maintenance3 = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameExtDescriptorIndexing)) {
+                    info.descriptorIndexing = true;
+                }
+                if (IsExtensionName(extension, kExtensionNameGoogleDisplayTiming)) {
+                    info.displayTiming = true;
+                }
             }
         }
 
         // Mark the extensions promoted to Vulkan 1.1 as available.
         if (info.properties.apiVersion >= VK_MAKE_VERSION(1, 1, 0)) {
             info.maintenance1 = true;
+            info.maintenance3 = true;
         }
 
         // TODO(cwallez@chromium.org): gather info about formats
@@ -412,4 +492,52 @@ namespace dawn_native { namespace vulkan {
         return rayTracingProperties;
     }
 
+    bool SupportsResourceTables(const Adapter& adapter) {
+        const VulkanDeviceInfo& info = adapter.GetDeviceInfo();
+        const VulkanFunctions& vkFunctions = adapter.GetBackend()->GetFunctions();
+        if (!info.descriptorIndexing || !info.maintenance3 ||
+            vkFunctions.GetPhysicalDeviceFeatures2 == nullptr ||
+            vkFunctions.GetPhysicalDeviceProperties2 == nullptr) {
+            return false;
+        }
+
+        VkPhysicalDevice physicalDevice = adapter.GetPhysicalDevice();
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+        indexingFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2 features2 = {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &indexingFeatures;
+        vkFunctions.GetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = {};
+        indexingProperties.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties2 = {};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &indexingProperties;
+        vkFunctions.GetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+        // The slots of a table are updated while the descriptor set is bound, and may be empty.
+        if (indexingFeatures.runtimeDescriptorArray != VK_TRUE ||
+            indexingFeatures.descriptorBindingPartiallyBound != VK_TRUE ||
+            indexingFeatures.descriptorBindingUpdateUnusedWhilePending != VK_TRUE ||
+            indexingFeatures.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE ||
+            indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind != VK_TRUE ||
+            indexingFeatures.shaderSampledImageArrayNonUniformIndexing != VK_TRUE ||
+            indexingFeatures.shaderStorageBufferArrayNonUniformIndexing != VK_TRUE) {
+            return false;
+        }
+
+        return indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages >=
+                   kMaxResourceTableCapacity &&
+               indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers >=
+                   kMaxResourceTableCapacity &&
+               indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages >=
+                   kMaxResourceTableCapacity &&
+               indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers >=
+                   kMaxResourceTableCapacity;
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -54,7 +54,19 @@ namespace dawn_native { namespace vulkan {
     extern const char kExtensionNameFuchsiaImagePipeSurface[];
     extern const char kExtensionNameKhrMaintenance1[];
     extern const char kExtensionNameNvRayTracing[];
+    extern const char kExtensionNameKhrRayTracing[];
     extern const char kExtensionNameKhrGetMemoryRequirements2[];
+    extern const char kExtensionNameKhrDedicatedAllocation[];
+    extern const char kExtensionNameExtMemoryBudget[];
+    extern const char kExtensionNameExtMemoryPriority[];
+    extern const char kExtensionNameKhrTimelineSemaphore[];
+    extern const char kExtensionNameKhrDescriptorUpdateTemplate[];
+    extern const char kExtensionNameKhrPushDescriptor[];
+    extern const char kExtensionNameKhrDrawIndirectCount[];
+    extern const char kExtensionNameExtConditionalRendering[];
+    extern const char kExtensionNameKhrMaintenance3[];
+    extern const char kExtensionNameExtDescriptorIndexing[];
+    extern const char kExtensionNameGoogleDisplayTiming[];
 
     // Global information - gathered before the instance is created
     struct VulkanGlobalKnobs {
@@ -103,7 +115,19 @@ namespace dawn_native { namespace vulkan {
         bool swapchain = false;
         bool maintenance1 = false;
         bool rayTracingNV = false;
+        bool rayTracingKHR = false;
         bool memoryRequirements2 = false;
+        bool dedicatedAllocation = false;
+        bool memoryBudget = false;
+        bool memoryPriority = false;
+        bool timelineSemaphore = false;
+        bool descriptorUpdateTemplate = false;
+        bool pushDescriptor = false;
+        bool drawIndirectCount = false;
+        bool conditionalRendering = false;
+        bool maintenance3 = false;
+        bool descriptorIndexing = false;
+        bool displayTiming = false;
     };
 
     struct VulkanDeviceInfo : VulkanDeviceKnobs {
@@ -127,6 +151,8 @@ namespace dawn_native { namespace vulkan {
 
     ResultOrError<VulkanGlobalInfo> GatherGlobalInfo(const Backend& backend);
     ResultOrError<std::vector<VkPhysicalDevice>> GetPhysicalDevices(const Backend& backend);
+    // Only gathers the properties and maintenance1 support, which is enough to list the adapter.
+    ResultOrError<VulkanDeviceInfo> GatherDeviceDiscoveryInfo(const Adapter& adapter);
     ResultOrError<VulkanDeviceInfo> GatherDeviceInfo(const Adapter& adapter);
     MaybeError GatherSurfaceInfo(const Adapter& adapter,
                                  VkSurfaceKHR surface,
@@ -134,6 +160,10 @@ namespace dawn_native { namespace vulkan {
 
     VkPhysicalDeviceRayTracingPropertiesNV GetRayTracingProperties(const Adapter& adapter);
 
+    // Whether the descriptor indexing features and limits needed by the resource tables are
+    // supported.
+    bool SupportsResourceTables(const Adapter& adapter);
+
 }}  // namespace dawn_native::vulkan
 
 #endif  // DAWNNATIVE_VULKAN_VULKANINFO_H_
@@ -62,6 +62,24 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         ResultOrError<VkImage> CreateImage(const ExternalImageDescriptor* descriptor,
                                            const VkImageCreateInfo& baseCreateInfo);
 
+        // True if the device reports it supports importing external memory for buffers.
+        bool SupportsImportBufferMemory(VkBufferUsageFlags usage);
+
+        // Returns the parameters required for importing the memory of a buffer
+        ResultOrError<MemoryImportParams> GetBufferMemoryImportParams(
+            const ExternalBufferDescriptor* descriptor,
+            VkBuffer buffer);
+
+        // Given an external handle pointing to memory, import it into a VkDeviceMemory for
+        // the buffer
+        ResultOrError<VkDeviceMemory> ImportBufferMemory(ExternalMemoryHandle handle,
+                                                         const MemoryImportParams& importParams,
+                                                         VkBuffer buffer);
+
+        // Create a VkBuffer for the given handle type
+        ResultOrError<VkBuffer> CreateBuffer(const ExternalBufferDescriptor* descriptor,
+                                             const VkBufferCreateInfo& baseCreateInfo);
+
       private:
         Device* mDevice = nullptr;
 
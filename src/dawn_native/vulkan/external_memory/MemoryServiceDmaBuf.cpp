@@ -57,6 +57,67 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
             return DAWN_VALIDATION_ERROR("DRM format modifier not supported");
         }
 
+        ResultOrError<MemoryImportParams> GetDmaBufMemoryImportParams(
+            Device* device,
+            int memoryFD,
+            VkMemoryRequirements memoryRequirements) {
+            VkMemoryFdPropertiesKHR fdProperties;
+            fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+            fdProperties.pNext = nullptr;
+
+            // Get the valid memory types that the external memory can be imported as.
+            device->fn.GetMemoryFdPropertiesKHR(device->GetVkDevice(),
+                                                VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT,
+                                                memoryFD, &fdProperties);
+            // Choose the best memory type that satisfies both the resource's constraint and the
+            // import's constraint.
+            memoryRequirements.memoryTypeBits &= fdProperties.memoryTypeBits;
+            int memoryTypeIndex =
+                device->FindBestMemoryTypeIndex(memoryRequirements, false /** mappable */);
+            if (memoryTypeIndex == -1) {
+                return DAWN_VALIDATION_ERROR("Unable to find appropriate memory type for import");
+            }
+            MemoryImportParams params = {memoryRequirements.size,
+                                         static_cast<uint32_t>(memoryTypeIndex)};
+            return params;
+        }
+
+        // dma-bufs are imported in dedicated allocations for either |image| or |buffer|.
+        ResultOrError<VkDeviceMemory> ImportDmaBufMemory(Device* device,
+                                                         ExternalMemoryHandle handle,
+                                                         const MemoryImportParams& importParams,
+                                                         VkImage image,
+                                                         VkBuffer buffer) {
+            if (handle < 0) {
+                return DAWN_VALIDATION_ERROR("Trying to import memory with invalid handle");
+            }
+
+            VkMemoryDedicatedAllocateInfo memoryDedicatedAllocateInfo;
+            memoryDedicatedAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+            memoryDedicatedAllocateInfo.pNext = nullptr;
+            memoryDedicatedAllocateInfo.image = image;
+            memoryDedicatedAllocateInfo.buffer = buffer;
+
+            VkImportMemoryFdInfoKHR importMemoryFdInfo;
+            importMemoryFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+            importMemoryFdInfo.pNext = &memoryDedicatedAllocateInfo;
+            importMemoryFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+            importMemoryFdInfo.fd = handle;
+
+            VkMemoryAllocateInfo memoryAllocateInfo;
+            memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            memoryAllocateInfo.pNext = &importMemoryFdInfo;
+            memoryAllocateInfo.allocationSize = importParams.allocationSize;
+            memoryAllocateInfo.memoryTypeIndex = importParams.memoryTypeIndex;
+
+            VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
+            DAWN_TRY(CheckVkSuccess(device->fn.AllocateMemory(device->GetVkDevice(),
+                                                              &memoryAllocateInfo, nullptr,
+                                                              &*allocatedMemory),
+                                    "vkAllocateMemory"));
+            return allocatedMemory;
+        }
+
     }  // anonymous namespace
 
     Service::Service(Device* device) : mDevice(device) {
@@ -159,62 +220,19 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         }
         const ExternalImageDescriptorDmaBuf* dmaBufDescriptor =
             static_cast<const ExternalImageDescriptorDmaBuf*>(descriptor);
-        VkDevice device = mDevice->GetVkDevice();
 
         // Get the valid memory types for the VkImage.
         VkMemoryRequirements memoryRequirements;
-        mDevice->fn.GetImageMemoryRequirements(device, image, &memoryRequirements);
-
-        VkMemoryFdPropertiesKHR fdProperties;
-        fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
-        fdProperties.pNext = nullptr;
-
-        // Get the valid memory types that the external memory can be imported as.
-        mDevice->fn.GetMemoryFdPropertiesKHR(device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT,
-                                             dmaBufDescriptor->memoryFD, &fdProperties);
-        // Choose the best memory type that satisfies both the image's constraint and the import's
-        // constraint.
-        memoryRequirements.memoryTypeBits &= fdProperties.memoryTypeBits;
-        int memoryTypeIndex =
-            mDevice->FindBestMemoryTypeIndex(memoryRequirements, false /** mappable */);
-        if (memoryTypeIndex == -1) {
-            return DAWN_VALIDATION_ERROR("Unable to find appropriate memory type for import");
-        }
-        MemoryImportParams params = {memoryRequirements.size, memoryTypeIndex};
-        return params;
+        mDevice->fn.GetImageMemoryRequirements(mDevice->GetVkDevice(), image, &memoryRequirements);
+
+        return GetDmaBufMemoryImportParams(mDevice, dmaBufDescriptor->memoryFD,
+                                           memoryRequirements);
     }
 
     ResultOrError<VkDeviceMemory> Service::ImportMemory(ExternalMemoryHandle handle,
                                                         const MemoryImportParams& importParams,
                                                         VkImage image) {
-        if (handle < 0) {
-            return DAWN_VALIDATION_ERROR("Trying to import memory with invalid handle");
-        }
-
-        VkMemoryDedicatedAllocateInfo memoryDedicatedAllocateInfo;
-        memoryDedicatedAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
-        memoryDedicatedAllocateInfo.pNext = nullptr;
-        memoryDedicatedAllocateInfo.image = image;
-        memoryDedicatedAllocateInfo.buffer = VkBuffer{};
-
-        VkImportMemoryFdInfoKHR importMemoryFdInfo;
-        importMemoryFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
-        importMemoryFdInfo.pNext = &memoryDedicatedAllocateInfo;
-        importMemoryFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT,
-        importMemoryFdInfo.fd = handle;
-
-        VkMemoryAllocateInfo memoryAllocateInfo;
-        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        memoryAllocateInfo.pNext = &importMemoryFdInfo;
-        memoryAllocateInfo.allocationSize = importParams.allocationSize;
-        memoryAllocateInfo.memoryTypeIndex = importParams.memoryTypeIndex;
-
-        VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
-        DAWN_TRY(
-            CheckVkSuccess(mDevice->fn.AllocateMemory(mDevice->GetVkDevice(), &memoryAllocateInfo,
-                                                      nullptr, &*allocatedMemory),
-                           "vkAllocateMemory"));
-        return allocatedMemory;
+        return ImportDmaBufMemory(mDevice, handle, importParams, image, VkBuffer{});
     }
 
     ResultOrError<VkImage> Service::CreateImage(const ExternalImageDescriptor* descriptor,
@@ -228,9 +246,10 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         VkDevice device = mDevice->GetVkDevice();
 
         // Dawn currently doesn't support multi-plane formats, so we only need to create a single
-        // VkSubresourceLayout here.
+        // VkSubresourceLayout here. The planes of multi-planar buffers are imported as separate
+        // single-plane images starting at the offset of their plane.
         VkSubresourceLayout planeLayout;
-        planeLayout.offset = 0;
+        planeLayout.offset = dmaBufDescriptor->planeOffset;
         planeLayout.size = 0;  // VK_EXT_image_drm_format_modifier mandates size = 0.
         planeLayout.rowPitch = dmaBufDescriptor->stride;
         planeLayout.arrayPitch = 0;  // Not an array texture
@@ -268,4 +287,78 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         return image;
     }
 
+    bool Service::SupportsImportBufferMemory(VkBufferUsageFlags usage) {
+        // Buffers don't need VK_EXT_image_drm_format_modifier, so mSupported isn't used.
+        const VulkanDeviceInfo& deviceInfo = mDevice->GetDeviceInfo();
+        const VulkanGlobalInfo& globalInfo =
+            ToBackend(mDevice->GetAdapter())->GetBackend()->GetGlobalInfo();
+        if (!globalInfo.getPhysicalDeviceProperties2 || !globalInfo.externalMemoryCapabilities ||
+            !deviceInfo.externalMemory || !deviceInfo.externalMemoryFD ||
+            !deviceInfo.externalMemoryDmaBuf) {
+            return false;
+        }
+
+        VkPhysicalDeviceExternalBufferInfo bufferInfo;
+        bufferInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_BUFFER_INFO_KHR;
+        bufferInfo.pNext = nullptr;
+        bufferInfo.flags = 0;
+        bufferInfo.usage = usage;
+        bufferInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+
+        VkExternalBufferProperties bufferProperties;
+        bufferProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_BUFFER_PROPERTIES_KHR;
+        bufferProperties.pNext = nullptr;
+
+        mDevice->fn.GetPhysicalDeviceExternalBufferProperties(
+            ToBackend(mDevice->GetAdapter())->GetPhysicalDevice(), &bufferInfo, &bufferProperties);
+
+        VkFlags memoryFlags = bufferProperties.externalMemoryProperties.externalMemoryFeatures;
+        return (memoryFlags & VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT_KHR) != 0;
+    }
+
+    ResultOrError<MemoryImportParams> Service::GetBufferMemoryImportParams(
+        const ExternalBufferDescriptor* descriptor,
+        VkBuffer buffer) {
+        if (descriptor->type != ExternalImageDescriptorType::DmaBuf) {
+            return DAWN_VALIDATION_ERROR("ExternalBufferDescriptor is not a dma-buf descriptor");
+        }
+        const ExternalBufferDescriptorDmaBuf* dmaBufDescriptor =
+            static_cast<const ExternalBufferDescriptorDmaBuf*>(descriptor);
+
+        VkMemoryRequirements memoryRequirements;
+        mDevice->fn.GetBufferMemoryRequirements(mDevice->GetVkDevice(), buffer,
+                                                &memoryRequirements);
+
+        return GetDmaBufMemoryImportParams(mDevice, dmaBufDescriptor->memoryFD,
+                                           memoryRequirements);
+    }
+
+    ResultOrError<VkDeviceMemory> Service::ImportBufferMemory(
+        ExternalMemoryHandle handle,
+        const MemoryImportParams& importParams,
+        VkBuffer buffer) {
+        return ImportDmaBufMemory(mDevice, handle, importParams, VkImage{}, buffer);
+    }
+
+    ResultOrError<VkBuffer> Service::CreateBuffer(const ExternalBufferDescriptor* descriptor,
+                                                  const VkBufferCreateInfo& baseCreateInfo) {
+        if (descriptor->type != ExternalImageDescriptorType::DmaBuf) {
+            return DAWN_VALIDATION_ERROR("ExternalBufferDescriptor is not a dma-buf descriptor");
+        }
+
+        VkExternalMemoryBufferCreateInfo externalMemoryBufferCreateInfo;
+        externalMemoryBufferCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+        externalMemoryBufferCreateInfo.pNext = nullptr;
+        externalMemoryBufferCreateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+
+        VkBufferCreateInfo createInfo = baseCreateInfo;
+        createInfo.pNext = &externalMemoryBufferCreateInfo;
+
+        VkBuffer buffer;
+        DAWN_TRY(CheckVkSuccess(
+            mDevice->fn.CreateBuffer(mDevice->GetVkDevice(), &createInfo, nullptr, &*buffer),
+            "CreateBuffer"));
+        return buffer;
+    }
+
 }}}  // namespace dawn_native::vulkan::external_memory
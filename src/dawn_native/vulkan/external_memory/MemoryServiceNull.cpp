@@ -55,4 +55,26 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         return DAWN_UNIMPLEMENTED_ERROR("Using null memory service to interop inside Vulkan");
     }
 
+    bool Service::SupportsImportBufferMemory(VkBufferUsageFlags usage) {
+        return false;
+    }
+
+    ResultOrError<MemoryImportParams> Service::GetBufferMemoryImportParams(
+        const ExternalBufferDescriptor* descriptor,
+        VkBuffer buffer) {
+        return DAWN_UNIMPLEMENTED_ERROR("Using null memory service to interop inside Vulkan");
+    }
+
+    ResultOrError<VkDeviceMemory> Service::ImportBufferMemory(
+        ExternalMemoryHandle handle,
+        const MemoryImportParams& importParams,
+        VkBuffer buffer) {
+        return DAWN_UNIMPLEMENTED_ERROR("Using null memory service to interop inside Vulkan");
+    }
+
+    ResultOrError<VkBuffer> Service::CreateBuffer(const ExternalBufferDescriptor* descriptor,
+                                                  const VkBufferCreateInfo& baseCreateInfo) {
+        return DAWN_UNIMPLEMENTED_ERROR("Using null memory service to interop inside Vulkan");
+    }
+
 }}}  // namespace dawn_native::vulkan::external_memory
@@ -22,6 +22,32 @@
 
 namespace dawn_native { namespace vulkan { namespace external_memory {
 
+    namespace {
+
+        ResultOrError<VkDeviceMemory> ImportMemoryFD(Device* device,
+                                                     ExternalMemoryHandle handle,
+                                                     const MemoryImportParams& importParams) {
+            VkImportMemoryFdInfoKHR importMemoryFdInfo;
+            importMemoryFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+            importMemoryFdInfo.pNext = nullptr;
+            importMemoryFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+            importMemoryFdInfo.fd = handle;
+
+            VkMemoryAllocateInfo allocateInfo;
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.pNext = &importMemoryFdInfo;
+            allocateInfo.allocationSize = importParams.allocationSize;
+            allocateInfo.memoryTypeIndex = importParams.memoryTypeIndex;
+
+            VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
+            DAWN_TRY(CheckVkSuccess(device->fn.AllocateMemory(device->GetVkDevice(), &allocateInfo,
+                                                              nullptr, &*allocatedMemory),
+                                    "vkAllocateMemory"));
+            return allocatedMemory;
+        }
+
+    }  // anonymous namespace
+
     Service::Service(Device* device) : mDevice(device) {
         const VulkanDeviceInfo& deviceInfo = mDevice->GetDeviceInfo();
         const VulkanGlobalInfo& globalInfo =
@@ -114,23 +140,7 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
             return DAWN_VALIDATION_ERROR("Requested allocation size is too small for image");
         }
 
-        VkImportMemoryFdInfoKHR importMemoryFdInfo;
-        importMemoryFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
-        importMemoryFdInfo.pNext = nullptr;
-        importMemoryFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-        importMemoryFdInfo.fd = handle;
-
-        VkMemoryAllocateInfo allocateInfo;
-        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocateInfo.pNext = &importMemoryFdInfo;
-        allocateInfo.allocationSize = importParams.allocationSize;
-        allocateInfo.memoryTypeIndex = importParams.memoryTypeIndex;
-
-        VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
-        DAWN_TRY(CheckVkSuccess(mDevice->fn.AllocateMemory(mDevice->GetVkDevice(), &allocateInfo,
-                                                           nullptr, &*allocatedMemory),
-                                "vkAllocateMemory"));
-        return allocatedMemory;
+        return ImportMemoryFD(mDevice, handle, importParams);
     }
 
     ResultOrError<VkImage> Service::CreateImage(const ExternalImageDescriptor* descriptor,
@@ -149,4 +159,81 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         return image;
     }
 
+    bool Service::SupportsImportBufferMemory(VkBufferUsageFlags usage) {
+        // Early out before we try using extension functions
+        if (!mSupported) {
+            return false;
+        }
+
+        VkPhysicalDeviceExternalBufferInfo bufferInfo;
+        bufferInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_BUFFER_INFO_KHR;
+        bufferInfo.pNext = nullptr;
+        bufferInfo.flags = 0;
+        bufferInfo.usage = usage;
+        bufferInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+        VkExternalBufferProperties bufferProperties;
+        bufferProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_BUFFER_PROPERTIES_KHR;
+        bufferProperties.pNext = nullptr;
+
+        mDevice->fn.GetPhysicalDeviceExternalBufferProperties(
+            ToBackend(mDevice->GetAdapter())->GetPhysicalDevice(), &bufferInfo, &bufferProperties);
+
+        // Like for images, the memory is imported without a dedicated allocation.
+        VkFlags memoryFlags = bufferProperties.externalMemoryProperties.externalMemoryFeatures;
+        return (memoryFlags & VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT_KHR) &&
+               !(memoryFlags & VK_EXTERNAL_MEMORY_FEATURE_DEDICATED_ONLY_BIT_KHR);
+    }
+
+    ResultOrError<MemoryImportParams> Service::GetBufferMemoryImportParams(
+        const ExternalBufferDescriptor* descriptor,
+        VkBuffer buffer) {
+        if (descriptor->type != ExternalImageDescriptorType::OpaqueFD) {
+            return DAWN_VALIDATION_ERROR("ExternalBufferDescriptor is not an OpaqueFD descriptor");
+        }
+        const ExternalBufferDescriptorOpaqueFD* opaqueFDDescriptor =
+            static_cast<const ExternalBufferDescriptorOpaqueFD*>(descriptor);
+
+        MemoryImportParams params = {opaqueFDDescriptor->allocationSize,
+                                     opaqueFDDescriptor->memoryTypeIndex};
+        return params;
+    }
+
+    ResultOrError<VkDeviceMemory> Service::ImportBufferMemory(
+        ExternalMemoryHandle handle,
+        const MemoryImportParams& importParams,
+        VkBuffer buffer) {
+        if (handle < 0) {
+            return DAWN_VALIDATION_ERROR("Trying to import memory with invalid handle");
+        }
+
+        VkMemoryRequirements requirements;
+        mDevice->fn.GetBufferMemoryRequirements(mDevice->GetVkDevice(), buffer, &requirements);
+        if (requirements.size > importParams.allocationSize) {
+            return DAWN_VALIDATION_ERROR("Requested allocation size is too small for buffer");
+        }
+        if ((requirements.memoryTypeBits & (1u << importParams.memoryTypeIndex)) == 0) {
+            return DAWN_VALIDATION_ERROR("Requested memory type can't be used for buffer");
+        }
+
+        return ImportMemoryFD(mDevice, handle, importParams);
+    }
+
+    ResultOrError<VkBuffer> Service::CreateBuffer(const ExternalBufferDescriptor* descriptor,
+                                                  const VkBufferCreateInfo& baseCreateInfo) {
+        VkExternalMemoryBufferCreateInfo externalInfo;
+        externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO_KHR;
+        externalInfo.pNext = nullptr;
+        externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+        VkBufferCreateInfo createInfo = baseCreateInfo;
+        createInfo.pNext = &externalInfo;
+
+        VkBuffer buffer;
+        DAWN_TRY(CheckVkSuccess(
+            mDevice->fn.CreateBuffer(mDevice->GetVkDevice(), &createInfo, nullptr, &*buffer),
+            "CreateBuffer"));
+        return buffer;
+    }
+
 }}}  // namespace dawn_native::vulkan::external_memory
@@ -151,4 +151,26 @@ namespace dawn_native { namespace vulkan { namespace external_memory {
         return image;
     }
 
+    bool Service::SupportsImportBufferMemory(VkBufferUsageFlags usage) {
+        return false;
+    }
+
+    ResultOrError<MemoryImportParams> Service::GetBufferMemoryImportParams(
+        const ExternalBufferDescriptor* descriptor,
+        VkBuffer buffer) {
+        return DAWN_UNIMPLEMENTED_ERROR("Importing buffers from Zircon handles");
+    }
+
+    ResultOrError<VkDeviceMemory> Service::ImportBufferMemory(
+        ExternalMemoryHandle handle,
+        const MemoryImportParams& importParams,
+        VkBuffer buffer) {
+        return DAWN_UNIMPLEMENTED_ERROR("Importing buffers from Zircon handles");
+    }
+
+    ResultOrError<VkBuffer> Service::CreateBuffer(const ExternalBufferDescriptor* descriptor,
+                                                  const VkBufferCreateInfo& baseCreateInfo) {
+        return DAWN_UNIMPLEMENTED_ERROR("Importing buffers from Zircon handles");
+    }
+
 }}}  // namespace dawn_native::vulkan::external_memory
@@ -42,11 +42,23 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
         // Export a VkSemaphore into an external handle
         ResultOrError<ExternalSemaphoreHandle> ExportSemaphore(VkSemaphore semaphore);
 
+        // True if timeline semaphores can be imported and exported too. A timeline semaphore is
+        // signaled and waited on with increasing values, so the same one can be used for all the
+        // frames instead of exporting a new binary semaphore for each of them.
+        bool SupportsTimeline();
+
+        // Given an external handle of a timeline semaphore, import it into a VkSemaphore
+        ResultOrError<VkSemaphore> ImportTimelineSemaphore(ExternalSemaphoreHandle handle);
+
+        // Create a timeline VkSemaphore that is exportable into an external handle later
+        ResultOrError<VkSemaphore> CreateExportableTimelineSemaphore(uint64_t initialValue);
+
       private:
         Device* mDevice = nullptr;
 
         // True if early checks pass that determine if the service is supported
         bool mSupported = false;
+        bool mSupportsTimeline = false;
     };
 
 }}}  // namespace dawn_native::vulkan::external_semaphore
@@ -20,6 +20,7 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
     Service::Service(Device* device) : mDevice(device) {
         DAWN_UNUSED(mDevice);
         DAWN_UNUSED(mSupported);
+        DAWN_UNUSED(mSupportsTimeline);
     }
 
     Service::~Service() = default;
@@ -40,4 +41,16 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
         return DAWN_UNIMPLEMENTED_ERROR("Using null semaphore service to interop inside Vulkan");
     }
 
+    bool Service::SupportsTimeline() {
+        return false;
+    }
+
+    ResultOrError<VkSemaphore> Service::ImportTimelineSemaphore(ExternalSemaphoreHandle handle) {
+        return DAWN_UNIMPLEMENTED_ERROR("Using null semaphore service to interop inside Vulkan");
+    }
+
+    ResultOrError<VkSemaphore> Service::CreateExportableTimelineSemaphore(uint64_t initialValue) {
+        return DAWN_UNIMPLEMENTED_ERROR("Using null semaphore service to interop inside Vulkan");
+    }
+
 }}}  // namespace dawn_native::vulkan::external_semaphore
@@ -20,6 +20,71 @@
 
 namespace dawn_native { namespace vulkan { namespace external_semaphore {
 
+    namespace {
+
+        // |typeInfo| is null for binary semaphores.
+        ResultOrError<VkSemaphore> ImportSemaphoreImpl(
+            Device* device,
+            ExternalSemaphoreHandle handle,
+            const VkSemaphoreTypeCreateInfoKHR* typeInfo) {
+            if (handle < 0) {
+                return DAWN_VALIDATION_ERROR("Trying to import semaphore with invalid handle");
+            }
+
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            VkSemaphoreCreateInfo info;
+            info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            info.pNext = typeInfo;
+            info.flags = 0;
+
+            DAWN_TRY(CheckVkSuccess(
+                device->fn.CreateSemaphore(device->GetVkDevice(), &info, nullptr, &*semaphore),
+                "vkCreateSemaphore"));
+
+            VkImportSemaphoreFdInfoKHR importSemaphoreFdInfo;
+            importSemaphoreFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
+            importSemaphoreFdInfo.pNext = nullptr;
+            importSemaphoreFdInfo.semaphore = semaphore;
+            importSemaphoreFdInfo.flags = 0;
+            importSemaphoreFdInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+            importSemaphoreFdInfo.fd = handle;
+
+            MaybeError status = CheckVkSuccess(
+                device->fn.ImportSemaphoreFdKHR(device->GetVkDevice(), &importSemaphoreFdInfo),
+                "vkImportSemaphoreFdKHR");
+
+            if (status.IsError()) {
+                device->fn.DestroySemaphore(device->GetVkDevice(), semaphore, nullptr);
+                DAWN_TRY(std::move(status));
+            }
+
+            return semaphore;
+        }
+
+        // |typeInfo| is null for binary semaphores.
+        ResultOrError<VkSemaphore> CreateExportableSemaphoreImpl(
+            Device* device,
+            const VkSemaphoreTypeCreateInfoKHR* typeInfo) {
+            VkExportSemaphoreCreateInfoKHR exportSemaphoreInfo;
+            exportSemaphoreInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR;
+            exportSemaphoreInfo.pNext = typeInfo;
+            exportSemaphoreInfo.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+            VkSemaphoreCreateInfo semaphoreCreateInfo;
+            semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphoreCreateInfo.pNext = &exportSemaphoreInfo;
+            semaphoreCreateInfo.flags = 0;
+
+            VkSemaphore signalSemaphore;
+            DAWN_TRY(CheckVkSuccess(device->fn.CreateSemaphore(device->GetVkDevice(),
+                                                               &semaphoreCreateInfo, nullptr,
+                                                               &*signalSemaphore),
+                                    "vkCreateSemaphore"));
+            return signalSemaphore;
+        }
+
+    }  // anonymous namespace
+
     Service::Service(Device* device) : mDevice(device) {
         const VulkanDeviceInfo& deviceInfo = mDevice->GetDeviceInfo();
         const VulkanGlobalInfo& globalInfo =
@@ -52,6 +117,27 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
         mSupported =
             mSupported &&
             ((semaphoreProperties.externalSemaphoreFeatures & requiredFlags) == requiredFlags);
+
+        // Timeline semaphores need the device's timeline semaphore support, and their external
+        // capabilities are queried separately from those of binary semaphores.
+        if (!mSupported || !deviceInfo.timelineSemaphore) {
+            return;
+        }
+
+        VkSemaphoreTypeCreateInfoKHR semaphoreTypeInfo;
+        semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        semaphoreTypeInfo.pNext = nullptr;
+        semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        semaphoreTypeInfo.initialValue = 0;
+        semaphoreInfo.pNext = &semaphoreTypeInfo;
+
+        semaphoreProperties.pNext = nullptr;
+        mDevice->fn.GetPhysicalDeviceExternalSemaphoreProperties(
+            ToBackend(mDevice->GetAdapter())->GetPhysicalDevice(), &semaphoreInfo,
+            &semaphoreProperties);
+
+        mSupportsTimeline =
+            (semaphoreProperties.externalSemaphoreFeatures & requiredFlags) == requiredFlags;
     }
 
     Service::~Service() = default;
@@ -61,57 +147,44 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
     }
 
     ResultOrError<VkSemaphore> Service::ImportSemaphore(ExternalSemaphoreHandle handle) {
-        if (handle < 0) {
-            return DAWN_VALIDATION_ERROR("Trying to import semaphore with invalid handle");
+        return ImportSemaphoreImpl(mDevice, handle, nullptr);
+    }
+
+    ResultOrError<VkSemaphore> Service::ImportTimelineSemaphore(ExternalSemaphoreHandle handle) {
+        if (!mSupportsTimeline) {
+            return DAWN_VALIDATION_ERROR("External timeline semaphores not supported");
         }
 
-        VkSemaphore semaphore = VK_NULL_HANDLE;
-        VkSemaphoreCreateInfo info;
-        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-        info.pNext = nullptr;
-        info.flags = 0;
+        // The initial value is ignored, the semaphore takes the payload of the imported one.
+        VkSemaphoreTypeCreateInfoKHR typeInfo;
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeInfo.pNext = nullptr;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeInfo.initialValue = 0;
 
-        DAWN_TRY(CheckVkSuccess(
-            mDevice->fn.CreateSemaphore(mDevice->GetVkDevice(), &info, nullptr, &*semaphore),
-            "vkCreateSemaphore"));
-
-        VkImportSemaphoreFdInfoKHR importSemaphoreFdInfo;
-        importSemaphoreFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
-        importSemaphoreFdInfo.pNext = nullptr;
-        importSemaphoreFdInfo.semaphore = semaphore;
-        importSemaphoreFdInfo.flags = 0;
-        importSemaphoreFdInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-        importSemaphoreFdInfo.fd = handle;
-
-        MaybeError status = CheckVkSuccess(
-            mDevice->fn.ImportSemaphoreFdKHR(mDevice->GetVkDevice(), &importSemaphoreFdInfo),
-            "vkImportSemaphoreFdKHR");
-
-        if (status.IsError()) {
-            mDevice->fn.DestroySemaphore(mDevice->GetVkDevice(), semaphore, nullptr);
-            DAWN_TRY(std::move(status));
+        return ImportSemaphoreImpl(mDevice, handle, &typeInfo);
+    }
+
+    ResultOrError<VkSemaphore> Service::CreateExportableSemaphore() {
+        return CreateExportableSemaphoreImpl(mDevice, nullptr);
+    }
+
+    ResultOrError<VkSemaphore> Service::CreateExportableTimelineSemaphore(uint64_t initialValue) {
+        if (!mSupportsTimeline) {
+            return DAWN_VALIDATION_ERROR("External timeline semaphores not supported");
         }
 
-        return semaphore;
+        VkSemaphoreTypeCreateInfoKHR typeInfo;
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeInfo.pNext = nullptr;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeInfo.initialValue = initialValue;
+
+        return CreateExportableSemaphoreImpl(mDevice, &typeInfo);
     }
 
-    ResultOrError<VkSemaphore> Service::CreateExportableSemaphore() {
-        VkExportSemaphoreCreateInfoKHR exportSemaphoreInfo;
-        exportSemaphoreInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR;
-        exportSemaphoreInfo.pNext = nullptr;
-        exportSemaphoreInfo.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
-
-        VkSemaphoreCreateInfo semaphoreCreateInfo;
-        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-        semaphoreCreateInfo.pNext = &exportSemaphoreInfo;
-        semaphoreCreateInfo.flags = 0;
-
-        VkSemaphore signalSemaphore;
-        DAWN_TRY(
-            CheckVkSuccess(mDevice->fn.CreateSemaphore(mDevice->GetVkDevice(), &semaphoreCreateInfo,
-                                                       nullptr, &*signalSemaphore),
-                           "vkCreateSemaphore"));
-        return signalSemaphore;
+    bool Service::SupportsTimeline() {
+        return mSupportsTimeline;
     }
 
     ResultOrError<ExternalSemaphoreHandle> Service::ExportSemaphore(VkSemaphore semaphore) {
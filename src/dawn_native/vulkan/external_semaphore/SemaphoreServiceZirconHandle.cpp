@@ -135,4 +135,17 @@ namespace dawn_native { namespace vulkan { namespace external_semaphore {
         return handle;
     }
 
+    // Zircon events are binary, so timeline semaphores can't be shared with Zircon handles.
+    bool Service::SupportsTimeline() {
+        return mSupportsTimeline;
+    }
+
+    ResultOrError<VkSemaphore> Service::ImportTimelineSemaphore(ExternalSemaphoreHandle handle) {
+        return DAWN_VALIDATION_ERROR("Timeline semaphores can't be imported from Zircon handles");
+    }
+
+    ResultOrError<VkSemaphore> Service::CreateExportableTimelineSemaphore(uint64_t initialValue) {
+        return DAWN_VALIDATION_ERROR("Timeline semaphores can't be exported to Zircon handles");
+    }
+
 }}}  // namespace dawn_native::vulkan::external_semaphore
@@ -0,0 +1,584 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_platform/FileCachingInterface.h"
+
+#include "common/Assert.h"
+#include "common/Platform.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+#    include "common/windows_with_undefs.h"
+#elif defined(DAWN_PLATFORM_POSIX)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace dawn_platform {
+
+    namespace {
+
+        constexpr char kMagic[8] = {'D', 'A', 'W', 'N', 'C', 'A', 'C', 'H'};
+        // Must be bumped whenever the layout of the file changes.
+        constexpr uint32_t kFormatVersion = 1;
+
+        constexpr uint32_t kMinIndexCapacity = 1024;
+        // The file grows by at least this much so that stores don't remap it each time.
+        constexpr uint64_t kMinGrowthSize = 1 << 20;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t formatVersion;
+            // The number of slots of the index, a power of two.
+            uint32_t indexCapacity;
+            uint64_t fingerprintHash;
+            // The end of the last committed record, the file past it is unused.
+            uint64_t committedSize;
+            // The size of the records the index points to, the rest of the value region is
+            // replaced entries.
+            uint64_t liveSize;
+            uint32_t entryCount;
+            uint32_t padding;
+        };
+        static_assert(sizeof(FileHeader) == 48, "");
+
+        // Slots with a record offset of 0 are empty.
+        struct IndexSlot {
+            uint64_t keyHash;
+            uint64_t recordOffset;
+        };
+        static_assert(sizeof(IndexSlot) == 16, "");
+
+        // Followed by the key and the value, and padded to 8 bytes.
+        struct RecordHeader {
+            uint64_t keyHash;
+            uint64_t checksum;
+            uint32_t keySize;
+            uint32_t valueSize;
+        };
+        static_assert(sizeof(RecordHeader) == 24, "");
+
+        // FNV-1a, which unlike std::hash is the same for every run and every platform.
+        constexpr uint64_t kFNVOffsetBasis = 0xcbf29ce484222325ull;
+        uint64_t HashBytes(const void* data, size_t size, uint64_t hash = kFNVOffsetBasis) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        uint64_t GetRecordSize(uint64_t keySize, uint64_t valueSize) {
+            return (sizeof(RecordHeader) + keySize + valueSize + 7) & ~uint64_t(7);
+        }
+
+        uint64_t GetValueRegionOffset(uint32_t indexCapacity) {
+            return sizeof(FileHeader) + uint64_t(indexCapacity) * sizeof(IndexSlot);
+        }
+
+        // Returns the record at |offset| if it is entirely in the committed value region.
+        const RecordHeader* GetRecord(const uint8_t* data, uint64_t offset) {
+            const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+            if (offset < GetValueRegionOffset(header->indexCapacity) || offset % 8 != 0 ||
+                offset > header->committedSize ||
+                header->committedSize - offset < sizeof(RecordHeader)) {
+                return nullptr;
+            }
+            const RecordHeader* record = reinterpret_cast<const RecordHeader*>(data + offset);
+            if (GetRecordSize(record->keySize, record->valueSize) >
+                header->committedSize - offset) {
+                return nullptr;
+            }
+            return record;
+        }
+
+        const uint8_t* GetRecordKey(const RecordHeader* record) {
+            return reinterpret_cast<const uint8_t*>(record) + sizeof(RecordHeader);
+        }
+
+        const uint8_t* GetRecordValue(const RecordHeader* record) {
+            return GetRecordKey(record) + record->keySize;
+        }
+
+        uint64_t ComputeChecksum(const void* key,
+                                 size_t keySize,
+                                 const void* value,
+                                 size_t valueSize) {
+            return HashBytes(value, valueSize, HashBytes(key, keySize));
+        }
+
+        bool IsRecordIntact(const RecordHeader* record) {
+            return record->checksum == ComputeChecksum(GetRecordKey(record), record->keySize,
+                                                       GetRecordValue(record), record->valueSize);
+        }
+
+        IndexSlot* GetIndex(uint8_t* data) {
+            return reinterpret_cast<IndexSlot*>(data + sizeof(FileHeader));
+        }
+
+        // Returns the slot holding |key|, or the empty slot where it would be inserted. The index
+        // is never full since it grows once half of its slots are used.
+        IndexSlot* FindSlot(uint8_t* data,
+                            uint64_t keyHash,
+                            const void* key,
+                            size_t keySize,
+                            bool* found) {
+            const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+            IndexSlot* index = GetIndex(data);
+            const uint32_t mask = header->indexCapacity - 1;
+
+            *found = false;
+            for (uint32_t i = 0; i < header->indexCapacity; ++i) {
+                IndexSlot* slot = &index[(keyHash + i) & mask];
+                if (slot->recordOffset == 0) {
+                    return slot;
+                }
+                if (slot->keyHash != keyHash) {
+                    continue;
+                }
+                const RecordHeader* record = GetRecord(data, slot->recordOffset);
+                if (record != nullptr && record->keySize == keySize &&
+                    memcmp(GetRecordKey(record), key, keySize) == 0) {
+                    *found = true;
+                    return slot;
+                }
+            }
+            return nullptr;
+        }
+
+        std::string GetTemporaryPath(const std::string& path) {
+            return path + ".tmp";
+        }
+
+        bool ReplaceFile(const std::string& from, const std::string& to) {
+#if defined(DAWN_PLATFORM_WINDOWS)
+            return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+            return rename(from.c_str(), to.c_str()) == 0;
+#endif
+        }
+
+    }  // anonymous namespace
+
+    // A read-write mapping of a whole file, which is remapped when the file is resized.
+    class FileCachingInterface::MappedFile {
+      public:
+        static std::unique_ptr<MappedFile> Open(const std::string& path) {
+            std::unique_ptr<MappedFile> file(new MappedFile());
+#if defined(DAWN_PLATFORM_WINDOWS)
+            file->mFile = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                      OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file->mFile == INVALID_HANDLE_VALUE) {
+                return nullptr;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file->mFile, &size)) {
+                return nullptr;
+            }
+            file->mSize = static_cast<uint64_t>(size.QuadPart);
+#elif defined(DAWN_PLATFORM_POSIX)
+            file->mFd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (file->mFd < 0) {
+                return nullptr;
+            }
+            struct stat stats;
+            if (fstat(file->mFd, &stats) != 0) {
+                return nullptr;
+            }
+            file->mSize = static_cast<uint64_t>(stats.st_size);
+#endif
+            if (!file->Map()) {
+                return nullptr;
+            }
+            return file;
+        }
+
+        ~MappedFile() {
+            Unmap();
+#if defined(DAWN_PLATFORM_WINDOWS)
+            if (mFile != INVALID_HANDLE_VALUE) {
+                CloseHandle(mFile);
+            }
+#elif defined(DAWN_PLATFORM_POSIX)
+            if (mFd >= 0) {
+                close(mFd);
+            }
+#endif
+        }
+
+        uint8_t* GetData() const {
+            return mData;
+        }
+
+        uint64_t GetSize() const {
+            return mSize;
+        }
+
+        // The content past the previous size is zeroed. The data pointer changes.
+        bool Resize(uint64_t size) {
+            Unmap();
+#if defined(DAWN_PLATFORM_WINDOWS)
+            LARGE_INTEGER distance;
+            distance.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(mFile, distance, nullptr, FILE_BEGIN) || !SetEndOfFile(mFile)) {
+                return false;
+            }
+#elif defined(DAWN_PLATFORM_POSIX)
+            if (ftruncate(mFd, static_cast<off_t>(size)) != 0) {
+                return false;
+            }
+#endif
+            mSize = size;
+            return Map();
+        }
+
+        // Writes the mapped content back to the file.
+        bool Flush() {
+            if (mData == nullptr) {
+                return true;
+            }
+#if defined(DAWN_PLATFORM_WINDOWS)
+            return FlushViewOfFile(mData, 0) && FlushFileBuffers(mFile);
+#elif defined(DAWN_PLATFORM_POSIX)
+            return msync(mData, static_cast<size_t>(mSize), MS_SYNC) == 0;
+#endif
+        }
+
+      private:
+        MappedFile() = default;
+
+        bool Map() {
+            ASSERT(mData == nullptr);
+            // Empty files can't be mapped.
+            if (mSize == 0) {
+                return true;
+            }
+            if (mSize > std::numeric_limits<size_t>::max()) {
+                return false;
+            }
+#if defined(DAWN_PLATFORM_WINDOWS)
+            mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+            if (mMapping == nullptr) {
+                return false;
+            }
+            mData = static_cast<uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_WRITE, 0, 0, 0));
+#elif defined(DAWN_PLATFORM_POSIX)
+            void* data = mmap(nullptr, static_cast<size_t>(mSize), PROT_READ | PROT_WRITE,
+                              MAP_SHARED, mFd, 0);
+            mData = data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+#endif
+            return mData != nullptr;
+        }
+
+        void Unmap() {
+#if defined(DAWN_PLATFORM_WINDOWS)
+            if (mData != nullptr) {
+                UnmapViewOfFile(mData);
+            }
+            if (mMapping != nullptr) {
+                CloseHandle(mMapping);
+                mMapping = nullptr;
+            }
+#elif defined(DAWN_PLATFORM_POSIX)
+            if (mData != nullptr) {
+                munmap(mData, static_cast<size_t>(mSize));
+            }
+#endif
+            mData = nullptr;
+        }
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+        HANDLE mFile = INVALID_HANDLE_VALUE;
+        HANDLE mMapping = nullptr;
+#elif defined(DAWN_PLATFORM_POSIX)
+        int mFd = -1;
+#endif
+        uint8_t* mData = nullptr;
+        uint64_t mSize = 0;
+    };
+
+    // static
+    std::unique_ptr<FileCachingInterface> FileCachingInterface::Open(const char* path,
+                                                                     const void* fingerprint,
+                                                                     size_t fingerprintSize) {
+        std::unique_ptr<MappedFile> file = MappedFile::Open(path);
+        if (file == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<FileCachingInterface> cache(new FileCachingInterface(
+            path, HashBytes(fingerprint, fingerprintSize), std::move(file)));
+        if (!cache->IsValid() && !cache->Reset()) {
+            return nullptr;
+        }
+        return cache;
+    }
+
+    // static
+    std::string FileCachingInterface::GetFileName(const void* fingerprint,
+                                                  size_t fingerprintSize) {
+        char name[32];
+        snprintf(name, sizeof(name), "%016" PRIx64 ".dawncache",
+                 HashBytes(fingerprint, fingerprintSize));
+        return name;
+    }
+
+    FileCachingInterface::FileCachingInterface(const char* path,
+                                               uint64_t fingerprintHash,
+                                               std::unique_ptr<MappedFile> file)
+        : mPath(path), mFingerprintHash(fingerprintHash), mFile(std::move(file)) {
+    }
+
+    FileCachingInterface::~FileCachingInterface() = default;
+
+    bool FileCachingInterface::IsValid() const {
+        if (mFile->GetSize() < sizeof(FileHeader)) {
+            return false;
+        }
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(mFile->GetData());
+        const uint32_t capacity = header->indexCapacity;
+        return memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+               header->formatVersion == kFormatVersion &&
+               header->fingerprintHash == mFingerprintHash && capacity != 0 &&
+               (capacity & (capacity - 1)) == 0 &&
+               header->committedSize >= GetValueRegionOffset(capacity) &&
+               header->committedSize <= mFile->GetSize();
+    }
+
+    bool FileCachingInterface::Reset() {
+        const uint64_t size = GetValueRegionOffset(kMinIndexCapacity);
+        if (!mFile->Resize(0) || !mFile->Resize(size)) {
+            return false;
+        }
+
+        FileHeader* header = reinterpret_cast<FileHeader*>(mFile->GetData());
+        memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->formatVersion = kFormatVersion;
+        header->indexCapacity = kMinIndexCapacity;
+        header->fingerprintHash = mFingerprintHash;
+        header->committedSize = size;
+        return true;
+    }
+
+    size_t FileCachingInterface::LoadData(const void* key,
+                                          size_t keySize,
+                                          void* value,
+                                          size_t valueSize) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFile == nullptr) {
+            return 0;
+        }
+
+        uint8_t* data = mFile->GetData();
+        bool found;
+        IndexSlot* slot = FindSlot(data, HashBytes(key, keySize), key, keySize, &found);
+        if (!found) {
+            return 0;
+        }
+
+        const RecordHeader* record = GetRecord(data, slot->recordOffset);
+        if (value == nullptr || valueSize < record->valueSize) {
+            return record->valueSize;
+        }
+
+        // Only the records that are read are checked, so that opening the file stays cheap.
+        if (!IsRecordIntact(record)) {
+            return 0;
+        }
+        memcpy(value, GetRecordValue(record), record->valueSize);
+        return record->valueSize;
+    }
+
+    void FileCachingInterface::StoreData(const void* key,
+                                         size_t keySize,
+                                         const void* value,
+                                         size_t valueSize) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFile == nullptr || keySize > std::numeric_limits<uint32_t>::max() ||
+            valueSize > std::numeric_limits<uint32_t>::max()) {
+            return;
+        }
+
+        const uint64_t keyHash = HashBytes(key, keySize);
+        bool found;
+        IndexSlot* slot = FindSlot(mFile->GetData(), keyHash, key, keySize, &found);
+        if (!found) {
+            const FileHeader* header = reinterpret_cast<const FileHeader*>(mFile->GetData());
+            if ((uint64_t(header->entryCount) + 1) * 2 > header->indexCapacity) {
+                if (!CompactLocked()) {
+                    return;
+                }
+                slot = FindSlot(mFile->GetData(), keyHash, key, keySize, &found);
+            }
+        }
+        if (slot == nullptr) {
+            return;
+        }
+        const uint64_t slotIndex = slot - GetIndex(mFile->GetData());
+
+        // Append the record past the committed size first, so that it is only visible once it
+        // is complete.
+        const uint64_t recordSize = GetRecordSize(keySize, valueSize);
+        uint64_t recordOffset = reinterpret_cast<FileHeader*>(mFile->GetData())->committedSize;
+        if (recordOffset + recordSize > mFile->GetSize()) {
+            uint64_t size = mFile->GetSize();
+            uint64_t newSize = std::max(recordOffset + recordSize,
+                                        size + std::max(size / 2, kMinGrowthSize));
+            if (!mFile->Resize(newSize)) {
+                return;
+            }
+        }
+
+        uint8_t* data = mFile->GetData();
+        RecordHeader* record = reinterpret_cast<RecordHeader*>(data + recordOffset);
+        record->keyHash = keyHash;
+        record->checksum = ComputeChecksum(key, keySize, value, valueSize);
+        record->keySize = static_cast<uint32_t>(keySize);
+        record->valueSize = static_cast<uint32_t>(valueSize);
+        memcpy(data + recordOffset + sizeof(RecordHeader), key, keySize);
+        memcpy(data + recordOffset + sizeof(RecordHeader) + keySize, value, valueSize);
+
+        FileHeader* header = reinterpret_cast<FileHeader*>(data);
+        header->committedSize = recordOffset + recordSize;
+
+        slot = &GetIndex(data)[slotIndex];
+        if (found) {
+            const RecordHeader* previous = GetRecord(data, slot->recordOffset);
+            header->liveSize -= GetRecordSize(previous->keySize, previous->valueSize);
+        } else {
+            header->entryCount++;
+        }
+        header->liveSize += recordSize;
+        slot->keyHash = keyHash;
+        slot->recordOffset = recordOffset;
+
+        const uint64_t staleSize =
+            header->committedSize - GetValueRegionOffset(header->indexCapacity) - header->liveSize;
+        if (staleSize > kMinGrowthSize && staleSize > header->liveSize) {
+            CompactLocked();
+        }
+    }
+
+    bool FileCachingInterface::Compact() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mFile != nullptr && CompactLocked();
+    }
+
+    bool FileCachingInterface::CompactLocked() {
+        uint8_t* data = mFile->GetData();
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+        const IndexSlot* index = GetIndex(data);
+
+        // The records that were damaged are dropped.
+        uint64_t liveSize = 0;
+        uint32_t entryCount = 0;
+        for (uint32_t i = 0; i < header->indexCapacity; ++i) {
+            const RecordHeader* record = GetRecord(data, index[i].recordOffset);
+            if (index[i].recordOffset != 0 && record != nullptr && IsRecordIntact(record)) {
+                liveSize += GetRecordSize(record->keySize, record->valueSize);
+                entryCount++;
+            }
+        }
+
+        // Leave room for as many new entries as there are entries before the index grows again.
+        uint32_t capacity = kMinIndexCapacity;
+        while (capacity < (uint64_t(entryCount) + 1) * 4) {
+            capacity *= 2;
+        }
+
+        const std::string temporaryPath = GetTemporaryPath(mPath);
+        {
+            std::unique_ptr<MappedFile> compacted = MappedFile::Open(temporaryPath);
+            const uint64_t size = GetValueRegionOffset(capacity) + liveSize;
+            if (compacted == nullptr || !compacted->Resize(0) || !compacted->Resize(size)) {
+                remove(temporaryPath.c_str());
+                return false;
+            }
+
+            uint8_t* compactedData = compacted->GetData();
+            FileHeader* compactedHeader = reinterpret_cast<FileHeader*>(compactedData);
+            memcpy(compactedHeader->magic, kMagic, sizeof(kMagic));
+            compactedHeader->formatVersion = kFormatVersion;
+            compactedHeader->indexCapacity = capacity;
+            compactedHeader->fingerprintHash = mFingerprintHash;
+            compactedHeader->committedSize = size;
+            compactedHeader->liveSize = liveSize;
+            compactedHeader->entryCount = entryCount;
+
+            IndexSlot* compactedIndex = GetIndex(compactedData);
+            uint64_t recordOffset = GetValueRegionOffset(capacity);
+            for (uint32_t i = 0; i < header->indexCapacity; ++i) {
+                const RecordHeader* record = GetRecord(data, index[i].recordOffset);
+                if (index[i].recordOffset == 0 || record == nullptr || !IsRecordIntact(record)) {
+                    continue;
+                }
+
+                uint32_t slot = static_cast<uint32_t>(record->keyHash) & (capacity - 1);
+                while (compactedIndex[slot].recordOffset != 0) {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                compactedIndex[slot].keyHash = record->keyHash;
+                compactedIndex[slot].recordOffset = recordOffset;
+
+                const uint64_t recordSize = GetRecordSize(record->keySize, record->valueSize);
+                memcpy(compactedData + recordOffset, record, recordSize);
+                recordOffset += recordSize;
+            }
+            ASSERT(recordOffset == size);
+
+            if (!compacted->Flush()) {
+                compacted = nullptr;
+                remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+
+        // The file can't be replaced while it is mapped on Windows.
+        mFile = nullptr;
+        const bool replaced = ReplaceFile(temporaryPath, mPath);
+        if (!replaced) {
+            remove(temporaryPath.c_str());
+        }
+        mFile = MappedFile::Open(mPath);
+        if (mFile != nullptr && !IsValid() && !Reset()) {
+            mFile = nullptr;
+        }
+        return replaced && mFile != nullptr;
+    }
+
+    size_t FileCachingInterface::GetEntryCount() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFile == nullptr) {
+            return 0;
+        }
+        return reinterpret_cast<const FileHeader*>(mFile->GetData())->entryCount;
+    }
+
+    uint64_t FileCachingInterface::GetFileSize() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFile == nullptr) {
+            return 0;
+        }
+        return reinterpret_cast<const FileHeader*>(mFile->GetData())->committedSize;
+    }
+
+}  // namespace dawn_platform
@@ -240,6 +240,11 @@
     INTERNAL_TRACE_EVENT_ADD(platform, TRACE_EVENT_PHASE_END, category, name,                     \
                              TRACE_EVENT_FLAG_COPY, arg1_name, arg1_val, arg2_name, arg2_val)
 
+// Evaluates to whether the category is enabled, to skip gathering the
+// arguments of events when they are expensive to compute.
+#define TRACE_EVENT_CATEGORY_ENABLED(platform, category) \
+    (*TRACE_EVENT_API_GET_CATEGORY_ENABLED(platform, ::dawn_platform::TraceCategory::category) != 0)
+
 // Records the value of a counter called "name" immediately. Value
 // must be representable as a 32 bit integer.
 // - category and name strings must have application lifetime (statics or
@@ -838,7 +843,7 @@ namespace dawn_platform { namespace TraceEvent {
 // structures so that it is portable to third_party libraries.
 #define INTERNAL_DECLARE_SET_TRACE_VALUE(actual_type, union_member, value_type_id) \
     static inline void setTraceValue(actual_type arg, unsigned char* type,         \
-                                     unsigned long long* value) {                  \
+                                     uint64_t* value) {                            \
         TraceValueUnion typeValue;                                                 \
         typeValue.union_member = arg;                                              \
         *type = value_type_id;                                                     \
@@ -847,16 +852,18 @@ namespace dawn_platform { namespace TraceEvent {
 // Simpler form for int types that can be safely casted.
 #define INTERNAL_DECLARE_SET_TRACE_VALUE_INT(actual_type, value_type_id)   \
     static inline void setTraceValue(actual_type arg, unsigned char* type, \
-                                     unsigned long long* value) {          \
+                                     uint64_t* value) {                    \
         *type = value_type_id;                                             \
-        *value = static_cast<unsigned long long>(arg);                     \
+        *value = static_cast<uint64_t>(arg);                               \
     }
 
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(unsigned long long, TRACE_VALUE_TYPE_UINT)
+        INTERNAL_DECLARE_SET_TRACE_VALUE_INT(unsigned long, TRACE_VALUE_TYPE_UINT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(unsigned int, TRACE_VALUE_TYPE_UINT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(unsigned short, TRACE_VALUE_TYPE_UINT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(unsigned char, TRACE_VALUE_TYPE_UINT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(long long, TRACE_VALUE_TYPE_INT)
+        INTERNAL_DECLARE_SET_TRACE_VALUE_INT(long, TRACE_VALUE_TYPE_INT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(int, TRACE_VALUE_TYPE_INT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(short, TRACE_VALUE_TYPE_INT)
         INTERNAL_DECLARE_SET_TRACE_VALUE_INT(signed char, TRACE_VALUE_TYPE_INT)
@@ -873,7 +880,7 @@ namespace dawn_platform { namespace TraceEvent {
 
         static inline void setTraceValue(const std::string& arg,
                                          unsigned char* type,
-                                         unsigned long long* value) {
+                                         uint64_t* value) {
             TraceValueUnion typeValue;
             typeValue.m_string = arg.data();
             *type = TRACE_VALUE_TYPE_COPY_STRING;
@@ -0,0 +1,332 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_platform/TracingPlatform.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace dawn_platform {
+
+    namespace {
+
+        constexpr uint32_t kCategoryCount = 4;
+        static_assert(static_cast<uint32_t>(TraceCategory::GPUWork) + 1 == kCategoryCount, "");
+
+        constexpr const char* kCategoryNames[kCategoryCount] = {
+            "General",
+            "Validation",
+            "Recording",
+            "GPUWork",
+        };
+
+        // Dawn caches the pointer to the enabled flag of each category in function-level statics
+        // so the flags have to outlive any TracingPlatform.
+        unsigned char gCategoryEnabled[kCategoryCount] = {};
+
+        std::atomic<uint64_t> gNextPlatformSerial(1);
+
+        // The events use the same layout as the arguments of AddTraceEvent. The names are
+        // string literals from the TRACE_EVENT macros so they don't need to be copied.
+        constexpr int kMaxArgs = 2;
+        struct Event {
+            const char* name;
+            double timestamp;
+            uint64_t id;
+            const char* argNames[kMaxArgs];
+            uint64_t argValues[kMaxArgs];
+            unsigned char argTypes[kMaxArgs];
+            uint8_t numArgs;
+            uint8_t category;
+            char phase;
+            unsigned char flags;
+        };
+
+        void WriteEscapedString(std::ostringstream& stream, const char* str) {
+            stream << '"';
+            for (const char* c = str; *c != '\0'; ++c) {
+                switch (*c) {
+                    case '"':
+                        stream << "\\\"";
+                        break;
+                    case '\\':
+                        stream << "\\\\";
+                        break;
+                    case '\n':
+                        stream << "\\n";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(*c) < 0x20) {
+                            char escaped[8];
+                            snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                            stream << escaped;
+                        } else {
+                            stream << *c;
+                        }
+                        break;
+                }
+            }
+            stream << '"';
+        }
+
+        void WriteArgValue(std::ostringstream& stream, unsigned char type, uint64_t value) {
+            switch (type) {
+                case TRACE_VALUE_TYPE_BOOL:
+                    stream << (value != 0 ? "true" : "false");
+                    break;
+                case TRACE_VALUE_TYPE_UINT:
+                    stream << value;
+                    break;
+                case TRACE_VALUE_TYPE_INT:
+                    stream << static_cast<int64_t>(value);
+                    break;
+                case TRACE_VALUE_TYPE_DOUBLE: {
+                    double d;
+                    memcpy(&d, &value, sizeof(d));
+                    stream << d;
+                    break;
+                }
+                case TRACE_VALUE_TYPE_POINTER: {
+                    char pointer[24];
+                    snprintf(pointer, sizeof(pointer), "\"0x%" PRIx64 "\"", value);
+                    stream << pointer;
+                    break;
+                }
+                case TRACE_VALUE_TYPE_STRING:
+                    WriteEscapedString(stream, reinterpret_cast<const char*>(value));
+                    break;
+                default:
+                    // Copied strings are owned by the caller and are gone by the time the events
+                    // are written out.
+                    stream << "null";
+                    break;
+            }
+        }
+
+    }  // anonymous namespace
+
+    struct TracingPlatform::ThreadRing {
+        ThreadRing(std::thread::id threadIdIn, uint32_t indexIn, size_t capacity)
+            : threadId(threadIdIn), index(indexIn), events(capacity) {
+        }
+
+        const std::thread::id threadId;
+        const uint32_t index;
+        std::vector<Event> events;
+
+        // Only written by the thread owning the ring. The release store publishes the event
+        // written before it.
+        std::atomic<uint64_t> eventCount{0};
+    };
+
+    TracingPlatform::TracingPlatform(size_t eventsPerThread)
+        : Platform(),
+          mEventsPerThread(
+              static_cast<size_t>(NextPowerOfTwo(std::max(eventsPerThread, size_t(1))))),
+          mSerial(gNextPlatformSerial.fetch_add(1)),
+          mOrigin(std::chrono::steady_clock::now()) {
+    }
+
+    TracingPlatform::~TracingPlatform() = default;
+
+    void TracingPlatform::EnableCategory(TraceCategory category, bool enabled) {
+        uint32_t index = static_cast<uint32_t>(category);
+        ASSERT(index < kCategoryCount);
+        gCategoryEnabled[index] = enabled ? 1 : 0;
+    }
+
+    void TracingPlatform::EnableAllCategories(bool enabled) {
+        for (uint32_t i = 0; i < kCategoryCount; ++i) {
+            gCategoryEnabled[i] = enabled ? 1 : 0;
+        }
+    }
+
+    const unsigned char* TracingPlatform::GetTraceCategoryEnabledFlag(TraceCategory category) {
+        uint32_t index = static_cast<uint32_t>(category);
+        ASSERT(index < kCategoryCount);
+        return &gCategoryEnabled[index];
+    }
+
+    double TracingPlatform::MonotonicallyIncreasingTime() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - mOrigin).count();
+    }
+
+    TracingPlatform::ThreadRing* TracingPlatform::GetLocalThreadRing() {
+        // Cache the ring of the last TracingPlatform used by this thread. Platforms are told
+        // apart with their serial because a new one could be allocated at the address of a
+        // deleted one.
+        struct LocalRing {
+            uint64_t platformSerial = 0;
+            ThreadRing* ring = nullptr;
+        };
+        thread_local LocalRing localRing;
+
+        if (localRing.platformSerial == mSerial) {
+            return localRing.ring;
+        }
+
+        std::thread::id threadId = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> lock(mRingsMutex);
+        ThreadRing* ring = nullptr;
+        for (const std::unique_ptr<ThreadRing>& existingRing : mRings) {
+            if (existingRing->threadId == threadId) {
+                ring = existingRing.get();
+                break;
+            }
+        }
+        if (ring == nullptr) {
+            mRings.push_back(std::make_unique<ThreadRing>(
+                threadId, static_cast<uint32_t>(mRings.size()), mEventsPerThread));
+            ring = mRings.back().get();
+        }
+
+        localRing.platformSerial = mSerial;
+        localRing.ring = ring;
+        return ring;
+    }
+
+    uint64_t TracingPlatform::AddTraceEvent(char phase,
+                                            const unsigned char* categoryGroupEnabled,
+                                            const char* name,
+                                            uint64_t id,
+                                            double timestamp,
+                                            int numArgs,
+                                            const char** argNames,
+                                            const unsigned char* argTypes,
+                                            const uint64_t* argValues,
+                                            unsigned char flags) {
+        ptrdiff_t category = categoryGroupEnabled - gCategoryEnabled;
+        if (category < 0 || category >= static_cast<ptrdiff_t>(kCategoryCount)) {
+            return 0;
+        }
+
+        ThreadRing* ring = GetLocalThreadRing();
+        uint64_t eventIndex = ring->eventCount.load(std::memory_order_relaxed);
+
+        Event* event = &ring->events[eventIndex & (mEventsPerThread - 1)];
+        event->name = name;
+        event->timestamp = timestamp;
+        event->id = id;
+        event->numArgs = static_cast<uint8_t>(std::min(numArgs, kMaxArgs));
+        for (uint8_t i = 0; i < event->numArgs; ++i) {
+            event->argNames[i] = argNames[i];
+            event->argValues[i] = argValues[i];
+            event->argTypes[i] = argTypes[i];
+        }
+        event->category = static_cast<uint8_t>(category);
+        event->phase = phase;
+        event->flags = flags;
+
+        ring->eventCount.store(eventIndex + 1, std::memory_order_release);
+
+        // Trace event handles only need to be unique, use the position of the event.
+        return (static_cast<uint64_t>(ring->index + 1) << 48) | (eventIndex & 0xFFFFFFFFFFFF);
+    }
+
+    std::string TracingPlatform::GetChromeTraceJSON() const {
+        std::ostringstream stream;
+        stream.precision(15);
+        stream << "{\"traceEvents\":[";
+
+        bool first = true;
+        auto BeginEntry = [&]() {
+            if (!first) {
+                stream << ",";
+            }
+            first = false;
+            stream << "\n";
+        };
+
+        std::lock_guard<std::mutex> lock(mRingsMutex);
+        for (const std::unique_ptr<ThreadRing>& ring : mRings) {
+            BeginEntry();
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << ring->index
+                   << ",\"args\":{\"name\":\"Dawn thread " << ring->index << "\"}}";
+
+            uint64_t eventCount = ring->eventCount.load(std::memory_order_acquire);
+            uint64_t firstEvent = eventCount > mEventsPerThread ? eventCount - mEventsPerThread : 0;
+
+            // When the ring wrapped around, the begin events of the oldest scopes might have been
+            // overwritten. Drop their end events so that the scopes stay balanced.
+            int64_t depth = 0;
+            for (uint64_t i = firstEvent; i < eventCount; ++i) {
+                const Event& event = ring->events[i & (mEventsPerThread - 1)];
+                if (event.phase == TRACE_EVENT_PHASE_BEGIN) {
+                    depth++;
+                } else if (event.phase == TRACE_EVENT_PHASE_END) {
+                    if (depth == 0) {
+                        continue;
+                    }
+                    depth--;
+                }
+
+                BeginEntry();
+                stream << "{\"name\":";
+                WriteEscapedString(stream, event.name);
+                stream << ",\"cat\":\"" << kCategoryNames[event.category] << "\",\"ph\":\""
+                       << event.phase << "\",\"ts\":" << event.timestamp * 1e6
+                       << ",\"pid\":0,\"tid\":" << ring->index;
+                if (event.flags & TRACE_EVENT_FLAG_HAS_ID) {
+                    char id[24];
+                    snprintf(id, sizeof(id), "\"0x%" PRIx64 "\"", event.id);
+                    stream << ",\"id\":" << id;
+                }
+                if (event.numArgs > 0) {
+                    stream << ",\"args\":{";
+                    for (uint8_t arg = 0; arg < event.numArgs; ++arg) {
+                        if (arg > 0) {
+                            stream << ",";
+                        }
+                        WriteEscapedString(stream, event.argNames[arg]);
+                        stream << ":";
+                        WriteArgValue(stream, event.argTypes[arg], event.argValues[arg]);
+                    }
+                    stream << "}";
+                }
+                stream << "}";
+            }
+        }
+
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        return stream.str();
+    }
+
+    bool TracingPlatform::WriteChromeTraceJSON(const char* path) const {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << GetChromeTraceJSON();
+        return file.good();
+    }
+
+    void TracingPlatform::ClearEvents() {
+        std::lock_guard<std::mutex> lock(mRingsMutex);
+        for (const std::unique_ptr<ThreadRing>& ring : mRings) {
+            ring->eventCount.store(0, std::memory_order_release);
+        }
+    }
+
+}  // namespace dawn_platform
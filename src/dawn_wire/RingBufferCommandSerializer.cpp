@@ -0,0 +1,396 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/RingBufferCommandSerializer.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace dawn_wire {
+
+    namespace {
+
+        // The ring is a sequence of 8 byte aligned records: each one is a RecordHeader followed
+        // by its payload.
+        enum RecordType : uint32_t {
+            // A batch of complete commands.
+            Batch = 0,
+            // Skips to the start of the ring when a record doesn't fit before its end.
+            Padding = 1,
+            // A piece of a batch larger than a record, the last piece completes the batch.
+            Chunk = 2,
+            LastChunk = 3,
+        };
+
+        struct RecordHeader {
+            uint32_t type;
+            uint32_t size;
+        };
+
+        constexpr uint32_t kRecordHeaderSize = sizeof(RecordHeader);
+        constexpr uint32_t kRecordAlignment = 8;
+        static_assert(kRecordHeaderSize == kRecordAlignment, "");
+
+        // The positions increase monotonically and wrap around at 2^32, which is a multiple of
+        // the capacity, so the index in the ring is the position modulo the capacity.
+        uint32_t AlignPosition(uint32_t position) {
+            return (position + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+        }
+
+    }  // anonymous namespace
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2,
+                  "The ring positions must be lock-free to be shared between processes");
+
+    // The read and write positions are on different cache lines to avoid false sharing.
+    struct CommandRingBuffer::Header {
+        std::atomic<uint32_t> write;
+        char padding0[60];
+        std::atomic<uint32_t> read;
+        char padding1[60];
+    };
+
+    // static
+    size_t CommandRingBuffer::GetMemorySize(size_t capacity) {
+        return sizeof(Header) + capacity;
+    }
+
+    CommandRingBuffer::CommandRingBuffer(size_t capacity)
+        : mOwnedMemory(new uint64_t[(GetMemorySize(capacity) + 7) / 8]) {
+        mHeader = new (mOwnedMemory.get()) Header();
+        mHeader->write.store(0, std::memory_order_relaxed);
+        mHeader->read.store(0, std::memory_order_relaxed);
+        mData = reinterpret_cast<char*>(mOwnedMemory.get()) + sizeof(Header);
+        mCapacity = static_cast<uint32_t>(capacity);
+        ASSERT(IsPowerOfTwo(capacity) && capacity >= 64 && capacity <= (1u << 30));
+    }
+
+    CommandRingBuffer::CommandRingBuffer(void* memory, size_t capacity, bool initialize) {
+        ASSERT(IsPowerOfTwo(capacity) && capacity >= 64 && capacity <= (1u << 30));
+        ASSERT(reinterpret_cast<uintptr_t>(memory) % 8 == 0);
+        if (initialize) {
+            mHeader = new (memory) Header();
+            mHeader->write.store(0, std::memory_order_relaxed);
+            mHeader->read.store(0, std::memory_order_relaxed);
+        } else {
+            mHeader = static_cast<Header*>(memory);
+        }
+        mData = static_cast<char*>(memory) + sizeof(Header);
+        mCapacity = static_cast<uint32_t>(capacity);
+    }
+
+    CommandRingBuffer::~CommandRingBuffer() = default;
+
+    size_t CommandRingBuffer::GetCapacity() const {
+        return mCapacity;
+    }
+
+    // RingBufferCommandSerializer
+
+    RingBufferCommandSerializer::RingBufferCommandSerializer(
+        CommandRingBuffer* ring,
+        const RingBufferCommandSerializerDescriptor& descriptor)
+        : mRing(ring), mDescriptor(descriptor), mMaxRecordSize(ring->mCapacity / 4) {
+        mWrite = mRing->mHeader->write.load(std::memory_order_relaxed);
+        mCompleted = mWrite;
+    }
+
+    RingBufferCommandSerializer::~RingBufferCommandSerializer() = default;
+
+    void* RingBufferCommandSerializer::GetCmdSpace(size_t size) {
+        // The batches queued on the client go first to keep the commands in order.
+        if (!mQueuedBatches.empty()) {
+            DrainQueuedBatches(mDescriptor.backpressureMode == RingBufferBackpressureMode::Block);
+            if (!mQueuedBatches.empty()) {
+                return AllocateQueuedSpace(size);
+            }
+        }
+
+        const bool block = mDescriptor.backpressureMode == RingBufferBackpressureMode::Block;
+
+        if (size > mMaxRecordSize) {
+            CloseBatch();
+            return AllocateQueuedSpace(size);
+        }
+        uint32_t size32 = static_cast<uint32_t>(size);
+
+        if (mBatchOpen) {
+            // The previous commands are complete so the batch can be published.
+            uint32_t batchSize = mWrite - mBatchStart - kRecordHeaderSize;
+            bool reachedThreshold =
+                mDescriptor.flushThreshold != 0 && batchSize >= mDescriptor.flushThreshold;
+            bool fitsInRing = (mWrite & (mRing->mCapacity - 1)) + size32 <= mRing->mCapacity;
+            if (reachedThreshold || batchSize + size32 > mMaxRecordSize || !fitsInRing) {
+                CloseBatch();
+            }
+        }
+
+        if (mBatchOpen) {
+            if (!WaitForSpace(AlignPosition(mWrite + size32) - mWrite, block)) {
+                CloseBatch();
+                return AllocateQueuedSpace(size);
+            }
+        } else {
+            if (!ReserveRecord(size32, block)) {
+                return AllocateQueuedSpace(size);
+            }
+            mBatchOpen = true;
+            mBatchStart = mWrite;
+            mWrite += kRecordHeaderSize;
+        }
+
+        char* result = &mRing->mData[mWrite & (mRing->mCapacity - 1)];
+        mWrite += size32;
+        return result;
+    }
+
+    bool RingBufferCommandSerializer::Flush() {
+        CloseBatch();
+        DrainQueuedBatches(mDescriptor.backpressureMode == RingBufferBackpressureMode::Block);
+        return true;
+    }
+
+    void RingBufferCommandSerializer::EndFrame() {
+        if (mDescriptor.flushOnEndFrame) {
+            Flush();
+        }
+    }
+
+    size_t RingBufferCommandSerializer::GetQueuedSize() const {
+        size_t queuedSize = 0;
+        for (const std::vector<char>& batch : mQueuedBatches) {
+            queuedSize += batch.size();
+        }
+        return queuedSize - mQueuedOffset;
+    }
+
+    bool RingBufferCommandSerializer::WaitForSpace(uint32_t size, bool block) {
+        const uint32_t capacity = mRing->mCapacity;
+        uint32_t read = mRing->mHeader->read.load(std::memory_order_acquire);
+        if (mWrite + size - read <= capacity) {
+            return true;
+        }
+
+        // Publish the complete records so that the reader can make progress.
+        Publish();
+        if (!block) {
+            return false;
+        }
+
+        do {
+            std::this_thread::yield();
+            read = mRing->mHeader->read.load(std::memory_order_acquire);
+        } while (mWrite + size - read > capacity);
+        return true;
+    }
+
+    bool RingBufferCommandSerializer::ReserveRecord(uint32_t payloadSize, bool block) {
+        ASSERT(!mBatchOpen);
+        ASSERT(payloadSize <= mMaxRecordSize);
+        const uint32_t capacity = mRing->mCapacity;
+
+        uint32_t recordSize = AlignPosition(kRecordHeaderSize + payloadSize);
+        uint32_t index = mWrite & (capacity - 1);
+        uint32_t paddingSize = index + recordSize > capacity ? capacity - index : 0;
+        if (!WaitForSpace(paddingSize + recordSize, block)) {
+            return false;
+        }
+
+        if (paddingSize > 0) {
+            RecordHeader padding = {Padding, paddingSize - kRecordHeaderSize};
+            memcpy(&mRing->mData[index], &padding, sizeof(padding));
+            mWrite += paddingSize;
+            mCompleted = mWrite;
+        }
+        return true;
+    }
+
+    bool RingBufferCommandSerializer::WriteRecord(uint32_t type,
+                                                  const char* data,
+                                                  uint32_t size,
+                                                  bool block) {
+        if (!ReserveRecord(size, block)) {
+            return false;
+        }
+
+        RecordHeader header = {type, size};
+        char* record = &mRing->mData[mWrite & (mRing->mCapacity - 1)];
+        memcpy(record, &header, sizeof(header));
+        memcpy(record + sizeof(header), data, size);
+        mWrite = AlignPosition(mWrite + sizeof(header) + size);
+        mCompleted = mWrite;
+        Publish();
+        return true;
+    }
+
+    void RingBufferCommandSerializer::CloseBatch() {
+        if (!mBatchOpen) {
+            return;
+        }
+
+        RecordHeader header = {Batch, mWrite - mBatchStart - kRecordHeaderSize};
+        memcpy(&mRing->mData[mBatchStart & (mRing->mCapacity - 1)], &header, sizeof(header));
+        mWrite = AlignPosition(mWrite);
+        mCompleted = mWrite;
+        mBatchOpen = false;
+        Publish();
+    }
+
+    void RingBufferCommandSerializer::Publish() {
+        mRing->mHeader->write.store(mCompleted, std::memory_order_release);
+    }
+
+    void* RingBufferCommandSerializer::AllocateQueuedSpace(size_t size) {
+        ASSERT(!mBatchOpen);
+
+        // Commands are appended to the last queued batch unless it is partially in the ring.
+        if (mQueuedBatches.empty() || (mQueuedBatches.size() == 1 && mQueuedOffset > 0)) {
+            mQueuedBatches.emplace_back();
+        }
+
+        // Only report when commands are queued because the ring is full, not because they are
+        // too large.
+        if (size <= mMaxRecordSize && !mReportedBackpressure) {
+            mReportedBackpressure = true;
+            if (mDescriptor.backpressureCallback) {
+                mDescriptor.backpressureCallback(GetQueuedSize() + size);
+            }
+        }
+
+        std::vector<char>& batch = mQueuedBatches.back();
+        size_t offset = batch.size();
+        batch.resize(offset + size);
+        return batch.data() + offset;
+    }
+
+    void RingBufferCommandSerializer::DrainQueuedBatches(bool block) {
+        ASSERT(!mBatchOpen);
+
+        while (!mQueuedBatches.empty()) {
+            const std::vector<char>& batch = mQueuedBatches.front();
+            size_t remainingSize = batch.size() - mQueuedOffset;
+
+            if (mQueuedOffset == 0 && remainingSize <= mMaxRecordSize) {
+                if (!WriteRecord(Batch, batch.data(), static_cast<uint32_t>(remainingSize),
+                                 block)) {
+                    return;
+                }
+            } else {
+                uint32_t chunkSize =
+                    static_cast<uint32_t>(std::min<size_t>(remainingSize, mMaxRecordSize));
+                uint32_t type = chunkSize == remainingSize ? LastChunk : Chunk;
+                if (!WriteRecord(type, batch.data() + mQueuedOffset, chunkSize, block)) {
+                    return;
+                }
+                mQueuedOffset += chunkSize;
+                if (mQueuedOffset < batch.size()) {
+                    continue;
+                }
+            }
+
+            mQueuedBatches.pop_front();
+            mQueuedOffset = 0;
+        }
+
+        mReportedBackpressure = false;
+    }
+
+    // RingBufferCommandReader
+
+    RingBufferCommandReader::RingBufferCommandReader(CommandRingBuffer* ring, size_t maxBatchSize)
+        : mRing(ring), mMaxBatchSize(maxBatchSize) {
+        mRead = mRing->mHeader->read.load(std::memory_order_relaxed);
+    }
+
+    RingBufferCommandReader::~RingBufferCommandReader() = default;
+
+    bool RingBufferCommandReader::HasCommands() const {
+        return mRing->mHeader->write.load(std::memory_order_acquire) != mRead;
+    }
+
+    bool RingBufferCommandReader::HandleCommands(CommandHandler* handler) {
+        const uint32_t capacity = mRing->mCapacity;
+
+        // The ring may be in memory shared with another process, so its contents are validated.
+        uint32_t write = mRing->mHeader->write.load(std::memory_order_acquire);
+        if (write - mRead > capacity) {
+            return false;
+        }
+
+        while (mRead != write) {
+            uint32_t index = mRead & (capacity - 1);
+            if (write - mRead < kRecordHeaderSize) {
+                return false;
+            }
+
+            RecordHeader header;
+            memcpy(&header, &mRing->mData[index], sizeof(header));
+            if (header.size > capacity - index - kRecordHeaderSize) {
+                return false;
+            }
+            uint32_t recordSize = AlignPosition(kRecordHeaderSize + header.size);
+            if (recordSize > write - mRead) {
+                return false;
+            }
+
+            const char* payload = &mRing->mData[index + kRecordHeaderSize];
+            switch (header.type) {
+                case Batch: {
+                    if (header.size > mMaxBatchSize ||
+                        handler->HandleCommands(payload, header.size) == nullptr) {
+                        return false;
+                    }
+                } break;
+
+                case Padding:
+                    break;
+
+                case Chunk:
+                case LastChunk: {
+                    ASSERT(mLargeBatch.size() <= mMaxBatchSize);
+                    if (header.size > mMaxBatchSize - mLargeBatch.size()) {
+                        mLargeBatch.clear();
+                        return false;
+                    }
+                    mLargeBatch.insert(mLargeBatch.end(), payload, payload + header.size);
+                    if (header.type == LastChunk) {
+                        bool success =
+                            handler->HandleCommands(mLargeBatch.data(), mLargeBatch.size()) !=
+                            nullptr;
+                        mLargeBatch.clear();
+                        if (!success) {
+                            return false;
+                        }
+                    }
+                } break;
+
+                default:
+                    return false;
+            }
+
+            // Release the record's space to the serializer once it is handled.
+            mRead += recordSize;
+            mRing->mHeader->read.store(mRead, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+}  // namespace dawn_wire
@@ -0,0 +1,248 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/SharedMemory.h"
+
+#include "common/Compiler.h"
+#include "common/Platform.h"
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+#    include "common/windows_with_undefs.h"
+#elif defined(DAWN_PLATFORM_POSIX)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    if defined(DAWN_PLATFORM_LINUX)
+#        include <sys/syscall.h>
+// File sealing isn't defined by older C libraries.
+#        if !defined(F_ADD_SEALS)
+#            define F_ADD_SEALS 1033
+#            define F_GET_SEALS 1034
+#            define F_SEAL_SEAL 0x0001
+#            define F_SEAL_SHRINK 0x0002
+#            define F_SEAL_GROW 0x0004
+#        endif
+#    endif
+#    if defined(DAWN_PLATFORM_ANDROID)
+#        include <linux/ashmem.h>
+#        include <sys/ioctl.h>
+#    endif
+#    if !defined(DAWN_PLATFORM_LINUX) && !defined(DAWN_PLATFORM_FUCHSIA)
+#        include <atomic>
+#        include <string>
+#    endif
+#endif
+
+namespace dawn_wire {
+
+    namespace {
+
+        // Zero-sized regions can't be mapped so they are backed by a single byte.
+        size_t GetMappingSize(size_t size) {
+            return size == 0 ? 1 : size;
+        }
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+        constexpr SharedMemoryHandle kInvalidHandle = nullptr;
+
+        void CloseSharedMemoryHandle(SharedMemoryHandle handle) {
+            ::CloseHandle(handle);
+        }
+
+        SharedMemoryHandle CreateSharedMemoryHandle(size_t size) {
+            uint64_t size64 = size;
+            return ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32),
+                                        static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+        }
+
+        void* MapSharedMemory(SharedMemoryHandle handle, size_t size) {
+            // Mapping a view larger than the file mapping fails, which validates |size|.
+            return ::MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        }
+
+        void UnmapSharedMemory(void* data, size_t) {
+            ::UnmapViewOfFile(data);
+        }
+#elif defined(DAWN_PLATFORM_POSIX)
+        constexpr SharedMemoryHandle kInvalidHandle = -1;
+
+        void CloseSharedMemoryHandle(SharedMemoryHandle handle) {
+            close(handle);
+        }
+
+        SharedMemoryHandle CreateSharedMemoryHandle(size_t size) {
+            int fd = -1;
+            bool canSeal = false;
+#    if defined(DAWN_PLATFORM_LINUX)
+            // MFD_CLOEXEC | MFD_ALLOW_SEALING is 3, memfd_create isn't wrapped by older C
+            // libraries.
+            fd = static_cast<int>(syscall(__NR_memfd_create, "dawn_wire", 3u));
+            canSeal = fd >= 0;
+#        if defined(DAWN_PLATFORM_ANDROID)
+            // Android kernels older than 3.17 don't have memfd but all have ashmem.
+            if (fd < 0) {
+                fd = open("/dev/ashmem", O_RDWR | O_CLOEXEC);
+                if (fd < 0) {
+                    return kInvalidHandle;
+                }
+                if (ioctl(fd, ASHMEM_SET_SIZE, size) < 0) {
+                    close(fd);
+                    return kInvalidHandle;
+                }
+                return fd;
+            }
+#        endif
+#    elif defined(DAWN_PLATFORM_FUCHSIA)
+            // Fuchsia has no POSIX shared memory, the regions would have to be VMOs so creations
+            // always fail.
+#    else
+            // Create a POSIX shared memory object and unlink it immediately so that it is only
+            // reachable through its file descriptors.
+            static std::atomic<uint64_t> sNextId(0);
+            std::string name = "/dawn_wire_" + std::to_string(getpid()) + "_" +
+                               std::to_string(sNextId++);
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (fd >= 0) {
+                shm_unlink(name.c_str());
+            }
+#    endif
+            if (fd < 0) {
+                return kInvalidHandle;
+            }
+
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                close(fd);
+                return kInvalidHandle;
+            }
+
+#    if defined(DAWN_PLATFORM_LINUX)
+            // Seal the size of the memfd so that the server, which only accepts sealed memfds,
+            // knows the region can't shrink while it accesses it.
+            if (canSeal &&
+                fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+                close(fd);
+                return kInvalidHandle;
+            }
+#    else
+            DAWN_UNUSED(canSeal);
+#    endif
+            return fd;
+        }
+
+        // Returns whether the peer that owns the region of |handle| can't shrink it. Otherwise,
+        // it could shrink the region after the size check and make accesses to the mapping
+        // raise SIGBUS.
+        bool RegionCantShrink(SharedMemoryHandle handle) {
+#    if defined(DAWN_PLATFORM_LINUX)
+            int seals = fcntl(handle, F_GET_SEALS);
+            if (seals >= 0) {
+                return (seals & F_SEAL_SHRINK) != 0;
+            }
+#        if defined(DAWN_PLATFORM_ANDROID)
+            // The size of ashmem regions is fixed once they are mapped, and mappings larger than
+            // the region fail.
+            return ioctl(handle, ASHMEM_GET_SIZE, nullptr) > 0;
+#        else
+            return false;
+#        endif
+#    else
+            // POSIX shared memory can't be sealed, the transfer services must only be used with
+            // trusted clients on these platforms.
+            DAWN_UNUSED(handle);
+            return true;
+#    endif
+        }
+
+        void* MapSharedMemory(SharedMemoryHandle handle, size_t size) {
+            // Accessing the mapping past the end of the region would raise SIGBUS, so check that
+            // the region is at least |size| bytes large and stays so.
+            if (!RegionCantShrink(handle)) {
+                return nullptr;
+            }
+
+            size_t regionSize = 0;
+            struct stat regionStat;
+            if (fstat(handle, &regionStat) == 0 && regionStat.st_size > 0) {
+                regionSize = static_cast<size_t>(regionStat.st_size);
+            }
+#    if defined(DAWN_PLATFORM_ANDROID)
+            if (regionSize == 0) {
+                int ashmemSize = ioctl(handle, ASHMEM_GET_SIZE, nullptr);
+                if (ashmemSize > 0) {
+                    regionSize = static_cast<size_t>(ashmemSize);
+                }
+            }
+#    endif
+            if (regionSize < size) {
+                return nullptr;
+            }
+
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+            return data == MAP_FAILED ? nullptr : data;
+        }
+
+        void UnmapSharedMemory(void* data, size_t size) {
+            munmap(data, size);
+        }
+#endif
+
+    }  // anonymous namespace
+
+    // static
+    std::unique_ptr<SharedMemory> SharedMemory::Create(size_t size) {
+        SharedMemoryHandle handle = CreateSharedMemoryHandle(GetMappingSize(size));
+        if (handle == kInvalidHandle) {
+            return nullptr;
+        }
+        return Import(handle, size);
+    }
+
+    // static
+    std::unique_ptr<SharedMemory> SharedMemory::Import(SharedMemoryHandle handle, size_t size) {
+        if (handle == kInvalidHandle) {
+            return nullptr;
+        }
+
+        void* data = MapSharedMemory(handle, GetMappingSize(size));
+        if (data == nullptr) {
+            CloseSharedMemoryHandle(handle);
+            return nullptr;
+        }
+        return std::unique_ptr<SharedMemory>(new SharedMemory(handle, data, size));
+    }
+
+    SharedMemory::SharedMemory(SharedMemoryHandle handle, void* data, size_t size)
+        : mHandle(handle), mData(data), mSize(size) {
+    }
+
+    SharedMemory::~SharedMemory() {
+        UnmapSharedMemory(mData, GetMappingSize(mSize));
+        CloseSharedMemoryHandle(mHandle);
+    }
+
+    SharedMemoryHandle SharedMemory::GetHandle() const {
+        return mHandle;
+    }
+
+    void* SharedMemory::GetData() const {
+        return mData;
+    }
+
+    size_t SharedMemory::GetSize() const {
+        return mSize;
+    }
+
+}  // namespace dawn_wire
@@ -0,0 +1,79 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_SHAREDMEMORY_H_
+#define DAWNWIRE_SHAREDMEMORY_H_
+
+#include "dawn_wire/SharedMemoryTransferService.h"
+
+#include <atomic>
+#include <memory>
+
+namespace dawn_wire {
+
+    // Serialized by the client to create the handles of the shared memory transfer services.
+    struct SharedMemoryHandleCreateInfo {
+        uint64_t id;
+        uint64_t size;
+        // The size of the transfer region the handle is sub-allocated from and the offset of the
+        // handle's data in it. Both are 0 for handles that have a region of their own.
+        uint64_t regionSize;
+        uint64_t offset;
+    };
+
+    // Serialized as the initial data of ReadHandles and as the flushes of WriteHandles, the data
+    // itself is in the shared memory.
+    struct SharedMemoryHandleDataInfo {
+        uint64_t dataLength;
+        // The serial of the flush of a sub-allocated WriteHandle, 0 otherwise.
+        uint64_t serial;
+    };
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                  "Transfer region serials must be lock-free to be shared between processes");
+
+    // The start of a transfer region. The server stores the serial of the last WriteHandle flush
+    // it copied the data of, so that the client knows when it can reuse the handle's range.
+    struct SharedMemoryTransferRegionHeader {
+        std::atomic<uint64_t> completedSerial;
+    };
+    constexpr size_t kTransferRegionAlignment = 256;
+
+    // A mapping of a shared memory region and the handle to the region.
+    class SharedMemory {
+      public:
+        // Creates a zero-initialized region of |size| bytes. Returns nullptr on failure.
+        static std::unique_ptr<SharedMemory> Create(size_t size);
+
+        // Maps the first |size| bytes of the region of |handle|, taking the ownership of the
+        // handle. Returns nullptr if the region is smaller than |size| or can't be mapped.
+        static std::unique_ptr<SharedMemory> Import(SharedMemoryHandle handle, size_t size);
+
+        ~SharedMemory();
+
+        SharedMemoryHandle GetHandle() const;
+        void* GetData() const;
+        size_t GetSize() const;
+
+      private:
+        SharedMemory(SharedMemoryHandle handle, void* data, size_t size);
+
+        SharedMemoryHandle mHandle;
+        void* mData;
+        size_t mSize;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_SHAREDMEMORY_H_
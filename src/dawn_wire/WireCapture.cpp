@@ -0,0 +1,97 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/WireCapture.h"
+
+namespace dawn_wire {
+
+    WireCaptureRecorder::WireCaptureRecorder(const char* path, CommandHandler* handler)
+        : mFile(path, std::ios::out | std::ios::binary | std::ios::trunc), mHandler(handler) {
+        uint32_t header[2] = {kWireCaptureMagic, kWireCaptureVersion};
+        mFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    WireCaptureRecorder::~WireCaptureRecorder() = default;
+
+    void WireCaptureRecorder::SetHandler(CommandHandler* handler) {
+        mHandler = handler;
+    }
+
+    bool WireCaptureRecorder::IsValid() const {
+        return mFile.good();
+    }
+
+    const volatile char* WireCaptureRecorder::HandleCommands(const volatile char* commands,
+                                                             size_t size) {
+        // A failed write doesn't stop the application, the capture only stops being valid.
+        if (size > 0 && mFile.good()) {
+            uint64_t batchSize = size;
+            mFile.write(reinterpret_cast<const char*>(&batchSize), sizeof(batchSize));
+            mFile.write(const_cast<const char*>(commands), size);
+            mFile.flush();
+        }
+
+        if (mHandler == nullptr) {
+            return commands + size;
+        }
+        return mHandler->HandleCommands(commands, size);
+    }
+
+    WireCaptureReader::WireCaptureReader(const char* path)
+        : mFile(path, std::ios::in | std::ios::binary) {
+        mFile.seekg(0, std::ios::end);
+        std::streamoff fileSize = mFile.tellg();
+        mFile.seekg(0, std::ios::beg);
+
+        uint32_t header[2] = {};
+        mFile.read(reinterpret_cast<char*>(header), sizeof(header));
+        mIsValid = mFile.good() && header[0] == kWireCaptureMagic &&
+                   header[1] == kWireCaptureVersion;
+        if (mIsValid) {
+            mRemainingSize = static_cast<uint64_t>(fileSize) - sizeof(header);
+        }
+    }
+
+    WireCaptureReader::~WireCaptureReader() = default;
+
+    bool WireCaptureReader::IsValid() const {
+        return mIsValid;
+    }
+
+    bool WireCaptureReader::ReadBatch(std::vector<char>* commands) {
+        if (!mIsValid) {
+            return false;
+        }
+
+        uint64_t batchSize = 0;
+        if (mRemainingSize < sizeof(batchSize)) {
+            return false;
+        }
+        mFile.read(reinterpret_cast<char*>(&batchSize), sizeof(batchSize));
+        mRemainingSize -= sizeof(batchSize);
+
+        // Check the size against the rest of the file so that a corrupted size doesn't allocate
+        // more than the file.
+        if (!mFile.good() || batchSize == 0 || batchSize > mRemainingSize) {
+            mIsValid = false;
+            return false;
+        }
+        mRemainingSize -= batchSize;
+
+        commands->resize(static_cast<size_t>(batchSize));
+        mFile.read(commands->data(), static_cast<std::streamsize>(batchSize));
+        return mFile.good();
+    }
+
+}  // namespace dawn_wire
@@ -18,7 +18,12 @@
 namespace dawn_wire {
 
     WireClient::WireClient(const WireClientDescriptor& descriptor)
-        : mImpl(new client::Client(descriptor.serializer, descriptor.memoryTransferService)) {
+        : mImpl(new client::Client(descriptor.serializer,
+                                   descriptor.memoryTransferService,
+                                   descriptor.useCompactEncoding,
+                                   descriptor.useClientValidation,
+                                   descriptor.collectStatistics,
+                                   descriptor.useCommandStreams)) {
     }
 
     WireClient::~WireClient() {
@@ -42,6 +47,30 @@ namespace dawn_wire {
         return mImpl->ReserveTexture(device);
     }
 
+    WireStatistics WireClient::GetStatistics() const {
+        return mImpl->GetStatistics();
+    }
+
+    void WireClient::ResetStatistics() {
+        mImpl->ResetStatistics();
+    }
+
+    void WireClient::BeginThreadCommandStream() {
+        mImpl->BeginThreadCommandStream();
+    }
+
+    void WireClient::FlushThreadCommandStream() {
+        mImpl->FlushCommandStream();
+    }
+
+    void WireClient::EndThreadCommandStream() {
+        mImpl->EndThreadCommandStream();
+    }
+
+    bool WireClient::Flush() {
+        return mImpl->Flush();
+    }
+
     namespace client {
         MemoryTransferService::~MemoryTransferService() = default;
 
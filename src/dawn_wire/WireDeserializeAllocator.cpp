@@ -17,12 +17,17 @@
 #include <algorithm>
 
 namespace dawn_wire {
+    namespace {
+        // Blocks larger than this are freed on Reset instead of being kept for the next commands.
+        constexpr size_t kMaxRetainedBlockSize = 1024 * 1024;
+    }  // anonymous namespace
+
     WireDeserializeAllocator::WireDeserializeAllocator() {
         Reset();
     }
 
     WireDeserializeAllocator::~WireDeserializeAllocator() {
-        Reset();
+        FreeBlocks();
     }
 
     void* WireDeserializeAllocator::GetSpace(size_t size) {
@@ -34,27 +39,51 @@ namespace dawn_wire {
             return buffer;
         }
 
-        // Otherwise allocate a new buffer and try again.
-        size_t allocationSize = std::max(size, size_t(2048));
-        char* allocation = static_cast<char*>(malloc(allocationSize));
-        if (allocation == nullptr) {
-            return nullptr;
+        // Otherwise reuse a block kept from the previous commands that is large enough, or
+        // allocate a new one, and try again.
+        auto unusedBlocks = mBlocks.begin() + mNextBlock;
+        auto block = std::find_if(unusedBlocks, mBlocks.end(),
+                                  [size](const Block& block) { return block.size >= size; });
+        if (block != mBlocks.end()) {
+            std::iter_swap(unusedBlocks, block);
+        } else {
+            size_t allocationSize = std::max(size, size_t(2048));
+            char* allocation = static_cast<char*>(malloc(allocationSize));
+            if (allocation == nullptr) {
+                return nullptr;
+            }
+            mBlocks.insert(unusedBlocks, {allocation, allocationSize});
         }
 
-        mAllocations.push_back(allocation);
-        mCurrentBuffer = allocation;
-        mRemainingSize = allocationSize;
+        mCurrentBuffer = mBlocks[mNextBlock].data;
+        mRemainingSize = mBlocks[mNextBlock].size;
+        mNextBlock++;
         return GetSpace(size);
     }
 
     void WireDeserializeAllocator::Reset() {
-        for (auto allocation : mAllocations) {
-            free(allocation);
+        // Only the blocks used by the last command can be too large to keep.
+        for (size_t i = 0; i < mNextBlock;) {
+            if (mBlocks[i].size > kMaxRetainedBlockSize) {
+                free(mBlocks[i].data);
+                mBlocks.erase(mBlocks.begin() + i);
+                mNextBlock--;
+            } else {
+                i++;
+            }
         }
-        mAllocations.clear();
+        mNextBlock = 0;
 
         // The initial buffer is the inline buffer so that some allocations can be skipped
         mCurrentBuffer = mStaticBuffer;
         mRemainingSize = sizeof(mStaticBuffer);
     }
+
+    void WireDeserializeAllocator::FreeBlocks() {
+        for (const Block& block : mBlocks) {
+            free(block.data);
+        }
+        mBlocks.clear();
+        mNextBlock = 0;
+    }
 }  // namespace dawn_wire
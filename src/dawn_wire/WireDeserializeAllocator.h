@@ -22,7 +22,8 @@
 namespace dawn_wire {
     // A really really simple implementation of the DeserializeAllocator. It's main feature
     // is that it has some inline storage so as to avoid allocations for the majority of
-    // commands.
+    // commands. The blocks allocated when the inline storage is exhausted are kept on Reset and
+    // reused by the next commands, except the very large ones.
     class WireDeserializeAllocator : public DeserializeAllocator {
       public:
         WireDeserializeAllocator();
@@ -33,10 +34,19 @@ namespace dawn_wire {
         void Reset();
 
       private:
+        struct Block {
+            char* data;
+            size_t size;
+        };
+
+        void FreeBlocks();
+
         size_t mRemainingSize = 0;
         char* mCurrentBuffer = nullptr;
         char mStaticBuffer[2048];
-        std::vector<char*> mAllocations;
+        // The blocks before mNextBlock are used since the last Reset.
+        std::vector<Block> mBlocks;
+        size_t mNextBlock = 0;
     };
 }  // namespace dawn_wire
 
@@ -21,7 +21,9 @@ namespace dawn_wire {
         : mImpl(new server::Server(descriptor.device,
                                    *descriptor.procs,
                                    descriptor.serializer,
-                                   descriptor.memoryTransferService)) {
+                                   descriptor.memoryTransferService,
+                                   descriptor.collectStatistics,
+                                   descriptor.allowObjectIdGaps)) {
     }
 
     WireServer::~WireServer() {
@@ -36,6 +38,14 @@ namespace dawn_wire {
         return mImpl->InjectTexture(texture, id, generation);
     }
 
+    WireStatistics WireServer::GetStatistics() const {
+        return mImpl->GetStatistics();
+    }
+
+    void WireServer::ResetStatistics() {
+        mImpl->ResetStatistics();
+    }
+
     namespace server {
         MemoryTransferService::~MemoryTransferService() = default;
 
@@ -0,0 +1,111 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/WireServerThread.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+
+namespace dawn_wire {
+
+    WireServerThread::WireServerThread(const WireServerThreadDescriptor& descriptor)
+        : mServer(descriptor.server),
+          mReturnSerializer(descriptor.returnSerializer),
+          mThread([this]() { Run(); }) {
+        ASSERT(mServer != nullptr);
+    }
+
+    WireServerThread::~WireServerThread() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWorkAvailable.notify_one();
+        mThread.join();
+    }
+
+    const volatile char* WireServerThread::HandleCommands(const volatile char* commands,
+                                                          size_t size) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mFailed) {
+                return nullptr;
+            }
+        }
+
+        // The commands may be in memory that the client reuses once this returns.
+        Work work;
+        work.commands.resize(size);
+        std::copy(commands, commands + size, work.commands.data());
+        Push(std::move(work));
+
+        return commands + size;
+    }
+
+    void WireServerThread::PostTask(std::function<void()> task) {
+        Work work;
+        work.task = std::move(task);
+        Push(std::move(work));
+    }
+
+    bool WireServerThread::Wait() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkDone.wait(lock, [this]() { return mPendingWork.empty() && !mBusy; });
+        return !mFailed;
+    }
+
+    void WireServerThread::Push(Work work) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPendingWork.push_back(std::move(work));
+        }
+        mWorkAvailable.notify_one();
+    }
+
+    void WireServerThread::Run() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mWorkAvailable.wait(lock, [this]() { return mStopping || !mPendingWork.empty(); });
+            if (mPendingWork.empty()) {
+                ASSERT(mStopping);
+                return;
+            }
+
+            Work work = std::move(mPendingWork.front());
+            mPendingWork.pop_front();
+            bool failed = mFailed;
+            mBusy = true;
+            lock.unlock();
+
+            if (work.task) {
+                work.task();
+            } else if (!failed) {
+                failed = mServer->HandleCommands(work.commands.data(), work.commands.size()) ==
+                         nullptr;
+                if (mReturnSerializer != nullptr) {
+                    mReturnSerializer->Flush();
+                }
+            }
+
+            lock.lock();
+            mFailed = failed;
+            mBusy = false;
+            if (mPendingWork.empty()) {
+                mWorkDone.notify_all();
+            }
+        }
+    }
+
+}  // namespace dawn_wire
@@ -0,0 +1,104 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/WireStatisticsRecorder.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace dawn_wire {
+
+    std::string WireStatistics::ToString() const {
+        std::ostringstream stream;
+        stream << batchCount << " batches, " << bytes << " bytes\n";
+        for (const WireCommandStatistics& command : commands) {
+            stream << "  " << std::left << std::setw(48) << command.name << std::right
+                   << std::setw(10) << command.count << " commands " << std::setw(14)
+                   << command.bytes << " bytes\n";
+        }
+
+        stream << "Batch latency:\n";
+        for (size_t i = 0; i < kLatencyBucketCount; ++i) {
+            if (batchLatencyHistogram[i] == 0) {
+                continue;
+            }
+            if (i + 1 < kLatencyBucketCount) {
+                stream << "  < " << std::setw(9) << (uint64_t(1) << i) << "us";
+            } else {
+                stream << "  >= " << std::setw(8) << (uint64_t(1) << (i - 1)) << "us";
+            }
+            stream << std::setw(10) << batchLatencyHistogram[i] << "\n";
+        }
+        return stream.str();
+    }
+
+    WireStatisticsRecorder::WireStatisticsRecorder(uint32_t commandCount,
+                                                   GetCommandName getCommandName)
+        : mCommandCount(commandCount),
+          mGetCommandName(getCommandName),
+          mCommands(new CommandCounters[commandCount]) {
+        for (std::atomic<uint64_t>& bucket : mBatchLatencies) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void WireStatisticsRecorder::RecordBatch(std::chrono::steady_clock::duration duration) {
+        uint64_t microseconds =
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+        // The first bucket holds the batches under a microsecond.
+        size_t bucket = microseconds == 0 ? 0 : Log2(microseconds) + 1;
+        bucket = std::min(bucket, WireStatistics::kLatencyBucketCount - 1);
+        mBatchLatencies[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    WireStatistics WireStatisticsRecorder::GetStatistics() const {
+        WireStatistics statistics;
+        for (uint32_t i = 0; i < mCommandCount; ++i) {
+            uint64_t count = mCommands[i].count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            uint64_t bytes = mCommands[i].bytes.load(std::memory_order_relaxed);
+            statistics.commands.push_back({mGetCommandName(i), count, bytes});
+            statistics.bytes += bytes;
+        }
+        std::sort(statistics.commands.begin(), statistics.commands.end(),
+                  [](const WireCommandStatistics& a, const WireCommandStatistics& b) {
+                      return a.bytes > b.bytes;
+                  });
+
+        for (size_t i = 0; i < WireStatistics::kLatencyBucketCount; ++i) {
+            statistics.batchLatencyHistogram[i] =
+                mBatchLatencies[i].load(std::memory_order_relaxed);
+            statistics.batchCount += statistics.batchLatencyHistogram[i];
+        }
+        return statistics;
+    }
+
+    void WireStatisticsRecorder::Reset() {
+        for (uint32_t i = 0; i < mCommandCount; ++i) {
+            mCommands[i].count.store(0, std::memory_order_relaxed);
+            mCommands[i].bytes.store(0, std::memory_order_relaxed);
+        }
+        for (std::atomic<uint64_t>& bucket : mBatchLatencies) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+}  // namespace dawn_wire
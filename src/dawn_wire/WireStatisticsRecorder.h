@@ -0,0 +1,61 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_WIRESTATISTICSRECORDER_H_
+#define DAWNWIRE_WIRESTATISTICSRECORDER_H_
+
+#include "common/Assert.h"
+#include "dawn_wire/WireStatistics.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace dawn_wire {
+
+    // Records the number of bytes of each type of command and the time it took to handle each
+    // batch of commands. The commands are recorded by the thread handling them while the
+    // statistics can be queried and reset from any thread.
+    class WireStatisticsRecorder {
+      public:
+        using GetCommandName = const char* (*)(uint32_t command);
+
+        WireStatisticsRecorder(uint32_t commandCount, GetCommandName getCommandName);
+
+        void RecordCommand(uint32_t command, size_t bytes) {
+            ASSERT(command < mCommandCount);
+            mCommands[command].count.fetch_add(1, std::memory_order_relaxed);
+            mCommands[command].bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        void RecordBatch(std::chrono::steady_clock::duration duration);
+
+        WireStatistics GetStatistics() const;
+        void Reset();
+
+      private:
+        struct CommandCounters {
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> bytes{0};
+        };
+
+        uint32_t mCommandCount;
+        GetCommandName mGetCommandName;
+        std::unique_ptr<CommandCounters[]> mCommands;
+        std::array<std::atomic<uint64_t>, WireStatistics::kLatencyBucketCount> mBatchLatencies;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_WIRESTATISTICSRECORDER_H_
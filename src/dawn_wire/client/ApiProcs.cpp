@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "common/Constants.h"
 #include "dawn_wire/client/ApiObjects.h"
 #include "dawn_wire/client/ApiProcs_autogen.h"
 #include "dawn_wire/client/Client.h"
@@ -44,12 +45,86 @@ namespace dawn_wire { namespace client {
             // Serialize the handle into the space after the command.
             handle->SerializeCreate(allocatedBuffer + commandSize);
         }
+
+        // The wire always transfers the whole buffer, ranged maps only adjust what is given to
+        // the application callback.
+        template <typename Callback>
+        struct RangeMapRequest {
+            Callback callback;
+            void* userdata;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        bool IsRangeInBuffer(const Buffer* buffer, uint64_t offset, uint64_t size) {
+            return size <= buffer->size && offset <= buffer->size - size;
+        }
+
+        // The client validation only does the checks that depend on what the client knows of the
+        // buffer, so the commands it rejects would also be rejected by the server. These return
+        // the validation error message, or nullptr if the command is valid for the client.
+        const char* ValidateBufferMap(const Buffer* buffer, WGPUBufferUsage requiredUsage) {
+            if (buffer->destroyed) {
+                return "Buffer is destroyed";
+            }
+            if (!(buffer->usage & requiredUsage)) {
+                return "Buffer needs the correct map usage bit";
+            }
+            return nullptr;
+        }
+
+        const char* ValidateBufferWrite(const Buffer* buffer, uint64_t offset, uint64_t size) {
+            if (buffer->destroyed) {
+                return "Buffer is destroyed";
+            }
+            if (offset % 4 != 0 || size % 4 != 0) {
+                return "Buffer writes must have an offset and size multiple of 4 bytes";
+            }
+            if (!IsRangeInBuffer(buffer, offset, size)) {
+                return "Buffer write out of range";
+            }
+            if (!(buffer->usage & WGPUBufferUsage_CopyDst)) {
+                return "Buffer needs the CopyDst usage bit";
+            }
+            return nullptr;
+        }
+
+        // Returns true if the client validation is enabled and |error| was injected in the
+        // device, in which case the command must not be sent.
+        bool ConsumedClientValidationError(const Buffer* buffer, const char* error) {
+            if (error == nullptr || !buffer->device->GetClient()->UseClientValidation()) {
+                return false;
+            }
+            ClientDeviceInjectError(reinterpret_cast<WGPUDevice>(buffer->device),
+                                    WGPUErrorType_Validation, error);
+            return true;
+        }
+
+        template <typename Callback, typename Pointer, typename BytePointer>
+        void ForwardRangeMapCallback(WGPUBufferMapAsyncStatus status,
+                                     Pointer data,
+                                     uint64_t dataLength,
+                                     void* userdata) {
+            std::unique_ptr<RangeMapRequest<Callback>> request(
+                static_cast<RangeMapRequest<Callback>*>(userdata));
+            if (status == WGPUBufferMapAsyncStatus_Success) {
+                request->callback(status, static_cast<BytePointer>(data) + request->offset,
+                                  request->size, request->userdata);
+            } else {
+                request->callback(status, data, dataLength, request->userdata);
+            }
+        }
     }  // namespace
 
     void ClientBufferMapReadAsync(WGPUBuffer cBuffer,
                                   WGPUBufferMapReadCallback callback,
                                   void* userdata) {
         Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (ConsumedClientValidationError(
+                buffer, ValidateBufferMap(buffer, WGPUBufferUsage_MapRead))) {
+            callback(WGPUBufferMapAsyncStatus_Error, nullptr, 0, userdata);
+            return;
+        }
 
         uint32_t serial = buffer->requestSerial++;
         ASSERT(buffer->requests.find(serial) == buffer->requests.end());
@@ -80,6 +155,11 @@ namespace dawn_wire { namespace client {
                                    WGPUBufferMapWriteCallback callback,
                                    void* userdata) {
         Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (ConsumedClientValidationError(
+                buffer, ValidateBufferMap(buffer, WGPUBufferUsage_MapWrite))) {
+            callback(WGPUBufferMapAsyncStatus_Error, nullptr, 0, userdata);
+            return;
+        }
 
         uint32_t serial = buffer->requestSerial++;
         ASSERT(buffer->requests.find(serial) == buffer->requests.end());
@@ -107,16 +187,54 @@ namespace dawn_wire { namespace client {
         SerializeBufferMapAsync(buffer, serial, writeHandle);
     }
 
+    void ClientBufferMapReadRangeAsync(WGPUBuffer cBuffer,
+                                       uint64_t offset,
+                                       uint64_t size,
+                                       WGPUBufferMapReadCallback callback,
+                                       void* userdata) {
+        Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (!IsRangeInBuffer(buffer, offset, size)) {
+            callback(WGPUBufferMapAsyncStatus_Error, nullptr, 0, userdata);
+            return;
+        }
+
+        auto* request =
+            new RangeMapRequest<WGPUBufferMapReadCallback>{callback, userdata, offset, size};
+        ClientBufferMapReadAsync(
+            cBuffer,
+            ForwardRangeMapCallback<WGPUBufferMapReadCallback, const void*, const uint8_t*>,
+            request);
+    }
+
+    void ClientBufferMapWriteRangeAsync(WGPUBuffer cBuffer,
+                                        uint64_t offset,
+                                        uint64_t size,
+                                        WGPUBufferMapWriteCallback callback,
+                                        void* userdata) {
+        Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (!IsRangeInBuffer(buffer, offset, size)) {
+            callback(WGPUBufferMapAsyncStatus_Error, nullptr, 0, userdata);
+            return;
+        }
+
+        auto* request =
+            new RangeMapRequest<WGPUBufferMapWriteCallback>{callback, userdata, offset, size};
+        ClientBufferMapWriteAsync(
+            cBuffer, ForwardRangeMapCallback<WGPUBufferMapWriteCallback, void*, uint8_t*>, request);
+    }
+
     WGPUBuffer ClientDeviceCreateBuffer(WGPUDevice cDevice,
                                         const WGPUBufferDescriptor* descriptor) {
         Device* device = reinterpret_cast<Device*>(cDevice);
         Client* wireClient = device->GetClient();
 
-        auto* bufferObjectAndSerial = wireClient->BufferAllocator().New(device);
+        auto* bufferObjectAndSerial =
+            wireClient->BufferAllocator().New(device, wireClient->GetCommandStream());
         Buffer* buffer = bufferObjectAndSerial->object.get();
         // Store the size of the buffer so that mapping operations can allocate a
         // MemoryTransfer handle of the proper size.
         buffer->size = descriptor->size;
+        buffer->usage = descriptor->usage;
 
         DeviceCreateBufferCmd cmd;
         cmd.self = cDevice;
@@ -136,9 +254,11 @@ namespace dawn_wire { namespace client {
         Device* device = reinterpret_cast<Device*>(cDevice);
         Client* wireClient = device->GetClient();
 
-        auto* bufferObjectAndSerial = wireClient->BufferAllocator().New(device);
+        auto* bufferObjectAndSerial =
+            wireClient->BufferAllocator().New(device, wireClient->GetCommandStream());
         Buffer* buffer = bufferObjectAndSerial->object.get();
         buffer->size = descriptor->size;
+        buffer->usage = descriptor->usage;
 
         WGPUCreateBufferMappedResult result;
         result.buffer = reinterpret_cast<WGPUBuffer>(buffer);
@@ -197,9 +317,11 @@ namespace dawn_wire { namespace client {
         Device* device = reinterpret_cast<Device*>(cDevice);
         Client* wireClient = device->GetClient();
 
-        auto* bufferObjectAndSerial = wireClient->BufferAllocator().New(device);
+        auto* bufferObjectAndSerial =
+            wireClient->BufferAllocator().New(device, wireClient->GetCommandStream());
         Buffer* buffer = bufferObjectAndSerial->object.get();
         buffer->size = descriptor->size;
+        buffer->usage = descriptor->usage;
 
         uint32_t serial = buffer->requestSerial++;
 
@@ -264,6 +386,43 @@ namespace dawn_wire { namespace client {
         writeHandle->SerializeCreate(allocatedBuffer + commandSize);
     }
 
+    void ClientDeviceCreateRayTracingAccelerationContainerAsync(
+        WGPUDevice cDevice,
+        const WGPURayTracingAccelerationContainerDescriptor* descriptor,
+        WGPURayTracingAccelerationContainerCreateCallback callback,
+        void* userdata) {
+        // Object creation is already pipelined on the wire: the container can be used as soon as
+        // its id is allocated and errors surface through the device's error callbacks.
+        WGPURayTracingAccelerationContainer container =
+            ClientDeviceCreateRayTracingAccelerationContainer(cDevice, descriptor);
+        callback(WGPURayTracingAccelerationContainerCreateStatus_Success, container, userdata);
+    }
+
+    void ClientDeviceCreateRayTracingPipelineAsync(WGPUDevice cDevice,
+                                                   const WGPURayTracingPipelineDescriptor* descriptor,
+                                                   WGPURayTracingPipelineCreateCallback callback,
+                                                   void* userdata) {
+        // Like acceleration containers, pipelines can be used as soon as their id is allocated.
+        WGPURayTracingPipeline pipeline = ClientDeviceCreateRayTracingPipeline(cDevice, descriptor);
+        callback(WGPURayTracingPipelineCreateStatus_Success, pipeline, userdata);
+    }
+
+    void ClientDeviceCreateRenderPipelineAsync(WGPUDevice cDevice,
+                                               const WGPURenderPipelineDescriptor* descriptor,
+                                               WGPURenderPipelineCreateCallback callback,
+                                               void* userdata) {
+        WGPURenderPipeline pipeline = ClientDeviceCreateRenderPipeline(cDevice, descriptor);
+        callback(WGPURenderPipelineCreateStatus_Success, pipeline, userdata);
+    }
+
+    void ClientDeviceCreateShaderModuleAsync(WGPUDevice cDevice,
+                                             const WGPUShaderModuleDescriptor* descriptor,
+                                             WGPUShaderModuleCreateCallback callback,
+                                             void* userdata) {
+        WGPUShaderModule shaderModule = ClientDeviceCreateShaderModule(cDevice, descriptor);
+        callback(WGPUShaderModuleCreateStatus_Success, shaderModule, userdata);
+    }
+
     void ClientDevicePushErrorScope(WGPUDevice cDevice, WGPUErrorFilter filter) {
         Device* device = reinterpret_cast<Device*>(cDevice);
         device->PushErrorScope(filter);
@@ -303,11 +462,102 @@ namespace dawn_wire { namespace client {
         fence->requests.Enqueue(std::move(request), value);
     }
 
+    void ClientDeviceGetRayTracingAccelerationContainerHandles(
+        WGPUDevice,
+        uint32_t containerCount,
+        WGPURayTracingAccelerationContainer const* cContainers,
+        uint64_t* handles) {
+        // Like ClientRayTracingAccelerationContainerGetHandle, the handles last retrieved with
+        // getHandleAsync are returned.
+        for (uint32_t i = 0; i < containerCount; ++i) {
+            auto* container = reinterpret_cast<RayTracingAccelerationContainer*>(cContainers[i]);
+            handles[i] = container->handle;
+        }
+    }
+
+    void ClientDeviceGetMemoryUsage(WGPUDevice, WGPUMemoryUsage* usage) {
+        // Memory is tracked on the server side and isn't sent back to the client.
+        *usage = {};
+    }
+
+    void ClientDeviceGetRayTracingAccelerationInstanceLayout(
+        WGPUDevice,
+        WGPURayTracingAccelerationInstanceLayout* layout) {
+        // The layout is the same for all the backends, so it doesn't need the server.
+        layout->size = kAccelerationInstanceSize;
+        layout->offsetAlignment = kAccelerationInstanceOffsetAlignment;
+        layout->transformOffset = kAccelerationInstanceTransformOffset;
+        layout->instanceIdAndMaskOffset = kAccelerationInstanceIdAndMaskOffset;
+        layout->instanceOffsetAndFlagsOffset = kAccelerationInstanceOffsetAndFlagsOffset;
+        layout->geometryContainerHandleOffset = kAccelerationInstanceHandleOffset;
+    }
+
+    uint32_t ClientDeviceGetMemoryTypeUsages(WGPUDevice, uint32_t, WGPUMemoryTypeUsage*) {
+        // Memory is tracked on the server side and isn't sent back to the client.
+        return 0;
+    }
+
+    void ClientRayTracingAccelerationContainerGetBuildInfo(
+        WGPURayTracingAccelerationContainer,
+        WGPURayTracingAccelerationContainerGetBuildInfoCallback callback,
+        void* userdata) {
+        // The build info is gathered on the server side, like the statistics.
+        callback(WGPURayTracingAccelerationContainerGetBuildInfoStatus_Unknown, {}, userdata);
+    }
+
+    bool ClientRayTracingAccelerationContainerIsEvicted(WGPURayTracingAccelerationContainer) {
+        // Like the statistics, the residency is only known on the server side.
+        return false;
+    }
+
+    uint64_t ClientTransientUniformAllocatorAllocate(WGPUTransientUniformAllocator,
+                                                     const void*,
+                                                     uint64_t) {
+        // The ring is only known on the server side, the allocations are reported as failed so
+        // that the application falls back to its own buffers.
+        return kInvalidTransientUniformOffset;
+    }
+
+    uint64_t ClientRayTracingAccelerationContainerGetHandle(
+        WGPURayTracingAccelerationContainer cContainer) {
+        // Handles live on the server side, so the last one retrieved with getHandleAsync is
+        // returned.
+        auto* container = reinterpret_cast<RayTracingAccelerationContainer*>(cContainer);
+        return container->handle;
+    }
+
+    void ClientRayTracingAccelerationContainerGetHandleAsync(
+        WGPURayTracingAccelerationContainer cContainer,
+        WGPURayTracingAccelerationContainerGetHandleCallback callback,
+        void* userdata) {
+        auto* container = reinterpret_cast<RayTracingAccelerationContainer*>(cContainer);
+
+        uint32_t serial = container->requestSerial++;
+        ASSERT(container->requests.find(serial) == container->requests.end());
+
+        RayTracingAccelerationContainer::HandleRequestData request = {};
+        request.callback = callback;
+        request.userdata = userdata;
+        container->requests[serial] = std::move(request);
+
+        RayTracingAccelerationContainerGetHandleAsyncCmd cmd;
+        cmd.containerId = container->id;
+        cmd.requestSerial = serial;
+
+        size_t requiredSize = cmd.GetRequiredSize();
+        char* allocatedBuffer =
+            static_cast<char*>(container->device->GetClient()->GetCmdSpace(requiredSize));
+        cmd.Serialize(allocatedBuffer);
+    }
+
     void ClientBufferSetSubData(WGPUBuffer cBuffer,
                                 uint64_t start,
                                 uint64_t count,
                                 const void* data) {
         Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (ConsumedClientValidationError(buffer, ValidateBufferWrite(buffer, start, count))) {
+            return;
+        }
 
         BufferSetSubDataInternalCmd cmd;
         cmd.bufferId = buffer->id;
@@ -321,6 +571,31 @@ namespace dawn_wire { namespace client {
         cmd.Serialize(allocatedBuffer);
     }
 
+    void ClientQueueWriteBuffer(WGPUQueue cQueue,
+                                WGPUBuffer cBuffer,
+                                uint64_t bufferOffset,
+                                const void* data,
+                                uint64_t size) {
+        Queue* queue = reinterpret_cast<Queue*>(cQueue);
+        Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        if (ConsumedClientValidationError(buffer,
+                                          ValidateBufferWrite(buffer, bufferOffset, size))) {
+            return;
+        }
+
+        QueueWriteBufferInternalCmd cmd;
+        cmd.queueId = queue->id;
+        cmd.bufferId = buffer->id;
+        cmd.bufferOffset = bufferOffset;
+        cmd.size = size;
+        cmd.data = static_cast<const uint8_t*>(data);
+
+        Client* wireClient = buffer->device->GetClient();
+        size_t requiredSize = cmd.GetRequiredSize();
+        char* allocatedBuffer = static_cast<char*>(wireClient->GetCmdSpace(requiredSize));
+        cmd.Serialize(allocatedBuffer);
+    }
+
     void ClientBufferUnmap(WGPUBuffer cBuffer) {
         Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
 
@@ -368,13 +643,26 @@ namespace dawn_wire { namespace client {
         cmd.Serialize(allocatedBuffer, *buffer->device->GetClient());
     }
 
+    void ClientBufferDestroy(WGPUBuffer cBuffer) {
+        Buffer* buffer = reinterpret_cast<Buffer*>(cBuffer);
+        buffer->destroyed = true;
+
+        BufferDestroyCmd cmd;
+        cmd.self = cBuffer;
+        size_t requiredSize = cmd.GetRequiredSize();
+        char* allocatedBuffer =
+            static_cast<char*>(buffer->device->GetClient()->GetCmdSpace(requiredSize));
+        cmd.Serialize(allocatedBuffer, *buffer->device->GetClient());
+    }
+
     WGPUFence ClientQueueCreateFence(WGPUQueue cSelf, WGPUFenceDescriptor const* descriptor) {
         Queue* queue = reinterpret_cast<Queue*>(cSelf);
         Device* device = queue->device;
 
         QueueCreateFenceCmd cmd;
         cmd.self = cSelf;
-        auto* allocation = device->GetClient()->FenceAllocator().New(device);
+        Client* client = device->GetClient();
+        auto* allocation = client->FenceAllocator().New(device, client->GetCommandStream());
         cmd.result = ObjectHandle{allocation->object->id, allocation->serial};
         cmd.descriptor = descriptor;
 
@@ -417,6 +705,10 @@ namespace dawn_wire { namespace client {
         char* allocatedBuffer =
             static_cast<char*>(fence->device->GetClient()->GetCmdSpace(requiredSize));
         cmd.Serialize(allocatedBuffer, *fence->device->GetClient());
+
+        // Fence signals are ordered like queue submissions, so that the fence completes
+        // without waiting for the command stream to be flushed.
+        fence->device->GetClient()->FlushCommandStream();
     }
 
     void ClientDeviceReference(WGPUDevice) {
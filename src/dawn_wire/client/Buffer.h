@@ -45,6 +45,9 @@ namespace dawn_wire { namespace client {
         std::map<uint32_t, MapRequestData> requests;
         uint32_t requestSerial = 0;
         uint64_t size = 0;
+        // The usage and destroyed state, used for the client validation.
+        WGPUBufferUsageFlags usage = WGPUBufferUsage_None;
+        bool destroyed = false;
 
         // Only one mapped pointer can be active at a time because Unmap clears all the in-flight
         // requests.
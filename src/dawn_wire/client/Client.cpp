@@ -13,29 +13,118 @@
 // limitations under the License.
 
 #include "dawn_wire/client/Client.h"
+
+#include "common/Assert.h"
 #include "dawn_wire/client/Device.h"
 
+#include <cstring>
+
 namespace dawn_wire { namespace client {
 
-    Client::Client(CommandSerializer* serializer, MemoryTransferService* memoryTransferService)
+    namespace {
+
+        thread_local CommandStream* tThreadCommandStream = nullptr;
+
+    }  // anonymous namespace
+
+    Client::Client(CommandSerializer* serializer,
+                   MemoryTransferService* memoryTransferService,
+                   bool useCompactEncoding,
+                   bool useClientValidation,
+                   bool collectStatistics,
+                   bool useCommandStreams)
         : ClientBase(),
           mDevice(DeviceAllocator().New(this)->object.get()),
           mSerializer(serializer),
-          mMemoryTransferService(memoryTransferService) {
+          mMemoryTransferService(memoryTransferService),
+          // The server decodes the compact commands relative to the previous commands it
+          // received, which can come from any command stream.
+          mUseCompactEncoding(useCompactEncoding && !useCommandStreams),
+          mUseClientValidation(useClientValidation),
+          mThreadCommandStreamCount(0) {
         if (mMemoryTransferService == nullptr) {
             // If a MemoryTransferService is not provided, fall back to inline memory.
             mOwnedMemoryTransferService = CreateInlineMemoryTransferService();
             mMemoryTransferService = mOwnedMemoryTransferService.get();
         }
+        if (collectStatistics) {
+            mStatistics = std::make_unique<WireStatisticsRecorder>(
+                kReturnWireCmdCount, [](uint32_t command) {
+                    return GetReturnWireCmdName(static_cast<ReturnWireCmd>(command));
+                });
+        }
+        if (useCommandStreams) {
+            mDefaultCommandStream = std::make_unique<CommandStream>(this);
+        }
     }
 
     Client::~Client() {
+        ASSERT(mThreadCommandStreamCount == 0);
+        if (mDefaultCommandStream != nullptr) {
+            mDefaultCommandStream->Flush();
+        }
         DeviceAllocator().Free(mDevice);
     }
 
+    void* Client::GetCmdSpace(size_t size) {
+        CommandStream* stream = GetCommandStream();
+        if (stream != nullptr) {
+            return stream->GetCmdSpace(size);
+        }
+        return mSerializer->GetCmdSpace(size);
+    }
+
+    CommandStream* Client::GetCommandStream() const {
+        if (tThreadCommandStream != nullptr && tThreadCommandStream->GetClient() == this) {
+            return tThreadCommandStream;
+        }
+        return mDefaultCommandStream.get();
+    }
+
+    void Client::BeginThreadCommandStream() {
+        ASSERT(mDefaultCommandStream != nullptr);
+        ASSERT(tThreadCommandStream == nullptr);
+        tThreadCommandStream = new CommandStream(this);
+        mThreadCommandStreamCount++;
+    }
+
+    void Client::EndThreadCommandStream() {
+        ASSERT(tThreadCommandStream != nullptr && tThreadCommandStream->GetClient() == this);
+        tThreadCommandStream->Flush();
+        delete tThreadCommandStream;
+        tThreadCommandStream = nullptr;
+        mThreadCommandStreamCount--;
+    }
+
+    void Client::FlushCommandStream() {
+        CommandStream* stream = GetCommandStream();
+        if (stream != nullptr) {
+            stream->Flush();
+        }
+    }
+
+    void Client::SerializeCommands(const char* commands, const std::vector<size_t>& commandSizes) {
+        std::lock_guard<std::mutex> lock(mSerializerMutex);
+        for (size_t size : commandSizes) {
+            memcpy(mSerializer->GetCmdSpace(size), commands, size);
+            commands += size;
+        }
+    }
+
+    bool Client::Flush() {
+        if (mDefaultCommandStream == nullptr) {
+            return mSerializer->Flush();
+        }
+
+        mDefaultCommandStream->Flush();
+        std::lock_guard<std::mutex> lock(mSerializerMutex);
+        return mSerializer->Flush();
+    }
+
     ReservedTexture Client::ReserveTexture(WGPUDevice cDevice) {
         Device* device = reinterpret_cast<Device*>(cDevice);
-        ObjectAllocator<Texture>::ObjectAndSerial* allocation = TextureAllocator().New(device);
+        ObjectAllocator<Texture>::ObjectAndSerial* allocation =
+            TextureAllocator().New(device, GetCommandStream());
 
         ReservedTexture result;
         result.texture = reinterpret_cast<WGPUTexture>(allocation->object.get());
@@ -44,4 +133,17 @@ namespace dawn_wire { namespace client {
         return result;
     }
 
+    WireStatistics Client::GetStatistics() const {
+        if (mStatistics == nullptr) {
+            return {};
+        }
+        return mStatistics->GetStatistics();
+    }
+
+    void Client::ResetStatistics() {
+        if (mStatistics != nullptr) {
+            mStatistics->Reset();
+        }
+    }
+
 }}  // namespace dawn_wire::client
@@ -21,7 +21,14 @@
 #include "dawn_wire/WireClient.h"
 #include "dawn_wire/WireCmd_autogen.h"
 #include "dawn_wire/WireDeserializeAllocator.h"
+#include "dawn_wire/WireStatisticsRecorder.h"
 #include "dawn_wire/client/ClientBase_autogen.h"
+#include "dawn_wire/client/CommandStream.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace dawn_wire { namespace client {
 
@@ -30,15 +37,32 @@ namespace dawn_wire { namespace client {
 
     class Client : public ClientBase {
       public:
-        Client(CommandSerializer* serializer, MemoryTransferService* memoryTransferService);
+        Client(CommandSerializer* serializer,
+               MemoryTransferService* memoryTransferService,
+               bool useCompactEncoding,
+               bool useClientValidation,
+               bool collectStatistics,
+               bool useCommandStreams);
         ~Client();
 
         const volatile char* HandleCommands(const volatile char* commands, size_t size);
         ReservedTexture ReserveTexture(WGPUDevice device);
 
-        void* GetCmdSpace(size_t size) {
-            return mSerializer->GetCmdSpace(size);
-        }
+        WireStatistics GetStatistics() const;
+        void ResetStatistics();
+
+        void* GetCmdSpace(size_t size);
+
+        // The command stream of the calling thread for this client, or the default command
+        // stream of the threads without one. Null when the client doesn't use command streams.
+        CommandStream* GetCommandStream() const;
+        void BeginThreadCommandStream();
+        void EndThreadCommandStream();
+        // Flushes the command stream of the calling thread, if the client uses command streams.
+        void FlushCommandStream();
+        // Appends the commands of a command stream to the serializer.
+        void SerializeCommands(const char* commands, const std::vector<size_t>& commandSizes);
+        bool Flush();
 
         WGPUDevice GetDevice() const {
             return reinterpret_cast<WGPUDeviceImpl*>(mDevice);
@@ -48,6 +72,18 @@ namespace dawn_wire { namespace client {
             return mMemoryTransferService;
         }
 
+        bool UseCompactEncoding() const {
+            return mUseCompactEncoding;
+        }
+
+        bool UseClientValidation() const {
+            return mUseClientValidation;
+        }
+
+        CompactCommandState* GetCompactCommandState() {
+            return &mCompactCommandState;
+        }
+
       private:
 #include "dawn_wire/client/ClientPrototypes_autogen.inc"
 
@@ -56,6 +92,15 @@ namespace dawn_wire { namespace client {
         WireDeserializeAllocator mAllocator;
         MemoryTransferService* mMemoryTransferService = nullptr;
         std::unique_ptr<MemoryTransferService> mOwnedMemoryTransferService = nullptr;
+        bool mUseCompactEncoding = false;
+        bool mUseClientValidation = false;
+        CompactCommandState mCompactCommandState;
+        std::unique_ptr<WireStatisticsRecorder> mStatistics;
+
+        // The serializer is only used with the lock held when the client uses command streams.
+        std::mutex mSerializerMutex;
+        std::unique_ptr<CommandStream> mDefaultCommandStream;
+        std::atomic<uint32_t> mThreadCommandStreamCount;
     };
 
     DawnProcTable GetProcs();
@@ -194,4 +194,35 @@ namespace dawn_wire { namespace client {
         return true;
     }
 
+    bool Client::DoRayTracingAccelerationContainerGetHandleAsyncCallback(
+        RayTracingAccelerationContainer* container,
+        uint32_t requestSerial,
+        uint32_t status,
+        uint64_t handle) {
+        // The container might have been deleted or recreated so this isn't an error.
+        if (container == nullptr) {
+            return true;
+        }
+
+        // The requests can have been deleted via a destruction of the container.
+        auto requestIt = container->requests.find(requestSerial);
+        if (requestIt == container->requests.end()) {
+            return true;
+        }
+
+        // Take the data of the request and remove it from the list of requests before calling
+        // the callback, in case it requests the handle again.
+        RayTracingAccelerationContainer::HandleRequestData request = requestIt->second;
+        container->requests.erase(requestIt);
+
+        auto handleStatus = static_cast<WGPURayTracingAccelerationContainerGetHandleStatus>(status);
+        if (handleStatus == WGPURayTracingAccelerationContainerGetHandleStatus_Success) {
+            container->handle = handle;
+        } else {
+            handle = 0;
+        }
+        request.callback(handleStatus, handle, request.userdata);
+        return true;
+    }
+
 }}  // namespace dawn_wire::client
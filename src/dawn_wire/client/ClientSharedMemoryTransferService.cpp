@@ -0,0 +1,352 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Assert.h"
+#include "dawn_wire/SharedMemory.h"
+#include "dawn_wire/SharedMemoryTransferService.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace dawn_wire { namespace client {
+
+    namespace {
+
+        uint64_t AlignToTransferRegion(uint64_t value) {
+            constexpr uint64_t kMask = kTransferRegionAlignment - 1;
+            return (value + kMask) & ~kMask;
+        }
+
+        // A shared memory region that WriteHandles are sub-allocated from. The range of a
+        // destroyed handle is only reused once the server has copied the data of the handle's
+        // last flush, which it signals with the serial in the region's header.
+        class TransferRegion {
+          public:
+            TransferRegion(std::unique_ptr<SharedMemory> memory, uint64_t id)
+                : mMemory(std::move(memory)), mId(id) {
+                mHeader = new (mMemory->GetData()) SharedMemoryTransferRegionHeader();
+                mHeader->completedSerial.store(0, std::memory_order_relaxed);
+
+                uint64_t dataStart = AlignToTransferRegion(sizeof(SharedMemoryTransferRegionHeader));
+                if (mMemory->GetSize() > dataStart) {
+                    mFreeRanges[dataStart] = mMemory->GetSize() - dataStart;
+                }
+            }
+
+            uint64_t GetId() const {
+                return mId;
+            }
+
+            size_t GetSize() const {
+                return mMemory->GetSize();
+            }
+
+            void* GetData(uint64_t offset) const {
+                return static_cast<char*>(mMemory->GetData()) + offset;
+            }
+
+            // Returns false if there is no free range large enough.
+            bool Allocate(size_t size, uint64_t* offset) {
+                ReclaimCompletedRanges();
+
+                uint64_t allocationSize = GetAllocationSize(size);
+                for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it) {
+                    if (it->second < allocationSize) {
+                        continue;
+                    }
+
+                    *offset = it->first;
+                    uint64_t remainingSize = it->second - allocationSize;
+                    mFreeRanges.erase(it);
+                    if (remainingSize > 0) {
+                        mFreeRanges[*offset + allocationSize] = remainingSize;
+                    }
+
+                    // Ranges that were used before must be zero-initialized like new regions.
+                    memset(GetData(*offset), 0, size);
+                    return true;
+                }
+                return false;
+            }
+
+            // |serial| is the serial of the last flush of the handle, or 0 if it wasn't flushed.
+            void Release(uint64_t offset, size_t size, uint64_t serial) {
+                uint64_t allocationSize = GetAllocationSize(size);
+                if (serial <= mHeader->completedSerial.load(std::memory_order_acquire)) {
+                    Free(offset, allocationSize);
+                } else {
+                    mRetiredRanges.push_back({offset, allocationSize, serial});
+                }
+            }
+
+            uint64_t GetNextFlushSerial() {
+                return ++mLastFlushSerial;
+            }
+
+          private:
+            struct RetiredRange {
+                uint64_t offset;
+                uint64_t size;
+                uint64_t serial;
+            };
+
+            static uint64_t GetAllocationSize(size_t size) {
+                return AlignToTransferRegion(std::max(size, size_t(1)));
+            }
+
+            void ReclaimCompletedRanges() {
+                uint64_t completedSerial = mHeader->completedSerial.load(std::memory_order_acquire);
+                auto completed = std::partition(
+                    mRetiredRanges.begin(), mRetiredRanges.end(),
+                    [completedSerial](const RetiredRange& range) {
+                        return range.serial > completedSerial;
+                    });
+                for (auto it = completed; it != mRetiredRanges.end(); ++it) {
+                    Free(it->offset, it->size);
+                }
+                mRetiredRanges.erase(completed, mRetiredRanges.end());
+            }
+
+            // Frees the range and merges it with the free ranges around it.
+            void Free(uint64_t offset, uint64_t size) {
+                auto next = mFreeRanges.lower_bound(offset);
+                if (next != mFreeRanges.end() && offset + size == next->first) {
+                    size += next->second;
+                    next = mFreeRanges.erase(next);
+                }
+                if (next != mFreeRanges.begin()) {
+                    auto previous = std::prev(next);
+                    if (previous->first + previous->second == offset) {
+                        previous->second += size;
+                        return;
+                    }
+                }
+                mFreeRanges[offset] = size;
+            }
+
+            std::unique_ptr<SharedMemory> mMemory;
+            uint64_t mId;
+            SharedMemoryTransferRegionHeader* mHeader;
+
+            // The free ranges keyed by their offset.
+            std::map<uint64_t, uint64_t> mFreeRanges;
+            std::vector<RetiredRange> mRetiredRanges;
+            uint64_t mLastFlushSerial = 0;
+        };
+
+    }  // anonymous namespace
+
+    class SharedMemoryTransferService : public MemoryTransferService {
+        class ReadHandleImpl : public ReadHandle {
+          public:
+            ReadHandleImpl(std::unique_ptr<SharedMemory> memory, uint64_t id)
+                : mMemory(std::move(memory)), mId(id) {
+            }
+
+            ~ReadHandleImpl() override = default;
+
+            size_t SerializeCreateSize() override {
+                return sizeof(SharedMemoryHandleCreateInfo);
+            }
+
+            void SerializeCreate(void* serializePointer) override {
+                SharedMemoryHandleCreateInfo createInfo = {mId, mMemory->GetSize(), 0, 0};
+                memcpy(serializePointer, &createInfo, sizeof(createInfo));
+            }
+
+            bool DeserializeInitialData(const void* deserializePointer,
+                                        size_t deserializeSize,
+                                        const void** data,
+                                        size_t* dataLength) override {
+                if (deserializeSize != sizeof(SharedMemoryHandleDataInfo) ||
+                    deserializePointer == nullptr) {
+                    return false;
+                }
+
+                SharedMemoryHandleDataInfo dataInfo;
+                memcpy(&dataInfo, deserializePointer, sizeof(dataInfo));
+                if (dataInfo.dataLength != mMemory->GetSize()) {
+                    return false;
+                }
+
+                // The server wrote the data in the shared memory, no copy is needed.
+                ASSERT(data != nullptr);
+                ASSERT(dataLength != nullptr);
+                *data = mMemory->GetData();
+                *dataLength = mMemory->GetSize();
+
+                return true;
+            }
+
+          private:
+            std::unique_ptr<SharedMemory> mMemory;
+            uint64_t mId;
+        };
+
+        class WriteHandleImpl : public WriteHandle {
+          public:
+            WriteHandleImpl(std::unique_ptr<SharedMemory> memory, uint64_t id)
+                : mMemory(std::move(memory)), mId(id) {
+            }
+
+            ~WriteHandleImpl() override = default;
+
+            size_t SerializeCreateSize() override {
+                return sizeof(SharedMemoryHandleCreateInfo);
+            }
+
+            void SerializeCreate(void* serializePointer) override {
+                SharedMemoryHandleCreateInfo createInfo = {mId, mMemory->GetSize(), 0, 0};
+                memcpy(serializePointer, &createInfo, sizeof(createInfo));
+            }
+
+            std::pair<void*, size_t> Open() override {
+                // Newly created shared memory is already zero-initialized.
+                return std::make_pair(mMemory->GetData(), mMemory->GetSize());
+            }
+
+            size_t SerializeFlushSize() override {
+                return sizeof(SharedMemoryHandleDataInfo);
+            }
+
+            void SerializeFlush(void* serializePointer) override {
+                ASSERT(serializePointer != nullptr);
+                SharedMemoryHandleDataInfo dataInfo = {mMemory->GetSize(), 0};
+                memcpy(serializePointer, &dataInfo, sizeof(dataInfo));
+            }
+
+          private:
+            std::unique_ptr<SharedMemory> mMemory;
+            uint64_t mId;
+        };
+
+        // A WriteHandle sub-allocated from the transfer region.
+        class TransferRegionWriteHandleImpl : public WriteHandle {
+          public:
+            TransferRegionWriteHandleImpl(std::shared_ptr<TransferRegion> region,
+                                          uint64_t offset,
+                                          size_t size)
+                : mRegion(std::move(region)), mOffset(offset), mSize(size) {
+            }
+
+            ~TransferRegionWriteHandleImpl() override {
+                mRegion->Release(mOffset, mSize, mLastFlushSerial);
+            }
+
+            size_t SerializeCreateSize() override {
+                return sizeof(SharedMemoryHandleCreateInfo);
+            }
+
+            void SerializeCreate(void* serializePointer) override {
+                SharedMemoryHandleCreateInfo createInfo = {mRegion->GetId(), mSize,
+                                                           mRegion->GetSize(), mOffset};
+                memcpy(serializePointer, &createInfo, sizeof(createInfo));
+            }
+
+            std::pair<void*, size_t> Open() override {
+                // The range was zero-initialized when it was allocated.
+                return std::make_pair(mRegion->GetData(mOffset), mSize);
+            }
+
+            size_t SerializeFlushSize() override {
+                return sizeof(SharedMemoryHandleDataInfo);
+            }
+
+            void SerializeFlush(void* serializePointer) override {
+                ASSERT(serializePointer != nullptr);
+                mLastFlushSerial = mRegion->GetNextFlushSerial();
+                SharedMemoryHandleDataInfo dataInfo = {mSize, mLastFlushSerial};
+                memcpy(serializePointer, &dataInfo, sizeof(dataInfo));
+            }
+
+          private:
+            std::shared_ptr<TransferRegion> mRegion;
+            uint64_t mOffset;
+            size_t mSize;
+            uint64_t mLastFlushSerial = 0;
+        };
+
+      public:
+        SharedMemoryTransferService(SharedMemoryExporter* exporter, size_t transferRegionSize)
+            : mExporter(exporter), mTransferRegionSize(transferRegionSize) {
+            ASSERT(mExporter != nullptr);
+        }
+        ~SharedMemoryTransferService() override = default;
+
+        ReadHandle* CreateReadHandle(size_t size) override {
+            uint64_t id = 0;
+            std::unique_ptr<SharedMemory> memory = CreateSharedMemory(size, &id);
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            return new ReadHandleImpl(std::move(memory), id);
+        }
+
+        WriteHandle* CreateWriteHandle(size_t size) override {
+            if (mTransferRegionSize != 0 && mTransferRegion == nullptr) {
+                uint64_t regionId = 0;
+                std::unique_ptr<SharedMemory> regionMemory =
+                    CreateSharedMemory(mTransferRegionSize, &regionId);
+                if (regionMemory != nullptr) {
+                    mTransferRegion =
+                        std::make_shared<TransferRegion>(std::move(regionMemory), regionId);
+                }
+                // Don't retry creating the transfer region when it fails.
+                mTransferRegionSize = 0;
+            }
+
+            uint64_t offset = 0;
+            if (mTransferRegion != nullptr && mTransferRegion->Allocate(size, &offset)) {
+                return new TransferRegionWriteHandleImpl(mTransferRegion, offset, size);
+            }
+
+            uint64_t id = 0;
+            std::unique_ptr<SharedMemory> memory = CreateSharedMemory(size, &id);
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            return new WriteHandleImpl(std::move(memory), id);
+        }
+
+      private:
+        std::unique_ptr<SharedMemory> CreateSharedMemory(size_t size, uint64_t* id) {
+            std::unique_ptr<SharedMemory> memory = SharedMemory::Create(size);
+            if (memory == nullptr) {
+                return nullptr;
+            }
+
+            *id = mExporter->ExportSharedMemory(memory->GetHandle(), size);
+            if (*id == 0) {
+                return nullptr;
+            }
+            return memory;
+        }
+
+        SharedMemoryExporter* mExporter;
+        size_t mTransferRegionSize;
+        std::shared_ptr<TransferRegion> mTransferRegion;
+    };
+
+    SharedMemoryExporter::~SharedMemoryExporter() = default;
+
+    std::unique_ptr<MemoryTransferService> CreateSharedMemoryTransferService(
+        SharedMemoryExporter* exporter,
+        size_t transferRegionSize) {
+        return std::make_unique<SharedMemoryTransferService>(exporter, transferRegionSize);
+    }
+
+}}  //  namespace dawn_wire::client
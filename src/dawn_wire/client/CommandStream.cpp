@@ -0,0 +1,70 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/client/CommandStream.h"
+
+#include "common/Assert.h"
+#include "dawn_wire/client/Client.h"
+
+namespace dawn_wire { namespace client {
+
+    CommandStream::CommandStream(Client* client) : mClient(client) {
+    }
+
+    CommandStream::~CommandStream() {
+        ASSERT(mCommandSizes.empty());
+        ASSERT(mDeferredIdFrees.empty());
+        ASSERT(mUnflushedIds.empty());
+    }
+
+    Client* CommandStream::GetClient() const {
+        return mClient;
+    }
+
+    void* CommandStream::GetCmdSpace(size_t size) {
+        size_t offset = mCommands.size();
+        mCommands.resize(offset + size);
+        mCommandSizes.push_back(size);
+        return &mCommands[offset];
+    }
+
+    void CommandStream::DeferFreeId(ObjectIdAllocator* allocator, uint32_t id) {
+        mDeferredIdFrees.emplace_back(allocator, id);
+    }
+
+    void CommandStream::AddUnflushedId(ObjectIdAllocator* allocator, uint32_t id) {
+        mUnflushedIds.emplace_back(allocator, id);
+    }
+
+    void CommandStream::Flush() {
+        if (!mCommandSizes.empty()) {
+            mClient->SerializeCommands(mCommands.data(), mCommandSizes);
+            mCommands.clear();
+            mCommandSizes.clear();
+        }
+
+        // Released before the IDs are freed since a freed ID can be unflushed again in another
+        // stream.
+        for (const auto& unflushedId : mUnflushedIds) {
+            unflushedId.first->ReleaseUnflushedId(unflushedId.second);
+        }
+        mUnflushedIds.clear();
+
+        for (const auto& deferredIdFree : mDeferredIdFrees) {
+            deferredIdFree.first->FreeDeferredId(deferredIdFree.second);
+        }
+        mDeferredIdFrees.clear();
+    }
+
+}}  // namespace dawn_wire::client
@@ -0,0 +1,70 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_CLIENT_COMMANDSTREAM_H_
+#define DAWNWIRE_CLIENT_COMMANDSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dawn_wire { namespace client {
+
+    class Client;
+
+    // Manages the IDs of an ObjectAllocator independently of the type of its objects.
+    class ObjectIdAllocator {
+      public:
+        virtual void FreeDeferredId(uint32_t id) = 0;
+        virtual void ReleaseUnflushedId(uint32_t id) = 0;
+
+      protected:
+        ~ObjectIdAllocator() = default;
+    };
+
+    // Buffers the commands recorded by one thread so that threads don't need to synchronize
+    // with each other to record commands. Flushing the stream appends its commands to the
+    // serializer of the client, after the commands of the streams flushed before it.
+    class CommandStream {
+      public:
+        CommandStream(Client* client);
+        ~CommandStream();
+
+        Client* GetClient() const;
+        void* GetCmdSpace(size_t size);
+
+        // The ID of a destroyed object is reused only once the command destroying it is
+        // flushed, so that the server can't receive a new object with that ID first.
+        void DeferFreeId(ObjectIdAllocator* allocator, uint32_t id);
+        // The IDs of the objects created in the stream are unflushed until the stream is
+        // flushed. The allocator doesn't give out IDs too far past its lowest unflushed ID, see
+        // kMaxObjectIdGap.
+        void AddUnflushedId(ObjectIdAllocator* allocator, uint32_t id);
+
+        void Flush();
+
+      private:
+        Client* mClient;
+        // The commands are appended to the serializer one by one since serializers can limit
+        // the size of the space they give out.
+        std::vector<char> mCommands;
+        std::vector<size_t> mCommandSizes;
+        std::vector<std::pair<ObjectIdAllocator*, uint32_t>> mDeferredIdFrees;
+        std::vector<std::pair<ObjectIdAllocator*, uint32_t>> mUnflushedIds;
+    };
+
+}}  // namespace dawn_wire::client
+
+#endif  // DAWNWIRE_CLIENT_COMMANDSTREAM_H_
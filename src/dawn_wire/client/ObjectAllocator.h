@@ -15,9 +15,18 @@
 #ifndef DAWNWIRE_CLIENT_OBJECTALLOCATOR_H_
 #define DAWNWIRE_CLIENT_OBJECTALLOCATOR_H_
 
+#include <dawn_wire/Wire.h>
+
 #include "common/Assert.h"
+#include "common/Math.h"
+#include "dawn_wire/client/CommandStream.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace dawn_wire { namespace client {
@@ -25,8 +34,10 @@ namespace dawn_wire { namespace client {
     class Client;
     class Device;
 
+    // The allocators are shared by the command streams of the client, and are internally
+    // synchronized.
     template <typename T>
-    class ObjectAllocator {
+    class ObjectAllocator final : public ObjectIdAllocator {
         using ObjectOwner =
             typename std::conditional<std::is_same<T, Device>::value, Client, Device>::type;
 
@@ -44,8 +55,42 @@ namespace dawn_wire { namespace client {
             mObjects.emplace_back(nullptr, 0);
         }
 
+        // The ObjectAndSerial stays valid until the object is freed.
         ObjectAndSerial* New(ObjectOwner* owner) {
+            return New(owner, nullptr);
+        }
+        // An ID given out for the first time to an object created while recording in |stream|
+        // is unflushed until |stream| is flushed, and the server knows all the other IDs given
+        // out before. So that the server accepts the IDs, New doesn't give out a new ID more than
+        // kMaxObjectIdGap past the lowest unflushed ID: it flushes |stream|, and then waits for
+        // the stream of the lowest unflushed ID to be flushed if it isn't |stream|. |stream| is
+        // flushed first even then, since it can hold the unflushed IDs of other allocators that
+        // the other stream is waiting for.
+        ObjectAndSerial* New(ObjectOwner* owner, CommandStream* stream) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            bool streamFlushed = false;
+            while (NextNewId() >= mIdEnd && !mUnflushedIds.empty() &&
+                   NextNewId() > mUnflushedIds.begin()->first + kMaxObjectIdGap) {
+                if (stream != nullptr && !streamFlushed) {
+                    // The commands recorded in |stream| so far are complete, and it can't record
+                    // more while it waits.
+                    lock.unlock();
+                    stream->Flush();
+                    lock.lock();
+                    streamFlushed = true;
+                } else {
+                    mUnflushedIdReleased.wait(lock);
+                }
+            }
+
             uint32_t id = GetNewId();
+            if (id >= mIdEnd) {
+                mIdEnd = id + 1;
+                if (stream != nullptr) {
+                    mUnflushedIds.emplace(id, stream);
+                    stream->AddUnflushedId(this, id);
+                }
+            }
             T* result = new T(owner, 1, id);
             auto object = std::unique_ptr<T>(result);
 
@@ -63,11 +108,42 @@ namespace dawn_wire { namespace client {
             return &mObjects[id];
         }
         void Free(T* obj) {
-            FreeId(obj->id);
-            mObjects[obj->id].object = nullptr;
+            Free(obj, nullptr);
+        }
+        // The ID of an object freed while recording in |stream| is reused once |stream| is
+        // flushed.
+        void Free(T* obj, CommandStream* stream) {
+            uint32_t id = obj->id;
+            std::unique_ptr<T> object;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                object = std::move(mObjects[id].object);
+                if (stream == nullptr) {
+                    FreeId(id);
+                }
+            }
+            if (stream != nullptr) {
+                stream->DeferFreeId(this, id);
+            }
+            // Destroyed without the lock held since destroying objects can call callbacks.
+            object = nullptr;
+        }
+
+        void FreeDeferredId(uint32_t id) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            FreeId(id);
+        }
+
+        void ReleaseUnflushedId(uint32_t id) override {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mUnflushedIds.erase(id);
+            }
+            mUnflushedIdReleased.notify_all();
         }
 
         T* GetObject(uint32_t id) {
+            std::lock_guard<std::mutex> lock(mMutex);
             if (id >= mObjects.size()) {
                 return nullptr;
             }
@@ -75,6 +151,7 @@ namespace dawn_wire { namespace client {
         }
 
         uint32_t GetSerial(uint32_t id) {
+            std::lock_guard<std::mutex> lock(mMutex);
             if (id >= mObjects.size()) {
                 return 0;
             }
@@ -82,22 +159,75 @@ namespace dawn_wire { namespace client {
         }
 
       private:
+        static constexpr uint32_t kBitsPerWord = 32;
+
+        // The lowest free ID is reused so that the live IDs, and the server's storage indexed by
+        // them, stay dense after bursts of allocations.
+        uint32_t NextNewId() {
+            // All the words before mFirstFreeWord are zero.
+            for (; mFirstFreeWord < mFreeIdBits.size(); ++mFirstFreeWord) {
+                uint32_t bits = mFreeIdBits[mFirstFreeWord];
+                if (bits != 0) {
+                    return mFirstFreeWord * kBitsPerWord + ScanForward(bits);
+                }
+            }
+            return mCurrentId;
+        }
         uint32_t GetNewId() {
-            if (mFreeIds.empty()) {
-                return mCurrentId++;
+            uint32_t id = NextNewId();
+            if (id == mCurrentId) {
+                mCurrentId++;
+            } else {
+                mFreeIdBits[id / kBitsPerWord] &= ~(1u << (id % kBitsPerWord));
             }
-            uint32_t id = mFreeIds.back();
-            mFreeIds.pop_back();
             return id;
         }
         void FreeId(uint32_t id) {
-            mFreeIds.push_back(id);
+            ASSERT(id != 0 && id < mCurrentId);
+            if (id + 1 != mCurrentId) {
+                uint32_t word = id / kBitsPerWord;
+                if (word >= mFreeIdBits.size()) {
+                    mFreeIdBits.resize(word + 1, 0);
+                }
+                mFreeIdBits[word] |= 1u << (id % kBitsPerWord);
+                mFirstFreeWord = std::min(mFirstFreeWord, word);
+                return;
+            }
+
+            // Freeing the highest ID lowers the high-water mark past all the free IDs below it
+            // so that the free list shrinks once the objects of a burst are released. The serials
+            // of the IDs above the mark are kept in mObjects.
+            mCurrentId--;
+            while (mCurrentId > 1 && IsFreeId(mCurrentId - 1)) {
+                mCurrentId--;
+                mFreeIdBits[mCurrentId / kBitsPerWord] &= ~(1u << (mCurrentId % kBitsPerWord));
+            }
+            uint32_t wordCount = (mCurrentId + kBitsPerWord - 1) / kBitsPerWord;
+            if (wordCount < mFreeIdBits.size()) {
+                mFreeIdBits.resize(wordCount);
+            }
+            mFirstFreeWord = std::min(mFirstFreeWord, wordCount);
+        }
+        bool IsFreeId(uint32_t id) const {
+            uint32_t word = id / kBitsPerWord;
+            return word < mFreeIdBits.size() &&
+                   (mFreeIdBits[word] & (1u << (id % kBitsPerWord))) != 0;
         }
 
         // 0 is an ID reserved to represent nullptr
         uint32_t mCurrentId = 1;
-        std::vector<uint32_t> mFreeIds;
-        std::vector<ObjectAndSerial> mObjects;
+        // A bit per ID below mCurrentId, set if the ID is free.
+        std::vector<uint32_t> mFreeIdBits;
+        uint32_t mFirstFreeWord = 0;
+        // A deque so that the ObjectAndSerial returned by New aren't moved by other threads
+        // allocating objects.
+        std::deque<ObjectAndSerial> mObjects;
+        // One past the highest ID given out, which unlike mCurrentId never decreases.
+        uint32_t mIdEnd = 1;
+        // The streams of the unflushed IDs, by ID.
+        std::map<uint32_t, CommandStream*> mUnflushedIds;
+        std::mutex mMutex;
+        std::condition_variable mUnflushedIdReleased;
         Device* mDevice;
     };
 }}  // namespace dawn_wire::client
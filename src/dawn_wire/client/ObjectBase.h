@@ -17,13 +17,16 @@
 
 #include <dawn/webgpu.h>
 
+#include <atomic>
+
 namespace dawn_wire { namespace client {
 
     class Device;
 
     // All non-Device objects of the client side have:
     //  - A pointer to the device to get where to serialize commands
-    //  - The external reference count
+    //  - The external reference count, atomic since the objects can be shared by the threads
+    //    recording in their own command stream
     //  - An ID that is used to refer to this object when talking with the server side
     struct ObjectBase {
         ObjectBase(Device* device, uint32_t refcount, uint32_t id)
@@ -31,7 +34,7 @@ namespace dawn_wire { namespace client {
         }
 
         Device* device;
-        uint32_t refcount;
+        std::atomic<uint32_t> refcount;
         uint32_t id;
     };
 
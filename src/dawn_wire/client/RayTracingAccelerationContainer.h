@@ -0,0 +1,46 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_CLIENT_RAYTRACINGACCELERATIONCONTAINER_H_
+#define DAWNWIRE_CLIENT_RAYTRACINGACCELERATIONCONTAINER_H_
+
+#include <dawn/webgpu.h>
+
+#include "dawn_wire/client/ObjectBase.h"
+
+#include <map>
+
+namespace dawn_wire { namespace client {
+
+    struct RayTracingAccelerationContainer : ObjectBase {
+        using ObjectBase::ObjectBase;
+
+        ~RayTracingAccelerationContainer();
+        void ClearHandleRequests(WGPURayTracingAccelerationContainerGetHandleStatus status);
+
+        struct HandleRequestData {
+            WGPURayTracingAccelerationContainerGetHandleCallback callback = nullptr;
+            void* userdata = nullptr;
+        };
+        std::map<uint32_t, HandleRequestData> requests;
+        uint32_t requestSerial = 0;
+
+        // The last handle returned by the server, 0 until the first request completes. The
+        // handle changes when the container gets compacted or rebuilt after an eviction.
+        uint64_t handle = 0;
+    };
+
+}}  // namespace dawn_wire::client
+
+#endif  // DAWNWIRE_CLIENT_RAYTRACINGACCELERATIONCONTAINER_H_
@@ -97,7 +97,7 @@ namespace dawn_wire { namespace server {
         // Returns nullptr if the ID is already allocated, or too far ahead, or if ID is 0 (ID 0 is
         // reserved for nullptr). Invalidates all the Data*
         Data* Allocate(uint32_t id) {
-            if (id == 0 || id > mKnown.size()) {
+            if (id == 0 || id > mKnown.size() + mMaxIdGap) {
                 return nullptr;
             }
 
@@ -106,6 +106,12 @@ namespace dawn_wire { namespace server {
             data.handle = nullptr;
 
             if (id >= mKnown.size()) {
+                while (mKnown.size() < id) {
+                    Data skipped;
+                    skipped.allocated = false;
+                    skipped.handle = nullptr;
+                    mKnown.push_back(std::move(skipped));
+                }
                 mKnown.push_back(std::move(data));
                 return &mKnown.back();
             }
@@ -124,6 +130,12 @@ namespace dawn_wire { namespace server {
             mKnown[id].allocated = false;
         }
 
+        // How many IDs the ID of a new object can skip past the known IDs. The IDs are dense
+        // unless the client uses command streams, see WireServerDescriptor::allowObjectIdGaps.
+        void SetMaxIdGap(uint32_t maxIdGap) {
+            mMaxIdGap = maxIdGap;
+        }
+
         std::vector<T> AcquireAllHandles() {
             std::vector<T> objects;
             for (Data& data : mKnown) {
@@ -139,6 +151,7 @@ namespace dawn_wire { namespace server {
 
       private:
         std::vector<Data> mKnown;
+        uint32_t mMaxIdGap = 0;
     };
 
     // ObjectIds are lost in deserialization. Store the ids of deserialized
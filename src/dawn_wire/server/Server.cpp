@@ -20,13 +20,23 @@ namespace dawn_wire { namespace server {
     Server::Server(WGPUDevice device,
                    const DawnProcTable& procs,
                    CommandSerializer* serializer,
-                   MemoryTransferService* memoryTransferService)
+                   MemoryTransferService* memoryTransferService,
+                   bool collectStatistics,
+                   bool allowObjectIdGaps)
         : mSerializer(serializer), mProcs(procs), mMemoryTransferService(memoryTransferService) {
+        if (collectStatistics) {
+            mStatistics = std::make_unique<WireStatisticsRecorder>(
+                kWireCmdCount,
+                [](uint32_t command) { return GetWireCmdName(static_cast<WireCmd>(command)); });
+        }
         if (mMemoryTransferService == nullptr) {
             // If a MemoryTransferService is not provided, fallback to inline memory.
             mOwnedMemoryTransferService = CreateInlineMemoryTransferService();
             mMemoryTransferService = mOwnedMemoryTransferService.get();
         }
+        if (allowObjectIdGaps) {
+            SetMaxObjectIdGap(kMaxObjectIdGap);
+        }
         // The client-server knowledge is bootstrapped with device 1.
         auto* deviceData = DeviceObjects().Allocate(1);
         deviceData->handle = device;
@@ -39,6 +49,19 @@ namespace dawn_wire { namespace server {
         DestroyAllObjects(mProcs);
     }
 
+    WireStatistics Server::GetStatistics() const {
+        if (mStatistics == nullptr) {
+            return {};
+        }
+        return mStatistics->GetStatistics();
+    }
+
+    void Server::ResetStatistics() {
+        if (mStatistics != nullptr) {
+            mStatistics->Reset();
+        }
+    }
+
     void* Server::GetCmdSpace(size_t size) {
         return mSerializer->GetCmdSpace(size);
     }
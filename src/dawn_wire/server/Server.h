@@ -15,6 +15,7 @@
 #ifndef DAWNWIRE_SERVER_SERVER_H_
 #define DAWNWIRE_SERVER_SERVER_H_
 
+#include "dawn_wire/WireStatisticsRecorder.h"
 #include "dawn_wire/server/ServerBase_autogen.h"
 
 namespace dawn_wire { namespace server {
@@ -45,21 +46,36 @@ namespace dawn_wire { namespace server {
         uint64_t value;
     };
 
+    struct AccelerationContainerHandleUserdata {
+        Server* server;
+        ObjectHandle container;
+        uint32_t requestSerial;
+    };
+
     class Server : public ServerBase {
       public:
         Server(WGPUDevice device,
                const DawnProcTable& procs,
                CommandSerializer* serializer,
-               MemoryTransferService* memoryTransferService);
+               MemoryTransferService* memoryTransferService,
+               bool collectStatistics,
+               bool allowObjectIdGaps);
         ~Server();
 
         const volatile char* HandleCommands(const volatile char* commands, size_t size);
 
         bool InjectTexture(WGPUTexture texture, uint32_t id, uint32_t generation);
 
+        WireStatistics GetStatistics() const;
+        void ResetStatistics();
+
       private:
         void* GetCmdSpace(size_t size);
 
+        // Ticks the device, the fence completed value updates produced by the tick are coalesced
+        // so that each fence gets at most one update.
+        void TickDevice();
+
         // Forwarding callbacks
         static void ForwardUncapturedError(WGPUErrorType type, const char* message, void* userdata);
         static void ForwardDeviceLost(const char* message, void* userdata);
@@ -73,6 +89,10 @@ namespace dawn_wire { namespace server {
                                                uint64_t dataLength,
                                                void* userdata);
         static void ForwardFenceCompletedValue(WGPUFenceCompletionStatus status, void* userdata);
+        static void ForwardAccelerationContainerGetHandle(
+            WGPURayTracingAccelerationContainerGetHandleStatus status,
+            uint64_t handle,
+            void* userdata);
 
         // Error callbacks
         void OnUncapturedError(WGPUErrorType type, const char* message);
@@ -90,14 +110,22 @@ namespace dawn_wire { namespace server {
                                            MapUserdata* userdata);
         void OnFenceCompletedValueUpdated(WGPUFenceCompletionStatus status,
                                           FenceCompletionUserdata* userdata);
+        void OnAccelerationContainerGetHandle(
+            WGPURayTracingAccelerationContainerGetHandleStatus status,
+            uint64_t handle,
+            AccelerationContainerHandleUserdata* userdata);
 
 #include "dawn_wire/server/ServerPrototypes_autogen.inc"
 
         CommandSerializer* mSerializer = nullptr;
         WireDeserializeAllocator mAllocator;
+        CompactCommandState mCompactCommandState;
+        bool mCoalesceFenceUpdates = false;
+        std::vector<ReturnFenceUpdateCompletedValueCmd> mPendingFenceUpdates;
         DawnProcTable mProcs;
         std::unique_ptr<MemoryTransferService> mOwnedMemoryTransferService = nullptr;
         MemoryTransferService* mMemoryTransferService = nullptr;
+        std::unique_ptr<WireStatisticsRecorder> mStatistics;
     };
 
     std::unique_ptr<MemoryTransferService> CreateInlineMemoryTransferService();
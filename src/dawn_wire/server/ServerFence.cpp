@@ -14,6 +14,7 @@
 
 #include "dawn_wire/server/Server.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace dawn_wire { namespace server {
@@ -31,13 +32,43 @@ namespace dawn_wire { namespace server {
             return;
         }
 
+        if (mCoalesceFenceUpdates) {
+            for (ReturnFenceUpdateCompletedValueCmd& pending : mPendingFenceUpdates) {
+                if (pending.fence.id == data->fence.id &&
+                    pending.fence.serial == data->fence.serial) {
+                    pending.value = std::max(pending.value, data->value);
+                    return;
+                }
+            }
+        }
+
         ReturnFenceUpdateCompletedValueCmd cmd;
         cmd.fence = data->fence;
         cmd.value = data->value;
 
+        if (mCoalesceFenceUpdates) {
+            mPendingFenceUpdates.push_back(cmd);
+            return;
+        }
+
         size_t requiredSize = cmd.GetRequiredSize();
         char* allocatedBuffer = static_cast<char*>(GetCmdSpace(requiredSize));
         cmd.Serialize(allocatedBuffer);
     }
 
+    void Server::TickDevice() {
+        ASSERT(!mCoalesceFenceUpdates && mPendingFenceUpdates.empty());
+
+        mCoalesceFenceUpdates = true;
+        mProcs.deviceTick(DeviceObjects().Get(1)->handle);
+        mCoalesceFenceUpdates = false;
+
+        for (const ReturnFenceUpdateCompletedValueCmd& cmd : mPendingFenceUpdates) {
+            size_t requiredSize = cmd.GetRequiredSize();
+            char* allocatedBuffer = static_cast<char*>(GetCmdSpace(requiredSize));
+            cmd.Serialize(allocatedBuffer);
+        }
+        mPendingFenceUpdates.clear();
+    }
+
 }}  // namespace dawn_wire::server
@@ -0,0 +1,70 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_wire/server/Server.h"
+
+#include <memory>
+
+namespace dawn_wire { namespace server {
+
+    bool Server::DoRayTracingAccelerationContainerGetHandleAsync(ObjectId containerId,
+                                                                 uint32_t requestSerial) {
+        // The null object isn't valid as `self`
+        if (containerId == 0) {
+            return false;
+        }
+
+        auto* container = RayTracingAccelerationContainerObjects().Get(containerId);
+        if (container == nullptr) {
+            return false;
+        }
+
+        std::unique_ptr<AccelerationContainerHandleUserdata> userdata =
+            std::make_unique<AccelerationContainerHandleUserdata>();
+        userdata->server = this;
+        userdata->container = ObjectHandle{containerId, container->serial};
+        userdata->requestSerial = requestSerial;
+
+        mProcs.rayTracingAccelerationContainerGetHandleAsync(
+            container->handle, ForwardAccelerationContainerGetHandle, userdata.release());
+        return true;
+    }
+
+    // static
+    void Server::ForwardAccelerationContainerGetHandle(
+        WGPURayTracingAccelerationContainerGetHandleStatus status,
+        uint64_t handle,
+        void* userdata) {
+        auto* data = static_cast<AccelerationContainerHandleUserdata*>(userdata);
+        data->server->OnAccelerationContainerGetHandle(status, handle, data);
+    }
+
+    void Server::OnAccelerationContainerGetHandle(
+        WGPURayTracingAccelerationContainerGetHandleStatus status,
+        uint64_t handle,
+        AccelerationContainerHandleUserdata* userdata) {
+        std::unique_ptr<AccelerationContainerHandleUserdata> data(userdata);
+
+        ReturnRayTracingAccelerationContainerGetHandleAsyncCallbackCmd cmd;
+        cmd.container = data->container;
+        cmd.requestSerial = data->requestSerial;
+        cmd.status = status;
+        cmd.handle = handle;
+
+        size_t requiredSize = cmd.GetRequiredSize();
+        char* allocatedBuffer = static_cast<char*>(GetCmdSpace(requiredSize));
+        cmd.Serialize(allocatedBuffer);
+    }
+
+}}  // namespace dawn_wire::server
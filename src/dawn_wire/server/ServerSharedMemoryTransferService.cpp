@@ -0,0 +1,211 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Assert.h"
+#include "dawn_wire/SharedMemory.h"
+#include "dawn_wire/SharedMemoryTransferService.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace dawn_wire { namespace server {
+
+    class SharedMemoryTransferService : public MemoryTransferService {
+      public:
+        class ReadHandleImpl : public ReadHandle {
+          public:
+            explicit ReadHandleImpl(std::unique_ptr<SharedMemory> memory)
+                : mMemory(std::move(memory)) {
+            }
+            ~ReadHandleImpl() override = default;
+
+            size_t SerializeInitialDataSize(const void* data, size_t dataLength) override {
+                return sizeof(SharedMemoryHandleDataInfo);
+            }
+
+            void SerializeInitialData(const void* data,
+                                      size_t dataLength,
+                                      void* serializePointer) override {
+                ASSERT(serializePointer != nullptr);
+
+                // The client checks that the length matches the size of the handle so only the
+                // data that fits is copied.
+                size_t copySize = std::min(dataLength, mMemory->GetSize());
+                if (copySize > 0) {
+                    ASSERT(data != nullptr);
+                    memcpy(mMemory->GetData(), data, copySize);
+                }
+
+                SharedMemoryHandleDataInfo dataInfo = {dataLength, 0};
+                memcpy(serializePointer, &dataInfo, sizeof(dataInfo));
+            }
+
+          private:
+            std::unique_ptr<SharedMemory> mMemory;
+        };
+
+        class WriteHandleImpl : public WriteHandle {
+          public:
+            // |offset| is the offset of the handle's data in |memory|, which is only non-zero
+            // for handles sub-allocated from a transfer region.
+            WriteHandleImpl(std::shared_ptr<SharedMemory> memory, uint64_t offset)
+                : mMemory(std::move(memory)), mOffset(offset) {
+            }
+            ~WriteHandleImpl() override = default;
+
+            bool DeserializeFlush(const void* deserializePointer, size_t deserializeSize) override {
+                if (deserializeSize != sizeof(SharedMemoryHandleDataInfo) ||
+                    mTargetData == nullptr || deserializePointer == nullptr) {
+                    return false;
+                }
+
+                SharedMemoryHandleDataInfo dataInfo;
+                memcpy(&dataInfo, deserializePointer, sizeof(dataInfo));
+                if (dataInfo.dataLength != mDataLength ||
+                    mDataLength > mMemory->GetSize() - mOffset) {
+                    return false;
+                }
+
+                // The client wrote the data in the shared memory, only the copy to the mapped
+                // buffer is needed.
+                memcpy(mTargetData, static_cast<char*>(mMemory->GetData()) + mOffset, mDataLength);
+
+                // Let the client reuse the range once the data is copied.
+                if (mOffset != 0) {
+                    auto* header =
+                        static_cast<SharedMemoryTransferRegionHeader*>(mMemory->GetData());
+                    header->completedSerial.store(dataInfo.serial, std::memory_order_release);
+                }
+                return true;
+            }
+
+          private:
+            std::shared_ptr<SharedMemory> mMemory;
+            uint64_t mOffset;
+        };
+
+        explicit SharedMemoryTransferService(SharedMemoryImporter* importer)
+            : mImporter(importer) {
+            ASSERT(mImporter != nullptr);
+        }
+        ~SharedMemoryTransferService() override = default;
+
+        bool DeserializeReadHandle(const void* deserializePointer,
+                                   size_t deserializeSize,
+                                   ReadHandle** readHandle) override {
+            ASSERT(readHandle != nullptr);
+            SharedMemoryHandleCreateInfo createInfo;
+            if (!DeserializeCreateInfo(deserializePointer, deserializeSize, &createInfo) ||
+                createInfo.regionSize != 0) {
+                return false;
+            }
+
+            std::unique_ptr<SharedMemory> memory =
+                ImportSharedMemory(createInfo.id, createInfo.size);
+            if (memory == nullptr) {
+                return false;
+            }
+            *readHandle = new ReadHandleImpl(std::move(memory));
+            return true;
+        }
+
+        bool DeserializeWriteHandle(const void* deserializePointer,
+                                    size_t deserializeSize,
+                                    WriteHandle** writeHandle) override {
+            ASSERT(writeHandle != nullptr);
+            SharedMemoryHandleCreateInfo createInfo;
+            if (!DeserializeCreateInfo(deserializePointer, deserializeSize, &createInfo)) {
+                return false;
+            }
+
+            if (createInfo.regionSize == 0) {
+                std::unique_ptr<SharedMemory> memory =
+                    ImportSharedMemory(createInfo.id, createInfo.size);
+                if (memory == nullptr) {
+                    return false;
+                }
+                *writeHandle = new WriteHandleImpl(std::move(memory), 0);
+                return true;
+            }
+
+            // The handle is sub-allocated from a transfer region, the data must be after the
+            // region's header and fit in the region.
+            if (createInfo.regionSize > std::numeric_limits<size_t>::max() ||
+                createInfo.offset < sizeof(SharedMemoryTransferRegionHeader) ||
+                createInfo.offset > createInfo.regionSize ||
+                createInfo.size > createInfo.regionSize - createInfo.offset) {
+                return false;
+            }
+
+            std::shared_ptr<SharedMemory> region =
+                GetTransferRegion(createInfo.id, createInfo.regionSize);
+            if (region == nullptr) {
+                return false;
+            }
+            *writeHandle = new WriteHandleImpl(std::move(region), createInfo.offset);
+            return true;
+        }
+
+      private:
+        static bool DeserializeCreateInfo(const void* deserializePointer,
+                                          size_t deserializeSize,
+                                          SharedMemoryHandleCreateInfo* createInfo) {
+            if (deserializeSize != sizeof(SharedMemoryHandleCreateInfo) ||
+                deserializePointer == nullptr) {
+                return false;
+            }
+
+            memcpy(createInfo, deserializePointer, sizeof(*createInfo));
+            return createInfo->size <= std::numeric_limits<size_t>::max();
+        }
+
+        std::unique_ptr<SharedMemory> ImportSharedMemory(uint64_t id, uint64_t size) {
+            SharedMemoryHandle handle;
+            if (!mImporter->ImportSharedMemory(id, &handle)) {
+                return nullptr;
+            }
+            return SharedMemory::Import(handle, static_cast<size_t>(size));
+        }
+
+        // Transfer regions are imported once and kept mapped for the lifetime of the service.
+        std::shared_ptr<SharedMemory> GetTransferRegion(uint64_t id, uint64_t size) {
+            auto it = mTransferRegions.find(id);
+            if (it != mTransferRegions.end()) {
+                if (it->second->GetSize() != size) {
+                    return nullptr;
+                }
+                return it->second;
+            }
+
+            std::shared_ptr<SharedMemory> region = ImportSharedMemory(id, size);
+            if (region != nullptr) {
+                mTransferRegions[id] = region;
+            }
+            return region;
+        }
+
+        SharedMemoryImporter* mImporter;
+        std::map<uint64_t, std::shared_ptr<SharedMemory>> mTransferRegions;
+    };
+
+    SharedMemoryImporter::~SharedMemoryImporter() = default;
+
+    std::unique_ptr<MemoryTransferService> CreateSharedMemoryTransferService(
+        SharedMemoryImporter* importer) {
+        return std::make_unique<SharedMemoryTransferService>(importer);
+    }
+
+}}  //  namespace dawn_wire::server
@@ -30,6 +30,14 @@ namespace dawn_native { namespace d3d12 {
     DAWN_NATIVE_EXPORT WGPUTextureFormat
     GetNativeSwapChainPreferredFormat(const DawnSwapChainImplementation* swapChain);
 
+    // Moves buffers out of the sparsest placed resource heap so that it can be released, which
+    // fights the fragmentation of long running applications. The copies are submitted on the
+    // next queue submit or device tick and cost GPU time, so this is meant to be called on idle
+    // frames. At most |maxRelocatedSize| bytes are copied. Returns the number of bytes of buffers
+    // relocated.
+    DAWN_NATIVE_EXPORT uint64_t DefragmentBufferMemory(WGPUDevice device,
+                                                       uint64_t maxRelocatedSize);
+
     struct DAWN_NATIVE_EXPORT ExternalImageDescriptorDXGISharedHandle : ExternalImageDescriptor {
       public:
         ExternalImageDescriptorDXGISharedHandle();
@@ -42,6 +50,29 @@ namespace dawn_native { namespace d3d12 {
     DAWN_NATIVE_EXPORT WGPUTexture
     WrapSharedHandle(WGPUDevice device, const ExternalImageDescriptorDXGISharedHandle* descriptor);
 
+    struct DAWN_NATIVE_EXPORT ExternalBufferDescriptorDXGISharedHandle : ExternalBufferDescriptor {
+      public:
+        ExternalBufferDescriptorDXGISharedHandle();
+
+        HANDLE sharedHandle;
+
+        // Optional shared handle of an ID3D12Fence. The commands submitted after the buffer is
+        // wrapped wait for the fence to reach fenceWaitValue, and ReleaseSharedBuffer signals it.
+        HANDLE fenceSharedHandle = nullptr;
+        uint64_t fenceWaitValue = 0;
+    };
+
+    // Note: SharedHandle must be a handle to a buffer resource at least as large as the buffer
+    // descriptor. Wrapped buffers alias the resource without any copy and can't be mappable.
+    DAWN_NATIVE_EXPORT WGPUBuffer
+    WrapSharedHandle(WGPUDevice device, const ExternalBufferDescriptorDXGISharedHandle* descriptor);
+
+    // Submits the pending commands, signals the fence the buffer was wrapped with, if any, with
+    // |fenceSignalValue| after them and destroys the buffer. On failure, returns false.
+    DAWN_NATIVE_EXPORT bool ReleaseSharedBuffer(WGPUDevice device,
+                                                WGPUBuffer buffer,
+                                                uint64_t fenceSignalValue);
+
 }}  // namespace dawn_native::d3d12
 
 #endif  // DAWNNATIVE_D3D12BACKEND_H_
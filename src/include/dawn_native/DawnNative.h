@@ -141,6 +141,9 @@ namespace dawn_native {
         // Gather all adapters in the system that can be accessed with no special options. These
         // adapters will later be returned by GetAdapters.
         void DiscoverDefaultAdapters();
+        // Same as above, but only connects to the backends in `backendTypes`, which avoids the
+        // cost of initializing the other backends.
+        void DiscoverDefaultAdapters(const std::vector<WGPUBackendType>& backendTypes);
 
         // Adds adapters that can be discovered with the options provided (like a getProcAddress).
         // The backend is chosen based on the type of the options used. Returns true on success.
@@ -175,6 +178,35 @@ namespace dawn_native {
     // Backdoor to get the number of lazy clears for testing
     DAWN_NATIVE_EXPORT size_t GetLazyClearCountForTesting(WGPUDevice device);
 
+    // Given a task that ticks the device, which calls the callbacks that completed. The executor
+    // must run the task exactly once, on any thread since the task takes the device's lock.
+    using CompletionExecutor = void (*)(void (*task)(void* taskData),
+                                        void* taskData,
+                                        void* userdata);
+
+    // How a device's completion thread reports that callbacks are ready, instead of the
+    // application polling with wgpuDeviceTick. Any combination of the notifications can be set.
+    struct DAWN_NATIVE_EXPORT CompletionThreadDescriptor {
+        // Called on the completion thread with a task that ticks the device. At most one task is
+        // given out at a time, the next one once the previous task started running.
+        CompletionExecutor executor = nullptr;
+        void* executorUserdata = nullptr;
+
+        // An event the completion thread signals after which the application should tick the
+        // device. On Windows, a HANDLE created with CreateEvent that is set with SetEvent. On POSIX
+        // systems, a file descriptor such as an eventfd or the write end of a pipe to which a
+        // uint64_t of 1 is written. The event must outlive the device.
+        void* win32Event = nullptr;
+        int eventFd = -1;
+    };
+
+    // Starts a thread which waits on the backend's fences without polling. Backends which can't
+    // wait on their fences from another thread poll them on that thread while commands are in
+    // flight, and don't wake up when the device is idle. Returns false if the device already has
+    // a completion thread. The thread is stopped when the device is lost or destroyed.
+    DAWN_NATIVE_EXPORT bool StartCompletionThread(WGPUDevice device,
+                                                  const CompletionThreadDescriptor* descriptor);
+
     //  Query if texture has been initialized
     DAWN_NATIVE_EXPORT bool IsTextureSubresourceInitialized(WGPUTexture texture,
                                                             uint32_t baseMipLevel,
@@ -192,7 +224,7 @@ namespace dawn_native {
     DAWN_NATIVE_EXPORT uint64_t AcquireErrorInjectorCallCount();
     DAWN_NATIVE_EXPORT void InjectErrorAt(uint64_t index);
 
-    // The different types of ExternalImageDescriptors
+    // The different types of ExternalImageDescriptors and ExternalBufferDescriptors
     enum ExternalImageDescriptorType {
         OpaqueFD,
         DmaBuf,
@@ -210,6 +242,16 @@ namespace dawn_native {
       protected:
         ExternalImageDescriptor(ExternalImageDescriptorType type);
     };
+
+    // Common properties of external buffers
+    struct DAWN_NATIVE_EXPORT ExternalBufferDescriptor {
+      public:
+        const ExternalImageDescriptorType type;
+        const WGPUBufferDescriptor* cBufferDescriptor;  // Must match buffer creation params
+
+      protected:
+        ExternalBufferDescriptor(ExternalImageDescriptorType type);
+    };
 }  // namespace dawn_native
 
 #endif  // DAWNNATIVE_DAWNNATIVE_H_
@@ -27,11 +27,73 @@ namespace dawn_native { namespace vulkan {
 
     DAWN_NATIVE_EXPORT PFN_vkVoidFunction GetInstanceProcAddr(WGPUDevice device, const char* pName);
 
+    struct DAWN_NATIVE_EXPORT NativeSwapChainOptions {
+        // When the surface doesn't support the present mode, MAILBOX and IMMEDIATE fall back to
+        // each other and then to FIFO, and FIFO_RELAXED falls back to FIFO. The turn_off_vsync
+        // toggle overrides the present mode with IMMEDIATE.
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        // The number of frames that can be in flight, counting the one recorded after acquiring
+        // the next image. Acquiring waits for the older frames to complete first. 0 means no
+        // limit.
+        uint32_t maxFramesInFlight = 0;
+    };
+
     DAWN_NATIVE_EXPORT DawnSwapChainImplementation
     CreateNativeSwapChainImpl(WGPUDevice device, ::VkSurfaceKHR surface);
+    DAWN_NATIVE_EXPORT DawnSwapChainImplementation
+    CreateNativeSwapChainImpl(WGPUDevice device,
+                              ::VkSurfaceKHR surface,
+                              const NativeSwapChainOptions& options);
     DAWN_NATIVE_EXPORT WGPUTextureFormat
     GetNativeSwapChainPreferredFormat(const DawnSwapChainImplementation* swapChain);
 
+    // Where the time went around the presentation of the last frame of a native swapchain. All
+    // the durations are in nanoseconds.
+    struct DAWN_NATIVE_EXPORT NativeSwapChainFrameTimings {
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        // CPU time spent waiting for older frames to complete because of maxFramesInFlight.
+        uint64_t framesInFlightWaitTime = 0;
+        // CPU time spent in vkAcquireNextImageKHR and vkQueuePresentKHR.
+        uint64_t acquireTime = 0;
+        uint64_t presentTime = 0;
+
+        // Only available with VK_GOOGLE_display_timing. The presentation engine reports frames
+        // with some delay, so presentId identifies the frame the other timings are for, counting
+        // from 1. The times are those of the presentation engine's clock.
+        bool hasDisplayTiming = false;
+        uint64_t refreshDuration = 0;
+        uint32_t presentId = 0;
+        uint64_t desiredPresentTime = 0;
+        uint64_t actualPresentTime = 0;
+        uint64_t earliestPresentTime = 0;
+        uint64_t presentMargin = 0;
+    };
+    DAWN_NATIVE_EXPORT NativeSwapChainFrameTimings
+    GetNativeSwapChainFrameTimings(const DawnSwapChainImplementation* swapChain);
+
+    // Serializes the pipeline cache shared by all the pipelines of the device, so that it can be
+    // restored with LoadPipelineCacheData by a later run to skip the compilation of pipelines
+    // which were already created. Returns an empty vector on failure.
+    DAWN_NATIVE_EXPORT std::vector<uint8_t> GetPipelineCacheData(WGPUDevice device);
+    // Merges previously serialized pipeline cache data into the device's pipeline cache. Data
+    // produced by another device or driver version is ignored. Returns false on failure.
+    DAWN_NATIVE_EXPORT bool LoadPipelineCacheData(WGPUDevice device, const void* data, size_t size);
+
+    // The memory used by the process in a memory heap of the device, and the amount it can use
+    // before the driver starts paging memory out. Allocations which would go over the budget of
+    // their preferred heap fall back to host visible memory, or fail with an out-of-memory error.
+    // Without VK_EXT_memory_budget, the budget is the size of the heap and the usage only counts
+    // the memory allocated by the device.
+    struct DAWN_NATIVE_EXPORT MemoryHeapBudget {
+        uint64_t usage;
+        uint64_t budget;
+        bool isDeviceLocal;
+    };
+    DAWN_NATIVE_EXPORT std::vector<MemoryHeapBudget> GetMemoryHeapBudgets(WGPUDevice device);
+
+    // The number of nanoseconds per tick of the timestamps resolved from timestamp query sets.
+    DAWN_NATIVE_EXPORT float GetTimestampPeriod(WGPUDevice device);
+
 // Can't use DAWN_PLATFORM_LINUX since header included in both dawn and chrome
 #ifdef __linux__
         // Common properties of external images represented by FDs
@@ -40,6 +102,13 @@ namespace dawn_native { namespace vulkan {
             int memoryFD;  // A file descriptor from an export of the memory of the image
             std::vector<int> waitFDs;  // File descriptors of semaphores which will be waited on
 
+            // Optional timeline semaphore from ImportTimelineSemaphoreOpaqueFD or
+            // CreateExportableTimelineSemaphore. The first use of the texture waits for it to reach
+            // waitTimelineValue, and the texture is released with SignalTimelineSemaphore instead
+            // of ExportSignalSemaphoreOpaqueFD.
+            ::VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+            uint64_t waitTimelineValue = 0;
+
           protected:
             ExternalImageDescriptorFD(ExternalImageDescriptorType type);
         };
@@ -58,6 +127,39 @@ namespace dawn_native { namespace vulkan {
 
             uint32_t stride;       // Stride of the buffer in bytes
             uint64_t drmModifier;  // DRM modifier of the buffer
+
+            // Offset of the plane in the buffer in bytes. The planes of multi-planar buffers, like
+            // NV12 or P010 video frames, are wrapped as separate textures aliasing the memory of
+            // the buffer, without any copy. Each wrap takes its own duplicate of the file
+            // descriptor, the offset and stride of its plane, the size of the plane and a format
+            // matching its components: R8Unorm and RG8Unorm for NV12, R16Uint and RG16Uint for
+            // P010 whose 10 bits are the high bits of each component.
+            uint64_t planeOffset = 0;
+        };
+
+        // Common properties of external buffers represented by FDs. Wrapped buffers alias the
+        // external memory without any copy, can't be mapped and can't be transient.
+        struct DAWN_NATIVE_EXPORT ExternalBufferDescriptorFD : ExternalBufferDescriptor {
+          public:
+            int memoryFD;  // A file descriptor from an export of the memory of the buffer
+            std::vector<int> waitFDs;  // File descriptors of semaphores which will be waited on
+
+          protected:
+            ExternalBufferDescriptorFD(ExternalImageDescriptorType type);
+        };
+
+        // Descriptor for opaque file descriptor buffer import
+        struct DAWN_NATIVE_EXPORT ExternalBufferDescriptorOpaqueFD : ExternalBufferDescriptorFD {
+            ExternalBufferDescriptorOpaqueFD();
+
+            VkDeviceSize allocationSize;  // Must match VkMemoryAllocateInfo from buffer creation
+            uint32_t memoryTypeIndex;     // Must match VkMemoryAllocateInfo from buffer creation
+        };
+
+        // Descriptor for dma-buf file descriptor buffer import. The buffer starts at the
+        // beginning of the dma-buf.
+        struct DAWN_NATIVE_EXPORT ExternalBufferDescriptorDmaBuf : ExternalBufferDescriptorFD {
+            ExternalBufferDescriptorDmaBuf();
         };
 
         // Exports a signal semaphore from a wrapped texture. This must be called on wrapped
@@ -65,6 +167,39 @@ namespace dawn_native { namespace vulkan {
         DAWN_NATIVE_EXPORT int ExportSignalSemaphoreOpaqueFD(WGPUDevice cDevice,
                                                              WGPUTexture cTexture);
 
+        // Timeline semaphores are shared once and then signaled and waited on with increasing
+        // values for each wrapped texture, instead of exporting a new semaphore for each of them.
+        // They are owned by the device until ReleaseTimelineSemaphore and must outlive the
+        // textures wrapped with them. On failure, these return VK_NULL_HANDLE.
+        DAWN_NATIVE_EXPORT bool SupportsTimelineSemaphoreOpaqueFD(WGPUDevice cDevice);
+        DAWN_NATIVE_EXPORT ::VkSemaphore ImportTimelineSemaphoreOpaqueFD(WGPUDevice cDevice,
+                                                                         int fd);
+        DAWN_NATIVE_EXPORT ::VkSemaphore CreateExportableTimelineSemaphore(WGPUDevice cDevice,
+                                                                           uint64_t initialValue);
+        // Exports a timeline semaphore created by the device. On failure, returns -1
+        DAWN_NATIVE_EXPORT int ExportTimelineSemaphoreOpaqueFD(WGPUDevice cDevice,
+                                                               ::VkSemaphore semaphore);
+        DAWN_NATIVE_EXPORT void ReleaseTimelineSemaphore(WGPUDevice cDevice,
+                                                         ::VkSemaphore semaphore);
+
+        // Releases a texture wrapped with a timeline semaphore by signaling it with |value|,
+        // which must be greater than its wait value. The texture can't be used afterwards. On
+        // failure, returns false
+        DAWN_NATIVE_EXPORT bool SignalTimelineSemaphore(WGPUDevice cDevice,
+                                                        WGPUTexture cTexture,
+                                                        uint64_t value);
+
+        // Exports a signal semaphore from a wrapped buffer. This must be called on wrapped
+        // buffers before they are destroyed. On failure, returns -1
+        DAWN_NATIVE_EXPORT int ExportBufferSignalSemaphoreOpaqueFD(WGPUDevice cDevice,
+                                                                   WGPUBuffer cBuffer);
+
+        // Imports external memory into a Vulkan buffer, for example vertex data produced by
+        // another API for acceleration structure builds. The first submit using the buffer waits
+        // on the provided semaphores. On failure, returns a nullptr.
+        DAWN_NATIVE_EXPORT WGPUBuffer WrapVulkanBuffer(WGPUDevice cDevice,
+                                                       const ExternalBufferDescriptor* descriptor);
+
         // Imports external memory into a Vulkan image. Internally, this uses external memory /
         // semaphore extensions to import the image and wait on the provided synchronizaton
         // primitives before the texture can be used.
@@ -17,6 +17,7 @@
 
 #include <dawn_native/dawn_native_export.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace dawn_platform {
@@ -28,6 +29,28 @@ namespace dawn_platform {
         GPUWork,     // Actual GPU work
     };
 
+    // An application-provided key-value store that Dawn uses to persist the results of expensive
+    // operations, like shader translation and compilation, across runs. The keys and values are
+    // opaque blobs: implementations must not interpret them.
+    class DAWN_NATIVE_EXPORT CachingInterface {
+      public:
+        virtual ~CachingInterface() {
+        }
+
+        // Returns the size of the value stored for |key|, or 0 when there is none. The value is
+        // copied to |value| only when |valueSize| is at least that size, so the size can be queried
+        // first by passing a null |value|.
+        virtual size_t LoadData(const void* key,
+                                size_t keySize,
+                                void* value,
+                                size_t valueSize) = 0;
+
+        virtual void StoreData(const void* key,
+                               size_t keySize,
+                               const void* value,
+                               size_t valueSize) = 0;
+    };
+
     class DAWN_NATIVE_EXPORT Platform {
       public:
         virtual ~Platform() {
@@ -46,6 +69,14 @@ namespace dawn_platform {
                                        const unsigned char* argTypes,
                                        const uint64_t* argValues,
                                        unsigned char flags) = 0;
+
+        // Returns the cache to use for devices matching |fingerprint|, or nullptr to disable
+        // persistent caching. The fingerprint identifies the adapter and driver so that the
+        // application can keep the cached data of incompatible configurations apart.
+        virtual CachingInterface* GetCachingInterface(const void* fingerprint,
+                                                      size_t fingerprintSize) {
+            return nullptr;
+        }
     };
 
 }  // namespace dawn_platform
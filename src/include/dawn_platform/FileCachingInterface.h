@@ -0,0 +1,88 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNPLATFORM_FILECACHINGINTERFACE_H_
+#define DAWNPLATFORM_FILECACHINGINTERFACE_H_
+
+#include <dawn_platform/DawnPlatform.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dawn_platform {
+
+    // A CachingInterface keeping the entries of one fingerprint in a single file that is mapped
+    // in memory, so that opening a large cache only reads its header and a lookup only touches the
+    // pages of the entry it finds. Platform::GetCachingInterface can open one per fingerprint,
+    // named with GetFileName.
+    //
+    // The file is a header, a hashed index and a value region. The index is an open-addressing
+    // table of (key hash, record offset) slots, and the records appended to the value region hold
+    // their key, so that colliding hashes are told apart, and a checksum of their content. A store
+    // appends its record first and then commits it in the header and the index, so a process that
+    // stops in the middle of a store leaves the previous entries readable. Replaced entries stay
+    // in the value region until the file is compacted, which rewrites it with the live entries and
+    // atomically renames it over the old one. Compaction also grows the index once it is half
+    // full.
+    //
+    // A file must only be opened by one FileCachingInterface at a time.
+    class DAWN_NATIVE_EXPORT FileCachingInterface : public CachingInterface {
+      public:
+        // Returns nullptr when the file can't be opened or created. The content of a file with
+        // another format version or fingerprint is discarded.
+        static std::unique_ptr<FileCachingInterface> Open(const char* path,
+                                                          const void* fingerprint,
+                                                          size_t fingerprintSize);
+
+        // A file name made of the hash of the fingerprint, to keep the caches of several adapters
+        // and drivers in the same directory.
+        static std::string GetFileName(const void* fingerprint, size_t fingerprintSize);
+
+        ~FileCachingInterface() override;
+
+        size_t LoadData(const void* key, size_t keySize, void* value, size_t valueSize) override;
+        void StoreData(const void* key,
+                       size_t keySize,
+                       const void* value,
+                       size_t valueSize) override;
+
+        // Stores compact the file automatically once most of the value region is replaced
+        // entries.
+        bool Compact();
+
+        size_t GetEntryCount() const;
+        uint64_t GetFileSize() const;
+
+      private:
+        class MappedFile;
+
+        FileCachingInterface(const char* path,
+                             uint64_t fingerprintHash,
+                             std::unique_ptr<MappedFile> file);
+
+        bool IsValid() const;
+        bool Reset();
+        bool CompactLocked();
+
+        const std::string mPath;
+        const uint64_t mFingerprintHash;
+
+        mutable std::mutex mMutex;
+        std::unique_ptr<MappedFile> mFile;
+    };
+
+}  // namespace dawn_platform
+
+#endif  // DAWNPLATFORM_FILECACHINGINTERFACE_H_
@@ -0,0 +1,81 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNPLATFORM_TRACINGPLATFORM_H_
+#define DAWNPLATFORM_TRACINGPLATFORM_H_
+
+#include <dawn_platform/DawnPlatform.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dawn_platform {
+
+    // A Platform recording Dawn's trace events in memory so that Dawn can be profiled inside an
+    // application without an external tracing system. Install it with Instance::SetPlatform and
+    // write the recorded events out with GetChromeTraceJSON, which can be loaded in
+    // chrome://tracing or Perfetto.
+    //
+    // Each thread adding events gets its own fixed-size ring buffer so that recording an event
+    // doesn't take any lock: when a ring is full its oldest events get overwritten.
+    class DAWN_NATIVE_EXPORT TracingPlatform : public Platform {
+      public:
+        // |eventsPerThread| is rounded up to a power of two.
+        explicit TracingPlatform(size_t eventsPerThread = 1 << 16);
+        ~TracingPlatform() override;
+
+        // The categories are filtered process-wide: Dawn caches the enabled flag of each category
+        // the first time it is used, so the flags are shared by all the TracingPlatforms.
+        // All the categories are disabled by default.
+        void EnableCategory(TraceCategory category, bool enabled);
+        void EnableAllCategories(bool enabled);
+
+        // These must only be called when no other thread is adding events, otherwise the events
+        // being written at the same time might be torn.
+        std::string GetChromeTraceJSON() const;
+        bool WriteChromeTraceJSON(const char* path) const;
+        void ClearEvents();
+
+        const unsigned char* GetTraceCategoryEnabledFlag(TraceCategory category) override;
+        double MonotonicallyIncreasingTime() override;
+        uint64_t AddTraceEvent(char phase,
+                               const unsigned char* categoryGroupEnabled,
+                               const char* name,
+                               uint64_t id,
+                               double timestamp,
+                               int numArgs,
+                               const char** argNames,
+                               const unsigned char* argTypes,
+                               const uint64_t* argValues,
+                               unsigned char flags) override;
+
+      private:
+        struct ThreadRing;
+
+        ThreadRing* GetLocalThreadRing();
+
+        const size_t mEventsPerThread;
+        const uint64_t mSerial;
+        const std::chrono::steady_clock::time_point mOrigin;
+
+        mutable std::mutex mRingsMutex;
+        std::vector<std::unique_ptr<ThreadRing>> mRings;
+    };
+
+}  // namespace dawn_platform
+
+#endif  // DAWNPLATFORM_TRACINGPLATFORM_H_
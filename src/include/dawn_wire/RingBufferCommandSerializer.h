@@ -0,0 +1,160 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_RINGBUFFERCOMMANDSERIALIZER_H_
+#define DAWNWIRE_RINGBUFFERCOMMANDSERIALIZER_H_
+
+#include "dawn_wire/Wire.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dawn_wire {
+
+    // A single-producer single-consumer ring of serialized commands. The producer is a
+    // RingBufferCommandSerializer and the consumer a RingBufferCommandReader, which may run on
+    // different threads. Neither side takes locks: they only synchronize through the atomic read
+    // and write positions of the ring.
+    class DAWN_WIRE_EXPORT CommandRingBuffer {
+      public:
+        // |capacity| must be a power of two between 64 bytes and 1GB.
+        static size_t GetMemorySize(size_t capacity);
+
+        // Creates a ring in memory owned by the ring, for a client and server in the same
+        // process.
+        explicit CommandRingBuffer(size_t capacity);
+
+        // Creates a ring in |memory|, which must be GetMemorySize(capacity) bytes large and 8
+        // bytes aligned, for example shared memory mapped in the client and the server processes.
+        // Exactly one of the two sides must pass |initialize| and it must do so before the other
+        // side uses the ring. The memory must outlive the ring.
+        CommandRingBuffer(void* memory, size_t capacity, bool initialize);
+
+        ~CommandRingBuffer();
+
+        size_t GetCapacity() const;
+
+      private:
+        friend class RingBufferCommandSerializer;
+        friend class RingBufferCommandReader;
+
+        struct Header;
+
+        std::unique_ptr<uint64_t[]> mOwnedMemory;
+        Header* mHeader;
+        char* mData;
+        uint32_t mCapacity;
+    };
+
+    enum class RingBufferBackpressureMode {
+        // When the ring is full, the serializer waits for the reader to make space.
+        Block,
+        // When the ring is full, the serializer queues the commands on the client and reports it
+        // with the backpressure callback. They are moved to the ring as the reader makes space.
+        Report,
+    };
+
+    struct DAWN_WIRE_EXPORT RingBufferCommandSerializerDescriptor {
+        // The commands are published to the reader in batches. A batch is published on Flush,
+        // once it reaches |flushThreshold| bytes unless it is 0, on EndFrame if
+        // |flushOnEndFrame|, and when it reaches a quarter of the ring capacity.
+        size_t flushThreshold = 0;
+        bool flushOnEndFrame = true;
+
+        RingBufferBackpressureMode backpressureMode = RingBufferBackpressureMode::Block;
+        // Called in the Report mode when commands start being queued on the client, with the
+        // size of the commands queued.
+        std::function<void(size_t)> backpressureCallback;
+    };
+
+    class DAWN_WIRE_EXPORT RingBufferCommandSerializer : public CommandSerializer {
+      public:
+        // |ring| must outlive the serializer.
+        RingBufferCommandSerializer(CommandRingBuffer* ring,
+                                    const RingBufferCommandSerializerDescriptor& descriptor = {});
+        ~RingBufferCommandSerializer() override;
+
+        void* GetCmdSpace(size_t size) override;
+
+        // Publishes all the commands. In the Report mode, the commands queued on the client that
+        // don't fit in the ring stay queued.
+        bool Flush() override;
+
+        // Publishes all the commands if the descriptor's |flushOnEndFrame| is set.
+        void EndFrame();
+
+        // Returns the size of the commands queued on the client because they didn't fit in the
+        // ring, in which case the reader is behind.
+        size_t GetQueuedSize() const;
+
+      private:
+        bool WaitForSpace(uint32_t size, bool block);
+        bool ReserveRecord(uint32_t payloadSize, bool block);
+        bool WriteRecord(uint32_t type, const char* data, uint32_t size, bool block);
+        void CloseBatch();
+        void Publish();
+        void* AllocateQueuedSpace(size_t size);
+        void DrainQueuedBatches(bool block);
+
+        CommandRingBuffer* mRing;
+        RingBufferCommandSerializerDescriptor mDescriptor;
+        uint32_t mMaxRecordSize;
+
+        // The position where the next command is written, and the end of the last complete
+        // record which is the position published to the reader.
+        uint32_t mWrite;
+        uint32_t mCompleted;
+
+        bool mBatchOpen = false;
+        uint32_t mBatchStart = 0;
+
+        // Batches waiting to be moved to the ring, either because they are larger than a record
+        // or because the ring was full. The front batch may have been partially moved in chunks.
+        std::deque<std::vector<char>> mQueuedBatches;
+        size_t mQueuedOffset = 0;
+        bool mReportedBackpressure = false;
+    };
+
+    class DAWN_WIRE_EXPORT RingBufferCommandReader {
+      public:
+        static constexpr size_t kDefaultMaxBatchSize = 256 * 1024 * 1024;
+
+        // |ring| must outlive the reader. Batches larger than |maxBatchSize| are rejected, so that
+        // a writer in another process can't make the reader reassemble commands from chunks
+        // until it runs out of memory.
+        explicit RingBufferCommandReader(CommandRingBuffer* ring,
+                                         size_t maxBatchSize = kDefaultMaxBatchSize);
+        ~RingBufferCommandReader();
+
+        bool HasCommands() const;
+
+        // Passes all the published batches to |handler|. Returns false if the handler fails, if
+        // the ring is corrupted or if a batch is larger than the maximum batch size.
+        bool HandleCommands(CommandHandler* handler);
+
+      private:
+        CommandRingBuffer* mRing;
+        size_t mMaxBatchSize;
+        uint32_t mRead;
+        // Commands larger than a record, reassembled from their chunks.
+        std::vector<char> mLargeBatch;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_RINGBUFFERCOMMANDSERIALIZER_H_
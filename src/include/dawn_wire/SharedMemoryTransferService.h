@@ -0,0 +1,91 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_SHAREDMEMORYTRANSFERSERVICE_H_
+#define DAWNWIRE_SHAREDMEMORYTRANSFERSERVICE_H_
+
+#include "dawn_wire/WireClient.h"
+#include "dawn_wire/WireServer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Memory transfer services for a client and a server on the same host. Each Read/WriteHandle is
+// backed by its own shared memory region, so the mapped data doesn't go through the command
+// stream: the server writes the data of ReadHandles straight into the region and copies the
+// data of WriteHandles out of it. The regions are memfds (or ashmem on old Android kernels) on
+// Linux, POSIX shared memory on the other POSIX platforms and anonymous file mappings on
+// Windows. Only the size and the identifier of the region are serialized in the command stream,
+// the region itself must be passed out-of-band by the embedder.
+//
+// The client could shrink a region while the server accesses it, so on Linux and Android the
+// server only imports memfds sealed with F_SEAL_SHRINK, which the client service creates, and
+// ashmem regions, whose size is fixed once mapped. POSIX shared memory can't be sealed: on the
+// other POSIX platforms the services must only be used with trusted clients.
+//
+// The client can also sub-allocate the WriteHandles from a single transfer region, so that
+// CreateBufferMapped and MapWriteAsync hand out pointers into memory that is already shared with
+// the server instead of creating a region for each buffer.
+
+namespace dawn_wire {
+
+#if defined(_WIN32)
+    // A HANDLE to a file mapping.
+    using SharedMemoryHandle = void*;
+#else
+    // A file descriptor.
+    using SharedMemoryHandle = int;
+#endif
+
+    namespace client {
+        class DAWN_WIRE_EXPORT SharedMemoryExporter {
+          public:
+            virtual ~SharedMemoryExporter();
+
+            // Send the region of |handle| to the server process and return a non-zero identifier
+            // the server's SharedMemoryImporter will import it with, or 0 on failure. |handle| is
+            // only valid during the call, so it must be duplicated (for example by sending it with
+            // SCM_RIGHTS or with DuplicateHandle). The region must be importable by the time the
+            // server processes the commands serialized after this call.
+            virtual uint64_t ExportSharedMemory(SharedMemoryHandle handle, size_t size) = 0;
+        };
+
+        // |exporter| must outlive the service. When |transferRegionSize| isn't 0, WriteHandles
+        // are sub-allocated from a transfer region of that size, created and exported the first
+        // time it is needed. The range of a WriteHandle is reused once the handle is destroyed and
+        // the server copied the data it flushed. WriteHandles that don't fit get their own region.
+        DAWN_WIRE_EXPORT std::unique_ptr<MemoryTransferService> CreateSharedMemoryTransferService(
+            SharedMemoryExporter* exporter,
+            size_t transferRegionSize = 0);
+    }  // namespace client
+
+    namespace server {
+        class DAWN_WIRE_EXPORT SharedMemoryImporter {
+          public:
+            virtual ~SharedMemoryImporter();
+
+            // Write to |handle| the region the client exported with |id| and transfer its
+            // ownership to the caller. Return false if there is no such region.
+            virtual bool ImportSharedMemory(uint64_t id, SharedMemoryHandle* handle) = 0;
+        };
+
+        // |importer| must outlive the service.
+        DAWN_WIRE_EXPORT std::unique_ptr<MemoryTransferService> CreateSharedMemoryTransferService(
+            SharedMemoryImporter* importer);
+    }  // namespace server
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_SHAREDMEMORYTRANSFERSERVICE_H_
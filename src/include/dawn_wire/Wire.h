@@ -35,6 +35,12 @@ namespace dawn_wire {
         virtual const volatile char* HandleCommands(const volatile char* commands, size_t size) = 0;
     };
 
+    // How far ahead of the object IDs a server knows the IDs of new objects can be when the
+    // server allows object ID gaps. The client allocates IDs densely, but the objects of its
+    // command streams are received in the order the streams are flushed, so the IDs allocated by
+    // the streams flushed later are skipped until then.
+    static constexpr uint32_t kMaxObjectIdGap = 64 * 1024;
+
     DAWN_WIRE_EXPORT size_t
     SerializedWGPUDevicePropertiesSize(const WGPUDeviceProperties* deviceProperties);
 
@@ -0,0 +1,86 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_WIRECAPTURE_H_
+#define DAWNWIRE_WIRECAPTURE_H_
+
+#include "dawn_wire/Wire.h"
+
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+namespace dawn_wire {
+
+    // A capture file holds the batches of commands that a WireServer handled, in order. With the
+    // inline memory transfer service the commands carry the contents of the buffer and texture
+    // uploads, so the capture replays on a new WireServer without the application, on any
+    // backend. The object IDs are the ones the client allocated, which makes the replay
+    // deterministic.
+    //
+    // Textures injected in the server and swap chains created with a native implementation are
+    // not part of the capture: commands using them fail to replay. Workloads captured for
+    // offline profiling render to textures instead of presenting.
+    //
+    // The file starts with a magic number and the version of the format, followed by each
+    // batch: its size in bytes as a uint64_t and its commands. Like the commands, the sizes are
+    // in the byte order of the machine that captured them.
+    constexpr uint32_t kWireCaptureMagic = 0x50435744;  // "DWCP"
+    constexpr uint32_t kWireCaptureVersion = 1;
+
+    // Appends each batch of commands to a capture file before forwarding it to its handler. It
+    // goes between the client-to-server serializer and the WireServer, for example as the
+    // handler of a utils::TerribleCommandBuffer.
+    class DAWN_WIRE_EXPORT WireCaptureRecorder : public CommandHandler {
+      public:
+        // Truncates the file at |path|. |handler| can be null to capture commands without
+        // executing them.
+        WireCaptureRecorder(const char* path, CommandHandler* handler = nullptr);
+        ~WireCaptureRecorder() override;
+
+        void SetHandler(CommandHandler* handler);
+
+        // False if the file couldn't be opened, or if writing a batch failed in which case the
+        // capture is truncated.
+        bool IsValid() const;
+
+        const volatile char* HandleCommands(const volatile char* commands,
+                                            size_t size) override;
+
+      private:
+        std::ofstream mFile;
+        CommandHandler* mHandler = nullptr;
+    };
+
+    class DAWN_WIRE_EXPORT WireCaptureReader {
+      public:
+        explicit WireCaptureReader(const char* path);
+        ~WireCaptureReader();
+
+        // False if the file couldn't be opened or isn't a capture of this version.
+        bool IsValid() const;
+
+        // Reads the next batch of commands into |commands|. Returns false at the end of the
+        // capture, or if the file is truncated.
+        bool ReadBatch(std::vector<char>* commands);
+
+      private:
+        std::ifstream mFile;
+        bool mIsValid = false;
+        uint64_t mRemainingSize = 0;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_WIRECAPTURE_H_
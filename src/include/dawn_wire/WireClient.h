@@ -17,6 +17,7 @@
 
 #include "dawn/dawn_proc_table.h"
 #include "dawn_wire/Wire.h"
+#include "dawn_wire/WireStatistics.h"
 
 #include <memory>
 #include <vector>
@@ -37,6 +38,20 @@ namespace dawn_wire {
     struct DAWN_WIRE_EXPORT WireClientDescriptor {
         CommandSerializer* serializer;
         client::MemoryTransferService* memoryTransferService = nullptr;
+        // Send the most common pass encoder commands with a smaller encoding, which omits their
+        // default values and the objects used by the previous command.
+        bool useCompactEncoding = false;
+        // Validate the buffer usage, the SetSubData and WriteBuffer ranges and the use of
+        // destroyed buffers on the client. Invalid commands aren't sent, their validation error
+        // is injected in the device instead.
+        bool useClientValidation = false;
+        // Count the bytes of each type of return command and time the handling of each batch of
+        // return commands, see GetStatistics.
+        bool collectStatistics = false;
+        // Buffer the commands of each thread in its own command stream, see
+        // BeginThreadCommandStream. The compact encoding isn't used with command streams.
+        // The server must use WireServerDescriptor::allowObjectIdGaps.
+        bool useCommandStreams = false;
     };
 
     class DAWN_WIRE_EXPORT WireClient : public CommandHandler {
@@ -44,6 +59,9 @@ namespace dawn_wire {
         WireClient(const WireClientDescriptor& descriptor);
         ~WireClient();
 
+        // The native-only procs, listed in client_unsupported_commands in dawn_wire.json, aren't
+        // sent to the server: they generate a validation error and don't write their outputs.
+        // The acceleration container statistics and memory info queries are native-only.
         static DawnProcTable GetProcs();
 
         WGPUDevice GetDevice() const;
@@ -52,6 +70,29 @@ namespace dawn_wire {
 
         ReservedTexture ReserveTexture(WGPUDevice device);
 
+        // The statistics of the return commands handled by the client, which are empty unless
+        // the client collects statistics. They can be queried and reset from any thread.
+        WireStatistics GetStatistics() const;
+        void ResetStatistics();
+
+        // With useCommandStreams, threads record their commands in command streams of their
+        // own instead of serializing all the API calls of the client. A stream is appended to
+        // the serializer when it's flushed: by Queue::Submit and Queue::Signal, which are the
+        // ordering points between the streams, and by FlushThreadCommandStream. Objects created
+        // in a stream can be used in other streams once it was flushed.
+        // The threads without a stream of their own share a default stream, so their API calls
+        // still need to be serialized. A thread can have a stream with one client at a time.
+        // Creating an object blocks while the stream of another thread holds an unflushed object
+        // ID kMaxObjectIdGap below the new one, so threads must keep flushing their streams.
+        void BeginThreadCommandStream();
+        void FlushThreadCommandStream();
+        void EndThreadCommandStream();
+
+        // Flushes the serializer. With useCommandStreams, the default stream is flushed first
+        // and the serializer must only be flushed with this, since command streams are
+        // appended to it from other threads.
+        bool Flush();
+
       private:
         std::unique_ptr<client::Client> mImpl;
     };
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "dawn_wire/Wire.h"
+#include "dawn_wire/WireStatistics.h"
 
 struct DawnProcTable;
 
@@ -33,6 +34,13 @@ namespace dawn_wire {
         const DawnProcTable* procs;
         CommandSerializer* serializer;
         server::MemoryTransferService* memoryTransferService = nullptr;
+        // Count the bytes of each type of command and time the handling of each batch of
+        // commands, see GetStatistics.
+        bool collectStatistics = false;
+        // Accept the IDs of new objects up to kMaxObjectIdGap ahead of the IDs the server knows,
+        // which the clients using WireClientDescriptor::useCommandStreams need. Otherwise each
+        // ID of a new object must be at most one past the highest ID the server knows.
+        bool allowObjectIdGaps = false;
     };
 
     class DAWN_WIRE_EXPORT WireServer : public CommandHandler {
@@ -45,6 +53,12 @@ namespace dawn_wire {
 
         bool InjectTexture(WGPUTexture texture, uint32_t id, uint32_t generation);
 
+        // The statistics of the commands handled by the server, which are empty unless the
+        // server collects statistics. They can be queried and reset from any thread, for
+        // example to dump them periodically.
+        WireStatistics GetStatistics() const;
+        void ResetStatistics();
+
       private:
         std::unique_ptr<server::Server> mImpl;
     };
@@ -0,0 +1,86 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_WIRESERVERTHREAD_H_
+#define DAWNWIRE_WIRESERVERTHREAD_H_
+
+#include "dawn_wire/Wire.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dawn_wire {
+
+    struct DAWN_WIRE_EXPORT WireServerThreadDescriptor {
+        // Usually a WireServer. Once the thread is created, the server must only be used on the
+        // thread, see WireServerThread::PostTask.
+        CommandHandler* server;
+        // The serializer of the server's return commands, flushed on the thread after each batch
+        // of commands. Optional.
+        CommandSerializer* returnSerializer = nullptr;
+    };
+
+    // Handles the commands of a server on a thread of its own. HandleCommands copies the commands
+    // and returns immediately so that receiving the next commands overlaps with the server
+    // deserializing and executing the previous ones. Servers of different devices can each have
+    // a thread so that their command streams are handled in parallel.
+    class DAWN_WIRE_EXPORT WireServerThread : public CommandHandler {
+      public:
+        WireServerThread(const WireServerThreadDescriptor& descriptor);
+        // Handles the remaining commands before joining the thread.
+        ~WireServerThread() override;
+
+        // Queues a copy of the commands for the thread. Returns nullptr once the server failed to
+        // handle commands, after which the commands are dropped.
+        const volatile char* HandleCommands(const volatile char* commands,
+                                            size_t size) override final;
+
+        // Runs |task| on the thread after the commands queued before it, for example to call
+        // WireServer::InjectTexture.
+        void PostTask(std::function<void()> task);
+
+        // Waits until the thread handled everything queued. Returns false if the server failed
+        // to handle commands.
+        bool Wait();
+
+      private:
+        struct Work {
+            std::vector<char> commands;
+            std::function<void()> task;
+        };
+
+        void Push(Work work);
+        void Run();
+
+        CommandHandler* mServer;
+        CommandSerializer* mReturnSerializer;
+
+        std::mutex mMutex;
+        std::condition_variable mWorkAvailable;
+        std::condition_variable mWorkDone;
+        std::deque<Work> mPendingWork;
+        bool mBusy = false;
+        bool mFailed = false;
+        bool mStopping = false;
+
+        std::thread mThread;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_WIRESERVERTHREAD_H_
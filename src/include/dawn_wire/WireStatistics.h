@@ -0,0 +1,53 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNWIRE_WIRESTATISTICS_H_
+#define DAWNWIRE_WIRESTATISTICS_H_
+
+#include "dawn_wire/dawn_wire_export.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dawn_wire {
+
+    struct WireCommandStatistics {
+        const char* name;
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    // The statistics of the commands handled by a WireServer or a WireClient since they were
+    // created or their statistics were last reset.
+    struct DAWN_WIRE_EXPORT WireStatistics {
+        // Bucket i of the latency histograms counts the batches that took less than 2^i
+        // microseconds and not in a previous bucket, the last bucket counts the rest.
+        static constexpr size_t kLatencyBucketCount = 24;
+
+        // The handled commands, by decreasing number of bytes.
+        std::vector<WireCommandStatistics> commands;
+        uint64_t bytes = 0;
+        uint64_t batchCount = 0;
+        // The time it took HandleCommands to execute each batch of commands.
+        std::array<uint64_t, kLatencyBucketCount> batchLatencyHistogram = {};
+
+        // Returns a human readable dump of the statistics.
+        std::string ToString() const;
+    };
+
+}  // namespace dawn_wire
+
+#endif  // DAWNWIRE_WIRESTATISTICS_H_
@@ -78,6 +78,27 @@ namespace {
         size_t slot;
     };
 
+    void SplitToggles(const char* toggles, std::vector<std::string>* result) {
+        std::istringstream stream(toggles);
+        std::string toggle;
+        while (std::getline(stream, toggle, ',')) {
+            if (!toggle.empty()) {
+                result->push_back(toggle);
+            }
+        }
+    }
+
+    std::string JoinToggles(const std::vector<std::string>& toggles) {
+        std::string result;
+        for (const std::string& toggle : toggles) {
+            if (!result.empty()) {
+                result += ",";
+            }
+            result += toggle;
+        }
+        return result;
+    }
+
     DawnTestEnvironment* gTestEnv = nullptr;
 
 }  // namespace
@@ -110,6 +131,12 @@ DawnTestParam MetalBackend(std::initializer_list<const char*> forceEnabledWorkar
                          forceDisabledWorkarounds);
 }
 
+DawnTestParam NullBackend(std::initializer_list<const char*> forceEnabledWorkarounds,
+                          std::initializer_list<const char*> forceDisabledWorkarounds) {
+    return DawnTestParam(wgpu::BackendType::Null, forceEnabledWorkarounds,
+                         forceDisabledWorkarounds);
+}
+
 DawnTestParam OpenGLBackend(std::initializer_list<const char*> forceEnabledWorkarounds,
                             std::initializer_list<const char*> forceDisabledWorkarounds) {
     return DawnTestParam(wgpu::BackendType::OpenGL, forceEnabledWorkarounds,
@@ -239,6 +266,18 @@ DawnTestEnvironment::DawnTestEnvironment(int argc, char** argv) {
             continue;
         }
 
+        constexpr const char kEnableTogglesArg[] = "--enable-toggles=";
+        if (strstr(argv[i], kEnableTogglesArg) == argv[i]) {
+            SplitToggles(argv[i] + strlen(kEnableTogglesArg), &mEnabledToggles);
+            continue;
+        }
+
+        constexpr const char kDisableTogglesArg[] = "--disable-toggles=";
+        if (strstr(argv[i], kDisableTogglesArg) == argv[i]) {
+            SplitToggles(argv[i] + strlen(kDisableTogglesArg), &mDisabledToggles);
+            continue;
+        }
+
         constexpr const char kWireTraceDirArg[] = "--wire-trace-dir=";
         if (strstr(argv[i], kWireTraceDirArg) == argv[i]) {
             const char* wireTraceDir = argv[i] + strlen(kWireTraceDirArg);
@@ -269,7 +308,9 @@ DawnTestEnvironment::DawnTestEnvironment(int argc, char** argv) {
                    "  --no-use-spvc-parser: Do no use spvc's spir-v parsing insteads of "
                    "spirv-cross's\n"
                    "  --adapter-vendor-id: Select adapter by vendor id to run end2end tests"
-                   "on multi-GPU systems \n";
+                   "on multi-GPU systems \n"
+                   "  --enable-toggles: Comma separated toggles to enable on all devices\n"
+                   "  --disable-toggles: Comma separated toggles to disable on all devices\n";
             continue;
         }
     }
@@ -307,6 +348,12 @@ void DawnTestEnvironment::SetUp() {
                     << "\n"
                        "BeginCaptureOnStartup: "
                     << (mBeginCaptureOnStartup ? "true" : "false")
+                    << "\n"
+                       "EnabledToggles: "
+                    << JoinToggles(mEnabledToggles)
+                    << "\n"
+                       "DisabledToggles: "
+                    << JoinToggles(mDisabledToggles)
                     << "\n"
                        "\n"
                     << "System adapters: \n";
@@ -349,6 +396,14 @@ bool DawnTestEnvironment::IsBackendValidationEnabled() const {
     return mEnableBackendValidation;
 }
 
+const std::vector<std::string>& DawnTestEnvironment::GetEnabledToggles() const {
+    return mEnabledToggles;
+}
+
+const std::vector<std::string>& DawnTestEnvironment::GetDisabledToggles() const {
+    return mDisabledToggles;
+}
+
 bool DawnTestEnvironment::IsDawnValidationSkipped() const {
     return mSkipDawnValidation;
 }
@@ -446,6 +501,10 @@ bool DawnTestBase::IsMetal() const {
     return mParam.backendType == wgpu::BackendType::Metal;
 }
 
+bool DawnTestBase::IsNull() const {
+    return mParam.backendType == wgpu::BackendType::Null;
+}
+
 bool DawnTestBase::IsOpenGL() const {
     return mParam.backendType == wgpu::BackendType::OpenGL;
 }
@@ -628,6 +687,15 @@ void DawnTestBase::SetUp() {
     deviceDescriptor.forceDisabledToggles = mParam.forceDisabledWorkarounds;
     deviceDescriptor.requiredExtensions = GetRequiredExtensions();
 
+    for (const std::string& toggle : gTestEnv->GetEnabledToggles()) {
+        ASSERT(gTestEnv->GetInstance()->GetToggleInfo(toggle.c_str()) != nullptr);
+        deviceDescriptor.forceEnabledToggles.push_back(toggle.c_str());
+    }
+    for (const std::string& toggle : gTestEnv->GetDisabledToggles()) {
+        ASSERT(gTestEnv->GetInstance()->GetToggleInfo(toggle.c_str()) != nullptr);
+        deviceDescriptor.forceDisabledToggles.push_back(toggle.c_str());
+    }
+
     static constexpr char kSkipValidationToggle[] = "skip_validation";
     if (gTestEnv->IsDawnValidationSkipped()) {
         ASSERT(gTestEnv->GetInstance()->GetToggleInfo(kSkipValidationToggle) != nullptr);
@@ -958,6 +1026,9 @@ namespace detail {
 #if defined(DAWN_ENABLE_BACKEND_METAL)
             case wgpu::BackendType::Metal:
 #endif
+#if defined(DAWN_ENABLE_BACKEND_NULL)
+            case wgpu::BackendType::Null:
+#endif
 #if defined(DAWN_ENABLE_BACKEND_OPENGL)
             case wgpu::BackendType::OpenGL:
 #endif
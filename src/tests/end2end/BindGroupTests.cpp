@@ -749,6 +749,85 @@ TEST_P(BindGroupTests, DrawThenChangePipelineAndBindGroup) {
     EXPECT_PIXEL_RGBA8_EQ(notFilled, renderPass.color, max, max);
 }
 
+// Do a draw, then switch to a pipeline using more bind groups and back without drawing. Setting
+// the same bind groups and dynamic offsets again should draw the same thing.
+TEST_P(BindGroupTests, DrawThenSwitchPipelinesBackWithoutDrawing) {
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+
+    // Create a bind group layout which uses a single dynamic uniform buffer.
+    wgpu::BindGroupLayout uniformLayout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Fragment, wgpu::BindingType::UniformBuffer, true}});
+
+    // Create a bind group layout which uses a single dynamic storage buffer.
+    wgpu::BindGroupLayout storageLayout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Fragment, wgpu::BindingType::StorageBuffer, true}});
+
+    // Create a pipeline with pipeline layout (uniform, uniform).
+    wgpu::RenderPipeline pipeline0 = MakeTestPipeline(
+        renderPass, {wgpu::BindingType::UniformBuffer, wgpu::BindingType::UniformBuffer},
+        {uniformLayout, uniformLayout});
+
+    // Create a pipeline with pipeline layout (uniform, uniform, storage).
+    wgpu::RenderPipeline pipeline1 =
+        MakeTestPipeline(renderPass,
+                         {wgpu::BindingType::UniformBuffer, wgpu::BindingType::UniformBuffer,
+                          wgpu::BindingType::StorageBuffer},
+                         {uniformLayout, uniformLayout, storageLayout});
+
+    // Both draws use { color0, color1 }, the sum of the two draws is RGBAunorm(1, 1, 0, 1).
+    std::array<float, 4> color0 = {0.501, 0, 0, 0.501};
+    std::array<float, 4> color1 = {0, 0.501, 0, 0};
+
+    size_t color1Offset = Align(sizeof(color0), kMinDynamicBufferOffsetAlignment);
+
+    std::vector<uint8_t> data(color1Offset + sizeof(color1), 0);
+    memcpy(data.data(), color0.data(), sizeof(color0));
+    memcpy(data.data() + color1Offset, color1.data(), sizeof(color1));
+
+    wgpu::Buffer uniformBuffer =
+        utils::CreateBufferFromData(device, data.data(), data.size(), wgpu::BufferUsage::Uniform);
+    wgpu::Buffer storageBuffer =
+        utils::CreateBufferFromData(device, data.data(), data.size(), wgpu::BufferUsage::Storage);
+
+    wgpu::BindGroup uniformBindGroup =
+        utils::MakeBindGroup(device, uniformLayout, {{0, uniformBuffer, 0, 4 * sizeof(float)}});
+    wgpu::BindGroup storageBindGroup =
+        utils::MakeBindGroup(device, storageLayout, {{0, storageBuffer, 0, 4 * sizeof(float)}});
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+
+    uint32_t color0DynamicOffset = 0;
+    uint32_t color1DynamicOffset = color1Offset;
+    uint32_t storageDynamicOffset = 0;
+
+    pass.SetPipeline(pipeline0);
+    pass.SetBindGroup(0, uniformBindGroup, 1, &color0DynamicOffset);
+    pass.SetBindGroup(1, uniformBindGroup, 1, &color1DynamicOffset);
+    pass.Draw(3, 1, 0, 0);
+
+    // The third bind group is only used by pipeline1 and must not be applied for pipeline0.
+    pass.SetPipeline(pipeline1);
+    pass.SetBindGroup(2, storageBindGroup, 1, &storageDynamicOffset);
+    pass.SetPipeline(pipeline0);
+
+    pass.SetBindGroup(0, uniformBindGroup, 1, &color0DynamicOffset);
+    pass.SetBindGroup(1, uniformBindGroup, 1, &color1DynamicOffset);
+    pass.Draw(3, 1, 0, 0);
+    pass.EndPass();
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    RGBA8 filled(255, 255, 0, 255);
+    RGBA8 notFilled(0, 0, 0, 0);
+    int min = 1, max = kRTSize - 3;
+    EXPECT_PIXEL_RGBA8_EQ(filled, renderPass.color, min, min);
+    EXPECT_PIXEL_RGBA8_EQ(filled, renderPass.color, max, min);
+    EXPECT_PIXEL_RGBA8_EQ(filled, renderPass.color, min, max);
+    EXPECT_PIXEL_RGBA8_EQ(notFilled, renderPass.color, max, max);
+}
+
 // Test that visibility of bindings in BindGroupLayout can be none
 // This test passes by not asserting or crashing.
 TEST_P(BindGroupTests, BindGroupLayoutVisibilityCanBeNone) {
@@ -18,6 +18,7 @@
 #include "common/Constants.h"
 #include "common/Math.h"
 #include "utils/ComboRenderPipelineDescriptor.h"
+#include "utils/TextureStreamer.h"
 #include "utils/WGPUHelpers.h"
 
 // The helper struct to configure the copies between buffers and textures.
@@ -1048,6 +1049,74 @@ TEST_P(CompressedTextureBCFormatTest, LargeImageHeightAndClampedCopyExtent) {
     }
 }
 
+// Test streaming the mip levels of BC textures with a budget smaller than the levels, from the
+// smallest level to the largest.
+TEST_P(CompressedTextureBCFormatTest, StreamMipLevels) {
+    // TODO(jiawei.shao@intel.com): find out why this test is flaky on Windows Intel Vulkan
+    // bots.
+    DAWN_SKIP_TEST_IF(IsIntel() && IsVulkan() && IsWindows());
+
+    // Queue::WriteTexture isn't implemented on Metal and OpenGL yet.
+    DAWN_SKIP_TEST_IF(IsMetal() || IsOpenGL());
+
+    DAWN_SKIP_TEST_IF(!IsBCFormatSupported());
+
+    constexpr uint32_t kMipmapLevelCount = 4;
+    CopyConfig config;
+    config.textureDescriptor.usage = kDefaultBCFormatTextureUsage;
+    config.textureDescriptor.size = {32, 32, 1};
+    config.textureDescriptor.mipLevelCount = kMipmapLevelCount;
+
+    wgpu::RenderPipeline renderPipeline = CreateRenderPipelineForTest();
+    for (wgpu::TextureFormat format : kBCFormats) {
+        config.textureDescriptor.format = format;
+        wgpu::Texture bcTexture = device.CreateTexture(&config.textureDescriptor);
+
+        utils::StreamedTextureDescriptor streamedDescriptor;
+        streamedDescriptor.texture = bcTexture;
+        streamedDescriptor.format = format;
+        streamedDescriptor.size = config.textureDescriptor.size;
+        streamedDescriptor.mipLevelCount = kMipmapLevelCount;
+
+        utils::TextureStreamer streamer(queue);
+        uint32_t textureId = streamer.AddTexture(streamedDescriptor);
+
+        std::vector<uint8_t> oneBlockData = GetOneBlockBCFormatTextureData(format);
+        for (uint32_t level = 0; level < kMipmapLevelCount; ++level) {
+            uint32_t blockCount = (32 >> level) / kBCBlockWidthInTexels;
+            std::vector<uint8_t> levelData;
+            for (uint32_t i = 0; i < blockCount * blockCount; ++i) {
+                levelData.insert(levelData.end(), oneBlockData.begin(), oneBlockData.end());
+            }
+            streamer.SetLevelData(textureId, level, levelData.data(), levelData.size());
+        }
+
+        // The budget is a single row of blocks of level 0.
+        const uint64_t kBudget = (32 / kBCBlockWidthInTexels) * oneBlockData.size();
+        uint32_t minResidentLevel = kMipmapLevelCount;
+        while (minResidentLevel > 0) {
+            EXPECT_LE(streamer.Upload(kBudget), kBudget);
+            WaitABit();
+
+            uint32_t newMinResidentLevel = streamer.GetMinResidentLevel(textureId);
+            EXPECT_LE(newMinResidentLevel, minResidentLevel);
+            minResidentLevel = newMinResidentLevel;
+        }
+        EXPECT_FALSE(streamer.HasPendingUploads());
+
+        for (uint32_t level = 0; level < kMipmapLevelCount; ++level) {
+            config.viewMipmapLevel = level;
+            wgpu::BindGroup bindGroup = CreateBindGroupForTest(
+                renderPipeline.GetBindGroupLayout(0), bcTexture, format, 0, level);
+
+            wgpu::Extent3D virtualSizeAtLevel = GetVirtualSizeAtLevel(config);
+            std::vector<RGBA8> expectedData = GetExpectedData(format, virtualSizeAtLevel);
+            VerifyCompressedTexturePixelValues(renderPipeline, bindGroup, virtualSizeAtLevel,
+                                               {0, 0, 0}, virtualSizeAtLevel, expectedData);
+        }
+    }
+}
+
 // TODO(jiawei.shao@intel.com): support BC formats on OpenGL backend
 DAWN_INSTANTIATE_TEST(CompressedTextureBCFormatTest,
                       D3D12Backend(),
@@ -108,4 +108,5 @@ DAWN_INSTANTIATE_TEST(ComputeIndirectTests,
                       D3D12Backend(),
                       MetalBackend(),
                       OpenGLBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"validate_indirect_arguments_on_gpu"}));
@@ -16,6 +16,8 @@
 
 #include "utils/WGPUHelpers.h"
 
+#include <array>
+
 class ComputeStorageBufferBarrierTests : public DawnTest {
   protected:
     static constexpr uint32_t kNumValues = 100;
@@ -192,6 +194,63 @@ TEST_P(ComputeStorageBufferBarrierTests, UniformToStorageAddPingPong) {
     EXPECT_BUFFER_U32_RANGE_EQ(expectedB.data(), bufferB, 0, kNumValues);
 }
 
+// Test that the dispatches of passes with independent dispatches still see the writes made by the
+// previous passes.
+TEST_P(ComputeStorageBufferBarrierTests, IndependentDispatchesBetweenPasses) {
+    constexpr uint32_t kBufferCount = 4;
+
+    std::vector<uint32_t> data(kNumValues, 0);
+    std::vector<uint32_t> expected(kNumValues, 0x1234 * kIterations);
+
+    uint64_t bufferSize = static_cast<uint64_t>(data.size() * sizeof(uint32_t));
+
+    wgpu::ShaderModule module =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+        #version 450
+        #define kNumValues 100
+        layout(std430, set = 0, binding = 0) buffer Buf { uint buf[kNumValues]; };
+        void main() {
+            buf[gl_GlobalInvocationID.x] += 0x1234;
+        }
+    )");
+
+    wgpu::ComputePipelineDescriptor pipelineDesc = {};
+    pipelineDesc.computeStage.module = module;
+    pipelineDesc.computeStage.entryPoint = "main";
+    wgpu::ComputePipeline pipeline = device.CreateComputePipeline(&pipelineDesc);
+
+    std::array<wgpu::Buffer, kBufferCount> buffers;
+    std::array<wgpu::BindGroup, kBufferCount> bindGroups;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        buffers[i] = utils::CreateBufferFromData(
+            device, data.data(), bufferSize,
+            wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc);
+        bindGroups[i] = utils::MakeBindGroup(device, pipeline.GetBindGroupLayout(0),
+                                             {{0, buffers[i], 0, bufferSize}});
+    }
+
+    // Each dispatch of a pass increments a different buffer, and each pass all of them.
+    wgpu::ComputePassDescriptor passDescriptor;
+    passDescriptor.independentDispatches = true;
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t i = 0; i < kIterations; ++i) {
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&passDescriptor);
+        pass.SetPipeline(pipeline);
+        for (uint32_t j = 0; j < kBufferCount; ++j) {
+            pass.SetBindGroup(0, bindGroups[j]);
+            pass.Dispatch(kNumValues, 1, 1);
+        }
+        pass.EndPass();
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffers[i], 0, kNumValues);
+    }
+}
+
 DAWN_INSTANTIATE_TEST(ComputeStorageBufferBarrierTests,
                       D3D12Backend(),
                       MetalBackend(),
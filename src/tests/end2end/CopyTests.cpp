@@ -14,6 +14,7 @@
 
 #include "tests/DawnTest.h"
 
+#include <algorithm>
 #include <array>
 #include "common/Constants.h"
 #include "common/Math.h"
@@ -732,3 +733,246 @@ TEST_P(CopyTests_T2T, TextureMip) {
 // TODO(brandon1.jones@intel.com) Add test for ensuring blitCommandEncoder on Metal.
 
 DAWN_INSTANTIATE_TEST(CopyTests_T2T, D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend());
+
+class QueueWriteTextureTests : public DawnTest {
+  protected:
+    wgpu::Texture CreateTexture(uint32_t width, uint32_t height) {
+        wgpu::TextureDescriptor descriptor;
+        descriptor.dimension = wgpu::TextureDimension::e2D;
+        descriptor.size = {width, height, 1};
+        descriptor.arrayLayerCount = 1;
+        descriptor.sampleCount = 1;
+        descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+        descriptor.mipLevelCount = 1;
+        descriptor.usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc;
+        return device.CreateTexture(&descriptor);
+    }
+
+    static std::vector<RGBA8> GetExpectedData(uint32_t width, uint32_t height) {
+        std::vector<RGBA8> data(width * height);
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                data[y * width + x] = RGBA8(x, y, x + y, 255);
+            }
+        }
+        return data;
+    }
+};
+
+// Test writing rows which are tightly packed, and so not aligned to 256 bytes.
+TEST_P(QueueWriteTextureTests, TightlyPackedRows) {
+    constexpr uint32_t kWidth = 13;
+    constexpr uint32_t kHeight = 7;
+    wgpu::Texture texture = CreateTexture(kWidth, kHeight);
+    std::vector<RGBA8> data = GetExpectedData(kWidth, kHeight);
+
+    wgpu::TextureCopyView textureCopyView = utils::CreateTextureCopyView(texture, 0, 0, {0, 0, 0});
+    wgpu::TextureDataLayout dataLayout;
+    wgpu::Extent3D writeSize = {kWidth, kHeight, 1};
+    queue.WriteTexture(&textureCopyView, data.data(), data.size() * sizeof(RGBA8), &dataLayout,
+                       &writeSize);
+
+    EXPECT_TEXTURE_RGBA8_EQ(data.data(), texture, 0, 0, kWidth, kHeight, 0, 0);
+}
+
+// Test writing a region of the texture from data with an offset and padded rows.
+TEST_P(QueueWriteTextureTests, PaddedRowsWithOffset) {
+    constexpr uint32_t kWidth = 13;
+    constexpr uint32_t kHeight = 7;
+    constexpr uint32_t kOffset = 8;
+    constexpr uint32_t kRowPitch = kWidth * sizeof(RGBA8) + 12;
+    wgpu::Texture texture = CreateTexture(kWidth + 3, kHeight + 2);
+    std::vector<RGBA8> expected = GetExpectedData(kWidth, kHeight);
+
+    std::vector<uint8_t> data(kOffset + kRowPitch * kHeight);
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        memcpy(&data[kOffset + y * kRowPitch], &expected[y * kWidth], kWidth * sizeof(RGBA8));
+    }
+
+    wgpu::TextureCopyView textureCopyView = utils::CreateTextureCopyView(texture, 0, 0, {3, 2, 0});
+    wgpu::TextureDataLayout dataLayout;
+    dataLayout.offset = kOffset;
+    dataLayout.rowPitch = kRowPitch;
+    wgpu::Extent3D writeSize = {kWidth, kHeight, 1};
+    queue.WriteTexture(&textureCopyView, data.data(), data.size(), &dataLayout, &writeSize);
+
+    EXPECT_TEXTURE_RGBA8_EQ(expected.data(), texture, 3, 2, kWidth, kHeight, 0, 0);
+}
+
+DAWN_INSTANTIATE_TEST(QueueWriteTextureTests, D3D12Backend(), VulkanBackend());
+
+class GenerateMipmapsTests : public DawnTest {};
+
+// Test the mip levels generated from a level of a single color have that color, in every layer.
+TEST_P(GenerateMipmapsTests, SolidColorLayers) {
+    constexpr uint32_t kSize = 64;
+    constexpr uint32_t kLevelCount = 7;
+    constexpr uint32_t kLayerCount = 2;
+    const RGBA8 kColors[kLayerCount] = {RGBA8(255, 0, 0, 255), RGBA8(0, 128, 255, 64)};
+
+    wgpu::TextureDescriptor descriptor;
+    descriptor.dimension = wgpu::TextureDimension::e2D;
+    descriptor.size = {kSize, kSize, 1};
+    descriptor.arrayLayerCount = kLayerCount;
+    descriptor.sampleCount = 1;
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.mipLevelCount = kLevelCount;
+    descriptor.usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    std::vector<wgpu::Buffer> buffers;
+    for (uint32_t layer = 0; layer < kLayerCount; ++layer) {
+        std::vector<RGBA8> data(kSize * kSize, kColors[layer]);
+        buffers.push_back(utils::CreateBufferFromData(device, data.data(),
+                                                      data.size() * sizeof(RGBA8),
+                                                      wgpu::BufferUsage::CopySrc));
+
+        wgpu::BufferCopyView bufferCopyView =
+            utils::CreateBufferCopyView(buffers.back(), 0, kSize * sizeof(RGBA8), 0);
+        wgpu::TextureCopyView textureCopyView =
+            utils::CreateTextureCopyView(texture, 0, layer, {0, 0, 0});
+        wgpu::Extent3D copySize = {kSize, kSize, 1};
+        encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+    }
+    encoder.GenerateMipmaps(texture, 0, kLevelCount);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    for (uint32_t layer = 0; layer < kLayerCount; ++layer) {
+        for (uint32_t level = 1; level < kLevelCount; ++level) {
+            uint32_t levelSize = kSize >> level;
+            std::vector<RGBA8> expected(levelSize * levelSize, kColors[layer]);
+            EXPECT_TEXTURE_RGBA8_EQ(expected.data(), texture, 0, 0, levelSize, levelSize, level,
+                                    layer);
+        }
+    }
+}
+
+DAWN_INSTANTIATE_TEST(GenerateMipmapsTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
+
+// Consecutive copies between the same resources may be recorded together by the backends.
+class ConsecutiveCopyTests : public DawnTest {
+  protected:
+    wgpu::Buffer CreateSourceBuffer(uint32_t count) {
+        std::vector<uint32_t> data(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            data[i] = i + 1;
+        }
+        return utils::CreateBufferFromData(device, data.data(), count * sizeof(uint32_t),
+                                           wgpu::BufferUsage::CopySrc);
+    }
+
+    wgpu::Buffer CreateDestinationBuffer(uint32_t count) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = count * sizeof(uint32_t);
+        descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+        return device.CreateBuffer(&descriptor);
+    }
+};
+
+// Test many small copies that continue each other.
+TEST_P(ConsecutiveCopyTests, ContiguousBufferCopies) {
+    constexpr uint32_t kCount = 64;
+    wgpu::Buffer source = CreateSourceBuffer(kCount);
+    wgpu::Buffer destination = CreateDestinationBuffer(kCount);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t i = 0; i < kCount; ++i) {
+        encoder.CopyBufferToBuffer(source, i * sizeof(uint32_t), destination,
+                                   i * sizeof(uint32_t), sizeof(uint32_t));
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    std::vector<uint32_t> expected(kCount);
+    for (uint32_t i = 0; i < kCount; ++i) {
+        expected[i] = i + 1;
+    }
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), destination, 0, kCount);
+}
+
+// Test copies writing the same destination range are still done in order.
+TEST_P(ConsecutiveCopyTests, OverlappingBufferCopies) {
+    constexpr uint32_t kCount = 16;
+    wgpu::Buffer source = CreateSourceBuffer(kCount);
+    wgpu::Buffer destination = CreateDestinationBuffer(kCount);
+
+    // Write [8, 16), then [1, 8) and [0, 4) over the start of it.
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(source, 8 * sizeof(uint32_t), destination, 0,
+                               8 * sizeof(uint32_t));
+    encoder.CopyBufferToBuffer(source, 0, destination, sizeof(uint32_t), 7 * sizeof(uint32_t));
+    encoder.CopyBufferToBuffer(source, 12 * sizeof(uint32_t), destination, 0,
+                               4 * sizeof(uint32_t));
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    std::vector<uint32_t> expected = {13, 14, 15, 16, 4, 5, 6, 7};
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), destination, 0, expected.size());
+}
+
+// Test copies from a buffer to separate and overlapping regions of a texture.
+TEST_P(ConsecutiveCopyTests, BufferToTextureCopies) {
+    constexpr uint32_t kSize = 4;
+    constexpr uint32_t kRowPitch = kTextureRowPitchAlignment;
+    constexpr uint32_t kPixelsPerRow = kRowPitch / sizeof(RGBA8);
+
+    // Each row of the buffer is a different color.
+    std::vector<RGBA8> data(kPixelsPerRow * kSize * 2);
+    for (uint32_t row = 0; row < kSize * 2; ++row) {
+        std::fill(data.begin() + row * kPixelsPerRow, data.begin() + (row + 1) * kPixelsPerRow,
+                  RGBA8(row * 16, 255 - row * 16, 0, 255));
+    }
+    wgpu::Buffer buffer = utils::CreateBufferFromData(device, data.data(),
+                                                      data.size() * sizeof(RGBA8),
+                                                      wgpu::BufferUsage::CopySrc);
+
+    wgpu::TextureDescriptor descriptor;
+    descriptor.dimension = wgpu::TextureDimension::e2D;
+    descriptor.size = {kSize, kSize, 1};
+    descriptor.arrayLayerCount = 1;
+    descriptor.sampleCount = 1;
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.mipLevelCount = 1;
+    descriptor.usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::CopySrc;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    // Copy the first rows of the buffer to each row of the texture, then the last rows of the
+    // buffer over the second and third rows.
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::Extent3D rowSize = {kSize, 1, 1};
+    for (uint32_t row = 0; row < kSize; ++row) {
+        wgpu::BufferCopyView bufferCopyView =
+            utils::CreateBufferCopyView(buffer, row * kRowPitch, kRowPitch, 0);
+        wgpu::TextureCopyView textureCopyView =
+            utils::CreateTextureCopyView(texture, 0, 0, {0, row, 0});
+        encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &rowSize);
+    }
+    {
+        wgpu::BufferCopyView bufferCopyView =
+            utils::CreateBufferCopyView(buffer, kSize * kRowPitch, kRowPitch, 0);
+        wgpu::TextureCopyView textureCopyView =
+            utils::CreateTextureCopyView(texture, 0, 0, {0, 1, 0});
+        wgpu::Extent3D copySize = {kSize, 2, 1};
+        encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    const uint32_t kExpectedBufferRows[kSize] = {0, kSize, kSize + 1, 3};
+    for (uint32_t row = 0; row < kSize; ++row) {
+        std::vector<RGBA8> expected(kSize, data[kExpectedBufferRows[row] * kPixelsPerRow]);
+        EXPECT_TEXTURE_RGBA8_EQ(expected.data(), texture, 0, row, kSize, 1, 0, 0);
+    }
+}
+
+DAWN_INSTANTIATE_TEST(ConsecutiveCopyTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
@@ -17,6 +17,8 @@
 #include "utils/ComboRenderPipelineDescriptor.h"
 #include "utils/WGPUHelpers.h"
 
+#include <cstring>
+
 constexpr uint32_t kRTSize = 4;
 
 class DrawIndexedIndirectTest : public DawnTest {
@@ -161,8 +163,29 @@ TEST_P(DrawIndexedIndirectTest, IndirectOffset) {
     Test({3, 1, 0, 4, 0, 3, 1, 3, 4, 0}, 0, 5 * sizeof(uint32_t), filled, notFilled);
 }
 
+// Test that the indirect arguments are clamped to the index buffer when they are validated on the
+// GPU.
+TEST_P(DrawIndexedIndirectTest, ClampedToIndexBuffer) {
+    DAWN_SKIP_TEST_IF(UsesWire());
+    bool validatesArguments = false;
+    for (const char* toggle : dawn_native::GetTogglesUsed(device.Get())) {
+        validatesArguments |= strcmp(toggle, "validate_indirect_arguments_on_gpu") == 0;
+    }
+    DAWN_SKIP_TEST_IF(!validatesArguments);
+
+    RGBA8 filled(0, 255, 0, 255);
+    RGBA8 notFilled(0, 0, 0, 0);
+
+    // The index count is clamped to the 6 indices after the offset.
+    Test({100, 1, 0, 0, 0}, 6 * sizeof(uint32_t), 0, filled, filled);
+
+    // The first index is clamped to the end of the index buffer, so nothing is drawn.
+    Test({3, 1, 100, 0, 0}, 0, 0, notFilled, notFilled);
+}
+
 DAWN_INSTANTIATE_TEST(DrawIndexedIndirectTest,
                       D3D12Backend(),
                       MetalBackend(),
                       OpenGLBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"validate_indirect_arguments_on_gpu"}));
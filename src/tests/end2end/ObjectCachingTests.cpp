@@ -400,4 +400,79 @@ TEST_P(ObjectCachingTest, SamplerDeduplication) {
     EXPECT_EQ(sampler.Get() == sameSampler.Get(), !UsesWire());
 }
 
+// Test that TextureViews are correctly deduplicated.
+TEST_P(ObjectCachingTest, TextureViewDeduplication) {
+    wgpu::TextureDescriptor textureDesc;
+    textureDesc.size = {16, 16, 1};
+    textureDesc.arrayLayerCount = 2;
+    textureDesc.mipLevelCount = 2;
+    textureDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+    textureDesc.usage = wgpu::TextureUsage::Sampled;
+    wgpu::Texture texture = device.CreateTexture(&textureDesc);
+    wgpu::Texture otherTexture = device.CreateTexture(&textureDesc);
+
+    wgpu::TextureView view = texture.CreateView();
+    wgpu::TextureView sameView = texture.CreateView();
+
+    // The defaults of a descriptor are resolved before the views are compared.
+    wgpu::TextureViewDescriptor explicitDesc;
+    explicitDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+    explicitDesc.dimension = wgpu::TextureViewDimension::e2DArray;
+    explicitDesc.mipLevelCount = 2;
+    explicitDesc.arrayLayerCount = 2;
+    wgpu::TextureView sameExplicitView = texture.CreateView(&explicitDesc);
+
+    wgpu::TextureView otherViewTexture = otherTexture.CreateView();
+
+    wgpu::TextureViewDescriptor otherDescMipLevel = explicitDesc;
+    otherDescMipLevel.baseMipLevel = 1;
+    otherDescMipLevel.mipLevelCount = 1;
+    wgpu::TextureView otherViewMipLevel = texture.CreateView(&otherDescMipLevel);
+
+    wgpu::TextureViewDescriptor otherDescArrayLayer = explicitDesc;
+    otherDescArrayLayer.dimension = wgpu::TextureViewDimension::e2D;
+    otherDescArrayLayer.baseArrayLayer = 1;
+    otherDescArrayLayer.arrayLayerCount = 1;
+    wgpu::TextureView otherViewArrayLayer = texture.CreateView(&otherDescArrayLayer);
+
+    EXPECT_NE(view.Get(), otherViewTexture.Get());
+    EXPECT_NE(view.Get(), otherViewMipLevel.Get());
+    EXPECT_NE(view.Get(), otherViewArrayLayer.Get());
+    EXPECT_EQ(view.Get() == sameView.Get(), !UsesWire());
+    EXPECT_EQ(view.Get() == sameExplicitView.Get(), !UsesWire());
+}
+
 DAWN_INSTANTIATE_TEST(ObjectCachingTest, D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend());
+
+class BindGroupCachingTest : public DawnTest {};
+
+// Test that BindGroups are correctly deduplicated when the cache_bind_groups toggle is enabled.
+TEST_P(BindGroupCachingTest, BindGroupDeduplication) {
+    wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Fragment, wgpu::BindingType::UniformBuffer}});
+
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.size = 512;
+    bufferDesc.usage = wgpu::BufferUsage::Uniform;
+    wgpu::Buffer buffer = device.CreateBuffer(&bufferDesc);
+    wgpu::Buffer otherBuffer = device.CreateBuffer(&bufferDesc);
+
+    wgpu::BindGroup bindGroup = utils::MakeBindGroup(device, bgl, {{0, buffer, 0, 256}});
+    wgpu::BindGroup sameBindGroup = utils::MakeBindGroup(device, bgl, {{0, buffer, 0, 256}});
+    wgpu::BindGroup otherBindGroupBuffer =
+        utils::MakeBindGroup(device, bgl, {{0, otherBuffer, 0, 256}});
+    wgpu::BindGroup otherBindGroupOffset =
+        utils::MakeBindGroup(device, bgl, {{0, buffer, 256, 256}});
+    wgpu::BindGroup otherBindGroupSize = utils::MakeBindGroup(device, bgl, {{0, buffer, 0, 128}});
+
+    EXPECT_NE(bindGroup.Get(), otherBindGroupBuffer.Get());
+    EXPECT_NE(bindGroup.Get(), otherBindGroupOffset.Get());
+    EXPECT_NE(bindGroup.Get(), otherBindGroupSize.Get());
+    EXPECT_EQ(bindGroup.Get() == sameBindGroup.Get(), !UsesWire());
+}
+
+DAWN_INSTANTIATE_TEST(BindGroupCachingTest,
+                      D3D12Backend({"cache_bind_groups"}),
+                      MetalBackend({"cache_bind_groups"}),
+                      OpenGLBackend({"cache_bind_groups"}),
+                      VulkanBackend({"cache_bind_groups"}));
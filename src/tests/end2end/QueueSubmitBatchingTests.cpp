@@ -0,0 +1,93 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+class QueueSubmitBatchingTests : public DawnTest {
+  protected:
+    // Submits a copy of |value| from a new buffer to |destination| at |offset|.
+    void SubmitCopy(wgpu::Buffer destination, uint64_t offset, uint32_t value) {
+        wgpu::Buffer source =
+            utils::CreateBufferFromData(device, &value, sizeof(value), wgpu::BufferUsage::CopySrc);
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(source, 0, destination, offset, sizeof(value));
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    void WaitForCompletedValue(wgpu::Fence fence, uint64_t completedValue) {
+        while (fence.GetCompletedValue() < completedValue) {
+            WaitABit();
+        }
+    }
+};
+
+// Test that the commands of consecutive submits execute in order.
+TEST_P(QueueSubmitBatchingTests, SubmitsExecuteInOrder) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 8;
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    SubmitCopy(buffer, 0, 1);
+    SubmitCopy(buffer, 4, 2);
+    SubmitCopy(buffer, 0, 3);
+
+    EXPECT_BUFFER_U32_EQ(3, buffer, 0);
+    EXPECT_BUFFER_U32_EQ(2, buffer, 4);
+}
+
+// Test that a fence signaled after submits completes once their commands are.
+TEST_P(QueueSubmitBatchingTests, FenceSignalAfterSubmits) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    wgpu::FenceDescriptor fenceDescriptor;
+    wgpu::Fence fence = queue.CreateFence(&fenceDescriptor);
+
+    SubmitCopy(buffer, 0, 1);
+    SubmitCopy(buffer, 0, 2);
+    queue.Signal(fence, 1);
+    WaitForCompletedValue(fence, 1);
+
+    EXPECT_BUFFER_U32_EQ(2, buffer, 0);
+}
+
+// Test that flushing the queue submits the batched commands.
+TEST_P(QueueSubmitBatchingTests, Flush) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    SubmitCopy(buffer, 0, 1);
+    queue.Flush();
+    SubmitCopy(buffer, 0, 2);
+    queue.Flush();
+    queue.Flush();
+
+    EXPECT_BUFFER_U32_EQ(2, buffer, 0);
+}
+
+DAWN_INSTANTIATE_TEST(QueueSubmitBatchingTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_batch_queue_submits"}));
@@ -115,6 +115,58 @@ TEST_P(RenderPassTest, TwoRenderPassesInOneCommandBuffer) {
     EXPECT_PIXEL_RGBA8_EQ(RGBA8::kGreen, renderTarget2, kRTSize - 1, 1);
 }
 
+// Test that consecutive render passes on the same attachment, which the backends can record in a
+// single render pass instance, each see the contents of the previous one.
+TEST_P(RenderPassTest, ConsecutiveRenderPassesOnSameAttachment) {
+    wgpu::Texture renderTarget = CreateDefault2DTexture();
+    wgpu::TextureView renderTargetView = renderTarget.CreateView();
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+
+    {
+        // In the first render pass we clear renderTarget to red and draw a blue triangle in the
+        // bottom left of it.
+        utils::ComboRenderPassDescriptor renderPass({renderTargetView});
+        renderPass.cColorAttachments[0].clearColor = {1.0f, 0.0f, 0.0f, 1.0f};
+
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(pipeline);
+        pass.Draw(3, 1, 0, 0);
+        pass.EndPass();
+    }
+
+    {
+        // In the second render pass we load renderTarget and draw a blue triangle in the bottom
+        // left of its right half.
+        utils::ComboRenderPassDescriptor renderPass({renderTargetView});
+        renderPass.cColorAttachments[0].loadOp = wgpu::LoadOp::Load;
+
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(pipeline);
+        pass.SetViewport(kRTSize / 2, 0, kRTSize / 2, kRTSize, 0.0f, 1.0f);
+        pass.Draw(3, 1, 0, 0);
+        pass.EndPass();
+    }
+
+    {
+        // The third render pass doesn't inherit the viewport of the second one.
+        utils::ComboRenderPassDescriptor renderPass({renderTargetView});
+        renderPass.cColorAttachments[0].loadOp = wgpu::LoadOp::Load;
+
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(pipeline);
+        pass.Draw(3, 1, 0, 0);
+        pass.EndPass();
+    }
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kBlue, renderTarget, 1, kRTSize - 1);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kBlue, renderTarget, kRTSize / 2 + 1, kRTSize - 1);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, renderTarget, kRTSize - 1, 1);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, renderTarget, kRTSize / 2 - 1, kRTSize / 2 - 2);
+}
+
 // Verify that the content in the color attachment will not be changed if there is no corresponding
 // fragment shader outputs in the render pipeline, the load operation is LoadOp::Load and the store
 // operation is StoreOp::Store.
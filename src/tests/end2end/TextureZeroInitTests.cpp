@@ -1034,6 +1034,70 @@ TEST_P(TextureZeroInitTest, PreservesInitializedArrayLayer) {
     EXPECT_EQ(true, dawn_native::IsTextureSubresourceInitialized(sampleTexture.Get(), 0, 1, 0, 2));
 }
 
+// Test that sampling a view of an initialized mip doesn't lazy clear the other mips, which are
+// outside of the view.
+TEST_P(TextureZeroInitTest, SampledViewOnlyClearsItsSubresources) {
+    wgpu::TextureDescriptor sampleTextureDescriptor = CreateTextureDescriptor(
+        2, 1,
+        wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::Sampled,
+        kColorFormat);
+    wgpu::Texture sampleTexture = device.CreateTexture(&sampleTextureDescriptor);
+
+    wgpu::SamplerDescriptor samplerDesc = utils::GetDefaultSamplerDescriptor();
+    wgpu::Sampler sampler = device.CreateSampler(&samplerDesc);
+
+    wgpu::TextureDescriptor renderTextureDescriptor = CreateTextureDescriptor(
+        1, 1, wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::OutputAttachment, kColorFormat);
+    wgpu::Texture renderTexture = device.CreateTexture(&renderTextureDescriptor);
+
+    // Fill the sample texture's first mip with data
+    std::vector<uint8_t> data(kFormatBlockByteSize * kSize * kSize, 2);
+    wgpu::Buffer stagingBuffer = utils::CreateBufferFromData(
+        device, data.data(), static_cast<uint32_t>(data.size()), wgpu::BufferUsage::CopySrc);
+    wgpu::BufferCopyView bufferCopyView = utils::CreateBufferCopyView(stagingBuffer, 0, 0, 0);
+    wgpu::TextureCopyView textureCopyView =
+        utils::CreateTextureCopyView(sampleTexture, 0, 0, {0, 0, 0});
+    wgpu::Extent3D copySize = {kSize, kSize, 1};
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    // Expect 0 lazy clears because the texture subresource will be completely copied to
+    EXPECT_LAZY_CLEAR(0u, queue.Submit(1, &commands));
+
+    // Create render pipeline
+    utils::ComboRenderPipelineDescriptor renderPipelineDescriptor(device);
+    renderPipelineDescriptor.vertexStage.module = CreateBasicVertexShaderForTest();
+    renderPipelineDescriptor.cFragmentStage.module = CreateSampledTextureFragmentShaderForTest();
+    renderPipelineDescriptor.cColorStates[0].format = kColorFormat;
+    wgpu::RenderPipeline renderPipeline = device.CreateRenderPipeline(&renderPipelineDescriptor);
+
+    // Create bindgroup with a view of the first mip only
+    wgpu::TextureViewDescriptor viewDescriptor = CreateTextureViewDescriptor(0, 0);
+    wgpu::BindGroup bindGroup =
+        utils::MakeBindGroup(device, renderPipeline.GetBindGroupLayout(0),
+                             {{0, sampler}, {1, sampleTexture.CreateView(&viewDescriptor)}});
+
+    // Encode pass and submit
+    encoder = device.CreateCommandEncoder();
+    utils::ComboRenderPassDescriptor renderPassDesc({renderTexture.CreateView()});
+    renderPassDesc.cColorAttachments[0].loadOp = wgpu::LoadOp::Clear;
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPassDesc);
+    pass.SetPipeline(renderPipeline);
+    pass.SetBindGroup(0, bindGroup);
+    pass.Draw(6, 1, 0, 0);
+    pass.EndPass();
+    commands = encoder.Finish();
+    // Expect 0 lazy clears because the view only covers the initialized mip.
+    EXPECT_LAZY_CLEAR(0u, queue.Submit(1, &commands));
+
+    std::vector<RGBA8> expectedWithTwos(kSize * kSize, {2, 2, 2, 2});
+    EXPECT_TEXTURE_RGBA8_EQ(expectedWithTwos.data(), renderTexture, 0, 0, kSize, kSize, 0, 0);
+
+    // Expect the second mip to still be uninitialized
+    EXPECT_EQ(true, dawn_native::IsTextureSubresourceInitialized(sampleTexture.Get(), 0, 1, 0, 1));
+    EXPECT_EQ(false, dawn_native::IsTextureSubresourceInitialized(sampleTexture.Get(), 1, 1, 0, 1));
+}
+
 DAWN_INSTANTIATE_TEST(
     TextureZeroInitTest,
     D3D12Backend({"nonzero_clear_resources_on_creation_for_testing"}),
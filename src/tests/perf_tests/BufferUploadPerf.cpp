@@ -17,13 +17,24 @@
 #include "tests/ParamGenerator.h"
 #include "utils/WGPUHelpers.h"
 
+#include <algorithm>
+
 namespace {
 
     constexpr unsigned int kNumIterations = 50;
+    // Large uploads do fewer iterations so that a step uploads at most this many bytes.
+    constexpr uint64_t kMaxBytesPerStep = 256 * 1024 * 1024;
+    // The number of staging buffers of the ring used by the MapWriteAsync uploads.
+    constexpr unsigned int kStagingRingSize = 3;
+    // The number of invocations of the compute shader keeping the GPU busy.
+    constexpr uint32_t kGPUWorkInvocations = 64 * 1024;
 
     enum class UploadMethod {
         SetSubData,
+        WriteBuffer,
         CreateBufferMapped,
+        MapWriteAsyncRing,
+        CopyBufferToTexture,
     };
 
     // Perf delta exists between ranges [0, 1MB] vs [1MB, MAX_SIZE).
@@ -35,17 +46,29 @@ namespace {
 
         BufferSize_4MB = 4 * 1024 * 1024,
         BufferSize_16MB = 16 * 1024 * 1024,
+        BufferSize_64MB = 64 * 1024 * 1024,
+        BufferSize_256MB = 256 * 1024 * 1024,
+    };
+
+    enum class GPUWork {
+        None,        // The GPU only does the uploads.
+        Concurrent,  // Each step also dispatches compute work running alongside the uploads.
     };
 
     struct BufferUploadParams : DawnTestParam {
         BufferUploadParams(const DawnTestParam& param,
                            UploadMethod uploadMethod,
-                           UploadSize uploadSize)
-            : DawnTestParam(param), uploadMethod(uploadMethod), uploadSize(uploadSize) {
+                           UploadSize uploadSize,
+                           GPUWork gpuWork)
+            : DawnTestParam(param),
+              uploadMethod(uploadMethod),
+              uploadSize(uploadSize),
+              gpuWork(gpuWork) {
         }
 
         UploadMethod uploadMethod;
         UploadSize uploadSize;
+        GPUWork gpuWork;
     };
 
     std::ostream& operator<<(std::ostream& ostream, const BufferUploadParams& param) {
@@ -55,9 +78,18 @@ namespace {
             case UploadMethod::SetSubData:
                 ostream << "_SetSubData";
                 break;
+            case UploadMethod::WriteBuffer:
+                ostream << "_WriteBuffer";
+                break;
             case UploadMethod::CreateBufferMapped:
                 ostream << "_CreateBufferMapped";
                 break;
+            case UploadMethod::MapWriteAsyncRing:
+                ostream << "_MapWriteAsyncRing";
+                break;
+            case UploadMethod::CopyBufferToTexture:
+                ostream << "_CopyBufferToTexture";
+                break;
         }
 
         switch (param.uploadSize) {
@@ -76,18 +108,43 @@ namespace {
             case UploadSize::BufferSize_16MB:
                 ostream << "_BufferSize_16MB";
                 break;
+            case UploadSize::BufferSize_64MB:
+                ostream << "_BufferSize_64MB";
+                break;
+            case UploadSize::BufferSize_256MB:
+                ostream << "_BufferSize_256MB";
+                break;
+        }
+
+        switch (param.gpuWork) {
+            case GPUWork::None:
+                break;
+            case GPUWork::Concurrent:
+                ostream << "_ConcurrentGPUWork";
+                break;
         }
 
         return ostream;
     }
 
+    unsigned int GetIterationsPerStep(UploadSize uploadSize) {
+        uint64_t iterations = kMaxBytesPerStep / static_cast<uint64_t>(uploadSize);
+        return static_cast<unsigned int>(
+            std::max(uint64_t(1), std::min(iterations, uint64_t(kNumIterations))));
+    }
+
 }  // namespace
 
-// Test uploading |kBufferSize| bytes of data |kNumIterations| times.
+// Test uploading |uploadSize| bytes of data up to |kNumIterations| times per step, optionally
+// while the GPU is busy with other work. The bandwidth of each upload path is reported in GB/s.
 class BufferUploadPerf : public DawnPerfTestWithParams<BufferUploadParams> {
   public:
     BufferUploadPerf()
-        : DawnPerfTestWithParams(kNumIterations, 1),
+        : DawnPerfTestWithParams(
+              GetIterationsPerStep(
+                  ::testing::WithParamInterface<BufferUploadParams>::GetParam().uploadSize),
+              1),
+          mUploadsPerStep(GetIterationsPerStep(GetParam().uploadSize)),
           data(static_cast<size_t>(GetParam().uploadSize)) {
     }
     ~BufferUploadPerf() override = default;
@@ -95,40 +152,187 @@ class BufferUploadPerf : public DawnPerfTestWithParams<BufferUploadParams> {
     void TestSetUp() override;
 
   private:
+    struct StagingBuffer {
+        wgpu::Buffer buffer;
+        void* mappedData = nullptr;
+    };
+
     void Step() override;
 
+    void SubmitGPUWork();
+    // Waits for the next staging buffer of the ring to be mapped and fills it with |data|.
+    StagingBuffer* AcquireStagingBuffer();
+    // Submits |commands| copying from |staging| and maps |staging| again for a later upload.
+    void SubmitAndRecycle(wgpu::CommandEncoder encoder, StagingBuffer* staging);
+
+    static void OnStagingBufferMapped(WGPUBufferMapAsyncStatus status,
+                                      void* data,
+                                      uint64_t dataLength,
+                                      void* userdata);
+
+    const unsigned int mUploadsPerStep;
+
     wgpu::Buffer dst;
     std::vector<uint8_t> data;
+
+    StagingBuffer mStagingRing[kStagingRingSize];
+    unsigned int mNextStagingBuffer = 0;
+
+    wgpu::Texture mDstTexture;
+    uint32_t mTextureWidth = 0;
+    uint32_t mTextureHeight = 0;
+
+    wgpu::ComputePipeline mGPUWorkPipeline;
+    wgpu::BindGroup mGPUWorkBindGroup;
 };
 
 void BufferUploadPerf::TestSetUp() {
     DawnPerfTestWithParams<BufferUploadParams>::TestSetUp();
 
+    SetBytesPerIteration(data.size());
+
     wgpu::BufferDescriptor desc = {};
     desc.size = data.size();
     desc.usage = wgpu::BufferUsage::CopyDst;
 
     dst = device.CreateBuffer(&desc);
+
+    UploadMethod uploadMethod = GetParam().uploadMethod;
+    if (uploadMethod == UploadMethod::MapWriteAsyncRing ||
+        uploadMethod == UploadMethod::CopyBufferToTexture) {
+        wgpu::BufferDescriptor stagingDesc = {};
+        stagingDesc.size = data.size();
+        stagingDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite;
+
+        for (StagingBuffer& staging : mStagingRing) {
+            wgpu::CreateBufferMappedResult result = device.CreateBufferMapped(&stagingDesc);
+            staging.buffer = result.buffer;
+            staging.mappedData = result.data;
+        }
+    }
+
+    if (uploadMethod == UploadMethod::CopyBufferToTexture) {
+        // Upload to an RGBA8 texture at most 8192 texels wide, which gives 8192x8192 for the
+        // largest size.
+        constexpr uint32_t kBytesPerTexel = 4;
+        mTextureWidth = std::min(static_cast<uint32_t>(data.size()) / kBytesPerTexel, 8192u);
+        mTextureHeight = static_cast<uint32_t>(data.size()) / (mTextureWidth * kBytesPerTexel);
+
+        wgpu::TextureDescriptor descriptor;
+        descriptor.dimension = wgpu::TextureDimension::e2D;
+        descriptor.size = {mTextureWidth, mTextureHeight, 1};
+        descriptor.arrayLayerCount = 1;
+        descriptor.sampleCount = 1;
+        descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+        descriptor.mipLevelCount = 1;
+        descriptor.usage = wgpu::TextureUsage::CopyDst;
+        mDstTexture = device.CreateTexture(&descriptor);
+    }
+
+    if (GetParam().gpuWork == GPUWork::Concurrent) {
+        wgpu::ShaderModule module =
+            utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+            #version 450
+            layout(local_size_x = 64) in;
+            layout(std430, set = 0, binding = 0) buffer Buf { uint values[]; };
+            void main() {
+                uint value = values[gl_GlobalInvocationID.x];
+                for (uint i = 0; i < 1024; ++i) {
+                    value = value * 1664525u + 1013904223u;
+                }
+                values[gl_GlobalInvocationID.x] = value;
+            }
+        )");
+
+        wgpu::ComputePipelineDescriptor pipelineDesc = {};
+        pipelineDesc.computeStage.module = module;
+        pipelineDesc.computeStage.entryPoint = "main";
+        mGPUWorkPipeline = device.CreateComputePipeline(&pipelineDesc);
+
+        wgpu::BufferDescriptor workDesc = {};
+        workDesc.size = kGPUWorkInvocations * sizeof(uint32_t);
+        workDesc.usage = wgpu::BufferUsage::Storage;
+        wgpu::Buffer workBuffer = device.CreateBuffer(&workDesc);
+
+        mGPUWorkBindGroup = utils::MakeBindGroup(device, mGPUWorkPipeline.GetBindGroupLayout(0),
+                                                 {{0, workBuffer, 0, workDesc.size}});
+    }
+}
+
+void BufferUploadPerf::SubmitGPUWork() {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    pass.SetPipeline(mGPUWorkPipeline);
+    pass.SetBindGroup(0, mGPUWorkBindGroup);
+    pass.Dispatch(kGPUWorkInvocations / 64, 1, 1);
+    pass.EndPass();
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+BufferUploadPerf::StagingBuffer* BufferUploadPerf::AcquireStagingBuffer() {
+    StagingBuffer* staging = &mStagingRing[mNextStagingBuffer];
+    mNextStagingBuffer = (mNextStagingBuffer + 1) % kStagingRingSize;
+
+    while (staging->mappedData == nullptr) {
+        WaitABit();
+    }
+
+    memcpy(staging->mappedData, data.data(), data.size());
+    staging->mappedData = nullptr;
+    staging->buffer.Unmap();
+    return staging;
+}
+
+void BufferUploadPerf::SubmitAndRecycle(wgpu::CommandEncoder encoder, StagingBuffer* staging) {
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    staging->buffer.MapWriteAsync(OnStagingBufferMapped, staging);
+}
+
+// static
+void BufferUploadPerf::OnStagingBufferMapped(WGPUBufferMapAsyncStatus status,
+                                             void* data,
+                                             uint64_t,
+                                             void* userdata) {
+    if (status == WGPUBufferMapAsyncStatus_Success) {
+        static_cast<StagingBuffer*>(userdata)->mappedData = data;
+    }
 }
 
 void BufferUploadPerf::Step() {
+    if (GetParam().gpuWork == GPUWork::Concurrent) {
+        SubmitGPUWork();
+    }
+
     switch (GetParam().uploadMethod) {
         case UploadMethod::SetSubData: {
-            for (unsigned int i = 0; i < kNumIterations; ++i) {
+            for (unsigned int i = 0; i < mUploadsPerStep; ++i) {
                 dst.SetSubData(0, data.size(), data.data());
             }
             // Make sure all SetSubData's are flushed.
             queue.Submit(0, nullptr);
         } break;
 
+        case UploadMethod::WriteBuffer: {
+            for (unsigned int i = 0; i < mUploadsPerStep; ++i) {
+                queue.WriteBuffer(dst, 0, data.data(), data.size());
+            }
+            // Make sure all WriteBuffer's are flushed.
+            queue.Submit(0, nullptr);
+        } break;
+
         case UploadMethod::CreateBufferMapped: {
             wgpu::BufferDescriptor desc = {};
             desc.size = data.size();
             desc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite;
+            desc.mappedDataFullyWritten = true;
 
             wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
 
-            for (unsigned int i = 0; i < kNumIterations; ++i) {
+            for (unsigned int i = 0; i < mUploadsPerStep; ++i) {
                 auto result = device.CreateBufferMapped(&desc);
                 memcpy(result.data, data.data(), data.size());
                 result.buffer.Unmap();
@@ -138,6 +342,34 @@ void BufferUploadPerf::Step() {
             wgpu::CommandBuffer commands = encoder.Finish();
             queue.Submit(1, &commands);
         } break;
+
+        case UploadMethod::MapWriteAsyncRing: {
+            // Each upload is submitted on its own so that its staging buffer can be mapped again
+            // while the next ones are filled.
+            for (unsigned int i = 0; i < mUploadsPerStep; ++i) {
+                StagingBuffer* staging = AcquireStagingBuffer();
+
+                wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+                encoder.CopyBufferToBuffer(staging->buffer, 0, dst, 0, data.size());
+                SubmitAndRecycle(encoder, staging);
+            }
+        } break;
+
+        case UploadMethod::CopyBufferToTexture: {
+            for (unsigned int i = 0; i < mUploadsPerStep; ++i) {
+                StagingBuffer* staging = AcquireStagingBuffer();
+
+                wgpu::BufferCopyView bufferCopyView =
+                    utils::CreateBufferCopyView(staging->buffer, 0, mTextureWidth * 4, 0);
+                wgpu::TextureCopyView textureCopyView =
+                    utils::CreateTextureCopyView(mDstTexture, 0, 0, {0, 0, 0});
+                wgpu::Extent3D copySize = {mTextureWidth, mTextureHeight, 1};
+
+                wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+                encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+                SubmitAndRecycle(encoder, staging);
+            }
+        } break;
     }
 }
 
@@ -148,7 +380,12 @@ TEST_P(BufferUploadPerf, Run) {
 DAWN_INSTANTIATE_PERF_TEST_SUITE_P(BufferUploadPerf,
                                    {D3D12Backend(), MetalBackend(), OpenGLBackend(),
                                     VulkanBackend()},
-                                   {UploadMethod::SetSubData, UploadMethod::CreateBufferMapped},
+                                   {UploadMethod::SetSubData, UploadMethod::WriteBuffer,
+                                    UploadMethod::CreateBufferMapped,
+                                    UploadMethod::MapWriteAsyncRing,
+                                    UploadMethod::CopyBufferToTexture},
                                    {UploadSize::BufferSize_1KB, UploadSize::BufferSize_64KB,
                                     UploadSize::BufferSize_1MB, UploadSize::BufferSize_4MB,
-                                    UploadSize::BufferSize_16MB});
+                                    UploadSize::BufferSize_16MB, UploadSize::BufferSize_64MB,
+                                    UploadSize::BufferSize_256MB},
+                                   {GPUWork::None, GPUWork::Concurrent});
@@ -20,8 +20,10 @@
 #include "tests/perf_tests/DawnPerfTestPlatform.h"
 #include "utils/Timer.h"
 
+#include <cmath>
 #include <fstream>
 #include <limits>
+#include <sstream>
 
 namespace {
 
@@ -67,6 +69,14 @@ namespace {
         outFile.close();
     }
 
+    void WriteJSONStringArray(std::ostream& stream, const std::vector<std::string>& strings) {
+        stream << "[";
+        for (size_t i = 0; i < strings.size(); ++i) {
+            stream << (i == 0 ? "" : ", ") << "\"" << strings[i] << "\"";
+        }
+        stream << "]";
+    }
+
 }  // namespace
 
 void InitDawnPerfTestEnvironment(int argc, char** argv) {
@@ -101,14 +111,36 @@ DawnPerfTestEnvironment::DawnPerfTestEnvironment(int argc, char** argv)
             continue;
         }
 
+        constexpr const char kWireCaptureFileArg[] = "--wire-capture=";
+        if (strstr(argv[i], kWireCaptureFileArg) == argv[i]) {
+            const char* wireCaptureFile = argv[i] + strlen(kWireCaptureFileArg);
+            if (wireCaptureFile[0] != '\0') {
+                mWireCaptureFile = wireCaptureFile;
+            }
+            continue;
+        }
+
+        constexpr const char kResultsFileArg[] = "--results-file=";
+        if (strstr(argv[i], kResultsFileArg) == argv[i]) {
+            const char* resultsFile = argv[i] + strlen(kResultsFileArg);
+            if (resultsFile[0] != '\0') {
+                mResultsFile = resultsFile;
+            }
+            continue;
+        }
+
         if (strcmp("-h", argv[i]) == 0 || strcmp("--help", argv[i]) == 0) {
             dawn::InfoLog()
                 << "Additional flags:"
-                << " [--calibration] [--override-steps=x] [--trace-file=file]\n"
+                << " [--calibration] [--override-steps=x] [--trace-file=file]"
+                   " [--results-file=file] [--wire-capture=file]\n"
                 << "  --calibration: Only run calibration. Calibration allows the perf test"
                    " runner script to save some time.\n"
                 << " --override-steps: Set a fixed number of steps to run for each test\n"
-                << " --trace-file: The file to dump trace results.\n";
+                << " --trace-file: The file to dump trace results.\n"
+                << " --results-file: The file to write the mean and standard deviation of the"
+                   " metrics of each test to, as JSON.\n"
+                << " --wire-capture: The dawn_wire capture file WireReplayPerf replays.\n";
             continue;
         }
     }
@@ -131,6 +163,13 @@ void DawnPerfTestEnvironment::SetUp() {
         outFile.flush();
         outFile.close();
     }
+
+    if (mResultsFile != nullptr) {
+        std::ofstream outFile;
+        outFile.open(mResultsFile);
+        outFile << "[";
+        outFile.close();
+    }
 }
 
 void DawnPerfTestEnvironment::TearDown() {
@@ -149,6 +188,13 @@ void DawnPerfTestEnvironment::TearDown() {
         outFile.close();
     }
 
+    if (mResultsFile != nullptr) {
+        std::ofstream outFile;
+        outFile.open(mResultsFile, std::ios_base::app);
+        outFile << "\n]" << std::endl;
+        outFile.close();
+    }
+
     DawnTestEnvironment::TearDown();
 }
 
@@ -164,6 +210,22 @@ const char* DawnPerfTestEnvironment::GetTraceFile() const {
     return mTraceFile;
 }
 
+const char* DawnPerfTestEnvironment::GetWireCaptureFile() const {
+    return mWireCaptureFile;
+}
+
+void DawnPerfTestEnvironment::AppendResults(const std::string& results) {
+    if (mResultsFile == nullptr) {
+        return;
+    }
+
+    std::ofstream outFile;
+    outFile.open(mResultsFile, std::ios_base::app);
+    outFile << (mHasResults ? ",\n" : "\n") << results;
+    outFile.close();
+    mHasResults = true;
+}
+
 DawnPerfTestPlatform* DawnPerfTestEnvironment::GetPlatform() const {
     return mPlatform.get();
 }
@@ -183,6 +245,18 @@ void DawnPerfTestBase::AbortTest() {
     mRunning = false;
 }
 
+void DawnPerfTestBase::AddGPUTime(double seconds) {
+    mGPUTime += seconds;
+}
+
+void DawnPerfTestBase::SetBytesPerIteration(uint64_t bytes) {
+    mBytesPerIteration = bytes;
+}
+
+const DawnPerfTestEnvironment* DawnPerfTestBase::GetEnvironment() const {
+    return gTestEnv;
+}
+
 void DawnPerfTestBase::RunTest() {
     if (gTestEnv->OverrideStepsToRun() == 0) {
         // Run to compute the approximate number of steps to perform.
@@ -224,6 +298,8 @@ void DawnPerfTestBase::RunTest() {
         }
     }
     platform->EnableTraceEventRecording(false);
+
+    WriteResults();
 }
 
 void DawnPerfTestBase::DoRunLoop(double maxRunTime) {
@@ -231,6 +307,7 @@ void DawnPerfTestBase::DoRunLoop(double maxRunTime) {
 
     mNumStepsPerformed = 0;
     cpuTime = 0;
+    mGPUTime = 0;
     mRunning = true;
 
     wgpu::FenceDescriptor desc = {};
@@ -337,9 +414,18 @@ void DawnPerfTestBase::OutputResults() {
 
     PrintPerIterationResultFromSeconds("wall_time", mTimer->GetElapsedTime(), true);
     PrintPerIterationResultFromSeconds("cpu_time", cpuTime, true);
+    PrintPerIterationResultFromSeconds("gpu_time", mGPUTime, true);
     PrintPerIterationResultFromSeconds("validation_time", totalValidationTime, true);
     PrintPerIterationResultFromSeconds("recording_time", totalRecordingTime, true);
 
+    if (mBytesPerIteration != 0) {
+        double bytes = static_cast<double>(mBytesPerIteration) *
+                       static_cast<double>(mNumStepsPerformed * mIterationsPerStep);
+        double bandwidth = bytes / mTimer->GetElapsedTime() * 1e-9;
+        PrintResult("bandwidth", bandwidth, "GB/s", true);
+        RecordTrialResult("bandwidth", bandwidth, "GB/s");
+    }
+
     const char* traceFile = gTestEnv->GetTraceFile();
     if (traceFile != nullptr) {
         DumpTraceEventsToJSONFile(traceEventBuffer, traceFile);
@@ -355,6 +441,7 @@ void DawnPerfTestBase::PrintPerIterationResultFromSeconds(const std::string& tra
 
     double secondsPerIteration =
         valueInSeconds / static_cast<double>(mNumStepsPerformed * mIterationsPerStep);
+    RecordTrialResult(trace, secondsPerIteration * 1e9, "ns");
 
     // Give the result a different name to ensure separate graphs if we transition.
     if (secondsPerIteration > 1) {
@@ -366,6 +453,59 @@ void DawnPerfTestBase::PrintPerIterationResultFromSeconds(const std::string& tra
     }
 }
 
+void DawnPerfTestBase::RecordTrialResult(const std::string& trace,
+                                         double value,
+                                         const std::string& units) {
+    TrialResults* results = &mTrialResults[trace];
+    results->units = units;
+    results->values.push_back(value);
+}
+
+void DawnPerfTestBase::WriteResults() const {
+    const ::testing::TestInfo* const testInfo =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+
+    for (const auto& it : mTrialResults) {
+        const std::vector<double>& values = it.second.values;
+
+        double mean = 0;
+        for (double value : values) {
+            mean += value;
+        }
+        mean /= static_cast<double>(values.size());
+
+        double variance = 0;
+        for (double value : values) {
+            variance += (value - mean) * (value - mean);
+        }
+        if (values.size() > 1) {
+            variance /= static_cast<double>(values.size() - 1);
+        }
+
+        std::ostringstream result;
+        result << "  { "
+               << "\"suite\": \"" << testInfo->test_suite_name() << "\", "
+               << "\"test\": \"" << testInfo->name() << "\", "
+               << "\"metric\": \"" << it.first << "\", "
+               << "\"units\": \"" << it.second.units << "\", "
+               << "\"enabled_toggles\": ";
+        WriteJSONStringArray(result, gTestEnv->GetEnabledToggles());
+        result << ", \"disabled_toggles\": ";
+        WriteJSONStringArray(result, gTestEnv->GetDisabledToggles());
+        result << ", \"skip_validation\": "
+               << (gTestEnv->IsDawnValidationSkipped() ? "true" : "false")
+               << ", \"use_spvc\": " << (gTestEnv->IsSpvcBeingUsed() ? "true" : "false")
+               << ", \"mean\": " << mean << ", \"stddev\": " << std::sqrt(variance)
+               << ", \"values\": [";
+        for (size_t i = 0; i < values.size(); ++i) {
+            result << (i == 0 ? "" : ", ") << values[i];
+        }
+        result << "] }";
+
+        gTestEnv->AppendResults(result.str());
+    }
+}
+
 void DawnPerfTestBase::PrintResult(const std::string& trace,
                                    double value,
                                    const std::string& units,
@@ -17,6 +17,10 @@
 
 #include "tests/DawnTest.h"
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace utils {
     class Timer;
 }
@@ -40,6 +44,13 @@ class DawnPerfTestEnvironment : public DawnTestEnvironment {
     // not be written to a json file.
     const char* GetTraceFile() const;
 
+    // Returns the path to the wire capture the WireReplayPerf test replays, or nullptr if there
+    // is none.
+    const char* GetWireCaptureFile() const;
+
+    // Appends the results of a test to the JSON array of the results file, if there is one.
+    void AppendResults(const std::string& results);
+
     DawnPerfTestPlatform* GetPlatform() const;
 
   private:
@@ -51,6 +62,11 @@ class DawnPerfTestEnvironment : public DawnTestEnvironment {
 
     const char* mTraceFile = nullptr;
 
+    const char* mWireCaptureFile = nullptr;
+
+    const char* mResultsFile = nullptr;
+    bool mHasResults = false;
+
     std::unique_ptr<DawnPerfTestPlatform> mPlatform;
 };
 
@@ -74,6 +90,18 @@ class DawnPerfTestBase {
     // Call if the test step was aborted and the test should stop running.
     void AbortTest();
 
+    // Tests measuring the GPU time of their steps, for example with timestamp queries, add it
+    // here so that it gets reported as the "gpu_time" metric.
+    void AddGPUTime(double seconds);
+
+    // Tests transferring data set the number of bytes transferred by each iteration so that the
+    // "bandwidth" metric gets reported in GB/s.
+    void SetBytesPerIteration(uint64_t bytes);
+
+    // For tests using the flags of the environment, or adding their own trace events to the
+    // platform.
+    const DawnPerfTestEnvironment* GetEnvironment() const;
+
     void RunTest();
     void PrintPerIterationResultFromSeconds(const std::string& trace,
                                             double valueInSeconds,
@@ -90,6 +118,10 @@ class DawnPerfTestBase {
   private:
     void DoRunLoop(double maxRunTime);
     void OutputResults();
+    // Keeps the value of the metric for the current trial, they are written to the results file
+    // with their mean and standard deviation once all the trials ran.
+    void RecordTrialResult(const std::string& trace, double value, const std::string& units);
+    void WriteResults() const;
 
     void PrintResultImpl(const std::string& trace,
                          const std::string& value,
@@ -105,7 +137,15 @@ class DawnPerfTestBase {
     unsigned int mStepsToRun = 0;
     unsigned int mNumStepsPerformed = 0;
     double cpuTime;
+    double mGPUTime = 0;
+    uint64_t mBytesPerIteration = 0;
     std::unique_ptr<utils::Timer> mTimer;
+
+    struct TrialResults {
+        std::string units;
+        std::vector<double> values;
+    };
+    std::map<std::string, TrialResults> mTrialResults;
 };
 
 template <typename Params = DawnTestParam>
@@ -21,9 +21,19 @@
 #include "utils/ComboRenderPipelineDescriptor.h"
 #include "utils/WGPUHelpers.h"
 
+#include <algorithm>
+#include <memory>
+
+#if defined(DAWN_ENABLE_BACKEND_VULKAN)
+#    include "dawn_native/VulkanBackend.h"
+#endif
+
 namespace {
 
-    constexpr unsigned int kNumDraws = 2000;
+    // With Pipeline::Periodic, the pipeline changes every |kPipelineSwitchInterval| draws.
+    constexpr unsigned int kPipelineSwitchInterval = 64;
+    // With RenderBundle::Multiple, each bundle records |kDrawsPerBundle| draws.
+    constexpr unsigned int kDrawsPerBundle = 1000;
 
     constexpr uint32_t kTextureSize = 64;
     constexpr size_t kUniformSize = 3 * sizeof(float);
@@ -66,6 +76,7 @@ namespace {
         Static,     // Keep the same pipeline for all draws.
         Redundant,  // Use the same pipeline, but redundantly set it.
         Dynamic,    // Change the pipeline between draws.
+        Periodic,   // Change the pipeline every kPipelineSwitchInterval draws.
     };
 
     enum class UniformData {
@@ -88,20 +99,40 @@ namespace {
     };
 
     enum class RenderBundle {
-        No,   // Record commands in a render pass
-        Yes,  // Record commands in a render bundle
+        No,        // Record commands in a render pass
+        Yes,       // Record commands in a render bundle
+        Multiple,  // Record commands in render bundles of kDrawsPerBundle draws
+    };
+
+    enum class DrawCount {
+        Default,  // 2000 draws per frame.
+        Large,    // 10000 draws per frame.
+        Huge,     // 100000 draws per frame.
     };
 
+    unsigned int GetNumDraws(DrawCount drawCount) {
+        switch (drawCount) {
+            case DrawCount::Default:
+                return 2000;
+            case DrawCount::Large:
+                return 10000;
+            case DrawCount::Huge:
+                return 100000;
+        }
+        UNREACHABLE();
+    }
+
     struct DrawCallParam {
         Pipeline pipelineType;
         VertexBuffer vertexBufferType;
         BindGroup bindGroupType;
         UniformData uniformDataType;
         RenderBundle withRenderBundle;
+        DrawCount drawCount;
     };
 
     using DrawCallParamTuple =
-        std::tuple<Pipeline, VertexBuffer, BindGroup, UniformData, RenderBundle>;
+        std::tuple<Pipeline, VertexBuffer, BindGroup, UniformData, RenderBundle, DrawCount>;
 
     template <typename T>
     int AssignParam(T& lhs, T rhs) {
@@ -117,11 +148,13 @@ namespace {
     //  - BindGroup::NoChange
     //  - UniformData::Static
     //  - RenderBundle::No
+    //  - DrawCount::Default
     template <typename... Ts>
     DrawCallParam MakeParam(Ts... args) {
         // Baseline param
-        DrawCallParamTuple paramTuple{Pipeline::Static, VertexBuffer::NoChange, BindGroup::NoChange,
-                                      UniformData::Static, RenderBundle::No};
+        DrawCallParamTuple paramTuple{Pipeline::Static,    VertexBuffer::NoChange,
+                                      BindGroup::NoChange, UniformData::Static,
+                                      RenderBundle::No,    DrawCount::Default};
 
         unsigned int unused[] = {
             0,  // Avoid making a 0-sized array.
@@ -132,7 +165,7 @@ namespace {
         return DrawCallParam{
             std::get<Pipeline>(paramTuple),     std::get<VertexBuffer>(paramTuple),
             std::get<BindGroup>(paramTuple),    std::get<UniformData>(paramTuple),
-            std::get<RenderBundle>(paramTuple),
+            std::get<RenderBundle>(paramTuple), std::get<DrawCount>(paramTuple),
         };
     }
 
@@ -157,6 +190,9 @@ namespace {
             case Pipeline::Dynamic:
                 ostream << "_DynamicPipeline";
                 break;
+            case Pipeline::Periodic:
+                ostream << "_PeriodicPipeline";
+                break;
         }
 
         switch (param.vertexBufferType) {
@@ -200,6 +236,18 @@ namespace {
             case RenderBundle::Yes:
                 ostream << "_RenderBundle";
                 break;
+            case RenderBundle::Multiple:
+                ostream << "_MultipleRenderBundles";
+                break;
+        }
+
+        switch (param.drawCount) {
+            case DrawCount::Default:
+                break;
+            case DrawCount::Large:
+            case DrawCount::Huge:
+                ostream << "_" << GetNumDraws(param.drawCount) << "Draws";
+                break;
         }
 
         return ostream;
@@ -215,15 +263,21 @@ namespace {
 //   - Static/Multiple/Dynamic vertex buffers: Tests switching buffer bindings. This has
 //     a state tracking cost as well as a GPU driver cost.
 //   - Static/Multiple/Dynamic bind groups: Same rationale as vertex buffers
-//   - Static/Dynamic pipelines: In addition to a change to GPU state, changing the pipeline
-//     layout incurs additional state tracking costs in Dawn.
+//   - Static/Dynamic/Periodic pipelines: In addition to a change to GPU state, changing the
+//     pipeline layout incurs additional state tracking costs in Dawn.
 //   - With/Without render bundles: All of the above can have lower validation costs if
 //     precomputed in a render bundle.
 //   - Static/Dynamic data: Updating data for each draw is a common use case. It also tests
 //     the efficiency of resource transitions.
+//   - Draw counts: Frames of 10k-100k draws show costs that grow with the size of the passes.
+// The GPU time of each frame is measured with timestamp queries when they are supported.
 class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
   public:
-    DrawCallPerf() : DawnPerfTestWithParams(kNumDraws, 3) {
+    DrawCallPerf()
+        : DawnPerfTestWithParams(
+              GetNumDraws(
+                  ::testing::WithParamInterface<DrawCallParamForTest>::GetParam().param.drawCount),
+              3) {
     }
     ~DrawCallPerf() override = default;
 
@@ -234,23 +288,32 @@ class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
         return DawnPerfTestWithParams::GetParam().param;
     }
 
+    std::vector<const char*> GetRequiredExtensions() override;
+
     template <typename Encoder>
-    void RecordRenderCommands(Encoder encoder);
+    void RecordRenderCommands(Encoder encoder, unsigned int firstDraw, unsigned int drawCount);
 
   private:
     void Step() override;
 
+    static void OnTimestampsMapped(WGPUBufferMapAsyncStatus status,
+                                   const void* data,
+                                   uint64_t dataLength,
+                                   void* userdata);
+
+    unsigned int mNumDraws = 0;
+
     // One large dynamic vertex buffer, or multiple separate vertex buffers.
-    wgpu::Buffer mVertexBuffers[kNumDraws];
+    std::vector<wgpu::Buffer> mVertexBuffers;
     size_t mAlignedVertexDataSize;
 
     std::vector<float> mUniformBufferData;
     // One large dynamic uniform buffer, or multiple separate uniform buffers.
-    wgpu::Buffer mUniformBuffers[kNumDraws];
+    std::vector<wgpu::Buffer> mUniformBuffers;
 
     wgpu::BindGroupLayout mUniformBindGroupLayout;
     // One dynamic bind group or multiple bind groups.
-    wgpu::BindGroup mUniformBindGroups[kNumDraws];
+    std::vector<wgpu::BindGroup> mUniformBindGroups;
     size_t mAlignedUniformSize;
     size_t mNumUniformFloats;
 
@@ -264,19 +327,65 @@ class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
     wgpu::TextureView mColorAttachment;
     wgpu::TextureView mDepthStencilAttachment;
 
-    wgpu::RenderBundle mRenderBundle;
+    // One render bundle with all the draws, or multiple render bundles.
+    std::vector<wgpu::RenderBundle> mRenderBundles;
+
+    // The timestamps written at the start and the end of each frame are copied to a readback
+    // buffer, which goes back to the free list once they are read.
+    bool mUseTimestampQuery = false;
+    double mTimestampPeriod = 1.0;
+    wgpu::QuerySet mTimestampQuerySet;
+    wgpu::Buffer mTimestampResolveBuffer;
+    std::vector<wgpu::Buffer> mFreeTimestampReadbackBuffers;
 };
 
+struct TimestampReadback {
+    DrawCallPerf* test;
+    wgpu::Buffer buffer;
+};
+
+std::vector<const char*> DrawCallPerf::GetRequiredExtensions() {
+    // The period of the timestamps is only known on Vulkan.
+#if defined(DAWN_ENABLE_BACKEND_VULKAN)
+    mUseTimestampQuery = IsVulkan() && SupportsExtensions({"timestamp_query"});
+#endif
+    if (!mUseTimestampQuery) {
+        return {};
+    }
+    return {"timestamp_query"};
+}
+
 void DrawCallPerf::TestSetUp() {
     DawnPerfTestWithParams::TestSetUp();
 
+    mNumDraws = GetNumDraws(GetParam().drawCount);
+    mVertexBuffers.resize(mNumDraws);
+    mUniformBuffers.resize(mNumDraws);
+    mUniformBindGroups.resize(mNumDraws);
+
+    if (mUseTimestampQuery) {
+#if defined(DAWN_ENABLE_BACKEND_VULKAN)
+        mTimestampPeriod = dawn_native::vulkan::GetTimestampPeriod(backendDevice);
+#endif
+
+        wgpu::QuerySetDescriptor querySetDescriptor;
+        querySetDescriptor.type = wgpu::QueryType::Timestamp;
+        querySetDescriptor.count = 2;
+        mTimestampQuerySet = device.CreateQuerySet(&querySetDescriptor);
+
+        wgpu::BufferDescriptor bufferDescriptor;
+        bufferDescriptor.size = 2 * sizeof(uint64_t);
+        bufferDescriptor.usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+        mTimestampResolveBuffer = device.CreateBuffer(&bufferDescriptor);
+    }
+
     // Compute aligned uniform / vertex data sizes.
     mAlignedUniformSize = Align(kUniformSize, kMinDynamicBufferOffsetAlignment);
     mAlignedVertexDataSize = Align(sizeof(kVertexData), 4);
 
     // Initialize uniform buffer data.
     mNumUniformFloats = mAlignedUniformSize / sizeof(float);
-    mUniformBufferData = std::vector<float>(kNumDraws * mNumUniformFloats, 0.0);
+    mUniformBufferData = std::vector<float>(mNumDraws * mNumUniformFloats, 0.0);
 
     // Create the color / depth stencil attachments.
     {
@@ -302,15 +411,15 @@ void DrawCallPerf::TestSetUp() {
             break;
 
         case VertexBuffer::Multiple: {
-            for (uint32_t i = 0; i < kNumDraws; ++i) {
+            for (uint32_t i = 0; i < mNumDraws; ++i) {
                 mVertexBuffers[i] = utils::CreateBufferFromData(
                     device, kVertexData, sizeof(kVertexData), wgpu::BufferUsage::Vertex);
             }
         } break;
 
         case VertexBuffer::Dynamic: {
-            std::vector<char> data(mAlignedVertexDataSize * kNumDraws);
-            for (uint32_t i = 0; i < kNumDraws; ++i) {
+            std::vector<char> data(mAlignedVertexDataSize * mNumDraws);
+            for (uint32_t i = 0; i < mNumDraws; ++i) {
                 memcpy(data.data() + mAlignedVertexDataSize * i, kVertexData, sizeof(kVertexData));
             }
 
@@ -373,8 +482,9 @@ void DrawCallPerf::TestSetUp() {
     renderPipelineDesc.cFragmentStage.module = fsModule;
     mPipelines[0] = device.CreateRenderPipeline(&renderPipelineDesc);
 
-    // If the test is using a dynamic pipeline, create the second pipeline.
-    if (GetParam().pipelineType == Pipeline::Dynamic) {
+    // If the test is changing the pipeline, create the second pipeline.
+    if (GetParam().pipelineType == Pipeline::Dynamic ||
+        GetParam().pipelineType == Pipeline::Periodic) {
         // Create another bind group layout. The data for this binding point will be the same for
         // all draws.
         mConstantBindGroupLayout = utils::MakeBindGroupLayout(
@@ -421,7 +531,7 @@ void DrawCallPerf::TestSetUp() {
             break;
 
         case BindGroup::NoReuse:
-            for (uint32_t i = 0; i < kNumDraws; ++i) {
+            for (uint32_t i = 0; i < mNumDraws; ++i) {
                 mUniformBuffers[i] = utils::CreateBufferFromData(
                     device, mUniformBufferData.data() + i * mNumUniformFloats, 3 * sizeof(float),
                     wgpu::BufferUsage::Uniform);
@@ -430,7 +540,7 @@ void DrawCallPerf::TestSetUp() {
             break;
 
         case BindGroup::Multiple:
-            for (uint32_t i = 0; i < kNumDraws; ++i) {
+            for (uint32_t i = 0; i < mNumDraws; ++i) {
                 mUniformBuffers[i] = utils::CreateBufferFromData(
                     device, mUniformBufferData.data() + i * mNumUniformFloats, 3 * sizeof(float),
                     wgpu::BufferUsage::Uniform);
@@ -454,20 +564,27 @@ void DrawCallPerf::TestSetUp() {
     }
 
     // If using render bundles, record the render commands now.
-    if (GetParam().withRenderBundle == RenderBundle::Yes) {
+    if (GetParam().withRenderBundle != RenderBundle::No) {
         wgpu::RenderBundleEncoderDescriptor descriptor = {};
         descriptor.colorFormatsCount = 1;
         descriptor.colorFormats = &renderPipelineDesc.cColorStates[0].format;
         descriptor.depthStencilFormat = renderPipelineDesc.cDepthStencilState.format;
 
-        wgpu::RenderBundleEncoder encoder = device.CreateRenderBundleEncoder(&descriptor);
-        RecordRenderCommands(encoder);
-        mRenderBundle = encoder.Finish();
+        unsigned int drawsPerBundle =
+            GetParam().withRenderBundle == RenderBundle::Yes ? mNumDraws : kDrawsPerBundle;
+        for (unsigned int firstDraw = 0; firstDraw < mNumDraws; firstDraw += drawsPerBundle) {
+            wgpu::RenderBundleEncoder encoder = device.CreateRenderBundleEncoder(&descriptor);
+            RecordRenderCommands(encoder, firstDraw,
+                                 std::min(drawsPerBundle, mNumDraws - firstDraw));
+            mRenderBundles.push_back(encoder.Finish());
+        }
     }
 }
 
 template <typename Encoder>
-void DrawCallPerf::RecordRenderCommands(Encoder pass) {
+void DrawCallPerf::RecordRenderCommands(Encoder pass,
+                                        unsigned int firstDraw,
+                                        unsigned int drawCount) {
     uint32_t uniformBindGroupIndex = 0;
 
     if (GetParam().pipelineType == Pipeline::Static) {
@@ -488,7 +605,7 @@ void DrawCallPerf::RecordRenderCommands(Encoder pass) {
         pass.SetBindGroup(uniformBindGroupIndex, mUniformBindGroups[0]);
     }
 
-    for (unsigned int i = 0; i < kNumDraws; ++i) {
+    for (unsigned int i = firstDraw; i < firstDraw + drawCount; ++i) {
         switch (GetParam().pipelineType) {
             case Pipeline::Static:
                 break;
@@ -506,6 +623,18 @@ void DrawCallPerf::RecordRenderCommands(Encoder pass) {
                     pass.SetBindGroup(0, mConstantBindGroup);
                 }
             } break;
+            case Pipeline::Periodic: {
+                // Render bundles don't inherit the pipeline, so it is also set at their start.
+                if (i == firstDraw || i % kPipelineSwitchInterval == 0) {
+                    uint32_t pipelineIndex = (i / kPipelineSwitchInterval) % 2;
+                    pass.SetPipeline(mPipelines[pipelineIndex]);
+
+                    uniformBindGroupIndex = pipelineIndex;
+                    if (uniformBindGroupIndex == 1) {
+                        pass.SetBindGroup(0, mConstantBindGroup);
+                    }
+                }
+            } break;
         }
 
         // Set the vertex buffer, if it changes.
@@ -567,7 +696,7 @@ void DrawCallPerf::Step() {
                 break;
             case BindGroup::NoReuse:
             case BindGroup::Multiple:
-                for (uint32_t i = 0; i < kNumDraws; ++i) {
+                for (uint32_t i = 0; i < mNumDraws; ++i) {
                     mUniformBuffers[i].SetSubData(
                         0, 3 * sizeof(float), mUniformBufferData.data() + i * mNumUniformFloats);
                 }
@@ -580,15 +709,20 @@ void DrawCallPerf::Step() {
     }
 
     wgpu::CommandEncoder commands = device.CreateCommandEncoder();
+    if (mUseTimestampQuery) {
+        commands.WriteTimestamp(mTimestampQuerySet, 0);
+    }
+
     utils::ComboRenderPassDescriptor renderPass({mColorAttachment}, mDepthStencilAttachment);
     wgpu::RenderPassEncoder pass = commands.BeginRenderPass(&renderPass);
 
     switch (GetParam().withRenderBundle) {
         case RenderBundle::No:
-            RecordRenderCommands(pass);
+            RecordRenderCommands(pass, 0, mNumDraws);
             break;
         case RenderBundle::Yes:
-            pass.ExecuteBundles(1, &mRenderBundle);
+        case RenderBundle::Multiple:
+            pass.ExecuteBundles(mRenderBundles.size(), mRenderBundles.data());
             break;
         default:
             UNREACHABLE();
@@ -596,8 +730,54 @@ void DrawCallPerf::Step() {
     }
 
     pass.EndPass();
+
+    wgpu::Buffer timestampReadbackBuffer;
+    if (mUseTimestampQuery) {
+        if (mFreeTimestampReadbackBuffers.empty()) {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = 2 * sizeof(uint64_t);
+            descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+            timestampReadbackBuffer = device.CreateBuffer(&descriptor);
+        } else {
+            timestampReadbackBuffer = std::move(mFreeTimestampReadbackBuffers.back());
+            mFreeTimestampReadbackBuffers.pop_back();
+        }
+
+        commands.WriteTimestamp(mTimestampQuerySet, 1);
+        commands.ResolveQuerySet(mTimestampQuerySet, 0, 2, mTimestampResolveBuffer, 0);
+        commands.CopyBufferToBuffer(mTimestampResolveBuffer, 0, timestampReadbackBuffer, 0,
+                                    2 * sizeof(uint64_t));
+    }
+
     wgpu::CommandBuffer commandBuffer = commands.Finish();
     queue.Submit(1, &commandBuffer);
+
+    if (mUseTimestampQuery) {
+        timestampReadbackBuffer.MapReadAsync(OnTimestampsMapped,
+                                             new TimestampReadback{this, timestampReadbackBuffer});
+    }
+}
+
+// static
+void DrawCallPerf::OnTimestampsMapped(WGPUBufferMapAsyncStatus status,
+                                      const void* data,
+                                      uint64_t dataLength,
+                                      void* userdata) {
+    std::unique_ptr<TimestampReadback> readback(static_cast<TimestampReadback*>(userdata));
+    if (status != WGPUBufferMapAsyncStatus_Success) {
+        return;
+    }
+
+    ASSERT(dataLength == 2 * sizeof(uint64_t));
+    const uint64_t* timestamps = static_cast<const uint64_t*>(data);
+    if (timestamps[1] > timestamps[0]) {
+        double nanoseconds =
+            static_cast<double>(timestamps[1] - timestamps[0]) * readback->test->mTimestampPeriod;
+        readback->test->AddGPUTime(nanoseconds * 1e-9);
+    }
+
+    readback->buffer.Unmap();
+    readback->test->mFreeTimestampReadbackBuffers.push_back(std::move(readback->buffer));
 }
 
 TEST_P(DrawCallPerf, Run) {
@@ -607,7 +787,8 @@ TEST_P(DrawCallPerf, Run) {
 DAWN_INSTANTIATE_PERF_TEST_SUITE_P(
     DrawCallPerf,
     {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend(),
-     VulkanBackend({"skip_validation"})},
+     VulkanBackend({"skip_validation"}),
+     VulkanBackend({"vulkan_record_render_passes_in_parallel"})},
     {
         // Baseline
         MakeParam(),
@@ -658,4 +839,13 @@ DAWN_INSTANTIATE_PERF_TEST_SUITE_P(
                   UniformData::Dynamic),  // Update per-draw data: Multiple bind groups
         MakeParam(BindGroup::Dynamic,
                   UniformData::Dynamic),  // Update per-draw data: Dynamic bind groups
+
+        // Frames with many draws.
+        MakeParam(DrawCount::Large),
+        MakeParam(DrawCount::Huge),
+        MakeParam(DrawCount::Huge, BindGroup::Dynamic),
+        MakeParam(DrawCount::Large, BindGroup::Multiple),
+        MakeParam(DrawCount::Huge, BindGroup::Dynamic, Pipeline::Periodic),
+        MakeParam(DrawCount::Huge, BindGroup::Dynamic, RenderBundle::Yes),
+        MakeParam(DrawCount::Huge, BindGroup::Dynamic, RenderBundle::Multiple),
     });
@@ -0,0 +1,432 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "tests/ParamGenerator.h"
+#include "utils/ComboRenderPipelineDescriptor.h"
+#include "utils/WGPUHelpers.h"
+
+#include <vector>
+
+namespace {
+
+    constexpr unsigned int kNumIterations = 1000;
+
+    constexpr float kVertexData[12] = {
+        0.0f, 0.5f, 0.0f, 1.0f, -0.5f, -0.5f, 0.0f, 1.0f, 0.5f, -0.5f, 0.0f, 1.0f,
+    };
+
+    constexpr char kVertexShader[] = R"(
+        #version 450
+        layout(location = 0) in vec4 pos;
+        void main() {
+            gl_Position = pos;
+        })";
+
+    constexpr char kFragmentShader[] = R"(
+        #version 450
+        layout (std140, set = 0, binding = 0) uniform Uniforms {
+            vec4 color;
+        };
+        layout(location = 0) out vec4 fragColor;
+        void main() {
+            fragColor = color;
+        })";
+
+    constexpr char kRayGen[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadNV vec3 hitValue;
+        layout(set = 0, binding = 0) uniform accelerationStructureNV topLevelAS;
+        layout(std140, set = 0, binding = 1) buffer PixelBuffer {
+            vec4 pixels[];
+        } pixelBuffer;
+        void main() {
+            hitValue = vec3(0);
+            traceNV(topLevelAS, gl_RayFlagsOpaqueNV, 0xFF, 0, 0, 0, vec3(0, 0, -1), 0.01,
+                    vec3(0, 0, 1), 4096.0, 0);
+            pixelBuffer.pixels[gl_LaunchIDNV.x] = vec4(hitValue, 1);
+        })";
+
+    constexpr char kRayClosestHit[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        void main() {
+            hitValue = vec3(1);
+        })";
+
+    constexpr char kRayMiss[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        void main() {
+            hitValue = vec3(0);
+        })";
+
+    // Each workload runs |kNumIterations| times the operation it is named after per step, so the
+    // results are the cost of one operation.
+    enum class Workload {
+        Draw,                        // Record a draw in a render pass.
+        SetBindGroup,                // Set a different bind group in a render pass.
+        CreateBindGroup,             // Create a bind group with a uniform buffer.
+        Finish,                      // Record a copy in a new command encoder and finish it.
+        Submit,                      // Same as Finish, then submit the command buffer.
+        BuildAccelerationContainer,  // Create and build a bottom-level container.
+        TraceRays,                   // Record a traceRays in a ray tracing pass.
+    };
+
+    struct FrontendOverheadParams : DawnTestParam {
+        FrontendOverheadParams(const DawnTestParam& param, Workload workload)
+            : DawnTestParam(param), workload(workload) {
+        }
+
+        Workload workload;
+    };
+
+    std::ostream& operator<<(std::ostream& ostream, const FrontendOverheadParams& param) {
+        ostream << static_cast<const DawnTestParam&>(param);
+
+        switch (param.workload) {
+            case Workload::Draw:
+                ostream << "_Draw";
+                break;
+            case Workload::SetBindGroup:
+                ostream << "_SetBindGroup";
+                break;
+            case Workload::CreateBindGroup:
+                ostream << "_CreateBindGroup";
+                break;
+            case Workload::Finish:
+                ostream << "_Finish";
+                break;
+            case Workload::Submit:
+                ostream << "_Submit";
+                break;
+            case Workload::BuildAccelerationContainer:
+                ostream << "_BuildAccelerationContainer";
+                break;
+            case Workload::TraceRays:
+                ostream << "_TraceRays";
+                break;
+        }
+
+        return ostream;
+    }
+
+}  // namespace
+
+// Measures the CPU cost of the frontend on the null backend, which has no GPU work or driver
+// calls, so that regressions of Dawn's own overhead show up in isolation.
+class FrontendOverheadPerf : public DawnPerfTestWithParams<FrontendOverheadParams> {
+  public:
+    FrontendOverheadPerf() : DawnPerfTestWithParams(kNumIterations, 1) {
+    }
+    ~FrontendOverheadPerf() override = default;
+
+    void TestSetUp() override;
+
+  private:
+    void Step() override;
+
+    wgpu::RayTracingAccelerationContainer CreateBottomLevel();
+
+    void StepDraw();
+    void StepSetBindGroup();
+    void StepCreateBindGroup();
+    void StepFinish(bool submit);
+    void StepBuildAccelerationContainer();
+    void StepTraceRays();
+
+    utils::BasicRenderPass mRenderPass;
+    wgpu::RenderPipeline mRenderPipeline;
+    wgpu::Buffer mVertexBuffer;
+    wgpu::Buffer mUniformBuffer;
+    wgpu::BindGroupLayout mBindGroupLayout;
+    wgpu::BindGroup mBindGroups[2];
+
+    wgpu::Buffer mCopySrcBuffer;
+    wgpu::Buffer mCopyDstBuffer;
+
+    wgpu::Buffer mGeometryVertexBuffer;
+    wgpu::RayTracingAccelerationContainer mGeometryContainer;
+    wgpu::RayTracingAccelerationContainer mInstanceContainer;
+    wgpu::RayTracingPipeline mRayTracingPipeline;
+    wgpu::BindGroup mRayTracingBindGroup;
+};
+
+void FrontendOverheadPerf::TestSetUp() {
+    DawnPerfTestWithParams<FrontendOverheadParams>::TestSetUp();
+
+    // The results only measure the frontend on the null backend.
+    DAWN_SKIP_TEST_IF(!IsNull());
+
+    switch (GetParam().workload) {
+        case Workload::Draw:
+        case Workload::SetBindGroup:
+        case Workload::CreateBindGroup: {
+            mRenderPass = utils::CreateBasicRenderPass(device, 4, 4);
+
+            mVertexBuffer = utils::CreateBufferFromData(device, kVertexData, sizeof(kVertexData),
+                                                        wgpu::BufferUsage::Vertex);
+
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = 256 * 2;
+            descriptor.usage = wgpu::BufferUsage::Uniform;
+            mUniformBuffer = device.CreateBuffer(&descriptor);
+
+            mBindGroupLayout = utils::MakeBindGroupLayout(
+                device, {{0, wgpu::ShaderStage::Fragment, wgpu::BindingType::UniformBuffer}});
+            for (uint32_t i = 0; i < 2; ++i) {
+                mBindGroups[i] = utils::MakeBindGroup(device, mBindGroupLayout,
+                                                      {{0, mUniformBuffer, i * 256, 16}});
+            }
+
+            utils::ComboRenderPipelineDescriptor pipelineDescriptor(device);
+            pipelineDescriptor.vertexStage.module =
+                utils::CreateShaderModule(device, utils::SingleShaderStage::Vertex, kVertexShader);
+            pipelineDescriptor.cFragmentStage.module = utils::CreateShaderModule(
+                device, utils::SingleShaderStage::Fragment, kFragmentShader);
+            pipelineDescriptor.layout = utils::MakeBasicPipelineLayout(device, &mBindGroupLayout);
+            pipelineDescriptor.cVertexState.vertexBufferCount = 1;
+            pipelineDescriptor.cVertexState.cVertexBuffers[0].arrayStride = 4 * sizeof(float);
+            pipelineDescriptor.cVertexState.cVertexBuffers[0].attributeCount = 1;
+            pipelineDescriptor.cVertexState.cAttributes[0].format = wgpu::VertexFormat::Float4;
+            pipelineDescriptor.cColorStates[0].format = mRenderPass.colorFormat;
+            mRenderPipeline = device.CreateRenderPipeline(&pipelineDescriptor);
+        } break;
+
+        case Workload::Finish:
+        case Workload::Submit: {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = 4;
+            descriptor.usage = wgpu::BufferUsage::CopySrc;
+            mCopySrcBuffer = device.CreateBuffer(&descriptor);
+            descriptor.usage = wgpu::BufferUsage::CopyDst;
+            mCopyDstBuffer = device.CreateBuffer(&descriptor);
+        } break;
+
+        case Workload::BuildAccelerationContainer:
+        case Workload::TraceRays: {
+            const float vertices[9] = {0.0f, 1.0f, 0.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f};
+            mGeometryVertexBuffer = utils::CreateBufferFromData(
+                device, vertices, sizeof(vertices), wgpu::BufferUsage::CopyDst);
+            if (GetParam().workload == Workload::BuildAccelerationContainer) {
+                break;
+            }
+
+            mGeometryContainer = CreateBottomLevel();
+
+            wgpu::RayTracingAccelerationInstanceDescriptor instance;
+            instance.geometryContainer = mGeometryContainer;
+            wgpu::RayTracingAccelerationContainerDescriptor instanceDescriptor;
+            instanceDescriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+            instanceDescriptor.instanceCount = 1;
+            instanceDescriptor.instances = &instance;
+            mInstanceContainer = device.CreateRayTracingAccelerationContainer(&instanceDescriptor);
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            encoder.BuildRayTracingAccelerationContainer(mGeometryContainer);
+            encoder.BuildRayTracingAccelerationContainer(mInstanceContainer);
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+
+            wgpu::BufferDescriptor pixelDescriptor;
+            pixelDescriptor.size = 4 * sizeof(float);
+            pixelDescriptor.usage = wgpu::BufferUsage::Storage;
+            wgpu::Buffer pixelBuffer = device.CreateBuffer(&pixelDescriptor);
+
+            wgpu::BindGroupLayout bindGroupLayout = utils::MakeBindGroupLayout(
+                device,
+                {{0, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::AccelerationContainer},
+                 {1, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::StorageBuffer}});
+
+            wgpu::BindGroupBinding bindings[2] = {};
+            bindings[0].binding = 0;
+            bindings[0].accelerationContainer = mInstanceContainer;
+            bindings[1].binding = 1;
+            bindings[1].buffer = pixelBuffer;
+            bindings[1].size = pixelDescriptor.size;
+
+            wgpu::BindGroupDescriptor bindGroupDescriptor;
+            bindGroupDescriptor.layout = bindGroupLayout;
+            bindGroupDescriptor.bindingCount = 2;
+            bindGroupDescriptor.bindings = bindings;
+            mRayTracingBindGroup = device.CreateBindGroup(&bindGroupDescriptor);
+
+            wgpu::RayTracingShaderBindingTableStagesDescriptor stages[3] = {
+                {wgpu::ShaderStage::RayGeneration,
+                 utils::CreateShaderModule(device, utils::SingleShaderStage::RayGeneration,
+                                           kRayGen)},
+                {wgpu::ShaderStage::RayClosestHit,
+                 utils::CreateShaderModule(device, utils::SingleShaderStage::RayClosestHit,
+                                           kRayClosestHit)},
+                {wgpu::ShaderStage::RayMiss,
+                 utils::CreateShaderModule(device, utils::SingleShaderStage::RayMiss, kRayMiss)},
+            };
+
+            wgpu::RayTracingShaderBindingTableGroupsDescriptor groups[3] = {};
+            groups[0].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+            groups[0].generalIndex = 0;
+            groups[1].type = wgpu::RayTracingShaderBindingTableGroupType::TrianglesHitGroup;
+            groups[1].closestHitIndex = 1;
+            groups[2].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+            groups[2].generalIndex = 2;
+
+            wgpu::RayTracingShaderBindingTableDescriptor sbtDescriptor;
+            sbtDescriptor.stagesCount = 3;
+            sbtDescriptor.stages = stages;
+            sbtDescriptor.groupsCount = 3;
+            sbtDescriptor.groups = groups;
+
+            wgpu::RayTracingStateDescriptor state;
+            state.shaderBindingTable = device.CreateRayTracingShaderBindingTable(&sbtDescriptor);
+            state.maxRecursionDepth = 1;
+
+            wgpu::RayTracingPipelineDescriptor pipelineDescriptor;
+            pipelineDescriptor.layout = utils::MakeBasicPipelineLayout(device, &bindGroupLayout);
+            pipelineDescriptor.rayTracingState = &state;
+            mRayTracingPipeline = device.CreateRayTracingPipeline(&pipelineDescriptor);
+        } break;
+    }
+}
+
+wgpu::RayTracingAccelerationContainer FrontendOverheadPerf::CreateBottomLevel() {
+    wgpu::RayTracingAccelerationGeometryVertexDescriptor vertex;
+    vertex.buffer = mGeometryVertexBuffer;
+    vertex.format = wgpu::VertexFormat::Float3;
+    vertex.stride = 3 * sizeof(float);
+    vertex.count = 3;
+
+    wgpu::RayTracingAccelerationGeometryDescriptor geometry;
+    geometry.flags = wgpu::RayTracingAccelerationGeometryFlag::Opaque;
+    geometry.type = wgpu::RayTracingAccelerationGeometryType::Triangles;
+    geometry.vertex = &vertex;
+
+    wgpu::RayTracingAccelerationContainerDescriptor descriptor;
+    descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Bottom;
+    descriptor.geometryCount = 1;
+    descriptor.geometries = &geometry;
+
+    return device.CreateRayTracingAccelerationContainer(&descriptor);
+}
+
+void FrontendOverheadPerf::StepDraw() {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+    pass.SetPipeline(mRenderPipeline);
+    pass.SetVertexBuffer(0, mVertexBuffer);
+    pass.SetBindGroup(0, mBindGroups[0]);
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        pass.Draw(3, 1, 0, 0);
+    }
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void FrontendOverheadPerf::StepSetBindGroup() {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+    pass.SetPipeline(mRenderPipeline);
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        // Alternate between the bind groups so that none of the calls are redundant.
+        pass.SetBindGroup(0, mBindGroups[i % 2]);
+    }
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void FrontendOverheadPerf::StepCreateBindGroup() {
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        utils::MakeBindGroup(device, mBindGroupLayout, {{0, mUniformBuffer, 0, 16}});
+    }
+}
+
+void FrontendOverheadPerf::StepFinish(bool submit) {
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(mCopySrcBuffer, 0, mCopyDstBuffer, 0, 4);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        if (submit) {
+            queue.Submit(1, &commands);
+        }
+    }
+}
+
+void FrontendOverheadPerf::StepBuildAccelerationContainer() {
+    std::vector<wgpu::RayTracingAccelerationContainer> containers;
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        containers.push_back(CreateBottomLevel());
+    }
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (const wgpu::RayTracingAccelerationContainer& container : containers) {
+        encoder.BuildRayTracingAccelerationContainer(container);
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void FrontendOverheadPerf::StepTraceRays() {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RayTracingPassDescriptor descriptor;
+    wgpu::RayTracingPassEncoder pass = encoder.BeginRayTracingPass(&descriptor);
+    pass.SetPipeline(mRayTracingPipeline);
+    pass.SetBindGroup(0, mRayTracingBindGroup);
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        pass.TraceRays(0, 1, 2, 1, 1);
+    }
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void FrontendOverheadPerf::Step() {
+    switch (GetParam().workload) {
+        case Workload::Draw:
+            StepDraw();
+            break;
+        case Workload::SetBindGroup:
+            StepSetBindGroup();
+            break;
+        case Workload::CreateBindGroup:
+            StepCreateBindGroup();
+            break;
+        case Workload::Finish:
+            StepFinish(false);
+            break;
+        case Workload::Submit:
+            StepFinish(true);
+            break;
+        case Workload::BuildAccelerationContainer:
+            StepBuildAccelerationContainer();
+            break;
+        case Workload::TraceRays:
+            StepTraceRays();
+            break;
+    }
+}
+
+TEST_P(FrontendOverheadPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_PERF_TEST_SUITE_P(FrontendOverheadPerf,
+                                   {NullBackend()},
+                                   {Workload::Draw, Workload::SetBindGroup,
+                                    Workload::CreateBindGroup, Workload::Finish, Workload::Submit,
+                                    Workload::BuildAccelerationContainer, Workload::TraceRays});
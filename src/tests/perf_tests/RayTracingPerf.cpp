@@ -0,0 +1,614 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "common/Assert.h"
+#include "tests/ParamGenerator.h"
+#include "utils/RayTracingScene.h"
+#include "utils/WGPUHelpers.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    constexpr unsigned int kNumIterations = 10;
+
+    // Every bottom-level geometry is a grid of |kGridSize| x |kGridSize| quads.
+    constexpr uint32_t kGridSize = 32;
+    constexpr uint32_t kTrianglesPerGeometry = kGridSize * kGridSize * 2;
+
+    // The amount of instances of the scene traced against.
+    constexpr uint32_t kSceneInstanceCount = 64;
+
+    // The instances of the UpdateScene workload share this many meshes.
+    constexpr uint32_t kSceneMeshCount = 4;
+
+    constexpr char kRayGenPrimary[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadNV vec3 hitValue;
+        layout(set = 0, binding = 0) uniform accelerationStructureNV topLevelAS;
+        layout(std140, set = 0, binding = 1) buffer PixelBuffer {
+            vec4 pixels[];
+        } pixelBuffer;
+        void main() {
+            const vec2 uv = (vec2(gl_LaunchIDNV.xy) + 0.5) / vec2(gl_LaunchSizeNV.xy);
+            const vec3 origin = vec3(uv * 8.0, -1.0);
+            hitValue = vec3(0);
+            traceNV(topLevelAS, gl_RayFlagsOpaqueNV, 0xFF, 0, 0, 0, origin, 0.01,
+                    vec3(0, 0, 1), 4096.0, 0);
+            pixelBuffer.pixels[gl_LaunchIDNV.y * gl_LaunchSizeNV.x + gl_LaunchIDNV.x] =
+                vec4(hitValue, 1);
+        })";
+
+    constexpr char kRayGenShadow[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadNV vec3 hitValue;
+        layout(set = 0, binding = 0) uniform accelerationStructureNV topLevelAS;
+        layout(std140, set = 0, binding = 1) buffer PixelBuffer {
+            vec4 pixels[];
+        } pixelBuffer;
+        void main() {
+            const vec2 uv = (vec2(gl_LaunchIDNV.xy) + 0.5) / vec2(gl_LaunchSizeNV.xy);
+            const vec3 origin = vec3(uv * 8.0, -1.0);
+            hitValue = vec3(0);
+            traceNV(topLevelAS,
+                    gl_RayFlagsOpaqueNV | gl_RayFlagsTerminateOnFirstHitNV |
+                        gl_RayFlagsSkipClosestHitShaderNV,
+                    0xFF, 0, 0, 0, origin, 0.01, normalize(vec3(0.3, 0.2, 1)), 4096.0, 0);
+            pixelBuffer.pixels[gl_LaunchIDNV.y * gl_LaunchSizeNV.x + gl_LaunchIDNV.x] =
+                vec4(hitValue, 1);
+        })";
+
+    constexpr char kRayGenIncoherent[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadNV vec3 hitValue;
+        layout(set = 0, binding = 0) uniform accelerationStructureNV topLevelAS;
+        layout(std140, set = 0, binding = 1) buffer PixelBuffer {
+            vec4 pixels[];
+        } pixelBuffer;
+        uint hash(uint x) {
+            x ^= x >> 16;
+            x *= 0x7feb352dU;
+            x ^= x >> 15;
+            x *= 0x846ca68bU;
+            x ^= x >> 16;
+            return x;
+        }
+        void main() {
+            const uint index = gl_LaunchIDNV.y * gl_LaunchSizeNV.x + gl_LaunchIDNV.x;
+            const uint seed = hash(index);
+            const vec3 direction = normalize(vec3(hash(seed) & 0xFFFF, hash(seed + 1) & 0xFFFF,
+                                                  hash(seed + 2) & 0xFFFF) / 32767.5 - 1.0);
+            hitValue = vec3(0);
+            traceNV(topLevelAS, gl_RayFlagsOpaqueNV, 0xFF, 0, 0, 0, vec3(4, 4, 4), 0.01,
+                    direction, 4096.0, 0);
+            pixelBuffer.pixels[index] = vec4(hitValue, 1);
+        })";
+
+    constexpr char kRayClosestHit[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        hitAttributeNV vec2 attribs;
+        void main() {
+            hitValue = vec3(1.0 - attribs.x - attribs.y, attribs.x, attribs.y);
+        })";
+
+    constexpr char kRayMiss[] = R"(
+        #version 460
+        #extension GL_NV_ray_tracing : require
+        layout(location = 0) rayPayloadInNV vec3 hitValue;
+        void main() {
+            hitValue = vec3(0.15);
+        })";
+
+    enum class Workload {
+        BuildBottomLevel,  // Create and build bottom-level containers of |count| geometries.
+        BuildTopLevel,     // Create and build top-level containers of |count| instances.
+        UpdateTopLevel,    // Update the instances of a top-level container of |count| instances.
+        UpdateScene,       // Move a quarter of the |count| instances of a utils::RayTracingScene.
+        TracePrimary,      // Trace |count| x |count| coherent rays.
+        TraceShadow,       // Trace |count| x |count| rays terminating on their first hit.
+        TraceIncoherent,   // Trace |count| x |count| rays into random directions.
+        CreatePipeline,    // Create |count| shader binding tables and ray tracing pipelines.
+    };
+
+    enum class Size {
+        Small,
+        Medium,
+        Large,
+    };
+
+    // The meaning of the count differs between workloads, so each one gets scaled separately.
+    uint32_t GetCount(Workload workload, Size size) {
+        const uint32_t sizeIndex = static_cast<uint32_t>(size);
+        switch (workload) {
+            case Workload::BuildBottomLevel:
+                return std::array<uint32_t, 3>{1, 16, 128}[sizeIndex];
+            case Workload::BuildTopLevel:
+            case Workload::UpdateTopLevel:
+            case Workload::UpdateScene:
+                return std::array<uint32_t, 3>{64, 1024, 16384}[sizeIndex];
+            case Workload::TracePrimary:
+            case Workload::TraceShadow:
+            case Workload::TraceIncoherent:
+                return std::array<uint32_t, 3>{256, 1024, 2048}[sizeIndex];
+            case Workload::CreatePipeline:
+                return std::array<uint32_t, 3>{1, 4, 16}[sizeIndex];
+        }
+        UNREACHABLE();
+    }
+
+    struct RayTracingParams : DawnTestParam {
+        RayTracingParams(const DawnTestParam& param, Workload workload, Size size)
+            : DawnTestParam(param), workload(workload), count(GetCount(workload, size)) {
+        }
+
+        Workload workload;
+        uint32_t count;
+    };
+
+    std::ostream& operator<<(std::ostream& ostream, const RayTracingParams& param) {
+        ostream << static_cast<const DawnTestParam&>(param);
+
+        switch (param.workload) {
+            case Workload::BuildBottomLevel:
+                ostream << "_BuildBottomLevel_Geometries_";
+                break;
+            case Workload::BuildTopLevel:
+                ostream << "_BuildTopLevel_Instances_";
+                break;
+            case Workload::UpdateTopLevel:
+                ostream << "_UpdateTopLevel_Instances_";
+                break;
+            case Workload::UpdateScene:
+                ostream << "_UpdateScene_Instances_";
+                break;
+            case Workload::TracePrimary:
+                ostream << "_TracePrimary_Size_";
+                break;
+            case Workload::TraceShadow:
+                ostream << "_TraceShadow_Size_";
+                break;
+            case Workload::TraceIncoherent:
+                ostream << "_TraceIncoherent_Size_";
+                break;
+            case Workload::CreatePipeline:
+                ostream << "_CreatePipeline_Pipelines_";
+                break;
+        }
+        ostream << param.count;
+
+        return ostream;
+    }
+
+    void GetInstanceTransform(uint32_t instance, float offset, float transform[12]) {
+        // Lay the instances out on a 8x8 grid, stacked along the z axis.
+        const float x = static_cast<float>(instance % 8) + offset;
+        const float y = static_cast<float>((instance / 8) % 8);
+        const float z = static_cast<float>(instance / 64);
+        const float matrix[12] = {
+            1.0f / 8, 0.0f, 0.0f, x, 0.0f, 1.0f / 8, 0.0f, y, 0.0f, 0.0f, 1.0f / 8, z,
+        };
+        memcpy(transform, matrix, sizeof(matrix));
+    }
+
+}  // namespace
+
+// Measures the building and updating of acceleration containers, tracing rays against them, and
+// the creation of ray tracing pipelines.
+class RayTracingPerf : public DawnPerfTestWithParams<RayTracingParams> {
+  public:
+    RayTracingPerf() : DawnPerfTestWithParams(kNumIterations, 1) {
+    }
+    ~RayTracingPerf() override = default;
+
+    void TestSetUp() override;
+
+  private:
+    void Step() override;
+
+    wgpu::RayTracingAccelerationContainer CreateBottomLevel(uint32_t geometryCount);
+    wgpu::RayTracingAccelerationContainer CreateTopLevel(uint32_t instanceCount,
+                                                         wgpu::RayTracingAccelerationContainerFlag flags);
+    wgpu::RayTracingPipeline CreatePipeline(const char* rayGen);
+
+    void StepBuildBottomLevel();
+    void StepBuildTopLevel();
+    void StepUpdateTopLevel();
+    void StepUpdateScene();
+    void StepTraceRays();
+    void StepCreatePipeline();
+
+    wgpu::Buffer mVertexBuffer;
+    wgpu::Buffer mIndexBuffer;
+    wgpu::Buffer mPixelBuffer;
+
+    wgpu::RayTracingAccelerationContainer mGeometryContainer;
+    wgpu::RayTracingAccelerationContainer mInstanceContainer;
+    std::unique_ptr<utils::RayTracingScene> mScene;
+
+    wgpu::BindGroupLayout mBindGroupLayout;
+    wgpu::PipelineLayout mPipelineLayout;
+    wgpu::BindGroup mBindGroup;
+    wgpu::RayTracingPipeline mPipeline;
+
+    wgpu::ShaderModule mRayClosestHitModule;
+    wgpu::ShaderModule mRayMissModule;
+
+    std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> mInstances;
+    std::vector<float> mTransforms;
+    uint32_t mUpdateCount = 0;
+};
+
+void RayTracingPerf::TestSetUp() {
+    DawnPerfTestWithParams<RayTracingParams>::TestSetUp();
+
+    // Unsupported on backends other than Vulkan.
+    DAWN_SKIP_TEST_IF(!IsVulkan());
+
+    // The geometry is a grid of quads in the xy plane.
+    std::vector<float> vertices;
+    for (uint32_t y = 0; y <= kGridSize; ++y) {
+        for (uint32_t x = 0; x <= kGridSize; ++x) {
+            vertices.push_back(static_cast<float>(x) / kGridSize);
+            vertices.push_back(static_cast<float>(y) / kGridSize);
+            vertices.push_back(0.0f);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < kGridSize; ++y) {
+        for (uint32_t x = 0; x < kGridSize; ++x) {
+            uint32_t i = y * (kGridSize + 1) + x;
+            indices.insert(indices.end(), {i, i + 1, i + kGridSize + 1});
+            indices.insert(indices.end(), {i + 1, i + kGridSize + 2, i + kGridSize + 1});
+        }
+    }
+    ASSERT(indices.size() == kTrianglesPerGeometry * 3);
+
+    mVertexBuffer = utils::CreateBufferFromData(device, vertices.data(),
+                                                vertices.size() * sizeof(float),
+                                                wgpu::BufferUsage::CopyDst);
+    mIndexBuffer = utils::CreateBufferFromData(device, indices.data(),
+                                               indices.size() * sizeof(uint32_t),
+                                               wgpu::BufferUsage::CopyDst);
+
+    mRayClosestHitModule =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::RayClosestHit, kRayClosestHit);
+    mRayMissModule = utils::CreateShaderModule(device, utils::SingleShaderStage::RayMiss, kRayMiss);
+
+    const RayTracingParams& params = GetParam();
+    switch (params.workload) {
+        case Workload::BuildBottomLevel:
+        case Workload::CreatePipeline:
+            break;
+
+        case Workload::BuildTopLevel:
+        case Workload::UpdateTopLevel: {
+            mGeometryContainer = CreateBottomLevel(1);
+            mInstanceContainer =
+                CreateTopLevel(params.count, wgpu::RayTracingAccelerationContainerFlag::AllowUpdate |
+                                                 wgpu::RayTracingAccelerationContainerFlag::PreferFastBuild);
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            encoder.BuildRayTracingAccelerationContainer(mGeometryContainer);
+            encoder.BuildRayTracingAccelerationContainer(mInstanceContainer);
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+        } break;
+
+        case Workload::UpdateScene: {
+            wgpu::RayTracingAccelerationGeometryVertexDescriptor vertex;
+            vertex.buffer = mVertexBuffer;
+            vertex.format = wgpu::VertexFormat::Float3;
+            vertex.stride = 3 * sizeof(float);
+            vertex.count = (kGridSize + 1) * (kGridSize + 1);
+
+            wgpu::RayTracingAccelerationGeometryIndexDescriptor index;
+            index.buffer = mIndexBuffer;
+            index.format = wgpu::IndexFormat::Uint32;
+            index.count = kTrianglesPerGeometry * 3;
+
+            wgpu::RayTracingAccelerationGeometryDescriptor geometry;
+            geometry.flags = wgpu::RayTracingAccelerationGeometryFlag::Opaque;
+            geometry.type = wgpu::RayTracingAccelerationGeometryType::Triangles;
+            geometry.vertex = &vertex;
+            geometry.index = &index;
+
+            // Every instance adds its mesh, which the scene deduplicates: the mesh m is made of
+            // m + 1 grids.
+            mScene = std::make_unique<utils::RayTracingScene>(device,
+                                                              utils::RayTracingSceneDescriptor{});
+            for (uint32_t ii = 0; ii < params.count; ++ii) {
+                std::vector<wgpu::RayTracingAccelerationGeometryDescriptor> geometries(
+                    ii % kSceneMeshCount + 1, geometry);
+                float transform[12];
+                GetInstanceTransform(ii, 0.0f, transform);
+                mScene->AddInstance(mScene->AddMesh(geometries), transform);
+            }
+            ASSERT(mScene->GetMeshCount() == std::min(params.count, kSceneMeshCount));
+            mScene->Submit(queue);
+        } break;
+
+        case Workload::TracePrimary:
+        case Workload::TraceShadow:
+        case Workload::TraceIncoherent: {
+            mGeometryContainer = CreateBottomLevel(1);
+            mInstanceContainer = CreateTopLevel(
+                kSceneInstanceCount, wgpu::RayTracingAccelerationContainerFlag::PreferFastTrace);
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            encoder.BuildRayTracingAccelerationContainer(mGeometryContainer);
+            encoder.BuildRayTracingAccelerationContainer(mInstanceContainer);
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = params.count * params.count * 4 * sizeof(float);
+            descriptor.usage = wgpu::BufferUsage::Storage;
+            mPixelBuffer = device.CreateBuffer(&descriptor);
+
+            mBindGroupLayout = utils::MakeBindGroupLayout(
+                device, {{0, wgpu::ShaderStage::RayGeneration,
+                          wgpu::BindingType::AccelerationContainer},
+                         {1, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::StorageBuffer}});
+
+            wgpu::BindGroupBinding bindings[2] = {};
+            bindings[0].binding = 0;
+            bindings[0].accelerationContainer = mInstanceContainer;
+            bindings[1].binding = 1;
+            bindings[1].buffer = mPixelBuffer;
+            bindings[1].size = descriptor.size;
+
+            wgpu::BindGroupDescriptor bindGroupDescriptor;
+            bindGroupDescriptor.layout = mBindGroupLayout;
+            bindGroupDescriptor.bindingCount = 2;
+            bindGroupDescriptor.bindings = bindings;
+            mBindGroup = device.CreateBindGroup(&bindGroupDescriptor);
+
+            mPipelineLayout = utils::MakeBasicPipelineLayout(device, &mBindGroupLayout);
+
+            const char* rayGen = params.workload == Workload::TracePrimary
+                                     ? kRayGenPrimary
+                                     : params.workload == Workload::TraceShadow ? kRayGenShadow
+                                                                                : kRayGenIncoherent;
+            mPipeline = CreatePipeline(rayGen);
+        } break;
+    }
+
+    if (params.workload == Workload::CreatePipeline) {
+        mBindGroupLayout = utils::MakeBindGroupLayout(
+            device,
+            {{0, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::AccelerationContainer},
+             {1, wgpu::ShaderStage::RayGeneration, wgpu::BindingType::StorageBuffer}});
+        mPipelineLayout = utils::MakeBasicPipelineLayout(device, &mBindGroupLayout);
+    }
+}
+
+wgpu::RayTracingAccelerationContainer RayTracingPerf::CreateBottomLevel(uint32_t geometryCount) {
+    wgpu::RayTracingAccelerationGeometryVertexDescriptor vertex;
+    vertex.buffer = mVertexBuffer;
+    vertex.format = wgpu::VertexFormat::Float3;
+    vertex.stride = 3 * sizeof(float);
+    vertex.count = (kGridSize + 1) * (kGridSize + 1);
+
+    wgpu::RayTracingAccelerationGeometryIndexDescriptor index;
+    index.buffer = mIndexBuffer;
+    index.format = wgpu::IndexFormat::Uint32;
+    index.count = kTrianglesPerGeometry * 3;
+
+    wgpu::RayTracingAccelerationGeometryDescriptor geometry;
+    geometry.flags = wgpu::RayTracingAccelerationGeometryFlag::Opaque;
+    geometry.type = wgpu::RayTracingAccelerationGeometryType::Triangles;
+    geometry.vertex = &vertex;
+    geometry.index = &index;
+
+    std::vector<wgpu::RayTracingAccelerationGeometryDescriptor> geometries(geometryCount,
+                                                                            geometry);
+
+    wgpu::RayTracingAccelerationContainerDescriptor descriptor;
+    descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Bottom;
+    descriptor.flags = wgpu::RayTracingAccelerationContainerFlag::PreferFastTrace;
+    descriptor.geometryCount = geometries.size();
+    descriptor.geometries = geometries.data();
+
+    return device.CreateRayTracingAccelerationContainer(&descriptor);
+}
+
+wgpu::RayTracingAccelerationContainer RayTracingPerf::CreateTopLevel(
+    uint32_t instanceCount,
+    wgpu::RayTracingAccelerationContainerFlag flags) {
+    mTransforms.resize(instanceCount * 12);
+    mInstances.resize(instanceCount);
+    for (uint32_t ii = 0; ii < instanceCount; ++ii) {
+        GetInstanceTransform(ii, 0.0f, &mTransforms[ii * 12]);
+
+        wgpu::RayTracingAccelerationInstanceDescriptor& instance = mInstances[ii];
+        instance = {};
+        instance.flags = wgpu::RayTracingAccelerationInstanceFlag::TriangleCullDisable;
+        instance.instanceId = ii;
+        instance.geometryContainer = mGeometryContainer;
+        instance.transformMatrixSize = 12;
+        instance.transformMatrix = &mTransforms[ii * 12];
+    }
+
+    wgpu::RayTracingAccelerationContainerDescriptor descriptor;
+    descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+    descriptor.flags = flags;
+    descriptor.instanceCount = mInstances.size();
+    descriptor.instances = mInstances.data();
+
+    return device.CreateRayTracingAccelerationContainer(&descriptor);
+}
+
+wgpu::RayTracingPipeline RayTracingPerf::CreatePipeline(const char* rayGen) {
+    wgpu::ShaderModule rayGenModule =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::RayGeneration, rayGen);
+
+    wgpu::RayTracingShaderBindingTableStagesDescriptor stages[3] = {
+        {wgpu::ShaderStage::RayGeneration, rayGenModule},
+        {wgpu::ShaderStage::RayClosestHit, mRayClosestHitModule},
+        {wgpu::ShaderStage::RayMiss, mRayMissModule},
+    };
+
+    wgpu::RayTracingShaderBindingTableGroupsDescriptor groups[3] = {};
+    groups[0].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+    groups[0].generalIndex = 0;
+    groups[1].type = wgpu::RayTracingShaderBindingTableGroupType::TrianglesHitGroup;
+    groups[1].closestHitIndex = 1;
+    groups[2].type = wgpu::RayTracingShaderBindingTableGroupType::General;
+    groups[2].generalIndex = 2;
+
+    wgpu::RayTracingShaderBindingTableDescriptor sbtDescriptor;
+    sbtDescriptor.stagesCount = 3;
+    sbtDescriptor.stages = stages;
+    sbtDescriptor.groupsCount = 3;
+    sbtDescriptor.groups = groups;
+    wgpu::RayTracingShaderBindingTable sbt =
+        device.CreateRayTracingShaderBindingTable(&sbtDescriptor);
+
+    wgpu::RayTracingStateDescriptor state;
+    state.shaderBindingTable = sbt;
+    state.maxRecursionDepth = 1;
+
+    wgpu::RayTracingPipelineDescriptor descriptor;
+    descriptor.layout = mPipelineLayout;
+    descriptor.rayTracingState = &state;
+
+    return device.CreateRayTracingPipeline(&descriptor);
+}
+
+void RayTracingPerf::StepBuildBottomLevel() {
+    std::vector<wgpu::RayTracingAccelerationContainer> containers;
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        containers.push_back(CreateBottomLevel(GetParam().count));
+    }
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.BuildRayTracingAccelerationContainers(containers.size(), containers.data());
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void RayTracingPerf::StepBuildTopLevel() {
+    std::vector<wgpu::RayTracingAccelerationContainer> containers;
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        containers.push_back(
+            CreateTopLevel(GetParam().count, wgpu::RayTracingAccelerationContainerFlag::PreferFastBuild));
+    }
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.BuildRayTracingAccelerationContainers(containers.size(), containers.data());
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void RayTracingPerf::StepUpdateTopLevel() {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        // move all the instances, so that every update has to refit the whole container
+        float offset = static_cast<float>(++mUpdateCount % 16) / 16.0f;
+        for (uint32_t ii = 0; ii < mInstances.size(); ++ii) {
+            GetInstanceTransform(ii, offset, &mTransforms[ii * 12]);
+        }
+        mInstanceContainer.UpdateInstances(0, mInstances.size(), mInstances.data());
+        encoder.UpdateRayTracingAccelerationContainer(mInstanceContainer);
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void RayTracingPerf::StepUpdateScene() {
+    const uint32_t instanceCount = mScene->GetInstanceCount();
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        // move a contiguous quarter of the instances, which the scene refits without writing
+        // the other instances
+        float offset = static_cast<float>(++mUpdateCount % 16) / 16.0f;
+        uint32_t firstInstance = (mUpdateCount % 4) * instanceCount / 4;
+        for (uint32_t ii = firstInstance; ii < firstInstance + instanceCount / 4; ++ii) {
+            float transform[12];
+            GetInstanceTransform(ii, offset, transform);
+            mScene->SetInstanceTransform(ii, transform);
+        }
+        mScene->Submit(queue);
+    }
+}
+
+void RayTracingPerf::StepTraceRays() {
+    const uint32_t size = GetParam().count;
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RayTracingPassDescriptor descriptor;
+    wgpu::RayTracingPassEncoder pass = encoder.BeginRayTracingPass(&descriptor);
+    pass.SetPipeline(mPipeline);
+    pass.SetBindGroup(0, mBindGroup);
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        pass.TraceRays(0, 1, 2, size, size);
+    }
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
+
+void RayTracingPerf::StepCreatePipeline() {
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        for (uint32_t ii = 0; ii < GetParam().count; ++ii) {
+            CreatePipeline(kRayGenPrimary);
+        }
+    }
+}
+
+void RayTracingPerf::Step() {
+    switch (GetParam().workload) {
+        case Workload::BuildBottomLevel:
+            StepBuildBottomLevel();
+            break;
+        case Workload::BuildTopLevel:
+            StepBuildTopLevel();
+            break;
+        case Workload::UpdateTopLevel:
+            StepUpdateTopLevel();
+            break;
+        case Workload::UpdateScene:
+            StepUpdateScene();
+            break;
+        case Workload::TracePrimary:
+        case Workload::TraceShadow:
+        case Workload::TraceIncoherent:
+            StepTraceRays();
+            break;
+        case Workload::CreatePipeline:
+            StepCreatePipeline();
+            break;
+    }
+}
+
+TEST_P(RayTracingPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_PERF_TEST_SUITE_P(RayTracingPerf,
+                                   {VulkanBackend()},
+                                   {Workload::BuildBottomLevel, Workload::BuildTopLevel,
+                                    Workload::UpdateTopLevel, Workload::UpdateScene,
+                                    Workload::TracePrimary, Workload::TraceShadow,
+                                    Workload::TraceIncoherent, Workload::CreatePipeline},
+                                   {Size::Small, Size::Medium, Size::Large});
@@ -0,0 +1,169 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "common/Log.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+#include "tests/perf_tests/DawnPerfTestPlatform.h"
+#include "utils/Timer.h"
+
+#include <dawn_native/DawnNative.h>
+#include <dawn_wire/WireCapture.h>
+#include <dawn_wire/WireServer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Drops the replies of the server, nothing waits for them during the replay.
+    class DiscardingCommandSerializer : public dawn_wire::CommandSerializer {
+      public:
+        void* GetCmdSpace(size_t size) override {
+            if (mBuffer.size() < size) {
+                mBuffer.resize(size);
+            }
+            return mBuffer.data();
+        }
+
+        bool Flush() override {
+            return true;
+        }
+
+      private:
+        std::vector<char> mBuffer;
+    };
+
+}  // anonymous namespace
+
+// Replays the wire capture given with --wire-capture= on the backend device, for offline
+// profiling of the workload of an application. Each step replays the whole capture on a new
+// WireServer, whose IDs start from scratch, and destroys it. The batches of the capture are timed
+// separately, and with --trace-file each of them is a WireReplay::Batch event containing the
+// recording of the command buffers and passes it submitted.
+class WireReplayPerf : public DawnPerfTestWithParams<> {
+  public:
+    WireReplayPerf() : DawnPerfTestWithParams(1, 1), mTimer(utils::CreateTimer()) {
+    }
+    ~WireReplayPerf() override = default;
+
+    void TestSetUp() override;
+
+  protected:
+    void ReportReplay();
+
+  private:
+    void Step() override;
+
+    static void OnReplayError(WGPUErrorType type, const char* message, void* userdata);
+
+    std::vector<std::vector<char>> mBatches;
+    // The time spent handling each batch, summed over all the replays.
+    std::vector<double> mBatchSeconds;
+    unsigned int mReplayCount = 0;
+    uint64_t mReplayErrorCount = 0;
+    dawn_wire::WireStatistics mStatistics;
+    std::unique_ptr<utils::Timer> mTimer;
+};
+
+void WireReplayPerf::TestSetUp() {
+    DawnPerfTestWithParams<>::TestSetUp();
+
+    const char* captureFile = GetEnvironment()->GetWireCaptureFile();
+    DAWN_SKIP_TEST_IF(captureFile == nullptr);
+
+    dawn_wire::WireCaptureReader reader(captureFile);
+    ASSERT_TRUE(reader.IsValid()) << captureFile << " is not a wire capture.";
+
+    std::vector<char> commands;
+    while (reader.ReadBatch(&commands)) {
+        mBatches.push_back(std::move(commands));
+    }
+    ASSERT_FALSE(mBatches.empty()) << captureFile << " has no commands.";
+    mBatchSeconds.resize(mBatches.size(), 0.0);
+}
+
+void WireReplayPerf::Step() {
+    DawnProcTable backendProcs = dawn_native::GetProcs();
+    DiscardingCommandSerializer serializer;
+
+    dawn_wire::WireServerDescriptor serverDesc = {};
+    serverDesc.device = backendDevice;
+    serverDesc.procs = &backendProcs;
+    serverDesc.serializer = &serializer;
+    serverDesc.collectStatistics = true;
+    dawn_wire::WireServer server(serverDesc);
+
+    // The server forwards the errors to the client, which isn't there. Count them instead, which
+    // also keeps the device from calling the server once it is destroyed.
+    backendProcs.deviceSetUncapturedErrorCallback(backendDevice, OnReplayError, this);
+    backendProcs.deviceSetDeviceLostCallback(backendDevice, nullptr, nullptr);
+
+    dawn_platform::Platform* platform = GetEnvironment()->GetPlatform();
+    for (size_t i = 0; i < mBatches.size(); ++i) {
+        TRACE_EVENT0(platform, General, "WireReplay::Batch");
+
+        mTimer->Start();
+        const volatile char* result = server.HandleCommands(mBatches[i].data(), mBatches[i].size());
+        mTimer->Stop();
+        mBatchSeconds[i] += mTimer->GetElapsedTime();
+
+        if (result == nullptr) {
+            ADD_FAILURE() << "Batch " << i << " of the capture failed to replay.";
+            AbortTest();
+            return;
+        }
+    }
+
+    mStatistics = server.GetStatistics();
+    mReplayCount++;
+}
+
+void WireReplayPerf::ReportReplay() {
+    if (mReplayCount == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < mBatchSeconds.size(); ++i) {
+        double batchMicroseconds = mBatchSeconds[i] * 1e6 / mReplayCount;
+        PrintResult("batch_" + std::to_string(i), batchMicroseconds, "us", false);
+    }
+    PrintResult("replay_errors", static_cast<unsigned int>(mReplayErrorCount / mReplayCount),
+                "count", false);
+
+    dawn::InfoLog() << "Commands of one replay:\n" << mStatistics.ToString();
+}
+
+// static
+void WireReplayPerf::OnReplayError(WGPUErrorType, const char* message, void* userdata) {
+    WireReplayPerf* test = static_cast<WireReplayPerf*>(userdata);
+    if (test->mReplayErrorCount == 0) {
+        dawn::WarningLog() << "The replay of the capture produced an error: " << message;
+    }
+    test->mReplayErrorCount++;
+}
+
+TEST_P(WireReplayPerf, Run) {
+    RunTest();
+    ReportReplay();
+}
+
+DAWN_INSTANTIATE_TEST(WireReplayPerf,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      NullBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
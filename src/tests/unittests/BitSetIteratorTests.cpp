@@ -16,6 +16,9 @@
 
 #include "common/BitSetIterator.h"
 
+#include <set>
+#include <vector>
+
 // This is ANGLE's BitSetIterator_unittests.cpp file.
 
 class BitSetIteratorTest : public testing::Test {
@@ -82,3 +85,51 @@ TEST_F(BitSetIteratorTest, NonLValueBitset) {
 
     EXPECT_EQ((mStateBits & otherBits).count(), seenBits.size());
 }
+
+// Test that the word iterator visits the same bits as the bitset iterator, across several words.
+TEST(BitSetWordIteratorTest, MatchesBitSetIterator) {
+    std::bitset<150> bits;
+    for (size_t bit : {0, 1, 31, 32, 63, 64, 65, 127, 128, 149}) {
+        bits.set(bit);
+    }
+
+    std::vector<uint32_t> expected;
+    for (uint32_t bit : IterateBitSet(bits)) {
+        expected.push_back(bit);
+    }
+
+    std::vector<uint32_t> seen;
+    for (uint32_t bit : IterateBitSetWords(bits)) {
+        seen.push_back(bit);
+    }
+    EXPECT_EQ(expected, seen);
+}
+
+// Test the word iterator on a single word, including an empty one.
+TEST(BitSetWordIteratorTest, SingleWord) {
+    std::bitset<16> bits;
+    for (uint32_t bit : IterateBitSetWords(bits)) {
+        DAWN_UNUSED(bit);
+        ADD_FAILURE();
+    }
+
+    bits.set(3);
+    bits.set(15);
+    std::vector<uint32_t> seen;
+    for (uint32_t bit : IterateBitSetWords(bits)) {
+        seen.push_back(bit);
+    }
+    EXPECT_EQ(seen, std::vector<uint32_t>({3, 15}));
+}
+
+// Test that the word iterator skips the empty words.
+TEST(BitSetWordIteratorTest, EmptyWords) {
+    std::bitset<256> bits;
+    bits.set(200);
+
+    std::vector<uint32_t> seen;
+    for (uint32_t bit : IterateBitSetWords(bits)) {
+        seen.push_back(bit);
+    }
+    EXPECT_EQ(seen, std::vector<uint32_t>({200}));
+}
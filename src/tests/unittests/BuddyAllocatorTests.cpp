@@ -324,4 +324,60 @@ TEST(BuddyAllocatorTests, VariousSizeSameAlignment) {
     ASSERT_EQ(allocator.Allocate(16, alignment), 16ull);
 
     ASSERT_EQ(allocator.ComputeTotalNumOfFreeBlocksForTesting(), 0u);
-}
\ No newline at end of file
+}
+
+// Verify the buddy allocator skips the levels whose free blocks are unaligned.
+TEST(BuddyAllocatorTests, AlignmentSkipsLevels) {
+    //  After one 8 byte allocation then one 8 byte allocation with 32 byte alignment.
+    //
+    //  Level          ----------------------------------------------------------------
+    //      0       64 |                               S                              |
+    //                 ----------------------------------------------------------------
+    //      1       32 |               S               |               S              |
+    //                 ----------------------------------------------------------------
+    //      2       16 |       S       |       F       |       S       |       F      |
+    //                 ----------------------------------------------------------------
+    //      3       8  |   Aa  |   F   |               |   Ab  |   F   |              |
+    //                 ----------------------------------------------------------------
+    //
+    BuddyAllocator allocator(64);
+
+    ASSERT_EQ(allocator.Allocate(8), 0u);
+    ASSERT_EQ(allocator.ComputeTotalNumOfFreeBlocksForTesting(), 3u);
+
+    // The free blocks of 8 and 16 bytes are unaligned, the 32 byte one is split.
+    ASSERT_EQ(allocator.Allocate(8, 32), 32u);
+    ASSERT_EQ(allocator.ComputeTotalNumOfFreeBlocksForTesting(), 4u);
+
+    // Smaller alignments use the smallest free blocks first.
+    ASSERT_EQ(allocator.Allocate(8, 8), 40u);
+    ASSERT_EQ(allocator.Allocate(16, 16), 48u);
+    ASSERT_EQ(allocator.Allocate(8, 8), 8u);
+    ASSERT_EQ(allocator.Allocate(16, 16), 16u);
+    ASSERT_EQ(allocator.ComputeTotalNumOfFreeBlocksForTesting(), 0u);
+    ASSERT_EQ(allocator.Allocate(8), BuddyAllocator::kInvalidOffset);
+
+    // Deallocating everything merges back into a single block, and the pooled blocks are reused.
+    for (uint64_t offset : {0u, 8u, 16u, 32u, 40u, 48u}) {
+        allocator.Deallocate(offset);
+    }
+    ASSERT_EQ(allocator.ComputeTotalNumOfFreeBlocksForTesting(), 1u);
+    ASSERT_EQ(allocator.Allocate(64), 0u);
+}
+
+// Verify that the allocated size counts the size of the allocated blocks.
+TEST(BuddyAllocatorTests, AllocatedSize) {
+    constexpr uint64_t maxBlockSize = 128;
+    BuddyAllocator allocator(maxBlockSize);
+    ASSERT_EQ(allocator.GetAllocatedSize(), 0u);
+
+    uint64_t offset1 = allocator.Allocate(32);
+    uint64_t offset2 = allocator.Allocate(64);
+    ASSERT_EQ(allocator.GetAllocatedSize(), 96u);
+
+    allocator.Deallocate(offset1);
+    ASSERT_EQ(allocator.GetAllocatedSize(), 64u);
+
+    allocator.Deallocate(offset2);
+    ASSERT_EQ(allocator.GetAllocatedSize(), 0u);
+}
@@ -48,6 +48,14 @@ class DummyBuddyResourceAllocator {
         return mAllocator.ComputeTotalNumOfHeapsForTesting();
     }
 
+    uint64_t GetAllocatedHeapSize() const {
+        return mAllocator.GetAllocatedHeapSize();
+    }
+
+    uint64_t GetUsedSize() const {
+        return mAllocator.GetUsedSize();
+    }
+
   private:
     DummyResourceHeapAllocator mHeapAllocator;
     BuddyMemoryAllocator mAllocator;
@@ -345,3 +353,32 @@ TEST(BuddyMemoryAllocatorTests, VariousSizeSameAlignment) {
 
     ASSERT_EQ(allocator.ComputeTotalNumOfHeapsForTesting(), 3u);
 }
+
+// Verify that the allocated heap and used sizes reflect the fragmentation of the heaps.
+TEST(BuddyMemoryAllocatorTests, AllocatedHeapAndUsedSizes) {
+    constexpr uint64_t maxBlockSize = 512;
+    constexpr uint64_t heapSize = 128;
+    DummyBuddyResourceAllocator allocator(maxBlockSize, heapSize);
+
+    ASSERT_EQ(allocator.GetAllocatedHeapSize(), 0u);
+    ASSERT_EQ(allocator.GetUsedSize(), 0u);
+
+    // Sizes are rounded up to the next power of two.
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(48);
+    ASSERT_EQ(allocation1.GetInfo().mRequestedSize, 48u);
+    ASSERT_EQ(allocator.GetAllocatedHeapSize(), heapSize);
+    ASSERT_EQ(allocator.GetUsedSize(), 64u);
+
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(heapSize);
+    ASSERT_EQ(allocator.GetAllocatedHeapSize(), 2 * heapSize);
+    ASSERT_EQ(allocator.GetUsedSize(), 64u + heapSize);
+
+    // The first heap stays allocated, half empty, until its last sub-allocation is freed.
+    allocator.Deallocate(allocation2);
+    ASSERT_EQ(allocator.GetAllocatedHeapSize(), heapSize);
+    ASSERT_EQ(allocator.GetUsedSize(), 64u);
+
+    allocator.Deallocate(allocation1);
+    ASSERT_EQ(allocator.GetAllocatedHeapSize(), 0u);
+    ASSERT_EQ(allocator.GetUsedSize(), 0u);
+}
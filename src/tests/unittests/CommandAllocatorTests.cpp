@@ -66,6 +66,23 @@ TEST(CommandAllocator, DoNothingAllocatorWithIterator) {
     iterator.DataWasDestroyed();
 }
 
+// Test that the allocated size of an iterator is the size of the blocks holding its commands
+TEST(CommandAllocator, AllocatedSize) {
+    {
+        CommandAllocator allocator;
+        CommandIterator iterator(std::move(allocator));
+        ASSERT_EQ(iterator.GetAllocatedSize(), 0u);
+        iterator.DataWasDestroyed();
+    }
+    {
+        CommandAllocator allocator;
+        allocator.Allocate<CommandDraw>(CommandType::Draw);
+        CommandIterator iterator(std::move(allocator));
+        ASSERT_GE(iterator.GetAllocatedSize(), sizeof(CommandDraw));
+        iterator.DataWasDestroyed();
+    }
+}
+
 // Test basic usage of allocator + iterator
 TEST(CommandAllocator, Basic) {
     CommandAllocator allocator;
@@ -446,3 +463,58 @@ TEST(CommandAllocator, AllocateDataDefaultInitializes) {
     CommandIterator iterator(std::move(allocator));
     iterator.DataWasDestroyed();
 }
+
+// Test that the blocks of a destroyed iterator are reused by the next allocator of the pool
+TEST(CommandAllocator, BlockPoolReusesBlocks) {
+    CommandBlockPool pool;
+
+    CommandDraw* firstDraw;
+    {
+        CommandAllocator allocator(&pool);
+        firstDraw = allocator.Allocate<CommandDraw>(CommandType::Draw);
+
+        CommandIterator iterator(std::move(allocator));
+        iterator.DataWasDestroyed();
+    }
+
+    {
+        CommandAllocator allocator(&pool);
+        CommandDraw* secondDraw = allocator.Allocate<CommandDraw>(CommandType::Draw);
+        ASSERT_EQ(firstDraw, secondDraw);
+
+        CommandIterator iterator(std::move(allocator));
+        iterator.DataWasDestroyed();
+    }
+}
+
+// Test the size classes of the block pool
+TEST(CommandAllocator, BlockPoolSizeClasses) {
+    CommandBlockPool pool;
+
+    // Small requests are rounded up to the smallest size class.
+    BlockDef small = pool.AcquireBlock(1);
+    ASSERT_NE(small.block, nullptr);
+    ASSERT_EQ(small.size, CommandBlockPool::kMinBlockSize);
+
+    // Blocks bigger than the largest size class aren't rounded up.
+    BlockDef big = pool.AcquireBlock(CommandBlockPool::kMaxBlockSize + 1);
+    ASSERT_NE(big.block, nullptr);
+    ASSERT_EQ(big.size, CommandBlockPool::kMaxBlockSize + 1);
+
+    BlockDef medium = pool.AcquireBlock(CommandBlockPool::kMinBlockSize * 3);
+    ASSERT_NE(medium.block, nullptr);
+    ASSERT_EQ(medium.size, CommandBlockPool::kMinBlockSize * 4);
+
+    pool.ReleaseBlocks({small, big, medium});
+
+    // A free block of a bigger size class is used when there is none of the requested class.
+    BlockDef reused = pool.AcquireBlock(CommandBlockPool::kMinBlockSize * 2);
+    ASSERT_EQ(reused.block, medium.block);
+    ASSERT_EQ(reused.size, medium.size);
+
+    reused = pool.AcquireBlock(1);
+    ASSERT_EQ(reused.block, small.block);
+
+    // The pool frees the blocks it still has when it is destroyed.
+    pool.ReleaseBlocks({reused, medium});
+}
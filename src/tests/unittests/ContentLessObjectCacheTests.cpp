@@ -0,0 +1,123 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_native/ContentLessObjectCache.h"
+
+#include <memory>
+#include <vector>
+
+using namespace dawn_native;
+
+namespace {
+
+    struct CacheableObject {
+        CacheableObject(uint32_t value, size_t hash) : value(value), hash(hash) {
+        }
+
+        struct EqualityFunc {
+            bool operator()(const CacheableObject* a, const CacheableObject* b) const {
+                return a->value == b->value;
+            }
+        };
+
+        uint32_t value;
+        size_t hash;
+    };
+
+}  // anonymous namespace
+
+// Test that objects are found by content and erased by identity.
+TEST(ContentLessObjectCacheTests, FindInsertErase) {
+    ContentLessObjectCache<CacheableObject> cache;
+    EXPECT_TRUE(cache.Empty());
+
+    CacheableObject object(1, 42);
+    CacheableObject blueprint(1, 42);
+    EXPECT_EQ(cache.Find(&blueprint, blueprint.hash), nullptr);
+
+    cache.Insert(&object, object.hash);
+    EXPECT_FALSE(cache.Empty());
+    EXPECT_EQ(cache.Find(&blueprint, blueprint.hash), &object);
+
+    // An equal object which isn't in the cache isn't erased.
+    EXPECT_FALSE(cache.Erase(&blueprint, blueprint.hash));
+    EXPECT_TRUE(cache.Erase(&object, object.hash));
+    EXPECT_TRUE(cache.Empty());
+    EXPECT_EQ(cache.Find(&blueprint, blueprint.hash), nullptr);
+}
+
+// Test that the hashes are compared, objects with equal content but different hashes aren't found.
+TEST(ContentLessObjectCacheTests, HashIsCompared) {
+    ContentLessObjectCache<CacheableObject> cache;
+
+    CacheableObject object(1, 42);
+    cache.Insert(&object, object.hash);
+
+    CacheableObject blueprint(1, 43);
+    EXPECT_EQ(cache.Find(&blueprint, blueprint.hash), nullptr);
+
+    EXPECT_TRUE(cache.Erase(&object, object.hash));
+}
+
+// Test colliding hashes, the objects are told apart by their content and erasing any of them keeps
+// the others reachable.
+TEST(ContentLessObjectCacheTests, HashCollisions) {
+    constexpr uint32_t kObjectCount = 64;
+    ContentLessObjectCache<CacheableObject> cache;
+
+    std::vector<std::unique_ptr<CacheableObject>> objects;
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        objects.push_back(std::make_unique<CacheableObject>(i, i % 4));
+        cache.Insert(objects.back().get(), objects.back()->hash);
+    }
+    EXPECT_EQ(cache.Size(), kObjectCount);
+
+    for (uint32_t i = 0; i < kObjectCount; i += 3) {
+        EXPECT_TRUE(cache.Erase(objects[i].get(), objects[i]->hash));
+    }
+
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        CacheableObject blueprint(i, i % 4);
+        CacheableObject* expected = i % 3 == 0 ? nullptr : objects[i].get();
+        EXPECT_EQ(cache.Find(&blueprint, blueprint.hash), expected);
+    }
+}
+
+// Test that the objects stay reachable as the table grows and entries are erased in any order.
+TEST(ContentLessObjectCacheTests, GrowAndErase) {
+    constexpr uint32_t kObjectCount = 10000;
+    ContentLessObjectCache<CacheableObject> cache;
+
+    std::vector<std::unique_ptr<CacheableObject>> objects;
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        objects.push_back(std::make_unique<CacheableObject>(i, size_t(i) * 7919));
+        cache.Insert(objects.back().get(), objects.back()->hash);
+    }
+
+    for (uint32_t i = 0; i < kObjectCount; i += 2) {
+        EXPECT_TRUE(cache.Erase(objects[i].get(), objects[i]->hash));
+    }
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        CacheableObject blueprint(i, size_t(i) * 7919);
+        CacheableObject* expected = i % 2 == 0 ? nullptr : objects[i].get();
+        ASSERT_EQ(cache.Find(&blueprint, blueprint.hash), expected);
+    }
+
+    for (uint32_t i = kObjectCount - 1; i < kObjectCount; i -= 2) {
+        EXPECT_TRUE(cache.Erase(objects[i].get(), objects[i]->hash));
+    }
+    EXPECT_TRUE(cache.Empty());
+}
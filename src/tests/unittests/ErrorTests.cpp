@@ -295,4 +295,57 @@ TEST(ErrorTests, TRY_ConversionToErrorOrResultNonPointer) {
     ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
 }
 
+// Check string literal messages are returned as is.
+TEST(ErrorTests, Error_LiteralMessage) {
+    auto CreateError = []() -> MaybeError {
+        return DAWN_VALIDATION_ERROR("I am a literal error message");
+    };
+
+    MaybeError result = CreateError();
+    ASSERT_TRUE(result.IsError());
+
+    std::unique_ptr<ErrorData> errorData = result.AcquireError();
+    ASSERT_EQ(errorData->GetMessage(), "I am a literal error message");
+}
+
+// Check formatted messages are formatted with their arguments.
+TEST(ErrorTests, Error_FormattedMessage) {
+    auto CreateError = [](uint32_t index, uint64_t offset) -> MaybeError {
+        return DAWN_FORMAT_VALIDATION_ERROR("offset %u is %llu", index,
+                                            static_cast<unsigned long long>(offset));
+    };
+
+    MaybeError result = CreateError(3, 1234);
+    ASSERT_TRUE(result.IsError());
+
+    std::unique_ptr<ErrorData> errorData = result.AcquireError();
+    ASSERT_EQ(errorData->GetMessage(), "offset 3 is 1234");
+}
+
+// Check lazy messages are formatted once, only when the message is queried.
+TEST(ErrorTests, Error_LazyMessageFormattedOnce) {
+    class CountingMessage : public ErrorData::LazyMessage {
+      public:
+        CountingMessage(uint32_t* formatCount) : mFormatCount(formatCount) {
+        }
+        std::string Format() const override {
+            (*mFormatCount)++;
+            return dummyErrorMessage;
+        }
+
+      private:
+        uint32_t* mFormatCount;
+    };
+
+    uint32_t formatCount = 0;
+    std::unique_ptr<ErrorData> errorData =
+        ErrorData::Create(InternalErrorType::Validation,
+                          std::make_unique<CountingMessage>(&formatCount), "", "", 0);
+    ASSERT_EQ(formatCount, 0u);
+
+    ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+    ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+    ASSERT_EQ(formatCount, 1u);
+}
+
 }  // anonymous namespace
@@ -0,0 +1,166 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_platform/FileCachingInterface.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace dawn_platform;
+
+namespace {
+
+    constexpr char kFingerprint[] = "fingerprint";
+
+    class FileCachingInterfaceTests : public testing::Test {
+      protected:
+        void SetUp() override {
+            mPath = testing::TempDir() + "FileCachingInterfaceTests.dawncache";
+            remove(mPath.c_str());
+        }
+
+        void TearDown() override {
+            remove(mPath.c_str());
+        }
+
+        std::unique_ptr<FileCachingInterface> Open(const char* fingerprint = kFingerprint) {
+            return FileCachingInterface::Open(mPath.c_str(), fingerprint, strlen(fingerprint));
+        }
+
+        static void Store(FileCachingInterface* cache,
+                          const std::string& key,
+                          const std::string& value) {
+            cache->StoreData(key.data(), key.size(), value.data(), value.size());
+        }
+
+        static std::string Load(FileCachingInterface* cache, const std::string& key) {
+            size_t size = cache->LoadData(key.data(), key.size(), nullptr, 0);
+            std::string value(size, '\0');
+            if (size == 0 || cache->LoadData(key.data(), key.size(), &value[0], size) != size) {
+                return "";
+            }
+            return value;
+        }
+
+        std::string mPath;
+    };
+
+}  // anonymous namespace
+
+// Test that the stored values are loaded back, and that missing keys miss.
+TEST_F(FileCachingInterfaceTests, StoreAndLoad) {
+    std::unique_ptr<FileCachingInterface> cache = Open();
+    ASSERT_NE(cache, nullptr);
+
+    Store(cache.get(), "key1", "value1");
+    Store(cache.get(), "key2", "a longer value2");
+    EXPECT_EQ(cache->GetEntryCount(), 2u);
+    EXPECT_EQ(Load(cache.get(), "key1"), "value1");
+    EXPECT_EQ(Load(cache.get(), "key2"), "a longer value2");
+    EXPECT_EQ(Load(cache.get(), "key3"), "");
+
+    // The value is only copied when the destination is large enough.
+    char small[2];
+    EXPECT_EQ(cache->LoadData("key1", 4, small, sizeof(small)), 6u);
+}
+
+// Test that the entries persist when the file is opened again.
+TEST_F(FileCachingInterfaceTests, Persists) {
+    {
+        std::unique_ptr<FileCachingInterface> cache = Open();
+        ASSERT_NE(cache, nullptr);
+        Store(cache.get(), "key", "value");
+    }
+
+    std::unique_ptr<FileCachingInterface> cache = Open();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetEntryCount(), 1u);
+    EXPECT_EQ(Load(cache.get(), "key"), "value");
+}
+
+// Test that the entries of another fingerprint are discarded.
+TEST_F(FileCachingInterfaceTests, OtherFingerprint) {
+    {
+        std::unique_ptr<FileCachingInterface> cache = Open();
+        ASSERT_NE(cache, nullptr);
+        Store(cache.get(), "key", "value");
+    }
+
+    std::unique_ptr<FileCachingInterface> cache = Open("other");
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetEntryCount(), 0u);
+    EXPECT_EQ(Load(cache.get(), "key"), "");
+}
+
+// Test that replacing a value keeps a single entry and that compaction drops the old value.
+TEST_F(FileCachingInterfaceTests, ReplaceAndCompact) {
+    std::unique_ptr<FileCachingInterface> cache = Open();
+    ASSERT_NE(cache, nullptr);
+
+    Store(cache.get(), "key", std::string(1000, 'a'));
+    Store(cache.get(), "key", std::string(1000, 'b'));
+    EXPECT_EQ(cache->GetEntryCount(), 1u);
+    EXPECT_EQ(Load(cache.get(), "key"), std::string(1000, 'b'));
+
+    uint64_t size = cache->GetFileSize();
+    EXPECT_TRUE(cache->Compact());
+    EXPECT_LT(cache->GetFileSize(), size);
+    EXPECT_EQ(Load(cache.get(), "key"), std::string(1000, 'b'));
+}
+
+// Test that the index grows when many entries are stored.
+TEST_F(FileCachingInterfaceTests, IndexGrows) {
+    std::unique_ptr<FileCachingInterface> cache = Open();
+    ASSERT_NE(cache, nullptr);
+
+    constexpr uint32_t kEntryCount = 5000;
+    for (uint32_t i = 0; i < kEntryCount; ++i) {
+        Store(cache.get(), "key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    EXPECT_EQ(cache->GetEntryCount(), kEntryCount);
+    for (uint32_t i = 0; i < kEntryCount; ++i) {
+        EXPECT_EQ(Load(cache.get(), "key" + std::to_string(i)), "value" + std::to_string(i));
+    }
+}
+
+// Test that a record damaged on disk is a miss rather than returning corrupted data.
+TEST_F(FileCachingInterfaceTests, DamagedRecord) {
+    std::string value(64, 'v');
+    {
+        std::unique_ptr<FileCachingInterface> cache = Open();
+        ASSERT_NE(cache, nullptr);
+        Store(cache.get(), "key", value);
+    }
+
+    {
+        std::fstream file(mPath, std::ios::in | std::ios::out | std::ios::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+        std::string contentString(content.begin(), content.end());
+        size_t valueOffset = contentString.find(value);
+        ASSERT_NE(valueOffset, std::string::npos);
+        file.clear();
+        file.seekp(valueOffset);
+        file.put('x');
+    }
+
+    std::unique_ptr<FileCachingInterface> cache = Open();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(Load(cache.get(), "key"), "");
+}
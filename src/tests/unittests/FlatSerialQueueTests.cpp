@@ -0,0 +1,202 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/FlatSerialQueue.h"
+
+#include <memory>
+
+using TestSerialQueue = FlatSerialQueue<int>;
+
+// A number of basic tests for FlatSerialQueue that are difficult to split from one another
+TEST(FlatSerialQueue, BasicTest) {
+    TestSerialQueue queue;
+
+    // Queue starts empty
+    ASSERT_TRUE(queue.Empty());
+
+    // Iterating on empty queue 1) works 2) doesn't produce any values
+    for (int value : queue.IterateAll()) {
+        DAWN_UNUSED(value);
+        ASSERT_TRUE(false);
+    }
+
+    // Enqueuing values as const ref or rvalue ref
+    queue.Enqueue(1, 0);
+    queue.Enqueue(2, 0);
+    queue.Enqueue(std::move(3), 1);
+
+    // Iterating over a non-empty queue produces the expected result
+    std::vector<int> expectedValues = {1, 2, 3};
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+
+    // Clear works and makes the queue empty and iteration does nothing.
+    queue.Clear();
+    ASSERT_TRUE(queue.Empty());
+
+    for (int value : queue.IterateAll()) {
+        DAWN_UNUSED(value);
+        ASSERT_TRUE(false);
+    }
+}
+
+// Test enqueuing vectors works
+TEST(FlatSerialQueue, EnqueueVectors) {
+    TestSerialQueue queue;
+
+    std::vector<int> vector1 = {1, 2, 3, 4};
+    std::vector<int> vector2 = {5, 6, 7, 8};
+    std::vector<int> vector3 = {9, 0};
+
+    queue.Enqueue(vector1, 0);
+    queue.Enqueue(std::move(vector2), 0);
+    queue.Enqueue(vector3, 1);
+
+    std::vector<int> expectedValues = {1, 2, 3, 4, 5, 6, 7, 8, 9, 0};
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+}
+
+// Test IterateUpTo
+TEST(FlatSerialQueue, IterateUpTo) {
+    TestSerialQueue queue;
+
+    std::vector<int> vector1 = {1, 2, 3, 4};
+    std::vector<int> vector2 = {5, 6, 7, 8};
+    std::vector<int> vector3 = {9, 0};
+
+    queue.Enqueue(vector1, 0);
+    queue.Enqueue(std::move(vector2), 1);
+    queue.Enqueue(vector3, 2);
+
+    std::vector<int> expectedValues = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (int value : queue.IterateUpTo(1)) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+    EXPECT_EQ(queue.LastSerial(), 2u);
+}
+
+// Test ClearUpTo
+TEST(FlatSerialQueue, ClearUpTo) {
+    TestSerialQueue queue;
+
+    std::vector<int> vector1 = {1, 2, 3, 4};
+    std::vector<int> vector2 = {5, 6, 7, 8};
+    std::vector<int> vector3 = {9, 0};
+
+    queue.Enqueue(vector1, 0);
+    queue.Enqueue(std::move(vector2), 0);
+    queue.Enqueue(vector3, 1);
+
+    queue.ClearUpTo(0);
+    EXPECT_EQ(queue.LastSerial(), 1u);
+
+    std::vector<int> expectedValues = {9, 0};
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+}
+
+// Test FirstSerial
+TEST(FlatSerialQueue, FirstSerial) {
+    TestSerialQueue queue;
+
+    std::vector<int> vector1 = {1, 2, 3, 4};
+    std::vector<int> vector2 = {5, 6, 7, 8};
+    std::vector<int> vector3 = {9, 0};
+
+    queue.Enqueue(vector1, 0);
+    queue.Enqueue(std::move(vector2), 1);
+    queue.Enqueue(vector3, 2);
+
+    EXPECT_EQ(queue.FirstSerial(), 0u);
+
+    queue.ClearUpTo(1);
+    EXPECT_EQ(queue.FirstSerial(), 2u);
+
+    queue.Clear();
+    queue.Enqueue(vector1, 6);
+    EXPECT_EQ(queue.FirstSerial(), 6u);
+}
+
+// Test LastSerial
+TEST(FlatSerialQueue, LastSerial) {
+    TestSerialQueue queue;
+
+    queue.Enqueue({1}, 0);
+    EXPECT_EQ(queue.LastSerial(), 0u);
+
+    queue.Enqueue({2}, 1);
+    EXPECT_EQ(queue.LastSerial(), 1u);
+}
+// Test that values stay in order when the ring buffer wraps around and grows
+TEST(FlatSerialQueue, WrapAround) {
+    TestSerialQueue queue;
+
+    int nextValue = 0;
+    int nextExpectedValue = 0;
+    for (Serial serial = 0; serial < 20; ++serial) {
+        // Enqueue more values than are cleared so that the buffer grows while it is wrapped.
+        for (Serial i = 0; i < serial % 5; ++i) {
+            queue.Enqueue(nextValue++, serial);
+        }
+        if (serial % 2 == 0 || queue.Empty()) {
+            continue;
+        }
+
+        Serial clearedSerial = queue.FirstSerial();
+        for (int value : queue.IterateUpTo(clearedSerial)) {
+            EXPECT_EQ(nextExpectedValue++, value);
+        }
+        queue.ClearUpTo(clearedSerial);
+        ASSERT_TRUE(queue.Empty() || queue.FirstSerial() > clearedSerial);
+    }
+
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(nextExpectedValue++, value);
+    }
+    EXPECT_EQ(nextValue, nextExpectedValue);
+}
+
+// Test that the values are destroyed when they are cleared
+TEST(FlatSerialQueue, ClearReleasesValues) {
+    FlatSerialQueue<std::shared_ptr<int>> queue;
+    std::shared_ptr<int> value = std::make_shared<int>(42);
+
+    queue.Enqueue(value, 0);
+    queue.Enqueue(value, 1);
+    EXPECT_EQ(value.use_count(), 3);
+
+    queue.ClearUpTo(0);
+    EXPECT_EQ(value.use_count(), 2);
+
+    queue.Clear();
+    EXPECT_EQ(value.use_count(), 1);
+}
@@ -0,0 +1,120 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/MagazineAllocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    class Base : public MagazineAllocated {
+      public:
+        virtual ~Base() = default;
+        uint32_t value = 0;
+    };
+
+    class Derived : public Base {
+      public:
+        char data[200];
+    };
+
+}  // anonymous namespace
+
+// Test that allocations of every size are aligned, writable and don't overlap.
+TEST(MagazineAllocatorTests, AllocationsAreDistinctAndAligned) {
+    std::vector<std::pair<void*, size_t>> allocations;
+    for (size_t size = 1; size <= kMaxMagazineAllocationSize + 64; size += 7) {
+        void* ptr = MagazineAllocate(size);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0u);
+        memset(ptr, static_cast<int>(size), size);
+        allocations.push_back({ptr, size});
+    }
+
+    for (const auto& allocation : allocations) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(allocation.first);
+        for (size_t i = 0; i < allocation.second; ++i) {
+            ASSERT_EQ(bytes[i], static_cast<uint8_t>(allocation.second));
+        }
+        MagazineDeallocate(allocation.first, allocation.second);
+    }
+}
+
+// Test that freed blocks are reused by the following allocations of the same size class.
+TEST(MagazineAllocatorTests, BlocksAreReused) {
+    void* ptr = MagazineAllocate(100);
+    MagazineDeallocate(ptr, 100);
+    void* reused = MagazineAllocate(110);
+    EXPECT_EQ(ptr, reused);
+    MagazineDeallocate(reused, 110);
+}
+
+// Test many allocations, overflowing the magazines in both directions.
+TEST(MagazineAllocatorTests, ManyAllocations) {
+    std::set<void*> allocations;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(allocations.insert(MagazineAllocate(48)).second);
+    }
+    for (void* ptr : allocations) {
+        MagazineDeallocate(ptr, 48);
+    }
+}
+
+// Test that objects can be deallocated on another thread than the one which allocated them.
+TEST(MagazineAllocatorTests, CrossThreadDeallocation) {
+    std::vector<void*> allocations;
+    std::thread allocator([&allocations]() {
+        for (uint32_t i = 0; i < 1000; ++i) {
+            allocations.push_back(MagazineAllocate(64));
+        }
+    });
+    allocator.join();
+
+    std::thread deallocator([&allocations]() {
+        for (void* ptr : allocations) {
+            MagazineDeallocate(ptr, 64);
+        }
+    });
+    deallocator.join();
+
+    // The blocks returned when the deallocating thread exited can be allocated again.
+    std::set<void*> reallocations;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        void* ptr = MagazineAllocate(64);
+        EXPECT_TRUE(reallocations.insert(ptr).second);
+    }
+    for (void* ptr : reallocations) {
+        MagazineDeallocate(ptr, 64);
+    }
+}
+
+// Test that objects of derived classes are deleted with the size of their dynamic type.
+TEST(MagazineAllocatorTests, MagazineAllocatedClasses) {
+    std::vector<Base*> objects;
+    for (uint32_t i = 0; i < 100; ++i) {
+        Base* object = i % 2 == 0 ? new Base() : new Derived();
+        object->value = i;
+        objects.push_back(object);
+    }
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(objects[i]->value, i);
+        delete objects[i];
+    }
+}
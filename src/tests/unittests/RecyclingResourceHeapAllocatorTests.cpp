@@ -0,0 +1,112 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_native/RecyclingResourceHeapAllocator.h"
+
+using namespace dawn_native;
+
+namespace {
+
+    class CountingResourceHeapAllocator : public ResourceHeapAllocator {
+      public:
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size) override {
+            mHeapCount++;
+            return std::make_unique<ResourceHeapBase>();
+        }
+        void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
+            mHeapCount--;
+        }
+
+        uint64_t GetHeapCount() const {
+            return mHeapCount;
+        }
+
+      private:
+        uint64_t mHeapCount = 0;
+    };
+
+    constexpr uint64_t kHeapSize = 1024;
+
+    ResourceHeapBase* AllocateHeap(RecyclingResourceHeapAllocator* allocator) {
+        return allocator->AllocateResourceHeap(kHeapSize).AcquireSuccess().release();
+    }
+
+    void DeallocateHeap(RecyclingResourceHeapAllocator* allocator, ResourceHeapBase* heap) {
+        allocator->DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase>(heap));
+    }
+
+}  // anonymous namespace
+
+// Verify the heaps given back are handed out again instead of creating new ones.
+TEST(RecyclingResourceHeapAllocatorTests, ReusesHeaps) {
+    CountingResourceHeapAllocator heapAllocator;
+    RecyclingResourceHeapAllocator allocator(kHeapSize, &heapAllocator);
+
+    ResourceHeapBase* heap1 = AllocateHeap(&allocator);
+    ResourceHeapBase* heap2 = AllocateHeap(&allocator);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 2u);
+
+    DeallocateHeap(&allocator, heap1);
+    DeallocateHeap(&allocator, heap2);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 2u);
+    EXPECT_EQ(allocator.GetRecycledHeapCountForTesting(), 2u);
+
+    // The most recently recycled heap is reused first.
+    EXPECT_EQ(AllocateHeap(&allocator), heap2);
+    EXPECT_EQ(AllocateHeap(&allocator), heap1);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 2u);
+    EXPECT_EQ(allocator.GetRecycledHeapCountForTesting(), 0u);
+
+    DeallocateHeap(&allocator, heap1);
+    DeallocateHeap(&allocator, heap2);
+}
+
+// Verify heaps are released once they stayed unused for kRetainedSerials serials.
+TEST(RecyclingResourceHeapAllocatorTests, ReleasesUnusedHeaps) {
+    CountingResourceHeapAllocator heapAllocator;
+    RecyclingResourceHeapAllocator allocator(kHeapSize, &heapAllocator);
+
+    ResourceHeapBase* heap1 = AllocateHeap(&allocator);
+    ResourceHeapBase* heap2 = AllocateHeap(&allocator);
+    DeallocateHeap(&allocator, heap1);
+
+    allocator.Tick(1);
+    DeallocateHeap(&allocator, heap2);
+
+    allocator.Tick(RecyclingResourceHeapAllocator::kRetainedSerials - 1);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 2u);
+
+    // Only the heap recycled before the first tick is old enough.
+    allocator.Tick(RecyclingResourceHeapAllocator::kRetainedSerials);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 1u);
+    EXPECT_EQ(allocator.GetRecycledHeapCountForTesting(), 1u);
+
+    allocator.Tick(RecyclingResourceHeapAllocator::kRetainedSerials + 1);
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 0u);
+    EXPECT_EQ(allocator.GetRecycledHeapCountForTesting(), 0u);
+}
+
+// Verify the recycled heaps are released when the allocator is destroyed.
+TEST(RecyclingResourceHeapAllocatorTests, ReleasesHeapsOnDestruction) {
+    CountingResourceHeapAllocator heapAllocator;
+    {
+        RecyclingResourceHeapAllocator allocator(kHeapSize, &heapAllocator);
+        DeallocateHeap(&allocator, AllocateHeap(&allocator));
+        EXPECT_EQ(heapAllocator.GetHeapCount(), 1u);
+    }
+    EXPECT_EQ(heapAllocator.GetHeapCount(), 0u);
+}
@@ -29,6 +29,10 @@ struct RCTest : public RefCounted {
     RCTest(bool* deleted) : deleted(deleted) {
     }
 
+    RCTest(uint64_t payload, bool singleThreaded, bool* deleted)
+        : RefCounted(payload, singleThreaded), deleted(deleted) {
+    }
+
     ~RCTest() override {
         if (deleted != nullptr) {
             *deleted = true;
@@ -42,6 +46,15 @@ struct RCTest : public RefCounted {
     bool* deleted = nullptr;
 };
 
+// Doesn't delete itself when the last reference is released, so the refcount can be checked.
+struct RCDeferredDeleteTest : public RefCounted {
+    void DeleteThis() override {
+        lastReferenceReleased = true;
+    }
+
+    bool lastReferenceReleased = false;
+};
+
 // Test that RCs start with one ref, and removing it destroys the object.
 TEST(RefCounted, StartsWithOneRef) {
     bool deleted = false;
@@ -64,6 +77,23 @@ TEST(RefCounted, AddingRefKeepsAlive) {
     ASSERT_TRUE(deleted);
 }
 
+// Test that TryReference adds a reference unless the last one was released.
+TEST(RefCounted, TryReference) {
+    auto* test = new RCDeferredDeleteTest();
+
+    ASSERT_TRUE(test->TryReference());
+    ASSERT_EQ(test->GetRefCountForTesting(), 2u);
+
+    test->Release();
+    test->Release();
+    ASSERT_TRUE(test->lastReferenceReleased);
+
+    ASSERT_FALSE(test->TryReference());
+    ASSERT_EQ(test->GetRefCountForTesting(), 0u);
+
+    delete test;
+}
+
 // Test that Reference and Release atomically change the refcount.
 TEST(RefCounted, RaceOnReferenceRelease) {
     bool deleted = false;
@@ -238,3 +268,34 @@ TEST(Ref, PayloadUnchangedByRefCounting) {
 
     test->Release();
 }
+
+// Test that single-threaded objects are refcounted like the others.
+TEST(RefCounted, SingleThreaded) {
+    bool deleted = false;
+    RCTest* test = new RCTest(1ull, true, &deleted);
+    ASSERT_TRUE(test->IsSingleThreaded());
+    ASSERT_EQ(test->GetRefCountForTesting(), 1u);
+    ASSERT_EQ(test->GetRefCountPayload(), 1u);
+
+    test->Reference();
+    ASSERT_EQ(test->GetRefCountForTesting(), 2u);
+    ASSERT_TRUE(test->TryReference());
+    ASSERT_EQ(test->GetRefCountForTesting(), 3u);
+
+    test->Release();
+    test->Release();
+    ASSERT_TRUE(test->HasOneRef());
+    ASSERT_EQ(test->GetRefCountPayload(), 1u);
+    ASSERT_TRUE(test->IsSingleThreaded());
+    ASSERT_FALSE(deleted);
+
+    test->Release();
+    ASSERT_TRUE(deleted);
+}
+
+// Test that objects are multi-threaded by default.
+TEST(RefCounted, MultiThreadedByDefault) {
+    RCTest* test = new RCTest(1ull);
+    ASSERT_FALSE(test->IsSingleThreaded());
+    test->Release();
+}
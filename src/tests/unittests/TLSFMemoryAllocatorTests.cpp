@@ -0,0 +1,207 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_native/ResourceHeapAllocator.h"
+#include "dawn_native/TLSFMemoryAllocator.h"
+
+using namespace dawn_native;
+
+namespace {
+
+    class DummyResourceHeapAllocator : public ResourceHeapAllocator {
+      public:
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size) override {
+            return std::make_unique<ResourceHeapBase>();
+        }
+        void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
+        }
+    };
+
+    class DummyTLSFResourceAllocator {
+      public:
+        DummyTLSFResourceAllocator(uint64_t heapSize, uint64_t blockGranularity)
+            : mAllocator(heapSize, blockGranularity, &mHeapAllocator) {
+        }
+
+        ResourceMemoryAllocation Allocate(
+            uint64_t allocationSize,
+            uint64_t alignment = 1,
+            uint64_t excludedHeapIndex = TLSFMemoryAllocator::kInvalidHeapIndex) {
+            ResultOrError<ResourceMemoryAllocation> result =
+                mAllocator.Allocate(allocationSize, alignment, excludedHeapIndex);
+            return (result.IsSuccess()) ? result.AcquireSuccess() : ResourceMemoryAllocation{};
+        }
+
+        void Deallocate(ResourceMemoryAllocation& allocation) {
+            mAllocator.Deallocate(allocation);
+        }
+
+        TLSFMemoryAllocator* operator->() {
+            return &mAllocator;
+        }
+
+      private:
+        DummyResourceHeapAllocator mHeapAllocator;
+        TLSFMemoryAllocator mAllocator;
+    };
+
+}  // anonymous namespace
+
+// Verify allocations are packed without rounding their size up to a power of two.
+TEST(TLSFMemoryAllocatorTests, PacksNonPowerOfTwoSizes) {
+    constexpr uint64_t kHeapSize = 1024;
+    DummyTLSFResourceAllocator allocator(kHeapSize, 16);
+
+    // Cannot allocate greater than heap size.
+    ResourceMemoryAllocation invalidAllocation = allocator.Allocate(kHeapSize + 1);
+    ASSERT_EQ(invalidAllocation.GetInfo().mMethod, AllocationMethod::kInvalid);
+
+    // Three allocations of 320 bytes would need three heaps with a buddy allocator.
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(320);
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(320);
+    ResourceMemoryAllocation allocation3 = allocator.Allocate(320);
+    ASSERT_EQ(allocation1.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    ASSERT_EQ(allocation2.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    ASSERT_EQ(allocation3.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 1u);
+    EXPECT_EQ(allocator->GetUsedSize(), 960u);
+    EXPECT_EQ(allocation1.GetResourceHeap(), allocation3.GetResourceHeap());
+
+    allocator.Deallocate(allocation1);
+    allocator.Deallocate(allocation2);
+    allocator.Deallocate(allocation3);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 0u);
+    EXPECT_EQ(allocator->GetUsedSize(), 0u);
+}
+
+// Verify sizes are rounded up to the granularity and offsets are aligned.
+TEST(TLSFMemoryAllocatorTests, GranularityAndAlignment) {
+    constexpr uint64_t kHeapSize = 4096;
+    DummyTLSFResourceAllocator allocator(kHeapSize, 64);
+
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(1);
+    EXPECT_EQ(allocation1.GetOffset(), 0u);
+    EXPECT_EQ(allocator->GetUsedSize(), 64u);
+
+    // The next 1024 byte aligned offset is 1024, the padding before it stays free.
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(100, 1024);
+    EXPECT_EQ(allocation2.GetOffset(), 1024u);
+    EXPECT_EQ(allocator->GetUsedSize(), 64u + 128u);
+
+    ResourceMemoryAllocation allocation3 = allocator.Allocate(64);
+    EXPECT_EQ(allocation3.GetOffset() % 64, 0u);
+    EXPECT_LT(allocation3.GetOffset(), 1024u);
+
+    allocator.Deallocate(allocation1);
+    allocator.Deallocate(allocation2);
+    allocator.Deallocate(allocation3);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 0u);
+}
+
+// Verify free neighbors are coalesced so that a large allocation fits after small ones are freed.
+TEST(TLSFMemoryAllocatorTests, CoalescesFreeBlocks) {
+    constexpr uint64_t kHeapSize = 1024;
+    DummyTLSFResourceAllocator allocator(kHeapSize, 16);
+
+    std::vector<ResourceMemoryAllocation> allocations;
+    for (uint32_t i = 0; i < 8; ++i) {
+        allocations.push_back(allocator.Allocate(128));
+    }
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 1u);
+
+    // Free every block but the last, alternating to exercise both neighbors.
+    for (uint32_t i = 0; i < 7; i += 2) {
+        allocator.Deallocate(allocations[i]);
+    }
+    for (uint32_t i = 1; i < 7; i += 2) {
+        allocator.Deallocate(allocations[i]);
+    }
+
+    // 896 bytes are free and contiguous at the start of the heap.
+    ResourceMemoryAllocation large = allocator.Allocate(896);
+    ASSERT_EQ(large.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    EXPECT_EQ(large.GetOffset(), 0u);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 1u);
+
+    allocator.Deallocate(large);
+    allocator.Deallocate(allocations[7]);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 0u);
+}
+
+// Verify heaps are created when full and that the sparse ones are defragmentation candidates.
+TEST(TLSFMemoryAllocatorTests, DefragmentationCandidate) {
+    constexpr uint64_t kHeapSize = 1024;
+    DummyTLSFResourceAllocator allocator(kHeapSize, 16);
+
+    // A single heap is never a candidate.
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(512);
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(384);
+    EXPECT_EQ(allocator->GetDefragmentationCandidate(), TLSFMemoryAllocator::kInvalidHeapIndex);
+
+    // The first heap is too full for these, so they go in a second heap.
+    ResourceMemoryAllocation allocation3 = allocator.Allocate(512);
+    ResourceMemoryAllocation allocation4 = allocator.Allocate(256);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 2u);
+    EXPECT_NE(allocator->GetHeapIndex(allocation1), allocator->GetHeapIndex(allocation4));
+
+    // Once the second heap is sparse and the first heap has room, the second heap is the
+    // candidate.
+    allocator.Deallocate(allocation3);
+    EXPECT_EQ(allocator->GetDefragmentationCandidate(), TLSFMemoryAllocator::kInvalidHeapIndex);
+    allocator.Deallocate(allocation2);
+
+    const uint64_t candidate = allocator->GetDefragmentationCandidate();
+    ASSERT_NE(candidate, TLSFMemoryAllocator::kInvalidHeapIndex);
+    EXPECT_EQ(allocator->GetHeapIndex(allocation4), candidate);
+
+    // Relocating the allocation out of the candidate releases it.
+    ResourceMemoryAllocation relocated = allocator.Allocate(256, 1, candidate);
+    ASSERT_EQ(relocated.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    EXPECT_NE(allocator->GetHeapIndex(relocated), candidate);
+    allocator.Deallocate(allocation4);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 1u);
+
+    // Allocations excluding the only heap don't create new heaps.
+    ResourceMemoryAllocation invalidAllocation =
+        allocator.Allocate(512, 1, allocator->GetHeapIndex(relocated));
+    EXPECT_EQ(invalidAllocation.GetInfo().mMethod, AllocationMethod::kInvalid);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 1u);
+
+    allocator.Deallocate(allocation1);
+    allocator.Deallocate(relocated);
+    EXPECT_EQ(allocator->ComputeTotalNumOfHeapsForTesting(), 0u);
+}
+
+// Verify the allocated heap size counts the heaps until their last allocation is freed.
+TEST(TLSFMemoryAllocatorTests, AllocatedHeapSize) {
+    constexpr uint64_t kHeapSize = 1024;
+    DummyTLSFResourceAllocator allocator(kHeapSize, 16);
+    EXPECT_EQ(allocator->GetAllocatedHeapSize(), 0u);
+
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(1000);
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(100);
+    EXPECT_EQ(allocation2.GetInfo().mRequestedSize, 100u);
+    EXPECT_EQ(allocator->GetAllocatedHeapSize(), 2 * kHeapSize);
+    EXPECT_EQ(allocator->GetUsedSize(), 1008u + 112u);
+
+    allocator.Deallocate(allocation1);
+    EXPECT_EQ(allocator->GetAllocatedHeapSize(), kHeapSize);
+
+    allocator.Deallocate(allocation2);
+    EXPECT_EQ(allocator->GetAllocatedHeapSize(), 0u);
+}
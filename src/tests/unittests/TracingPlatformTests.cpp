@@ -0,0 +1,115 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_platform/TracingPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
+
+#include <thread>
+
+using namespace dawn_platform;
+
+namespace {
+
+    size_t CountOccurences(const std::string& str, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t pos = str.find(pattern); pos != std::string::npos;
+             pos = str.find(pattern, pos + pattern.size())) {
+            count++;
+        }
+        return count;
+    }
+
+    class TracingPlatformTests : public testing::Test {
+      protected:
+        void TearDown() override {
+            platform.EnableAllCategories(false);
+        }
+
+        TracingPlatform platform{8};
+    };
+
+}  // anonymous namespace
+
+// Test that scoped events are recorded as begin and end events.
+TEST_F(TracingPlatformTests, ScopedEvent) {
+    platform.EnableAllCategories(true);
+    { TRACE_EVENT0(&platform, General, "ScopedEvent"); }
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "\"name\":\"ScopedEvent\""), 2u);
+    EXPECT_EQ(CountOccurences(json, "\"ph\":\"B\""), 1u);
+    EXPECT_EQ(CountOccurences(json, "\"ph\":\"E\""), 1u);
+    EXPECT_EQ(CountOccurences(json, "\"cat\":\"General\""), 2u);
+}
+
+// Test that only the events of the enabled categories are recorded.
+TEST_F(TracingPlatformTests, CategoryFiltering) {
+    platform.EnableCategory(TraceCategory::Validation, true);
+    { TRACE_EVENT0(&platform, General, "GeneralEvent"); }
+    { TRACE_EVENT0(&platform, Validation, "ValidationEvent"); }
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "GeneralEvent"), 0u);
+    EXPECT_EQ(CountOccurences(json, "ValidationEvent"), 2u);
+}
+
+// Test that arguments are written out.
+TEST_F(TracingPlatformTests, Arguments) {
+    platform.EnableAllCategories(true);
+    TRACE_EVENT_INSTANT1(&platform, General, "InstantEvent", "count", 42u);
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "\"args\":{\"count\":42}"), 1u);
+}
+
+// Test that full rings drop their oldest events and that the scopes stay balanced.
+TEST_F(TracingPlatformTests, RingWrapsAround) {
+    platform.EnableAllCategories(true);
+    {
+        TRACE_EVENT0(&platform, General, "OuterEvent");
+        for (uint32_t i = 0; i < 16; ++i) {
+            TRACE_EVENT0(&platform, General, "InnerEvent");
+        }
+    }
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "OuterEvent"), 0u);
+    EXPECT_EQ(CountOccurences(json, "\"ph\":\"B\""), CountOccurences(json, "\"ph\":\"E\""));
+    EXPECT_LE(CountOccurences(json, "InnerEvent"), 8u);
+}
+
+// Test that each thread records its events in its own ring.
+TEST_F(TracingPlatformTests, PerThreadRings) {
+    platform.EnableAllCategories(true);
+    { TRACE_EVENT0(&platform, General, "MainThreadEvent"); }
+    std::thread thread([this]() { TRACE_EVENT0(&platform, General, "OtherThreadEvent"); });
+    thread.join();
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "\"name\":\"thread_name\""), 2u);
+    EXPECT_EQ(CountOccurences(json, "MainThreadEvent"), 2u);
+    EXPECT_EQ(CountOccurences(json, "OtherThreadEvent"), 2u);
+}
+
+// Test that clearing the events drops all the recorded events.
+TEST_F(TracingPlatformTests, ClearEvents) {
+    platform.EnableAllCategories(true);
+    { TRACE_EVENT0(&platform, General, "ClearedEvent"); }
+    platform.ClearEvents();
+
+    std::string json = platform.GetChromeTraceJSON();
+    EXPECT_EQ(CountOccurences(json, "ClearedEvent"), 0u);
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/WorkerThreadPool.h"
+
+#include <atomic>
+#include <vector>
+
+// Test that every task runs exactly once, with and without worker threads.
+TEST(WorkerThreadPoolTests, RunsEachTaskOnce) {
+    for (uint32_t threadCount : {0u, 1u, 4u}) {
+        WorkerThreadPool pool(threadCount);
+        ASSERT_EQ(pool.GetThreadCount(), threadCount);
+
+        std::vector<std::atomic<uint32_t>> runCounts(100);
+        for (std::atomic<uint32_t>& runCount : runCounts) {
+            runCount = 0;
+        }
+
+        pool.ParallelFor(static_cast<uint32_t>(runCounts.size()),
+                         [&](uint32_t i) { runCounts[i]++; });
+
+        for (const std::atomic<uint32_t>& runCount : runCounts) {
+            ASSERT_EQ(runCount.load(), 1u);
+        }
+    }
+}
+
+// Test that the pool can be reused after a ParallelFor returned.
+TEST(WorkerThreadPoolTests, Reuse) {
+    WorkerThreadPool pool(3);
+
+    std::atomic<uint32_t> sum(0);
+    for (uint32_t i = 0; i < 50; ++i) {
+        pool.ParallelFor(i, [&](uint32_t task) { sum += task + 1; });
+    }
+
+    // The sum of (1 + ... + i) for i in [0, 50).
+    uint32_t expectedSum = 0;
+    for (uint32_t i = 0; i < 50; ++i) {
+        expectedSum += i * (i + 1) / 2;
+    }
+    ASSERT_EQ(sum.load(), expectedSum);
+}
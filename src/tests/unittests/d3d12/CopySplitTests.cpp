@@ -453,3 +453,21 @@ TEST_F(CopySplitTest, ImageHeight) {
         }
     }
 }
+
+// Test that 2D copies whose rows straddle the row pitch at the closest aligned placement are
+// placed further back in the buffer so that they need a single copy region.
+TEST_F(CopySplitTest, UnalignedOffsetSingleRegion) {
+    // The row pitch is 768 bytes: placements 512 bytes further back shift the start of the copy
+    // by 256 bytes in the rows of the footprint.
+    TextureSpec textureSpec = {0, 0, 0, 128, 4, 1, 4};
+    BufferSpec bufferSpec = {4 * 768 + 256 + 64, 768, 4};
+
+    TextureCopySplit copySplit = DoTest(textureSpec, bufferSpec);
+    if (HasFatalFailure()) {
+        std::ostringstream message;
+        message << "Failed generating splits: " << textureSpec << ", " << bufferSpec << std::endl
+                << copySplit << std::endl;
+        FAIL() << message.str();
+    }
+    ASSERT_EQ(copySplit.count, 1u);
+}
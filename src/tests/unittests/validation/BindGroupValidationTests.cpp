@@ -688,6 +688,42 @@ TEST_F(BindGroupLayoutValidationTest, DynamicBufferNumberLimit) {
     }
 }
 
+// Check that push descriptor layouts can't have dynamic buffers.
+TEST_F(BindGroupLayoutValidationTest, PushDescriptorsAndDynamicBuffers) {
+    wgpu::BindGroupLayoutBinding binding = {0, wgpu::ShaderStage::Compute,
+                                            wgpu::BindingType::UniformBuffer};
+    wgpu::BindGroupLayoutDescriptor descriptor;
+    descriptor.bindingCount = 1;
+    descriptor.bindings = &binding;
+    descriptor.pushDescriptors = true;
+
+    // Success case, the buffer isn't dynamic.
+    device.CreateBindGroupLayout(&descriptor);
+
+    // Error case, the buffer is dynamic.
+    binding.hasDynamicOffset = true;
+    ASSERT_DEVICE_ERROR(device.CreateBindGroupLayout(&descriptor));
+}
+
+// Check that a pipeline layout can have at most one push descriptor layout.
+TEST_F(BindGroupLayoutValidationTest, PushDescriptorLayoutsPerPipelineLayout) {
+    wgpu::BindGroupLayoutBinding binding = {0, wgpu::ShaderStage::Compute,
+                                            wgpu::BindingType::Sampler};
+    wgpu::BindGroupLayoutDescriptor descriptor;
+    descriptor.bindingCount = 1;
+    descriptor.bindings = &binding;
+
+    wgpu::BindGroupLayout bgl[2];
+    bgl[0] = device.CreateBindGroupLayout(&descriptor);
+
+    descriptor.pushDescriptors = true;
+    bgl[1] = device.CreateBindGroupLayout(&descriptor);
+    TestCreatePipelineLayout(bgl, 2, true);
+
+    bgl[0] = bgl[1];
+    TestCreatePipelineLayout(bgl, 2, false);
+}
+
 constexpr uint64_t kBufferSize = 3 * kMinDynamicBufferOffsetAlignment + 8;
 constexpr uint32_t kBindingSize = 9;
 
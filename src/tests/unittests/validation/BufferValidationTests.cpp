@@ -16,6 +16,7 @@
 
 #include <gmock/gmock.h>
 
+#include <limits>
 #include <memory>
 
 using namespace testing;
@@ -122,6 +123,48 @@ TEST_F(BufferValidationTest, CreationSuccess) {
     }
 }
 
+// Test the validation of the residency priority of buffers.
+TEST_F(BufferValidationTest, ResidencyPriority) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::Uniform;
+    descriptor.residencyPriority = wgpu::ResidencyPriority::Low;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    descriptor.residencyPriority = static_cast<wgpu::ResidencyPriority>(0xFFFF);
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&descriptor));
+
+    buffer.SetResidencyPriority(wgpu::ResidencyPriority::High);
+    ASSERT_DEVICE_ERROR(buffer.SetResidencyPriority(static_cast<wgpu::ResidencyPriority>(0xFFFF)));
+
+    // Changing the priority of a destroyed buffer is valid, it doesn't do anything.
+    buffer.Destroy();
+    buffer.SetResidencyPriority(wgpu::ResidencyPriority::Minimum);
+}
+
+// Test that descriptors created repeatedly, whose validation is cached, are still validated for
+// each of their members.
+TEST_F(BufferValidationTest, RepeatedDescriptors) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    for (uint32_t i = 0; i < 2; ++i) {
+        descriptor.label = i == 0 ? "first" : "second";
+        device.CreateBuffer(&descriptor);
+    }
+
+    wgpu::BufferDescriptor invalidDescriptor = descriptor;
+    invalidDescriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::Uniform;
+    for (uint32_t i = 0; i < 2; ++i) {
+        ASSERT_DEVICE_ERROR(device.CreateBuffer(&invalidDescriptor));
+        device.CreateBuffer(&descriptor);
+    }
+
+    invalidDescriptor = descriptor;
+    invalidDescriptor.residencyPriority = static_cast<wgpu::ResidencyPriority>(0xFFFF);
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&invalidDescriptor));
+}
+
 // Test restriction on usages allowed with MapRead and MapWrite
 TEST_F(BufferValidationTest, CreationMapUsageRestrictions) {
     // MapRead with CopyDst is ok
@@ -189,6 +232,77 @@ TEST_F(BufferValidationTest, MapWriteSuccess) {
     buf.Unmap();
 }
 
+// Test the success case for mapping a range of a buffer for reading
+TEST_F(BufferValidationTest, MapReadRangeSuccess) {
+    wgpu::Buffer buf = CreateMapReadBuffer(16);
+
+    buf.MapReadRangeAsync(4, 8, ToMockBufferMapReadCallback, nullptr);
+
+    EXPECT_CALL(*mockBufferMapReadCallback,
+                Call(WGPUBufferMapAsyncStatus_Success, Ne(nullptr), 8u, _))
+        .Times(1);
+    queue.Submit(0, nullptr);
+
+    buf.Unmap();
+}
+
+// Test the success case for mapping a range of a buffer for writing
+TEST_F(BufferValidationTest, MapWriteRangeSuccess) {
+    wgpu::Buffer buf = CreateMapWriteBuffer(16);
+
+    buf.MapWriteRangeAsync(4, 8, ToMockBufferMapWriteCallback, nullptr);
+
+    EXPECT_CALL(*mockBufferMapWriteCallback,
+                Call(WGPUBufferMapAsyncStatus_Success, Ne(nullptr), 8u, _))
+        .Times(1);
+    queue.Submit(0, nullptr);
+
+    buf.Unmap();
+}
+
+// Test that the pointer given for a mapped range is offset from the start of the buffer
+TEST_F(BufferValidationTest, MapRangePointerIsOffset) {
+    wgpu::Buffer buf = CreateMapWriteBuffer(16);
+
+    uint32_t* wholePointer = nullptr;
+    buf.MapWriteAsync(ToMockBufferMapWriteCallback, nullptr);
+    EXPECT_CALL(*mockBufferMapWriteCallback, Call(WGPUBufferMapAsyncStatus_Success, _, 16u, _))
+        .WillOnce(SaveArg<1>(&wholePointer));
+    queue.Submit(0, nullptr);
+    buf.Unmap();
+
+    uint32_t* rangePointer = nullptr;
+    buf.MapWriteRangeAsync(8, 4, ToMockBufferMapWriteCallback, nullptr);
+    EXPECT_CALL(*mockBufferMapWriteCallback, Call(WGPUBufferMapAsyncStatus_Success, _, 4u, _))
+        .WillOnce(SaveArg<1>(&rangePointer));
+    queue.Submit(0, nullptr);
+    buf.Unmap();
+
+    ASSERT_NE(wholePointer, nullptr);
+    ASSERT_EQ(rangePointer, wholePointer + 2);
+}
+
+// Test that mapping a range outside of the buffer is invalid
+TEST_F(BufferValidationTest, MapRangeOutOfBounds) {
+    {
+        wgpu::Buffer buf = CreateMapReadBuffer(16);
+
+        EXPECT_CALL(*mockBufferMapReadCallback,
+                    Call(WGPUBufferMapAsyncStatus_Error, nullptr, 0u, _))
+            .Times(1);
+        ASSERT_DEVICE_ERROR(buf.MapReadRangeAsync(12, 8, ToMockBufferMapReadCallback, nullptr));
+    }
+    {
+        wgpu::Buffer buf = CreateMapWriteBuffer(16);
+
+        EXPECT_CALL(*mockBufferMapWriteCallback,
+                    Call(WGPUBufferMapAsyncStatus_Error, nullptr, 0u, _))
+            .Times(1);
+        ASSERT_DEVICE_ERROR(buf.MapWriteRangeAsync(
+            8, std::numeric_limits<uint64_t>::max(), ToMockBufferMapWriteCallback, nullptr));
+    }
+}
+
 // Test the success case for CreateBufferMapped
 TEST_F(BufferValidationTest, CreateBufferMappedSuccess) {
     wgpu::CreateBufferMappedResult result = CreateBufferMapped(4, wgpu::BufferUsage::MapWrite);
@@ -205,6 +319,21 @@ TEST_F(BufferValidationTest, NonMappableCreateBufferMappedSuccess) {
     result.buffer.Unmap();
 }
 
+// Test that mappedDataFullyWritten is only valid for buffers created mapped
+TEST_F(BufferValidationTest, MappedDataFullyWritten) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::CopySrc;
+    descriptor.mappedDataFullyWritten = true;
+
+    wgpu::CreateBufferMappedResult result = device.CreateBufferMapped(&descriptor);
+    ASSERT_NE(result.data, nullptr);
+    ASSERT_EQ(result.dataLength, 4u);
+    result.buffer.Unmap();
+
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&descriptor));
+}
+
 // Test map reading a buffer with wrong current usage
 TEST_F(BufferValidationTest, MapReadWrongUsage) {
     wgpu::BufferDescriptor descriptor;
@@ -710,6 +839,68 @@ TEST_F(BufferValidationTest, SubmitMappedBuffer) {
     }
 }
 
+// Test the usages which are allowed with PersistentMap
+TEST_F(BufferValidationTest, CreationPersistentMapUsageRestrictions) {
+    auto CreateWithUsage = [&](wgpu::BufferUsage usage) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = 4;
+        descriptor.usage = usage;
+        return device.CreateBuffer(&descriptor);
+    };
+
+    // Success
+    CreateWithUsage(wgpu::BufferUsage::PersistentMap | wgpu::BufferUsage::MapRead |
+                    wgpu::BufferUsage::CopyDst);
+    CreateWithUsage(wgpu::BufferUsage::PersistentMap | wgpu::BufferUsage::MapWrite |
+                    wgpu::BufferUsage::CopySrc);
+
+    // Error case, PersistentMap requires a map usage
+    ASSERT_DEVICE_ERROR(CreateWithUsage(wgpu::BufferUsage::PersistentMap));
+    ASSERT_DEVICE_ERROR(
+        CreateWithUsage(wgpu::BufferUsage::PersistentMap | wgpu::BufferUsage::CopyDst));
+
+    // Error case, the map usages still restrict the other usages
+    ASSERT_DEVICE_ERROR(CreateWithUsage(wgpu::BufferUsage::PersistentMap |
+                                        wgpu::BufferUsage::MapRead | wgpu::BufferUsage::Uniform));
+}
+
+// Test that it is valid to submit persistently mapped buffers in a queue
+TEST_F(BufferValidationTest, SubmitPersistentlyMappedBuffer) {
+    wgpu::BufferDescriptor descriptorA;
+    descriptorA.size = 4;
+    descriptorA.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite |
+                        wgpu::BufferUsage::PersistentMap;
+
+    wgpu::BufferDescriptor descriptorB;
+    descriptorB.size = 4;
+    descriptorB.usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead |
+                        wgpu::BufferUsage::PersistentMap;
+
+    wgpu::Buffer bufA = device.CreateBuffer(&descriptorA);
+    wgpu::Buffer bufB = device.CreateBuffer(&descriptorB);
+
+    bufA.MapWriteAsync(ToMockBufferMapWriteCallback, nullptr);
+    bufB.MapReadAsync(ToMockBufferMapReadCallback, nullptr);
+    EXPECT_CALL(*mockBufferMapWriteCallback,
+                Call(WGPUBufferMapAsyncStatus_Success, Ne(nullptr), 4u, _))
+        .Times(1);
+    EXPECT_CALL(*mockBufferMapReadCallback,
+                Call(WGPUBufferMapAsyncStatus_Success, Ne(nullptr), 4u, _))
+        .Times(1);
+    queue.Submit(0, nullptr);
+
+    // Both buffers stay mapped across the submits.
+    for (uint32_t i = 0; i < 2; ++i) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(bufA, 0, bufB, 0, 4);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    bufA.Unmap();
+    bufB.Unmap();
+}
+
 // Test that it is invalid to submit a destroyed buffer in a queue
 TEST_F(BufferValidationTest, SubmitDestroyedBuffer) {
     wgpu::BufferDescriptor descriptorA;
@@ -757,3 +948,28 @@ TEST_F(BufferValidationTest, UnmapUnmappedBuffer) {
         buf.Unmap();
     }
 }
+
+// Test that the memory usage of the device counts the buffers until they are destroyed
+TEST_F(BufferValidationTest, MemoryUsageCountsBuffers) {
+    wgpu::MemoryUsage usage;
+    device.GetMemoryUsage(&usage);
+    uint64_t bufferCount = usage.bufferCount;
+    uint64_t bufferSize = usage.bufferSize;
+
+    wgpu::Buffer bufA = CreateMapReadBuffer(16);
+    wgpu::Buffer bufB = CreateMapWriteBuffer(64);
+    device.GetMemoryUsage(&usage);
+    ASSERT_EQ(usage.bufferCount, bufferCount + 2);
+    ASSERT_EQ(usage.bufferSize, bufferSize + 80);
+
+    // Destroying the buffer releases its memory even though it is still referenced.
+    bufA.Destroy();
+    device.GetMemoryUsage(&usage);
+    ASSERT_EQ(usage.bufferCount, bufferCount + 1);
+    ASSERT_EQ(usage.bufferSize, bufferSize + 64);
+
+    bufB = nullptr;
+    device.GetMemoryUsage(&usage);
+    ASSERT_EQ(usage.bufferCount, bufferCount);
+    ASSERT_EQ(usage.bufferSize, bufferSize);
+}
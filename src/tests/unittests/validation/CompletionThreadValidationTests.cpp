@@ -0,0 +1,108 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "dawn_native/DawnNative.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+    // Runs the tasks of the completion thread on the test thread.
+    struct TaskQueue {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::pair<void (*)(void*), void*>> tasks;
+
+        static void Enqueue(void (*task)(void*), void* taskData, void* userdata) {
+            TaskQueue* queue = static_cast<TaskQueue*>(userdata);
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->tasks.emplace_back(task, taskData);
+            queue->condition.notify_one();
+        }
+
+        // Returns false if no task was given in time.
+        bool RunOne() {
+            std::pair<void (*)(void*), void*> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!condition.wait_for(lock, std::chrono::seconds(5),
+                                        [this] { return !tasks.empty(); })) {
+                    return false;
+                }
+                task = tasks.front();
+                tasks.pop_front();
+            }
+            task.first(task.second);
+            return true;
+        }
+    };
+
+}  // anonymous namespace
+
+class CompletionThreadValidationTest : public ValidationTest {
+  protected:
+    void SetUp() override {
+        ValidationTest::SetUp();
+
+        dawn_native::CompletionThreadDescriptor descriptor;
+        descriptor.executor = TaskQueue::Enqueue;
+        descriptor.executorUserdata = &mTasks;
+        ASSERT_TRUE(dawn_native::StartCompletionThread(device.Get(), &descriptor));
+    }
+
+    void TearDown() override {
+        // Joins the completion thread, then frees the tasks it gave that didn't run.
+        device = nullptr;
+        for (auto& task : mTasks.tasks) {
+            task.first(task.second);
+        }
+        ValidationTest::TearDown();
+    }
+
+    TaskQueue mTasks;
+};
+
+// Test that a device only gets one completion thread.
+TEST_F(CompletionThreadValidationTest, StartTwice) {
+    dawn_native::CompletionThreadDescriptor descriptor;
+    descriptor.executor = TaskQueue::Enqueue;
+    descriptor.executorUserdata = &mTasks;
+    ASSERT_FALSE(dawn_native::StartCompletionThread(device.Get(), &descriptor));
+}
+
+// Test that the tasks of the completion thread call the map callback without the application
+// ticking the device.
+TEST_F(CompletionThreadValidationTest, MapWriteAsyncWithoutTick) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+    descriptor.usage = wgpu::BufferUsage::MapWrite;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    bool done = false;
+    buffer.MapWriteAsync(
+        [](WGPUBufferMapAsyncStatus status, void*, uint64_t, void* userdata) {
+            EXPECT_EQ(status, WGPUBufferMapAsyncStatus_Success);
+            *static_cast<bool*>(userdata) = true;
+        },
+        &done);
+
+    while (!done) {
+        ASSERT_TRUE(mTasks.RunOne());
+    }
+}
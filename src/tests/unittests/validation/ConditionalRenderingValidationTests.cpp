@@ -0,0 +1,147 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+#include <limits>
+
+class ConditionalRenderingValidationTest : public ValidationTest {
+  protected:
+    wgpu::Buffer CreatePredicateBuffer(uint64_t size,
+                                       wgpu::BufferUsage usage = wgpu::BufferUsage::Predicate) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = size;
+        descriptor.usage = usage | wgpu::BufferUsage::CopyDst;
+        return device.CreateBuffer(&descriptor);
+    }
+
+    void TestConditionalComputePass(utils::Expectation expectation,
+                                    const wgpu::Buffer& buffer,
+                                    uint64_t offset) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginConditionalRendering(buffer, offset);
+        pass.EndConditionalRendering();
+        pass.EndPass();
+
+        if (expectation == utils::Expectation::Success) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    }
+};
+
+// Verify that the predicate usage and conditional rendering require the extension
+TEST_F(ConditionalRenderingValidationTest, RequiresExtension) {
+    ASSERT_DEVICE_ERROR(CreatePredicateBuffer(8));
+
+    wgpu::Buffer buffer = CreatePredicateBuffer(8, wgpu::BufferUsage::Indirect);
+    TestConditionalComputePass(utils::Expectation::Failure, buffer, 0);
+}
+
+class ConditionalRenderingExtensionValidationTest : public ConditionalRenderingValidationTest {
+  protected:
+    ConditionalRenderingExtensionValidationTest() : ConditionalRenderingValidationTest() {
+        device = CreateDeviceFromAdapter(adapter, {"conditional_rendering"});
+    }
+};
+
+// Verify the validation of the predicate
+TEST_F(ConditionalRenderingExtensionValidationTest, Predicate) {
+    wgpu::Buffer buffer = CreatePredicateBuffer(16);
+
+    // Success cases
+    TestConditionalComputePass(utils::Expectation::Success, buffer, 0);
+    TestConditionalComputePass(utils::Expectation::Success, buffer, 8);
+
+    // The offset must be a multiple of 8
+    TestConditionalComputePass(utils::Expectation::Failure, buffer, 4);
+
+    // The 8 bytes of the predicate must be in bounds
+    TestConditionalComputePass(utils::Expectation::Failure, buffer, 16);
+    TestConditionalComputePass(utils::Expectation::Failure, buffer,
+                               std::numeric_limits<uint64_t>::max() - 7);
+
+    // The buffer needs the Predicate usage
+    wgpu::Buffer indirectBuffer = CreatePredicateBuffer(8, wgpu::BufferUsage::Indirect);
+    TestConditionalComputePass(utils::Expectation::Failure, indirectBuffer, 0);
+}
+
+// Verify that the conditional rendering scopes are balanced inside a pass
+TEST_F(ConditionalRenderingExtensionValidationTest, Scopes) {
+    wgpu::Buffer buffer = CreatePredicateBuffer(16);
+
+    // Success case, scopes one after the other
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginConditionalRendering(buffer, 0);
+        pass.EndConditionalRendering();
+        pass.BeginConditionalRendering(buffer, 8, true);
+        pass.EndConditionalRendering();
+        pass.EndPass();
+        encoder.Finish();
+    }
+
+    // Error case, scopes can't be nested
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginConditionalRendering(buffer, 0);
+        pass.BeginConditionalRendering(buffer, 8);
+        pass.EndConditionalRendering();
+        pass.EndConditionalRendering();
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Error case, ending a scope that didn't begin
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.EndConditionalRendering();
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Error case, the scope must end before the pass
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginConditionalRendering(buffer, 0);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+}
+
+// Verify that the predicate can't be written in the pass that reads it
+TEST_F(ConditionalRenderingExtensionValidationTest, PredicateWrittenInPass) {
+    wgpu::Buffer buffer = CreatePredicateBuffer(16, wgpu::BufferUsage::Predicate |
+                                                        wgpu::BufferUsage::Storage);
+
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+    wgpu::BindGroup bindGroup = utils::MakeBindGroup(device, layout, {{0, buffer, 0, 16}});
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    pass.SetBindGroup(0, bindGroup);
+    pass.BeginConditionalRendering(buffer, 0);
+    pass.EndConditionalRendering();
+    pass.EndPass();
+    ASSERT_DEVICE_ERROR(encoder.Finish());
+}
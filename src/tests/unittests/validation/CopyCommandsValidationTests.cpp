@@ -1152,6 +1152,34 @@ TEST_F(CopyCommandTest_T2T, CopyToMipmapOfNonSquareTexture) {
                 maxMipmapLevel - 2, 0, {0, 0, 0}, {2, 1, 1});
 }
 
+class CopyCommandTest_SkipCopyBoundsValidation : public CopyCommandTest {
+  public:
+    CopyCommandTest_SkipCopyBoundsValidation() : CopyCommandTest() {
+        device = CreateDeviceFromAdapter(adapter, {}, {"skip_copy_bounds_validation"});
+    }
+};
+
+// Test that skipping the copy bounds validation doesn't skip the buffer bounds validation.
+TEST_F(CopyCommandTest_SkipCopyBoundsValidation, OnlyTextureBoundsAreSkipped) {
+    wgpu::Texture texture = Create2DTexture(4, 4, 1, 1, wgpu::TextureFormat::RGBA8Unorm,
+                                            wgpu::TextureUsage::CopySrc |
+                                                wgpu::TextureUsage::CopyDst);
+    wgpu::Buffer buffer = CreateBuffer(BufferSizeForTextureCopy(8, 4, 1),
+                                       wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst);
+
+    // The copy doesn't fit in the texture, which isn't validated.
+    TestB2TCopy(utils::Expectation::Success, buffer, 0, 256, 0, texture, 0, 0, {0, 0, 0},
+                {8, 4, 1});
+    TestT2BCopy(utils::Expectation::Success, texture, 0, 0, {2, 0, 0}, buffer, 0, 256, 0,
+                {4, 4, 1});
+
+    // The copy doesn't fit in the buffer, which still is.
+    TestB2TCopy(utils::Expectation::Failure, buffer, 256, 256, 0, texture, 0, 0, {0, 0, 0},
+                {8, 4, 1});
+    TestT2BCopy(utils::Expectation::Failure, texture, 0, 0, {0, 0, 0}, buffer, 256, 256, 0,
+                {8, 4, 1});
+}
+
 class CopyCommandTest_CompressedTextureFormats : public CopyCommandTest {
   public:
     CopyCommandTest_CompressedTextureFormats() : CopyCommandTest() {
@@ -1464,3 +1492,69 @@ TEST_F(CopyCommandTest_CompressedTextureFormats, ImageExtent) {
         }
     }
 }
+
+class CopyCommandTest_GenerateMipmaps : public CopyCommandTest {
+  protected:
+    void TestGenerateMipmaps(utils::Expectation expectation,
+                             wgpu::Texture texture,
+                             uint32_t baseMipLevel,
+                             uint32_t mipLevelCount) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.GenerateMipmaps(texture, baseMipLevel, mipLevelCount);
+        if (expectation == utils::Expectation::Success) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    }
+
+    static constexpr wgpu::TextureUsage kMipmapUsage =
+        wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst;
+};
+
+// Test generating all or part of the mip chain of a texture.
+TEST_F(CopyCommandTest_GenerateMipmaps, Success) {
+    wgpu::Texture texture =
+        Create2DTexture(16, 16, 5, 2, wgpu::TextureFormat::RGBA8Unorm, kMipmapUsage);
+
+    TestGenerateMipmaps(utils::Expectation::Success, texture, 0, 5);
+    TestGenerateMipmaps(utils::Expectation::Success, texture, 1, 3);
+    TestGenerateMipmaps(utils::Expectation::Success, texture, 4, 1);
+}
+
+// Test the mip levels have to be in the texture.
+TEST_F(CopyCommandTest_GenerateMipmaps, OutOfBounds) {
+    wgpu::Texture texture =
+        Create2DTexture(16, 16, 5, 1, wgpu::TextureFormat::RGBA8Unorm, kMipmapUsage);
+
+    TestGenerateMipmaps(utils::Expectation::Failure, texture, 0, 0);
+    TestGenerateMipmaps(utils::Expectation::Failure, texture, 0, 6);
+    TestGenerateMipmaps(utils::Expectation::Failure, texture, 5, 1);
+    TestGenerateMipmaps(utils::Expectation::Failure, texture, 2, 4);
+}
+
+// Test the texture needs both the CopySrc and CopyDst usages.
+TEST_F(CopyCommandTest_GenerateMipmaps, IncorrectUsage) {
+    wgpu::Texture source =
+        Create2DTexture(16, 16, 5, 1, wgpu::TextureFormat::RGBA8Unorm, wgpu::TextureUsage::CopySrc);
+    wgpu::Texture destination =
+        Create2DTexture(16, 16, 5, 1, wgpu::TextureFormat::RGBA8Unorm, wgpu::TextureUsage::CopyDst);
+
+    TestGenerateMipmaps(utils::Expectation::Failure, source, 0, 5);
+    TestGenerateMipmaps(utils::Expectation::Failure, destination, 0, 5);
+}
+
+// Test only filterable color formats of single-sampled textures are supported.
+TEST_F(CopyCommandTest_GenerateMipmaps, IncorrectFormatOrSampleCount) {
+    wgpu::Texture integerTexture =
+        Create2DTexture(16, 16, 5, 1, wgpu::TextureFormat::RGBA8Uint, kMipmapUsage);
+    TestGenerateMipmaps(utils::Expectation::Failure, integerTexture, 0, 5);
+
+    wgpu::Texture depthTexture =
+        Create2DTexture(16, 16, 5, 1, wgpu::TextureFormat::Depth32Float, kMipmapUsage);
+    TestGenerateMipmaps(utils::Expectation::Failure, depthTexture, 0, 5);
+
+    wgpu::Texture multisampledTexture =
+        Create2DTexture(16, 16, 1, 1, wgpu::TextureFormat::RGBA8Unorm, kMipmapUsage, 4);
+    TestGenerateMipmaps(utils::Expectation::Failure, multisampledTexture, 0, 1);
+}
@@ -94,6 +94,36 @@ class DrawIndirectValidationTest : public ValidationTest {
         ValidateExpectation(encoder, expectation);
     }
 
+    void TestMultiDraw(utils::Expectation expectation,
+                       std::initializer_list<uint32_t> bufferList,
+                       uint64_t indirectOffset,
+                       uint32_t maxDrawCount,
+                       bool indexed,
+                       wgpu::Buffer countBuffer = nullptr,
+                       uint64_t countBufferOffset = 0) {
+        wgpu::Buffer indirectBuffer =
+            utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::Indirect, bufferList);
+
+        DummyRenderPass renderPass(device);
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(pipeline);
+        if (indexed) {
+            uint32_t zeros[100] = {};
+            wgpu::Buffer indexBuffer =
+                utils::CreateBufferFromData(device, zeros, sizeof(zeros), wgpu::BufferUsage::Index);
+            pass.SetIndexBuffer(indexBuffer);
+            pass.MultiDrawIndexedIndirect(indirectBuffer, indirectOffset, maxDrawCount,
+                                          countBuffer, countBufferOffset);
+        } else {
+            pass.MultiDrawIndirect(indirectBuffer, indirectOffset, maxDrawCount, countBuffer,
+                                   countBufferOffset);
+        }
+        pass.EndPass();
+
+        ValidateExpectation(encoder, expectation);
+    }
+
     wgpu::RenderPipeline pipeline;
 };
 
@@ -141,3 +171,69 @@ TEST_F(DrawIndirectValidationTest, DrawIndexedIndirectOffsetBounds) {
     TestIndirectOffsetDrawIndexed(utils::Expectation::Failure, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
                                   offset);
 }
+
+// Verify that all the draws of multi draw indirect calls must be in bounds
+TEST_F(DrawIndirectValidationTest, MultiDrawIndirectOffsetBounds) {
+    // In bounds, two draws
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4, 5, 6, 7, 8}, 0, 2, false);
+    // In bounds, two draws with a positive offset
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4, 5, 6, 7, 8, 9}, 1 * sizeof(uint32_t),
+                  2, false);
+    // In bounds, no draw
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4}, 0, 0, false);
+
+    // Out of bounds, the second draw is past the buffer
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4, 5, 6, 7}, 0, 2, false);
+    // Out of bounds, the draw count overflows with the offset
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4, 5, 6, 7, 8}, 4 * sizeof(uint32_t),
+                  std::numeric_limits<uint32_t>::max(), false);
+
+    // In bounds, two indexed draws
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, 0, 2, true);
+    // Out of bounds, the second indexed draw is past the buffer
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4, 5, 6, 7, 8, 9}, 0, 2, true);
+}
+
+// Verify that a count buffer requires the draw_indirect_count extension
+TEST_F(DrawIndirectValidationTest, CountBufferRequiresExtension) {
+    wgpu::Buffer countBuffer =
+        utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::Indirect, {1});
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 1, false, countBuffer);
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4, 5}, 0, 1, true, countBuffer);
+}
+
+class DrawIndirectCountValidationTest : public DrawIndirectValidationTest {
+  protected:
+    DrawIndirectCountValidationTest() : DrawIndirectValidationTest() {
+        device = CreateDeviceFromAdapter(adapter, {"draw_indirect_count"});
+    }
+};
+
+// Verify the validation of the count buffer of multi draw indirect calls
+TEST_F(DrawIndirectCountValidationTest, CountBuffer) {
+    wgpu::Buffer countBuffer =
+        utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::Indirect, {1, 2});
+
+    // Success cases
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4, 5, 6, 7, 8}, 0, 2, false,
+                  countBuffer, 0);
+    TestMultiDraw(utils::Expectation::Success, {1, 2, 3, 4, 5}, 0, 1, true, countBuffer,
+                  1 * sizeof(uint32_t));
+
+    // The max draw count still bounds the draws in the indirect buffer
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 2, false, countBuffer, 0);
+
+    // The count buffer offset must be a multiple of 4
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 1, false, countBuffer, 2);
+
+    // The count must be in bounds
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 1, false, countBuffer,
+                  2 * sizeof(uint32_t));
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 1, false, countBuffer,
+                  std::numeric_limits<uint64_t>::max() - 3);
+
+    // The count buffer needs the Indirect usage
+    wgpu::Buffer uniformBuffer =
+        utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::Uniform, {1});
+    TestMultiDraw(utils::Expectation::Failure, {1, 2, 3, 4}, 0, 1, false, uniformBuffer, 0);
+}
@@ -165,6 +165,23 @@ TEST_F(ErrorScopeValidationTest, CallbackAfterQueueSubmitNested) {
     device.Tick();
 }
 
+// Test that an error scope enclosing several Queue::Submit calls its callback once, after all of
+// them complete
+TEST_F(ErrorScopeValidationTest, CallbackAfterMultipleQueueSubmits) {
+    wgpu::Queue queue = device.CreateQueue();
+
+    device.PushErrorScope(wgpu::ErrorFilter::OutOfMemory);
+    queue.Submit(0, nullptr);
+    queue.Submit(0, nullptr);
+    queue.Submit(0, nullptr);
+    device.PopErrorScope(ToMockDevicePopErrorScopeCallback, this);
+
+    EXPECT_CALL(*mockDevicePopErrorScopeCallback, Call(WGPUErrorType_NoError, _, this)).Times(1);
+
+    // Side effects of Queue::Submit only are seen after Tick()
+    device.Tick();
+}
+
 // Test a callback that returns asynchronously followed by a synchronous one
 TEST_F(ErrorScopeValidationTest, AsynchronousThenSynchronous) {
     wgpu::Queue queue = device.CreateQueue();
@@ -211,3 +211,27 @@ TEST_F(FenceValidationTest, SignalWrongQueueDoesNotUpdateValue) {
     Flush();
     EXPECT_EQ(fence.GetCompletedValue(), 2u);
 }
+
+// Test that queues can wait on the values signaled on the fences of any queue
+TEST_F(FenceValidationTest, Wait) {
+    wgpu::QueueDescriptor queueDescriptor;
+    queueDescriptor.type = wgpu::QueueType::Compute;
+    wgpu::Queue computeQueue = device.CreateQueue(&queueDescriptor);
+
+    wgpu::FenceDescriptor descriptor;
+    descriptor.initialValue = 1;
+    wgpu::Fence fence = queue.CreateFence(&descriptor);
+
+    // Waiting on values that are already signaled is valid.
+    computeQueue.Wait(fence, 0);
+    computeQueue.Wait(fence, 1);
+    queue.Wait(fence, 1);
+
+    // The value must be signaled before the wait.
+    ASSERT_DEVICE_ERROR(computeQueue.Wait(fence, 2));
+
+    queue.Signal(fence, 2);
+    computeQueue.Wait(fence, 2);
+    Flush();
+    EXPECT_EQ(fence.GetCompletedValue(), 2u);
+}
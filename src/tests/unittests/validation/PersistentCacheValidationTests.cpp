@@ -0,0 +1,187 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "dawn_platform/DawnPlatform.h"
+#include "utils/WGPUHelpers.h"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace {
+
+    // A Platform keeping the persistent cache in memory and counting the accesses to it.
+    class InMemoryCachePlatform : public dawn_platform::Platform,
+                                  public dawn_platform::CachingInterface {
+      public:
+        const unsigned char* GetTraceCategoryEnabledFlag(
+            dawn_platform::TraceCategory category) override {
+            static unsigned char disabled = 0;
+            return &disabled;
+        }
+
+        double MonotonicallyIncreasingTime() override {
+            return 0.0;
+        }
+
+        uint64_t AddTraceEvent(char phase,
+                               const unsigned char* categoryGroupEnabled,
+                               const char* name,
+                               uint64_t id,
+                               double timestamp,
+                               int numArgs,
+                               const char** argNames,
+                               const unsigned char* argTypes,
+                               const uint64_t* argValues,
+                               unsigned char flags) override {
+            return 0;
+        }
+
+        dawn_platform::CachingInterface* GetCachingInterface(const void* fingerprint,
+                                                             size_t fingerprintSize) override {
+            return this;
+        }
+
+        size_t LoadData(const void* key, size_t keySize, void* value, size_t valueSize) override {
+            auto it = mEntries.find(ToVector(key, keySize));
+            if (it == mEntries.end()) {
+                return 0;
+            }
+            if (value != nullptr && valueSize >= it->second.size()) {
+                memcpy(value, it->second.data(), it->second.size());
+                hitCount++;
+            }
+            return it->second.size();
+        }
+
+        void StoreData(const void* key,
+                       size_t keySize,
+                       const void* value,
+                       size_t valueSize) override {
+            mEntries[ToVector(key, keySize)] = ToVector(value, valueSize);
+            storeCount++;
+        }
+
+        size_t GetEntryCount() const {
+            return mEntries.size();
+        }
+
+        uint32_t hitCount = 0;
+        uint32_t storeCount = 0;
+
+      private:
+        static std::vector<uint8_t> ToVector(const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            return std::vector<uint8_t>(bytes, bytes + size);
+        }
+
+        std::map<std::vector<uint8_t>, std::vector<uint8_t>> mEntries;
+    };
+
+    constexpr char kComputeShader[] = R"(
+        #version 450
+        layout(set = 0, binding = 0) uniform UniformBuffer {
+            vec4 pos;
+        };
+        layout(set = 0, binding = 1) buffer StorageBuffer {
+            vec4 data;
+        };
+        void main() {
+            data = pos;
+        })";
+
+}  // anonymous namespace
+
+class PersistentCacheValidationTest : public ValidationTest {
+  protected:
+    void SetUp() override {
+        ValidationTest::SetUp();
+        instance->SetPlatform(&mPlatform);
+    }
+
+    void TearDown() override {
+        ValidationTest::TearDown();
+        instance->SetPlatform(nullptr);
+    }
+
+    wgpu::ComputePipeline CreatePipeline(const wgpu::Device& testDevice) {
+        wgpu::ComputePipelineDescriptor descriptor;
+        descriptor.layout = nullptr;
+        descriptor.computeStage.module = utils::CreateShaderModule(
+            testDevice, utils::SingleShaderStage::Compute, kComputeShader);
+        descriptor.computeStage.entryPoint = "main";
+        return testDevice.CreateComputePipeline(&descriptor);
+    }
+
+    InMemoryCachePlatform mPlatform;
+};
+
+// Test that the reflection of a shader module is stored in the cache and reused by other devices.
+TEST_F(PersistentCacheValidationTest, ReflectionIsReused) {
+    wgpu::Device firstDevice = CreateDeviceFromAdapter(adapter, {});
+    utils::CreateShaderModule(firstDevice, utils::SingleShaderStage::Compute, kComputeShader);
+    EXPECT_EQ(mPlatform.hitCount, 0u);
+    EXPECT_EQ(mPlatform.storeCount, 1u);
+
+    wgpu::Device secondDevice = CreateDeviceFromAdapter(adapter, {});
+    utils::CreateShaderModule(secondDevice, utils::SingleShaderStage::Compute, kComputeShader);
+    EXPECT_EQ(mPlatform.hitCount, 1u);
+    EXPECT_EQ(mPlatform.storeCount, 1u);
+    EXPECT_EQ(mPlatform.GetEntryCount(), 1u);
+}
+
+// Test that different shader modules don't share cache entries.
+TEST_F(PersistentCacheValidationTest, DifferentModulesUseDifferentEntries) {
+    wgpu::Device testDevice = CreateDeviceFromAdapter(adapter, {});
+    utils::CreateShaderModule(testDevice, utils::SingleShaderStage::Compute, kComputeShader);
+    utils::CreateShaderModule(testDevice, utils::SingleShaderStage::Compute, R"(
+        #version 450
+        void main() {
+        })");
+    EXPECT_EQ(mPlatform.hitCount, 0u);
+    EXPECT_EQ(mPlatform.GetEntryCount(), 2u);
+}
+
+// Test that the reflection loaded from the cache matches the one of the shader: the default
+// pipeline layouts have the same bindings.
+TEST_F(PersistentCacheValidationTest, CachedReflectionIsValid) {
+    for (uint32_t i = 0; i < 2; ++i) {
+        wgpu::Device testDevice = CreateDeviceFromAdapter(adapter, {});
+        wgpu::ComputePipeline pipeline = CreatePipeline(testDevice);
+
+        wgpu::BufferDescriptor bufferDesc;
+        bufferDesc.size = 16;
+        bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Storage;
+        wgpu::Buffer buffer = testDevice.CreateBuffer(&bufferDesc);
+
+        // A bind group matching the reflected bindings is valid.
+        utils::MakeBindGroup(testDevice, pipeline.GetBindGroupLayout(0),
+                             {{0, buffer, 0, 16}, {1, buffer, 0, 16}});
+    }
+    EXPECT_EQ(mPlatform.hitCount, 1u);
+}
+
+// Test that nothing is stored for invalid shader modules.
+TEST_F(PersistentCacheValidationTest, InvalidModuleIsNotStored) {
+    wgpu::Device testDevice = CreateDeviceFromAdapter(adapter, {});
+
+    wgpu::ShaderModuleDescriptor descriptor;
+    uint32_t invalidCode[] = {0x07230203, 0, 0, 0, 0};
+    descriptor.code = invalidCode;
+    descriptor.codeSize = 5;
+    ASSERT_DEVICE_ERROR(testDevice.CreateShaderModule(&descriptor));
+    EXPECT_EQ(mPlatform.storeCount, 0u);
+}
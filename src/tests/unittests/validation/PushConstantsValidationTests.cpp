@@ -0,0 +1,217 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "common/Constants.h"
+#include "utils/WGPUHelpers.h"
+
+#include <array>
+
+class PushConstantsValidationTest : public ValidationTest {
+  protected:
+    PushConstantsValidationTest() : ValidationTest() {
+        device = CreateDeviceFromAdapter(adapter, {"push_constants"});
+    }
+
+    wgpu::PipelineLayout CreateLayout(uint32_t pushConstantSize,
+                                      wgpu::ShaderStage visibility = wgpu::ShaderStage::Compute) {
+        wgpu::PipelineLayoutDescriptor descriptor;
+        descriptor.bindGroupLayoutCount = 0;
+        descriptor.bindGroupLayouts = nullptr;
+        descriptor.pushConstantSize = pushConstantSize;
+        descriptor.pushConstantVisibility = visibility;
+        return device.CreatePipelineLayout(&descriptor);
+    }
+
+    // Uses a 16 byte push constant block.
+    wgpu::ComputePipeline CreatePipeline(wgpu::PipelineLayout layout) {
+        wgpu::ShaderModule module =
+            utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+                #version 450
+                layout(local_size_x = 1) in;
+                layout(push_constant) uniform PushConstants {
+                    uvec4 values;
+                } pushConstants;
+                layout(std430, set = 0, binding = 0) buffer Output {
+                    uvec4 result;
+                } outputBuffer;
+                void main() {
+                    outputBuffer.result = pushConstants.values;
+                })");
+
+        wgpu::ComputePipelineDescriptor descriptor;
+        descriptor.layout = layout;
+        descriptor.computeStage.module = module;
+        descriptor.computeStage.entryPoint = "main";
+        return device.CreateComputePipeline(&descriptor);
+    }
+};
+
+// Test the validation of the push constants of pipeline layouts.
+TEST_F(PushConstantsValidationTest, PipelineLayoutCreation) {
+    CreateLayout(0, wgpu::ShaderStage::None);
+    CreateLayout(4);
+    CreateLayout(kMaxPushConstantSize, wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment);
+
+    // The size must be aligned and at most the max.
+    ASSERT_DEVICE_ERROR(CreateLayout(6));
+    ASSERT_DEVICE_ERROR(CreateLayout(kMaxPushConstantSize + 4));
+
+    // The push constants must be visible to a stage, and only when there are push constants.
+    ASSERT_DEVICE_ERROR(CreateLayout(16, wgpu::ShaderStage::None));
+    ASSERT_DEVICE_ERROR(CreateLayout(0, wgpu::ShaderStage::Compute));
+}
+
+// Test that push constants require the push_constants extension.
+TEST_F(PushConstantsValidationTest, RequiresExtension) {
+    device = CreateDeviceFromAdapter(adapter, std::vector<const char*>());
+
+    ASSERT_DEVICE_ERROR(CreateLayout(16));
+
+    uint32_t data = 0;
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    pass.SetPushConstants(wgpu::ShaderStage::Compute, 0, sizeof(data), &data);
+    pass.EndPass();
+    ASSERT_DEVICE_ERROR(encoder.Finish());
+}
+
+// Test that the push constant block of a shader must fit in the push constants of the layout.
+TEST_F(PushConstantsValidationTest, PipelineCompatibility) {
+    wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+
+    auto CreateLayoutWithBindGroup = [&](uint32_t size, wgpu::ShaderStage visibility) {
+        wgpu::PipelineLayoutDescriptor descriptor;
+        descriptor.bindGroupLayoutCount = 1;
+        descriptor.bindGroupLayouts = &bgl;
+        descriptor.pushConstantSize = size;
+        descriptor.pushConstantVisibility = visibility;
+        return device.CreatePipelineLayout(&descriptor);
+    };
+
+    CreatePipeline(CreateLayoutWithBindGroup(16, wgpu::ShaderStage::Compute));
+    CreatePipeline(CreateLayoutWithBindGroup(kMaxPushConstantSize, wgpu::ShaderStage::Compute));
+    ASSERT_DEVICE_ERROR(CreatePipeline(CreateLayoutWithBindGroup(8, wgpu::ShaderStage::Compute)));
+    ASSERT_DEVICE_ERROR(
+        CreatePipeline(CreateLayoutWithBindGroup(16, wgpu::ShaderStage::Fragment)));
+    ASSERT_DEVICE_ERROR(CreatePipeline(CreateLayoutWithBindGroup(0, wgpu::ShaderStage::None)));
+
+    // The default layout reserves the push constants of the shader.
+    CreatePipeline(nullptr);
+}
+
+// Test the validation of the arguments of setPushConstants.
+TEST_F(PushConstantsValidationTest, SetPushConstantsArguments) {
+    wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+    wgpu::PipelineLayoutDescriptor layoutDescriptor;
+    layoutDescriptor.bindGroupLayoutCount = 1;
+    layoutDescriptor.bindGroupLayouts = &bgl;
+    layoutDescriptor.pushConstantSize = kMaxPushConstantSize;
+    layoutDescriptor.pushConstantVisibility = wgpu::ShaderStage::Compute;
+    wgpu::ComputePipeline pipeline =
+        CreatePipeline(device.CreatePipelineLayout(&layoutDescriptor));
+
+    // The bind group is set so that only the push constants are validated at dispatch.
+    wgpu::Buffer buffer = utils::CreateBufferFromData<uint32_t>(
+        device, wgpu::BufferUsage::Storage, {0, 0, 0, 0});
+    wgpu::BindGroup bindGroup = utils::MakeBindGroup(device, bgl, {{0, buffer, 0, 16}});
+
+    auto TestSetPushConstants = [&](utils::Expectation expectation, wgpu::ShaderStage stages,
+                                    uint32_t offset, uint32_t size) {
+        std::array<uint32_t, kMaxPushConstantSize / sizeof(uint32_t)> data = {};
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(pipeline);
+        pass.SetBindGroup(0, bindGroup);
+        pass.SetPushConstants(stages, offset, size, data.data());
+        pass.Dispatch(1);
+        pass.EndPass();
+
+        if (expectation == utils::Expectation::Success) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    };
+
+    TestSetPushConstants(utils::Expectation::Success, wgpu::ShaderStage::Compute, 0, 16);
+    TestSetPushConstants(utils::Expectation::Success, wgpu::ShaderStage::Compute, 4,
+                         kMaxPushConstantSize - 4);
+
+    // The offset and the size must be aligned, and the size non-zero.
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::Compute, 2, 4);
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::Compute, 0, 6);
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::Compute, 0, 0);
+
+    // The range must be within the max.
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::Compute, 4,
+                         kMaxPushConstantSize);
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::Compute,
+                         kMaxPushConstantSize, 4);
+
+    // The push constants must be set for a stage.
+    TestSetPushConstants(utils::Expectation::Failure, wgpu::ShaderStage::None, 0, 16);
+}
+
+// Test that the push constants must be in the range and the stages of the current layout when
+// dispatching.
+TEST_F(PushConstantsValidationTest, DispatchWithLayout) {
+    wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+    wgpu::PipelineLayoutDescriptor layoutDescriptor;
+    layoutDescriptor.bindGroupLayoutCount = 1;
+    layoutDescriptor.bindGroupLayouts = &bgl;
+    layoutDescriptor.pushConstantSize = 16;
+    layoutDescriptor.pushConstantVisibility = wgpu::ShaderStage::Compute;
+    wgpu::ComputePipeline pipeline =
+        CreatePipeline(device.CreatePipelineLayout(&layoutDescriptor));
+
+    wgpu::Buffer buffer = utils::CreateBufferFromData<uint32_t>(
+        device, wgpu::BufferUsage::Storage, {0, 0, 0, 0});
+    wgpu::BindGroup bindGroup = utils::MakeBindGroup(device, bgl, {{0, buffer, 0, 16}});
+
+    auto TestDispatchWithBindGroup = [&](utils::Expectation expectation, wgpu::ShaderStage stages,
+                                         uint32_t offset, uint32_t size) {
+        uint32_t data[4] = {};
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPushConstants(stages, offset, size, data);
+        pass.SetPipeline(pipeline);
+        pass.SetBindGroup(0, bindGroup);
+        pass.Dispatch(1);
+        pass.EndPass();
+
+        if (expectation == utils::Expectation::Success) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    };
+
+    // Setting the push constants before the pipeline is valid.
+    TestDispatchWithBindGroup(utils::Expectation::Success, wgpu::ShaderStage::Compute, 0, 16);
+    TestDispatchWithBindGroup(utils::Expectation::Success, wgpu::ShaderStage::Compute, 8, 8);
+
+    // Out of the range of the layout.
+    TestDispatchWithBindGroup(utils::Expectation::Failure, wgpu::ShaderStage::Compute, 8, 16);
+
+    // Not visible to the stage in the layout.
+    TestDispatchWithBindGroup(utils::Expectation::Failure,
+                              wgpu::ShaderStage::Compute | wgpu::ShaderStage::Fragment, 0, 16);
+}
@@ -0,0 +1,338 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+class QuerySetValidationTest : public ValidationTest {
+  protected:
+    QuerySetValidationTest() : ValidationTest() {
+        device = CreateDeviceFromAdapter(adapter,
+                                         {"timestamp_query", "pipeline_statistics_query"});
+        queue = device.CreateQueue();
+    }
+
+    wgpu::QuerySet CreateQuerySet(wgpu::QueryType type,
+                                  uint32_t count,
+                                  std::vector<wgpu::PipelineStatisticName> statistics = {}) {
+        wgpu::QuerySetDescriptor descriptor;
+        descriptor.type = type;
+        descriptor.count = count;
+        descriptor.pipelineStatisticsCount = static_cast<uint32_t>(statistics.size());
+        descriptor.pipelineStatistics = statistics.data();
+        return device.CreateQuerySet(&descriptor);
+    }
+
+    wgpu::Buffer CreateResolveBuffer(uint64_t size,
+                                     wgpu::BufferUsage usage = wgpu::BufferUsage::QueryResolve) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = size;
+        descriptor.usage = usage;
+        return device.CreateBuffer(&descriptor);
+    }
+
+    wgpu::Queue queue;
+};
+
+// Test the creation of the query sets of each type.
+TEST_F(QuerySetValidationTest, CreationSuccess) {
+    CreateQuerySet(wgpu::QueryType::Occlusion, 4);
+    CreateQuerySet(wgpu::QueryType::Timestamp, 4);
+    CreateQuerySet(wgpu::QueryType::PipelineStatistics, 4,
+                   {wgpu::PipelineStatisticName::VertexShaderInvocations,
+                    wgpu::PipelineStatisticName::FragmentShaderInvocations});
+}
+
+// Test that the query count must be within bounds.
+TEST_F(QuerySetValidationTest, CreationQueryCount) {
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::Timestamp, 0));
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::Timestamp, 8193));
+    CreateQuerySet(wgpu::QueryType::Timestamp, 8192);
+}
+
+// Test that pipeline statistics are required by and only allowed for pipeline statistics
+// queries, without duplicates.
+TEST_F(QuerySetValidationTest, CreationPipelineStatistics) {
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::PipelineStatistics, 4));
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::Occlusion, 4,
+                                       {wgpu::PipelineStatisticName::ClipperInvocations}));
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::Timestamp, 4,
+                                       {wgpu::PipelineStatisticName::ClipperInvocations}));
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::PipelineStatistics, 4,
+                                       {wgpu::PipelineStatisticName::ClipperInvocations,
+                                        wgpu::PipelineStatisticName::ClipperInvocations}));
+}
+
+// Test that timestamp and pipeline statistics queries require their extension.
+TEST_F(QuerySetValidationTest, CreationWithoutExtensions) {
+    device = CreateDeviceFromAdapter(adapter, std::vector<const char*>());
+
+    CreateQuerySet(wgpu::QueryType::Occlusion, 4);
+    ASSERT_DEVICE_ERROR(CreateQuerySet(wgpu::QueryType::Timestamp, 4));
+    ASSERT_DEVICE_ERROR(
+        CreateQuerySet(wgpu::QueryType::PipelineStatistics, 4,
+                       {wgpu::PipelineStatisticName::ComputeShaderInvocations}));
+}
+
+// Test that timestamps are written in bounds of a timestamp query set.
+TEST_F(QuerySetValidationTest, WriteTimestamp) {
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 2);
+    wgpu::QuerySet occlusionSet = CreateQuerySet(wgpu::QueryType::Occlusion, 2);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.WriteTimestamp(timestampSet, 0);
+        encoder.WriteTimestamp(timestampSet, 1);
+        encoder.Finish();
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.WriteTimestamp(timestampSet, 2);
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.WriteTimestamp(occlusionSet, 0);
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.EndPass();
+        encoder.Finish();
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RayTracingPassDescriptor descriptor;
+        wgpu::RayTracingPassEncoder pass = encoder.BeginRayTracingPass(&descriptor);
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.EndPass();
+        encoder.Finish();
+    }
+}
+
+// Test that a query can only be written once per pass.
+TEST_F(QuerySetValidationTest, WriteQueryTwiceInPass) {
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 2);
+    DummyRenderPass renderPass(device);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.WriteTimestamp(timestampSet, 1);
+        pass.EndPass();
+        encoder.Finish();
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Writing the query again in another pass is valid.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        for (uint32_t i = 0; i < 2; ++i) {
+            wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+            pass.WriteTimestamp(timestampSet, 0);
+            pass.EndPass();
+        }
+        encoder.Finish();
+    }
+}
+
+// Test that occlusion queries are begun and ended in pairs in render passes.
+TEST_F(QuerySetValidationTest, OcclusionQuery) {
+    wgpu::QuerySet occlusionSet = CreateQuerySet(wgpu::QueryType::Occlusion, 2);
+    DummyRenderPass renderPass(device);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.BeginOcclusionQuery(occlusionSet, 0);
+        pass.EndOcclusionQuery();
+        pass.BeginOcclusionQuery(occlusionSet, 1);
+        pass.EndOcclusionQuery();
+        pass.EndPass();
+        encoder.Finish();
+    }
+    // Nested occlusion queries
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.BeginOcclusionQuery(occlusionSet, 0);
+        pass.BeginOcclusionQuery(occlusionSet, 1);
+        pass.EndOcclusionQuery();
+        pass.EndOcclusionQuery();
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+    // End without a Begin
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.EndOcclusionQuery();
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+    // Query still active at the end of the pass
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.BeginOcclusionQuery(occlusionSet, 0);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+}
+
+// Test that pipeline statistics queries are begun and ended in pairs.
+TEST_F(QuerySetValidationTest, PipelineStatisticsQuery) {
+    wgpu::QuerySet statisticsSet =
+        CreateQuerySet(wgpu::QueryType::PipelineStatistics, 2,
+                       {wgpu::PipelineStatisticName::ComputeShaderInvocations});
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 2);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginPipelineStatisticsQuery(statisticsSet, 0);
+        pass.EndPipelineStatisticsQuery();
+        pass.EndPass();
+        encoder.Finish();
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginPipelineStatisticsQuery(timestampSet, 0);
+        pass.EndPipelineStatisticsQuery();
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.BeginPipelineStatisticsQuery(statisticsSet, 0);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+}
+
+// Test the bounds, alignment and usage checks of resolves.
+TEST_F(QuerySetValidationTest, ResolveQuerySet) {
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 4);
+    wgpu::Buffer destination = CreateResolveBuffer(64);
+
+    auto TestResolve = [&](uint32_t firstQuery, uint32_t queryCount, wgpu::Buffer buffer,
+                           uint64_t offset, bool success) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        for (uint32_t i = 0; i < 4; ++i) {
+            encoder.WriteTimestamp(timestampSet, i);
+        }
+        encoder.ResolveQuerySet(timestampSet, firstQuery, queryCount, buffer, offset);
+        if (success) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    };
+
+    TestResolve(0, 4, destination, 0, true);
+    TestResolve(1, 3, destination, 32, true);
+
+    // Queries out of bounds of the query set
+    TestResolve(4, 1, destination, 0, false);
+    TestResolve(1, 4, destination, 0, false);
+
+    // Unaligned destination offset
+    TestResolve(0, 1, destination, 4, false);
+
+    // Results out of bounds of the buffer
+    TestResolve(0, 4, destination, 40, false);
+
+    // Destination without the QueryResolve usage
+    TestResolve(0, 1, CreateResolveBuffer(64, wgpu::BufferUsage::CopyDst), 0, false);
+}
+
+// Test that pipeline statistics resolve one value per statistic.
+TEST_F(QuerySetValidationTest, ResolvePipelineStatisticsSize) {
+    wgpu::QuerySet statisticsSet =
+        CreateQuerySet(wgpu::QueryType::PipelineStatistics, 1,
+                       {wgpu::PipelineStatisticName::VertexShaderInvocations,
+                        wgpu::PipelineStatisticName::FragmentShaderInvocations});
+    DummyRenderPass renderPass(device);
+
+    for (uint64_t size : {8u, 16u}) {
+        wgpu::Buffer destination = CreateResolveBuffer(size);
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.BeginPipelineStatisticsQuery(statisticsSet, 0);
+        pass.EndPipelineStatisticsQuery();
+        pass.EndPass();
+        encoder.ResolveQuerySet(statisticsSet, 0, 1, destination, 0);
+        if (size == 16u) {
+            encoder.Finish();
+        } else {
+            ASSERT_DEVICE_ERROR(encoder.Finish());
+        }
+    }
+}
+
+// Test that only queries written before the resolve can be resolved.
+TEST_F(QuerySetValidationTest, ResolveUnwrittenQueries) {
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 2);
+    wgpu::Buffer destination = CreateResolveBuffer(16);
+
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.WriteTimestamp(timestampSet, 0);
+        encoder.ResolveQuerySet(timestampSet, 0, 2, destination, 0);
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Queries written by submitted commands are available to later command buffers.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.WriteTimestamp(timestampSet, 0);
+        pass.WriteTimestamp(timestampSet, 1);
+        pass.EndPass();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.ResolveQuerySet(timestampSet, 0, 2, destination, 0);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+}
+
+// Test that destroyed query sets can't be used in submits.
+TEST_F(QuerySetValidationTest, SubmitDestroyedQuerySet) {
+    wgpu::QuerySet timestampSet = CreateQuerySet(wgpu::QueryType::Timestamp, 1);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.WriteTimestamp(timestampSet, 0);
+    wgpu::CommandBuffer commands = encoder.Finish();
+
+    timestampSet.Destroy();
+    ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+}
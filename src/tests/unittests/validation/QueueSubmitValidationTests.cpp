@@ -66,4 +66,189 @@ TEST_F(QueueSubmitValidationTest, SubmitWithMappedBuffer) {
     queue.Submit(1, &commands);
 }
 
+// Test the validation of Queue::WriteBuffer
+TEST_F(QueueSubmitValidationTest, WriteBuffer) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.usage = wgpu::BufferUsage::CopyDst;
+    descriptor.size = 16;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    wgpu::Queue queue = device.CreateQueue();
+    uint32_t data[4] = {};
+
+    // Success case
+    queue.WriteBuffer(buffer, 4, data, 12);
+
+    // The offset and the size must be multiples of 4
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(buffer, 2, data, 4));
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(buffer, 0, data, 2));
+
+    // The write must be in bounds
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(buffer, 4, data, 16));
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(buffer, 20, data, 0));
+
+    // The buffer needs the CopyDst usage
+    descriptor.usage = wgpu::BufferUsage::CopySrc;
+    wgpu::Buffer copySrcBuffer = device.CreateBuffer(&descriptor);
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(copySrcBuffer, 0, data, 4));
+
+    // The buffer can't be destroyed
+    buffer.Destroy();
+    ASSERT_DEVICE_ERROR(queue.WriteBuffer(buffer, 0, data, 4));
+}
+
+// Test the validation of Queue::WriteTexture
+TEST_F(QueueSubmitValidationTest, WriteTexture) {
+    wgpu::TextureDescriptor descriptor;
+    descriptor.dimension = wgpu::TextureDimension::e2D;
+    descriptor.size = {4, 4, 1};
+    descriptor.arrayLayerCount = 1;
+    descriptor.sampleCount = 1;
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.mipLevelCount = 1;
+    descriptor.usage = wgpu::TextureUsage::CopyDst;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    wgpu::Queue queue = device.CreateQueue();
+    uint8_t data[128] = {};
+    wgpu::TextureCopyView copyView = utils::CreateTextureCopyView(texture, 0, 0, {0, 0, 0});
+    wgpu::Extent3D writeSize = {4, 4, 1};
+    wgpu::TextureDataLayout layout;
+
+    // Success cases, with tightly packed rows and with a row pitch that isn't aligned
+    queue.WriteTexture(&copyView, data, 64, &layout, &writeSize);
+    layout.rowPitch = 20;
+    queue.WriteTexture(&copyView, data, 80, &layout, &writeSize);
+
+    // The row pitch can't be smaller than a row
+    layout.rowPitch = 12;
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&copyView, data, 128, &layout, &writeSize));
+    layout.rowPitch = 0;
+
+    // The write can't read outside of the data
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&copyView, data, 60, &layout, &writeSize));
+    layout.offset = 68;
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&copyView, data, 128, &layout, &writeSize));
+    layout.offset = 0;
+
+    // The write must be in the texture
+    wgpu::TextureCopyView offsetCopyView = utils::CreateTextureCopyView(texture, 0, 0, {1, 0, 0});
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&offsetCopyView, data, 128, &layout, &writeSize));
+
+    // The texture needs the CopyDst usage
+    descriptor.usage = wgpu::TextureUsage::CopySrc;
+    wgpu::Texture copySrcTexture = device.CreateTexture(&descriptor);
+    wgpu::TextureCopyView copySrcView = utils::CreateTextureCopyView(copySrcTexture, 0, 0, {});
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&copySrcView, data, 64, &layout, &writeSize));
+
+    // The texture can't be destroyed
+    texture.Destroy();
+    ASSERT_DEVICE_ERROR(queue.WriteTexture(&copyView, data, 64, &layout, &writeSize));
+}
+
+// Test that flushing the queue is valid with and without commands submitted before
+TEST_F(QueueSubmitValidationTest, Flush) {
+    wgpu::Queue queue = device.CreateQueue();
+    queue.Flush();
+
+    wgpu::CommandBuffer commands = device.CreateCommandEncoder().Finish();
+    queue.Submit(1, &commands);
+    queue.Flush();
+}
+
+// Test that transient buffers are destroyed once the command buffer using them is submitted
+TEST_F(QueueSubmitValidationTest, TransientBufferDestroyedAfterSubmit) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Transient;
+    descriptor.size = 4;
+    wgpu::Buffer transientBuffer = device.CreateBuffer(&descriptor);
+
+    descriptor.usage = wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer targetBuffer = device.CreateBuffer(&descriptor);
+
+    wgpu::CommandBuffer commands[2];
+    for (wgpu::CommandBuffer& command : commands) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(transientBuffer, 0, targetBuffer, 0, 4);
+        command = encoder.Finish();
+    }
+
+    wgpu::Queue queue = device.CreateQueue();
+
+    // Command buffers submitted together can all use the transient buffer.
+    queue.Submit(2, commands);
+
+    // The transient buffer can't be used by later submits.
+    ASSERT_DEVICE_ERROR(queue.Submit(1, &commands[0]));
+}
+
+// Test that transient buffers can't be mapped
+TEST_F(QueueSubmitValidationTest, TransientBufferCannotBeMapped) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 4;
+
+    descriptor.usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::Transient;
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&descriptor));
+
+    descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::Transient;
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&descriptor));
+}
+
+// Test the validation of the queue descriptor
+TEST_F(QueueSubmitValidationTest, CreateQueue) {
+    wgpu::QueueDescriptor descriptor;
+    device.CreateQueue(&descriptor);
+
+    descriptor.type = static_cast<wgpu::QueueType>(3);
+    ASSERT_DEVICE_ERROR(device.CreateQueue(&descriptor));
+}
+
+// Test that command buffers can only be submitted to queues that can execute all their commands
+TEST_F(QueueSubmitValidationTest, SubmitToQueueType) {
+    wgpu::QueueDescriptor descriptor;
+    descriptor.type = wgpu::QueueType::Compute;
+    wgpu::Queue computeQueue = device.CreateQueue(&descriptor);
+    descriptor.type = wgpu::QueueType::Copy;
+    wgpu::Queue copyQueue = device.CreateQueue(&descriptor);
+    wgpu::Queue graphicsQueue = device.CreateQueue();
+
+    wgpu::BufferDescriptor bufferDescriptor;
+    bufferDescriptor.size = 4;
+    bufferDescriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&bufferDescriptor);
+
+    wgpu::CommandBuffer copyCommands;
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(buffer, 0, buffer, 0, 0);
+        copyCommands = encoder.Finish();
+    }
+    wgpu::CommandBuffer computeCommands;
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(buffer, 0, buffer, 0, 0);
+        encoder.BeginComputePass().EndPass();
+        computeCommands = encoder.Finish();
+    }
+    wgpu::CommandBuffer renderCommands;
+    {
+        utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 1, 1);
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.BeginRenderPass(&renderPass.renderPassInfo).EndPass();
+        renderCommands = encoder.Finish();
+    }
+
+    graphicsQueue.Submit(1, &copyCommands);
+    graphicsQueue.Submit(1, &computeCommands);
+    graphicsQueue.Submit(1, &renderCommands);
+
+    computeQueue.Submit(1, &copyCommands);
+    computeQueue.Submit(1, &computeCommands);
+    ASSERT_DEVICE_ERROR(computeQueue.Submit(1, &renderCommands));
+
+    copyQueue.Submit(1, &copyCommands);
+    ASSERT_DEVICE_ERROR(copyQueue.Submit(1, &computeCommands));
+    ASSERT_DEVICE_ERROR(copyQueue.Submit(1, &renderCommands));
+}
+
 }  // anonymous namespace
@@ -737,6 +737,88 @@ TEST_F(RenderPassDescriptorValidationTest, UseNaNOrINFINITYAsColorOrDepthClearVa
     }
 }
 
+// Tests that transient attachments must be cleared and discarded by render passes
+TEST_F(RenderPassDescriptorValidationTest, TransientAttachmentLoadAndStoreOps) {
+    constexpr wgpu::TextureUsage kUsage =
+        wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::TransientAttachment;
+    wgpu::TextureView color = CreateTexture(device, wgpu::TextureDimension::e2D,
+                                            wgpu::TextureFormat::RGBA8Unorm, 1, 1, 1, 1, 1, kUsage)
+                                  .CreateView();
+    wgpu::TextureView depthStencil =
+        CreateTexture(device, wgpu::TextureDimension::e2D, wgpu::TextureFormat::Depth24PlusStencil8,
+                      1, 1, 1, 1, 1, kUsage)
+            .CreateView();
+
+    // Success case: the attachments are cleared and discarded.
+    {
+        utils::ComboRenderPassDescriptor renderPass({color}, depthStencil);
+        renderPass.cColorAttachments[0].storeOp = wgpu::StoreOp::Clear;
+        renderPass.cDepthStencilAttachmentInfo.depthStoreOp = wgpu::StoreOp::Clear;
+        renderPass.cDepthStencilAttachmentInfo.stencilStoreOp = wgpu::StoreOp::Clear;
+        AssertBeginRenderPassSuccess(&renderPass);
+    }
+
+    // Error case: the color attachment is stored.
+    {
+        utils::ComboRenderPassDescriptor renderPass({color});
+        AssertBeginRenderPassError(&renderPass);
+    }
+
+    // Error case: the color attachment is loaded.
+    {
+        utils::ComboRenderPassDescriptor renderPass({color});
+        renderPass.cColorAttachments[0].loadOp = wgpu::LoadOp::Load;
+        renderPass.cColorAttachments[0].storeOp = wgpu::StoreOp::Clear;
+        AssertBeginRenderPassError(&renderPass);
+    }
+
+    // Error case: the depth stencil attachment is stored.
+    {
+        utils::ComboRenderPassDescriptor renderPass({}, depthStencil);
+        AssertBeginRenderPassError(&renderPass);
+    }
+
+    // Error case: the stencil aspect is loaded.
+    {
+        utils::ComboRenderPassDescriptor renderPass({}, depthStencil);
+        renderPass.cDepthStencilAttachmentInfo.stencilLoadOp = wgpu::LoadOp::Load;
+        renderPass.cDepthStencilAttachmentInfo.depthStoreOp = wgpu::StoreOp::Clear;
+        renderPass.cDepthStencilAttachmentInfo.stencilStoreOp = wgpu::StoreOp::Clear;
+        AssertBeginRenderPassError(&renderPass);
+    }
+}
+
+// Tests that a multisampled transient attachment can be resolved, but not into a transient
+// attachment.
+TEST_F(MultisampledRenderPassDescriptorValidationTest, TransientAttachmentResolve) {
+    constexpr wgpu::TextureUsage kUsage =
+        wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::TransientAttachment;
+    wgpu::TextureView color = CreateTexture(device, wgpu::TextureDimension::e2D, kColorFormat,
+                                            kSize, kSize, kArrayLayers, kLevelCount, kSampleCount,
+                                            kUsage)
+                                  .CreateView();
+
+    // Success case: resolve into a normal texture.
+    {
+        utils::ComboRenderPassDescriptor renderPass({color});
+        renderPass.cColorAttachments[0].storeOp = wgpu::StoreOp::Clear;
+        renderPass.cColorAttachments[0].resolveTarget = CreateNonMultisampledColorTextureView();
+        AssertBeginRenderPassSuccess(&renderPass);
+    }
+
+    // Error case: resolve into a transient attachment.
+    {
+        wgpu::TextureView resolveTarget =
+            CreateTexture(device, wgpu::TextureDimension::e2D, kColorFormat, kSize, kSize,
+                          kArrayLayers, kLevelCount, 1, kUsage)
+                .CreateView();
+        utils::ComboRenderPassDescriptor renderPass({color});
+        renderPass.cColorAttachments[0].storeOp = wgpu::StoreOp::Clear;
+        renderPass.cColorAttachments[0].resolveTarget = resolveTarget;
+        AssertBeginRenderPassError(&renderPass);
+    }
+}
+
 // TODO(cwallez@chromium.org): Constraints on attachment aliasing?
 
 } // anonymous namespace
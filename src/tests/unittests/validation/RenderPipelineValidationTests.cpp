@@ -477,3 +477,47 @@ TEST_F(RenderPipelineValidationTest, StorageBufferInVertexShaderNoLayout) {
     descriptor.cFragmentStage.module = fsModule;
     ASSERT_DEVICE_ERROR(device.CreateRenderPipeline(&descriptor));
 }
+
+// Test that pipelines created asynchronously are validated and that the descriptor doesn't need
+// to outlive the call.
+TEST_F(RenderPipelineValidationTest, CreateRenderPipelineAsync) {
+    struct CreationResult {
+        bool called = false;
+        WGPURenderPipelineCreateStatus status;
+        wgpu::RenderPipeline pipeline;
+    };
+    auto callback = [](WGPURenderPipelineCreateStatus status, WGPURenderPipeline pipeline,
+                       void* userdata) {
+        CreationResult* result = static_cast<CreationResult*>(userdata);
+        result->called = true;
+        result->status = status;
+        result->pipeline = wgpu::RenderPipeline::Acquire(pipeline);
+    };
+
+    CreationResult success;
+    CreationResult error;
+    {
+        utils::ComboRenderPipelineDescriptor descriptor(device);
+        descriptor.vertexStage.module = vsModule;
+        descriptor.cFragmentStage.module = fsModule;
+        device.CreateRenderPipelineAsync(&descriptor, callback, &success);
+
+        // The sample count must be valid
+        descriptor.sampleCount = 3;
+        device.CreateRenderPipelineAsync(&descriptor, callback, &error);
+    }
+    ASSERT_FALSE(success.called);
+
+    device.Tick();
+    ASSERT_TRUE(success.called);
+    ASSERT_EQ(WGPURenderPipelineCreateStatus_Success, success.status);
+    ASSERT_NE(nullptr, success.pipeline.Get());
+    ASSERT_TRUE(error.called);
+    ASSERT_EQ(WGPURenderPipelineCreateStatus_Error, error.status);
+
+    // The pipeline is shared with the equal ones created synchronously.
+    utils::ComboRenderPipelineDescriptor descriptor(device);
+    descriptor.vertexStage.module = vsModule;
+    descriptor.cFragmentStage.module = fsModule;
+    ASSERT_EQ(success.pipeline.Get(), device.CreateRenderPipeline(&descriptor).Get());
+}
@@ -0,0 +1,212 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "common/Constants.h"
+#include "utils/WGPUHelpers.h"
+
+class ResourceTableValidationTest : public ValidationTest {
+  protected:
+    wgpu::BindGroupLayout CreateTableLayout(
+        uint32_t capacity,
+        wgpu::BindingType type = wgpu::BindingType::SampledTexture) {
+        wgpu::BindGroupLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.visibility = wgpu::ShaderStage::Compute;
+        binding.type = type;
+        binding.textureDimension = wgpu::TextureViewDimension::e2D;
+        binding.textureComponentType = wgpu::TextureComponentType::Float;
+
+        wgpu::BindGroupLayoutDescriptor descriptor;
+        descriptor.bindingCount = 1;
+        descriptor.bindings = &binding;
+        descriptor.resourceTableCapacity = capacity;
+        return device.CreateBindGroupLayout(&descriptor);
+    }
+
+    wgpu::ResourceTable CreateTable(const wgpu::BindGroupLayout& layout) {
+        wgpu::ResourceTableDescriptor descriptor;
+        descriptor.layout = layout;
+        return device.CreateResourceTable(&descriptor);
+    }
+
+    wgpu::TextureView CreateView(wgpu::TextureFormat format = wgpu::TextureFormat::RGBA8Unorm,
+                                 wgpu::TextureUsage usage = wgpu::TextureUsage::Sampled,
+                                 uint32_t arrayLayerCount = 1) {
+        wgpu::TextureDescriptor descriptor;
+        descriptor.dimension = wgpu::TextureDimension::e2D;
+        descriptor.size = {16, 16, 1};
+        descriptor.arrayLayerCount = arrayLayerCount;
+        descriptor.sampleCount = 1;
+        descriptor.format = format;
+        descriptor.mipLevelCount = 1;
+        descriptor.usage = usage;
+        return device.CreateTexture(&descriptor).CreateView();
+    }
+
+    wgpu::Buffer CreateBuffer(uint64_t size,
+                              wgpu::BufferUsage usage = wgpu::BufferUsage::Storage) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = size;
+        descriptor.usage = usage;
+        return device.CreateBuffer(&descriptor);
+    }
+
+    wgpu::CommandBuffer EncodeSetResourceTable(const wgpu::ResourceTable& table) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetResourceTable(0, table);
+        pass.EndPass();
+        return encoder.Finish();
+    }
+};
+
+// Verify that the resource table layouts require the extension
+TEST_F(ResourceTableValidationTest, RequiresExtension) {
+    ASSERT_DEVICE_ERROR(CreateTableLayout(16));
+}
+
+class ResourceTableExtensionValidationTest : public ResourceTableValidationTest {
+  protected:
+    ResourceTableExtensionValidationTest() : ResourceTableValidationTest() {
+        device = CreateDeviceFromAdapter(adapter, {"resource_tables"});
+    }
+};
+
+// Verify the validation of the resource table layouts
+TEST_F(ResourceTableExtensionValidationTest, Layout) {
+    // Success cases
+    CreateTableLayout(1);
+    CreateTableLayout(kMaxResourceTableCapacity);
+    CreateTableLayout(16, wgpu::BindingType::ReadonlyStorageBuffer);
+
+    // The capacity is bounded
+    ASSERT_DEVICE_ERROR(CreateTableLayout(kMaxResourceTableCapacity + 1));
+
+    // Only sampled textures and readonly storage buffers can be in tables
+    ASSERT_DEVICE_ERROR(CreateTableLayout(16, wgpu::BindingType::UniformBuffer));
+    ASSERT_DEVICE_ERROR(CreateTableLayout(16, wgpu::BindingType::StorageBuffer));
+    ASSERT_DEVICE_ERROR(CreateTableLayout(16, wgpu::BindingType::Sampler));
+
+    // A table layout has a single binding
+    {
+        wgpu::BindGroupLayoutBinding bindings[2] = {};
+        for (uint32_t i = 0; i < 2; ++i) {
+            bindings[i].binding = i;
+            bindings[i].visibility = wgpu::ShaderStage::Compute;
+            bindings[i].type = wgpu::BindingType::SampledTexture;
+        }
+
+        wgpu::BindGroupLayoutDescriptor descriptor;
+        descriptor.bindingCount = 2;
+        descriptor.bindings = bindings;
+        descriptor.resourceTableCapacity = 16;
+        ASSERT_DEVICE_ERROR(device.CreateBindGroupLayout(&descriptor));
+    }
+}
+
+// Verify that tables need a table layout and that table layouts can't make bind groups
+TEST_F(ResourceTableExtensionValidationTest, LayoutMismatch) {
+    wgpu::BindGroupLayout tableLayout = CreateTableLayout(16);
+    CreateTable(tableLayout);
+    ASSERT_DEVICE_ERROR(utils::MakeBindGroup(device, tableLayout, {{0, CreateView()}}));
+
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::SampledTexture}});
+    ASSERT_DEVICE_ERROR(CreateTable(layout));
+}
+
+// Verify the validation of the texture views set in tables
+TEST_F(ResourceTableExtensionValidationTest, SetTextureView) {
+    wgpu::ResourceTable table = CreateTable(CreateTableLayout(16));
+
+    // Success cases, including replacing and clearing slots
+    table.SetTextureView(0, CreateView());
+    table.SetTextureView(15, CreateView());
+    table.SetTextureView(0, CreateView());
+    table.ClearSlot(0);
+    table.ClearSlot(1);
+
+    // The slot must be in bounds
+    ASSERT_DEVICE_ERROR(table.SetTextureView(16, CreateView()));
+    ASSERT_DEVICE_ERROR(table.ClearSlot(16));
+
+    // The texture needs the Sampled usage
+    ASSERT_DEVICE_ERROR(table.SetTextureView(
+        0, CreateView(wgpu::TextureFormat::RGBA8Unorm, wgpu::TextureUsage::CopyDst)));
+
+    // The component type and the dimension must match the layout
+    ASSERT_DEVICE_ERROR(table.SetTextureView(0, CreateView(wgpu::TextureFormat::RGBA8Uint)));
+    ASSERT_DEVICE_ERROR(table.SetTextureView(
+        0, CreateView(wgpu::TextureFormat::RGBA8Unorm, wgpu::TextureUsage::Sampled, 2)));
+
+    // Buffers can't be set in a table of textures
+    ASSERT_DEVICE_ERROR(table.SetBuffer(0, CreateBuffer(256), 0, 256));
+}
+
+// Verify the validation of the buffers set in tables
+TEST_F(ResourceTableExtensionValidationTest, SetBuffer) {
+    wgpu::ResourceTable table =
+        CreateTable(CreateTableLayout(16, wgpu::BindingType::ReadonlyStorageBuffer));
+    wgpu::Buffer buffer = CreateBuffer(512);
+
+    // Success cases
+    table.SetBuffer(0, buffer, 0, 512);
+    table.SetBuffer(1, buffer, 256, 256);
+    table.SetBuffer(2, buffer, 0, wgpu::kWholeSize);
+
+    // The range must be in the buffer and the offset aligned
+    ASSERT_DEVICE_ERROR(table.SetBuffer(0, buffer, 256, 512));
+    ASSERT_DEVICE_ERROR(table.SetBuffer(0, buffer, 0, 1024));
+    ASSERT_DEVICE_ERROR(table.SetBuffer(0, buffer, 4, 256));
+
+    // The buffer needs the Storage usage
+    ASSERT_DEVICE_ERROR(table.SetBuffer(0, CreateBuffer(256, wgpu::BufferUsage::Uniform), 0, 256));
+
+    // Texture views can't be set in a table of buffers
+    ASSERT_DEVICE_ERROR(table.SetTextureView(0, CreateView()));
+}
+
+// Verify that a table can't be modified between being set in a command buffer and its submit
+TEST_F(ResourceTableExtensionValidationTest, ModifiedBeforeSubmit) {
+    wgpu::Queue queue = device.CreateQueue();
+    wgpu::ResourceTable table = CreateTable(CreateTableLayout(16));
+    table.SetTextureView(0, CreateView());
+
+    // Success case, the table is unchanged
+    {
+        wgpu::CommandBuffer commands = EncodeSetResourceTable(table);
+        queue.Submit(1, &commands);
+    }
+
+    // Success case, the table is changed after the submit and set again
+    {
+        table.SetTextureView(1, CreateView());
+        wgpu::CommandBuffer commands = EncodeSetResourceTable(table);
+        queue.Submit(1, &commands);
+    }
+
+    // Error cases, the table is set again or cleared after being encoded
+    {
+        wgpu::CommandBuffer commands = EncodeSetResourceTable(table);
+        table.SetTextureView(2, CreateView());
+        ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+    }
+    {
+        wgpu::CommandBuffer commands = EncodeSetResourceTable(table);
+        table.ClearSlot(2);
+        ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+    }
+}
@@ -19,6 +19,8 @@
 #include "utils/WGPUHelpers.h"
 
 #include <sstream>
+#include <thread>
+#include <vector>
 
 class ShaderModuleValidationTest : public ValidationTest {
 };
@@ -108,3 +110,99 @@ TEST_F(ShaderModuleValidationTest, FragmentOutputLocationExceedsMaxColorAttachme
     ASSERT_DEVICE_ERROR(utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment,
                                                   stream.str().c_str()));
 }
+
+namespace {
+
+    // An empty compute shader:
+    //                OpCapability Shader
+    //                OpMemoryModel Logical GLSL450
+    //                OpEntryPoint GLCompute %main "main"
+    //                OpExecutionMode %main LocalSize 1 1 1
+    //        %void = OpTypeVoid
+    //          %fn = OpTypeFunction %void
+    //        %main = OpFunction %void None %fn
+    //       %label = OpLabel
+    //                OpReturn
+    //                OpFunctionEnd
+    constexpr uint32_t kEmptyComputeShader[] = {
+        0x07230203, 0x00010000, 0x00000000, 0x00000005, 0x00000000,
+        0x00020011, 0x00000001,
+        0x0003000E, 0x00000000, 0x00000001,
+        0x0005000F, 0x00000005, 0x00000001, 0x6E69616D, 0x00000000,
+        0x00060010, 0x00000001, 0x00000011, 0x00000001, 0x00000001, 0x00000001,
+        0x00020013, 0x00000002,
+        0x00030021, 0x00000003, 0x00000002,
+        0x00050036, 0x00000002, 0x00000001, 0x00000000, 0x00000003,
+        0x000200F8, 0x00000004,
+        0x000100FD,
+        0x00010038,
+    };
+
+    struct CreationResult {
+        bool called = false;
+        WGPUShaderModuleCreateStatus status;
+        wgpu::ShaderModule shaderModule;
+    };
+
+    void OnShaderModuleCreated(WGPUShaderModuleCreateStatus status,
+                               WGPUShaderModule shaderModule,
+                               void* userdata) {
+        CreationResult* result = static_cast<CreationResult*>(userdata);
+        result->called = true;
+        result->status = status;
+        result->shaderModule = wgpu::ShaderModule::Acquire(shaderModule);
+    }
+
+}  // anonymous namespace
+
+class ShaderModuleAsyncValidationTest : public ValidationTest {
+  protected:
+    // Creates a valid and an invalid module asynchronously and ticks the device until both
+    // callbacks were called.
+    void TestCreateShaderModuleAsync() {
+        CreationResult success;
+        CreationResult error;
+        {
+            std::vector<uint32_t> code(std::begin(kEmptyComputeShader),
+                                       std::end(kEmptyComputeShader));
+            wgpu::ShaderModuleDescriptor descriptor;
+            descriptor.codeSize = static_cast<uint32_t>(code.size());
+            descriptor.code = code.data();
+            device.CreateShaderModuleAsync(&descriptor, OnShaderModuleCreated, &success);
+
+            // The SPIR-V must have a valid header
+            code[0] = 0;
+            device.CreateShaderModuleAsync(&descriptor, OnShaderModuleCreated, &error);
+        }
+        ASSERT_FALSE(success.called);
+
+        StartExpectDeviceError();
+        while (!success.called || !error.called) {
+            device.Tick();
+            std::this_thread::yield();
+        }
+        ASSERT_TRUE(EndExpectDeviceError());
+
+        ASSERT_EQ(WGPUShaderModuleCreateStatus_Success, success.status);
+        ASSERT_NE(nullptr, success.shaderModule.Get());
+        ASSERT_EQ(WGPUShaderModuleCreateStatus_Error, error.status);
+
+        // The module is shared with the equal ones created synchronously.
+        wgpu::ShaderModuleDescriptor descriptor;
+        descriptor.codeSize = sizeof(kEmptyComputeShader) / sizeof(uint32_t);
+        descriptor.code = kEmptyComputeShader;
+        ASSERT_EQ(success.shaderModule.Get(), device.CreateShaderModule(&descriptor).Get());
+    }
+};
+
+// Test that modules created asynchronously are validated during the device tick.
+TEST_F(ShaderModuleAsyncValidationTest, CreateShaderModuleAsync) {
+    TestCreateShaderModuleAsync();
+}
+
+// Test that modules created asynchronously are validated when the validation runs on worker
+// threads.
+TEST_F(ShaderModuleAsyncValidationTest, CreateShaderModuleAsyncOnWorkerThreads) {
+    device = CreateDeviceFromAdapter(adapter, {}, {"validate_shader_modules_on_worker_threads"});
+    TestCreateShaderModuleAsync();
+}
@@ -0,0 +1,188 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "common/Constants.h"
+#include "utils/WGPUHelpers.h"
+
+class SparseResourcesValidationTest : public ValidationTest {
+  protected:
+    SparseResourcesValidationTest() : ValidationTest() {
+        device = CreateDeviceFromAdapter(adapter, {"sparse_resources"});
+        queue = device.CreateQueue();
+    }
+
+    wgpu::Buffer CreateBuffer(uint64_t size,
+                              wgpu::BufferUsage usage = wgpu::BufferUsage::Sparse |
+                                                        wgpu::BufferUsage::Storage) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = size;
+        descriptor.usage = usage;
+        return device.CreateBuffer(&descriptor);
+    }
+
+    // The tiles of RGBA8 textures are 128x128 texels.
+    wgpu::Texture CreateTexture(uint32_t width,
+                                uint32_t height,
+                                uint32_t mipLevelCount = 1,
+                                wgpu::TextureFormat format = wgpu::TextureFormat::RGBA8Unorm) {
+        wgpu::TextureDescriptor descriptor;
+        descriptor.size = {width, height, 1};
+        descriptor.arrayLayerCount = 2;
+        descriptor.mipLevelCount = mipLevelCount;
+        descriptor.format = format;
+        descriptor.usage = wgpu::TextureUsage::Sparse | wgpu::TextureUsage::Sampled;
+        return device.CreateTexture(&descriptor);
+    }
+
+    wgpu::Queue queue;
+};
+
+// Test that sparse resources require the sparse_resources extension.
+TEST_F(SparseResourcesValidationTest, RequiresExtension) {
+    device = CreateDeviceFromAdapter(adapter, std::vector<const char*>());
+
+    ASSERT_DEVICE_ERROR(CreateBuffer(kSparseTileSize));
+    ASSERT_DEVICE_ERROR(CreateTexture(128, 128));
+}
+
+// Test the validation of the creation of sparse buffers.
+TEST_F(SparseResourcesValidationTest, BufferCreation) {
+    CreateBuffer(kSparseTileSize);
+    CreateBuffer(16 * kSparseTileSize);
+
+    // The size must be a multiple of the tile size.
+    ASSERT_DEVICE_ERROR(CreateBuffer(kSparseTileSize / 2));
+    ASSERT_DEVICE_ERROR(CreateBuffer(kSparseTileSize + 4));
+
+    // Sparse buffers can't be mapped or transient.
+    ASSERT_DEVICE_ERROR(
+        CreateBuffer(kSparseTileSize, wgpu::BufferUsage::Sparse | wgpu::BufferUsage::MapWrite));
+    ASSERT_DEVICE_ERROR(
+        CreateBuffer(kSparseTileSize, wgpu::BufferUsage::Sparse | wgpu::BufferUsage::MapRead));
+    ASSERT_DEVICE_ERROR(
+        CreateBuffer(kSparseTileSize, wgpu::BufferUsage::Sparse | wgpu::BufferUsage::Transient));
+
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kSparseTileSize;
+    descriptor.usage = wgpu::BufferUsage::Sparse | wgpu::BufferUsage::CopyDst;
+    ASSERT_DEVICE_ERROR(device.CreateBufferMapped(&descriptor));
+}
+
+// Test the validation of the creation of sparse textures.
+TEST_F(SparseResourcesValidationTest, TextureCreation) {
+    CreateTexture(128, 128);
+    CreateTexture(256, 384);
+    CreateTexture(512, 512, 3);
+    CreateTexture(256, 256, 1, wgpu::TextureFormat::R8Unorm);
+    CreateTexture(128, 64, 1, wgpu::TextureFormat::RGBA16Float);
+
+    // All the mip levels must be made of whole tiles.
+    ASSERT_DEVICE_ERROR(CreateTexture(100, 128));
+    ASSERT_DEVICE_ERROR(CreateTexture(128, 192));
+    ASSERT_DEVICE_ERROR(CreateTexture(512, 512, 4));
+    ASSERT_DEVICE_ERROR(CreateTexture(128, 128, 1, wgpu::TextureFormat::R8Unorm));
+
+    // Sparse textures can't be multisampled or have a depth-stencil format.
+    ASSERT_DEVICE_ERROR(CreateTexture(128, 128, 1, wgpu::TextureFormat::Depth32Float));
+    {
+        wgpu::TextureDescriptor descriptor;
+        descriptor.size = {128, 128, 1};
+        descriptor.sampleCount = 4;
+        descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+        descriptor.usage = wgpu::TextureUsage::Sparse | wgpu::TextureUsage::OutputAttachment;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+    }
+
+    // Sparse textures can't be transient.
+    {
+        wgpu::TextureDescriptor descriptor;
+        descriptor.size = {128, 128, 1};
+        descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+        descriptor.usage = wgpu::TextureUsage::Sparse | wgpu::TextureUsage::Transient |
+                           wgpu::TextureUsage::OutputAttachment;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+    }
+}
+
+// Test the validation of the arguments of updateBufferTileMappings.
+TEST_F(SparseResourcesValidationTest, UpdateBufferTileMappings) {
+    wgpu::Buffer buffer = CreateBuffer(4 * kSparseTileSize);
+
+    queue.UpdateBufferTileMappings(buffer, 0, 4 * kSparseTileSize, true);
+    queue.UpdateBufferTileMappings(buffer, kSparseTileSize, kSparseTileSize, false);
+    queue.UpdateBufferTileMappings(buffer, 4 * kSparseTileSize, 0, true);
+
+    // The range must be made of whole tiles within the buffer.
+    ASSERT_DEVICE_ERROR(queue.UpdateBufferTileMappings(buffer, 4, kSparseTileSize, true));
+    ASSERT_DEVICE_ERROR(queue.UpdateBufferTileMappings(buffer, 0, kSparseTileSize / 2, true));
+    ASSERT_DEVICE_ERROR(
+        queue.UpdateBufferTileMappings(buffer, 3 * kSparseTileSize, 2 * kSparseTileSize, true));
+    ASSERT_DEVICE_ERROR(
+        queue.UpdateBufferTileMappings(buffer, 5 * kSparseTileSize, kSparseTileSize, true));
+
+    // The buffer must be sparse.
+    wgpu::Buffer denseBuffer = CreateBuffer(kSparseTileSize, wgpu::BufferUsage::Storage);
+    ASSERT_DEVICE_ERROR(queue.UpdateBufferTileMappings(denseBuffer, 0, kSparseTileSize, true));
+
+    // The buffer must not be destroyed.
+    buffer.Destroy();
+    ASSERT_DEVICE_ERROR(queue.UpdateBufferTileMappings(buffer, 0, kSparseTileSize, true));
+}
+
+// Test the validation of the arguments of updateTextureTileMappings.
+TEST_F(SparseResourcesValidationTest, UpdateTextureTileMappings) {
+    wgpu::Texture texture = CreateTexture(512, 256, 2);
+
+    auto TestUpdate = [&](utils::Expectation expectation, uint32_t mipLevel, uint32_t arrayLayer,
+                          wgpu::Origin3D origin, wgpu::Extent3D size) {
+        if (expectation == utils::Expectation::Success) {
+            queue.UpdateTextureTileMappings(texture, mipLevel, arrayLayer, &origin, &size, true);
+        } else {
+            ASSERT_DEVICE_ERROR(queue.UpdateTextureTileMappings(texture, mipLevel, arrayLayer,
+                                                                &origin, &size, true));
+        }
+    };
+
+    TestUpdate(utils::Expectation::Success, 0, 0, {0, 0, 0}, {512, 256, 1});
+    TestUpdate(utils::Expectation::Success, 0, 1, {128, 128, 0}, {256, 128, 1});
+    TestUpdate(utils::Expectation::Success, 1, 0, {128, 0, 0}, {128, 128, 1});
+    TestUpdate(utils::Expectation::Success, 1, 1, {0, 0, 0}, {0, 0, 1});
+
+    // The subresource must be in the texture.
+    TestUpdate(utils::Expectation::Failure, 2, 0, {0, 0, 0}, {128, 128, 1});
+    TestUpdate(utils::Expectation::Failure, 0, 2, {0, 0, 0}, {128, 128, 1});
+
+    // The region must be made of whole tiles of a single array layer.
+    TestUpdate(utils::Expectation::Failure, 0, 0, {64, 0, 0}, {128, 128, 1});
+    TestUpdate(utils::Expectation::Failure, 0, 0, {0, 0, 0}, {128, 100, 1});
+    TestUpdate(utils::Expectation::Failure, 0, 0, {0, 0, 1}, {128, 128, 1});
+    TestUpdate(utils::Expectation::Failure, 0, 0, {0, 0, 0}, {128, 128, 2});
+
+    // The region must be within the mip level.
+    TestUpdate(utils::Expectation::Failure, 0, 0, {512, 0, 0}, {128, 128, 1});
+    TestUpdate(utils::Expectation::Failure, 0, 0, {0, 128, 0}, {128, 256, 1});
+    TestUpdate(utils::Expectation::Failure, 1, 0, {0, 0, 0}, {256, 256, 1});
+
+    // The texture must be sparse.
+    wgpu::TextureDescriptor descriptor;
+    descriptor.size = {128, 128, 1};
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.usage = wgpu::TextureUsage::Sampled;
+    wgpu::Texture denseTexture = device.CreateTexture(&descriptor);
+    wgpu::Origin3D origin = {0, 0, 0};
+    wgpu::Extent3D size = {128, 128, 1};
+    ASSERT_DEVICE_ERROR(queue.UpdateTextureTileMappings(denseTexture, 0, 0, &origin, &size, true));
+}
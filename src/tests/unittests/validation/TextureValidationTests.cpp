@@ -386,6 +386,110 @@ TEST_F(TextureValidationTest, TextureFormatUndefined) {
     ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
 }
 
+// Test that transient textures are destroyed once the command buffer using them is submitted.
+TEST_F(TextureValidationTest, TransientTextureDestroyedAfterSubmit) {
+    wgpu::TextureDescriptor descriptor = CreateDefaultTextureDescriptor();
+    descriptor.usage = wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::Transient;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    utils::ComboRenderPassDescriptor renderPass({texture.CreateView()});
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    {
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.EndPass();
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+
+    queue.Submit(1, &commands);
+
+    // Submit should fail because the transient texture was destroyed by the first submit
+    ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+}
+
+// Test it is an error to create a transient texture that can be presented.
+TEST_F(TextureValidationTest, TransientAndPresent) {
+    wgpu::TextureDescriptor descriptor = CreateDefaultTextureDescriptor();
+    descriptor.usage = wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::Transient;
+    device.CreateTexture(&descriptor);
+
+    descriptor.usage |= wgpu::TextureUsage::Present;
+    ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+}
+
+// Test that transient attachments can only be used as output attachments.
+TEST_F(TextureValidationTest, TransientAttachmentUsage) {
+    wgpu::TextureDescriptor descriptor = CreateDefaultTextureDescriptor();
+    descriptor.usage =
+        wgpu::TextureUsage::OutputAttachment | wgpu::TextureUsage::TransientAttachment;
+    device.CreateTexture(&descriptor);
+
+    // The OutputAttachment usage is required.
+    descriptor.usage = wgpu::TextureUsage::TransientAttachment;
+    ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+
+    // No other usage is allowed since the contents never leave the render passes.
+    for (wgpu::TextureUsage usage : {wgpu::TextureUsage::Sampled, wgpu::TextureUsage::CopySrc,
+                                     wgpu::TextureUsage::CopyDst, wgpu::TextureUsage::Storage}) {
+        descriptor.usage = wgpu::TextureUsage::OutputAttachment |
+                           wgpu::TextureUsage::TransientAttachment | usage;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+    }
+}
+
+// Test the validation of the residency priority of textures.
+TEST_F(TextureValidationTest, ResidencyPriority) {
+    wgpu::TextureDescriptor descriptor = CreateDefaultTextureDescriptor();
+    descriptor.residencyPriority = wgpu::ResidencyPriority::Maximum;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    descriptor.residencyPriority = static_cast<wgpu::ResidencyPriority>(0xFFFF);
+    ASSERT_DEVICE_ERROR(device.CreateTexture(&descriptor));
+
+    texture.SetResidencyPriority(wgpu::ResidencyPriority::Minimum);
+    ASSERT_DEVICE_ERROR(texture.SetResidencyPriority(static_cast<wgpu::ResidencyPriority>(0xFFFF)));
+
+    // Changing the priority of a destroyed texture is valid, it doesn't do anything.
+    texture.Destroy();
+    texture.SetResidencyPriority(wgpu::ResidencyPriority::High);
+}
+
+// Test that descriptors created repeatedly, whose validation is cached, are still validated for
+// each of their members.
+TEST_F(TextureValidationTest, RepeatedDescriptors) {
+    wgpu::TextureDescriptor descriptor = CreateDefaultTextureDescriptor();
+    for (uint32_t i = 0; i < 2; ++i) {
+        descriptor.label = i == 0 ? "first" : "second";
+        device.CreateTexture(&descriptor);
+    }
+
+    // A valid shape stays valid with another label and an invalid one stays invalid.
+    wgpu::TextureDescriptor invalidDescriptor = descriptor;
+    invalidDescriptor.sampleCount = 3;
+    for (uint32_t i = 0; i < 2; ++i) {
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&invalidDescriptor));
+        descriptor.label = nullptr;
+        device.CreateTexture(&descriptor);
+    }
+
+    // Each member is part of the key.
+    {
+        wgpu::TextureDescriptor other = descriptor;
+        other.mipLevelCount = 7;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&other));
+    }
+    {
+        wgpu::TextureDescriptor other = descriptor;
+        other.size.height = 0;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&other));
+    }
+    {
+        wgpu::TextureDescriptor other = descriptor;
+        other.format = wgpu::TextureFormat::Undefined;
+        ASSERT_DEVICE_ERROR(device.CreateTexture(&other));
+    }
+}
+
 // TODO(jiawei.shao@intel.com): add tests to verify we cannot create 1D or 3D textures with
 // compressed texture formats.
 class CompressedTextureFormatsValidationTests : public TextureValidationTest {
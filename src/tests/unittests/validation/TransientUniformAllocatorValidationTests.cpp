@@ -0,0 +1,108 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "common/Constants.h"
+#include "utils/WGPUHelpers.h"
+
+#include <array>
+#include <vector>
+
+class TransientUniformAllocatorValidationTest : public ValidationTest {
+  protected:
+    wgpu::TransientUniformAllocator CreateAllocator(uint64_t size) {
+        wgpu::TransientUniformAllocatorDescriptor descriptor;
+        descriptor.size = size;
+        return device.CreateTransientUniformAllocator(&descriptor);
+    }
+
+    void SubmitAndTick() {
+        wgpu::Queue queue = device.CreateQueue();
+        queue.Submit(0, nullptr);
+        device.Tick();
+    }
+
+    std::array<float, 4> mData = {1.0f, 2.0f, 3.0f, 4.0f};
+};
+
+// Test that the size of the ring must be a non-zero multiple of the dynamic offset alignment.
+TEST_F(TransientUniformAllocatorValidationTest, CreationSize) {
+    CreateAllocator(kMinDynamicBufferOffsetAlignment);
+    CreateAllocator(16 * kMinDynamicBufferOffsetAlignment);
+
+    ASSERT_DEVICE_ERROR(CreateAllocator(0));
+    ASSERT_DEVICE_ERROR(CreateAllocator(kMinDynamicBufferOffsetAlignment + 4));
+}
+
+// Test that the allocations are placed at offsets usable as dynamic offsets.
+TEST_F(TransientUniformAllocatorValidationTest, OffsetsAreAligned) {
+    wgpu::TransientUniformAllocator allocator =
+        CreateAllocator(4 * kMinDynamicBufferOffsetAlignment);
+
+    ASSERT_EQ(0u, allocator.Allocate(mData.data(), sizeof(mData)));
+    ASSERT_EQ(kMinDynamicBufferOffsetAlignment, allocator.Allocate(mData.data(), sizeof(mData)));
+    ASSERT_EQ(2 * kMinDynamicBufferOffsetAlignment,
+              allocator.Allocate(mData.data(), kMinDynamicBufferOffsetAlignment + 4));
+}
+
+// Test the invalid allocations.
+TEST_F(TransientUniformAllocatorValidationTest, AllocateErrors) {
+    wgpu::TransientUniformAllocator allocator =
+        CreateAllocator(2 * kMinDynamicBufferOffsetAlignment);
+
+    ASSERT_DEVICE_ERROR(
+        ASSERT_EQ(kInvalidTransientUniformOffset, allocator.Allocate(mData.data(), 0)));
+    ASSERT_DEVICE_ERROR(
+        ASSERT_EQ(kInvalidTransientUniformOffset, allocator.Allocate(nullptr, sizeof(mData))));
+
+    std::vector<uint8_t> large(3 * kMinDynamicBufferOffsetAlignment);
+    ASSERT_DEVICE_ERROR(ASSERT_EQ(kInvalidTransientUniformOffset,
+                                  allocator.Allocate(large.data(), large.size())));
+}
+
+// Test that a full ring fails the allocations without an error, and that the space is reused
+// once the commands of the serial completed.
+TEST_F(TransientUniformAllocatorValidationTest, FullRingIsReused) {
+    wgpu::TransientUniformAllocator allocator =
+        CreateAllocator(2 * kMinDynamicBufferOffsetAlignment);
+
+    ASSERT_NE(kInvalidTransientUniformOffset, allocator.Allocate(mData.data(), sizeof(mData)));
+    ASSERT_NE(kInvalidTransientUniformOffset, allocator.Allocate(mData.data(), sizeof(mData)));
+    ASSERT_EQ(kInvalidTransientUniformOffset, allocator.Allocate(mData.data(), sizeof(mData)));
+
+    SubmitAndTick();
+    ASSERT_NE(kInvalidTransientUniformOffset, allocator.Allocate(mData.data(), sizeof(mData)));
+}
+
+// Test that the buffer of the ring can be bound with dynamic offsets.
+TEST_F(TransientUniformAllocatorValidationTest, BufferIsDynamicUniform) {
+    wgpu::TransientUniformAllocator allocator =
+        CreateAllocator(4 * kMinDynamicBufferOffsetAlignment);
+
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer, true}});
+    utils::MakeBindGroup(device, layout,
+                         {{0, allocator.GetBuffer(), 0, kMinDynamicBufferOffsetAlignment}});
+}
+
+// Test that an error allocator fails its allocations and returns an error buffer.
+TEST_F(TransientUniformAllocatorValidationTest, ErrorAllocator) {
+    wgpu::TransientUniformAllocator allocator;
+    ASSERT_DEVICE_ERROR(allocator = CreateAllocator(0));
+
+    ASSERT_DEVICE_ERROR(ASSERT_EQ(kInvalidTransientUniformOffset,
+                                  allocator.Allocate(mData.data(), sizeof(mData))));
+    ASSERT_DEVICE_ERROR(allocator.GetBuffer());
+}
@@ -29,8 +29,10 @@ class ValidationTest : public testing::Test {
     ValidationTest();
     ~ValidationTest();
 
-    wgpu::Device CreateDeviceFromAdapter(dawn_native::Adapter adapter,
-                                         const std::vector<const char*>& requiredExtensions);
+    wgpu::Device CreateDeviceFromAdapter(
+        dawn_native::Adapter adapter,
+        const std::vector<const char*>& requiredExtensions,
+        const std::vector<const char*>& forceEnabledToggles = std::vector<const char*>());
 
     void TearDown() override;
 
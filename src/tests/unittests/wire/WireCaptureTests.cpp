@@ -0,0 +1,170 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/wire/WireTest.h"
+
+#include "dawn_wire/WireCapture.h"
+#include "dawn_wire/WireServer.h"
+#include "utils/TerribleCommandBuffer.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace dawn_wire;
+
+namespace {
+
+    // Records the batches of commands it receives.
+    class RecordingCommandHandler : public CommandHandler {
+      public:
+        const volatile char* HandleCommands(const volatile char* commands, size_t size) override {
+            batches.emplace_back(const_cast<const char*>(commands), size);
+            return commands + size;
+        }
+
+        std::vector<std::string> batches;
+    };
+
+    std::string GetTestCapturePath() {
+        return testing::TempDir() + "WireCaptureTests.dawncapture";
+    }
+
+    std::string ReadBatch(WireCaptureReader* reader) {
+        std::vector<char> commands;
+        if (!reader->ReadBatch(&commands)) {
+            return "";
+        }
+        return std::string(commands.begin(), commands.end());
+    }
+
+}  // anonymous namespace
+
+// Test that the recorder forwards the batches to its handler and that the reader reads them back
+// in order.
+TEST(WireCaptureRecorderTests, RoundTrip) {
+    std::string path = GetTestCapturePath();
+    RecordingCommandHandler handler;
+    {
+        WireCaptureRecorder recorder(path.c_str(), &handler);
+        ASSERT_TRUE(recorder.IsValid());
+
+        std::string first = "first";
+        std::string second(100000, 'a');
+        EXPECT_NE(recorder.HandleCommands(first.data(), first.size()), nullptr);
+        EXPECT_NE(recorder.HandleCommands(second.data(), second.size()), nullptr);
+        EXPECT_TRUE(recorder.IsValid());
+    }
+
+    ASSERT_EQ(handler.batches.size(), 2u);
+    EXPECT_EQ(handler.batches[0], "first");
+    EXPECT_EQ(handler.batches[1], std::string(100000, 'a'));
+
+    WireCaptureReader reader(path.c_str());
+    ASSERT_TRUE(reader.IsValid());
+    EXPECT_EQ(ReadBatch(&reader), "first");
+    EXPECT_EQ(ReadBatch(&reader), std::string(100000, 'a'));
+
+    std::vector<char> commands;
+    EXPECT_FALSE(reader.ReadBatch(&commands));
+}
+
+// Test that files which aren't captures, missing or truncated ones are rejected.
+TEST(WireCaptureRecorderTests, InvalidFiles) {
+    std::string path = GetTestCapturePath();
+
+    EXPECT_FALSE(WireCaptureReader((path + ".missing").c_str()).IsValid());
+
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file << "not a capture";
+    }
+    EXPECT_FALSE(WireCaptureReader(path.c_str()).IsValid());
+
+    {
+        WireCaptureRecorder recorder(path.c_str());
+        std::string commands = "commands";
+        recorder.HandleCommands(commands.data(), commands.size());
+    }
+    {
+        // Cut the last byte of the batch.
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+        file.close();
+
+        std::ofstream truncated(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        truncated.write(contents.data(), contents.size() - 1);
+    }
+
+    WireCaptureReader reader(path.c_str());
+    ASSERT_TRUE(reader.IsValid());
+    std::vector<char> commands;
+    EXPECT_FALSE(reader.ReadBatch(&commands));
+}
+
+class WireCaptureTests : public WireTest {
+  public:
+    WireCaptureTests() : mPath(GetTestCapturePath()) {
+    }
+    ~WireCaptureTests() override = default;
+
+  private:
+    const char* GetCapturePath() override {
+        return mPath.c_str();
+    }
+
+    std::string mPath;
+};
+
+// Test that a capture replays the same calls on a new server.
+TEST_F(WireCaptureTests, ReplayOnNewServer) {
+    wgpuDeviceCreateCommandEncoder(device, nullptr);
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr)).WillOnce(Return(apiEncoder));
+    FlushClient();
+
+    WireCaptureReader reader(GetTestCapturePath().c_str());
+    ASSERT_TRUE(reader.IsValid());
+
+    DawnProcTable mockProcs;
+    WGPUDevice unusedDevice;
+    api.GetProcTableAndDevice(&mockProcs, &unusedDevice);
+
+    // The replies of the replay server are dropped.
+    auto s2cBuf = std::make_unique<utils::TerribleCommandBuffer>();
+
+    EXPECT_CALL(api, OnDeviceSetUncapturedErrorCallback(apiDevice, _, _)).Times(1);
+    EXPECT_CALL(api, OnDeviceSetDeviceLostCallback(apiDevice, _, _)).Times(1);
+    WireServerDescriptor serverDesc = {};
+    serverDesc.device = apiDevice;
+    serverDesc.procs = &mockProcs;
+    serverDesc.serializer = s2cBuf.get();
+    auto replayServer = std::make_unique<WireServer>(serverDesc);
+
+    WGPUCommandEncoder replayedEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .WillOnce(Return(replayedEncoder));
+
+    std::vector<char> commands;
+    ASSERT_TRUE(reader.ReadBatch(&commands));
+    EXPECT_NE(replayServer->HandleCommands(commands.data(), commands.size()), nullptr);
+    EXPECT_FALSE(reader.ReadBatch(&commands));
+
+    // The replay server releases the objects it created.
+    EXPECT_CALL(api, CommandEncoderRelease(replayedEncoder)).Times(1);
+    replayServer = nullptr;
+}
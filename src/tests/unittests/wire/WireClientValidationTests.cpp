@@ -0,0 +1,154 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/wire/WireTest.h"
+
+using namespace testing;
+using namespace dawn_wire;
+
+namespace {
+
+    class MockBufferMapCallback {
+      public:
+        MOCK_METHOD2(Call, void(WGPUBufferMapAsyncStatus status, void* userdata));
+    };
+
+    std::unique_ptr<StrictMock<MockBufferMapCallback>> mockBufferMapCallback;
+    void ToMockBufferMapReadCallback(WGPUBufferMapAsyncStatus status,
+                                     const void*,
+                                     uint64_t,
+                                     void* userdata) {
+        mockBufferMapCallback->Call(status, userdata);
+    }
+    void ToMockBufferMapWriteCallback(WGPUBufferMapAsyncStatus status,
+                                      void*,
+                                      uint64_t,
+                                      void* userdata) {
+        mockBufferMapCallback->Call(status, userdata);
+    }
+
+}  // anonymous namespace
+
+class WireClientValidationTests : public WireTest {
+  public:
+    WireClientValidationTests() {
+    }
+    ~WireClientValidationTests() override = default;
+
+    void SetUp() override {
+        WireTest::SetUp();
+
+        mockBufferMapCallback = std::make_unique<StrictMock<MockBufferMapCallback>>();
+    }
+
+    void TearDown() override {
+        WireTest::TearDown();
+
+        mockBufferMapCallback = nullptr;
+    }
+
+  protected:
+    WGPUBuffer CreateBuffer(WGPUBufferUsageFlags usage, WGPUBuffer* apiBuffer) {
+        WGPUBufferDescriptor descriptor = {};
+        descriptor.usage = usage;
+        descriptor.size = 16;
+
+        *apiBuffer = api.GetNewBuffer();
+        WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &descriptor);
+        EXPECT_CALL(api, DeviceCreateBuffer(apiDevice, _)).WillOnce(Return(*apiBuffer));
+        FlushClient();
+        return buffer;
+    }
+
+    void ExpectValidationError() {
+        EXPECT_CALL(api,
+                    DeviceInjectError(apiDevice, WGPUErrorType_Validation, ValidStringMessage()))
+            .Times(1);
+    }
+
+  private:
+    bool UseClientValidation() override {
+        return true;
+    }
+};
+
+// Test that maps without the map usage fail on the client without being sent to the server.
+TEST_F(WireClientValidationTests, MapRequiresUsage) {
+    WGPUBuffer apiBuffer;
+    WGPUBuffer buffer = CreateBuffer(WGPUBufferUsage_MapWrite, &apiBuffer);
+
+    EXPECT_CALL(*mockBufferMapCallback, Call(WGPUBufferMapAsyncStatus_Error, this)).Times(1);
+    wgpuBufferMapReadAsync(buffer, ToMockBufferMapReadCallback, this);
+    Mock::VerifyAndClearExpectations(mockBufferMapCallback.get());
+
+    ExpectValidationError();
+    FlushClient();
+
+    // Maps with the correct usage are sent.
+    wgpuBufferMapWriteAsync(buffer, ToMockBufferMapWriteCallback, this);
+    EXPECT_CALL(api, OnBufferMapWriteAsyncCallback(apiBuffer, _, _)).Times(1);
+    FlushClient();
+
+    EXPECT_CALL(*mockBufferMapCallback, Call(WGPUBufferMapAsyncStatus_Unknown, this)).Times(1);
+}
+
+// Test that SetSubData and WriteBuffer check the alignment, range and usage on the client.
+TEST_F(WireClientValidationTests, Writes) {
+    WGPUBuffer apiBuffer;
+    WGPUBuffer buffer = CreateBuffer(WGPUBufferUsage_CopyDst, &apiBuffer);
+    WGPUBuffer apiMapBuffer;
+    WGPUBuffer mapBuffer = CreateBuffer(WGPUBufferUsage_MapRead, &apiMapBuffer);
+
+    WGPUQueue queue = wgpuDeviceCreateQueue(device, nullptr);
+    WGPUQueue apiQueue = api.GetNewQueue();
+    EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr)).WillOnce(Return(apiQueue));
+    FlushClient();
+
+    uint32_t data[8] = {};
+    wgpuBufferSetSubData(buffer, 2, 4, data);
+    wgpuBufferSetSubData(buffer, 8, 16, data);
+    wgpuBufferSetSubData(mapBuffer, 0, 4, data);
+    wgpuQueueWriteBuffer(queue, buffer, 0, data, 6);
+    ExpectValidationError();
+    ExpectValidationError();
+    ExpectValidationError();
+    ExpectValidationError();
+    FlushClient();
+
+    wgpuBufferSetSubData(buffer, 4, 8, data);
+    wgpuQueueWriteBuffer(queue, buffer, 0, data, 16);
+    EXPECT_CALL(api, BufferSetSubData(apiBuffer, 4, 8, _)).Times(1);
+    EXPECT_CALL(api, QueueWriteBuffer(apiQueue, apiBuffer, 0, _, 16)).Times(1);
+    FlushClient();
+}
+
+// Test that destroyed buffers can't be mapped or written.
+TEST_F(WireClientValidationTests, DestroyedBuffer) {
+    WGPUBuffer apiBuffer;
+    WGPUBuffer buffer = CreateBuffer(WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopyDst,
+                                     &apiBuffer);
+
+    wgpuBufferDestroy(buffer);
+    EXPECT_CALL(api, BufferDestroy(apiBuffer)).Times(1);
+    FlushClient();
+
+    EXPECT_CALL(*mockBufferMapCallback, Call(WGPUBufferMapAsyncStatus_Error, this)).Times(1);
+    wgpuBufferMapWriteAsync(buffer, ToMockBufferMapWriteCallback, this);
+
+    uint32_t data = 0;
+    wgpuBufferSetSubData(buffer, 0, 4, &data);
+    ExpectValidationError();
+    ExpectValidationError();
+    FlushClient();
+}
@@ -0,0 +1,220 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/wire/WireTest.h"
+
+#include "dawn_wire/WireClient.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace testing;
+using namespace dawn_wire;
+
+class WireCommandStreamTests : public WireTest {
+  public:
+    WireCommandStreamTests() {
+    }
+    ~WireCommandStreamTests() override = default;
+
+    void SetUp() override {
+        WireTest::SetUp();
+
+        queue = wgpuDeviceCreateQueue(device, nullptr);
+        apiQueue = api.GetNewQueue();
+        EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr)).WillOnce(Return(apiQueue));
+        FlushClient();
+    }
+
+  protected:
+    WGPUQueue queue;
+    WGPUQueue apiQueue;
+
+  private:
+    bool UseCommandStreams() override {
+        return true;
+    }
+};
+
+// Test that the commands of a thread's command stream are sent when the stream is flushed by a
+// queue submission.
+TEST_F(WireCommandStreamTests, FlushedBySubmit) {
+    GetWireClient()->BeginThreadCommandStream();
+
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+
+    // Nothing is sent before the submission.
+    FlushClient();
+
+    wgpuQueueSubmit(queue, 1, &commands);
+
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    WGPUCommandBuffer apiCommands = api.GetNewCommandBuffer();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr)).WillOnce(Return(apiEncoder));
+    EXPECT_CALL(api, CommandEncoderFinish(apiEncoder, nullptr)).WillOnce(Return(apiCommands));
+    EXPECT_CALL(api, QueueSubmit(apiQueue, 1, _));
+    FlushClient();
+
+    GetWireClient()->EndThreadCommandStream();
+}
+
+// Test that the ID of an object released in a command stream isn't reused by other streams
+// before the stream is flushed, and that the server accepts the IDs the stream skipped.
+TEST_F(WireCommandStreamTests, ReleasedIdReusedAfterFlush) {
+    GetWireClient()->BeginThreadCommandStream();
+    WGPUCommandEncoder streamEncoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    wgpuCommandEncoderRelease(streamEncoder);
+
+    // Recorded in the default stream, which is flushed first.
+    std::thread([&]() { wgpuDeviceCreateCommandEncoder(device, nullptr); }).join();
+
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr)).WillOnce(Return(apiEncoder));
+    FlushClient();
+
+    GetWireClient()->EndThreadCommandStream();
+
+    WGPUCommandEncoder apiStreamEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .WillOnce(Return(apiStreamEncoder));
+    EXPECT_CALL(api, CommandEncoderRelease(apiStreamEncoder));
+    FlushClient();
+}
+
+// Test that a stream is flushed before the ID of an object created in it gets too far past the
+// lowest unflushed ID, which is its own.
+TEST_F(WireCommandStreamTests, FlushedBeforeIdGapTooLarge) {
+    GetWireClient()->BeginThreadCommandStream();
+
+    // The commands can be sent while the encoders are created, once the serializer is full.
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .Times(kMaxObjectIdGap + 1)
+        .WillRepeatedly(Return(apiEncoder));
+    for (uint32_t i = 0; i < kMaxObjectIdGap + 2; ++i) {
+        wgpuDeviceCreateCommandEncoder(device, nullptr);
+    }
+    FlushClient();
+
+    GetWireClient()->EndThreadCommandStream();
+
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr)).WillOnce(Return(apiEncoder));
+    FlushClient();
+}
+
+// Test that creating an object waits for the stream of another thread to be flushed when the
+// stream holds an unflushed ID too far below the new one, and that the server accepts the largest
+// ID gap the client can make.
+TEST_F(WireCommandStreamTests, WaitsForOtherStreamBeforeIdGapTooLarge) {
+    GetWireClient()->BeginThreadCommandStream();
+    for (uint32_t i = 0; i < kMaxObjectIdGap; ++i) {
+        wgpuDeviceCreateCommandEncoder(device, nullptr);
+    }
+
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .Times(kMaxObjectIdGap + 2)
+        .WillRepeatedly(Return(apiEncoder));
+
+    std::atomic<uint32_t> createdCount(0);
+    std::thread otherThread([&]() {
+        GetWireClient()->BeginThreadCommandStream();
+
+        // Its ID is kMaxObjectIdGap past the IDs the server knows when it's received.
+        wgpuDeviceCreateCommandEncoder(device, nullptr);
+        GetWireClient()->FlushThreadCommandStream();
+        createdCount++;
+
+        wgpuDeviceCreateCommandEncoder(device, nullptr);
+        createdCount++;
+
+        GetWireClient()->EndThreadCommandStream();
+    });
+
+    while (createdCount == 0) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(createdCount, 1u);
+
+    GetWireClient()->FlushThreadCommandStream();
+    otherThread.join();
+    EXPECT_EQ(createdCount, 2u);
+
+    GetWireClient()->EndThreadCommandStream();
+    FlushClient();
+}
+
+// Test that threads waiting on each other's streams in the allocators of different object types
+// don't deadlock, since they flush their own stream before waiting.
+TEST_F(WireCommandStreamTests, CrossedWaitsDontDeadlock) {
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    WGPUQueue apiOtherQueue = api.GetNewQueue();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .Times(kMaxObjectIdGap + 2)
+        .WillRepeatedly(Return(apiEncoder));
+    EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr))
+        .Times(kMaxObjectIdGap + 2)
+        .WillRepeatedly(Return(apiOtherQueue));
+
+    GetWireClient()->BeginThreadCommandStream();
+    wgpuDeviceCreateCommandEncoder(device, nullptr);
+
+    std::atomic<bool> otherThreadStarted(false);
+    std::thread otherThread([&]() {
+        GetWireClient()->BeginThreadCommandStream();
+        wgpuDeviceCreateQueue(device, nullptr);
+        otherThreadStarted = true;
+
+        // The last encoder waits for the first encoder of the main thread's stream.
+        for (uint32_t i = 0; i < kMaxObjectIdGap + 1; ++i) {
+            wgpuDeviceCreateCommandEncoder(device, nullptr);
+        }
+        GetWireClient()->EndThreadCommandStream();
+    });
+
+    while (!otherThreadStarted) {
+        std::this_thread::yield();
+    }
+    // The last queue waits for the first queue of the other thread's stream.
+    for (uint32_t i = 0; i < kMaxObjectIdGap + 1; ++i) {
+        wgpuDeviceCreateQueue(device, nullptr);
+    }
+    GetWireClient()->FlushThreadCommandStream();
+    otherThread.join();
+
+    GetWireClient()->EndThreadCommandStream();
+    FlushClient();
+}
+
+class WireCommandStreamWithoutIdGapsTests : public WireCommandStreamTests {
+  private:
+    bool AllowObjectIdGaps() override {
+        return false;
+    }
+};
+
+// Test that the server rejects object ID gaps unless it allows them.
+TEST_F(WireCommandStreamWithoutIdGapsTests, IdGapRejected) {
+    GetWireClient()->BeginThreadCommandStream();
+    wgpuDeviceCreateCommandEncoder(device, nullptr);
+
+    // Recorded in the default stream, which is flushed first.
+    std::thread([&]() { wgpuDeviceCreateCommandEncoder(device, nullptr); }).join();
+    FlushClient(false);
+
+    GetWireClient()->EndThreadCommandStream();
+}
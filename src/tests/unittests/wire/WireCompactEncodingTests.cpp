@@ -0,0 +1,133 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/wire/WireTest.h"
+
+#include <array>
+
+using namespace testing;
+using namespace dawn_wire;
+
+class WireCompactEncodingTests : public WireTest {
+  public:
+    WireCompactEncodingTests() {
+    }
+    ~WireCompactEncodingTests() override = default;
+
+  protected:
+    WGPUBindGroup CreateBindGroup(WGPUBindGroup apiBindGroup) {
+        WGPUBindGroupLayoutDescriptor bglDescriptor = {};
+        WGPUBindGroupLayout bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDescriptor);
+        WGPUBindGroupLayout apiBgl = api.GetNewBindGroupLayout();
+        EXPECT_CALL(api, DeviceCreateBindGroupLayout(apiDevice, _)).WillOnce(Return(apiBgl));
+
+        WGPUBindGroupDescriptor bindGroupDescriptor = {};
+        bindGroupDescriptor.layout = bgl;
+        WGPUBindGroup bindGroup = wgpuDeviceCreateBindGroup(device, &bindGroupDescriptor);
+        EXPECT_CALL(api, DeviceCreateBindGroup(apiDevice, _)).WillOnce(Return(apiBindGroup));
+        return bindGroup;
+    }
+
+  private:
+    bool UseCompactEncoding() override {
+        return true;
+    }
+};
+
+// Test that the compact commands are received with their values and defaults, interleaved with
+// regular commands.
+TEST_F(WireCompactEncodingTests, ComputePass) {
+    WGPUBindGroup apiBindGroup = api.GetNewBindGroup();
+    WGPUBindGroup bindGroup = CreateBindGroup(apiBindGroup);
+
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
+
+    std::array<uint32_t, 3> testOffsets = {0, 256, 0xFFFF'FFFFu};
+    wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, testOffsets.size(), testOffsets.data());
+    wgpuComputePassEncoderSetBindGroup(pass, 1, bindGroup, 0, nullptr);
+    wgpuComputePassEncoderDispatch(pass, 1, 1, 1);
+    wgpuComputePassEncoderDispatch(pass, 0x12345678, 2, 0);
+    wgpuComputePassEncoderEndPass(pass);
+
+    WGPUCommandEncoder apiEncoder = api.GetNewCommandEncoder();
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr)).WillOnce(Return(apiEncoder));
+
+    WGPUComputePassEncoder apiPass = api.GetNewComputePassEncoder();
+    EXPECT_CALL(api, CommandEncoderBeginComputePass(apiEncoder, nullptr)).WillOnce(Return(apiPass));
+
+    {
+        InSequence sequence;
+        EXPECT_CALL(api, ComputePassEncoderSetBindGroup(
+                             apiPass, 0, apiBindGroup, testOffsets.size(),
+                             MatchesLambda([testOffsets](const uint32_t* offsets) -> bool {
+                                 for (size_t i = 0; i < testOffsets.size(); i++) {
+                                     if (offsets[i] != testOffsets[i]) {
+                                         return false;
+                                     }
+                                 }
+                                 return true;
+                             })));
+        EXPECT_CALL(api, ComputePassEncoderSetBindGroup(apiPass, 1, apiBindGroup, 0, nullptr));
+        EXPECT_CALL(api, ComputePassEncoderDispatch(apiPass, 1, 1, 1));
+        EXPECT_CALL(api, ComputePassEncoderDispatch(apiPass, 0x12345678, 2, 0));
+        EXPECT_CALL(api, ComputePassEncoderEndPass(apiPass));
+    }
+
+    FlushClient();
+}
+
+// Test that objects omitted because they are the same as in the previous command are tracked
+// separately for each command, and that signed values round-trip.
+TEST_F(WireCompactEncodingTests, RenderBundles) {
+    WGPUBufferDescriptor bufferDescriptor = {};
+    bufferDescriptor.size = 1024;
+    WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &bufferDescriptor);
+    WGPUBuffer apiBuffer = api.GetNewBuffer();
+    EXPECT_CALL(api, DeviceCreateBuffer(apiDevice, _)).WillOnce(Return(apiBuffer));
+
+    WGPURenderBundleEncoderDescriptor bundleDescriptor = {};
+    WGPURenderBundleEncoder bundleA =
+        wgpuDeviceCreateRenderBundleEncoder(device, &bundleDescriptor);
+    WGPURenderBundleEncoder bundleB =
+        wgpuDeviceCreateRenderBundleEncoder(device, &bundleDescriptor);
+    WGPURenderBundleEncoder apiBundleA = api.GetNewRenderBundleEncoder();
+    WGPURenderBundleEncoder apiBundleB = api.GetNewRenderBundleEncoder();
+    EXPECT_CALL(api, DeviceCreateRenderBundleEncoder(apiDevice, _))
+        .WillOnce(Return(apiBundleA))
+        .WillOnce(Return(apiBundleB));
+
+    wgpuRenderBundleEncoderSetVertexBuffer(bundleA, 0, buffer, 0);
+    wgpuRenderBundleEncoderSetVertexBuffer(bundleA, 1, buffer, 0xFFFF'FFFF'FFFFull);
+    wgpuRenderBundleEncoderSetIndexBuffer(bundleB, buffer, 16);
+    wgpuRenderBundleEncoderDrawIndexed(bundleA, 36, 1, 0, -3, 0);
+    wgpuRenderBundleEncoderDrawIndexed(bundleB, 6, 2, 3, 0x7FFF'FFFF, 1);
+    wgpuRenderBundleEncoderDrawIndexed(bundleA, 6, 1, 0, -0x7FFF'FFFF - 1, 0);
+    wgpuRenderBundleEncoderDraw(bundleB, 3, 1, 0, 0);
+
+    {
+        InSequence sequence;
+        EXPECT_CALL(api, RenderBundleEncoderSetVertexBuffer(apiBundleA, 0, apiBuffer, 0));
+        EXPECT_CALL(api, RenderBundleEncoderSetVertexBuffer(apiBundleA, 1, apiBuffer,
+                                                            0xFFFF'FFFF'FFFFull));
+        EXPECT_CALL(api, RenderBundleEncoderSetIndexBuffer(apiBundleB, apiBuffer, 16));
+        EXPECT_CALL(api, RenderBundleEncoderDrawIndexed(apiBundleA, 36, 1, 0, -3, 0));
+        EXPECT_CALL(api, RenderBundleEncoderDrawIndexed(apiBundleB, 6, 2, 3, 0x7FFF'FFFF, 1));
+        EXPECT_CALL(api,
+                    RenderBundleEncoderDrawIndexed(apiBundleA, 6, 1, 0, -0x7FFF'FFFF - 1, 0));
+        EXPECT_CALL(api, RenderBundleEncoderDraw(apiBundleB, 3, 1, 0, 0));
+    }
+
+    FlushClient();
+}
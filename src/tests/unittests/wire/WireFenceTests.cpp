@@ -44,9 +44,9 @@ class WireFenceTests : public WireTest {
             std::make_unique<StrictMock<MockFenceOnCompletionCallback>>();
 
         {
-            queue = wgpuDeviceCreateQueue(device);
+            queue = wgpuDeviceCreateQueue(device, nullptr);
             apiQueue = api.GetNewQueue();
-            EXPECT_CALL(api, DeviceCreateQueue(apiDevice)).WillOnce(Return(apiQueue));
+            EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr)).WillOnce(Return(apiQueue));
             FlushClient();
         }
         {
@@ -228,9 +228,9 @@ TEST_F(WireFenceTests, DestroyBeforeOnCompletionEnd) {
 
 // Test that signaling a fence on a wrong queue is invalid
 TEST_F(WireFenceTests, SignalWrongQueue) {
-    WGPUQueue queue2 = wgpuDeviceCreateQueue(device);
+    WGPUQueue queue2 = wgpuDeviceCreateQueue(device, nullptr);
     WGPUQueue apiQueue2 = api.GetNewQueue();
-    EXPECT_CALL(api, DeviceCreateQueue(apiDevice)).WillOnce(Return(apiQueue2));
+    EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr)).WillOnce(Return(apiQueue2));
     FlushClient();
 
     wgpuQueueSignal(queue2, fence, 2u);  // error
@@ -241,9 +241,9 @@ TEST_F(WireFenceTests, SignalWrongQueue) {
 
 // Test that signaling a fence on a wrong queue does not update fence signaled value
 TEST_F(WireFenceTests, SignalWrongQueueDoesNotUpdateValue) {
-    WGPUQueue queue2 = wgpuDeviceCreateQueue(device);
+    WGPUQueue queue2 = wgpuDeviceCreateQueue(device, nullptr);
     WGPUQueue apiQueue2 = api.GetNewQueue();
-    EXPECT_CALL(api, DeviceCreateQueue(apiDevice)).WillOnce(Return(apiQueue2));
+    EXPECT_CALL(api, DeviceCreateQueue(apiDevice, nullptr)).WillOnce(Return(apiQueue2));
     FlushClient();
 
     wgpuQueueSignal(queue2, fence, 2u);  // error
@@ -262,3 +262,37 @@ TEST_F(WireFenceTests, SignalWrongQueueDoesNotUpdateValue) {
     FlushServer();
     EXPECT_EQ(wgpuFenceGetCompletedValue(fence), 2u);
 }
+
+// Check that the completed value updates of a fence produced by a server device tick are
+// coalesced and still complete all the client callbacks.
+TEST_F(WireFenceTests, TickCoalescesCompletedValueUpdates) {
+    WGPUFenceOnCompletionCallback callbacks[2] = {};
+    void* userdatas[2] = {};
+
+    wgpuQueueSignal(queue, fence, 2u);
+    wgpuQueueSignal(queue, fence, 3u);
+    EXPECT_CALL(api, QueueSignal(apiQueue, apiFence, 2u)).Times(1);
+    EXPECT_CALL(api, QueueSignal(apiQueue, apiFence, 3u)).Times(1);
+    EXPECT_CALL(api, OnFenceOnCompletionCallback(apiFence, 2u, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&callbacks[0]), SaveArg<3>(&userdatas[0])));
+    EXPECT_CALL(api, OnFenceOnCompletionCallback(apiFence, 3u, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&callbacks[1]), SaveArg<3>(&userdatas[1])));
+    FlushClient();
+
+    wgpuFenceOnCompletion(fence, 2u, ToMockFenceOnCompletionCallback, this);
+    wgpuFenceOnCompletion(fence, 3u, ToMockFenceOnCompletionCallback, this);
+
+    // The server ticks the device before handling the next commands, the fences complete
+    // during the tick.
+    EXPECT_CALL(api, DeviceTick(apiDevice)).WillOnce(InvokeWithoutArgs([&]() {
+        callbacks[0](WGPUFenceCompletionStatus_Success, userdatas[0]);
+        callbacks[1](WGPUFenceCompletionStatus_Success, userdatas[1]);
+    }));
+    DoQueueSignal(4u);
+    FlushClient();
+
+    EXPECT_CALL(*mockFenceOnCompletionCallback, Call(WGPUFenceCompletionStatus_Success, this))
+        .Times(2);
+    FlushServer();
+    EXPECT_EQ(wgpuFenceGetCompletedValue(fence), 4u);
+}
@@ -0,0 +1,78 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/unittests/wire/WireTest.h"
+
+using namespace testing;
+using namespace dawn_wire;
+
+class WireNativeOnlyTests : public WireTest {
+  public:
+    WireNativeOnlyTests() {
+    }
+    ~WireNativeOnlyTests() override = default;
+
+  protected:
+    WGPURayTracingAccelerationContainer CreateContainer() {
+        WGPURayTracingAccelerationContainerDescriptor descriptor = {};
+        WGPURayTracingAccelerationContainer container =
+            wgpuDeviceCreateRayTracingAccelerationContainer(device, &descriptor);
+
+        WGPURayTracingAccelerationContainer apiContainer =
+            api.GetNewRayTracingAccelerationContainer();
+        EXPECT_CALL(api, DeviceCreateRayTracingAccelerationContainer(apiDevice, _))
+            .WillOnce(Return(apiContainer));
+        FlushClient();
+        return container;
+    }
+
+    void ExpectValidationError() {
+        EXPECT_CALL(api,
+                    DeviceInjectError(apiDevice, WGPUErrorType_Validation, ValidStringMessage()))
+            .Times(1);
+    }
+};
+
+// Test that getting the statistics of an acceleration container generates an error instead of
+// returning statistics the server didn't send.
+TEST_F(WireNativeOnlyTests, AccelerationContainerGetStatistics) {
+    WGPURayTracingAccelerationContainer container = CreateContainer();
+
+    WGPURayTracingAccelerationContainerStatistics statistics = {};
+    statistics.updateCount = 7;
+    wgpuRayTracingAccelerationContainerGetStatistics(container, &statistics);
+    EXPECT_EQ(statistics.updateCount, 7u);
+
+    ExpectValidationError();
+    FlushClient();
+}
+
+// Test that the memory info queries of acceleration containers generate an error instead of
+// returning sizes the server didn't send.
+TEST_F(WireNativeOnlyTests, AccelerationContainerMemoryInfo) {
+    WGPURayTracingAccelerationContainer container = CreateContainer();
+
+    WGPURayTracingAccelerationContainerMemoryInfo info = {};
+    info.resultSize = 7;
+    wgpuRayTracingAccelerationContainerGetMemoryInfo(container, &info);
+    EXPECT_EQ(info.resultSize, 7u);
+
+    wgpuDeviceGetRayTracingAccelerationContainerMemoryInfo(device, &info);
+    EXPECT_EQ(info.resultSize, 7u);
+
+    ExpectValidationError();
+    ExpectValidationError();
+    FlushClient();
+}
@@ -0,0 +1,280 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_wire/RingBufferCommandSerializer.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dawn_wire;
+
+namespace {
+
+    // Records the batches of commands it receives.
+    class RecordingCommandHandler : public CommandHandler {
+      public:
+        const volatile char* HandleCommands(const volatile char* commands, size_t size) override {
+            batches.emplace_back(const_cast<const char*>(commands), size);
+            received += batches.back();
+            return commands + size;
+        }
+
+        std::vector<std::string> batches;
+        std::string received;
+    };
+
+    void WriteCommand(CommandSerializer* serializer, const std::string& command) {
+        void* space = serializer->GetCmdSpace(command.size());
+        ASSERT_NE(space, nullptr);
+        memcpy(space, command.data(), command.size());
+    }
+
+    std::string MakeCommand(size_t size, char seed) {
+        std::string command(size, 0);
+        for (size_t i = 0; i < size; ++i) {
+            command[i] = static_cast<char>(seed + i);
+        }
+        return command;
+    }
+
+}  // anonymous namespace
+
+// Test that commands are only visible to the reader once they are flushed, in a single batch.
+TEST(WireRingBufferCommandSerializerTests, FlushPublishesBatch) {
+    CommandRingBuffer ring(1024);
+    RingBufferCommandSerializer serializer(&ring);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    WriteCommand(&serializer, "first");
+    WriteCommand(&serializer, "second");
+    EXPECT_FALSE(reader.HasCommands());
+
+    serializer.Flush();
+    EXPECT_TRUE(reader.HasCommands());
+    EXPECT_TRUE(reader.HandleCommands(&handler));
+    EXPECT_FALSE(reader.HasCommands());
+
+    ASSERT_EQ(handler.batches.size(), 1u);
+    EXPECT_EQ(handler.batches[0], "firstsecond");
+}
+
+// Test that the commands stay in order when the ring wraps around many times.
+TEST(WireRingBufferCommandSerializerTests, WrapsAround) {
+    CommandRingBuffer ring(256);
+    RingBufferCommandSerializer serializer(&ring);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    std::string expected;
+    for (uint32_t i = 0; i < 100; ++i) {
+        std::string command = MakeCommand(1 + (i * 7) % 40, static_cast<char>(i));
+        WriteCommand(&serializer, command);
+        expected += command;
+        serializer.Flush();
+        EXPECT_TRUE(reader.HandleCommands(&handler));
+    }
+
+    EXPECT_EQ(handler.received, expected);
+}
+
+// Test that commands larger than a record are reassembled by the reader.
+TEST(WireRingBufferCommandSerializerTests, LargeCommands) {
+    CommandRingBuffer ring(256);
+    RingBufferCommandSerializer serializer(&ring);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    // The chunks don't all fit in the ring at once, so the reader drains it on another thread.
+    std::string large = MakeCommand(1000, 3);
+    std::string expected = "small" + large + "after";
+    std::thread consumer([&]() {
+        while (handler.received.size() < expected.size()) {
+            ASSERT_TRUE(reader.HandleCommands(&handler));
+            std::this_thread::yield();
+        }
+    });
+    WriteCommand(&serializer, "small");
+    WriteCommand(&serializer, large);
+    WriteCommand(&serializer, "after");
+    serializer.Flush();
+    consumer.join();
+
+    ASSERT_EQ(handler.batches.size(), 3u);
+    EXPECT_EQ(handler.batches[0], "small");
+    EXPECT_EQ(handler.batches[1], large);
+    EXPECT_EQ(handler.batches[2], "after");
+}
+
+// Test that the reader rejects batches reassembled from chunks once they exceed its maximum batch
+// size, and accepts them up to it.
+TEST(WireRingBufferCommandSerializerTests, MaxBatchSize) {
+    std::string large = MakeCommand(1000, 5);
+
+    // The Report mode doesn't wait for the reader, so the test can alternate between the
+    // serializer and the reader on a single thread.
+    RingBufferCommandSerializerDescriptor descriptor;
+    descriptor.backpressureMode = RingBufferBackpressureMode::Report;
+
+    {
+        CommandRingBuffer ring(256);
+        RingBufferCommandSerializer serializer(&ring, descriptor);
+        RingBufferCommandReader reader(&ring, large.size());
+        RecordingCommandHandler handler;
+
+        WriteCommand(&serializer, large);
+        serializer.Flush();
+        for (uint32_t i = 0; i < 100 && handler.batches.empty(); ++i) {
+            ASSERT_TRUE(reader.HandleCommands(&handler));
+            serializer.Flush();
+        }
+        ASSERT_EQ(handler.batches.size(), 1u);
+        EXPECT_EQ(handler.batches[0], large);
+    }
+
+    {
+        CommandRingBuffer ring(256);
+        RingBufferCommandSerializer serializer(&ring, descriptor);
+        RingBufferCommandReader reader(&ring, large.size() - 1);
+        RecordingCommandHandler handler;
+
+        WriteCommand(&serializer, large);
+        serializer.Flush();
+        bool success = true;
+        for (uint32_t i = 0; i < 100 && success; ++i) {
+            success = reader.HandleCommands(&handler);
+            serializer.Flush();
+        }
+        EXPECT_FALSE(success);
+        EXPECT_TRUE(handler.batches.empty());
+    }
+}
+
+// Test that batches are published once they reach the flush threshold.
+TEST(WireRingBufferCommandSerializerTests, FlushThreshold) {
+    CommandRingBuffer ring(1024);
+    RingBufferCommandSerializerDescriptor descriptor;
+    descriptor.flushThreshold = 16;
+    descriptor.flushOnEndFrame = false;
+    RingBufferCommandSerializer serializer(&ring, descriptor);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    WriteCommand(&serializer, "0123456789");
+    WriteCommand(&serializer, "0123456789");
+    EXPECT_FALSE(reader.HasCommands());
+
+    // The batch is over the threshold, it is published when the next command starts.
+    WriteCommand(&serializer, "abc");
+    EXPECT_TRUE(reader.HandleCommands(&handler));
+    ASSERT_EQ(handler.batches.size(), 1u);
+    EXPECT_EQ(handler.batches[0], "01234567890123456789");
+
+    serializer.EndFrame();
+    EXPECT_FALSE(reader.HasCommands());
+    serializer.Flush();
+    EXPECT_TRUE(reader.HandleCommands(&handler));
+    EXPECT_EQ(handler.batches.back(), "abc");
+}
+
+// Test that in the Report mode, commands are queued on the client when the ring is full.
+TEST(WireRingBufferCommandSerializerTests, ReportBackpressure) {
+    CommandRingBuffer ring(256);
+    RingBufferCommandSerializerDescriptor descriptor;
+    descriptor.backpressureMode = RingBufferBackpressureMode::Report;
+    uint32_t reportCount = 0;
+    descriptor.backpressureCallback = [&](size_t) { reportCount++; };
+    RingBufferCommandSerializer serializer(&ring, descriptor);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    std::string expected;
+    for (uint32_t i = 0; i < 20; ++i) {
+        std::string command = MakeCommand(32, static_cast<char>(i));
+        WriteCommand(&serializer, command);
+        expected += command;
+        serializer.Flush();
+    }
+    EXPECT_EQ(reportCount, 1u);
+    EXPECT_GT(serializer.GetQueuedSize(), 0u);
+
+    // The queued commands are moved to the ring as the reader makes space.
+    while (serializer.GetQueuedSize() > 0) {
+        EXPECT_TRUE(reader.HandleCommands(&handler));
+        serializer.Flush();
+    }
+    EXPECT_TRUE(reader.HandleCommands(&handler));
+    EXPECT_EQ(handler.received, expected);
+
+    // The callback is called again once the ring is full again.
+    for (uint32_t i = 0; i < 20; ++i) {
+        WriteCommand(&serializer, MakeCommand(32, 0));
+        serializer.Flush();
+    }
+    EXPECT_EQ(reportCount, 2u);
+}
+
+// Test that the reader rejects a corrupted ring.
+TEST(WireRingBufferCommandSerializerTests, CorruptedRing) {
+    std::vector<uint64_t> memory(CommandRingBuffer::GetMemorySize(256) / sizeof(uint64_t));
+    CommandRingBuffer ring(memory.data(), 256, true);
+    RingBufferCommandSerializer serializer(&ring);
+    WriteCommand(&serializer, "command");
+    serializer.Flush();
+
+    // Make the record larger than the ring.
+    CommandRingBuffer otherRing(memory.data(), 256, false);
+    char* data = reinterpret_cast<char*>(memory.data()) +
+                 CommandRingBuffer::GetMemorySize(256) - 256;
+    uint32_t size = 1000;
+    memcpy(data + sizeof(uint32_t), &size, sizeof(size));
+
+    RingBufferCommandReader reader(&otherRing);
+    RecordingCommandHandler handler;
+    EXPECT_FALSE(reader.HandleCommands(&handler));
+    EXPECT_TRUE(handler.batches.empty());
+}
+
+// Test a serializer and a reader on different threads in the Block mode.
+TEST(WireRingBufferCommandSerializerTests, BlockingProducerConsumer) {
+    CommandRingBuffer ring(512);
+    RingBufferCommandSerializerDescriptor descriptor;
+    descriptor.flushThreshold = 64;
+    RingBufferCommandSerializer serializer(&ring, descriptor);
+    RingBufferCommandReader reader(&ring);
+    RecordingCommandHandler handler;
+
+    constexpr uint32_t kCommandCount = 2000;
+    std::string expected;
+    for (uint32_t i = 0; i < kCommandCount; ++i) {
+        expected += MakeCommand(1 + (i * 13) % 200, static_cast<char>(i));
+    }
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < kCommandCount; ++i) {
+            WriteCommand(&serializer, MakeCommand(1 + (i * 13) % 200, static_cast<char>(i)));
+        }
+        serializer.Flush();
+    });
+    while (handler.received.size() < expected.size()) {
+        ASSERT_TRUE(reader.HandleCommands(&handler));
+    }
+    producer.join();
+
+    EXPECT_EQ(handler.received, expected);
+}
@@ -0,0 +1,130 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_wire/WireServerThread.h"
+
+#include <string>
+#include <thread>
+
+using namespace dawn_wire;
+
+namespace {
+
+    // Records the commands it handles and the thread it handles them on, fails on "fail".
+    class RecordingServer : public CommandHandler {
+      public:
+        const volatile char* HandleCommands(const volatile char* commands, size_t size) override {
+            std::string batch(const_cast<const char*>(commands), size);
+            received += batch + ";";
+            threadId = std::this_thread::get_id();
+            if (batch == "fail") {
+                return nullptr;
+            }
+            return commands + size;
+        }
+
+        std::string received;
+        std::thread::id threadId;
+    };
+
+    class CountingSerializer : public CommandSerializer {
+      public:
+        void* GetCmdSpace(size_t size) override {
+            return nullptr;
+        }
+        bool Flush() override {
+            flushCount++;
+            return true;
+        }
+
+        uint32_t flushCount = 0;
+    };
+
+    void SendCommands(CommandHandler* handler, std::string commands) {
+        ASSERT_NE(handler->HandleCommands(commands.data(), commands.size()), nullptr);
+    }
+
+}  // anonymous namespace
+
+// Test that the commands are handled in order on another thread and that the return commands are
+// flushed after each batch.
+TEST(WireServerThreadTests, HandlesCommandsOnThread) {
+    RecordingServer server;
+    CountingSerializer returnSerializer;
+
+    WireServerThreadDescriptor descriptor;
+    descriptor.server = &server;
+    descriptor.returnSerializer = &returnSerializer;
+    WireServerThread thread(descriptor);
+
+    // The commands are copied so the buffer can be reused immediately.
+    std::string commands = "first";
+    SendCommands(&thread, commands);
+    commands = "second";
+    SendCommands(&thread, commands);
+
+    EXPECT_TRUE(thread.Wait());
+    EXPECT_EQ(server.received, "first;second;");
+    EXPECT_NE(server.threadId, std::this_thread::get_id());
+    EXPECT_EQ(returnSerializer.flushCount, 2u);
+}
+
+// Test that tasks run in order with the commands.
+TEST(WireServerThreadTests, PostTask) {
+    RecordingServer server;
+    WireServerThreadDescriptor descriptor;
+    descriptor.server = &server;
+    WireServerThread thread(descriptor);
+
+    SendCommands(&thread, "before");
+    thread.PostTask([&]() { server.received += "task;"; });
+    SendCommands(&thread, "after");
+
+    EXPECT_TRUE(thread.Wait());
+    EXPECT_EQ(server.received, "before;task;after;");
+}
+
+// Test that the commands after a failure are dropped.
+TEST(WireServerThreadTests, Failure) {
+    RecordingServer server;
+    WireServerThreadDescriptor descriptor;
+    descriptor.server = &server;
+    WireServerThread thread(descriptor);
+
+    SendCommands(&thread, "fail");
+    // These are either rejected or dropped depending on whether the failure already happened.
+    std::string dropped = "dropped";
+    thread.HandleCommands(dropped.data(), dropped.size());
+    EXPECT_FALSE(thread.Wait());
+    EXPECT_EQ(server.received, "fail;");
+
+    std::string commands = "rejected";
+    EXPECT_EQ(thread.HandleCommands(commands.data(), commands.size()), nullptr);
+}
+
+// Test that the destructor handles the remaining commands.
+TEST(WireServerThreadTests, DestructionDrainsCommands) {
+    RecordingServer server;
+    {
+        WireServerThreadDescriptor descriptor;
+        descriptor.server = &server;
+        WireServerThread thread(descriptor);
+        for (uint32_t i = 0; i < 100; ++i) {
+            SendCommands(&thread, "a");
+        }
+    }
+    EXPECT_EQ(server.received.size(), 200u);
+}
@@ -0,0 +1,337 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/Platform.h"
+#include "dawn_wire/SharedMemoryTransferService.h"
+
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#if defined(DAWN_PLATFORM_WINDOWS)
+#    include "common/windows_with_undefs.h"
+#else
+#    include <unistd.h>
+#    if defined(DAWN_PLATFORM_LINUX)
+#        include <sys/syscall.h>
+#    endif
+#endif
+
+using namespace dawn_wire;
+
+namespace {
+
+    // Passes the regions between the client and the server of the same process by duplicating
+    // their handles.
+    class InProcessSharedMemoryTransport : public client::SharedMemoryExporter,
+                                           public server::SharedMemoryImporter {
+      public:
+        ~InProcessSharedMemoryTransport() override {
+            for (auto& it : mHandles) {
+                CloseHandle(it.second);
+            }
+        }
+
+        uint64_t ExportSharedMemory(SharedMemoryHandle handle, size_t size) override {
+            SharedMemoryHandle duplicate;
+#if defined(DAWN_PLATFORM_WINDOWS)
+            if (!::DuplicateHandle(::GetCurrentProcess(), handle, ::GetCurrentProcess(),
+                                   &duplicate, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+                return 0;
+            }
+#else
+            duplicate = dup(handle);
+            if (duplicate < 0) {
+                return 0;
+            }
+#endif
+            uint64_t id = mNextId++;
+            mHandles[id] = duplicate;
+            return id;
+        }
+
+        bool ImportSharedMemory(uint64_t id, SharedMemoryHandle* handle) override {
+            auto it = mHandles.find(id);
+            if (it == mHandles.end()) {
+                return false;
+            }
+            *handle = it->second;
+            mHandles.erase(it);
+            return true;
+        }
+
+      private:
+        static void CloseHandle(SharedMemoryHandle handle) {
+#if defined(DAWN_PLATFORM_WINDOWS)
+            ::CloseHandle(handle);
+#else
+            close(handle);
+#endif
+        }
+
+        uint64_t mNextId = 1;
+        std::map<uint64_t, SharedMemoryHandle> mHandles;
+    };
+
+    class WireSharedMemoryTransferServiceTests : public testing::Test {
+      protected:
+        void SetUp() override {
+#if defined(DAWN_PLATFORM_FUCHSIA)
+            GTEST_SKIP();
+#endif
+            mClientService = client::CreateSharedMemoryTransferService(&mTransport);
+            mServerService = server::CreateSharedMemoryTransferService(&mTransport);
+        }
+
+        // Creates the server side of |clientHandle| and targets it at |target|.
+        std::unique_ptr<server::MemoryTransferService::WriteHandle> CreateServerWriteHandle(
+            client::MemoryTransferService::WriteHandle* clientHandle,
+            void* target,
+            size_t targetSize) {
+            std::vector<char> createInfo = SerializeCreate(clientHandle);
+            server::MemoryTransferService::WriteHandle* serverHandle = nullptr;
+            if (!mServerService->DeserializeWriteHandle(createInfo.data(), createInfo.size(),
+                                                        &serverHandle)) {
+                return nullptr;
+            }
+            serverHandle->SetTarget(target, targetSize);
+            return std::unique_ptr<server::MemoryTransferService::WriteHandle>(serverHandle);
+        }
+
+        // Writes |value| in the data of |clientHandle| and flushes it to |serverHandle|.
+        bool WriteAndFlush(client::MemoryTransferService::WriteHandle* clientHandle,
+                           server::MemoryTransferService::WriteHandle* serverHandle,
+                           char value) {
+            void* data = nullptr;
+            size_t dataLength = 0;
+            std::tie(data, dataLength) = clientHandle->Open();
+            memset(data, value, dataLength);
+
+            std::vector<char> flush(clientHandle->SerializeFlushSize());
+            clientHandle->SerializeFlush(flush.data());
+            return serverHandle->DeserializeFlush(flush.data(), flush.size());
+        }
+
+        template <typename Handle>
+        std::vector<char> SerializeCreate(Handle* handle) {
+            std::vector<char> createInfo(handle->SerializeCreateSize());
+            handle->SerializeCreate(createInfo.data());
+            return createInfo;
+        }
+
+        InProcessSharedMemoryTransport mTransport;
+        std::unique_ptr<client::MemoryTransferService> mClientService;
+        std::unique_ptr<server::MemoryTransferService> mServerService;
+    };
+
+}  // anonymous namespace
+
+// Test that the data of a ReadHandle is written by the server in the shared memory.
+TEST_F(WireSharedMemoryTransferServiceTests, ReadHandle) {
+    constexpr uint32_t kData[] = {0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10,
+                                  0x11121314, 0x15161718, 0x191A1B1C, 0x1D1E1F20};
+
+    std::unique_ptr<client::MemoryTransferService::ReadHandle> clientHandle(
+        mClientService->CreateReadHandle(sizeof(kData)));
+    ASSERT_NE(clientHandle, nullptr);
+
+    std::vector<char> createInfo = SerializeCreate(clientHandle.get());
+    server::MemoryTransferService::ReadHandle* serverHandlePtr = nullptr;
+    ASSERT_TRUE(mServerService->DeserializeReadHandle(createInfo.data(), createInfo.size(),
+                                                      &serverHandlePtr));
+    std::unique_ptr<server::MemoryTransferService::ReadHandle> serverHandle(serverHandlePtr);
+
+    // Only the size of the data goes through the command stream.
+    std::vector<char> initialData(serverHandle->SerializeInitialDataSize(kData, sizeof(kData)));
+    EXPECT_LT(initialData.size(), sizeof(kData));
+    serverHandle->SerializeInitialData(kData, sizeof(kData), initialData.data());
+
+    const void* data = nullptr;
+    size_t dataLength = 0;
+    ASSERT_TRUE(clientHandle->DeserializeInitialData(initialData.data(), initialData.size(),
+                                                     &data, &dataLength));
+    ASSERT_EQ(dataLength, sizeof(kData));
+    EXPECT_EQ(memcmp(data, kData, sizeof(kData)), 0);
+}
+
+// Test that the data of a WriteHandle is copied by the server from the shared memory.
+TEST_F(WireSharedMemoryTransferServiceTests, WriteHandle) {
+    constexpr uint32_t kData[] = {0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10,
+                                  0x11121314, 0x15161718, 0x191A1B1C, 0x1D1E1F20};
+
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle(
+        mClientService->CreateWriteHandle(sizeof(kData)));
+    ASSERT_NE(clientHandle, nullptr);
+
+    std::vector<char> createInfo = SerializeCreate(clientHandle.get());
+    server::MemoryTransferService::WriteHandle* serverHandlePtr = nullptr;
+    ASSERT_TRUE(mServerService->DeserializeWriteHandle(createInfo.data(), createInfo.size(),
+                                                       &serverHandlePtr));
+    std::unique_ptr<server::MemoryTransferService::WriteHandle> serverHandle(serverHandlePtr);
+
+    uint32_t target[8] = {};
+    serverHandle->SetTarget(target, sizeof(target));
+
+    // The mapping is zero-initialized.
+    void* data = nullptr;
+    size_t dataLength = 0;
+    std::tie(data, dataLength) = clientHandle->Open();
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(dataLength, sizeof(kData));
+    std::vector<char> zeroes(sizeof(kData), 0);
+    EXPECT_EQ(memcmp(data, zeroes.data(), sizeof(kData)), 0);
+
+    memcpy(data, kData, sizeof(kData));
+
+    std::vector<char> flush(clientHandle->SerializeFlushSize());
+    EXPECT_LT(flush.size(), sizeof(kData));
+    clientHandle->SerializeFlush(flush.data());
+    ASSERT_TRUE(serverHandle->DeserializeFlush(flush.data(), flush.size()));
+    EXPECT_EQ(memcmp(target, kData, sizeof(kData)), 0);
+}
+
+// Test that the server rejects handles larger than their shared memory region.
+TEST_F(WireSharedMemoryTransferServiceTests, HandleLargerThanRegion) {
+    std::unique_ptr<client::MemoryTransferService::ReadHandle> clientHandle(
+        mClientService->CreateReadHandle(16));
+    ASSERT_NE(clientHandle, nullptr);
+
+    std::vector<char> createInfo = SerializeCreate(clientHandle.get());
+    // The size is serialized after the identifier of the region.
+    uint64_t hugeSize = uint64_t(1) << 40;
+    memcpy(createInfo.data() + sizeof(uint64_t), &hugeSize, sizeof(hugeSize));
+
+    server::MemoryTransferService::ReadHandle* serverHandle = nullptr;
+    EXPECT_FALSE(
+        mServerService->DeserializeReadHandle(createInfo.data(), createInfo.size(), &serverHandle));
+}
+
+// Test that the server rejects handles of regions that weren't exported.
+TEST_F(WireSharedMemoryTransferServiceTests, UnknownRegion) {
+    uint64_t createInfo[4] = {1234, 16, 0, 0};
+    server::MemoryTransferService::WriteHandle* serverHandle = nullptr;
+    EXPECT_FALSE(
+        mServerService->DeserializeWriteHandle(createInfo, sizeof(createInfo), &serverHandle));
+}
+
+#if defined(DAWN_PLATFORM_LINUX) && !defined(DAWN_PLATFORM_ANDROID)
+// Test that the server rejects memfds whose size isn't sealed, which the client could shrink
+// while the server accesses them.
+TEST_F(WireSharedMemoryTransferServiceTests, UnsealedRegion) {
+    // MFD_CLOEXEC, without MFD_ALLOW_SEALING.
+    int fd = static_cast<int>(syscall(__NR_memfd_create, "unsealed", 1u));
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, 16), 0);
+    uint64_t id = mTransport.ExportSharedMemory(fd, 16);
+    close(fd);
+    ASSERT_NE(id, 0u);
+
+    uint64_t createInfo[4] = {id, 16, 0, 0};
+    server::MemoryTransferService::WriteHandle* serverHandle = nullptr;
+    EXPECT_FALSE(
+        mServerService->DeserializeWriteHandle(createInfo, sizeof(createInfo), &serverHandle));
+}
+#endif
+
+// Test that WriteHandles are sub-allocated from the transfer region and that the ranges are only
+// reused once the server copied their data.
+TEST_F(WireSharedMemoryTransferServiceTests, TransferRegion) {
+    constexpr size_t kRegionSize = 4096;
+    constexpr size_t kHandleSize = 1024;
+    mClientService = client::CreateSharedMemoryTransferService(&mTransport, kRegionSize);
+
+    std::vector<char> target(kHandleSize);
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle1(
+        mClientService->CreateWriteHandle(kHandleSize));
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle2(
+        mClientService->CreateWriteHandle(kHandleSize));
+    ASSERT_NE(clientHandle1, nullptr);
+    ASSERT_NE(clientHandle2, nullptr);
+
+    // Both handles are in the same region, which is only imported once.
+    char* data1 = static_cast<char*>(clientHandle1->Open().first);
+    char* data2 = static_cast<char*>(clientHandle2->Open().first);
+    EXPECT_EQ(data2 - data1, static_cast<ptrdiff_t>(kHandleSize));
+
+    auto serverHandle1 = CreateServerWriteHandle(clientHandle1.get(), target.data(), kHandleSize);
+    auto serverHandle2 = CreateServerWriteHandle(clientHandle2.get(), target.data(), kHandleSize);
+    ASSERT_NE(serverHandle1, nullptr);
+    ASSERT_NE(serverHandle2, nullptr);
+
+    ASSERT_TRUE(WriteAndFlush(clientHandle1.get(), serverHandle1.get(), 1));
+    EXPECT_EQ(target[0], 1);
+
+    // The second handle was flushed but the server didn't copy its data yet so its range isn't
+    // reused.
+    std::vector<char> flush(clientHandle2->SerializeFlushSize());
+    clientHandle2->SerializeFlush(flush.data());
+    clientHandle2 = nullptr;
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle3(
+        mClientService->CreateWriteHandle(kHandleSize));
+    ASSERT_NE(clientHandle3, nullptr);
+    EXPECT_NE(clientHandle3->Open().first, data2);
+
+    // Once the server copied the data, the range is reused and zero-initialized.
+    ASSERT_TRUE(serverHandle2->DeserializeFlush(flush.data(), flush.size()));
+    EXPECT_EQ(target[0], 0);
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle4(
+        mClientService->CreateWriteHandle(kHandleSize));
+    ASSERT_NE(clientHandle4, nullptr);
+    char* data4 = static_cast<char*>(clientHandle4->Open().first);
+    EXPECT_EQ(data4, data2);
+    EXPECT_EQ(data4[0], 0);
+
+    auto serverHandle4 = CreateServerWriteHandle(clientHandle4.get(), target.data(), kHandleSize);
+    ASSERT_NE(serverHandle4, nullptr);
+    ASSERT_TRUE(WriteAndFlush(clientHandle4.get(), serverHandle4.get(), 4));
+    EXPECT_EQ(target[kHandleSize - 1], 4);
+}
+
+// Test that WriteHandles that don't fit in the transfer region get their own region.
+TEST_F(WireSharedMemoryTransferServiceTests, TransferRegionFallback) {
+    constexpr size_t kRegionSize = 4096;
+    mClientService = client::CreateSharedMemoryTransferService(&mTransport, kRegionSize);
+
+    std::vector<char> target(kRegionSize);
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle(
+        mClientService->CreateWriteHandle(kRegionSize));
+    ASSERT_NE(clientHandle, nullptr);
+
+    auto serverHandle = CreateServerWriteHandle(clientHandle.get(), target.data(), kRegionSize);
+    ASSERT_NE(serverHandle, nullptr);
+    ASSERT_TRUE(WriteAndFlush(clientHandle.get(), serverHandle.get(), 7));
+    EXPECT_EQ(target[kRegionSize - 1], 7);
+}
+
+// Test that the server rejects transfer region handles that overlap the region's header or don't
+// fit in the region.
+TEST_F(WireSharedMemoryTransferServiceTests, TransferRegionOutOfBounds) {
+    mClientService = client::CreateSharedMemoryTransferService(&mTransport, 4096);
+
+    std::unique_ptr<client::MemoryTransferService::WriteHandle> clientHandle(
+        mClientService->CreateWriteHandle(16));
+    ASSERT_NE(clientHandle, nullptr);
+    std::vector<char> createInfo = SerializeCreate(clientHandle.get());
+
+    // The offset is serialized after the identifier, the size and the size of the region.
+    for (uint64_t offset : {uint64_t(0), uint64_t(4090)}) {
+        memcpy(createInfo.data() + 3 * sizeof(uint64_t), &offset, sizeof(offset));
+        server::MemoryTransferService::WriteHandle* serverHandle = nullptr;
+        EXPECT_FALSE(mServerService->DeserializeWriteHandle(createInfo.data(), createInfo.size(),
+                                                            &serverHandle));
+    }
+}
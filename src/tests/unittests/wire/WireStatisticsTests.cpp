@@ -0,0 +1,86 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/wire/WireTest.h"
+
+#include <cstring>
+
+using namespace testing;
+using namespace dawn_wire;
+
+class WireStatisticsTests : public WireTest {
+  public:
+    WireStatisticsTests() {
+    }
+    ~WireStatisticsTests() override = default;
+
+  protected:
+    const WireCommandStatistics* FindCommand(const WireStatistics& statistics, const char* name) {
+        for (const WireCommandStatistics& command : statistics.commands) {
+            if (strcmp(command.name, name) == 0) {
+                return &command;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    bool CollectStatistics() override {
+        return true;
+    }
+};
+
+// Test that the server counts the commands and bytes of each type of command, and the batches.
+TEST_F(WireStatisticsTests, ServerCountsCommands) {
+    wgpuDeviceCreateCommandEncoder(device, nullptr);
+    wgpuDeviceCreateCommandEncoder(device, nullptr);
+    EXPECT_CALL(api, DeviceCreateCommandEncoder(apiDevice, nullptr))
+        .Times(2)
+        .WillRepeatedly(Return(api.GetNewCommandEncoder()));
+    FlushClient();
+
+    WireStatistics statistics = GetWireServer()->GetStatistics();
+    EXPECT_EQ(statistics.batchCount, 1u);
+
+    const WireCommandStatistics* command =
+        FindCommand(statistics, "DeviceCreateCommandEncoder");
+    ASSERT_NE(command, nullptr);
+    EXPECT_EQ(command->count, 2u);
+    EXPECT_GT(command->bytes, 0u);
+    EXPECT_EQ(statistics.bytes, command->bytes);
+    EXPECT_NE(statistics.ToString().find("DeviceCreateCommandEncoder"), std::string::npos);
+
+    GetWireServer()->ResetStatistics();
+    EXPECT_TRUE(GetWireServer()->GetStatistics().commands.empty());
+    EXPECT_EQ(GetWireServer()->GetStatistics().batchCount, 0u);
+}
+
+// Test that the client counts the return commands.
+TEST_F(WireStatisticsTests, ClientCountsReturnCommands) {
+    wgpuDeviceInjectError(device, WGPUErrorType_Validation, "Some error message");
+    EXPECT_CALL(api, DeviceInjectError(apiDevice, WGPUErrorType_Validation, _))
+        .WillOnce(InvokeWithoutArgs([&]() {
+            api.CallDeviceErrorCallback(apiDevice, WGPUErrorType_Validation,
+                                        "Some error message");
+        }));
+    FlushClient();
+    FlushServer();
+
+    WireStatistics statistics = GetWireClient()->GetStatistics();
+    EXPECT_EQ(statistics.batchCount, 1u);
+    const WireCommandStatistics* command =
+        FindCommand(statistics, "DeviceUncapturedErrorCallback");
+    ASSERT_NE(command, nullptr);
+    EXPECT_EQ(command->count, 1u);
+}
@@ -15,6 +15,7 @@
 #include "tests/unittests/wire/WireTest.h"
 
 #include "dawn/dawn_proc.h"
+#include "dawn_wire/WireCapture.h"
 #include "dawn_wire/WireClient.h"
 #include "dawn_wire/WireServer.h"
 #include "utils/TerribleCommandBuffer.h"
@@ -36,6 +37,30 @@ server::MemoryTransferService* WireTest::GetServerMemoryTransferService() {
     return nullptr;
 }
 
+bool WireTest::UseCompactEncoding() {
+    return false;
+}
+
+bool WireTest::UseClientValidation() {
+    return false;
+}
+
+bool WireTest::CollectStatistics() {
+    return false;
+}
+
+bool WireTest::UseCommandStreams() {
+    return false;
+}
+
+bool WireTest::AllowObjectIdGaps() {
+    return UseCommandStreams();
+}
+
+const char* WireTest::GetCapturePath() {
+    return nullptr;
+}
+
 void WireTest::SetUp() {
     DawnProcTable mockProcs;
     WGPUDevice mockDevice;
@@ -54,13 +79,24 @@ void WireTest::SetUp() {
     serverDesc.procs = &mockProcs;
     serverDesc.serializer = mS2cBuf.get();
     serverDesc.memoryTransferService = GetServerMemoryTransferService();
+    serverDesc.collectStatistics = CollectStatistics();
+    serverDesc.allowObjectIdGaps = AllowObjectIdGaps();
 
     mWireServer.reset(new WireServer(serverDesc));
     mC2sBuf->SetHandler(mWireServer.get());
+    if (GetCapturePath() != nullptr) {
+        mCaptureRecorder = std::make_unique<WireCaptureRecorder>(GetCapturePath(),
+                                                                 mWireServer.get());
+        mC2sBuf->SetHandler(mCaptureRecorder.get());
+    }
 
     WireClientDescriptor clientDesc = {};
     clientDesc.serializer = mC2sBuf.get();
     clientDesc.memoryTransferService = GetClientMemoryTransferService();
+    clientDesc.useCompactEncoding = UseCompactEncoding();
+    clientDesc.useClientValidation = UseClientValidation();
+    clientDesc.collectStatistics = CollectStatistics();
+    clientDesc.useCommandStreams = UseCommandStreams();
 
     mWireClient.reset(new WireClient(clientDesc));
     mS2cBuf->SetHandler(mWireClient.get());
@@ -85,7 +121,7 @@ void WireTest::TearDown() {
 }
 
 void WireTest::FlushClient(bool success) {
-    ASSERT_EQ(mC2sBuf->Flush(), success);
+    ASSERT_EQ(mWireClient->Flush(), success);
 
     Mock::VerifyAndClearExpectations(&api);
     SetupIgnoredCallExpectations();
@@ -105,6 +141,9 @@ dawn_wire::WireClient* WireTest::GetWireClient() {
 
 void WireTest::DeleteServer() {
     mWireServer = nullptr;
+    if (mCaptureRecorder != nullptr) {
+        mCaptureRecorder->SetHandler(nullptr);
+    }
 }
 
 void WireTest::SetupIgnoredCallExpectations() {
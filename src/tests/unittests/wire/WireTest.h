@@ -96,6 +96,7 @@ inline testing::Matcher<const char*> ValidStringMessage() {
 }
 
 namespace dawn_wire {
+    class WireCaptureRecorder;
     class WireClient;
     class WireServer;
     namespace client {
@@ -135,7 +136,16 @@ class WireTest : public testing::Test {
 
     virtual dawn_wire::client::MemoryTransferService* GetClientMemoryTransferService();
     virtual dawn_wire::server::MemoryTransferService* GetServerMemoryTransferService();
-
+    virtual bool UseCompactEncoding();
+    virtual bool UseClientValidation();
+    virtual bool CollectStatistics();
+    virtual bool UseCommandStreams();
+    // Whether the server accepts object ID gaps, by default when the client uses command streams.
+    virtual bool AllowObjectIdGaps();
+    // The commands the client sends are captured to this file if it isn't null.
+    virtual const char* GetCapturePath();
+
+    std::unique_ptr<dawn_wire::WireCaptureRecorder> mCaptureRecorder;
     std::unique_ptr<dawn_wire::WireServer> mWireServer;
     std::unique_ptr<dawn_wire::WireClient> mWireClient;
     std::unique_ptr<utils::TerribleCommandBuffer> mS2cBuf;
@@ -0,0 +1,65 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/d3d12/CommandAllocatorManager.h"
+#include "dawn_native/d3d12/DeviceD3D12.h"
+
+using namespace dawn_native::d3d12;
+
+class D3D12CommandAllocatorManagerTests : public DawnTest {
+  protected:
+    void TestSetUp() override {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        mD3DDevice = reinterpret_cast<Device*>(device.Get());
+    }
+
+    Device* mD3DDevice = nullptr;
+};
+
+// Verify the pool grows past the old limit of 32 allocators without waiting on the GPU.
+TEST_P(D3D12CommandAllocatorManagerTests, GrowsWithoutWaiting) {
+    constexpr uint32_t kAllocatorCount = 40;
+    CommandAllocatorManager manager(mD3DDevice);
+
+    for (uint32_t i = 0; i < kAllocatorCount; ++i) {
+        EXPECT_TRUE(manager.ReserveCommandAllocator().IsSuccess());
+    }
+
+    EXPECT_EQ(manager.GetStats().reserveCount, kAllocatorCount);
+    EXPECT_EQ(manager.GetStats().allocatorCount, kAllocatorCount);
+    EXPECT_EQ(manager.GetStats().waitCount, 0u);
+}
+
+// Verify reservations wait for the oldest allocator once the pool is at its high-water mark.
+TEST_P(D3D12CommandAllocatorManagerTests, WaitsAtHighWaterMark) {
+    CommandAllocatorManager manager(mD3DDevice, 2);
+
+    EXPECT_TRUE(manager.ReserveCommandAllocator().IsSuccess());
+    EXPECT_TRUE(manager.ReserveCommandAllocator().IsSuccess());
+
+    // Submit the serial of the reserved allocators so that waiting on it completes.
+    mD3DDevice->Tick();
+
+    EXPECT_TRUE(manager.ReserveCommandAllocator().IsSuccess());
+    EXPECT_EQ(manager.GetStats().allocatorCount, 2u);
+    EXPECT_EQ(manager.GetStats().waitCount, 1u);
+
+    // The allocators were freed by the wait so the next reservation doesn't wait again.
+    EXPECT_TRUE(manager.ReserveCommandAllocator().IsSuccess());
+    EXPECT_EQ(manager.GetStats().waitCount, 1u);
+}
+
+DAWN_INSTANTIATE_TEST(D3D12CommandAllocatorManagerTests, D3D12Backend());
@@ -16,6 +16,7 @@
 
 #include "dawn_native/d3d12/DeviceD3D12.h"
 #include "dawn_native/d3d12/ShaderVisibleDescriptorAllocatorD3D12.h"
+#include "dawn_native/d3d12/StagingDescriptorAllocatorD3D12.h"
 #include "utils/ComboRenderPipelineDescriptor.h"
 #include "utils/WGPUHelpers.h"
 
@@ -198,4 +199,36 @@ TEST_P(D3D12DescriptorHeapTests, PoolHeapsInPendingAndMultipleSubmits) {
     EXPECT_EQ(allocator->GetShaderVisiblePoolSizeForTesting(heapType), kNumOfSwitches);
 }
 
+// Verify the non shader-visible allocator creates heaps when full and reuses deallocated blocks.
+TEST_P(D3D12DescriptorHeapTests, StagingAllocatorReusesBlocks) {
+    constexpr uint32_t kDescriptorCount = 3;
+    constexpr uint32_t kBlocksPerHeap = 2;
+    StagingDescriptorAllocator allocator(mD3DDevice, kDescriptorCount, kBlocksPerHeap,
+                                         D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    CPUDescriptorHeapAllocation first = allocator.AllocateCPUDescriptors().AcquireSuccess();
+    CPUDescriptorHeapAllocation second = allocator.AllocateCPUDescriptors().AcquireSuccess();
+    CPUDescriptorHeapAllocation third = allocator.AllocateCPUDescriptors().AcquireSuccess();
+
+    // The first heap only has room for two blocks.
+    EXPECT_EQ(first.GetHeapIndex(), 0u);
+    EXPECT_EQ(second.GetHeapIndex(), 0u);
+    EXPECT_EQ(third.GetHeapIndex(), 1u);
+    EXPECT_EQ(second.GetBaseDescriptor().ptr - first.GetBaseDescriptor().ptr,
+              kDescriptorCount * allocator.GetSizeIncrement());
+
+    // Deallocated blocks are reused right away.
+    const D3D12_CPU_DESCRIPTOR_HANDLE secondDescriptor = second.GetBaseDescriptor();
+    allocator.Deallocate(&second);
+    EXPECT_FALSE(second.IsValid());
+
+    CPUDescriptorHeapAllocation fourth = allocator.AllocateCPUDescriptors().AcquireSuccess();
+    EXPECT_EQ(fourth.GetHeapIndex(), 0u);
+    EXPECT_EQ(fourth.GetBaseDescriptor().ptr, secondDescriptor.ptr);
+
+    allocator.Deallocate(&first);
+    allocator.Deallocate(&third);
+    allocator.Deallocate(&fourth);
+}
+
 DAWN_INSTANTIATE_TEST(D3D12DescriptorHeapTests, D3D12Backend());
@@ -0,0 +1,90 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/d3d12/DeviceD3D12.h"
+#include "dawn_native/d3d12/RayTracingBufferAllocatorD3D12.h"
+#include "dawn_native/d3d12/ResourceAllocatorManagerD3D12.h"
+
+using namespace dawn_native::d3d12;
+
+class D3D12RayTracingMemoryTests : public DawnTest {
+  protected:
+    void TestSetUp() override {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        mD3DDevice = reinterpret_cast<Device*>(device.Get());
+        DAWN_SKIP_TEST_IF(!mD3DDevice->GetDeviceInfo().supportsRayTracing);
+        mAllocatorManager = mD3DDevice->GetResourceAllocatorManager();
+    }
+
+    RayTracingBuffer* GetBuffer(const dawn_native::ResourceMemoryAllocation& allocation) {
+        return static_cast<RayTracingBuffer*>(allocation.GetResourceHeap());
+    }
+
+    Device* mD3DDevice = nullptr;
+    ResourceAllocatorManager* mAllocatorManager = nullptr;
+};
+
+// Test that small acceleration structures are placed in the same buffer at 256 byte aligned
+// offsets instead of each getting a 64KB resource.
+TEST_P(D3D12RayTracingMemoryTests, SmallAccelerationStructuresShareBuffer) {
+    dawn_native::ResourceMemoryAllocation first =
+        mAllocatorManager->AllocateAccelerationStructureMemory(1000).AcquireSuccess();
+    dawn_native::ResourceMemoryAllocation second =
+        mAllocatorManager->AllocateAccelerationStructureMemory(1000).AcquireSuccess();
+
+    EXPECT_EQ(first.GetInfo().mMethod, dawn_native::AllocationMethod::kSubAllocated);
+    EXPECT_EQ(second.GetInfo().mMethod, dawn_native::AllocationMethod::kSubAllocated);
+    EXPECT_EQ(first.GetResourceHeap(), second.GetResourceHeap());
+    EXPECT_NE(first.GetOffset(), second.GetOffset());
+    EXPECT_EQ(first.GetOffset() % D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, 0u);
+    EXPECT_EQ(second.GetOffset() % D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, 0u);
+    EXPECT_EQ(GetBuffer(first)->GetState(),
+              D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE);
+
+    mAllocatorManager->DeallocateRayTracingMemory(first);
+    mAllocatorManager->DeallocateRayTracingMemory(second);
+    EXPECT_EQ(first.GetInfo().mMethod, dawn_native::AllocationMethod::kInvalid);
+}
+
+// Test that acceleration structures larger than the shared buffers get a buffer of their own.
+TEST_P(D3D12RayTracingMemoryTests, LargeAccelerationStructureGetsOwnBuffer) {
+    constexpr uint64_t kSize = 16ull * 1024ull * 1024ull;
+    dawn_native::ResourceMemoryAllocation allocation =
+        mAllocatorManager->AllocateAccelerationStructureMemory(kSize).AcquireSuccess();
+
+    EXPECT_EQ(allocation.GetInfo().mMethod, dawn_native::AllocationMethod::kDirect);
+    EXPECT_EQ(allocation.GetOffset(), 0u);
+    EXPECT_GE(GetBuffer(allocation)->GetD3D12Resource()->GetDesc().Width, kSize);
+
+    mAllocatorManager->DeallocateRayTracingMemory(allocation);
+}
+
+// Test that the scratch memory comes from unordered access buffers separate from the ones of the
+// acceleration structures.
+TEST_P(D3D12RayTracingMemoryTests, ScratchMemoryIsSeparate) {
+    dawn_native::ResourceMemoryAllocation accelerationStructure =
+        mAllocatorManager->AllocateAccelerationStructureMemory(1000).AcquireSuccess();
+    dawn_native::ResourceMemoryAllocation scratch =
+        mAllocatorManager->AllocateAccelerationStructureScratchMemory(1000).AcquireSuccess();
+
+    EXPECT_NE(accelerationStructure.GetResourceHeap(), scratch.GetResourceHeap());
+    EXPECT_EQ(GetBuffer(scratch)->GetState(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    mAllocatorManager->DeallocateRayTracingMemory(accelerationStructure);
+    mAllocatorManager->DeallocateRayTracingMemory(scratch);
+}
+
+DAWN_INSTANTIATE_TEST(D3D12RayTracingMemoryTests, D3D12Backend());
@@ -0,0 +1,303 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/VulkanBackend.h"
+#include "dawn_native/vulkan/AdapterVk.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/ResourceMemoryAllocatorVk.h"
+
+#include <unistd.h>
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        constexpr uint64_t kBufferSize = 256;
+
+        class VulkanBufferWrappingTestBase : public DawnTest {
+          public:
+            void TestSetUp() override {
+                if (UsesWire()) {
+                    return;
+                }
+
+                deviceVk = reinterpret_cast<dawn_native::vulkan::Device*>(device.Get());
+
+                CreateBindExportBuffer(deviceVk, kBufferSize, &defaultBuffer, &defaultAllocation,
+                                       &defaultAllocationSize, &defaultMemoryTypeIndex,
+                                       &defaultFd);
+                defaultDescriptor.size = kBufferSize;
+                defaultDescriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+            }
+
+            void TearDown() override {
+                if (!UsesWire()) {
+                    deviceVk->GetFencedDeleter()->DeleteWhenUnused(defaultBuffer);
+                    deviceVk->GetFencedDeleter()->DeleteWhenUnused(defaultAllocation);
+                }
+                DawnTest::TearDown();
+            }
+
+            // Creates a VkBuffer with exportable external memory and extracts a file descriptor
+            // representing the memory.
+            void CreateBindExportBuffer(dawn_native::vulkan::Device* deviceVk,
+                                        uint64_t size,
+                                        VkBuffer* handle,
+                                        VkDeviceMemory* allocation,
+                                        VkDeviceSize* allocationSize,
+                                        uint32_t* memoryTypeIndex,
+                                        int* memoryFd) {
+                VkExternalMemoryBufferCreateInfoKHR externalInfo;
+                externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO_KHR;
+                externalInfo.pNext = nullptr;
+                externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+                VkBufferCreateInfo createInfo;
+                createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                createInfo.pNext = &externalInfo;
+                createInfo.flags = 0;
+                createInfo.size = size;
+                createInfo.usage =
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                createInfo.queueFamilyIndexCount = 0;
+                createInfo.pQueueFamilyIndices = nullptr;
+
+                ::VkResult result = deviceVk->fn.CreateBuffer(deviceVk->GetVkDevice(), &createInfo,
+                                                              nullptr, &**handle);
+                EXPECT_EQ(result, VK_SUCCESS) << "Failed to create external buffer";
+
+                VkMemoryRequirements requirements;
+                deviceVk->fn.GetBufferMemoryRequirements(deviceVk->GetVkDevice(), *handle,
+                                                         &requirements);
+
+                VkExportMemoryAllocateInfoKHR exportInfo;
+                exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR;
+                exportInfo.pNext = nullptr;
+                exportInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+                int bestType = deviceVk->GetResourceMemoryAllocatorForTesting()->FindBestTypeIndex(
+                    requirements, false);
+                VkMemoryAllocateInfo allocateInfo;
+                allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                allocateInfo.pNext = &exportInfo;
+                allocateInfo.allocationSize = requirements.size;
+                allocateInfo.memoryTypeIndex = static_cast<uint32_t>(bestType);
+
+                *allocationSize = allocateInfo.allocationSize;
+                *memoryTypeIndex = allocateInfo.memoryTypeIndex;
+
+                result = deviceVk->fn.AllocateMemory(deviceVk->GetVkDevice(), &allocateInfo,
+                                                     nullptr, &**allocation);
+                EXPECT_EQ(result, VK_SUCCESS) << "Failed to allocate external memory";
+
+                result = deviceVk->fn.BindBufferMemory(deviceVk->GetVkDevice(), *handle,
+                                                       *allocation, 0);
+                EXPECT_EQ(result, VK_SUCCESS) << "Failed to bind buffer memory";
+
+                *memoryFd = GetMemoryFd(deviceVk, *allocation);
+            }
+
+            // Extracts a file descriptor representing memory on a device
+            int GetMemoryFd(dawn_native::vulkan::Device* deviceVk, VkDeviceMemory memory) {
+                VkMemoryGetFdInfoKHR getFdInfo;
+                getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+                getFdInfo.pNext = nullptr;
+                getFdInfo.memory = memory;
+                getFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+
+                int memoryFd = -1;
+                deviceVk->fn.GetMemoryFdKHR(deviceVk->GetVkDevice(), &getFdInfo, &memoryFd);
+
+                EXPECT_GE(memoryFd, 0) << "Failed to get file descriptor for external memory";
+                return memoryFd;
+            }
+
+            // Wraps a vulkan buffer from external memory
+            wgpu::Buffer WrapVulkanBuffer(wgpu::Device device,
+                                          const wgpu::BufferDescriptor* bufferDescriptor,
+                                          int memoryFd,
+                                          VkDeviceSize allocationSize,
+                                          uint32_t memoryTypeIndex,
+                                          std::vector<int> waitFDs,
+                                          bool expectValid = true) {
+                dawn_native::vulkan::ExternalBufferDescriptorOpaqueFD descriptor;
+                descriptor.cBufferDescriptor =
+                    reinterpret_cast<const WGPUBufferDescriptor*>(bufferDescriptor);
+                descriptor.allocationSize = allocationSize;
+                descriptor.memoryTypeIndex = memoryTypeIndex;
+                descriptor.memoryFD = memoryFd;
+                descriptor.waitFDs = waitFDs;
+
+                WGPUBuffer buffer =
+                    dawn_native::vulkan::WrapVulkanBuffer(device.Get(), &descriptor);
+
+                if (expectValid) {
+                    EXPECT_NE(buffer, nullptr) << "Failed to wrap buffer, are external memory / "
+                                                  "semaphore extensions supported?";
+                } else {
+                    EXPECT_EQ(buffer, nullptr);
+                }
+
+                return wgpu::Buffer::Acquire(buffer);
+            }
+
+            // Exports the signal from a wrapped buffer and ignores it
+            void IgnoreSignalSemaphore(wgpu::Device device, wgpu::Buffer wrappedBuffer) {
+                int fd = dawn_native::vulkan::ExportBufferSignalSemaphoreOpaqueFD(
+                    device.Get(), wrappedBuffer.Get());
+                ASSERT_NE(fd, -1);
+                close(fd);
+            }
+
+          protected:
+            dawn_native::vulkan::Device* deviceVk;
+
+            wgpu::BufferDescriptor defaultDescriptor;
+            VkBuffer defaultBuffer;
+            VkDeviceMemory defaultAllocation;
+            VkDeviceSize defaultAllocationSize;
+            uint32_t defaultMemoryTypeIndex;
+            int defaultFd;
+        };
+
+    }  // anonymous namespace
+
+    using VulkanBufferWrappingValidationTests = VulkanBufferWrappingTestBase;
+
+    // Test no error occurs if the import is valid
+    TEST_P(VulkanBufferWrappingValidationTests, SuccessfulImport) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        wgpu::Buffer buffer = WrapVulkanBuffer(device, &defaultDescriptor, defaultFd,
+                                               defaultAllocationSize, defaultMemoryTypeIndex, {});
+        EXPECT_NE(buffer.Get(), nullptr);
+        IgnoreSignalSemaphore(device, buffer);
+    }
+
+    // Test an error occurs if the buffer is mappable
+    TEST_P(VulkanBufferWrappingValidationTests, MappableUsage) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        defaultDescriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+
+        ASSERT_DEVICE_ERROR(wgpu::Buffer buffer = WrapVulkanBuffer(
+                                device, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                                defaultMemoryTypeIndex, {}, false));
+        EXPECT_EQ(buffer.Get(), nullptr);
+    }
+
+    // Test an error occurs if the buffer is transient
+    TEST_P(VulkanBufferWrappingValidationTests, TransientUsage) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        defaultDescriptor.usage |= wgpu::BufferUsage::Transient;
+
+        ASSERT_DEVICE_ERROR(wgpu::Buffer buffer = WrapVulkanBuffer(
+                                device, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                                defaultMemoryTypeIndex, {}, false));
+        EXPECT_EQ(buffer.Get(), nullptr);
+    }
+
+    // Test an error occurs if the allocation is smaller than the buffer
+    TEST_P(VulkanBufferWrappingValidationTests, AllocationTooSmall) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        defaultDescriptor.size = defaultAllocationSize * 2;
+
+        ASSERT_DEVICE_ERROR(wgpu::Buffer buffer = WrapVulkanBuffer(
+                                device, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                                defaultMemoryTypeIndex, {}, false));
+        EXPECT_EQ(buffer.Get(), nullptr);
+    }
+
+    // Test an error occurs if we try to export the signal semaphore twice
+    TEST_P(VulkanBufferWrappingValidationTests, DoubleSignalSemaphoreExport) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        wgpu::Buffer buffer = WrapVulkanBuffer(device, &defaultDescriptor, defaultFd,
+                                               defaultAllocationSize, defaultMemoryTypeIndex, {});
+        ASSERT_NE(buffer.Get(), nullptr);
+        IgnoreSignalSemaphore(device, buffer);
+        ASSERT_DEVICE_ERROR(int fd = dawn_native::vulkan::ExportBufferSignalSemaphoreOpaqueFD(
+                                device.Get(), buffer.Get()));
+        ASSERT_EQ(fd, -1);
+    }
+
+    // Test an error occurs if we try to export the signal semaphore from a normal buffer
+    TEST_P(VulkanBufferWrappingValidationTests, NormalBufferSignalSemaphoreExport) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        wgpu::Buffer buffer = device.CreateBuffer(&defaultDescriptor);
+        ASSERT_DEVICE_ERROR(int fd = dawn_native::vulkan::ExportBufferSignalSemaphoreOpaqueFD(
+                                device.Get(), buffer.Get()));
+        ASSERT_EQ(fd, -1);
+    }
+
+    class VulkanBufferWrappingUsageTests : public VulkanBufferWrappingTestBase {
+      public:
+        void TestSetUp() override {
+            VulkanBufferWrappingTestBase::TestSetUp();
+            if (UsesWire()) {
+                return;
+            }
+
+            // Create another device based on the original
+            dawn_native::vulkan::Adapter* backendAdapter =
+                reinterpret_cast<dawn_native::vulkan::Adapter*>(deviceVk->GetAdapter());
+            dawn_native::DeviceDescriptor deviceDescriptor;
+            deviceDescriptor.forceEnabledToggles = GetParam().forceEnabledWorkarounds;
+            deviceDescriptor.forceDisabledToggles = GetParam().forceDisabledWorkarounds;
+
+            secondDevice = wgpu::Device::Acquire(
+                reinterpret_cast<WGPUDevice>(backendAdapter->CreateDevice(&deviceDescriptor)));
+        }
+
+      protected:
+        wgpu::Device secondDevice;
+    };
+
+    // Write a buffer in |secondDevice|
+    // Verify the data is visible in |device| after waiting on the signal semaphore
+    TEST_P(VulkanBufferWrappingUsageTests, WriteBufferAcrossDevices) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+
+        // Import the buffer on |secondDevice| and write it
+        wgpu::Buffer wrappedBuffer =
+            WrapVulkanBuffer(secondDevice, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                             defaultMemoryTypeIndex, {});
+
+        std::vector<uint32_t> data(kBufferSize / sizeof(uint32_t));
+        for (uint32_t i = 0; i < data.size(); ++i) {
+            data[i] = i * 3 + 1;
+        }
+        secondDevice.GetDefaultQueue().WriteBuffer(wrappedBuffer, 0, data.data(), kBufferSize);
+
+        int signalFd = dawn_native::vulkan::ExportBufferSignalSemaphoreOpaqueFD(
+            secondDevice.Get(), wrappedBuffer.Get());
+
+        // Import the buffer to |device|, making sure we wait on signalFd
+        int memoryFd = GetMemoryFd(deviceVk, defaultAllocation);
+        wgpu::Buffer nextWrappedBuffer =
+            WrapVulkanBuffer(device, &defaultDescriptor, memoryFd, defaultAllocationSize,
+                             defaultMemoryTypeIndex, {signalFd});
+
+        // Verify |device| sees the changes from |secondDevice|
+        EXPECT_BUFFER_U32_RANGE_EQ(data.data(), nextWrappedBuffer, 0, data.size());
+
+        IgnoreSignalSemaphore(device, nextWrappedBuffer);
+    }
+
+    DAWN_INSTANTIATE_TEST(VulkanBufferWrappingValidationTests, VulkanBackend());
+    DAWN_INSTANTIATE_TEST(VulkanBufferWrappingUsageTests, VulkanBackend());
+
+}}  // namespace dawn_native::vulkan
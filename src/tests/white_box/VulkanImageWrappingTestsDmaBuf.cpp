@@ -106,13 +106,15 @@ namespace dawn_native { namespace vulkan {
                                           uint64_t drmModifier,
                                           std::vector<int> waitFDs,
                                           bool isCleared = true,
-                                          bool expectValid = true) {
+                                          bool expectValid = true,
+                                          uint64_t planeOffset = 0) {
                 dawn_native::vulkan::ExternalImageDescriptorDmaBuf descriptor;
                 descriptor.cTextureDescriptor =
                     reinterpret_cast<const WGPUTextureDescriptor*>(textureDescriptor);
                 descriptor.isCleared = isCleared;
                 descriptor.stride = stride;
                 descriptor.drmModifier = drmModifier;
+                descriptor.planeOffset = planeOffset;
                 descriptor.memoryFD = memoryFd;
                 descriptor.waitFDs = waitFDs;
 
@@ -260,6 +262,40 @@ namespace dawn_native { namespace vulkan {
         ASSERT_EQ(fd, -1);
     }
 
+    // Test the planes of a NV12 buffer can be imported as separate textures
+    TEST_P(VulkanImageWrappingValidationTests, ImportNV12Planes) {
+        constexpr uint32_t kWidth = 4;
+        constexpr uint32_t kHeight = 4;
+        gbm_bo* nv12Bo = gbm_bo_create(gbmDevice, kWidth, kHeight, GBM_FORMAT_NV12,
+                                       GBM_BO_USE_TEXTURING | GBM_BO_USE_LINEAR);
+        DAWN_SKIP_TEST_IF(nv12Bo == nullptr);
+        uint64_t modifier = gbm_bo_get_modifier(nv12Bo);
+
+        wgpu::TextureDescriptor yDescriptor = defaultDescriptor;
+        yDescriptor.format = wgpu::TextureFormat::R8Unorm;
+        yDescriptor.size = {kWidth, kHeight, 1};
+        yDescriptor.usage = wgpu::TextureUsage::Sampled | wgpu::TextureUsage::CopySrc;
+        wgpu::Texture yTexture =
+            WrapVulkanImage(device, &yDescriptor, gbm_bo_get_fd(nv12Bo),
+                            gbm_bo_get_stride_for_plane(nv12Bo, 0), modifier, {}, true, true,
+                            gbm_bo_get_offset(nv12Bo, 0));
+
+        wgpu::TextureDescriptor uvDescriptor = yDescriptor;
+        uvDescriptor.format = wgpu::TextureFormat::RG8Unorm;
+        uvDescriptor.size = {kWidth / 2, kHeight / 2, 1};
+        wgpu::Texture uvTexture =
+            WrapVulkanImage(device, &uvDescriptor, gbm_bo_get_fd(nv12Bo),
+                            gbm_bo_get_stride_for_plane(nv12Bo, 1), modifier, {}, true, true,
+                            gbm_bo_get_offset(nv12Bo, 1));
+
+        EXPECT_NE(yTexture.Get(), nullptr);
+        EXPECT_NE(uvTexture.Get(), nullptr);
+        IgnoreSignalSemaphore(device, yTexture);
+        IgnoreSignalSemaphore(device, uvTexture);
+        gbm_bo_destroy(nv12Bo);
+        close(defaultFd);
+    }
+
     // Fixture to test using external memory textures through different usages.
     // These tests are skipped if the harness is using the wire.
     class VulkanImageWrappingUsageTests : public VulkanImageWrappingTestBase {
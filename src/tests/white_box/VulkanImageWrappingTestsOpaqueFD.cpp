@@ -159,7 +159,9 @@ namespace dawn_native { namespace vulkan {
                                           uint32_t memoryTypeIndex,
                                           std::vector<int> waitFDs,
                                           bool isCleared = true,
-                                          bool expectValid = true) {
+                                          bool expectValid = true,
+                                          ::VkSemaphore timelineSemaphore = VK_NULL_HANDLE,
+                                          uint64_t waitTimelineValue = 0) {
                 dawn_native::vulkan::ExternalImageDescriptorOpaqueFD descriptor;
                 descriptor.cTextureDescriptor =
                     reinterpret_cast<const WGPUTextureDescriptor*>(textureDescriptor);
@@ -168,6 +170,8 @@ namespace dawn_native { namespace vulkan {
                 descriptor.memoryTypeIndex = memoryTypeIndex;
                 descriptor.memoryFD = memoryFd;
                 descriptor.waitFDs = waitFDs;
+                descriptor.timelineSemaphore = timelineSemaphore;
+                descriptor.waitTimelineValue = waitTimelineValue;
 
                 WGPUTexture texture =
                     dawn_native::vulkan::WrapVulkanImage(device.Get(), &descriptor);
@@ -348,6 +352,25 @@ namespace dawn_native { namespace vulkan {
         ASSERT_EQ(fd, -1);
     }
 
+    // Test an error occurs when exporting a binary signal semaphore from a texture wrapped with a
+    // timeline semaphore
+    TEST_P(VulkanImageWrappingValidationTests, TimelineTextureSignalSemaphoreExport) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        DAWN_SKIP_TEST_IF(!dawn_native::vulkan::SupportsTimelineSemaphoreOpaqueFD(device.Get()));
+
+        ::VkSemaphore timelineSemaphore =
+            dawn_native::vulkan::CreateExportableTimelineSemaphore(device.Get(), 0);
+        wgpu::Texture texture =
+            WrapVulkanImage(device, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                            defaultMemoryTypeIndex, {}, true, true, timelineSemaphore, 0);
+        ASSERT_DEVICE_ERROR(int fd = dawn_native::vulkan::ExportSignalSemaphoreOpaqueFD(
+                                device.Get(), texture.Get()));
+        ASSERT_EQ(fd, -1);
+
+        EXPECT_TRUE(dawn_native::vulkan::SignalTimelineSemaphore(device.Get(), texture.Get(), 1));
+        dawn_native::vulkan::ReleaseTimelineSemaphore(device.Get(), timelineSemaphore);
+    }
+
     // Fixture to test using external memory textures through different usages.
     // These tests are skipped if the harness is using the wire.
     class VulkanImageWrappingUsageTests : public VulkanImageWrappingTestBase {
@@ -479,6 +502,48 @@ namespace dawn_native { namespace vulkan {
         IgnoreSignalSemaphore(device, nextWrappedTexture);
     }
 
+    // Clear an image in |secondDevice| and release it by signaling a shared timeline semaphore
+    // Verify clear color is visible in |device| after waiting on the timeline semaphore
+    TEST_P(VulkanImageWrappingUsageTests, ClearImageAcrossDevicesWithTimelineSemaphore) {
+        DAWN_SKIP_TEST_IF(UsesWire());
+        DAWN_SKIP_TEST_IF(
+            !dawn_native::vulkan::SupportsTimelineSemaphoreOpaqueFD(secondDevice.Get()) ||
+            !dawn_native::vulkan::SupportsTimelineSemaphoreOpaqueFD(device.Get()));
+
+        // Share a single timeline semaphore between the devices
+        ::VkSemaphore secondTimeline =
+            dawn_native::vulkan::CreateExportableTimelineSemaphore(secondDevice.Get(), 0);
+        ASSERT_NE(secondTimeline, VK_NULL_HANDLE);
+        int timelineFd = dawn_native::vulkan::ExportTimelineSemaphoreOpaqueFD(secondDevice.Get(),
+                                                                              secondTimeline);
+        ASSERT_NE(timelineFd, -1);
+        ::VkSemaphore timeline =
+            dawn_native::vulkan::ImportTimelineSemaphoreOpaqueFD(device.Get(), timelineFd);
+        ASSERT_NE(timeline, VK_NULL_HANDLE);
+
+        // Import the image on |secondDevice|, clear it and signal 1
+        wgpu::Texture wrappedTexture =
+            WrapVulkanImage(secondDevice, &defaultDescriptor, defaultFd, defaultAllocationSize,
+                            defaultMemoryTypeIndex, {}, true, true, secondTimeline, 0);
+        ClearImage(secondDevice, wrappedTexture, {1 / 255.0f, 2 / 255.0f, 3 / 255.0f, 4 / 255.0f});
+        ASSERT_TRUE(dawn_native::vulkan::SignalTimelineSemaphore(secondDevice.Get(),
+                                                                 wrappedTexture.Get(), 1));
+
+        // Import the image to |device|, making sure we wait for 1
+        int memoryFd = GetMemoryFd(deviceVk, defaultAllocation);
+        wgpu::Texture nextWrappedTexture =
+            WrapVulkanImage(device, &defaultDescriptor, memoryFd, defaultAllocationSize,
+                            defaultMemoryTypeIndex, {}, true, true, timeline, 1);
+
+        // Verify |device| sees the changes from |secondDevice|
+        EXPECT_PIXEL_RGBA8_EQ(RGBA8(1, 2, 3, 4), nextWrappedTexture, 0, 0);
+
+        ASSERT_TRUE(dawn_native::vulkan::SignalTimelineSemaphore(device.Get(),
+                                                                 nextWrappedTexture.Get(), 2));
+        dawn_native::vulkan::ReleaseTimelineSemaphore(device.Get(), timeline);
+        dawn_native::vulkan::ReleaseTimelineSemaphore(secondDevice.Get(), secondTimeline);
+    }
+
     // Import texture to |device| and |secondDevice|
     // Clear image in |secondDevice|
     // Verify clear color is visible in |device|
@@ -58,7 +58,7 @@ namespace utils {
             instance->DiscoverAdapters(&adapterOptions);
 #endif  // defined(DAWN_ENABLE_BACKEND_OPENGL)
         } else {
-            instance->DiscoverDefaultAdapters();
+            instance->DiscoverDefaultAdapters({static_cast<WGPUBackendType>(type)});
         }
     }
 
@@ -0,0 +1,54 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/RayTracingInstanceShader.h"
+
+#include "common/Assert.h"
+
+#include <sstream>
+
+namespace utils {
+
+    std::string GetAccelerationInstanceGLSL(
+        const wgpu::RayTracingAccelerationInstanceLayout& layout,
+        const char* bufferName) {
+        // the instances are written word by word
+        ASSERT(layout.size % 4 == 0 && layout.transformOffset % 4 == 0);
+        ASSERT(layout.instanceIdAndMaskOffset % 4 == 0);
+        ASSERT(layout.instanceOffsetAndFlagsOffset % 4 == 0);
+        ASSERT(layout.geometryContainerHandleOffset % 4 == 0);
+
+        std::ostringstream glsl;
+        glsl << "void writeAccelerationInstance(uint instanceIndex, vec4 row0, vec4 row1, "
+                "vec4 row2, uint instanceId, uint mask, uint instanceOffset, uint flags, "
+                "uvec2 geometryContainerHandle) {\n";
+        glsl << "    uint base = instanceIndex * " << layout.size / 4 << "u;\n";
+        glsl << "    vec4 rows[3] = vec4[3](row0, row1, row2);\n";
+        glsl << "    for (uint i = 0u; i < 12u; ++i) {\n";
+        glsl << "        " << bufferName << "[base + " << layout.transformOffset / 4
+             << "u + i] = floatBitsToUint(rows[i / 4u][i % 4u]);\n";
+        glsl << "    }\n";
+        glsl << "    " << bufferName << "[base + " << layout.instanceIdAndMaskOffset / 4
+             << "u] = (instanceId & 0xFFFFFFu) | (mask << 24u);\n";
+        glsl << "    " << bufferName << "[base + " << layout.instanceOffsetAndFlagsOffset / 4
+             << "u] = (instanceOffset & 0xFFFFFFu) | (flags << 24u);\n";
+        glsl << "    " << bufferName << "[base + " << layout.geometryContainerHandleOffset / 4
+             << "u] = geometryContainerHandle.x;\n";
+        glsl << "    " << bufferName << "[base + " << layout.geometryContainerHandleOffset / 4 + 1
+             << "u] = geometryContainerHandle.y;\n";
+        glsl << "}\n";
+        return glsl.str();
+    }
+
+}  // namespace utils
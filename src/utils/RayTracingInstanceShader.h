@@ -0,0 +1,42 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UTILS_RAYTRACINGINSTANCESHADER_H_
+#define UTILS_RAYTRACINGINSTANCESHADER_H_
+
+#include <dawn/webgpu_cpp.h>
+
+#include <string>
+
+namespace utils {
+
+    // Returns GLSL declaring writeAccelerationInstance(), which packs an instance with the layout
+    // the device reads instance buffers with, so that compute shaders can generate the instances
+    // of a top-level container on the GPU. |bufferName| is a uint array of the shader the
+    // instances are written to, for example:
+    //
+    //   layout(std430, set = 0, binding = 0) buffer Instances { uint instanceWords[]; };
+    //   <GetAccelerationInstanceGLSL(layout, "instanceWords")>
+    //
+    //   writeAccelerationInstance(index, row0, row1, row2, id, 0xFF, 0, 0, handle);
+    //
+    // The transform is given as its three rows and the geometry container handle, as returned
+    // by getHandle(), as its low and high words.
+    std::string GetAccelerationInstanceGLSL(
+        const wgpu::RayTracingAccelerationInstanceLayout& layout,
+        const char* bufferName);
+
+}  // namespace utils
+
+#endif  // UTILS_RAYTRACINGINSTANCESHADER_H_
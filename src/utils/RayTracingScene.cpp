@@ -0,0 +1,299 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/RayTracingScene.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace utils {
+
+    namespace {
+
+        uint64_t GetBufferKey(const wgpu::Buffer& buffer) {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(buffer.Get()));
+        }
+
+    }  // anonymous namespace
+
+    RayTracingScene::RayTracingScene(const wgpu::Device& device,
+                                     const RayTracingSceneDescriptor& descriptor)
+        : mDevice(device), mDescriptor(descriptor) {
+    }
+
+    uint32_t RayTracingScene::AddMesh(
+        const std::vector<wgpu::RayTracingAccelerationGeometryDescriptor>& geometries) {
+        Mesh mesh;
+        std::vector<uint64_t> key;
+        for (const wgpu::RayTracingAccelerationGeometryDescriptor& descriptor : geometries) {
+            MeshGeometry geometry = {};
+            geometry.descriptor = descriptor;
+            key.push_back(static_cast<uint64_t>(descriptor.type));
+            key.push_back(static_cast<uint64_t>(descriptor.flags));
+
+            key.push_back(descriptor.vertex != nullptr);
+            if (descriptor.vertex != nullptr) {
+                geometry.vertex = *descriptor.vertex;
+                key.insert(key.end(), {GetBufferKey(geometry.vertex.buffer),
+                                       static_cast<uint64_t>(geometry.vertex.format),
+                                       geometry.vertex.stride, geometry.vertex.offset,
+                                       geometry.vertex.count});
+            }
+            key.push_back(descriptor.index != nullptr);
+            if (descriptor.index != nullptr) {
+                geometry.index = *descriptor.index;
+                key.insert(key.end(), {GetBufferKey(geometry.index.buffer),
+                                       static_cast<uint64_t>(geometry.index.format),
+                                       geometry.index.offset, geometry.index.count});
+            }
+            key.push_back(descriptor.aabb != nullptr);
+            if (descriptor.aabb != nullptr) {
+                geometry.aabb = *descriptor.aabb;
+                key.insert(key.end(), {GetBufferKey(geometry.aabb.buffer), geometry.aabb.stride,
+                                       geometry.aabb.offset, geometry.aabb.count});
+            }
+            key.push_back(descriptor.transform != nullptr);
+            if (descriptor.transform != nullptr) {
+                geometry.transform = *descriptor.transform;
+                key.insert(key.end(),
+                           {GetBufferKey(geometry.transform.buffer), geometry.transform.offset});
+            }
+
+            mesh.geometries.push_back(geometry);
+        }
+
+        auto it = mMeshIndices.find(key);
+        if (it != mMeshIndices.end()) {
+            return it->second;
+        }
+
+        mesh.container = CreateMeshContainer(mesh);
+        uint32_t meshIndex = static_cast<uint32_t>(mMeshes.size());
+        mMeshes.push_back(std::move(mesh));
+        mMeshIndices[std::move(key)] = meshIndex;
+        return meshIndex;
+    }
+
+    uint32_t RayTracingScene::AddInstance(
+        uint32_t meshIndex,
+        const float transform[12],
+        const wgpu::RayTracingAccelerationInstanceProperties& properties) {
+        ASSERT(meshIndex < mMeshes.size());
+
+        Instance instance;
+        instance.meshIndex = meshIndex;
+        memcpy(instance.transform.data(), transform, sizeof(instance.transform));
+        instance.properties = properties;
+
+        uint32_t instanceIndex = static_cast<uint32_t>(mInstances.size());
+        mInstances.push_back(instance);
+        MarkInstanceDirty(instanceIndex);
+        return instanceIndex;
+    }
+
+    void RayTracingScene::SetInstanceTransform(uint32_t instanceIndex, const float transform[12]) {
+        ASSERT(instanceIndex < mInstances.size());
+        Instance& instance = mInstances[instanceIndex];
+        memcpy(instance.transform.data(), transform, sizeof(instance.transform));
+        MarkInstanceDirty(instanceIndex);
+    }
+
+    void RayTracingScene::SetInstanceProperties(
+        uint32_t instanceIndex,
+        const wgpu::RayTracingAccelerationInstanceProperties& properties) {
+        ASSERT(instanceIndex < mInstances.size());
+        mInstances[instanceIndex].properties = properties;
+        MarkInstanceDirty(instanceIndex);
+    }
+
+    bool RayTracingScene::Submit(const wgpu::Queue& queue) {
+        wgpu::CommandEncoder encoder = mDevice.CreateCommandEncoder();
+        bool hasCommands = false;
+
+        // Compact the containers whose compacted size is known. The top-level container still
+        // references the containers they were compacted from, so it gets rebuilt.
+        for (Mesh& mesh : mMeshes) {
+            if (mesh.compaction == nullptr || !mesh.compaction->compactedSizeAvailable) {
+                continue;
+            }
+            wgpu::RayTracingAccelerationContainer compacted = CreateMeshContainer(mesh);
+            encoder.CompactRayTracingAccelerationContainer(mesh.container, compacted);
+            mesh.container = compacted;
+            mesh.compaction = nullptr;
+            mTopLevelNeedsRebuild = true;
+            hasCommands = true;
+        }
+
+        // Build all the new meshes in one batch, which shares the barriers between the builds.
+        std::vector<wgpu::RayTracingAccelerationContainer> builds;
+        std::vector<uint32_t> compactableMeshes;
+        const bool allowCompaction =
+            (mDescriptor.meshFlags & wgpu::RayTracingAccelerationContainerFlag::AllowCompaction) !=
+            0;
+        for (uint32_t meshIndex = 0; meshIndex < mMeshes.size(); ++meshIndex) {
+            Mesh& mesh = mMeshes[meshIndex];
+            if (mesh.built) {
+                continue;
+            }
+            builds.push_back(mesh.container);
+            mesh.built = true;
+            if (allowCompaction) {
+                mesh.compaction = std::make_shared<CompactionState>();
+                compactableMeshes.push_back(meshIndex);
+            }
+        }
+        if (!builds.empty()) {
+            encoder.BuildRayTracingAccelerationContainers(builds.size(), builds.data());
+            hasCommands = true;
+        }
+
+        // Refit the instances that changed, unless the top-level container has to be recreated.
+        bool recreated = false;
+        if (!mInstances.empty()) {
+            const bool allowUpdate =
+                (mDescriptor.instanceFlags &
+                 wgpu::RayTracingAccelerationContainerFlag::AllowUpdate) != 0;
+            const bool instancesChanged = mDirtyInstanceEnd > mFirstDirtyInstance;
+            if (mTopLevelContainer == nullptr || mTopLevelNeedsRebuild ||
+                mTopLevelInstanceCount != mInstances.size() || (instancesChanged && !allowUpdate)) {
+                CreateTopLevelContainer();
+                encoder.BuildRayTracingAccelerationContainer(mTopLevelContainer);
+                mTopLevelNeedsRebuild = false;
+                recreated = true;
+                hasCommands = true;
+            } else if (instancesChanged) {
+                uint32_t instanceCount = mDirtyInstanceEnd - mFirstDirtyInstance;
+                std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> instances =
+                    GetInstanceDescriptors(mFirstDirtyInstance, instanceCount);
+                mTopLevelContainer.UpdateInstances(mFirstDirtyInstance, instanceCount,
+                                                   instances.data());
+                encoder.UpdateRayTracingAccelerationContainer(mTopLevelContainer);
+                hasCommands = true;
+            }
+            mFirstDirtyInstance = 0;
+            mDirtyInstanceEnd = 0;
+        }
+
+        if (hasCommands) {
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+        }
+
+        // The compacted sizes are queried by the builds, and known once they completed.
+        for (uint32_t meshIndex : compactableMeshes) {
+            Mesh& mesh = mMeshes[meshIndex];
+            mesh.container.GetBuildInfo(OnBuildInfo,
+                                        new std::shared_ptr<CompactionState>(mesh.compaction));
+        }
+
+        return recreated;
+    }
+
+    const wgpu::RayTracingAccelerationContainer& RayTracingScene::GetTopLevelContainer() const {
+        return mTopLevelContainer;
+    }
+
+    uint32_t RayTracingScene::GetMeshCount() const {
+        return static_cast<uint32_t>(mMeshes.size());
+    }
+
+    uint32_t RayTracingScene::GetInstanceCount() const {
+        return static_cast<uint32_t>(mInstances.size());
+    }
+
+    // static
+    void RayTracingScene::OnBuildInfo(WGPURayTracingAccelerationContainerGetBuildInfoStatus status,
+                                      WGPURayTracingAccelerationContainerBuildInfo info,
+                                      void* userdata) {
+        std::unique_ptr<std::shared_ptr<CompactionState>> state(
+            static_cast<std::shared_ptr<CompactionState>*>(userdata));
+        // The container stays uncompacted if its compacted size can't be known, for example
+        // with the wire.
+        (*state)->compactedSizeAvailable =
+            status == WGPURayTracingAccelerationContainerGetBuildInfoStatus_Success &&
+            info.compactedSize != 0;
+    }
+
+    wgpu::RayTracingAccelerationContainer RayTracingScene::CreateMeshContainer(
+        const Mesh& mesh) const {
+        std::vector<wgpu::RayTracingAccelerationGeometryDescriptor> geometries;
+        for (const MeshGeometry& geometry : mesh.geometries) {
+            wgpu::RayTracingAccelerationGeometryDescriptor descriptor = geometry.descriptor;
+            if (descriptor.vertex != nullptr) {
+                descriptor.vertex = &geometry.vertex;
+            }
+            if (descriptor.index != nullptr) {
+                descriptor.index = &geometry.index;
+            }
+            if (descriptor.aabb != nullptr) {
+                descriptor.aabb = &geometry.aabb;
+            }
+            if (descriptor.transform != nullptr) {
+                descriptor.transform = &geometry.transform;
+            }
+            geometries.push_back(descriptor);
+        }
+
+        wgpu::RayTracingAccelerationContainerDescriptor descriptor;
+        descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Bottom;
+        descriptor.flags = mDescriptor.meshFlags;
+        descriptor.geometryCount = static_cast<uint32_t>(geometries.size());
+        descriptor.geometries = geometries.data();
+        return mDevice.CreateRayTracingAccelerationContainer(&descriptor);
+    }
+
+    void RayTracingScene::CreateTopLevelContainer() {
+        std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> instances =
+            GetInstanceDescriptors(0, static_cast<uint32_t>(mInstances.size()));
+
+        wgpu::RayTracingAccelerationContainerDescriptor descriptor;
+        descriptor.level = wgpu::RayTracingAccelerationContainerLevel::Top;
+        descriptor.flags = mDescriptor.instanceFlags;
+        descriptor.instanceCount = static_cast<uint32_t>(instances.size());
+        descriptor.instances = instances.data();
+        descriptor.updateRebuildThreshold = mDescriptor.updateRebuildThreshold;
+        mTopLevelContainer = mDevice.CreateRayTracingAccelerationContainer(&descriptor);
+        mTopLevelInstanceCount = descriptor.instanceCount;
+    }
+
+    std::vector<wgpu::RayTracingAccelerationInstanceDescriptor>
+    RayTracingScene::GetInstanceDescriptors(uint32_t firstInstance, uint32_t instanceCount) const {
+        std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> descriptors(instanceCount);
+        for (uint32_t ii = 0; ii < instanceCount; ++ii) {
+            const Instance& instance = mInstances[firstInstance + ii];
+            wgpu::RayTracingAccelerationInstanceDescriptor& descriptor = descriptors[ii];
+            descriptor.flags = instance.properties.flags;
+            descriptor.mask = instance.properties.mask;
+            descriptor.instanceId = instance.properties.instanceId;
+            descriptor.instanceOffset = instance.properties.instanceOffset;
+            descriptor.transformMatrixSize = static_cast<uint32_t>(instance.transform.size());
+            descriptor.transformMatrix = instance.transform.data();
+            descriptor.geometryContainer = mMeshes[instance.meshIndex].container;
+        }
+        return descriptors;
+    }
+
+    void RayTracingScene::MarkInstanceDirty(uint32_t instanceIndex) {
+        if (mDirtyInstanceEnd == mFirstDirtyInstance) {
+            mFirstDirtyInstance = instanceIndex;
+            mDirtyInstanceEnd = instanceIndex + 1;
+        } else {
+            mFirstDirtyInstance = std::min(mFirstDirtyInstance, instanceIndex);
+            mDirtyInstanceEnd = std::max(mDirtyInstanceEnd, instanceIndex + 1);
+        }
+    }
+
+}  // namespace utils
@@ -0,0 +1,146 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UTILS_RAYTRACINGSCENE_H_
+#define UTILS_RAYTRACINGSCENE_H_
+
+#include <dawn/webgpu_cpp.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace utils {
+
+    struct RayTracingSceneDescriptor {
+        // Flags of the bottom-level containers of the meshes. With AllowCompaction, each of them
+        // gets compacted by the first Submit() after its build completed.
+        wgpu::RayTracingAccelerationContainerFlag meshFlags =
+            wgpu::RayTracingAccelerationContainerFlag::PreferFastTrace |
+            wgpu::RayTracingAccelerationContainerFlag::AllowCompaction;
+        // Flags of the top-level container. With AllowUpdate, instances that changed are refit
+        // into the container, otherwise the container is created and built again.
+        wgpu::RayTracingAccelerationContainerFlag instanceFlags =
+            wgpu::RayTracingAccelerationContainerFlag::AllowUpdate |
+            wgpu::RayTracingAccelerationContainerFlag::PreferFastBuild;
+        // The amount of refits after which an update rebuilds the top-level container instead.
+        uint32_t updateRebuildThreshold = 16;
+    };
+
+    // Keeps the acceleration containers of a scene of instanced meshes up to date:
+    //  - Meshes added with the same geometries share their bottom-level container.
+    //  - The bottom-level containers that weren't built yet are built in a single batch, before
+    //    the top-level container in the same command buffer.
+    //  - Only the range of instances that changed since the last submit is written, and the
+    //    top-level container is refit when it allows updates. It is recreated when instances
+    //    were added or the container of a mesh was replaced by its compacted version.
+    //  - The bottom-level containers which allow compaction are compacted once the size is
+    //    known, which takes a tick of the device after the submit that built them.
+    //
+    //   utils::RayTracingScene scene(device, {});
+    //   uint32_t mesh = scene.AddMesh(geometries);
+    //   uint32_t instance = scene.AddInstance(mesh, transform);
+    //   // once per frame:
+    //   scene.SetInstanceTransform(instance, transform);
+    //   if (scene.Submit(queue)) {
+    //       // recreate the bind groups using scene.GetTopLevelContainer()
+    //   }
+    class RayTracingScene {
+      public:
+        RayTracingScene(const wgpu::Device& device, const RayTracingSceneDescriptor& descriptor);
+
+        // Returns the index of the mesh. The descriptors, and what they point to, are copied.
+        uint32_t AddMesh(
+            const std::vector<wgpu::RayTracingAccelerationGeometryDescriptor>& geometries);
+
+        // Returns the index of the instance. The transform is a row-major 3x4 matrix.
+        uint32_t AddInstance(uint32_t meshIndex,
+                             const float transform[12],
+                             const wgpu::RayTracingAccelerationInstanceProperties& properties = {});
+        void SetInstanceTransform(uint32_t instanceIndex, const float transform[12]);
+        void SetInstanceProperties(
+            uint32_t instanceIndex,
+            const wgpu::RayTracingAccelerationInstanceProperties& properties);
+
+        // Records and submits the compactions, builds and updates of the containers that the
+        // changes since the last submit need. Returns true if the top-level container was
+        // recreated, in which case the bind groups using it need to be recreated too.
+        bool Submit(const wgpu::Queue& queue);
+
+        // Null until the first Submit() with instances.
+        const wgpu::RayTracingAccelerationContainer& GetTopLevelContainer() const;
+
+        uint32_t GetMeshCount() const;
+        uint32_t GetInstanceCount() const;
+
+      private:
+        struct MeshGeometry {
+            wgpu::RayTracingAccelerationGeometryDescriptor descriptor;
+            wgpu::RayTracingAccelerationGeometryVertexDescriptor vertex;
+            wgpu::RayTracingAccelerationGeometryIndexDescriptor index;
+            wgpu::RayTracingAccelerationGeometryAabbDescriptor aabb;
+            wgpu::RayTracingAccelerationGeometryTransformDescriptor transform;
+        };
+
+        // Set by the build info callback, which can be called after the scene was destroyed.
+        struct CompactionState {
+            bool compactedSizeAvailable = false;
+        };
+
+        struct Mesh {
+            std::vector<MeshGeometry> geometries;
+            wgpu::RayTracingAccelerationContainer container;
+            bool built = false;
+            std::shared_ptr<CompactionState> compaction;
+        };
+
+        struct Instance {
+            uint32_t meshIndex;
+            std::array<float, 12> transform;
+            wgpu::RayTracingAccelerationInstanceProperties properties;
+        };
+
+        static void OnBuildInfo(WGPURayTracingAccelerationContainerGetBuildInfoStatus status,
+                                WGPURayTracingAccelerationContainerBuildInfo info,
+                                void* userdata);
+
+        wgpu::RayTracingAccelerationContainer CreateMeshContainer(const Mesh& mesh) const;
+        void CreateTopLevelContainer();
+        std::vector<wgpu::RayTracingAccelerationInstanceDescriptor> GetInstanceDescriptors(
+            uint32_t firstInstance,
+            uint32_t instanceCount) const;
+        void MarkInstanceDirty(uint32_t instanceIndex);
+
+        wgpu::Device mDevice;
+        RayTracingSceneDescriptor mDescriptor;
+
+        std::vector<Mesh> mMeshes;
+        // The members of the geometry descriptors of each mesh, to find the meshes that a new
+        // one can share its container with.
+        std::map<std::vector<uint64_t>, uint32_t> mMeshIndices;
+
+        std::vector<Instance> mInstances;
+        // The range of instances that changed since the last submit.
+        uint32_t mFirstDirtyInstance = 0;
+        uint32_t mDirtyInstanceEnd = 0;
+
+        wgpu::RayTracingAccelerationContainer mTopLevelContainer;
+        uint32_t mTopLevelInstanceCount = 0;
+        bool mTopLevelNeedsRebuild = false;
+    };
+
+}  // namespace utils
+
+#endif  // UTILS_RAYTRACINGSCENE_H_
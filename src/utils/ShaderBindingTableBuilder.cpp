@@ -0,0 +1,142 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/ShaderBindingTableBuilder.h"
+
+#include "common/Assert.h"
+
+namespace utils {
+
+    ShaderBindingTableBuilder::ShaderBindingTableBuilder(uint32_t rayTypeCount)
+        : mRayTypeCount(rayTypeCount) {
+        ASSERT(rayTypeCount > 0);
+    }
+
+    int32_t ShaderBindingTableBuilder::AddStage(wgpu::ShaderStage stage,
+                                                const wgpu::ShaderModule& module) {
+        wgpu::RayTracingShaderBindingTableStagesDescriptor descriptor;
+        descriptor.stage = stage;
+        descriptor.module = module;
+        mStages.push_back(descriptor);
+        return static_cast<int32_t>(mStages.size() - 1);
+    }
+
+    uint32_t ShaderBindingTableBuilder::AddGeneralGroup(int32_t stageIndex) {
+        if (!ValidateStage(stageIndex, wgpu::ShaderStage::RayGeneration) &&
+            !ValidateStage(stageIndex, wgpu::ShaderStage::RayMiss) &&
+            !ValidateStage(stageIndex, wgpu::ShaderStage::RayCallable)) {
+            SetError("General group must reference a ray generation, miss or callable stage");
+        }
+
+        wgpu::RayTracingShaderBindingTableGroupsDescriptor group;
+        group.type = wgpu::RayTracingShaderBindingTableGroupType::General;
+        group.generalIndex = stageIndex;
+        mGeneralGroups.push_back(group);
+        return static_cast<uint32_t>(mGeneralGroups.size() - 1);
+    }
+
+    uint32_t ShaderBindingTableBuilder::AddGeometryContainer(
+        const std::vector<wgpu::RayTracingAccelerationGeometryType>& geometryTypes,
+        const std::vector<ShaderBindingTableHitGroup>& hitGroups) {
+        uint32_t instanceOffset = static_cast<uint32_t>(mHitGroups.size());
+        if (hitGroups.size() != geometryTypes.size() * mRayTypeCount) {
+            SetError("Geometry container needs a hit group per geometry and ray type");
+            return instanceOffset;
+        }
+
+        for (size_t i = 0; i < hitGroups.size(); ++i) {
+            const ShaderBindingTableHitGroup& hitGroup = hitGroups[i];
+            bool isAABBs =
+                geometryTypes[i / mRayTypeCount] == wgpu::RayTracingAccelerationGeometryType::Aabbs;
+
+            if (hitGroup.closestHitIndex != -1 &&
+                !ValidateStage(hitGroup.closestHitIndex, wgpu::ShaderStage::RayClosestHit)) {
+                SetError("Hit group closest hit index must reference a closest hit stage");
+            }
+            if (hitGroup.anyHitIndex != -1 &&
+                !ValidateStage(hitGroup.anyHitIndex, wgpu::ShaderStage::RayAnyHit)) {
+                SetError("Hit group any hit index must reference an any hit stage");
+            }
+            if (isAABBs) {
+                if (!ValidateStage(hitGroup.intersectionIndex,
+                                   wgpu::ShaderStage::RayIntersection)) {
+                    SetError("Hit group of an AABB geometry needs an intersection stage");
+                }
+            } else if (hitGroup.intersectionIndex != -1) {
+                SetError("Hit group of a triangle geometry can't have an intersection stage");
+            }
+
+            wgpu::RayTracingShaderBindingTableGroupsDescriptor group;
+            group.type = isAABBs ? wgpu::RayTracingShaderBindingTableGroupType::ProceduralHitGroup
+                                 : wgpu::RayTracingShaderBindingTableGroupType::TrianglesHitGroup;
+            group.closestHitIndex = hitGroup.closestHitIndex;
+            group.anyHitIndex = hitGroup.anyHitIndex;
+            group.intersectionIndex = hitGroup.intersectionIndex;
+            mHitGroups.push_back(group);
+        }
+        return instanceOffset;
+    }
+
+    uint32_t ShaderBindingTableBuilder::GetRayHitOffset() const {
+        return static_cast<uint32_t>(mGeneralGroups.size());
+    }
+
+    uint32_t ShaderBindingTableBuilder::GetHitGroupIndex(uint32_t instanceOffset,
+                                                         uint32_t geometryIndex,
+                                                         uint32_t rayType) const {
+        ASSERT(rayType < mRayTypeCount);
+        uint32_t index =
+            GetRayHitOffset() + instanceOffset + geometryIndex * mRayTypeCount + rayType;
+        ASSERT(index < mGeneralGroups.size() + mHitGroups.size());
+        return index;
+    }
+
+    const std::string& ShaderBindingTableBuilder::GetError() const {
+        return mError;
+    }
+
+    wgpu::RayTracingShaderBindingTable ShaderBindingTableBuilder::Create(
+        const wgpu::Device& device,
+        uint32_t recordDataSize) const {
+        if (!mError.empty()) {
+            device.InjectError(wgpu::ErrorType::Validation, mError.c_str());
+            return nullptr;
+        }
+
+        std::vector<wgpu::RayTracingShaderBindingTableGroupsDescriptor> groups = mGeneralGroups;
+        groups.insert(groups.end(), mHitGroups.begin(), mHitGroups.end());
+
+        wgpu::RayTracingShaderBindingTableDescriptor descriptor;
+        descriptor.stagesCount = static_cast<uint32_t>(mStages.size());
+        descriptor.stages = mStages.data();
+        descriptor.groupsCount = static_cast<uint32_t>(groups.size());
+        descriptor.groups = groups.data();
+        descriptor.recordDataSize = recordDataSize;
+        return device.CreateRayTracingShaderBindingTable(&descriptor);
+    }
+
+    bool ShaderBindingTableBuilder::ValidateStage(int32_t stageIndex,
+                                                  wgpu::ShaderStage expected) const {
+        return stageIndex >= 0 && static_cast<size_t>(stageIndex) < mStages.size() &&
+               mStages[stageIndex].stage == expected;
+    }
+
+    void ShaderBindingTableBuilder::SetError(const std::string& error) {
+        // Keep the first error, the later ones are often caused by it.
+        if (mError.empty()) {
+            mError = error;
+        }
+    }
+
+}  // namespace utils
@@ -0,0 +1,97 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UTILS_SHADERBINDINGTABLEBUILDER_H_
+#define UTILS_SHADERBINDINGTABLEBUILDER_H_
+
+#include <dawn/webgpu_cpp.h>
+
+#include <string>
+#include <vector>
+
+namespace utils {
+
+    // The stages of a hit group, as indices returned by ShaderBindingTableBuilder::AddStage, or
+    // -1 when the group doesn't have the stage.
+    struct ShaderBindingTableHitGroup {
+        int32_t closestHitIndex = -1;
+        int32_t anyHitIndex = -1;
+        int32_t intersectionIndex = -1;
+    };
+
+    // Lays out the groups of a shader binding table so that each geometry of a geometry container
+    // gets its own hit groups, one per ray type. traceNV selects the hit group of a hit with
+    //
+    //   rayHitOffset + instanceOffset + geometryIndex * sbtRecordStride + sbtRecordOffset
+    //
+    // so the shaders pass the ray type count as sbtRecordStride and the ray type as
+    // sbtRecordOffset, and the instances of a geometry container use the instance offset returned
+    // when its hit groups were added. A per-geometry material is then selected by the hit group
+    // instead of a branch in the shader.
+    //
+    //   utils::ShaderBindingTableBuilder builder(2);  // primary and shadow rays
+    //   uint32_t rayGeneration = builder.AddGeneralGroup(builder.AddStage(RayGeneration, rgen));
+    //   uint32_t instanceOffset = builder.AddGeometryContainer(geometryTypes, hitGroups);
+    //   wgpu::RayTracingShaderBindingTable sbt = builder.Create(device);
+    class ShaderBindingTableBuilder {
+      public:
+        explicit ShaderBindingTableBuilder(uint32_t rayTypeCount);
+
+        // Returns the index of the stage, for the groups.
+        int32_t AddStage(wgpu::ShaderStage stage, const wgpu::ShaderModule& module);
+
+        // Adds a ray generation, miss or callable group and returns its group index. The general
+        // groups are placed before the hit groups and their indices don't change.
+        uint32_t AddGeneralGroup(int32_t stageIndex);
+
+        // Adds the hit groups of a geometry container, with the hit group of the ray type r of
+        // the geometry g at hitGroups[g * rayTypeCount + r]. Returns the instance offset of the
+        // instances of the container. Triangle geometries can't have an intersection stage and
+        // AABB geometries need one.
+        uint32_t AddGeometryContainer(
+            const std::vector<wgpu::RayTracingAccelerationGeometryType>& geometryTypes,
+            const std::vector<ShaderBindingTableHitGroup>& hitGroups);
+
+        // The ray hit offset to give to traceRays. Only final once all the general groups were
+        // added.
+        uint32_t GetRayHitOffset() const;
+
+        // The group index of the hit group that a hit with the geometry of an instance uses, for
+        // example to write the record data of its material.
+        uint32_t GetHitGroupIndex(uint32_t instanceOffset,
+                                  uint32_t geometryIndex,
+                                  uint32_t rayType) const;
+
+        // Returns an empty string if the layout is valid, otherwise why it isn't.
+        const std::string& GetError() const;
+
+        // Injects a validation error in the device and returns a null table if the layout isn't
+        // valid.
+        wgpu::RayTracingShaderBindingTable Create(const wgpu::Device& device,
+                                                  uint32_t recordDataSize = 0) const;
+
+      private:
+        bool ValidateStage(int32_t stageIndex, wgpu::ShaderStage expected) const;
+        void SetError(const std::string& error);
+
+        uint32_t mRayTypeCount;
+        std::vector<wgpu::RayTracingShaderBindingTableStagesDescriptor> mStages;
+        std::vector<wgpu::RayTracingShaderBindingTableGroupsDescriptor> mGeneralGroups;
+        std::vector<wgpu::RayTracingShaderBindingTableGroupsDescriptor> mHitGroups;
+        std::string mError;
+    };
+
+}  // namespace utils
+
+#endif  // UTILS_SHADERBINDINGTABLEBUILDER_H_
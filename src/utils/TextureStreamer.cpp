@@ -0,0 +1,293 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/TextureStreamer.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+
+namespace utils {
+
+    namespace {
+
+        struct BlockInfo {
+            uint32_t width;
+            uint32_t height;
+            uint32_t byteSize;
+        };
+
+        BlockInfo GetBlockInfo(wgpu::TextureFormat format) {
+            switch (format) {
+                case wgpu::TextureFormat::R8Unorm:
+                case wgpu::TextureFormat::R8Snorm:
+                case wgpu::TextureFormat::R8Uint:
+                case wgpu::TextureFormat::R8Sint:
+                    return {1, 1, 1};
+
+                case wgpu::TextureFormat::R16Uint:
+                case wgpu::TextureFormat::R16Sint:
+                case wgpu::TextureFormat::R16Float:
+                case wgpu::TextureFormat::RG8Unorm:
+                case wgpu::TextureFormat::RG8Snorm:
+                case wgpu::TextureFormat::RG8Uint:
+                case wgpu::TextureFormat::RG8Sint:
+                    return {1, 1, 2};
+
+                case wgpu::TextureFormat::R32Float:
+                case wgpu::TextureFormat::R32Uint:
+                case wgpu::TextureFormat::R32Sint:
+                case wgpu::TextureFormat::RG16Uint:
+                case wgpu::TextureFormat::RG16Sint:
+                case wgpu::TextureFormat::RG16Float:
+                case wgpu::TextureFormat::RGBA8Unorm:
+                case wgpu::TextureFormat::RGBA8UnormSrgb:
+                case wgpu::TextureFormat::RGBA8Snorm:
+                case wgpu::TextureFormat::RGBA8Uint:
+                case wgpu::TextureFormat::RGBA8Sint:
+                case wgpu::TextureFormat::BGRA8Unorm:
+                case wgpu::TextureFormat::BGRA8UnormSrgb:
+                case wgpu::TextureFormat::RGB10A2Unorm:
+                case wgpu::TextureFormat::RG11B10Float:
+                    return {1, 1, 4};
+
+                case wgpu::TextureFormat::RG32Float:
+                case wgpu::TextureFormat::RG32Uint:
+                case wgpu::TextureFormat::RG32Sint:
+                case wgpu::TextureFormat::RGBA16Uint:
+                case wgpu::TextureFormat::RGBA16Sint:
+                case wgpu::TextureFormat::RGBA16Float:
+                    return {1, 1, 8};
+
+                case wgpu::TextureFormat::RGBA32Float:
+                case wgpu::TextureFormat::RGBA32Uint:
+                case wgpu::TextureFormat::RGBA32Sint:
+                    return {1, 1, 16};
+
+                case wgpu::TextureFormat::BC1RGBAUnorm:
+                case wgpu::TextureFormat::BC1RGBAUnormSrgb:
+                case wgpu::TextureFormat::BC4RUnorm:
+                case wgpu::TextureFormat::BC4RSnorm:
+                    return {4, 4, 8};
+
+                case wgpu::TextureFormat::BC2RGBAUnorm:
+                case wgpu::TextureFormat::BC2RGBAUnormSrgb:
+                case wgpu::TextureFormat::BC3RGBAUnorm:
+                case wgpu::TextureFormat::BC3RGBAUnormSrgb:
+                case wgpu::TextureFormat::BC5RGUnorm:
+                case wgpu::TextureFormat::BC5RGSnorm:
+                case wgpu::TextureFormat::BC6HRGBUfloat:
+                case wgpu::TextureFormat::BC6HRGBSfloat:
+                case wgpu::TextureFormat::BC7RGBAUnorm:
+                case wgpu::TextureFormat::BC7RGBAUnormSrgb:
+                    return {4, 4, 16};
+
+                // Depth formats can't be written to.
+                default:
+                    UNREACHABLE();
+                    return {1, 1, 0};
+            }
+        }
+
+    }  // anonymous namespace
+
+    TextureStreamer::TextureStreamer(const wgpu::Queue& queue) : mQueue(queue) {
+        wgpu::FenceDescriptor fenceDescriptor;
+        fenceDescriptor.initialValue = 0;
+        mFence = mQueue.CreateFence(&fenceDescriptor);
+    }
+
+    uint32_t TextureStreamer::AddTexture(const StreamedTextureDescriptor& descriptor) {
+        ASSERT(descriptor.mipLevelCount > 0);
+
+        BlockInfo blockInfo = GetBlockInfo(descriptor.format);
+        StreamedTexture texture;
+        texture.descriptor = descriptor;
+        texture.blockWidth = blockInfo.width;
+        texture.blockHeight = blockInfo.height;
+        texture.blockByteSize = blockInfo.byteSize;
+        texture.levelData.resize(descriptor.mipLevelCount);
+        texture.hasLevelData.resize(descriptor.mipLevelCount, false);
+        texture.levelSignalValues.resize(descriptor.mipLevelCount, 0);
+        texture.remainingLevelCount = descriptor.mipLevelCount;
+
+        uint32_t textureId = mNextTextureId++;
+        mTextures.emplace(textureId, std::move(texture));
+        return textureId;
+    }
+
+    void TextureStreamer::RemoveTexture(uint32_t textureId) {
+        mTextures.erase(textureId);
+    }
+
+    void TextureStreamer::SetPriority(uint32_t textureId, int32_t priority) {
+        mTextures.at(textureId).descriptor.priority = priority;
+    }
+
+    void TextureStreamer::SetLevelData(uint32_t textureId,
+                                       uint32_t level,
+                                       const void* data,
+                                       uint64_t size) {
+        StreamedTexture& texture = mTextures.at(textureId);
+        ASSERT(level < texture.descriptor.mipLevelCount);
+        ASSERT(size == GetLevelByteSize(texture, level));
+
+        // Levels that were already written don't need their data anymore.
+        if (level >= texture.remainingLevelCount) {
+            return;
+        }
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        texture.levelData[level].assign(bytes, bytes + size);
+        texture.hasLevelData[level] = true;
+    }
+
+    uint64_t TextureStreamer::Upload(uint64_t maxBytes) {
+        uint64_t writtenBytes = 0;
+        bool needsSignal = false;
+
+        while (StreamedTexture* texture = GetNextTexture()) {
+            uint32_t level = texture->remainingLevelCount - 1;
+            wgpu::Extent3D sizeInBlocks = GetLevelSizeInBlocks(*texture, level);
+            uint32_t bytesPerRow = sizeInBlocks.width * texture->blockByteSize;
+
+            uint64_t budgetRowCount = (maxBytes - writtenBytes) / bytesPerRow;
+            if (budgetRowCount == 0) {
+                if (writtenBytes != 0) {
+                    break;
+                }
+                // Rows larger than the budget are still written, one per call.
+                budgetRowCount = 1;
+            }
+            uint32_t rowCount = static_cast<uint32_t>(
+                std::min(budgetRowCount, uint64_t(sizeInBlocks.height - texture->nextRow)));
+
+            wgpu::TextureCopyView copyView;
+            copyView.texture = texture->descriptor.texture;
+            copyView.mipLevel = level;
+            copyView.arrayLayer = texture->nextLayer;
+            copyView.origin = {0, texture->nextRow * texture->blockHeight, 0};
+
+            wgpu::TextureDataLayout dataLayout;
+            dataLayout.offset =
+                (uint64_t(texture->nextLayer) * sizeInBlocks.height + texture->nextRow) *
+                bytesPerRow;
+            dataLayout.rowPitch = bytesPerRow;
+
+            wgpu::Extent3D writeSize = {sizeInBlocks.width * texture->blockWidth,
+                                        rowCount * texture->blockHeight, 1};
+            const std::vector<uint8_t>& data = texture->levelData[level];
+            mQueue.WriteTexture(&copyView, data.data(), data.size(), &dataLayout, &writeSize);
+            writtenBytes += uint64_t(rowCount) * bytesPerRow;
+
+            texture->nextRow += rowCount;
+            if (texture->nextRow < sizeInBlocks.height) {
+                continue;
+            }
+            texture->nextRow = 0;
+            texture->nextLayer++;
+            if (texture->nextLayer < sizeInBlocks.depth) {
+                continue;
+            }
+
+            // The level is complete once the signal after it completes.
+            texture->nextLayer = 0;
+            texture->remainingLevelCount--;
+            texture->levelSignalValues[level] = mNextSignalValue;
+            texture->levelData[level] = {};
+            needsSignal = true;
+        }
+
+        if (needsSignal) {
+            mQueue.Signal(mFence, mNextSignalValue++);
+        }
+        return writtenBytes;
+    }
+
+    bool TextureStreamer::HasPendingUploads() const {
+        for (const auto& it : mTextures) {
+            if (it.second.remainingLevelCount != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t TextureStreamer::GetMinResidentLevel(uint32_t textureId) const {
+        const StreamedTexture& texture = mTextures.at(textureId);
+        uint64_t completedValue = mFence.GetCompletedValue();
+
+        uint32_t minResidentLevel = texture.descriptor.mipLevelCount;
+        while (minResidentLevel > 0) {
+            uint64_t signalValue = texture.levelSignalValues[minResidentLevel - 1];
+            if (signalValue == 0 || signalValue > completedValue) {
+                break;
+            }
+            minResidentLevel--;
+        }
+        return minResidentLevel;
+    }
+
+    TextureStreamer::StreamedTexture* TextureStreamer::GetNextTexture() {
+        StreamedTexture* nextTexture = nullptr;
+        uint32_t nextTextureId = 0;
+        bool nextIsMipTail = false;
+
+        for (auto& it : mTextures) {
+            StreamedTexture& texture = it.second;
+            if (texture.remainingLevelCount == 0 ||
+                !texture.hasLevelData[texture.remainingLevelCount - 1]) {
+                continue;
+            }
+
+            uint32_t level = texture.remainingLevelCount - 1;
+            bool isMipTail = GetLevelByteSize(texture, level) <= texture.descriptor.mipTailSize;
+
+            // Mip tails first, then by priority, then in the order the textures were added.
+            bool isBetter;
+            if (nextTexture == nullptr || isMipTail != nextIsMipTail) {
+                isBetter = nextTexture == nullptr || isMipTail;
+            } else if (texture.descriptor.priority != nextTexture->descriptor.priority) {
+                isBetter = texture.descriptor.priority > nextTexture->descriptor.priority;
+            } else {
+                isBetter = it.first < nextTextureId;
+            }
+
+            if (isBetter) {
+                nextTexture = &texture;
+                nextTextureId = it.first;
+                nextIsMipTail = isMipTail;
+            }
+        }
+        return nextTexture;
+    }
+
+    // static
+    wgpu::Extent3D TextureStreamer::GetLevelSizeInBlocks(const StreamedTexture& texture,
+                                                         uint32_t level) {
+        uint32_t width = std::max(texture.descriptor.size.width >> level, 1u);
+        uint32_t height = std::max(texture.descriptor.size.height >> level, 1u);
+        return {(width + texture.blockWidth - 1) / texture.blockWidth,
+                (height + texture.blockHeight - 1) / texture.blockHeight,
+                texture.descriptor.size.depth};
+    }
+
+    // static
+    uint64_t TextureStreamer::GetLevelByteSize(const StreamedTexture& texture, uint32_t level) {
+        wgpu::Extent3D sizeInBlocks = GetLevelSizeInBlocks(texture, level);
+        return uint64_t(sizeInBlocks.width) * sizeInBlocks.height * sizeInBlocks.depth *
+               texture.blockByteSize;
+    }
+
+}  // namespace utils
@@ -0,0 +1,111 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UTILS_TEXTURESTREAMER_H_
+#define UTILS_TEXTURESTREAMER_H_
+
+#include <dawn/webgpu_cpp.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+    struct StreamedTextureDescriptor {
+        // Needs the CopyDst usage.
+        wgpu::Texture texture;
+        wgpu::TextureFormat format = wgpu::TextureFormat::Undefined;
+        // The size of level 0, the depth is the number of array layers.
+        wgpu::Extent3D size = {1, 1, 1};
+        uint32_t mipLevelCount = 1;
+
+        // Levels with at most this many bytes are part of the mip tail. The mip tails of all the
+        // textures are streamed before the other levels, so that each texture can be sampled
+        // early at a low resolution.
+        uint64_t mipTailSize = 64 * 1024;
+        // Outside of the mip tails, the textures with the highest priority are streamed first.
+        int32_t priority = 0;
+    };
+
+    // Streams the mip levels of textures, including compressed ones, from the smallest level to
+    // the largest, with Queue::WriteTexture. The per-frame upload is capped by a byte budget, and
+    // levels larger than what's left of the budget are written in parts over several frames, so
+    // that the staging memory of the device stays small. Shaders can clamp their LOD to the
+    // levels that are resident.
+    //
+    //   utils::TextureStreamer streamer(queue);
+    //   uint32_t id = streamer.AddTexture(descriptor);
+    //   streamer.SetLevelData(id, level, data, size);  // for each level, as it is loaded
+    //   // once per frame:
+    //   streamer.Upload(1024 * 1024);
+    //   uint32_t minLod = streamer.GetMinResidentLevel(id);
+    class TextureStreamer {
+      public:
+        TextureStreamer(const wgpu::Queue& queue);
+
+        // Returns the id of the texture in the streamer.
+        uint32_t AddTexture(const StreamedTextureDescriptor& descriptor);
+        // Stops streaming the texture, the levels already written stay in the texture.
+        void RemoveTexture(uint32_t textureId);
+        void SetPriority(uint32_t textureId, int32_t priority);
+
+        // The data of the level is made of rows of blocks, tightly packed, for each of the array
+        // layers. It is copied until the level has been written.
+        void SetLevelData(uint32_t textureId, uint32_t level, const void* data, uint64_t size);
+
+        // Writes up to |maxBytes| of level data, and at least one row of blocks when there is
+        // data to write. Returns the number of bytes written.
+        uint64_t Upload(uint64_t maxBytes);
+        bool HasPendingUploads() const;
+
+        // Returns the smallest level such that it and all the levels after it are complete on the
+        // GPU, or the level count when no level is resident yet. The residency is updated when
+        // the device is ticked.
+        uint32_t GetMinResidentLevel(uint32_t textureId) const;
+
+      private:
+        struct StreamedTexture {
+            StreamedTextureDescriptor descriptor;
+            uint32_t blockWidth;
+            uint32_t blockHeight;
+            uint32_t blockByteSize;
+
+            std::vector<std::vector<uint8_t>> levelData;
+            std::vector<bool> hasLevelData;
+            // The fence value signaled after each level was written, 0 until then.
+            std::vector<uint64_t> levelSignalValues;
+
+            // The levels are written from the last one, this is the number of levels left and
+            // the position of the next row of blocks in the level being written.
+            uint32_t remainingLevelCount;
+            uint32_t nextLayer = 0;
+            uint32_t nextRow = 0;
+        };
+
+        // Returns the texture to write the next rows of, or nullptr if none has data to write.
+        StreamedTexture* GetNextTexture();
+        static wgpu::Extent3D GetLevelSizeInBlocks(const StreamedTexture& texture, uint32_t level);
+        static uint64_t GetLevelByteSize(const StreamedTexture& texture, uint32_t level);
+
+        wgpu::Queue mQueue;
+        wgpu::Fence mFence;
+        uint64_t mNextSignalValue = 1;
+
+        uint32_t mNextTextureId = 0;
+        std::unordered_map<uint32_t, StreamedTexture> mTextures;
+    };
+
+}  // namespace utils
+
+#endif  // UTILS_TEXTURESTREAMER_H_
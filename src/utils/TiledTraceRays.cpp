@@ -0,0 +1,129 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/TiledTraceRays.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+
+namespace utils {
+
+    namespace {
+
+        // Owns the callback of a tile until its fence value completes, so that the callbacks
+        // don't depend on the lifetime of the TiledTraceRays.
+        struct TileCompletion {
+            TraceRaysTileCallback callback;
+            TraceRaysTile tile;
+        };
+
+        void OnTileCompleted(WGPUFenceCompletionStatus status, void* userdata) {
+            TileCompletion* completion = static_cast<TileCompletion*>(userdata);
+            completion->callback(status, completion->tile);
+            delete completion;
+        }
+
+        uint64_t DistanceSquared(const TraceRaysTile& tile, uint32_t x, uint32_t y) {
+            // distance from the point to the closest pixel of the tile
+            uint32_t clampedX = std::min(std::max(x, tile.x), tile.x + tile.width - 1);
+            uint32_t clampedY = std::min(std::max(y, tile.y), tile.y + tile.height - 1);
+            uint64_t dx = std::max(x, clampedX) - std::min(x, clampedX);
+            uint64_t dy = std::max(y, clampedY) - std::min(y, clampedY);
+            return dx * dx + dy * dy;
+        }
+
+    }  // anonymous namespace
+
+    TiledTraceRays::TiledTraceRays(const wgpu::Device& device,
+                                   const wgpu::Queue& queue,
+                                   const TiledTraceRaysDescriptor& descriptor)
+        : mDevice(device),
+          mQueue(queue),
+          mDescriptor(descriptor),
+          mPriorityX(descriptor.width / 2),
+          mPriorityY(descriptor.height / 2) {
+        ASSERT(descriptor.tileWidth > 0 && descriptor.tileHeight > 0);
+
+        wgpu::FenceDescriptor fenceDescriptor;
+        fenceDescriptor.initialValue = 0;
+        mFence = mQueue.CreateFence(&fenceDescriptor);
+
+        Reset();
+    }
+
+    void TiledTraceRays::Prioritize(uint32_t x, uint32_t y) {
+        mPriorityX = x;
+        mPriorityY = y;
+        std::stable_sort(mRemainingTiles.begin(), mRemainingTiles.end(),
+                         [x, y](const TraceRaysTile& a, const TraceRaysTile& b) {
+                             return DistanceSquared(a, x, y) > DistanceSquared(b, x, y);
+                         });
+    }
+
+    uint32_t TiledTraceRays::SubmitTiles(uint32_t maxTileCount, TraceRaysTileCallback callback) {
+        uint32_t submittedTileCount = 0;
+        while (submittedTileCount < maxTileCount && HasRemainingTiles()) {
+            TraceRaysTile tile = mRemainingTiles.back();
+            mRemainingTiles.pop_back();
+
+            wgpu::CommandEncoder encoder = mDevice.CreateCommandEncoder();
+            {
+                wgpu::RayTracingPassDescriptor passDescriptor;
+                wgpu::RayTracingPassEncoder pass = encoder.BeginRayTracingPass(&passDescriptor);
+                pass.SetPipeline(mDescriptor.pipeline);
+                for (uint32_t i = 0; i < mDescriptor.bindGroups.size(); ++i) {
+                    pass.SetBindGroup(i, mDescriptor.bindGroups[i]);
+                }
+
+                uint32_t tileOrigin[2] = {tile.x, tile.y};
+                pass.SetPushConstants(wgpu::ShaderStage::RayGeneration,
+                                      mDescriptor.tileOriginPushConstantOffset,
+                                      sizeof(tileOrigin), tileOrigin);
+                pass.TraceRays(mDescriptor.rayGenerationOffset, mDescriptor.rayHitOffset,
+                               mDescriptor.rayMissOffset, tile.width, tile.height);
+                pass.EndPass();
+            }
+            wgpu::CommandBuffer commands = encoder.Finish();
+
+            mQueue.Submit(1, &commands);
+            uint64_t signalValue = mNextSignalValue++;
+            mQueue.Signal(mFence, signalValue);
+            mFence.OnCompletion(signalValue, OnTileCompleted, new TileCompletion{callback, tile});
+
+            submittedTileCount++;
+        }
+        return submittedTileCount;
+    }
+
+    bool TiledTraceRays::HasRemainingTiles() const {
+        return !mRemainingTiles.empty();
+    }
+
+    void TiledTraceRays::Reset() {
+        mRemainingTiles.clear();
+        for (uint32_t y = 0; y < mDescriptor.height; y += mDescriptor.tileHeight) {
+            for (uint32_t x = 0; x < mDescriptor.width; x += mDescriptor.tileWidth) {
+                TraceRaysTile tile;
+                tile.x = x;
+                tile.y = y;
+                tile.width = std::min(mDescriptor.tileWidth, mDescriptor.width - x);
+                tile.height = std::min(mDescriptor.tileHeight, mDescriptor.height - y);
+                mRemainingTiles.push_back(tile);
+            }
+        }
+        Prioritize(mPriorityX, mPriorityY);
+    }
+
+}  // namespace utils
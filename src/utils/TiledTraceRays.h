@@ -0,0 +1,103 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UTILS_TILEDTRACERAYS_H_
+#define UTILS_TILEDTRACERAYS_H_
+
+#include <dawn/webgpu_cpp.h>
+
+#include <functional>
+#include <vector>
+
+namespace utils {
+
+    struct TraceRaysTile {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    using TraceRaysTileCallback =
+        std::function<void(WGPUFenceCompletionStatus status, const TraceRaysTile& tile)>;
+
+    struct TiledTraceRaysDescriptor {
+        wgpu::RayTracingPipeline pipeline;
+        // Set at the group indices they are in the vector.
+        std::vector<wgpu::BindGroup> bindGroups;
+
+        uint32_t rayGenerationOffset = 0;
+        uint32_t rayHitOffset = 0;
+        uint32_t rayMissOffset = 0;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t tileWidth = 256;
+        uint32_t tileHeight = 256;
+
+        // Offset of the uvec2 push constant the ray generation shader gets the origin of its tile
+        // from. The shader adds it to gl_LaunchIDNV, and uses the full size of the image instead
+        // of gl_LaunchSizeNV.
+        uint32_t tileOriginPushConstantOffset = 0;
+    };
+
+    // Splits a traceRays dispatch into tiles that are each recorded in their own command buffer
+    // and submitted separately, so that a large image doesn't keep the GPU busy long enough to
+    // trigger a device reset and other work can be submitted in between the tiles. The tiles
+    // closest to the point of the image with the highest priority are traced first, which is the
+    // center of the image unless Prioritize() was called. The pipeline layout needs push
+    // constants visible to the ray generation stage.
+    //
+    //   utils::TiledTraceRays tracer(queue, descriptor);
+    //   // once per frame, until the image is complete:
+    //   tracer.SubmitTiles(4, [](WGPUFenceCompletionStatus status, const TraceRaysTile& tile) {
+    //       // the pixels of the tile are ready
+    //   });
+    class TiledTraceRays {
+      public:
+        TiledTraceRays(const wgpu::Device& device,
+                       const wgpu::Queue& queue,
+                       const TiledTraceRaysDescriptor& descriptor);
+
+        // Orders the tiles that haven't been submitted by their distance to the pixel (x, y),
+        // for example to trace the area under the cursor first.
+        void Prioritize(uint32_t x, uint32_t y);
+
+        // Submits up to |maxTileCount| tiles, each followed by a fence signal. The callback is
+        // called for each of them once the tile completes, when the device is ticked. Returns the
+        // number of tiles submitted.
+        uint32_t SubmitTiles(uint32_t maxTileCount, TraceRaysTileCallback callback);
+
+        bool HasRemainingTiles() const;
+
+        // Starts over with all the tiles, for example after the scene changed.
+        void Reset();
+
+      private:
+        wgpu::Device mDevice;
+        wgpu::Queue mQueue;
+        wgpu::Fence mFence;
+        uint64_t mNextSignalValue = 1;
+
+        TiledTraceRaysDescriptor mDescriptor;
+        uint32_t mPriorityX;
+        uint32_t mPriorityY;
+
+        // The tiles left to submit, the ones with the highest priority at the back.
+        std::vector<TraceRaysTile> mRemainingTiles;
+    };
+
+}  // namespace utils
+
+#endif  // UTILS_TILEDTRACERAYS_H_
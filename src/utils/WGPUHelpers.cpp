@@ -46,6 +46,8 @@ namespace utils {
                     return shaderc_glsl_miss_shader;
                 case SingleShaderStage::RayIntersection:
                     return shaderc_glsl_intersection_shader;
+                case SingleShaderStage::RayCallable:
+                    return shaderc_glsl_callable_shader;
                 default:
                     UNREACHABLE();
             }
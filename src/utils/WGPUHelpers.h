@@ -34,7 +34,8 @@ namespace utils {
         RayAnyHit,
         RayClosestHit,
         RayMiss,
-        RayIntersection
+        RayIntersection,
+        RayCallable
     };
 
     wgpu::ShaderModule CreateShaderModule(const wgpu::Device& device,